@@ -34,9 +34,14 @@ ${BAZEL_BIN} build @com_google_protobuf//:protoc
 io::log_yellow "Build microgenerator plugin"
 ${BAZEL_BIN} build //generator:protoc-gen-cpp_codegen
 
+# Each entry is: copyright year, product path, proto file, the number of
+# pages prefetched by paginated methods (0 disables prefetching), whether
+# the client allocates requests in a per-call protobuf arena, and whether the
+# connection holds its default retry, backoff, and idempotency policies by
+# value.
 product_path_proto_path_to_generate=(
-  "2020 google/cloud/iam google/iam/credentials/v1/iamcredentials.proto"
-  "2021 google/cloud/logging google/logging/v2/logging.proto"
+  "2020 google/cloud/iam google/iam/credentials/v1/iamcredentials.proto 0 false false"
+  "2021 google/cloud/logging google/logging/v2/logging.proto 2 true false"
 )
 
 io::log_yellow "Run protoc and format generated .h and .cc files:"
@@ -46,6 +51,9 @@ for proto in "${product_path_proto_path_to_generate[@]}"; do
   copyright_year=${tuple[0]}
   product_path=${tuple[1]}
   proto_file=${tuple[2]}
+  pagination_prefetch_pages=${tuple[3]}
+  arena_allocated_requests=${tuple[4]}
+  static_retry_policies=${tuple[5]}
   echo "Generate code from ${proto_file} to ${product_path}"
   GOOGLE_CLOUD_CPP_ENABLE_CLOG=yes "${BAZEL_BIN_DIR}"/external/com_google_protobuf/protoc \
     --plugin=protoc-gen-cpp_codegen="${BAZEL_BIN_DIR}"/generator/protoc-gen-cpp_codegen \
@@ -55,6 +63,9 @@ for proto in "${product_path_proto_path_to_generate[@]}"; do
     --proto_path="${BAZEL_OUTPUT_BASE}"/external/com_google_googleapis \
     --cpp_codegen_opt=googleapis_commit_hash="${BAZEL_DEPS_GOOGLEAPIS_HASH}" \
     --cpp_codegen_opt=copyright_year="${copyright_year}" \
+    --cpp_codegen_opt=pagination_prefetch_pages="${pagination_prefetch_pages}" \
+    --cpp_codegen_opt=arena_allocated_requests="${arena_allocated_requests}" \
+    --cpp_codegen_opt=static_retry_policies="${static_retry_policies}" \
     "${BAZEL_OUTPUT_BASE}"/external/com_google_googleapis/"${proto_file}"
 
   find "${product_path}" \( -name '*.cc' -o -name '*.h' \) -exec clang-format -i {} \;
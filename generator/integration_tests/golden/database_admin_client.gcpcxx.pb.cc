@@ -240,6 +240,51 @@ DatabaseAdminClient::ListBackupOperations(::google::test::admin::database::v1::L
   return connection_->ListBackupOperations(std::move(request));
 }
 
+future<StatusOr<::google::test::admin::database::v1::Database>>
+DatabaseAdminClient::AsyncGetDatabase(::google::test::admin::database::v1::GetDatabaseRequest const& request) {
+  return connection_->AsyncGetDatabase(request);
+}
+
+future<Status>
+DatabaseAdminClient::AsyncDropDatabase(::google::test::admin::database::v1::DropDatabaseRequest const& request) {
+  return connection_->AsyncDropDatabase(request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>
+DatabaseAdminClient::AsyncGetDatabaseDdl(::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) {
+  return connection_->AsyncGetDatabaseDdl(request);
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DatabaseAdminClient::AsyncSetIamPolicy(::google::iam::v1::SetIamPolicyRequest const& request) {
+  return connection_->AsyncSetIamPolicy(request);
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DatabaseAdminClient::AsyncGetIamPolicy(::google::iam::v1::GetIamPolicyRequest const& request) {
+  return connection_->AsyncGetIamPolicy(request);
+}
+
+future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>
+DatabaseAdminClient::AsyncTestIamPermissions(::google::iam::v1::TestIamPermissionsRequest const& request) {
+  return connection_->AsyncTestIamPermissions(request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DatabaseAdminClient::AsyncGetBackup(::google::test::admin::database::v1::GetBackupRequest const& request) {
+  return connection_->AsyncGetBackup(request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DatabaseAdminClient::AsyncUpdateBackup(::google::test::admin::database::v1::UpdateBackupRequest const& request) {
+  return connection_->AsyncUpdateBackup(request);
+}
+
+future<Status>
+DatabaseAdminClient::AsyncDeleteBackup(::google::test::admin::database::v1::DeleteBackupRequest const& request) {
+  return connection_->AsyncDeleteBackup(request);
+}
+
 }  // namespace golden
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -578,6 +578,87 @@ class DatabaseAdminClient {
   StreamRange<::google::longrunning::Operation>
   ListBackupOperations(::google::test::admin::database::v1::ListBackupOperationsRequest request);
 
+  /**
+   * Asynchronous version of `GetDatabase()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::test::admin::database::v1::Database>>
+  AsyncGetDatabase(::google::test::admin::database::v1::GetDatabaseRequest const& request);
+
+  /**
+   * Asynchronous version of `DropDatabase()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<Status>
+  AsyncDropDatabase(::google::test::admin::database::v1::DropDatabaseRequest const& request);
+
+  /**
+   * Asynchronous version of `GetDatabaseDdl()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>
+  AsyncGetDatabaseDdl(::google::test::admin::database::v1::GetDatabaseDdlRequest const& request);
+
+  /**
+   * Asynchronous version of `SetIamPolicy()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::iam::v1::Policy>>
+  AsyncSetIamPolicy(::google::iam::v1::SetIamPolicyRequest const& request);
+
+  /**
+   * Asynchronous version of `GetIamPolicy()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::iam::v1::Policy>>
+  AsyncGetIamPolicy(::google::iam::v1::GetIamPolicyRequest const& request);
+
+  /**
+   * Asynchronous version of `TestIamPermissions()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>
+  AsyncTestIamPermissions(::google::iam::v1::TestIamPermissionsRequest const& request);
+
+  /**
+   * Asynchronous version of `GetBackup()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::test::admin::database::v1::Backup>>
+  AsyncGetBackup(::google::test::admin::database::v1::GetBackupRequest const& request);
+
+  /**
+   * Asynchronous version of `UpdateBackup()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::test::admin::database::v1::Backup>>
+  AsyncUpdateBackup(::google::test::admin::database::v1::UpdateBackupRequest const& request);
+
+  /**
+   * Asynchronous version of `DeleteBackup()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<Status>
+  AsyncDeleteBackup(::google::test::admin::database::v1::DeleteBackupRequest const& request);
+
  private:
   std::shared_ptr<DatabaseAdminConnection> connection_;
 };
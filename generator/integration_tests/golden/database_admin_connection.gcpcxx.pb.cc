@@ -18,6 +18,8 @@
 
 #include "generator/integration_tests/golden/database_admin_connection.gcpcxx.pb.h"
 #include "generator/integration_tests/golden/internal/database_admin_stub_factory.gcpcxx.pb.h"
+#include "google/cloud/background_threads.h"
+#include "google/cloud/internal/async_retry_loop.h"
 #include "google/cloud/internal/pagination_range.h"
 #include "google/cloud/internal/polling_loop.h"
 #include "google/cloud/internal/retry_loop.h"
@@ -179,6 +181,76 @@ StreamRange<::google::longrunning::Operation> DatabaseAdminConnection::ListBacku
     });
 }
 
+future<StatusOr<::google::test::admin::database::v1::Database>>
+DatabaseAdminConnection::AsyncGetDatabase(
+    ::google::test::admin::database::v1::GetDatabaseRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::test::admin::database::v1::Database>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<Status>
+DatabaseAdminConnection::AsyncDropDatabase(
+    ::google::test::admin::database::v1::DropDatabaseRequest const&) {
+  return google::cloud::make_ready_future(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>
+DatabaseAdminConnection::AsyncGetDatabaseDdl(
+    ::google::test::admin::database::v1::GetDatabaseDdlRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DatabaseAdminConnection::AsyncSetIamPolicy(
+    ::google::iam::v1::SetIamPolicyRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::iam::v1::Policy>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DatabaseAdminConnection::AsyncGetIamPolicy(
+    ::google::iam::v1::GetIamPolicyRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::iam::v1::Policy>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>
+DatabaseAdminConnection::AsyncTestIamPermissions(
+    ::google::iam::v1::TestIamPermissionsRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::iam::v1::TestIamPermissionsResponse>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DatabaseAdminConnection::AsyncGetBackup(
+    ::google::test::admin::database::v1::GetBackupRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::test::admin::database::v1::Backup>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DatabaseAdminConnection::AsyncUpdateBackup(
+    ::google::test::admin::database::v1::UpdateBackupRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::test::admin::database::v1::Backup>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<Status>
+DatabaseAdminConnection::AsyncDeleteBackup(
+    ::google::test::admin::database::v1::DeleteBackupRequest const&) {
+  return google::cloud::make_ready_future(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
 namespace {
 std::unique_ptr<DatabaseAdminRetryPolicy> DefaultRetryPolicy() {
   return DatabaseAdminLimitedTimeRetryPolicy(std::chrono::minutes(30)).clone();
@@ -203,21 +275,23 @@ std::unique_ptr<PollingPolicy> DefaultPollingPolicy() {
 class DatabaseAdminConnectionImpl : public DatabaseAdminConnection {
  public:
   explicit DatabaseAdminConnectionImpl(
+      std::unique_ptr<BackgroundThreads> background,
       std::shared_ptr<golden_internal::DatabaseAdminStub> stub,
       std::unique_ptr<DatabaseAdminRetryPolicy> retry_policy,
       std::unique_ptr<BackoffPolicy> backoff_policy,
       std::unique_ptr<PollingPolicy> polling_policy,
       std::unique_ptr<DatabaseAdminConnectionIdempotencyPolicy> idempotency_policy)
-      : stub_(std::move(stub)),
+      : background_(std::move(background)), stub_(std::move(stub)),
         retry_policy_prototype_(std::move(retry_policy)),
         backoff_policy_prototype_(std::move(backoff_policy)),
         polling_policy_prototype_(std::move(polling_policy)),
         idempotency_policy_(std::move(idempotency_policy)) {}
 
   explicit DatabaseAdminConnectionImpl(
+      std::unique_ptr<BackgroundThreads> background,
       std::shared_ptr<golden_internal::DatabaseAdminStub> stub)
       : DatabaseAdminConnectionImpl(
-          std::move(stub),
+          std::move(background), std::move(stub),
           DefaultRetryPolicy(),
           DefaultBackoffPolicy(),
           DefaultPollingPolicy(),
@@ -542,6 +616,150 @@ class DatabaseAdminConnectionImpl : public DatabaseAdminConnection {
         });
   }
 
+  future<StatusOr<::google::test::admin::database::v1::Database>>
+  AsyncGetDatabase(
+      ::google::test::admin::database::v1::GetDatabaseRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->GetDatabase(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::GetDatabaseRequest const& request) {
+          return stub->AsyncGetDatabase(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<Status>
+  AsyncDropDatabase(
+      ::google::test::admin::database::v1::DropDatabaseRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->DropDatabase(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::DropDatabaseRequest const& request) {
+          return stub->AsyncDropDatabase(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>
+  AsyncGetDatabaseDdl(
+      ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->GetDatabaseDdl(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) {
+          return stub->AsyncGetDatabaseDdl(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::iam::v1::Policy>>
+  AsyncSetIamPolicy(
+      ::google::iam::v1::SetIamPolicyRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->SetIamPolicy(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::iam::v1::SetIamPolicyRequest const& request) {
+          return stub->AsyncSetIamPolicy(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::iam::v1::Policy>>
+  AsyncGetIamPolicy(
+      ::google::iam::v1::GetIamPolicyRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->GetIamPolicy(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::iam::v1::GetIamPolicyRequest const& request) {
+          return stub->AsyncGetIamPolicy(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>
+  AsyncTestIamPermissions(
+      ::google::iam::v1::TestIamPermissionsRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->TestIamPermissions(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::iam::v1::TestIamPermissionsRequest const& request) {
+          return stub->AsyncTestIamPermissions(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::Backup>>
+  AsyncGetBackup(
+      ::google::test::admin::database::v1::GetBackupRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->GetBackup(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::GetBackupRequest const& request) {
+          return stub->AsyncGetBackup(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::Backup>>
+  AsyncUpdateBackup(
+      ::google::test::admin::database::v1::UpdateBackupRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->UpdateBackup(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::UpdateBackupRequest const& request) {
+          return stub->AsyncUpdateBackup(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<Status>
+  AsyncDeleteBackup(
+      ::google::test::admin::database::v1::DeleteBackupRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->DeleteBackup(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::DeleteBackupRequest const& request) {
+          return stub->AsyncDeleteBackup(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
  private:
   template <typename MethodResponse, template<typename> class Extractor,
     typename Stub>
@@ -619,6 +837,7 @@ class DatabaseAdminConnectionImpl : public DatabaseAdminConnection {
         golden_internal::DatabaseAdminStub>(std::move(operation));
   }
 
+  std::unique_ptr<BackgroundThreads> background_;
   std::shared_ptr<golden_internal::DatabaseAdminStub> stub_;
   std::unique_ptr<DatabaseAdminRetryPolicy const> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
@@ -630,6 +849,7 @@ class DatabaseAdminConnectionImpl : public DatabaseAdminConnection {
 std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
     DatabaseAdminConnectionOptions const& options) {
   return std::make_shared<DatabaseAdminConnectionImpl>(
+      options.background_threads_factory()(),
       golden_internal::CreateDefaultDatabaseAdminStub(options));
 }
 
@@ -640,6 +860,7 @@ std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
     std::unique_ptr<PollingPolicy> polling_policy,
     std::unique_ptr<DatabaseAdminConnectionIdempotencyPolicy> idempotency_policy) {
   return std::make_shared<DatabaseAdminConnectionImpl>(
+      options.background_threads_factory()(),
       golden_internal::CreateDefaultDatabaseAdminStub(options),
       std::move(retry_policy), std::move(backoff_policy),
       std::move(polling_policy), std::move(idempotency_policy));
@@ -652,6 +873,7 @@ std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
     std::unique_ptr<PollingPolicy> polling_policy,
     std::unique_ptr<DatabaseAdminConnectionIdempotencyPolicy> idempotency_policy) {
   return std::make_shared<DatabaseAdminConnectionImpl>(
+      google::cloud::internal::DefaultBackgroundThreads(1),
       std::move(stub), std::move(retry_policy), std::move(backoff_policy),
       std::move(polling_policy), std::move(idempotency_policy));
 }
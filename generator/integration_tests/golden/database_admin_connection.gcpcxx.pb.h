@@ -24,6 +24,7 @@
 #include "google/cloud/backoff_policy.h"
 #include "google/cloud/connection_options.h"
 #include "google/cloud/future.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/polling_policy.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/stream_range.h"
@@ -55,6 +56,10 @@ using DatabaseAdminLimitedErrorCountRetryPolicy =
     google::cloud::internal::LimitedErrorCountRetryPolicy<
         golden_internal::DatabaseAdminRetryTraits>;
 
+using DatabaseAdminBudgetedRetryPolicy =
+    google::cloud::internal::BudgetedRetryPolicy<
+        golden_internal::DatabaseAdminRetryTraits>;
+
 class DatabaseAdminConnection {
  public:
   virtual ~DatabaseAdminConnection() = 0;
@@ -110,6 +115,33 @@ class DatabaseAdminConnection {
   virtual StreamRange<::google::longrunning::Operation>
   ListBackupOperations(::google::test::admin::database::v1::ListBackupOperationsRequest request);
 
+  virtual future<StatusOr<::google::test::admin::database::v1::Database>>
+  AsyncGetDatabase(::google::test::admin::database::v1::GetDatabaseRequest const& request);
+
+  virtual future<Status>
+  AsyncDropDatabase(::google::test::admin::database::v1::DropDatabaseRequest const& request);
+
+  virtual future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>
+  AsyncGetDatabaseDdl(::google::test::admin::database::v1::GetDatabaseDdlRequest const& request);
+
+  virtual future<StatusOr<::google::iam::v1::Policy>>
+  AsyncSetIamPolicy(::google::iam::v1::SetIamPolicyRequest const& request);
+
+  virtual future<StatusOr<::google::iam::v1::Policy>>
+  AsyncGetIamPolicy(::google::iam::v1::GetIamPolicyRequest const& request);
+
+  virtual future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>
+  AsyncTestIamPermissions(::google::iam::v1::TestIamPermissionsRequest const& request);
+
+  virtual future<StatusOr<::google::test::admin::database::v1::Backup>>
+  AsyncGetBackup(::google::test::admin::database::v1::GetBackupRequest const& request);
+
+  virtual future<StatusOr<::google::test::admin::database::v1::Backup>>
+  AsyncUpdateBackup(::google::test::admin::database::v1::UpdateBackupRequest const& request);
+
+  virtual future<Status>
+  AsyncDeleteBackup(::google::test::admin::database::v1::DeleteBackupRequest const& request);
+
 };
 
 std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
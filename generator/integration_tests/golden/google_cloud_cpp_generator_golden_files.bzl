@@ -33,6 +33,8 @@ google_cloud_cpp_generator_golden_files = [
     "internal/database_admin_logging_decorator.gcpcxx.pb.h",
     "internal/database_admin_metadata_decorator.gcpcxx.pb.cc",
     "internal/database_admin_metadata_decorator.gcpcxx.pb.h",
+    "internal/database_admin_metrics_decorator.gcpcxx.pb.cc",
+    "internal/database_admin_metrics_decorator.gcpcxx.pb.h",
     "internal/database_admin_stub.gcpcxx.pb.cc",
     "internal/database_admin_stub.gcpcxx.pb.h",
     "internal/database_admin_stub_factory.gcpcxx.pb.cc",
@@ -41,6 +43,8 @@ google_cloud_cpp_generator_golden_files = [
     "internal/iam_credentials_logging_decorator.gcpcxx.pb.h",
     "internal/iam_credentials_metadata_decorator.gcpcxx.pb.cc",
     "internal/iam_credentials_metadata_decorator.gcpcxx.pb.h",
+    "internal/iam_credentials_metrics_decorator.gcpcxx.pb.cc",
+    "internal/iam_credentials_metrics_decorator.gcpcxx.pb.h",
     "internal/iam_credentials_stub.gcpcxx.pb.cc",
     "internal/iam_credentials_stub.gcpcxx.pb.h",
     "internal/iam_credentials_stub_factory.gcpcxx.pb.cc",
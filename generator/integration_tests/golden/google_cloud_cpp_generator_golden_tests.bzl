@@ -22,6 +22,7 @@ google_cloud_cpp_generator_golden_tests = [
     "tests/golden_idempotency_policy_test.cc",
     "tests/golden_logging_decorator_test.cc",
     "tests/golden_metadata_decorator_test.cc",
+    "tests/golden_metrics_decorator_test.cc",
     "tests/golden_stub_factory_test.cc",
     "tests/golden_stub_test.cc",
     "tests/iam_credentials_client_test.cc",
@@ -94,6 +94,21 @@ IAMCredentialsClient::TailLogEntries(::google::test::admin::database::v1::TailLo
   return connection_->TailLogEntries(std::move(request));
 }
 
+future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+IAMCredentialsClient::AsyncGenerateAccessToken(::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+  return connection_->AsyncGenerateAccessToken(request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+IAMCredentialsClient::AsyncGenerateIdToken(::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+  return connection_->AsyncGenerateIdToken(request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+IAMCredentialsClient::AsyncWriteLogEntries(::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+  return connection_->AsyncWriteLogEntries(request);
+}
+
 }  // namespace golden
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
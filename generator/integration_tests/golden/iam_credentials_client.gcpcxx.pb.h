@@ -234,6 +234,33 @@ class IAMCredentialsClient {
   StreamRange<::google::test::admin::database::v1::TailLogEntriesResponse>
   TailLogEntries(::google::test::admin::database::v1::TailLogEntriesRequest request);
 
+  /**
+   * Asynchronous version of `GenerateAccessToken()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(::google::test::admin::database::v1::GenerateAccessTokenRequest const& request);
+
+  /**
+   * Asynchronous version of `GenerateIdToken()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(::google::test::admin::database::v1::GenerateIdTokenRequest const& request);
+
+  /**
+   * Asynchronous version of `WriteLogEntries()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(::google::test::admin::database::v1::WriteLogEntriesRequest const& request);
+
  private:
   std::shared_ptr<IAMCredentialsConnection> connection_;
 };
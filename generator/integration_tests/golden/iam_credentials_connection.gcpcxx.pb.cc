@@ -18,6 +18,8 @@
 
 #include "generator/integration_tests/golden/iam_credentials_connection.gcpcxx.pb.h"
 #include "generator/integration_tests/golden/internal/iam_credentials_stub_factory.gcpcxx.pb.h"
+#include "google/cloud/background_threads.h"
+#include "google/cloud/internal/async_retry_loop.h"
 #include "google/cloud/internal/pagination_range.h"
 #include "google/cloud/internal/resumable_streaming_read_rpc.h"
 #include "google/cloud/internal/retry_loop.h"
@@ -83,6 +85,30 @@ StreamRange<::google::test::admin::database::v1::TailLogEntriesResponse> IAMCred
       );
 }
 
+future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+IAMCredentialsConnection::AsyncGenerateAccessToken(
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+IAMCredentialsConnection::AsyncGenerateIdToken(
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+IAMCredentialsConnection::AsyncWriteLogEntries(
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const&) {
+  return google::cloud::make_ready_future<
+    StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>(
+    Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
 namespace {
 std::unique_ptr<IAMCredentialsRetryPolicy> DefaultRetryPolicy() {
   return IAMCredentialsLimitedTimeRetryPolicy(std::chrono::minutes(30)).clone();
@@ -98,19 +124,21 @@ std::unique_ptr<BackoffPolicy> DefaultBackoffPolicy() {
 class IAMCredentialsConnectionImpl : public IAMCredentialsConnection {
  public:
   explicit IAMCredentialsConnectionImpl(
+      std::unique_ptr<BackgroundThreads> background,
       std::shared_ptr<golden_internal::IAMCredentialsStub> stub,
       std::unique_ptr<IAMCredentialsRetryPolicy> retry_policy,
       std::unique_ptr<BackoffPolicy> backoff_policy,
       std::unique_ptr<IAMCredentialsConnectionIdempotencyPolicy> idempotency_policy)
-      : stub_(std::move(stub)),
+      : background_(std::move(background)), stub_(std::move(stub)),
         retry_policy_prototype_(std::move(retry_policy)),
         backoff_policy_prototype_(std::move(backoff_policy)),
         idempotency_policy_(std::move(idempotency_policy)) {}
 
   explicit IAMCredentialsConnectionImpl(
+      std::unique_ptr<BackgroundThreads> background,
       std::shared_ptr<golden_internal::IAMCredentialsStub> stub)
       : IAMCredentialsConnectionImpl(
-          std::move(stub),
+          std::move(background), std::move(stub),
           DefaultRetryPolicy(),
           DefaultBackoffPolicy(),
           MakeDefaultIAMCredentialsConnectionIdempotencyPolicy()) {}
@@ -216,7 +244,56 @@ class IAMCredentialsConnectionImpl : public IAMCredentialsConnection {
         [resumable]{return resumable->Read();}));
   }
 
+  future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+      ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->GenerateAccessToken(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+          return stub->AsyncGenerateAccessToken(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(
+      ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->GenerateIdToken(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+          return stub->AsyncGenerateIdToken(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+      ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->WriteLogEntries(request),
+        background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+          return stub->AsyncWriteLogEntries(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
  private:
+  std::unique_ptr<BackgroundThreads> background_;
   std::shared_ptr<golden_internal::IAMCredentialsStub> stub_;
   std::unique_ptr<IAMCredentialsRetryPolicy const> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
@@ -227,6 +304,7 @@ class IAMCredentialsConnectionImpl : public IAMCredentialsConnection {
 std::shared_ptr<IAMCredentialsConnection> MakeIAMCredentialsConnection(
     IAMCredentialsConnectionOptions const& options) {
   return std::make_shared<IAMCredentialsConnectionImpl>(
+      options.background_threads_factory()(),
       golden_internal::CreateDefaultIAMCredentialsStub(options));
 }
 
@@ -236,6 +314,7 @@ std::shared_ptr<IAMCredentialsConnection> MakeIAMCredentialsConnection(
     std::unique_ptr<BackoffPolicy> backoff_policy,
     std::unique_ptr<IAMCredentialsConnectionIdempotencyPolicy> idempotency_policy) {
   return std::make_shared<IAMCredentialsConnectionImpl>(
+      options.background_threads_factory()(),
       golden_internal::CreateDefaultIAMCredentialsStub(options),
       std::move(retry_policy), std::move(backoff_policy),
       std::move(idempotency_policy));
@@ -247,6 +326,7 @@ std::shared_ptr<IAMCredentialsConnection> MakeIAMCredentialsConnection(
     std::unique_ptr<BackoffPolicy> backoff_policy,
     std::unique_ptr<IAMCredentialsConnectionIdempotencyPolicy> idempotency_policy) {
   return std::make_shared<IAMCredentialsConnectionImpl>(
+      google::cloud::internal::DefaultBackgroundThreads(1),
       std::move(stub), std::move(retry_policy), std::move(backoff_policy),
       std::move(idempotency_policy));
 }
@@ -23,6 +23,8 @@
 #include "generator/integration_tests/golden/retry_traits.h"
 #include "google/cloud/backoff_policy.h"
 #include "google/cloud/connection_options.h"
+#include "google/cloud/future.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/stream_range.h"
 #include "google/cloud/version.h"
@@ -52,6 +54,10 @@ using IAMCredentialsLimitedErrorCountRetryPolicy =
     google::cloud::internal::LimitedErrorCountRetryPolicy<
         golden_internal::IAMCredentialsRetryTraits>;
 
+using IAMCredentialsBudgetedRetryPolicy =
+    google::cloud::internal::BudgetedRetryPolicy<
+        golden_internal::IAMCredentialsRetryTraits>;
+
 void IAMCredentialsTailLogEntriesStreamingUpdater(
     ::google::test::admin::database::v1::TailLogEntriesResponse const& response,
     ::google::test::admin::database::v1::TailLogEntriesRequest& request);
@@ -75,6 +81,15 @@ class IAMCredentialsConnection {
   virtual StreamRange<::google::test::admin::database::v1::TailLogEntriesResponse>
   TailLogEntries(::google::test::admin::database::v1::TailLogEntriesRequest request);
 
+  virtual future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(::google::test::admin::database::v1::GenerateAccessTokenRequest const& request);
+
+  virtual future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(::google::test::admin::database::v1::GenerateIdTokenRequest const& request);
+
+  virtual future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(::google::test::admin::database::v1::WriteLogEntriesRequest const& request);
+
 };
 
 std::shared_ptr<IAMCredentialsConnection> MakeIAMCredentialsConnection(
@@ -167,6 +167,87 @@ DatabaseAdminMetadata::ListBackupOperations(
   return child_->ListBackupOperations(context, request);
 }
 
+future<StatusOr<::google::test::admin::database::v1::Database>>
+DatabaseAdminMetadata::AsyncGetDatabase(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetDatabaseRequest const& request) {
+  SetMetadata(*context, "name=" + request.name());
+  return child_->AsyncGetDatabase(cq, std::move(context), request);
+}
+
+future<Status>
+DatabaseAdminMetadata::AsyncDropDatabase(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::DropDatabaseRequest const& request) {
+  SetMetadata(*context, "database=" + request.database());
+  return child_->AsyncDropDatabase(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>
+DatabaseAdminMetadata::AsyncGetDatabaseDdl(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) {
+  SetMetadata(*context, "database=" + request.database());
+  return child_->AsyncGetDatabaseDdl(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DatabaseAdminMetadata::AsyncSetIamPolicy(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::SetIamPolicyRequest const& request) {
+  SetMetadata(*context, "resource=" + request.resource());
+  return child_->AsyncSetIamPolicy(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DatabaseAdminMetadata::AsyncGetIamPolicy(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::GetIamPolicyRequest const& request) {
+  SetMetadata(*context, "resource=" + request.resource());
+  return child_->AsyncGetIamPolicy(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>
+DatabaseAdminMetadata::AsyncTestIamPermissions(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::TestIamPermissionsRequest const& request) {
+  SetMetadata(*context, "resource=" + request.resource());
+  return child_->AsyncTestIamPermissions(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DatabaseAdminMetadata::AsyncGetBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetBackupRequest const& request) {
+  SetMetadata(*context, "name=" + request.name());
+  return child_->AsyncGetBackup(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DatabaseAdminMetadata::AsyncUpdateBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::UpdateBackupRequest const& request) {
+  SetMetadata(*context, "backup.name=" + request.backup().name());
+  return child_->AsyncUpdateBackup(cq, std::move(context), request);
+}
+
+future<Status>
+DatabaseAdminMetadata::AsyncDeleteBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::DeleteBackupRequest const& request) {
+  SetMetadata(*context, "name=" + request.name());
+  return child_->AsyncDeleteBackup(cq, std::move(context), request);
+}
+
 StatusOr<google::longrunning::Operation> DatabaseAdminMetadata::GetOperation(
     grpc::ClientContext& context,
     google::longrunning::GetOperationRequest const& request) {
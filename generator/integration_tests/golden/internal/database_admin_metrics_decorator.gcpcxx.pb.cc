@@ -0,0 +1,398 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by the Codegen C++ plugin.
+// If you make any local changes, they will be lost.
+// source: generator/integration_tests/test.proto
+#include "generator/integration_tests/golden/internal/database_admin_metrics_decorator.gcpcxx.pb.h"
+#include "google/cloud/instrumentation.h"
+#include "google/cloud/internal/metrics_wrapper.h"
+#include "google/cloud/status_or.h"
+#include <generator/integration_tests/test.grpc.pb.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace golden_internal {
+
+DatabaseAdminMetrics::DatabaseAdminMetrics(
+    std::shared_ptr<DatabaseAdminStub> child)
+    : child_(std::move(child)) {}
+
+StatusOr<::google::test::admin::database::v1::ListDatabasesResponse>
+DatabaseAdminMetrics::ListDatabases(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::ListDatabasesRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::ListDatabasesRequest const& request) {
+        return child_->ListDatabases(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/ListDatabases");
+}
+
+StatusOr<::google::longrunning::Operation>
+DatabaseAdminMetrics::CreateDatabase(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::CreateDatabaseRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::CreateDatabaseRequest const& request) {
+        return child_->CreateDatabase(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/CreateDatabase");
+}
+
+StatusOr<::google::test::admin::database::v1::Database>
+DatabaseAdminMetrics::GetDatabase(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::GetDatabaseRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::GetDatabaseRequest const& request) {
+        return child_->GetDatabase(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/GetDatabase");
+}
+
+StatusOr<::google::longrunning::Operation>
+DatabaseAdminMetrics::UpdateDatabaseDdl(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::UpdateDatabaseDdlRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::UpdateDatabaseDdlRequest const& request) {
+        return child_->UpdateDatabaseDdl(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/UpdateDatabaseDdl");
+}
+
+Status
+DatabaseAdminMetrics::DropDatabase(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::DropDatabaseRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::DropDatabaseRequest const& request) {
+        return child_->DropDatabase(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/DropDatabase");
+}
+
+StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>
+DatabaseAdminMetrics::GetDatabaseDdl(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) {
+        return child_->GetDatabaseDdl(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/GetDatabaseDdl");
+}
+
+StatusOr<::google::iam::v1::Policy>
+DatabaseAdminMetrics::SetIamPolicy(
+    grpc::ClientContext& context,
+    ::google::iam::v1::SetIamPolicyRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::iam::v1::SetIamPolicyRequest const& request) {
+        return child_->SetIamPolicy(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/SetIamPolicy");
+}
+
+StatusOr<::google::iam::v1::Policy>
+DatabaseAdminMetrics::GetIamPolicy(
+    grpc::ClientContext& context,
+    ::google::iam::v1::GetIamPolicyRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::iam::v1::GetIamPolicyRequest const& request) {
+        return child_->GetIamPolicy(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/GetIamPolicy");
+}
+
+StatusOr<::google::iam::v1::TestIamPermissionsResponse>
+DatabaseAdminMetrics::TestIamPermissions(
+    grpc::ClientContext& context,
+    ::google::iam::v1::TestIamPermissionsRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::iam::v1::TestIamPermissionsRequest const& request) {
+        return child_->TestIamPermissions(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/TestIamPermissions");
+}
+
+StatusOr<::google::longrunning::Operation>
+DatabaseAdminMetrics::CreateBackup(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::CreateBackupRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::CreateBackupRequest const& request) {
+        return child_->CreateBackup(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/CreateBackup");
+}
+
+StatusOr<::google::test::admin::database::v1::Backup>
+DatabaseAdminMetrics::GetBackup(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::GetBackupRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::GetBackupRequest const& request) {
+        return child_->GetBackup(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/GetBackup");
+}
+
+StatusOr<::google::test::admin::database::v1::Backup>
+DatabaseAdminMetrics::UpdateBackup(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::UpdateBackupRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::UpdateBackupRequest const& request) {
+        return child_->UpdateBackup(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/UpdateBackup");
+}
+
+Status
+DatabaseAdminMetrics::DeleteBackup(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::DeleteBackupRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::DeleteBackupRequest const& request) {
+        return child_->DeleteBackup(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/DeleteBackup");
+}
+
+StatusOr<::google::test::admin::database::v1::ListBackupsResponse>
+DatabaseAdminMetrics::ListBackups(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::ListBackupsRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::ListBackupsRequest const& request) {
+        return child_->ListBackups(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/ListBackups");
+}
+
+StatusOr<::google::longrunning::Operation>
+DatabaseAdminMetrics::RestoreDatabase(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::RestoreDatabaseRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::RestoreDatabaseRequest const& request) {
+        return child_->RestoreDatabase(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/RestoreDatabase");
+}
+
+StatusOr<::google::test::admin::database::v1::ListDatabaseOperationsResponse>
+DatabaseAdminMetrics::ListDatabaseOperations(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::ListDatabaseOperationsRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::ListDatabaseOperationsRequest const& request) {
+        return child_->ListDatabaseOperations(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/ListDatabaseOperations");
+}
+
+StatusOr<::google::test::admin::database::v1::ListBackupOperationsResponse>
+DatabaseAdminMetrics::ListBackupOperations(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::ListBackupOperationsRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::ListBackupOperationsRequest const& request) {
+        return child_->ListBackupOperations(context, request);
+      },
+      context, request, "google.test.admin.database.v1.DatabaseAdmin/ListBackupOperations");
+}
+
+future<StatusOr<::google::test::admin::database::v1::Database>>
+DatabaseAdminMetrics::AsyncGetDatabase(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetDatabaseRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::GetDatabaseRequest const& request) {
+        return child_->AsyncGetDatabase(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/GetDatabase");
+}
+
+future<Status>
+DatabaseAdminMetrics::AsyncDropDatabase(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::DropDatabaseRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::DropDatabaseRequest const& request) {
+        return child_->AsyncDropDatabase(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/DropDatabase");
+}
+
+future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>
+DatabaseAdminMetrics::AsyncGetDatabaseDdl(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) {
+        return child_->AsyncGetDatabaseDdl(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/GetDatabaseDdl");
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DatabaseAdminMetrics::AsyncSetIamPolicy(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::SetIamPolicyRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::v1::SetIamPolicyRequest const& request) {
+        return child_->AsyncSetIamPolicy(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/SetIamPolicy");
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DatabaseAdminMetrics::AsyncGetIamPolicy(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::GetIamPolicyRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::v1::GetIamPolicyRequest const& request) {
+        return child_->AsyncGetIamPolicy(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/GetIamPolicy");
+}
+
+future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>
+DatabaseAdminMetrics::AsyncTestIamPermissions(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::TestIamPermissionsRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::v1::TestIamPermissionsRequest const& request) {
+        return child_->AsyncTestIamPermissions(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/TestIamPermissions");
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DatabaseAdminMetrics::AsyncGetBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetBackupRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::GetBackupRequest const& request) {
+        return child_->AsyncGetBackup(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/GetBackup");
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DatabaseAdminMetrics::AsyncUpdateBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::UpdateBackupRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::UpdateBackupRequest const& request) {
+        return child_->AsyncUpdateBackup(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/UpdateBackup");
+}
+
+future<Status>
+DatabaseAdminMetrics::AsyncDeleteBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::DeleteBackupRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::DeleteBackupRequest const& request) {
+        return child_->AsyncDeleteBackup(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.DatabaseAdmin/DeleteBackup");
+}
+
+StatusOr<google::longrunning::Operation> DatabaseAdminMetrics::GetOperation(
+    grpc::ClientContext& context,
+    google::longrunning::GetOperationRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             google::longrunning::GetOperationRequest const& request) {
+        return child_->GetOperation(context, request);
+      },
+      context, request, "google.longrunning.Operations/GetOperation");
+}
+
+Status DatabaseAdminMetrics::CancelOperation(
+    grpc::ClientContext& context,
+    google::longrunning::CancelOperationRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             google::longrunning::CancelOperationRequest const& request) {
+        return child_->CancelOperation(context, request);
+      },
+      context, request, "google.longrunning.Operations/CancelOperation");
+}
+}  // namespace golden_internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
@@ -251,6 +251,138 @@ DefaultDatabaseAdminStub::ListBackupOperations(
     return response;
 }
 
+future<StatusOr<::google::test::admin::database::v1::Database>>
+DefaultDatabaseAdminStub::AsyncGetDatabase(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetDatabaseRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::GetDatabaseRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncGetDatabase(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<Status>
+DefaultDatabaseAdminStub::AsyncDropDatabase(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::DropDatabaseRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::DropDatabaseRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncDropDatabase(context, request, cq);
+      },
+      request, std::move(context))
+      .then([](future<StatusOr<::google::protobuf::Empty>> f) {
+        return f.get().status();
+      });
+}
+
+future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>
+DefaultDatabaseAdminStub::AsyncGetDatabaseDdl(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncGetDatabaseDdl(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DefaultDatabaseAdminStub::AsyncSetIamPolicy(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::SetIamPolicyRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::iam::v1::SetIamPolicyRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncSetIamPolicy(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::iam::v1::Policy>>
+DefaultDatabaseAdminStub::AsyncGetIamPolicy(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::GetIamPolicyRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::iam::v1::GetIamPolicyRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncGetIamPolicy(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>
+DefaultDatabaseAdminStub::AsyncTestIamPermissions(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::v1::TestIamPermissionsRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::iam::v1::TestIamPermissionsRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncTestIamPermissions(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DefaultDatabaseAdminStub::AsyncGetBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GetBackupRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::GetBackupRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncGetBackup(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::test::admin::database::v1::Backup>>
+DefaultDatabaseAdminStub::AsyncUpdateBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::UpdateBackupRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::UpdateBackupRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncUpdateBackup(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<Status>
+DefaultDatabaseAdminStub::AsyncDeleteBackup(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::DeleteBackupRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::DeleteBackupRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncDeleteBackup(context, request, cq);
+      },
+      request, std::move(context))
+      .then([](future<StatusOr<::google::protobuf::Empty>> f) {
+        return f.get().status();
+      });
+}
+
 /// Poll a long-running operation.
 StatusOr<google::longrunning::Operation>
 DefaultDatabaseAdminStub::GetOperation(
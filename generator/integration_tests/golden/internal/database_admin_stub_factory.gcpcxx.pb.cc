@@ -19,29 +19,320 @@
 #include "generator/integration_tests/golden/internal/database_admin_stub_factory.gcpcxx.pb.h"
 #include "generator/integration_tests/golden/internal/database_admin_logging_decorator.gcpcxx.pb.h"
 #include "generator/integration_tests/golden/internal/database_admin_metadata_decorator.gcpcxx.pb.h"
+#include "generator/integration_tests/golden/internal/database_admin_metrics_decorator.gcpcxx.pb.h"
 #include "generator/integration_tests/golden/internal/database_admin_stub.gcpcxx.pb.h"
+#include "google/cloud/internal/channel_cache.h"
+#include "google/cloud/internal/channel_pool.h"
 #include "google/cloud/log.h"
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace google {
 namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
 namespace golden_internal {
 
+namespace {
+
+/**
+ * Sends each call to the stub whose channel has the fewest outstanding
+ * requests.
+ *
+ * Streaming calls are balanced when they start, but are not counted as
+ * outstanding requests while the stream is open.
+ */
+class DatabaseAdminStubPool : public DatabaseAdminStub {
+ public:
+  DatabaseAdminStubPool(
+      std::shared_ptr<google::cloud::internal::ChannelPool> pool,
+      std::vector<std::shared_ptr<DatabaseAdminStub>> children)
+      : pool_(std::move(pool)), children_(std::move(children)) {}
+
+  StatusOr<::google::test::admin::database::v1::ListDatabasesResponse> ListDatabases(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::ListDatabasesRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->ListDatabases(context, request);
+  }
+
+  StatusOr<::google::longrunning::Operation> CreateDatabase(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::CreateDatabaseRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->CreateDatabase(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::Database> GetDatabase(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::GetDatabaseRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->GetDatabase(context, request);
+  }
+
+  StatusOr<::google::longrunning::Operation> UpdateDatabaseDdl(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::UpdateDatabaseDdlRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->UpdateDatabaseDdl(context, request);
+  }
+
+  Status DropDatabase(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::DropDatabaseRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->DropDatabase(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse> GetDatabaseDdl(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->GetDatabaseDdl(context, request);
+  }
+
+  StatusOr<::google::iam::v1::Policy> SetIamPolicy(
+      grpc::ClientContext& context,
+      ::google::iam::v1::SetIamPolicyRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->SetIamPolicy(context, request);
+  }
+
+  StatusOr<::google::iam::v1::Policy> GetIamPolicy(
+      grpc::ClientContext& context,
+      ::google::iam::v1::GetIamPolicyRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->GetIamPolicy(context, request);
+  }
+
+  StatusOr<::google::iam::v1::TestIamPermissionsResponse> TestIamPermissions(
+      grpc::ClientContext& context,
+      ::google::iam::v1::TestIamPermissionsRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->TestIamPermissions(context, request);
+  }
+
+  StatusOr<::google::longrunning::Operation> CreateBackup(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::CreateBackupRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->CreateBackup(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::Backup> GetBackup(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::GetBackupRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->GetBackup(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::Backup> UpdateBackup(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::UpdateBackupRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->UpdateBackup(context, request);
+  }
+
+  Status DeleteBackup(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::DeleteBackupRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->DeleteBackup(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::ListBackupsResponse> ListBackups(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::ListBackupsRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->ListBackups(context, request);
+  }
+
+  StatusOr<::google::longrunning::Operation> RestoreDatabase(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::RestoreDatabaseRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->RestoreDatabase(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::ListDatabaseOperationsResponse> ListDatabaseOperations(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::ListDatabaseOperationsRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->ListDatabaseOperations(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::ListBackupOperationsResponse> ListBackupOperations(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::ListBackupOperationsRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->ListBackupOperations(context, request);
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::Database>> AsyncGetDatabase(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::GetDatabaseRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncGetDatabase(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::test::admin::database::v1::Database>> f) {
+          return f.get();
+        });
+  }
+
+  future<Status> AsyncDropDatabase(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::DropDatabaseRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncDropDatabase(cq, std::move(context), request)
+        .then([lease](future<Status> f) { return f.get(); });
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>> AsyncGetDatabaseDdl(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::GetDatabaseDdlRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncGetDatabaseDdl(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>> f) {
+          return f.get();
+        });
+  }
+
+  future<StatusOr<::google::iam::v1::Policy>> AsyncSetIamPolicy(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::v1::SetIamPolicyRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncSetIamPolicy(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::iam::v1::Policy>> f) {
+          return f.get();
+        });
+  }
+
+  future<StatusOr<::google::iam::v1::Policy>> AsyncGetIamPolicy(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::v1::GetIamPolicyRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncGetIamPolicy(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::iam::v1::Policy>> f) {
+          return f.get();
+        });
+  }
+
+  future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>> AsyncTestIamPermissions(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::v1::TestIamPermissionsRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncTestIamPermissions(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>> f) {
+          return f.get();
+        });
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::Backup>> AsyncGetBackup(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::GetBackupRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncGetBackup(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::test::admin::database::v1::Backup>> f) {
+          return f.get();
+        });
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::Backup>> AsyncUpdateBackup(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::UpdateBackupRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncUpdateBackup(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::test::admin::database::v1::Backup>> f) {
+          return f.get();
+        });
+  }
+
+  future<Status> AsyncDeleteBackup(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::DeleteBackupRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncDeleteBackup(cq, std::move(context), request)
+        .then([lease](future<Status> f) { return f.get(); });
+  }
+
+  StatusOr<google::longrunning::Operation> GetOperation(
+      grpc::ClientContext& client_context,
+      google::longrunning::GetOperationRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->GetOperation(client_context, request);
+  }
+
+  Status CancelOperation(
+      grpc::ClientContext& client_context,
+      google::longrunning::CancelOperationRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->CancelOperation(client_context,
+                                                     request);
+  }
+
+ private:
+  std::shared_ptr<google::cloud::internal::ChannelPool> pool_;
+  std::vector<std::shared_ptr<DatabaseAdminStub>> children_;
+};
+
+}  // namespace
+
 std::shared_ptr<DatabaseAdminStub>
 CreateDefaultDatabaseAdminStub(golden::DatabaseAdminConnectionOptions const& options) {
-  auto channel =
-      grpc::CreateCustomChannel(options.endpoint(), options.credentials(),
-                                options.CreateChannelArguments());
-  auto service_grpc_stub =
-      ::google::test::admin::database::v1::DatabaseAdmin::NewStub(channel);
-  auto longrunning_grpc_stub =
-      google::longrunning::Operations::NewStub(channel);
+  auto const num_channels = (std::max)(options.num_channels(), 1);
+  std::vector<std::shared_ptr<grpc::Channel>> channels;
+  std::vector<std::shared_ptr<DatabaseAdminStub>> children;
+  for (int id = 0; id != num_channels; ++id) {
+    auto arguments = options.CreateChannelArguments();
+    // A different `grpc.channel_id` value gives each channel its own
+    // connection.
+    arguments.SetInt("grpc.channel_id", id);
+    auto channel = google::cloud::internal::CreateCustomChannel(
+        options.endpoint(), options.credentials(), arguments,
+        options.channel_cache_enabled());
+    auto service_grpc_stub =
+        ::google::test::admin::database::v1::DatabaseAdmin::NewStub(channel);
+    auto longrunning_grpc_stub =
+        google::longrunning::Operations::NewStub(channel);
+    children.push_back(std::make_shared<DefaultDatabaseAdminStub>(
+        std::move(service_grpc_stub), std::move(longrunning_grpc_stub))));
+    channels.push_back(std::move(channel));
+  }
+  auto pool = std::make_shared<google::cloud::internal::ChannelPool>(
+      std::move(channels));
+  pool->WarmUp();
 
   std::shared_ptr<DatabaseAdminStub> stub =
-      std::make_shared<DefaultDatabaseAdminStub>(
-          std::move(service_grpc_stub), std::move(longrunning_grpc_stub));
+      std::make_shared<DatabaseAdminStubPool>(std::move(pool),
+                                              std::move(children));
 
+  stub = std::make_shared<DatabaseAdminMetrics>(std::move(stub));
   stub = std::make_shared<DatabaseAdminMetadata>(std::move(stub));
 
   if (options.tracing_enabled("rpc")) {
@@ -103,6 +103,48 @@ IAMCredentialsLogging::TailLogEntries(
       context, request, __func__, tracing_options_);
 }
 
+future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+IAMCredentialsLogging::AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+        return child_->AsyncGenerateAccessToken(cq, std::move(context), request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
+future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+IAMCredentialsLogging::AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+        return child_->AsyncGenerateIdToken(cq, std::move(context), request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
+future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+IAMCredentialsLogging::AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+        return child_->AsyncWriteLogEntries(cq, std::move(context), request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
 }  // namespace golden_internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
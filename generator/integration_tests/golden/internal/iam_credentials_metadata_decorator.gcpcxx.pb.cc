@@ -71,6 +71,33 @@ IAMCredentialsMetadata::TailLogEntries(
   return child_->TailLogEntries(context, request);
 }
 
+future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+IAMCredentialsMetadata::AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+  SetMetadata(*context, "name=" + request.name());
+  return child_->AsyncGenerateAccessToken(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+IAMCredentialsMetadata::AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+  SetMetadata(*context, {});
+  return child_->AsyncGenerateIdToken(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+IAMCredentialsMetadata::AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+  SetMetadata(*context, {});
+  return child_->AsyncWriteLogEntries(cq, std::move(context), request);
+}
+
 void IAMCredentialsMetadata::SetMetadata(grpc::ClientContext& context,
                                         std::string const& request_params) {
   context.AddMetadata("x-goog-request-params", request_params);
@@ -54,6 +54,21 @@ class IAMCredentialsMetadata : public IAMCredentialsStub {
     grpc::ClientContext& context,
     ::google::test::admin::database::v1::TailLogEntriesRequest const& request) override;
 
+  future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>> AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) override;
+
+  future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>> AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) override;
+
+  future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>> AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) override;
+
  private:
   void SetMetadata(grpc::ClientContext& context,
                    std::string const& request_params);
@@ -0,0 +1,143 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by the Codegen C++ plugin.
+// If you make any local changes, they will be lost.
+// source: generator/integration_tests/test.proto
+#include "generator/integration_tests/golden/internal/iam_credentials_metrics_decorator.gcpcxx.pb.h"
+#include "google/cloud/instrumentation.h"
+#include "google/cloud/internal/metrics_wrapper.h"
+#include "google/cloud/internal/streaming_read_rpc_metrics.h"
+#include "google/cloud/status_or.h"
+#include <generator/integration_tests/test.grpc.pb.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace golden_internal {
+
+IAMCredentialsMetrics::IAMCredentialsMetrics(
+    std::shared_ptr<IAMCredentialsStub> child)
+    : child_(std::move(child)) {}
+
+StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>
+IAMCredentialsMetrics::GenerateAccessToken(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+        return child_->GenerateAccessToken(context, request);
+      },
+      context, request, "google.test.admin.database.v1.IAMCredentials/GenerateAccessToken");
+}
+
+StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>
+IAMCredentialsMetrics::GenerateIdToken(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+        return child_->GenerateIdToken(context, request);
+      },
+      context, request, "google.test.admin.database.v1.IAMCredentials/GenerateIdToken");
+}
+
+StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>
+IAMCredentialsMetrics::WriteLogEntries(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+        return child_->WriteLogEntries(context, request);
+      },
+      context, request, "google.test.admin.database.v1.IAMCredentials/WriteLogEntries");
+}
+
+StatusOr<::google::test::admin::database::v1::ListLogsResponse>
+IAMCredentialsMetrics::ListLogs(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::ListLogsRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::test::admin::database::v1::ListLogsRequest const& request) {
+        return child_->ListLogs(context, request);
+      },
+      context, request, "google.test.admin.database.v1.IAMCredentials/ListLogs");
+}
+
+std::unique_ptr<internal::StreamingReadRpc<::google::test::admin::database::v1::TailLogEntriesResponse>>
+IAMCredentialsMetrics::TailLogEntries(
+    grpc::ClientContext& context,
+    ::google::test::admin::database::v1::TailLogEntriesRequest const& request) {
+  auto stream = child_->TailLogEntries(context, request);
+  if (!google::cloud::internal::InstrumentationEnabled()) return stream;
+  return absl::make_unique<internal::StreamingReadRpcMetrics<
+      ::google::test::admin::database::v1::TailLogEntriesResponse>>(
+      std::move(stream), "google.test.admin.database.v1.IAMCredentials/TailLogEntries");
+}
+
+future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+IAMCredentialsMetrics::AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+        return child_->AsyncGenerateAccessToken(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.IAMCredentials/GenerateAccessToken");
+}
+
+future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+IAMCredentialsMetrics::AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+        return child_->AsyncGenerateIdToken(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.IAMCredentials/GenerateIdToken");
+}
+
+future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+IAMCredentialsMetrics::AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+        return child_->AsyncWriteLogEntries(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.test.admin.database.v1.IAMCredentials/WriteLogEntries");
+}
+
+}  // namespace golden_internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
@@ -93,6 +93,48 @@ DefaultIAMCredentialsStub::TailLogEntries(
       std::move(context), std::move(stream));
 }
 
+future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+DefaultIAMCredentialsStub::AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncGenerateAccessToken(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+DefaultIAMCredentialsStub::AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::GenerateIdTokenRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncGenerateIdToken(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+DefaultIAMCredentialsStub::AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::test::admin::database::v1::WriteLogEntriesRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncWriteLogEntries(context, request, cq);
+      },
+      request, std::move(context));
+}
+
 }  // namespace golden_internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -18,6 +18,8 @@
 #ifndef GOOGLE_CLOUD_CPP_GENERATOR_INTEGRATION_TESTS_GOLDEN_INTERNAL_IAM_CREDENTIALS_STUB_GCPCXX_PB_H
 #define GOOGLE_CLOUD_CPP_GENERATOR_INTEGRATION_TESTS_GOLDEN_INTERNAL_IAM_CREDENTIALS_STUB_GCPCXX_PB_H
 
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
 #include "google/cloud/internal/streaming_read_rpc.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/version.h"
@@ -54,6 +56,21 @@ class IAMCredentialsStub {
     grpc::ClientContext& context,
     ::google::test::admin::database::v1::TailLogEntriesRequest const& request) = 0;
 
+  virtual future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>> AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) = 0;
+
+  virtual future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>> AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) = 0;
+
+  virtual future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>> AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) = 0;
+
 };
 
 class DefaultIAMCredentialsStub : public IAMCredentialsStub {
@@ -87,6 +104,24 @@ class DefaultIAMCredentialsStub : public IAMCredentialsStub {
     grpc::ClientContext& client_context,
     ::google::test::admin::database::v1::TailLogEntriesRequest const& request) override;
 
+  future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) override;
+
+  future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) override;
+
+  future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) override;
+
  private:
   std::unique_ptr<::google::test::admin::database::v1::IAMCredentials::StubInterface> grpc_stub_;
 };
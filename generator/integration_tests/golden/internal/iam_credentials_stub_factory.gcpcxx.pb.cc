@@ -19,26 +19,138 @@
 #include "generator/integration_tests/golden/internal/iam_credentials_stub_factory.gcpcxx.pb.h"
 #include "generator/integration_tests/golden/internal/iam_credentials_logging_decorator.gcpcxx.pb.h"
 #include "generator/integration_tests/golden/internal/iam_credentials_metadata_decorator.gcpcxx.pb.h"
+#include "generator/integration_tests/golden/internal/iam_credentials_metrics_decorator.gcpcxx.pb.h"
 #include "generator/integration_tests/golden/internal/iam_credentials_stub.gcpcxx.pb.h"
+#include "google/cloud/internal/channel_cache.h"
+#include "google/cloud/internal/channel_pool.h"
 #include "google/cloud/log.h"
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace google {
 namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
 namespace golden_internal {
 
+namespace {
+
+/**
+ * Sends each call to the stub whose channel has the fewest outstanding
+ * requests.
+ *
+ * Streaming calls are balanced when they start, but are not counted as
+ * outstanding requests while the stream is open.
+ */
+class IAMCredentialsStubPool : public IAMCredentialsStub {
+ public:
+  IAMCredentialsStubPool(
+      std::shared_ptr<google::cloud::internal::ChannelPool> pool,
+      std::vector<std::shared_ptr<IAMCredentialsStub>> children)
+      : pool_(std::move(pool)), children_(std::move(children)) {}
+
+  StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse> GenerateAccessToken(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->GenerateAccessToken(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse> GenerateIdToken(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->GenerateIdToken(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse> WriteLogEntries(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->WriteLogEntries(context, request);
+  }
+
+  StatusOr<::google::test::admin::database::v1::ListLogsResponse> ListLogs(
+      grpc::ClientContext& context,
+      ::google::test::admin::database::v1::ListLogsRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->ListLogs(context, request);
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>> AsyncGenerateAccessToken(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::GenerateAccessTokenRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncGenerateAccessToken(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>> f) {
+          return f.get();
+        });
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>> AsyncGenerateIdToken(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::GenerateIdTokenRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncGenerateIdToken(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>> f) {
+          return f.get();
+        });
+  }
+
+  future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>> AsyncWriteLogEntries(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::test::admin::database::v1::WriteLogEntriesRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncWriteLogEntries(cq, std::move(context), request)
+        .then([lease](future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>> f) {
+          return f.get();
+        });
+  }
+
+ private:
+  std::shared_ptr<google::cloud::internal::ChannelPool> pool_;
+  std::vector<std::shared_ptr<IAMCredentialsStub>> children_;
+};
+
+}  // namespace
+
 std::shared_ptr<IAMCredentialsStub>
 CreateDefaultIAMCredentialsStub(golden::IAMCredentialsConnectionOptions const& options) {
-  auto channel =
-      grpc::CreateCustomChannel(options.endpoint(), options.credentials(),
-                                options.CreateChannelArguments());
-  auto service_grpc_stub =
-      ::google::test::admin::database::v1::IAMCredentials::NewStub(channel);
+  auto const num_channels = (std::max)(options.num_channels(), 1);
+  std::vector<std::shared_ptr<grpc::Channel>> channels;
+  std::vector<std::shared_ptr<IAMCredentialsStub>> children;
+  for (int id = 0; id != num_channels; ++id) {
+    auto arguments = options.CreateChannelArguments();
+    // A different `grpc.channel_id` value gives each channel its own
+    // connection.
+    arguments.SetInt("grpc.channel_id", id);
+    auto channel = google::cloud::internal::CreateCustomChannel(
+        options.endpoint(), options.credentials(), arguments,
+        options.channel_cache_enabled());
+    auto service_grpc_stub =
+        ::google::test::admin::database::v1::IAMCredentials::NewStub(channel);
+    children.push_back(std::make_shared<DefaultIAMCredentialsStub>(
+        std::move(service_grpc_stub)));
+    channels.push_back(std::move(channel));
+  }
+  auto pool = std::make_shared<google::cloud::internal::ChannelPool>(
+      std::move(channels));
+  pool->WarmUp();
+
   std::shared_ptr<IAMCredentialsStub> stub =
-      std::make_shared<DefaultIAMCredentialsStub>(
-          std::move(service_grpc_stub));
+      std::make_shared<IAMCredentialsStubPool>(std::move(pool),
+                                              std::move(children));
 
+  stub = std::make_shared<IAMCredentialsMetrics>(std::move(stub));
   stub = std::make_shared<IAMCredentialsMetadata>(std::move(stub));
 
   if (options.tracing_enabled("rpc")) {
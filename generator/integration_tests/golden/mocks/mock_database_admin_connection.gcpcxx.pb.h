@@ -96,6 +96,42 @@ class MockDatabaseAdminConnection : public golden::DatabaseAdminConnection {
   ListBackupOperations,
   (::google::test::admin::database::v1::ListBackupOperationsRequest request), (override));
 
+  MOCK_METHOD(future<StatusOr<::google::test::admin::database::v1::Database>>,
+  AsyncGetDatabase,
+  (::google::test::admin::database::v1::GetDatabaseRequest const& request), (override));
+
+  MOCK_METHOD(future<Status>,
+  AsyncDropDatabase,
+  (::google::test::admin::database::v1::DropDatabaseRequest const& request), (override));
+
+  MOCK_METHOD(future<StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>>,
+  AsyncGetDatabaseDdl,
+  (::google::test::admin::database::v1::GetDatabaseDdlRequest const& request), (override));
+
+  MOCK_METHOD(future<StatusOr<::google::iam::v1::Policy>>,
+  AsyncSetIamPolicy,
+  (::google::iam::v1::SetIamPolicyRequest const& request), (override));
+
+  MOCK_METHOD(future<StatusOr<::google::iam::v1::Policy>>,
+  AsyncGetIamPolicy,
+  (::google::iam::v1::GetIamPolicyRequest const& request), (override));
+
+  MOCK_METHOD(future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>,
+  AsyncTestIamPermissions,
+  (::google::iam::v1::TestIamPermissionsRequest const& request), (override));
+
+  MOCK_METHOD(future<StatusOr<::google::test::admin::database::v1::Backup>>,
+  AsyncGetBackup,
+  (::google::test::admin::database::v1::GetBackupRequest const& request), (override));
+
+  MOCK_METHOD(future<StatusOr<::google::test::admin::database::v1::Backup>>,
+  AsyncUpdateBackup,
+  (::google::test::admin::database::v1::UpdateBackupRequest const& request), (override));
+
+  MOCK_METHOD(future<Status>,
+  AsyncDeleteBackup,
+  (::google::test::admin::database::v1::DeleteBackupRequest const& request), (override));
+
 };
 
 }  // namespace golden_mocks
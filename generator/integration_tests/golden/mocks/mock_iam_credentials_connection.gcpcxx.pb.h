@@ -48,6 +48,18 @@ class MockIAMCredentialsConnection : public golden::IAMCredentialsConnection {
   TailLogEntries,
   (::google::test::admin::database::v1::TailLogEntriesRequest request), (override));
 
+  MOCK_METHOD(future<StatusOr<::google::test::admin::database::v1::GenerateAccessTokenResponse>>,
+  AsyncGenerateAccessToken,
+  (::google::test::admin::database::v1::GenerateAccessTokenRequest const& request), (override));
+
+  MOCK_METHOD(future<StatusOr<::google::test::admin::database::v1::GenerateIdTokenResponse>>,
+  AsyncGenerateIdToken,
+  (::google::test::admin::database::v1::GenerateIdTokenRequest const& request), (override));
+
+  MOCK_METHOD(future<StatusOr<::google::test::admin::database::v1::WriteLogEntriesResponse>>,
+  AsyncWriteLogEntries,
+  (::google::test::admin::database::v1::WriteLogEntriesRequest const& request), (override));
+
 };
 
 }  // namespace golden_mocks
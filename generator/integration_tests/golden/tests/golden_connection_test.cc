@@ -134,6 +134,69 @@ class MockGoldenStub
        ::google::test::admin::database::v1::ListBackupOperationsRequest const&
            request),
       (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::test::admin::database::v1::Database>>,
+      AsyncGetDatabase,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GetDatabaseRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<Status>, AsyncDropDatabase,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::DropDatabaseRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::test::admin::database::v1::GetDatabaseDdlResponse>>,
+      AsyncGetDatabaseDdl,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GetDatabaseDdlRequest const&
+           request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::v1::Policy>>,
+      AsyncSetIamPolicy,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::iam::v1::SetIamPolicyRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::v1::Policy>>,
+      AsyncGetIamPolicy,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::iam::v1::GetIamPolicyRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>,
+      AsyncTestIamPermissions,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::iam::v1::TestIamPermissionsRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::test::admin::database::v1::Backup>>,
+      AsyncGetBackup,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GetBackupRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::test::admin::database::v1::Backup>>,
+      AsyncUpdateBackup,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::UpdateBackupRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<Status>, AsyncDeleteBackup,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::DeleteBackupRequest const& request),
+      (override));
   /// Poll a long-running operation.
   MOCK_METHOD(StatusOr<google::longrunning::Operation>, GetOperation,
               (grpc::ClientContext & client_context,
@@ -0,0 +1,306 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/capture_instrumentation.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "generator/integration_tests/golden/internal/database_admin_metrics_decorator.gcpcxx.pb.h"
+#include <gmock/gmock.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace golden_internal {
+namespace {
+
+using ::google::cloud::testing_util::CaptureInstrumentation;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+class MockGoldenStub
+    : public google::cloud::golden_internal::DatabaseAdminStub {
+ public:
+  ~MockGoldenStub() override = default;
+  MOCK_METHOD(
+      StatusOr<::google::test::admin::database::v1::ListDatabasesResponse>,
+      ListDatabases,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::ListDatabasesRequest const&
+           request),
+      (override));
+
+  MOCK_METHOD(StatusOr<::google::longrunning::Operation>, CreateDatabase,
+              (grpc::ClientContext & context,
+               ::google::test::admin::database::v1::CreateDatabaseRequest const&
+                   request),
+              (override));
+
+  MOCK_METHOD(
+      StatusOr<::google::test::admin::database::v1::Database>, GetDatabase,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::GetDatabaseRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      StatusOr<::google::longrunning::Operation>, UpdateDatabaseDdl,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::UpdateDatabaseDdlRequest const&
+           request),
+      (override));
+
+  MOCK_METHOD(
+      Status, DropDatabase,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::DropDatabaseRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      StatusOr<::google::test::admin::database::v1::GetDatabaseDdlResponse>,
+      GetDatabaseDdl,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::GetDatabaseDdlRequest const&
+           request),
+      (override));
+
+  MOCK_METHOD(StatusOr<::google::iam::v1::Policy>, SetIamPolicy,
+              (grpc::ClientContext & context,
+               ::google::iam::v1::SetIamPolicyRequest const& request),
+              (override));
+
+  MOCK_METHOD(StatusOr<::google::iam::v1::Policy>, GetIamPolicy,
+              (grpc::ClientContext & context,
+               ::google::iam::v1::GetIamPolicyRequest const& request),
+              (override));
+
+  MOCK_METHOD(StatusOr<::google::iam::v1::TestIamPermissionsResponse>,
+              TestIamPermissions,
+              (grpc::ClientContext & context,
+               ::google::iam::v1::TestIamPermissionsRequest const& request),
+              (override));
+
+  MOCK_METHOD(
+      StatusOr<::google::longrunning::Operation>, CreateBackup,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::CreateBackupRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      StatusOr<::google::test::admin::database::v1::Backup>, GetBackup,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::GetBackupRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      StatusOr<::google::test::admin::database::v1::Backup>, UpdateBackup,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::UpdateBackupRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      Status, DeleteBackup,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::DeleteBackupRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      StatusOr<::google::test::admin::database::v1::ListBackupsResponse>,
+      ListBackups,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::ListBackupsRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      StatusOr<::google::longrunning::Operation>, RestoreDatabase,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::RestoreDatabaseRequest const&
+           request),
+      (override));
+
+  MOCK_METHOD(
+      StatusOr<
+          ::google::test::admin::database::v1::ListDatabaseOperationsResponse>,
+      ListDatabaseOperations,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::ListDatabaseOperationsRequest const&
+           request),
+      (override));
+
+  MOCK_METHOD(
+      StatusOr<
+          ::google::test::admin::database::v1::ListBackupOperationsResponse>,
+      ListBackupOperations,
+      (grpc::ClientContext & context,
+       ::google::test::admin::database::v1::ListBackupOperationsRequest const&
+           request),
+      (override));
+
+  MOCK_METHOD(
+      future<StatusOr<::google::test::admin::database::v1::Database>>,
+      AsyncGetDatabase,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GetDatabaseRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<Status>, AsyncDropDatabase,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::DropDatabaseRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::test::admin::database::v1::GetDatabaseDdlResponse>>,
+      AsyncGetDatabaseDdl,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GetDatabaseDdlRequest const&
+           request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::v1::Policy>>,
+      AsyncSetIamPolicy,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::iam::v1::SetIamPolicyRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::v1::Policy>>,
+      AsyncGetIamPolicy,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::iam::v1::GetIamPolicyRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::v1::TestIamPermissionsResponse>>,
+      AsyncTestIamPermissions,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::iam::v1::TestIamPermissionsRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::test::admin::database::v1::Backup>>,
+      AsyncGetBackup,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GetBackupRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<::google::test::admin::database::v1::Backup>>,
+      AsyncUpdateBackup,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::UpdateBackupRequest const& request),
+      (override));
+  MOCK_METHOD(
+      future<Status>, AsyncDeleteBackup,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::DeleteBackupRequest const& request),
+      (override));
+  /// Poll a long-running operation.
+  MOCK_METHOD(StatusOr<google::longrunning::Operation>, GetOperation,
+              (grpc::ClientContext & client_context,
+               google::longrunning::GetOperationRequest const& request),
+              (override));
+
+  /// Cancel a long-running operation.
+  MOCK_METHOD(Status, CancelOperation,
+              (grpc::ClientContext & client_context,
+               google::longrunning::CancelOperationRequest const& request),
+              (override));
+};
+
+class MetricsDecoratorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<MockGoldenStub>();
+    internal::SetInstrumentation(capture_);
+  }
+  void TearDown() override { internal::SetInstrumentation(nullptr); }
+
+  static Status TransientError() {
+    return Status(StatusCode::kUnavailable, "try-again");
+  }
+
+  std::shared_ptr<MockGoldenStub> mock_;
+  std::shared_ptr<CaptureInstrumentation> capture_ =
+      std::make_shared<CaptureInstrumentation>();
+};
+
+TEST_F(MetricsDecoratorTest, GetDatabase) {
+  EXPECT_CALL(*mock_, GetDatabase(_, _)).WillOnce([] {
+    return google::test::admin::database::v1::Database{};
+  });
+
+  DatabaseAdminMetrics stub(mock_);
+  grpc::ClientContext context;
+  google::test::admin::database::v1::GetDatabaseRequest request;
+  auto status = stub.GetDatabase(context, request);
+  EXPECT_STATUS_OK(status);
+  EXPECT_THAT(
+      capture_->ClearEvents(),
+      ElementsAre("rpc:google.test.admin.database.v1.DatabaseAdmin/"
+                  "GetDatabase:OK"));
+}
+
+TEST_F(MetricsDecoratorTest, DropDatabase) {
+  EXPECT_CALL(*mock_, DropDatabase(_, _)).WillOnce([] {
+    return TransientError();
+  });
+
+  DatabaseAdminMetrics stub(mock_);
+  grpc::ClientContext context;
+  google::test::admin::database::v1::DropDatabaseRequest request;
+  auto status = stub.DropDatabase(context, request);
+  EXPECT_THAT(status, StatusIs(StatusCode::kUnavailable));
+  EXPECT_THAT(
+      capture_->ClearEvents(),
+      ElementsAre("rpc:google.test.admin.database.v1.DatabaseAdmin/"
+                  "DropDatabase:UNAVAILABLE"));
+}
+
+TEST_F(MetricsDecoratorTest, GetOperation) {
+  EXPECT_CALL(*mock_, GetOperation(_, _)).WillOnce([] {
+    return google::longrunning::Operation{};
+  });
+
+  DatabaseAdminMetrics stub(mock_);
+  grpc::ClientContext context;
+  google::longrunning::GetOperationRequest request;
+  auto status = stub.GetOperation(context, request);
+  EXPECT_STATUS_OK(status);
+  EXPECT_THAT(
+      capture_->ClearEvents(),
+      ElementsAre("rpc:google.longrunning.Operations/GetOperation:OK"));
+}
+
+TEST_F(MetricsDecoratorTest, Disabled) {
+  internal::SetInstrumentation(nullptr);
+  EXPECT_CALL(*mock_, DropDatabase(_, _)).WillOnce([] { return Status(); });
+
+  DatabaseAdminMetrics stub(mock_);
+  grpc::ClientContext context;
+  google::test::admin::database::v1::DropDatabaseRequest request;
+  EXPECT_STATUS_OK(stub.DropDatabase(context, request));
+  EXPECT_THAT(capture_->ClearEvents(), IsEmpty());
+}
+
+}  // namespace
+}  // namespace golden_internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
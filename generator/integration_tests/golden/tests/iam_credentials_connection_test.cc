@@ -73,6 +73,33 @@ class MockIAMCredentialsStub
        ::google::test::admin::database::v1::TailLogEntriesRequest const&
            request),
       (override));
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::test::admin::database::v1::GenerateAccessTokenResponse>>,
+      AsyncGenerateAccessToken,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GenerateAccessTokenRequest const&
+           request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::test::admin::database::v1::GenerateIdTokenResponse>>,
+      AsyncGenerateIdToken,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GenerateIdTokenRequest const&
+           request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::test::admin::database::v1::WriteLogEntriesResponse>>,
+      AsyncWriteLogEntries,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::WriteLogEntriesRequest const&
+           request),
+      (override));
 };
 
 std::shared_ptr<golden::IAMCredentialsConnection> CreateTestingConnection(
@@ -129,6 +156,40 @@ TEST(IAMCredentialsConnectionTest, GenerateAccessTokenTooManyTransients) {
   EXPECT_EQ(StatusCode::kUnavailable, response.status().code());
 }
 
+TEST(IAMCredentialsConnectionTest, AsyncGenerateAccessTokenSuccess) {
+  auto mock = std::make_shared<MockIAMCredentialsStub>();
+  EXPECT_CALL(*mock, AsyncGenerateAccessToken)
+      .WillOnce([](google::cloud::CompletionQueue&,
+                   std::unique_ptr<grpc::ClientContext>,
+                   ::google::test::admin::database::v1::
+                       GenerateAccessTokenRequest const&) {
+        ::google::test::admin::database::v1::GenerateAccessTokenResponse
+            response;
+        return make_ready_future(make_status_or(std::move(response)));
+      });
+  auto conn = CreateTestingConnection(std::move(mock));
+  ::google::test::admin::database::v1::GenerateAccessTokenRequest request;
+  auto response = conn->AsyncGenerateAccessToken(request).get();
+  EXPECT_STATUS_OK(response);
+}
+
+TEST(IAMCredentialsConnectionTest, AsyncGenerateAccessTokenPermanentError) {
+  auto mock = std::make_shared<MockIAMCredentialsStub>();
+  EXPECT_CALL(*mock, AsyncGenerateAccessToken)
+      .WillOnce([](google::cloud::CompletionQueue&,
+                   std::unique_ptr<grpc::ClientContext>,
+                   ::google::test::admin::database::v1::
+                       GenerateAccessTokenRequest const&) {
+        return make_ready_future(StatusOr<
+            ::google::test::admin::database::v1::GenerateAccessTokenResponse>(
+            Status(StatusCode::kPermissionDenied, "uh-oh")));
+      });
+  auto conn = CreateTestingConnection(std::move(mock));
+  ::google::test::admin::database::v1::GenerateAccessTokenRequest request;
+  auto response = conn->AsyncGenerateAccessToken(request).get();
+  EXPECT_EQ(StatusCode::kPermissionDenied, response.status().code());
+}
+
 TEST(IAMCredentialsConnectionTest, GenerateIdTokenSuccess) {
   auto mock = std::make_shared<MockIAMCredentialsStub>();
   EXPECT_CALL(*mock, GenerateIdToken)
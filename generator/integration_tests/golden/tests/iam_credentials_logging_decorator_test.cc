@@ -70,6 +70,33 @@ class MockIAMCredentialsStub
        ::google::test::admin::database::v1::TailLogEntriesRequest const&
            request),
       (override));
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::test::admin::database::v1::GenerateAccessTokenResponse>>,
+      AsyncGenerateAccessToken,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GenerateAccessTokenRequest const&
+           request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::test::admin::database::v1::GenerateIdTokenResponse>>,
+      AsyncGenerateIdToken,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::GenerateIdTokenRequest const&
+           request),
+      (override));
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::test::admin::database::v1::WriteLogEntriesResponse>>,
+      AsyncWriteLogEntries,
+      (google::cloud::CompletionQueue & cq,
+       std::unique_ptr<grpc::ClientContext> context,
+       ::google::test::admin::database::v1::WriteLogEntriesRequest const&
+           request),
+      (override));
 };
 
 class LoggingDecoratorTest : public ::testing::Test {
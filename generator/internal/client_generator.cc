@@ -196,6 +196,54 @@ Status ClientGenerator::GenerateHeader() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    HeaderPrintMethod(
+        method,
+        {MethodPattern(
+            {
+                {IsResponseTypeEmpty,
+                 // clang-format off
+    "  /**\n"
+    "   * Asynchronous version of `$method_name$()`.\n"
+    "   *\n"
+    "   * The returned future is satisfied when the RPC, including any retries,\n"
+    "   * completes.\n"
+    "   */\n"
+    "  future<Status>\n",
+    "  /**\n"
+    "   * Asynchronous version of `$method_name$()`.\n"
+    "   *\n"
+    "   * The returned future is satisfied when the RPC, including any retries,\n"
+    "   * completes.\n"
+    "   */\n"
+    "  future<StatusOr<$response_type$>>\n"},
+   {"  Async$method_name$($request_type$ const& request);\n"
+        "\n"}
+                // clang-format on
+            },
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {
+                 // clang-format off
+   {"  /**\n"
+    "   * Starts a bidirectional stream for `$method_name$`.\n"
+    "   *\n"
+    "   * The caller must call `Start()` before any other operation, and\n"
+    "   * `Finish()` once it is done with the stream. The stream is not\n"
+    "   * retried; on failure the application decides how to resume.\n"
+    "   */\n"
+    "  std::unique_ptr<\n"
+    "      ::google::cloud::internal::AsyncStreamingReadWriteRpc<\n"
+    "          $request_type$,\n"
+    "          $response_type$>>\n"
+    "  Async$method_name$();\n\n"},
+                 // clang-format on
+             },
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   HeaderPrint(  // clang-format off
     " private:\n"
     "  std::shared_ptr<$connection_class_name$> connection_;\n");
@@ -223,8 +271,27 @@ Status ClientGenerator::GenerateCc() {
   // clang-format on
 
   // includes
+  // With `arena_allocated_requests=true` the request built by the flattened
+  // overloads of unary and long-running methods, including any repeated or
+  // message fields copied from the arguments, is allocated in a per-call arena
+  // and released in one step. Paginated and streaming connections copy the
+  // request, so an arena would only add overhead.
+  auto const arena = vars().find("arena_allocated_requests");
+  bool const use_arena = arena != vars().end() && arena->second == "true";
+  std::string const request_declaration =
+      use_arena
+          ? "  google::protobuf::Arena arena;\n"
+            "  auto& request =\n"
+            "      *google::protobuf::Arena::CreateMessage<$request_type$>("
+            "&arena);\n"
+          : "  $request_type$ request;\n";
+
   CcLocalIncludes({vars("client_header_path")});
-  CcSystemIncludes({"memory"});
+  if (use_arena) {
+    CcSystemIncludes({"google/protobuf/arena.h", "memory"});
+  } else {
+    CcSystemIncludes({"memory"});
+  }
   CcPrint("\n");
 
   auto result = CcOpenNamespaces();
@@ -256,7 +323,7 @@ Status ClientGenerator::GenerateCc() {
                    "Status\n",
                    "StatusOr<$response_type$>\n"},
                   {method_string},
-                  {"  $request_type$ request;\n"},
+                  {request_declaration},
                    {method_request_string},
                   {"  return connection_->$method_name$(request);\n"
                    "}\n\n"}
@@ -271,7 +338,7 @@ Status ClientGenerator::GenerateCc() {
                     "future<Status>\n",
                     "future<StatusOr<$longrunning_deduced_response_type$>>\n"},
                   {method_string},
-                  {"  $request_type$ request;\n"},
+                  {request_declaration},
                    {method_request_string},
                   {"  return connection_->$method_name$(request);\n"
                   "}\n\n"}
@@ -357,6 +424,38 @@ Status ClientGenerator::GenerateCc() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    CcPrintMethod(
+        method,
+        {MethodPattern(
+            {
+                {IsResponseTypeEmpty,
+                 // clang-format off
+    "future<Status>\n",
+    "future<StatusOr<$response_type$>>\n"},
+   {"$client_class_name$::Async$method_name$($request_type$ const& request) {\n"
+    "  return connection_->Async$method_name$(request);\n"
+    "}\n\n"}
+                // clang-format on
+            },
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {
+                 // clang-format off
+   {"std::unique_ptr<\n"
+    "    ::google::cloud::internal::AsyncStreamingReadWriteRpc<\n"
+    "        $request_type$,\n"
+    "        $response_type$>>\n"
+    "$client_class_name$::Async$method_name$() {\n"
+    "  return connection_->Async$method_name$();\n"
+    "}\n\n"},
+                 // clang-format on
+             },
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   CcCloseNamespaces();
   return {};
 }
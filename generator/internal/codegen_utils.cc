@@ -16,11 +16,13 @@
 #include "google/cloud/internal/absl_str_cat_quiet.h"
 #include "google/cloud/internal/absl_str_join_quiet.h"
 #include "google/cloud/internal/absl_str_replace_quiet.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include <google/protobuf/compiler/code_generator.h>
 #include <cctype>
+#include <cstdint>
 #include <string>
 
 namespace google {
@@ -149,6 +151,45 @@ ProcessCommandLineArgs(std::string const& parameters) {
     copyright_year->second = CurrentCopyrightYear();
   }
 
+  auto pagination_prefetch_pages =
+      std::find_if(command_line_args.begin(), command_line_args.end(),
+                   [](std::pair<std::string, std::string> const& p) {
+                     return p.first == "pagination_prefetch_pages";
+                   });
+  std::uint32_t pages;
+  if (pagination_prefetch_pages != command_line_args.end() &&
+      !absl::SimpleAtoi(pagination_prefetch_pages->second, &pages)) {
+    return Status(StatusCode::kInvalidArgument,
+                  "--cpp_codegen_opt=pagination_prefetch_pages=<count> must "
+                  "be a non-negative integer.");
+  }
+
+  auto arena_allocated_requests =
+      std::find_if(command_line_args.begin(), command_line_args.end(),
+                   [](std::pair<std::string, std::string> const& p) {
+                     return p.first == "arena_allocated_requests";
+                   });
+  if (arena_allocated_requests != command_line_args.end() &&
+      arena_allocated_requests->second != "true" &&
+      arena_allocated_requests->second != "false") {
+    return Status(StatusCode::kInvalidArgument,
+                  "--cpp_codegen_opt=arena_allocated_requests=<value> must "
+                  "be true or false.");
+  }
+
+  auto static_retry_policies =
+      std::find_if(command_line_args.begin(), command_line_args.end(),
+                   [](std::pair<std::string, std::string> const& p) {
+                     return p.first == "static_retry_policies";
+                   });
+  if (static_retry_policies != command_line_args.end() &&
+      static_retry_policies->second != "true" &&
+      static_retry_policies->second != "false") {
+    return Status(StatusCode::kInvalidArgument,
+                  "--cpp_codegen_opt=static_retry_policies=<value> must "
+                  "be true or false.");
+  }
+
   return command_line_args;
 }
 
@@ -22,7 +22,9 @@ namespace cloud {
 namespace generator_internal {
 namespace {
 
+using ::testing::Contains;
 using ::testing::ElementsAre;
+using ::testing::Pair;
 
 TEST(GeneratedFileSuffix, Success) {
   EXPECT_EQ(".gcpcxx.pb", GeneratedFileSuffix());
@@ -224,6 +226,60 @@ TEST(ProcessCommandLineArgs, CopyrightYearWithValue) {
   EXPECT_EQ(result->back().second, "1995");
 }
 
+TEST(ProcessCommandLineArgs, PaginationPrefetchPages) {
+  auto result = ProcessCommandLineArgs(
+      "product_path=google/cloud/pubsub/"
+      ",googleapis_commit_hash=foo,pagination_prefetch_pages=2");
+  ASSERT_TRUE(result.ok());
+  EXPECT_THAT(*result, Contains(Pair("pagination_prefetch_pages", "2")));
+}
+
+TEST(ProcessCommandLineArgs, InvalidPaginationPrefetchPages) {
+  auto result = ProcessCommandLineArgs(
+      "product_path=google/cloud/pubsub/"
+      ",googleapis_commit_hash=foo,pagination_prefetch_pages=many");
+  EXPECT_EQ(result.status().code(), StatusCode::kInvalidArgument);
+  EXPECT_EQ(result.status().message(),
+            "--cpp_codegen_opt=pagination_prefetch_pages=<count> must be a "
+            "non-negative integer.");
+}
+
+TEST(ProcessCommandLineArgs, ArenaAllocatedRequests) {
+  auto result = ProcessCommandLineArgs(
+      "product_path=google/cloud/pubsub/"
+      ",googleapis_commit_hash=foo,arena_allocated_requests=true");
+  ASSERT_TRUE(result.ok());
+  EXPECT_THAT(*result, Contains(Pair("arena_allocated_requests", "true")));
+}
+
+TEST(ProcessCommandLineArgs, InvalidArenaAllocatedRequests) {
+  auto result = ProcessCommandLineArgs(
+      "product_path=google/cloud/pubsub/"
+      ",googleapis_commit_hash=foo,arena_allocated_requests=yes");
+  EXPECT_EQ(result.status().code(), StatusCode::kInvalidArgument);
+  EXPECT_EQ(result.status().message(),
+            "--cpp_codegen_opt=arena_allocated_requests=<value> must be true "
+            "or false.");
+}
+
+TEST(ProcessCommandLineArgs, StaticRetryPolicies) {
+  auto result = ProcessCommandLineArgs(
+      "product_path=google/cloud/pubsub/"
+      ",googleapis_commit_hash=foo,static_retry_policies=true");
+  ASSERT_TRUE(result.ok());
+  EXPECT_THAT(*result, Contains(Pair("static_retry_policies", "true")));
+}
+
+TEST(ProcessCommandLineArgs, InvalidStaticRetryPolicies) {
+  auto result = ProcessCommandLineArgs(
+      "product_path=google/cloud/pubsub/"
+      ",googleapis_commit_hash=foo,static_retry_policies=1");
+  EXPECT_EQ(result.status().code(), StatusCode::kInvalidArgument);
+  EXPECT_EQ(result.status().message(),
+            "--cpp_codegen_opt=static_retry_policies=<value> must be true "
+            "or false.");
+}
+
 }  // namespace
 }  // namespace generator_internal
 }  // namespace cloud
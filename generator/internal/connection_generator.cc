@@ -50,7 +50,11 @@ Status ConnectionGenerator::GenerateHeader() {
       {vars("idempotency_policy_header_path"), vars("stub_header_path"),
        vars("retry_traits_header_path"), "google/cloud/backoff_policy.h",
        "google/cloud/connection_options.h",
-       HasLongrunningMethod() ? "google/cloud/future.h" : "",
+       "google/cloud/future.h",
+       HasBidirStreamingMethod()
+           ? "google/cloud/internal/async_read_write_stream_impl.h"
+           : "",
+       "google/cloud/internal/retry_budget.h",
        HasLongrunningMethod() ? "google/cloud/polling_policy.h" : "",
        "google/cloud/status_or.h",
        HasStreamingReadMethod() || HasPaginatedMethod()
@@ -88,6 +92,10 @@ Status ConnectionGenerator::GenerateHeader() {
     "\n"
     "using $limited_error_count_retry_policy_name$ =\n"
     "    google::cloud::internal::LimitedErrorCountRetryPolicy<\n"
+    "        $product_internal_namespace$::$retry_traits_name$>;\n"
+    "\n"
+    "using $budgeted_retry_policy_name$ =\n"
+    "    google::cloud::internal::BudgetedRetryPolicy<\n"
     "        $product_internal_namespace$::$retry_traits_name$>;\n\n"
     //  clang-format on
   );
@@ -159,6 +167,35 @@ Status ConnectionGenerator::GenerateHeader() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    HeaderPrintMethod(
+        method,
+        {MethodPattern(
+            {
+                {IsResponseTypeEmpty,
+                 // clang-format off
+    "  virtual future<Status>\n",
+    "  virtual future<StatusOr<$response_type$>>\n"},
+   {"  Async$method_name$($request_type$ const& request);\n"
+        "\n",}
+                // clang-format on
+            },
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {
+                 // clang-format off
+   {"  virtual std::unique_ptr<\n"
+    "      ::google::cloud::internal::AsyncStreamingReadWriteRpc<\n"
+    "          $request_type$,\n"
+    "          $response_type$>>\n"
+    "  Async$method_name$();\n\n"},
+                 // clang-format on
+             },
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   // close abstract interface Connection base class
   HeaderPrint(  // clang-format off
     "};\n\n");
@@ -209,7 +246,10 @@ Status ConnectionGenerator::GenerateCc() {
   // includes
   CcLocalIncludes(
       {vars("connection_header_path"), vars("stub_factory_header_path"),
+       "google/cloud/background_threads.h",
+       "google/cloud/internal/async_retry_loop.h",
        HasPaginatedMethod() ? "google/cloud/internal/pagination_range.h" : "",
+       StaticRetryPolicies() ? "google/cloud/internal/policy_holder.h" : "",
        HasLongrunningMethod() ? "google/cloud/internal/polling_loop.h" : "",
        HasStreamingReadMethod()
            ? "google/cloud/internal/resumable_streaming_read_rpc.h"
@@ -314,12 +354,78 @@ Status ConnectionGenerator::GenerateCc() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    CcPrintMethod(
+        method,
+        {MethodPattern(
+            {
+                {IsResponseTypeEmpty,
+                 // clang-format off
+    "future<Status>\n",
+    "future<StatusOr<$response_type$>>\n"},
+   {"$connection_class_name$::Async$method_name$(\n"
+    "    $request_type$ const&) {\n"},
+   {IsResponseTypeEmpty,
+    "  return google::cloud::make_ready_future(\n"
+    "    Status(StatusCode::kUnimplemented, \"not implemented\"));\n",
+    "  return google::cloud::make_ready_future<\n"
+    "    StatusOr<$response_type$>>(\n"
+    "    Status(StatusCode::kUnimplemented, \"not implemented\"));\n"},
+   {"}\n\n"}
+                // clang-format on
+            },
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {
+                 // clang-format off
+   {"std::unique_ptr<\n"
+    "    ::google::cloud::internal::AsyncStreamingReadWriteRpc<\n"
+    "        $request_type$,\n"
+    "        $response_type$>>\n"
+    "$connection_class_name$::Async$method_name$() {\n"
+    "  return absl::make_unique<\n"
+    "      ::google::cloud::internal::AsyncStreamingReadWriteRpcError<\n"
+    "          $request_type$,\n"
+    "          $response_type$>>(\n"
+    "      Status(StatusCode::kUnimplemented, \"not implemented\"));\n"
+    "}\n\n"},
+                 // clang-format on
+             },
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   // open anonymous namespace
   CcPrint("namespace {\n");
 
   // default policies
-  CcPrint(
-      {// clang-format off
+  if (StaticRetryPolicies()) {
+    CcPrint(
+        {// clang-format off
+   {"$limited_time_retry_policy_name$ DefaultRetryPolicy() {\n"
+    "  return $limited_time_retry_policy_name$(std::chrono::minutes(30));\n"
+    "}\n"
+    "\n"
+    "ExponentialBackoffPolicy DefaultBackoffPolicy() {\n"
+    "  auto constexpr kBackoffScaling = 2.0;\n"
+    "  return ExponentialBackoffPolicy(std::chrono::seconds(1),\n"
+    "                                  std::chrono::minutes(5), kBackoffScaling);\n"
+    "}\n"
+    "\n"},
+    {generator_internal::HasLongrunningMethod,
+    "std::unique_ptr<PollingPolicy> DefaultPollingPolicy() {\n"
+    "  auto constexpr kBackoffScaling = 2.0;\n"
+    "  return GenericPollingPolicy<$limited_time_retry_policy_name$, ExponentialBackoffPolicy>(\n"
+    "             $limited_time_retry_policy_name$(std::chrono::minutes(30)),\n"
+    "             ExponentialBackoffPolicy(std::chrono::seconds(10),\n"
+    "                                      std::chrono::minutes(5), kBackoffScaling))\n"
+    "      .clone();\n"
+    "}\n\n", ""}});
+    // clang-format on
+  } else {
+    CcPrint(
+        {// clang-format off
    {"std::unique_ptr<$retry_policy_name$> DefaultRetryPolicy() {\n"
     "  return $limited_time_retry_policy_name$(std::chrono::minutes(30)).clone();\n"
     "}\n"
@@ -340,44 +446,80 @@ Status ConnectionGenerator::GenerateCc() {
     "                                      std::chrono::minutes(5), kBackoffScaling))\n"
     "      .clone();\n"
     "}\n\n", ""}});
-       // clang-format on
+    // clang-format on
+  }
 
   // default connection implementation class
-  CcPrint(
-      {//clang-format off
-       {"class $connection_class_name$Impl : public $connection_class_name$ {\n"
-        " public:\n"
-        "  explicit $connection_class_name$Impl(\n"
-        "      "
-        "std::shared_ptr<$product_internal_namespace$::$stub_class_name$> "
-        "stub,\n"
-        "      std::unique_ptr<$retry_policy_name$> retry_policy,\n"
-        "      std::unique_ptr<BackoffPolicy> backoff_policy,\n"},
-       {generator_internal::HasLongrunningMethod,
-        "      std::unique_ptr<PollingPolicy> polling_policy,\n", ""},
-       {"      std::unique_ptr<$idempotency_class_name$> "
-        "idempotency_policy)\n"
-        "      : stub_(std::move(stub)),\n"
-        "        retry_policy_prototype_(std::move(retry_policy)),\n"
-        "        backoff_policy_prototype_(std::move(backoff_policy)),\n"},
-       {generator_internal::HasLongrunningMethod,
-        "        polling_policy_prototype_(std::move(polling_policy)),\n", ""},
-       {"        idempotency_policy_(std::move(idempotency_policy)) {}\n"
-        "\n"
-        "  explicit $connection_class_name$Impl(\n"
-        "      "
-        "std::shared_ptr<$product_internal_namespace$::$stub_class_name$> "
-        "stub)\n"
-        "      : $connection_class_name$Impl(\n"
-        "          std::move(stub),\n"
-        "          DefaultRetryPolicy(),\n"
-        "          DefaultBackoffPolicy(),\n"},
-       {generator_internal::HasLongrunningMethod,
-        "          DefaultPollingPolicy(),\n", ""},
-       {"          MakeDefault$idempotency_class_name$()) {}\n"
-        "\n"
-        "  ~$connection_class_name$Impl() override = default;\n\n"}});
-  //  clang-format on
+  if (StaticRetryPolicies()) {
+    // The policy types are template parameters: `Make*Connection(options)`
+    // uses the concrete default policies, held by value, while the overloads
+    // receiving policies from the application hold them by pointer.
+    CcPrint(
+        {//clang-format off
+         {"template <typename RetryPolicyType, typename BackoffPolicyType,\n"
+          "          typename IdempotencyPolicyType>\n"
+          "class $connection_class_name$Impl : public $connection_class_name$ "
+          "{\n"
+          " public:\n"
+          "  $connection_class_name$Impl(\n"
+          "      std::unique_ptr<BackgroundThreads> background,\n"
+          "      "
+          "std::shared_ptr<$product_internal_namespace$::$stub_class_name$> "
+          "stub,\n"
+          "      RetryPolicyType retry_policy,\n"
+          "      BackoffPolicyType backoff_policy,\n"},
+         {generator_internal::HasLongrunningMethod,
+          "      std::unique_ptr<PollingPolicy> polling_policy,\n", ""},
+         {"      IdempotencyPolicyType idempotency_policy)\n"
+          "      : background_(std::move(background)), stub_(std::move(stub)),\n"
+          "        retry_policy_prototype_(std::move(retry_policy)),\n"
+          "        backoff_policy_prototype_(std::move(backoff_policy)),\n"},
+         {generator_internal::HasLongrunningMethod,
+          "        polling_policy_prototype_(std::move(polling_policy)),\n", ""},
+         {"        idempotency_policy_(std::move(idempotency_policy)) {}\n"
+          "\n"
+          "  ~$connection_class_name$Impl() override = default;\n\n"}});
+    //  clang-format on
+  } else {
+    CcPrint(
+        {//clang-format off
+         {"class $connection_class_name$Impl : public $connection_class_name$ "
+          "{\n"
+          " public:\n"
+          "  explicit $connection_class_name$Impl(\n"
+          "      std::unique_ptr<BackgroundThreads> background,\n"
+          "      "
+          "std::shared_ptr<$product_internal_namespace$::$stub_class_name$> "
+          "stub,\n"
+          "      std::unique_ptr<$retry_policy_name$> retry_policy,\n"
+          "      std::unique_ptr<BackoffPolicy> backoff_policy,\n"},
+         {generator_internal::HasLongrunningMethod,
+          "      std::unique_ptr<PollingPolicy> polling_policy,\n", ""},
+         {"      std::unique_ptr<$idempotency_class_name$> "
+          "idempotency_policy)\n"
+          "      : background_(std::move(background)), stub_(std::move(stub)),\n"
+          "        retry_policy_prototype_(std::move(retry_policy)),\n"
+          "        backoff_policy_prototype_(std::move(backoff_policy)),\n"},
+         {generator_internal::HasLongrunningMethod,
+          "        polling_policy_prototype_(std::move(polling_policy)),\n", ""},
+         {"        idempotency_policy_(std::move(idempotency_policy)) {}\n"
+          "\n"
+          "  explicit $connection_class_name$Impl(\n"
+          "      std::unique_ptr<BackgroundThreads> background,\n"
+          "      "
+          "std::shared_ptr<$product_internal_namespace$::$stub_class_name$> "
+          "stub)\n"
+          "      : $connection_class_name$Impl(\n"
+          "          std::move(background), std::move(stub),\n"
+          "          DefaultRetryPolicy(),\n"
+          "          DefaultBackoffPolicy(),\n"},
+         {generator_internal::HasLongrunningMethod,
+          "          DefaultPollingPolicy(),\n", ""},
+         {"          MakeDefault$idempotency_class_name$()) {}\n"
+          "\n"
+          "  ~$connection_class_name$Impl() override = default;\n\n"}});
+    //  clang-format on
+  }
 
   for (auto const& method : methods()) {
     CcPrintMethod(
@@ -391,8 +533,8 @@ Status ConnectionGenerator::GenerateCc() {
    {"  $method_name$(\n"
     "      $request_type$ const& request) override {\n"
     "    return google::cloud::internal::RetryLoop(\n"
-    "        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),\n"
-    "        idempotency_policy_->$method_name$(request),\n"
+    "        $retry_policy_clone$, $backoff_policy_clone$,\n"
+    "        $idempotency_policy_ref$$method_name$(request),\n"
     "        [this](grpc::ClientContext& context,\n"
     "            $request_type$ const& request) {\n"
     "          return stub_->$method_name$(context, request);\n"
@@ -413,8 +555,8 @@ Status ConnectionGenerator::GenerateCc() {
    {"  $method_name$(\n"
     "      $request_type$ const& request) override {\n"
     "    auto operation = google::cloud::internal::RetryLoop(\n"
-    "        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),\n"
-    "        idempotency_policy_->$method_name$(request),\n"
+    "        $retry_policy_clone$, $backoff_policy_clone$,\n"
+    "        $idempotency_policy_ref$$method_name$(request),\n"
     "        [this](grpc::ClientContext& context,\n"
     "               $request_type$ const& request) {\n"
     "          return stub_->$method_name$(context, request);\n"
@@ -439,12 +581,12 @@ Status ConnectionGenerator::GenerateCc() {
     "    request.clear_page_token();\n"
     "    auto stub = stub_;\n"
     "    auto retry =\n"
-    "        std::shared_ptr<$retry_policy_name$ const>(retry_policy_prototype_->clone());\n"
+    "        std::shared_ptr<$retry_policy_name$ const>($retry_policy_ref$clone());\n"
     "    auto backoff = std::shared_ptr<BackoffPolicy const>(\n"
-    "        backoff_policy_prototype_->clone());\n"
-    "    auto idempotency = idempotency_policy_->$method_name$(request);\n"
+    "        $backoff_policy_ref$clone());\n"
+    "    auto idempotency = $idempotency_policy_ref$$method_name$(request);\n"
     "    char const* function_name = __func__;\n"
-    "    return google::cloud::internal::MakePaginationRange<StreamRange<\n"
+    "    return google::cloud::internal::$pagination_range_factory$<StreamRange<\n"
     "        $range_output_type$>>(\n"
     "        std::move(request),\n"
     "        [stub, retry, backoff, idempotency, function_name]\n"
@@ -462,7 +604,7 @@ Status ConnectionGenerator::GenerateCc() {
     "          auto& messages = *r.mutable_$range_output_field_name$();\n"
     "          std::move(messages.begin(), messages.end(), result.begin());\n"
     "          return result;\n"
-    "        });\n"
+    "        }$pagination_prefetch_argument$);\n"
     "  }\n\n"
                      // clang-format on
                  },
@@ -476,9 +618,9 @@ Status ConnectionGenerator::GenerateCc() {
     "    auto stub = stub_;\n"
     "    auto retry_policy =\n"
     "        std::shared_ptr<$retry_policy_name$ const>(\n"
-    "            retry_policy_prototype_->clone());\n"
+    "            $retry_policy_ref$clone());\n"
     "    auto backoff_policy = std::shared_ptr<BackoffPolicy const>(\n"
-    "        backoff_policy_prototype_->clone());\n"
+    "        $backoff_policy_ref$clone());\n"
     "\n"
     "    auto factory = [stub](\n"
     "        $request_type$ const& request) {\n"
@@ -506,6 +648,53 @@ Status ConnectionGenerator::GenerateCc() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    CcPrintMethod(
+        method,
+        {MethodPattern(
+            {
+                {IsResponseTypeEmpty,
+                 // clang-format off
+    "  future<Status>\n",
+    "  future<StatusOr<$response_type$>>\n"},
+   {"  Async$method_name$(\n"
+    "      $request_type$ const& request) override {\n"
+    "    auto stub = stub_;\n"
+    "    return google::cloud::internal::AsyncRetryLoop(\n"
+    "        $retry_policy_clone$, $backoff_policy_clone$,\n"
+    "        $idempotency_policy_ref$$method_name$(request),\n"
+    "        background_->cq(),\n"
+    "        [stub](CompletionQueue& cq,\n"
+    "               std::unique_ptr<grpc::ClientContext> context,\n"
+    "               $request_type$ const& request) {\n"
+    "          return stub->Async$method_name$(cq, std::move(context), request);\n"
+    "        },\n"
+    "        request, __func__);\n"
+    "  }\n"
+    "\n",}
+                // clang-format on
+            },
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         // Bidirectional streams are not retried or resumed: the application
+         // owns the request sequence and decides how to restart the stream.
+         MethodPattern(
+             {
+                 // clang-format off
+   {"  std::unique_ptr<\n"
+    "      ::google::cloud::internal::AsyncStreamingReadWriteRpc<\n"
+    "          $request_type$,\n"
+    "          $response_type$>>\n"
+    "  Async$method_name$() override {\n"
+    "    return stub_->Async$method_name$(\n"
+    "        background_->cq(), absl::make_unique<grpc::ClientContext>());\n"
+    "  }\n\n"},
+                 // clang-format on
+             },
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   CcPrint(  // clang-format off
     " private:\n");
   // clang-format on
@@ -581,29 +770,103 @@ Status ConnectionGenerator::GenerateCc() {
         __FILE__, __LINE__);
   }
 
-  CcPrint(
-      {// clang-format off
-   {"  std::shared_ptr<$product_internal_namespace$::$stub_class_name$> stub_;\n"
+  if (StaticRetryPolicies()) {
+    CcPrint(
+        {// clang-format off
+   {"  std::unique_ptr<BackgroundThreads> background_;\n"
+    "  std::shared_ptr<$product_internal_namespace$::$stub_class_name$> stub_;\n"
+    "  RetryPolicyType retry_policy_prototype_;\n"
+    "  BackoffPolicyType backoff_policy_prototype_;\n"},
+   {generator_internal::HasLongrunningMethod,
+    "  std::unique_ptr<PollingPolicy const> polling_policy_prototype_;\n", ""},
+   {"  IdempotencyPolicyType idempotency_policy_;\n"
+    "};\n"
+    "\n"
+    "using $connection_class_name$DefaultPoliciesImpl =\n"
+    "    $connection_class_name$Impl<$limited_time_retry_policy_name$,\n"
+    "        ExponentialBackoffPolicy, Default$idempotency_class_name$>;\n"
+    "\n"
+    "using $connection_class_name$CustomPoliciesImpl =\n"
+    "    $connection_class_name$Impl<std::unique_ptr<$retry_policy_name$ const>,\n"
+    "        std::unique_ptr<BackoffPolicy const>,\n"
+    "        std::unique_ptr<$idempotency_class_name$>>;\n"}});
+    // clang-format on
+
+    CcPrint("}  // namespace\n\n");
+
+    CcPrint(
+        {// clang-format off
+   {"std::shared_ptr<$connection_class_name$> Make$connection_class_name$(\n"
+    "    $connection_options_name$ const& options) {\n"
+    "  return std::make_shared<$connection_class_name$DefaultPoliciesImpl>(\n"
+    "      options.background_threads_factory()(),\n"
+    "      $product_internal_namespace$::CreateDefault$stub_class_name$(options),\n"
+    "      DefaultRetryPolicy(), DefaultBackoffPolicy(),\n"},
+   {generator_internal::HasLongrunningMethod,
+    "      DefaultPollingPolicy(), Default$idempotency_class_name$());\n}\n\n",
+    "      Default$idempotency_class_name$());\n}\n\n"}});
+    // clang-format on
+
+    CcPrint(
+        {// clang-format off
+   {"std::shared_ptr<$connection_class_name$> Make$connection_class_name$(\n"
+    "    $connection_options_name$ const& options,\n"
+    "    std::unique_ptr<$retry_policy_name$> retry_policy,\n"
+    "    std::unique_ptr<BackoffPolicy> backoff_policy,\n"},
+   {generator_internal::HasLongrunningMethod,
+    "    std::unique_ptr<PollingPolicy> polling_policy,\n", ""},
+   {"    std::unique_ptr<$idempotency_class_name$> idempotency_policy) {\n"
+    "  return std::make_shared<$connection_class_name$CustomPoliciesImpl>(\n"
+    "      options.background_threads_factory()(),\n"
+    "      $product_internal_namespace$::CreateDefault$stub_class_name$(options),\n"
+    "      std::move(retry_policy), std::move(backoff_policy),\n"},
+   {generator_internal::HasLongrunningMethod,
+    "      std::move(polling_policy), std::move(idempotency_policy));\n}\n\n",
+    "      std::move(idempotency_policy));\n}\n\n"}});
+    // clang-format on
+
+    CcPrint(
+        {// clang-format off
+   {"std::shared_ptr<$connection_class_name$> Make$connection_class_name$(\n"
+    "    std::shared_ptr<$product_internal_namespace$::$stub_class_name$> stub,\n"
+    "    std::unique_ptr<$retry_policy_name$> retry_policy,\n"
+    "    std::unique_ptr<BackoffPolicy> backoff_policy,\n"},
+   {generator_internal::HasLongrunningMethod,
+    "    std::unique_ptr<PollingPolicy> polling_policy,\n", ""},
+   {"    std::unique_ptr<$idempotency_class_name$> idempotency_policy) {\n"
+    "  return std::make_shared<$connection_class_name$CustomPoliciesImpl>(\n"
+    "      google::cloud::internal::DefaultBackgroundThreads(1),\n"
+    "      std::move(stub), std::move(retry_policy), std::move(backoff_policy),\n"},
+   {generator_internal::HasLongrunningMethod,
+    "      std::move(polling_policy), std::move(idempotency_policy));\n}\n\n",
+    "      std::move(idempotency_policy));\n}\n\n"}});
+    // clang-format on
+  } else {
+    CcPrint(
+        {// clang-format off
+   {"  std::unique_ptr<BackgroundThreads> background_;\n"
+    "  std::shared_ptr<$product_internal_namespace$::$stub_class_name$> stub_;\n"
     "  std::unique_ptr<$retry_policy_name$ const> retry_policy_prototype_;\n"
     "  std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;\n"},
    {generator_internal::HasLongrunningMethod,
     "  std::unique_ptr<PollingPolicy const> polling_policy_prototype_;\n", ""},
    {"  std::unique_ptr<$idempotency_class_name$> idempotency_policy_;\n"
     "};\n"}});
-  // clang-format on
+    // clang-format on
 
-  CcPrint("}  // namespace\n\n");
+    CcPrint("}  // namespace\n\n");
 
-  CcPrint(  // clang-format off
+    CcPrint(  // clang-format off
     "std::shared_ptr<$connection_class_name$> Make$connection_class_name$(\n"
     "    $connection_options_name$ const& options) {\n"
     "  return std::make_shared<$connection_class_name$Impl>(\n"
+    "      options.background_threads_factory()(),\n"
     "      $product_internal_namespace$::CreateDefault$stub_class_name$(options));\n"
     "}\n\n");
-  // clang-format on
+    // clang-format on
 
-  CcPrint(
-      {// clang-format off
+    CcPrint(
+        {// clang-format off
    {"std::shared_ptr<$connection_class_name$> Make$connection_class_name$(\n"
     "    $connection_options_name$ const& options,\n"
     "    std::unique_ptr<$retry_policy_name$> retry_policy,\n"
@@ -612,15 +875,16 @@ Status ConnectionGenerator::GenerateCc() {
     "    std::unique_ptr<PollingPolicy> polling_policy,\n", ""},
    {"    std::unique_ptr<$idempotency_class_name$> idempotency_policy) {\n"
     "  return std::make_shared<$connection_class_name$Impl>(\n"
+    "      options.background_threads_factory()(),\n"
     "      $product_internal_namespace$::CreateDefault$stub_class_name$(options),\n"
     "      std::move(retry_policy), std::move(backoff_policy),\n"},
    {generator_internal::HasLongrunningMethod,
     "      std::move(polling_policy), std::move(idempotency_policy));\n}\n\n",
     "      std::move(idempotency_policy));\n}\n\n"}});
-  // clang-format on
+    // clang-format on
 
-  CcPrint(
-      {// clang-format off
+    CcPrint(
+        {// clang-format off
    {"std::shared_ptr<$connection_class_name$> Make$connection_class_name$(\n"
     "    std::shared_ptr<$product_internal_namespace$::$stub_class_name$> stub,\n"
     "    std::unique_ptr<$retry_policy_name$> retry_policy,\n"
@@ -629,11 +893,13 @@ Status ConnectionGenerator::GenerateCc() {
     "    std::unique_ptr<PollingPolicy> polling_policy,\n", ""},
    {"    std::unique_ptr<$idempotency_class_name$> idempotency_policy) {\n"
     "  return std::make_shared<$connection_class_name$Impl>(\n"
+    "      google::cloud::internal::DefaultBackgroundThreads(1),\n"
     "      std::move(stub), std::move(retry_policy), std::move(backoff_policy),\n"},
    {generator_internal::HasLongrunningMethod,
     "      std::move(polling_policy), std::move(idempotency_policy));\n}\n\n",
     "      std::move(idempotency_policy));\n}\n\n"}});
-  // clang-format on
+    // clang-format on
+  }
 
   CcCloseNamespaces();
   return {};
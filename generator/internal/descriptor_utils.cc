@@ -26,6 +26,7 @@
 #include "generator/internal/idempotency_policy_generator.h"
 #include "generator/internal/logging_decorator_generator.h"
 #include "generator/internal/metadata_decorator_generator.h"
+#include "generator/internal/metrics_decorator_generator.h"
 #include "generator/internal/mock_connection_generator.h"
 #include "generator/internal/predicate_utils.h"
 #include "generator/internal/retry_policy_generator.h"
@@ -406,6 +407,8 @@ VarsDictionary CreateServiceVars(
     google::protobuf::ServiceDescriptor const& descriptor,
     std::vector<std::pair<std::string, std::string>> const& initial_values) {
   VarsDictionary vars(initial_values.begin(), initial_values.end());
+  vars["budgeted_retry_policy_name"] =
+      absl::StrCat(descriptor.name(), "BudgetedRetryPolicy");
   vars["class_comment_block"] =
       FormatClassCommentsFromServiceComments(descriptor);
   vars["client_class_name"] = absl::StrCat(descriptor.name(), "Client");
@@ -457,12 +460,52 @@ VarsDictionary CreateServiceVars(
       absl::StrCat(vars["product_path"], "internal/",
                    ServiceNameToFilePath(descriptor.name()),
                    "_metadata_decorator", GeneratedFileSuffix(), ".h");
+  vars["metrics_class_name"] = absl::StrCat(descriptor.name(), "Metrics");
+  vars["metrics_cc_path"] =
+      absl::StrCat(vars["product_path"], "internal/",
+                   ServiceNameToFilePath(descriptor.name()),
+                   "_metrics_decorator", GeneratedFileSuffix(), ".cc");
+  vars["metrics_header_path"] =
+      absl::StrCat(vars["product_path"], "internal/",
+                   ServiceNameToFilePath(descriptor.name()),
+                   "_metrics_decorator", GeneratedFileSuffix(), ".h");
   vars["mock_connection_class_name"] =
       absl::StrCat("Mock", descriptor.name(), "Connection");
   vars["mock_connection_header_path"] =
       absl::StrCat(vars["product_path"], "mocks/mock_",
                    ServiceNameToFilePath(descriptor.name()), "_connection",
                    GeneratedFileSuffix(), ".h");
+  // Paginated methods prefetch pages only if the generator is configured to.
+  auto const prefetch_pages = vars.find("pagination_prefetch_pages");
+  if (prefetch_pages == vars.end() || prefetch_pages->second == "0") {
+    vars["pagination_prefetch_argument"] = "";
+    vars["pagination_range_factory"] = "MakePaginationRange";
+  } else {
+    vars["pagination_prefetch_argument"] =
+        absl::StrCat(",\n        ", prefetch_pages->second);
+    vars["pagination_range_factory"] = "MakePrefetchingPaginationRange";
+  }
+  // Connections hold the retry, backoff, and idempotency policies by value,
+  // and copy them on each call, only if the generator is configured to.
+  auto const static_policies = vars.find("static_retry_policies");
+  if (static_policies == vars.end() || static_policies->second != "true") {
+    vars["backoff_policy_clone"] = "backoff_policy_prototype_->clone()";
+    vars["backoff_policy_ref"] = "backoff_policy_prototype_->";
+    vars["idempotency_policy_ref"] = "idempotency_policy_->";
+    vars["retry_policy_clone"] = "retry_policy_prototype_->clone()";
+    vars["retry_policy_ref"] = "retry_policy_prototype_->";
+  } else {
+    vars["backoff_policy_clone"] =
+        "google::cloud::internal::ClonePolicy(backoff_policy_prototype_)";
+    vars["backoff_policy_ref"] =
+        "google::cloud::internal::PolicyRef(backoff_policy_prototype_).";
+    vars["idempotency_policy_ref"] =
+        "google::cloud::internal::PolicyRef(idempotency_policy_).";
+    vars["retry_policy_clone"] =
+        "google::cloud::internal::ClonePolicy(retry_policy_prototype_)";
+    vars["retry_policy_ref"] =
+        "google::cloud::internal::PolicyRef(retry_policy_prototype_).";
+  }
   vars["product_namespace"] = BuildNamespaces(vars["product_path"])[3];
   vars["product_internal_namespace"] =
       BuildNamespaces(vars["product_path"], NamespaceType::kInternal)[3];
@@ -475,6 +518,7 @@ VarsDictionary CreateServiceVars(
       absl::StrCat(vars["product_path"], "retry_traits", ".h");
   vars["service_endpoint"] =
       descriptor.options().GetExtension(google::api::default_host);
+  vars["service_full_name"] = descriptor.full_name();
   vars["service_name"] = descriptor.name();
   vars["stub_class_name"] = absl::StrCat(descriptor.name(), "Stub");
   vars["stub_cc_path"] = absl::StrCat(vars["product_path"], "internal/",
@@ -553,6 +597,9 @@ std::vector<std::unique_ptr<GeneratorInterface>> MakeGenerators(
   code_generators.push_back(absl::make_unique<MetadataDecoratorGenerator>(
       service, service_vars, CreateMethodVars(*service, service_vars),
       context));
+  code_generators.push_back(absl::make_unique<MetricsDecoratorGenerator>(
+      service, service_vars, CreateMethodVars(*service, service_vars),
+      context));
   code_generators.push_back(absl::make_unique<MockConnectionGenerator>(
       service, service_vars, CreateMethodVars(*service, service_vars),
       context));
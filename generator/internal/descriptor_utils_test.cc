@@ -178,9 +178,38 @@ TEST_P(CreateServiceVarsTest, KeySetCorrectly) {
   EXPECT_EQ(iter->second, GetParam().second);
 }
 
+TEST_F(CreateServiceVarsTest, PaginationPrefetch) {
+  const FileDescriptor* service_file_descriptor =
+      pool_.FindFileByName("google/cloud/frobber/v1/frobber.proto");
+  service_vars_ = CreateServiceVars(
+      *service_file_descriptor->service(0),
+      {std::make_pair("product_path", "google/cloud/frobber/"),
+       std::make_pair("pagination_prefetch_pages", "2")});
+  EXPECT_EQ(service_vars_["pagination_range_factory"],
+            "MakePrefetchingPaginationRange");
+  EXPECT_EQ(service_vars_["pagination_prefetch_argument"], ",\n        2");
+}
+
+TEST_F(CreateServiceVarsTest, StaticRetryPolicies) {
+  const FileDescriptor* service_file_descriptor =
+      pool_.FindFileByName("google/cloud/frobber/v1/frobber.proto");
+  service_vars_ = CreateServiceVars(
+      *service_file_descriptor->service(0),
+      {std::make_pair("product_path", "google/cloud/frobber/"),
+       std::make_pair("static_retry_policies", "true")});
+  EXPECT_EQ(service_vars_["retry_policy_clone"],
+            "google::cloud::internal::ClonePolicy(retry_policy_prototype_)");
+  EXPECT_EQ(service_vars_["idempotency_policy_ref"],
+            "google::cloud::internal::PolicyRef(idempotency_policy_).");
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ServiceVars, CreateServiceVarsTest,
     testing::Values(
+        std::make_pair("backoff_policy_clone",
+                       "backoff_policy_prototype_->clone()"),
+        std::make_pair("budgeted_retry_policy_name",
+                       "FrobberServiceBudgetedRetryPolicy"),
         std::make_pair("client_class_name", "FrobberServiceClient"),
         std::make_pair("client_cc_path",
                        "google/cloud/frobber/"
@@ -209,6 +238,7 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_pair("idempotency_policy_header_path",
                        "google/cloud/frobber/"
                        "frobber_connection_idempotency_policy.gcpcxx.pb.h"),
+        std::make_pair("idempotency_policy_ref", "idempotency_policy_->"),
         std::make_pair("limited_error_count_retry_policy_name",
                        "FrobberServiceLimitedErrorCountRetryPolicy"),
         std::make_pair("limited_time_retry_policy_name",
@@ -227,22 +257,35 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_pair("metadata_header_path",
                        "google/cloud/frobber/internal/"
                        "frobber_metadata_decorator.gcpcxx.pb.h"),
+        std::make_pair("metrics_class_name", "FrobberServiceMetrics"),
+        std::make_pair("metrics_cc_path",
+                       "google/cloud/frobber/internal/"
+                       "frobber_metrics_decorator.gcpcxx.pb.cc"),
+        std::make_pair("metrics_header_path",
+                       "google/cloud/frobber/internal/"
+                       "frobber_metrics_decorator.gcpcxx.pb.h"),
         std::make_pair("mock_connection_class_name",
                        "MockFrobberServiceConnection"),
         std::make_pair("mock_connection_header_path",
                        "google/cloud/frobber/mocks/"
                        "mock_frobber_connection.gcpcxx.pb.h"),
+        std::make_pair("pagination_prefetch_argument", ""),
+        std::make_pair("pagination_range_factory", "MakePaginationRange"),
         std::make_pair("product_namespace", "frobber"),
         std::make_pair("product_internal_namespace", "frobber_internal"),
         std::make_pair("proto_file_name",
                        "google/cloud/frobber/v1/frobber.proto"),
         std::make_pair("proto_grpc_header_path",
                        "google/cloud/frobber/v1/frobber.grpc.pb.h"),
+        std::make_pair("retry_policy_clone",
+                       "retry_policy_prototype_->clone()"),
         std::make_pair("retry_policy_name", "FrobberServiceRetryPolicy"),
         std::make_pair("retry_traits_name", "FrobberServiceRetryTraits"),
         std::make_pair("retry_traits_header_path",
                        "google/cloud/frobber/retry_traits.h"),
         std::make_pair("service_endpoint", ""),
+        std::make_pair("service_full_name",
+                       "google.cloud.frobber.v1.FrobberService"),
         std::make_pair("service_name", "FrobberService"),
         std::make_pair("stub_class_name", "FrobberServiceStub"),
         std::make_pair(
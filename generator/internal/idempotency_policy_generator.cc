@@ -104,6 +104,51 @@ Status IdempotencyPolicyGenerator::GenerateHeader() {
       "    MakeDefault$idempotency_class_name$();\n\n");
   // clang-format on
 
+  // With `static_retry_policies=true` the connection holds the default policy
+  // by value, the class is `final` so the compiler can resolve (and inline)
+  // each call.
+  if (StaticRetryPolicies()) {
+    HeaderPrint(  // clang-format off
+      "/// The default idempotency policy, as a concrete type.\n"
+      "class Default$idempotency_class_name$ final\n"
+      "    : public $idempotency_class_name$ {\n"
+      " public:\n"
+      "  ~Default$idempotency_class_name$() override = default;\n\n"
+      "  /// Create a new copy of this object.\n"
+      "  std::unique_ptr<$idempotency_class_name$> clone() const override;\n\n");
+    // clang-format on
+
+    for (auto const& method : methods()) {
+      HeaderPrintMethod(
+          method,
+          {MethodPattern(
+               {
+                   // clang-format off
+   {"  google::cloud::internal::Idempotency\n"
+    "  $method_name$($request_type$ const&) override {\n"
+    "    return google::cloud::internal::Idempotency::$default_idempotency$;\n"
+    "  }\n\n",}
+                   // clang-format on
+               },
+               All(IsNonStreaming, Not(IsPaginated))),
+           MethodPattern(
+               {
+                   // clang-format off
+   {"  google::cloud::internal::Idempotency\n"
+    "  $method_name$($request_type$) override {\n"
+    "    return google::cloud::internal::Idempotency::$default_idempotency$;\n"
+    "  }\n\n",}
+                   // clang-format on
+               },
+               All(IsNonStreaming, IsPaginated))},
+          __FILE__, __LINE__);
+    }
+
+    HeaderPrint(  // clang-format off
+      "};\n\n");
+    // clang-format on
+  }
+
   HeaderCloseNamespaces();
   // close header guard
   HeaderPrint(  // clang-format off
@@ -135,53 +180,62 @@ Status IdempotencyPolicyGenerator::GenerateCc() {
     "$idempotency_class_name$::~$idempotency_class_name$() = default;\n\n");
   // clang-format on
 
-  // open anonymous namespace
-  CcPrint("namespace {\n");
-
-  CcPrint(  // clang_format off
-      "class Default$idempotency_class_name$ : public "
-      "$idempotency_class_name$ {\n"
-      " public:\n"
-      "  ~Default$idempotency_class_name$() override = default;\n\n"
-      //  clang-format on
-  );
-
-  CcPrint(  // clang-format off
-    "  /// Create a new copy of this object.\n"
-    "  std::unique_ptr<$idempotency_class_name$> clone() const override {\n"
-    "    return absl::make_unique<Default$idempotency_class_name$>(*this);\n"
-    "  }\n\n");
-  // clang-format on
-
-  for (auto const& method : methods()) {
-    CcPrintMethod(
-        method,
-        {MethodPattern(
-             {
-                 // clang-format off
-   {"  Idempotency\n"
-    "  $method_name$($request_type$ const&) override {\n"
-    "    return Idempotency::$default_idempotency$;\n"
-    "  }\n\n",}
-                 // clang-format on
-             },
-             All(IsNonStreaming, Not(IsPaginated))),
-         MethodPattern(
-             {
-                 // clang-format off
-   {"  Idempotency\n"
-    "  $method_name$($request_type$) override {\n"
-    "    return Idempotency::$default_idempotency$;\n"
-    "  }\n\n",}
-                 // clang-format on
-             },
-             All(IsNonStreaming, IsPaginated))},
-        __FILE__, __LINE__);
+  if (StaticRetryPolicies()) {
+    CcPrint(  // clang-format off
+      "std::unique_ptr<$idempotency_class_name$>\n"
+      "Default$idempotency_class_name$::clone() const {\n"
+      "  return absl::make_unique<Default$idempotency_class_name$>(*this);\n"
+      "}\n\n");
+    // clang-format on
+  } else {
+    // open anonymous namespace
+    CcPrint("namespace {\n");
+
+    CcPrint(  // clang_format off
+        "class Default$idempotency_class_name$ : public "
+        "$idempotency_class_name$ {\n"
+        " public:\n"
+        "  ~Default$idempotency_class_name$() override = default;\n\n"
+        //  clang-format on
+    );
+
+    CcPrint(  // clang-format off
+      "  /// Create a new copy of this object.\n"
+      "  std::unique_ptr<$idempotency_class_name$> clone() const override {\n"
+      "    return absl::make_unique<Default$idempotency_class_name$>(*this);\n"
+      "  }\n\n");
+    // clang-format on
+
+    for (auto const& method : methods()) {
+      CcPrintMethod(
+          method,
+          {MethodPattern(
+               {
+                   // clang-format off
+     {"  Idempotency\n"
+      "  $method_name$($request_type$ const&) override {\n"
+      "    return Idempotency::$default_idempotency$;\n"
+      "  }\n\n",}
+                   // clang-format on
+               },
+               All(IsNonStreaming, Not(IsPaginated))),
+           MethodPattern(
+               {
+                   // clang-format off
+     {"  Idempotency\n"
+      "  $method_name$($request_type$) override {\n"
+      "    return Idempotency::$default_idempotency$;\n"
+      "  }\n\n",}
+                   // clang-format on
+               },
+               All(IsNonStreaming, IsPaginated))},
+          __FILE__, __LINE__);
+    }
+    CcPrint(  // clang-format off
+      "};\n"
+      "}  // namespace\n\n");
+    // clang-format on
   }
-  CcPrint(  // clang-format off
-    "};\n"
-    "}  // namespace\n\n");
-  // clang-format on
 
   CcPrint(  // clang-format off
       "std::unique_ptr<$idempotency_class_name$>\n"
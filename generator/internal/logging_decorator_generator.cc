@@ -94,6 +94,34 @@ Status LoggingDecoratorGenerator::GenerateHeader() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    HeaderPrintMethod(
+        method,
+        {MethodPattern({{IsResponseTypeEmpty,
+                         // clang-format off
+    "  future<Status> Async$method_name$(\n",
+    "  future<StatusOr<$response_type$>> Async$method_name$(\n"},
+   {"    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context,\n"
+    "    $request_type$ const& request) override;\n"
+                         // clang-format on
+                         "\n"}},
+                       All(IsNonStreaming, Not(IsLongrunningOperation),
+                           Not(IsPaginated))),
+         MethodPattern(
+             {// clang-format off
+   {"  std::unique_ptr<internal::AsyncStreamingReadWriteRpc<\n"
+    "      $request_type$,\n"
+    "      $response_type$>>\n"
+    "  Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context) override;\n"
+               // clang-format on
+               "\n"}},
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   if (HasLongrunningMethod()) {
     HeaderPrint(  // clang-format off
     "  /// Poll a long-running operation.\n"
@@ -138,6 +166,10 @@ Status LoggingDecoratorGenerator::GenerateCc() {
 
   // includes
   CcLocalIncludes({vars("logging_header_path"),
+                   HasBidirStreamingMethod()
+                       ? "google/cloud/internal/"
+                         "async_streaming_read_write_rpc_logging.h"
+                       : "",
                    "google/cloud/internal/log_wrapper.h",
                    HasStreamingReadMethod()
                        ? "google/cloud/internal/streaming_read_rpc_logging.h"
@@ -213,6 +245,58 @@ Status LoggingDecoratorGenerator::GenerateCc() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    CcPrintMethod(
+        method,
+        {MethodPattern(
+            {{IsResponseTypeEmpty,
+              // clang-format off
+    "future<Status>\n",
+    "future<StatusOr<$response_type$>>\n"},
+    {
+    "$logging_class_name$::Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context,\n"
+    "    $request_type$ const& request) {\n"
+    "  return google::cloud::internal::LogWrapper(\n"
+    "      [this](google::cloud::CompletionQueue& cq,\n"
+    "             std::unique_ptr<grpc::ClientContext> context,\n"
+    "             $request_type$ const& request) {\n"
+    "        return child_->Async$method_name$(cq, std::move(context), request);\n"
+    "      },\n"
+    "      cq, std::move(context), request, __func__, tracing_options_);\n"
+    "}\n"
+    "\n"}},
+            // clang-format on
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {// clang-format off
+   {"std::unique_ptr<internal::AsyncStreamingReadWriteRpc<\n"
+    "    $request_type$,\n"
+    "    $response_type$>>\n"
+    "$logging_class_name$::Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context) {\n"
+    "  using LoggingStream = internal::AsyncStreamingReadWriteRpcLogging<\n"
+    "      $request_type$,\n"
+    "      $response_type$>;\n"
+    "\n"
+    "  auto request_id = google::cloud::internal::RequestIdForLogging();\n"
+    "  GCP_LOG(DEBUG) << __func__ << \"(\" << request_id << \")\";\n"
+    "  auto stream = child_->Async$method_name$(cq, std::move(context));\n"
+    "  if (components_.count(\"rpc-streams\") > 0) {\n"
+    "    stream = absl::make_unique<LoggingStream>(\n"
+    "        std::move(stream), tracing_options_, std::move(request_id));\n"
+    "  }\n"
+    "  return stream;\n"
+    "}\n"
+    "\n"}},
+             // clang-format on
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   // long running operation support methods
   if (HasLongrunningMethod()) {
     CcPrint(  // clang-format off
@@ -90,6 +90,34 @@ Status MetadataDecoratorGenerator::GenerateHeader() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    HeaderPrintMethod(
+        method,
+        {MethodPattern({{IsResponseTypeEmpty,
+                         // clang-format off
+    "  future<Status> Async$method_name$(\n",
+    "  future<StatusOr<$response_type$>> Async$method_name$(\n"},
+   {"    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context,\n"
+    "    $request_type$ const& request) override;\n"
+                         // clang-format on
+                         "\n"}},
+                       All(IsNonStreaming, Not(IsLongrunningOperation),
+                           Not(IsPaginated))),
+         MethodPattern(
+             {// clang-format off
+   {"  std::unique_ptr<internal::AsyncStreamingReadWriteRpc<\n"
+    "      $request_type$,\n"
+    "      $response_type$>>\n"
+    "  Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context) override;\n"
+               // clang-format on
+               "\n"}},
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   if (HasLongrunningMethod()) {
     HeaderPrint(  // clang-format off
     "  /// Poll a long-running operation.\n"
@@ -193,6 +221,48 @@ Status MetadataDecoratorGenerator::GenerateCc() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    CcPrintMethod(
+        method,
+        {MethodPattern(
+            {
+                {IsResponseTypeEmpty,
+                 // clang-format off
+    "future<Status>\n",
+    "future<StatusOr<$response_type$>>\n"},
+   {"$metadata_class_name$::Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context,\n"
+    "    $request_type$ const& request) {\n"},
+   {HasRoutingHeader,
+    "  SetMetadata(*context, \"$method_request_param_key$=\" + request.$method_request_param_value$);\n",
+    "  SetMetadata(*context, {});\n"},
+   {"  return child_->Async$method_name$(cq, std::move(context), request);\n"
+    "}\n"
+    "\n",}
+                // clang-format on
+            },
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {
+                 // clang-format off
+   {"std::unique_ptr<internal::AsyncStreamingReadWriteRpc<\n"
+    "    $request_type$,\n"
+    "    $response_type$>>\n"
+    "$metadata_class_name$::Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context) {\n"
+    "  SetMetadata(*context, {});\n"
+    "  return child_->Async$method_name$(cq, std::move(context));\n"
+    "}\n"
+    "\n"}
+                 // clang-format on
+             },
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   // long running operation support methods
   if (HasLongrunningMethod()) {
     CcPrint(  // clang-format off
@@ -106,6 +106,35 @@ Status MockConnectionGenerator::GenerateHeader() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    HeaderPrintMethod(
+        method,
+        {MethodPattern(
+            {
+                {IsResponseTypeEmpty,
+                 // clang-format off
+    "  MOCK_METHOD(future<Status>,\n",
+    "  MOCK_METHOD(future<StatusOr<$response_type$>>,\n"},
+   {"  Async$method_name$,\n"
+    "  ($request_type$ const& request), (override));\n\n",}
+                // clang-format on
+            },
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {
+                 // clang-format off
+   {"  MOCK_METHOD((std::unique_ptr<\n"
+    "      ::google::cloud::internal::AsyncStreamingReadWriteRpc<\n"
+    "          $request_type$,\n"
+    "          $response_type$>>),\n"
+    "  Async$method_name$, (), (override));\n\n"},
+                 // clang-format on
+             },
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   // close abstract interface Connection base class
   HeaderPrint(  // clang-format off
     "};\n\n");
@@ -69,6 +69,14 @@ bool HasStreamingReadMethod(
   return false;
 }
 
+bool HasBidirStreamingMethod(
+    google::protobuf::ServiceDescriptor const& service) {
+  for (int i = 0; i < service.method_count(); ++i) {
+    if (IsBidirStreaming(*service.method(i))) return true;
+  }
+  return false;
+}
+
 // https://google.aip.dev/client-libraries/4233
 google::cloud::optional<std::pair<std::string, std::string>>
 DeterminePagination(google::protobuf::MethodDescriptor const& method) {
@@ -143,6 +151,10 @@ bool IsStreamingRead(google::protobuf::MethodDescriptor const& method) {
   return !method.client_streaming() && method.server_streaming();
 }
 
+bool IsBidirStreaming(google::protobuf::MethodDescriptor const& method) {
+  return method.client_streaming() && method.server_streaming();
+}
+
 bool IsLongrunningOperation(google::protobuf::MethodDescriptor const& method) {
   return method.output_type()->full_name() == "google.longrunning.Operation";
 }
@@ -46,6 +46,12 @@ bool HasMessageWithMapField(google::protobuf::ServiceDescriptor const& service);
  */
 bool HasStreamingReadMethod(google::protobuf::ServiceDescriptor const& service);
 
+/**
+ * Determines if the service contains at least one bidirectional streaming rpc.
+ */
+bool HasBidirStreamingMethod(
+    google::protobuf::ServiceDescriptor const& service);
+
 /**
  * Determines if the given method meets the criteria for pagination.
  *
@@ -65,6 +71,12 @@ bool IsNonStreaming(google::protobuf::MethodDescriptor const& method);
  */
 bool IsStreamingRead(google::protobuf::MethodDescriptor const& method);
 
+/**
+ * Determines if the given method has both a stream request and a stream
+ * response.
+ */
+bool IsBidirStreaming(google::protobuf::MethodDescriptor const& method);
+
 /**
  * Determines if the given method is a long running operation.
  */
@@ -991,6 +991,28 @@ TEST_F(StreamingReadTest, HasStreamingRead) {
       *service_file_descriptor->service(1)));
 }
 
+TEST_F(StreamingReadTest, IsBidirStreaming) {
+  const FileDescriptor* service_file_descriptor =
+      pool_.FindFileByName("google/cloud/foo/streaming.proto");
+  EXPECT_FALSE(
+      IsBidirStreaming(*service_file_descriptor->service(0)->method(0)));
+  EXPECT_FALSE(
+      IsBidirStreaming(*service_file_descriptor->service(0)->method(1)));
+  EXPECT_TRUE(
+      IsBidirStreaming(*service_file_descriptor->service(0)->method(2)));
+  EXPECT_FALSE(
+      IsBidirStreaming(*service_file_descriptor->service(0)->method(3)));
+}
+
+TEST_F(StreamingReadTest, HasBidirStreaming) {
+  const FileDescriptor* service_file_descriptor =
+      pool_.FindFileByName("google/cloud/foo/streaming.proto");
+  EXPECT_TRUE(generator_internal::HasBidirStreamingMethod(
+      *service_file_descriptor->service(0)));
+  EXPECT_TRUE(generator_internal::HasBidirStreamingMethod(
+      *service_file_descriptor->service(1)));
+}
+
 TEST(PredicateUtilsTest, HasRoutingHeaderSuccess) {
   google::protobuf::FileDescriptorProto service_file;
   /// @cond
@@ -81,6 +81,15 @@ bool ServiceCodeGenerator::HasStreamingReadMethod() const {
   return generator_internal::HasStreamingReadMethod(*service_descriptor_);
 }
 
+bool ServiceCodeGenerator::HasBidirStreamingMethod() const {
+  return generator_internal::HasBidirStreamingMethod(*service_descriptor_);
+}
+
+bool ServiceCodeGenerator::StaticRetryPolicies() const {
+  auto const iter = service_vars_.find("static_retry_policies");
+  return iter != service_vars_.end() && iter->second == "true";
+}
+
 VarsDictionary const& ServiceCodeGenerator::vars() const {
   return service_vars_;
 }
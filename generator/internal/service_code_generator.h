@@ -92,6 +92,11 @@ class ServiceCodeGenerator : public GeneratorInterface {
   bool HasPaginatedMethod() const;
   bool HasMessageWithMapField() const;
   bool HasStreamingReadMethod() const;
+  bool HasBidirStreamingMethod() const;
+
+  /// Whether the connection holds its policies by value, see
+  /// `--cpp_codegen_opt=static_retry_policies=true`.
+  bool StaticRetryPolicies() const;
 
  private:
   enum class FileType { kHeaderFile, kCcFile };
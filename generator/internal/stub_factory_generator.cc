@@ -14,6 +14,7 @@
 
 #include "generator/internal/stub_factory_generator.h"
 #include "generator/internal/codegen_utils.h"
+#include "generator/internal/predicate_utils.h"
 #include "generator/internal/printer.h"
 #include <google/api/client.pb.h>
 #include <google/protobuf/descriptor.h>
@@ -75,45 +76,190 @@ Status StubFactoryGenerator::GenerateCc() {
   // includes
   CcLocalIncludes({vars("stub_factory_header_path"),
                    vars("logging_header_path"), vars("metadata_header_path"),
-                   vars("stub_header_path"), "google/cloud/log.h"});
-  CcSystemIncludes({"memory"});
+                   vars("metrics_header_path"), vars("stub_header_path"),
+                   "google/cloud/internal/channel_cache.h",
+                   "google/cloud/internal/channel_pool.h",
+                   "google/cloud/log.h"});
+  CcSystemIncludes({"algorithm", "memory", "vector"});
   CcPrint("\n");
 
   auto result = CcOpenNamespaces(NamespaceType::kInternal);
   if (!result.ok()) return result;
 
+  // The decorator that balances the calls across the channels. It is only
+  // used by the factory function, so it is not part of the public API.
+  CcPrint(  // clang-format off
+    "namespace {\n"
+    "\n"
+    "/**\n"
+    " * Sends each call to the stub whose channel has the fewest outstanding\n"
+    " * requests.\n"
+    " *\n"
+    " * Streaming calls are balanced when they start, but are not counted as\n"
+    " * outstanding requests while the stream is open.\n"
+    " */\n"
+    "class $stub_class_name$Pool : public $stub_class_name$ {\n"
+    " public:\n"
+    "  $stub_class_name$Pool(\n"
+    "      std::shared_ptr<google::cloud::internal::ChannelPool> pool,\n"
+    "      std::vector<std::shared_ptr<$stub_class_name$>> children)\n"
+    "      : pool_(std::move(pool)), children_(std::move(children)) {}\n"
+    "\n");
+  // clang-format on
+
+  for (auto const& method : methods()) {
+    CcPrintMethod(
+        method,
+        {MethodPattern(
+             {{IsResponseTypeEmpty,
+               // clang-format off
+    "  Status $method_name$(\n",
+    "  StatusOr<$response_type$> $method_name$(\n"},
+   {"      grpc::ClientContext& context,\n"
+    "      $request_type$ const& request) override {\n"
+    "    auto lease = pool_->Acquire();\n"
+    "    return children_[lease.index()]->$method_name$(context, request);\n"
+    "  }\n"
+    "\n"}},
+             // clang-format on
+             IsNonStreaming),
+         MethodPattern(
+             {// clang-format off
+   {"  std::unique_ptr<internal::StreamingReadRpc<$response_type$>>\n"
+    "  $method_name$(\n"
+    "      grpc::ClientContext& context,\n"
+    "      $request_type$ const& request) override {\n"
+    "    auto lease = pool_->Acquire();\n"
+    "    return children_[lease.index()]->$method_name$(context, request);\n"
+    "  }\n"
+    "\n"}},
+             // clang-format on
+             IsStreamingRead)},
+        __FILE__, __LINE__);
+  }
+
+  for (auto const& method : methods()) {
+    CcPrintMethod(
+        method,
+        {MethodPattern(
+             {{IsResponseTypeEmpty,
+               // clang-format off
+    "  future<Status> Async$method_name$(\n",
+    "  future<StatusOr<$response_type$>> Async$method_name$(\n"},
+   {"      google::cloud::CompletionQueue& cq,\n"
+    "      std::unique_ptr<grpc::ClientContext> context,\n"
+    "      $request_type$ const& request) override {\n"
+    "    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(\n"
+    "        pool_->Acquire());\n"
+    "    return children_[lease->index()]\n"
+    "        ->Async$method_name$(cq, std::move(context), request)\n"},
+   {IsResponseTypeEmpty,
+    "        .then([lease](future<Status> f) { return f.get(); });\n",
+    "        .then([lease](future<StatusOr<$response_type$>> f) {\n"
+    "          return f.get();\n"
+    "        });\n"},
+   {"  }\n"
+    "\n"}},
+             // clang-format on
+             All(IsNonStreaming, Not(IsLongrunningOperation),
+                 Not(IsPaginated))),
+         MethodPattern(
+             {// clang-format off
+   {"  std::unique_ptr<internal::AsyncStreamingReadWriteRpc<\n"
+    "      $request_type$,\n"
+    "      $response_type$>>\n"
+    "  Async$method_name$(\n"
+    "      google::cloud::CompletionQueue& cq,\n"
+    "      std::unique_ptr<grpc::ClientContext> context) override {\n"
+    "    auto lease = pool_->Acquire();\n"
+    "    return children_[lease.index()]->Async$method_name$(\n"
+    "        cq, std::move(context));\n"
+    "  }\n"
+    "\n"}},
+             // clang-format on
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
+  if (HasLongrunningMethod()) {
+    CcPrint(  // clang-format off
+    "  StatusOr<google::longrunning::Operation> GetOperation(\n"
+    "      grpc::ClientContext& client_context,\n"
+    "      google::longrunning::GetOperationRequest const& request) override {\n"
+    "    auto lease = pool_->Acquire();\n"
+    "    return children_[lease.index()]->GetOperation(client_context, request);\n"
+    "  }\n"
+    "\n"
+    "  Status CancelOperation(\n"
+    "      grpc::ClientContext& client_context,\n"
+    "      google::longrunning::CancelOperationRequest const& request) override {\n"
+    "    auto lease = pool_->Acquire();\n"
+    "    return children_[lease.index()]->CancelOperation(client_context,\n"
+    "                                                     request);\n"
+    "  }\n"
+    "\n");
+    // clang-format on
+  }
+
+  CcPrint(  // clang-format off
+    " private:\n"
+    "  std::shared_ptr<google::cloud::internal::ChannelPool> pool_;\n"
+    "  std::vector<std::shared_ptr<$stub_class_name$>> children_;\n"
+    "};\n"
+    "\n"
+    "}  // namespace\n"
+    "\n");
+  // clang-format on
+
   // factory function implementation
   CcPrint(  // clang-format off
     "std::shared_ptr<$stub_class_name$>\n"
     "CreateDefault$stub_class_name$($product_namespace$::$connection_options_name$ const& options) {\n"
-    "  auto channel =\n"
-    "      grpc::CreateCustomChannel(options.endpoint(), options.credentials(),\n"
-    "                                options.CreateChannelArguments());\n"
-    "  auto service_grpc_stub =\n"
-    "      $grpc_stub_fqn$::NewStub(channel);\n");
+    "  auto const num_channels = (std::max)(options.num_channels(), 1);\n"
+    "  std::vector<std::shared_ptr<grpc::Channel>> channels;\n"
+    "  std::vector<std::shared_ptr<$stub_class_name$>> children;\n"
+    "  for (int id = 0; id != num_channels; ++id) {\n"
+    "    auto arguments = options.CreateChannelArguments();\n"
+    "    // A different `grpc.channel_id` value gives each channel its own\n"
+    "    // connection.\n"
+    "    arguments.SetInt(\"grpc.channel_id\", id);\n"
+    "    auto channel = google::cloud::internal::CreateCustomChannel(\n"
+    "        options.endpoint(), options.credentials(), arguments,\n"
+    "        options.channel_cache_enabled());\n"
+    "    auto service_grpc_stub =\n"
+    "        $grpc_stub_fqn$::NewStub(channel);\n");
+  // clang-format on
   if (HasLongrunningMethod()) {
     CcPrint(  // clang-format off
-    "  auto longrunning_grpc_stub =\n"
-    "      google::longrunning::Operations::NewStub(channel);\n"
-    "\n");
-            // clang-format on
+    "    auto longrunning_grpc_stub =\n"
+    "        google::longrunning::Operations::NewStub(channel);\n");
+    // clang-format on
   }
   CcPrint(  // clang-format off
-    "  std::shared_ptr<$stub_class_name$> stub =\n"
-    "      std::make_shared<Default$stub_class_name$>(\n"
-    "          std::move(service_grpc_stub)");
-            // clang-format on
+    "    children.push_back(std::make_shared<Default$stub_class_name$>(\n"
+    "        std::move(service_grpc_stub)");
+  // clang-format on
   if (HasLongrunningMethod()) {
     CcPrint(  // clang-format off
-    ", std::move(longrunning_grpc_stub));\n");
-              // clang-format on
+    ", std::move(longrunning_grpc_stub)));\n");
+    // clang-format on
   } else {
     CcPrint(  // clang-format off
-    ");\n");
+    "));\n");
     // clang-format on
   }
   CcPrint(  // clang-format off
+    "    channels.push_back(std::move(channel));\n"
+    "  }\n"
+    "  auto pool = std::make_shared<google::cloud::internal::ChannelPool>(\n"
+    "      std::move(channels));\n"
+    "  pool->WarmUp();\n"
+    "\n"
+    "  std::shared_ptr<$stub_class_name$> stub =\n"
+    "      std::make_shared<$stub_class_name$Pool>(std::move(pool),\n"
+    "                                              std::move(children));\n"
     "\n"
+    "  stub = std::make_shared<$metrics_class_name$>(std::move(stub));\n"
     "  stub = std::make_shared<$metadata_class_name$>(std::move(stub));\n"
     "\n"
     "  if (options.tracing_enabled(\"rpc\")) {\n"
@@ -48,10 +48,15 @@ Status StubGenerator::GenerateHeader() {
   // clang-format on
 
   // includes
-  HeaderLocalIncludes({HasStreamingReadMethod()
+  HeaderLocalIncludes({HasBidirStreamingMethod()
+                           ? "google/cloud/internal/async_read_write_stream_impl.h"
+                           : "",
+                       HasStreamingReadMethod()
                            ? "google/cloud/internal/streaming_read_rpc.h"
                            : "",
-                       "google/cloud/status_or.h", "google/cloud/version.h"});
+                       "google/cloud/completion_queue.h",
+                       "google/cloud/future.h", "google/cloud/status_or.h",
+                       "google/cloud/version.h"});
   HeaderSystemIncludes(
       {vars("proto_grpc_header_path"),
        HasLongrunningMethod() ? "google/longrunning/operations.grpc.pb.h" : "",
@@ -94,6 +99,35 @@ Status StubGenerator::GenerateHeader() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    HeaderPrintMethod(
+        method,
+        {MethodPattern(
+            {{IsResponseTypeEmpty,
+              // clang-format off
+    "  virtual future<Status> Async$method_name$(\n",
+    "  virtual future<StatusOr<$response_type$>> Async$method_name$(\n"},
+   {"    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context,\n"
+    "    $request_type$ const& request) = 0;\n"
+              // clang-format on
+              "\n"}},
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {// clang-format off
+   {"  virtual std::unique_ptr<internal::AsyncStreamingReadWriteRpc<\n"
+    "      $request_type$,\n"
+    "      $response_type$>>\n"
+    "  Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context) = 0;\n"
+    "\n"}},
+             // clang-format on
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   // long running operation support methods
   if (HasLongrunningMethod()) {
     HeaderPrint(  // clang-format off
@@ -161,6 +195,35 @@ Status StubGenerator::GenerateHeader() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    HeaderPrintMethod(
+        method,
+        {MethodPattern({{IsResponseTypeEmpty,
+                         // clang-format off
+    "  future<Status>\n",
+    "  future<StatusOr<$response_type$>>\n"},
+    {"  Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context,\n"
+    "    $request_type$ const& request) override;\n"
+    "\n"}},
+                       // clang-format on
+                       All(IsNonStreaming, Not(IsLongrunningOperation),
+                           Not(IsPaginated))),
+         MethodPattern(
+             {// clang-format off
+   {"  std::unique_ptr<internal::AsyncStreamingReadWriteRpc<\n"
+    "      $request_type$,\n"
+    "      $response_type$>>\n"
+    "  Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context) override;\n"
+    "\n"}},
+             // clang-format on
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   if (HasLongrunningMethod()) {
     // long running operation support methods
     HeaderPrint(  // clang-format off
@@ -257,9 +320,9 @@ Status StubGenerator::GenerateCc() {
     "    grpc::ClientContext&,\n"
     "    $request_type$ const& request) {\n"
     "  auto context = absl::make_unique<grpc::ClientContext>();\n"
-    "  auto stream = grpc_stub_->TailLogEntries(context.get(), request);\n"
+    "  auto stream = grpc_stub_->$method_name$(context.get(), request);\n"
     "  return absl::make_unique<internal::StreamingReadRpcImpl<\n"
-    "      ::google::test::admin::database::v1::TailLogEntriesResponse>>(\n"
+    "      $response_type$>>(\n"
     "      std::move(context), std::move(stream));\n"
     "}\n\n"}},
              // clang-format on
@@ -267,6 +330,58 @@ Status StubGenerator::GenerateCc() {
         __FILE__, __LINE__);
   }
 
+  for (auto const& method : methods()) {
+    CcPrintMethod(
+        method,
+        {MethodPattern(
+            {{IsResponseTypeEmpty,
+              // clang-format off
+    "future<Status>\n",
+    "future<StatusOr<$response_type$>>\n"},
+   {"Default$stub_class_name$::Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context,\n"
+    "    $request_type$ const& request) {\n"
+    "  return cq.MakeUnaryRpc(\n"
+    "      [this](grpc::ClientContext* context,\n"
+    "             $request_type$ const& request,\n"
+    "             grpc::CompletionQueue* cq) {\n"
+    "        return grpc_stub_->Async$method_name$(context, request, cq);\n"
+    "      },\n"
+    "      request, std::move(context))"},
+   {IsResponseTypeEmpty,
+    "\n"
+    "      .then([](future<StatusOr<$response_type$>> f) {\n"
+    "        return f.get().status();\n"
+    "      });\n",
+    ";\n"},
+   {"}\n"
+    "\n"}},
+            // clang-format on
+            All(IsNonStreaming, Not(IsLongrunningOperation),
+                Not(IsPaginated))),
+         MethodPattern(
+             {// clang-format off
+   {"std::unique_ptr<internal::AsyncStreamingReadWriteRpc<\n"
+    "    $request_type$,\n"
+    "    $response_type$>>\n"
+    "Default$stub_class_name$::Async$method_name$(\n"
+    "    google::cloud::CompletionQueue& cq,\n"
+    "    std::unique_ptr<grpc::ClientContext> context) {\n"
+    "  return internal::MakeStreamingReadWriteRpc<\n"
+    "      $request_type$,\n"
+    "      $response_type$>(\n"
+    "      cq, std::move(context),\n"
+    "      [this](grpc::ClientContext* context, grpc::CompletionQueue* cq) {\n"
+    "        return grpc_stub_->PrepareAsync$method_name$(context, cq);\n"
+    "      });\n"
+    "}\n"
+    "\n"}},
+             // clang-format on
+             IsBidirStreaming)},
+        __FILE__, __LINE__);
+  }
+
   if (HasLongrunningMethod()) {
     // long running operation support methods
     CcPrint(  // clang-format off
@@ -0,0 +1,188 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/async_log_backend.h"
+#include "google/cloud/internal/thread_affinity.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * A single-producer, single-consumer ring buffer of log records.
+ *
+ * The producer is the thread that owns the buffer, the consumer is whoever
+ * holds `AsyncLogBackend::flush_mu_`.
+ */
+class LogRingBuffer {
+ public:
+  explicit LogRingBuffer(std::size_t capacity)
+      : slots_(capacity), mask_(capacity - 1) {}
+
+  /// Append @p record, returns false (and drops it) if the buffer is full.
+  bool Push(LogRecord record, bool& half_full) {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    auto const size = tail - head_.load(std::memory_order_acquire);
+    if (size == slots_.size()) return false;
+    slots_[tail & mask_] = std::move(record);
+    tail_.store(tail + 1, std::memory_order_release);
+    half_full = 2 * (size + 1) >= slots_.size();
+    return true;
+  }
+
+  /// Remove the oldest record into @p record, returns false if empty.
+  bool Pop(LogRecord& record) {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return false;
+    record = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  void close() { closed_.store(true); }
+  bool closed() const { return closed_.load(); }
+
+ private:
+  std::vector<LogRecord> slots_;
+  std::size_t const mask_;
+  std::atomic<bool> closed_{false};
+  // Keep the consumer and producer indices in different cache lines.
+  char pad0_[64];
+  std::atomic<std::size_t> head_{0};
+  char pad1_[64];
+  std::atomic<std::size_t> tail_{0};
+};
+
+}  // namespace internal
+
+namespace {
+std::size_t RoundUpToPowerOfTwo(std::size_t n) {
+  std::size_t r = 1;
+  while (r < n) r <<= 1;
+  return r;
+}
+
+std::uint64_t NextBackendId() {
+  static std::atomic<std::uint64_t> next{0};
+  return ++next;
+}
+
+struct ThreadBufferEntry {
+  std::uint64_t id;
+  std::shared_ptr<internal::LogRingBuffer> buffer;
+};
+}  // namespace
+
+std::size_t constexpr AsyncLogBackend::kDefaultBufferSize;
+
+AsyncLogBackend::AsyncLogBackend(std::shared_ptr<LogBackend> backend,
+                                 std::size_t buffer_size,
+                                 std::chrono::milliseconds flush_interval)
+    : backend_(std::move(backend)),
+      buffer_size_(
+          RoundUpToPowerOfTwo((std::max)(buffer_size, std::size_t{2}))),
+      flush_interval_(flush_interval),
+      id_(NextBackendId()),
+      flusher_([this] { FlushLoop(); }) {}
+
+AsyncLogBackend::~AsyncLogBackend() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    shutdown_ = true;
+  }
+  cv_.notify_one();
+  flusher_.join();
+  Flush();
+  std::lock_guard<std::mutex> lk(mu_);
+  for (auto& b : buffers_) b->close();
+}
+
+void AsyncLogBackend::Process(LogRecord const& log_record) {
+  ProcessWithOwnership(log_record);
+}
+
+void AsyncLogBackend::ProcessWithOwnership(LogRecord log_record) {
+  bool half_full = false;
+  if (!ThreadBuffer()->Push(std::move(log_record), half_full)) {
+    ++dropped_;
+    return;
+  }
+  // Notifying without the lock may miss the flusher, but then it wakes up
+  // after `flush_interval_` anyway.
+  if (half_full) cv_.notify_one();
+}
+
+void AsyncLogBackend::Flush() {
+  std::lock_guard<std::mutex> flush_lk(flush_mu_);
+  auto buffers = [this] {
+    std::lock_guard<std::mutex> lk(mu_);
+    return buffers_;
+  }();
+  LogRecord record;
+  for (auto& b : buffers) {
+    while (b->Pop(record)) backend_->ProcessWithOwnership(std::move(record));
+  }
+  buffers.clear();
+  // Buffers only referenced by `buffers_` belong to threads that have exited.
+  std::lock_guard<std::mutex> lk(mu_);
+  auto exited = [](std::shared_ptr<internal::LogRingBuffer> const& b) {
+    return b.use_count() == 1 && b->empty();
+  };
+  buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), exited),
+                 buffers_.end());
+}
+
+std::shared_ptr<internal::LogRingBuffer> const&
+AsyncLogBackend::ThreadBuffer() {
+  thread_local std::vector<ThreadBufferEntry> entries;
+  for (auto const& e : entries) {
+    if (e.id == id_) return e.buffer;
+  }
+  // Only the first record from each thread gets here, take the chance to
+  // release the buffers of any destroyed backends.
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [](ThreadBufferEntry const& e) {
+                                 return e.buffer->closed();
+                               }),
+                entries.end());
+  auto buffer = std::make_shared<internal::LogRingBuffer>(buffer_size_);
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    buffers_.push_back(buffer);
+  }
+  entries.push_back(ThreadBufferEntry{id_, std::move(buffer)});
+  return entries.back().buffer;
+}
+
+void AsyncLogBackend::FlushLoop() {
+  internal::SetCurrentThreadName("gcp-log-flush");
+  std::unique_lock<std::mutex> lk(mu_);
+  while (!shutdown_) {
+    cv_.wait_for(lk, flush_interval_);
+    lk.unlock();
+    Flush();
+    lk.lock();
+  }
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,108 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_ASYNC_LOG_BACKEND_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_ASYNC_LOG_BACKEND_H
+
+#include "google/cloud/log.h"
+#include "google/cloud/version.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+class LogRingBuffer;
+}  // namespace internal
+
+/**
+ * A `LogBackend` that moves the work of another backend off the logging thread.
+ *
+ * Each thread that logs gets its own bounded, lock-free ring buffer. Logging
+ * a record only moves it into that buffer, a background thread periodically
+ * drains the buffers into the wrapped backend. If a buffer is full the record
+ * is dropped and counted in `dropped_count()`, so a slow backend never blocks
+ * the application. Records from the same thread are delivered in order, there
+ * is no ordering guarantee across threads.
+ *
+ * @par Example
+ * @code
+ * auto backend = std::make_shared<google::cloud::AsyncLogBackend>(
+ *     std::make_shared<MyBackend>());
+ * auto id = google::cloud::LogSink::Instance().AddBackend(backend);
+ * @endcode
+ */
+class AsyncLogBackend : public LogBackend {
+ public:
+  static std::size_t constexpr kDefaultBufferSize = 4096;
+
+  /**
+   * Create a backend forwarding to @p backend.
+   *
+   * @param backend the backend that receives the records.
+   * @param buffer_size the maximum number of buffered records per thread,
+   *     rounded up to a power of two.
+   * @param flush_interval how often the background thread drains the buffers.
+   */
+  explicit AsyncLogBackend(
+      std::shared_ptr<LogBackend> backend,
+      std::size_t buffer_size = kDefaultBufferSize,
+      std::chrono::milliseconds flush_interval = std::chrono::milliseconds(50));
+  ~AsyncLogBackend() override;
+
+  AsyncLogBackend(AsyncLogBackend const&) = delete;
+  AsyncLogBackend& operator=(AsyncLogBackend const&) = delete;
+
+  void Process(LogRecord const& log_record) override;
+  void ProcessWithOwnership(LogRecord log_record) override;
+
+  /// Deliver all the buffered records before returning.
+  void Flush();
+
+  /// The number of records dropped because a buffer was full.
+  std::uint64_t dropped_count() const { return dropped_.load(); }
+
+ private:
+  std::shared_ptr<internal::LogRingBuffer> const& ThreadBuffer();
+  void FlushLoop();
+
+  std::shared_ptr<LogBackend> backend_;
+  std::size_t buffer_size_;
+  std::chrono::milliseconds flush_interval_;
+  std::uint64_t const id_;
+  std::atomic<std::uint64_t> dropped_{0};
+
+  // Serializes the consumers of the buffers.
+  std::mutex flush_mu_;
+  // Guards the list of buffers.
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool shutdown_ = false;  // GUARDED_BY(mu_)
+  std::vector<std::shared_ptr<internal::LogRingBuffer>>
+      buffers_;  // GUARDED_BY(mu_)
+  std::thread flusher_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_ASYNC_LOG_BACKEND_H
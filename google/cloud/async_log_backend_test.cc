@@ -0,0 +1,160 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/async_log_backend.h"
+#include <gmock/gmock.h>
+#include <future>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+
+using ::testing::ElementsAre;
+
+class CollectingBackend : public LogBackend {
+ public:
+  void Process(LogRecord const& lr) override { ProcessWithOwnership(lr); }
+  void ProcessWithOwnership(LogRecord lr) override {
+    std::lock_guard<std::mutex> lk(mu_);
+    messages_.push_back(std::move(lr.message));
+  }
+
+  std::vector<std::string> messages() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return messages_;
+  }
+
+ private:
+  mutable std::mutex mu_;
+  std::vector<std::string> messages_;
+};
+
+LogRecord MakeRecord(std::string message) {
+  LogRecord lr;
+  lr.severity = Severity::GCP_LS_INFO;
+  lr.function = "Func";
+  lr.filename = "filename.cc";
+  lr.lineno = 123;
+  lr.timestamp = std::chrono::system_clock::now();
+  lr.message = std::move(message);
+  return lr;
+}
+
+auto constexpr kNoPeriodicFlush = std::chrono::hours(1);
+
+TEST(AsyncLogBackendTest, DeliversInOrder) {
+  auto collector = std::make_shared<CollectingBackend>();
+  AsyncLogBackend tested(collector, 16, kNoPeriodicFlush);
+  tested.Process(MakeRecord("a"));
+  tested.ProcessWithOwnership(MakeRecord("b"));
+  tested.Process(MakeRecord("c"));
+  tested.Flush();
+  EXPECT_THAT(collector->messages(), ElementsAre("a", "b", "c"));
+  EXPECT_EQ(0, tested.dropped_count());
+}
+
+TEST(AsyncLogBackendTest, FlushesOnDestruction) {
+  auto collector = std::make_shared<CollectingBackend>();
+  {
+    AsyncLogBackend tested(collector, 16, kNoPeriodicFlush);
+    tested.Process(MakeRecord("a"));
+  }
+  EXPECT_THAT(collector->messages(), ElementsAre("a"));
+}
+
+TEST(AsyncLogBackendTest, FlushesPeriodically) {
+  auto collector = std::make_shared<CollectingBackend>();
+  AsyncLogBackend tested(collector, 16, std::chrono::milliseconds(1));
+  tested.Process(MakeRecord("a"));
+  for (int i = 0; i != 1000 && collector->messages().empty(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_THAT(collector->messages(), ElementsAre("a"));
+}
+
+TEST(AsyncLogBackendTest, DropsOnOverflow) {
+  // Block the wrapped backend, so the buffer cannot drain.
+  class BlockingBackend : public LogBackend {
+   public:
+    explicit BlockingBackend(std::shared_future<void> f) : f_(std::move(f)) {}
+    void Process(LogRecord const&) override { f_.wait(); }
+    void ProcessWithOwnership(LogRecord) override { f_.wait(); }
+
+   private:
+    std::shared_future<void> f_;
+  };
+  std::promise<void> unblock;
+  auto backend =
+      std::make_shared<BlockingBackend>(unblock.get_future().share());
+  AsyncLogBackend tested(backend, 4, kNoPeriodicFlush);
+  for (int i = 0; i != 100; ++i) tested.Process(MakeRecord("r"));
+  // At most one record can be inside the backend, and the rest must fit in
+  // the buffer.
+  EXPECT_GE(tested.dropped_count(), 100 - 4 - 1);
+  unblock.set_value();
+}
+
+TEST(AsyncLogBackendTest, ManyThreads) {
+  auto constexpr kThreads = 4;
+  auto constexpr kRecords = 1000;
+  auto collector = std::make_shared<CollectingBackend>();
+  AsyncLogBackend tested(collector, kRecords, std::chrono::milliseconds(1));
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kThreads; ++t) {
+    threads.emplace_back([&tested, t] {
+      for (int i = 0; i != kRecords; ++i) {
+        tested.Process(
+            MakeRecord(std::to_string(t) + ":" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  tested.Flush();
+
+  auto const messages = collector->messages();
+  EXPECT_EQ(kThreads * kRecords, messages.size() + tested.dropped_count());
+  // Records from each thread are delivered in order.
+  std::map<std::string, int> last;
+  for (auto const& m : messages) {
+    auto const pos = m.find(':');
+    auto const thread = m.substr(0, pos);
+    auto const index = std::stoi(m.substr(pos + 1));
+    auto l = last.find(thread);
+    if (l != last.end()) {
+      EXPECT_LT(l->second, index) << m;
+    }
+    last[thread] = index;
+  }
+}
+
+TEST(AsyncLogBackendTest, WithLogSink) {
+  auto collector = std::make_shared<CollectingBackend>();
+  auto backend =
+      std::make_shared<AsyncLogBackend>(collector, 16, kNoPeriodicFlush);
+  LogSink sink;
+  sink.AddBackend(backend);
+  GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_WARNING, sink) << "test message";
+  backend->Flush();
+  EXPECT_THAT(collector->messages(), ElementsAre("test message"));
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
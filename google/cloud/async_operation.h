@@ -18,6 +18,7 @@
 #include "google/cloud/version.h"
 #include <grpcpp/grpcpp.h>
 #include <chrono>
+#include <memory>
 
 namespace google {
 namespace cloud {
@@ -75,6 +76,16 @@ class AsyncGrpcOperation : public AsyncOperation {
    *   response, it would return true only after the stream is finished).
    */
   virtual bool Notify(bool ok) = 0;
+
+ private:
+  friend class DefaultCompletionQueueImpl;
+
+  // While the operation is pending `DefaultCompletionQueueImpl` uses its
+  // address as the gRPC tag. The operation owns itself through `self_`, and it
+  // is linked into an intrusive list of pending operations.
+  std::shared_ptr<AsyncGrpcOperation> self_;
+  AsyncGrpcOperation* prev_ = nullptr;
+  AsyncGrpcOperation* next_ = nullptr;
 };
 
 }  // namespace internal
@@ -256,6 +256,69 @@ TEST_F(TableAsyncReadRowsTest, SingleRowInstantFinish) {
   ASSERT_EQ(0U, cq_impl_->size());
 }
 
+/// @test Verify that reading with a visitor delivers the cells.
+TEST_F(TableAsyncReadRowsTest, Visitor) {
+  auto& stream = AddReader([](btproto::ReadRowsRequest const&) {});
+
+  EXPECT_CALL(stream, Read(_, _))
+      .WillOnce([](btproto::ReadRowsResponse* r, void*) {
+        *r = bigtable::testing::ReadRowsResponseFromString(
+            R"(
+                chunks {
+                  row_key: "r1"
+                  family_name { value: "fam" }
+                  qualifier { value: "col" }
+                  timestamp_micros: 42000
+                  value: "v1"
+                }
+                chunks {
+                  timestamp_micros: 41000
+                  value: "v2"
+                  commit_row: true
+                })");
+      })
+      .RetiresOnSaturation();
+  EXPECT_CALL(stream, Finish(_, _)).WillOnce([](grpc::Status* status, void*) {
+    *status = grpc::Status::OK;
+  });
+
+  class Visitor : public ReadRowsVisitor {
+   public:
+    void OnRowStart(RowKeyType const& row_key) override {
+      events.push_back("start " + std::string(row_key));
+    }
+    void OnCell(Cell cell) override {
+      events.push_back("cell " + std::string(cell.value()));
+    }
+    bool OnRowCommit(RowKeyType const& row_key) override {
+      events.push_back("commit " + std::string(row_key));
+      return true;
+    }
+
+    std::vector<std::string> events;
+  };
+  auto visitor = std::make_shared<Visitor>();
+  auto done = table_.AsyncReadRows(cq_, RowSet(), Filter::PassAllFilter(),
+                                   visitor);
+
+  ASSERT_EQ(1U, cq_impl_->size());
+  cq_impl_->SimulateCompletion(true);  // Finish Start()
+  ASSERT_EQ(1U, cq_impl_->size());
+  cq_impl_->SimulateCompletion(true);  // Return data
+  std::vector<std::string> const expected{"start r1", "cell v1", "cell v2",
+                                          "commit r1"};
+  EXPECT_EQ(expected, visitor->events);
+
+  ASSERT_EQ(1U, cq_impl_->size());
+  cq_impl_->SimulateCompletion(false);  // Finish stream
+  ASSERT_EQ(1U, cq_impl_->size());
+  EXPECT_TRUE(Unsatisfied(done));
+  cq_impl_->SimulateCompletion(true);  // Finish Finish()
+
+  ASSERT_STATUS_OK(done.get());
+  ASSERT_EQ(0U, cq_impl_->size());
+}
+
 /// @test Verify that reading 2 rows delivered in 2 responses works.
 TEST_F(TableAsyncReadRowsTest, MultipleChunks) {
   auto& stream = AddReader([](btproto::ReadRowsRequest const&) {});
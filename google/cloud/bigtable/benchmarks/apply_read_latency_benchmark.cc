@@ -64,6 +64,14 @@
  * - Delete the table.
  * - Report the same results in CSV format to make analysis easier.
  *
+ * With the `--target-ops-per-second=N` flag the benchmark runs in open-loop
+ * mode instead: the operations are started at a fixed rate of N per second,
+ * independently of how long previous operations took, and executed by a pool
+ * of T threads. The latency of each operation is measured from the time it was
+ * scheduled to start. Unlike the closed-loop results, these are not affected
+ * by coordinated omission, i.e., slow periods are not underrepresented in the
+ * results because fewer operations were issued during them.
+ *
  * Using a command-line parameter the benchmark can be configured to create a
  * local gRPC server that implements the Cloud Bigtable APIs used by the
  * benchmark.  If this parameter is not used the benchmark uses the default
@@ -94,6 +102,11 @@ google::cloud::StatusOr<LatencyBenchmarkResult> RunBenchmark(
     bigtable::benchmarks::Benchmark& benchmark, std::string app_profile_id,
     std::string const& table_id, std::chrono::seconds test_duration);
 
+/// Run the test in open-loop mode, at the rate configured in @p setup.
+void RunOpenLoopBenchmark(bigtable::benchmarks::Benchmark& benchmark,
+                          bigtable::benchmarks::BenchmarkSetup const& setup,
+                          BenchmarkResult& populate_results);
+
 //@{
 /// @name Test constants.  Defined as requirements in the original bug (#189).
 /// How many times does each thread report progress.
@@ -122,6 +135,12 @@ int main(int argc, char* argv[]) {
   Benchmark::PrintThroughputResult(std::cout, "perf", "Upload",
                                    *populate_results);
 
+  if (setup->target_ops_per_second() > 0) {
+    RunOpenLoopBenchmark(benchmark, *setup, *populate_results);
+    benchmark.DeleteTable();
+    return 0;
+  }
+
   auto data_client = benchmark.MakeDataClient();
   // Start the threads running the latency test.
   std::cout << "Running Latency Benchmark " << std::flush;
@@ -254,4 +273,52 @@ google::cloud::StatusOr<LatencyBenchmarkResult> RunBenchmark(
   return result;
 }
 
+void RunOpenLoopBenchmark(bigtable::benchmarks::Benchmark& benchmark,
+                          bigtable::benchmarks::BenchmarkSetup const& setup,
+                          BenchmarkResult& populate_results) {
+  enum OperationType : std::size_t { kApply, kReadRow, kOperationTypeCount };
+  auto make_operation = [&benchmark, &setup] {
+    auto table = std::make_shared<bigtable::Table>(
+        benchmark.MakeDataClient(), setup.app_profile_id(), setup.table_id());
+    auto generator = std::make_shared<google::cloud::internal::DefaultPRNG>(
+        google::cloud::internal::MakeDefaultPRNG());
+    return [&benchmark, table, generator] {
+      auto row_key = benchmark.MakeRandomKey(*generator);
+      std::uniform_int_distribution<int> prng_operation(0, 1);
+      if (prng_operation(*generator) == 0) {
+        auto r = RunOneApply(*table, std::move(row_key), *generator);
+        return bigtable::benchmarks::OpenLoopSample{kApply, r.status};
+      }
+      auto r = RunOneReadRow(*table, std::move(row_key));
+      return bigtable::benchmarks::OpenLoopSample{kReadRow, r.status};
+    };
+  };
+
+  std::cout << "Running Open-Loop Latency Benchmark at "
+            << setup.target_ops_per_second() << " ops/s " << std::flush;
+  auto results = Benchmark::RunOpenLoop(
+      setup.target_ops_per_second(), setup.test_duration(),
+      setup.thread_count(), kOperationTypeCount, make_operation);
+  auto const& apply = results[kApply];
+  auto const& read = results[kReadRow];
+  std::cout << " DONE. Elapsed=" << FormatDuration(apply.elapsed)
+            << ", Ops=" << apply.latency.count() + read.latency.count()
+            << ", Errors=" << apply.error_count + read.error_count << "\n";
+
+  Benchmark::PrintLatencyResult(std::cout, "perf", "Apply()", apply);
+  Benchmark::PrintLatencyResult(std::cout, "perf", "ReadRow()", read);
+
+  std::cout << Benchmark::ResultsCsvHeader() << "\n";
+  benchmark.PrintResultCsv(std::cout, "perf", "BulkApply()", "Latency",
+                           populate_results);
+  benchmark.PrintResultCsv(std::cout, "perf", "Apply()", "Latency",
+                           apply.latency, apply.elapsed);
+  benchmark.PrintResultCsv(std::cout, "perf", "Apply()", "ServiceTime",
+                           apply.service_time, apply.elapsed);
+  benchmark.PrintResultCsv(std::cout, "perf", "ReadRow()", "Latency",
+                           read.latency, read.elapsed);
+  benchmark.PrintResultCsv(std::cout, "perf", "ReadRow()", "ServiceTime",
+                           read.service_time, read.elapsed);
+}
+
 }  // anonymous namespace
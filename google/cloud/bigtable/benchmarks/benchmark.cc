@@ -15,6 +15,7 @@
 #include "google/cloud/bigtable/benchmarks/benchmark.h"
 #include "google/cloud/bigtable/benchmarks/random_mutation.h"
 #include "google/cloud/bigtable/table_admin.h"
+#include <atomic>
 #include <future>
 #include <iomanip>
 #include <sstream>
@@ -33,7 +34,7 @@ Benchmark::Benchmark(BenchmarkSetup setup)
       key_width_(KeyWidth()),
       client_options_(grpc::InsecureChannelCredentials()) {
   if (setup_.use_embedded_server()) {
-    server_ = CreateEmbeddedServer();
+    server_ = CreateEmbeddedServer(setup_.embedded_server_options());
     std::string address = server_->address();
     std::cout << "Running embedded Cloud Bigtable server at " << address
               << "\n";
@@ -145,6 +146,59 @@ std::string Benchmark::MakeKey(std::int64_t id) const {
   return os.str();
 }
 
+std::vector<OpenLoopResult> Benchmark::RunOpenLoop(
+    double ops_per_second, std::chrono::milliseconds duration,
+    int thread_count, std::size_t type_count,
+    std::function<OpenLoopOperation()> const& make_operation) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto const total = static_cast<std::int64_t>(
+      ops_per_second * static_cast<double>(duration.count()) / 1000.0);
+  auto const start = std::chrono::steady_clock::now();
+  // Compute each start time from the start of the benchmark, accumulating the
+  // interval between operations would accumulate rounding errors too.
+  auto scheduled_start = [start, ops_per_second](std::int64_t i) {
+    return start + std::chrono::nanoseconds(static_cast<std::int64_t>(
+                       static_cast<double>(i) * 1.0E9 / ops_per_second));
+  };
+
+  std::atomic<std::int64_t> next{0};
+  auto worker = [&]() {
+    std::vector<OpenLoopResult> partial(type_count);
+    auto op = make_operation();
+    for (auto i = next++; i < total; i = next++) {
+      auto const scheduled = scheduled_start(i);
+      std::this_thread::sleep_until(scheduled);
+      auto const actual = std::chrono::steady_clock::now();
+      auto sample = op();
+      auto const now = std::chrono::steady_clock::now();
+      auto& r = partial.at(sample.type);
+      r.latency.Record(duration_cast<microseconds>(now - scheduled));
+      r.service_time.Record(duration_cast<microseconds>(now - actual));
+      if (!sample.status.ok()) ++r.error_count;
+    }
+    return partial;
+  };
+
+  std::vector<std::future<std::vector<OpenLoopResult>>> tasks;
+  for (int i = 0; i != thread_count; ++i) {
+    tasks.emplace_back(std::async(std::launch::async, worker));
+  }
+  std::vector<OpenLoopResult> results(type_count);
+  for (auto& t : tasks) {
+    auto partial = t.get();
+    for (std::size_t i = 0; i != type_count; ++i) {
+      results[i].error_count += partial[i].error_count;
+      results[i].latency.Merge(partial[i].latency);
+      results[i].service_time.Merge(partial[i].service_time);
+    }
+  }
+  auto const elapsed = duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  for (auto& r : results) r.elapsed = elapsed;
+  return results;
+}
+
 void Benchmark::PrintThroughputResult(std::ostream& os, std::string const&,
                                       std::string const& phase,
                                       BenchmarkResult const& result) {
@@ -184,6 +238,34 @@ void Benchmark::PrintLatencyResult(std::ostream& os,
   os << "\n";
 }
 
+void Benchmark::PrintLatencyResult(std::ostream& os,
+                                   std::string const& test_name,
+                                   std::string const& operation,
+                                   OpenLoopResult const& result) {
+  if (result.latency.count() == 0) {
+    os << "# Test=" << test_name << ", " << operation << " no results\n";
+    return;
+  }
+  auto const elapsed_ms = (std::max)(result.elapsed.count(),
+                                     std::chrono::milliseconds::rep{1});
+  auto ops_throughput = 1000 * result.latency.count() / elapsed_ms;
+  os << "# Test=" << test_name << ", " << operation
+     << " Throughput = " << ops_throughput
+     << " ops/s, Errors = " << result.error_count;
+  auto print = [&os](char const* name, LatencyHistogram const& h) {
+    os << ", " << name << ": ";
+    char const* sep = "";
+    for (double p : kResultPercentiles) {
+      os << sep << "p" << std::setprecision(3) << p << "="
+         << std::setprecision(2) << FormatDuration(h.Percentile(p));
+      sep = ", ";
+    }
+  };
+  print("Latency", result.latency);
+  print("Service Time", result.service_time);
+  os << "\n";
+}
+
 std::string Benchmark::ResultsCsvHeader() {
   return "name,start,op.name,measurement,nsamples,min,p50,p90,p95,p99,p99.9,max"
          ",units,throughput.rows,throughput.ops,notes";
@@ -219,6 +301,28 @@ void Benchmark::PrintResultCsv(std::ostream& os, std::string const& test_name,
      << setup_.notes() << "\n";
 }
 
+void Benchmark::PrintResultCsv(std::ostream& os, std::string const& test_name,
+                               std::string const& op_name,
+                               std::string const& measurement,
+                               LatencyHistogram const& histogram,
+                               std::chrono::milliseconds elapsed) const {
+  if (histogram.count() == 0) {
+    os << "# Test=" << test_name << ", " << op_name << " no results\n";
+    return;
+  }
+  os << test_name << "," << setup_.start_time() << "," << op_name << ","
+     << measurement << "," << histogram.count();
+  for (double p : kResultPercentiles) {
+    os << "," << histogram.Percentile(p).count();
+  }
+  auto const elapsed_ms =
+      (std::max)(elapsed.count(), std::chrono::milliseconds::rep{1});
+  // Each operation in the open-loop benchmarks touches a single row.
+  auto ops_throughput = 1000 * histogram.count() / elapsed_ms;
+  os << ",us," << ops_throughput << "," << ops_throughput << ","
+     << setup_.notes() << "\n";
+}
+
 int Benchmark::create_table_count() const {
   if (!server_) {
     return 0;
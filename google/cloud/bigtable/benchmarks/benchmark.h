@@ -16,13 +16,16 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_BENCHMARK_H
 
 #include "google/cloud/bigtable/benchmarks/embedded_server.h"
+#include "google/cloud/bigtable/benchmarks/latency_histogram.h"
 #include "google/cloud/bigtable/benchmarks/setup.h"
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/internal/random.h"
 #include "google/cloud/status_or.h"
 #include <chrono>
 #include <deque>
+#include <functional>
 #include <thread>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -40,6 +43,32 @@ struct BenchmarkResult {
   std::int64_t row_count;
 };
 
+/// The result of a single operation in an open-loop benchmark.
+struct OpenLoopSample {
+  /// The type of operation, used to select the `OpenLoopResult`.
+  std::size_t type;
+  google::cloud::Status status;
+};
+
+/// Execute one operation in an open-loop benchmark.
+using OpenLoopOperation = std::function<OpenLoopSample()>;
+
+/**
+ * The results for one type of operation in an open-loop benchmark.
+ *
+ * `latency` is measured from the time the operation was scheduled to start,
+ * and includes any time spent waiting for a worker thread. This is the latency
+ * a client issuing requests at a fixed rate would observe. `service_time` is
+ * measured from the time the operation actually started, which is what a
+ * closed-loop benchmark reports.
+ */
+struct OpenLoopResult {
+  std::chrono::milliseconds elapsed;
+  std::int64_t error_count;
+  LatencyHistogram latency;
+  LatencyHistogram service_time;
+};
+
 /**
  * Common code used by the Cloud Bigtable C++ Client benchmarks.
  */
@@ -80,6 +109,31 @@ class Benchmark {
     return OperationResult{status, elapsed};
   }
 
+  /**
+   * Run operations at a fixed arrival rate, independent of their latency.
+   *
+   * Closed-loop benchmarks, where each thread starts a new operation as soon
+   * as the previous one completes, issue fewer operations when the service
+   * slows down. The slow periods are then underrepresented in the results, a
+   * problem known as "coordinated omission". This function schedules the i-th
+   * operation to start at `i / ops_per_second` seconds after the benchmark
+   * starts, and measures its latency from that scheduled time. Operations are
+   * executed by @p thread_count worker threads; if all of them are busy the
+   * operations start late, and the delay is included in their latency.
+   *
+   * @param ops_per_second the arrival rate, must be > 0.
+   * @param duration how long to issue new operations.
+   * @param thread_count the number of worker threads, must be > 0.
+   * @param type_count the number of operation types, the size of the result.
+   * @param make_operation called once by each worker thread, it returns the
+   *     function executing one operation. This function returns an
+   *     `OpenLoopSample` with a `type` in the `[0, type_count)` range.
+   */
+  static std::vector<OpenLoopResult> RunOpenLoop(
+      double ops_per_second, std::chrono::milliseconds duration,
+      int thread_count, std::size_t type_count,
+      std::function<OpenLoopOperation()> const& make_operation);
+
   /// Print the result of a throughput test in human readable form.
   static void PrintThroughputResult(std::ostream& os,
                                     std::string const& test_name,
@@ -91,6 +145,11 @@ class Benchmark {
                                  std::string const& operation,
                                  BenchmarkResult& result);
 
+  /// Print the result of an open-loop latency test in human readable form.
+  static void PrintLatencyResult(std::ostream& os, std::string const& test_name,
+                                 std::string const& operation,
+                                 OpenLoopResult const& result);
+
   /// Return the header for CSV results.
   static std::string ResultsCsvHeader();
 
@@ -100,6 +159,13 @@ class Benchmark {
                       std::string const& measurement,
                       BenchmarkResult& result) const;
 
+  /// Print the result of an open-loop benchmark as a CSV line.
+  void PrintResultCsv(std::ostream& os, std::string const& test_name,
+                      std::string const& op_name,
+                      std::string const& measurement,
+                      LatencyHistogram const& histogram,
+                      std::chrono::milliseconds elapsed) const;
+
   //@{
   /**
    * @name Embedded server counter accessors.
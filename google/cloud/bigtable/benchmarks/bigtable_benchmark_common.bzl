@@ -20,6 +20,7 @@ bigtable_benchmark_common_hdrs = [
     "benchmark.h",
     "constants.h",
     "embedded_server.h",
+    "latency_histogram.h",
     "random_mutation.h",
     "setup.h",
 ]
@@ -27,6 +28,7 @@ bigtable_benchmark_common_hdrs = [
 bigtable_benchmark_common_srcs = [
     "benchmark.cc",
     "embedded_server.cc",
+    "latency_histogram.cc",
     "random_mutation.cc",
     "setup.cc",
 ]
@@ -16,6 +16,7 @@
 #include "google/cloud/internal/build_info.h"
 #include "google/cloud/testing_util/assert_ok.h"
 #include <gmock/gmock.h>
+#include <atomic>
 
 namespace google {
 namespace cloud {
@@ -204,6 +205,87 @@ TEST(BenchmarkTest, PrintCsv) {
   EXPECT_THAT(output, HasSubstr(",123,"));
 }
 
+TEST(BenchmarkTest, RunOpenLoop) {
+  std::atomic<int> workers{0};
+  auto make_operation = [&workers] {
+    ++workers;
+    auto count = std::make_shared<int>(0);
+    return [count] {
+      auto const type = static_cast<std::size_t>(++*count % 2);
+      return OpenLoopSample{type, type == 0 ? Status{}
+                                            : Status(StatusCode::kUnavailable,
+                                                     "try-again")};
+    };
+  };
+  auto results = Benchmark::RunOpenLoop(1000, std::chrono::milliseconds(100),
+                                        2, 2, make_operation);
+  EXPECT_EQ(2, workers.load());
+  ASSERT_EQ(2U, results.size());
+  EXPECT_EQ(100, results[0].latency.count() + results[1].latency.count());
+  EXPECT_EQ(results[0].latency.count(), results[0].service_time.count());
+  EXPECT_EQ(0, results[0].error_count);
+  EXPECT_EQ(results[1].latency.count(), results[1].error_count);
+  // The operations are scheduled over 100ms, the benchmark cannot finish
+  // earlier than the last scheduled operation.
+  EXPECT_GE(results[0].elapsed, std::chrono::milliseconds(99));
+}
+
+TEST(BenchmarkTest, RunOpenLoopIncludesQueueing) {
+  // A single worker cannot keep up with the arrival rate, the operations start
+  // later and later. The service time remains low, but the latency, measured
+  // from the scheduled start, includes the queueing delay.
+  auto make_operation = [] {
+    return [] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      return OpenLoopSample{0, Status{}};
+    };
+  };
+  auto results = Benchmark::RunOpenLoop(1000, std::chrono::milliseconds(50),
+                                        1, 1, make_operation);
+  ASSERT_EQ(1U, results.size());
+  auto const& r = results[0];
+  EXPECT_EQ(50, r.latency.count());
+  EXPECT_LT(r.service_time.Percentile(50), std::chrono::milliseconds(100));
+  EXPECT_GE(r.latency.max(), std::chrono::milliseconds(150));
+  EXPECT_GE(r.elapsed, std::chrono::milliseconds(250));
+}
+
+TEST(BenchmarkTest, PrintOpenLoopResult) {
+  char* argv[] = {arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  auto setup = MakeBenchmarkSetup("latency", argc, argv);
+  ASSERT_STATUS_OK(setup);
+
+  Benchmark bm(*setup);
+  OpenLoopResult result{};
+  result.elapsed = std::chrono::milliseconds(1000);
+  result.error_count = 3;
+  for (int i = 1; i <= 100; ++i) {
+    result.latency.Record(std::chrono::microseconds(i * 100));
+    result.service_time.Record(std::chrono::microseconds(i * 10));
+  }
+
+  std::ostringstream os;
+  Benchmark::PrintLatencyResult(os, "foo", "bar", result);
+  auto output = os.str();
+  EXPECT_THAT(output, HasSubstr("100 ops/s"));
+  EXPECT_THAT(output, HasSubstr("Errors = 3"));
+  EXPECT_THAT(output, HasSubstr("p0=100.000us"));
+  EXPECT_THAT(output, HasSubstr("p100=10.000ms"));
+  EXPECT_THAT(output, HasSubstr("p100=1.000ms"));
+
+  std::string header = Benchmark::ResultsCsvHeader();
+  auto const field_count = std::count(header.begin(), header.end(), ',');
+  std::ostringstream csv;
+  bm.PrintResultCsv(csv, "foo", "bar", "Latency", result.latency,
+                    result.elapsed);
+  auto const csv_output = csv.str();
+  EXPECT_EQ(field_count,
+            std::count(csv_output.begin(), csv_output.end(), ','));
+  EXPECT_THAT(csv_output, HasSubstr(",100,"));    // p0
+  EXPECT_THAT(csv_output, HasSubstr(",10000,"));  // p100
+}
+
 }  // namespace
 }  // namespace benchmarks
 }  // namespace bigtable
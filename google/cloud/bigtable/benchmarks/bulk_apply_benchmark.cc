@@ -0,0 +1,125 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/constants.h"
+#include "google/cloud/bigtable/benchmarks/random_mutation.h"
+#include "google/cloud/bigtable/internal/bulk_mutator.h"
+#include "google/cloud/internal/random.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+/**
+ * @file
+ *
+ * Measure the client-side cost of retrying large `BulkApply()` requests.
+ *
+ * `Table::BulkApply()` resends only the mutations that failed with a transient
+ * error. This benchmark measures how long the client library takes to prepare
+ * each attempt and to process its results, without any network or server
+ * costs. The benchmark:
+ * - Creates a `BulkMutation` with N rows (by default 100,000), each row with
+ *   `kNumFields` random values of `kFieldSize` bytes.
+ * - Simulates up to A attempts (by default 5) of the `MutateRows()` RPC. In
+ *   each attempt a fraction F (by default 0.5) of the mutations fails with
+ *   `UNAVAILABLE`, and the rest succeed.
+ * - Reports, for each attempt, the number of mutations sent, the time to
+ *   prepare the request, and the time to process the responses.
+ *
+ * Usage: bulk_apply_benchmark [row-count] [attempts] [failure-rate]
+ */
+
+namespace {
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using bigtable::benchmarks::kNumFields;
+using bigtable::benchmarks::MakeRandomMutation;
+
+bigtable::BulkMutation MakeBulkMutation(
+    google::cloud::internal::DefaultPRNG& generator, std::int64_t row_count) {
+  bigtable::BulkMutation bulk;
+  for (std::int64_t row = 0; row != row_count; ++row) {
+    bigtable::SingleRowMutation mutation("user" + std::to_string(row));
+    for (int field = 0; field != kNumFields; ++field) {
+      mutation.emplace_back(MakeRandomMutation(generator, field));
+    }
+    bulk.emplace_back(std::move(mutation));
+  }
+  return bulk;
+}
+
+btproto::MutateRowsResponse MakeResponse(
+    google::cloud::internal::DefaultPRNG& generator, int size,
+    double failure_rate) {
+  std::bernoulli_distribution fail(failure_rate);
+  btproto::MutateRowsResponse response;
+  for (int i = 0; i != size; ++i) {
+    auto& entry = *response.add_entries();
+    entry.set_index(i);
+    entry.mutable_status()->set_code(fail(generator) ? grpc::UNAVAILABLE
+                                                     : grpc::OK);
+  }
+  return response;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  std::int64_t row_count = 100000;
+  int attempts = 5;
+  double failure_rate = 0.5;
+  if (argc > 1) row_count = std::stoll(argv[1]);
+  if (argc > 2) attempts = std::stoi(argv[2]);
+  if (argc > 3) failure_rate = std::stod(argv[3]);
+  if (row_count <= 0 || attempts <= 0 || failure_rate < 0 ||
+      failure_rate > 1) {
+    std::cerr << "Usage: " << argv[0]
+              << " [row-count] [attempts] [failure-rate]\n";
+    return 1;
+  }
+
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  bigtable::SafeIdempotentMutationPolicy policy;
+  bigtable::internal::BulkMutatorState state(
+      "", "projects/p/instances/i/tables/t", policy,
+      MakeBulkMutation(generator, row_count));
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+  std::cout << "Attempt,Mutations,BeforeStartUs,ProcessResultsUs\n";
+  for (int attempt = 0; attempt != attempts && state.HasPendingMutations();
+       ++attempt) {
+    auto start = steady_clock::now();
+    auto const& request = state.BeforeStart();
+    auto const before_start = steady_clock::now() - start;
+
+    auto const size = request.entries_size();
+    auto response = MakeResponse(generator, size, failure_rate);
+    start = steady_clock::now();
+    state.OnRead(response);
+    state.OnFinish(google::cloud::Status{});
+    auto const process = steady_clock::now() - start;
+    std::cout << attempt << "," << size << ","
+              << duration_cast<microseconds>(before_start).count() << ","
+              << duration_cast<microseconds>(process).count() << "\n";
+  }
+  auto const failures = std::move(state).OnRetryDone();
+  std::cout << "Failed mutations: " << failures.size() << "\n";
+
+  return 0;
+}
@@ -17,9 +17,14 @@
 #include "google/cloud/bigtable/benchmarks/setup.h"
 #include <google/bigtable/admin/v2/bigtable_table_admin.grpc.pb.h>
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <iomanip>
+#include <mutex>
+#include <random>
 #include <sstream>
+#include <thread>
 
 namespace btproto = google::bigtable::v2;
 namespace btadmin = google::bigtable::admin::v2;
@@ -28,6 +33,89 @@ namespace google {
 namespace cloud {
 namespace bigtable {
 namespace benchmarks {
+/**
+ * Injects the latency, errors, and throughput limits configured in
+ * `EmbeddedServerOptions`.
+ *
+ * The random choices are serialized, so runs with the same seed and the same
+ * sequence of requests make the same choices.
+ */
+class Simulator {
+ public:
+  explicit Simulator(EmbeddedServerOptions options)
+      : options_(std::move(options)),
+        enabled_(options_.median_latency.count() > 0 ||
+                 options_.error_rate > 0 ||
+                 options_.mutation_failure_rate > 0),
+        // The p99 of a standard normal distribution.
+        sigma_(options_.tail_latency_ratio > 1.0
+                   ? std::log(options_.tail_latency_ratio) / 2.326348
+                   : 0.0),
+        generator_(options_.seed),
+        next_slot_(Clock::now()) {}
+
+  /// Waits for the simulated latency, returns an error if the RPC fails.
+  grpc::Status StartRpc() {
+    if (!enabled_) return grpc::Status::OK;
+    bool fail;
+    std::chrono::microseconds latency;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      fail = Chance(options_.error_rate);
+      latency = SampleLatency();
+    }
+    if (latency.count() > 0) std::this_thread::sleep_for(latency);
+    if (!fail) return grpc::Status::OK;
+    return grpc::Status(grpc::StatusCode::UNAVAILABLE, "simulated failure");
+  }
+
+  /// Returns true if a `MutateRows` entry should fail.
+  bool FailMutation() {
+    if (options_.mutation_failure_rate <= 0) return false;
+    std::lock_guard<std::mutex> lk(mu_);
+    return Chance(options_.mutation_failure_rate);
+  }
+
+  /// Waits until @p rows more rows can be processed within the limit.
+  void Throttle(std::int64_t rows) {
+    if (options_.max_rows_per_second <= 0) return;
+    auto const cost = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(rows) /
+                                      options_.max_rows_per_second));
+    Clock::time_point start;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      start = (std::max)(next_slot_, Clock::now());
+      next_slot_ = start + cost;
+    }
+    std::this_thread::sleep_until(start);
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  bool Chance(double probability) {
+    if (probability <= 0) return false;
+    return std::uniform_real_distribution<double>(0, 1)(generator_) <
+           probability;
+  }
+
+  std::chrono::microseconds SampleLatency() {
+    auto const median = options_.median_latency;
+    if (median.count() <= 0 || sigma_ == 0.0) return median;
+    auto const m = static_cast<double>(median.count());
+    return std::chrono::microseconds(static_cast<std::int64_t>(
+        std::lognormal_distribution<double>(std::log(m), sigma_)(generator_)));
+  }
+
+  EmbeddedServerOptions const options_;
+  bool const enabled_;
+  double const sigma_;
+  std::mutex mu_;
+  google::cloud::internal::DefaultPRNG generator_;  // GUARDED_BY(mu_)
+  Clock::time_point next_slot_;                     // GUARDED_BY(mu_)
+};
+
 /**
  * Implement the portions of the `google.bigtable.v2.Bigtable` interface
  * necessary for the benchmarks.
@@ -39,8 +127,11 @@ namespace benchmarks {
  */
 class BigtableImpl final : public btproto::Bigtable::Service {
  public:
-  BigtableImpl()
-      : mutate_row_count_(0), mutate_rows_count_(0), read_rows_count_(0) {
+  explicit BigtableImpl(EmbeddedServerOptions options)
+      : simulator_(std::move(options)),
+        mutate_row_count_(0),
+        mutate_rows_count_(0),
+        read_rows_count_(0) {
     // Prepare a list of random values to use at run-time.  This is because we
     // want the overhead of this implementation to be as small as possible.
     // Using a single value is an option, but compresses too well and makes the
@@ -54,6 +145,9 @@ class BigtableImpl final : public btproto::Bigtable::Service {
   grpc::Status MutateRow(grpc::ServerContext*, btproto::MutateRowRequest const*,
                          btproto::MutateRowResponse*) override {
     ++mutate_row_count_;
+    auto status = simulator_.StartRpc();
+    if (!status.ok()) return status;
+    simulator_.Throttle(1);
     return grpc::Status::OK;
   }
 
@@ -61,10 +155,18 @@ class BigtableImpl final : public btproto::Bigtable::Service {
       grpc::ServerContext*, btproto::MutateRowsRequest const* request,
       grpc::ServerWriter<btproto::MutateRowsResponse>* writer) override {
     ++mutate_rows_count_;
+    auto status = simulator_.StartRpc();
+    if (!status.ok()) return status;
+    simulator_.Throttle(request->entries_size());
     btproto::MutateRowsResponse msg;
     for (int index = 0; index != request->entries_size(); ++index) {
       auto& entry = *msg.add_entries();
       entry.set_index(index);
+      if (simulator_.FailMutation()) {
+        entry.mutable_status()->set_code(grpc::StatusCode::UNAVAILABLE);
+        entry.mutable_status()->set_message("simulated mutation failure");
+        continue;
+      }
       entry.mutable_status()->set_code(grpc::StatusCode::OK);
     }
     writer->WriteLast(msg, grpc::WriteOptions());
@@ -75,6 +177,8 @@ class BigtableImpl final : public btproto::Bigtable::Service {
       grpc::ServerContext*, btproto::ReadRowsRequest const* request,
       grpc::ServerWriter<btproto::ReadRowsResponse>* writer) override {
     ++read_rows_count_;
+    auto status = simulator_.StartRpc();
+    if (!status.ok()) return status;
     std::int64_t rows_limit = 10000;
     if (request->rows_limit() != 0) {
       rows_limit = request->rows_limit();
@@ -82,6 +186,7 @@ class BigtableImpl final : public btproto::Bigtable::Service {
 
     btproto::ReadRowsResponse msg;
     for (std::int64_t i = 0; i != rows_limit; ++i) {
+      simulator_.Throttle(1);
       std::size_t idx = 0;
       char const* cf = kColumnFamily;
       std::ostringstream os;
@@ -120,6 +225,7 @@ class BigtableImpl final : public btproto::Bigtable::Service {
   int read_rows_count() const { return read_rows_count_.load(); }
 
  private:
+  Simulator simulator_;
   std::vector<std::string> values_;
   std::atomic<int> mutate_row_count_;
   std::atomic<int> mutate_rows_count_;
@@ -160,7 +266,8 @@ class TableAdminImpl final : public btadmin::BigtableTableAdmin::Service {
 /// The implementation of EmbeddedServer.
 class DefaultEmbeddedServer : public EmbeddedServer {
  public:
-  explicit DefaultEmbeddedServer() {
+  explicit DefaultEmbeddedServer(EmbeddedServerOptions options)
+      : bigtable_service_(std::move(options)) {
     int port;
     std::string server_address("[::]:0");
     builder_.AddListeningPort(server_address, grpc::InsecureServerCredentials(),
@@ -200,7 +307,13 @@ class DefaultEmbeddedServer : public EmbeddedServer {
 };
 
 std::unique_ptr<EmbeddedServer> CreateEmbeddedServer() {
-  return std::unique_ptr<EmbeddedServer>(new DefaultEmbeddedServer);
+  return CreateEmbeddedServer(EmbeddedServerOptions{});
+}
+
+std::unique_ptr<EmbeddedServer> CreateEmbeddedServer(
+    EmbeddedServerOptions options) {
+  return std::unique_ptr<EmbeddedServer>(
+      new DefaultEmbeddedServer(std::move(options)));
 }
 
 }  // namespace benchmarks
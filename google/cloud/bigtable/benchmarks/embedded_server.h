@@ -15,6 +15,8 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_EMBEDDED_SERVER_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_EMBEDDED_SERVER_H
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -22,6 +24,38 @@ namespace google {
 namespace cloud {
 namespace bigtable {
 namespace benchmarks {
+/**
+ * Simulates the latency, errors, and throughput limits of a real service.
+ *
+ * By default the embedded server answers immediately and never fails, which
+ * hides how retries, hedging, and batching behave under realistic conditions.
+ * These options make the server slower and less reliable, in a repeatable
+ * way: all the random choices use a generator initialized with `seed`.
+ */
+struct EmbeddedServerOptions {
+  /// The median latency added to each data RPC, zero disables the latency.
+  std::chrono::microseconds median_latency = std::chrono::microseconds(0);
+
+  /**
+   * The ratio between the p99 and the median latency.
+   *
+   * The latency follows a log-normal distribution, with this ratio larger
+   * than 1.0 some requests are much slower than the median.
+   */
+  double tail_latency_ratio = 1.0;
+
+  /// The fraction of data RPCs that fail with `UNAVAILABLE`.
+  double error_rate = 0.0;
+
+  /// The fraction of `MutateRows` entries that fail with `UNAVAILABLE`.
+  double mutation_failure_rate = 0.0;
+
+  /// Limit the rows read and mutated per second, zero disables the limit.
+  double max_rows_per_second = 0.0;
+
+  std::uint64_t seed = 0;
+};
+
 /**
  * An abstract class to run and stop the embedded Bigtable server.
  *
@@ -49,6 +83,10 @@ class EmbeddedServer {
 /// Create an embedded server.
 std::unique_ptr<EmbeddedServer> CreateEmbeddedServer();
 
+/// Create an embedded server simulating the given latency and failures.
+std::unique_ptr<EmbeddedServer> CreateEmbeddedServer(
+    EmbeddedServerOptions options);
+
 }  // namespace benchmarks
 }  // namespace bigtable
 }  // namespace cloud
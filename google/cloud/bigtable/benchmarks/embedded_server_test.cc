@@ -146,6 +146,72 @@ TEST(EmbeddedServer, ReadRows100) {
   wait_thread.join();
 }
 
+TEST(EmbeddedServer, SimulatedErrors) {
+  EmbeddedServerOptions server_options;
+  server_options.error_rate = 1.0;
+  auto server = CreateEmbeddedServer(server_options);
+  std::thread wait_thread([&server]() { server->Wait(); });
+
+  ClientOptions options(grpc::InsecureChannelCredentials());
+  options.set_data_endpoint(server->address());
+  Table table(CreateDefaultDataClient("fake-project", "fake-instance", options),
+              "fake-table", LimitedErrorCountRetryPolicy(2),
+              ExponentialBackoffPolicy(milliseconds(1), milliseconds(2)));
+
+  auto status = table.Apply(SingleRowMutation(
+      "row1", {SetCell("fam", "col", milliseconds(0), "val")}));
+  EXPECT_EQ(StatusCode::kUnavailable, status.code());
+  EXPECT_EQ(3, server->mutate_row_count());
+
+  server->Shutdown();
+  wait_thread.join();
+}
+
+TEST(EmbeddedServer, SimulatedMutationFailures) {
+  EmbeddedServerOptions server_options;
+  server_options.mutation_failure_rate = 1.0;
+  auto server = CreateEmbeddedServer(server_options);
+  std::thread wait_thread([&server]() { server->Wait(); });
+
+  ClientOptions options(grpc::InsecureChannelCredentials());
+  options.set_data_endpoint(server->address());
+  Table table(CreateDefaultDataClient("fake-project", "fake-instance", options),
+              "fake-table", LimitedErrorCountRetryPolicy(0),
+              ExponentialBackoffPolicy(milliseconds(1), milliseconds(2)));
+
+  BulkMutation bulk;
+  bulk.emplace_back(SingleRowMutation(
+      "row1", {SetCell("fam", "col", milliseconds(0), "val")}));
+  bulk.emplace_back(SingleRowMutation(
+      "row2", {SetCell("fam", "col", milliseconds(0), "val")}));
+  auto failures = table.BulkApply(std::move(bulk));
+  EXPECT_EQ(2U, failures.size());
+
+  server->Shutdown();
+  wait_thread.join();
+}
+
+TEST(EmbeddedServer, SimulatedLatency) {
+  EmbeddedServerOptions server_options;
+  server_options.median_latency = std::chrono::microseconds(20000);
+  auto server = CreateEmbeddedServer(server_options);
+  std::thread wait_thread([&server]() { server->Wait(); });
+
+  ClientOptions options(grpc::InsecureChannelCredentials());
+  options.set_data_endpoint(server->address());
+  Table table(CreateDefaultDataClient("fake-project", "fake-instance", options),
+              "fake-table");
+
+  // With a tail ratio of 1.0 every request takes the median latency.
+  auto const start = std::chrono::steady_clock::now();
+  auto reader = table.ReadRows(RowSet("row1"), 1, Filter::PassAllFilter());
+  EXPECT_EQ(1, std::distance(reader.begin(), reader.end()));
+  EXPECT_GE(std::chrono::steady_clock::now() - start, milliseconds(20));
+
+  server->Shutdown();
+  wait_thread.join();
+}
+
 }  // namespace
 }  // namespace benchmarks
 }  // namespace bigtable
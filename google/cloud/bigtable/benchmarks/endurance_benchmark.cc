@@ -46,6 +46,13 @@
  * The test then waits for all the threads to finish and reports effective
  * throughput.
  *
+ * With the `--target-ops-per-second=N` flag the benchmark starts the
+ * operations at a fixed rate of N per second (in the same 2 reads per write
+ * mix), executed by a pool of T threads. The latency of each operation is
+ * measured from the time it was scheduled to start, so stalls in the service
+ * are fully reflected in the results, and the benchmark reports latency
+ * histograms for each operation type.
+ *
  * Using a command-line parameter the benchmark can be configured to create a
  * local gRPC server that implements the Cloud Bigtable APIs used by the
  * benchmark.  If this parameter is not used the benchmark uses the default
@@ -70,6 +77,10 @@ google::cloud::StatusOr<long> RunBenchmark(  // NOLINT(google-runtime-int)
     bigtable::benchmarks::Benchmark& benchmark, std::string app_profile_id,
     std::string const& table_id, std::chrono::seconds test_duration);
 
+/// Run the test in open-loop mode, at the rate configured in @p setup.
+void RunOpenLoopBenchmark(bigtable::benchmarks::Benchmark& benchmark,
+                          bigtable::benchmarks::BenchmarkSetup const& setup);
+
 }  // anonymous namespace
 
 int main(int argc, char* argv[]) {
@@ -83,6 +94,12 @@ int main(int argc, char* argv[]) {
   // Create and populate the table for the benchmark.
   benchmark.CreateTable();
 
+  if (setup->target_ops_per_second() > 0) {
+    RunOpenLoopBenchmark(benchmark, *setup);
+    benchmark.DeleteTable();
+    return 0;
+  }
+
   // Start the threads running the latency test.
   std::cout << "# Running Endurance Benchmark:\n";
   auto latency_test_start = std::chrono::steady_clock::now();
@@ -195,4 +212,38 @@ google::cloud::StatusOr<long> RunBenchmark(  // NOLINT(google-runtime-int)
   return static_cast<long>(partial.operations.size());
 }
 
+void RunOpenLoopBenchmark(bigtable::benchmarks::Benchmark& benchmark,
+                          bigtable::benchmarks::BenchmarkSetup const& setup) {
+  enum OperationType : std::size_t { kReadRow, kApply, kOperationTypeCount };
+  auto make_operation = [&benchmark, &setup] {
+    auto table = std::make_shared<bigtable::Table>(
+        benchmark.MakeDataClient(), setup.app_profile_id(), setup.table_id());
+    auto generator = std::make_shared<google::cloud::internal::DefaultPRNG>(
+        google::cloud::internal::MakeDefaultPRNG());
+    auto counter = std::make_shared<int>(0);
+    return [&benchmark, table, generator, counter] {
+      // Keep the same mix as the closed-loop test: two reads per write.
+      if (++*counter % 3 == 0) {
+        auto r = RunOneApply(*table, benchmark, *generator);
+        return bigtable::benchmarks::OpenLoopSample{kApply, r.status};
+      }
+      auto r = RunOneReadRow(*table, benchmark, *generator);
+      return bigtable::benchmarks::OpenLoopSample{kReadRow, r.status};
+    };
+  };
+
+  std::cout << "# Running Open-Loop Endurance Benchmark at "
+            << setup.target_ops_per_second() << " ops/s\n";
+  auto results = Benchmark::RunOpenLoop(
+      setup.target_ops_per_second(), setup.test_duration(),
+      setup.thread_count(), kOperationTypeCount, make_operation);
+  auto const& read = results[kReadRow];
+  auto const& apply = results[kApply];
+  std::cout << "# DONE. Elapsed=" << FormatDuration(read.elapsed)
+            << ", Ops=" << read.latency.count() + apply.latency.count()
+            << ", Errors=" << read.error_count + apply.error_count << "\n";
+  Benchmark::PrintLatencyResult(std::cout, "long", "ReadRow()", read);
+  Benchmark::PrintLatencyResult(std::cout, "long", "Apply()", apply);
+}
+
 }  // anonymous namespace
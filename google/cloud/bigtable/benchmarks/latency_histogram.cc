@@ -0,0 +1,103 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/// The number of sub-buckets in each power-of-two range.
+constexpr std::int64_t kSubBucketCount = 1024;
+constexpr std::int64_t kSubBucketHalfCount = kSubBucketCount / 2;
+}  // anonymous namespace
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+
+void LatencyHistogram::Record(std::chrono::microseconds value) {
+  auto const v = (std::max)(std::int64_t{0},
+                            static_cast<std::int64_t>(value.count()));
+  auto const index = IndexFor(v);
+  if (index >= counts_.size()) counts_.resize(index + 1);
+  ++counts_[index];
+  min_ = count_ == 0 ? v : (std::min)(min_, v);
+  max_ = (std::max)(max_, v);
+  sum_ += v;
+  ++count_;
+}
+
+void LatencyHistogram::Merge(LatencyHistogram const& rhs) {
+  if (rhs.count_ == 0) return;
+  if (rhs.counts_.size() > counts_.size()) counts_.resize(rhs.counts_.size());
+  for (std::size_t i = 0; i != rhs.counts_.size(); ++i) {
+    counts_[i] += rhs.counts_[i];
+  }
+  min_ = count_ == 0 ? rhs.min_ : (std::min)(min_, rhs.min_);
+  max_ = (std::max)(max_, rhs.max_);
+  sum_ += rhs.sum_;
+  count_ += rhs.count_;
+}
+
+std::chrono::microseconds LatencyHistogram::mean() const {
+  if (count_ == 0) return std::chrono::microseconds(0);
+  return std::chrono::microseconds(sum_ / count_);
+}
+
+std::chrono::microseconds LatencyHistogram::Percentile(
+    double percentile) const {
+  if (count_ == 0) return std::chrono::microseconds(0);
+  if (percentile <= 0) return min();
+  if (percentile >= 100) return max();
+  // Round to the nearest rank, `std::ceil()` is too sensitive to floating
+  // point errors, e.g., 99.9% of 1000 samples might round up to 1000.
+  auto rank = static_cast<std::int64_t>(
+      percentile / 100.0 * static_cast<double>(count_) + 0.5);
+  rank = (std::max)(rank, std::int64_t{1});
+  std::int64_t cumulative = 0;
+  for (std::size_t i = 0; i != counts_.size(); ++i) {
+    cumulative += counts_[i];
+    if (cumulative >= rank) {
+      return std::chrono::microseconds(
+          (std::min)(HighestEquivalentValue(i), max_));
+    }
+  }
+  return max();
+}
+
+std::size_t LatencyHistogram::IndexFor(std::int64_t value) {
+  if (value < kSubBucketCount) return static_cast<std::size_t>(value);
+  // Find the power-of-two range for `value`, once shifted the value falls in
+  // the upper half of the sub-buckets, i.e. in [512, 1024).
+  int shift = 0;
+  while ((value >> shift) >= kSubBucketCount) ++shift;
+  return static_cast<std::size_t>(kSubBucketCount +
+                                  (shift - 1) * kSubBucketHalfCount +
+                                  (value >> shift) - kSubBucketHalfCount);
+}
+
+std::int64_t LatencyHistogram::HighestEquivalentValue(std::size_t index) {
+  auto const i = static_cast<std::int64_t>(index);
+  if (i < kSubBucketCount) return i;
+  auto const offset = i - kSubBucketCount;
+  auto const shift = offset / kSubBucketHalfCount + 1;
+  auto const sub_bucket = offset % kSubBucketHalfCount + kSubBucketHalfCount;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,88 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_LATENCY_HISTOGRAM_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_LATENCY_HISTOGRAM_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+/**
+ * A latency histogram with bounded relative error, in the style of HDR
+ * Histogram.
+ *
+ * Values are recorded in microseconds. Values below 1024us are recorded
+ * exactly, larger values are grouped in power-of-two ranges, each split into
+ * 512 linear sub-buckets, so any reported value is within 0.2% of the recorded
+ * value. Memory usage depends only on the largest value recorded (about 50KiB
+ * for values up to 1 second), not on the number of samples, which makes it
+ * suitable for benchmarks running for many hours.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram() = default;
+
+  /// Record a single sample, negative values are recorded as 0.
+  void Record(std::chrono::microseconds value);
+
+  /// Add all the samples in @p rhs to this histogram.
+  void Merge(LatencyHistogram const& rhs);
+
+  /// The number of samples recorded.
+  std::int64_t count() const { return count_; }
+
+  /// The smallest sample recorded, or 0 if the histogram is empty.
+  std::chrono::microseconds min() const {
+    return std::chrono::microseconds(count_ == 0 ? 0 : min_);
+  }
+
+  /// The largest sample recorded, or 0 if the histogram is empty.
+  std::chrono::microseconds max() const {
+    return std::chrono::microseconds(max_);
+  }
+
+  /// The mean of all the samples, or 0 if the histogram is empty.
+  std::chrono::microseconds mean() const;
+
+  /**
+   * Return the value at the @p percentile (in the [0, 100] range).
+   *
+   * The result is the largest value equivalent (within the histogram
+   * precision) to the sample at that rank, capped by `max()`. Returns 0 if the
+   * histogram is empty.
+   */
+  std::chrono::microseconds Percentile(double percentile) const;
+
+ private:
+  static std::size_t IndexFor(std::int64_t value);
+  static std::int64_t HighestEquivalentValue(std::size_t index);
+
+  std::vector<std::int64_t> counts_;
+  std::int64_t count_ = 0;
+  std::int64_t sum_ = 0;
+  std::int64_t min_ = 0;
+  std::int64_t max_ = 0;
+};
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_LATENCY_HISTOGRAM_H
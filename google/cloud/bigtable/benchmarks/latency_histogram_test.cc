@@ -0,0 +1,97 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/latency_histogram.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+namespace {
+
+using ::std::chrono::microseconds;
+using ::std::chrono::milliseconds;
+using ::std::chrono::seconds;
+
+TEST(LatencyHistogram, Empty) {
+  LatencyHistogram h;
+  EXPECT_EQ(0, h.count());
+  EXPECT_EQ(microseconds(0), h.min());
+  EXPECT_EQ(microseconds(0), h.max());
+  EXPECT_EQ(microseconds(0), h.mean());
+  EXPECT_EQ(microseconds(0), h.Percentile(50));
+}
+
+TEST(LatencyHistogram, SmallValuesAreExact) {
+  LatencyHistogram h;
+  for (int i = 1; i <= 1000; ++i) h.Record(microseconds(i));
+  EXPECT_EQ(1000, h.count());
+  EXPECT_EQ(microseconds(1), h.min());
+  EXPECT_EQ(microseconds(1000), h.max());
+  EXPECT_EQ(microseconds(500), h.mean());
+  EXPECT_EQ(microseconds(1), h.Percentile(0));
+  EXPECT_EQ(microseconds(500), h.Percentile(50));
+  EXPECT_EQ(microseconds(990), h.Percentile(99));
+  EXPECT_EQ(microseconds(999), h.Percentile(99.9));
+  EXPECT_EQ(microseconds(1000), h.Percentile(100));
+}
+
+TEST(LatencyHistogram, LargeValuesBoundedError) {
+  LatencyHistogram h;
+  for (auto v : {microseconds(1500), microseconds(123456),
+                 std::chrono::duration_cast<microseconds>(milliseconds(7890)),
+                 std::chrono::duration_cast<microseconds>(seconds(3600))}) {
+    LatencyHistogram single;
+    single.Record(v);
+    single.Record(v * 2);
+    auto const actual = single.Percentile(50);
+    EXPECT_GE(actual, v);
+    EXPECT_LE((actual - v).count(), v.count() / 500) << "v=" << v.count();
+    h.Merge(single);
+  }
+  EXPECT_EQ(8, h.count());
+  EXPECT_EQ(microseconds(1500), h.min());
+  EXPECT_EQ(std::chrono::duration_cast<microseconds>(seconds(7200)), h.max());
+}
+
+TEST(LatencyHistogram, NegativeValues) {
+  LatencyHistogram h;
+  h.Record(microseconds(-10));
+  EXPECT_EQ(1, h.count());
+  EXPECT_EQ(microseconds(0), h.max());
+}
+
+TEST(LatencyHistogram, Merge) {
+  LatencyHistogram a;
+  LatencyHistogram b;
+  for (int i = 0; i != 100; ++i) a.Record(microseconds(100));
+  for (int i = 0; i != 100; ++i) b.Record(microseconds(200000));
+  LatencyHistogram merged;
+  merged.Merge(a);
+  merged.Merge(LatencyHistogram{});
+  merged.Merge(b);
+  EXPECT_EQ(200, merged.count());
+  EXPECT_EQ(microseconds(100), merged.min());
+  EXPECT_EQ(microseconds(200000), merged.max());
+  EXPECT_EQ(microseconds(100), merged.Percentile(50));
+  EXPECT_EQ(microseconds(200000), merged.Percentile(51));
+  EXPECT_EQ(microseconds(100050), merged.mean());
+}
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
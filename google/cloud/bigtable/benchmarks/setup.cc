@@ -18,15 +18,26 @@
 #include "google/cloud/internal/getenv.h"
 #include "google/cloud/internal/random.h"
 #include "google/cloud/internal/throw_delegate.h"
+#include "google/cloud/optional.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
 /// Supporting types and functions to implement `BenchmarkSetup`
 namespace {
+char const kTargetRateFlag[] = "--target-ops-per-second=";
+char const kServerLatencyFlag[] = "--embedded-server-latency-us=";
+char const kServerTailRatioFlag[] = "--embedded-server-tail-ratio=";
+char const kServerErrorRateFlag[] = "--embedded-server-error-rate=";
+char const kServerMutationFailureRateFlag[] =
+    "--embedded-server-mutation-failure-rate=";
+char const kServerMaxRowsPerSecondFlag[] =
+    "--embedded-server-max-rows-per-second=";
+
 std::string FormattedStartTime() {
   return absl::FormatTime("%FT%TZ", absl::Now(), absl::UTCTimeZone());
 }
@@ -74,6 +85,7 @@ google::cloud::StatusOr<BenchmarkSetup> MakeBenchmarkSetup(
   setup_data.test_duration = std::chrono::seconds(kDefaultTestDuration * 60);
   setup_data.use_embedded_server = false;
   setup_data.parallel_requests = 10;
+  setup_data.target_ops_per_second = 0;
 
   auto usage = [argv](char const* msg) -> google::cloud::Status {
     std::string const cmd = argv[0];
@@ -83,11 +95,59 @@ google::cloud::StatusOr<BenchmarkSetup> MakeBenchmarkSetup(
               << " [thread-count (" << kDefaultThreads << ")]"
               << " [test-duration-seconds (" << kDefaultTestDuration << "min)]"
               << " [table-size (" << kDefaultTableSize << ")]"
-              << " [use-embedded-server (false)]\n";
+              << " [use-embedded-server (false)]"
+              << " [parallel-requests (10)]"
+              << " [" << kTargetRateFlag << "N (0, closed loop)]"
+              << " [" << kServerLatencyFlag << "N (0)]"
+              << " [" << kServerTailRatioFlag << "X (1.0)]"
+              << " [" << kServerErrorRateFlag << "X (0.0)]"
+              << " [" << kServerMutationFailureRateFlag << "X (0.0)]"
+              << " [" << kServerMaxRowsPerSecondFlag << "N (0, unlimited)]\n";
     return google::cloud::Status{google::cloud::StatusCode::kFailedPrecondition,
                                  msg};
   };
 
+  // The flags are optional, they can appear anywhere in the command-line and
+  // are removed before parsing the positional arguments.
+  auto const flags_end =
+      std::stable_partition(argv + 1, argv + argc, [](char const* arg) {
+        return std::string(arg).rfind("--", 0) != 0;
+      });
+  auto& server = setup_data.embedded_server_options;
+  for (auto i = flags_end; i != argv + argc; ++i) {
+    std::string const arg = *i;
+    auto value = [&arg](char const* flag) -> optional<double> {
+      if (arg.rfind(flag, 0) != 0) return {};
+      return std::stod(arg.substr(std::strlen(flag)));
+    };
+    if (auto v = value(kTargetRateFlag)) {
+      setup_data.target_ops_per_second = *v;
+    } else if (auto v = value(kServerLatencyFlag)) {
+      server.median_latency =
+          std::chrono::microseconds(static_cast<std::int64_t>(*v));
+    } else if (auto v = value(kServerTailRatioFlag)) {
+      server.tail_latency_ratio = *v;
+    } else if (auto v = value(kServerErrorRateFlag)) {
+      server.error_rate = *v;
+    } else if (auto v = value(kServerMutationFailureRateFlag)) {
+      server.mutation_failure_rate = *v;
+    } else if (auto v = value(kServerMaxRowsPerSecondFlag)) {
+      server.max_rows_per_second = *v;
+    } else {
+      return usage("unknown flag");
+    }
+  }
+  argc = static_cast<int>(flags_end - argv);
+  if (setup_data.target_ops_per_second < 0) {
+    return usage("target-ops-per-second should be >= 0");
+  }
+  if (server.median_latency.count() < 0 || server.tail_latency_ratio < 1.0 ||
+      server.error_rate < 0 || server.error_rate > 1 ||
+      server.mutation_failure_rate < 0 || server.mutation_failure_rate > 1 ||
+      server.max_rows_per_second < 0) {
+    return usage("invalid embedded server simulation flag");
+  }
+
   bool auto_run =
       google::cloud::internal::GetEnv("GOOGLE_CLOUD_CPP_AUTO_RUN_EXAMPLES")
           .value_or("") == "yes";
@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_SETUP_H
 
 #include "google/cloud/bigtable/benchmarks/constants.h"
+#include "google/cloud/bigtable/benchmarks/embedded_server.h"
 #include "google/cloud/status_or.h"
 #include <chrono>
 #include <string>
@@ -41,6 +42,12 @@ struct BenchmarkSetupData {
   bool use_embedded_server;
 
   int parallel_requests;
+
+  /// If not zero, run the latency benchmarks at this fixed arrival rate.
+  double target_ops_per_second;
+
+  /// The simulated latency and failures of the embedded server.
+  EmbeddedServerOptions embedded_server_options;
 };
 
 /**
@@ -72,6 +79,21 @@ class BenchmarkSetup {
 
   int parallel_requests() const { return setup_data_.parallel_requests; }
 
+  /**
+   * The arrival rate for open-loop benchmarks.
+   *
+   * If zero (the default) the latency benchmarks run in a closed loop, each
+   * thread starting a new operation when the previous one completes.
+   */
+  double target_ops_per_second() const {
+    return setup_data_.target_ops_per_second;
+  }
+
+  /// The latency, errors, and throughput limits of the embedded server.
+  EmbeddedServerOptions const& embedded_server_options() const {
+    return setup_data_.embedded_server_options;
+  }
+
  private:
   BenchmarkSetupData setup_data_;
 };
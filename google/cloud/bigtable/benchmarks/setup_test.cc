@@ -221,6 +221,69 @@ TEST(BenchmarkSetup, TableSize) {
   EXPECT_FALSE(MakeBenchmarkSetup("table-size", argc, argv));
 }
 
+TEST(BenchmarkSetup, TargetRate) {
+  char rate[] = "--target-ops-per-second=1500";
+  char* argv[] = {arg0, arg1, rate, arg2, arg3,
+                  arg4, arg5, arg6, arg7, arg8, arg9};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  auto setup = MakeBenchmarkSetup("rate", argc, argv);
+  ASSERT_STATUS_OK(setup);
+  EXPECT_EQ(2, argc);
+  EXPECT_EQ(std::string("Unused"), argv[1]);
+  EXPECT_EQ("bar", setup->instance_id());
+  EXPECT_EQ(4, setup->thread_count());
+  EXPECT_EQ(1500, setup->target_ops_per_second());
+}
+
+TEST(BenchmarkSetup, TargetRateDefault) {
+  char* argv[] = {arg0, arg1, arg2, arg3};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  auto setup = MakeBenchmarkSetup("rate", argc, argv);
+  ASSERT_STATUS_OK(setup);
+  EXPECT_EQ(0, setup->target_ops_per_second());
+}
+
+TEST(BenchmarkSetup, TargetRateNegative) {
+  char rate[] = "--target-ops-per-second=-1";
+  char* argv[] = {arg0, arg1, arg2, arg3, rate};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  EXPECT_FALSE(MakeBenchmarkSetup("rate", argc, argv));
+}
+
+TEST(BenchmarkSetup, EmbeddedServerFlags) {
+  char latency[] = "--embedded-server-latency-us=500";
+  char ratio[] = "--embedded-server-tail-ratio=4";
+  char errors[] = "--embedded-server-error-rate=0.01";
+  char failures[] = "--embedded-server-mutation-failure-rate=0.02";
+  char rows[] = "--embedded-server-max-rows-per-second=10000";
+  char* argv[] = {arg0, latency, arg1, ratio, arg2, errors, arg3, failures,
+                  rows};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  auto setup = MakeBenchmarkSetup("server", argc, argv);
+  ASSERT_STATUS_OK(setup);
+  EXPECT_EQ(4, argc);
+  auto const& server = setup->embedded_server_options();
+  EXPECT_EQ(std::chrono::microseconds(500), server.median_latency);
+  EXPECT_EQ(4.0, server.tail_latency_ratio);
+  EXPECT_EQ(0.01, server.error_rate);
+  EXPECT_EQ(0.02, server.mutation_failure_rate);
+  EXPECT_EQ(10000, server.max_rows_per_second);
+}
+
+TEST(BenchmarkSetup, EmbeddedServerFlagsInvalid) {
+  char ratio[] = "--embedded-server-tail-ratio=0.5";
+  char* argv[] = {arg0, arg1, arg2, arg3, ratio};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  EXPECT_FALSE(MakeBenchmarkSetup("server", argc, argv));
+}
+
+TEST(BenchmarkSetup, UnknownFlag) {
+  char flag[] = "--not-a-flag=1";
+  char* argv[] = {arg0, arg1, arg2, arg3, flag};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  EXPECT_FALSE(MakeBenchmarkSetup("server", argc, argv));
+}
+
 }  // namespace
 }  // namespace benchmarks
 }  // namespace bigtable
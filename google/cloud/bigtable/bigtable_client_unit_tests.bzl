@@ -25,17 +25,21 @@ bigtable_client_unit_tests = [
     "async_read_stream_test.cc",
     "async_row_reader_test.cc",
     "bigtable_version_test.cc",
+    "bulk_loader_test.cc",
     "cell_test.cc",
     "client_options_test.cc",
     "cluster_config_test.cc",
     "column_family_test.cc",
+    "columnar_reader_test.cc",
     "data_client_test.cc",
     "expr_test.cc",
     "filters_test.cc",
     "force_sanitizer_failures_test.cc",
+    "hedging_policy_test.cc",
     "iam_binding_test.cc",
     "iam_policy_test.cc",
     "idempotent_mutation_policy_test.cc",
+    "increment_aggregator_test.cc",
     "instance_admin_client_test.cc",
     "instance_admin_test.cc",
     "instance_config_test.cc",
@@ -46,23 +50,34 @@ bigtable_client_unit_tests = [
     "internal/async_retry_multi_page_test.cc",
     "internal/async_retry_unary_rpc_and_poll_test.cc",
     "internal/bulk_mutator_test.cc",
+    "internal/caching_data_client_test.cc",
+    "internal/channel_load_balancer_test.cc",
     "internal/common_client_test.cc",
     "internal/google_bytes_traits_test.cc",
+    "internal/hedged_client_reader_test.cc",
     "internal/logging_admin_client_test.cc",
     "internal/logging_data_client_test.cc",
     "internal/logging_instance_admin_client_test.cc",
     "internal/prefix_range_end_test.cc",
+    "internal/read_rows_read_ahead_test.cc",
+    "internal/row_cache_test.cc",
+    "internal/sorted_row_set_test.cc",
+    "internal/string_interner_test.cc",
     "metadata_update_policy_test.cc",
     "mutation_batcher_test.cc",
     "mutations_test.cc",
+    "parallel_scan_test.cc",
     "polling_policy_test.cc",
+    "prepared_read_rows_request_test.cc",
     "read_modify_write_rule_test.cc",
     "row_range_test.cc",
     "row_reader_test.cc",
     "row_set_test.cc",
+    "rows_by_keys_test.cc",
     "row_test.cc",
     "rpc_backoff_policy_test.cc",
     "rpc_retry_policy_test.cc",
+    "split_point_cache_test.cc",
     "table_admin_test.cc",
     "table_apply_test.cc",
     "table_bulk_apply_test.cc",
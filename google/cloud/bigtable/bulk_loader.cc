@@ -0,0 +1,279 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/bulk_loader.h"
+#include "google/cloud/bigtable/parallel_scan.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/**
+ * Read one CSV record from @p is.
+ *
+ * @return false at the end of the input.
+ */
+StatusOr<bool> ReadCsvRecord(std::istream& is,
+                             std::vector<std::string>& fields) {
+  fields.clear();
+  std::string field;
+  bool quoted = false;
+  bool empty = true;
+  for (auto c = is.get(); c != std::istream::traits_type::eof(); c = is.get()) {
+    empty = false;
+    if (quoted) {
+      if (c != '"') {
+        field.push_back(static_cast<char>(c));
+      } else if (is.peek() == '"') {
+        field.push_back(static_cast<char>(is.get()));
+      } else {
+        quoted = false;
+      }
+      continue;
+    }
+    if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.push_back(std::move(field));
+      field.clear();
+    } else if (c == '\n') {
+      fields.push_back(std::move(field));
+      return true;
+    } else if (c != '\r' || is.peek() != '\n') {
+      field.push_back(static_cast<char>(c));
+    }
+  }
+  if (quoted) {
+    return Status(StatusCode::kInvalidArgument, "unterminated quoted field");
+  }
+  if (empty) return false;
+  fields.push_back(std::move(field));
+  return true;
+}
+
+/// The state shared by `BulkLoader::Load()` and the mutation callbacks.
+struct LoadState {
+  void OnCompletion(Status status, std::size_t bytes, std::size_t cells) {
+    std::unique_lock<std::mutex> lk(mu);
+    outstanding_bytes -= bytes;
+    --outstanding_rows;
+    if (status.ok()) {
+      ++progress.rows;
+      progress.cells += cells;
+      progress.bytes += bytes;
+    } else {
+      ++progress.failed_rows;
+      if (this->status.ok()) this->status = std::move(status);
+    }
+    lk.unlock();
+    cv.notify_all();
+  }
+
+  std::mutex mu;
+  std::condition_variable cv;
+  std::size_t outstanding_bytes = 0;  // GUARDED_BY(mu)
+  std::size_t outstanding_rows = 0;   // GUARDED_BY(mu)
+  BulkLoadProgress progress;          // GUARDED_BY(mu)
+  Status status;                      // GUARDED_BY(mu)
+};
+}  // namespace
+
+BulkLoadSource MakeCsvBulkLoadSource(std::istream& is) {
+  auto record_count = std::make_shared<std::uint64_t>(0);
+  return [&is, record_count]() -> StatusOr<absl::optional<BulkLoadRecord>> {
+    std::vector<std::string> fields;
+    while (true) {
+      auto more = ReadCsvRecord(is, fields);
+      if (!more) return std::move(more).status();
+      if (!*more) return absl::optional<BulkLoadRecord>{};
+      ++*record_count;
+      if (fields.size() == 1 && fields[0].empty()) continue;
+      if (fields.size() != 4 && fields.size() != 5) {
+        return Status(StatusCode::kInvalidArgument,
+                      "record " + std::to_string(*record_count) +
+                          ": expected 4 or 5 fields, got " +
+                          std::to_string(fields.size()));
+      }
+      BulkLoadRecord record;
+      record.row_key = std::move(fields[0]);
+      record.family = std::move(fields[1]);
+      record.column = std::move(fields[2]);
+      record.value = std::move(fields[3]);
+      if (fields.size() == 5) {
+        char* end = nullptr;
+        auto const timestamp = std::strtoll(fields[4].c_str(), &end, 10);
+        if (fields[4].empty() || *end != '\0') {
+          return Status(StatusCode::kInvalidArgument,
+                        "record " + std::to_string(*record_count) +
+                            ": invalid timestamp <" + fields[4] + ">");
+        }
+        record.timestamp_micros = static_cast<std::int64_t>(timestamp);
+      }
+      return absl::make_optional(std::move(record));
+    }
+  };
+}
+
+StatusOr<BulkLoadProgress> BulkLoader::Load(BulkLoadSource const& source) {
+  auto splits = SplitPoints();
+  if (!splits) return std::move(splits).status();
+  std::vector<std::unique_ptr<MutationBatcher>> batchers;
+  batchers.reserve(splits->size() + 1);
+  for (std::size_t i = 0; i <= splits->size(); ++i) {
+    batchers.push_back(MakeBatcher(table_, options_.batcher_options));
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto const start = Clock::now();
+  // Use the same timestamp for all the cells without one, so retrying (or
+  // reloading) a row is idempotent. Bigtable uses millisecond granularity.
+  auto const default_timestamp =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch()))
+          .count();
+
+  auto state = std::make_shared<LoadState>();
+  auto snapshot = [&] {
+    std::unique_lock<std::mutex> lk(state->mu);
+    auto p = state->progress;
+    lk.unlock();
+    p.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - start);
+    return p;
+  };
+  auto report = [&] {
+    if (options_.progress_callback) options_.progress_callback(snapshot());
+  };
+
+  absl::optional<SingleRowMutation> row;
+  std::size_t row_bytes = 0;
+  std::size_t row_cells = 0;
+  auto flush = [&] {
+    if (!row) return;
+    auto const bytes = row_bytes;
+    auto const cells = row_cells;
+    {
+      std::unique_lock<std::mutex> lk(state->mu);
+      state->cv.wait(lk, [&] {
+        return state->outstanding_bytes == 0 ||
+               state->outstanding_bytes + bytes <=
+                   options_.max_outstanding_bytes;
+      });
+      state->outstanding_bytes += bytes;
+      ++state->outstanding_rows;
+    }
+    auto const shard =
+        std::upper_bound(splits->begin(), splits->end(), row->row_key()) -
+        splits->begin();
+    auto f = batchers[shard]->AsyncApply(cq_, *std::move(row));
+    row.reset();
+    row_bytes = 0;
+    row_cells = 0;
+    f.second.then([state, bytes, cells](future<Status> g) {
+      state->OnCompletion(g.get(), bytes, cells);
+    });
+    f.first.get();
+  };
+
+  auto next_report = start + options_.progress_period;
+  Status source_status;
+  while (true) {
+    auto record = source();
+    if (!record) {
+      source_status = std::move(record).status();
+      break;
+    }
+    if (!*record) {
+      flush();
+      break;
+    }
+    auto& r = **record;
+    if (row && row->row_key() != r.row_key) flush();
+    if (!row) {
+      row_bytes += r.row_key.size();
+      row.emplace(std::move(r.row_key));
+    }
+    row_bytes += r.family.size() + r.column.size() + r.value.size();
+    ++row_cells;
+    Mutation m;
+    auto& set_cell = *m.op.mutable_set_cell();
+    set_cell.set_family_name(std::move(r.family));
+    set_cell.set_column_qualifier(std::move(r.column));
+    set_cell.set_timestamp_micros(
+        r.timestamp_micros.value_or(default_timestamp));
+    set_cell.set_value(std::move(r.value));
+    row->emplace_back(std::move(m));
+
+    if (Clock::now() >= next_report) {
+      report();
+      next_report = Clock::now() + options_.progress_period;
+    }
+  }
+
+  for (auto& b : batchers) b->AsyncWaitForNoPendingRequests().get();
+  {
+    // The completion callbacks may run after the batchers are done.
+    std::unique_lock<std::mutex> lk(state->mu);
+    state->cv.wait(lk, [&] { return state->outstanding_rows == 0; });
+  }
+  report();
+  if (!source_status.ok()) return source_status;
+  {
+    std::lock_guard<std::mutex> lk(state->mu);
+    if (!state->status.ok()) return state->status;
+  }
+  return snapshot();
+}
+
+std::unique_ptr<MutationBatcher> BulkLoader::MakeBatcher(
+    Table table, MutationBatcher::Options options) {
+  return absl::make_unique<MutationBatcher>(std::move(table),
+                                            std::move(options));
+}
+
+StatusOr<std::vector<RowKeySample>> BulkLoader::SampleRowsImpl(Table& table) {
+  return table.SampleRows();
+}
+
+StatusOr<std::vector<std::string>> BulkLoader::SplitPoints() {
+  auto splits = options_.split_points;
+  if (splits.empty() && options_.max_shards > 1) {
+    auto samples = SampleRowsImpl(table_);
+    if (!samples) return std::move(samples).status();
+    // SplitRowSet() chooses split points evenly spaced by size, each range
+    // but the first starts at one of them.
+    for (auto const& r :
+         SplitRowSet(RowSet(), *samples, options_.max_shards)) {
+      auto const& start = r.as_proto().row_ranges(0).start_key_closed();
+      splits.emplace_back(start.begin(), start.end());
+    }
+  }
+  std::sort(splits.begin(), splits.end());
+  splits.erase(std::unique(splits.begin(), splits.end()), splits.end());
+  // The empty row key is the start of the table, not a split point.
+  if (!splits.empty() && splits.front().empty()) splits.erase(splits.begin());
+  return splits;
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
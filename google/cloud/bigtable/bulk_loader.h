@@ -0,0 +1,227 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_LOADER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_LOADER_H
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/mutation_batcher.h"
+#include "google/cloud/bigtable/row_key_sample.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/optional.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/// A single cell to load, `BulkLoader` converts it to a `SetCell` mutation.
+struct BulkLoadRecord {
+  std::string row_key;
+  std::string family;
+  std::string column;
+  std::string value;
+  /// If not set, the loader uses the time when the load started.
+  absl::optional<std::int64_t> timestamp_micros;
+};
+
+/**
+ * Returns the next record to load.
+ *
+ * Return an empty optional at the end of the input, or an error to stop the
+ * load. The loader calls this function from a single thread.
+ */
+using BulkLoadSource =
+    std::function<StatusOr<absl::optional<BulkLoadRecord>>()>;
+
+/**
+ * Returns a `BulkLoadSource` that reads CSV records from @p is.
+ *
+ * Each line contains `row_key,family,column,value` and, optionally, a fifth
+ * field with the timestamp in microseconds. Fields containing commas, quotes,
+ * or line breaks must be quoted with `"`, and quotes within quoted fields must
+ * be doubled, as in RFC 4180. Empty lines are ignored.
+ *
+ * The returned function holds a reference to @p is, the stream must remain
+ * valid while the function is in use.
+ */
+BulkLoadSource MakeCsvBulkLoadSource(std::istream& is);
+
+/// The work completed by a `BulkLoader`.
+struct BulkLoadProgress {
+  /// The number of rows (consecutive records with the same key) loaded.
+  std::uint64_t rows = 0;
+  std::uint64_t cells = 0;
+  /// The approximate size of the loaded data.
+  std::uint64_t bytes = 0;
+  /// The number of rows that could not be loaded.
+  std::uint64_t failed_rows = 0;
+  std::chrono::milliseconds elapsed = std::chrono::milliseconds(0);
+
+  /// The average throughput since the load started.
+  double bytes_per_second() const {
+    if (elapsed.count() == 0) return 0;
+    return static_cast<double>(bytes) * 1000.0 /
+           static_cast<double>(elapsed.count());
+  }
+};
+
+/// Configure a `BulkLoader`.
+struct BulkLoadOptions {
+  /**
+   * Partition the rows using these row keys.
+   *
+   * Each partition is sent by a separate `MutationBatcher`. If empty, the
+   * loader chooses up to `max_shards - 1` split points from the results of
+   * `Table::SampleRows()`. For new, empty tables provide the split points
+   * used to create the table.
+   */
+  BulkLoadOptions& SetSplitPoints(std::vector<std::string> v) {
+    split_points = std::move(v);
+    return *this;
+  }
+
+  /// The maximum number of partitions when using `Table::SampleRows()`.
+  BulkLoadOptions& SetMaxShards(std::size_t v) {
+    max_shards = v;
+    return *this;
+  }
+
+  /**
+   * The maximum size of the mutations sent but not yet completed.
+   *
+   * This limit applies to all the partitions, in addition to the limits of
+   * each `MutationBatcher`. It bounds the memory used by the loader.
+   */
+  BulkLoadOptions& SetMaxOutstandingBytes(std::size_t v) {
+    max_outstanding_bytes = v;
+    return *this;
+  }
+
+  /// The configuration for the `MutationBatcher` of each partition.
+  BulkLoadOptions& SetBatcherOptions(MutationBatcher::Options v) {
+    batcher_options = std::move(v);
+    return *this;
+  }
+
+  /**
+   * Report the progress periodically.
+   *
+   * The callback is invoked by the thread calling `BulkLoader::Load()`, about
+   * every `progress_period` while the load runs, and once more when the load
+   * completes.
+   */
+  BulkLoadOptions& SetProgressCallback(
+      std::function<void(BulkLoadProgress const&)> v) {
+    progress_callback = std::move(v);
+    return *this;
+  }
+
+  BulkLoadOptions& SetProgressPeriod(std::chrono::milliseconds v) {
+    progress_period = v;
+    return *this;
+  }
+
+  std::vector<std::string> split_points;
+  std::size_t max_shards = 16;
+  std::size_t max_outstanding_bytes = 256 * 1024 * 1024;
+  MutationBatcher::Options batcher_options = MutationBatcher::Options();
+  std::function<void(BulkLoadProgress const&)> progress_callback;
+  std::chrono::milliseconds progress_period = std::chrono::seconds(10);
+};
+
+/**
+ * Loads large datasets into a table using many `MutationBatcher`s.
+ *
+ * The loader reads records from a `BulkLoadSource` and combines consecutive
+ * records with the same row key into a single `SingleRowMutation`, so sorted
+ * inputs produce one mutation per row. The rows are partitioned by key range,
+ * and each partition is sent by its own `MutationBatcher`, so the batches
+ * touch few tablets and the partitions proceed in parallel. A global limit on
+ * the outstanding bytes keeps the memory usage bounded.
+ *
+ * Records without a timestamp use the time when the load started. This makes
+ * all the mutations idempotent, so the table retry policies apply to them.
+ *
+ * Applications must run the event loop of the `CompletionQueue` in one or more
+ * threads.
+ *
+ * @par Example
+ * @code
+ * namespace cbt = google::cloud::bigtable;
+ * std::ifstream is("data.csv");
+ * cbt::BulkLoader loader(
+ *     table, cq,
+ *     cbt::BulkLoadOptions().SetProgressCallback(
+ *         [](cbt::BulkLoadProgress const& p) {
+ *           std::cout << p.rows << " rows, " << p.bytes_per_second() / 1e6
+ *                     << " MB/s\n";
+ *         }));
+ * auto progress = loader.Load(cbt::MakeCsvBulkLoadSource(is));
+ * if (!progress) throw std::runtime_error(progress.status().message());
+ * @endcode
+ */
+class BulkLoader {
+ public:
+  BulkLoader(Table table, CompletionQueue cq,
+             BulkLoadOptions options = BulkLoadOptions())
+      : table_(std::move(table)),
+        cq_(std::move(cq)),
+        options_(std::move(options)) {}
+
+  virtual ~BulkLoader() = default;
+
+  /**
+   * Load all the records from @p source.
+   *
+   * Rows that fail are counted in `BulkLoadProgress::failed_rows`, the load
+   * continues with the remaining rows. The function returns once all the
+   * mutations complete.
+   *
+   * @return the final progress, or the first error returned by @p source or
+   *     by any mutation.
+   */
+  StatusOr<BulkLoadProgress> Load(BulkLoadSource const& source);
+
+ protected:
+  // Wrap creating the batchers in a virtual function to ease testing.
+  virtual std::unique_ptr<MutationBatcher> MakeBatcher(
+      Table table, MutationBatcher::Options options);
+
+  // Wrap sampling the row keys in a virtual function to ease testing.
+  virtual StatusOr<std::vector<RowKeySample>> SampleRowsImpl(Table& table);
+
+ private:
+  StatusOr<std::vector<std::string>> SplitPoints();
+
+  Table table_;
+  CompletionQueue cq_;
+  BulkLoadOptions options_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_LOADER_H
@@ -0,0 +1,287 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/bulk_loader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+
+namespace btproto = ::google::bigtable::v2;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+/// Read all the records from @p source.
+StatusOr<std::vector<BulkLoadRecord>> ReadAll(BulkLoadSource const& source) {
+  std::vector<BulkLoadRecord> records;
+  while (true) {
+    auto r = source();
+    if (!r) return std::move(r).status();
+    if (!*r) return records;
+    records.push_back(**std::move(r));
+  }
+}
+
+/// Return a source with one record for each value in @p cells.
+BulkLoadSource MakeSource(
+    std::vector<std::pair<std::string, std::string>> cells) {
+  auto next = std::make_shared<std::size_t>(0);
+  return [cells, next]() -> StatusOr<absl::optional<BulkLoadRecord>> {
+    if (*next == cells.size()) return absl::optional<BulkLoadRecord>{};
+    auto const& c = cells[(*next)++];
+    BulkLoadRecord record;
+    record.row_key = c.first;
+    record.family = "fam";
+    record.column = "col";
+    record.value = c.second;
+    return absl::make_optional(std::move(record));
+  };
+}
+
+/// The mutations sent by a `TestBatcher`, indexed by batcher.
+using SentMutations = std::vector<std::vector<btproto::MutateRowsRequest>>;
+
+/// A batcher that completes each batch immediately, without RPCs.
+class TestBatcher : public MutationBatcher {
+ public:
+  TestBatcher(Table table, Options options, SentMutations& sent)
+      : MutationBatcher(std::move(table), std::move(options)),
+        sent_(sent),
+        index_(sent.size()) {
+    sent_.emplace_back();
+  }
+
+ protected:
+  future<std::vector<FailedMutation>> AsyncBulkApplyImpl(
+      Table&, BulkMutation&& mut, CompletionQueue&) override {
+    btproto::MutateRowsRequest request;
+    mut.MoveTo(&request);
+    std::vector<FailedMutation> failed;
+    for (int i = 0; i != request.entries_size(); ++i) {
+      if (request.entries(i).row_key().rfind("fail", 0) != 0) continue;
+      failed.emplace_back(Status(StatusCode::kPermissionDenied, "uh-oh"), i);
+    }
+    sent_[index_].push_back(std::move(request));
+    return make_ready_future(std::move(failed));
+  }
+
+ private:
+  SentMutations& sent_;
+  std::size_t index_;
+};
+
+class TestBulkLoader : public BulkLoader {
+ public:
+  TestBulkLoader(Table table, CompletionQueue cq, BulkLoadOptions options,
+                 std::vector<std::string> samples)
+      : BulkLoader(std::move(table), std::move(cq), std::move(options)),
+        samples_(std::move(samples)) {}
+
+  SentMutations const& sent() const { return sent_; }
+
+  /// The row keys sent to each batcher.
+  std::vector<std::vector<std::string>> row_keys() const {
+    std::vector<std::vector<std::string>> result;
+    for (auto const& requests : sent_) {
+      result.emplace_back();
+      for (auto const& r : requests) {
+        for (auto const& e : r.entries()) result.back().push_back(e.row_key());
+      }
+    }
+    return result;
+  }
+
+ protected:
+  std::unique_ptr<MutationBatcher> MakeBatcher(
+      Table table, MutationBatcher::Options options) override {
+    return absl::make_unique<TestBatcher>(std::move(table), std::move(options),
+                                          sent_);
+  }
+
+  StatusOr<std::vector<RowKeySample>> SampleRowsImpl(Table&) override {
+    std::vector<RowKeySample> samples;
+    std::int64_t offset = 0;
+    for (auto const& key : samples_) {
+      offset += 1000;
+      samples.push_back(RowKeySample{key, offset});
+    }
+    return samples;
+  }
+
+ private:
+  std::vector<std::string> samples_;
+  SentMutations sent_;
+};
+
+class BulkLoaderTest : public bigtable::testing::TableTestFixture {
+ protected:
+  // MutationBatcher completes the batches using `cq_.RunAsync()`.
+  BulkLoaderTest() : cq_thread_([this] { cq_.Run(); }) {}
+
+  ~BulkLoaderTest() override {
+    cq_.Shutdown();
+    cq_thread_.join();
+  }
+
+  CompletionQueue cq_;
+  std::thread cq_thread_;
+};
+
+TEST(BulkLoadCsvTest, Simple) {
+  std::istringstream is(
+      "r1,fam,c1,v1\n"
+      "r1,fam,c2,v2,1000\r\n"
+      "\n"
+      "r2,fam,c1,\n");
+  auto records = ReadAll(MakeCsvBulkLoadSource(is));
+  ASSERT_STATUS_OK(records);
+  ASSERT_EQ(3U, records->size());
+  auto const& r0 = (*records)[0];
+  EXPECT_EQ("r1", r0.row_key);
+  EXPECT_EQ("fam", r0.family);
+  EXPECT_EQ("c1", r0.column);
+  EXPECT_EQ("v1", r0.value);
+  EXPECT_FALSE(r0.timestamp_micros.has_value());
+  auto const& r1 = (*records)[1];
+  EXPECT_EQ("c2", r1.column);
+  EXPECT_EQ("v2", r1.value);
+  EXPECT_EQ(1000, r1.timestamp_micros.value_or(0));
+  auto const& r2 = (*records)[2];
+  EXPECT_EQ("r2", r2.row_key);
+  EXPECT_EQ("", r2.value);
+}
+
+TEST(BulkLoadCsvTest, Quoted) {
+  std::istringstream is(
+      "\"r,1\",fam,\"say \"\"hi\"\"\",\"line1\nline2\"\n"
+      "r2,fam,c,v");
+  auto records = ReadAll(MakeCsvBulkLoadSource(is));
+  ASSERT_STATUS_OK(records);
+  ASSERT_EQ(2U, records->size());
+  EXPECT_EQ("r,1", (*records)[0].row_key);
+  EXPECT_EQ("say \"hi\"", (*records)[0].column);
+  EXPECT_EQ("line1\nline2", (*records)[0].value);
+  EXPECT_EQ("r2", (*records)[1].row_key);
+  EXPECT_EQ("v", (*records)[1].value);
+}
+
+TEST(BulkLoadCsvTest, Errors) {
+  std::istringstream fields("r1,fam,c1,v1\nr2,fam,c1\n");
+  auto records = ReadAll(MakeCsvBulkLoadSource(fields));
+  EXPECT_EQ(StatusCode::kInvalidArgument, records.status().code());
+  EXPECT_THAT(records.status().message(), HasSubstr("record 2"));
+
+  std::istringstream timestamp("r1,fam,c1,v1,abc\n");
+  records = ReadAll(MakeCsvBulkLoadSource(timestamp));
+  EXPECT_EQ(StatusCode::kInvalidArgument, records.status().code());
+  EXPECT_THAT(records.status().message(), HasSubstr("timestamp"));
+
+  std::istringstream quote("r1,fam,c1,\"v1\n");
+  records = ReadAll(MakeCsvBulkLoadSource(quote));
+  EXPECT_EQ(StatusCode::kInvalidArgument, records.status().code());
+}
+
+TEST_F(BulkLoaderTest, SplitPoints) {
+  std::vector<BulkLoadProgress> reports;
+  TestBulkLoader loader(table_, cq_,
+                        BulkLoadOptions()
+                            .SetSplitPoints({"m", "c"})
+                            .SetProgressCallback(
+                                [&reports](BulkLoadProgress const& p) {
+                                  reports.push_back(p);
+                                }),
+                        {});
+  auto progress = loader.Load(MakeSource(
+      {{"a", "1"}, {"a", "2"}, {"d", "3"}, {"m", "4"}, {"x", "5"}}));
+  ASSERT_STATUS_OK(progress);
+  EXPECT_EQ(4U, progress->rows);
+  EXPECT_EQ(5U, progress->cells);
+  EXPECT_EQ(0U, progress->failed_rows);
+  EXPECT_LT(0U, progress->bytes);
+  ASSERT_FALSE(reports.empty());
+  EXPECT_EQ(4U, reports.back().rows);
+
+  EXPECT_THAT(loader.row_keys(), ElementsAre(ElementsAre("a"), ElementsAre("d"),
+                                             ElementsAre("m", "x")));
+  // The cells for the same row are combined in a single mutation, and they
+  // all get the same timestamp.
+  auto const& entry = loader.sent()[0].at(0).entries(0);
+  ASSERT_EQ(2, entry.mutations_size());
+  EXPECT_EQ("1", entry.mutations(0).set_cell().value());
+  EXPECT_EQ("2", entry.mutations(1).set_cell().value());
+  EXPECT_EQ(entry.mutations(0).set_cell().timestamp_micros(),
+            entry.mutations(1).set_cell().timestamp_micros());
+  EXPECT_LT(0, entry.mutations(0).set_cell().timestamp_micros());
+  EXPECT_EQ(0, entry.mutations(0).set_cell().timestamp_micros() % 1000);
+}
+
+TEST_F(BulkLoaderTest, SampleRows) {
+  TestBulkLoader loader(table_, cq_, BulkLoadOptions().SetMaxShards(2),
+                        {"b", "d", "f", ""});
+  auto progress =
+      loader.Load(MakeSource({{"a", "1"}, {"c", "2"}, {"e", "3"}, {"g", "4"}}));
+  ASSERT_STATUS_OK(progress);
+  EXPECT_EQ(4U, progress->rows);
+  EXPECT_THAT(loader.row_keys(),
+              ElementsAre(ElementsAre("a", "c"), ElementsAre("e", "g")));
+}
+
+TEST_F(BulkLoaderTest, FailedRows) {
+  TestBulkLoader loader(table_, cq_, BulkLoadOptions().SetMaxShards(1), {});
+  auto progress = loader.Load(
+      MakeSource({{"a", "1"}, {"fail-1", "2"}, {"b", "3"}, {"fail-2", "4"}}));
+  EXPECT_EQ(StatusCode::kPermissionDenied, progress.status().code());
+  // The load continues after a failure.
+  EXPECT_THAT(loader.row_keys(),
+              ElementsAre(ElementsAre("a", "fail-1", "b", "fail-2")));
+}
+
+TEST_F(BulkLoaderTest, SourceError) {
+  int count = 0;
+  TestBulkLoader loader(table_, cq_, BulkLoadOptions().SetMaxShards(1), {});
+  auto progress =
+      loader.Load([&count]() -> StatusOr<absl::optional<BulkLoadRecord>> {
+        if (++count == 3) return Status(StatusCode::kDataLoss, "bad input");
+        BulkLoadRecord record;
+        record.row_key = "r" + std::to_string(count);
+        return absl::make_optional(std::move(record));
+      });
+  EXPECT_EQ(StatusCode::kDataLoss, progress.status().code());
+  // The complete rows before the error are loaded, the incomplete row is not.
+  EXPECT_THAT(loader.row_keys(), ElementsAre(ElementsAre("r1")));
+}
+
+TEST_F(BulkLoaderTest, OutstandingBytes) {
+  // With a tiny limit the loader still makes progress, one row at a time.
+  TestBulkLoader loader(
+      table_, cq_,
+      BulkLoadOptions().SetMaxShards(1).SetMaxOutstandingBytes(1), {});
+  auto progress = loader.Load(MakeSource({{"a", "1"}, {"b", "2"}, {"c", "3"}}));
+  ASSERT_STATUS_OK(progress);
+  EXPECT_EQ(3U, progress->rows);
+}
+
+}  // namespace
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,87 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CACHING_DATA_CLIENT_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CACHING_DATA_CLIENT_H
+
+#include "google/cloud/bigtable/data_client.h"
+#include "google/cloud/bigtable/version.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/// Configure the row cache created by `MakeCachingDataClient()`.
+struct RowCacheOptions {
+  /// How long a cached row can be used, after it is read from the service.
+  RowCacheOptions& SetTtl(std::chrono::milliseconds v) {
+    ttl = v;
+    return *this;
+  }
+
+  /// The (approximate) maximum size of the cached responses.
+  RowCacheOptions& SetMaxBytes(std::size_t v) {
+    max_bytes = v;
+    return *this;
+  }
+
+  std::chrono::milliseconds ttl = std::chrono::seconds(60);
+  std::size_t max_bytes = 64 * 1024 * 1024;
+};
+
+/**
+ * Returns a `DataClient` that caches the results of point reads.
+ *
+ * Applications that repeatedly read the same rows, with the same filter, from
+ * read-mostly tables can use this decorator to serve most of the reads from
+ * memory. The results of `ReadRows()` requests for exactly one row key, such
+ * as those sent by `Table::ReadRow()`, are cached using the table, app
+ * profile, row key, filter, and rows limit as the key. The cached results
+ * expire after `options.ttl`, and the least recently used results are evicted
+ * when the cache exceeds `options.max_bytes`.
+ *
+ * Any mutation of a row sent through the returned `DataClient`, that is, via
+ * `Apply()`, `BulkApply()`, `CheckAndMutateRow()`, `ReadModifyWriteRow()`
+ * (and their asynchronous versions) in any `Table` using this client,
+ * invalidates the cached results for that row.
+ *
+ * @warning The cache cannot observe changes made by other clients, or other
+ *     processes. The results may be stale by up to `options.ttl`. Do not use
+ *     this decorator for tables that are modified by other clients unless
+ *     the application can tolerate such staleness.
+ *
+ * @par Example
+ * @code
+ * namespace cbt = google::cloud::bigtable;
+ * auto client = cbt::MakeCachingDataClient(
+ *     cbt::CreateDefaultDataClient(project_id, instance_id,
+ *                                  cbt::ClientOptions()),
+ *     cbt::RowCacheOptions().SetTtl(std::chrono::seconds(10)));
+ * cbt::Table table(client, "lookup-table");
+ * auto row = table.ReadRow("key", cbt::Filter::Latest(1));
+ * @endcode
+ */
+std::shared_ptr<DataClient> MakeCachingDataClient(
+    std::shared_ptr<DataClient> client,
+    RowCacheOptions options = RowCacheOptions());
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CACHING_DATA_CLIENT_H
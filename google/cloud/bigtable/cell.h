@@ -20,6 +20,7 @@
 #include "google/cloud/bigtable/version.h"
 #include "google/cloud/status_or.h"
 #include <chrono>
+#include <memory>
 #include <type_traits>
 #include <vector>
 
@@ -30,6 +31,9 @@ inline namespace BIGTABLE_CLIENT_NS {
 class Cell;
 struct Mutation;
 Mutation SetCell(Cell);
+namespace internal {
+class ReadRowsParser;
+}  // namespace internal
 
 /**
  * Defines the type for column qualifiers.
@@ -84,7 +88,10 @@ using CellValueType = std::decay<decltype(
  * storage is sparse, column families, columns, and timestamps might contain
  * zero cells.
  *
- * The Cell class owns all its data.
+ * The Cell class owns all its data. Cells created by the library when reading
+ * rows share (immutable) copies of their row key, column family name, and
+ * column qualifier, so large batches of rows do not allocate a new copy of
+ * these strings for each cell.
  */
 class Cell {
  public:
@@ -99,9 +106,11 @@ class Cell {
   Cell(KeyType&& row_key, std::string family_name,
        ColumnType&& column_qualifier, std::int64_t timestamp, ValueType&& value,
        std::vector<std::string> labels)
-      : row_key_(std::forward<KeyType>(row_key)),
-        family_name_(std::move(family_name)),
-        column_qualifier_(std::forward<ColumnType>(column_qualifier)),
+      : row_key_(std::make_shared<RowKeyType>(
+            std::forward<KeyType>(row_key))),
+        family_name_(std::make_shared<std::string>(std::move(family_name))),
+        column_qualifier_(std::make_shared<ColumnQualifierType>(
+            std::forward<ColumnType>(column_qualifier))),
         timestamp_(timestamp),
         value_(std::forward<ValueType>(value)),
         labels_(std::move(labels)) {}
@@ -129,16 +138,16 @@ class Cell {
 
   /// Return the row key this cell belongs to. The returned value is not valid
   /// after this object is deleted.
-  RowKeyType const& row_key() const { return row_key_; }
+  RowKeyType const& row_key() const { return ValueOrEmpty(row_key_); }
 
   /// Return the family this cell belongs to. The returned value is not valid
   /// after this object is deleted.
-  std::string const& family_name() const { return family_name_; }
+  std::string const& family_name() const { return ValueOrEmpty(family_name_); }
 
   /// Return the column this cell belongs to. The returned value is not valid
   /// after this object is deleted.
   ColumnQualifierType const& column_qualifier() const {
-    return column_qualifier_;
+    return ValueOrEmpty(column_qualifier_);
   }
 
   /// Return the timestamp of this cell.
@@ -169,9 +178,32 @@ class Cell {
   std::vector<std::string> const& labels() const { return labels_; }
 
  private:
-  RowKeyType row_key_;
-  std::string family_name_;
-  ColumnQualifierType column_qualifier_;
+  friend class internal::ReadRowsParser;
+
+  /// Used by the parser to share strings across the cells in a stream.
+  Cell(std::shared_ptr<RowKeyType const> row_key,
+       std::shared_ptr<std::string const> family_name,
+       std::shared_ptr<ColumnQualifierType const> column_qualifier,
+       std::int64_t timestamp, CellValueType value,
+       std::vector<std::string> labels)
+      : row_key_(std::move(row_key)),
+        family_name_(std::move(family_name)),
+        column_qualifier_(std::move(column_qualifier)),
+        timestamp_(timestamp),
+        value_(std::move(value)),
+        labels_(std::move(labels)) {}
+
+  // The pointers are only null in moved-from cells.
+  template <typename T>
+  static T const& ValueOrEmpty(std::shared_ptr<T const> const& p) {
+    if (p) return *p;
+    static auto const* const kEmpty = new T;
+    return *kEmpty;
+  }
+
+  std::shared_ptr<RowKeyType const> row_key_;
+  std::shared_ptr<std::string const> family_name_;
+  std::shared_ptr<ColumnQualifierType const> column_qualifier_;
   std::int64_t timestamp_;
   CellValueType value_;
   std::vector<std::string> labels_;
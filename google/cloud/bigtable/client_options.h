@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CLIENT_OPTIONS_H
 
 #include "google/cloud/bigtable/version.h"
+#include "google/cloud/connection_options.h"
 #include "google/cloud/status.h"
 #include "google/cloud/tracing_options.h"
 #include <grpcpp/grpcpp.h>
@@ -118,6 +119,22 @@ class ClientOptions {
     return connection_pool_name_;
   }
 
+  /**
+   * Share the gRPC channels with other clients in the process.
+   *
+   * With the cache enabled, clients with the same endpoint, the same
+   * credentials object, and the same channel arguments share their channels,
+   * including clients from other libraries configured with
+   * `ConnectionOptions::enable_channel_cache()`. Use
+   * `set_connection_pool_name()` to keep separate pools.
+   */
+  ClientOptions& enable_channel_cache() {
+    channel_cache_enabled_ = true;
+    return *this;
+  }
+  /// Return whether the clients share their channels.
+  bool channel_cache_enabled() const { return channel_cache_enabled_; }
+
   /* Set the size of the connection pool.
    *
    * Specifying 0 for @p size will set the size of the connection pool to
@@ -149,6 +166,18 @@ class ClientOptions {
     return *this;
   }
 
+  /**
+   * Configure the gRPC transport, e.g., keepalive, flow control, compression.
+   *
+   * This uses the same `GrpcTransportOptions` as the other gRPC-based
+   * libraries. The values are applied to the current channel arguments, later
+   * calls to `set_channel_arguments()` discard them.
+   */
+  ClientOptions& set_transport_options(GrpcTransportOptions const& options) {
+    options.ApplyTo(channel_arguments_);
+    return *this;
+  }
+
   /**
    * Set compression algorithm for channel.
    *
@@ -386,6 +415,7 @@ class ClientOptions {
   std::shared_ptr<grpc::ChannelCredentials> credentials_;
   grpc::ChannelArguments channel_arguments_;
   std::string connection_pool_name_;
+  bool channel_cache_enabled_ = false;
   std::size_t connection_pool_size_;
   std::string data_endpoint_;
   std::string admin_endpoint_;
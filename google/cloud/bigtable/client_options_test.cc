@@ -19,6 +19,7 @@
 #include "google/cloud/testing_util/scoped_environment.h"
 #include <gmock/gmock.h>
 #include <cstdlib>
+#include <map>
 
 namespace google {
 namespace cloud {
@@ -254,6 +255,14 @@ TEST(ClientOptionsTest, EditConnectionPoolName) {
   EXPECT_EQ("foo", returned.connection_pool_name());
 }
 
+TEST(ClientOptionsTest, EnableChannelCache) {
+  bigtable::ClientOptions client_options_object;
+  EXPECT_FALSE(client_options_object.channel_cache_enabled());
+  auto& returned = client_options_object.enable_channel_cache();
+  EXPECT_EQ(&returned, &client_options_object);
+  EXPECT_TRUE(returned.channel_cache_enabled());
+}
+
 TEST(ClientOptionsTest, EditConnectionPoolSize) {
   bigtable::ClientOptions client_options_object;
   auto& returned = client_options_object.set_connection_pool_size(42);
@@ -327,6 +336,24 @@ TEST(ClientOptionsTest, SetCompressionAlgorithm) {
             grpc::string(test_args.args[3].key));
 }
 
+TEST(ClientOptionsTest, SetTransportOptions) {
+  auto client_options_object = bigtable::ClientOptions().set_transport_options(
+      GrpcTransportOptions{}
+          .set_keepalive_time(std::chrono::seconds(30))
+          .set_http2_bdp_probe(false));
+  grpc::ChannelArguments c_args = client_options_object.channel_arguments();
+  grpc_channel_args test_args = c_args.c_channel_args();
+  // Use the low-level C API because grpc::ChannelArguments lacks high-level
+  // accessors.
+  std::map<std::string, int> args;
+  for (std::size_t i = 0; i != test_args.num_args; ++i) {
+    auto const& arg = test_args.args[i];
+    if (arg.type == GRPC_ARG_INTEGER) args[arg.key] = arg.value.integer;
+  }
+  EXPECT_EQ(30000, args[GRPC_ARG_KEEPALIVE_TIME_MS]);
+  EXPECT_EQ(0, args.at(GRPC_ARG_HTTP2_BDP_PROBE));
+}
+
 TEST(ClientOptionsTest, SetMaxReceiveMessageSize) {
   bigtable::ClientOptions client_options_object = bigtable::ClientOptions();
   client_options_object.SetMaxReceiveMessageSize(256 * 1024L * 1024L);
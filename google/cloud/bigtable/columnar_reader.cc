@@ -0,0 +1,111 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/columnar_reader.h"
+#include <algorithm>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+
+std::size_t constexpr ColumnarReadRowsVisitor::kDefaultBatchSize;
+
+ColumnarReadRowsVisitor::ColumnarReadRowsVisitor(
+    std::vector<ColumnarColumn> columns, ColumnarSink& sink,
+    std::size_t batch_size)
+    : columns_(std::move(columns)),
+      sink_(sink),
+      batch_size_((std::max)(batch_size, std::size_t{1})),
+      row_(columns_.size()) {
+  for (std::size_t i = 0; i != columns_.size(); ++i) {
+    index_[columns_[i].family].emplace(columns_[i].qualifier, i);
+  }
+}
+
+void ColumnarReadRowsVisitor::OnRowStart(RowKeyType const&) { OnRowReset(); }
+
+void ColumnarReadRowsVisitor::OnCell(Cell cell) {
+  if (!status_.ok()) return;
+  auto f = index_.find(cell.family_name());
+  if (f == index_.end()) return;
+  auto c = f->second.find(cell.column_qualifier());
+  if (c == f->second.end()) return;
+  auto& value = row_[c->second];
+  // The cells in a column are sorted by decreasing timestamp, keep the first.
+  if (value.present) return;
+  if (columns_[c->second].type == ColumnarCellType::kInt64) {
+    auto v = cell.decode_big_endian_integer<std::int64_t>();
+    if (!v) {
+      status_ = Status(v.status().code(),
+                       "cannot decode cell in " + cell.family_name() + ":" +
+                           cell.column_qualifier() + " as INT64: " +
+                           v.status().message());
+      return;
+    }
+    value.int64 = *v;
+  } else {
+    value.bytes = std::move(cell).value();
+  }
+  value.present = true;
+}
+
+bool ColumnarReadRowsVisitor::OnRowCommit(RowKeyType const& row_key) {
+  if (!status_.ok()) return false;
+  sink_.AppendRowKey(row_key);
+  for (std::size_t i = 0; i != row_.size(); ++i) {
+    auto& value = row_[i];
+    if (!value.present) {
+      sink_.AppendNull(i);
+    } else if (columns_[i].type == ColumnarCellType::kInt64) {
+      sink_.AppendInt64(i, value.int64);
+    } else {
+      sink_.AppendBytes(i, std::move(value.bytes));
+    }
+    value = ColumnValue{};
+  }
+  if (++batch_rows_ != batch_size_) return true;
+  batch_rows_ = 0;
+  status_ = sink_.FinishBatch(batch_size_);
+  return status_.ok();
+}
+
+void ColumnarReadRowsVisitor::OnRowReset() {
+  for (auto& value : row_) value = ColumnValue{};
+}
+
+Status ColumnarReadRowsVisitor::Finish() {
+  if (!status_.ok() || batch_rows_ == 0) return status_;
+  auto rows = batch_rows_;
+  batch_rows_ = 0;
+  status_ = sink_.FinishBatch(rows);
+  return status_;
+}
+
+Status ReadRowsColumnar(Table& table, RowSet row_set, Filter filter,
+                        std::vector<ColumnarColumn> columns, ColumnarSink& sink,
+                        std::size_t batch_size) {
+  ColumnarReadRowsVisitor visitor(std::move(columns), sink, batch_size);
+  auto status = table.ReadRows(std::move(row_set), std::move(filter), visitor);
+  if (!status.ok()) return status;
+  // The visitor stops the read on errors, which `ReadRows()` reports as a
+  // success, `Finish()` returns them.
+  return visitor.Finish();
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,161 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_READER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_READER_H
+
+#include "google/cloud/bigtable/cell.h"
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/read_rows_visitor.h"
+#include "google/cloud/bigtable/row_key.h"
+#include "google/cloud/bigtable/row_set.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/status.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/// How the cells of a column are decoded in a columnar read.
+enum class ColumnarCellType {
+  /// The cell value, unmodified.
+  kBytes,
+  /// A 64-bit big-endian integer, as written by `ReadModifyWriteRow()`.
+  kInt64,
+};
+
+/// Maps the cells with the given family and qualifier to an output column.
+struct ColumnarColumn {
+  std::string family;
+  ColumnQualifierType qualifier;
+  ColumnarCellType type;
+};
+
+/**
+ * Receives the results of a columnar read.
+ *
+ * Each row is delivered as one call to `AppendRowKey()`, followed by one
+ * `Append*()` call for each column, in the order they appear in the schema.
+ * Columns without a cell in the row receive an `AppendNull()` call.
+ *
+ * After every `batch_size` rows, and after the last row, the reader calls
+ * `FinishBatch()`. Implementations typically accumulate the values in column
+ * builders, e.g. for Apache Arrow, and emit a record batch in
+ * `FinishBatch()`.
+ */
+class ColumnarSink {
+ public:
+  virtual ~ColumnarSink() = default;
+
+  virtual void AppendRowKey(RowKeyType row_key) = 0;
+  virtual void AppendNull(std::size_t column) = 0;
+  virtual void AppendBytes(std::size_t column, CellValueType value) = 0;
+  virtual void AppendInt64(std::size_t column, std::int64_t value) = 0;
+
+  /**
+   * Called when a batch of @p rows rows is complete.
+   *
+   * @return an error to stop the read, the error is returned to the caller.
+   */
+  virtual Status FinishBatch(std::size_t rows) = 0;
+};
+
+/**
+ * A `ReadRowsVisitor` that converts the cells into columns.
+ *
+ * Applications scanning tables into analytics jobs often iterate over
+ * `bigtable::Row` objects to rebuild the columns by hand. This visitor
+ * receives the cells as the `ReadRows` responses are parsed, without
+ * building a `Row`, and sends the value of each column in the schema to a
+ * `ColumnarSink`. Only the most recent cell of each column is used, cells in
+ * columns not in the schema are discarded.
+ *
+ * Rows are only sent to the sink once they are committed, so partial rows
+ * from failed streams never reach it.
+ *
+ * @par Example
+ * @code
+ * namespace cbt = google::cloud::bigtable;
+ * cbt::ColumnarReadRowsVisitor visitor(
+ *     {{"stats", "views", cbt::ColumnarCellType::kInt64},
+ *      {"info", "title", cbt::ColumnarCellType::kBytes}},
+ *     sink);
+ * auto status = table.ReadRows(cbt::RowSet(cbt::RowRange::Prefix("page#")),
+ *                              cbt::Filter::Latest(1), visitor);
+ * if (status.ok()) status = visitor.Finish();
+ * @endcode
+ */
+class ColumnarReadRowsVisitor : public ReadRowsVisitor {
+ public:
+  static std::size_t constexpr kDefaultBatchSize = 8192;
+
+  ColumnarReadRowsVisitor(std::vector<ColumnarColumn> columns,
+                          ColumnarSink& sink,
+                          std::size_t batch_size = kDefaultBatchSize);
+
+  void OnRowStart(RowKeyType const& row_key) override;
+  void OnCell(Cell cell) override;
+  bool OnRowCommit(RowKeyType const& row_key) override;
+  void OnRowReset() override;
+
+  /**
+   * Sends the last partial batch to the sink.
+   *
+   * @return the first error decoding a cell or returned by the sink, if any.
+   */
+  Status Finish();
+
+ private:
+  struct ColumnValue {
+    bool present = false;
+    CellValueType bytes;
+    std::int64_t int64 = 0;
+  };
+
+  std::vector<ColumnarColumn> columns_;
+  ColumnarSink& sink_;
+  std::size_t batch_size_;
+  /// The column index for each family and qualifier.
+  std::unordered_map<std::string,
+                     std::unordered_map<ColumnQualifierType, std::size_t>>
+      index_;
+  /// The values of the current row.
+  std::vector<ColumnValue> row_;
+  std::size_t batch_rows_ = 0;
+  Status status_;
+};
+
+/**
+ * Reads @p row_set from @p table and sends the columns to @p sink.
+ *
+ * This is a convenience wrapper around `ColumnarReadRowsVisitor` and
+ * `Table::ReadRows()`, see their documentation for details.
+ */
+Status ReadRowsColumnar(
+    Table& table, RowSet row_set, Filter filter,
+    std::vector<ColumnarColumn> columns, ColumnarSink& sink,
+    std::size_t batch_size = ColumnarReadRowsVisitor::kDefaultBatchSize);
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_READER_H
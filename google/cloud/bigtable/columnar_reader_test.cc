@@ -0,0 +1,174 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/columnar_reader.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+
+using ::google::cloud::bigtable::testing::MockReadRowsReader;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::DoAll;
+using ::testing::ElementsAre;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+// Records each call as a string, e.g. "int64[0]=1".
+class RecordingSink : public ColumnarSink {
+ public:
+  void AppendRowKey(RowKeyType row_key) override {
+    calls.push_back("key=" + std::string(row_key));
+  }
+  void AppendNull(std::size_t column) override { Record("null", column, ""); }
+  void AppendBytes(std::size_t column, CellValueType value) override {
+    Record("bytes", column, std::string(value));
+  }
+  void AppendInt64(std::size_t column, std::int64_t value) override {
+    Record("int64", column, std::to_string(value));
+  }
+  Status FinishBatch(std::size_t rows) override {
+    calls.push_back("batch " + std::to_string(rows));
+    return finish_status;
+  }
+
+  std::vector<std::string> calls;
+  Status finish_status;
+
+ private:
+  void Record(std::string const& type, std::size_t column,
+              std::string const& value) {
+    calls.push_back(type + "[" + std::to_string(column) + "]=" + value);
+  }
+};
+
+std::vector<ColumnarColumn> Schema() {
+  return {{"fam", "count", ColumnarCellType::kInt64},
+          {"fam", "name", ColumnarCellType::kBytes}};
+}
+
+Cell MakeCell(std::string const& row, std::string const& column,
+              std::int64_t timestamp, std::string value) {
+  return Cell(row, "fam", column, timestamp, std::move(value));
+}
+
+TEST(ColumnarReadRowsVisitorTest, Batches) {
+  RecordingSink sink;
+  ColumnarReadRowsVisitor visitor(Schema(), sink, 2);
+  for (auto const* row : {"r1", "r2", "r3"}) {
+    visitor.OnRowStart(row);
+    // Newer cells first, only the first one in each column is used.
+    visitor.OnCell(Cell(row, "fam", "count", 2000, std::int64_t{7}));
+    visitor.OnCell(Cell(row, "fam", "count", 1000, std::int64_t{6}));
+    // Columns not in the schema are ignored.
+    visitor.OnCell(MakeCell(row, "other", 1000, "x"));
+    if (std::string(row) != "r2") visitor.OnCell(MakeCell(row, "name", 0, row));
+    EXPECT_TRUE(visitor.OnRowCommit(row));
+  }
+  EXPECT_STATUS_OK(visitor.Finish());
+  EXPECT_THAT(sink.calls,
+              ElementsAre("key=r1", "int64[0]=7", "bytes[1]=r1", "key=r2",
+                          "int64[0]=7", "null[1]=", "batch 2", "key=r3",
+                          "int64[0]=7", "bytes[1]=r3", "batch 1"));
+}
+
+TEST(ColumnarReadRowsVisitorTest, ResetDiscardsPartialRow) {
+  RecordingSink sink;
+  ColumnarReadRowsVisitor visitor(Schema(), sink);
+  visitor.OnRowStart("r1");
+  visitor.OnCell(MakeCell("r1", "name", 0, "partial"));
+  visitor.OnRowReset();
+  visitor.OnRowStart("r1");
+  EXPECT_TRUE(visitor.OnRowCommit("r1"));
+  EXPECT_STATUS_OK(visitor.Finish());
+  EXPECT_THAT(sink.calls,
+              ElementsAre("key=r1", "null[0]=", "null[1]=", "batch 1"));
+}
+
+TEST(ColumnarReadRowsVisitorTest, DecodeError) {
+  RecordingSink sink;
+  ColumnarReadRowsVisitor visitor(Schema(), sink);
+  visitor.OnRowStart("r1");
+  visitor.OnCell(MakeCell("r1", "count", 0, "not-an-int64"));
+  EXPECT_FALSE(visitor.OnRowCommit("r1"));
+  EXPECT_THAT(visitor.Finish(), StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_TRUE(sink.calls.empty());
+}
+
+TEST(ColumnarReadRowsVisitorTest, SinkError) {
+  RecordingSink sink;
+  sink.finish_status = Status(StatusCode::kResourceExhausted, "full");
+  ColumnarReadRowsVisitor visitor(Schema(), sink, 1);
+  visitor.OnRowStart("r1");
+  EXPECT_FALSE(visitor.OnRowCommit("r1"));
+  EXPECT_THAT(visitor.Finish(),
+              StatusIs(StatusCode::kResourceExhausted, "full"));
+}
+
+class ReadRowsColumnarTest : public bigtable::testing::TableTestFixture {};
+
+TEST_F(ReadRowsColumnarTest, Simple) {
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "count" }
+        timestamp_micros: 42000
+        value: "\000\000\000\000\000\000\000\052"
+      }
+      chunks {
+        qualifier { value: "name" }
+        timestamp_micros: 42000
+        value: "one"
+        commit_row: true
+      }
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "name" }
+        timestamp_micros: 42000
+        value: "two"
+        commit_row: true
+      }
+      )");
+
+  auto* stream = new MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  EXPECT_CALL(*stream, Read)
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, ReadRows).WillOnce(stream->MakeMockReturner());
+
+  RecordingSink sink;
+  ASSERT_STATUS_OK(ReadRowsColumnar(table_, RowSet(), Filter::PassAllFilter(),
+                                    Schema(), sink));
+  EXPECT_THAT(sink.calls,
+              ElementsAre("key=r1", "int64[0]=42", "bytes[1]=one", "key=r2",
+                          "null[0]=", "bytes[1]=two", "batch 2"));
+}
+
+}  // namespace
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -17,6 +17,7 @@
 #include "google/cloud/bigtable/internal/logging_data_client.h"
 #include "google/cloud/internal/log_wrapper.h"
 #include "google/cloud/log.h"
+#include "absl/memory/memory.h"
 
 namespace btproto = google::bigtable::v2;
 
@@ -62,7 +63,10 @@ class DefaultDataClient : public DataClient {
   grpc::Status MutateRow(grpc::ClientContext* context,
                          btproto::MutateRowRequest const& request,
                          btproto::MutateRowResponse* response) override {
-    return impl_.Stub()->MutateRow(context, request, response);
+    auto stub = impl_.TrackedStub();
+    auto status = stub.first->MutateRow(context, request, response);
+    stub.second.Done(status);
+    return status;
   }
 
   std::unique_ptr<
@@ -77,7 +81,10 @@ class DefaultDataClient : public DataClient {
       grpc::ClientContext* context,
       btproto::CheckAndMutateRowRequest const& request,
       btproto::CheckAndMutateRowResponse* response) override {
-    return impl_.Stub()->CheckAndMutateRow(context, request, response);
+    auto stub = impl_.TrackedStub();
+    auto status = stub.first->CheckAndMutateRow(context, request, response);
+    stub.second.Done(status);
+    return status;
   }
 
   std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
@@ -93,7 +100,10 @@ class DefaultDataClient : public DataClient {
       grpc::ClientContext* context,
       btproto::ReadModifyWriteRowRequest const& request,
       btproto::ReadModifyWriteRowResponse* response) override {
-    return impl_.Stub()->ReadModifyWriteRow(context, request, response);
+    auto stub = impl_.TrackedStub();
+    auto status = stub.first->ReadModifyWriteRow(context, request, response);
+    stub.second.Done(status);
+    return status;
   }
 
   std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
@@ -108,7 +118,10 @@ class DefaultDataClient : public DataClient {
   std::unique_ptr<grpc::ClientReaderInterface<btproto::ReadRowsResponse>>
   ReadRows(grpc::ClientContext* context,
            btproto::ReadRowsRequest const& request) override {
-    return impl_.Stub()->ReadRows(context, request);
+    auto stub = impl_.TrackedStub();
+    return absl::make_unique<
+        internal::TrackedClientReader<btproto::ReadRowsResponse>>(
+        stub.first->ReadRows(context, request), std::move(stub.second));
   }
 
   std::unique_ptr<grpc::ClientAsyncReaderInterface<btproto::ReadRowsResponse>>
@@ -143,7 +156,10 @@ class DefaultDataClient : public DataClient {
   std::unique_ptr<grpc::ClientReaderInterface<btproto::MutateRowsResponse>>
   MutateRows(grpc::ClientContext* context,
              btproto::MutateRowsRequest const& request) override {
-    return impl_.Stub()->MutateRows(context, request);
+    auto stub = impl_.TrackedStub();
+    return absl::make_unique<
+        internal::TrackedClientReader<btproto::MutateRowsResponse>>(
+        stub.first->MutateRows(context, request), std::move(stub.second));
   }
   std::unique_ptr<::grpc::ClientAsyncReaderInterface<
       ::google::bigtable::v2::MutateRowsResponse>>
@@ -32,6 +32,7 @@ class AsyncBulkMutatorNoex;
 class AsyncRetryBulkApply;
 class AsyncSampleRowKeys;
 class BulkMutator;
+class CachingDataClient;
 template <typename ReadRowCallback,
           typename std::enable_if<
               google::cloud::internal::is_invocable<
@@ -102,6 +103,7 @@ class DataClient {
                                         grpc::Status&>::value,
                                     int>::type>
   friend class internal::AsyncRowReader;
+  friend class internal::CachingDataClient;
   friend class internal::LoggingDataClient;
 
   //@{
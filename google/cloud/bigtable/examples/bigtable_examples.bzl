@@ -25,6 +25,7 @@ bigtable_examples = [
     "bigtable_instance_admin_snippets.cc",
     "bigtable_table_admin_backup_async_snippets.cc",
     "bigtable_table_admin_backup_snippets.cc",
+    "bulk_load_snippets.cc",
     "data_async_snippets.cc",
     "data_filter_snippets.cc",
     "data_snippets.cc",
@@ -0,0 +1,166 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/examples/bigtable_examples_common.h"
+//! [bulk load includes]
+#include "google/cloud/bigtable/bulk_loader.h"
+//! [bulk load includes]
+#include "google/cloud/bigtable/table_admin.h"
+#include "google/cloud/internal/getenv.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/crash_handler.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+void BulkLoadCsv(google::cloud::bigtable::Table table,
+                 google::cloud::CompletionQueue cq,
+                 std::vector<std::string> const& argv) {
+  //! [bulk load csv]
+  namespace cbt = google::cloud::bigtable;
+  [](cbt::Table table, cbt::CompletionQueue cq, std::string const& filename) {
+    std::ifstream is(filename);
+    if (!is) throw std::runtime_error("cannot open " + filename);
+
+    // Report the progress every few seconds, loading large files can take a
+    // while.
+    auto options =
+        cbt::BulkLoadOptions()
+            .SetProgressPeriod(std::chrono::seconds(5))
+            .SetProgressCallback([](cbt::BulkLoadProgress const& p) {
+              std::cout << p.rows << " rows (" << p.cells << " cells, "
+                        << p.bytes / (1024 * 1024) << " MiB) loaded in "
+                        << p.elapsed.count() << "ms, "
+                        << p.bytes_per_second() / (1024 * 1024) << " MiB/s, "
+                        << p.failed_rows << " failed rows\n";
+            });
+    cbt::BulkLoader loader(std::move(table), std::move(cq),
+                           std::move(options));
+    auto progress = loader.Load(cbt::MakeCsvBulkLoadSource(is));
+    if (!progress) throw std::runtime_error(progress.status().message());
+    std::cout << "Loaded " << progress->rows << " rows from " << filename
+              << "\n";
+  }
+  //! [bulk load csv]
+  (std::move(table), std::move(cq), argv.at(0));
+}
+
+void BulkLoadWithSplits(google::cloud::bigtable::Table table,
+                        google::cloud::CompletionQueue cq,
+                        std::vector<std::string> const& argv) {
+  //! [bulk load with splits]
+  namespace cbt = google::cloud::bigtable;
+  [](cbt::Table table, cbt::CompletionQueue cq, std::string const& filename,
+     std::vector<std::string> splits) {
+    std::ifstream is(filename);
+    if (!is) throw std::runtime_error("cannot open " + filename);
+
+    // A new table has no data to sample, use the split points from the table
+    // creation instead.
+    cbt::BulkLoader loader(
+        std::move(table), std::move(cq),
+        cbt::BulkLoadOptions().SetSplitPoints(std::move(splits)));
+    auto progress = loader.Load(cbt::MakeCsvBulkLoadSource(is));
+    if (!progress) throw std::runtime_error(progress.status().message());
+    std::cout << "Loaded " << progress->rows << " rows from " << filename
+              << " in " << progress->elapsed.count() << "ms\n";
+  }
+  //! [bulk load with splits]
+  (std::move(table), std::move(cq), argv.at(0),
+   std::vector<std::string>(argv.begin() + 1, argv.end()));
+}
+
+void RunAll(std::vector<std::string> const& argv) {
+  namespace examples = ::google::cloud::bigtable::examples;
+  namespace cbt = google::cloud::bigtable;
+
+  if (!argv.empty()) throw examples::Usage{"auto"};
+  examples::CheckEnvironmentVariablesAreSet({
+      "GOOGLE_CLOUD_PROJECT",
+      "GOOGLE_CLOUD_CPP_BIGTABLE_TEST_INSTANCE_ID",
+  });
+  auto const project_id =
+      google::cloud::internal::GetEnv("GOOGLE_CLOUD_PROJECT").value();
+  auto const instance_id = google::cloud::internal::GetEnv(
+                               "GOOGLE_CLOUD_CPP_BIGTABLE_TEST_INSTANCE_ID")
+                               .value();
+
+  cbt::TableAdmin admin(
+      cbt::CreateDefaultAdminClient(project_id, cbt::ClientOptions{}),
+      instance_id);
+
+  // If a previous run of these samples crashes before cleaning up there may be
+  // old tables left over. As there are quotas on the total number of tables we
+  // remove stale tables after 48 hours.
+  examples::CleanupOldTables("bulk-load-", admin);
+
+  // Initialize a generator with some amount of entropy.
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const table_id = examples::RandomTableId("bulk-load-", generator);
+
+  std::vector<std::string> const splits{"key-001000", "key-002000"};
+  std::cout << "\nCreating table to run the examples (" << table_id << ")"
+            << std::endl;
+  auto schema = admin.CreateTable(
+      table_id,
+      cbt::TableConfig({{"fam", cbt::GcRule::MaxNumVersions(10)}}, splits));
+  if (!schema) throw std::runtime_error(schema.status().message());
+
+  auto const filename = "bulk-load-" + table_id + ".csv";
+  {
+    std::ofstream os(filename);
+    for (int i = 0; i != 3000; ++i) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "key-%06d", i);
+      os << buf << ",fam,col0,value0-" << i << "\n";
+      os << buf << ",fam,col1,\"value1, " << i << "\"\n";
+    }
+  }
+
+  cbt::Table table(cbt::CreateDefaultDataClient(admin.project(),
+                                                admin.instance_id(),
+                                                cbt::ClientOptions()),
+                   table_id);
+
+  google::cloud::CompletionQueue cq;
+  std::thread th([&cq] { cq.Run(); });
+  examples::AutoShutdownCQ shutdown(cq, std::move(th));
+
+  std::cout << "\nRunning the BulkLoadWithSplits() example" << std::endl;
+  BulkLoadWithSplits(table, cq, {filename, splits[0], splits[1]});
+
+  std::cout << "\nRunning the BulkLoadCsv() example" << std::endl;
+  BulkLoadCsv(table, cq, {filename});
+
+  std::remove(filename.c_str());
+  (void)admin.DeleteTable(table_id);
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  google::cloud::testing_util::InstallCrashHandler(argv[0]);
+
+  using google::cloud::bigtable::examples::MakeCommandEntry;
+  google::cloud::bigtable::examples::Example example({
+      MakeCommandEntry("bulk-load-csv", {"<filename>"}, BulkLoadCsv),
+      MakeCommandEntry("bulk-load-with-splits",
+                       {"<filename>", "<split-1>", "<split-2>"},
+                       BulkLoadWithSplits),
+      {"auto", RunAll},
+  });
+  return example.Run(argc, argv);
+}
@@ -20,18 +20,23 @@ google_cloud_cpp_bigtable_hdrs = [
     "admin_client.h",
     "app_profile_config.h",
     "async_row_reader.h",
+    "bulk_loader.h",
+    "caching_data_client.h",
     "cell.h",
     "client_options.h",
     "cluster_config.h",
     "cluster_list_responses.h",
     "column_family.h",
+    "columnar_reader.h",
     "completion_queue.h",
     "data_client.h",
     "expr.h",
     "filters.h",
+    "hedging_policy.h",
     "iam_binding.h",
     "iam_policy.h",
     "idempotent_mutation_policy.h",
+    "increment_aggregator.h",
     "instance_admin.h",
     "instance_admin_client.h",
     "instance_config.h",
@@ -44,23 +49,34 @@ google_cloud_cpp_bigtable_hdrs = [
     "internal/async_retry_op.h",
     "internal/async_retry_unary_rpc_and_poll.h",
     "internal/bulk_mutator.h",
+    "internal/caching_data_client.h",
+    "internal/channel_load_balancer.h",
     "internal/client_options_defaults.h",
     "internal/common_client.h",
     "internal/google_bytes_traits.h",
+    "internal/hedged_client_reader.h",
     "internal/logging_admin_client.h",
     "internal/logging_data_client.h",
     "internal/logging_instance_admin_client.h",
+    "internal/policy_fast_path.h",
     "internal/prefix_range_end.h",
+    "internal/read_rows_read_ahead.h",
     "internal/readrowsparser.h",
+    "internal/row_cache.h",
     "internal/rowreaderiterator.h",
     "internal/rpc_policy_parameters.h",
     "internal/rpc_policy_parameters.inc",
+    "internal/sorted_row_set.h",
+    "internal/string_interner.h",
     "internal/unary_client_utils.h",
     "metadata_update_policy.h",
     "mutation_batcher.h",
     "mutations.h",
+    "parallel_scan.h",
     "polling_policy.h",
+    "prepared_read_rows_request.h",
     "read_modify_write_rule.h",
+    "read_rows_visitor.h",
     "resource_names.h",
     "row.h",
     "row_key.h",
@@ -68,8 +84,10 @@ google_cloud_cpp_bigtable_hdrs = [
     "row_range.h",
     "row_reader.h",
     "row_set.h",
+    "rows_by_keys.h",
     "rpc_backoff_policy.h",
     "rpc_retry_policy.h",
+    "split_point_cache.h",
     "table.h",
     "table_admin.h",
     "table_config.h",
@@ -80,37 +98,52 @@ google_cloud_cpp_bigtable_hdrs = [
 google_cloud_cpp_bigtable_srcs = [
     "admin_client.cc",
     "app_profile_config.cc",
+    "bulk_loader.cc",
+    "caching_data_client.cc",
     "client_options.cc",
     "cluster_config.cc",
+    "columnar_reader.cc",
     "data_client.cc",
     "expr.cc",
+    "hedging_policy.cc",
     "iam_binding.cc",
     "iam_policy.cc",
     "idempotent_mutation_policy.cc",
+    "increment_aggregator.cc",
     "instance_admin.cc",
     "instance_admin_client.cc",
     "instance_config.cc",
     "instance_update_config.cc",
     "internal/async_bulk_apply.cc",
     "internal/bulk_mutator.cc",
+    "internal/caching_data_client.cc",
+    "internal/channel_load_balancer.cc",
     "internal/common_client.cc",
     "internal/google_bytes_traits.cc",
     "internal/logging_admin_client.cc",
     "internal/logging_data_client.cc",
     "internal/logging_instance_admin_client.cc",
     "internal/prefix_range_end.cc",
+    "internal/read_rows_read_ahead.cc",
     "internal/readrowsparser.cc",
+    "internal/row_cache.cc",
     "internal/rowreaderiterator.cc",
+    "internal/sorted_row_set.cc",
+    "internal/string_interner.cc",
     "metadata_update_policy.cc",
     "mutation_batcher.cc",
     "mutations.cc",
+    "parallel_scan.cc",
     "polling_policy.cc",
+    "prepared_read_rows_request.cc",
     "resource_names.cc",
     "row_range.cc",
     "row_reader.cc",
     "row_set.cc",
+    "rows_by_keys.cc",
     "rpc_backoff_policy.cc",
     "rpc_retry_policy.cc",
+    "split_point_cache.cc",
     "table.cc",
     "table_admin.cc",
     "table_config.cc",
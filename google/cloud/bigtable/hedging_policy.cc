@@ -0,0 +1,69 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/hedging_policy.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+// Use the maximum delay until there are enough samples to estimate the
+// percentile.
+std::size_t constexpr kMinimumSamples = 20;
+}  // namespace
+
+LatencyHedgingPolicy::LatencyHedgingPolicy(
+    double percentile, std::chrono::microseconds minimum_delay,
+    std::chrono::microseconds maximum_delay, std::size_t window_size)
+    : percentile_((std::min)((std::max)(percentile, 0.0), 1.0)),
+      minimum_delay_(minimum_delay),
+      maximum_delay_((std::max)(minimum_delay, maximum_delay)),
+      window_size_((std::max)(window_size, kMinimumSamples)),
+      state_(std::make_shared<State>()) {}
+
+std::unique_ptr<HedgingPolicy> LatencyHedgingPolicy::clone() const {
+  return absl::make_unique<LatencyHedgingPolicy>(*this);
+}
+
+std::chrono::microseconds LatencyHedgingPolicy::hedge_delay() {
+  std::vector<std::chrono::microseconds> samples;
+  {
+    std::lock_guard<std::mutex> lk(state_->mu);
+    if (state_->samples.size() < kMinimumSamples) return maximum_delay_;
+    samples = state_->samples;
+  }
+  auto const n = static_cast<double>(samples.size());
+  auto const index = (std::min)(samples.size() - 1,
+                                static_cast<std::size_t>(percentile_ * n));
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return (std::min)(maximum_delay_, (std::max)(minimum_delay_, samples[index]));
+}
+
+void LatencyHedgingPolicy::OnLatency(std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lk(state_->mu);
+  if (state_->samples.size() < window_size_) {
+    state_->samples.push_back(latency);
+    return;
+  }
+  state_->samples[state_->next] = latency;
+  state_->next = (state_->next + 1) % window_size_;
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
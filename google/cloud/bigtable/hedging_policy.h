@@ -0,0 +1,108 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H
+
+#include "google/cloud/bigtable/version.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Define the interface to control hedged reads.
+ *
+ * A hedged read sends a second copy of an idempotent read request if the
+ * first copy has not received a response after some delay. The client uses
+ * whichever response arrives first and cancels the other request. This trades
+ * a small amount of additional load for much lower tail latency when a few
+ * servers (or connections) are temporarily slow.
+ *
+ * `Table` only hedges `ReadRow()`, `ReadRows()` with small sets of row keys,
+ * and `SampleRows()`. Hedging is disabled unless the application provides a
+ * `HedgingPolicy` when the `Table` is created.
+ *
+ * Implementations must be thread-safe, the `Table` shares a single policy
+ * across all its (possibly concurrent) requests.
+ */
+class HedgingPolicy {
+ public:
+  virtual ~HedgingPolicy() = default;
+
+  /// Return a copy of the policy.
+  virtual std::unique_ptr<HedgingPolicy> clone() const = 0;
+
+  /// How long to wait for the first response before sending a second request.
+  virtual std::chrono::microseconds hedge_delay() = 0;
+
+  /// Called with the time until the first response of each successful read.
+  virtual void OnLatency(std::chrono::microseconds latency) = 0;
+};
+
+/**
+ * Hedge the requests slower than a percentile of the recent latencies.
+ *
+ * The policy keeps the latency of the last @p window_size reads, and sends
+ * the second request once the first one has taken longer than @p percentile
+ * of them. With the default (0.95) about 5% of the reads are hedged. The delay
+ * is clamped to the [@p minimum_delay, @p maximum_delay] range, and until the
+ * policy has observed enough reads it uses @p maximum_delay.
+ *
+ * Copies of this policy share their observations.
+ *
+ * @par Example
+ * @code
+ * using namespace std::chrono_literals; // assuming C++14.
+ * bigtable::Table table(client, "my-table",
+ *                       bigtable::LatencyHedgingPolicy(0.95, 2ms, 100ms));
+ * @endcode
+ */
+class LatencyHedgingPolicy : public HedgingPolicy {
+ public:
+  explicit LatencyHedgingPolicy(
+      double percentile = 0.95,
+      std::chrono::microseconds minimum_delay = std::chrono::milliseconds(1),
+      std::chrono::microseconds maximum_delay = std::chrono::seconds(1),
+      std::size_t window_size = 1000);
+
+  std::unique_ptr<HedgingPolicy> clone() const override;
+  std::chrono::microseconds hedge_delay() override;
+  void OnLatency(std::chrono::microseconds latency) override;
+
+ private:
+  struct State {
+    std::mutex mu;
+    std::vector<std::chrono::microseconds> samples;  // GUARDED_BY(mu)
+    std::size_t next = 0;                            // GUARDED_BY(mu)
+  };
+
+  double percentile_;
+  std::chrono::microseconds minimum_delay_;
+  std::chrono::microseconds maximum_delay_;
+  std::size_t window_size_;
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H
@@ -0,0 +1,68 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/hedging_policy.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+
+using ::std::chrono::microseconds;
+using ::std::chrono::milliseconds;
+
+TEST(LatencyHedgingPolicyTest, MaximumDelayWithoutSamples) {
+  LatencyHedgingPolicy tested(0.9, milliseconds(1), milliseconds(100));
+  EXPECT_EQ(milliseconds(100), tested.hedge_delay());
+  for (int i = 0; i != 10; ++i) tested.OnLatency(milliseconds(5));
+  EXPECT_EQ(milliseconds(100), tested.hedge_delay());
+}
+
+TEST(LatencyHedgingPolicyTest, Percentile) {
+  LatencyHedgingPolicy tested(0.9, milliseconds(1), milliseconds(100));
+  for (int i = 100; i != 0; --i) tested.OnLatency(milliseconds(i));
+  EXPECT_EQ(milliseconds(91), tested.hedge_delay());
+}
+
+TEST(LatencyHedgingPolicyTest, Clamped) {
+  LatencyHedgingPolicy tested(0.5, milliseconds(2), milliseconds(10));
+  for (int i = 0; i != 50; ++i) tested.OnLatency(microseconds(100));
+  EXPECT_EQ(milliseconds(2), tested.hedge_delay());
+  for (int i = 0; i != 100; ++i) tested.OnLatency(milliseconds(50));
+  EXPECT_EQ(milliseconds(10), tested.hedge_delay());
+}
+
+TEST(LatencyHedgingPolicyTest, Window) {
+  LatencyHedgingPolicy tested(0.5, milliseconds(1), milliseconds(100), 20);
+  for (int i = 0; i != 20; ++i) tested.OnLatency(milliseconds(50));
+  EXPECT_EQ(milliseconds(50), tested.hedge_delay());
+  // The old samples are discarded.
+  for (int i = 0; i != 20; ++i) tested.OnLatency(milliseconds(5));
+  EXPECT_EQ(milliseconds(5), tested.hedge_delay());
+}
+
+TEST(LatencyHedgingPolicyTest, ClonesShareSamples) {
+  LatencyHedgingPolicy tested(0.5, milliseconds(1), milliseconds(100));
+  auto clone = tested.clone();
+  for (int i = 0; i != 20; ++i) clone->OnLatency(milliseconds(7));
+  EXPECT_EQ(milliseconds(7), tested.hedge_delay());
+}
+
+}  // namespace
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
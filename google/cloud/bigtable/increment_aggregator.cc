@@ -0,0 +1,200 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/increment_aggregator.h"
+#include "google/cloud/bigtable/read_modify_write_rule.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace btproto = ::google::bigtable::v2;
+
+namespace {
+
+struct Waiter {
+  std::int64_t amount;
+  promise<StatusOr<std::int64_t>> result;
+};
+
+// The increments of a single cell, in the order they were received.
+struct PendingCell {
+  std::int64_t total = 0;
+  std::vector<Waiter> waiters;
+};
+
+// The pending increments of a row, keyed by family and column.
+using PendingRow = std::map<std::pair<std::string, std::string>, PendingCell>;
+
+StatusOr<std::int64_t> FindCounter(Row const& row, std::string const& family,
+                                   std::string const& column) {
+  for (auto const& cell : row.cells()) {
+    if (cell.family_name() != family || cell.column_qualifier() != column) {
+      continue;
+    }
+    return cell.decode_big_endian_integer<std::int64_t>();
+  }
+  return Status(StatusCode::kInternal,
+                "ReadModifyWriteRow response is missing the cell for " +
+                    family + ":" + column);
+}
+
+void Complete(PendingRow& cells, StatusOr<Row> const& row) {
+  for (auto& c : cells) {
+    auto& waiters = c.second.waiters;
+    auto value = row ? FindCounter(*row, c.first.first, c.first.second)
+                     : StatusOr<std::int64_t>(row.status());
+    if (!value) {
+      for (auto& w : waiters) w.result.set_value(value.status());
+      continue;
+    }
+    // The service returns the value after all the increments, walk back from
+    // the last one to compute what each caller would have seen.
+    auto v = *value;
+    for (auto w = waiters.rbegin(); w != waiters.rend(); ++w) {
+      w->result.set_value(v);
+      v -= w->amount;
+    }
+  }
+}
+
+}  // namespace
+
+class IncrementAggregator::State
+    : public std::enable_shared_from_this<IncrementAggregator::State> {
+ public:
+  State(Table table, CompletionQueue cq, Options options)
+      : table_(std::move(table)),
+        cq_(std::move(cq)),
+        options_(std::move(options)) {}
+
+  future<StatusOr<std::int64_t>> Increment(std::string row_key,
+                                           std::string family,
+                                           std::string column,
+                                           std::int64_t amount) {
+    promise<StatusOr<std::int64_t>> p;
+    auto f = p.get_future();
+    bool flush = false;
+    bool start_timer = false;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      auto& cell = pending_[std::move(row_key)][std::make_pair(
+          std::move(family), std::move(column))];
+      cell.total += amount;
+      cell.waiters.push_back(Waiter{amount, std::move(p)});
+      if (pending_.size() >= (std::max)(options_.max_pending_rows,
+                                        std::size_t{1})) {
+        flush = true;
+      } else if (!timer_running_) {
+        start_timer = timer_running_ = true;
+      }
+    }
+    if (flush) Flush();
+    if (start_timer) StartTimer();
+    return f;
+  }
+
+  void Flush() {
+    std::unordered_map<std::string, PendingRow> pending;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      pending.swap(pending_);
+    }
+    if (pending.empty()) return;
+
+    std::vector<std::pair<future<StatusOr<Row>>, std::shared_ptr<PendingRow>>>
+        sent;
+    sent.reserve(pending.size());
+    {
+      // `Table` is not thread-safe, and this runs both in the application
+      // threads and the timer callbacks.
+      std::lock_guard<std::mutex> lk(table_mu_);
+      for (auto& row : pending) {
+        btproto::ReadModifyWriteRowRequest request;
+        request.set_row_key(row.first);
+        for (auto const& cell : row.second) {
+          *request.add_rules() =
+              ReadModifyWriteRule::IncrementAmount(
+                  cell.first.first, cell.first.second, cell.second.total)
+                  .as_proto();
+        }
+        sent.emplace_back(SendRequest(table_, cq_, std::move(request)),
+                          std::make_shared<PendingRow>(std::move(row.second)));
+      }
+    }
+    // Attach the callbacks without holding any locks, they may run
+    // immediately and satisfy the application's futures.
+    for (auto& s : sent) {
+      auto cells = std::move(s.second);
+      s.first.then(
+          [cells](future<StatusOr<Row>> f) { Complete(*cells, f.get()); });
+    }
+  }
+
+ private:
+  void StartTimer() {
+    std::weak_ptr<State> self = shared_from_this();
+    cq_.MakeRelativeTimer(options_.flush_period)
+        .then([self](future<StatusOr<std::chrono::system_clock::time_point>>) {
+          auto state = self.lock();
+          if (!state) return;
+          {
+            std::lock_guard<std::mutex> lk(state->mu_);
+            state->timer_running_ = false;
+          }
+          state->Flush();
+        });
+  }
+
+  Table table_;
+  CompletionQueue cq_;
+  Options const options_;
+  std::mutex table_mu_;
+  std::mutex mu_;
+  std::unordered_map<std::string, PendingRow> pending_;  // GUARDED_BY(mu_)
+  bool timer_running_ = false;                            // GUARDED_BY(mu_)
+};
+
+IncrementAggregator::IncrementAggregator(Table table, CompletionQueue cq,
+                                         Options options)
+    : state_(std::make_shared<State>(std::move(table), std::move(cq),
+                                     std::move(options))) {}
+
+IncrementAggregator::~IncrementAggregator() { state_->Flush(); }
+
+future<StatusOr<std::int64_t>> IncrementAggregator::AsyncIncrement(
+    std::string row_key, std::string family, std::string column,
+    std::int64_t amount) {
+  return state_->Increment(std::move(row_key), std::move(family),
+                           std::move(column), amount);
+}
+
+void IncrementAggregator::Flush() { state_->Flush(); }
+
+future<StatusOr<Row>> IncrementAggregator::SendRequest(
+    Table& table, CompletionQueue& cq,
+    btproto::ReadModifyWriteRowRequest request) {
+  return table.AsyncReadModifyWriteRowImpl(cq, std::move(request));
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
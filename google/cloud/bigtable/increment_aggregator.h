@@ -0,0 +1,130 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INCREMENT_AGGREGATOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INCREMENT_AGGREGATOR_H
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status_or.h"
+#include <google/bigtable/v2/bigtable.pb.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Combines increments of the same cells into fewer `ReadModifyWriteRow` calls.
+ *
+ * Applications incrementing a few hot counters at a high rate pay a round trip
+ * per `Table::ReadModifyWriteRow()` call, and the calls contend on the same
+ * rows. This class holds increments for a short period, sums the increments
+ * for each (row, family, column), and then sends a single
+ * `ReadModifyWriteRow` request per row, with one `IncrementAmount` rule per
+ * column.
+ *
+ * Each caller receives the value of the counter as if the increments had been
+ * applied one at a time, in the order they were received: the value returned
+ * by the service, minus the increments received after the caller's. As with
+ * `Table::ReadModifyWriteRow()`, a failed request fails all its increments,
+ * and the requests are not retried, because they are not idempotent.
+ *
+ * Increments wait up to `Options::flush_period` before they are sent, trading
+ * that latency for fewer requests. Applications must run the event loop of the
+ * `CompletionQueue` in one or more threads.
+ *
+ * @par Thread-safety
+ * Instances of this class are guaranteed to work when accessed concurrently
+ * from multiple threads.
+ *
+ * @par Example
+ * @code
+ * namespace cbt = google::cloud::bigtable;
+ * cbt::IncrementAggregator counters(table, cq);
+ * auto value = counters.AsyncIncrement("page#home", "stats", "views", 1);
+ * // ... later ...
+ * auto v = value.get();
+ * if (!v) throw std::runtime_error(v.status().message());
+ * std::cout << "views: " << *v << "\n";
+ * @endcode
+ */
+class IncrementAggregator {
+ public:
+  /// Configure an `IncrementAggregator`.
+  struct Options {
+    Options() = default;
+
+    /// How long increments wait for others before they are sent.
+    Options& SetFlushPeriod(std::chrono::milliseconds v) {
+      flush_period = v;
+      return *this;
+    }
+
+    /// Send the pending increments as soon as they touch this many rows.
+    Options& SetMaxPendingRows(std::size_t v) {
+      max_pending_rows = v;
+      return *this;
+    }
+
+    std::chrono::milliseconds flush_period = std::chrono::milliseconds(10);
+    std::size_t max_pending_rows = 1000;
+  };
+
+  IncrementAggregator(Table table, CompletionQueue cq,
+                      Options options = Options());
+
+  /// Sends any pending increments, without waiting for them.
+  ~IncrementAggregator();
+
+  IncrementAggregator(IncrementAggregator const&) = delete;
+  IncrementAggregator& operator=(IncrementAggregator const&) = delete;
+
+  /**
+   * Add @p amount to the big-endian 64-bit integer in the given cell.
+   *
+   * @returns a future satisfied with the value of the counter after this
+   *     increment, once the request including it completes.
+   */
+  future<StatusOr<std::int64_t>> AsyncIncrement(std::string row_key,
+                                                std::string family,
+                                                std::string column,
+                                                std::int64_t amount);
+
+  /// Send all the pending increments now.
+  void Flush();
+
+ private:
+  class State;
+
+  static future<StatusOr<Row>> SendRequest(
+      Table& table, CompletionQueue& cq,
+      google::bigtable::v2::ReadModifyWriteRowRequest request);
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INCREMENT_AGGREGATOR_H
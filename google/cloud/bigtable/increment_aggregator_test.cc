@@ -0,0 +1,177 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/increment_aggregator.h"
+#include "google/cloud/bigtable/testing/mock_response_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/internal/big_endian.h"
+#include "google/cloud/testing_util/fake_completion_queue_impl.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <map>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+
+namespace btproto = ::google::bigtable::v2;
+
+using ::google::cloud::testing_util::FakeCompletionQueueImpl;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+
+using MockReader = ::google::cloud::bigtable::testing::MockAsyncResponseReader<
+    btproto::ReadModifyWriteRowResponse>;
+
+// Returns a response with the given counter values in family "fam".
+btproto::ReadModifyWriteRowResponse MakeResponse(
+    std::string const& row_key, std::map<std::string, std::int64_t> const& v) {
+  btproto::ReadModifyWriteRowResponse response;
+  response.mutable_row()->set_key(row_key);
+  auto& family = *response.mutable_row()->add_families();
+  family.set_name("fam");
+  for (auto const& kv : v) {
+    auto& column = *family.add_columns();
+    column.set_qualifier(kv.first);
+    column.add_cells()->set_value(
+        google::cloud::internal::EncodeBigEndian(kv.second));
+  }
+  return response;
+}
+
+class IncrementAggregatorTest
+    : public ::google::cloud::bigtable::testing::TableTestFixture {
+ protected:
+  std::shared_ptr<FakeCompletionQueueImpl> cq_impl_ =
+      std::make_shared<FakeCompletionQueueImpl>();
+  CompletionQueue cq_ = CompletionQueue(cq_impl_);
+};
+
+TEST_F(IncrementAggregatorTest, CombinesIncrements) {
+  auto reader = absl::make_unique<MockReader>();
+  EXPECT_CALL(*client_, AsyncReadModifyWriteRow(_, _, _))
+      .WillOnce([&reader](grpc::ClientContext*,
+                          btproto::ReadModifyWriteRowRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ("r1", request.row_key());
+        std::map<std::string, std::int64_t> amounts;
+        for (auto const& r : request.rules()) {
+          EXPECT_EQ("fam", r.family_name());
+          amounts[r.column_qualifier()] = r.increment_amount();
+        }
+        EXPECT_EQ((std::map<std::string, std::int64_t>{{"a", 6}, {"b", 10}}),
+                  amounts);
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            btproto::ReadModifyWriteRowResponse>>(reader.get());
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](btproto::ReadModifyWriteRowResponse* response,
+                   grpc::Status* status, void*) {
+        *response = MakeResponse("r1", {{"a", 106}, {"b", 10}});
+        *status = grpc::Status::OK;
+      });
+
+  IncrementAggregator tested(table_, cq_);
+  auto a1 = tested.AsyncIncrement("r1", "fam", "a", 1);
+  auto a2 = tested.AsyncIncrement("r1", "fam", "a", 2);
+  auto b1 = tested.AsyncIncrement("r1", "fam", "b", 10);
+  auto a3 = tested.AsyncIncrement("r1", "fam", "a", 3);
+
+  // Complete the flush timer and then the request.
+  cq_impl_->SimulateCompletion(true);
+  cq_impl_->SimulateCompletion(true);
+
+  // Each caller sees the value after its own increment.
+  EXPECT_EQ(101, a1.get().value());
+  EXPECT_EQ(103, a2.get().value());
+  EXPECT_EQ(106, a3.get().value());
+  EXPECT_EQ(10, b1.get().value());
+}
+
+TEST_F(IncrementAggregatorTest, OneRequestPerRow) {
+  auto r1 = absl::make_unique<MockReader>();
+  auto r2 = absl::make_unique<MockReader>();
+  EXPECT_CALL(*client_, AsyncReadModifyWriteRow(_, _, _))
+      .Times(2)
+      .WillRepeatedly([&](grpc::ClientContext*,
+                          btproto::ReadModifyWriteRowRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ(1, request.rules_size());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            btproto::ReadModifyWriteRowResponse>>(
+            request.row_key() == "r1" ? r1.get() : r2.get());
+      });
+  EXPECT_CALL(*r1, Finish(_, _, _))
+      .WillOnce([](btproto::ReadModifyWriteRowResponse* response,
+                   grpc::Status* status, void*) {
+        *response = MakeResponse("r1", {{"a", 2}});
+        *status = grpc::Status::OK;
+      });
+  EXPECT_CALL(*r2, Finish(_, _, _))
+      .WillOnce([](btproto::ReadModifyWriteRowResponse*, grpc::Status* status,
+                   void*) {
+        *status = grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh");
+      });
+
+  // Reaching the row limit sends the increments without waiting.
+  IncrementAggregator tested(
+      table_, cq_, IncrementAggregator::Options().SetMaxPendingRows(2));
+  auto f1 = tested.AsyncIncrement("r1", "fam", "a", 1);
+  auto f2 = tested.AsyncIncrement("r1", "fam", "a", 1);
+  auto f3 = tested.AsyncIncrement("r2", "fam", "a", 1);
+  cq_impl_->SimulateCompletion(true);
+
+  EXPECT_EQ(1, f1.get().value());
+  EXPECT_EQ(2, f2.get().value());
+  EXPECT_THAT(f3.get(), StatusIs(StatusCode::kPermissionDenied));
+}
+
+TEST_F(IncrementAggregatorTest, FlushOnDestruction) {
+  auto reader = absl::make_unique<MockReader>();
+  EXPECT_CALL(*client_, AsyncReadModifyWriteRow(_, _, _))
+      .WillOnce([&reader](grpc::ClientContext*,
+                          btproto::ReadModifyWriteRowRequest const&,
+                          grpc::CompletionQueue*) {
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            btproto::ReadModifyWriteRowResponse>>(reader.get());
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](btproto::ReadModifyWriteRowResponse* response,
+                   grpc::Status* status, void*) {
+        // The response does not include the counter.
+        *response = MakeResponse("r1", {});
+        *status = grpc::Status::OK;
+      });
+
+  future<StatusOr<std::int64_t>> f;
+  {
+    IncrementAggregator tested(table_, cq_);
+    f = tested.AsyncIncrement("r1", "fam", "a", 1);
+  }
+  cq_impl_->SimulateCompletion(true);
+  EXPECT_THAT(f.get(), StatusIs(StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
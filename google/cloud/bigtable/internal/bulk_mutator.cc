@@ -65,6 +65,7 @@ BulkMutatorState::BulkMutatorState(std::string const& app_profile_id,
 }
 
 google::bigtable::v2::MutateRowsRequest const& BulkMutatorState::BeforeStart() {
+  MovePendingEntries();
   mutations_.Swap(&pending_mutations_);
   annotations_.swap(pending_annotations_);
   for (auto& a : annotations_) {
@@ -78,6 +79,25 @@ google::bigtable::v2::MutateRowsRequest const& BulkMutatorState::BeforeStart() {
   return mutations_;
 }
 
+void BulkMutatorState::MovePendingEntries() {
+  if (pending_indices_.empty()) return;
+  // Release all the entries from the previous request, the request and its
+  // entries are not allocated in an arena, so this does not copy them.
+  auto& entries = *mutations_.mutable_entries();
+  std::vector<btproto::MutateRowsRequest::Entry*> released(entries.size());
+  entries.ExtractSubrange(0, entries.size(), released.data());
+
+  auto& pending = *pending_mutations_.mutable_entries();
+  pending.Reserve(pending.size() + static_cast<int>(pending_indices_.size()));
+  for (auto const index : pending_indices_) {
+    pending.AddAllocated(released[index]);
+    released[index] = nullptr;
+  }
+  // The remaining entries either succeeded or failed permanently.
+  for (auto* e : released) delete e;
+  pending_indices_.clear();
+}
+
 std::vector<int> BulkMutatorState::OnRead(
     google::bigtable::v2::MutateRowsResponse& response) {
   std::vector<int> res;
@@ -97,6 +117,11 @@ std::vector<int> BulkMutatorState::OnRead(
     }
     auto const index = static_cast<std::size_t>(entry.index());
     auto& annotation = annotations_[index];
+    if (annotation.has_mutation_result) {
+      GCP_LOG(ERROR) << "Duplicate mutation index received from the server,"
+                     << " got=" << entry.index();
+      continue;
+    }
     annotation.has_mutation_result = true;
     auto const& status = entry.status();
     auto const code = static_cast<grpc::StatusCode>(status.code());
@@ -107,14 +132,13 @@ std::vector<int> BulkMutatorState::OnRead(
       res.push_back(annotation.original_index);
       continue;
     }
-    auto& original = *mutations_.mutable_entries(static_cast<int>(index));
     // Failed responses are handled according to the current policies.
     if (SafeGrpcRetry::IsTransientFailure(code) &&
         (annotation.idempotency == Idempotency::kIdempotent)) {
       // Retryable requests are saved in the pending mutations, along with the
       // mapping from their index in pending_mutations_ to the original
       // vector and other miscellanea.
-      pending_mutations_.add_entries()->Swap(&original);
+      pending_indices_.push_back(static_cast<int>(index));
       pending_annotations_.push_back(annotation);
     } else {
       // Failures are saved for reporting, notice that we avoid copying, and
@@ -137,11 +161,10 @@ void BulkMutatorState::OnFinish(google::cloud::Status finish_status) {
       continue;
     }
     // If there are any mutations with unknown state, they need to be handled.
-    auto& original = *mutations_.mutable_entries(index);
     if (annotation.idempotency == Idempotency::kIdempotent) {
       // If the mutation was retryable, move it to the pending mutations to try
       // again, along with their index.
-      pending_mutations_.add_entries()->Swap(&original);
+      pending_indices_.push_back(index);
       pending_annotations_.push_back(annotation);
     } else {
       if (last_status_.ok()) {
@@ -171,9 +194,8 @@ std::vector<FailedMutation> BulkMutatorState::ConsumeAccumulatedFailures() {
 std::vector<FailedMutation> BulkMutatorState::OnRetryDone() && {
   std::vector<FailedMutation> result(std::move(failures_));
 
-  auto size = pending_mutations_.mutable_entries()->size();
-  for (int idx = 0; idx != size; idx++) {
-    int original_index = pending_annotations_[idx].original_index;
+  for (auto const& annotation : pending_annotations_) {
+    int original_index = annotation.original_index;
     if (last_status_.ok()) {
       google::cloud::Status status(
           google::cloud::StatusCode::kInternal,
@@ -35,9 +35,7 @@ class BulkMutatorState {
                    IdempotentMutationPolicy& idempotent_policy,
                    BulkMutation mut);
 
-  bool HasPendingMutations() const {
-    return pending_mutations_.entries_size() != 0;
-  }
+  bool HasPendingMutations() const { return !pending_annotations_.empty(); }
 
   /// Returns the Request parameter for the next MutateRows() RPC.
   google::bigtable::v2::MutateRowsRequest const& BeforeStart();
@@ -66,6 +64,9 @@ class BulkMutatorState {
   std::vector<FailedMutation> OnRetryDone() &&;
 
  private:
+  /// Move the entries to retry from `mutations_` to `pending_mutations_`.
+  void MovePendingEntries();
+
   /// The current request proto.
   google::bigtable::v2::MutateRowsRequest mutations_;
 
@@ -107,6 +108,14 @@ class BulkMutatorState {
   /// Accumulate mutations for the next request.
   google::bigtable::v2::MutateRowsRequest pending_mutations_;
 
+  /**
+   * The entries in `mutations_` to retry in the next request.
+   *
+   * The entries are transferred (not copied, nor swapped into new entries)
+   * to `pending_mutations_` when the next request starts.
+   */
+  std::vector<int> pending_indices_;
+
   /// Accumulate annotations for the next request.
   std::vector<Annotations> pending_annotations_;
 };
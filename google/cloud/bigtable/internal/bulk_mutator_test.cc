@@ -481,6 +481,50 @@ TEST(MultipleRowsMutatorTest, UnconfirmedAreFailed) {
             failures.front().status().code());
 }
 
+TEST(MultipleRowsMutatorTest, RetryMovesPendingEntries) {
+  BulkMutation mut(
+      SingleRowMutation("foo", {SetCell("fam", "col", 0_ms, "v0")}),
+      SingleRowMutation("bar", {SetCell("fam", "col", 0_ms, "v1")}),
+      SingleRowMutation("baz", {SetCell("fam", "col", 0_ms, "v2")}));
+
+  auto policy = DefaultIdempotentMutationPolicy();
+  internal::BulkMutatorState state("", "foo/bar/baz/table", *policy,
+                                   std::move(mut));
+  auto const& first = state.BeforeStart();
+  ASSERT_EQ(3, first.entries_size());
+
+  btproto::MutateRowsResponse response;
+  auto add_entry = [&response](int index, grpc::StatusCode code) {
+    auto& e = *response.add_entries();
+    e.set_index(index);
+    e.mutable_status()->set_code(code);
+  };
+  add_entry(2, grpc::StatusCode::UNAVAILABLE);
+  add_entry(0, grpc::StatusCode::OK);
+  // Duplicate results are ignored.
+  add_entry(2, grpc::StatusCode::UNAVAILABLE);
+  EXPECT_EQ(std::vector<int>{0}, state.OnRead(response));
+  // "bar" has no result, it is retried too.
+  state.OnFinish(Status(StatusCode::kUnavailable, "try-again"));
+  EXPECT_TRUE(state.HasPendingMutations());
+
+  auto const& second = state.BeforeStart();
+  EXPECT_EQ("foo/bar/baz/table", second.table_name());
+  ASSERT_EQ(2, second.entries_size());
+  EXPECT_EQ("baz", second.entries(0).row_key());
+  EXPECT_EQ("v2", second.entries(0).mutations(0).set_cell().value());
+  EXPECT_EQ("bar", second.entries(1).row_key());
+  EXPECT_EQ("v1", second.entries(1).mutations(0).set_cell().value());
+
+  response.Clear();
+  add_entry(0, grpc::StatusCode::OK);
+  add_entry(1, grpc::StatusCode::OK);
+  EXPECT_EQ((std::vector<int>{2, 1}), state.OnRead(response));
+  state.OnFinish(Status());
+  EXPECT_FALSE(state.HasPendingMutations());
+  EXPECT_TRUE(std::move(state).OnRetryDone().empty());
+}
+
 }  // anonymous namespace
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
@@ -0,0 +1,302 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/caching_data_client.h"
+#include "absl/memory/memory.h"
+#include <grpcpp/support/sync_stream.h>
+#include <functional>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+
+namespace btproto = google::bigtable::v2;
+
+namespace {
+/// Replays a cached `ReadRows()` result.
+class CachedReadRowsReader
+    : public grpc::ClientReaderInterface<btproto::ReadRowsResponse> {
+ public:
+  explicit CachedReadRowsReader(
+      std::shared_ptr<RowCache::Responses const> responses)
+      : responses_(std::move(responses)) {}
+
+  void WaitForInitialMetadata() override {}
+
+  bool NextMessageSize(std::uint32_t* sz) override {
+    if (next_ == responses_->size()) return false;
+    *sz = static_cast<std::uint32_t>((*responses_)[next_].ByteSizeLong());
+    return true;
+  }
+
+  bool Read(btproto::ReadRowsResponse* msg) override {
+    if (next_ == responses_->size()) return false;
+    *msg = (*responses_)[next_++];
+    return true;
+  }
+
+  grpc::Status Finish() override { return grpc::Status::OK; }
+
+ private:
+  std::shared_ptr<RowCache::Responses const> responses_;
+  std::size_t next_ = 0;
+};
+
+/// Forwards a `ReadRows()` stream, and caches its result if it succeeds.
+class CachingReadRowsReader
+    : public grpc::ClientReaderInterface<btproto::ReadRowsResponse> {
+ public:
+  CachingReadRowsReader(
+      std::unique_ptr<grpc::ClientReaderInterface<btproto::ReadRowsResponse>>
+          child,
+      std::shared_ptr<RowCache> cache, RowCacheKey key,
+      std::uint64_t generation)
+      : child_(std::move(child)),
+        cache_(std::move(cache)),
+        key_(std::move(key)),
+        generation_(generation) {}
+
+  void WaitForInitialMetadata() override { child_->WaitForInitialMetadata(); }
+
+  bool NextMessageSize(std::uint32_t* sz) override {
+    return child_->NextMessageSize(sz);
+  }
+
+  bool Read(btproto::ReadRowsResponse* msg) override {
+    if (!child_->Read(msg)) return false;
+    if (!caching_) return true;
+    bytes_ += msg->ByteSizeLong();
+    if (bytes_ > cache_->max_bytes()) {
+      // Too large to cache, release the copies as soon as possible.
+      caching_ = false;
+      RowCache::Responses{}.swap(responses_);
+      return true;
+    }
+    responses_.push_back(*msg);
+    return true;
+  }
+
+  grpc::Status Finish() override {
+    auto status = child_->Finish();
+    if (status.ok() && caching_) {
+      cache_->Insert(std::move(key_), generation_, std::move(responses_));
+    }
+    caching_ = false;
+    return status;
+  }
+
+ private:
+  std::unique_ptr<grpc::ClientReaderInterface<btproto::ReadRowsResponse>>
+      child_;
+  std::shared_ptr<RowCache> cache_;
+  RowCacheKey key_;
+  std::uint64_t generation_;
+  bool caching_ = true;
+  std::size_t bytes_ = 0;
+  RowCache::Responses responses_;
+};
+
+/// Forwards a `MutateRows()` stream, and calls a function when it finishes.
+class OnFinishMutateRowsReader
+    : public grpc::ClientReaderInterface<btproto::MutateRowsResponse> {
+ public:
+  OnFinishMutateRowsReader(
+      std::unique_ptr<grpc::ClientReaderInterface<btproto::MutateRowsResponse>>
+          child,
+      std::function<void()> on_finish)
+      : child_(std::move(child)), on_finish_(std::move(on_finish)) {}
+
+  void WaitForInitialMetadata() override { child_->WaitForInitialMetadata(); }
+
+  bool NextMessageSize(std::uint32_t* sz) override {
+    return child_->NextMessageSize(sz);
+  }
+
+  bool Read(btproto::MutateRowsResponse* msg) override {
+    return child_->Read(msg);
+  }
+
+  grpc::Status Finish() override {
+    auto status = child_->Finish();
+    on_finish_();
+    return status;
+  }
+
+ private:
+  std::unique_ptr<grpc::ClientReaderInterface<btproto::MutateRowsResponse>>
+      child_;
+  std::function<void()> on_finish_;
+};
+}  // namespace
+
+grpc::Status CachingDataClient::MutateRow(
+    grpc::ClientContext* context, btproto::MutateRowRequest const& request,
+    btproto::MutateRowResponse* response) {
+  auto const row = RowCacheRow(request.table_name(), request.row_key());
+  cache_->Invalidate(row);
+  auto status = child_->MutateRow(context, request, response);
+  cache_->Invalidate(row);
+  return status;
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<btproto::MutateRowResponse>>
+CachingDataClient::AsyncMutateRow(grpc::ClientContext* context,
+                                  btproto::MutateRowRequest const& request,
+                                  grpc::CompletionQueue* cq) {
+  cache_->Invalidate(RowCacheRow(request.table_name(), request.row_key()));
+  return child_->AsyncMutateRow(context, request, cq);
+}
+
+grpc::Status CachingDataClient::CheckAndMutateRow(
+    grpc::ClientContext* context,
+    btproto::CheckAndMutateRowRequest const& request,
+    btproto::CheckAndMutateRowResponse* response) {
+  auto const row = RowCacheRow(request.table_name(), request.row_key());
+  cache_->Invalidate(row);
+  auto status = child_->CheckAndMutateRow(context, request, response);
+  cache_->Invalidate(row);
+  return status;
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    google::bigtable::v2::CheckAndMutateRowResponse>>
+CachingDataClient::AsyncCheckAndMutateRow(
+    grpc::ClientContext* context,
+    const google::bigtable::v2::CheckAndMutateRowRequest& request,
+    grpc::CompletionQueue* cq) {
+  cache_->Invalidate(RowCacheRow(request.table_name(), request.row_key()));
+  return child_->AsyncCheckAndMutateRow(context, request, cq);
+}
+
+grpc::Status CachingDataClient::ReadModifyWriteRow(
+    grpc::ClientContext* context,
+    btproto::ReadModifyWriteRowRequest const& request,
+    btproto::ReadModifyWriteRowResponse* response) {
+  auto const row = RowCacheRow(request.table_name(), request.row_key());
+  cache_->Invalidate(row);
+  auto status = child_->ReadModifyWriteRow(context, request, response);
+  cache_->Invalidate(row);
+  return status;
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    google::bigtable::v2::ReadModifyWriteRowResponse>>
+CachingDataClient::AsyncReadModifyWriteRow(
+    grpc::ClientContext* context,
+    google::bigtable::v2::ReadModifyWriteRowRequest const& request,
+    grpc::CompletionQueue* cq) {
+  cache_->Invalidate(RowCacheRow(request.table_name(), request.row_key()));
+  return child_->AsyncReadModifyWriteRow(context, request, cq);
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<btproto::ReadRowsResponse>>
+CachingDataClient::ReadRows(grpc::ClientContext* context,
+                            btproto::ReadRowsRequest const& request) {
+  auto key = MakeRowCacheKey(request);
+  if (!key) return child_->ReadRows(context, request);
+  auto cached = cache_->Lookup(*key);
+  if (cached) return absl::make_unique<CachedReadRowsReader>(std::move(cached));
+  // Capture the generation before sending the request, any mutation after
+  // this point discards the result.
+  auto const generation = cache_->generation();
+  return absl::make_unique<CachingReadRowsReader>(
+      child_->ReadRows(context, request), cache_, *std::move(key),
+      generation);
+}
+
+std::unique_ptr<grpc::ClientAsyncReaderInterface<btproto::ReadRowsResponse>>
+CachingDataClient::AsyncReadRows(
+    grpc::ClientContext* context,
+    const google::bigtable::v2::ReadRowsRequest& request,
+    grpc::CompletionQueue* cq, void* tag) {
+  return child_->AsyncReadRows(context, request, cq, tag);
+}
+
+std::unique_ptr<::grpc::ClientAsyncReaderInterface<
+    ::google::bigtable::v2::ReadRowsResponse>>
+CachingDataClient::PrepareAsyncReadRows(
+    ::grpc::ClientContext* context,
+    const ::google::bigtable::v2::ReadRowsRequest& request,
+    ::grpc::CompletionQueue* cq) {
+  return child_->PrepareAsyncReadRows(context, request, cq);
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<btproto::SampleRowKeysResponse>>
+CachingDataClient::SampleRowKeys(
+    grpc::ClientContext* context,
+    btproto::SampleRowKeysRequest const& request) {
+  return child_->SampleRowKeys(context, request);
+}
+
+std::unique_ptr<::grpc::ClientAsyncReaderInterface<
+    ::google::bigtable::v2::SampleRowKeysResponse>>
+CachingDataClient::AsyncSampleRowKeys(
+    ::grpc::ClientContext* context,
+    const ::google::bigtable::v2::SampleRowKeysRequest& request,
+    ::grpc::CompletionQueue* cq, void* tag) {
+  return child_->AsyncSampleRowKeys(context, request, cq, tag);
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<btproto::MutateRowsResponse>>
+CachingDataClient::MutateRows(grpc::ClientContext* context,
+                              btproto::MutateRowsRequest const& request) {
+  Invalidate(request);
+  auto cache = cache_;
+  // Copy only the keys, the request may be released before the stream.
+  auto rows = std::make_shared<std::vector<std::string>>();
+  rows->reserve(request.entries_size());
+  for (auto const& entry : request.entries()) {
+    rows->push_back(RowCacheRow(request.table_name(), entry.row_key()));
+  }
+  return absl::make_unique<OnFinishMutateRowsReader>(
+      child_->MutateRows(context, request), [cache, rows] {
+        for (auto const& row : *rows) cache->Invalidate(row);
+      });
+}
+
+std::unique_ptr<::grpc::ClientAsyncReaderInterface<
+    ::google::bigtable::v2::MutateRowsResponse>>
+CachingDataClient::AsyncMutateRows(
+    ::grpc::ClientContext* context,
+    const ::google::bigtable::v2::MutateRowsRequest& request,
+    ::grpc::CompletionQueue* cq, void* tag) {
+  Invalidate(request);
+  return child_->AsyncMutateRows(context, request, cq, tag);
+}
+
+std::unique_ptr<::grpc::ClientAsyncReaderInterface<
+    ::google::bigtable::v2::MutateRowsResponse>>
+CachingDataClient::PrepareAsyncMutateRows(
+    ::grpc::ClientContext* context,
+    const ::google::bigtable::v2::MutateRowsRequest& request,
+    ::grpc::CompletionQueue* cq) {
+  Invalidate(request);
+  return child_->PrepareAsyncMutateRows(context, request, cq);
+}
+
+void CachingDataClient::Invalidate(btproto::MutateRowsRequest const& request) {
+  for (auto const& entry : request.entries()) {
+    cache_->Invalidate(RowCacheRow(request.table_name(), entry.row_key()));
+  }
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
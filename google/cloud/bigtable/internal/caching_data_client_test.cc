@@ -0,0 +1,224 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/caching_data_client.h"
+#include "google/cloud/bigtable/testing/mock_data_client.h"
+#include "google/cloud/bigtable/testing/mock_mutate_rows_reader.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace btproto = ::google::bigtable::v2;
+using ::testing::Return;
+
+auto constexpr kTableName = "projects/p/instances/i/tables/t";
+
+btproto::ReadRowsRequest MakeReadRowRequest(std::string const& row_key) {
+  btproto::ReadRowsRequest request;
+  request.set_table_name(kTableName);
+  request.mutable_rows()->add_row_keys(row_key);
+  request.set_rows_limit(1);
+  return request;
+}
+
+/// Returns a mock stream with a single response, holding @p value.
+std::unique_ptr<grpc::ClientReaderInterface<btproto::ReadRowsResponse>>
+MakeReader(std::string const& value) {
+  auto* reader =
+      new testing::MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  EXPECT_CALL(*reader, Read)
+      .WillOnce([value](btproto::ReadRowsResponse* r) {
+        auto& chunk = *r->add_chunks();
+        chunk.set_row_key("r1");
+        chunk.set_value(value);
+        chunk.set_commit_row(true);
+        return true;
+      })
+      .WillOnce(Return(false));
+  EXPECT_CALL(*reader, Finish).WillOnce(Return(grpc::Status::OK));
+  return std::unique_ptr<
+      grpc::ClientReaderInterface<btproto::ReadRowsResponse>>(reader);
+}
+
+/// Reads all the values in @p stream.
+std::vector<std::string> ReadAll(
+    grpc::ClientReaderInterface<btproto::ReadRowsResponse>& stream) {
+  std::vector<std::string> values;
+  btproto::ReadRowsResponse response;
+  while (stream.Read(&response)) {
+    for (auto const& chunk : response.chunks()) values.push_back(chunk.value());
+  }
+  EXPECT_TRUE(stream.Finish().ok());
+  return values;
+}
+
+class CachingDataClientTest : public ::testing::Test {
+ protected:
+  CachingDataClientTest()
+      : mock_(std::make_shared<testing::MockDataClient>()),
+        cache_(std::make_shared<RowCache>(std::chrono::seconds(60),
+                                          1024 * 1024)),
+        tested_(mock_, cache_) {}
+
+  std::vector<std::string> ReadRow(std::string const& row_key) {
+    grpc::ClientContext context;
+    auto stream = tested_.ReadRows(&context, MakeReadRowRequest(row_key));
+    return ReadAll(*stream);
+  }
+
+  std::shared_ptr<testing::MockDataClient> mock_;
+  std::shared_ptr<RowCache> cache_;
+  CachingDataClient tested_;
+};
+
+TEST_F(CachingDataClientTest, ReadRowsCached) {
+  EXPECT_CALL(*mock_, ReadRows)
+      .WillOnce([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+        return MakeReader("v1");
+      });
+
+  EXPECT_THAT(ReadRow("r1"), ::testing::ElementsAre("v1"));
+  // The second read is served from the cache.
+  EXPECT_THAT(ReadRow("r1"), ::testing::ElementsAre("v1"));
+  EXPECT_EQ(1U, cache_->size());
+}
+
+TEST_F(CachingDataClientTest, ReadRowsNotCachedOnError) {
+  EXPECT_CALL(*mock_, ReadRows)
+      .Times(2)
+      .WillRepeatedly(
+          [](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+            auto* reader = new testing::MockReadRowsReader(
+                "google.bigtable.v2.Bigtable.ReadRows");
+            EXPECT_CALL(*reader, Read).WillOnce(Return(false));
+            EXPECT_CALL(*reader, Finish)
+                .WillOnce(Return(
+                    grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+            return std::unique_ptr<
+                grpc::ClientReaderInterface<btproto::ReadRowsResponse>>(reader);
+          });
+
+  for (int i = 0; i != 2; ++i) {
+    grpc::ClientContext context;
+    auto stream = tested_.ReadRows(&context, MakeReadRowRequest("r1"));
+    btproto::ReadRowsResponse response;
+    EXPECT_FALSE(stream->Read(&response));
+    EXPECT_FALSE(stream->Finish().ok());
+  }
+  EXPECT_EQ(0U, cache_->size());
+}
+
+TEST_F(CachingDataClientTest, ReadRowsRangeNotCached) {
+  EXPECT_CALL(*mock_, ReadRows)
+      .Times(2)
+      .WillRepeatedly(
+          [](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+            return MakeReader("v1");
+          });
+
+  auto request = MakeReadRowRequest("r1");
+  request.mutable_rows()->add_row_keys("r2");
+  for (int i = 0; i != 2; ++i) {
+    grpc::ClientContext context;
+    auto stream = tested_.ReadRows(&context, request);
+    EXPECT_THAT(ReadAll(*stream), ::testing::ElementsAre("v1"));
+  }
+  EXPECT_EQ(0U, cache_->size());
+}
+
+TEST_F(CachingDataClientTest, MutateRowInvalidates) {
+  EXPECT_CALL(*mock_, ReadRows)
+      .WillOnce([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+        return MakeReader("v1");
+      })
+      .WillOnce([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+        return MakeReader("v2");
+      });
+  EXPECT_CALL(*mock_, MutateRow).WillOnce(Return(grpc::Status::OK));
+
+  EXPECT_THAT(ReadRow("r1"), ::testing::ElementsAre("v1"));
+
+  grpc::ClientContext context;
+  btproto::MutateRowRequest request;
+  request.set_table_name(kTableName);
+  request.set_row_key("r1");
+  btproto::MutateRowResponse response;
+  EXPECT_TRUE(tested_.MutateRow(&context, request, &response).ok());
+  EXPECT_EQ(0U, cache_->size());
+
+  EXPECT_THAT(ReadRow("r1"), ::testing::ElementsAre("v2"));
+}
+
+TEST_F(CachingDataClientTest, MutateRowOtherTable) {
+  EXPECT_CALL(*mock_, ReadRows)
+      .WillOnce([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+        return MakeReader("v1");
+      });
+  EXPECT_CALL(*mock_, MutateRow).WillOnce(Return(grpc::Status::OK));
+
+  EXPECT_THAT(ReadRow("r1"), ::testing::ElementsAre("v1"));
+
+  grpc::ClientContext context;
+  btproto::MutateRowRequest request;
+  request.set_table_name("projects/p/instances/i/tables/other");
+  request.set_row_key("r1");
+  btproto::MutateRowResponse response;
+  EXPECT_TRUE(tested_.MutateRow(&context, request, &response).ok());
+  EXPECT_EQ(1U, cache_->size());
+}
+
+TEST_F(CachingDataClientTest, MutateRowsInvalidatesOnFinish) {
+  EXPECT_CALL(*mock_, ReadRows)
+      .WillOnce([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+        return MakeReader("v1");
+      });
+  EXPECT_CALL(*mock_, MutateRows)
+      .WillOnce([](grpc::ClientContext*, btproto::MutateRowsRequest const&) {
+        auto* reader = new testing::MockMutateRowsReader(
+            "google.bigtable.v2.Bigtable.MutateRows");
+        EXPECT_CALL(*reader, Read).WillOnce(Return(false));
+        EXPECT_CALL(*reader, Finish).WillOnce(Return(grpc::Status::OK));
+        return std::unique_ptr<
+            grpc::ClientReaderInterface<btproto::MutateRowsResponse>>(reader);
+      });
+
+  grpc::ClientContext context;
+  btproto::MutateRowsRequest request;
+  request.set_table_name(kTableName);
+  request.add_entries()->set_row_key("r1");
+  auto stream = tested_.MutateRows(&context, request);
+
+  // A read that completes while the mutation is in progress may return the
+  // old values, it must not be cached.
+  EXPECT_THAT(ReadRow("r1"), ::testing::ElementsAre("v1"));
+  EXPECT_EQ(1U, cache_->size());
+
+  btproto::MutateRowsResponse response;
+  EXPECT_FALSE(stream->Read(&response));
+  EXPECT_TRUE(stream->Finish().ok());
+  EXPECT_EQ(0U, cache_->size());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,191 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/channel_load_balancer.h"
+#include <algorithm>
+#include <random>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+// Replace a channel after this many consecutive failures.
+auto constexpr kMaxConsecutiveFailures = 3;
+// Look for slow channels after this many completed calls.
+auto constexpr kSlowChannelCheckInterval = 64;
+// Channels need this many samples before they are considered slow.
+auto constexpr kMinSamples = 16;
+// A channel is slow if its latency is this many times the median latency...
+auto constexpr kSlowChannelFactor = 4.0;
+// ... and above this threshold, small absolute differences do not matter.
+auto constexpr kMinSlowLatencyUs = 50 * 1000.0;
+// Only prefer a channel for its latency if it is this many times faster.
+auto constexpr kLatencyTolerance = 2.0;
+// The weight of each new sample in the latency moving average.
+auto constexpr kLatencyAlpha = 0.2;
+
+bool IsUnhealthy(grpc::Status const& status) {
+  return status.error_code() == grpc::StatusCode::UNAVAILABLE ||
+         status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED;
+}
+}  // namespace
+
+ChannelLoadBalancer::ChannelLoadBalancer(std::size_t size)
+    : channels_(size), rng_(std::random_device{}()) {}
+
+std::size_t ChannelLoadBalancer::Pick() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (channels_.size() <= 1) return 0;
+  // Skip the channels waiting for a replacement, unless all of them are.
+  auto candidate = next_;
+  for (std::size_t i = 0; i != channels_.size(); ++i) {
+    candidate = (next_ + i) % channels_.size();
+    if (!channels_[candidate].evicted) break;
+  }
+  next_ = (candidate + 1) % channels_.size();
+  auto const alternative = std::uniform_int_distribution<std::size_t>(
+      0, channels_.size() - 1)(rng_);
+  if (IsBetter(channels_[alternative], channels_[candidate])) {
+    return alternative;
+  }
+  return candidate;
+}
+
+void ChannelLoadBalancer::OnStart(std::size_t index) {
+  std::lock_guard<std::mutex> lk(mu_);
+  ++channels_.at(index).in_flight;
+}
+
+void ChannelLoadBalancer::RecordLatency(std::size_t index,
+                                        std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& c = channels_.at(index);
+  auto const sample = static_cast<double>(latency.count());
+  c.latency_us = c.samples == 0 ? sample
+                                : kLatencyAlpha * sample +
+                                      (1 - kLatencyAlpha) * c.latency_us;
+  ++c.samples;
+}
+
+void ChannelLoadBalancer::OnDone(std::size_t index,
+                                 grpc::Status const& status) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& c = channels_.at(index);
+  if (c.in_flight > 0) --c.in_flight;
+  if (!IsUnhealthy(status)) {
+    c.consecutive_failures = 0;
+  } else if (++c.consecutive_failures >= kMaxConsecutiveFailures) {
+    Evict(index);
+  }
+  if (++completions_ % kSlowChannelCheckInterval == 0) CheckSlowChannels();
+}
+
+std::vector<std::size_t> ChannelLoadBalancer::TakeEvicted() {
+  std::lock_guard<std::mutex> lk(mu_);
+  std::vector<std::size_t> evicted;
+  evicted.swap(evicted_);
+  for (auto index : evicted) {
+    auto& c = channels_[index];
+    c.latency_us = 0;
+    c.samples = 0;
+    c.consecutive_failures = 0;
+    c.evicted = false;
+  }
+  return evicted;
+}
+
+std::size_t ChannelLoadBalancer::in_flight(std::size_t index) {
+  std::lock_guard<std::mutex> lk(mu_);
+  return channels_.at(index).in_flight;
+}
+
+std::chrono::microseconds ChannelLoadBalancer::latency(std::size_t index) {
+  std::lock_guard<std::mutex> lk(mu_);
+  return std::chrono::microseconds(
+      static_cast<std::int64_t>(channels_.at(index).latency_us));
+}
+
+bool ChannelLoadBalancer::IsBetter(ChannelStats const& a,
+                                   ChannelStats const& b) {
+  if (a.evicted != b.evicted) return b.evicted;
+  if (a.in_flight != b.in_flight) return a.in_flight < b.in_flight;
+  if (a.samples == 0 || b.samples == 0) return false;
+  return a.latency_us * kLatencyTolerance < b.latency_us;
+}
+
+void ChannelLoadBalancer::Evict(std::size_t index) {
+  auto& c = channels_[index];
+  if (c.evicted) return;
+  c.evicted = true;
+  evicted_.push_back(index);
+}
+
+void ChannelLoadBalancer::CheckSlowChannels() {
+  // Replace at most one slow channel at a time, the pool may be slow because
+  // the service is slow.
+  if (!evicted_.empty()) return;
+  std::vector<double> latencies;
+  for (auto const& c : channels_) {
+    if (c.samples >= kMinSamples) latencies.push_back(c.latency_us);
+  }
+  if (latencies.size() < 2) return;
+  auto const mid = latencies.begin() + latencies.size() / 2;
+  std::nth_element(latencies.begin(), mid, latencies.end());
+  auto const threshold =
+      (std::max)(kMinSlowLatencyUs, *mid * kSlowChannelFactor);
+  auto slowest = std::max_element(
+      channels_.begin(), channels_.end(),
+      [](ChannelStats const& a, ChannelStats const& b) {
+        return a.latency_us < b.latency_us;
+      });
+  if (slowest->samples < kMinSamples || slowest->latency_us <= threshold) {
+    return;
+  }
+  Evict(static_cast<std::size_t>(std::distance(channels_.begin(), slowest)));
+}
+
+ChannelCallTracker::ChannelCallTracker(
+    std::shared_ptr<ChannelLoadBalancer> balancer, std::size_t index)
+    : balancer_(std::move(balancer)),
+      index_(index),
+      start_(ChannelLoadBalancer::Clock::now()) {
+  balancer_->OnStart(index_);
+}
+
+ChannelCallTracker::~ChannelCallTracker() {
+  if (balancer_) Done(grpc::Status::OK);
+}
+
+void ChannelCallTracker::RecordLatency() {
+  if (!balancer_ || latency_recorded_) return;
+  latency_recorded_ = true;
+  balancer_->RecordLatency(
+      index_, std::chrono::duration_cast<std::chrono::microseconds>(
+                  ChannelLoadBalancer::Clock::now() - start_));
+}
+
+void ChannelCallTracker::Done(grpc::Status const& status) {
+  if (!balancer_) return;
+  RecordLatency();
+  balancer_->OnDone(index_, status);
+  balancer_.reset();
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,172 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_CHANNEL_LOAD_BALANCER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_CHANNEL_LOAD_BALANCER_H
+
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/internal/random.h"
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/sync_stream.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Selects the channel for each call in a `CommonClient` pool.
+ *
+ * The balancer tracks the number of calls in flight, the latency and the
+ * consecutive failures of each channel. It uses the "power of two choices"
+ * algorithm: it compares the next channel in round-robin order with a channel
+ * chosen at random and picks the least loaded one. When there is no load
+ * information (e.g., for calls that are not tracked) this is simply
+ * round-robin.
+ *
+ * Channels that fail repeatedly with `UNAVAILABLE` or `DEADLINE_EXCEEDED`, or
+ * that are much slower than the rest of the pool, are marked for eviction.
+ * `CommonClient` replaces them with new channels, see `TakeEvicted()`.
+ *
+ * @par Thread-safety
+ * Instances of this class are safe to use from multiple threads.
+ */
+class ChannelLoadBalancer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit ChannelLoadBalancer(std::size_t size);
+
+  /// The index of the channel for the next call.
+  std::size_t Pick();
+
+  /// A call started on channel @p index.
+  void OnStart(std::size_t index);
+
+  /// The call on channel @p index took @p latency to return its first result.
+  void RecordLatency(std::size_t index, std::chrono::microseconds latency);
+
+  /// A call on channel @p index completed with @p status.
+  void OnDone(std::size_t index, grpc::Status const& status);
+
+  /**
+   * Returns the channels that should be replaced, and resets their stats.
+   *
+   * The caller is expected to replace each channel in the returned list. Calls
+   * in flight on the old channel are still accounted for.
+   */
+  std::vector<std::size_t> TakeEvicted();
+
+  std::size_t in_flight(std::size_t index);
+  std::chrono::microseconds latency(std::size_t index);
+
+ private:
+  struct ChannelStats {
+    std::size_t in_flight = 0;
+    double latency_us = 0;
+    std::uint64_t samples = 0;
+    int consecutive_failures = 0;
+    bool evicted = false;
+  };
+
+  static bool IsBetter(ChannelStats const& a, ChannelStats const& b);
+  void Evict(std::size_t index);
+  void CheckSlowChannels();
+
+  std::mutex mu_;
+  std::vector<ChannelStats> channels_;         // GUARDED_BY(mu_)
+  std::size_t next_ = 0;                       // GUARDED_BY(mu_)
+  std::uint64_t completions_ = 0;              // GUARDED_BY(mu_)
+  std::vector<std::size_t> evicted_;           // GUARDED_BY(mu_)
+  google::cloud::internal::DefaultPRNG rng_;  // GUARDED_BY(mu_)
+};
+
+/**
+ * Reports the start and completion of a call to a `ChannelLoadBalancer`.
+ *
+ * Calls that are never marked as `Done()` are reported as successful when the
+ * tracker is destroyed.
+ */
+class ChannelCallTracker {
+ public:
+  ChannelCallTracker() = default;
+  ChannelCallTracker(std::shared_ptr<ChannelLoadBalancer> balancer,
+                     std::size_t index);
+  ChannelCallTracker(ChannelCallTracker&&) = default;
+  ChannelCallTracker& operator=(ChannelCallTracker&&) = delete;
+  ~ChannelCallTracker();
+
+  /// Record the latency of the call, if it was not recorded already.
+  void RecordLatency();
+
+  /// Report the outcome of the call.
+  void Done(grpc::Status const& status);
+
+ private:
+  std::shared_ptr<ChannelLoadBalancer> balancer_;
+  std::size_t index_ = 0;
+  ChannelLoadBalancer::Clock::time_point start_;
+  bool latency_recorded_ = false;
+};
+
+/**
+ * Tracks a streaming read with a `ChannelCallTracker`.
+ *
+ * The latency of the call is the time to receive the first response, the long
+ * running streams would otherwise look like slow channels.
+ */
+template <typename Response>
+class TrackedClientReader : public grpc::ClientReaderInterface<Response> {
+ public:
+  TrackedClientReader(
+      std::unique_ptr<grpc::ClientReaderInterface<Response>> child,
+      ChannelCallTracker tracker)
+      : child_(std::move(child)), tracker_(std::move(tracker)) {}
+
+  void WaitForInitialMetadata() override { child_->WaitForInitialMetadata(); }
+
+  bool NextMessageSize(std::uint32_t* sz) override {
+    return child_->NextMessageSize(sz);
+  }
+
+  bool Read(Response* response) override {
+    auto const result = child_->Read(response);
+    tracker_.RecordLatency();
+    return result;
+  }
+
+  grpc::Status Finish() override {
+    auto status = child_->Finish();
+    tracker_.Done(status);
+    return status;
+  }
+
+ private:
+  std::unique_ptr<grpc::ClientReaderInterface<Response>> child_;
+  ChannelCallTracker tracker_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_CHANNEL_LOAD_BALANCER_H
@@ -0,0 +1,128 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/channel_load_balancer.h"
+#include <gmock/gmock.h>
+#include <set>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::std::chrono::milliseconds;
+
+TEST(ChannelLoadBalancerTest, RoundRobinWithoutLoad) {
+  ChannelLoadBalancer tested(4);
+  for (int round = 0; round != 3; ++round) {
+    for (std::size_t i = 0; i != 4; ++i) EXPECT_EQ(i, tested.Pick());
+  }
+}
+
+TEST(ChannelLoadBalancerTest, SingleChannel) {
+  ChannelLoadBalancer tested(1);
+  tested.OnStart(0);
+  EXPECT_EQ(0U, tested.Pick());
+  EXPECT_EQ(0U, tested.Pick());
+}
+
+TEST(ChannelLoadBalancerTest, AvoidsBusyChannels) {
+  ChannelLoadBalancer tested(2);
+  for (int i = 0; i != 10; ++i) tested.OnStart(0);
+  // The round-robin candidate is channel 0 half the time, but whenever the
+  // random alternative is channel 1 it is preferred.
+  int count = 0;
+  for (int i = 0; i != 1000; ++i) count += tested.Pick() == 1 ? 1 : 0;
+  EXPECT_LT(600, count);
+  EXPECT_EQ(10U, tested.in_flight(0));
+  tested.OnDone(0, grpc::Status::OK);
+  EXPECT_EQ(9U, tested.in_flight(0));
+}
+
+TEST(ChannelLoadBalancerTest, ConsecutiveFailuresEvict) {
+  ChannelLoadBalancer tested(3);
+  grpc::Status unavailable(grpc::StatusCode::UNAVAILABLE, "try-again");
+  grpc::Status denied(grpc::StatusCode::PERMISSION_DENIED, "uh-oh");
+  for (int i = 0; i != 2; ++i) {
+    tested.OnStart(1);
+    tested.OnDone(1, unavailable);
+  }
+  // Other errors and successes reset the count.
+  tested.OnStart(1);
+  tested.OnDone(1, denied);
+  EXPECT_TRUE(tested.TakeEvicted().empty());
+  for (int i = 0; i != 3; ++i) {
+    tested.OnStart(1);
+    tested.OnDone(1, unavailable);
+  }
+  // Evicted channels are only used when there is no alternative.
+  for (int i = 0; i != 100; ++i) EXPECT_NE(1U, tested.Pick());
+  EXPECT_THAT(tested.TakeEvicted(), ::testing::ElementsAre(1U));
+  EXPECT_TRUE(tested.TakeEvicted().empty());
+  std::set<std::size_t> picked;
+  for (int i = 0; i != 3; ++i) picked.insert(tested.Pick());
+  EXPECT_EQ(3U, picked.size());
+}
+
+TEST(ChannelLoadBalancerTest, SlowChannelsEvicted) {
+  ChannelLoadBalancer tested(4);
+  for (int i = 0; i != 64; ++i) {
+    auto const index = static_cast<std::size_t>(i % 4);
+    tested.OnStart(index);
+    tested.RecordLatency(index,
+                         index == 2 ? milliseconds(500) : milliseconds(10));
+    tested.OnDone(index, grpc::Status::OK);
+  }
+  EXPECT_EQ(milliseconds(500), tested.latency(2));
+  EXPECT_THAT(tested.TakeEvicted(), ::testing::ElementsAre(2U));
+  EXPECT_EQ(milliseconds(0), tested.latency(2));
+}
+
+TEST(ChannelLoadBalancerTest, UniformlySlowPoolNotEvicted) {
+  ChannelLoadBalancer tested(4);
+  for (int i = 0; i != 128; ++i) {
+    auto const index = static_cast<std::size_t>(i % 4);
+    tested.OnStart(index);
+    tested.RecordLatency(index, milliseconds(500 + 10 * i));
+    tested.OnDone(index, grpc::Status::OK);
+  }
+  EXPECT_TRUE(tested.TakeEvicted().empty());
+}
+
+TEST(ChannelCallTrackerTest, ReportsCall) {
+  auto balancer = std::make_shared<ChannelLoadBalancer>(2);
+  {
+    ChannelCallTracker tracker(balancer, 1);
+    EXPECT_EQ(1U, balancer->in_flight(1));
+    ChannelCallTracker moved(std::move(tracker));
+    EXPECT_EQ(1U, balancer->in_flight(1));
+    moved.Done(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again"));
+    EXPECT_EQ(0U, balancer->in_flight(1));
+  }
+  EXPECT_EQ(0U, balancer->in_flight(1));
+  {
+    ChannelCallTracker tracker(balancer, 0);
+    EXPECT_EQ(1U, balancer->in_flight(0));
+  }
+  EXPECT_EQ(0U, balancer->in_flight(0));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
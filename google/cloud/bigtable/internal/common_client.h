@@ -16,9 +16,11 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COMMON_CLIENT_H
 
 #include "google/cloud/bigtable/client_options.h"
+#include "google/cloud/bigtable/internal/channel_load_balancer.h"
 #include "google/cloud/bigtable/version.h"
 #include "google/cloud/connection_options.h"
 #include "google/cloud/internal/absl_flat_hash_map_quiet.h"
+#include "google/cloud/internal/channel_cache.h"
 #include "google/cloud/internal/random.h"
 #include "google/cloud/log.h"
 #include "google/cloud/status_or.h"
@@ -99,9 +101,13 @@ void ScheduleChannelRefresh(
  * Refactor implementation of `bigtable::{Data,Admin,InstanceAdmin}Client`.
  *
  * All the clients need to keep a collection (sometimes with a single element)
- * of channels, update the collection when needed and round-robin across the
- * channels. At least `bigtable::DataClient` needs to optimize the creation of
- * the stub objects.
+ * of channels, update the collection when needed and balance the load across
+ * the channels. At least `bigtable::DataClient` needs to optimize the creation
+ * of the stub objects.
+ *
+ * The channels are selected using a `ChannelLoadBalancer`. Calls made through
+ * `TrackedStub()` report their outcome to the balancer, which uses it to avoid
+ * busy or slow channels, and to replace the unhealthy ones.
  *
  * The class exposes the channels because they are needed for clients that
  * use more than one type of Stub.
@@ -121,7 +127,6 @@ class CommonClient {
 
   explicit CommonClient(bigtable::ClientOptions options)
       : options_(std::move(options)),
-        current_index_(0),
         background_threads_(
             google::cloud::internal::DefaultBackgroundThreads(1)),
         cq_(std::make_shared<CompletionQueue>(background_threads_->cq())),
@@ -152,14 +157,26 @@ class CommonClient {
   StubPtr Stub() {
     std::unique_lock<std::mutex> lk(mu_);
     CheckConnections(lk);
+    ReplaceEvictedChannels(lk);
     auto stub = stubs_[GetIndex()];
     return stub;
   }
 
+  /// Return the next Stub, and a tracker to report the outcome of the call.
+  std::pair<StubPtr, ChannelCallTracker> TrackedStub() {
+    std::unique_lock<std::mutex> lk(mu_);
+    CheckConnections(lk);
+    ReplaceEvictedChannels(lk);
+    auto const index = GetIndex();
+    return std::make_pair(stubs_[index],
+                          ChannelCallTracker(load_balancer_, index));
+  }
+
   /// Return the next Channel to make a call.
   ChannelPtr Channel() {
     std::unique_lock<std::mutex> lk(mu_);
     CheckConnections(lk);
+    ReplaceEvictedChannels(lk);
     auto channel = channels_[GetIndex()];
     return channel;
   }
@@ -193,7 +210,7 @@ class CommonClient {
     if (stubs_.empty()) {
       channels.swap(channels_);
       tmp.swap(stubs_);
-      current_index_ = 0;
+      load_balancer_ = std::make_shared<ChannelLoadBalancer>(stubs_.size());
     } else {
       // Some other thread created the pool and saved it in `stubs_`. The work
       // in this thread was superfluous. We release the lock while clearing the
@@ -205,15 +222,46 @@ class CommonClient {
     }
   }
 
-  ChannelPtr CreateChannel(std::size_t idx) {
+  /// Replace the channels that the load balancer considers unhealthy.
+  void ReplaceEvictedChannels(std::unique_lock<std::mutex>& lk) {
+    auto balancer = load_balancer_;
+    auto evicted = balancer->TakeEvicted();
+    if (evicted.empty()) return;
+    auto const generation = ++generation_;
+    // Release the lock while creating the channels, as in CheckConnections().
+    lk.unlock();
+    std::vector<std::pair<ChannelPtr, StubPtr>> replacements;
+    for (auto index : evicted) {
+      auto channel = CreateChannel(index, generation);
+      auto stub = Interface::NewStub(channel);
+      replacements.emplace_back(std::move(channel), std::move(stub));
+    }
+    lk.lock();
+    // The pool may have been reset while the lock was released.
+    if (balancer != load_balancer_ || stubs_.empty()) return;
+    for (std::size_t i = 0; i != evicted.size(); ++i) {
+      GCP_LOG(INFO) << "Replacing unhealthy channel " << evicted[i]
+                    << " in the connection pool";
+      channels_[evicted[i]] = std::move(replacements[i].first);
+      stubs_[evicted[i]] = std::move(replacements[i].second);
+    }
+  }
+
+  ChannelPtr CreateChannel(std::size_t idx, int generation = 0) {
     auto args = options_.channel_arguments();
     if (!options_.connection_pool_name().empty()) {
       args.SetString("cbt-c++/connection-pool-name",
                      options_.connection_pool_name());
     }
     args.SetInt("cbt-c++/connection-pool-id", static_cast<int>(idx));
-    auto res = grpc::CreateCustomChannel(Traits::Endpoint(options_),
-                                         options_.credentials(), args);
+    // gRPC shares the connections of channels with the same arguments, the
+    // replacement of a channel needs different arguments to get a new one.
+    if (generation != 0) {
+      args.SetInt("cbt-c++/connection-pool-generation", generation);
+    }
+    auto res = google::cloud::internal::CreateCustomChannel(
+        Traits::Endpoint(options_), options_.credentials(), args,
+        options_.channel_cache_enabled());
     if (options_.max_conn_refresh_period().count() == 0) {
       return res;
     }
@@ -229,22 +277,16 @@ class CommonClient {
     return result;
   }
 
-  /// Get the current index for round-robin over connections.
-  std::size_t GetIndex() {
-    std::size_t current = current_index_++;
-    // Round robin through the connections.
-    if (current_index_ >= stubs_.size()) {
-      current_index_ = 0;
-    }
-    return current;
-  }
+  /// Get the index of the connection for the next call.
+  std::size_t GetIndex() { return load_balancer_->Pick(); }
 
   std::mutex mu_;
   std::size_t num_pending_refreshes_{};
   ClientOptions options_;
   std::vector<ChannelPtr> channels_;
   std::vector<StubPtr> stubs_;
-  std::size_t current_index_;
+  std::shared_ptr<ChannelLoadBalancer> load_balancer_;
+  int generation_ = 0;
   std::unique_ptr<BackgroundThreads> background_threads_;
   // Timers, which we schedule for refreshes, need to reference the completion
   // queue. We cannot make the completion queue's underlying implementation
@@ -0,0 +1,198 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_HEDGED_CLIENT_READER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_HEDGED_CLIENT_READER_H
+
+#include "google/cloud/bigtable/hedging_policy.h"
+#include "google/cloud/bigtable/version.h"
+#include "absl/memory/memory.h"
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/sync_stream.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * A streaming read that sends a second (hedged) request if the first is slow.
+ *
+ * The wrapper starts the request using @p context, and waits for its first
+ * response on a background thread. If no response arrives within
+ * `policy->hedge_delay()` it creates a second context with @p make_context and
+ * starts an identical request. The first request to receive a response (or
+ * the end of its stream) wins, the other request is cancelled and the rest of
+ * the stream is read from the winner.
+ *
+ * Each call to @p factory picks a channel from the client's pool, and the pool
+ * prefers the channels with fewer requests in flight, so the second request
+ * (almost always) uses a different channel than the first.
+ *
+ * The wrapper does not own @p context, which must outlive it.
+ */
+template <typename Response>
+class HedgedClientReader : public grpc::ClientReaderInterface<Response> {
+ public:
+  using Reader = grpc::ClientReaderInterface<Response>;
+  using Factory = std::function<std::unique_ptr<Reader>(grpc::ClientContext*)>;
+  using ContextFactory = std::function<std::unique_ptr<grpc::ClientContext>()>;
+
+  HedgedClientReader(Factory factory, grpc::ClientContext* context,
+                     ContextFactory make_context,
+                     std::shared_ptr<HedgingPolicy> policy)
+      : factory_(std::move(factory)),
+        make_context_(std::move(make_context)),
+        policy_(std::move(policy)),
+        start_(std::chrono::steady_clock::now()),
+        deadline_(start_ + policy_->hedge_delay()) {
+    Start(attempts_[0], context);
+  }
+
+  ~HedgedClientReader() override {
+    if (finished_) return;
+    // The caller abandoned the stream without calling `Finish()`, the
+    // background threads may be blocked in `Read()`.
+    for (auto& a : attempts_) {
+      if (a.stream) a.context->TryCancel();
+    }
+    for (auto& a : attempts_) {
+      if (a.thread.joinable()) a.thread.join();
+    }
+  }
+
+  void WaitForInitialMetadata() override {
+    Race();
+    attempts_[winner_].stream->WaitForInitialMetadata();
+  }
+
+  bool NextMessageSize(std::uint32_t* sz) override {
+    Race();
+    return attempts_[winner_].stream->NextMessageSize(sz);
+  }
+
+  bool Read(Response* msg) override {
+    Race();
+    auto& w = attempts_[winner_];
+    if (!w.has_more) return false;
+    if (first_delivered_) return w.has_more = w.stream->Read(msg);
+    first_delivered_ = true;
+    msg->Swap(&w.first);
+    return true;
+  }
+
+  grpc::Status Finish() override {
+    Race();
+    finished_ = true;
+    auto status = attempts_[winner_].stream->Finish();
+    auto& loser = attempts_[1 - winner_];
+    if (loser.stream) {
+      loser.thread.join();
+      (void)loser.stream->Finish();
+    }
+    return status;
+  }
+
+ private:
+  struct Attempt {
+    std::unique_ptr<grpc::ClientContext> owned_context;
+    grpc::ClientContext* context = nullptr;
+    std::unique_ptr<Reader> stream;
+    std::thread thread;
+    Response first;
+    bool has_more = false;
+    bool ready = false;  // GUARDED_BY(mu_)
+  };
+
+  void Start(Attempt& a, grpc::ClientContext* context) {
+    a.context = context;
+    a.stream = factory_(context);
+    a.thread = std::thread([this, &a] {
+      a.has_more = a.stream->Read(&a.first);
+      std::lock_guard<std::mutex> lk(mu_);
+      a.ready = true;
+      cv_.notify_all();
+    });
+  }
+
+  bool HasResponse() const {
+    return attempts_[0].ready || attempts_[1].ready;
+  }
+
+  /// Wait until one of the attempts has a response, hedging if needed.
+  void Race() {
+    if (winner_ >= 0) return;
+    std::unique_lock<std::mutex> lk(mu_);
+    if (!cv_.wait_until(lk, deadline_, [this] { return HasResponse(); })) {
+      lk.unlock();
+      auto& hedge = attempts_[1];
+      hedge.owned_context = make_context_();
+      Start(hedge, hedge.owned_context.get());
+      lk.lock();
+      cv_.wait(lk, [this] { return HasResponse(); });
+    }
+    winner_ = attempts_[0].ready ? 0 : 1;
+    lk.unlock();
+
+    auto& w = attempts_[winner_];
+    w.thread.join();
+    auto& loser = attempts_[1 - winner_];
+    if (loser.stream) loser.context->TryCancel();
+    if (w.has_more) {
+      policy_->OnLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start_));
+    }
+  }
+
+  Factory factory_;
+  ContextFactory make_context_;
+  std::shared_ptr<HedgingPolicy> policy_;
+  std::chrono::steady_clock::time_point const start_;
+  std::chrono::steady_clock::time_point const deadline_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  Attempt attempts_[2];
+  int winner_ = -1;
+  bool first_delivered_ = false;
+  bool finished_ = false;
+};
+
+/**
+ * Returns a stream created by @p factory, wrapped in a `HedgedClientReader` if
+ * @p policy is not null.
+ */
+template <typename Response>
+std::unique_ptr<grpc::ClientReaderInterface<Response>> MaybeHedge(
+    std::shared_ptr<HedgingPolicy> policy, grpc::ClientContext* context,
+    typename HedgedClientReader<Response>::Factory factory,
+    typename HedgedClientReader<Response>::ContextFactory make_context) {
+  if (!policy) return factory(context);
+  return absl::make_unique<HedgedClientReader<Response>>(
+      std::move(factory), context, std::move(make_context), std::move(policy));
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_HEDGED_CLIENT_READER_H
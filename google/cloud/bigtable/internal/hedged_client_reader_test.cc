@@ -0,0 +1,173 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/hedged_client_reader.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::bigtable::v2::ReadRowsResponse;
+using ::google::cloud::bigtable::testing::MockReadRowsReader;
+using ::testing::Return;
+using Tested = HedgedClientReader<ReadRowsResponse>;
+
+auto constexpr kMethod = "google.bigtable.v2.Bigtable.ReadRows";
+
+class TestHedgingPolicy : public HedgingPolicy {
+ public:
+  explicit TestHedgingPolicy(std::chrono::microseconds delay)
+      : delay_(delay) {}
+
+  std::unique_ptr<HedgingPolicy> clone() const override {
+    return absl::make_unique<TestHedgingPolicy>(*this);
+  }
+  std::chrono::microseconds hedge_delay() override { return delay_; }
+  void OnLatency(std::chrono::microseconds) override { ++latencies; }
+
+  int latencies = 0;
+
+ private:
+  std::chrono::microseconds delay_;
+};
+
+std::function<bool(ReadRowsResponse*)> ReturnRowKey(std::string key) {
+  return [key](ReadRowsResponse* r) {
+    r->Clear();
+    r->add_chunks()->set_row_key(key);
+    return true;
+  };
+}
+
+std::vector<std::string> ReadAll(grpc::ClientReaderInterface<ReadRowsResponse>&
+                                     stream) {
+  std::vector<std::string> keys;
+  ReadRowsResponse response;
+  while (stream.Read(&response)) {
+    for (auto const& c : response.chunks()) keys.push_back(c.row_key());
+  }
+  return keys;
+}
+
+Tested::ContextFactory MakeContext() {
+  return [] { return absl::make_unique<grpc::ClientContext>(); };
+}
+
+TEST(HedgedClientReaderTest, FastPrimary) {
+  auto policy = std::make_shared<TestHedgingPolicy>(std::chrono::seconds(30));
+  int calls = 0;
+  auto factory = [&calls](grpc::ClientContext*) {
+    ++calls;
+    auto mock = absl::make_unique<MockReadRowsReader>(kMethod);
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*mock, Read)
+        .WillOnce(ReturnRowKey("r1"))
+        .WillOnce(ReturnRowKey("r2"))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock, Finish).WillOnce(Return(grpc::Status::OK));
+    return std::unique_ptr<Tested::Reader>(std::move(mock));
+  };
+
+  grpc::ClientContext context;
+  Tested tested(factory, &context, MakeContext(), policy);
+  EXPECT_THAT(ReadAll(tested), ::testing::ElementsAre("r1", "r2"));
+  EXPECT_TRUE(tested.Finish().ok());
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(1, policy->latencies);
+}
+
+TEST(HedgedClientReaderTest, SlowPrimary) {
+  auto policy =
+      std::make_shared<TestHedgingPolicy>(std::chrono::milliseconds(1));
+  std::promise<void> release_primary;
+  auto primary_released = release_primary.get_future().share();
+  grpc::ClientContext context;
+  std::vector<grpc::ClientContext*> contexts;
+  auto factory = [&](grpc::ClientContext* c) {
+    contexts.push_back(c);
+    auto mock = absl::make_unique<MockReadRowsReader>(kMethod);
+    if (contexts.size() == 1) {
+      // The primary request is stuck until it is cancelled.
+      EXPECT_CALL(*mock, Read).WillOnce([primary_released](ReadRowsResponse*) {
+        primary_released.wait();
+        return false;
+      });
+      EXPECT_CALL(*mock, Finish)
+          .WillOnce(Return(grpc::Status(grpc::StatusCode::CANCELLED, "")));
+      return std::unique_ptr<Tested::Reader>(std::move(mock));
+    }
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*mock, Read)
+        .WillOnce(ReturnRowKey("r1"))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock, Finish).WillOnce(Return(grpc::Status::OK));
+    return std::unique_ptr<Tested::Reader>(std::move(mock));
+  };
+
+  Tested tested(factory, &context, MakeContext(), policy);
+  EXPECT_THAT(ReadAll(tested), ::testing::ElementsAre("r1"));
+  release_primary.set_value();
+  EXPECT_TRUE(tested.Finish().ok());
+  ASSERT_EQ(2U, contexts.size());
+  EXPECT_EQ(&context, contexts[0]);
+  EXPECT_NE(&context, contexts[1]);
+  EXPECT_EQ(1, policy->latencies);
+}
+
+TEST(HedgedClientReaderTest, EmptyStream) {
+  auto policy = std::make_shared<TestHedgingPolicy>(std::chrono::seconds(30));
+  auto factory = [](grpc::ClientContext*) {
+    auto mock = absl::make_unique<MockReadRowsReader>(kMethod);
+    EXPECT_CALL(*mock, Read).WillOnce(Return(false));
+    EXPECT_CALL(*mock, Finish)
+        .WillOnce(Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "")));
+    return std::unique_ptr<Tested::Reader>(std::move(mock));
+  };
+
+  grpc::ClientContext context;
+  Tested tested(factory, &context, MakeContext(), policy);
+  ReadRowsResponse response;
+  EXPECT_FALSE(tested.Read(&response));
+  EXPECT_FALSE(tested.Read(&response));
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, tested.Finish().error_code());
+  // Failed requests do not count towards the latency estimates.
+  EXPECT_EQ(0, policy->latencies);
+}
+
+TEST(HedgedClientReaderTest, MaybeHedgeDisabled) {
+  auto mock = absl::make_unique<MockReadRowsReader>(kMethod);
+  auto* expected = mock.get();
+  grpc::ClientContext context;
+  auto stream = MaybeHedge<ReadRowsResponse>(
+      nullptr, &context,
+      [&mock](grpc::ClientContext*) {
+        return std::unique_ptr<Tested::Reader>(std::move(mock));
+      },
+      MakeContext());
+  EXPECT_EQ(expected, stream.get());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
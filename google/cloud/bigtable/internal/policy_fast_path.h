@@ -0,0 +1,47 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_POLICY_FAST_PATH_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_POLICY_FAST_PATH_H
+
+#include "google/cloud/bigtable/version.h"
+#include <typeinfo>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Returns true if the built-in @p policy can skip `clone()` for the first
+ * attempt of an operation.
+ *
+ * The built-in policies are public and may be subclassed. A subclass may
+ * override `clone()` or `Setup()`, so the fast path only applies when the
+ * dynamic type of @p policy is exactly `Policy`.
+ */
+template <typename Policy, typename Base>
+bool HasFirstAttemptFastPath(Base const& policy) {
+  return typeid(policy) == typeid(Policy);
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_POLICY_FAST_PATH_H
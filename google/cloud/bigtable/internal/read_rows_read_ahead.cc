@@ -0,0 +1,143 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/read_rows_read_ahead.h"
+#include "google/cloud/internal/getenv.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+void SizeFromEnv(char const* name, std::size_t& value) {
+  auto v = google::cloud::internal::GetEnv(name);
+  if (!v) return;
+  char* end;
+  auto const n = std::strtoull(v->c_str(), &end, 10);
+  if (end == v->c_str() || *end != '\0') return;
+  value = static_cast<std::size_t>(n);
+}
+
+}  // namespace
+
+ReadAheadOptions ReadAheadOptionsFromEnv() {
+  ReadAheadOptions options;
+  SizeFromEnv("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_MESSAGES",
+              options.max_messages);
+  SizeFromEnv("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_BYTES", options.max_bytes);
+  return options;
+}
+
+std::unique_ptr<
+    grpc::ClientReaderInterface<google::bigtable::v2::ReadRowsResponse>>
+MaybeReadAhead(
+    std::unique_ptr<
+        grpc::ClientReaderInterface<google::bigtable::v2::ReadRowsResponse>>
+        stream,
+    grpc::ClientContext* context, ReadAheadOptions const& options) {
+  if (options.max_messages == 0) return stream;
+  return absl::make_unique<ReadRowsReadAhead>(
+      std::move(stream), context, options.max_messages, options.max_bytes);
+}
+
+ReadRowsReadAhead::ReadRowsReadAhead(
+    std::unique_ptr<grpc::ClientReaderInterface<Response>> child,
+    grpc::ClientContext* context, std::size_t max_messages,
+    std::size_t max_bytes)
+    : child_(std::move(child)),
+      context_(context),
+      max_messages_((std::max)(max_messages, std::size_t{1})),
+      max_bytes_(max_bytes),
+      thread_([this] { Run(); }) {}
+
+ReadRowsReadAhead::~ReadRowsReadAhead() {
+  if (!thread_.joinable()) return;
+  // The caller abandoned the stream without calling `Finish()`, the thread
+  // may be blocked in `Read()`.
+  context_->TryCancel();
+  Stop();
+}
+
+void ReadRowsReadAhead::WaitForInitialMetadata() {
+  // The background thread is already reading, the metadata is available once
+  // the first response (or the end of the stream) arrives.
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [this] { return !buffer_.empty() || done_; });
+}
+
+bool ReadRowsReadAhead::NextMessageSize(std::uint32_t* sz) {
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [this] { return !buffer_.empty() || done_; });
+  if (buffer_.empty()) return false;
+  *sz = static_cast<std::uint32_t>(buffer_.front().bytes);
+  return true;
+}
+
+bool ReadRowsReadAhead::Read(Response* msg) {
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [this] { return !buffer_.empty() || done_; });
+  if (buffer_.empty()) return false;
+  msg->Swap(&buffer_.front().message);
+  buffer_bytes_ -= buffer_.front().bytes;
+  buffer_.pop_front();
+  cv_.notify_all();
+  return true;
+}
+
+grpc::Status ReadRowsReadAhead::Finish() {
+  Stop();
+  return child_->Finish();
+}
+
+void ReadRowsReadAhead::Run() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    cv_.wait(lk, [this] {
+      return stop_ ||
+             (buffer_.size() < max_messages_ && buffer_bytes_ < max_bytes_);
+    });
+    if (stop_) break;
+    lk.unlock();
+    Response response;
+    auto const ok = child_->Read(&response);
+    lk.lock();
+    if (!ok) break;
+    auto const bytes = response.ByteSizeLong();
+    buffer_bytes_ += bytes;
+    buffer_.push_back(Buffered{std::move(response), bytes});
+    cv_.notify_all();
+  }
+  done_ = true;
+  cv_.notify_all();
+}
+
+void ReadRowsReadAhead::Stop() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,117 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_READ_ROWS_READ_AHEAD_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_READ_ROWS_READ_AHEAD_H
+
+#include "google/cloud/bigtable/version.h"
+#include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <grpcpp/grpcpp.h>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * A `ReadRows()` stream that reads ahead of its caller.
+ *
+ * A background thread reads from the wrapped stream into a buffer of up to
+ * @p max_messages responses (and, approximately, @p max_bytes bytes), so the
+ * network reads overlap with the parsing of the previous responses and with
+ * the application processing the rows.
+ *
+ * The wrapper does not own @p context, which must outlive it. It is used to
+ * cancel the stream if the wrapper is destroyed before the stream finishes.
+ * If the stream fails any buffered responses are discarded with it, and the
+ * `RowReader` retries from the last row delivered to the application.
+ */
+class ReadRowsReadAhead : public grpc::ClientReaderInterface<
+                              google::bigtable::v2::ReadRowsResponse> {
+ public:
+  using Response = google::bigtable::v2::ReadRowsResponse;
+
+  ReadRowsReadAhead(
+      std::unique_ptr<grpc::ClientReaderInterface<Response>> child,
+      grpc::ClientContext* context, std::size_t max_messages,
+      std::size_t max_bytes);
+  ~ReadRowsReadAhead() override;
+
+  void WaitForInitialMetadata() override;
+  bool NextMessageSize(std::uint32_t* sz) override;
+  bool Read(Response* msg) override;
+  grpc::Status Finish() override;
+
+ private:
+  void Run();
+  void Stop();
+
+  struct Buffered {
+    Response message;
+    std::size_t bytes;
+  };
+
+  std::unique_ptr<grpc::ClientReaderInterface<Response>> child_;
+  grpc::ClientContext* context_;
+  std::size_t const max_messages_;
+  std::size_t const max_bytes_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Buffered> buffer_;   // GUARDED_BY(mu_)
+  std::size_t buffer_bytes_ = 0;  // GUARDED_BY(mu_)
+  bool done_ = false;  // GUARDED_BY(mu_), the stream has no more messages
+  bool stop_ = false;  // GUARDED_BY(mu_), stop reading the stream
+  std::thread thread_;
+};
+
+/// Configure the read-ahead for `RowReader`.
+struct ReadAheadOptions {
+  /// The maximum number of buffered responses, 0 disables the read-ahead.
+  std::size_t max_messages = 0;
+  /// The (approximate) maximum number of buffered bytes.
+  std::size_t max_bytes = 16 * 1024 * 1024;
+};
+
+/**
+ * Returns the read-ahead configured via the environment.
+ *
+ * The read-ahead is disabled by default, it is enabled by setting
+ * `GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_MESSAGES`, and optionally
+ * `GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_BYTES`, to a positive integer.
+ */
+ReadAheadOptions ReadAheadOptionsFromEnv();
+
+/// Returns @p stream, wrapped in a `ReadRowsReadAhead` if enabled.
+std::unique_ptr<
+    grpc::ClientReaderInterface<google::bigtable::v2::ReadRowsResponse>>
+MaybeReadAhead(
+    std::unique_ptr<
+        grpc::ClientReaderInterface<google::bigtable::v2::ReadRowsResponse>>
+        stream,
+    grpc::ClientContext* context, ReadAheadOptions const& options);
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_READ_ROWS_READ_AHEAD_H
@@ -0,0 +1,182 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/read_rows_read_ahead.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "google/cloud/testing_util/scoped_environment.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <atomic>
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::bigtable::v2::ReadRowsResponse;
+using ::google::cloud::bigtable::testing::MockReadRowsReader;
+using ::google::cloud::testing_util::ScopedEnvironment;
+using ::testing::Return;
+
+auto constexpr kMethod = "google.bigtable.v2.Bigtable.ReadRows";
+
+std::function<bool(ReadRowsResponse*)> ReturnRowKey(std::string key) {
+  return [key](ReadRowsResponse* r) {
+    r->add_chunks()->set_row_key(key);
+    return true;
+  };
+}
+
+TEST(ReadRowsReadAheadTest, ReadsAll) {
+  auto mock = absl::make_unique<MockReadRowsReader>(kMethod);
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*mock, Read)
+        .WillOnce(ReturnRowKey("r1"))
+        .WillOnce(ReturnRowKey("r2"))
+        .WillOnce(ReturnRowKey("r3"))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock, Finish).WillOnce(Return(grpc::Status::OK));
+  }
+
+  grpc::ClientContext context;
+  ReadRowsReadAhead tested(std::move(mock), &context, 2, 1024);
+  std::vector<std::string> keys;
+  ReadRowsResponse response;
+  while (tested.Read(&response)) {
+    ASSERT_EQ(1, response.chunks_size());
+    keys.push_back(response.chunks(0).row_key());
+  }
+  EXPECT_THAT(keys, ::testing::ElementsAre("r1", "r2", "r3"));
+  EXPECT_FALSE(tested.Read(&response));
+  EXPECT_TRUE(tested.Finish().ok());
+}
+
+TEST(ReadRowsReadAheadTest, FinishError) {
+  auto mock = absl::make_unique<MockReadRowsReader>(kMethod);
+  EXPECT_CALL(*mock, Read).WillOnce(Return(false));
+  EXPECT_CALL(*mock, Finish)
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+
+  grpc::ClientContext context;
+  ReadRowsReadAhead tested(std::move(mock), &context, 2, 1024);
+  ReadRowsResponse response;
+  std::uint32_t size;
+  EXPECT_FALSE(tested.NextMessageSize(&size));
+  EXPECT_FALSE(tested.Read(&response));
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, tested.Finish().error_code());
+}
+
+TEST(ReadRowsReadAheadTest, BoundedBuffer) {
+  std::atomic<int> reads{0};
+  auto mock = absl::make_unique<MockReadRowsReader>(kMethod);
+  EXPECT_CALL(*mock, Read).WillRepeatedly([&reads](ReadRowsResponse* r) {
+    if (++reads > 10) return false;
+    r->add_chunks()->set_row_key("r");
+    return true;
+  });
+  EXPECT_CALL(*mock, Finish).WillOnce(Return(grpc::Status::OK));
+
+  grpc::ClientContext context;
+  ReadRowsReadAhead tested(std::move(mock), &context, 3, 1024 * 1024);
+  std::uint32_t size;
+  ASSERT_TRUE(tested.NextMessageSize(&size));
+  EXPECT_LT(0U, size);
+  // Give the background thread a chance to read too much.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_LE(reads.load(), 3);
+
+  ReadRowsResponse response;
+  int count = 0;
+  while (tested.Read(&response)) ++count;
+  EXPECT_EQ(10, count);
+  EXPECT_TRUE(tested.Finish().ok());
+}
+
+TEST(ReadRowsReadAheadTest, AbandonedAfterEnd) {
+  auto mock = absl::make_unique<MockReadRowsReader>(kMethod);
+  EXPECT_CALL(*mock, Read)
+      .WillOnce(ReturnRowKey("r1"))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*mock, Finish).Times(0);
+
+  grpc::ClientContext context;
+  auto tested = absl::make_unique<ReadRowsReadAhead>(std::move(mock),
+                                                     &context, 2, 1024);
+  tested->WaitForInitialMetadata();
+  // Destroying the wrapper without reading or finishing the stream must not
+  // block.
+  tested.reset();
+}
+
+TEST(ReadRowsReadAheadTest, MaybeReadAhead) {
+  grpc::ClientContext context;
+  auto* mock = new MockReadRowsReader(kMethod);
+  auto stream = MaybeReadAhead(MockReadRowsReader::UniquePtr(mock), &context,
+                               ReadAheadOptions{});
+  EXPECT_EQ(mock, stream.get());
+
+  ReadAheadOptions options;
+  options.max_messages = 4;
+  mock = new MockReadRowsReader(kMethod);
+  EXPECT_CALL(*mock, Read).WillOnce(Return(false));
+  EXPECT_CALL(*mock, Finish).WillOnce(Return(grpc::Status::OK));
+  stream = MaybeReadAhead(MockReadRowsReader::UniquePtr(mock), &context,
+                          options);
+  EXPECT_NE(mock, stream.get());
+  EXPECT_NE(nullptr, dynamic_cast<ReadRowsReadAhead*>(stream.get()));
+  ReadRowsResponse response;
+  EXPECT_FALSE(stream->Read(&response));
+  EXPECT_TRUE(stream->Finish().ok());
+}
+
+TEST(ReadRowsReadAheadTest, OptionsFromEnv) {
+  {
+    ScopedEnvironment messages("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_MESSAGES",
+                               absl::nullopt);
+    ScopedEnvironment bytes("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_BYTES",
+                            absl::nullopt);
+    auto const options = ReadAheadOptionsFromEnv();
+    EXPECT_EQ(0U, options.max_messages);
+    EXPECT_EQ(16 * 1024 * 1024U, options.max_bytes);
+  }
+  {
+    ScopedEnvironment messages("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_MESSAGES",
+                               "8");
+    ScopedEnvironment bytes("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_BYTES",
+                            "1024");
+    auto const options = ReadAheadOptionsFromEnv();
+    EXPECT_EQ(8U, options.max_messages);
+    EXPECT_EQ(1024U, options.max_bytes);
+  }
+  {
+    ScopedEnvironment messages("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_MESSAGES",
+                               "not-a-number");
+    ScopedEnvironment bytes("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_BYTES", "");
+    auto const options = ReadAheadOptionsFromEnv();
+    EXPECT_EQ(0U, options.max_messages);
+    EXPECT_EQ(16 * 1024 * 1024U, options.max_bytes);
+  }
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -22,6 +22,27 @@ inline namespace BIGTABLE_CLIENT_NS {
 namespace internal {
 using google::bigtable::v2::ReadRowsResponse_CellChunk;
 
+void ReadRowsVisitorAdapter::OnCell(Cell cell) {
+  if (stopped_) return;
+  if (!row_started_) {
+    visitor_.OnRowStart(cell.row_key());
+    row_started_ = true;
+  }
+  visitor_.OnCell(std::move(cell));
+}
+
+void ReadRowsVisitorAdapter::OnRowCommit(RowKeyType const& row_key) {
+  if (stopped_) return;
+  row_started_ = false;
+  stopped_ = !visitor_.OnRowCommit(row_key);
+}
+
+void ReadRowsVisitorAdapter::OnRowReset() {
+  if (stopped_ || !row_started_) return;
+  row_started_ = false;
+  visitor_.OnRowReset();
+}
+
 void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk chunk,
                                  grpc::Status& status) {
   if (end_of_stream_) {
@@ -51,13 +72,13 @@ void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk chunk,
                             "New column family must specify qualifier");
       return;
     }
-    using std::swap;
-    swap(*chunk.mutable_family_name()->mutable_value(), cell_.family);
+    cell_.family = families_.Intern(
+        std::move(*chunk.mutable_family_name()->mutable_value()));
   }
 
   if (chunk.has_qualifier()) {
-    using std::swap;
-    swap(*chunk.mutable_qualifier()->mutable_value(), cell_.column);
+    cell_.column = qualifiers_.Intern(
+        std::move(*chunk.mutable_qualifier()->mutable_value()));
   }
 
   if (cell_first_chunk_) {
@@ -86,13 +107,14 @@ void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk chunk,
 
   // Last chunk in the cell has zero for value size
   if (chunk.value_size() == 0) {
-    if (cells_.empty()) {
+    if (!row_has_cells_) {
       if (cell_.row.empty()) {
         status = grpc::Status(grpc::StatusCode::INTERNAL,
                               "Missing row key at last chunk in cell");
         return;
       }
       row_key_ = cell_.row;
+      shared_row_key_ = std::make_shared<RowKeyType>(cell_.row);
     } else {
       if (row_key_ != cell_.row) {
         status = grpc::Status(grpc::StatusCode::INTERNAL,
@@ -100,12 +122,21 @@ void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk chunk,
         return;
       }
     }
-    cells_.emplace_back(MovePartialToCell());
+    if (!visitor_) {
+      cells_.emplace_back(MovePartialToCell());
+    } else if (!chunk.reset_row()) {
+      // Do not deliver a cell that is discarded by the reset below.
+      visitor_->OnCell(MovePartialToCell());
+    }
+    row_has_cells_ = true;
     cell_first_chunk_ = true;
   }
 
   if (chunk.reset_row()) {
     cells_.clear();
+    row_has_cells_ = false;
+    if (visitor_) visitor_->OnRowReset();
+    shared_row_key_.reset();
     cell_ = {};
     if (!cell_first_chunk_) {
       status = grpc::Status(grpc::StatusCode::INTERNAL,
@@ -118,13 +149,15 @@ void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk chunk,
                             "Commit row with an unfinished cell");
       return;
     }
-    if (cells_.empty()) {
+    if (!row_has_cells_) {
       status = grpc::Status(grpc::StatusCode::INTERNAL,
                             "Commit row missing the row key");
       return;
     }
+    if (visitor_) visitor_->OnRowCommit(row_key_);
     row_ready_ = true;
     last_seen_row_key_ = row_key_;
+    shared_row_key_.reset();
     cell_.row.clear();
   }
 }
@@ -143,7 +176,7 @@ void ReadRowsParser::HandleEndOfStream(grpc::Status& status) {
     return;
   }
 
-  if (cells_.begin() != cells_.end() && !row_ready_) {
+  if (row_has_cells_ && !row_ready_) {
     status = grpc::Status(grpc::StatusCode::INTERNAL,
                           "end of stream with unfinished row");
     return;
@@ -159,6 +192,7 @@ Row ReadRowsParser::Next(grpc::Status& status) {
     return Row("", {});
   }
   row_ready_ = false;
+  row_has_cells_ = false;
 
   Row row(std::move(row_key_), std::move(cells_));
   row_key_.clear();
@@ -167,10 +201,10 @@ Row ReadRowsParser::Next(grpc::Status& status) {
 }
 
 Cell ReadRowsParser::MovePartialToCell() {
-  // The row, family, and column are explicitly copied because the
-  // ReadRows v2 may reuse them in future chunks. See the CellChunk
-  // message comments in bigtable.proto.
-  Cell cell(cell_.row, cell_.family, cell_.column, cell_.timestamp,
+  // The row, family, and column are shared because the ReadRows v2 may
+  // reuse them in future chunks. See the CellChunk message comments in
+  // bigtable.proto.
+  Cell cell(shared_row_key_, cell_.family, cell_.column, cell_.timestamp,
             std::move(cell_.value), std::move(cell_.labels));
   cell_.value.clear();
   return cell;
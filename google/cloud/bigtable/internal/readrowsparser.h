@@ -16,10 +16,13 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_READROWSPARSER_H
 
 #include "google/cloud/bigtable/cell.h"
+#include "google/cloud/bigtable/internal/string_interner.h"
+#include "google/cloud/bigtable/read_rows_visitor.h"
 #include "google/cloud/bigtable/row.h"
 #include "google/cloud/bigtable/version.h"
 #include "absl/memory/memory.h"
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <memory>
 #include <vector>
 
 namespace google {
@@ -27,6 +30,34 @@ namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
 namespace internal {
+/**
+ * Forwards the cells from streaming `ReadRowsParser` objects to a
+ * `ReadRowsVisitor`.
+ *
+ * The same adapter is shared by all the parsers created for one read,
+ * including any retries, so it can tell the visitor to discard a partial row
+ * when a stream fails in the middle of it.
+ */
+class ReadRowsVisitorAdapter {
+ public:
+  explicit ReadRowsVisitorAdapter(ReadRowsVisitor& visitor)
+      : visitor_(visitor) {}
+
+  void OnCell(Cell cell);
+  void OnRowCommit(RowKeyType const& row_key);
+
+  /// Discard the current row, a no-op if no cells have been delivered.
+  void OnRowReset();
+
+  /// True if the visitor asked to stop reading.
+  bool stopped() const { return stopped_; }
+
+ private:
+  ReadRowsVisitor& visitor_;
+  bool row_started_ = false;
+  bool stopped_ = false;
+};
+
 /**
  * Transforms a stream of chunks as returned by the ReadRows streaming
  * RPC into a sequence of rows.
@@ -48,10 +79,16 @@ namespace internal {
  * single and unique parser should be used for each stream of ReadRows
  * responses. If errors occur, an exception is thrown as documented by
  * each method and the parser object is left in an undefined state.
+ *
+ * A parser created with a `ReadRowsVisitorAdapter` is a streaming parser: it
+ * delivers each cell to the adapter as soon as it is complete, and the rows
+ * returned by `Next()` have the row key, but no cells.
  */
 class ReadRowsParser {
  public:
   ReadRowsParser() = default;
+  explicit ReadRowsParser(std::shared_ptr<ReadRowsVisitorAdapter> visitor)
+      : visitor_(std::move(visitor)) {}
 
   virtual ~ReadRowsParser() = default;
 
@@ -80,11 +117,16 @@ class ReadRowsParser {
   virtual Row Next(grpc::Status& status);
 
  private:
+  // Tables have few column families, but may use a different qualifier in each
+  // row, limit how many are kept.
+  static std::size_t constexpr kMaxInternedFamilies = 1024;
+  static std::size_t constexpr kMaxInternedQualifiers = 4096;
+
   /// Holds partially formed data until a full Row is ready.
   struct ParseCell {
     RowKeyType row;
-    std::string family;
-    ColumnQualifierType column;
+    std::shared_ptr<std::string const> family;
+    std::shared_ptr<ColumnQualifierType const> column;
     int64_t timestamp;
     CellValueType value;
     std::vector<std::string> labels;
@@ -94,23 +136,37 @@ class ReadRowsParser {
    * Moves partial results into a Cell class.
    *
    * Also helps handle string ownership correctly. The value is moved
-   * when converting to a result cell, but the key, family and column
-   * are copied, because they are possibly reused by following cells.
+   * when converting to a result cell, the row key is shared by all the cells
+   * in the row, and the family and column are shared with any other cells in
+   * the stream that use the same names.
    */
   Cell MovePartialToCell();
 
   /// Row key for the current row.
   RowKeyType row_key_;
 
+  /// Row key for the current row, shared by all its cells.
+  std::shared_ptr<RowKeyType const> shared_row_key_;
+
   /// Parsed cells of a yet unfinished row.
   std::vector<Cell> cells_;
 
+  /// If set, receives the parsed cells instead of `cells_`.
+  std::shared_ptr<ReadRowsVisitorAdapter> visitor_;
+
+  /// True if the current row has any cells, even if not kept in `cells_`.
+  bool row_has_cells_{false};
+
   /// Is the next incoming chunk the first in a cell?
   bool cell_first_chunk_{true};
 
   /// Stores partial fields.
   ParseCell cell_;
 
+  /// Deduplicate the family names and qualifiers across the stream.
+  StringInterner families_{kMaxInternedFamilies};
+  StringInterner qualifiers_{kMaxInternedQualifiers};
+
   /// Set when a row is ready.
   RowKeyType last_seen_row_key_;
 
@@ -131,6 +187,24 @@ class ReadRowsParserFactory {
     return absl::make_unique<ReadRowsParser>();
   }
 };
+
+/// Creates streaming parsers, sending all the cells to the same adapter.
+class StreamingReadRowsParserFactory : public ReadRowsParserFactory {
+ public:
+  explicit StreamingReadRowsParserFactory(
+      std::shared_ptr<ReadRowsVisitorAdapter> visitor)
+      : visitor_(std::move(visitor)) {}
+
+  std::unique_ptr<ReadRowsParser> Create() override {
+    // A new parser is created for each stream. If the previous stream failed
+    // in the middle of a row, that row is retried from the beginning.
+    visitor_->OnRowReset();
+    return absl::make_unique<ReadRowsParser>(visitor_);
+  }
+
+ private:
+  std::shared_ptr<ReadRowsVisitorAdapter> visitor_;
+};
 }  // namespace internal
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
@@ -128,6 +128,95 @@ TEST(ReadRowsParserTest, NextAfterEndOfStreamSucceeds) {
   EXPECT_FALSE(parser.HasNext());
 }
 
+TEST(ReadRowsParserTest, CellsShareRowKey) {
+  using google::protobuf::TextFormat;
+  ReadRowsParser parser;
+  std::vector<std::string> chunks = {
+      R"(
+    row_key: "RK-with-a-long-row-key-to-avoid-small-string-optimizations"
+    family_name: < value: "F">
+    qualifier: < value: "C1">
+    timestamp_micros: 42
+    value: "V1"
+    )",
+      R"(
+    qualifier: < value: "C2">
+    timestamp_micros: 42
+    value: "V2"
+    commit_row: true
+    )"};
+  grpc::Status status;
+  for (auto const& c : chunks) {
+    ReadRowsResponse_CellChunk chunk;
+    ASSERT_TRUE(TextFormat::ParseFromString(c, &chunk));
+    parser.HandleChunk(chunk, status);
+    ASSERT_TRUE(status.ok());
+  }
+  ASSERT_TRUE(parser.HasNext());
+  auto row = parser.Next(status);
+  EXPECT_TRUE(status.ok());
+  ASSERT_EQ(2U, row.cells().size());
+  auto const& c1 = row.cells()[0];
+  auto const& c2 = row.cells()[1];
+  EXPECT_EQ(row.row_key(), c1.row_key());
+  EXPECT_EQ("C1", c1.column_qualifier());
+  EXPECT_EQ("V1", c1.value());
+  EXPECT_EQ("C2", c2.column_qualifier());
+  EXPECT_EQ("V2", c2.value());
+  // Both cells refer to the same copy of the row key.
+  EXPECT_EQ(&c1.row_key(), &c2.row_key());
+
+  // Copies of a cell keep the row key after the row is gone.
+  auto copy = c2;
+  row = Row("", {});
+  EXPECT_EQ("RK-with-a-long-row-key-to-avoid-small-string-optimizations",
+            copy.row_key());
+}
+
+TEST(ReadRowsParserTest, FamiliesAndQualifiersShared) {
+  using google::protobuf::TextFormat;
+  ReadRowsParser parser;
+  std::vector<std::string> chunks = {
+      R"(
+    row_key: "RK1"
+    family_name: < value: "a-long-family-name-to-avoid-small-strings">
+    qualifier: < value: "a-long-column-name-to-avoid-small-strings">
+    timestamp_micros: 42
+    value: "V1"
+    commit_row: true
+    )",
+      R"(
+    row_key: "RK2"
+    family_name: < value: "a-long-family-name-to-avoid-small-strings">
+    qualifier: < value: "a-long-column-name-to-avoid-small-strings">
+    timestamp_micros: 42
+    value: "V2"
+    commit_row: true
+    )"};
+  std::vector<Row> rows;
+  grpc::Status status;
+  for (auto const& c : chunks) {
+    ReadRowsResponse_CellChunk chunk;
+    ASSERT_TRUE(TextFormat::ParseFromString(c, &chunk));
+    parser.HandleChunk(chunk, status);
+    ASSERT_TRUE(status.ok());
+    ASSERT_TRUE(parser.HasNext());
+    rows.push_back(parser.Next(status));
+    ASSERT_TRUE(status.ok());
+  }
+  ASSERT_EQ(1U, rows[0].cells().size());
+  ASSERT_EQ(1U, rows[1].cells().size());
+  auto const& c1 = rows[0].cells()[0];
+  auto const& c2 = rows[1].cells()[0];
+  EXPECT_EQ("RK1", c1.row_key());
+  EXPECT_EQ("RK2", c2.row_key());
+  EXPECT_EQ("a-long-family-name-to-avoid-small-strings", c2.family_name());
+  EXPECT_EQ("a-long-column-name-to-avoid-small-strings",
+            c2.column_qualifier());
+  EXPECT_EQ(&c1.family_name(), &c2.family_name());
+  EXPECT_EQ(&c1.column_qualifier(), &c2.column_qualifier());
+}
+
 TEST(ReadRowsParserTest, NextWithNoDataThrows) {
   ReadRowsParser parser;
   grpc::Status status;
@@ -139,6 +228,141 @@ TEST(ReadRowsParserTest, NextWithNoDataThrows) {
   EXPECT_FALSE(status.ok());
 }
 
+/// Record the visitor callbacks as strings, to simplify the assertions.
+class RecordingVisitor : public ReadRowsVisitor {
+ public:
+  void OnRowStart(RowKeyType const& row_key) override {
+    events.push_back("start " + std::string(row_key));
+  }
+  void OnCell(Cell cell) override {
+    events.push_back("cell " + std::string(cell.column_qualifier()) + "=" +
+                     std::string(cell.value()));
+  }
+  bool OnRowCommit(RowKeyType const& row_key) override {
+    events.push_back("commit " + std::string(row_key));
+    return std::string(row_key) != stop_at;
+  }
+  void OnRowReset() override { events.emplace_back("reset"); }
+
+  std::vector<std::string> events;
+  std::string stop_at;
+};
+
+std::vector<ReadRowsResponse_CellChunk> ParseChunks(
+    std::vector<std::string> const& chunk_strings) {
+  std::vector<ReadRowsResponse_CellChunk> chunks;
+  for (auto const& c : chunk_strings) {
+    ReadRowsResponse_CellChunk chunk;
+    EXPECT_TRUE(google::protobuf::TextFormat::ParseFromString(c, &chunk));
+    chunks.push_back(std::move(chunk));
+  }
+  return chunks;
+}
+
+TEST(ReadRowsParserTest, StreamingDeliversCells) {
+  RecordingVisitor visitor;
+  auto adapter = std::make_shared<ReadRowsVisitorAdapter>(visitor);
+  ReadRowsParser parser(adapter);
+  grpc::Status status;
+  std::vector<Row> rows;
+  for (auto& chunk : ParseChunks({
+           R"(row_key: "r1" family_name: < value: "F" >
+              qualifier: < value: "c1" > value: "v" value_size: 2)",
+           R"(value: "1")",
+           R"(qualifier: < value: "c2" > value: "v2" commit_row: true)",
+           R"(row_key: "r2" family_name: < value: "F" >
+              qualifier: < value: "c1" > value: "v3" commit_row: true)",
+       })) {
+    parser.HandleChunk(std::move(chunk), status);
+    ASSERT_TRUE(status.ok()) << status.error_message();
+    if (parser.HasNext()) rows.push_back(parser.Next(status));
+  }
+  parser.HandleEndOfStream(status);
+  ASSERT_TRUE(status.ok());
+
+  std::vector<std::string> const expected{
+      "start r1", "cell c1=v1", "cell c2=v2", "commit r1",
+      "start r2", "cell c1=v3", "commit r2"};
+  EXPECT_EQ(expected, visitor.events);
+  // The rows only signal the commits, the cells are not kept.
+  ASSERT_EQ(2U, rows.size());
+  EXPECT_EQ("r1", rows[0].row_key());
+  EXPECT_TRUE(rows[0].cells().empty());
+  EXPECT_EQ("r2", rows[1].row_key());
+  EXPECT_TRUE(rows[1].cells().empty());
+}
+
+TEST(ReadRowsParserTest, StreamingResetRow) {
+  RecordingVisitor visitor;
+  auto adapter = std::make_shared<ReadRowsVisitorAdapter>(visitor);
+  ReadRowsParser parser(adapter);
+  grpc::Status status;
+  for (auto& chunk : ParseChunks({
+           R"(row_key: "r1" family_name: < value: "F" >
+              qualifier: < value: "c1" > value: "v1")",
+           R"(reset_row: true)",
+           R"(row_key: "r1" family_name: < value: "F" >
+              qualifier: < value: "c1" > value: "v2" commit_row: true)",
+       })) {
+    parser.HandleChunk(std::move(chunk), status);
+    ASSERT_TRUE(status.ok()) << status.error_message();
+    if (parser.HasNext()) parser.Next(status);
+  }
+  parser.HandleEndOfStream(status);
+  ASSERT_TRUE(status.ok());
+
+  std::vector<std::string> const expected{"start r1", "cell c1=v1", "reset",
+                                          "start r1", "cell c1=v2",
+                                          "commit r1"};
+  EXPECT_EQ(expected, visitor.events);
+}
+
+TEST(ReadRowsParserTest, StreamingNewParserResetsPartialRow) {
+  RecordingVisitor visitor;
+  auto adapter = std::make_shared<ReadRowsVisitorAdapter>(visitor);
+  StreamingReadRowsParserFactory factory(adapter);
+  auto parser = factory.Create();
+  grpc::Status status;
+  for (auto& chunk : ParseChunks({
+           R"(row_key: "r1" family_name: < value: "F" >
+              qualifier: < value: "c1" > value: "v1")",
+       })) {
+    parser->HandleChunk(std::move(chunk), status);
+    ASSERT_TRUE(status.ok()) << status.error_message();
+  }
+  // Simulate a retry after the stream fails.
+  parser = factory.Create();
+  // Resetting again is a no-op.
+  adapter->OnRowReset();
+
+  std::vector<std::string> const expected{"start r1", "cell c1=v1", "reset"};
+  EXPECT_EQ(expected, visitor.events);
+}
+
+TEST(ReadRowsParserTest, StreamingStop) {
+  RecordingVisitor visitor;
+  visitor.stop_at = "r1";
+  auto adapter = std::make_shared<ReadRowsVisitorAdapter>(visitor);
+  ReadRowsParser parser(adapter);
+  grpc::Status status;
+  for (auto& chunk : ParseChunks({
+           R"(row_key: "r1" family_name: < value: "F" >
+              qualifier: < value: "c1" > value: "v1" commit_row: true)",
+           R"(row_key: "r2" family_name: < value: "F" >
+              qualifier: < value: "c1" > value: "v2")",
+       })) {
+    parser.HandleChunk(std::move(chunk), status);
+    ASSERT_TRUE(status.ok()) << status.error_message();
+    if (parser.HasNext()) parser.Next(status);
+  }
+  EXPECT_TRUE(adapter->stopped());
+  adapter->OnRowReset();
+
+  std::vector<std::string> const expected{"start r1", "cell c1=v1",
+                                          "commit r1"};
+  EXPECT_EQ(expected, visitor.events);
+}
+
 // **** Acceptance tests helpers ****
 // Can also be used by gtest to print Cell values
 void PrintTo(Cell const& c, std::ostream* os) {
@@ -0,0 +1,128 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/row_cache.h"
+#include <iterator>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+
+absl::optional<RowCacheKey> MakeRowCacheKey(
+    google::bigtable::v2::ReadRowsRequest const& request) {
+  if (request.rows().row_keys_size() != 1 ||
+      request.rows().row_ranges_size() != 0) {
+    return {};
+  }
+  RowCacheKey key;
+  key.row = RowCacheRow(request.table_name(), request.rows().row_keys(0));
+  // The length prefix keeps the app profile and the filter from running into
+  // each other.
+  key.variant = std::to_string(request.app_profile_id().size()) + ':' +
+                request.app_profile_id() + ':' +
+                std::to_string(request.rows_limit()) + ':' +
+                request.filter().SerializeAsString();
+  return key;
+}
+
+std::string RowCacheRow(std::string const& table_name,
+                        std::string const& row_key) {
+  return std::to_string(table_name.size()) + ':' + table_name + row_key;
+}
+
+RowCache::RowCache(std::chrono::milliseconds ttl, std::size_t max_bytes,
+                   std::function<Clock::time_point()> clock)
+    : ttl_(ttl), max_bytes_(max_bytes), clock_(std::move(clock)) {}
+
+std::shared_ptr<RowCache::Responses const> RowCache::Lookup(
+    RowCacheKey const& key) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto row = index_.find(key.row);
+  if (row == index_.end()) return nullptr;
+  auto variant = row->second.find(key.variant);
+  if (variant == row->second.end()) return nullptr;
+  auto entry = variant->second;
+  if (entry->expiration <= clock_()) {
+    EraseLocked(entry);
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, entry);
+  return entry->responses;
+}
+
+std::uint64_t RowCache::generation() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return generation_;
+}
+
+void RowCache::Insert(RowCacheKey key, std::uint64_t generation,
+                      Responses responses) {
+  std::size_t bytes = key.row.size() + key.variant.size();
+  for (auto const& r : responses) bytes += r.ByteSizeLong();
+  if (bytes > max_bytes_) return;
+  auto shared = std::make_shared<Responses const>(std::move(responses));
+
+  std::lock_guard<std::mutex> lk(mu_);
+  if (generation != generation_) return;
+  auto& variants = index_[key.row];
+  auto existing = variants.find(key.variant);
+  if (existing != variants.end()) {
+    bytes_ -= existing->second->bytes;
+    lru_.erase(existing->second);
+    variants.erase(existing);
+  }
+  auto const expiration = clock_() + ttl_;
+  lru_.push_front(Entry{key, std::move(shared), bytes, expiration});
+  variants.emplace(std::move(key.variant), lru_.begin());
+  bytes_ += bytes;
+  while (bytes_ > max_bytes_) EraseLocked(std::prev(lru_.end()));
+}
+
+void RowCache::Invalidate(std::string const& row) {
+  std::lock_guard<std::mutex> lk(mu_);
+  ++generation_;
+  auto loc = index_.find(row);
+  if (loc == index_.end()) return;
+  for (auto& kv : loc->second) {
+    bytes_ -= kv.second->bytes;
+    lru_.erase(kv.second);
+  }
+  index_.erase(loc);
+}
+
+std::size_t RowCache::bytes() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return bytes_;
+}
+
+std::size_t RowCache::size() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return lru_.size();
+}
+
+void RowCache::EraseLocked(Lru::iterator entry) {
+  bytes_ -= entry->bytes;
+  auto row = index_.find(entry->key.row);
+  row->second.erase(entry->key.variant);
+  if (row->second.empty()) index_.erase(row);
+  lru_.erase(entry);
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,119 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ROW_CACHE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ROW_CACHE_H
+
+#include "google/cloud/bigtable/version.h"
+#include "absl/types/optional.h"
+#include <google/bigtable/v2/bigtable.pb.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/// Identify a cached `ReadRows()` result.
+struct RowCacheKey {
+  /// The table name and row key, all the cached results for a row share it.
+  std::string row;
+  /// The app profile, filter, and rows limit.
+  std::string variant;
+};
+
+/**
+ * Returns the cache key for @p request.
+ *
+ * Only requests for exactly one row key can be cached, for other requests the
+ * function returns an empty optional.
+ */
+absl::optional<RowCacheKey> MakeRowCacheKey(
+    google::bigtable::v2::ReadRowsRequest const& request);
+
+/// Returns the key used to invalidate the cached results for a row.
+std::string RowCacheRow(std::string const& table_name,
+                        std::string const& row_key);
+
+/**
+ * A thread-safe cache of `ReadRows()` results, with TTL and LRU eviction.
+ *
+ * A read that misses the cache records `generation()` before sending its
+ * request, and passes it to `Insert()`. If any row was invalidated in between
+ * the result is not cached, as it may predate the mutation.
+ */
+class RowCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Responses = std::vector<google::bigtable::v2::ReadRowsResponse>;
+
+  RowCache(std::chrono::milliseconds ttl, std::size_t max_bytes,
+           std::function<Clock::time_point()> clock = Clock::now);
+
+  /// Returns the cached result for @p key, or nullptr if not present.
+  std::shared_ptr<Responses const> Lookup(RowCacheKey const& key);
+
+  /// The number of invalidations so far.
+  std::uint64_t generation() const;
+
+  /// Caches @p responses, unless the cache was invalidated after @p generation.
+  void Insert(RowCacheKey key, std::uint64_t generation, Responses responses);
+
+  /// Removes all the cached results for @p row, see `RowCacheRow()`.
+  void Invalidate(std::string const& row);
+
+  std::size_t max_bytes() const { return max_bytes_; }
+  std::size_t bytes() const;
+  std::size_t size() const;
+
+ private:
+  struct Entry {
+    RowCacheKey key;
+    std::shared_ptr<Responses const> responses;
+    std::size_t bytes;
+    Clock::time_point expiration;
+  };
+  using Lru = std::list<Entry>;
+
+  void EraseLocked(Lru::iterator entry);
+
+  std::chrono::milliseconds const ttl_;
+  std::size_t const max_bytes_;
+  std::function<Clock::time_point()> clock_;
+
+  mutable std::mutex mu_;
+  Lru lru_;  // GUARDED_BY(mu_), most recently used first
+  std::unordered_map<std::string, std::map<std::string, Lru::iterator>>
+      index_;                   // GUARDED_BY(mu_)
+  std::size_t bytes_ = 0;       // GUARDED_BY(mu_)
+  std::uint64_t generation_ = 0;  // GUARDED_BY(mu_)
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ROW_CACHE_H
@@ -0,0 +1,191 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/row_cache.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace btproto = ::google::bigtable::v2;
+using ::std::chrono::milliseconds;
+using ::std::chrono::seconds;
+using Clock = RowCache::Clock;
+
+btproto::ReadRowsRequest MakeRequest(std::string const& row_key) {
+  btproto::ReadRowsRequest request;
+  request.set_table_name("projects/p/instances/i/tables/t");
+  request.mutable_rows()->add_row_keys(row_key);
+  request.set_rows_limit(1);
+  return request;
+}
+
+RowCache::Responses MakeResponses(std::string const& value) {
+  btproto::ReadRowsResponse response;
+  auto& chunk = *response.add_chunks();
+  chunk.set_value(value);
+  chunk.set_commit_row(true);
+  return RowCache::Responses{response};
+}
+
+RowCacheKey MakeKey(std::string const& row_key) {
+  return *MakeRowCacheKey(MakeRequest(row_key));
+}
+
+class RowCacheTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<RowCache> MakeTested(std::size_t max_bytes) {
+    return absl::make_unique<RowCache>(seconds(10), max_bytes,
+                                       [this] { return now_; });
+  }
+
+  Clock::time_point now_ = Clock::time_point{} + seconds(1000);
+};
+
+TEST(MakeRowCacheKeyTest, OnlyPointReads) {
+  EXPECT_TRUE(MakeRowCacheKey(MakeRequest("r1")).has_value());
+
+  auto two_keys = MakeRequest("r1");
+  two_keys.mutable_rows()->add_row_keys("r2");
+  EXPECT_FALSE(MakeRowCacheKey(two_keys).has_value());
+
+  auto range = MakeRequest("r1");
+  range.mutable_rows()->add_row_ranges()->set_start_key_closed("r2");
+  EXPECT_FALSE(MakeRowCacheKey(range).has_value());
+
+  EXPECT_FALSE(MakeRowCacheKey(btproto::ReadRowsRequest{}).has_value());
+}
+
+TEST(MakeRowCacheKeyTest, FilterAware) {
+  auto const plain = MakeRowCacheKey(MakeRequest("r1"));
+  auto filtered_request = MakeRequest("r1");
+  filtered_request.mutable_filter()->set_cells_per_column_limit_filter(1);
+  auto const filtered = MakeRowCacheKey(filtered_request);
+  auto other_table_request = MakeRequest("r1");
+  other_table_request.set_table_name("projects/p/instances/i/tables/t2");
+  auto const other_table = MakeRowCacheKey(other_table_request);
+  ASSERT_TRUE(plain && filtered && other_table);
+
+  EXPECT_EQ(plain->row, filtered->row);
+  EXPECT_NE(plain->variant, filtered->variant);
+  EXPECT_NE(plain->row, other_table->row);
+  EXPECT_EQ(RowCacheRow(filtered_request.table_name(), "r1"), filtered->row);
+}
+
+TEST_F(RowCacheTest, InsertAndLookup) {
+  auto tested = MakeTested(1024 * 1024);
+  EXPECT_EQ(nullptr, tested->Lookup(MakeKey("r1")));
+
+  tested->Insert(MakeKey("r1"), tested->generation(), MakeResponses("v1"));
+  auto cached = tested->Lookup(MakeKey("r1"));
+  ASSERT_NE(nullptr, cached);
+  ASSERT_EQ(1U, cached->size());
+  EXPECT_EQ("v1", cached->front().chunks(0).value());
+  EXPECT_EQ(1U, tested->size());
+  EXPECT_LT(0U, tested->bytes());
+
+  // Inserting again replaces the cached value.
+  tested->Insert(MakeKey("r1"), tested->generation(), MakeResponses("v2"));
+  cached = tested->Lookup(MakeKey("r1"));
+  ASSERT_NE(nullptr, cached);
+  EXPECT_EQ("v2", cached->front().chunks(0).value());
+  EXPECT_EQ(1U, tested->size());
+}
+
+TEST_F(RowCacheTest, Expiration) {
+  auto tested = MakeTested(1024 * 1024);
+  tested->Insert(MakeKey("r1"), tested->generation(), MakeResponses("v1"));
+  now_ += seconds(9);
+  EXPECT_NE(nullptr, tested->Lookup(MakeKey("r1")));
+  now_ += seconds(1);
+  EXPECT_EQ(nullptr, tested->Lookup(MakeKey("r1")));
+  EXPECT_EQ(0U, tested->size());
+  EXPECT_EQ(0U, tested->bytes());
+}
+
+TEST_F(RowCacheTest, EvictsLeastRecentlyUsed) {
+  // Measure the size of one entry, all the test entries have the same size.
+  auto const entry_bytes = [this] {
+    auto t = MakeTested(1024 * 1024);
+    t->Insert(MakeKey("r0"), t->generation(), MakeResponses("v0"));
+    return t->bytes();
+  }();
+
+  auto tested = MakeTested(3 * entry_bytes);
+  tested->Insert(MakeKey("r1"), tested->generation(), MakeResponses("v1"));
+  tested->Insert(MakeKey("r2"), tested->generation(), MakeResponses("v2"));
+  tested->Insert(MakeKey("r3"), tested->generation(), MakeResponses("v3"));
+  EXPECT_EQ(3U, tested->size());
+
+  // Use "r1", so "r2" is the least recently used.
+  EXPECT_NE(nullptr, tested->Lookup(MakeKey("r1")));
+  tested->Insert(MakeKey("r4"), tested->generation(), MakeResponses("v4"));
+  EXPECT_EQ(3U, tested->size());
+  EXPECT_EQ(3 * entry_bytes, tested->bytes());
+  EXPECT_EQ(nullptr, tested->Lookup(MakeKey("r2")));
+  EXPECT_NE(nullptr, tested->Lookup(MakeKey("r1")));
+  EXPECT_NE(nullptr, tested->Lookup(MakeKey("r3")));
+  EXPECT_NE(nullptr, tested->Lookup(MakeKey("r4")));
+}
+
+TEST_F(RowCacheTest, SkipsLargeResults) {
+  auto tested = MakeTested(64);
+  tested->Insert(MakeKey("r1"), tested->generation(),
+                 MakeResponses(std::string(128, 'x')));
+  EXPECT_EQ(nullptr, tested->Lookup(MakeKey("r1")));
+  EXPECT_EQ(0U, tested->bytes());
+}
+
+TEST_F(RowCacheTest, InvalidateRemovesAllVariants) {
+  auto tested = MakeTested(1024 * 1024);
+  auto filtered_request = MakeRequest("r1");
+  filtered_request.mutable_filter()->set_cells_per_column_limit_filter(1);
+  auto const filtered = *MakeRowCacheKey(filtered_request);
+
+  tested->Insert(MakeKey("r1"), tested->generation(), MakeResponses("v1"));
+  tested->Insert(filtered, tested->generation(), MakeResponses("v1"));
+  tested->Insert(MakeKey("r2"), tested->generation(), MakeResponses("v2"));
+  EXPECT_EQ(3U, tested->size());
+
+  tested->Invalidate(filtered.row);
+  EXPECT_EQ(nullptr, tested->Lookup(MakeKey("r1")));
+  EXPECT_EQ(nullptr, tested->Lookup(filtered));
+  EXPECT_NE(nullptr, tested->Lookup(MakeKey("r2")));
+  EXPECT_EQ(1U, tested->size());
+}
+
+TEST_F(RowCacheTest, InsertAfterInvalidateIsIgnored) {
+  auto tested = MakeTested(1024 * 1024);
+  // A read starts, then a mutation invalidates the row before the read
+  // completes. The result of the read may predate the mutation.
+  auto const generation = tested->generation();
+  tested->Invalidate(MakeKey("r1").row);
+  tested->Insert(MakeKey("r1"), generation, MakeResponses("v1"));
+  EXPECT_EQ(nullptr, tested->Lookup(MakeKey("r1")));
+
+  tested->Insert(MakeKey("r1"), tested->generation(), MakeResponses("v1"));
+  EXPECT_NE(nullptr, tested->Lookup(MakeKey("r1")));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,81 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/sorted_row_set.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+
+SortedRowSet::SortedRowSet(RowSet row_set) {
+  auto proto = std::move(row_set).as_proto();
+  all_rows_ = proto.row_keys().empty() && proto.row_ranges().empty();
+  keys_.reserve(proto.row_keys_size());
+  for (auto& key : *proto.mutable_row_keys()) keys_.push_back(std::move(key));
+  if (!std::is_sorted(keys_.begin(), keys_.end())) {
+    std::sort(keys_.begin(), keys_.end());
+  }
+  keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+  for (auto& r : *proto.mutable_row_ranges()) {
+    RowRange range(std::move(r));
+    if (range.IsEmpty()) continue;
+    ranges_.push_back(std::move(range));
+  }
+}
+
+void SortedRowSet::TrimTo(RowKeyType const& row_key) {
+  auto const remaining = RowRange::Open(row_key, "");
+  if (all_rows_) {
+    all_rows_ = false;
+    ranges_.push_back(remaining);
+    return;
+  }
+  auto begin = keys_.begin() + static_cast<std::ptrdiff_t>(first_key_);
+  first_key_ = static_cast<std::size_t>(
+      std::upper_bound(begin, keys_.end(), row_key) - keys_.begin());
+  std::vector<RowRange> ranges;
+  for (auto const& r : ranges_) {
+    auto i = r.Intersect(remaining);
+    if (std::get<0>(i)) ranges.push_back(std::move(std::get<1>(i)));
+  }
+  ranges_ = std::move(ranges);
+}
+
+bool SortedRowSet::IsEmpty() const {
+  return !all_rows_ && row_keys_size() == 0 && ranges_.empty();
+}
+
+RowSet SortedRowSet::ToRowSet() const {
+  if (all_rows_) return RowSet();
+  // A `RowSet` with no entries means "all rows", but we want "no rows".
+  if (IsEmpty()) return RowSet(RowRange::Empty());
+  RowSet result;
+  for (auto k = keys_.begin() + static_cast<std::ptrdiff_t>(first_key_);
+       k != keys_.end(); ++k) {
+    result.Append(*k);
+  }
+  for (auto const& r : ranges_) result.Append(r);
+  return result;
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,78 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SORTED_ROW_SET_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SORTED_ROW_SET_H
+
+#include "google/cloud/bigtable/row_key.h"
+#include "google/cloud/bigtable/row_range.h"
+#include "google/cloud/bigtable/row_set.h"
+#include "google/cloud/bigtable/version.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * A `RowSet` in sorted form, cheap to trim when resuming a read.
+ *
+ * When a `ReadRows` stream fails, `RowReader` resumes it after the last row
+ * key it received. With `RowSet::Intersect()` each retry walks and copies all
+ * the row keys in the set, which is expensive for sets with hundreds of
+ * thousands of keys.
+ *
+ * This class sorts and deduplicates the row keys once. Trimming the set then
+ * requires a binary search over the remaining keys, and only the keys that
+ * remain are copied when converting back to a `RowSet`. The row ranges are
+ * trimmed one at a time, applications rarely use more than a few of them.
+ *
+ * @par Thread-safety
+ * Instances of this class are not thread-safe, they are owned by a single
+ * `RowReader`.
+ */
+class SortedRowSet {
+ public:
+  explicit SortedRowSet(RowSet row_set);
+
+  /// Remove all the keys and ranges at or before @p row_key.
+  void TrimTo(RowKeyType const& row_key);
+
+  /// Returns true if the set matches no rows, see `RowSet::IsEmpty()`.
+  bool IsEmpty() const;
+
+  /// Returns the remaining keys and ranges.
+  RowSet ToRowSet() const;
+
+  /// The number of row keys remaining in the set.
+  std::size_t row_keys_size() const { return keys_.size() - first_key_; }
+
+ private:
+  /// A set with no keys and no ranges reads all the rows.
+  bool all_rows_;
+  std::vector<RowKeyType> keys_;
+  std::size_t first_key_ = 0;
+  std::vector<RowRange> ranges_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SORTED_ROW_SET_H
@@ -0,0 +1,105 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/sorted_row_set.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+
+std::vector<std::string> Keys(RowSet const& row_set) {
+  auto const& keys = row_set.as_proto().row_keys();
+  return std::vector<std::string>(keys.begin(), keys.end());
+}
+
+TEST(SortedRowSetTest, SortsAndDeduplicatesKeys) {
+  SortedRowSet tested(RowSet("c", "a", "b", "a"));
+  EXPECT_EQ(3U, tested.row_keys_size());
+  EXPECT_FALSE(tested.IsEmpty());
+  auto row_set = tested.ToRowSet();
+  EXPECT_THAT(Keys(row_set), ElementsAre("a", "b", "c"));
+  EXPECT_EQ(0, row_set.as_proto().row_ranges_size());
+}
+
+TEST(SortedRowSetTest, TrimKeys) {
+  SortedRowSet tested(RowSet("d", "b", "a", "c", "e"));
+  tested.TrimTo("b");
+  EXPECT_THAT(Keys(tested.ToRowSet()), ElementsAre("c", "d", "e"));
+  // Keys between the existing keys work too.
+  tested.TrimTo("cc");
+  EXPECT_THAT(Keys(tested.ToRowSet()), ElementsAre("d", "e"));
+  tested.TrimTo("e");
+  EXPECT_EQ(0U, tested.row_keys_size());
+  EXPECT_TRUE(tested.IsEmpty());
+  EXPECT_TRUE(tested.ToRowSet().IsEmpty());
+}
+
+TEST(SortedRowSetTest, TrimRanges) {
+  SortedRowSet tested(RowSet(RowRange::Closed("a", "c"),
+                             RowRange::Closed("e", "g"), "d"));
+  tested.TrimTo("b");
+  auto row_set = tested.ToRowSet();
+  EXPECT_THAT(Keys(row_set), ElementsAre("d"));
+  ASSERT_EQ(2, row_set.as_proto().row_ranges_size());
+  EXPECT_EQ(RowRange::LeftOpen("b", "c"),
+            RowRange(row_set.as_proto().row_ranges(0)));
+  EXPECT_EQ(RowRange::Closed("e", "g"),
+            RowRange(row_set.as_proto().row_ranges(1)));
+
+  tested.TrimTo("f");
+  row_set = tested.ToRowSet();
+  EXPECT_TRUE(Keys(row_set).empty());
+  ASSERT_EQ(1, row_set.as_proto().row_ranges_size());
+  EXPECT_EQ(RowRange::LeftOpen("f", "g"),
+            RowRange(row_set.as_proto().row_ranges(0)));
+
+  tested.TrimTo("g");
+  EXPECT_TRUE(tested.IsEmpty());
+}
+
+TEST(SortedRowSetTest, AllRows) {
+  SortedRowSet tested(RowSet{});
+  EXPECT_FALSE(tested.IsEmpty());
+  auto row_set = tested.ToRowSet();
+  EXPECT_EQ(0, row_set.as_proto().row_keys_size());
+  EXPECT_EQ(0, row_set.as_proto().row_ranges_size());
+
+  tested.TrimTo("m");
+  EXPECT_FALSE(tested.IsEmpty());
+  row_set = tested.ToRowSet();
+  ASSERT_EQ(1, row_set.as_proto().row_ranges_size());
+  EXPECT_EQ(RowRange::Open("m", ""),
+            RowRange(row_set.as_proto().row_ranges(0)));
+}
+
+TEST(SortedRowSetTest, EmptyRanges) {
+  SortedRowSet tested(RowSet(RowRange::Empty()));
+  EXPECT_TRUE(tested.IsEmpty());
+  EXPECT_TRUE(tested.ToRowSet().IsEmpty());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
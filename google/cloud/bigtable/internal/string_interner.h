@@ -0,0 +1,65 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_STRING_INTERNER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_STRING_INTERNER_H
+
+#include "google/cloud/bigtable/version.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Deduplicates strings, returning shared, immutable copies.
+ *
+ * The `ReadRowsParser` uses one interner per stream for the column family
+ * names and qualifiers, which repeat on most rows. The cells then share a
+ * single copy of each string instead of holding their own.
+ *
+ * The interner stops adding new strings once it holds @p max_size of them, so
+ * tables with unique qualifiers in each row do not grow it without bounds.
+ * Strings that do not fit are returned in their own (unshared) copy.
+ *
+ * @par Thread-safety
+ * Instances of this class are not thread-safe, they are owned by a single
+ * parser.
+ */
+class StringInterner {
+ public:
+  explicit StringInterner(std::size_t max_size) : max_size_(max_size) {}
+
+  /// Returns the shared copy of @p value, creating it if needed.
+  std::shared_ptr<std::string const> Intern(std::string value);
+
+  /// The number of strings in the interner.
+  std::size_t size() const { return strings_.size(); }
+
+ private:
+  std::size_t max_size_;
+  std::unordered_map<std::string, std::shared_ptr<std::string const>> strings_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_STRING_INTERNER_H
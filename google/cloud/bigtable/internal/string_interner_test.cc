@@ -0,0 +1,75 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/string_interner.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+TEST(StringInternerTest, Basic) {
+  StringInterner tested(16);
+  auto a1 = tested.Intern("family-a");
+  auto b1 = tested.Intern("family-b");
+  auto a2 = tested.Intern("family-a");
+  EXPECT_EQ("family-a", *a1);
+  EXPECT_EQ("family-b", *b1);
+  EXPECT_EQ(a1.get(), a2.get());
+  EXPECT_NE(a1.get(), b1.get());
+  EXPECT_EQ(2U, tested.size());
+}
+
+TEST(StringInternerTest, Empty) {
+  StringInterner tested(16);
+  auto e1 = tested.Intern("");
+  auto e2 = tested.Intern("");
+  EXPECT_EQ("", *e1);
+  EXPECT_EQ(e1.get(), e2.get());
+}
+
+TEST(StringInternerTest, MaxSize) {
+  StringInterner tested(2);
+  auto a1 = tested.Intern("a");
+  auto b1 = tested.Intern("b");
+  auto c1 = tested.Intern("c");
+  auto c2 = tested.Intern("c");
+  EXPECT_EQ(2U, tested.size());
+  EXPECT_EQ("c", *c1);
+  EXPECT_EQ("c", *c2);
+  // Strings that do not fit are not shared.
+  EXPECT_NE(c1.get(), c2.get());
+  // The existing strings are still shared.
+  EXPECT_EQ(a1.get(), tested.Intern("a").get());
+  EXPECT_EQ(b1.get(), tested.Intern("b").get());
+}
+
+TEST(StringInternerTest, OutlivesInterner) {
+  std::shared_ptr<std::string const> s;
+  {
+    StringInterner tested(16);
+    s = tested.Intern("qualifier");
+  }
+  EXPECT_EQ("qualifier", *s);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
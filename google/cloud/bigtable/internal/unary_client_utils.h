@@ -21,6 +21,8 @@
 #include "google/cloud/bigtable/version.h"
 #include "google/cloud/grpc_error_delegate.h"
 #include "google/cloud/internal/retry_policy.h"
+#include <chrono>
+#include <string>
 #include <thread>
 
 namespace google {
@@ -152,11 +154,7 @@ struct UnaryClientUtils {
         break;
       }
       if (!rpc_policy.OnFailure(status)) {
-        std::string full_message = error_message;
-        full_message += "(" + metadata_update_policy.value() + ") ";
-        full_message += status.error_message();
-        status = grpc::Status(status.error_code(), full_message,
-                              status.error_details());
+        status = AddErrorContext(status, metadata_update_policy, error_message);
         break;
       }
       auto delay = backoff_policy.OnCompletion(status);
@@ -165,6 +163,69 @@ struct UnaryClientUtils {
     return response;
   }
 
+  /**
+   * Call a simple unary RPC with retries, cloning the policies only to retry.
+   *
+   * This implements `MakeCall()` given the prototypes of the RPC policies.
+   * Most calls succeed on the first attempt, when the policies support it that
+   * attempt uses `SetupFirstAttempt()` and the policies are only cloned if the
+   * attempt fails. The retry policy is cloned with `CloneForRetry()`, so it
+   * counts any time limits from the start of the first attempt.
+   *
+   * @tparam MemberFunction the signature of the member function.
+   * @param client the object that holds the gRPC stub.
+   * @param rpc_prototype the prototype for the policy controlling what failures
+   *     are retryable.
+   * @param backoff_prototype the prototype for the policy controlling how long
+   *     to wait before retrying.
+   * @param metadata_update_policy to keep metadata like
+   *     x-goog-request-params.
+   * @param function the pointer to the member function to call.
+   * @param request an initialized request parameter for the RPC.
+   * @param error_message include this message in any exception or error log.
+   * @return the return parameter from the RPC.
+   */
+  template <typename MemberFunction>
+  static typename Signature<MemberFunction>::ResponseType
+  MakeCallFromPrototypes(
+      ClientType& client, bigtable::RPCRetryPolicy const& rpc_prototype,
+      bigtable::RPCBackoffPolicy const& backoff_prototype,
+      bigtable::MetadataUpdatePolicy const& metadata_update_policy,
+      MemberFunction function,
+      typename Signature<MemberFunction>::RequestType const& request,
+      char const* error_message, grpc::Status& status,
+      google::cloud::internal::Idempotency idempotency) {
+    auto const start = std::chrono::system_clock::now();
+    typename Signature<MemberFunction>::ResponseType response;
+    {
+      grpc::ClientContext client_context;
+      if (!rpc_prototype.SetupFirstAttempt(client_context) ||
+          !backoff_prototype.SetupFirstAttempt(client_context)) {
+        return MakeCall(client, rpc_prototype.clone(),
+                        backoff_prototype.clone(), metadata_update_policy,
+                        function, request, error_message, status, idempotency);
+      }
+      metadata_update_policy.Setup(client_context);
+      status = (client.*function)(&client_context, request, &response);
+    }
+    if (status.ok()) return response;
+
+    auto rpc_policy = rpc_prototype.CloneForRetry(start);
+    auto backoff_policy = backoff_prototype.clone();
+    if (!rpc_policy->OnFailure(status)) {
+      status = AddErrorContext(status, metadata_update_policy, error_message);
+      return response;
+    }
+    auto delay = backoff_policy->OnCompletion(status);
+    std::this_thread::sleep_for(delay);
+    if (idempotency != google::cloud::internal::Idempotency::kIdempotent) {
+      return response;
+    }
+    return MakeCall(client, *rpc_policy, *backoff_policy,
+                    metadata_update_policy, function, request, error_message,
+                    status, idempotency);
+  }
+
   /**
    * Call a simple unary RPC with no retry.
    *
@@ -201,14 +262,52 @@ struct UnaryClientUtils {
     status = (client.*function)(&client_context, request, &response);
 
     if (!status.ok()) {
-      std::string full_message = error_message;
-      full_message += "(" + metadata_update_policy.value() + ") ";
-      full_message += status.error_message();
-      status = grpc::Status(status.error_code(), full_message,
-                            status.error_details());
+      status = AddErrorContext(status, metadata_update_policy, error_message);
     }
     return response;
   }
+
+  /**
+   * Call a simple unary RPC with no retry, given the prototype of the retry
+   * policy.
+   *
+   * This implements `MakeNonIdempotentCall()`, but only clones the policy if it
+   * does not support `SetupFirstAttempt()`.
+   */
+  template <typename MemberFunction>
+  static typename Signature<MemberFunction>::ResponseType MakeNonIdempotentCall(
+      ClientType& client, bigtable::RPCRetryPolicy const& rpc_prototype,
+      bigtable::MetadataUpdatePolicy const& metadata_update_policy,
+      MemberFunction function,
+      typename Signature<MemberFunction>::RequestType const& request,
+      char const* error_message, grpc::Status& status) {
+    typename Signature<MemberFunction>::ResponseType response;
+
+    grpc::ClientContext client_context;
+    if (!rpc_prototype.SetupFirstAttempt(client_context)) {
+      rpc_prototype.clone()->Setup(client_context);
+    }
+    metadata_update_policy.Setup(client_context);
+    status = (client.*function)(&client_context, request, &response);
+
+    if (!status.ok()) {
+      status = AddErrorContext(status, metadata_update_policy, error_message);
+    }
+    return response;
+  }
+
+ private:
+  /// Include @p error_message and the metadata in the message of @p status.
+  static grpc::Status AddErrorContext(
+      grpc::Status const& status,
+      bigtable::MetadataUpdatePolicy const& metadata_update_policy,
+      char const* error_message) {
+    std::string full_message = error_message;
+    full_message += "(" + metadata_update_policy.value() + ") ";
+    full_message += status.error_message();
+    return grpc::Status(status.error_code(), full_message,
+                        status.error_details());
+  }
 };
 
 }  // namespace internal
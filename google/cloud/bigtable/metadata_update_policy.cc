@@ -15,6 +15,7 @@
 #include "google/cloud/bigtable/metadata_update_policy.h"
 #include "google/cloud/bigtable/version.h"
 #include "google/cloud/internal/api_client_header.h"
+#include <string>
 
 namespace google {
 namespace cloud {
@@ -44,8 +45,12 @@ MetadataUpdatePolicy::MetadataUpdatePolicy(
       api_client_header_(internal::ApiClientHeader()) {}
 
 void MetadataUpdatePolicy::Setup(grpc::ClientContext& context) const {
-  context.AddMetadata(std::string("x-goog-request-params"), value());
-  context.AddMetadata(std::string("x-goog-api-client"), api_client_header());
+  // Avoid allocating the keys on each call, this runs for every RPC.
+  static auto const* const kRequestParams =
+      new std::string("x-goog-request-params");
+  static auto const* const kApiClient = new std::string("x-goog-api-client");
+  context.AddMetadata(*kRequestParams, value());
+  context.AddMetadata(*kApiClient, api_client_header());
 }
 
 }  // namespace BIGTABLE_CLIENT_NS
@@ -14,7 +14,11 @@
 
 #include "google/cloud/bigtable/mutation_batcher.h"
 #include "google/cloud/bigtable/internal/client_options_defaults.h"
+#include "google/cloud/bigtable/rpc_retry_policy.h"
 #include "google/cloud/grpc_error_delegate.h"
+#include "google/cloud/instrumentation.h"
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 
 namespace google {
@@ -31,12 +35,24 @@ auto constexpr kDefaultMaxSizePerBatch =
 auto constexpr kDefaultMaxBatches = 8;
 auto constexpr kDefaultMaxOutstandingSize =
     kDefaultMaxSizePerBatch * kDefaultMaxBatches;
+auto constexpr kDefaultTargetLatency = std::chrono::milliseconds(500);
+auto constexpr kDefaultMinSizePerBatch = 64 * 1024;
+// With adaptive flow control the batch size grows by this fraction of the
+// maximum after each successful batch.
+auto constexpr kSizeIncreaseDivisor = 16;
+auto constexpr kDefaultKeyRangeRefreshPeriod = std::chrono::minutes(5);
 
 MutationBatcher::Options::Options()
     : max_mutations_per_batch(kBigtableMutationLimit),
       max_size_per_batch(kDefaultMaxSizePerBatch),
       max_batches(kDefaultMaxBatches),
-      max_outstanding_size(kDefaultMaxOutstandingSize) {}
+      max_outstanding_size(kDefaultMaxOutstandingSize),
+      adaptive_flow_control(false),
+      target_latency(kDefaultTargetLatency),
+      min_size_per_batch(kDefaultMinSizePerBatch),
+      group_by_key_range(false),
+      key_range_refresh_period(kDefaultKeyRangeRefreshPeriod),
+      merge_same_row_mutations(false) {}
 
 std::pair<future<void>, future<Status>> MutationBatcher::AsyncApply(
     CompletionQueue& cq, SingleRowMutation mut) {
@@ -44,9 +60,12 @@ std::pair<future<void>, future<Status>> MutationBatcher::AsyncApply(
   CompletionPromise completion_promise;
   auto res = std::make_pair(admission_promise.get_future(),
                             completion_promise.get_future());
-  PendingSingleRowMutation pending(std::move(mut),
-                                   std::move(completion_promise),
-                                   std::move(admission_promise));
+  PendingSingleRowMutation pending(
+      std::move(mut), std::move(completion_promise),
+      std::move(admission_promise),
+      options_.merge_same_row_mutations
+          ? table_.idempotent_mutation_policy_.get()
+          : nullptr);
   std::unique_lock<std::mutex> lk(mu_);
 
   grpc::Status mutation_status = IsValid(pending);
@@ -63,8 +82,9 @@ std::pair<future<void>, future<Status>> MutationBatcher::AsyncApply(
     return res;
   }
   ++num_requests_pending_;
+  MaybeRefreshKeyRanges(cq);
 
-  if (!CanAppendToBatch(pending)) {
+  if (!CanAppendToBatch(pending) || !memory_.TryAcquire(pending.request_size)) {
     pending_mutations_.push(std::move(pending));
     return res;
   }
@@ -79,16 +99,32 @@ std::pair<future<void>, future<Status>> MutationBatcher::AsyncApply(
 
 future<void> MutationBatcher::AsyncWaitForNoPendingRequests() {
   std::unique_lock<std::mutex> lk(mu_);
-  if (num_requests_pending_ == 0) {
+  if (num_requests_pending_ == 0 && !key_range_refresh_in_flight_) {
     return make_ready_future();
   }
   no_more_pending_promises_.emplace_back();
   return no_more_pending_promises_.back().get_future();
 }
 
+MutationBatcher::FlowControlStats MutationBatcher::flow_control_stats() {
+  std::unique_lock<std::mutex> lk(mu_);
+  FlowControlStats stats;
+  stats.max_batches = MaxBatches();
+  stats.max_size_per_batch = MaxSizePerBatch();
+  stats.outstanding_batches = num_outstanding_batches_;
+  stats.outstanding_size = outstanding_size_;
+  stats.limit_reductions = limit_reductions_;
+  stats.completed_batches = completed_batches_;
+  stats.completed_mutations = completed_mutations_;
+  stats.failed_mutations = failed_mutations_;
+  stats.completed_bytes = completed_bytes_;
+  stats.last_batch_latency = last_batch_latency_;
+  return stats;
+}
+
 MutationBatcher::PendingSingleRowMutation::PendingSingleRowMutation(
     SingleRowMutation mut_arg, CompletionPromise completion_promise,
-    AdmissionPromise admission_promise)
+    AdmissionPromise admission_promise, IdempotentMutationPolicy* policy)
     : mut(std::move(mut_arg)),
       completion_promise(std::move(completion_promise)),
       admission_promise(std::move(admission_promise)) {
@@ -97,6 +133,12 @@ MutationBatcher::PendingSingleRowMutation::PendingSingleRowMutation(
   // This operation might not be cheap, so let's cache it.
   request_size = tmp.ByteSizeLong();
   num_mutations = static_cast<std::size_t>(tmp.mutations_size());
+  idempotent =
+      policy != nullptr &&
+      std::all_of(tmp.mutations().begin(), tmp.mutations().end(),
+                  [policy](::google::bigtable::v2::Mutation const& m) {
+                    return policy->is_idempotent(m);
+                  });
   mut = SingleRowMutation(std::move(tmp));
 }
 
@@ -126,12 +168,26 @@ grpc::Status MutationBatcher::IsValid(PendingSingleRowMutation& mut) const {
   return grpc::Status();
 }
 
+std::string const& MutationBatcher::KeyRangeStart(
+    std::string const& row_key) const {
+  static auto const* const kFirstRange = new std::string;
+  auto i = std::upper_bound(key_range_boundaries_.begin(),
+                            key_range_boundaries_.end(), row_key);
+  if (i == key_range_boundaries_.begin()) return *kFirstRange;
+  return *std::prev(i);
+}
+
 bool MutationBatcher::HasSpaceFor(PendingSingleRowMutation const& mut) const {
-  return outstanding_size_ + mut.request_size <=
-             options_.max_outstanding_size &&
-         cur_batch_->requests_size + mut.request_size <=
-             options_.max_size_per_batch &&
-         cur_batch_->num_mutations + mut.num_mutations <=
+  if (outstanding_size_ + mut.request_size > options_.max_outstanding_size) {
+    return false;
+  }
+  auto i = open_batches_.find(KeyRangeStart(mut.mut.row_key()));
+  // An empty batch has space for any valid mutation, even if the adaptive
+  // flow control has reduced the batch size below the mutation size.
+  if (i == open_batches_.end()) return true;
+  auto const& batch = *i->second;
+  return batch.requests_size + mut.request_size <= MaxSizePerBatch() &&
+         batch.num_mutations + mut.num_mutations <=
              options_.max_mutations_per_batch;
 }
 
@@ -140,14 +196,115 @@ future<std::vector<FailedMutation>> MutationBatcher::AsyncBulkApplyImpl(
   return table.AsyncBulkApply(std::move(mut), cq);
 }
 
+StatusOr<std::vector<RowKeySample>> MutationBatcher::SampleRowsImpl(
+    Table& table) {
+  return table.SampleRows();
+}
+
+void MutationBatcher::MaybeRefreshKeyRanges(CompletionQueue& cq) {
+  if (!options_.group_by_key_range) return;
+  if (options_.split_point_cache) {
+    // Only copy the split points when the cache has new ones.
+    auto points = options_.split_point_cache->split_points();
+    if (points == split_points_) return;
+    key_range_boundaries_ = *points;
+    split_points_ = std::move(points);
+    return;
+  }
+  if (key_range_refresh_in_flight_) return;
+  auto const now = Clock::now();
+  if (now < next_key_range_refresh_) return;
+  key_range_refresh_in_flight_ = true;
+  next_key_range_refresh_ = now + options_.key_range_refresh_period;
+  // There is no asynchronous version of `SampleRows()`, run it in one of the
+  // completion queue threads.
+  auto table = table_;
+  cq.RunAsync([this, table](CompletionQueue& queue) mutable {
+    auto samples = SampleRowsImpl(table);
+    std::vector<std::string> boundaries;
+    if (samples) {
+      for (auto& sample : *samples) {
+        if (sample.row_key.empty()) continue;
+        boundaries.push_back(std::move(sample.row_key));
+      }
+      std::sort(boundaries.begin(), boundaries.end());
+      boundaries.erase(std::unique(boundaries.begin(), boundaries.end()),
+                       boundaries.end());
+    }
+    std::unique_lock<std::mutex> lk(mu_);
+    key_range_refresh_in_flight_ = false;
+    // On errors keep the previous boundaries until the next refresh.
+    if (samples) key_range_boundaries_ = std::move(boundaries);
+    SatisfyPromises(TryAdmit(queue), lk);  // unlocks the lock
+  });
+}
+
+std::size_t MutationBatcher::MaxBatches() const {
+  if (!options_.adaptive_flow_control) return options_.max_batches;
+  return (std::max)(std::size_t{1}, static_cast<std::size_t>(batches_limit_));
+}
+
+std::size_t MutationBatcher::MaxSizePerBatch() const {
+  if (!options_.adaptive_flow_control) return options_.max_size_per_batch;
+  return size_per_batch_limit_;
+}
+
+void MutationBatcher::AdjustLimits(Batch const& batch,
+                                   std::vector<FailedMutation> const& failed) {
+  auto const now = Clock::now();
+  auto const latency = now - batch.sent;
+  last_batch_latency_ =
+      std::chrono::duration_cast<std::chrono::microseconds>(latency);
+  if (!options_.adaptive_flow_control) return;
+
+  auto const overloaded =
+      std::any_of(failed.begin(), failed.end(), [](FailedMutation const& f) {
+        return internal::SafeGrpcRetry::IsTransientFailure(f.status()) ||
+               f.status().code() == StatusCode::kResourceExhausted;
+      });
+  auto const max_batches = static_cast<double>(options_.max_batches);
+  auto const max_size = options_.max_size_per_batch;
+  auto const min_size = (std::min)(options_.min_size_per_batch, max_size);
+  if (overloaded || latency > options_.target_latency) {
+    // Batches sent before the last reduction saw the old limits, they should
+    // not reduce the limits again.
+    if (batch.sent < last_reduction_) return;
+    last_reduction_ = now;
+    ++limit_reductions_;
+    batches_limit_ = (std::max)(1.0, batches_limit_ / 2);
+    size_per_batch_limit_ = (std::max)(min_size, size_per_batch_limit_ / 2);
+    return;
+  }
+  // Grow the number of batches by about one per round-trip, i.e., once all the
+  // outstanding batches complete.
+  batches_limit_ =
+      (std::min)(max_batches, batches_limit_ + 1.0 / batches_limit_);
+  auto const step = (std::max)(std::size_t{1}, max_size / kSizeIncreaseDivisor);
+  size_per_batch_limit_ =
+      (std::min)(max_size, (std::max)(min_size, size_per_batch_limit_ + step));
+}
+
 bool MutationBatcher::FlushIfPossible(CompletionQueue cq) {
-  if (cur_batch_->num_mutations > 0 &&
-      num_outstanding_batches_ < options_.max_batches) {
+  if (!open_batches_.empty() && num_outstanding_batches_ < MaxBatches()) {
     ++num_outstanding_batches_;
 
-    auto batch = std::make_shared<Batch>();
-    cur_batch_.swap(batch);
-    AsyncBulkApplyImpl(table_, std::move(batch->requests), cq)
+    // Send the largest batch, the others have more time to fill up.
+    auto largest = std::max_element(
+        open_batches_.begin(), open_batches_.end(),
+        [](std::pair<std::string const, std::shared_ptr<Batch>> const& a,
+           std::pair<std::string const, std::shared_ptr<Batch>> const& b) {
+          return a.second->requests_size < b.second->requests_size;
+        });
+    auto batch = std::move(largest->second);
+    open_batches_.erase(largest);
+    batch->sent = Clock::now();
+    google::cloud::internal::RecordValue(
+        "bigtable.mutation_batcher.batch_size",
+        static_cast<std::int64_t>(batch->num_mutations));
+    BulkMutation requests;
+    for (auto& r : batch->requests) requests.emplace_back(std::move(r));
+    batch->requests.clear();
+    AsyncBulkApplyImpl(table_, std::move(requests), cq)
         .then([this, cq,
                batch](future<std::vector<FailedMutation>> failed) mutable {
           // Calling OnBulkApplyDone here might lead to a deadlock if the
@@ -178,6 +335,7 @@ void MutationBatcher::OnBulkApplyDone(
     std::vector<FailedMutation> const& failed) {
   // First process all the failures, marking the mutations as done after
   // processing them.
+  std::size_t failed_requests = 0;
   for (auto const& f : failed) {
     int const idx = f.original_index();
     if (idx < 0 ||
@@ -190,21 +348,28 @@ void MutationBatcher::OnBulkApplyDone(
       google::cloud::internal::ThrowRuntimeError(std::move(os).str());
     }
     MutationData& data = batch.mutation_data[idx];
-    data.completion_promise.set_value(f.status());
+    for (auto& p : data.completion_promises) p.set_value(f.status());
+    failed_requests += data.completion_promises.size();
     data.done = true;
   }
   // Any remaining mutations are treated as successful.
   for (auto& data : batch.mutation_data) {
     if (!data.done) {
-      data.completion_promise.set_value(Status());
+      for (auto& p : data.completion_promises) p.set_value(Status());
       data.done = true;
     }
   }
-  auto const num_mutations = batch.mutation_data.size();
+  auto const num_mutations = batch.num_requests;
   batch.mutation_data.clear();
 
   std::unique_lock<std::mutex> lk(mu_);
+  AdjustLimits(batch, failed);
+  ++completed_batches_;
+  completed_mutations_ += num_mutations;
+  failed_mutations_ += failed_requests;
+  completed_bytes_ += batch.requests_size;
   outstanding_size_ -= batch.requests_size;
+  memory_.Release(batch.requests_size);
   num_requests_pending_ -= num_mutations;
   num_outstanding_batches_--;
   SatisfyPromises(TryAdmit(cq), lk);  // unlocks the lock
@@ -217,7 +382,8 @@ std::vector<MutationBatcher::AdmissionPromise> MutationBatcher::TryAdmit(
 
   do {
     while (!pending_mutations_.empty() &&
-           HasSpaceFor(pending_mutations_.front())) {
+           HasSpaceFor(pending_mutations_.front()) &&
+           memory_.TryAcquire(pending_mutations_.front().request_size)) {
       auto& mut = pending_mutations_.front();
       admission_promises.emplace_back(std::move(mut.admission_promise));
       Admit(std::move(mut));
@@ -228,18 +394,41 @@ std::vector<MutationBatcher::AdmissionPromise> MutationBatcher::TryAdmit(
 }
 
 void MutationBatcher::Admit(PendingSingleRowMutation mut) {
+  auto& batch = open_batches_[KeyRangeStart(mut.mut.row_key())];
+  if (!batch) batch = std::make_shared<Batch>();
   outstanding_size_ += mut.request_size;
-  cur_batch_->requests_size += mut.request_size;
-  cur_batch_->num_mutations += mut.num_mutations;
-  cur_batch_->requests.emplace_back(std::move(mut.mut));
-  cur_batch_->mutation_data.emplace_back(MutationData(std::move(mut)));
+  batch->requests_size += mut.request_size;
+  batch->num_mutations += mut.num_mutations;
+  ++batch->num_requests;
+  if (options_.merge_same_row_mutations) {
+    auto ins =
+        batch->row_entries.emplace(mut.mut.row_key(), batch->requests.size());
+    auto const index = ins.first->second;
+    if (!ins.second &&
+        batch->mutation_data[index].idempotent == mut.idempotent) {
+      ::google::bigtable::v2::MutateRowsRequest::Entry entry;
+      mut.mut.MoveTo(&entry);
+      auto& merged = batch->requests[index];
+      for (auto& m : *entry.mutable_mutations()) {
+        merged.emplace_back(Mutation{std::move(m)});
+      }
+      batch->mutation_data[index].completion_promises.push_back(
+          std::move(mut.completion_promise));
+      return;
+    }
+    // Later mutations for this row are merged into the new entry.
+    ins.first->second = batch->requests.size();
+  }
+  batch->requests.emplace_back(std::move(mut.mut));
+  batch->mutation_data.emplace_back(MutationData(std::move(mut)));
 }
 
 void MutationBatcher::SatisfyPromises(
     std::vector<AdmissionPromise> admission_promises,
     std::unique_lock<std::mutex>& lk) {
   std::vector<NoMorePendingPromise> no_more_pending_promises;
-  if (num_requests_pending_ == 0 && num_outstanding_batches_ == 0) {
+  if (num_requests_pending_ == 0 && num_outstanding_batches_ == 0 &&
+      !key_range_refresh_in_flight_) {
     // We should wait not only on num_requests_pending_ being zero but also on
     // num_outstanding_batches_ because we want to allow the user to kill the
     // completion queue after this promise is fulfilled. Otherwise, the user can
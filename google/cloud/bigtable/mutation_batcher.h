@@ -17,16 +17,26 @@
 
 #include "google/cloud/bigtable/client_options.h"
 #include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/idempotent_mutation_policy.h"
 #include "google/cloud/bigtable/mutations.h"
+#include "google/cloud/bigtable/row_key_sample.h"
+#include "google/cloud/bigtable/split_point_cache.h"
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/bigtable/version.h"
+#include "google/cloud/memory_budget.h"
 #include "google/cloud/status.h"
 #include "absl/memory/memory.h"
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <chrono>
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <map>
 #include <memory>
 #include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -43,7 +53,9 @@ inline namespace BIGTABLE_CLIENT_NS {
  * `SingleRowMutations` and maintain multiple batches "in flight".
  *
  * This class also offers an easy-to-use flow control mechanism to avoid
- * unbounded growth in its internal buffers.
+ * unbounded growth in its internal buffers. Optionally, the flow control can
+ * adapt the number of concurrent batches and their size to the observed
+ * latency and failures, see `Options::SetAdaptiveFlowControl()`.
  *
  * Applications must provide a `CompletionQueue` to (asynchronously) execute
  * these operations. The application is responsible of executing the
@@ -83,19 +95,149 @@ class MutationBatcher {
       return *this;
     }
 
+    /**
+     * Adapt the number of outstanding batches and their size to the load.
+     *
+     * When enabled, `max_batches` and `max_size_per_batch` become upper
+     * bounds. The limits in effect are halved when a batch takes longer than
+     * the target latency, or when some of its mutations fail with a
+     * retryable error. They grow again, additively, while the batches
+     * complete on time. At most one reduction happens per round-trip, that
+     * is, batches sent before the last reduction do not trigger another one.
+     */
+    Options& SetAdaptiveFlowControl(bool adaptive_flow_control_arg) {
+      adaptive_flow_control = adaptive_flow_control_arg;
+      return *this;
+    }
+
+    /// Batches taking longer than this trigger a reduction of the limits.
+    Options& SetTargetLatency(std::chrono::milliseconds target_latency_arg) {
+      target_latency = target_latency_arg;
+      return *this;
+    }
+
+    /// The adaptive flow control will not make batches smaller than this.
+    Options& SetMinSizePerBatch(size_t min_size_per_batch_arg) {
+      min_size_per_batch = min_size_per_batch_arg;
+      return *this;
+    }
+
+    /**
+     * Group the mutations waiting for a batch by row key range.
+     *
+     * By default batches contain mutations in arrival order, and thus each
+     * batch may touch many tablets; one slow tablet delays the whole batch.
+     * When enabled, the mutations are placed in separate batches for each
+     * range between the row keys returned by `Table::SampleRows()`, which
+     * are refreshed periodically. Mutations only accumulate while all the
+     * batches are outstanding, so this has no effect on lightly loaded
+     * batchers.
+     */
+    Options& SetGroupByKeyRange(bool group_by_key_range_arg) {
+      group_by_key_range = group_by_key_range_arg;
+      return *this;
+    }
+
+    /// How often the row key ranges used to group mutations are refreshed.
+    Options& SetKeyRangeRefreshPeriod(
+        std::chrono::seconds key_range_refresh_period_arg) {
+      key_range_refresh_period = key_range_refresh_period_arg;
+      return *this;
+    }
+
+    /**
+     * Take the row key ranges used to group mutations from @p cache.
+     *
+     * By default each batcher calls `Table::SampleRows()` on its own. With a
+     * `SplitPointCache` shared by several batchers (and readers), the ranges
+     * are updated whenever the cache refreshes, and
+     * `key_range_refresh_period` is ignored.
+     */
+    Options& SetSplitPointCache(std::shared_ptr<SplitPointCache> cache) {
+      split_point_cache = std::move(cache);
+      return *this;
+    }
+
+    /**
+     * Merge the mutations for the same row into one entry of their batch.
+     *
+     * Applications that modify the same rows many times in quick succession
+     * send one `MutateRowsRequest` entry per `SingleRowMutation` by default.
+     * When enabled, mutations for a row already present in the batch under
+     * construction are appended to that entry, in the order they were
+     * received. This reduces the number of entries, the size of the
+     * requests, and the work in the service.
+     *
+     * Mutations are only merged if the table's `IdempotentMutationPolicy`
+     * classifies them the same way, so idempotent mutations are still retried
+     * on transient failures. All the mutations merged into one entry succeed
+     * or fail together.
+     */
+    Options& SetMergeSameRowMutations(bool merge_same_row_mutations_arg) {
+      merge_same_row_mutations = merge_same_row_mutations_arg;
+      return *this;
+    }
+
+    /**
+     * Report the outstanding mutations to @p budget.
+     *
+     * The mutations are reported as the `mutation-batcher` subsystem of a
+     * client named after the table, from the time they are admitted until
+     * their batch completes. While the budget is exhausted new mutations are
+     * not admitted, as if `max_outstanding_size` had been reached.
+     */
+    Options& SetMemoryBudget(std::shared_ptr<MemoryBudget> memory_budget_arg) {
+      memory_budget = std::move(memory_budget_arg);
+      return *this;
+    }
+
     std::size_t max_mutations_per_batch;
     std::size_t max_size_per_batch;
     std::size_t max_batches;
     std::size_t max_outstanding_size;
+    bool adaptive_flow_control;
+    std::chrono::milliseconds target_latency;
+    std::size_t min_size_per_batch;
+    bool group_by_key_range;
+    std::chrono::seconds key_range_refresh_period;
+    bool merge_same_row_mutations;
+    std::shared_ptr<SplitPointCache> split_point_cache;
+    std::shared_ptr<MemoryBudget> memory_budget;
+  };
+
+  /**
+   * A snapshot of the flow control limits and the work completed so far.
+   *
+   * Applications can compute the throughput from the difference between two
+   * snapshots.
+   */
+  struct FlowControlStats {
+    /// The number of outstanding batches currently allowed.
+    std::size_t max_batches;
+    /// The size of the batches currently allowed.
+    std::size_t max_size_per_batch;
+    std::size_t outstanding_batches;
+    std::size_t outstanding_size;
+    /// The number of times the adaptive flow control reduced the limits.
+    std::uint64_t limit_reductions;
+    std::uint64_t completed_batches;
+    std::uint64_t completed_mutations;
+    std::uint64_t failed_mutations;
+    std::uint64_t completed_bytes;
+    /// The latency of the most recently completed batch.
+    std::chrono::microseconds last_batch_latency;
   };
 
   explicit MutationBatcher(Table table, Options options = Options())
       : table_(std::move(table)),
         options_(options),
+        memory_(options_.memory_budget, table_.table_name(),
+                "mutation-batcher"),
         num_outstanding_batches_(),
         outstanding_size_(),
         num_requests_pending_(),
-        cur_batch_(std::make_shared<Batch>()) {}
+        batches_limit_(static_cast<double>(options_.max_batches)),
+        size_per_batch_limit_(options_.max_size_per_batch) {}
 
   virtual ~MutationBatcher() = default;
 
@@ -162,28 +304,38 @@ class MutationBatcher {
    */
   future<void> AsyncWaitForNoPendingRequests();
 
+  /// Returns the current flow control limits and counters.
+  FlowControlStats flow_control_stats();
+
  protected:
   // Wrap calling underlying operation in a virtual function to ease testing.
   virtual future<std::vector<FailedMutation>> AsyncBulkApplyImpl(
       Table& table, BulkMutation&& mut, CompletionQueue& cq);
 
+  // Wrap sampling the row keys in a virtual function to ease testing.
+  virtual StatusOr<std::vector<RowKeySample>> SampleRowsImpl(Table& table);
+
  private:
   using CompletionPromise = promise<Status>;
   using AdmissionPromise = promise<void>;
   using NoMorePendingPromise = promise<void>;
+  using Clock = std::chrono::steady_clock;
   struct Batch;
 
   /**
    * This structure represents a single mutation before it is admitted.
    */
   struct PendingSingleRowMutation {
+    /// Classifies the mutation with @p policy, unless it is null.
     PendingSingleRowMutation(SingleRowMutation mut_arg,
                              CompletionPromise completion_promise,
-                             AdmissionPromise admission_promise);
+                             AdmissionPromise admission_promise,
+                             IdempotentMutationPolicy* policy);
 
     SingleRowMutation mut;
     size_t num_mutations;
     size_t request_size;
+    bool idempotent;
     CompletionPromise completion_promise;
     AdmissionPromise admission_promise;
   };
@@ -191,15 +343,18 @@ class MutationBatcher {
   /**
    * A mutation that has been sent to the Cloud Bigtable service.
    *
-   * We need to save the `CompletionPromise` associated with each mutation.
-   * Because only failures are reported, we need to track whether the mutation
-   * is "done", so we can simulate a success report.
+   * We need to save the `CompletionPromise` associated with each mutation,
+   * there are several if mutations for the same row were merged. Because only
+   * failures are reported, we need to track whether the mutation is "done", so
+   * we can simulate a success report.
    */
   struct MutationData {
     explicit MutationData(PendingSingleRowMutation pending)
-        : completion_promise(std::move(pending.completion_promise)),
-          done(false) {}
-    CompletionPromise completion_promise;
+        : idempotent(pending.idempotent), done(false) {
+      completion_promises.push_back(std::move(pending.completion_promise));
+    }
+    std::vector<CompletionPromise> completion_promises;
+    bool idempotent;
     bool done;
   };
 
@@ -224,21 +379,29 @@ class MutationBatcher {
 
     size_t num_mutations{};
     size_t requests_size{};
-    BulkMutation requests;
+    /// The number of `SingleRowMutation`s admitted into this batch.
+    size_t num_requests{};
+    Clock::time_point sent;
+    std::vector<SingleRowMutation> requests;
     std::vector<MutationData> mutation_data;
+    /// The last entry for each row key, used to merge mutations.
+    std::unordered_map<std::string, std::size_t> row_entries;
   };
 
+  /// Returns the start of the row key range used to group @p row_key.
+  std::string const& KeyRangeStart(std::string const& row_key) const;
+
   /// Check if a mutation doesn't exceed allowed limits.
   grpc::Status IsValid(PendingSingleRowMutation& mut) const;
 
   /**
-   * Check whether there is space for the passed mutation in the currently
-   * constructed batch.
+   * Check whether there is space for the passed mutation in the batch under
+   * construction for its row key range.
    */
   bool HasSpaceFor(PendingSingleRowMutation const& mut) const;
 
   /**
-   * Check if one can append a mutation to the currently constructed batch.
+   * Check if one can append a mutation to the batch under construction.
    * Even if there is space for the mutation, we shouldn't append mutations if
    * some other are not admitted yet.
    */
@@ -250,11 +413,24 @@ class MutationBatcher {
   }
 
   /**
-   * Send the currently constructed batch if there are not too many outstanding
-   * already. If there are no mutations in the batch, it's a noop.
+   * Send the largest batch under construction if there are not too many
+   * outstanding already. If there are no mutations to send, it's a noop.
    */
   bool FlushIfPossible(CompletionQueue cq);
 
+  /// The number of outstanding batches allowed by the flow control.
+  std::size_t MaxBatches() const;
+
+  /// The batch size allowed by the flow control.
+  std::size_t MaxSizePerBatch() const;
+
+  /// Update the adaptive flow control limits after a batch completes.
+  void AdjustLimits(Batch const& batch,
+                    std::vector<FailedMutation> const& failed);
+
+  /// Start a refresh of the row key ranges if it is enabled and due.
+  void MaybeRefreshKeyRanges(CompletionQueue& cq);
+
   /// Handle a completed batch.
   void OnBulkApplyDone(CompletionQueue cq, MutationBatcher::Batch batch,
                        std::vector<FailedMutation> const& failed);
@@ -268,7 +444,8 @@ class MutationBatcher {
   std::vector<MutationBatcher::AdmissionPromise> TryAdmit(CompletionQueue& cq);
 
   /**
-   * Append mutation `mut` to the currently constructed batch.
+   * Append mutation `mut` to the batch under construction for its row key
+   * range.
    */
   void Admit(PendingSingleRowMutation mut);
 
@@ -282,6 +459,8 @@ class MutationBatcher {
   std::mutex mu_;
   Table table_;
   Options options_;
+  /// The outstanding mutations, reported to `Options::memory_budget`.
+  MemoryAccount memory_;
 
   /// Num batches sent but not completed.
   size_t num_outstanding_batches_;
@@ -290,8 +469,31 @@ class MutationBatcher {
   // Number of uncompleted SingleRowMutations (including not admitted).
   size_t num_requests_pending_;
 
-  /// Currently constructed batch of mutations.
-  std::shared_ptr<Batch> cur_batch_;
+  /**
+   * The batches under construction, keyed by the start of their row key
+   * range. Without grouping by key range there is at most one, keyed by the
+   * empty string. Batches are removed when they are sent, so none is empty.
+   */
+  std::map<std::string, std::shared_ptr<Batch>> open_batches_;
+
+  /// The row key ranges boundaries, see `Options::SetGroupByKeyRange()`.
+  std::vector<std::string> key_range_boundaries_;
+  /// The split points `key_range_boundaries_` was copied from, if any.
+  std::shared_ptr<SplitPointCache::SplitPoints const> split_points_;
+  Clock::time_point next_key_range_refresh_;
+  bool key_range_refresh_in_flight_ = false;
+
+  /// The adaptive flow control limits, see `Options::SetAdaptiveFlowControl`.
+  double batches_limit_;
+  std::size_t size_per_batch_limit_;
+  Clock::time_point last_reduction_;
+
+  std::uint64_t limit_reductions_ = 0;
+  std::uint64_t completed_batches_ = 0;
+  std::uint64_t completed_mutations_ = 0;
+  std::uint64_t failed_mutations_ = 0;
+  std::uint64_t completed_bytes_ = 0;
+  std::chrono::microseconds last_batch_latency_{0};
 
   /**
    * These are the mutations which have not been admitted yet. If the user is
@@ -14,6 +14,7 @@
 
 #include "google/cloud/bigtable/mutation_batcher.h"
 #include "google/cloud/bigtable/testing/mock_mutate_rows_reader.h"
+#include "google/cloud/bigtable/testing/mock_sample_row_keys_reader.h"
 #include "google/cloud/bigtable/testing/table_test_fixture.h"
 #include "google/cloud/future.h"
 #include "google/cloud/internal/api_client_header.h"
@@ -23,6 +24,8 @@
 #include "google/cloud/testing_util/validate_metadata.h"
 #include <google/protobuf/util/message_differencer.h>
 #include <gmock/gmock.h>
+#include <deque>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -744,6 +747,370 @@ TEST_F(MutationBatcherTest, ApplyCompletesImmediately) {
   EXPECT_EQ(0, NumOperationsOutstanding());
 }
 
+/// A batcher where the test controls when (and how) each batch completes.
+class ManualBatcher : public MutationBatcher {
+ public:
+  ManualBatcher(Table table, Options options)
+      : MutationBatcher(std::move(table), std::move(options)) {}
+
+  std::size_t sent() const { return pending_.size(); }
+
+  /// The row keys in each batch sent.
+  std::vector<std::vector<std::string>> const& row_keys() const {
+    return row_keys_;
+  }
+
+  void SetSamples(std::vector<std::string> keys) {
+    samples_ = std::move(keys);
+  }
+
+  void SetOnSampleRows(std::function<void()> cb) {
+    on_sample_rows_ = std::move(cb);
+  }
+
+  void Complete(std::size_t index, std::vector<FailedMutation> failed = {}) {
+    pending_.at(index).set_value(std::move(failed));
+  }
+
+ protected:
+  future<std::vector<FailedMutation>> AsyncBulkApplyImpl(
+      Table&, BulkMutation&& mut, CompletionQueue&) override {
+    btproto::MutateRowsRequest request;
+    mut.MoveTo(&request);
+    std::vector<std::string> keys;
+    for (auto const& e : request.entries()) keys.push_back(e.row_key());
+    row_keys_.push_back(std::move(keys));
+    pending_.emplace_back();
+    return pending_.back().get_future();
+  }
+
+  StatusOr<std::vector<RowKeySample>> SampleRowsImpl(Table&) override {
+    if (on_sample_rows_) on_sample_rows_();
+    std::vector<RowKeySample> samples;
+    for (auto const& key : samples_) {
+      samples.push_back(RowKeySample{key, 0});
+    }
+    return samples;
+  }
+
+ private:
+  std::deque<promise<std::vector<FailedMutation>>> pending_;
+  std::vector<std::vector<std::string>> row_keys_;
+  std::vector<std::string> samples_;
+  std::function<void()> on_sample_rows_;
+};
+
+class AdaptiveMutationBatcherTest : public MutationBatcherTest {
+ protected:
+  ManualBatcher* MakeBatcher(MutationBatcher::Options options) {
+    auto* batcher = new ManualBatcher(table_, std::move(options));
+    batcher_.reset(batcher);
+    return batcher;
+  }
+
+  std::shared_ptr<MutationState> ApplyOne(std::string row) {
+    return Apply(SingleRowMutation(std::move(row),
+                                   {bt::SetCell("fam", "col", 0_ms, "baz")}));
+  }
+
+  void Complete(ManualBatcher* batcher, std::size_t index,
+                std::vector<FailedMutation> failed = {}) {
+    batcher->Complete(index, std::move(failed));
+    // RunAsync
+    cq_impl_->SimulateCompletion(true);
+  }
+};
+
+std::vector<FailedMutation> Failed(StatusCode code) {
+  return {FailedMutation(Status(code, "failed"), 0)};
+}
+
+MutationBatcher::Options AdaptiveOptions() {
+  return MutationBatcher::Options()
+      .SetMaxMutationsPerBatch(1)
+      .SetMaxSizePerBatch(2000)
+      .SetMinSizePerBatch(500)
+      .SetMaxBatches(4)
+      .SetAdaptiveFlowControl(true)
+      .SetTargetLatency(std::chrono::hours(1));
+}
+
+TEST_F(AdaptiveMutationBatcherTest, FixedLimits) {
+  auto* batcher = MakeBatcher(
+      AdaptiveOptions().SetAdaptiveFlowControl(false).SetMaxBatches(2));
+  auto s0 = ApplyOne("r0");
+  auto s1 = ApplyOne("r1");
+  EXPECT_EQ(2U, batcher->sent());
+  Complete(batcher, 0, Failed(StatusCode::kUnavailable));
+  EXPECT_TRUE(s0->completed);
+
+  auto stats = batcher->flow_control_stats();
+  EXPECT_EQ(2U, stats.max_batches);
+  EXPECT_EQ(2000U, stats.max_size_per_batch);
+  EXPECT_EQ(1U, stats.outstanding_batches);
+  EXPECT_EQ(0U, stats.limit_reductions);
+  EXPECT_EQ(1U, stats.completed_batches);
+  EXPECT_EQ(1U, stats.completed_mutations);
+  EXPECT_EQ(1U, stats.failed_mutations);
+  EXPECT_LT(0U, stats.completed_bytes);
+  Complete(batcher, 1);
+}
+
+TEST_F(AdaptiveMutationBatcherTest, MemoryBudget) {
+  auto budget = std::make_shared<MemoryBudget>(1);
+  // Another client holds the whole budget.
+  MemoryAccount other(budget, "other-client", "buffers");
+  other.Acquire(1);
+  auto* batcher = MakeBatcher(
+      AdaptiveOptions().SetAdaptiveFlowControl(false).SetMemoryBudget(budget));
+  // The first mutation is admitted because the batcher holds no memory.
+  auto s0 = ApplyOne("r0");
+  auto s1 = ApplyOne("r1");
+  EXPECT_TRUE(s0->admitted);
+  EXPECT_FALSE(s1->admitted);
+  EXPECT_EQ(1U, batcher->sent());
+  auto const usage = budget->Usage();
+  ASSERT_EQ(2U, usage.size());
+  EXPECT_EQ(table_.table_name(), usage[1].client);
+  EXPECT_EQ("mutation-batcher", usage[1].subsystem);
+
+  Complete(batcher, 0);
+  EXPECT_TRUE(s1->admitted);
+  EXPECT_EQ(2U, batcher->sent());
+  Complete(batcher, 1);
+  EXPECT_EQ(1U, budget->used_bytes());
+}
+
+TEST_F(AdaptiveMutationBatcherTest, RetryableFailuresReduceLimits) {
+  auto* batcher = MakeBatcher(AdaptiveOptions());
+  std::vector<std::shared_ptr<MutationState>> states;
+  for (auto const* row : {"r0", "r1", "r2", "r3"}) {
+    states.push_back(ApplyOne(row));
+  }
+  EXPECT_EQ(4U, batcher->sent());
+  EXPECT_EQ(4U, batcher->flow_control_stats().max_batches);
+
+  Complete(batcher, 0, Failed(StatusCode::kUnavailable));
+  auto stats = batcher->flow_control_stats();
+  EXPECT_EQ(2U, stats.max_batches);
+  EXPECT_EQ(1000U, stats.max_size_per_batch);
+  EXPECT_EQ(1U, stats.limit_reductions);
+
+  // This batch was sent before the reduction, it does not reduce the limits
+  // again.
+  Complete(batcher, 1, Failed(StatusCode::kResourceExhausted));
+  stats = batcher->flow_control_stats();
+  EXPECT_EQ(2U, stats.max_batches);
+  EXPECT_EQ(1U, stats.limit_reductions);
+
+  // Two batches are still outstanding, new mutations must wait.
+  states.push_back(ApplyOne("r4"));
+  EXPECT_EQ(4U, batcher->sent());
+  Complete(batcher, 2);
+  EXPECT_EQ(5U, batcher->sent());
+
+  // Permanent failures are not a sign of overload.
+  Complete(batcher, 3, Failed(StatusCode::kPermissionDenied));
+  Complete(batcher, 4);
+  stats = batcher->flow_control_stats();
+  EXPECT_EQ(1U, stats.limit_reductions);
+  EXPECT_EQ(5U, stats.completed_batches);
+  EXPECT_EQ(3U, stats.failed_mutations);
+  for (auto const& s : states) EXPECT_TRUE(s->completed);
+}
+
+TEST_F(AdaptiveMutationBatcherTest, LimitsRecover) {
+  auto* batcher = MakeBatcher(AdaptiveOptions());
+  ApplyOne("r0");
+  Complete(batcher, 0, Failed(StatusCode::kUnavailable));
+  ApplyOne("r1");
+  Complete(batcher, 1, Failed(StatusCode::kUnavailable));
+  auto stats = batcher->flow_control_stats();
+  EXPECT_EQ(2U, stats.limit_reductions);
+  EXPECT_EQ(1U, stats.max_batches);
+  EXPECT_EQ(500U, stats.max_size_per_batch);
+
+  // The limits grow with each successful batch, but never above the maximum.
+  std::size_t previous_batches = stats.max_batches;
+  std::size_t previous_size = stats.max_size_per_batch;
+  for (std::size_t i = 2; i != 30; ++i) {
+    ApplyOne("r" + std::to_string(i));
+    Complete(batcher, i);
+    stats = batcher->flow_control_stats();
+    EXPECT_LE(previous_batches, stats.max_batches);
+    EXPECT_LE(previous_size, stats.max_size_per_batch);
+    previous_batches = stats.max_batches;
+    previous_size = stats.max_size_per_batch;
+  }
+  EXPECT_EQ(4U, stats.max_batches);
+  EXPECT_EQ(2000U, stats.max_size_per_batch);
+}
+
+TEST_F(AdaptiveMutationBatcherTest, SlowBatchesReduceLimits) {
+  auto* batcher = MakeBatcher(
+      AdaptiveOptions().SetTargetLatency(std::chrono::milliseconds(1)));
+  ApplyOne("r0");
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  Complete(batcher, 0);
+  auto stats = batcher->flow_control_stats();
+  EXPECT_EQ(1U, stats.limit_reductions);
+  EXPECT_EQ(2U, stats.max_batches);
+  EXPECT_LE(std::chrono::milliseconds(5), stats.last_batch_latency);
+}
+
+TEST_F(AdaptiveMutationBatcherTest, LargeMutationsAreAdmitted) {
+  auto* batcher = MakeBatcher(AdaptiveOptions().SetMaxMutationsPerBatch(10));
+  ApplyOne("r0");
+  Complete(batcher, 0, Failed(StatusCode::kUnavailable));
+  EXPECT_EQ(1000U, batcher->flow_control_stats().max_size_per_batch);
+
+  // A mutation larger than the current batch size, but within the maximum,
+  // is sent in its own batch.
+  auto state = ApplyOne("r1-" + std::string(1500, 'x'));
+  EXPECT_TRUE(state->admitted);
+  EXPECT_EQ(2U, batcher->sent());
+  Complete(batcher, 1);
+  EXPECT_TRUE(state->completed);
+}
+
+TEST_F(AdaptiveMutationBatcherTest, GroupByKeyRange) {
+  auto* batcher = MakeBatcher(
+      MutationBatcher::Options().SetMaxBatches(1).SetGroupByKeyRange(true));
+  batcher->SetSamples({"m", ""});
+  ApplyOne("a0");
+  EXPECT_EQ(1U, batcher->sent());
+  // Run the key range refresh.
+  cq_impl_->SimulateCompletion(true);
+
+  std::vector<std::shared_ptr<MutationState>> states;
+  for (auto const* row : {"a1", "z1", "a2", "z2", "z3"}) {
+    states.push_back(ApplyOne(row));
+  }
+  EXPECT_EQ(1U, batcher->sent());
+  Complete(batcher, 0);
+  ASSERT_EQ(2U, batcher->sent());
+  Complete(batcher, 1);
+  ASSERT_EQ(3U, batcher->sent());
+  Complete(batcher, 2);
+  for (auto const& s : states) EXPECT_TRUE(s->completed);
+
+  using ::testing::ElementsAre;
+  EXPECT_THAT(batcher->row_keys(),
+              ElementsAre(ElementsAre("a0"), ElementsAre("z1", "z2", "z3"),
+                          ElementsAre("a1", "a2")));
+  EXPECT_EQ(batcher->AsyncWaitForNoPendingRequests().wait_for(1_ms),
+            std::future_status::ready);
+}
+
+TEST_F(AdaptiveMutationBatcherTest, GroupByKeyRangeWithSplitPointCache) {
+  EXPECT_CALL(*client_, SampleRowKeys)
+      .WillRepeatedly([](grpc::ClientContext*,
+                         btproto::SampleRowKeysRequest const&) {
+        auto reader = absl::make_unique<testing::MockSampleRowKeysReader>(
+            "google.bigtable.v2.Bigtable.SampleRowKeys");
+        EXPECT_CALL(*reader, Read)
+            .WillOnce([](btproto::SampleRowKeysResponse* r) {
+              r->set_row_key("m");
+              return true;
+            })
+            .WillOnce(::testing::Return(false));
+        EXPECT_CALL(*reader, Finish)
+            .WillOnce(::testing::Return(grpc::Status::OK));
+        return std::unique_ptr<
+            grpc::ClientReaderInterface<btproto::SampleRowKeysResponse>>(
+            std::move(reader));
+      });
+  auto cache = std::make_shared<SplitPointCache>(table_, cq_);
+  // Run the first refresh of the cache.
+  cq_impl_->SimulateCompletion(true);
+
+  auto* batcher = MakeBatcher(MutationBatcher::Options()
+                                  .SetMaxBatches(1)
+                                  .SetGroupByKeyRange(true)
+                                  .SetSplitPointCache(cache));
+  // The batcher does not sample the rows on its own.
+  batcher->SetOnSampleRows([] { FAIL() << "unexpected call to SampleRows"; });
+  std::vector<std::shared_ptr<MutationState>> states;
+  for (auto const* row : {"a0", "a1", "z1", "a2"}) {
+    states.push_back(ApplyOne(row));
+  }
+  Complete(batcher, 0);
+  Complete(batcher, 1);
+  Complete(batcher, 2);
+  for (auto const& s : states) EXPECT_TRUE(s->completed);
+
+  using ::testing::ElementsAre;
+  EXPECT_THAT(batcher->row_keys(),
+              ElementsAre(ElementsAre("a0"), ElementsAre("a1", "a2"),
+                          ElementsAre("z1")));
+}
+
+TEST_F(AdaptiveMutationBatcherTest, WaitForKeyRangeRefresh) {
+  auto* batcher =
+      MakeBatcher(MutationBatcher::Options().SetGroupByKeyRange(true));
+  promise<void> sampling;
+  auto sampling_started = sampling.get_future();
+  promise<void> release;
+  auto released = release.get_future();
+  batcher->SetOnSampleRows([&] {
+    sampling.set_value();
+    released.get();
+  });
+
+  ApplyOne("a0");
+  auto no_more_pending = batcher->AsyncWaitForNoPendingRequests();
+  // Run the key range refresh in a separate thread, it blocks until released.
+  std::thread refresh([this] { cq_impl_->SimulateCompletion(true); });
+  sampling_started.get();
+  Complete(batcher, 0);
+  // The mutation is done, but the batcher still has work in flight.
+  EXPECT_EQ(no_more_pending.wait_for(1_ms), std::future_status::timeout);
+  release.set_value();
+  refresh.join();
+  EXPECT_EQ(no_more_pending.wait_for(1_ms), std::future_status::ready);
+}
+
+TEST_F(AdaptiveMutationBatcherTest, MergeSameRowMutations) {
+  auto* batcher = MakeBatcher(MutationBatcher::Options()
+                                  .SetMaxBatches(1)
+                                  .SetMergeSameRowMutations(true));
+  ApplyOne("r0");
+  EXPECT_EQ(1U, batcher->sent());
+
+  // Mutations with an explicit timestamp are idempotent, mutations using the
+  // server time are not, they are never merged with each other.
+  auto non_idempotent = [](std::string row) {
+    return SingleRowMutation(std::move(row), {bt::SetCell("fam", "col", "v")});
+  };
+  auto s1 = ApplyOne("r1");
+  auto s2 = ApplyOne("r2");
+  auto s3 = ApplyOne("r1");
+  auto s4 = Apply(non_idempotent("r1"));
+  auto s5 = Apply(non_idempotent("r1"));
+  auto s6 = ApplyOne("r2");
+  Complete(batcher, 0);
+  ASSERT_EQ(2U, batcher->sent());
+  Complete(batcher, 1, Failed(StatusCode::kPermissionDenied));
+
+  using ::testing::ElementsAre;
+  EXPECT_THAT(batcher->row_keys(), ElementsAre(ElementsAre("r0"),
+                                               ElementsAre("r1", "r2", "r1")));
+  // The mutations merged into the failed entry fail together.
+  for (auto const& s : {s1, s3}) {
+    EXPECT_TRUE(s->completed);
+    EXPECT_EQ(StatusCode::kPermissionDenied, s->completion_status.code());
+  }
+  for (auto const& s : {s2, s4, s5, s6}) {
+    EXPECT_TRUE(s->completed);
+    EXPECT_TRUE(s->completion_status.ok());
+  }
+  auto stats = batcher->flow_control_stats();
+  EXPECT_EQ(7U, stats.completed_mutations);
+  EXPECT_EQ(2U, stats.failed_mutations);
+  EXPECT_EQ(batcher->AsyncWaitForNoPendingRequests().wait_for(1_ms),
+            std::future_status::ready);
+}
+
 }  // namespace
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
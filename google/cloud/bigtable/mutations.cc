@@ -35,8 +35,8 @@ Mutation DeleteFromRow() {
 Mutation SetCell(Cell cell) {
   Mutation m;
   auto& set_cell = *m.op.mutable_set_cell();
-  set_cell.set_family_name(std::move(cell.family_name_));
-  set_cell.set_column_qualifier(std::move(cell.column_qualifier_));
+  set_cell.set_family_name(cell.family_name());
+  set_cell.set_column_qualifier(cell.column_qualifier());
   set_cell.set_timestamp_micros(cell.timestamp_);
   set_cell.set_value(std::move(cell.value_));
   return m;
@@ -0,0 +1,390 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/parallel_scan.h"
+#include "google/cloud/bigtable/internal/google_bytes_traits.h"
+#include "google/cloud/bigtable/internal/prefix_range_end.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/// Choose up to `max_ranges - 1` split points, evenly spaced by offset.
+std::vector<RowKeyType> ChooseSplitPoints(
+    std::vector<RowKeySample> const& samples, std::size_t max_ranges) {
+  std::vector<RowKeySample const*> candidates;
+  for (auto const& s : samples) {
+    // The service uses the empty row key to represent the end of the table.
+    if (internal::IsEmptyRowKey(s.row_key)) continue;
+    if (!candidates.empty() && !(candidates.back()->row_key < s.row_key)) {
+      continue;
+    }
+    candidates.push_back(&s);
+  }
+
+  std::vector<RowKeyType> splits;
+  if (max_ranges <= 1) return splits;
+  auto const max_splits = max_ranges - 1;
+  if (candidates.size() <= max_splits) {
+    for (auto const* s : candidates) splits.push_back(s->row_key);
+    return splits;
+  }
+
+  // The last sample covers the full table, use it to compute the target size
+  // of each range.
+  auto const total = (std::max)(samples.back().offset_bytes, std::int64_t{1});
+  for (auto const* s : candidates) {
+    if (splits.size() == max_splits) break;
+    auto const next = static_cast<std::int64_t>(splits.size() + 1);
+    auto const threshold =
+        static_cast<std::int64_t>(static_cast<double>(total) * next /
+                                  static_cast<double>(max_ranges));
+    if (s->offset_bytes < threshold) continue;
+    splits.push_back(s->row_key);
+  }
+  return splits;
+}
+
+// The offset of the last sample at or before @p key.
+std::int64_t OffsetAtOrBefore(RowKeyType const& key,
+                              std::vector<RowKeySample> const& samples) {
+  std::int64_t offset = 0;
+  for (auto const& s : samples) {
+    // An empty sample key is the end of the table.
+    if (internal::IsEmptyRowKey(s.row_key) || key < s.row_key) break;
+    offset = s.offset_bytes;
+  }
+  return offset;
+}
+
+// The offset of the first sample at or after @p key, an empty @p key is the
+// end of the table.
+std::int64_t OffsetAtOrAfter(RowKeyType const& key,
+                             std::vector<RowKeySample> const& samples) {
+  if (samples.empty()) return 0;
+  if (!internal::IsEmptyRowKey(key)) {
+    for (auto const& s : samples) {
+      if (internal::IsEmptyRowKey(s.row_key) || !(s.row_key < key)) {
+        return s.offset_bytes;
+      }
+    }
+  }
+  return samples.back().offset_bytes;
+}
+
+class AsyncReadPrefixesHandler
+    : public std::enable_shared_from_this<AsyncReadPrefixesHandler> {
+ public:
+  using RowCallback = std::function<future<bool>(std::size_t, Row)>;
+
+  AsyncReadPrefixesHandler(Table table, CompletionQueue cq,
+                           std::vector<RowKeyType> prefixes, Filter filter,
+                           RowCallback on_row,
+                           ReadPrefixesOptions const& options)
+      : table_(std::move(table)),
+        cq_(std::move(cq)),
+        prefixes_(std::move(prefixes)),
+        filter_(std::move(filter)),
+        on_row_(std::move(on_row)),
+        rows_limit_(options.rows_limit_per_prefix),
+        // With a rows limit each prefix needs its own stream.
+        streams_(AssignPrefixesToStreams(
+            EstimatePrefixSizes(prefixes_, options.row_key_samples),
+            rows_limit_ > 0 ? prefixes_.size() : options.max_concurrency)) {}
+
+  future<Status> Start(std::size_t max_concurrency) {
+    auto f = promise_.get_future();
+    auto const concurrency = (std::max)(max_concurrency, std::size_t{1});
+    std::unique_lock<std::mutex> lk(mu_);
+    // Prevent the streams that complete immediately from satisfying the
+    // promise before all the initial streams start.
+    ++outstanding_;
+    for (std::size_t i = 0; i != concurrency && CanStart(); ++i) {
+      StartNext(lk);
+    }
+    --outstanding_;
+    MaybeFinish(std::move(lk));
+    return f;
+  }
+
+ private:
+  bool CanStart() const {
+    return status_.ok() && !stopped_ && next_stream_ != streams_.size();
+  }
+
+  // Start the next stream, `lk` is released while the stream starts.
+  void StartNext(std::unique_lock<std::mutex>& lk) {
+    auto const& stream = streams_[next_stream_];
+    RowSet row_set;
+    for (auto i : stream) row_set.Append(RowRange::Prefix(prefixes_[i]));
+    ++next_stream_;
+    ++outstanding_;
+    // Each stream uses its own copy, `Table` is not thread-safe.
+    auto table = table_;
+    lk.unlock();
+    auto self = shared_from_this();
+    auto on_row = [self, &stream](Row row) {
+      return self->OnRow(stream, std::move(row));
+    };
+    auto on_finish = [self](Status status) {
+      self->OnFinish(std::move(status));
+    };
+    if (rows_limit_ > 0) {
+      table.AsyncReadRows(cq_, std::move(on_row), std::move(on_finish),
+                          std::move(row_set), rows_limit_, filter_);
+    } else {
+      table.AsyncReadRows(cq_, std::move(on_row), std::move(on_finish),
+                          std::move(row_set), filter_);
+    }
+    lk.lock();
+  }
+
+  future<bool> OnRow(std::vector<std::size_t> const& stream, Row row) {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if (stopped_ || !status_.ok()) return make_ready_future(false);
+    }
+    // Overlapping prefixes in the same stream return each row once.
+    std::vector<std::size_t> matches;
+    for (auto i : stream) {
+      auto const& prefix = prefixes_[i];
+      if (row.row_key().compare(0, prefix.size(), prefix) == 0) {
+        matches.push_back(i);
+      }
+    }
+    if (matches.empty()) return make_ready_future(true);
+    return Deliver(std::move(matches), 0, std::move(row));
+  }
+
+  // Deliver @p row to the prefixes in `matches[n:]`, one at a time.
+  future<bool> Deliver(std::vector<std::size_t> matches, std::size_t n,
+                       Row row) {
+    auto self = shared_from_this();
+    if (n + 1 == matches.size()) {
+      return on_row_(matches[n], std::move(row)).then([self](future<bool> f) {
+        return self->OnDelivered(f.get());
+      });
+    }
+    auto const index = matches[n];
+    return on_row_(index, row).then(
+        [self, matches, n, row](future<bool> f) mutable -> future<bool> {
+          if (!self->OnDelivered(f.get())) return make_ready_future(false);
+          return self->Deliver(std::move(matches), n + 1, std::move(row));
+        });
+  }
+
+  bool OnDelivered(bool keep_reading) {
+    if (keep_reading) return true;
+    std::lock_guard<std::mutex> lk(mu_);
+    stopped_ = true;
+    return false;
+  }
+
+  void OnFinish(Status status) {
+    std::unique_lock<std::mutex> lk(mu_);
+    --outstanding_;
+    // Streams stopped by the application finish with `kCancelled`, that is
+    // not an error.
+    if (!status.ok() && status_.ok() && !stopped_) status_ = std::move(status);
+    if (CanStart()) StartNext(lk);
+    MaybeFinish(std::move(lk));
+  }
+
+  // Satisfy the promise once all the streams are done.
+  void MaybeFinish(std::unique_lock<std::mutex> lk) {
+    if (outstanding_ != 0) return;
+    lk.unlock();
+    promise_.set_value(std::move(status_));
+  }
+
+  Table table_;
+  CompletionQueue cq_;
+  std::vector<RowKeyType> const prefixes_;
+  Filter const filter_;
+  RowCallback const on_row_;
+  std::int64_t const rows_limit_;
+  std::vector<std::vector<std::size_t>> const streams_;
+  std::mutex mu_;
+  std::size_t next_stream_ = 0;  // GUARDED_BY(mu_)
+  std::size_t outstanding_ = 0;  // GUARDED_BY(mu_)
+  bool stopped_ = false;         // GUARDED_BY(mu_)
+  Status status_;                // GUARDED_BY(mu_)
+  promise<Status> promise_;
+};
+}  // namespace
+
+std::vector<RowSet> SplitRowSet(RowSet const& row_set,
+                                std::vector<RowKeySample> const& samples,
+                                std::size_t max_ranges) {
+  std::vector<RowSet> result;
+  auto add = [&row_set, &result](RowRange const& range) {
+    auto r = row_set.Intersect(range);
+    if (!r.IsEmpty()) result.push_back(std::move(r));
+  };
+  RowKeyType begin;
+  for (auto& split : ChooseSplitPoints(samples, max_ranges)) {
+    add(RowRange::RightOpen(begin, split));
+    begin = std::move(split);
+  }
+  add(RowRange::StartingAt(std::move(begin)));
+  return result;
+}
+
+Status ParallelReadRows(Table const& table, RowSet row_set, Filter filter,
+                        std::function<bool(Row)> on_row,
+                        ParallelReadRowsOptions const& options) {
+  Table sampler = table;
+  auto samples = sampler.SampleRows();
+  if (!samples) return std::move(samples).status();
+  auto const ranges = SplitRowSet(
+      row_set, *samples, (std::max)(options.max_ranges, std::size_t{1}));
+  if (ranges.empty()) return {};
+
+  std::atomic<std::size_t> next_range{0};
+  std::atomic<bool> stop{false};
+  std::mutex mu;
+  Status status;  // GUARDED_BY(mu)
+  auto worker = [&](Table t) {
+    for (auto i = next_range++; i < ranges.size() && !stop.load();
+         i = next_range++) {
+      auto reader = t.ReadRows(ranges[i], filter);
+      for (auto& row : reader) {
+        if (!row) {
+          std::lock_guard<std::mutex> lk(mu);
+          if (status.ok()) status = std::move(row).status();
+          stop.store(true);
+          break;
+        }
+        if (stop.load() || !on_row(*std::move(row))) {
+          stop.store(true);
+          reader.Cancel();
+          break;
+        }
+      }
+    }
+  };
+
+  auto const concurrency =
+      (std::min)((std::max)(options.max_concurrency, std::size_t{1}),
+                 ranges.size());
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency - 1);
+  for (std::size_t i = 1; i < concurrency; ++i) {
+    threads.emplace_back(worker, table);
+  }
+  // Use the calling thread as one of the workers.
+  worker(table);
+  for (auto& t : threads) t.join();
+
+  std::lock_guard<std::mutex> lk(mu);
+  return status;
+}
+
+std::vector<std::int64_t> EstimatePrefixSizes(
+    std::vector<RowKeyType> const& prefixes,
+    std::vector<RowKeySample> const& samples) {
+  std::vector<std::int64_t> sizes;
+  sizes.reserve(prefixes.size());
+  for (auto const& prefix : prefixes) {
+    auto const start = OffsetAtOrBefore(prefix, samples);
+    auto const end = OffsetAtOrAfter(internal::PrefixRangeEnd(prefix), samples);
+    sizes.push_back((std::max)(end - start, std::int64_t{1}));
+  }
+  return sizes;
+}
+
+std::vector<std::vector<std::size_t>> AssignPrefixesToStreams(
+    std::vector<std::int64_t> const& sizes, std::size_t max_streams) {
+  auto const count =
+      (std::min)((std::max)(max_streams, std::size_t{1}), sizes.size());
+  std::vector<std::size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [&sizes](std::size_t a, std::size_t b) {
+                     return sizes[a] > sizes[b];
+                   });
+
+  std::vector<std::pair<std::int64_t, std::vector<std::size_t>>> streams(
+      count);
+  for (auto i : order) {
+    auto s = std::min_element(
+        streams.begin(), streams.end(),
+        [](std::pair<std::int64_t, std::vector<std::size_t>> const& a,
+           std::pair<std::int64_t, std::vector<std::size_t>> const& b) {
+          return a.first < b.first;
+        });
+    s->first += sizes[i];
+    s->second.push_back(i);
+  }
+  std::stable_sort(
+      streams.begin(), streams.end(),
+      [](std::pair<std::int64_t, std::vector<std::size_t>> const& a,
+         std::pair<std::int64_t, std::vector<std::size_t>> const& b) {
+        return a.first > b.first;
+      });
+
+  std::vector<std::vector<std::size_t>> result;
+  result.reserve(streams.size());
+  for (auto& s : streams) result.push_back(std::move(s.second));
+  return result;
+}
+
+future<Status> AsyncReadPrefixes(
+    Table const& table, CompletionQueue cq, std::vector<RowKeyType> prefixes,
+    Filter filter, std::function<future<bool>(std::size_t, Row)> on_row,
+    ReadPrefixesOptions const& options) {
+  auto handler = std::make_shared<AsyncReadPrefixesHandler>(
+      table, std::move(cq), std::move(prefixes), std::move(filter),
+      std::move(on_row), options);
+  return handler->Start(options.max_concurrency);
+}
+
+future<StatusOr<std::vector<std::vector<Row>>>> AsyncReadPrefixes(
+    Table const& table, CompletionQueue cq, std::vector<RowKeyType> prefixes,
+    Filter filter, ReadPrefixesOptions const& options) {
+  struct State {
+    std::mutex mu;
+    std::vector<std::vector<Row>> rows;  // GUARDED_BY(mu)
+  };
+  auto state = std::make_shared<State>();
+  state->rows.resize(prefixes.size());
+  return AsyncReadPrefixes(
+             table, std::move(cq), std::move(prefixes), std::move(filter),
+             [state](std::size_t index, Row row) {
+               std::lock_guard<std::mutex> lk(state->mu);
+               state->rows[index].push_back(std::move(row));
+               return make_ready_future(true);
+             },
+             options)
+      .then([state](future<Status> f)
+                -> StatusOr<std::vector<std::vector<Row>>> {
+        auto status = f.get();
+        if (!status.ok()) return status;
+        std::lock_guard<std::mutex> lk(state->mu);
+        return std::move(state->rows);
+      });
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
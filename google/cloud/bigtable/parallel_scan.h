@@ -0,0 +1,221 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_PARALLEL_SCAN_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_PARALLEL_SCAN_H
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/row_key_sample.h"
+#include "google/cloud/bigtable/row_set.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Split @p row_set into disjoint row sets of roughly equal size.
+ *
+ * The split points are chosen among the row keys in @p samples, typically the
+ * result of `Table::SampleRows()`, so each range contains about the same number
+ * of bytes according to the sample offsets. The union of the returned row sets
+ * is @p row_set, and the row sets are sorted by row key. Ranges that do not
+ * intersect @p row_set are omitted.
+ *
+ * @param row_set the rows to split, a default constructed `RowSet` represents
+ *     the full table.
+ * @param samples the sampled row keys, in the order returned by the service.
+ * @param max_ranges the maximum number of row sets returned.
+ */
+std::vector<RowSet> SplitRowSet(RowSet const& row_set,
+                                std::vector<RowKeySample> const& samples,
+                                std::size_t max_ranges);
+
+/// Configure `ParallelReadRows()`.
+struct ParallelReadRowsOptions {
+  /// No more than this many `ReadRows()` streams will be open at a time.
+  ParallelReadRowsOptions& SetMaxConcurrency(std::size_t v) {
+    max_concurrency = v;
+    return *this;
+  }
+
+  /**
+   * Split the scan in at most this many ranges.
+   *
+   * Using more ranges than streams balances the load across the streams when
+   * some ranges are slower to read than others.
+   */
+  ParallelReadRowsOptions& SetMaxRanges(std::size_t v) {
+    max_ranges = v;
+    return *this;
+  }
+
+  std::size_t max_concurrency = 8;
+  std::size_t max_ranges = 64;
+};
+
+/**
+ * Read all the rows in @p row_set using multiple concurrent streams.
+ *
+ * The function samples the table row keys, splits @p row_set using
+ * `SplitRowSet()`, and reads each range with a separate `Table::ReadRows()`
+ * call, with up to `options.max_concurrency` ranges in flight. The data client
+ * assigns each call to a different channel, so the scan throughput grows with
+ * the number of channels in the `DataClient` and the number of cores.
+ *
+ * Each range is retried (and resumed after the last row received) according to
+ * the retry and backoff policies of @p table. The function returns the first
+ * error of any range that fails permanently, after stopping the other ranges.
+ *
+ * @param on_row called for each row. The rows are sorted within each range,
+ *     but the ranges are read concurrently, so this callback may be called
+ *     from multiple threads at the same time and must be thread-safe. Return
+ *     `false` to stop the scan.
+ *
+ * @par Thread-safety
+ * The function makes copies of @p table for each stream, it is safe to use
+ * @p table from other threads while the scan runs.
+ */
+Status ParallelReadRows(Table const& table, RowSet row_set, Filter filter,
+                        std::function<bool(Row)> on_row,
+                        ParallelReadRowsOptions const& options = {});
+
+/// Configure `AsyncReadPrefixes()`.
+struct ReadPrefixesOptions {
+  /// No more than this many `ReadRows()` streams will be open at a time.
+  ReadPrefixesOptions& SetMaxConcurrency(std::size_t v) {
+    max_concurrency = v;
+    return *this;
+  }
+
+  /**
+   * Return at most this many rows for each prefix, 0 means no limit.
+   *
+   * The limit is enforced by the service, so each prefix is read with its own
+   * `ReadRows()` stream when this is set.
+   */
+  ReadPrefixesOptions& SetRowsLimitPerPrefix(std::int64_t v) {
+    rows_limit_per_prefix = v;
+    return *this;
+  }
+
+  /**
+   * The samples used to estimate the size of each prefix.
+   *
+   * Typically the result of `Table::SampleRows()`, which changes slowly and
+   * can be reused for many scans. Without samples all the prefixes are
+   * assumed to have the same size.
+   */
+  ReadPrefixesOptions& SetRowKeySamples(std::vector<RowKeySample> v) {
+    row_key_samples = std::move(v);
+    return *this;
+  }
+
+  std::size_t max_concurrency = 8;
+  std::int64_t rows_limit_per_prefix = 0;
+  std::vector<RowKeySample> row_key_samples;
+};
+
+/**
+ * Estimate the size, in bytes, of the rows starting with each of @p prefixes.
+ *
+ * The estimate is the difference between the `offset_bytes` of the last
+ * sample at or before the start of each prefix range, and of the first sample
+ * at or after its end. A prefix between two consecutive samples is estimated
+ * as the size of that interval. Without samples every prefix is estimated as
+ * 1 byte.
+ *
+ * @param prefixes the row key prefixes.
+ * @param samples the result of `Table::SampleRows()`, in row key order.
+ */
+std::vector<std::int64_t> EstimatePrefixSizes(
+    std::vector<RowKeyType> const& prefixes,
+    std::vector<RowKeySample> const& samples);
+
+/**
+ * Assign the prefixes to at most @p max_streams `ReadRows()` requests.
+ *
+ * Each prefix goes, largest first, to the request with the smallest estimated
+ * size so far. The requests are returned largest first, each as the indexes
+ * of its prefixes in @p sizes.
+ */
+std::vector<std::vector<std::size_t>> AssignPrefixesToStreams(
+    std::vector<std::int64_t> const& sizes, std::size_t max_streams);
+
+/**
+ * Asynchronously read all the rows starting with any of @p prefixes.
+ *
+ * A `RowSet` with many `RowRange::Prefix()` ranges is read by a single
+ * `ReadRows()` stream, one prefix after the other. This function assigns the
+ * prefixes to up to `options.max_concurrency` concurrent
+ * `Table::AsyncReadRows()` streams using `AssignPrefixesToStreams()`, so each
+ * stream reads about the same amount of data, and starts the largest streams
+ * first.
+ *
+ * Each stream is retried (and resumed after the last row received) according
+ * to the retry and backoff policies of @p table. The returned future is
+ * satisfied with the first error of any stream that fails permanently, after
+ * stopping the other streams.
+ *
+ * @param cq the completion queue that will execute the asynchronous calls,
+ *     the application must ensure that one or more threads are blocked on
+ *     `cq.Run()`.
+ * @param on_row called for each row, with the index of its prefix in
+ *     @p prefixes. A row matching several prefixes is delivered once for each
+ *     prefix. The rows of each prefix are delivered in key order, but the
+ *     streams run concurrently, so this callback may be called from multiple
+ *     threads at the same time and must be thread-safe. Satisfy the returned
+ *     future with `false` to stop the scan, the returned future is then
+ *     satisfied with an OK status.
+ *
+ * @par Thread-safety
+ * The function makes copies of @p table for each stream, it is safe to use
+ * @p table from other threads while the scan runs.
+ */
+future<Status> AsyncReadPrefixes(
+    Table const& table, CompletionQueue cq, std::vector<RowKeyType> prefixes,
+    Filter filter, std::function<future<bool>(std::size_t, Row)> on_row,
+    ReadPrefixesOptions const& options = {});
+
+/**
+ * Asynchronously read all the rows starting with any of @p prefixes, grouped
+ * by prefix.
+ *
+ * The prefixes are read as in the previous overload.
+ *
+ * @returns a future satisfied with the rows for each prefix, in key order, and
+ *     in the same order as @p prefixes, or with the first error of any stream
+ *     that fails permanently.
+ */
+future<StatusOr<std::vector<std::vector<Row>>>> AsyncReadPrefixes(
+    Table const& table, CompletionQueue cq, std::vector<RowKeyType> prefixes,
+    Filter filter, ReadPrefixesOptions const& options = {});
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_PARALLEL_SCAN_H
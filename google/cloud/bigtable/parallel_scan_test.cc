@@ -0,0 +1,363 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/parallel_scan.h"
+#include "google/cloud/bigtable/testing/mock_response_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/fake_completion_queue_impl.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+
+namespace btproto = ::google::bigtable::v2;
+
+using ::google::cloud::bigtable::testing::MockClientAsyncReaderInterface;
+using ::google::cloud::testing_util::FakeCompletionQueueImpl;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+std::vector<RowRange> SingleRanges(std::vector<RowSet> const& sets) {
+  std::vector<RowRange> result;
+  for (auto const& s : sets) {
+    EXPECT_EQ(0, s.as_proto().row_keys_size());
+    EXPECT_EQ(1, s.as_proto().row_ranges_size());
+    if (s.as_proto().row_ranges_size() != 1) continue;
+    result.emplace_back(s.as_proto().row_ranges(0));
+  }
+  return result;
+}
+
+TEST(SplitRowSetTest, NoSamples) {
+  auto actual = SingleRanges(SplitRowSet(RowSet(), {}, 8));
+  ASSERT_EQ(1U, actual.size());
+  EXPECT_EQ(RowRange::StartingAt(""), actual[0]);
+}
+
+TEST(SplitRowSetTest, AllSamples) {
+  std::vector<RowKeySample> samples{
+      {"a", 10}, {"b", 20}, {"c", 30}, {"", 40}};
+  auto actual = SingleRanges(SplitRowSet(RowSet(), samples, 8));
+  ASSERT_EQ(4U, actual.size());
+  EXPECT_EQ(RowRange::RightOpen("", "a"), actual[0]);
+  EXPECT_EQ(RowRange::RightOpen("a", "b"), actual[1]);
+  EXPECT_EQ(RowRange::RightOpen("b", "c"), actual[2]);
+  EXPECT_EQ(RowRange::StartingAt("c"), actual[3]);
+}
+
+TEST(SplitRowSetTest, BalancedByOffset) {
+  std::vector<RowKeySample> samples{
+      {"k1", 10}, {"k2", 20}, {"k3", 30}, {"k4", 40}, {"k5", 50},
+      {"k6", 60}, {"k7", 70}, {"k8", 80}, {"k9", 90}, {"", 100}};
+  auto actual = SingleRanges(SplitRowSet(RowSet(), samples, 2));
+  ASSERT_EQ(2U, actual.size());
+  EXPECT_EQ(RowRange::RightOpen("", "k5"), actual[0]);
+  EXPECT_EQ(RowRange::StartingAt("k5"), actual[1]);
+
+  actual = SingleRanges(SplitRowSet(RowSet(), samples, 4));
+  ASSERT_EQ(4U, actual.size());
+  EXPECT_EQ(RowRange::RightOpen("", "k3"), actual[0]);
+  EXPECT_EQ(RowRange::RightOpen("k3", "k5"), actual[1]);
+  EXPECT_EQ(RowRange::RightOpen("k5", "k8"), actual[2]);
+  EXPECT_EQ(RowRange::StartingAt("k8"), actual[3]);
+}
+
+TEST(SplitRowSetTest, SingleRange) {
+  std::vector<RowKeySample> samples{{"a", 10}, {"b", 20}, {"", 30}};
+  auto actual = SingleRanges(SplitRowSet(RowSet(), samples, 1));
+  ASSERT_EQ(1U, actual.size());
+  EXPECT_EQ(RowRange::StartingAt(""), actual[0]);
+}
+
+TEST(SplitRowSetTest, IntersectRange) {
+  std::vector<RowKeySample> samples{
+      {"a", 10}, {"b", 20}, {"c", 30}, {"", 40}};
+  auto actual = SingleRanges(
+      SplitRowSet(RowSet(RowRange::Range("b1", "c1")), samples, 8));
+  ASSERT_EQ(2U, actual.size());
+  EXPECT_EQ(RowRange::RightOpen("b1", "c"), actual[0]);
+  EXPECT_EQ(RowRange::RightOpen("c", "c1"), actual[1]);
+}
+
+TEST(SplitRowSetTest, IntersectKeys) {
+  std::vector<RowKeySample> samples{
+      {"a", 10}, {"b", 20}, {"c", 30}, {"", 40}};
+  auto actual = SplitRowSet(RowSet("a0", "a1", "c0"), samples, 8);
+  ASSERT_EQ(2U, actual.size());
+  ASSERT_EQ(2, actual[0].as_proto().row_keys_size());
+  EXPECT_EQ("a0", actual[0].as_proto().row_keys(0));
+  EXPECT_EQ("a1", actual[0].as_proto().row_keys(1));
+  ASSERT_EQ(1, actual[1].as_proto().row_keys_size());
+  EXPECT_EQ("c0", actual[1].as_proto().row_keys(0));
+}
+
+TEST(ReadPrefixesTest, EstimateWithoutSamples) {
+  EXPECT_THAT(EstimatePrefixSizes({"a", "b", "c"}, {}), ElementsAre(1, 1, 1));
+}
+
+TEST(ReadPrefixesTest, EstimateWithSamples) {
+  // The last sample, with an empty key, is the end of the table.
+  std::vector<RowKeySample> samples{
+      {"b", 100}, {"c", 300}, {"d", 350}, {"", 1000}};
+  EXPECT_THAT(
+      EstimatePrefixSizes({"a", "b", "bx", "c", "d", "", "\xff"}, samples),
+      ElementsAre(100, 200, 200, 50, 650, 1000, 650));
+}
+
+TEST(ReadPrefixesTest, AssignBalanced) {
+  auto streams = AssignPrefixesToStreams({10, 70, 20, 30, 40}, 2);
+  // Largest first: 70 -> s0, 40 -> s1, 30 -> s1, 20 -> s0, 10 -> s1.
+  ASSERT_EQ(2U, streams.size());
+  EXPECT_THAT(streams[0], UnorderedElementsAre(1, 2));
+  EXPECT_THAT(streams[1], UnorderedElementsAre(4, 3, 0));
+}
+
+TEST(ReadPrefixesTest, AssignLargestStreamFirst) {
+  auto streams = AssignPrefixesToStreams({5, 50, 20}, 3);
+  ASSERT_EQ(3U, streams.size());
+  EXPECT_THAT(streams[0], ElementsAre(1));
+  EXPECT_THAT(streams[1], ElementsAre(2));
+  EXPECT_THAT(streams[2], ElementsAre(0));
+}
+
+TEST(ReadPrefixesTest, AssignEdgeCases) {
+  EXPECT_TRUE(AssignPrefixesToStreams({}, 4).empty());
+  // A zero limit is treated as 1.
+  auto streams = AssignPrefixesToStreams({1, 2, 3}, 0);
+  ASSERT_EQ(1U, streams.size());
+  EXPECT_THAT(streams[0], ElementsAre(2, 1, 0));
+}
+
+class AsyncReadPrefixesTest : public bigtable::testing::TableTestFixture {
+ protected:
+  AsyncReadPrefixesTest()
+      : cq_impl_(std::make_shared<FakeCompletionQueueImpl>()), cq_(cq_impl_) {}
+
+  /**
+   * Serve the `ReadRows()` streams from a table with @p keys.
+   *
+   * Each stream returns all its rows in a single response. Streams reading a
+   * range that starts at a key in `errors_` fail with that error.
+   */
+  void ServeRows(std::vector<std::string> keys) {
+    EXPECT_CALL(*client_, PrepareAsyncReadRows)
+        .WillRepeatedly([this, keys](grpc::ClientContext*,
+                                     btproto::ReadRowsRequest const& request,
+                                     grpc::CompletionQueue*) {
+          requests_.push_back(request);
+          ++in_flight_;
+          max_in_flight_ = (std::max)(max_in_flight_, in_flight_);
+          return MakeReader(keys, request);
+        });
+  }
+
+  std::unique_ptr<MockClientAsyncReaderInterface<btproto::ReadRowsResponse>>
+  MakeReader(std::vector<std::string> const& keys,
+             btproto::ReadRowsRequest const& request) {
+    auto const& ranges = request.rows().row_ranges();
+    btproto::ReadRowsResponse response;
+    std::int64_t count = 0;
+    for (auto const& key : keys) {
+      if (request.rows_limit() != 0 && count == request.rows_limit()) break;
+      auto const match =
+          std::any_of(ranges.begin(), ranges.end(),
+                      [&key](btproto::RowRange const& r) {
+                        return RowRange(r).Contains(key);
+                      });
+      if (!match) continue;
+      ++count;
+      auto& chunk = *response.add_chunks();
+      chunk.set_row_key(key);
+      chunk.mutable_family_name()->set_value("fam");
+      chunk.mutable_qualifier()->set_value("col");
+      chunk.set_value("value");
+      chunk.set_commit_row(true);
+    }
+    auto status = grpc::Status::OK;
+    for (auto const& r : ranges) {
+      auto e = errors_.find(r.start_key_closed());
+      if (e != errors_.end()) status = e->second;
+    }
+
+    auto reader = absl::make_unique<
+        MockClientAsyncReaderInterface<btproto::ReadRowsResponse>>();
+    EXPECT_CALL(*reader, StartCall);
+    EXPECT_CALL(*reader, Read)
+        .WillOnce([response](btproto::ReadRowsResponse* r, void*) {
+          *r = response;
+        })
+        .WillOnce([](btproto::ReadRowsResponse*, void*) {});
+    EXPECT_CALL(*reader, Finish)
+        .WillOnce([this, status](grpc::Status* s, void*) {
+          --in_flight_;
+          *s = status;
+        });
+    return reader;
+  }
+
+  /// Run the streams to completion, all the running streams move in lockstep.
+  void RunStreams() {
+    while (!cq_impl_->empty()) {
+      cq_impl_->SimulateCompletion(true);   // StartCall()
+      cq_impl_->SimulateCompletion(true);   // Read() returns the rows
+      cq_impl_->SimulateCompletion(false);  // Read() reaches the end
+      cq_impl_->SimulateCompletion(true);   // Finish()
+    }
+  }
+
+  template <typename T>
+  T Get(future<T> f) {
+    RunStreams();
+    EXPECT_EQ(std::future_status::ready, f.wait_for(std::chrono::seconds(0)));
+    return f.get();
+  }
+
+  std::shared_ptr<FakeCompletionQueueImpl> cq_impl_;
+  CompletionQueue cq_;
+  std::map<std::string, grpc::Status> errors_;
+  std::vector<btproto::ReadRowsRequest> requests_;
+  int in_flight_ = 0;
+  int max_in_flight_ = 0;
+};
+
+std::vector<std::vector<std::string>> RowKeys(
+    std::vector<std::vector<Row>> const& groups) {
+  std::vector<std::vector<std::string>> result;
+  for (auto const& rows : groups) {
+    result.emplace_back();
+    for (auto const& r : rows) result.back().push_back(r.row_key());
+  }
+  return result;
+}
+
+TEST_F(AsyncReadPrefixesTest, DeliversPrefixIndex) {
+  ServeRows({"a1", "a2", "b1", "c1", "d1"});
+  std::vector<std::pair<std::size_t, std::string>> rows;
+  auto status = Get(AsyncReadPrefixes(
+      table_, cq_, {"a", "b", "c"}, Filter::PassAllFilter(),
+      [&rows](std::size_t index, Row row) {
+        rows.emplace_back(index, row.row_key());
+        return make_ready_future(true);
+      },
+      ReadPrefixesOptions().SetMaxConcurrency(1)));
+  ASSERT_STATUS_OK(status);
+  EXPECT_THAT(rows, ElementsAre(Pair(0U, "a1"), Pair(0U, "a2"),
+                                Pair(1U, "b1"), Pair(2U, "c1")));
+  ASSERT_EQ(1U, requests_.size());
+  EXPECT_EQ(3, requests_[0].rows().row_ranges_size());
+}
+
+TEST_F(AsyncReadPrefixesTest, OverlappingPrefixes) {
+  ServeRows({"a1", "ab1", "ab2", "b1"});
+  std::vector<std::pair<std::size_t, std::string>> rows;
+  auto status = Get(AsyncReadPrefixes(
+      table_, cq_, {"a", "ab"}, Filter::PassAllFilter(),
+      [&rows](std::size_t index, Row row) {
+        rows.emplace_back(index, row.row_key());
+        return make_ready_future(true);
+      },
+      ReadPrefixesOptions().SetMaxConcurrency(1)));
+  ASSERT_STATUS_OK(status);
+  // Each row is read once, and delivered to every prefix it matches.
+  EXPECT_THAT(rows,
+              ElementsAre(Pair(0U, "a1"), Pair(0U, "ab1"), Pair(1U, "ab1"),
+                          Pair(0U, "ab2"), Pair(1U, "ab2")));
+  EXPECT_EQ(1U, requests_.size());
+}
+
+TEST_F(AsyncReadPrefixesTest, MaxConcurrency) {
+  ServeRows({"a1", "b1", "c1", "d1", "e1"});
+  std::vector<std::string> keys;
+  auto status = Get(AsyncReadPrefixes(
+      table_, cq_, {"a", "b", "c", "d", "e"}, Filter::PassAllFilter(),
+      [&keys](std::size_t, Row row) {
+        keys.push_back(row.row_key());
+        return make_ready_future(true);
+      },
+      ReadPrefixesOptions().SetMaxConcurrency(2).SetRowsLimitPerPrefix(10)));
+  ASSERT_STATUS_OK(status);
+  EXPECT_THAT(keys, UnorderedElementsAre("a1", "b1", "c1", "d1", "e1"));
+  EXPECT_EQ(5U, requests_.size());
+  EXPECT_EQ(2, max_in_flight_);
+}
+
+TEST_F(AsyncReadPrefixesTest, RowsLimitPerPrefix) {
+  ServeRows({"a1", "a2", "b1", "b2", "c1"});
+  auto rows = Get(AsyncReadPrefixes(
+      table_, cq_, {"a", "b", "c"}, Filter::PassAllFilter(),
+      ReadPrefixesOptions().SetMaxConcurrency(1).SetRowsLimitPerPrefix(1)));
+  ASSERT_STATUS_OK(rows);
+  EXPECT_THAT(RowKeys(*rows), ElementsAre(ElementsAre("a1"), ElementsAre("b1"),
+                                          ElementsAre("c1")));
+  // Each prefix uses its own stream, even if the concurrency is lower.
+  ASSERT_EQ(3U, requests_.size());
+  for (auto const& r : requests_) {
+    EXPECT_EQ(1, r.rows().row_ranges_size());
+    EXPECT_EQ(1, r.rows_limit());
+  }
+}
+
+TEST_F(AsyncReadPrefixesTest, StopStopsAllStreams) {
+  ServeRows({"a1", "a2", "b1", "c1", "d1"});
+  int calls = 0;
+  auto status = Get(AsyncReadPrefixes(
+      table_, cq_, {"a", "b", "c", "d"}, Filter::PassAllFilter(),
+      [&calls](std::size_t, Row const&) {
+        ++calls;
+        return make_ready_future(false);
+      },
+      ReadPrefixesOptions().SetMaxConcurrency(2).SetRowsLimitPerPrefix(10)));
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(1, calls);
+  // The streams already running are cancelled, no new streams start.
+  EXPECT_EQ(2U, requests_.size());
+}
+
+TEST_F(AsyncReadPrefixesTest, PermanentError) {
+  errors_.emplace("a", grpc::Status(grpc::StatusCode::PERMISSION_DENIED,
+                                    "uh-oh"));
+  errors_.emplace("b", grpc::Status(grpc::StatusCode::NOT_FOUND, "uh-oh"));
+  ServeRows({"a1", "b1", "c1", "d1"});
+  auto rows = Get(AsyncReadPrefixes(
+      table_, cq_, {"a", "b", "c", "d"}, Filter::PassAllFilter(),
+      ReadPrefixesOptions().SetMaxConcurrency(2).SetRowsLimitPerPrefix(10)));
+  ASSERT_FALSE(rows.ok());
+  EXPECT_EQ(StatusCode::kPermissionDenied, rows.status().code());
+  EXPECT_EQ(2U, requests_.size());
+}
+
+TEST_F(AsyncReadPrefixesTest, GroupedByPrefix) {
+  ServeRows({"a1", "a2", "b1", "c1"});
+  auto rows = Get(AsyncReadPrefixes(table_, cq_, {"b", "a", "x"},
+                                    Filter::PassAllFilter()));
+  ASSERT_STATUS_OK(rows);
+  EXPECT_THAT(RowKeys(*rows), ElementsAre(ElementsAre("b1"),
+                                          ElementsAre("a1", "a2"),
+                                          ::testing::IsEmpty()));
+}
+
+}  // namespace
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,49 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/prepared_read_rows_request.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+std::shared_ptr<google::bigtable::v2::ReadRowsRequest const> MakePrototype(
+    std::string table_name, std::string app_profile_id, Filter filter) {
+  auto prototype = std::make_shared<google::bigtable::v2::ReadRowsRequest>();
+  prototype->set_table_name(std::move(table_name));
+  prototype->set_app_profile_id(std::move(app_profile_id));
+  *prototype->mutable_filter() = std::move(filter).as_proto();
+  return prototype;
+}
+}  // namespace
+
+PreparedReadRowsRequest::PreparedReadRowsRequest(std::string table_name,
+                                                 std::string app_profile_id,
+                                                 Filter filter)
+    : prototype_(MakePrototype(std::move(table_name), std::move(app_profile_id),
+                               std::move(filter))) {}
+
+google::bigtable::v2::ReadRowsRequest PreparedReadRowsRequest::MakeRequest(
+    RowSet row_set, std::int64_t rows_limit) const {
+  google::bigtable::v2::ReadRowsRequest request(*prototype_);
+  *request.mutable_rows() = std::move(row_set).as_proto();
+  if (rows_limit != 0) request.set_rows_limit(rows_limit);
+  return request;
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
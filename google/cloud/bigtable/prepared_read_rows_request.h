@@ -0,0 +1,68 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_PREPARED_READ_ROWS_REQUEST_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_PREPARED_READ_ROWS_REQUEST_H
+
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/row_set.h"
+#include "google/cloud/bigtable/version.h"
+#include <google/bigtable/v2/bigtable.pb.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * The parts of a `ReadRows()` request that do not change between calls.
+ *
+ * Applications that issue many reads with the same filter can prepare the
+ * request once, via `Table::PrepareReadRows()`, and reuse it. The table name,
+ * app profile, and filter are converted to their protobuf form once, and
+ * shared by all the calls that use this object. Each request (and each retry)
+ * starts from a copy of the prepared protobuf, instead of rebuilding it.
+ *
+ * Objects of this class are immutable and cheap to copy, they can be used
+ * from multiple threads without synchronization.
+ */
+class PreparedReadRowsRequest {
+ public:
+  PreparedReadRowsRequest(std::string table_name, std::string app_profile_id,
+                          Filter filter);
+
+  std::string const& table_name() const { return prototype_->table_name(); }
+  std::string const& app_profile_id() const {
+    return prototype_->app_profile_id();
+  }
+  google::bigtable::v2::RowFilter const& filter() const {
+    return prototype_->filter();
+  }
+
+  /// Returns a complete request to read @p row_set, up to @p rows_limit rows.
+  google::bigtable::v2::ReadRowsRequest MakeRequest(
+      RowSet row_set, std::int64_t rows_limit) const;
+
+ private:
+  std::shared_ptr<google::bigtable::v2::ReadRowsRequest const> prototype_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_PREPARED_READ_ROWS_REQUEST_H
@@ -0,0 +1,60 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/prepared_read_rows_request.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+
+TEST(PreparedReadRowsRequestTest, Accessors) {
+  PreparedReadRowsRequest tested("test-table", "test-profile",
+                                 Filter::FamilyRegex("fam"));
+  EXPECT_EQ("test-table", tested.table_name());
+  EXPECT_EQ("test-profile", tested.app_profile_id());
+  EXPECT_EQ("fam", tested.filter().family_name_regex_filter());
+}
+
+TEST(PreparedReadRowsRequestTest, MakeRequest) {
+  PreparedReadRowsRequest tested("test-table", "test-profile",
+                                 Filter::FamilyRegex("fam"));
+  auto request = tested.MakeRequest(RowSet("r1", "r2"), 2);
+  EXPECT_EQ("test-table", request.table_name());
+  EXPECT_EQ("test-profile", request.app_profile_id());
+  EXPECT_EQ("fam", request.filter().family_name_regex_filter());
+  EXPECT_THAT(request.rows().row_keys(), ::testing::ElementsAre("r1", "r2"));
+  EXPECT_EQ(2, request.rows_limit());
+
+  // The prepared request is not modified, and can be reused.
+  request = tested.MakeRequest(RowSet(RowRange::Prefix("r")), 0);
+  EXPECT_EQ("fam", request.filter().family_name_regex_filter());
+  EXPECT_EQ(0, request.rows().row_keys_size());
+  EXPECT_EQ(1, request.rows().row_ranges_size());
+  EXPECT_EQ(0, request.rows_limit());
+}
+
+TEST(PreparedReadRowsRequestTest, CopiesShareState) {
+  PreparedReadRowsRequest tested("test-table", "", Filter::PassAllFilter());
+  auto copy = tested;
+  EXPECT_EQ(&tested.filter(), &copy.filter());
+}
+
+}  // namespace
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,78 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_READ_ROWS_VISITOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_READ_ROWS_VISITOR_H
+
+#include "google/cloud/bigtable/cell.h"
+#include "google/cloud/bigtable/row_key.h"
+#include "google/cloud/bigtable/version.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Receives the cells returned by `Table::ReadRows()` as they are parsed.
+ *
+ * The `Table::ReadRows()` and `Table::AsyncReadRows()` overloads consuming a
+ * visitor do not build a `Row` for each row in the results. Instead, they
+ * deliver each cell as soon as it is complete, so reading rows with millions
+ * of cells does not require holding the full row in memory.
+ *
+ * The callbacks for each row are:
+ * - `OnRowStart()` before the first cell in the row,
+ * - `OnCell()` for each cell in the row, in order,
+ * - `OnRowCommit()` once the row is complete, or `OnRowReset()` if the row is
+ *   aborted.
+ *
+ * A row is aborted when the service asks the client to discard the cells
+ * received so far, or when the stream fails in the middle of a row. In the
+ * latter case the library may retry the request, and the cells of the row
+ * are delivered again, starting with a new `OnRowStart()` call. Applications
+ * must not commit any work for a row until `OnRowCommit()` is called.
+ *
+ * @par Thread-safety
+ * The callbacks for a single read are never called concurrently, but with
+ * `Table::AsyncReadRows()` they may be called from any thread running the
+ * completion queue.
+ */
+class ReadRowsVisitor {
+ public:
+  virtual ~ReadRowsVisitor() = default;
+
+  /// Called before the first cell of a row.
+  virtual void OnRowStart(RowKeyType const& /*row_key*/) {}
+
+  /// Called for each cell, the cell is owned by the visitor.
+  virtual void OnCell(Cell cell) = 0;
+
+  /**
+   * Called when all the cells in a row have been delivered.
+   *
+   * @return `false` to stop reading, any rows after this one are not
+   *     delivered, and the read completes successfully.
+   */
+  virtual bool OnRowCommit(RowKeyType const& /*row_key*/) { return true; }
+
+  /// Called if the cells delivered since `OnRowStart()` must be discarded.
+  virtual void OnRowReset() {}
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_READ_ROWS_VISITOR_H
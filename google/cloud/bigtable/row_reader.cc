@@ -13,17 +13,22 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/row_reader.h"
+#include "google/cloud/bigtable/internal/hedged_client_reader.h"
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/grpc_error_delegate.h"
 #include "google/cloud/internal/throw_delegate.h"
 #include "google/cloud/log.h"
 #include "absl/memory/memory.h"
-#include <thread>
 
 namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/// Only point reads, and reads of a few row keys, are hedged.
+int constexpr kMaxHedgedRowKeys = 10;
+}  // namespace
+
 // RowReader::iterator must satisfy the requirements of an InputIterator.
 static_assert(
     std::is_same<std::iterator_traits<RowReader::iterator>::iterator_category,
@@ -78,19 +83,34 @@ RowReader::RowReader(
     std::unique_ptr<RPCBackoffPolicy> backoff_policy,
     MetadataUpdatePolicy metadata_update_policy,
     std::unique_ptr<internal::ReadRowsParserFactory> parser_factory)
+    : RowReader(std::move(client),
+                PreparedReadRowsRequest(std::move(table_name),
+                                        std::move(app_profile_id),
+                                        std::move(filter)),
+                std::move(row_set), rows_limit, std::move(retry_policy),
+                std::move(backoff_policy), std::move(metadata_update_policy),
+                std::move(parser_factory)) {}
+
+RowReader::RowReader(
+    std::shared_ptr<DataClient> client, PreparedReadRowsRequest prepared,
+    RowSet row_set, std::int64_t rows_limit,
+    std::unique_ptr<RPCRetryPolicy> retry_policy,
+    std::unique_ptr<RPCBackoffPolicy> backoff_policy,
+    MetadataUpdatePolicy metadata_update_policy,
+    std::unique_ptr<internal::ReadRowsParserFactory> parser_factory)
     : client_(std::move(client)),
-      app_profile_id_(std::move(app_profile_id)),
-      table_name_(std::move(table_name)),
+      prepared_(std::move(prepared)),
       row_set_(std::move(row_set)),
       rows_limit_(rows_limit),
-      filter_(std::move(filter)),
       retry_policy_(std::move(retry_policy)),
       backoff_policy_(std::move(backoff_policy)),
       metadata_update_policy_(std::move(metadata_update_policy)),
       context_(),
+      cancellation_token_(google::cloud::internal::CurrentCancellationToken()),
       parser_factory_(std::move(parser_factory)),
       stream_is_open_(false),
       operation_cancelled_(false),
+      read_ahead_options_(internal::ReadAheadOptionsFromEnv()),
       processed_chunks_count_(0),
       rows_count_(0) {}
 
@@ -107,25 +127,40 @@ void RowReader::MakeRequest() {
   response_ = {};
   processed_chunks_count_ = 0;
 
-  google::bigtable::v2::ReadRowsRequest request;
-  request.set_table_name(table_name_);
-  request.set_app_profile_id(app_profile_id_);
-
-  auto row_set_proto = row_set_.as_proto();
-  request.mutable_rows()->Swap(&row_set_proto);
-
-  auto filter_proto = filter_.as_proto();
-  request.mutable_filter()->Swap(&filter_proto);
-
-  if (rows_limit_ != NO_ROWS_LIMIT) {
-    request.set_rows_limit(rows_limit_ - rows_count_);
-  }
+  auto request = prepared_.MakeRequest(
+      row_set_.ToRowSet(),
+      rows_limit_ == NO_ROWS_LIMIT ? NO_ROWS_LIMIT : rows_limit_ - rows_count_);
 
+  // Release the previous stream (if any) before its context.
+  stream_.reset();
+  cancel_registration_.Reset();
   context_ = absl::make_unique<grpc::ClientContext>();
   retry_policy_->Setup(*context_);
   backoff_policy_->Setup(*context_);
   metadata_update_policy_.Setup(*context_);
-  stream_ = client_->ReadRows(context_.get(), request);
+  auto* context = context_.get();
+  cancel_registration_ = CancellationRegistration(
+      cancellation_token_, [context] { context->TryCancel(); });
+  auto hedging_policy = hedging_policy_;
+  if (request.rows().row_ranges_size() != 0 ||
+      request.rows().row_keys_size() == 0 ||
+      request.rows().row_keys_size() > kMaxHedgedRowKeys) {
+    hedging_policy.reset();
+  }
+  auto stream = internal::MaybeHedge<google::bigtable::v2::ReadRowsResponse>(
+      std::move(hedging_policy), context_.get(),
+      [this, request](grpc::ClientContext* context) {
+        return client_->ReadRows(context, request);
+      },
+      [this] {
+        auto context = absl::make_unique<grpc::ClientContext>();
+        retry_policy_->Setup(*context);
+        backoff_policy_->Setup(*context);
+        metadata_update_policy_.Setup(*context);
+        return context;
+      });
+  stream_ = internal::MaybeReadAhead(std::move(stream), context_.get(),
+                                    read_ahead_options_);
   stream_is_open_ = true;
 
   parser_ = parser_factory_->Create();
@@ -145,7 +180,8 @@ bool RowReader::NextChunk() {
 }
 
 StatusOr<RowReader::OptionalRow> RowReader::Advance() {
-  if (operation_cancelled_) {
+  if (operation_cancelled_ ||
+      google::cloud::internal::IsCancelled(cancellation_token_)) {
     return Status(StatusCode::kCancelled, "Operation cancelled.");
   }
   while (true) {
@@ -167,7 +203,7 @@ StatusOr<RowReader::OptionalRow> RowReader::Advance() {
     if (!last_read_row_key_.empty()) {
       // We've returned some rows and need to make sure we don't
       // request them again.
-      row_set_ = row_set_.Intersect(RowRange::Open(last_read_row_key_, ""));
+      row_set_.TrimTo(last_read_row_key_);
     }
 
     // If we receive an error, but the retryable set is empty, stop.
@@ -175,12 +211,19 @@ StatusOr<RowReader::OptionalRow> RowReader::Advance() {
       return row;
     }
 
+    if (google::cloud::internal::IsCancelled(cancellation_token_)) {
+      return Status(StatusCode::kCancelled, "Operation cancelled.");
+    }
+
     if (!retry_policy_->OnFailure(status)) {
       return MakeStatusFromRpcError(status);
     }
 
     auto delay = backoff_policy_->OnCompletion(status);
-    std::this_thread::sleep_for(delay);
+    if (!google::cloud::internal::SleepUnlessCancelled(cancellation_token_,
+                                                       delay)) {
+      return Status(StatusCode::kCancelled, "Operation cancelled.");
+    }
 
     // If we reach this place, we failed and need to restart the call.
     MakeRequest();
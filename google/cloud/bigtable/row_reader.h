@@ -17,14 +17,19 @@
 
 #include "google/cloud/bigtable/data_client.h"
 #include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/hedging_policy.h"
+#include "google/cloud/bigtable/internal/read_rows_read_ahead.h"
 #include "google/cloud/bigtable/internal/readrowsparser.h"
 #include "google/cloud/bigtable/internal/rowreaderiterator.h"
+#include "google/cloud/bigtable/internal/sorted_row_set.h"
 #include "google/cloud/bigtable/metadata_update_policy.h"
+#include "google/cloud/bigtable/prepared_read_rows_request.h"
 #include "google/cloud/bigtable/row.h"
 #include "google/cloud/bigtable/row_set.h"
 #include "google/cloud/bigtable/rpc_backoff_policy.h"
 #include "google/cloud/bigtable/rpc_retry_policy.h"
 #include "google/cloud/bigtable/version.h"
+#include "google/cloud/cancellation.h"
 #include "google/cloud/optional.h"
 #include "absl/types/optional.h"
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
@@ -36,6 +41,8 @@ namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+class Table;
+
 /**
  * Object returned by Table::ReadRows(), enumerates rows in the response.
  *
@@ -70,12 +77,21 @@ class RowReader {
             MetadataUpdatePolicy metadata_update_policy,
             std::unique_ptr<internal::ReadRowsParserFactory> parser_factory);
 
+  RowReader(std::shared_ptr<DataClient> client,
+            PreparedReadRowsRequest prepared, RowSet row_set,
+            std::int64_t rows_limit,
+            std::unique_ptr<RPCRetryPolicy> retry_policy,
+            std::unique_ptr<RPCBackoffPolicy> backoff_policy,
+            MetadataUpdatePolicy metadata_update_policy,
+            std::unique_ptr<internal::ReadRowsParserFactory> parser_factory);
+
   RowReader(RowReader&&) noexcept = default;
 
   ~RowReader();
 
   using iterator = internal::RowReaderIterator;
   friend class internal::RowReaderIterator;
+  friend class Table;
 
   /**
    * Input iterator over rows in the response.
@@ -135,16 +151,19 @@ class RowReader {
   void MakeRequest();
 
   std::shared_ptr<DataClient> client_;
-  std::string app_profile_id_;
-  std::string table_name_;
-  RowSet row_set_;
+  PreparedReadRowsRequest prepared_;
+  /// The rows left to read, trimmed after the last read row on each retry.
+  internal::SortedRowSet row_set_;
   std::int64_t rows_limit_;
-  Filter filter_;
   std::unique_ptr<RPCRetryPolicy> retry_policy_;
   std::unique_ptr<RPCBackoffPolicy> backoff_policy_;
   MetadataUpdatePolicy metadata_update_policy_;
 
   std::unique_ptr<grpc::ClientContext> context_;
+  /// The cancellation token current when the reader was created, if any.
+  absl::optional<CancellationToken> cancellation_token_;
+  /// Cancels `context_` when `cancellation_token_` is cancelled.
+  CancellationRegistration cancel_registration_;
 
   std::unique_ptr<internal::ReadRowsParserFactory> parser_factory_;
   std::unique_ptr<internal::ReadRowsParser> parser_;
@@ -153,6 +172,9 @@ class RowReader {
       stream_;
   bool stream_is_open_;
   bool operation_cancelled_;
+  internal::ReadAheadOptions read_ahead_options_;
+  /// If set, hedge the requests for small sets of row keys.
+  std::shared_ptr<HedgingPolicy> hedging_policy_;
 
   /// The last received response, chunks are being parsed one by one from it.
   google::bigtable::v2::ReadRowsResponse response_;
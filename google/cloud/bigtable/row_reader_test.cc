@@ -20,6 +20,8 @@
 #include "google/cloud/internal/throw_delegate.h"
 #include "google/cloud/testing_util/assert_ok.h"
 #include "google/cloud/testing_util/capture_log_lines_backend.h"
+#include "google/cloud/testing_util/scoped_environment.h"
+#include "google/cloud/testing_util/status_matchers.h"
 #include "google/cloud/testing_util/validate_metadata.h"
 #include "absl/memory/memory.h"
 #include <gmock/gmock.h>
@@ -37,6 +39,8 @@ using ::google::bigtable::v2::ReadRowsResponse_CellChunk;
 using ::google::cloud::bigtable::Row;
 using ::google::cloud::bigtable::testing::MockReadRowsReader;
 using ::google::cloud::testing_util::IsContextMDValid;
+using ::google::cloud::testing_util::ScopedEnvironment;
+using ::google::cloud::testing_util::StatusIs;
 using ::testing::_;
 using ::testing::Contains;
 using ::testing::DoAll;
@@ -215,6 +219,35 @@ TEST_F(RowReaderTest, ReadOneRow) {
   EXPECT_EQ(++it, reader.end());
 }
 
+TEST_F(RowReaderTest, ReadOneRowWithReadAhead) {
+  ScopedEnvironment env("GOOGLE_CLOUD_CPP_BIGTABLE_READ_AHEAD_MESSAGES", "4");
+  // wrapped in unique_ptr by ReadRows
+  auto* stream = new MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  auto parser = absl::make_unique<ReadRowsParserMock>();
+  parser->SetRows({"r1"});
+  EXPECT_CALL(*parser, HandleEndOfStreamHook).Times(1);
+  {
+    ::testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows).WillOnce(stream->MakeMockReturner());
+    EXPECT_CALL(*stream, Read).WillOnce(Return(true));
+    EXPECT_CALL(*stream, Read).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, "", bigtable::RowSet(), bigtable::RowReader::NO_ROWS_LIMIT,
+      bigtable::Filter::PassAllFilter(), std::move(retry_policy_),
+      std::move(backoff_policy_), metadata_update_policy_,
+      std::move(parser_factory_));
+
+  auto it = reader.begin();
+  EXPECT_NE(it, reader.end());
+  ASSERT_STATUS_OK(*it);
+  EXPECT_EQ((*it)->row_key(), "r1");
+  EXPECT_EQ(++it, reader.end());
+}
+
 TEST_F(RowReaderTest, ReadOneRowAppProfileId) {
   // wrapped in unique_ptr by ReadRows
   auto parser = absl::make_unique<ReadRowsParserMock>();
@@ -796,6 +829,40 @@ TEST_F(RowReaderTest, FailedStreamRetryNewContext) {
   EXPECT_EQ(++it, reader.end());
 }
 
+TEST_F(RowReaderTest, CancelledTokenStopsRetries) {
+  google::cloud::CancellationToken token;
+  // wrapped in unique_ptr by ReadRows
+  auto* stream = new MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  auto parser = absl::make_unique<ReadRowsParserMock>();
+  {
+    ::testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows).WillOnce(stream->MakeMockReturner());
+    EXPECT_CALL(*stream, Read)
+        .WillOnce([&token](google::bigtable::v2::ReadRowsResponse*) {
+          token.Cancel();
+          return false;
+        });
+    EXPECT_CALL(*stream, Finish())
+        .WillOnce(
+            Return(grpc::Status(grpc::StatusCode::CANCELLED, "cancelled")));
+
+    EXPECT_CALL(*retry_policy_, OnFailureHook).Times(0);
+    EXPECT_CALL(*backoff_policy_, OnCompletionHook).Times(0);
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  google::cloud::CancellationScope scope(token);
+  bigtable::RowReader reader(
+      client_, "", bigtable::RowSet(), bigtable::RowReader::NO_ROWS_LIMIT,
+      bigtable::Filter::PassAllFilter(), std::move(retry_policy_),
+      std::move(backoff_policy_), metadata_update_policy_,
+      std::move(parser_factory_));
+
+  auto it = reader.begin();
+  EXPECT_NE(it, reader.end());
+  EXPECT_THAT(*it, StatusIs(StatusCode::kCancelled));
+}
+
 }  // anonymous namespace
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
@@ -0,0 +1,70 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/rows_by_keys.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+
+std::vector<std::vector<RowKeyType>> SplitRowKeys(
+    std::vector<RowKeyType> row_keys, ReadRowsByKeysOptions const& options) {
+  std::sort(row_keys.begin(), row_keys.end());
+  row_keys.erase(std::unique(row_keys.begin(), row_keys.end()),
+                 row_keys.end());
+  auto const max_keys =
+      (std::max)(options.max_keys_per_request, std::size_t{1});
+
+  std::vector<std::vector<RowKeyType>> batches;
+  std::vector<RowKeyType> current;
+  std::size_t current_bytes = 0;
+  for (auto& key : row_keys) {
+    if (key.empty()) continue;
+    if (!current.empty() &&
+        (current.size() == max_keys ||
+         current_bytes + key.size() > options.max_bytes_per_request)) {
+      batches.push_back(std::move(current));
+      current = {};
+      current_bytes = 0;
+    }
+    current_bytes += key.size();
+    current.push_back(std::move(key));
+  }
+  if (!current.empty()) batches.push_back(std::move(current));
+  return batches;
+}
+
+RowsByKeys MakeRowsByKeys(std::vector<RowKeyType> row_keys,
+                          std::vector<Row> rows) {
+  RowsByKeys result;
+  for (auto& row : rows) {
+    auto key = row.row_key();
+    result.rows.emplace(std::move(key), std::move(row));
+  }
+  std::sort(row_keys.begin(), row_keys.end());
+  row_keys.erase(std::unique(row_keys.begin(), row_keys.end()),
+                 row_keys.end());
+  for (auto& key : row_keys) {
+    if (result.rows.count(key) != 0) continue;
+    result.missing_keys.push_back(std::move(key));
+  }
+  return result;
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,89 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROWS_BY_KEYS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROWS_BY_KEYS_H
+
+#include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/row_key.h"
+#include "google/cloud/bigtable/version.h"
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/// Configure `Table::ReadRowsByKeys()` and `Table::AsyncReadRowsByKeys()`.
+struct ReadRowsByKeysOptions {
+  /// A single `ReadRows()` request will not ask for more keys than this.
+  ReadRowsByKeysOptions& SetMaxKeysPerRequest(std::size_t v) {
+    max_keys_per_request = v;
+    return *this;
+  }
+
+  /// The keys in a single `ReadRows()` request will not exceed this size.
+  ReadRowsByKeysOptions& SetMaxBytesPerRequest(std::size_t v) {
+    max_bytes_per_request = v;
+    return *this;
+  }
+
+  /// No more than this many `ReadRows()` requests will be in flight.
+  ReadRowsByKeysOptions& SetMaxConcurrency(std::size_t v) {
+    max_concurrency = v;
+    return *this;
+  }
+
+  std::size_t max_keys_per_request = 100;
+  std::size_t max_bytes_per_request = 64 * 1024;
+  std::size_t max_concurrency = 8;
+};
+
+/// The result of `Table::ReadRowsByKeys()` and `Table::AsyncReadRowsByKeys()`.
+struct RowsByKeys {
+  /// The rows found, keyed by row key.
+  std::map<RowKeyType, Row> rows;
+
+  /**
+   * The requested keys that were not found, in sorted order.
+   *
+   * Note that rows where the filter removes all the cells are not returned by
+   * the service, and are reported as missing too.
+   */
+  std::vector<RowKeyType> missing_keys;
+};
+
+/**
+ * Split @p row_keys into batches for `Table::ReadRowsByKeys()`.
+ *
+ * The keys are sorted and duplicates removed, so each batch covers a
+ * contiguous part of the table. Each batch has at most
+ * `options.max_keys_per_request` keys, and their total size is at most
+ * `options.max_bytes_per_request`, except that a single key always fits.
+ * Empty row keys are not valid, they are omitted.
+ */
+std::vector<std::vector<RowKeyType>> SplitRowKeys(
+    std::vector<RowKeyType> row_keys, ReadRowsByKeysOptions const& options);
+
+/// Create a `RowsByKeys` from the rows read for @p row_keys.
+RowsByKeys MakeRowsByKeys(std::vector<RowKeyType> row_keys,
+                          std::vector<Row> rows);
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROWS_BY_KEYS_H
@@ -0,0 +1,70 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/rows_by_keys.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(SplitRowKeysTest, Empty) {
+  EXPECT_TRUE(SplitRowKeys({}, ReadRowsByKeysOptions()).empty());
+  EXPECT_TRUE(SplitRowKeys({""}, ReadRowsByKeysOptions()).empty());
+}
+
+TEST(SplitRowKeysTest, SortsAndRemovesDuplicates) {
+  auto const actual =
+      SplitRowKeys({"c", "a", "b", "a", "", "c"}, ReadRowsByKeysOptions());
+  EXPECT_THAT(actual, ElementsAre(ElementsAre("a", "b", "c")));
+}
+
+TEST(SplitRowKeysTest, MaxKeys) {
+  auto const actual =
+      SplitRowKeys({"e", "d", "c", "b", "a"},
+                   ReadRowsByKeysOptions().SetMaxKeysPerRequest(2));
+  EXPECT_THAT(actual, ElementsAre(ElementsAre("a", "b"), ElementsAre("c", "d"),
+                                  ElementsAre("e")));
+}
+
+TEST(SplitRowKeysTest, MaxBytes) {
+  auto const actual = SplitRowKeys(
+      {"aaaa", "bb", "cc", std::string(10, 'd'), "e"},
+      ReadRowsByKeysOptions().SetMaxBytesPerRequest(6));
+  // Keys larger than the limit get a batch of their own.
+  EXPECT_THAT(actual,
+              ElementsAre(ElementsAre("aaaa", "bb"), ElementsAre("cc"),
+                          ElementsAre(std::string(10, 'd')), ElementsAre("e")));
+}
+
+TEST(MakeRowsByKeysTest, Basic) {
+  std::vector<Row> rows;
+  rows.emplace_back("b", std::vector<Cell>{});
+  rows.emplace_back("d", std::vector<Cell>{});
+  auto const actual = MakeRowsByKeys({"d", "c", "b", "a", "c"}, rows);
+  ASSERT_EQ(2U, actual.rows.size());
+  EXPECT_EQ("b", actual.rows.at("b").row_key());
+  EXPECT_EQ("d", actual.rows.at("d").row_key());
+  EXPECT_THAT(actual.missing_keys, ElementsAre("a", "c"));
+}
+
+}  // namespace
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -13,11 +13,16 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/rpc_backoff_policy.h"
+#include "google/cloud/bigtable/internal/policy_fast_path.h"
 
 namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+bool RPCBackoffPolicy::SetupFirstAttempt(grpc::ClientContext&) const {
+  return false;
+}
+
 std::unique_ptr<RPCBackoffPolicy> DefaultRPCBackoffPolicy(
     internal::RPCPolicyParameters defaults) {
   return std::unique_ptr<RPCBackoffPolicy>(new ExponentialBackoffPolicy(
@@ -35,6 +40,11 @@ std::unique_ptr<RPCBackoffPolicy> ExponentialBackoffPolicy::clone() const {
 
 void ExponentialBackoffPolicy::Setup(grpc::ClientContext&) const {}
 
+bool ExponentialBackoffPolicy::SetupFirstAttempt(
+    grpc::ClientContext&) const {
+  return internal::HasFirstAttemptFastPath<ExponentialBackoffPolicy>(*this);
+}
+
 std::chrono::milliseconds ExponentialBackoffPolicy::OnCompletion(
     google::cloud::Status const&) {
   return impl_.OnCompletion();
@@ -60,6 +60,18 @@ class RPCBackoffPolicy {
    */
   virtual void Setup(grpc::ClientContext& context) const = 0;
 
+  /**
+   * Update the ClientContext for the first call of a new operation, without
+   * cloning this policy.
+   *
+   * Policies can override this to avoid allocating a new policy for operations
+   * that succeed on the first attempt. If this returns `true` it must have the
+   * same effect as `clone()->Setup(context)`, and any retries use `clone()`.
+   * If it returns `false` the caller uses `clone()` and `Setup()` for all the
+   * attempts. The default implementation returns `false`.
+   */
+  virtual bool SetupFirstAttempt(grpc::ClientContext& context) const;
+
   /**
    * Return the delay after an RPC operation has completed.
    *
@@ -93,6 +105,7 @@ class ExponentialBackoffPolicy : public RPCBackoffPolicy {
 
   std::unique_ptr<RPCBackoffPolicy> clone() const override;
   void Setup(grpc::ClientContext& context) const override;
+  bool SetupFirstAttempt(grpc::ClientContext& context) const override;
   std::chrono::milliseconds OnCompletion(
       google::cloud::Status const& status) override;
   // TODO(#2344) - remove ::grpc::Status version.
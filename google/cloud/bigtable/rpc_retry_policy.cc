@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/rpc_retry_policy.h"
+#include "google/cloud/bigtable/internal/policy_fast_path.h"
 #include "google/cloud/grpc_error_delegate.h"
 #include <sstream>
 
@@ -26,6 +27,15 @@ std::unique_ptr<RPCRetryPolicy> DefaultRPCRetryPolicy(
       new LimitedTimeRetryPolicy(defaults.maximum_retry_period));
 }
 
+bool RPCRetryPolicy::SetupFirstAttempt(grpc::ClientContext&) const {
+  return false;
+}
+
+std::unique_ptr<RPCRetryPolicy> RPCRetryPolicy::CloneForRetry(
+    std::chrono::system_clock::time_point) const {
+  return clone();
+}
+
 std::unique_ptr<RPCRetryPolicy> LimitedErrorCountRetryPolicy::clone() const {
   return std::unique_ptr<RPCRetryPolicy>(
       new LimitedErrorCountRetryPolicy(*this));
@@ -33,6 +43,11 @@ std::unique_ptr<RPCRetryPolicy> LimitedErrorCountRetryPolicy::clone() const {
 
 void LimitedErrorCountRetryPolicy::Setup(grpc::ClientContext&) const {}
 
+bool LimitedErrorCountRetryPolicy::SetupFirstAttempt(
+    grpc::ClientContext&) const {
+  return internal::HasFirstAttemptFastPath<LimitedErrorCountRetryPolicy>(*this);
+}
+
 bool LimitedErrorCountRetryPolicy::OnFailure(
     google::cloud::Status const& status) {
   return impl_.OnFailure(status);
@@ -56,6 +71,26 @@ void LimitedTimeRetryPolicy::Setup(grpc::ClientContext& context) const {
   }
 }
 
+bool LimitedTimeRetryPolicy::SetupFirstAttempt(
+    grpc::ClientContext& context) const {
+  if (!internal::HasFirstAttemptFastPath<LimitedTimeRetryPolicy>(*this)) {
+    return false;
+  }
+  // Copying the implementation restarts the clock, as `clone()` would, without
+  // any allocations.
+  Impl const fresh(impl_);
+  if (context.deadline() >= fresh.deadline()) {
+    context.set_deadline(fresh.deadline());
+  }
+  return true;
+}
+
+std::unique_ptr<RPCRetryPolicy> LimitedTimeRetryPolicy::CloneForRetry(
+    std::chrono::system_clock::time_point first_attempt_start) const {
+  return std::unique_ptr<RPCRetryPolicy>(new LimitedTimeRetryPolicy(
+      impl_.maximum_duration(), first_attempt_start));
+}
+
 bool LimitedTimeRetryPolicy::OnFailure(google::cloud::Status const& status) {
   return impl_.OnFailure(status);
 }
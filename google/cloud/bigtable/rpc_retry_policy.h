@@ -100,6 +100,29 @@ class RPCRetryPolicy {
    */
   virtual void Setup(grpc::ClientContext& context) const = 0;
 
+  /**
+   * Update the ClientContext for the first call of a new operation, without
+   * cloning this policy.
+   *
+   * Policies can override this to avoid allocating a new policy for operations
+   * that succeed on the first attempt. If this returns `true` it must have the
+   * same effect as `clone()->Setup(context)`, and any retries use
+   * `CloneForRetry()`. If it returns `false` the caller uses `clone()` and
+   * `Setup()` for all the attempts. The default implementation returns
+   * `false`.
+   */
+  virtual bool SetupFirstAttempt(grpc::ClientContext& context) const;
+
+  /**
+   * Return a new copy of this object, to retry an operation whose first
+   * attempt used `SetupFirstAttempt()`.
+   *
+   * Policies that limit the time spent in an operation must count it from
+   * @p first_attempt_start. The default implementation returns `clone()`.
+   */
+  virtual std::unique_ptr<RPCRetryPolicy> CloneForRetry(
+      std::chrono::system_clock::time_point first_attempt_start) const;
+
   /**
    * Handle an RPC failure.
    *
@@ -132,6 +155,7 @@ class LimitedErrorCountRetryPolicy : public RPCRetryPolicy {
 
   std::unique_ptr<RPCRetryPolicy> clone() const override;
   void Setup(grpc::ClientContext& context) const override;
+  bool SetupFirstAttempt(grpc::ClientContext& context) const override;
   bool OnFailure(google::cloud::Status const& status) override;
   // TODO(#2344) - remove ::grpc::Status version.
   bool OnFailure(grpc::Status const& status) override;
@@ -154,11 +178,18 @@ class LimitedTimeRetryPolicy : public RPCRetryPolicy {
 
   std::unique_ptr<RPCRetryPolicy> clone() const override;
   void Setup(grpc::ClientContext& context) const override;
+  bool SetupFirstAttempt(grpc::ClientContext& context) const override;
+  std::unique_ptr<RPCRetryPolicy> CloneForRetry(
+      std::chrono::system_clock::time_point first_attempt_start) const override;
   bool OnFailure(google::cloud::Status const& status) override;
   // TODO(#2344) - remove ::grpc::Status version.
   bool OnFailure(grpc::Status const& status) override;
 
  private:
+  LimitedTimeRetryPolicy(std::chrono::milliseconds maximum_duration,
+                         std::chrono::system_clock::time_point start)
+      : impl_(maximum_duration, start) {}
+
   using Impl =
       google::cloud::internal::LimitedTimeRetryPolicy<internal::SafeGrpcRetry>;
   Impl impl_;
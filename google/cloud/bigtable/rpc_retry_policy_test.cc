@@ -82,6 +82,44 @@ TEST(LimitedTimeRetryPolicy, OnNonRetryable) {
   EXPECT_FALSE(tested.OnFailure(CreatePermanentError()));
 }
 
+/// @test Verify that SetupFirstAttempt() uses a fresh deadline.
+TEST(LimitedTimeRetryPolicy, SetupFirstAttempt) {
+  LimitedTimeRetryPolicy tested(kLimitedTimeTestPeriod);
+  std::this_thread::sleep_for(2 * kLimitedTimeTestPeriod);
+
+  // The deadline of the prototype has expired, but a new operation gets the
+  // full period, as it would with `tested.clone()->Setup()`.
+  auto const start = std::chrono::system_clock::now();
+  grpc::ClientContext context;
+  EXPECT_TRUE(tested.SetupFirstAttempt(context));
+  EXPECT_LE(start + kLimitedTimeTestPeriod, context.deadline());
+  EXPECT_GE(std::chrono::system_clock::now() + kLimitedTimeTestPeriod,
+            context.deadline());
+}
+
+/// @test Verify that CloneForRetry() counts time from the first attempt.
+TEST(LimitedTimeRetryPolicy, CloneForRetry) {
+  LimitedTimeRetryPolicy original(kLimitedTimeTestPeriod);
+  auto const now = std::chrono::system_clock::now();
+
+  auto tested = original.CloneForRetry(now);
+  CheckLimitedTime(*tested);
+
+  auto expired = original.CloneForRetry(now - 2 * kLimitedTimeTestPeriod);
+  EXPECT_FALSE(expired->OnFailure(CreateTransientError()));
+}
+
+/// @test Verify that subclasses do not use the SetupFirstAttempt() fast path.
+TEST(LimitedTimeRetryPolicy, SetupFirstAttemptSubclass) {
+  class Subclass : public LimitedTimeRetryPolicy {
+   public:
+    Subclass() : LimitedTimeRetryPolicy(kLimitedTimeTestPeriod) {}
+  };
+  Subclass tested;
+  grpc::ClientContext context;
+  EXPECT_FALSE(tested.SetupFirstAttempt(context));
+}
+
 /// @test A simple test for the LimitedErrorCountRetryPolicy.
 TEST(LimitedErrorCountRetryPolicy, Simple) {
   LimitedErrorCountRetryPolicy tested(3);
@@ -0,0 +1,140 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/split_point_cache.h"
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+
+class SplitPointCache::State
+    : public std::enable_shared_from_this<SplitPointCache::State> {
+ public:
+  State(Table table, CompletionQueue cq, Options options)
+      : table_(std::move(table)),
+        cq_(std::move(cq)),
+        options_(std::move(options)),
+        split_points_(std::make_shared<SplitPoints const>()) {}
+
+  std::shared_ptr<SplitPoints const> split_points() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return split_points_;
+  }
+
+  future<Status> Refresh() {
+    auto p = std::make_shared<promise<Status>>();
+    auto f = p->get_future();
+    // There is no asynchronous version of `SampleRows()`, run it in one of
+    // the completion queue threads.
+    auto self = shared_from_this();
+    cq_.RunAsync([self, p](CompletionQueue&) { p->set_value(self->Sample()); });
+    return f;
+  }
+
+  void RefreshAndSchedule() {
+    std::weak_ptr<State> w = shared_from_this();
+    Refresh().then([w](future<Status>) {
+      if (auto self = w.lock()) self->ScheduleNext();
+    });
+  }
+
+  void Stop() {
+    future<void> timer;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      stopped_ = true;
+      timer = std::move(timer_);
+    }
+    if (timer.valid()) timer.cancel();
+  }
+
+ private:
+  Status Sample() {
+    // `Table` is not thread-safe, use a copy for each refresh.
+    auto table = table_;
+    auto samples = table.SampleRows();
+    if (!samples) return std::move(samples).status();
+    SplitPoints points;
+    points.reserve(samples->size());
+    for (auto& sample : *samples) {
+      // The last sample is the end of the table, an empty key.
+      if (sample.row_key.empty()) continue;
+      points.push_back(std::move(sample.row_key));
+    }
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    auto p = std::make_shared<SplitPoints const>(std::move(points));
+    std::lock_guard<std::mutex> lk(mu_);
+    split_points_ = std::move(p);
+    return Status();
+  }
+
+  void ScheduleNext() {
+    std::weak_ptr<State> w = shared_from_this();
+    std::lock_guard<std::mutex> lk(mu_);
+    if (stopped_) return;
+    timer_ =
+        cq_.MakeRelativeTimer(options_.refresh_period)
+            .then([w](future<StatusOr<std::chrono::system_clock::time_point>>
+                          f) {
+              // The timer is cancelled when the cache is destroyed.
+              if (!f.get()) return;
+              if (auto self = w.lock()) self->RefreshAndSchedule();
+            });
+  }
+
+  Table const table_;
+  CompletionQueue cq_;
+  Options const options_;
+  std::mutex mu_;
+  std::shared_ptr<SplitPoints const> split_points_;  // GUARDED_BY(mu_)
+  future<void> timer_;                               // GUARDED_BY(mu_)
+  bool stopped_ = false;                             // GUARDED_BY(mu_)
+};
+
+SplitPointCache::SplitPointCache(Table table, CompletionQueue cq,
+                                 Options options)
+    : state_(std::make_shared<State>(std::move(table), std::move(cq),
+                                     std::move(options))) {
+  state_->RefreshAndSchedule();
+}
+
+SplitPointCache::~SplitPointCache() { state_->Stop(); }
+
+std::shared_ptr<SplitPointCache::SplitPoints const>
+SplitPointCache::split_points() const {
+  return state_->split_points();
+}
+
+std::size_t SplitPointCache::RangeIndex(std::string const& row_key) const {
+  auto points = split_points();
+  return static_cast<std::size_t>(
+      std::upper_bound(points->begin(), points->end(), row_key) -
+      points->begin());
+}
+
+std::size_t SplitPointCache::range_count() const {
+  return split_points()->size() + 1;
+}
+
+future<Status> SplitPointCache::Refresh() { return state_->Refresh(); }
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
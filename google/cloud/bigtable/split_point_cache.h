@@ -0,0 +1,117 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_SPLIT_POINT_CACHE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_SPLIT_POINT_CACHE_H
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Caches the split points of a table, refreshing them in the background.
+ *
+ * Parallel scans, batching mutations by key range, and pre-splitting work all
+ * need the boundaries between the tablets of a table. `Table::SampleRows()`
+ * returns them, but it is a streaming RPC, too expensive to call for each
+ * operation. Objects of this class call `SampleRows()` once on creation, and
+ * then periodically, so multiple readers and batchers can share the results.
+ *
+ * The split points divide the table in `split_points().size() + 1` ranges:
+ * range `i` contains the keys in `[split_points[i - 1], split_points[i])`,
+ * where the first range starts with the empty key and the last range has no
+ * upper bound. The split points are empty until the first refresh completes,
+ * and if it fails, in which case the whole table is a single range. Failed
+ * refreshes keep the previous split points.
+ *
+ * Applications must run the event loop of the `CompletionQueue` in one or
+ * more threads.
+ *
+ * @par Thread-safety
+ * Instances of this class are guaranteed to work when accessed concurrently
+ * from multiple threads.
+ *
+ * @par Example
+ * @code
+ * namespace cbt = google::cloud::bigtable;
+ * auto splits = std::make_shared<cbt::SplitPointCache>(table, cq);
+ * splits->Refresh().get();  // optionally wait for the first refresh
+ * auto shard = splits->RangeIndex("user#1234");
+ * @endcode
+ */
+class SplitPointCache {
+ public:
+  /// Configure a `SplitPointCache`.
+  struct Options {
+    Options() = default;
+
+    /// How often the split points are refreshed.
+    Options& SetRefreshPeriod(std::chrono::milliseconds v) {
+      refresh_period = v;
+      return *this;
+    }
+
+    std::chrono::milliseconds refresh_period = std::chrono::minutes(5);
+  };
+
+  using SplitPoints = std::vector<std::string>;
+
+  SplitPointCache(Table table, CompletionQueue cq, Options options = Options());
+
+  /// Stops the background refreshes.
+  ~SplitPointCache();
+
+  SplitPointCache(SplitPointCache const&) = delete;
+  SplitPointCache& operator=(SplitPointCache const&) = delete;
+
+  /// The current split points, sorted and without duplicates.
+  std::shared_ptr<SplitPoints const> split_points() const;
+
+  /// The index of the range containing @p row_key.
+  std::size_t RangeIndex(std::string const& row_key) const;
+
+  /// The number of ranges, that is, `split_points().size() + 1`.
+  std::size_t range_count() const;
+
+  /**
+   * Refresh the split points now.
+   *
+   * @return a future satisfied with the result of `SampleRows()` once the
+   *     split points are updated. The periodic refreshes continue on their
+   *     schedule.
+   */
+  future<Status> Refresh();
+
+ private:
+  class State;
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_SPLIT_POINT_CACHE_H
@@ -0,0 +1,124 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/split_point_cache.h"
+#include "google/cloud/bigtable/testing/mock_sample_row_keys_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/fake_completion_queue_impl.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+
+namespace btproto = ::google::bigtable::v2;
+using ::google::cloud::bigtable::testing::MockSampleRowKeysReader;
+using ::google::cloud::testing_util::FakeCompletionQueueImpl;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::Return;
+using ::testing::Unused;
+
+class SplitPointCacheTest
+    : public ::google::cloud::bigtable::testing::TableTestFixture {
+ protected:
+  using Reader = grpc::ClientReaderInterface<btproto::SampleRowKeysResponse>;
+
+  // Returns a `SampleRowKeys` action returning @p keys and then @p status.
+  static std::function<std::unique_ptr<Reader>(
+      grpc::ClientContext*, btproto::SampleRowKeysRequest const&)>
+  Samples(std::vector<std::string> keys,
+          grpc::Status status = grpc::Status::OK) {
+    return [keys, status](Unused, Unused) {
+      auto reader = absl::make_unique<MockSampleRowKeysReader>(
+          "google.bigtable.v2.Bigtable.SampleRowKeys");
+      auto& read = EXPECT_CALL(*reader, Read);
+      for (auto const& k : keys) {
+        read.WillOnce([k](btproto::SampleRowKeysResponse* r) {
+          r->set_row_key(k);
+          return true;
+        });
+      }
+      read.WillOnce(Return(false));
+      EXPECT_CALL(*reader, Finish).WillOnce(Return(status));
+      return std::unique_ptr<Reader>(std::move(reader));
+    };
+  }
+
+  std::shared_ptr<FakeCompletionQueueImpl> cq_impl_ =
+      std::make_shared<FakeCompletionQueueImpl>();
+  CompletionQueue cq_ = CompletionQueue(cq_impl_);
+};
+
+TEST_F(SplitPointCacheTest, RefreshesInBackground) {
+  EXPECT_CALL(*client_, SampleRowKeys)
+      .WillOnce(Samples({"m", "f", ""}))
+      .WillOnce(Samples({"c", "m", "t", ""}));
+
+  SplitPointCache tested(table_, cq_,
+                         SplitPointCache::Options().SetRefreshPeriod(
+                             std::chrono::milliseconds(10)));
+  // Until the first refresh completes the table is a single range.
+  EXPECT_TRUE(tested.split_points()->empty());
+  EXPECT_EQ(1U, tested.range_count());
+  EXPECT_EQ(0U, tested.RangeIndex("z"));
+
+  // Run the first refresh.
+  cq_impl_->SimulateCompletion(true);
+  EXPECT_THAT(*tested.split_points(), ElementsAre("f", "m"));
+  EXPECT_EQ(3U, tested.range_count());
+  EXPECT_EQ(0U, tested.RangeIndex(""));
+  EXPECT_EQ(0U, tested.RangeIndex("a"));
+  EXPECT_EQ(1U, tested.RangeIndex("f"));
+  EXPECT_EQ(1U, tested.RangeIndex("ff"));
+  EXPECT_EQ(2U, tested.RangeIndex("m"));
+  EXPECT_EQ(2U, tested.RangeIndex("z"));
+
+  // The split points are shared, callers keep a consistent snapshot.
+  auto snapshot = tested.split_points();
+  // Expire the timer, and then run the refresh.
+  cq_impl_->SimulateCompletion(true);
+  cq_impl_->SimulateCompletion(true);
+  EXPECT_THAT(*tested.split_points(), ElementsAre("c", "m", "t"));
+  EXPECT_THAT(*snapshot, ElementsAre("f", "m"));
+}
+
+TEST_F(SplitPointCacheTest, FailedRefreshKeepsSplitPoints) {
+  EXPECT_CALL(*client_, SampleRowKeys)
+      .WillOnce(Samples({"m", ""}))
+      .WillOnce(Samples({}, grpc::Status(grpc::StatusCode::PERMISSION_DENIED,
+                                         "uh-oh")));
+
+  SplitPointCache tested(table_, cq_);
+  cq_impl_->SimulateCompletion(true);
+  EXPECT_THAT(*tested.split_points(), ElementsAre("m"));
+
+  auto refresh = tested.Refresh();
+  cq_impl_->SimulateCompletion(true);
+  EXPECT_THAT(refresh.get(), StatusIs(StatusCode::kPermissionDenied));
+  EXPECT_THAT(*tested.split_points(), ElementsAre("m"));
+}
+
+}  // namespace
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
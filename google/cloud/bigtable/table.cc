@@ -15,9 +15,14 @@
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/bigtable/internal/async_bulk_apply.h"
 #include "google/cloud/bigtable/internal/bulk_mutator.h"
+#include "google/cloud/bigtable/internal/hedged_client_reader.h"
 #include "google/cloud/bigtable/internal/unary_client_utils.h"
 #include "google/cloud/grpc_error_delegate.h"
 #include "google/cloud/internal/async_retry_unary_rpc.h"
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <mutex>
 #include <thread>
 #include <type_traits>
 
@@ -69,37 +74,51 @@ static_assert(std::is_copy_assignable<bigtable::Table>::value,
               "bigtable::Table must be CopyAssignable");
 
 Status Table::Apply(SingleRowMutation mut) {
-  // Copy the policies in effect for this operation.  Many policy classes change
-  // their state as the operation makes progress (or fails to make progress), so
-  // we need fresh instances.
-  auto rpc_policy = clone_rpc_retry_policy();
-  auto backoff_policy = clone_rpc_backoff_policy();
-  auto idempotent_policy = clone_idempotent_mutation_policy();
-
   // Build the RPC request, try to minimize copying.
   btproto::MutateRowRequest request;
   SetCommonTableOperationRequest<btproto::MutateRowRequest>(
       request, app_profile_id_, table_name_);
   mut.MoveTo(request);
 
+  // Copy the policies in effect for this operation.  Many policy classes change
+  // their state as the operation makes progress (or fails to make progress), so
+  // we need fresh instances. Most mutations succeed on the first attempt, so
+  // when the policies support it make that attempt with the prototypes, and
+  // only copy them to retry.
+  auto const start = std::chrono::system_clock::now();
   bool const is_idempotent =
       std::all_of(request.mutations().begin(), request.mutations().end(),
-                  [&idempotent_policy](btproto::Mutation const& m) {
-                    return idempotent_policy->is_idempotent(m);
+                  [this](btproto::Mutation const& m) {
+                    return idempotent_mutation_policy_->is_idempotent(m);
                   });
-
+  std::unique_ptr<RPCRetryPolicy> rpc_policy;
+  std::unique_ptr<RPCBackoffPolicy> backoff_policy;
   btproto::MutateRowResponse response;
   grpc::Status status;
   while (true) {
     grpc::ClientContext client_context;
-    rpc_policy->Setup(client_context);
-    backoff_policy->Setup(client_context);
+    if (rpc_policy) {
+      rpc_policy->Setup(client_context);
+      backoff_policy->Setup(client_context);
+    } else if (!rpc_retry_policy_prototype_->SetupFirstAttempt(
+                   client_context) ||
+               !rpc_backoff_policy_prototype_->SetupFirstAttempt(
+                   client_context)) {
+      rpc_policy = clone_rpc_retry_policy();
+      backoff_policy = clone_rpc_backoff_policy();
+      rpc_policy->Setup(client_context);
+      backoff_policy->Setup(client_context);
+    }
     metadata_update_policy_.Setup(client_context);
     status = client_->MutateRow(&client_context, request, &response);
 
     if (status.ok()) {
       return google::cloud::Status{};
     }
+    if (!rpc_policy) {
+      rpc_policy = rpc_retry_policy_prototype_->CloneForRetry(start);
+      backoff_policy = clone_rpc_backoff_policy();
+    }
     // It is up to the policy to terminate this loop, it could run
     // forever, but that would be a bad policy (pun intended).
     if (!rpc_policy->OnFailure(status) || !is_idempotent) {
@@ -185,28 +204,98 @@ future<std::vector<FailedMutation>> Table::AsyncBulkApply(BulkMutation mut,
 }
 
 RowReader Table::ReadRows(RowSet row_set, Filter filter) {
-  return RowReader(
-      client_, app_profile_id_, table_name_, std::move(row_set),
-      RowReader::NO_ROWS_LIMIT, std::move(filter), clone_rpc_retry_policy(),
-      clone_rpc_backoff_policy(), metadata_update_policy_,
-      absl::make_unique<bigtable::internal::ReadRowsParserFactory>());
+  return ReadRows(std::move(row_set), RowReader::NO_ROWS_LIMIT,
+                  PrepareReadRows(std::move(filter)));
 }
 
 RowReader Table::ReadRows(RowSet row_set, std::int64_t rows_limit,
                           Filter filter) {
-  return RowReader(
-      client_, app_profile_id_, table_name_, std::move(row_set), rows_limit,
-      std::move(filter), clone_rpc_retry_policy(), clone_rpc_backoff_policy(),
+  return ReadRows(std::move(row_set), rows_limit,
+                  PrepareReadRows(std::move(filter)));
+}
+
+RowReader Table::ReadRows(RowSet row_set,
+                          PreparedReadRowsRequest const& prepared) {
+  return ReadRows(std::move(row_set), RowReader::NO_ROWS_LIMIT, prepared);
+}
+
+RowReader Table::ReadRows(RowSet row_set, std::int64_t rows_limit,
+                          PreparedReadRowsRequest const& prepared) {
+  RowReader reader(
+      client_, prepared, std::move(row_set), rows_limit,
+      clone_rpc_retry_policy(), clone_rpc_backoff_policy(),
       metadata_update_policy_,
       absl::make_unique<bigtable::internal::ReadRowsParserFactory>());
+  reader.hedging_policy_ = hedging_policy_;
+  return reader;
+}
+
+Status Table::ReadRows(RowSet row_set, Filter filter,
+                       ReadRowsVisitor& visitor) {
+  auto adapter = std::make_shared<internal::ReadRowsVisitorAdapter>(visitor);
+  RowReader reader(
+      client_, PrepareReadRows(std::move(filter)), std::move(row_set),
+      RowReader::NO_ROWS_LIMIT, clone_rpc_retry_policy(),
+      clone_rpc_backoff_policy(), metadata_update_policy_,
+      absl::make_unique<internal::StreamingReadRowsParserFactory>(adapter));
+  reader.hedging_policy_ = hedging_policy_;
+  // The rows returned by the reader have no cells, they only signal that a
+  // row was committed.
+  Status status;
+  for (auto& row : reader) {
+    if (!row) {
+      status = std::move(row).status();
+      break;
+    }
+    if (adapter->stopped()) {
+      reader.Cancel();
+      break;
+    }
+  }
+  // Discard any partial row left by a failed stream.
+  adapter->OnRowReset();
+  return status;
+}
+
+future<Status> Table::AsyncReadRows(CompletionQueue& cq, RowSet row_set,
+                                    Filter filter,
+                                    std::shared_ptr<ReadRowsVisitor> visitor) {
+  auto adapter = std::make_shared<internal::ReadRowsVisitorAdapter>(*visitor);
+  auto done = std::make_shared<promise<Status>>();
+  auto f = done->get_future();
+  auto on_row = [adapter](Row const&) {
+    return make_ready_future(!adapter->stopped());
+  };
+  // The visitor must live until the read completes.
+  auto on_finish = [adapter, visitor, done](Status status) {
+    adapter->OnRowReset();
+    // Stopping the read cancels the stream, that is not an error.
+    if (adapter->stopped() && status.code() == StatusCode::kCancelled) {
+      status = Status();
+    }
+    done->set_value(std::move(status));
+  };
+  using Reader = AsyncRowReader<decltype(on_row), decltype(on_finish)>;
+  Reader::Create(
+      cq, client_, app_profile_id_, table_name_, std::move(on_row),
+      std::move(on_finish), std::move(row_set), Reader::NO_ROWS_LIMIT,
+      std::move(filter), clone_rpc_retry_policy(), clone_rpc_backoff_policy(),
+      metadata_update_policy_,
+      absl::make_unique<internal::StreamingReadRowsParserFactory>(
+          std::move(adapter)));
+  return f;
 }
 
 StatusOr<std::pair<bool, Row>> Table::ReadRow(std::string row_key,
                                               Filter filter) {
+  return ReadRow(std::move(row_key), PrepareReadRows(std::move(filter)));
+}
+
+StatusOr<std::pair<bool, Row>> Table::ReadRow(
+    std::string row_key, PreparedReadRowsRequest const& prepared) {
   RowSet row_set(std::move(row_key));
   std::int64_t const rows_limit = 1;
-  RowReader reader =
-      ReadRows(std::move(row_set), rows_limit, std::move(filter));
+  RowReader reader = ReadRows(std::move(row_set), rows_limit, prepared);
 
   auto it = reader.begin();
   if (it == reader.end()) {
@@ -223,6 +312,49 @@ StatusOr<std::pair<bool, Row>> Table::ReadRow(std::string row_key,
   return result;
 }
 
+StatusOr<RowsByKeys> Table::ReadRowsByKeys(
+    std::vector<RowKeyType> row_keys, Filter filter,
+    ReadRowsByKeysOptions const& options) {
+  auto const batches = SplitRowKeys(row_keys, options);
+  std::vector<std::vector<Row>> results(batches.size());
+  std::vector<Status> statuses(batches.size());
+  std::atomic<std::size_t> next_batch{0};
+  std::atomic<bool> failed{false};
+  auto const prepared = PrepareReadRows(std::move(filter));
+  auto worker = [&](Table table) {
+    for (auto i = next_batch++; i < batches.size() && !failed.load();
+         i = next_batch++) {
+      RowSet row_set;
+      for (auto const& key : batches[i]) row_set.Append(key);
+      for (auto& row : table.ReadRows(std::move(row_set), prepared)) {
+        if (!row) {
+          statuses[i] = std::move(row).status();
+          failed.store(true);
+          break;
+        }
+        results[i].push_back(*std::move(row));
+      }
+    }
+  };
+
+  auto const concurrency = (std::min)(
+      (std::max)(options.max_concurrency, std::size_t{1}), batches.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < concurrency; ++i) {
+    threads.emplace_back(worker, *this);
+  }
+  // Use the calling thread as one of the workers.
+  worker(*this);
+  for (auto& t : threads) t.join();
+
+  std::vector<Row> rows;
+  for (std::size_t i = 0; i != batches.size(); ++i) {
+    if (!statuses[i].ok()) return std::move(statuses[i]);
+    std::move(results[i].begin(), results[i].end(), std::back_inserter(rows));
+  }
+  return MakeRowsByKeys(std::move(row_keys), std::move(rows));
+}
+
 StatusOr<MutationBranch> Table::CheckAndMutateRow(
     std::string row_key, Filter filter, std::vector<Mutation> true_mutations,
     std::vector<Mutation> false_mutations) {
@@ -241,8 +373,8 @@ StatusOr<MutationBranch> Table::CheckAndMutateRow(
   auto const idempotency = idempotent_mutation_policy_->is_idempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  auto response = ClientUtils::MakeCall(
-      *client_, clone_rpc_retry_policy(), clone_rpc_backoff_policy(),
+  auto response = ClientUtils::MakeCallFromPrototypes(
+      *client_, *rpc_retry_policy_prototype_, *rpc_backoff_policy_prototype_,
       metadata_update_policy_, &DataClient::CheckAndMutateRow, request,
       "Table::CheckAndMutateRow", status, idempotency);
 
@@ -319,7 +451,18 @@ StatusOr<std::vector<bigtable::RowKeySample>> Table::SampleRows() {
     retry_policy->Setup(client_context);
     clone_metadata_update_policy().Setup(client_context);
 
-    auto stream = client_->SampleRowKeys(&client_context, request);
+    auto stream = internal::MaybeHedge<btproto::SampleRowKeysResponse>(
+        hedging_policy_, &client_context,
+        [this, &request](grpc::ClientContext* context) {
+          return client_->SampleRowKeys(context, request);
+        },
+        [this, &backoff_policy, &retry_policy] {
+          auto context = absl::make_unique<grpc::ClientContext>();
+          backoff_policy->Setup(*context);
+          retry_policy->Setup(*context);
+          clone_metadata_update_policy().Setup(*context);
+          return context;
+        });
     while (stream->Read(&response)) {
       bigtable::RowKeySample row_sample;
       row_sample.offset_bytes = response.offset_bytes();
@@ -350,7 +493,7 @@ StatusOr<Row> Table::ReadModifyWriteRowImpl(
 
   grpc::Status status;
   auto response = ClientUtils::MakeNonIdempotentCall(
-      *(client_), clone_rpc_retry_policy(), clone_metadata_update_policy(),
+      *(client_), *rpc_retry_policy_prototype_, metadata_update_policy_,
       &DataClient::ReadModifyWriteRow, request, "ReadModifyWriteRowRequest",
       status);
   if (!status.ok()) {
@@ -447,6 +590,101 @@ future<StatusOr<std::pair<bool, Row>>> Table::AsyncReadRow(CompletionQueue& cq,
   return handler->GetFuture();
 }
 
+future<StatusOr<RowsByKeys>> Table::AsyncReadRowsByKeys(
+    CompletionQueue& cq, std::vector<RowKeyType> row_keys, Filter filter,
+    ReadRowsByKeysOptions const& options) {
+  class AsyncReadRowsByKeysHandler
+      : public std::enable_shared_from_this<AsyncReadRowsByKeysHandler> {
+   public:
+    AsyncReadRowsByKeysHandler(Table table, CompletionQueue cq,
+                               std::vector<RowKeyType> row_keys, Filter filter,
+                               ReadRowsByKeysOptions const& options)
+        : table_(std::move(table)),
+          cq_(std::move(cq)),
+          batches_(SplitRowKeys(row_keys, options)),
+          row_keys_(std::move(row_keys)),
+          filter_(std::move(filter)) {}
+
+    future<StatusOr<RowsByKeys>> Start(std::size_t max_concurrency) {
+      auto f = promise_.get_future();
+      auto const concurrency = (std::max)(max_concurrency, std::size_t{1});
+      std::unique_lock<std::mutex> lk(mu_);
+      // Prevent the requests that complete immediately from satisfying the
+      // promise before all the initial requests start.
+      ++outstanding_;
+      for (std::size_t i = 0; i != concurrency && CanStart(); ++i) {
+        StartNext(lk);
+      }
+      --outstanding_;
+      MaybeFinish(std::move(lk));
+      return f;
+    }
+
+   private:
+    bool CanStart() const {
+      return status_.ok() && next_batch_ != batches_.size();
+    }
+
+    // Start the next batch, `lk` is released while the request starts.
+    void StartNext(std::unique_lock<std::mutex>& lk) {
+      RowSet row_set;
+      for (auto const& key : batches_[next_batch_]) row_set.Append(key);
+      ++next_batch_;
+      ++outstanding_;
+      // Each request uses its own copy, `Table` is not thread-safe.
+      auto table = table_;
+      lk.unlock();
+      auto self = shared_from_this();
+      table.AsyncReadRows(
+          cq_,
+          [self](Row row) {
+            std::lock_guard<std::mutex> lk(self->mu_);
+            self->rows_.push_back(std::move(row));
+            return make_ready_future(true);
+          },
+          [self](Status status) { self->OnFinish(std::move(status)); },
+          std::move(row_set), filter_);
+      lk.lock();
+    }
+
+    void OnFinish(Status status) {
+      std::unique_lock<std::mutex> lk(mu_);
+      --outstanding_;
+      if (!status.ok() && status_.ok()) status_ = std::move(status);
+      if (CanStart()) StartNext(lk);
+      MaybeFinish(std::move(lk));
+    }
+
+    // Satisfy the promise once all the requests are done.
+    void MaybeFinish(std::unique_lock<std::mutex> lk) {
+      if (outstanding_ != 0) return;
+      lk.unlock();
+      if (!status_.ok()) {
+        promise_.set_value(std::move(status_));
+        return;
+      }
+      promise_.set_value(
+          MakeRowsByKeys(std::move(row_keys_), std::move(rows_)));
+    }
+
+    Table table_;
+    CompletionQueue cq_;
+    std::vector<std::vector<RowKeyType>> const batches_;
+    std::vector<RowKeyType> row_keys_;
+    Filter const filter_;
+    std::mutex mu_;
+    std::size_t next_batch_ = 0;   // GUARDED_BY(mu_)
+    std::size_t outstanding_ = 0;  // GUARDED_BY(mu_)
+    Status status_;                // GUARDED_BY(mu_)
+    std::vector<Row> rows_;        // GUARDED_BY(mu_)
+    promise<StatusOr<RowsByKeys>> promise_;
+  };
+
+  auto handler = std::make_shared<AsyncReadRowsByKeysHandler>(
+      *this, cq, std::move(row_keys), std::move(filter), options);
+  return handler->Start(options.max_concurrency);
+}
+
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
 }  // namespace cloud
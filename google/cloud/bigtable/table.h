@@ -19,12 +19,16 @@
 #include "google/cloud/bigtable/completion_queue.h"
 #include "google/cloud/bigtable/data_client.h"
 #include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/hedging_policy.h"
 #include "google/cloud/bigtable/idempotent_mutation_policy.h"
 #include "google/cloud/bigtable/mutations.h"
+#include "google/cloud/bigtable/prepared_read_rows_request.h"
 #include "google/cloud/bigtable/read_modify_write_rule.h"
+#include "google/cloud/bigtable/read_rows_visitor.h"
 #include "google/cloud/bigtable/row_key_sample.h"
 #include "google/cloud/bigtable/row_reader.h"
 #include "google/cloud/bigtable/row_set.h"
+#include "google/cloud/bigtable/rows_by_keys.h"
 #include "google/cloud/bigtable/rpc_backoff_policy.h"
 #include "google/cloud/bigtable/rpc_retry_policy.h"
 #include "google/cloud/bigtable/version.h"
@@ -172,7 +176,8 @@ class Table {
   struct ValidPolicy
       : absl::disjunction<std::is_base_of<RPCBackoffPolicy, P>,
                           std::is_base_of<RPCRetryPolicy, P>,
-                          std::is_base_of<IdempotentMutationPolicy, P>> {};
+                          std::is_base_of<IdempotentMutationPolicy, P>,
+                          std::is_base_of<HedgingPolicy, P>> {};
 
   /// A meta function to check if all the @p Policies are valid policy types.
   template <typename... Policies>
@@ -249,6 +254,9 @@ class Table {
    * @tparam Policies the types of the policies to override, the types must
    *     derive from one of the following types:
    *
+   *     - `HedgingPolicy` when to send a second copy of slow point reads. Use
+   *       `LatencyHedgingPolicy` to hedge the reads slower than a percentile
+   *       of the recent latencies. Reads are not hedged by default.
    *     - `IdempotentMutationPolicy` which mutations are retried. Use
    *       `SafeIdempotentMutationPolicy` to only retry idempotent operations,
    *       use `AlwaysRetryMutationPolicy` to retry all operations. Read the
@@ -313,6 +321,9 @@ class Table {
    * @param policies the set of policy overrides for this object.
    * @tparam Policies the types of the policies to override, the types must
    *     derive from one of the following types:
+   *     - `HedgingPolicy` when to send a second copy of slow point reads. Use
+   *       `LatencyHedgingPolicy` to hedge the reads slower than a percentile
+   *       of the recent latencies. Reads are not hedged by default.
    *     - `IdempotentMutationPolicy` which mutations are retried. Use
    *       `SafeIdempotentMutationPolicy` to only retry idempotent operations,
    *       use `AlwaysRetryMutationPolicy` to retry all operations. Read the
@@ -505,6 +516,33 @@ class Table {
    */
   RowReader ReadRows(RowSet row_set, std::int64_t rows_limit, Filter filter);
 
+  /**
+   * Reads a set of rows from the table, delivering each cell to a visitor.
+   *
+   * Unlike the overloads returning a `RowReader`, this function does not
+   * build a `Row` with all the cells of each row. The cells are delivered to
+   * @p visitor as soon as they are received, so the memory used does not
+   * depend on the size of the rows. Use this function to process very wide
+   * rows incrementally.
+   *
+   * @param row_set the rows to read from.
+   * @param filter is applied on the server-side to data in the rows.
+   * @param visitor receives the cells, and is notified when each row starts,
+   *     is committed, or is reset. See `ReadRowsVisitor` for details.
+   * @returns the status of the read. It is OK if all the rows were read, or if
+   *     the visitor stopped the read.
+   *
+   * @par Idempotency
+   * This is a read-only operation and therefore it is always idempotent.
+   *
+   * @par Thread-safety
+   * Two threads concurrently calling this member function on the same instance
+   * of this class are **not** guaranteed to work. Consider copying the object
+   * and using different copies in each thread. The visitor callbacks are
+   * called from the thread calling this function.
+   */
+  Status ReadRows(RowSet row_set, Filter filter, ReadRowsVisitor& visitor);
+
   /**
    * Read and return a single row from the table.
    *
@@ -529,6 +567,70 @@ class Table {
    */
   StatusOr<std::pair<bool, Row>> ReadRow(std::string row_key, Filter filter);
 
+  /**
+   * Prepare the parts of a `ReadRows()` request that do not change.
+   *
+   * Applications that read with the same filter many times can prepare the
+   * request once and pass it to `ReadRows()` or `ReadRow()`, instead of
+   * building and converting the filter for each call.
+   *
+   * The returned object is only valid for this table (and copies of this
+   * object), it captures the table name and app profile id.
+   *
+   * @par Example
+   * @code
+   * auto prepared = table.PrepareReadRows(
+   *     cbt::Filter::Chain(cbt::Filter::FamilyRegex("fam"),
+   *                        cbt::Filter::Latest(1)));
+   * for (auto const& key : keys) {
+   *   auto row = table.ReadRow(key, prepared);
+   *   // ... process row ...
+   * }
+   * @endcode
+   */
+  PreparedReadRowsRequest PrepareReadRows(Filter filter) const {
+    return PreparedReadRowsRequest(table_name_, app_profile_id_,
+                                   std::move(filter));
+  }
+
+  /// Reads a set of rows from the table, using a prepared request.
+  RowReader ReadRows(RowSet row_set, PreparedReadRowsRequest const& prepared);
+
+  /// Reads a limited set of rows from the table, using a prepared request.
+  RowReader ReadRows(RowSet row_set, std::int64_t rows_limit,
+                     PreparedReadRowsRequest const& prepared);
+
+  /// Read and return a single row from the table, using a prepared request.
+  StatusOr<std::pair<bool, Row>> ReadRow(
+      std::string row_key, PreparedReadRowsRequest const& prepared);
+
+  /**
+   * Read and return many rows from the table.
+   *
+   * This is more efficient than calling `ReadRow()` for each key. The keys are
+   * sorted, split in batches using `SplitRowKeys()`, and each batch is read
+   * with a single `ReadRows()` request. Up to `options.max_concurrency`
+   * batches are read concurrently, each in a separate thread.
+   *
+   * @param row_keys the rows to read, duplicates are ignored.
+   * @param filter a filter expression, can be used to select a subset of the
+   *     column families and columns in the rows.
+   * @param options control how the keys are split into requests.
+   * @returns the rows found, and the keys not found, or the first error
+   *     returned by any of the requests.
+   *
+   * @par Idempotency
+   * This is a read-only operation and therefore it is always idempotent.
+   *
+   * @par Thread-safety
+   * Two threads concurrently calling this member function on the same instance
+   * of this class are **not** guaranteed to work. Consider copying the object
+   * and using different copies in each thread.
+   */
+  StatusOr<RowsByKeys> ReadRowsByKeys(
+      std::vector<RowKeyType> row_keys, Filter filter,
+      ReadRowsByKeysOptions const& options = ReadRowsByKeysOptions());
+
   /**
    * Atomic test-and-set for a row using filter expressions.
    *
@@ -803,6 +905,37 @@ class Table {
         absl::make_unique<bigtable::internal::ReadRowsParserFactory>());
   }
 
+  /**
+   * Asynchronously reads a set of rows, delivering each cell to a visitor.
+   *
+   * This is the asynchronous version of
+   * `ReadRows(RowSet, Filter, ReadRowsVisitor&)`, the cells are delivered to
+   * @p visitor as they are received, without building a `Row` for each row.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param row_set the rows to read from.
+   * @param filter is applied on the server-side to data in the rows.
+   * @param visitor receives the cells, and is notified when each row starts,
+   *     is committed, or is reset. See `ReadRowsVisitor` for details.
+   * @returns a future satisfied when the read completes. The status is OK if
+   *     all the rows were read, or if the visitor stopped the read.
+   *
+   * @par Thread-safety
+   * Two threads concurrently calling this member function on the same instance
+   * of this class are **not** guaranteed to work. Consider copying the object
+   * and using different copies in each thread. The visitor callbacks may be
+   * executed on any thread running the provided completion queue.
+   */
+  future<Status> AsyncReadRows(CompletionQueue& cq, RowSet row_set,
+                               Filter filter,
+                               std::shared_ptr<ReadRowsVisitor> visitor);
+
   /**
    * Asynchronously read and return a single row from the table.
    *
@@ -839,6 +972,38 @@ class Table {
                                                       std::string row_key,
                                                       Filter filter);
 
+  /**
+   * Asynchronously read and return many rows from the table.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * This is the asynchronous version of `ReadRowsByKeys()`, up to
+   * `options.max_concurrency` `ReadRows()` requests are in flight at a time.
+   *
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param row_keys the rows to read, duplicates are ignored.
+   * @param filter a filter expression, can be used to select a subset of the
+   *     column families and columns in the rows.
+   * @param options control how the keys are split into requests.
+   * @returns a future satisfied with the rows found and the keys not found, or
+   *     with the first error returned by any of the requests.
+   *
+   * @par Idempotency
+   * This is a read-only operation and therefore it is always idempotent.
+   *
+   * @par Thread-safety
+   * Two threads concurrently calling this member function on the same instance
+   * of this class are **not** guaranteed to work. Consider copying the object
+   * and using different copies in each thread.
+   */
+  future<StatusOr<RowsByKeys>> AsyncReadRowsByKeys(
+      CompletionQueue& cq, std::vector<RowKeyType> row_keys, Filter filter,
+      ReadRowsByKeysOptions const& options = ReadRowsByKeysOptions());
+
  private:
   /**
    * Send request ReadModifyWriteRowRequest to modify the row and get it back
@@ -891,6 +1056,10 @@ class Table {
     idempotent_mutation_policy_ = policy.clone();
   }
 
+  void ChangePolicy(HedgingPolicy const& policy) {
+    hedging_policy_ = policy.clone();
+  }
+
   template <typename Policy, typename... Policies>
   void ChangePolicies(Policy&& policy, Policies&&... policies) {
     ChangePolicy(policy);
@@ -899,6 +1068,7 @@ class Table {
   void ChangePolicies() {}
   //@}
 
+  friend class IncrementAggregator;
   friend class MutationBatcher;
   std::shared_ptr<DataClient> client_;
   std::string app_profile_id_;
@@ -908,6 +1078,7 @@ class Table {
   std::shared_ptr<RPCBackoffPolicy const> rpc_backoff_policy_prototype_;
   MetadataUpdatePolicy metadata_update_policy_;
   std::shared_ptr<IdempotentMutationPolicy> idempotent_mutation_policy_;
+  std::shared_ptr<HedgingPolicy> hedging_policy_;
 };
 
 }  // namespace BIGTABLE_CLIENT_NS
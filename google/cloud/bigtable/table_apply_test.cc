@@ -18,6 +18,9 @@
 #include "google/cloud/testing_util/assert_ok.h"
 #include "google/cloud/testing_util/chrono_literals.h"
 #include "google/cloud/testing_util/validate_metadata.h"
+#include <chrono>
+#include <memory>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -42,6 +45,51 @@ auto mock_mutate_row = [](grpc::Status const& status) {
 
 class TableApplyTest : public bigtable::testing::TableTestFixture {};
 
+/// A retry policy that counts how many times it is cloned.
+class CountingRetryPolicy : public bigtable::RPCRetryPolicy {
+ public:
+  explicit CountingRetryPolicy(std::shared_ptr<int> clones)
+      : impl_(3), clones_(std::move(clones)) {}
+
+  std::unique_ptr<bigtable::RPCRetryPolicy> clone() const override {
+    ++*clones_;
+    return std::unique_ptr<bigtable::RPCRetryPolicy>(
+        new CountingRetryPolicy(*this));
+  }
+  void Setup(grpc::ClientContext&) const override {}
+  bool SetupFirstAttempt(grpc::ClientContext&) const override { return true; }
+  bool OnFailure(google::cloud::Status const& status) override {
+    return impl_.OnFailure(status);
+  }
+  bool OnFailure(grpc::Status const& status) override {
+    return impl_.OnFailure(status);
+  }
+
+ private:
+  bigtable::LimitedErrorCountRetryPolicy impl_;
+  std::shared_ptr<int> clones_;
+};
+
+/// A subclass of a built-in policy that overrides `Setup()`.
+class CustomSetupRetryPolicy : public bigtable::LimitedTimeRetryPolicy {
+ public:
+  explicit CustomSetupRetryPolicy(std::shared_ptr<int> setups)
+      : LimitedTimeRetryPolicy(std::chrono::minutes(10)),
+        setups_(std::move(setups)) {}
+
+  std::unique_ptr<bigtable::RPCRetryPolicy> clone() const override {
+    return std::unique_ptr<bigtable::RPCRetryPolicy>(
+        new CustomSetupRetryPolicy(*this));
+  }
+  void Setup(grpc::ClientContext& context) const override {
+    ++*setups_;
+    LimitedTimeRetryPolicy::Setup(context);
+  }
+
+ private:
+  std::shared_ptr<int> setups_;
+};
+
 /// @test Verify that Table::Apply() works in a simplest case.
 TEST_F(TableApplyTest, Simple) {
   EXPECT_CALL(*client_, MutateRow).WillOnce(mock_mutate_row(grpc::Status::OK));
@@ -51,6 +99,61 @@ TEST_F(TableApplyTest, Simple) {
   ASSERT_STATUS_OK(status);
 }
 
+/// @test Verify that Table::Apply() copies the policies only to retry.
+TEST_F(TableApplyTest, ClonePoliciesOnlyToRetry) {
+  auto clones = std::make_shared<int>(0);
+  bigtable::Table table(client_, kTableId, CountingRetryPolicy(clones));
+  // The constructor keeps its own copy of the policy.
+  *clones = 0;
+
+  EXPECT_CALL(*client_, MutateRow)
+      .WillOnce(mock_mutate_row(grpc::Status::OK))
+      .WillOnce(mock_mutate_row(
+          grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")))
+      .WillOnce(mock_mutate_row(grpc::Status::OK));
+
+  auto status = table.Apply(bigtable::SingleRowMutation(
+      "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}));
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(0, *clones);
+
+  status = table.Apply(bigtable::SingleRowMutation(
+      "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}));
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(1, *clones);
+}
+
+/// @test Verify that Table::Apply() uses the overrides in policy subclasses.
+TEST_F(TableApplyTest, FirstAttemptUsesSubclassSetup) {
+  auto setups = std::make_shared<int>(0);
+  bigtable::Table table(client_, kTableId, CustomSetupRetryPolicy(setups));
+
+  EXPECT_CALL(*client_, MutateRow).WillOnce(mock_mutate_row(grpc::Status::OK));
+
+  auto status = table.Apply(bigtable::SingleRowMutation(
+      "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}));
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(1, *setups);
+}
+
+/// @test Verify that the retry deadline includes the first attempt.
+TEST_F(TableApplyTest, RetryDeadlineIncludesFirstAttempt) {
+  bigtable::Table table(client_, kTableId,
+                        bigtable::LimitedTimeRetryPolicy(50_ms));
+
+  EXPECT_CALL(*client_, MutateRow)
+      .WillOnce([](grpc::ClientContext*,
+                   google::bigtable::v2::MutateRowRequest const&,
+                   google::bigtable::v2::MutateRowResponse*) {
+        std::this_thread::sleep_for(100_ms);
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again");
+      });
+
+  auto status = table.Apply(bigtable::SingleRowMutation(
+      "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}));
+  EXPECT_EQ(google::cloud::StatusCode::kUnavailable, status.code());
+}
+
 /// @test Verify that Table::Apply() raises an exception on permanent failures.
 TEST_F(TableApplyTest, Failure) {
   EXPECT_CALL(*client_, MutateRow)
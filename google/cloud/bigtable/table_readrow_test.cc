@@ -17,6 +17,7 @@
 #include "google/cloud/bigtable/testing/table_test_fixture.h"
 #include "google/cloud/testing_util/assert_ok.h"
 #include "absl/memory/memory.h"
+#include <future>
 
 namespace google {
 namespace cloud {
@@ -73,6 +74,112 @@ TEST_F(TableReadRowTest, ReadRowSimple) {
   EXPECT_EQ("r1", row.row_key());
 }
 
+TEST_F(TableReadRowTest, ReadRowPrepared) {
+  auto const response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "col" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+)");
+
+  EXPECT_CALL(*client_, ReadRows)
+      .Times(2)
+      .WillRepeatedly([&response, this](grpc::ClientContext*,
+                                        btproto::ReadRowsRequest const& req) {
+        auto stream = absl::make_unique<MockReadRowsReader>(
+            "google.bigtable.v2.Bigtable.ReadRows");
+        EXPECT_CALL(*stream, Read)
+            .WillOnce([response](btproto::ReadRowsResponse* r) {
+              *r = response;
+              return true;
+            })
+            .WillOnce(Return(false));
+        EXPECT_CALL(*stream, Finish).WillOnce(Return(grpc::Status::OK));
+
+        EXPECT_EQ(1, req.rows().row_keys_size());
+        EXPECT_EQ("r1", req.rows().row_keys(0));
+        EXPECT_EQ(1, req.rows_limit());
+        EXPECT_EQ(table_.table_name(), req.table_name());
+        EXPECT_EQ("fam", req.filter().family_name_regex_filter());
+        return stream;
+      });
+
+  auto const prepared =
+      table_.PrepareReadRows(bigtable::Filter::FamilyRegex("fam"));
+  for (int i = 0; i != 2; ++i) {
+    auto result = table_.ReadRow("r1", prepared);
+    ASSERT_STATUS_OK(result);
+    EXPECT_TRUE(std::get<0>(*result));
+    EXPECT_EQ("r1", std::get<1>(*result).row_key());
+  }
+}
+
+TEST_F(TableReadRowTest, ReadRowHedged) {
+  auto const response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "col" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+)");
+
+  // The first request is stuck until the second one finishes.
+  std::promise<void> hedge_done;
+  auto primary_released = hedge_done.get_future().share();
+  EXPECT_CALL(*client_, ReadRows)
+      .WillOnce([primary_released](grpc::ClientContext*,
+                                   btproto::ReadRowsRequest const&) {
+        auto stream = absl::make_unique<MockReadRowsReader>(
+            "google.bigtable.v2.Bigtable.ReadRows");
+        EXPECT_CALL(*stream, Read)
+            .WillOnce([primary_released](btproto::ReadRowsResponse*) {
+              primary_released.wait();
+              return false;
+            });
+        EXPECT_CALL(*stream, Finish)
+            .WillOnce(Return(grpc::Status(grpc::StatusCode::CANCELLED, "")));
+        return stream;
+      })
+      .WillOnce([&response, &hedge_done](grpc::ClientContext* context,
+                                         btproto::ReadRowsRequest const& req) {
+        auto stream = absl::make_unique<MockReadRowsReader>(
+            "google.bigtable.v2.Bigtable.ReadRows");
+        EXPECT_CALL(*stream, Read)
+            .WillOnce([response](btproto::ReadRowsResponse* r) {
+              *r = response;
+              return true;
+            })
+            .WillOnce(Return(false));
+        EXPECT_CALL(*stream, Finish).WillOnce([&hedge_done] {
+          hedge_done.set_value();
+          return grpc::Status::OK;
+        });
+
+        EXPECT_STATUS_OK(
+            IsContextMDValid(*context, "google.bigtable.v2.Bigtable.ReadRows",
+                             google::cloud::internal::ApiClientHeader()));
+        EXPECT_EQ(1, req.rows().row_keys_size());
+        EXPECT_EQ("r1", req.rows().row_keys(0));
+        return stream;
+      });
+
+  // Without any latency samples the policy hedges after `maximum_delay`.
+  Table table(client_, kTableId,
+              LatencyHedgingPolicy(0.95, std::chrono::microseconds(1),
+                                   std::chrono::microseconds(1)));
+  auto result = table.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  ASSERT_STATUS_OK(result);
+  EXPECT_TRUE(std::get<0>(*result));
+  EXPECT_EQ("r1", std::get<1>(*result).row_key());
+}
+
 TEST_F(TableReadRowTest, ReadRowMissing) {
   EXPECT_CALL(*client_, ReadRows)
       .WillOnce([this](grpc::ClientContext* context,
@@ -118,6 +225,73 @@ TEST_F(TableReadRowTest, UnrecoverableFailure) {
   EXPECT_FALSE(row);
 }
 
+btproto::ReadRowsResponse ResponseForRow(std::string const& row_key) {
+  return bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: ")" + row_key + R"("
+        family_name { value: "fam" }
+        qualifier { value: "col" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+)");
+}
+
+TEST_F(TableReadRowTest, ReadRowsByKeys) {
+  auto make_returner = [](std::vector<std::string> expected_keys,
+                          std::string found) {
+    return [expected_keys, found](grpc::ClientContext*,
+                                  btproto::ReadRowsRequest const& req) {
+      std::vector<std::string> keys(req.rows().row_keys().begin(),
+                                    req.rows().row_keys().end());
+      EXPECT_EQ(expected_keys, keys);
+      EXPECT_EQ(0, req.rows_limit());
+      auto stream = absl::make_unique<MockReadRowsReader>(
+          "google.bigtable.v2.Bigtable.ReadRows");
+      EXPECT_CALL(*stream, Read)
+          .WillOnce([found](btproto::ReadRowsResponse* r) {
+            *r = ResponseForRow(found);
+            return true;
+          })
+          .WillOnce(Return(false));
+      EXPECT_CALL(*stream, Finish).WillOnce(Return(grpc::Status::OK));
+      return stream;
+    };
+  };
+  EXPECT_CALL(*client_, ReadRows)
+      .WillOnce(make_returner({"r1", "r2"}, "r1"))
+      .WillOnce(make_returner({"r3"}, "r3"));
+
+  auto result = table_.ReadRowsByKeys(
+      {"r3", "r1", "r2", "r1"}, bigtable::Filter::PassAllFilter(),
+      ReadRowsByKeysOptions().SetMaxKeysPerRequest(2).SetMaxConcurrency(1));
+  ASSERT_STATUS_OK(result);
+  ASSERT_EQ(2U, result->rows.size());
+  EXPECT_EQ("r1", result->rows.at("r1").row_key());
+  EXPECT_EQ("r3", result->rows.at("r3").row_key());
+  EXPECT_EQ(std::vector<std::string>{"r2"}, result->missing_keys);
+}
+
+TEST_F(TableReadRowTest, ReadRowsByKeysFailure) {
+  EXPECT_CALL(*client_, ReadRows)
+      .WillRepeatedly([](grpc::ClientContext*,
+                         btproto::ReadRowsRequest const&) {
+        auto stream = absl::make_unique<MockReadRowsReader>(
+            "google.bigtable.v2.Bigtable.ReadRows");
+        EXPECT_CALL(*stream, Read).WillRepeatedly(Return(false));
+        EXPECT_CALL(*stream, Finish)
+            .WillRepeatedly(Return(
+                grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh oh")));
+        return stream;
+      });
+
+  auto result = table_.ReadRowsByKeys(
+      {"r1", "r2", "r3"}, bigtable::Filter::PassAllFilter(),
+      ReadRowsByKeysOptions().SetMaxKeysPerRequest(1));
+  EXPECT_EQ(StatusCode::kPermissionDenied, result.status().code());
+}
+
 }  // anonymous namespace
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
@@ -148,6 +148,187 @@ TEST_F(TableReadRowsTest, ReadRowsThrowsWhenTooManyErrors) {
   ASSERT_EQ(reader.end(), it);
 }
 
+/// Record the visitor callbacks as strings, to simplify the assertions.
+class RecordingVisitor : public ReadRowsVisitor {
+ public:
+  void OnRowStart(RowKeyType const& row_key) override {
+    events.push_back("start " + std::string(row_key));
+  }
+  void OnCell(Cell cell) override {
+    events.push_back("cell " + std::string(cell.value()));
+  }
+  bool OnRowCommit(RowKeyType const& row_key) override {
+    events.push_back("commit " + std::string(row_key));
+    return std::string(row_key) != stop_at;
+  }
+  void OnRowReset() override { events.emplace_back("reset"); }
+
+  std::vector<std::string> events;
+  std::string stop_at;
+};
+
+TEST_F(TableReadRowsTest, ReadRowsVisitor) {
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "v1"
+      }
+      chunks {
+        timestamp_micros: 41000
+        value: "v2"
+        commit_row: true
+      }
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "v3"
+        commit_row: true
+      }
+      )");
+
+  auto* stream = new MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  EXPECT_CALL(*stream, Read)
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, ReadRows).WillOnce(stream->MakeMockReturner());
+
+  RecordingVisitor visitor;
+  auto status = table_.ReadRows(bigtable::RowSet(),
+                                bigtable::Filter::PassAllFilter(), visitor);
+  ASSERT_STATUS_OK(status);
+  std::vector<std::string> const expected{"start r1", "cell v1",  "cell v2",
+                                          "commit r1", "start r2", "cell v3",
+                                          "commit r2"};
+  EXPECT_EQ(expected, visitor.events);
+}
+
+TEST_F(TableReadRowsTest, ReadRowsVisitorResetsOnRetry) {
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "v1"
+        commit_row: true
+      }
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "partial"
+      }
+      )");
+  auto response_retry = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "v2"
+        commit_row: true
+      }
+      )");
+
+  auto* stream = new MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  auto* stream_retry =
+      new MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  EXPECT_CALL(*client_, ReadRows)
+      .WillOnce(stream->MakeMockReturner())
+      .WillOnce(stream_retry->MakeMockReturner());
+  EXPECT_CALL(*stream, Read)
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish())
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+  EXPECT_CALL(*stream_retry, Read)
+      .WillOnce(DoAll(SetArgPointee<0>(response_retry), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream_retry, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  RecordingVisitor visitor;
+  auto status = table_.ReadRows(bigtable::RowSet(),
+                                bigtable::Filter::PassAllFilter(), visitor);
+  ASSERT_STATUS_OK(status);
+  std::vector<std::string> const expected{
+      "start r1", "cell v1", "commit r1", "start r2", "cell partial",
+      "reset",    "start r2", "cell v2", "commit r2"};
+  EXPECT_EQ(expected, visitor.events);
+}
+
+TEST_F(TableReadRowsTest, ReadRowsVisitorStop) {
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "v1"
+        commit_row: true
+      }
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "v2"
+        commit_row: true
+      }
+      )");
+
+  auto* stream = new MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  EXPECT_CALL(*stream, Read)
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, ReadRows).WillOnce(stream->MakeMockReturner());
+
+  RecordingVisitor visitor;
+  visitor.stop_at = "r1";
+  auto status = table_.ReadRows(bigtable::RowSet(),
+                                bigtable::Filter::PassAllFilter(), visitor);
+  ASSERT_STATUS_OK(status);
+  std::vector<std::string> const expected{"start r1", "cell v1", "commit r1"};
+  EXPECT_EQ(expected, visitor.events);
+}
+
+TEST_F(TableReadRowsTest, ReadRowsVisitorPermanentError) {
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "partial"
+      }
+      )");
+
+  auto* stream = new MockReadRowsReader("google.bigtable.v2.Bigtable.ReadRows");
+  EXPECT_CALL(*stream, Read)
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish())
+      .WillOnce(Return(
+          grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh")));
+  EXPECT_CALL(*client_, ReadRows).WillOnce(stream->MakeMockReturner());
+
+  RecordingVisitor visitor;
+  auto status = table_.ReadRows(bigtable::RowSet(),
+                                bigtable::Filter::PassAllFilter(), visitor);
+  EXPECT_EQ(StatusCode::kPermissionDenied, status.code());
+  std::vector<std::string> const expected{"start r1", "cell partial",
+                                          "reset"};
+  EXPECT_EQ(expected, visitor.events);
+}
+
 }  // anonymous namespace
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
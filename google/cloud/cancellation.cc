@@ -0,0 +1,133 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/cancellation.h"
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+
+struct CancellationToken::State {
+  std::mutex mu;
+  std::condition_variable cv;
+  bool cancelled = false;
+  std::uint64_t next_id = 0;
+  std::map<std::uint64_t, std::function<void()>> callbacks;
+  // The callback running in `Cancel()`, 0 if none, and the thread running it.
+  std::uint64_t running_id = 0;
+  std::thread::id running_thread;
+};
+
+namespace {
+CancellationToken const*& CurrentToken() {
+  static thread_local CancellationToken const* current = nullptr;
+  return current;
+}
+}  // namespace
+
+CancellationToken::CancellationToken() : state_(std::make_shared<State>()) {}
+
+void CancellationToken::Cancel() {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  if (state_->cancelled) return;
+  state_->cancelled = true;
+  state_->running_thread = std::this_thread::get_id();
+  // Run the callbacks one at a time, without holding the lock, so they can
+  // use (or destroy) other registrations.
+  while (!state_->callbacks.empty()) {
+    auto i = state_->callbacks.begin();
+    state_->running_id = i->first;
+    auto callback = std::move(i->second);
+    state_->callbacks.erase(i);
+    lk.unlock();
+    callback();
+    lk.lock();
+    state_->running_id = 0;
+    state_->cv.notify_all();
+  }
+  state_->cv.notify_all();
+}
+
+bool CancellationToken::cancelled() const {
+  std::lock_guard<std::mutex> lk(state_->mu);
+  return state_->cancelled;
+}
+
+bool CancellationToken::WaitFor(std::chrono::nanoseconds timeout) const {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  return state_->cv.wait_for(lk, timeout, [this] { return state_->cancelled; });
+}
+
+CancellationScope::CancellationScope(CancellationToken token)
+    : token_(std::move(token)), previous_(CurrentToken()) {
+  CurrentToken() = &token_;
+}
+
+CancellationScope::~CancellationScope() { CurrentToken() = previous_; }
+
+CancellationRegistration::CancellationRegistration(
+    absl::optional<CancellationToken> const& token,
+    std::function<void()> callback) {
+  if (!token) return;
+  auto state = token->state_;
+  std::unique_lock<std::mutex> lk(state->mu);
+  if (state->cancelled) {
+    lk.unlock();
+    callback();
+    return;
+  }
+  id_ = ++state->next_id;
+  state->callbacks.emplace(id_, std::move(callback));
+  state_ = std::move(state);
+}
+
+void CancellationRegistration::Reset() {
+  if (!state_) return;
+  auto state = std::move(state_);
+  state_.reset();
+  std::unique_lock<std::mutex> lk(state->mu);
+  if (state->callbacks.erase(id_) != 0) return;
+  // The callback is running, or already ran, wait unless it is this thread
+  // that is running it.
+  if (state->running_thread == std::this_thread::get_id()) return;
+  auto const id = id_;
+  state->cv.wait(lk, [&] { return state->running_id != id; });
+}
+
+namespace internal {
+
+absl::optional<CancellationToken> CurrentCancellationToken() {
+  auto const* token = CurrentToken();
+  if (token == nullptr) return absl::nullopt;
+  return *token;
+}
+
+bool SleepUnlessCancelled(absl::optional<CancellationToken> const& token,
+                          std::chrono::nanoseconds duration) {
+  if (!token) {
+    std::this_thread::sleep_for(duration);
+    return true;
+  }
+  return !token->WaitFor(duration);
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,173 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_CANCELLATION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_CANCELLATION_H
+
+#include "google/cloud/version.h"
+#include "absl/types/optional.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+
+/**
+ * A signal to abandon the calls made on behalf of the application.
+ *
+ * Applications create a token, make it current with a `CancellationScope`,
+ * and then make calls in any of the client libraries. The calls capture the
+ * current token when they start, and if the token is cancelled they cancel the
+ * `grpc::ClientContext` (or the HTTP transfer) of the attempt in progress,
+ * skip any backoff, and return a `StatusCode::kCancelled` error. This is
+ * useful to release connections and CPU held by work the application no
+ * longer needs, e.g., requests that took too long, or the losers in a hedged
+ * request.
+ *
+ * Cancellation is cooperative and best-effort: a call may complete
+ * successfully if it was almost done when the token was cancelled.
+ *
+ * Copies of a token share the same state, cancelling any copy cancels all of
+ * them.
+ *
+ * @par Thread-safety
+ * Instances of this class are safe to use from multiple threads.
+ *
+ * @par Example
+ * @code
+ * google::cloud::CancellationToken token;
+ * auto watchdog = std::async(std::launch::async, [token]() mutable {
+ *   std::this_thread::sleep_for(std::chrono::seconds(5));
+ *   token.Cancel();
+ * });
+ * google::cloud::CancellationScope scope(token);
+ * auto response = client.SomeRpc(request);  // kCancelled after 5 seconds
+ * @endcode
+ */
+class CancellationToken {
+ public:
+  CancellationToken();
+
+  /// Cancels the token and all the calls using it, has no effect if the token
+  /// is already cancelled.
+  void Cancel();
+
+  /// Returns true if `Cancel()` was called on this token or one of its copies.
+  bool cancelled() const;
+
+  /**
+   * Waits until the token is cancelled, or @p timeout elapses.
+   *
+   * @return true if the token is cancelled.
+   */
+  bool WaitFor(std::chrono::nanoseconds timeout) const;
+
+  friend bool operator==(CancellationToken const& a,
+                         CancellationToken const& b) {
+    return a.state_ == b.state_;
+  }
+  friend bool operator!=(CancellationToken const& a,
+                         CancellationToken const& b) {
+    return !(a == b);
+  }
+
+ private:
+  friend class CancellationRegistration;
+  struct State;
+  std::shared_ptr<State> state_;
+};
+
+/**
+ * Makes @p token the cancellation token for calls started by this thread.
+ *
+ * The token is in effect until the scope is destroyed, scopes can be nested.
+ * Calls capture the token when they start, streams and asynchronous calls
+ * remain cancellable after the scope is destroyed.
+ */
+class CancellationScope {
+ public:
+  explicit CancellationScope(CancellationToken token);
+  ~CancellationScope();
+
+  CancellationScope(CancellationScope const&) = delete;
+  CancellationScope& operator=(CancellationScope const&) = delete;
+
+ private:
+  CancellationToken token_;
+  CancellationToken const* previous_;
+};
+
+/**
+ * Runs a callback when a token is cancelled, until this object is destroyed.
+ *
+ * The callback runs immediately, in the constructor, if the token is already
+ * cancelled. Otherwise it runs in the thread calling `Cancel()`. The
+ * destructor blocks until the callback completes if it is running in a
+ * different thread, so the callback can safely reference objects that outlive
+ * the registration.
+ */
+class CancellationRegistration {
+ public:
+  CancellationRegistration() = default;
+  CancellationRegistration(absl::optional<CancellationToken> const& token,
+                           std::function<void()> callback);
+  ~CancellationRegistration() { Reset(); }
+
+  CancellationRegistration(CancellationRegistration&& rhs) noexcept
+      : state_(std::move(rhs.state_)), id_(rhs.id_) {
+    rhs.state_.reset();
+  }
+  CancellationRegistration& operator=(CancellationRegistration&& rhs) noexcept {
+    Reset();
+    state_ = std::move(rhs.state_);
+    id_ = rhs.id_;
+    rhs.state_.reset();
+    return *this;
+  }
+
+  /// Removes the callback, waiting for it to complete if it is running.
+  void Reset();
+
+ private:
+  std::shared_ptr<CancellationToken::State> state_;
+  std::uint64_t id_ = 0;
+};
+
+namespace internal {
+
+/// The token of the innermost `CancellationScope` in this thread, if any.
+absl::optional<CancellationToken> CurrentCancellationToken();
+
+/// Returns true if @p token is set and cancelled.
+inline bool IsCancelled(absl::optional<CancellationToken> const& token) {
+  return token.has_value() && token->cancelled();
+}
+
+/**
+ * Sleeps for @p duration, returning early if @p token is cancelled.
+ *
+ * @return false if the sleep was interrupted by a cancellation.
+ */
+bool SleepUnlessCancelled(absl::optional<CancellationToken> const& token,
+                          std::chrono::nanoseconds duration);
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_CANCELLATION_H
@@ -0,0 +1,164 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/cancellation.h"
+#include <gmock/gmock.h>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(CancellationToken, Basic) {
+  CancellationToken token;
+  auto copy = token;
+  EXPECT_EQ(token, copy);
+  EXPECT_NE(token, CancellationToken{});
+  EXPECT_FALSE(token.cancelled());
+  copy.Cancel();
+  EXPECT_TRUE(token.cancelled());
+  // Cancelling twice has no effect.
+  token.Cancel();
+  EXPECT_TRUE(copy.cancelled());
+}
+
+TEST(CancellationToken, WaitFor) {
+  CancellationToken token;
+  EXPECT_FALSE(token.WaitFor(std::chrono::milliseconds(1)));
+  auto canceller = std::async(std::launch::async, [token]() mutable {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    token.Cancel();
+  });
+  EXPECT_TRUE(token.WaitFor(std::chrono::hours(1)));
+  canceller.get();
+}
+
+TEST(CancellationScope, Nested) {
+  EXPECT_FALSE(internal::CurrentCancellationToken().has_value());
+  CancellationToken outer;
+  CancellationToken inner;
+  {
+    CancellationScope s1(outer);
+    EXPECT_EQ(outer, internal::CurrentCancellationToken());
+    {
+      CancellationScope s2(inner);
+      EXPECT_EQ(inner, internal::CurrentCancellationToken());
+    }
+    EXPECT_EQ(outer, internal::CurrentCancellationToken());
+  }
+  EXPECT_FALSE(internal::CurrentCancellationToken().has_value());
+}
+
+TEST(CancellationScope, PerThread) {
+  CancellationToken token;
+  CancellationScope scope(token);
+  auto other = std::async(std::launch::async, [] {
+    return internal::CurrentCancellationToken().has_value();
+  });
+  EXPECT_FALSE(other.get());
+}
+
+TEST(CancellationRegistration, RunsOnCancel) {
+  CancellationToken token;
+  std::vector<std::string> calls;
+  CancellationRegistration r1(token, [&calls] { calls.emplace_back("r1"); });
+  CancellationRegistration r2(token, [&calls] { calls.emplace_back("r2"); });
+  CancellationRegistration r3(token, [&calls] { calls.emplace_back("r3"); });
+  r2.Reset();
+  EXPECT_TRUE(calls.empty());
+  token.Cancel();
+  EXPECT_THAT(calls, ElementsAre("r1", "r3"));
+  token.Cancel();
+  EXPECT_THAT(calls, ElementsAre("r1", "r3"));
+}
+
+TEST(CancellationRegistration, AlreadyCancelled) {
+  CancellationToken token;
+  token.Cancel();
+  int calls = 0;
+  CancellationRegistration r(token, [&calls] { ++calls; });
+  EXPECT_EQ(1, calls);
+}
+
+TEST(CancellationRegistration, NoToken) {
+  int calls = 0;
+  CancellationRegistration r(absl::nullopt, [&calls] { ++calls; });
+  r.Reset();
+  EXPECT_EQ(0, calls);
+}
+
+TEST(CancellationRegistration, Move) {
+  CancellationToken token;
+  int calls = 0;
+  CancellationRegistration r;
+  {
+    CancellationRegistration tmp(token, [&calls] { ++calls; });
+    r = std::move(tmp);
+  }
+  token.Cancel();
+  EXPECT_EQ(1, calls);
+}
+
+TEST(CancellationRegistration, ResetWaitsForCallback) {
+  CancellationToken token;
+  std::promise<void> started;
+  std::promise<void> release;
+  bool done = false;
+  CancellationRegistration r(token, [&] {
+    started.set_value();
+    release.get_future().get();
+    done = true;
+  });
+  auto canceller =
+      std::async(std::launch::async, [token]() mutable { token.Cancel(); });
+  started.get_future().get();
+  auto resetter = std::async(std::launch::async, [&r] { r.Reset(); });
+  EXPECT_EQ(std::future_status::timeout,
+            resetter.wait_for(std::chrono::milliseconds(10)));
+  release.set_value();
+  resetter.get();
+  EXPECT_TRUE(done);
+  canceller.get();
+}
+
+TEST(CancellationRegistration, ResetInCallback) {
+  CancellationToken token;
+  CancellationRegistration r;
+  r = CancellationRegistration(token, [&r] { r.Reset(); });
+  token.Cancel();
+  SUCCEED();
+}
+
+TEST(SleepUnlessCancelled, Basic) {
+  EXPECT_TRUE(internal::SleepUnlessCancelled(absl::nullopt,
+                                             std::chrono::milliseconds(1)));
+  CancellationToken token;
+  EXPECT_TRUE(
+      internal::SleepUnlessCancelled(token, std::chrono::milliseconds(1)));
+  token.Cancel();
+  EXPECT_FALSE(internal::SleepUnlessCancelled(token, std::chrono::hours(1)));
+  EXPECT_TRUE(internal::IsCancelled(token));
+  EXPECT_FALSE(internal::IsCancelled(absl::nullopt));
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
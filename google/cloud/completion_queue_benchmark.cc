@@ -14,11 +14,15 @@
 
 #include "google/cloud/completion_queue.h"
 #include "google/cloud/internal/default_completion_queue_impl.h"
+#include "google/cloud/internal/sharded_completion_queue_impl.h"
 #include <benchmark/benchmark.h>
+#include <algorithm>
 #include <condition_variable>
 #include <deque>
 #include <functional>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -46,6 +50,8 @@ namespace {
 // BM_CompletionQueueRunAsync_BigO       1004.78 N        219.47 N
 // BM_CompletionQueueRunAsync_RMS             18 %            17 %
 
+using TimerFuture = future<StatusOr<std::chrono::system_clock::time_point>>;
+
 auto constexpr kMinThreads = 16;
 auto constexpr kMaxThreads = 16;
 auto constexpr kMinExecutions = 1 << 9;
@@ -126,6 +132,138 @@ BENCHMARK(BM_CompletionQueueRunAsync)
     ->Ranges({{kMinThreads, kMaxThreads}, {kMinExecutions, kMaxExecutions}})
     ->Complexity(benchmark::oN);
 
+void BM_CompletionQueueRunAsyncWorkStealing(benchmark::State& state) {
+  // The I/O threads are not used by RunAsync(), keep just one.
+  CompletionQueue cq(std::make_shared<internal::DefaultCompletionQueueImpl>(
+      absl::make_unique<internal::WorkStealingExecutor>(
+          static_cast<std::size_t>(state.range(0)))));
+  std::thread io([](CompletionQueue cq) { cq.Run(); }, cq);
+
+  auto runner = [&](std::int64_t n) {
+    Wait wait(n);
+    for (std::int64_t i = 0; i != n; ++i) {
+      cq.RunAsync([&wait] { wait.OneDone(); });
+    }
+    wait.BlockUntilDone();
+    return 0;
+  };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runner(state.range(1)));
+  }
+  state.SetComplexityN(state.range(1));
+  cq.Shutdown();
+  io.join();
+}
+BENCHMARK(BM_CompletionQueueRunAsyncWorkStealing)
+    ->RangeMultiplier(2)
+    ->Ranges({{kMinThreads, kMaxThreads}, {kMinExecutions, kMaxExecutions}})
+    ->Complexity(benchmark::oN);
+
+void BM_CompletionQueueTimerExpire(benchmark::State& state) {
+  CompletionQueue cq;
+  std::vector<std::thread> pool(static_cast<std::size_t>(state.range(0)));
+  std::generate_n(pool.begin(), pool.size(), [&cq] {
+    return std::thread([](CompletionQueue cq) { cq.Run(); }, cq);
+  });
+
+  auto runner = [&](std::int64_t n) {
+    Wait wait(n);
+    for (std::int64_t i = 0; i != n; ++i) {
+      cq.MakeRelativeTimer(std::chrono::microseconds(100))
+          .then([&wait](TimerFuture) { wait.OneDone(); });
+    }
+    wait.BlockUntilDone();
+    return 0;
+  };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runner(state.range(1)));
+  }
+  state.SetComplexityN(state.range(1));
+  cq.Shutdown();
+  for (auto& t : pool) t.join();
+}
+BENCHMARK(BM_CompletionQueueTimerExpire)
+    ->RangeMultiplier(2)
+    ->Ranges({{kMinThreads, kMaxThreads}, {kMinExecutions, kMaxExecutions}})
+    ->Complexity(benchmark::oN);
+
+void BM_CompletionQueueTimerCancel(benchmark::State& state) {
+  CompletionQueue cq;
+  std::vector<std::thread> pool(static_cast<std::size_t>(state.range(0)));
+  std::generate_n(pool.begin(), pool.size(), [&cq] {
+    return std::thread([](CompletionQueue cq) { cq.Run(); }, cq);
+  });
+
+  auto runner = [&](std::int64_t n) {
+    std::vector<TimerFuture> timers;
+    for (std::int64_t i = 0; i != n; ++i) {
+      timers.push_back(cq.MakeRelativeTimer(std::chrono::hours(1)));
+    }
+    for (auto& t : timers) t.cancel();
+    for (auto& t : timers) t.get();
+    return 0;
+  };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runner(state.range(1)));
+  }
+  state.SetComplexityN(state.range(1));
+  cq.Shutdown();
+  for (auto& t : pool) t.join();
+}
+BENCHMARK(BM_CompletionQueueTimerCancel)
+    ->RangeMultiplier(2)
+    ->Ranges({{kMinThreads, kMaxThreads}, {kMinExecutions, kMaxExecutions}})
+    ->Complexity(benchmark::oN);
+
+auto constexpr kRunThreads = 16;
+auto constexpr kOperationsPerWorker = 256;
+
+// Many threads starting and completing operations, with a sharded completion
+// queue. Expired timers exercise the `StartOperation()` and
+// `ForgetOperation()` path for each operation.
+void BM_CompletionQueueShardedOperations(benchmark::State& state) {
+  auto const shards = static_cast<std::size_t>(state.range(0));
+  auto const workers = static_cast<std::size_t>(state.range(1));
+  CompletionQueue cq(
+      std::make_shared<internal::ShardedCompletionQueueImpl>(shards));
+  std::vector<std::thread> pool(kRunThreads);
+  std::generate_n(pool.begin(), pool.size(), [&cq] {
+    return std::thread([](CompletionQueue cq) { cq.Run(); }, cq);
+  });
+
+  auto runner = [&] {
+    Wait wait(static_cast<std::int64_t>(workers) * kOperationsPerWorker);
+    auto work = [&cq, &wait] {
+      for (int i = 0; i != kOperationsPerWorker; ++i) {
+        cq.MakeDeadlineTimer(std::chrono::system_clock::now())
+            .then([&wait](TimerFuture) { wait.OneDone(); });
+      }
+    };
+    std::vector<std::thread> threads(workers);
+    std::generate_n(threads.begin(), threads.size(),
+                    [&work] { return std::thread(work); });
+    for (auto& t : threads) t.join();
+    wait.BlockUntilDone();
+    return 0;
+  };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runner());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(workers) *
+                          kOperationsPerWorker);
+  cq.Shutdown();
+  for (auto& t : pool) t.join();
+}
+BENCHMARK(BM_CompletionQueueShardedOperations)
+    ->RangeMultiplier(4)
+    ->Ranges({{1, 16}, {1, 16}})
+    ->UseRealTime();
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -127,6 +127,31 @@ TEST(CompletionQueueTest, TimerSmokeTest) {
   t.join();
 }
 
+#if GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+future<StatusOr<int>> CountTimers(CompletionQueue cq, int count) {
+  int expired = 0;
+  for (int i = 0; i != count; ++i) {
+    auto timer = co_await cq.MakeRelativeTimer(std::chrono::milliseconds(1));
+    if (!timer) co_return std::move(timer).status();
+    ++expired;
+  }
+  co_return expired;
+}
+
+/// @test Verify that CompletionQueue futures can be awaited in coroutines.
+TEST(CompletionQueueTest, TimerCoroutine) {
+  CompletionQueue cq;
+  std::thread t([&cq] { cq.Run(); });
+
+  auto actual = CountTimers(cq, 3).get();
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(3, *actual);
+
+  cq.Shutdown();
+  t.join();
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+
 TEST(CompletionQueueTest, MockSmokeTest) {
   auto mock = std::make_shared<FakeCompletionQueueImpl>();
 
@@ -590,6 +615,37 @@ TEST(CompletionQueueTest, NoRunAsyncAfterShutdown) {
   EXPECT_EQ(std::future_status::timeout, f.wait_for(ms(0)));
 }
 
+TEST(CompletionQueueTest, RunAsyncWorkStealingExecutor) {
+  auto impl = std::make_shared<internal::DefaultCompletionQueueImpl>(
+      absl::make_unique<internal::WorkStealingExecutor>(2));
+  CompletionQueue cq(impl);
+  std::thread runner([&cq] { cq.Run(); });
+
+  // The functors run in the executor threads, not the thread calling Run().
+  std::promise<std::thread::id> id;
+  cq.RunAsync([&id](CompletionQueue&) {
+    id.set_value(std::this_thread::get_id());
+  });
+  auto const actual = id.get_future().get();
+  EXPECT_NE(runner.get_id(), actual);
+  EXPECT_NE(std::this_thread::get_id(), actual);
+
+  RunAsyncBlocker blocker;
+  auto on_run_async = [&blocker] { blocker.PushBack().get(); };
+  auto wait = [&blocker] { return blocker.PopFront(); };
+  auto constexpr kIterations = 100;
+  for (int i = 0; i != kIterations; ++i) cq.RunAsync(on_run_async);
+  for (int i = 0; i != kIterations; ++i) wait().set_value();
+  // The gRPC completion queue is not used for RunAsync().
+  EXPECT_EQ(0, impl->notify_counter());
+
+  cq.Shutdown();
+  runner.join();
+  bool called = false;
+  cq.RunAsync([&called] { called = true; });
+  EXPECT_FALSE(called);
+}
+
 class RunAsyncTest : public ::testing::TestWithParam<int> {};
 
 TEST_P(RunAsyncTest, Torture) {
@@ -605,11 +661,15 @@ TEST_P(RunAsyncTest, Torture) {
   std::mutex mu;
   std::condition_variable cv;
   int timer_count = kThreads * iterations;
+  int timer_expired = 0;
   int async_count = kThreads * iterations;
-  auto on_timer = [&](future<StatusOr<std::chrono::system_clock::time_point>>) {
-    std::lock_guard<std::mutex> lk(mu);
-    if (--timer_count == 0) cv.notify_one();
-  };
+  auto on_timer =
+      [&](future<StatusOr<std::chrono::system_clock::time_point>> f) {
+        auto const expired = f.get().ok();
+        std::lock_guard<std::mutex> lk(mu);
+        if (expired) ++timer_expired;
+        if (--timer_count == 0) cv.notify_one();
+      };
   auto on_async = [&] {
     std::lock_guard<std::mutex> lk(mu);
     if (--async_count == 0) cv.notify_one();
@@ -646,10 +706,12 @@ TEST_P(RunAsyncTest, Torture) {
   auto const max_run_async_pool_hwm = GetParam() > 1 ? GetParam() - 1 : 1;
   EXPECT_GE(impl->run_async_pool_hwm(), 1);
   EXPECT_LE(impl->run_async_pool_hwm(), max_run_async_pool_hwm);
-  // We expect at least one notify per timer.
-  EXPECT_GE(impl->notify_counter(), kThreads * iterations);
-  // We expect at most one notify per RunAsync(), because this test sequences
-  // the RunAsync() calls we often hit the upper bound.
+  // Timers expiring together are coalesced in the timer wheel, so there is no
+  // useful lower bound on the notifications for them. Instead, verify that
+  // every timer expired. We expect at most one notify per RunAsync(), because
+  // this test sequences the RunAsync() calls we often hit the upper bound.
+  EXPECT_EQ(kThreads * iterations, timer_expired);
+  EXPECT_GE(impl->notify_counter(), 1);
   EXPECT_LE(impl->notify_counter(),
             kThreads * iterations + kThreads * iterations);
 }
@@ -805,6 +867,70 @@ TEST(CompletionQueueTest, CancelTimerContinuation) {
   t.join();
 }
 
+/// @test Verify that many timers share a few underlying alarms.
+TEST(CompletionQueueTest, TimerWheelCoalesces) {
+  auto impl = std::make_shared<internal::DefaultCompletionQueueImpl>();
+  CompletionQueue cq(impl);
+  std::thread t([&cq] { cq.Run(); });
+
+  auto constexpr kTimerCount = 1000;
+  auto const deadline =
+      std::chrono::system_clock::now() + std::chrono::milliseconds(50);
+  std::vector<TimerFuture> timers;
+  for (int i = 0; i != kTimerCount; ++i) {
+    timers.push_back(cq.MakeDeadlineTimer(deadline));
+  }
+  for (auto& f : timers) {
+    auto tp = f.get();
+    ASSERT_STATUS_OK(tp);
+    EXPECT_EQ(deadline, *tp);
+  }
+  EXPECT_EQ(0, impl->pending_timers());
+  EXPECT_GE(impl->notify_counter(), 1);
+  EXPECT_LT(impl->notify_counter(), kTimerCount / 10);
+
+  cq.Shutdown();
+  t.join();
+}
+
+/// @test Verify that canceling timers in the wheel does not affect others.
+TEST(CompletionQueueTest, TimerWheelCancel) {
+  auto impl = std::make_shared<internal::DefaultCompletionQueueImpl>();
+  CompletionQueue cq(impl);
+  std::thread t([&cq] { cq.Run(); });
+
+  using ms = std::chrono::milliseconds;
+  auto canceled = cq.MakeRelativeTimer(std::chrono::hours(1));
+  auto expires = cq.MakeRelativeTimer(ms(10));
+  EXPECT_EQ(2, impl->pending_timers());
+  canceled.cancel();
+  // Canceling a timer removes it from the wheel immediately.
+  EXPECT_EQ(1, impl->pending_timers());
+  EXPECT_EQ(StatusCode::kCancelled, canceled.get().status().code());
+  EXPECT_STATUS_OK(expires.get());
+  EXPECT_EQ(0, impl->pending_timers());
+
+  cq.Shutdown();
+  t.join();
+}
+
+/// @test Verify that canceled timers complete in the completion queue threads.
+TEST(CompletionQueueTest, TimerWheelCancelIsAsynchronous) {
+  CompletionQueue cq;
+  std::thread t([&cq] { cq.Run(); });
+
+  auto timer = cq.MakeRelativeTimer(std::chrono::hours(1))
+                   .then([](TimerFuture f) {
+                     EXPECT_EQ(StatusCode::kCancelled, f.get().status().code());
+                     return std::this_thread::get_id();
+                   });
+  timer.cancel();
+  EXPECT_NE(std::this_thread::get_id(), timer.get());
+
+  cq.Shutdown();
+  t.join();
+}
+
 TEST(CompletionQueueTest, ImplStartOperationDuplicate) {
   auto impl = std::make_shared<internal::DefaultCompletionQueueImpl>();
   auto op = std::make_shared<MockOperation>();
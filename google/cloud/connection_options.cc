@@ -23,6 +23,46 @@
 namespace google {
 namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
+
+void GrpcTransportOptions::ApplyTo(grpc::ChannelArguments& args) const {
+  auto as_int = [](std::chrono::milliseconds v) {
+    return static_cast<int>(v.count());
+  };
+  if (keepalive_time_) {
+    args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, as_int(*keepalive_time_));
+  }
+  if (keepalive_timeout_) {
+    args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, as_int(*keepalive_timeout_));
+  }
+  if (keepalive_permit_without_calls_) {
+    args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS,
+                *keepalive_permit_without_calls_ ? 1 : 0);
+  }
+  if (max_send_message_size_) {
+    args.SetMaxSendMessageSize(*max_send_message_size_);
+  }
+  if (max_receive_message_size_) {
+    args.SetMaxReceiveMessageSize(*max_receive_message_size_);
+  }
+  if (http2_stream_window_size_) {
+    args.SetInt(GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES,
+                *http2_stream_window_size_);
+  }
+  if (http2_bdp_probe_) {
+    args.SetInt(GRPC_ARG_HTTP2_BDP_PROBE, *http2_bdp_probe_ ? 1 : 0);
+  }
+  if (http2_write_buffer_size_) {
+    args.SetInt(GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE, *http2_write_buffer_size_);
+  }
+  if (compression_algorithm_) {
+    args.SetCompressionAlgorithm(*compression_algorithm_);
+  }
+  if (tcp_read_chunk_size_) {
+    args.SetInt(GRPC_ARG_TCP_READ_CHUNK_SIZE, *tcp_read_chunk_size_);
+  }
+  if (resource_quota_) args.SetResourceQuota(*resource_quota_);
+}
+
 namespace internal {
 std::set<std::string> DefaultTracingComponents() {
   auto tracing =
@@ -44,6 +84,12 @@ std::unique_ptr<BackgroundThreads> DefaultBackgroundThreads(
       thread_pool_size);
 }
 
+std::unique_ptr<BackgroundThreads> DefaultBackgroundThreads(
+    BackgroundThreadsConfig config) {
+  return absl::make_unique<AutomaticallyCreatedBackgroundThreads>(
+      std::move(config));
+}
+
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
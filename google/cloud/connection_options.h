@@ -16,23 +16,212 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_CONNECTION_OPTIONS_H
 
 #include "google/cloud/completion_queue.h"
+#include "google/cloud/fault_injection_options.h"
 #include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/internal/thread_affinity.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/tracing_options.h"
 #include "google/cloud/version.h"
+#include "absl/types/optional.h"
 #include <grpcpp/grpcpp.h>
+#include <grpcpp/resource_quota.h>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
+/**
+ * Typed configuration for the gRPC transport.
+ *
+ * gRPC exposes most of its transport tuning as untyped channel arguments. This
+ * class collects the arguments that matter for performance in one place, so
+ * applications can tune all the gRPC-based libraries the same way. Any value
+ * left unset keeps the gRPC default.
+ *
+ * @par Example
+ * @code
+ * auto transport = google::cloud::GrpcTransportOptions{}
+ *     .set_keepalive_time(std::chrono::seconds(30))
+ *     .set_max_receive_message_size(64 * 1024 * 1024);
+ * auto options = spanner::ConnectionOptions().set_transport_options(transport);
+ * @endcode
+ */
+class GrpcTransportOptions {
+ public:
+  /**
+   * Send a keepalive ping after @p v without activity on the connection.
+   *
+   * Keepalive pings detect broken connections before an RPC fails, and prevent
+   * proxies and load balancers from closing idle connections.
+   */
+  GrpcTransportOptions& set_keepalive_time(std::chrono::milliseconds v) {
+    keepalive_time_ = v;
+    return *this;
+  }
+  absl::optional<std::chrono::milliseconds> const& keepalive_time() const {
+    return keepalive_time_;
+  }
+
+  /// Close the connection if a keepalive ping is not answered within @p v.
+  GrpcTransportOptions& set_keepalive_timeout(std::chrono::milliseconds v) {
+    keepalive_timeout_ = v;
+    return *this;
+  }
+  absl::optional<std::chrono::milliseconds> const& keepalive_timeout() const {
+    return keepalive_timeout_;
+  }
+
+  /// Send keepalive pings even if there are no RPCs in progress.
+  GrpcTransportOptions& set_keepalive_permit_without_calls(bool v) {
+    keepalive_permit_without_calls_ = v;
+    return *this;
+  }
+  absl::optional<bool> const& keepalive_permit_without_calls() const {
+    return keepalive_permit_without_calls_;
+  }
+
+  /// The maximum size for outgoing messages, in bytes. -1 means unlimited.
+  GrpcTransportOptions& set_max_send_message_size(int v) {
+    max_send_message_size_ = v;
+    return *this;
+  }
+  absl::optional<int> const& max_send_message_size() const {
+    return max_send_message_size_;
+  }
+
+  /// The maximum size for incoming messages, in bytes. -1 means unlimited.
+  GrpcTransportOptions& set_max_receive_message_size(int v) {
+    max_receive_message_size_ = v;
+    return *this;
+  }
+  absl::optional<int> const& max_receive_message_size() const {
+    return max_receive_message_size_;
+  }
+
+  /**
+   * The initial HTTP/2 flow control window for each stream, in bytes.
+   *
+   * Larger windows improve the throughput of streaming RPCs on high latency
+   * connections, at the cost of more memory per stream.
+   */
+  GrpcTransportOptions& set_http2_stream_window_size(int v) {
+    http2_stream_window_size_ = v;
+    return *this;
+  }
+  absl::optional<int> const& http2_stream_window_size() const {
+    return http2_stream_window_size_;
+  }
+
+  /**
+   * Enable or disable the HTTP/2 bandwidth-delay product probes.
+   *
+   * With the probes enabled gRPC grows the flow control windows automatically.
+   * Disable them to keep the window set by `set_http2_stream_window_size()`.
+   */
+  GrpcTransportOptions& set_http2_bdp_probe(bool v) {
+    http2_bdp_probe_ = v;
+    return *this;
+  }
+  absl::optional<bool> const& http2_bdp_probe() const {
+    return http2_bdp_probe_;
+  }
+
+  /// The size of the HTTP/2 write buffer for each stream, in bytes.
+  GrpcTransportOptions& set_http2_write_buffer_size(int v) {
+    http2_write_buffer_size_ = v;
+    return *this;
+  }
+  absl::optional<int> const& http2_write_buffer_size() const {
+    return http2_write_buffer_size_;
+  }
+
+  /// The default compression algorithm for the channel.
+  GrpcTransportOptions& set_compression_algorithm(
+      grpc_compression_algorithm v) {
+    compression_algorithm_ = v;
+    return *this;
+  }
+  absl::optional<grpc_compression_algorithm> const& compression_algorithm()
+      const {
+    return compression_algorithm_;
+  }
+
+  /**
+   * The size of the socket reads, in bytes.
+   *
+   * gRPC does not expose the kernel socket buffer sizes, this is the closest
+   * control over how much data is read from the socket at once.
+   */
+  GrpcTransportOptions& set_tcp_read_chunk_size(int v) {
+    tcp_read_chunk_size_ = v;
+    return *this;
+  }
+  absl::optional<int> const& tcp_read_chunk_size() const {
+    return tcp_read_chunk_size_;
+  }
+
+  /**
+   * Limit the memory used by the channel buffers, in bytes.
+   *
+   * Channels configured with the same `GrpcTransportOptions` object, or its
+   * copies, share this limit.
+   */
+  GrpcTransportOptions& set_resource_quota_memory(std::size_t v) {
+    resource_quota_memory_ = v;
+    resource_quota()->Resize(v);
+    return *this;
+  }
+  absl::optional<std::size_t> const& resource_quota_memory() const {
+    return resource_quota_memory_;
+  }
+
+  /// Limit the number of threads gRPC creates for the channels.
+  GrpcTransportOptions& set_resource_quota_max_threads(int v) {
+    resource_quota_max_threads_ = v;
+    resource_quota()->SetMaxThreads(v);
+    return *this;
+  }
+  absl::optional<int> const& resource_quota_max_threads() const {
+    return resource_quota_max_threads_;
+  }
+
+  /// Set the configured values in @p args.
+  void ApplyTo(grpc::ChannelArguments& args) const;
+
+ private:
+  std::shared_ptr<grpc::ResourceQuota> const& resource_quota() {
+    if (!resource_quota_) {
+      resource_quota_ = std::make_shared<grpc::ResourceQuota>();
+    }
+    return resource_quota_;
+  }
+
+  absl::optional<std::chrono::milliseconds> keepalive_time_;
+  absl::optional<std::chrono::milliseconds> keepalive_timeout_;
+  absl::optional<bool> keepalive_permit_without_calls_;
+  absl::optional<int> max_send_message_size_;
+  absl::optional<int> max_receive_message_size_;
+  absl::optional<int> http2_stream_window_size_;
+  absl::optional<bool> http2_bdp_probe_;
+  absl::optional<int> http2_write_buffer_size_;
+  absl::optional<grpc_compression_algorithm> compression_algorithm_;
+  absl::optional<int> tcp_read_chunk_size_;
+  absl::optional<std::size_t> resource_quota_memory_;
+  absl::optional<int> resource_quota_max_threads_;
+  std::shared_ptr<grpc::ResourceQuota> resource_quota_;
+};
+
 namespace internal {
 std::set<std::string> DefaultTracingComponents();
 TracingOptions DefaultTracingOptions();
 std::unique_ptr<BackgroundThreads> DefaultBackgroundThreads(std::size_t);
+std::unique_ptr<BackgroundThreads> DefaultBackgroundThreads(
+    BackgroundThreadsConfig config);
 }  // namespace internal
 
 /**
@@ -161,6 +350,45 @@ class ConnectionOptions {
     return *this;
   }
 
+  /**
+   * Share the gRPC channels with other clients in the process.
+   *
+   * By default each client creates its own channels, even if other clients
+   * use the same endpoint and credentials. With the cache enabled, clients
+   * with the same endpoint, the same credentials object, and the same channel
+   * arguments share their channels, across all the libraries. The channels
+   * are released when the last client using them is destroyed.
+   */
+  ConnectionOptions& enable_channel_cache() {
+    channel_cache_enabled_ = true;
+    return *this;
+  }
+
+  /// Do not share the gRPC channels with other clients, the default.
+  ConnectionOptions& disable_channel_cache() {
+    channel_cache_enabled_ = false;
+    return *this;
+  }
+
+  /// Return whether the clients share their channels, see
+  /// `enable_channel_cache()`.
+  bool channel_cache_enabled() const { return channel_cache_enabled_; }
+
+  /**
+   * Inject latency and errors in the RPCs, for load and resilience tests.
+   *
+   * @see `FaultInjectionOptions` for the details.
+   */
+  ConnectionOptions& set_fault_injection(FaultInjectionOptions v) {
+    fault_injection_ = v;
+    return *this;
+  }
+
+  /// Return the fault injection configuration, disabled by default.
+  FaultInjectionOptions const& fault_injection() const {
+    return fault_injection_;
+  }
+
   /**
    * Prepend @p prefix to the user-agent string.
    *
@@ -178,6 +406,21 @@ class ConnectionOptions {
   /// Return the current value for the user agent string.
   std::string const& user_agent_prefix() const { return user_agent_prefix_; }
 
+  /**
+   * Configure the gRPC transport, e.g., keepalive, flow control, compression.
+   *
+   * These values are applied by `CreateChannelArguments()`.
+   */
+  ConnectionOptions& set_transport_options(GrpcTransportOptions v) {
+    transport_options_ = std::move(v);
+    return *this;
+  }
+
+  /// The gRPC transport configuration.
+  GrpcTransportOptions const& transport_options() const {
+    return transport_options_;
+  }
+
   /**
    * Create a new `grpc::ChannelArguments` configured with the options in this
    * object.
@@ -197,6 +440,7 @@ class ConnectionOptions {
                                   channel_pool_domain());
     }
     channel_arguments.SetUserAgentPrefix(user_agent_prefix());
+    transport_options_.ApplyTo(channel_arguments);
     return channel_arguments;
   }
 
@@ -213,6 +457,71 @@ class ConnectionOptions {
     return background_thread_pool_size_;
   }
 
+  /**
+   * Pin the background threads to @p cpu_sets.
+   *
+   * Each CPU set gets its own `CompletionQueue`, and the background threads
+   * are assigned to the sets round-robin, with at least one thread per set.
+   * The connection uses the completion queue local to the CPU where it is
+   * created.
+   *
+   * @note this value is not used if `DisableBackgroundThreads()` is called.
+   */
+  ConnectionOptions& set_background_thread_cpu_sets(
+      std::vector<std::vector<int>> cpu_sets) {
+    background_thread_cpu_sets_ = std::move(cpu_sets);
+    return *this;
+  }
+  std::vector<std::vector<int>> const& background_thread_cpu_sets() const {
+    return background_thread_cpu_sets_;
+  }
+
+  /**
+   * Pin the background threads to the NUMA nodes of the host.
+   *
+   * This is equivalent to calling `set_background_thread_cpu_sets()` with the
+   * CPUs of each NUMA node. It has no effect if the NUMA topology is unknown,
+   * for example, on platforms other than Linux.
+   */
+  ConnectionOptions& enable_numa_aware_background_threads() {
+    return set_background_thread_cpu_sets(internal::NumaNodeCpuSets());
+  }
+
+  /**
+   * Name the background threads `<name>-<index>`.
+   *
+   * The names are visible in debuggers and profilers. On Linux they are
+   * truncated to 15 characters.
+   *
+   * @note this value is not used if `DisableBackgroundThreads()` is called.
+   */
+  ConnectionOptions& set_background_thread_name(std::string name) {
+    background_thread_name_ = std::move(name);
+    return *this;
+  }
+  std::string const& background_thread_name() const {
+    return background_thread_name_;
+  }
+
+  /**
+   * Shard the background completion queue.
+   *
+   * With more than one shard, each with its own gRPC completion queue, map of
+   * pending operations, and threads, the background threads contend less for
+   * the completion queue locks. This is only useful with many threads and a
+   * high rate of asynchronous operations. The connection creates at least one
+   * background thread per shard.
+   *
+   * @note this value is not used if `DisableBackgroundThreads()` is called.
+   */
+  ConnectionOptions& set_completion_queue_shards(std::size_t n) {
+    completion_queue_shards_ = n;
+    return *this;
+  }
+  std::size_t completion_queue_shards() const {
+    return completion_queue_shards_;
+  }
+
   /**
    * Configure the connection to use @p cq for all background work.
    *
@@ -231,12 +540,34 @@ class ConnectionOptions {
     return *this;
   }
 
+  /**
+   * Returns `true` if the application configured the background threads.
+   *
+   * That is, if the application called `set_background_thread_pool_size()`
+   * with a non-zero value, configured the CPU sets, the name, or the
+   * completion queue shards of the background threads, or called
+   * `DisableBackgroundThreads()`. Some libraries share the background threads
+   * across all their connections when the application does not configure
+   * them.
+   */
+  bool background_threads_configured() const {
+    return background_thread_pool_size_ != 0 ||
+           !background_thread_cpu_sets_.empty() ||
+           completion_queue_shards_ > 1 ||
+           !background_thread_name_.empty() ||
+           static_cast<bool>(background_threads_factory_);
+  }
+
   using BackgroundThreadsFactory =
       std::function<std::unique_ptr<BackgroundThreads>()>;
   BackgroundThreadsFactory background_threads_factory() const {
     if (background_threads_factory_) return background_threads_factory_;
-    auto const s = background_thread_pool_size_;
-    return [s] { return internal::DefaultBackgroundThreads(s); };
+    internal::BackgroundThreadsConfig config;
+    config.thread_count = background_thread_pool_size_;
+    config.cpu_sets = background_thread_cpu_sets_;
+    config.thread_name = background_thread_name_;
+    config.completion_queue_shards = completion_queue_shards_;
+    return [config] { return internal::DefaultBackgroundThreads(config); };
   }
 
  private:
@@ -246,9 +577,15 @@ class ConnectionOptions {
   std::set<std::string> tracing_components_;
   TracingOptions tracing_options_;
   std::string channel_pool_domain_;
+  bool channel_cache_enabled_ = false;
+  FaultInjectionOptions fault_injection_;
 
   std::string user_agent_prefix_;
+  GrpcTransportOptions transport_options_;
   std::size_t background_thread_pool_size_ = 0;
+  std::vector<std::vector<int>> background_thread_cpu_sets_;
+  std::string background_thread_name_;
+  std::size_t completion_queue_shards_ = 1;
   BackgroundThreadsFactory background_threads_factory_;
 };
 
@@ -109,6 +109,23 @@ TEST(ConnectionOptionsTest, ChannelPoolName) {
   EXPECT_EQ("test-channel-pool", options.channel_pool_domain());
 }
 
+TEST(ConnectionOptionsTest, ChannelCache) {
+  TestConnectionOptions options(grpc::InsecureChannelCredentials());
+  EXPECT_FALSE(options.channel_cache_enabled());
+  options.enable_channel_cache();
+  EXPECT_TRUE(options.channel_cache_enabled());
+  options.disable_channel_cache();
+  EXPECT_FALSE(options.channel_cache_enabled());
+}
+
+TEST(ConnectionOptionsTest, FaultInjection) {
+  TestConnectionOptions options(grpc::InsecureChannelCredentials());
+  EXPECT_FALSE(options.fault_injection().enabled());
+  options.set_fault_injection(FaultInjectionOptions{}.set_error_rate(0.5));
+  EXPECT_TRUE(options.fault_injection().enabled());
+  EXPECT_EQ(0.5, options.fault_injection().error_rate());
+}
+
 TEST(ConnectionOptionsTest, UserAgentPrefix) {
   TestConnectionOptions options(grpc::InsecureChannelCredentials());
   EXPECT_EQ(TestTraits::user_agent_prefix(), options.user_agent_prefix());
@@ -134,6 +151,48 @@ TEST(ConnectionOptionsTest, CreateChannelArgumentsDefault) {
               StartsWith(options.user_agent_prefix()));
 }
 
+TEST(ConnectionOptionsTest, TransportOptions) {
+  TestConnectionOptions options(grpc::InsecureChannelCredentials());
+  options.set_transport_options(
+      GrpcTransportOptions{}
+          .set_keepalive_time(std::chrono::seconds(30))
+          .set_keepalive_timeout(std::chrono::seconds(5))
+          .set_keepalive_permit_without_calls(true)
+          .set_max_send_message_size(1024)
+          .set_max_receive_message_size(2048)
+          .set_http2_stream_window_size(4096)
+          .set_http2_bdp_probe(false)
+          .set_http2_write_buffer_size(8192)
+          .set_compression_algorithm(GRPC_COMPRESS_GZIP)
+          .set_tcp_read_chunk_size(16384)
+          .set_resource_quota_max_threads(4));
+  EXPECT_EQ(std::chrono::milliseconds(30000),
+            options.transport_options().keepalive_time());
+
+  auto actual = options.CreateChannelArguments();
+
+  grpc_channel_args test_args = actual.c_channel_args();
+  std::map<std::string, int> args;
+  bool has_quota = false;
+  for (std::size_t i = 0; i != test_args.num_args; ++i) {
+    auto const& arg = test_args.args[i];
+    if (arg.type == GRPC_ARG_INTEGER) args[arg.key] = arg.value.integer;
+    if (std::string(arg.key) == GRPC_ARG_RESOURCE_QUOTA) has_quota = true;
+  }
+  EXPECT_EQ(30000, args[GRPC_ARG_KEEPALIVE_TIME_MS]);
+  EXPECT_EQ(5000, args[GRPC_ARG_KEEPALIVE_TIMEOUT_MS]);
+  EXPECT_EQ(1, args[GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS]);
+  EXPECT_EQ(1024, args[GRPC_ARG_MAX_SEND_MESSAGE_LENGTH]);
+  EXPECT_EQ(2048, args[GRPC_ARG_MAX_RECEIVE_MESSAGE_LENGTH]);
+  EXPECT_EQ(4096, args[GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES]);
+  EXPECT_EQ(0, args.at(GRPC_ARG_HTTP2_BDP_PROBE));
+  EXPECT_EQ(8192, args[GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE]);
+  EXPECT_EQ(GRPC_COMPRESS_GZIP,
+            args[GRPC_COMPRESSION_CHANNEL_DEFAULT_ALGORITHM]);
+  EXPECT_EQ(16384, args[GRPC_ARG_TCP_READ_CHUNK_SIZE]);
+  EXPECT_TRUE(has_quota);
+}
+
 TEST(ConnectionOptionsTest, CreateChannelArgumentsWithChannelPool) {
   TestConnectionOptions options(grpc::InsecureChannelCredentials());
   options.set_channel_pool_domain("testing-pool");
@@ -166,8 +225,11 @@ TEST(ConnectionOptionsTest, CreateChannelArgumentsWithChannelPool) {
 TEST(ConnectionOptionsTest, CustomBackgroundThreads) {
   CompletionQueue cq;
 
+  EXPECT_FALSE(TestConnectionOptions(grpc::InsecureChannelCredentials())
+                   .background_threads_configured());
   auto options = TestConnectionOptions(grpc::InsecureChannelCredentials())
                      .DisableBackgroundThreads(cq);
+  EXPECT_TRUE(options.background_threads_configured());
   auto background = options.background_threads_factory()();
 
   using ms = std::chrono::milliseconds;
@@ -226,6 +288,7 @@ TEST(ConnectionOptionsTest, DefaultBackgroundThreads) {
   auto constexpr kThreadCount = 4;
   auto options = TestConnectionOptions(grpc::InsecureChannelCredentials())
                      .set_background_thread_pool_size(kThreadCount);
+  EXPECT_TRUE(options.background_threads_configured());
   auto background = options.background_threads_factory()();
   auto* tp = dynamic_cast<internal::AutomaticallyCreatedBackgroundThreads*>(
       background.get());
@@ -233,6 +296,33 @@ TEST(ConnectionOptionsTest, DefaultBackgroundThreads) {
   EXPECT_EQ(kThreadCount, tp->pool_size());
 }
 
+TEST(ConnectionOptionsTest, BackgroundThreadsCpuSets) {
+  auto options = TestConnectionOptions(grpc::InsecureChannelCredentials());
+  EXPECT_FALSE(options.background_threads_configured());
+  options.set_background_thread_cpu_sets({{0}, {0}})
+      .set_background_thread_name("test-bg");
+  EXPECT_TRUE(options.background_threads_configured());
+  EXPECT_EQ("test-bg", options.background_thread_name());
+  auto background = options.background_threads_factory()();
+  auto* tp = dynamic_cast<internal::AutomaticallyCreatedBackgroundThreads*>(
+      background.get());
+  ASSERT_NE(nullptr, tp);
+  EXPECT_EQ(2, tp->cq_count());
+  EXPECT_EQ(2, tp->pool_size());
+}
+
+TEST(ConnectionOptionsTest, CompletionQueueShards) {
+  auto options = TestConnectionOptions(grpc::InsecureChannelCredentials());
+  EXPECT_EQ(1, options.completion_queue_shards());
+  options.set_completion_queue_shards(4);
+  EXPECT_TRUE(options.background_threads_configured());
+  auto background = options.background_threads_factory()();
+  auto* tp = dynamic_cast<internal::AutomaticallyCreatedBackgroundThreads*>(
+      background.get());
+  ASSERT_NE(nullptr, tp);
+  EXPECT_EQ(4, tp->pool_size());
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -0,0 +1,106 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FAULT_INJECTION_OPTIONS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FAULT_INJECTION_OPTIONS_H
+
+#include "google/cloud/status.h"
+#include "google/cloud/version.h"
+#include <chrono>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+/**
+ * Configure the faults injected in the RPCs of a client.
+ *
+ * Load tests of the retry, hedging, and flow control behavior need realistic
+ * failures, without waiting for a real outage. When any of the rates is
+ * positive the libraries add a decorator to their stubs which, for each RPC:
+ *
+ * - delays a `latency_rate()` fraction of the calls, with a log-normal
+ *   distribution with the given median and 99th percentile,
+ * - fails an `error_rate()` fraction of the calls with `error_code()`,
+ * - breaks a `stream_reset_rate()` fraction of the reads in streaming RPCs,
+ *   the stream then finishes with `error_code()`.
+ *
+ * The faults are injected below the retry loops, so the libraries handle
+ * them as they would handle errors from the service.
+ *
+ * @warning This is intended for testing, do not enable it in production.
+ */
+class FaultInjectionOptions {
+ public:
+  /// Fail this fraction of the calls, in [0, 1].
+  FaultInjectionOptions& set_error_rate(double v) {
+    error_rate_ = v;
+    return *this;
+  }
+  double error_rate() const { return error_rate_; }
+
+  /// The code for the injected errors, `kUnavailable`, a transient error, by
+  /// default.
+  FaultInjectionOptions& set_error_code(StatusCode v) {
+    error_code_ = v;
+    return *this;
+  }
+  StatusCode error_code() const { return error_code_; }
+
+  /// Delay this fraction of the calls, in [0, 1].
+  FaultInjectionOptions& set_latency_rate(double v) {
+    latency_rate_ = v;
+    return *this;
+  }
+  double latency_rate() const { return latency_rate_; }
+
+  /// The median of the injected delays.
+  FaultInjectionOptions& set_latency_median(std::chrono::microseconds v) {
+    latency_median_ = v;
+    return *this;
+  }
+  std::chrono::microseconds latency_median() const { return latency_median_; }
+
+  /// The 99th percentile of the injected delays, the tail latency.
+  FaultInjectionOptions& set_latency_p99(std::chrono::microseconds v) {
+    latency_p99_ = v;
+    return *this;
+  }
+  std::chrono::microseconds latency_p99() const { return latency_p99_; }
+
+  /// Break this fraction of the reads in streaming RPCs, in [0, 1].
+  FaultInjectionOptions& set_stream_reset_rate(double v) {
+    stream_reset_rate_ = v;
+    return *this;
+  }
+  double stream_reset_rate() const { return stream_reset_rate_; }
+
+  /// Returns true if any fault is injected.
+  bool enabled() const {
+    return error_rate_ > 0 || latency_rate_ > 0 || stream_reset_rate_ > 0;
+  }
+
+ private:
+  double error_rate_ = 0;
+  StatusCode error_code_ = StatusCode::kUnavailable;
+  double latency_rate_ = 0;
+  std::chrono::microseconds latency_median_ = std::chrono::milliseconds(10);
+  std::chrono::microseconds latency_p99_ = std::chrono::milliseconds(100);
+  double stream_reset_rate_ = 0;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FAULT_INJECTION_OPTIONS_H
@@ -0,0 +1,282 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/firestore/bulk_writer.h"
+#include "google/cloud/firestore/internal/rate_limiter.h"
+#include "google/cloud/grpc_error_delegate.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace firestore {
+namespace v1 = ::google::firestore::v1;
+
+namespace {
+
+using TimerFuture = future<StatusOr<std::chrono::system_clock::time_point>>;
+
+struct PendingWrite {
+  v1::Write write;
+  promise<StatusOr<v1::WriteResult>> result;
+  std::unique_ptr<RetryPolicy> retry_policy;
+  std::unique_ptr<BackoffPolicy> backoff_policy;
+};
+
+std::string const& DocumentName(v1::Write const& write) {
+  switch (write.operation_case()) {
+    case v1::Write::kUpdate:
+      return write.update().name();
+    case v1::Write::kDelete:
+      return write.delete_();
+    case v1::Write::kTransform:
+      return write.transform().document();
+    default:
+      break;
+  }
+  static auto const* const kEmpty = new std::string;
+  return *kEmpty;
+}
+
+// The status of the write at @p index in a `BatchWrite` response.
+Status WriteStatus(StatusOr<v1::BatchWriteResponse> const& response,
+                   int index) {
+  if (!response) return response.status();
+  if (index >= response->status_size()) return Status{};
+  return MakeStatusFromRpcError(response->status(index));
+}
+
+}  // namespace
+
+class BulkWriter::State : public std::enable_shared_from_this<State> {
+ public:
+  State(std::shared_ptr<firestore_internal::FirestoreStub> stub,
+        CompletionQueue cq, std::string database, Options options)
+      : stub_(std::move(stub)),
+        cq_(std::move(cq)),
+        database_(std::move(database)),
+        options_(std::move(options)),
+        limiter_(options_.initial_writes_per_second,
+                 options_.max_writes_per_second, options_.ramp_up_multiplier,
+                 options_.ramp_up_period, Clock::now()) {}
+
+  future<StatusOr<v1::WriteResult>> Write(v1::Write write) {
+    PendingWrite w;
+    w.write = std::move(write);
+    w.retry_policy = options_.retry_policy->clone();
+    w.backoff_policy = options_.backoff_policy->clone();
+    auto f = w.result.get_future();
+    std::unique_lock<std::mutex> lk(mu_);
+    queue_.push_back(std::move(w));
+    Drain(std::move(lk), false);
+    return f;
+  }
+
+  void Flush() { Drain(std::unique_lock<std::mutex>(mu_), true); }
+
+ private:
+  using Clock = firestore_internal::RampUpRateLimiter::Clock;
+
+  std::size_t MaxBatchSize() const {
+    return (std::max)(options_.max_batch_size, std::size_t{1});
+  }
+
+  // Send as many batches as the limits allow. Partial batches are only sent
+  // if @p force is set.
+  void Drain(std::unique_lock<std::mutex> lk, bool force) {
+    std::vector<std::vector<PendingWrite>> batches;
+    auto throttle = Clock::duration(0);
+    while (!throttled_ && !queue_.empty() &&
+           in_flight_ < (std::max)(options_.max_in_flight_batches,
+                                   std::size_t{1})) {
+      if (!force && queue_.size() < MaxBatchSize()) break;
+      auto const scanned = ScanBatch();
+      throttle = limiter_.Acquire(scanned.first, Clock::now());
+      if (throttle != Clock::duration(0)) {
+        throttled_ = true;
+        break;
+      }
+      batches.push_back(TakeBatch(scanned.second));
+      ++in_flight_;
+    }
+    bool const start_timer = !queue_.empty() && !throttled_ && !timer_running_;
+    if (start_timer) timer_running_ = true;
+    lk.unlock();
+    // Start the timers and send the requests without holding the lock, their
+    // callbacks may run immediately.
+    if (throttle != Clock::duration(0)) StartThrottleTimer(throttle);
+    if (start_timer) StartFlushTimer();
+    for (auto& b : batches) Send(std::move(b));
+  }
+
+  // Find the writes for the next batch, skipping writes for documents already
+  // in the batch. Returns the size of the batch and the number of queued
+  // writes examined.
+  std::pair<std::size_t, std::size_t> ScanBatch() const {
+    std::set<std::string> names;
+    std::size_t scanned = 0;
+    for (auto const& w : queue_) {
+      if (names.size() == MaxBatchSize()) break;
+      ++scanned;
+      names.insert(DocumentName(w.write));
+    }
+    return {names.size(), scanned};
+  }
+
+  std::vector<PendingWrite> TakeBatch(std::size_t scanned) {
+    std::set<std::string> names;
+    std::vector<PendingWrite> batch;
+    std::vector<PendingWrite> skipped;
+    for (std::size_t i = 0; i != scanned; ++i) {
+      auto& w = queue_[i];
+      if (names.insert(DocumentName(w.write)).second) {
+        batch.push_back(std::move(w));
+      } else {
+        skipped.push_back(std::move(w));
+      }
+    }
+    using difference_type = std::deque<PendingWrite>::difference_type;
+    auto const end =
+        std::next(queue_.begin(), static_cast<difference_type>(scanned));
+    queue_.erase(queue_.begin(), end);
+    queue_.insert(queue_.begin(), std::make_move_iterator(skipped.begin()),
+                  std::make_move_iterator(skipped.end()));
+    return batch;
+  }
+
+  void Send(std::vector<PendingWrite> batch) {
+    v1::BatchWriteRequest request;
+    request.set_database(database_);
+    for (auto const& w : batch) *request.add_writes() = w.write;
+    auto self = shared_from_this();
+    auto writes = std::make_shared<std::vector<PendingWrite>>(std::move(batch));
+    stub_
+        ->AsyncBatchWrite(cq_, absl::make_unique<grpc::ClientContext>(),
+                          request)
+        .then([self, writes](future<StatusOr<v1::BatchWriteResponse>> f) {
+          self->OnBatchWrite(std::move(*writes), f.get());
+        });
+  }
+
+  void OnBatchWrite(std::vector<PendingWrite> batch,
+                    StatusOr<v1::BatchWriteResponse> const& response) {
+    for (std::size_t i = 0; i != batch.size(); ++i) {
+      auto& w = batch[i];
+      auto const index = static_cast<int>(i);
+      auto status = WriteStatus(response, index);
+      if (status.ok()) {
+        w.result.set_value(index < response->write_results_size()
+                               ? response->write_results(index)
+                               : v1::WriteResult{});
+        continue;
+      }
+      // Each write is retried on its own, the rest of the batch succeeded or
+      // failed independently.
+      if (!w.retry_policy->OnFailure(status)) {
+        w.result.set_value(std::move(status));
+        continue;
+      }
+      Retry(std::move(w), std::move(status));
+    }
+    std::unique_lock<std::mutex> lk(mu_);
+    --in_flight_;
+    Drain(std::move(lk), false);
+  }
+
+  void Retry(PendingWrite w, Status last_status) {
+    auto const delay = w.backoff_policy->OnCompletion();
+    auto self = shared_from_this();
+    auto pending = std::make_shared<PendingWrite>(std::move(w));
+    cq_.MakeRelativeTimer(delay).then(
+        [self, pending, last_status](TimerFuture f) {
+          if (!f.get()) {
+            pending->result.set_value(last_status);
+            return;
+          }
+          std::unique_lock<std::mutex> lk(self->mu_);
+          self->queue_.push_front(std::move(*pending));
+          self->Drain(std::move(lk), false);
+        });
+  }
+
+  void StartFlushTimer() {
+    std::weak_ptr<State> weak = shared_from_this();
+    cq_.MakeRelativeTimer(options_.flush_period).then([weak](TimerFuture f) {
+      auto self = weak.lock();
+      if (!self) return;
+      auto tp = f.get();
+      std::unique_lock<std::mutex> lk(self->mu_);
+      self->timer_running_ = false;
+      if (!tp) return self->Abort(std::move(lk), tp.status());
+      self->Drain(std::move(lk), true);
+    });
+  }
+
+  void StartThrottleTimer(Clock::duration wait) {
+    // Keep the state alive, the queued writes must complete even if the
+    // `BulkWriter` is deleted.
+    auto self = shared_from_this();
+    cq_.MakeRelativeTimer(wait).then([self](TimerFuture f) {
+      auto tp = f.get();
+      std::unique_lock<std::mutex> lk(self->mu_);
+      self->throttled_ = false;
+      if (!tp) return self->Abort(std::move(lk), tp.status());
+      self->Drain(std::move(lk), true);
+    });
+  }
+
+  // The completion queue is shutting down, no more requests can be sent.
+  void Abort(std::unique_lock<std::mutex> lk, Status const& status) {
+    std::deque<PendingWrite> queue;
+    queue.swap(queue_);
+    lk.unlock();
+    for (auto& w : queue) w.result.set_value(status);
+  }
+
+  std::shared_ptr<firestore_internal::FirestoreStub> const stub_;
+  CompletionQueue cq_;
+  std::string const database_;
+  Options const options_;
+  std::mutex mu_;
+  firestore_internal::RampUpRateLimiter limiter_;  // GUARDED_BY(mu_)
+  std::deque<PendingWrite> queue_;                 // GUARDED_BY(mu_)
+  std::size_t in_flight_ = 0;                      // GUARDED_BY(mu_)
+  bool timer_running_ = false;                     // GUARDED_BY(mu_)
+  bool throttled_ = false;                         // GUARDED_BY(mu_)
+};
+
+BulkWriter::BulkWriter(std::shared_ptr<firestore_internal::FirestoreStub> stub,
+                       CompletionQueue cq, std::string database,
+                       Options options)
+    : state_(std::make_shared<State>(std::move(stub), std::move(cq),
+                                     std::move(database),
+                                     std::move(options))) {}
+
+BulkWriter::~BulkWriter() { state_->Flush(); }
+
+future<StatusOr<v1::WriteResult>> BulkWriter::Write(v1::Write write) {
+  return state_->Write(std::move(write));
+}
+
+void BulkWriter::Flush() { state_->Flush(); }
+
+}  // namespace firestore
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,183 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_BULK_WRITER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_BULK_WRITER_H
+
+#include "google/cloud/firestore/internal/firestore_stub.h"
+#include "google/cloud/firestore/retry_policy.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status_or.h"
+#include <google/firestore/v1/write.pb.h>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace firestore {
+/**
+ * Applies a large number of independent writes with `BatchWrite` requests.
+ *
+ * Applications loading or updating many documents pay a round trip per
+ * `Commit` request, and may overload the service if they send too many writes
+ * too quickly. This class groups the writes into `BatchWrite` requests, keeps
+ * a bounded number of requests in flight, and retries each failed write on its
+ * own. Writes in a `BatchWrite` request are not applied atomically, and are
+ * not applied in any particular order.
+ *
+ * The rate of writes follows the "500/50/5" rule recommended for Cloud
+ * Firestore: start with at most 500 writes per second, and increase the rate
+ * by 50% every 5 minutes. The rates and the ramp up schedule are configurable
+ * via `Options`.
+ *
+ * Writes wait up to `Options::flush_period` for a full batch before they are
+ * sent. Applications must run the event loop of the `CompletionQueue` in one
+ * or more threads, `DataClient::MakeBulkWriter()` uses the background threads
+ * of the client.
+ *
+ * @par Thread-safety
+ * Instances of this class are guaranteed to work when accessed concurrently
+ * from multiple threads.
+ *
+ * @par Example
+ * @code
+ * namespace fs = google::cloud::firestore;
+ * auto writer = client.MakeBulkWriter(
+ *     "projects/my-project/databases/(default)");
+ * std::vector<future<StatusOr<google::firestore::v1::WriteResult>>> results;
+ * for (auto& w : writes) results.push_back(writer->Write(std::move(w)));
+ * for (auto& r : results) {
+ *   auto result = r.get();
+ *   if (!result) std::cerr << result.status() << "\n";
+ * }
+ * @endcode
+ */
+class BulkWriter {
+ public:
+  /// Configure a `BulkWriter`.
+  struct Options {
+    Options() = default;
+
+    /// The maximum number of writes in each `BatchWrite` request.
+    Options& SetMaxBatchSize(std::size_t v) {
+      max_batch_size = v;
+      return *this;
+    }
+
+    /// The maximum number of `BatchWrite` requests in flight.
+    Options& SetMaxInFlightBatches(std::size_t v) {
+      max_in_flight_batches = v;
+      return *this;
+    }
+
+    /// How long writes wait for a full batch before they are sent.
+    Options& SetFlushPeriod(std::chrono::milliseconds v) {
+      flush_period = v;
+      return *this;
+    }
+
+    /// The initial rate, in writes per second.
+    Options& SetInitialWritesPerSecond(double v) {
+      initial_writes_per_second = v;
+      return *this;
+    }
+
+    /// The rate never increases above this value, in writes per second.
+    Options& SetMaxWritesPerSecond(double v) {
+      max_writes_per_second = v;
+      return *this;
+    }
+
+    /// Multiply the rate by @p multiplier after each @p period.
+    Options& SetRampUp(double multiplier, std::chrono::milliseconds period) {
+      ramp_up_multiplier = multiplier;
+      ramp_up_period = period;
+      return *this;
+    }
+
+    /// The retry policy for each write, cloned for every write.
+    Options& SetRetryPolicy(RetryPolicy const& v) {
+      retry_policy = v.clone();
+      return *this;
+    }
+
+    /// The backoff policy for each write, cloned for every write.
+    Options& SetBackoffPolicy(BackoffPolicy const& v) {
+      backoff_policy = v.clone();
+      return *this;
+    }
+
+    std::size_t max_batch_size = 20;
+    std::size_t max_in_flight_batches = 10;
+    std::chrono::milliseconds flush_period = std::chrono::milliseconds(10);
+    double initial_writes_per_second = 500;
+    double max_writes_per_second = 10000;
+    double ramp_up_multiplier = 1.5;
+    std::chrono::milliseconds ramp_up_period = std::chrono::minutes(5);
+    std::shared_ptr<RetryPolicy const> retry_policy =
+        LimitedErrorCountRetryPolicy(10).clone();
+    std::shared_ptr<BackoffPolicy const> backoff_policy =
+        ExponentialBackoffPolicy(std::chrono::seconds(1),
+                                 std::chrono::seconds(60), 1.5)
+            .clone();
+  };
+
+  /**
+   * Create a writer for @p database.
+   *
+   * Applications should use `DataClient::MakeBulkWriter()`, this constructor
+   * is used in tests.
+   *
+   * @param database the database name, in the
+   *     `projects/{project_id}/databases/{database_id}` format.
+   */
+  BulkWriter(std::shared_ptr<firestore_internal::FirestoreStub> stub,
+             CompletionQueue cq, std::string database,
+             Options options = Options());
+
+  /// Sends any pending writes, without waiting for them.
+  ~BulkWriter();
+
+  BulkWriter(BulkWriter const&) = delete;
+  BulkWriter& operator=(BulkWriter const&) = delete;
+
+  /**
+   * Queue @p write.
+   *
+   * A batch never contains two writes for the same document, later writes
+   * wait for the next batch.
+   *
+   * @returns a future satisfied with the result of the write once it succeeds,
+   *     or with the last error once the retry policy is exhausted.
+   */
+  future<StatusOr<google::firestore::v1::WriteResult>> Write(
+      google::firestore::v1::Write write);
+
+  /// Send all the pending writes now, subject to the rate and in flight
+  /// limits.
+  void Flush();
+
+ private:
+  class State;
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace firestore
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_BULK_WRITER_H
@@ -0,0 +1,222 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/firestore/bulk_writer.h"
+#include "google/cloud/firestore/testing/mock_firestore_stub.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/fake_completion_queue_impl.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace firestore {
+namespace {
+
+namespace v1 = ::google::firestore::v1;
+
+using ::google::cloud::firestore_testing::MockFirestoreStub;
+using ::google::cloud::testing_util::FakeCompletionQueueImpl;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+
+v1::Write MakeDelete(std::string const& name) {
+  v1::Write write;
+  write.set_delete_("projects/p/databases/d/documents/c/" + name);
+  return write;
+}
+
+std::vector<std::string> Names(v1::BatchWriteRequest const& request) {
+  std::vector<std::string> names;
+  for (auto const& w : request.writes()) {
+    names.push_back(w.delete_().substr(w.delete_().rfind('/') + 1));
+  }
+  return names;
+}
+
+// Returns a successful response for every write in @p request, except for the
+// writes at @p failures, which fail with @p code.
+future<StatusOr<v1::BatchWriteResponse>> MakeResponse(
+    v1::BatchWriteRequest const& request, std::vector<int> const& failures = {},
+    grpc::StatusCode code = grpc::StatusCode::UNAVAILABLE) {
+  v1::BatchWriteResponse response;
+  for (int i = 0; i != request.writes_size(); ++i) {
+    auto& status = *response.add_status();
+    response.add_write_results()->mutable_update_time()->set_seconds(i + 1);
+    if (std::find(failures.begin(), failures.end(), i) != failures.end()) {
+      status.set_code(code);
+      status.set_message("try-again");
+    }
+  }
+  return make_ready_future(make_status_or(std::move(response)));
+}
+
+class BulkWriterTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<MockFirestoreStub> mock_ =
+      std::make_shared<MockFirestoreStub>();
+  std::shared_ptr<FakeCompletionQueueImpl> cq_impl_ =
+      std::make_shared<FakeCompletionQueueImpl>();
+  CompletionQueue cq_ = CompletionQueue(cq_impl_);
+};
+
+TEST_F(BulkWriterTest, SendsFullBatchesImmediately) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        EXPECT_EQ("projects/p/databases/d", request.database());
+        EXPECT_THAT(Names(request), ElementsAre("a", "b"));
+        return MakeResponse(request);
+      });
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        EXPECT_THAT(Names(request), ElementsAre("c"));
+        return MakeResponse(request);
+      });
+
+  BulkWriter tested(mock_, cq_, "projects/p/databases/d",
+                    BulkWriter::Options().SetMaxBatchSize(2));
+  auto a = tested.Write(MakeDelete("a"));
+  auto b = tested.Write(MakeDelete("b"));
+  auto c = tested.Write(MakeDelete("c"));
+  ASSERT_STATUS_OK(a.get());
+  EXPECT_EQ(2, b.get()->update_time().seconds());
+
+  // The partial batch is sent when the flush timer expires.
+  cq_impl_->SimulateCompletion(true);
+  ASSERT_STATUS_OK(c.get());
+}
+
+TEST_F(BulkWriterTest, OneWritePerDocumentInEachBatch) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        EXPECT_THAT(Names(request), ElementsAre("a", "b"));
+        return MakeResponse(request);
+      });
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        EXPECT_THAT(Names(request), ElementsAre("a"));
+        return MakeResponse(request);
+      });
+
+  BulkWriter tested(mock_, cq_, "projects/p/databases/d");
+  auto a1 = tested.Write(MakeDelete("a"));
+  auto a2 = tested.Write(MakeDelete("a"));
+  auto b = tested.Write(MakeDelete("b"));
+  tested.Flush();
+  ASSERT_STATUS_OK(a1.get());
+  ASSERT_STATUS_OK(a2.get());
+  ASSERT_STATUS_OK(b.get());
+}
+
+TEST_F(BulkWriterTest, RetriesFailedWrites) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        EXPECT_THAT(Names(request), ElementsAre("a", "b"));
+        return MakeResponse(request, {0});
+      });
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        // Only the failed write is sent again.
+        EXPECT_THAT(Names(request), ElementsAre("a"));
+        return MakeResponse(request);
+      });
+
+  BulkWriter tested(mock_, cq_, "projects/p/databases/d");
+  auto a = tested.Write(MakeDelete("a"));
+  auto b = tested.Write(MakeDelete("b"));
+  tested.Flush();
+  ASSERT_STATUS_OK(b.get());
+
+  // Complete the backoff timer, and then the flush timer sending the retry.
+  cq_impl_->SimulateCompletion(true);
+  cq_impl_->SimulateCompletion(true);
+  ASSERT_STATUS_OK(a.get());
+}
+
+TEST_F(BulkWriterTest, PermanentErrorsAreNotRetried) {
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        return MakeResponse(request, {1},
+                            grpc::StatusCode::PERMISSION_DENIED);
+      });
+
+  BulkWriter tested(mock_, cq_, "projects/p/databases/d");
+  auto a = tested.Write(MakeDelete("a"));
+  auto b = tested.Write(MakeDelete("b"));
+  tested.Flush();
+  ASSERT_STATUS_OK(a.get());
+  EXPECT_THAT(b.get(), StatusIs(StatusCode::kPermissionDenied));
+}
+
+TEST_F(BulkWriterTest, LimitsBatchesInFlight) {
+  promise<StatusOr<v1::BatchWriteResponse>> first;
+  v1::BatchWriteRequest first_request;
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([&](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                    v1::BatchWriteRequest const& request) {
+        first_request = request;
+        return first.get_future();
+      });
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        EXPECT_THAT(Names(request), ElementsAre("b"));
+        return MakeResponse(request);
+      });
+
+  BulkWriter tested(
+      mock_, cq_, "projects/p/databases/d",
+      BulkWriter::Options().SetMaxBatchSize(1).SetMaxInFlightBatches(1));
+  auto a = tested.Write(MakeDelete("a"));
+  auto b = tested.Write(MakeDelete("b"));
+  // The second batch waits until the first completes.
+  first.set_value(MakeResponse(first_request).get());
+  ASSERT_STATUS_OK(a.get());
+  ASSERT_STATUS_OK(b.get());
+}
+
+TEST_F(BulkWriterTest, FlushOnDestruction) {
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        return MakeResponse(request);
+      });
+
+  future<StatusOr<v1::WriteResult>> f;
+  {
+    BulkWriter tested(mock_, cq_, "projects/p/databases/d");
+    f = tested.Write(MakeDelete("a"));
+  }
+  ASSERT_STATUS_OK(f.get());
+}
+
+}  // namespace
+}  // namespace firestore
+}  // namespace cloud
+}  // namespace google
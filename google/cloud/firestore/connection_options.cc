@@ -0,0 +1,38 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/firestore/connection_options.h"
+#include "google/cloud/internal/compiler_info.h"
+#include "google/cloud/version.h"
+
+namespace google {
+namespace cloud {
+namespace firestore {
+
+std::string ConnectionOptionsTraits::default_endpoint() {
+  return "firestore.googleapis.com";
+}
+
+std::string ConnectionOptionsTraits::user_agent_prefix() {
+  return "gcloud-cpp/" + ::google::cloud::version_string() + " (" +
+         ::google::cloud::internal::CompilerId() + "-" +
+         ::google::cloud::internal::CompilerVersion() + "; " +
+         ::google::cloud::internal::CompilerFeatures() + ")";
+}
+
+int ConnectionOptionsTraits::default_num_channels() { return 4; }
+
+}  // namespace firestore
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,336 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/firestore/data_client.h"
+#include "google/cloud/internal/resumable_streaming_read_rpc.h"
+#include "google/cloud/internal/retry_loop.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_split.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace firestore {
+namespace v1 = ::google::firestore::v1;
+
+namespace {
+
+/**
+ * Calls `fn(i)` for each `i` in `[0, count)`, using up to @p max_threads
+ * threads.
+ *
+ * Stops starting new calls after the first error, and returns it.
+ */
+template <typename Functor>
+Status ParallelFor(std::size_t count, std::size_t max_threads, Functor fn) {
+  std::atomic<std::size_t> next{0};
+  std::mutex mu;
+  Status first_error;
+  std::atomic<bool> failed{false};
+  auto worker = [&] {
+    for (auto i = next++; i < count && !failed.load(); i = next++) {
+      auto status = fn(i);
+      if (status.ok()) continue;
+      std::lock_guard<std::mutex> lk(mu);
+      if (!failed.exchange(true)) first_error = std::move(status);
+    }
+  };
+  auto const threads =
+      (std::min)(count, (std::max)(max_threads, std::size_t{1}));
+  std::vector<std::thread> pool;
+  // The calling thread is one of the workers, it would be idle otherwise.
+  for (std::size_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+  worker();
+  for (auto& t : pool) t.join();
+  return first_error;
+}
+
+std::string const& ResultName(v1::BatchGetDocumentsResponse const& response) {
+  if (response.has_found()) return response.found().name();
+  return response.missing();
+}
+
+// Compares document names one path segment at a time, this is how the service
+// orders documents by `__name__`.
+bool NameLess(std::string const& a, std::string const& b) {
+  std::vector<absl::string_view> sa = absl::StrSplit(a, '/');
+  std::vector<absl::string_view> sb = absl::StrSplit(b, '/');
+  return std::lexicographical_compare(sa.begin(), sa.end(), sb.begin(),
+                                      sb.end());
+}
+
+std::string const& CursorName(v1::Cursor const& cursor) {
+  static auto const* const kEmpty = new std::string;
+  if (cursor.values_size() == 0) return *kEmpty;
+  return cursor.values(0).reference_value();
+}
+
+}  // namespace
+
+DataClient::DataClient(ConnectionOptions const& connection_options,
+                       Options options)
+    : background_(connection_options.background_threads_factory()()),
+      cq_(background_->cq()),
+      options_(std::move(options)) {
+  for (int i = 0; i != connection_options.num_channels(); ++i) {
+    stubs_.push_back(
+        firestore_internal::CreateDefaultFirestoreStub(connection_options, i));
+  }
+}
+
+DataClient::DataClient(std::shared_ptr<firestore_internal::FirestoreStub> stub,
+                       CompletionQueue cq, Options options)
+    : stubs_({std::move(stub)}),
+      cq_(std::move(cq)),
+      options_(std::move(options)) {}
+
+StatusOr<std::vector<v1::BatchGetDocumentsResponse>>
+DataClient::BatchGetDocuments(v1::BatchGetDocumentsRequest request) {
+  std::vector<std::string> names;
+  std::unordered_set<std::string> seen;
+  for (auto& n : *request.mutable_documents()) {
+    if (seen.insert(n).second) names.push_back(std::move(n));
+  }
+  request.clear_documents();
+
+  auto const chunk_size = (std::max)(options_.max_batch_get_size,
+                                     std::size_t{1});
+  std::vector<v1::BatchGetDocumentsRequest> chunks;
+  for (std::size_t i = 0; i < names.size(); i += chunk_size) {
+    auto chunk = request;
+    auto const end = (std::min)(names.size(), i + chunk_size);
+    for (auto j = i; j != end; ++j) chunk.add_documents(names[j]);
+    chunks.push_back(std::move(chunk));
+  }
+  std::vector<std::shared_ptr<firestore_internal::FirestoreStub>> stubs;
+  for (std::size_t i = 0; i != chunks.size(); ++i) stubs.push_back(NextStub());
+
+  using Results =
+      std::unordered_map<std::string, v1::BatchGetDocumentsResponse>;
+  std::vector<Results> results(chunks.size());
+  std::vector<std::string> transactions(chunks.size());
+  auto read_chunk = [&](std::size_t i) -> Status {
+    auto stub = stubs[i];
+    auto factory = [stub](v1::BatchGetDocumentsRequest const& r) {
+      return stub->BatchGetDocuments(
+          absl::make_unique<grpc::ClientContext>(), r);
+    };
+    auto updater = [](v1::BatchGetDocumentsResponse const& response,
+                      v1::BatchGetDocumentsRequest& r) {
+      // Resume from the documents not received yet, in the same transaction
+      // or snapshot.
+      if (!response.transaction().empty()) {
+        r.set_transaction(response.transaction());
+      } else if (r.consistency_selector_case() ==
+                     v1::BatchGetDocumentsRequest::
+                         CONSISTENCY_SELECTOR_NOT_SET &&
+                 response.has_read_time()) {
+        *r.mutable_read_time() = response.read_time();
+      }
+      auto const& name = ResultName(response);
+      if (name.empty()) return;
+      auto& docs = *r.mutable_documents();
+      auto loc = std::find(docs.begin(), docs.end(), name);
+      if (loc != docs.end()) docs.erase(loc);
+    };
+    auto stream = internal::MakeResumableStreamingReadRpc<
+        v1::BatchGetDocumentsResponse, v1::BatchGetDocumentsRequest>(
+        options_.retry_policy->clone(), options_.backoff_policy->clone(),
+        std::move(factory), std::move(updater), std::move(chunks[i]));
+    v1::BatchGetDocumentsResponse response;
+    for (;;) {
+      auto status = stream->ReadInto(response);
+      if (status) return *std::move(status);
+      if (!response.transaction().empty()) {
+        transactions[i] = response.transaction();
+      }
+      // Responses carrying only a transaction id have no name.
+      if (ResultName(response).empty()) continue;
+      auto name = ResultName(response);
+      results[i][std::move(name)] = std::move(response);
+      response.Clear();
+    }
+  };
+
+  // A `new_transaction` would start one transaction per chunk. Read the first
+  // chunk alone, and use its transaction for the others.
+  std::size_t first = 0;
+  if (request.has_new_transaction() && !chunks.empty()) {
+    auto status = read_chunk(0);
+    if (!status.ok()) return status;
+    first = 1;
+    for (auto i = first; i < chunks.size(); ++i) {
+      chunks[i].set_transaction(transactions[0]);
+    }
+  }
+  auto status = ParallelFor(
+      chunks.size() - first, options_.max_concurrent_streams,
+      [&](std::size_t i) { return read_chunk(first + i); });
+  if (!status.ok()) return status;
+
+  std::vector<v1::BatchGetDocumentsResponse> ordered;
+  ordered.reserve(names.size());
+  std::size_t chunk = 0;
+  for (std::size_t i = 0; i != names.size(); ++i) {
+    if (i != 0 && i % chunk_size == 0) ++chunk;
+    auto loc = results[chunk].find(names[i]);
+    if (loc == results[chunk].end()) {
+      return Status(StatusCode::kInternal,
+                    "BatchGetDocuments response is missing " + names[i]);
+    }
+    ordered.push_back(std::move(loc->second));
+  }
+  if (!ordered.empty() && !transactions.empty()) {
+    ordered.front().set_transaction(std::move(transactions.front()));
+  }
+  return ordered;
+}
+
+StatusOr<std::vector<v1::StructuredQuery>> DataClient::PartitionQuery(
+    std::string const& parent, v1::StructuredQuery query,
+    std::int64_t partition_count) {
+  if (query.order_by().empty()) {
+    auto& order = *query.add_order_by();
+    order.mutable_field()->set_field_path("__name__");
+    order.set_direction(v1::StructuredQuery::ASCENDING);
+  }
+  if (partition_count <= 1) return std::vector<v1::StructuredQuery>{query};
+
+  v1::PartitionQueryRequest request;
+  request.set_parent(parent);
+  *request.mutable_structured_query() = query;
+  // The service returns up to `partition_count` split points, which define
+  // one more partition than points.
+  request.set_partition_count(partition_count - 1);
+  std::vector<v1::Cursor> cursors;
+  auto stub = NextStub();
+  for (;;) {
+    auto response = internal::RetryLoop(
+        options_.retry_policy->clone(), options_.backoff_policy->clone(),
+        Idempotency::kIdempotent,
+        [&stub](grpc::ClientContext& context,
+                v1::PartitionQueryRequest const& r) {
+          return stub->PartitionQuery(context, r);
+        },
+        request, __func__);
+    if (!response) return std::move(response).status();
+    for (auto& c : *response->mutable_partitions()) {
+      cursors.push_back(std::move(c));
+    }
+    if (response->next_page_token().empty()) break;
+    request.set_page_token(std::move(*response->mutable_next_page_token()));
+  }
+  // The split points are not ordered across pages.
+  std::sort(cursors.begin(), cursors.end(),
+            [](v1::Cursor const& a, v1::Cursor const& b) {
+              return NameLess(CursorName(a), CursorName(b));
+            });
+
+  std::vector<v1::StructuredQuery> partitions;
+  partitions.reserve(cursors.size() + 1);
+  for (std::size_t i = 0; i <= cursors.size(); ++i) {
+    auto partition = query;
+    if (i != 0) {
+      *partition.mutable_start_at() = cursors[i - 1];
+      partition.mutable_start_at()->set_before(true);
+    }
+    if (i != cursors.size()) {
+      *partition.mutable_end_at() = cursors[i];
+      partition.mutable_end_at()->set_before(true);
+    }
+    partitions.push_back(std::move(partition));
+  }
+  return partitions;
+}
+
+StatusOr<std::vector<v1::Document>> DataClient::RunPartitionedQuery(
+    std::string const& parent, v1::StructuredQuery query,
+    std::int64_t partition_count) {
+  auto partitions = PartitionQuery(parent, std::move(query), partition_count);
+  if (!partitions) return std::move(partitions).status();
+
+  std::vector<std::shared_ptr<firestore_internal::FirestoreStub>> stubs;
+  for (std::size_t i = 0; i != partitions->size(); ++i) {
+    stubs.push_back(NextStub());
+  }
+  std::vector<std::vector<v1::Document>> results(partitions->size());
+  auto run_partition = [&](std::size_t i) -> Status {
+    auto stub = stubs[i];
+    auto factory = [stub](v1::RunQueryRequest const& r) {
+      return stub->RunQuery(absl::make_unique<grpc::ClientContext>(), r);
+    };
+    auto updater = [](v1::RunQueryResponse const& response,
+                      v1::RunQueryRequest& r) {
+      // Resume after the last document received, at the same snapshot. The
+      // partitions are ordered by name, so the name is a valid cursor.
+      if (r.consistency_selector_case() ==
+              v1::RunQueryRequest::CONSISTENCY_SELECTOR_NOT_SET &&
+          response.has_read_time()) {
+        *r.mutable_read_time() = response.read_time();
+      }
+      if (!response.has_document()) return;
+      auto& start = *r.mutable_structured_query()->mutable_start_at();
+      start.clear_values();
+      start.add_values()->set_reference_value(response.document().name());
+      start.set_before(false);
+    };
+    v1::RunQueryRequest request;
+    request.set_parent(parent);
+    *request.mutable_structured_query() = std::move((*partitions)[i]);
+    auto stream = internal::MakeResumableStreamingReadRpc<
+        v1::RunQueryResponse, v1::RunQueryRequest>(
+        options_.retry_policy->clone(), options_.backoff_policy->clone(),
+        std::move(factory), std::move(updater), std::move(request));
+    v1::RunQueryResponse response;
+    for (;;) {
+      auto status = stream->ReadInto(response);
+      if (status) return *std::move(status);
+      if (!response.has_document()) continue;
+      results[i].push_back(std::move(*response.mutable_document()));
+      response.clear_document();
+    }
+  };
+  auto status = ParallelFor(partitions->size(), options_.max_concurrent_streams,
+                            run_partition);
+  if (!status.ok()) return status;
+
+  std::vector<v1::Document> documents;
+  for (auto& r : results) {
+    std::move(r.begin(), r.end(), std::back_inserter(documents));
+  }
+  return documents;
+}
+
+std::unique_ptr<BulkWriter> DataClient::MakeBulkWriter(
+    std::string database, BulkWriter::Options options) {
+  return absl::make_unique<BulkWriter>(NextStub(), cq_, std::move(database),
+                                       std::move(options));
+}
+
+std::shared_ptr<firestore_internal::FirestoreStub> DataClient::NextStub() {
+  auto stub = stubs_[next_stub_];
+  next_stub_ = (next_stub_ + 1) % stubs_.size();
+  return stub;
+}
+
+}  // namespace firestore
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,180 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_DATA_CLIENT_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_DATA_CLIENT_H
+
+#include "google/cloud/firestore/bulk_writer.h"
+#include "google/cloud/firestore/connection_options.h"
+#include "google/cloud/firestore/internal/firestore_stub.h"
+#include "google/cloud/firestore/retry_policy.h"
+#include "google/cloud/background_threads.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/status_or.h"
+#include <google/firestore/v1/firestore.pb.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace firestore {
+/**
+ * Reads and writes large numbers of Cloud Firestore documents.
+ *
+ * This client wraps the Cloud Firestore RPCs designed for bulk operations:
+ *
+ * - `BatchGetDocuments()` splits large reads into chunks, and reads the chunks
+ *   using several streams in parallel. Interrupted streams are resumed, only
+ *   the documents not yet received are requested again.
+ * - `MakeBulkWriter()` creates a `BulkWriter`, which groups independent writes
+ *   into `BatchWrite` requests, with rate and concurrency limits.
+ * - `PartitionQuery()` splits a collection group query into partitions, and
+ *   `RunPartitionedQuery()` runs the partitions in parallel.
+ *
+ * The parallel reads block the calling thread, and use up to
+ * `Options::max_concurrent_streams` additional threads for the streams.
+ *
+ * @par Thread-safety
+ * Instances of this class created via copy-construction or copy-assignment
+ * share the underlying pool of connections. Access to these copies via
+ * multiple threads is guaranteed to work. Two threads operating on the same
+ * instance of this class is not guaranteed to work.
+ */
+class DataClient {
+ public:
+  /// Configure a `DataClient`.
+  struct Options {
+    Options() = default;
+
+    /// The maximum number of documents requested by each stream.
+    Options& SetMaxBatchGetSize(std::size_t v) {
+      max_batch_get_size = v;
+      return *this;
+    }
+
+    /// The maximum number of streams used by each call.
+    Options& SetMaxConcurrentStreams(std::size_t v) {
+      max_concurrent_streams = v;
+      return *this;
+    }
+
+    /// Control how RPCs are retried, and streams resumed.
+    Options& SetRetryPolicy(RetryPolicy const& v) {
+      retry_policy = v.clone();
+      return *this;
+    }
+
+    /// Control how long the client waits between retries.
+    Options& SetBackoffPolicy(BackoffPolicy const& v) {
+      backoff_policy = v.clone();
+      return *this;
+    }
+
+    std::size_t max_batch_get_size = 100;
+    std::size_t max_concurrent_streams = 8;
+    std::shared_ptr<RetryPolicy const> retry_policy =
+        LimitedTimeRetryPolicy(std::chrono::minutes(10)).clone();
+    std::shared_ptr<BackoffPolicy const> backoff_policy =
+        ExponentialBackoffPolicy(std::chrono::milliseconds(100),
+                                 std::chrono::seconds(60), 1.3)
+            .clone();
+  };
+
+  explicit DataClient(ConnectionOptions const& connection_options =
+                          ConnectionOptions(),
+                      Options options = Options());
+
+  /**
+   * Create a client using @p stub, the completion queue @p cq runs the
+   * asynchronous operations.
+   *
+   * Applications should use the other constructor, this one is used in tests.
+   */
+  DataClient(std::shared_ptr<firestore_internal::FirestoreStub> stub,
+             CompletionQueue cq, Options options = Options());
+
+  /**
+   * Read the documents named in @p request.
+   *
+   * The documents are requested in chunks of up to
+   * `Options::max_batch_get_size` names. All the other fields in @p request,
+   * such as the mask, the transaction, or the read time, are used for every
+   * chunk. Note that the chunks are read independently, set a read time or a
+   * transaction in @p request to get a consistent snapshot across chunks.
+   *
+   * @return one response for each distinct name in `request.documents()`, in
+   *     the order of their first appearance. Each response contains either
+   *     the document, or the name of a missing document. If the request
+   *     starts a new transaction, the first response contains its id. If any
+   *     chunk fails the function returns the error.
+   */
+  StatusOr<std::vector<google::firestore::v1::BatchGetDocumentsResponse>>
+  BatchGetDocuments(google::firestore::v1::BatchGetDocumentsRequest request);
+
+  /**
+   * Split @p query into up to @p partition_count queries.
+   *
+   * The partitions are disjoint, their union returns the same documents as
+   * @p query, and each can be executed in parallel. The query must be a
+   * collection group query, i.e., its `from` selector must set
+   * `all_descendants`. If the query does not set an order, it is ordered by
+   * document name, which is required by the service.
+   *
+   * @param parent the parent resource, in the
+   *     `projects/{project_id}/databases/{database_id}/documents` format.
+   * @param query the query to partition.
+   * @param partition_count the maximum number of partitions. The service may
+   *     return fewer partitions.
+   */
+  StatusOr<std::vector<google::firestore::v1::StructuredQuery>> PartitionQuery(
+      std::string const& parent, google::firestore::v1::StructuredQuery query,
+      std::int64_t partition_count);
+
+  /**
+   * Run @p query using up to @p partition_count parallel streams.
+   *
+   * Each partition is read by a different stream, interrupted streams resume
+   * after the last document received. The partitions are independent queries,
+   * a `limit` or `offset` in @p query applies to each partition.
+   *
+   * @return the documents returned by the query, in document name order.
+   */
+  StatusOr<std::vector<google::firestore::v1::Document>> RunPartitionedQuery(
+      std::string const& parent, google::firestore::v1::StructuredQuery query,
+      std::int64_t partition_count);
+
+  /// Create a `BulkWriter` for @p database using this client's connections.
+  std::unique_ptr<BulkWriter> MakeBulkWriter(
+      std::string database,
+      BulkWriter::Options options = BulkWriter::Options());
+
+ private:
+  std::shared_ptr<firestore_internal::FirestoreStub> NextStub();
+
+  std::shared_ptr<BackgroundThreads> background_;
+  std::vector<std::shared_ptr<firestore_internal::FirestoreStub>> stubs_;
+  CompletionQueue cq_;
+  Options options_;
+  std::size_t next_stub_ = 0;
+};
+
+}  // namespace firestore
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_DATA_CLIENT_H
@@ -0,0 +1,299 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/firestore/data_client.h"
+#include "google/cloud/firestore/testing/mock_firestore_stub.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/fake_completion_queue_impl.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace firestore {
+namespace {
+
+namespace v1 = ::google::firestore::v1;
+
+using ::google::cloud::firestore_testing::MockFirestoreStub;
+using ::google::cloud::firestore_testing::MockStreamingReadRpc;
+using ::google::cloud::testing_util::FakeCompletionQueueImpl;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Return;
+
+auto constexpr kParent = "projects/p/databases/d/documents";
+
+std::string DocName(std::string const& id) {
+  return std::string(kParent) + "/c/" + id;
+}
+
+// Returns a stream that yields @p responses and then @p last.
+template <typename Response>
+std::unique_ptr<internal::StreamingReadRpc<Response>> MakeStream(
+    std::vector<Response> const& responses, Status const& last = Status{}) {
+  using ReadResult = absl::variant<Status, Response>;
+  auto stream = absl::make_unique<MockStreamingReadRpc<Response>>();
+  ::testing::InSequence sequence;
+  for (auto const& r : responses) {
+    EXPECT_CALL(*stream, Read).WillOnce(Return(ReadResult(r)));
+  }
+  EXPECT_CALL(*stream, Read).WillOnce(Return(ReadResult(last)));
+  return std::move(stream);
+}
+
+v1::BatchGetDocumentsResponse Found(std::string const& id) {
+  v1::BatchGetDocumentsResponse response;
+  response.mutable_found()->set_name(DocName(id));
+  response.mutable_read_time()->set_seconds(42);
+  return response;
+}
+
+v1::BatchGetDocumentsResponse Missing(std::string const& id) {
+  v1::BatchGetDocumentsResponse response;
+  response.set_missing(DocName(id));
+  response.mutable_read_time()->set_seconds(42);
+  return response;
+}
+
+std::vector<std::string> Ids(v1::BatchGetDocumentsRequest const& request) {
+  std::vector<std::string> ids;
+  for (auto const& d : request.documents()) {
+    ids.push_back(d.substr(d.rfind('/') + 1));
+  }
+  return ids;
+}
+
+v1::Cursor MakeCursor(std::string const& id) {
+  v1::Cursor cursor;
+  cursor.add_values()->set_reference_value(DocName(id));
+  return cursor;
+}
+
+class DataClientTest : public ::testing::Test {
+ protected:
+  DataClient MakeClient(
+      DataClient::Options options = DataClient::Options()) {
+    // Run the streams in sequence, and retry without delays.
+    options.SetMaxConcurrentStreams(1).SetBackoffPolicy(
+        ExponentialBackoffPolicy(std::chrono::microseconds(1),
+                                 std::chrono::microseconds(1), 2.0));
+    return DataClient(mock_, CompletionQueue(cq_impl_), std::move(options));
+  }
+
+  std::shared_ptr<MockFirestoreStub> mock_ =
+      std::make_shared<MockFirestoreStub>();
+  std::shared_ptr<FakeCompletionQueueImpl> cq_impl_ =
+      std::make_shared<FakeCompletionQueueImpl>();
+};
+
+TEST_F(DataClientTest, BatchGetDocumentsInChunks) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_, BatchGetDocuments(_, _))
+      .WillOnce([](std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchGetDocumentsRequest const& request) {
+        EXPECT_EQ("projects/p/databases/d", request.database());
+        EXPECT_THAT(Ids(request), ElementsAre("a", "b"));
+        // The service returns the documents in any order.
+        return MakeStream<v1::BatchGetDocumentsResponse>(
+            {Missing("b"), Found("a")});
+      });
+  EXPECT_CALL(*mock_, BatchGetDocuments(_, _))
+      .WillOnce([](std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchGetDocumentsRequest const& request) {
+        EXPECT_THAT(Ids(request), ElementsAre("c"));
+        return MakeStream<v1::BatchGetDocumentsResponse>({Found("c")});
+      });
+
+  auto client = MakeClient(DataClient::Options().SetMaxBatchGetSize(2));
+  v1::BatchGetDocumentsRequest request;
+  request.set_database("projects/p/databases/d");
+  for (auto const* id : {"a", "b", "a", "c"}) {
+    request.add_documents(DocName(id));
+  }
+  auto response = client.BatchGetDocuments(request);
+  ASSERT_STATUS_OK(response);
+  ASSERT_EQ(3, response->size());
+  EXPECT_EQ(DocName("a"), (*response)[0].found().name());
+  EXPECT_EQ(DocName("b"), (*response)[1].missing());
+  EXPECT_EQ(DocName("c"), (*response)[2].found().name());
+}
+
+TEST_F(DataClientTest, BatchGetDocumentsResumes) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_, BatchGetDocuments(_, _))
+      .WillOnce([](std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchGetDocumentsRequest const& request) {
+        EXPECT_THAT(Ids(request), ElementsAre("a", "b"));
+        EXPECT_FALSE(request.has_read_time());
+        return MakeStream<v1::BatchGetDocumentsResponse>(
+            {Found("a")}, Status(StatusCode::kUnavailable, "try-again"));
+      });
+  EXPECT_CALL(*mock_, BatchGetDocuments(_, _))
+      .WillOnce([](std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchGetDocumentsRequest const& request) {
+        // Only the missing documents are requested, at the same snapshot.
+        EXPECT_THAT(Ids(request), ElementsAre("b"));
+        EXPECT_EQ(42, request.read_time().seconds());
+        return MakeStream<v1::BatchGetDocumentsResponse>({Found("b")});
+      });
+
+  auto client = MakeClient();
+  v1::BatchGetDocumentsRequest request;
+  request.add_documents(DocName("a"));
+  request.add_documents(DocName("b"));
+  auto response = client.BatchGetDocuments(request);
+  ASSERT_STATUS_OK(response);
+  ASSERT_EQ(2, response->size());
+  EXPECT_EQ(DocName("a"), (*response)[0].found().name());
+  EXPECT_EQ(DocName("b"), (*response)[1].found().name());
+}
+
+TEST_F(DataClientTest, BatchGetDocumentsError) {
+  EXPECT_CALL(*mock_, BatchGetDocuments(_, _))
+      .WillOnce([](std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchGetDocumentsRequest const&) {
+        return MakeStream<v1::BatchGetDocumentsResponse>(
+            {}, Status(StatusCode::kPermissionDenied, "uh-oh"));
+      });
+
+  auto client = MakeClient();
+  v1::BatchGetDocumentsRequest request;
+  request.add_documents(DocName("a"));
+  EXPECT_THAT(client.BatchGetDocuments(request),
+              StatusIs(StatusCode::kPermissionDenied));
+}
+
+TEST_F(DataClientTest, PartitionQuery) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_, PartitionQuery(_, _))
+      .WillOnce([](grpc::ClientContext&,
+                   v1::PartitionQueryRequest const& request) {
+        EXPECT_EQ(kParent, request.parent());
+        EXPECT_EQ(2, request.partition_count());
+        auto const& order = request.structured_query().order_by();
+        EXPECT_EQ(1, order.size());
+        EXPECT_EQ("__name__", order.Get(0).field().field_path());
+        v1::PartitionQueryResponse response;
+        *response.add_partitions() = MakeCursor("m");
+        response.set_next_page_token("p2");
+        return make_status_or(response);
+      });
+  EXPECT_CALL(*mock_, PartitionQuery(_, _))
+      .WillOnce([](grpc::ClientContext&,
+                   v1::PartitionQueryRequest const& request) {
+        EXPECT_EQ("p2", request.page_token());
+        v1::PartitionQueryResponse response;
+        // Split points are not ordered across pages.
+        *response.add_partitions() = MakeCursor("f");
+        return make_status_or(response);
+      });
+
+  auto client = MakeClient();
+  v1::StructuredQuery query;
+  query.add_from()->set_all_descendants(true);
+  auto partitions = client.PartitionQuery(kParent, query, 3);
+  ASSERT_STATUS_OK(partitions);
+  ASSERT_EQ(3, partitions->size());
+  auto const& p = *partitions;
+  EXPECT_FALSE(p[0].has_start_at());
+  EXPECT_EQ(DocName("f"), p[0].end_at().values(0).reference_value());
+  EXPECT_EQ(DocName("f"), p[1].start_at().values(0).reference_value());
+  EXPECT_TRUE(p[1].start_at().before());
+  EXPECT_EQ(DocName("m"), p[1].end_at().values(0).reference_value());
+  EXPECT_EQ(DocName("m"), p[2].start_at().values(0).reference_value());
+  EXPECT_FALSE(p[2].has_end_at());
+}
+
+TEST_F(DataClientTest, RunPartitionedQuery) {
+  EXPECT_CALL(*mock_, PartitionQuery(_, _))
+      .WillOnce([](grpc::ClientContext&, v1::PartitionQueryRequest const&) {
+        v1::PartitionQueryResponse response;
+        *response.add_partitions() = MakeCursor("m");
+        return make_status_or(response);
+      });
+  auto make_response = [](std::string const& id) {
+    v1::RunQueryResponse response;
+    response.mutable_document()->set_name(DocName(id));
+    response.mutable_read_time()->set_seconds(42);
+    return response;
+  };
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_, RunQuery(_, _))
+      .WillOnce([&](std::unique_ptr<grpc::ClientContext>,
+                    v1::RunQueryRequest const& request) {
+        EXPECT_FALSE(request.structured_query().has_start_at());
+        return MakeStream<v1::RunQueryResponse>(
+            {make_response("a"), make_response("b")});
+      });
+  EXPECT_CALL(*mock_, RunQuery(_, _))
+      .WillOnce([&](std::unique_ptr<grpc::ClientContext>,
+                    v1::RunQueryRequest const& request) {
+        EXPECT_EQ(DocName("m"), request.structured_query()
+                                    .start_at()
+                                    .values(0)
+                                    .reference_value());
+        return MakeStream<v1::RunQueryResponse>(
+            {make_response("m")},
+            Status(StatusCode::kUnavailable, "try-again"));
+      });
+  EXPECT_CALL(*mock_, RunQuery(_, _))
+      .WillOnce([&](std::unique_ptr<grpc::ClientContext>,
+                    v1::RunQueryRequest const& request) {
+        // Resume after the last document received, at the same snapshot.
+        auto const& start = request.structured_query().start_at();
+        EXPECT_EQ(DocName("m"), start.values(0).reference_value());
+        EXPECT_FALSE(start.before());
+        EXPECT_EQ(42, request.read_time().seconds());
+        return MakeStream<v1::RunQueryResponse>({make_response("x")});
+      });
+
+  auto client = MakeClient();
+  v1::StructuredQuery query;
+  query.add_from()->set_all_descendants(true);
+  auto documents = client.RunPartitionedQuery(kParent, query, 2);
+  ASSERT_STATUS_OK(documents);
+  std::vector<std::string> names;
+  for (auto const& d : *documents) names.push_back(d.name());
+  EXPECT_THAT(names, ElementsAre(DocName("a"), DocName("b"), DocName("m"),
+                                 DocName("x")));
+}
+
+TEST_F(DataClientTest, MakeBulkWriter) {
+  EXPECT_CALL(*mock_, AsyncBatchWrite(_, _, _))
+      .WillOnce([](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                   v1::BatchWriteRequest const& request) {
+        EXPECT_EQ("projects/p/databases/d", request.database());
+        v1::BatchWriteResponse response;
+        response.add_write_results();
+        return make_ready_future(make_status_or(response));
+      });
+
+  auto client = MakeClient();
+  auto writer = client.MakeBulkWriter("projects/p/databases/d");
+  v1::Write write;
+  write.set_delete_(DocName("a"));
+  auto f = writer->Write(std::move(write));
+  writer.reset();
+  ASSERT_STATUS_OK(f.get());
+}
+
+}  // namespace
+}  // namespace firestore
+}  // namespace cloud
+}  // namespace google
@@ -15,47 +15,71 @@
 #include "google/cloud/firestore/field_path.h"
 #include <algorithm>
 #include <cctype>
+#include <mutex>
+#include <unordered_map>
 
 namespace google {
 namespace cloud {
 namespace firestore {
 
-FieldPath::FieldPath(std::vector<std::string> parts)
-    : parts_(std::move(parts)) {
-  this->valid_ = std::all_of(parts_.begin(), parts_.end(),
-                             [](std::string const& p) { return !p.empty(); });
+namespace {
+// Bound the memory used by the `FromString()` cache. Applications build paths
+// from a small set of field names, once full the cache stops growing.
+std::size_t constexpr kMaxCachedPaths = 4096;
+}  // namespace
+
+FieldPath::FieldPath(std::vector<std::string> parts) {
+  auto rep = std::make_shared<Rep>();
+  rep->valid = std::all_of(parts.begin(), parts.end(),
+                           [](std::string const& p) { return !p.empty(); });
+  // let the server catch the empty string error for invalid paths
+  if (rep->valid) rep->api_repr = MakeApiRepr(parts);
+  rep->hash = std::hash<std::string>{}(rep->api_repr);
+  rep->parts = std::move(parts);
+  rep_ = std::move(rep);
 }
 
 FieldPath FieldPath::InvalidFieldPath() {
-  std::vector<std::string> parts = {""};
-  return FieldPath(parts);
+  static auto const* const kInvalid =
+      new FieldPath(std::vector<std::string>{""});
+  return *kInvalid;
 }
 
 FieldPath FieldPath::FromString(std::string const& string) {
-  if (InvalidCharacters(string)) {
-    return FieldPath::InvalidFieldPath();
+  using Cache = std::unordered_map<std::string, std::shared_ptr<Rep const>>;
+  static auto* const mu = new std::mutex;
+  static auto* const cache = new Cache;
+  {
+    std::lock_guard<std::mutex> lk(*mu);
+    auto loc = cache->find(string);
+    if (loc != cache->end()) return FieldPath(loc->second);
   }
-  return FieldPath(Split(string));
+  // Parse without holding the lock, another thread may insert the same path
+  // first, which is harmless.
+  auto path = InvalidCharacters(string) ? FieldPath::InvalidFieldPath()
+                                        : FieldPath(Split(string));
+  std::lock_guard<std::mutex> lk(*mu);
+  if (cache->size() < kMaxCachedPaths) cache->emplace(string, path.rep_);
+  return path;
 }
 
 FieldPath FieldPath::Append(std::string const& string) const {
-  std::vector<std::string> parts(this->parts_);
-  auto const field_path = FieldPath::FromString(string);
-  return this->Append(field_path);
+  return this->Append(FieldPath::FromString(string));
 }
 
 FieldPath FieldPath::Append(FieldPath const& field_path) const {
-  if (valid_ && field_path.valid_) {
-    std::vector<std::string> parts(this->parts_);
-    for (auto const& part : field_path.parts_) {
-      parts.push_back(part);
-    }
-    return FieldPath(parts);
+  if (valid() && field_path.valid()) {
+    std::vector<std::string> parts;
+    parts.reserve(size() + field_path.size());
+    parts.insert(parts.end(), rep_->parts.begin(), rep_->parts.end());
+    parts.insert(parts.end(), field_path.rep_->parts.begin(),
+                 field_path.rep_->parts.end());
+    return FieldPath(std::move(parts));
   }
   return FieldPath::InvalidFieldPath();
 }
 
-std::string FieldPath::ToApiRepr() const {
+std::string FieldPath::MakeApiRepr(std::vector<std::string> const& parts) {
   // gcc-4.8 ships with a broken regex library (sigh), so don't use it.
   auto is_simple_field_name = [](std::string const& part) {
     if (part.empty()) {
@@ -68,45 +92,33 @@ std::string FieldPath::ToApiRepr() const {
                        [](char c) { return c == '_' || std::isalnum(c) != 0; });
   };
   std::string s;
-  if (valid_) {
-    for (auto part : parts_) {
-      auto const match = is_simple_field_name(part);
-      if (match) {
-        s += part + '.';
-      } else {
-        ReplaceAll(part, "\\", "\\\\");
-        ReplaceAll(part, "`", "\\`");
-        s += '`' + part + "`.";
-      }
+  for (auto const& part : parts) {
+    if (is_simple_field_name(part)) {
+      s += part;
+      s += '.';
+    } else {
+      auto escaped = part;
+      ReplaceAll(escaped, "\\", "\\\\");
+      ReplaceAll(escaped, "`", "\\`");
+      s += '`';
+      s += escaped;
+      s += "`.";
     }
-    s.resize(s.size() - 1);  // cannot be empty and remove final period
   }
-  return s;  // let the server catch the empty string error for invalid
+  s.resize(s.size() - 1);  // cannot be empty and remove final period
+  return s;
 }
 
 bool operator==(FieldPath const& lhs, FieldPath const& rhs) {
-  return lhs.ToApiRepr() == rhs.ToApiRepr();
+  if (lhs.rep_ == rhs.rep_) return true;
+  return lhs.rep_->hash == rhs.rep_->hash &&
+         lhs.rep_->api_repr == rhs.rep_->api_repr;
 }
 
 bool operator<(FieldPath const& lhs, FieldPath const& rhs) {
-  auto const lhs_size = lhs.parts_.size();
-  auto const rhs_size = rhs.parts_.size();
-  auto const min_length = (std::min)(lhs_size, rhs_size);
-  for (auto i = 0U; i != min_length; i++) {
-    if (lhs.parts_[i] < rhs.parts_[i]) {
-      return true;
-    }
-    if (lhs.parts_[i] > rhs.parts_[i]) {
-      return false;
-    }
-  }
-  if (lhs_size < rhs_size) {
-    return true;
-  }
-  if (lhs_size > rhs_size) {
-    return false;
-  }
-  return false;
+  auto const& l = lhs.rep_->parts;
+  auto const& r = rhs.rep_->parts;
+  return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
 }
 
 std::ostream& operator<<(std::ostream& os, FieldPath const& field_path) {
@@ -118,15 +130,16 @@ bool FieldPath::InvalidCharacters(std::string const& string) {
   return string.find_first_of("~*/[]") != std::string::npos;
 }
 
-std::vector<std::string> FieldPath::Split(std::string string) {
+std::vector<std::string> FieldPath::Split(std::string const& string) {
   std::vector<std::string> parts;
+  std::string::size_type start = 0;
   auto index = string.find('.');
   while (index != std::string::npos) {
-    parts.push_back(string.substr(0, index));
-    string = string.substr(index + 1);
-    index = string.find('.');
+    parts.emplace_back(string, start, index - start);
+    start = index + 1;
+    index = string.find('.', start);
   }
-  parts.push_back(string);
+  parts.emplace_back(string, start);
   return parts;
 }
 
@@ -15,7 +15,10 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_FIELD_PATH_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_FIELD_PATH_H
 
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <regex>
 #include <string>
 #include <utility>
@@ -28,6 +31,12 @@ namespace firestore {
  * A FieldPath refers to a field in a document. The path may consist of
  * a single field name (referring to a top level field in the document),
  * or a list of field names (referring to a nested field in the document).
+ *
+ * FieldPath objects are immutable, copies share the parsed components, and
+ * the API representation and hash are computed once, on construction. This
+ * makes them cheap to copy, compare, and use as keys in hash maps.
+ * `FromString()` caches the paths it parses, building the same path again
+ * does not split or validate the string.
  */
 class FieldPath {
  public:
@@ -75,21 +84,50 @@ class FieldPath {
    * Convert the FieldPath into a unique representation for the server.
    * @return The unique server API representation.
    */
-  std::string ToApiRepr() const;
+  std::string const& ToApiRepr() const { return rep_->api_repr; }
 
   /**
    * Return the number of components for this FieldPath.
    * @return The number of components for this FieldPath.
    */
-  std::size_t size() const { return parts_.size(); }
+  std::size_t size() const { return rep_->parts.size(); }
 
   /**
    * Returns whether this FieldPath is valid or not.
    * @return Whether this FieldPath is valid or not.
    */
-  bool valid() const { return valid_; }
+  bool valid() const { return rep_->valid; }
+
+  /**
+   * Return a hash of this FieldPath, consistent with `operator==`.
+   * @return The hash of the API representation.
+   */
+  std::size_t hash() const { return rep_->hash; }
 
  private:
+  /**
+   * The immutable state of a FieldPath, shared by all its copies.
+   */
+  struct Rep {
+    std::vector<std::string> parts;
+    std::string api_repr;
+    std::size_t hash;
+    bool valid;
+  };
+
+  explicit FieldPath(std::shared_ptr<Rep const> rep) : rep_(std::move(rep)) {}
+
+  /**
+   * Compute the API representation of @p parts.
+   *
+   * @param parts The valid components of a field path.
+   * @return The unique server API representation.
+   */
+  static std::string MakeApiRepr(std::vector<std::string> const& parts);
+
+  // This is a friend because it accesses rep_ directly.
+  friend bool operator==(FieldPath const& lhs, FieldPath const& rhs);
+
   /**
    * The representation of this FieldPath @p field_path for ostream @p os.
    *
@@ -114,10 +152,10 @@ class FieldPath {
   /**
    * Splits @p string via field path delimiter '.'.
    *
-   * @param string A const string to write to.
+   * @param string A const string to split.
    * @return The vector of string after splitting via delimiter
    */
-  static std::vector<std::string> Split(std::string string);
+  static std::vector<std::string> Split(std::string const& string);
 
   /**
    * Replace all occurrences of @p find in @p string with @p replace.
@@ -130,14 +168,9 @@ class FieldPath {
                          std::string const& replace);
 
   /**
-   * The components of this FieldPath.
+   * The components, API representation, and hash of this FieldPath.
    */
-  std::vector<std::string> parts_;
-
-  /**
-   * Whether this FieldPath is valid or not.
-   */
-  bool valid_;
+  std::shared_ptr<Rep const> rep_;
 };
 
 bool operator==(FieldPath const& lhs, FieldPath const& rhs);
@@ -163,4 +196,15 @@ inline bool operator>=(FieldPath const& lhs, FieldPath const& rhs) {
 }  // namespace cloud
 }  // namespace google
 
+namespace std {
+/// Hash FieldPath objects, e.g., to use them as keys in `std::unordered_map`.
+template <>
+struct hash<google::cloud::firestore::FieldPath> {
+  std::size_t operator()(
+      google::cloud::firestore::FieldPath const& field_path) const {
+    return field_path.hash();
+  }
+};
+}  // namespace std
+
 #endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_FIELD_PATH_H
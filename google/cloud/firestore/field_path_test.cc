@@ -14,6 +14,9 @@
 
 #include "google/cloud/firestore/field_path.h"
 #include <gtest/gtest.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace firestore = google::cloud::firestore;
 
@@ -209,3 +212,37 @@ TEST(FieldPath, Size) {
   ASSERT_TRUE(field_path.valid());
   EXPECT_EQ(3, field_path.size());
 }
+
+TEST(FieldPath, FromStringIsCached) {
+  auto const a = firestore::FieldPath::FromString("cached.path");
+  auto const b = firestore::FieldPath::FromString("cached.path");
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a.hash(), b.hash());
+  // Both paths share the same representation.
+  EXPECT_EQ(&a.ToApiRepr(), &b.ToApiRepr());
+}
+
+TEST(FieldPath, HashConsistentWithEquality) {
+  std::vector<std::string> const parts = {"a", "b.c"};
+  auto const from_parts = firestore::FieldPath(parts);
+  auto const from_string = firestore::FieldPath::FromString("a.`b.c`");
+  auto const appended = firestore::FieldPath({"a"}).Append(
+      firestore::FieldPath(std::vector<std::string>{"b.c"}));
+  EXPECT_EQ(from_parts, appended);
+  EXPECT_EQ(from_parts.hash(), appended.hash());
+  EXPECT_NE(from_parts, from_string);
+  EXPECT_EQ(firestore::FieldPath::InvalidFieldPath(),
+            firestore::FieldPath::FromString("a..b"));
+  EXPECT_EQ(firestore::FieldPath::InvalidFieldPath().hash(),
+            firestore::FieldPath::FromString("a..b").hash());
+}
+
+TEST(FieldPath, UnorderedMapKey) {
+  std::unordered_map<firestore::FieldPath, int> map;
+  map[firestore::FieldPath::FromString("a.b")] = 1;
+  map[firestore::FieldPath::FromString("a.c")] = 2;
+  map[firestore::FieldPath(std::vector<std::string>{"a", "b"})] += 10;
+  EXPECT_EQ(2, map.size());
+  EXPECT_EQ(11, map[firestore::FieldPath::FromString("a.b")]);
+  EXPECT_EQ(2, map[firestore::FieldPath::FromString("a.c")]);
+}
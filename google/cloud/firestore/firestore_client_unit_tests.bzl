@@ -17,5 +17,8 @@
 """Automatically generated unit tests list - DO NOT EDIT."""
 
 firestore_client_unit_tests = [
+    "bulk_writer_test.cc",
+    "data_client_test.cc",
     "field_path_test.cc",
+    "internal/rate_limiter_test.cc",
 ]
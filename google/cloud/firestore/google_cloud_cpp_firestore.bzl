@@ -17,9 +17,20 @@
 """Automatically generated source lists for google_cloud_cpp_firestore - DO NOT EDIT."""
 
 google_cloud_cpp_firestore_hdrs = [
+    "bulk_writer.h",
+    "connection_options.h",
+    "data_client.h",
     "field_path.h",
+    "internal/firestore_stub.h",
+    "internal/rate_limiter.h",
+    "retry_policy.h",
 ]
 
 google_cloud_cpp_firestore_srcs = [
+    "bulk_writer.cc",
+    "connection_options.cc",
+    "data_client.cc",
     "field_path.cc",
+    "internal/firestore_stub.cc",
+    "internal/rate_limiter.cc",
 ]
@@ -0,0 +1,92 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/firestore/internal/firestore_stub.h"
+#include "google/cloud/grpc_error_delegate.h"
+#include "google/cloud/internal/channel_cache.h"
+#include "absl/memory/memory.h"
+
+namespace google {
+namespace cloud {
+namespace firestore_internal {
+
+namespace v1 = ::google::firestore::v1;
+
+class DefaultFirestoreStub : public FirestoreStub {
+ public:
+  explicit DefaultFirestoreStub(
+      std::unique_ptr<v1::Firestore::StubInterface> grpc_stub)
+      : grpc_stub_(std::move(grpc_stub)) {}
+
+  ~DefaultFirestoreStub() override = default;
+
+  std::unique_ptr<internal::StreamingReadRpc<v1::BatchGetDocumentsResponse>>
+  BatchGetDocuments(std::unique_ptr<grpc::ClientContext> context,
+                    v1::BatchGetDocumentsRequest const& request) override {
+    auto stream = grpc_stub_->BatchGetDocuments(context.get(), request);
+    return absl::make_unique<
+        internal::StreamingReadRpcImpl<v1::BatchGetDocumentsResponse>>(
+        std::move(context), std::move(stream));
+  }
+
+  future<StatusOr<v1::BatchWriteResponse>> AsyncBatchWrite(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      v1::BatchWriteRequest const& request) override {
+    return cq.MakeUnaryRpc(
+        [this](grpc::ClientContext* context,
+               v1::BatchWriteRequest const& request,
+               grpc::CompletionQueue* cq) {
+          return grpc_stub_->AsyncBatchWrite(context, request, cq);
+        },
+        request, std::move(context));
+  }
+
+  StatusOr<v1::PartitionQueryResponse> PartitionQuery(
+      grpc::ClientContext& context,
+      v1::PartitionQueryRequest const& request) override {
+    v1::PartitionQueryResponse response;
+    auto status = grpc_stub_->PartitionQuery(&context, request, &response);
+    if (!status.ok()) return google::cloud::MakeStatusFromRpcError(status);
+    return response;
+  }
+
+  std::unique_ptr<internal::StreamingReadRpc<v1::RunQueryResponse>> RunQuery(
+      std::unique_ptr<grpc::ClientContext> context,
+      v1::RunQueryRequest const& request) override {
+    auto stream = grpc_stub_->RunQuery(context.get(), request);
+    return absl::make_unique<
+        internal::StreamingReadRpcImpl<v1::RunQueryResponse>>(
+        std::move(context), std::move(stream));
+  }
+
+ private:
+  std::unique_ptr<v1::Firestore::StubInterface> grpc_stub_;
+};
+
+std::shared_ptr<FirestoreStub> CreateDefaultFirestoreStub(
+    firestore::ConnectionOptions options, int channel_id) {
+  auto channel_arguments = options.CreateChannelArguments();
+  // Newer versions of gRPC include a macro (`GRPC_ARG_CHANNEL_ID`) but use
+  // its value here to allow compiling against older versions.
+  channel_arguments.SetInt("grpc.channel_id", channel_id);
+  return std::make_shared<DefaultFirestoreStub>(
+      v1::Firestore::NewStub(google::cloud::internal::CreateCustomChannel(
+          options.endpoint(), options.credentials(), channel_arguments,
+          options.channel_cache_enabled())));
+}
+
+}  // namespace firestore_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,83 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_INTERNAL_FIRESTORE_STUB_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_INTERNAL_FIRESTORE_STUB_H
+
+#include "google/cloud/firestore/connection_options.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
+#include "google/cloud/internal/streaming_read_rpc.h"
+#include "google/cloud/status_or.h"
+#include <google/firestore/v1/firestore.grpc.pb.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace firestore_internal {
+
+/**
+ * Define the interface for the gRPC wrapper.
+ *
+ * We wrap the gRPC-generated `FirestoreStub` to:
+ *   - Return a StatusOr<T> instead of using a `grpc::Status` and an "output
+ *     parameter" for the response.
+ *   - To be able to mock the stubs.
+ *   - To be able to decompose some functionality (logging, adding metadata
+ *     information) into layers.
+ */
+class FirestoreStub {
+ public:
+  virtual ~FirestoreStub() = default;
+
+  /// Stream the documents named in @p request.
+  virtual std::unique_ptr<
+      internal::StreamingReadRpc<google::firestore::v1::BatchGetDocumentsResponse>>
+  BatchGetDocuments(
+      std::unique_ptr<grpc::ClientContext> context,
+      google::firestore::v1::BatchGetDocumentsRequest const& request) = 0;
+
+  /// Apply a batch of independent writes.
+  virtual future<StatusOr<google::firestore::v1::BatchWriteResponse>>
+  AsyncBatchWrite(google::cloud::CompletionQueue& cq,
+                  std::unique_ptr<grpc::ClientContext> context,
+                  google::firestore::v1::BatchWriteRequest const& request) = 0;
+
+  /// Compute the cursors that split a query into partitions.
+  virtual StatusOr<google::firestore::v1::PartitionQueryResponse>
+  PartitionQuery(
+      grpc::ClientContext& context,
+      google::firestore::v1::PartitionQueryRequest const& request) = 0;
+
+  /// Stream the results of a query.
+  virtual std::unique_ptr<
+      internal::StreamingReadRpc<google::firestore::v1::RunQueryResponse>>
+  RunQuery(std::unique_ptr<grpc::ClientContext> context,
+           google::firestore::v1::RunQueryRequest const& request) = 0;
+};
+
+/**
+ * Creates a FirestoreStub configured with @p options and @p channel_id.
+ *
+ * @p channel_id should be unique among all stubs in the same pool, to ensure
+ * they use different underlying connections.
+ */
+std::shared_ptr<FirestoreStub> CreateDefaultFirestoreStub(
+    firestore::ConnectionOptions options, int channel_id);
+
+}  // namespace firestore_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_INTERNAL_FIRESTORE_STUB_H
@@ -0,0 +1,70 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/firestore/internal/rate_limiter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace google {
+namespace cloud {
+namespace firestore_internal {
+
+RampUpRateLimiter::RampUpRateLimiter(double initial_rate, double max_rate,
+                                     double multiplier,
+                                     Clock::duration ramp_up_period,
+                                     Clock::time_point start)
+    : initial_rate_(initial_rate),
+      max_rate_((std::max)(initial_rate, max_rate)),
+      multiplier_(multiplier),
+      ramp_up_period_(ramp_up_period),
+      start_(start),
+      last_refill_(start),
+      tokens_(initial_rate) {}
+
+RampUpRateLimiter::Clock::duration RampUpRateLimiter::Acquire(
+    std::size_t n, Clock::time_point now) {
+  Refill(now);
+  auto const r = rate(now);
+  auto const needed = (std::min)(static_cast<double>(n), r);
+  if (tokens_ >= needed) {
+    tokens_ -= static_cast<double>(n);
+    return Clock::duration(0);
+  }
+  auto const wait = std::chrono::duration<double>((needed - tokens_) / r);
+  return (std::max)(Clock::duration(1),
+                    std::chrono::duration_cast<Clock::duration>(wait));
+}
+
+double RampUpRateLimiter::rate(Clock::time_point now) const {
+  if (now <= start_ || ramp_up_period_ <= Clock::duration(0) ||
+      multiplier_ <= 1.0) {
+    return initial_rate_;
+  }
+  auto const periods = (now - start_) / ramp_up_period_;
+  auto const r =
+      initial_rate_ * std::pow(multiplier_, static_cast<double>(periods));
+  return (std::min)(r, max_rate_);
+}
+
+void RampUpRateLimiter::Refill(Clock::time_point now) {
+  if (now <= last_refill_) return;
+  auto const elapsed = std::chrono::duration<double>(now - last_refill_);
+  auto const r = rate(now);
+  tokens_ = (std::min)(r, tokens_ + elapsed.count() * r);
+  last_refill_ = now;
+}
+
+}  // namespace firestore_internal
+}  // namespace cloud
+}  // namespace google
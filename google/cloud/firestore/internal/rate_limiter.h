@@ -0,0 +1,74 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_INTERNAL_RATE_LIMITER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_INTERNAL_RATE_LIMITER_H
+
+#include <chrono>
+#include <cstddef>
+
+namespace google {
+namespace cloud {
+namespace firestore_internal {
+
+/**
+ * A token bucket whose rate increases over time.
+ *
+ * Cloud Firestore recommends that bulk writes ramp up their traffic gradually,
+ * the "500/50/5" rule: start with at most 500 operations per second, and
+ * increase the rate by 50% every 5 minutes. This class computes the allowed
+ * rate at any point in time, and implements a token bucket with that rate.
+ * The bucket holds at most one second worth of tokens.
+ *
+ * @note this class is thread compatible, the callers must serialize access to
+ *     each instance.
+ */
+class RampUpRateLimiter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  RampUpRateLimiter(double initial_rate, double max_rate, double multiplier,
+                    Clock::duration ramp_up_period, Clock::time_point start);
+
+  /**
+   * Take @p n tokens from the bucket.
+   *
+   * Requests larger than the bucket capacity are granted once the bucket is
+   * full, they borrow tokens from future periods.
+   *
+   * @return zero if the tokens were taken, otherwise how long until they are
+   *     available. No tokens are taken in that case.
+   */
+  Clock::duration Acquire(std::size_t n, Clock::time_point now);
+
+  /// The allowed rate, in operations per second, at @p now.
+  double rate(Clock::time_point now) const;
+
+ private:
+  void Refill(Clock::time_point now);
+
+  double const initial_rate_;
+  double const max_rate_;
+  double const multiplier_;
+  Clock::duration const ramp_up_period_;
+  Clock::time_point const start_;
+  Clock::time_point last_refill_;
+  double tokens_;
+};
+
+}  // namespace firestore_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_INTERNAL_RATE_LIMITER_H
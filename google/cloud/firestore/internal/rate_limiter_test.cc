@@ -0,0 +1,81 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/firestore/internal/rate_limiter.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace firestore_internal {
+namespace {
+
+using Clock = RampUpRateLimiter::Clock;
+using std::chrono::milliseconds;
+using std::chrono::minutes;
+using std::chrono::seconds;
+
+TEST(RampUpRateLimiter, RampUp) {
+  auto const start = Clock::now();
+  RampUpRateLimiter tested(500, 10000, 1.5, minutes(5), start);
+  EXPECT_DOUBLE_EQ(500, tested.rate(start));
+  EXPECT_DOUBLE_EQ(500, tested.rate(start + minutes(4)));
+  EXPECT_DOUBLE_EQ(750, tested.rate(start + minutes(5)));
+  EXPECT_DOUBLE_EQ(1125, tested.rate(start + minutes(10)));
+  EXPECT_DOUBLE_EQ(10000, tested.rate(start + minutes(60)));
+}
+
+TEST(RampUpRateLimiter, NoRampUp) {
+  auto const start = Clock::now();
+  RampUpRateLimiter tested(500, 10000, 1.0, minutes(5), start);
+  EXPECT_DOUBLE_EQ(500, tested.rate(start + minutes(60)));
+}
+
+TEST(RampUpRateLimiter, Acquire) {
+  auto const start = Clock::now();
+  RampUpRateLimiter tested(100, 100, 1.0, minutes(5), start);
+  // The bucket starts full.
+  EXPECT_EQ(Clock::duration(0), tested.Acquire(60, start));
+  EXPECT_EQ(Clock::duration(0), tested.Acquire(40, start));
+  // The bucket is empty, 20 tokens take 200ms at 100 tokens per second.
+  using ms = std::chrono::duration<double, std::milli>;
+  auto wait = ms(tested.Acquire(20, start));
+  EXPECT_NEAR(200.0, wait.count(), 1.0);
+  // Tokens are not taken when the caller must wait.
+  EXPECT_EQ(Clock::duration(0), tested.Acquire(20, start + milliseconds(200)));
+  EXPECT_NE(Clock::duration(0), tested.Acquire(20, start + milliseconds(200)));
+}
+
+TEST(RampUpRateLimiter, CapacityIsOneSecond) {
+  auto const start = Clock::now();
+  RampUpRateLimiter tested(100, 100, 1.0, minutes(5), start);
+  // Waiting a long time does not accumulate more than one second of tokens.
+  auto const later = start + seconds(60);
+  EXPECT_EQ(Clock::duration(0), tested.Acquire(100, later));
+  EXPECT_NE(Clock::duration(0), tested.Acquire(1, later));
+}
+
+TEST(RampUpRateLimiter, LargeRequests) {
+  auto const start = Clock::now();
+  RampUpRateLimiter tested(10, 10, 1.0, minutes(5), start);
+  // A request larger than the capacity succeeds once the bucket is full.
+  EXPECT_EQ(Clock::duration(0), tested.Acquire(25, start));
+  // ... and the next requests wait for the borrowed tokens.
+  auto wait = tested.Acquire(1, start);
+  EXPECT_NEAR(1.6, std::chrono::duration<double>(wait).count(), 0.01);
+}
+
+}  // namespace
+}  // namespace firestore_internal
+}  // namespace cloud
+}  // namespace google
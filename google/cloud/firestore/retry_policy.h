@@ -0,0 +1,64 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_RETRY_POLICY_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_RETRY_POLICY_H
+
+#include "google/cloud/internal/backoff_policy.h"
+#include "google/cloud/internal/retry_policy.h"
+#include "google/cloud/status.h"
+
+namespace google {
+namespace cloud {
+namespace firestore_internal {
+struct RetryTraits {
+  static inline bool IsPermanentFailure(google::cloud::Status const& status) {
+    return status.code() != StatusCode::kOk &&
+           status.code() != StatusCode::kAborted &&
+           status.code() != StatusCode::kDeadlineExceeded &&
+           status.code() != StatusCode::kInternal &&
+           status.code() != StatusCode::kUnavailable &&
+           status.code() != StatusCode::kResourceExhausted;
+  }
+};
+
+}  // namespace firestore_internal
+
+namespace firestore {
+
+/// The base class for the Cloud Firestore retry policies.
+using RetryPolicy = google::cloud::internal::TraitBasedRetryPolicy<
+    firestore_internal::RetryTraits>;
+
+/// A retry policy that limits the total time spent retrying.
+using LimitedTimeRetryPolicy = google::cloud::internal::LimitedTimeRetryPolicy<
+    firestore_internal::RetryTraits>;
+
+/// A retry policy that limits the number of failures.
+using LimitedErrorCountRetryPolicy =
+    google::cloud::internal::LimitedErrorCountRetryPolicy<
+        firestore_internal::RetryTraits>;
+
+/// The base class for backoff policies.
+using BackoffPolicy = google::cloud::internal::BackoffPolicy;
+
+/// A truncated exponential backoff policy with randomized periods.
+using ExponentialBackoffPolicy =
+    google::cloud::internal::ExponentialBackoffPolicy;
+
+}  // namespace firestore
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_RETRY_POLICY_H
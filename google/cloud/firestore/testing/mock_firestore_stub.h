@@ -0,0 +1,77 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_TESTING_MOCK_FIRESTORE_STUB_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_TESTING_MOCK_FIRESTORE_STUB_H
+
+#include "google/cloud/firestore/internal/firestore_stub.h"
+#include <gmock/gmock.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace firestore_testing {
+
+/**
+ * A class to mock firestore_internal::FirestoreStub
+ */
+class MockFirestoreStub : public firestore_internal::FirestoreStub {
+ public:
+  ~MockFirestoreStub() override = default;
+
+  MOCK_METHOD(std::unique_ptr<internal::StreamingReadRpc<
+                  google::firestore::v1::BatchGetDocumentsResponse>>,
+              BatchGetDocuments,
+              (std::unique_ptr<grpc::ClientContext>,
+               google::firestore::v1::BatchGetDocumentsRequest const&),
+              (override));
+
+  MOCK_METHOD(future<StatusOr<google::firestore::v1::BatchWriteResponse>>,
+              AsyncBatchWrite,
+              (google::cloud::CompletionQueue&,
+               std::unique_ptr<grpc::ClientContext>,
+               google::firestore::v1::BatchWriteRequest const&),
+              (override));
+
+  MOCK_METHOD(StatusOr<google::firestore::v1::PartitionQueryResponse>,
+              PartitionQuery,
+              (grpc::ClientContext&,
+               google::firestore::v1::PartitionQueryRequest const&),
+              (override));
+
+  MOCK_METHOD(std::unique_ptr<internal::StreamingReadRpc<
+                  google::firestore::v1::RunQueryResponse>>,
+              RunQuery,
+              (std::unique_ptr<grpc::ClientContext>,
+               google::firestore::v1::RunQueryRequest const&),
+              (override));
+};
+
+/**
+ * A class to mock the streams returned by `MockFirestoreStub`.
+ */
+template <typename ResponseType>
+class MockStreamingReadRpc : public internal::StreamingReadRpc<ResponseType> {
+ public:
+  ~MockStreamingReadRpc() override = default;
+
+  MOCK_METHOD(void, Cancel, (), (override));
+  MOCK_METHOD((absl::variant<Status, ResponseType>), Read, (), (override));
+};
+
+}  // namespace firestore_testing
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FIRESTORE_TESTING_MOCK_FIRESTORE_STUB_H
@@ -0,0 +1,125 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/future.h"
+#include "google/cloud/status_or.h"
+#include "google/cloud/testing_util/chrono_literals.h"
+#include <gmock/gmock.h>
+#include <stdexcept>
+#include <thread>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+
+#if GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+using testing_util::chrono_literals::operator"" _ms;
+
+future<int> AddOne(future<int> f) { co_return 1 + co_await std::move(f); }
+
+future<void> SetFlag(future<void> f, bool& flag) {
+  co_await std::move(f);
+  flag = true;
+}
+
+future<StatusOr<int>> Sum(future<StatusOr<int>> a, future<StatusOr<int>> b) {
+  auto x = co_await std::move(a);
+  if (!x) co_return std::move(x).status();
+  auto y = co_await std::move(b);
+  if (!y) co_return std::move(y).status();
+  co_return *x + *y;
+}
+
+TEST(FutureCoroutinesTest, AwaitReady) {
+  auto f = AddOne(make_ready_future(41));
+  ASSERT_EQ(std::future_status::ready, f.wait_for(0_ms));
+  EXPECT_EQ(42, f.get());
+}
+
+TEST(FutureCoroutinesTest, AwaitPending) {
+  promise<int> p;
+  auto f = AddOne(p.get_future());
+  EXPECT_NE(std::future_status::ready, f.wait_for(0_ms));
+  p.set_value(41);
+  ASSERT_EQ(std::future_status::ready, f.wait_for(0_ms));
+  EXPECT_EQ(42, f.get());
+}
+
+TEST(FutureCoroutinesTest, AwaitVoid) {
+  promise<void> p;
+  bool flag = false;
+  auto f = SetFlag(p.get_future(), flag);
+  EXPECT_FALSE(flag);
+  p.set_value();
+  f.get();
+  EXPECT_TRUE(flag);
+}
+
+TEST(FutureCoroutinesTest, ResumeInSatisfyingThread) {
+  promise<int> p;
+  auto f = AddOne(p.get_future());
+  std::thread t([&p] { p.set_value(1); });
+  EXPECT_EQ(2, f.get());
+  t.join();
+}
+
+TEST(FutureCoroutinesTest, StatusOr) {
+  promise<StatusOr<int>> a;
+  promise<StatusOr<int>> b;
+  auto f = Sum(a.get_future(), b.get_future());
+  a.set_value(40);
+  b.set_value(2);
+  auto actual = f.get();
+  ASSERT_TRUE(actual.ok());
+  EXPECT_EQ(42, *actual);
+
+  promise<StatusOr<int>> c;
+  promise<StatusOr<int>> d;
+  f = Sum(c.get_future(), d.get_future());
+  c.set_value(Status(StatusCode::kUnavailable, "try-again"));
+  actual = f.get();
+  EXPECT_EQ(StatusCode::kUnavailable, actual.status().code());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+future<int> Throws(future<int> f) {
+  auto v = co_await std::move(f);
+  if (v != 0) throw std::runtime_error("test message");
+  co_return v;
+}
+
+TEST(FutureCoroutinesTest, PropagateException) {
+  promise<int> p;
+  auto f = Throws(p.get_future());
+  p.set_value(1);
+  EXPECT_THROW(f.get(), std::runtime_error);
+
+  promise<int> q;
+  auto g = AddOne(q.get_future());
+  q.set_exception(std::make_exception_ptr(std::runtime_error("test message")));
+  EXPECT_THROW(g.get(), std::runtime_error);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+#else
+TEST(FutureCoroutinesTest, NotAvailable) {
+  GTEST_SKIP() << "C++20 coroutines are not available";
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -17,28 +17,35 @@
 """Automatically generated source lists for google_cloud_cpp_common - DO NOT EDIT."""
 
 google_cloud_cpp_common_hdrs = [
+    "async_log_backend.h",
     "backoff_policy.h",
+    "cancellation.h",
+    "fault_injection_options.h",
     "future.h",
     "future_generic.h",
     "future_void.h",
     "iam_binding.h",
     "iam_bindings.h",
     "iam_policy.h",
+    "instrumentation.h",
     "internal/absl_flat_hash_map_quiet.h",
     "internal/absl_str_cat_quiet.h",
     "internal/absl_str_join_quiet.h",
     "internal/absl_str_replace_quiet.h",
     "internal/api_client_header.h",
     "internal/backoff_policy.h",
+    "internal/base64.h",
     "internal/big_endian.h",
     "internal/build_info.h",
     "internal/compiler_info.h",
     "internal/diagnostics_pop.inc",
     "internal/diagnostics_push.inc",
     "internal/disable_msvc_crt_secure_warnings.inc",
+    "internal/fault_injector.h",
     "internal/filesystem.h",
     "internal/format_time_point.h",
     "internal/future_base.h",
+    "internal/future_coroutines.h",
     "internal/future_fwd.h",
     "internal/future_impl.h",
     "internal/future_then_impl.h",
@@ -48,18 +55,23 @@ google_cloud_cpp_common_hdrs = [
     "internal/ios_flags_saver.h",
     "internal/pagination_range.h",
     "internal/parse_rfc3339.h",
+    "internal/policy_holder.h",
     "internal/port_platform.h",
     "internal/random.h",
+    "internal/retry_budget.h",
     "internal/retry_policy.h",
     "internal/setenv.h",
     "internal/strerror.h",
+    "internal/thread_affinity.h",
     "internal/throw_delegate.h",
+    "internal/timer_wheel.h",
     "internal/tuple.h",
     "internal/user_agent_prefix.h",
     "internal/utility.h",
     "internal/version_info.h",
     "kms_key_name.h",
     "log.h",
+    "memory_budget.h",
     "optional.h",
     "polling_policy.h",
     "status.h",
@@ -71,23 +83,31 @@ google_cloud_cpp_common_hdrs = [
 ]
 
 google_cloud_cpp_common_srcs = [
+    "async_log_backend.cc",
+    "cancellation.cc",
     "iam_bindings.cc",
     "iam_policy.cc",
+    "instrumentation.cc",
     "internal/api_client_header.cc",
     "internal/backoff_policy.cc",
+    "internal/base64.cc",
     "internal/compiler_info.cc",
+    "internal/fault_injector.cc",
     "internal/filesystem.cc",
     "internal/format_time_point.cc",
     "internal/future_impl.cc",
     "internal/getenv.cc",
     "internal/parse_rfc3339.cc",
     "internal/random.cc",
+    "internal/retry_budget.cc",
     "internal/setenv.cc",
     "internal/strerror.cc",
+    "internal/thread_affinity.cc",
     "internal/throw_delegate.cc",
     "internal/user_agent_prefix.cc",
     "kms_key_name.cc",
     "log.cc",
+    "memory_budget.cc",
     "status.cc",
     "terminate_handler.cc",
     "tracing_options.cc",
@@ -17,4 +17,7 @@
 """Automatically generated unit tests list - DO NOT EDIT."""
 
 google_cloud_cpp_common_benchmarks = [
+    "future_benchmark.cc",
+    "internal/rfc3339_benchmark.cc",
+    "status_or_benchmark.cc",
 ]
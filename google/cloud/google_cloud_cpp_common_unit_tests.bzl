@@ -17,31 +17,42 @@
 """Automatically generated unit tests list - DO NOT EDIT."""
 
 google_cloud_cpp_common_unit_tests = [
+    "async_log_backend_test.cc",
+    "cancellation_test.cc",
+    "future_coroutines_test.cc",
     "future_generic_test.cc",
     "future_generic_then_test.cc",
     "future_void_test.cc",
     "future_void_then_test.cc",
     "iam_bindings_test.cc",
+    "instrumentation_test.cc",
     "internal/api_client_header_test.cc",
     "internal/backoff_policy_test.cc",
+    "internal/base64_test.cc",
     "internal/big_endian_test.cc",
     "internal/compiler_info_test.cc",
     "internal/env_test.cc",
+    "internal/fault_injector_test.cc",
     "internal/filesystem_test.cc",
     "internal/format_time_point_test.cc",
     "internal/future_impl_test.cc",
     "internal/invoke_result_test.cc",
     "internal/pagination_range_test.cc",
     "internal/parse_rfc3339_test.cc",
+    "internal/policy_holder_test.cc",
     "internal/random_test.cc",
+    "internal/retry_budget_test.cc",
     "internal/retry_policy_test.cc",
     "internal/strerror_test.cc",
+    "internal/thread_affinity_test.cc",
     "internal/throw_delegate_test.cc",
+    "internal/timer_wheel_test.cc",
     "internal/tuple_test.cc",
     "internal/user_agent_prefix_test.cc",
     "internal/utility_test.cc",
     "kms_key_name_test.cc",
     "log_test.cc",
+    "memory_budget_test.cc",
     "status_or_test.cc",
     "status_test.cc",
     "stream_range_test.cc",
@@ -26,23 +26,33 @@ google_cloud_cpp_grpc_utils_hdrs = [
     "grpc_utils/completion_queue.h",
     "grpc_utils/grpc_error_delegate.h",
     "grpc_utils/version.h",
+    "internal/async_batch_completion.h",
     "internal/async_connection_ready.h",
     "internal/async_read_stream_impl.h",
     "internal/async_read_write_stream_impl.h",
     "internal/async_retry_loop.h",
     "internal/async_retry_unary_rpc.h",
     "internal/async_rpc_details.h",
+    "internal/async_streaming_read_write_rpc_fault_injection.h",
+    "internal/async_streaming_read_write_rpc_logging.h",
+    "internal/async_streaming_read_write_rpc_metrics.h",
     "internal/background_threads_impl.h",
+    "internal/channel_cache.h",
+    "internal/channel_pool.h",
     "internal/completion_queue_impl.h",
     "internal/default_completion_queue_impl.h",
     "internal/log_wrapper.h",
+    "internal/metrics_wrapper.h",
     "internal/polling_loop.h",
     "internal/resumable_streaming_read_rpc.h",
     "internal/retry_loop.h",
     "internal/retry_loop_helpers.h",
+    "internal/sharded_completion_queue_impl.h",
     "internal/streaming_read_rpc.h",
     "internal/streaming_read_rpc_logging.h",
+    "internal/streaming_read_rpc_metrics.h",
     "internal/time_utils.h",
+    "internal/work_stealing_executor.h",
 ]
 
 google_cloud_cpp_grpc_utils_srcs = [
@@ -51,9 +61,14 @@ google_cloud_cpp_grpc_utils_srcs = [
     "grpc_error_delegate.cc",
     "internal/async_connection_ready.cc",
     "internal/background_threads_impl.cc",
+    "internal/channel_cache.cc",
+    "internal/channel_pool.cc",
     "internal/default_completion_queue_impl.cc",
     "internal/log_wrapper.cc",
+    "internal/metrics_wrapper.cc",
     "internal/retry_loop_helpers.cc",
+    "internal/sharded_completion_queue_impl.cc",
     "internal/streaming_read_rpc.cc",
     "internal/time_utils.cc",
+    "internal/work_stealing_executor.cc",
 ]
@@ -20,16 +20,26 @@ google_cloud_cpp_grpc_utils_unit_tests = [
     "completion_queue_test.cc",
     "connection_options_test.cc",
     "grpc_error_delegate_test.cc",
+    "internal/async_batch_completion_test.cc",
     "internal/async_connection_ready_test.cc",
     "internal/async_read_write_stream_impl_test.cc",
     "internal/async_retry_loop_test.cc",
     "internal/async_retry_unary_rpc_test.cc",
+    "internal/async_streaming_read_write_rpc_fault_injection_test.cc",
+    "internal/async_streaming_read_write_rpc_logging_test.cc",
+    "internal/async_streaming_read_write_rpc_metrics_test.cc",
     "internal/background_threads_impl_test.cc",
+    "internal/channel_cache_test.cc",
+    "internal/channel_pool_test.cc",
     "internal/log_wrapper_test.cc",
+    "internal/metrics_wrapper_test.cc",
     "internal/polling_loop_test.cc",
     "internal/resumable_streaming_read_rpc_test.cc",
     "internal/retry_loop_test.cc",
+    "internal/sharded_completion_queue_impl_test.cc",
     "internal/streaming_read_rpc_logging_test.cc",
+    "internal/streaming_read_rpc_metrics_test.cc",
     "internal/streaming_read_rpc_test.cc",
     "internal/time_utils_test.cc",
+    "internal/work_stealing_executor_test.cc",
 ]
@@ -0,0 +1,114 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/iam/caching_access_token_generator.h"
+#include "google/cloud/internal/time_utils.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace iam {
+
+using ::google::iam::credentials::v1::GenerateAccessTokenRequest;
+using ::google::iam::credentials::v1::GenerateAccessTokenResponse;
+
+StatusOr<GenerateAccessTokenResponse>
+CachingAccessTokenGenerator::GenerateAccessToken(
+    GenerateAccessTokenRequest const& request) {
+  return AsyncGenerateAccessToken(request).get();
+}
+
+future<StatusOr<GenerateAccessTokenResponse>>
+CachingAccessTokenGenerator::AsyncGenerateAccessToken(
+    GenerateAccessTokenRequest const& request) {
+  auto key = MakeKey(request);
+  auto const now = clock_();
+  std::unique_lock<std::mutex> lk(mu_);
+  auto& entry = cache_[key];
+  if (entry.has_token && entry.expiration - options_.expiration_slack() > now) {
+    auto token = entry.token;
+    auto const refresh =
+        !entry.refreshing && entry.expiration - options_.refresh_ahead() <= now;
+    if (refresh) entry.refreshing = true;
+    lk.unlock();
+    if (refresh) Refresh(std::move(key), request);
+    return make_ready_future(make_status_or(std::move(token)));
+  }
+
+  promise<StatusOr<GenerateAccessTokenResponse>> p;
+  auto f = p.get_future();
+  entry.waiters.push_back(std::move(p));
+  if (entry.refreshing) return f;
+  entry.refreshing = true;
+  lk.unlock();
+  Refresh(std::move(key), request);
+  return f;
+}
+
+CachingAccessTokenGenerator::Key CachingAccessTokenGenerator::MakeKey(
+    GenerateAccessTokenRequest const& request) {
+  std::vector<std::string> scopes(request.scope().begin(),
+                                  request.scope().end());
+  std::sort(scopes.begin(), scopes.end());
+  std::vector<std::string> delegates(request.delegates().begin(),
+                                     request.delegates().end());
+  return Key(request.name(), std::move(scopes), std::move(delegates));
+}
+
+void CachingAccessTokenGenerator::Refresh(
+    Key key, GenerateAccessTokenRequest const& request) {
+  // Keep the generator alive until the refresh completes, otherwise the
+  // promises held in the cache would be destroyed before they are satisfied.
+  auto self = shared_from_this();
+  struct OnResponse {
+    std::shared_ptr<CachingAccessTokenGenerator> self;
+    Key key;
+    void operator()(future<StatusOr<GenerateAccessTokenResponse>> f) {
+      self->OnRefresh(key, f.get());
+    }
+  };
+  connection_->AsyncGenerateAccessToken(request).then(
+      OnResponse{std::move(self), std::move(key)});
+}
+
+void CachingAccessTokenGenerator::OnRefresh(
+    Key const& key, StatusOr<GenerateAccessTokenResponse> response) {
+  std::unique_lock<std::mutex> lk(mu_);
+  auto loc = cache_.find(key);
+  if (loc == cache_.end()) return;
+  auto& entry = loc->second;
+  entry.refreshing = false;
+  auto waiters = std::move(entry.waiters);
+  entry.waiters.clear();
+  if (response) {
+    entry.token = *response;
+    entry.expiration = internal::ToChronoTimePoint(response->expire_time());
+    entry.has_token = true;
+  } else if (!entry.has_token) {
+    // Do not keep entries for requests that never succeeded, the application
+    // may be sending requests for invalid (or deleted) service accounts.
+    cache_.erase(loc);
+  }
+  lk.unlock();
+  // A failed background refresh keeps the current token, which remains usable
+  // until it is close to expiring. Only callers waiting for a token see the
+  // error.
+  for (auto& w : waiters) w.set_value(response);
+}
+
+}  // namespace iam
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,178 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_IAM_CACHING_ACCESS_TOKEN_GENERATOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_IAM_CACHING_ACCESS_TOKEN_GENERATOR_H
+
+#include "google/cloud/iam/iam_credentials_connection.gcpcxx.pb.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status_or.h"
+#include "google/cloud/version.h"
+#include <google/iam/credentials/v1/iamcredentials.grpc.pb.h>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace iam {
+
+/**
+ * Controls when `CachingAccessTokenGenerator` refreshes its cached tokens.
+ *
+ * A cached token is returned while its remaining lifetime is larger than the
+ * `expiration_slack()`. Once the remaining lifetime drops below
+ * `refresh_ahead()` the generator starts a background refresh, but continues
+ * to return the cached token until the refresh completes. Only callers that
+ * find no usable token wait for a new one.
+ */
+class CachingAccessTokenGeneratorOptions {
+ public:
+  CachingAccessTokenGeneratorOptions() = default;
+
+  /// Tokens expiring within this time are never returned from the cache.
+  std::chrono::seconds expiration_slack() const { return expiration_slack_; }
+  CachingAccessTokenGeneratorOptions& set_expiration_slack(
+      std::chrono::seconds v) {
+    expiration_slack_ = v;
+    return *this;
+  }
+
+  /// Tokens expiring within this time are refreshed in the background.
+  std::chrono::seconds refresh_ahead() const { return refresh_ahead_; }
+  CachingAccessTokenGeneratorOptions& set_refresh_ahead(
+      std::chrono::seconds v) {
+    refresh_ahead_ = v;
+    return *this;
+  }
+
+ private:
+  std::chrono::seconds expiration_slack_ = std::chrono::seconds(60);
+  std::chrono::seconds refresh_ahead_ = std::chrono::seconds(300);
+};
+
+/**
+ * Caches the access tokens returned by `GenerateAccessToken()`.
+ *
+ * Applications that impersonate service accounts often call
+ * `IAMCredentialsClient::GenerateAccessToken()` before each request, even
+ * though the tokens are valid for an hour (by default). This class keeps the
+ * most recent token for each combination of service account name, scopes,
+ * and delegates, and returns it until it is close to its expiration time. The
+ * order of the scopes is not significant, the order of the delegates is.
+ *
+ * Tokens are refreshed in the background before they expire, see
+ * `CachingAccessTokenGeneratorOptions` for details. At most one
+ * `AsyncGenerateAccessToken()` RPC is in progress for each key: concurrent
+ * callers that need a new token share the result of a single request.
+ *
+ * The `lifetime` field of the request is forwarded to the service when a new
+ * token is needed, but it is not part of the cache key.
+ *
+ * @par Example
+ * @code
+ * namespace iam = ::google::cloud::iam;
+ * auto tokens = iam::CachingAccessTokenGenerator::Create(
+ *     iam::MakeIAMCredentialsConnection());
+ * google::iam::credentials::v1::GenerateAccessTokenRequest request;
+ * request.set_name("projects/-/serviceAccounts/"
+ *                  "sa@my-project.iam.gserviceaccount.com");
+ * request.add_scope("https://www.googleapis.com/auth/cloud-platform");
+ * auto token = tokens->GenerateAccessToken(request);
+ * @endcode
+ *
+ * @note The connection must support `AsyncGenerateAccessToken()`, as the
+ *     connections returned by `MakeIAMCredentialsConnection()` do.
+ */
+class CachingAccessTokenGenerator
+    : public std::enable_shared_from_this<CachingAccessTokenGenerator> {
+ public:
+  using Clock = std::function<std::chrono::system_clock::time_point()>;
+
+  static std::shared_ptr<CachingAccessTokenGenerator> Create(
+      std::shared_ptr<IAMCredentialsConnection> connection,
+      CachingAccessTokenGeneratorOptions options = {}) {
+    return Create(std::move(connection), std::move(options),
+                  [] { return std::chrono::system_clock::now(); });
+  }
+
+  /// Creates a generator using @p clock, applications should not need this.
+  static std::shared_ptr<CachingAccessTokenGenerator> Create(
+      std::shared_ptr<IAMCredentialsConnection> connection,
+      CachingAccessTokenGeneratorOptions options, Clock clock) {
+    return std::shared_ptr<CachingAccessTokenGenerator>(
+        new CachingAccessTokenGenerator(std::move(connection),
+                                        std::move(options), std::move(clock)));
+  }
+
+  /// Returns a cached token for @p request, or blocks until one is available.
+  StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>
+  GenerateAccessToken(
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request);
+
+  /// Returns a future satisfied with a cached or newly generated token.
+  future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request);
+
+ private:
+  using Response = ::google::iam::credentials::v1::GenerateAccessTokenResponse;
+  using Key = std::tuple<std::string, std::vector<std::string>,
+                         std::vector<std::string>>;
+
+  struct Entry {
+    Response token;
+    std::chrono::system_clock::time_point expiration;
+    bool has_token = false;
+    bool refreshing = false;
+    std::vector<promise<StatusOr<Response>>> waiters;
+  };
+
+  CachingAccessTokenGenerator(
+      std::shared_ptr<IAMCredentialsConnection> connection,
+      CachingAccessTokenGeneratorOptions options, Clock clock)
+      : connection_(std::move(connection)),
+        options_(std::move(options)),
+        clock_(std::move(clock)) {}
+
+  static Key MakeKey(
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request);
+  void Refresh(Key key,
+               ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+                   request);
+  void OnRefresh(Key const& key, StatusOr<Response> response);
+
+  std::shared_ptr<IAMCredentialsConnection> const connection_;
+  CachingAccessTokenGeneratorOptions const options_;
+  Clock const clock_;
+
+  std::mutex mu_;
+  std::map<Key, Entry> cache_;
+};
+
+}  // namespace iam
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_IAM_CACHING_ACCESS_TOKEN_GENERATOR_H
@@ -0,0 +1,235 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/iam/caching_access_token_generator.h"
+#include "google/cloud/iam/mocks/mock_iam_credentials_connection.gcpcxx.pb.h"
+#include "google/cloud/internal/time_utils.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace iam {
+namespace {
+
+using ::google::cloud::iam_mocks::MockIAMCredentialsConnection;
+using ::google::cloud::testing_util::StatusIs;
+using ::google::iam::credentials::v1::GenerateAccessTokenRequest;
+using ::google::iam::credentials::v1::GenerateAccessTokenResponse;
+
+using TokenResponse = StatusOr<GenerateAccessTokenResponse>;
+
+auto const kStart = std::chrono::system_clock::time_point{} +
+                    std::chrono::hours(24 * 365 * 50);
+
+GenerateAccessTokenRequest MakeRequest(std::vector<std::string> scopes,
+                                       std::vector<std::string> delegates) {
+  GenerateAccessTokenRequest request;
+  request.set_name("projects/-/serviceAccounts/sa@test-project.iam");
+  for (auto& s : scopes) request.add_scope(std::move(s));
+  for (auto& d : delegates) request.add_delegates(std::move(d));
+  return request;
+}
+
+GenerateAccessTokenRequest MakeRequest() {
+  return MakeRequest({"scope-a", "scope-b"}, {});
+}
+
+TokenResponse MakeToken(std::string token,
+                        std::chrono::system_clock::time_point expiration) {
+  GenerateAccessTokenResponse response;
+  response.set_access_token(std::move(token));
+  *response.mutable_expire_time() = internal::ToProtoTimestamp(expiration);
+  return response;
+}
+
+class CachingAccessTokenGeneratorTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<CachingAccessTokenGenerator> MakeGenerator() {
+    return CachingAccessTokenGenerator::Create(
+        mock_,
+        CachingAccessTokenGeneratorOptions{}
+            .set_expiration_slack(std::chrono::seconds(60))
+            .set_refresh_ahead(std::chrono::seconds(300)),
+        [this] { return now_; });
+  }
+
+  std::shared_ptr<MockIAMCredentialsConnection> mock_ =
+      std::make_shared<MockIAMCredentialsConnection>();
+  std::chrono::system_clock::time_point now_ = kStart;
+};
+
+TEST_F(CachingAccessTokenGeneratorTest, CachesToken) {
+  EXPECT_CALL(*mock_, AsyncGenerateAccessToken)
+      .WillOnce([](GenerateAccessTokenRequest const& request) {
+        EXPECT_EQ("projects/-/serviceAccounts/sa@test-project.iam",
+                  request.name());
+        return make_ready_future(
+            MakeToken("token-1", kStart + std::chrono::hours(1)));
+      });
+
+  auto tested = MakeGenerator();
+  auto token = tested->GenerateAccessToken(MakeRequest());
+  ASSERT_STATUS_OK(token);
+  EXPECT_EQ("token-1", token->access_token());
+
+  now_ += std::chrono::minutes(30);
+  // The order of the scopes is not significant.
+  token = tested->GenerateAccessToken(MakeRequest({"scope-b", "scope-a"}, {}));
+  ASSERT_STATUS_OK(token);
+  EXPECT_EQ("token-1", token->access_token());
+}
+
+TEST_F(CachingAccessTokenGeneratorTest, KeysIncludeScopesAndDelegates) {
+  EXPECT_CALL(*mock_, AsyncGenerateAccessToken)
+      .Times(3)
+      .WillRepeatedly([](GenerateAccessTokenRequest const& request) {
+        auto token = std::to_string(request.scope_size()) + "-" +
+                     std::to_string(request.delegates_size());
+        return make_ready_future(
+            MakeToken(std::move(token), kStart + std::chrono::hours(1)));
+      });
+
+  auto tested = MakeGenerator();
+  for (int i = 0; i != 2; ++i) {
+    auto token = tested->GenerateAccessToken(MakeRequest());
+    ASSERT_STATUS_OK(token);
+    EXPECT_EQ("2-0", token->access_token());
+    token = tested->GenerateAccessToken(MakeRequest({"scope-a"}, {}));
+    ASSERT_STATUS_OK(token);
+    EXPECT_EQ("1-0", token->access_token());
+    token = tested->GenerateAccessToken(MakeRequest({"scope-a"}, {"d"}));
+    ASSERT_STATUS_OK(token);
+    EXPECT_EQ("1-1", token->access_token());
+  }
+}
+
+TEST_F(CachingAccessTokenGeneratorTest, RefreshesAheadOfExpiration) {
+  promise<TokenResponse> refresh;
+  EXPECT_CALL(*mock_, AsyncGenerateAccessToken)
+      .WillOnce([](GenerateAccessTokenRequest const&) {
+        return make_ready_future(
+            MakeToken("token-1", kStart + std::chrono::hours(1)));
+      })
+      .WillOnce([&](GenerateAccessTokenRequest const&) {
+        return refresh.get_future();
+      });
+
+  auto tested = MakeGenerator();
+  ASSERT_STATUS_OK(tested->GenerateAccessToken(MakeRequest()));
+
+  // Inside the refresh window the cached token is returned immediately, and
+  // only one background refresh starts.
+  now_ = kStart + std::chrono::minutes(57);
+  for (int i = 0; i != 3; ++i) {
+    auto token = tested->GenerateAccessToken(MakeRequest());
+    ASSERT_STATUS_OK(token);
+    EXPECT_EQ("token-1", token->access_token());
+  }
+
+  refresh.set_value(MakeToken("token-2", kStart + std::chrono::hours(2)));
+  auto token = tested->GenerateAccessToken(MakeRequest());
+  ASSERT_STATUS_OK(token);
+  EXPECT_EQ("token-2", token->access_token());
+}
+
+TEST_F(CachingAccessTokenGeneratorTest, SingleFlightForConcurrentCallers) {
+  promise<TokenResponse> response;
+  EXPECT_CALL(*mock_, AsyncGenerateAccessToken)
+      .WillOnce([&](GenerateAccessTokenRequest const&) {
+        return response.get_future();
+      });
+
+  auto tested = MakeGenerator();
+  std::vector<future<TokenResponse>> pending;
+  for (int i = 0; i != 3; ++i) {
+    pending.push_back(tested->AsyncGenerateAccessToken(MakeRequest()));
+  }
+  response.set_value(MakeToken("token-1", kStart + std::chrono::hours(1)));
+  for (auto& f : pending) {
+    auto token = f.get();
+    ASSERT_STATUS_OK(token);
+    EXPECT_EQ("token-1", token->access_token());
+  }
+}
+
+TEST_F(CachingAccessTokenGeneratorTest, ExpiredTokenIsNotReturned) {
+  EXPECT_CALL(*mock_, AsyncGenerateAccessToken)
+      .WillOnce([](GenerateAccessTokenRequest const&) {
+        return make_ready_future(
+            MakeToken("token-1", kStart + std::chrono::hours(1)));
+      })
+      .WillOnce([](GenerateAccessTokenRequest const&) {
+        return make_ready_future(
+            MakeToken("token-2", kStart + std::chrono::hours(2)));
+      });
+
+  auto tested = MakeGenerator();
+  ASSERT_STATUS_OK(tested->GenerateAccessToken(MakeRequest()));
+
+  // The token is within the expiration slack, the caller must wait.
+  now_ = kStart + std::chrono::minutes(59) + std::chrono::seconds(30);
+  auto token = tested->GenerateAccessToken(MakeRequest());
+  ASSERT_STATUS_OK(token);
+  EXPECT_EQ("token-2", token->access_token());
+}
+
+TEST_F(CachingAccessTokenGeneratorTest, ErrorsAreNotCached) {
+  EXPECT_CALL(*mock_, AsyncGenerateAccessToken)
+      .WillOnce([](GenerateAccessTokenRequest const&) {
+        return make_ready_future(
+            TokenResponse(Status(StatusCode::kPermissionDenied, "uh-oh")));
+      })
+      .WillOnce([](GenerateAccessTokenRequest const&) {
+        return make_ready_future(
+            MakeToken("token-1", kStart + std::chrono::hours(1)));
+      });
+
+  auto tested = MakeGenerator();
+  EXPECT_THAT(tested->GenerateAccessToken(MakeRequest()),
+              StatusIs(StatusCode::kPermissionDenied));
+  auto token = tested->GenerateAccessToken(MakeRequest());
+  ASSERT_STATUS_OK(token);
+  EXPECT_EQ("token-1", token->access_token());
+}
+
+TEST_F(CachingAccessTokenGeneratorTest, FailedRefreshKeepsToken) {
+  EXPECT_CALL(*mock_, AsyncGenerateAccessToken)
+      .WillOnce([](GenerateAccessTokenRequest const&) {
+        return make_ready_future(
+            MakeToken("token-1", kStart + std::chrono::hours(1)));
+      })
+      .WillOnce([](GenerateAccessTokenRequest const&) {
+        return make_ready_future(
+            TokenResponse(Status(StatusCode::kUnavailable, "try-again")));
+      });
+
+  auto tested = MakeGenerator();
+  ASSERT_STATUS_OK(tested->GenerateAccessToken(MakeRequest()));
+
+  now_ = kStart + std::chrono::minutes(57);
+  auto token = tested->GenerateAccessToken(MakeRequest());
+  ASSERT_STATUS_OK(token);
+  EXPECT_EQ("token-1", token->access_token());
+}
+
+}  // namespace
+}  // namespace iam
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -17,22 +17,26 @@
 """Automatically generated source lists for google_cloud_cpp_iam - DO NOT EDIT."""
 
 google_cloud_cpp_iam_hdrs = [
+    "caching_access_token_generator.h",
     "iam_credentials_client.gcpcxx.pb.h",
     "iam_credentials_connection.gcpcxx.pb.h",
     "iam_credentials_connection_idempotency_policy.gcpcxx.pb.h",
     "internal/iam_credentials_logging_decorator.gcpcxx.pb.h",
     "internal/iam_credentials_metadata_decorator.gcpcxx.pb.h",
+    "internal/iam_credentials_metrics_decorator.gcpcxx.pb.h",
     "internal/iam_credentials_stub.gcpcxx.pb.h",
     "internal/iam_credentials_stub_factory.gcpcxx.pb.h",
     "retry_traits.h",
 ]
 
 google_cloud_cpp_iam_srcs = [
+    "caching_access_token_generator.cc",
     "iam_credentials_client.gcpcxx.pb.cc",
     "iam_credentials_connection.gcpcxx.pb.cc",
     "iam_credentials_connection_idempotency_policy.gcpcxx.pb.cc",
     "internal/iam_credentials_logging_decorator.gcpcxx.pb.cc",
     "internal/iam_credentials_metadata_decorator.gcpcxx.pb.cc",
+    "internal/iam_credentials_metrics_decorator.gcpcxx.pb.cc",
     "internal/iam_credentials_stub.gcpcxx.pb.cc",
     "internal/iam_credentials_stub_factory.gcpcxx.pb.cc",
 ]
@@ -101,6 +101,30 @@ IAMCredentialsClient::SignJwt(
   return connection_->SignJwt(request);
 }
 
+future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+IAMCredentialsClient::AsyncGenerateAccessToken(
+    ::google::iam::credentials::v1::GenerateAccessTokenRequest const& request) {
+  return connection_->AsyncGenerateAccessToken(request);
+}
+
+future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+IAMCredentialsClient::AsyncGenerateIdToken(
+    ::google::iam::credentials::v1::GenerateIdTokenRequest const& request) {
+  return connection_->AsyncGenerateIdToken(request);
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+IAMCredentialsClient::AsyncSignBlob(
+    ::google::iam::credentials::v1::SignBlobRequest const& request) {
+  return connection_->AsyncSignBlob(request);
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+IAMCredentialsClient::AsyncSignJwt(
+    ::google::iam::credentials::v1::SignJwtRequest const& request) {
+  return connection_->AsyncSignJwt(request);
+}
+
 }  // namespace iam
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -225,6 +225,45 @@ class IAMCredentialsClient {
   StatusOr<::google::iam::credentials::v1::SignJwtResponse> SignJwt(
       ::google::iam::credentials::v1::SignJwtRequest const& request);
 
+  /**
+   * Asynchronous version of `GenerateAccessToken()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request);
+
+  /**
+   * Asynchronous version of `GenerateIdToken()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(
+      ::google::iam::credentials::v1::GenerateIdTokenRequest const& request);
+
+  /**
+   * Asynchronous version of `SignBlob()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+  AsyncSignBlob(::google::iam::credentials::v1::SignBlobRequest const& request);
+
+  /**
+   * Asynchronous version of `SignJwt()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+  AsyncSignJwt(::google::iam::credentials::v1::SignJwtRequest const& request);
+
  private:
   std::shared_ptr<IAMCredentialsConnection> connection_;
 };
@@ -18,6 +18,8 @@
 
 #include "google/cloud/iam/iam_credentials_connection.gcpcxx.pb.h"
 #include "google/cloud/iam/internal/iam_credentials_stub_factory.gcpcxx.pb.h"
+#include "google/cloud/background_threads.h"
+#include "google/cloud/internal/async_retry_loop.h"
 #include "google/cloud/internal/retry_loop.h"
 #include "google/cloud/internal/user_agent_prefix.h"
 #include <memory>
@@ -63,6 +65,38 @@ IAMCredentialsConnection::SignJwt(
   return Status(StatusCode::kUnimplemented, "not implemented");
 }
 
+future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+IAMCredentialsConnection::AsyncGenerateAccessToken(
+    ::google::iam::credentials::v1::GenerateAccessTokenRequest const&) {
+  return google::cloud::make_ready_future<
+      StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>(
+      Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+IAMCredentialsConnection::AsyncGenerateIdToken(
+    ::google::iam::credentials::v1::GenerateIdTokenRequest const&) {
+  return google::cloud::make_ready_future<
+      StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>(
+      Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+IAMCredentialsConnection::AsyncSignBlob(
+    ::google::iam::credentials::v1::SignBlobRequest const&) {
+  return google::cloud::make_ready_future<
+      StatusOr<::google::iam::credentials::v1::SignBlobResponse>>(
+      Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+IAMCredentialsConnection::AsyncSignJwt(
+    ::google::iam::credentials::v1::SignJwtRequest const&) {
+  return google::cloud::make_ready_future<
+      StatusOr<::google::iam::credentials::v1::SignJwtResponse>>(
+      Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
 namespace {
 std::unique_ptr<IAMCredentialsRetryPolicy> DefaultRetryPolicy() {
   return IAMCredentialsLimitedTimeRetryPolicy(std::chrono::minutes(30)).clone();
@@ -78,20 +112,24 @@ std::unique_ptr<BackoffPolicy> DefaultBackoffPolicy() {
 class IAMCredentialsConnectionImpl : public IAMCredentialsConnection {
  public:
   explicit IAMCredentialsConnectionImpl(
+      std::unique_ptr<BackgroundThreads> background,
       std::shared_ptr<iam_internal::IAMCredentialsStub> stub,
       std::unique_ptr<IAMCredentialsRetryPolicy> retry_policy,
       std::unique_ptr<BackoffPolicy> backoff_policy,
       std::unique_ptr<IAMCredentialsConnectionIdempotencyPolicy>
           idempotency_policy)
-      : stub_(std::move(stub)),
+      : background_(std::move(background)),
+        stub_(std::move(stub)),
         retry_policy_prototype_(std::move(retry_policy)),
         backoff_policy_prototype_(std::move(backoff_policy)),
         idempotency_policy_(std::move(idempotency_policy)) {}
 
   explicit IAMCredentialsConnectionImpl(
+      std::unique_ptr<BackgroundThreads> background,
       std::shared_ptr<iam_internal::IAMCredentialsStub> stub)
       : IAMCredentialsConnectionImpl(
-            std::move(stub), DefaultRetryPolicy(), DefaultBackoffPolicy(),
+            std::move(background), std::move(stub), DefaultRetryPolicy(),
+            DefaultBackoffPolicy(),
             MakeDefaultIAMCredentialsConnectionIdempotencyPolicy()) {}
 
   ~IAMCredentialsConnectionImpl() override = default;
@@ -149,7 +187,73 @@ class IAMCredentialsConnectionImpl : public IAMCredentialsConnection {
         request, __func__);
   }
 
+  future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->GenerateAccessToken(request), background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+                   request) {
+          return stub->AsyncGenerateAccessToken(cq, std::move(context),
+                                                request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(
+      ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+          request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->GenerateIdToken(request), background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+                   request) {
+          return stub->AsyncGenerateIdToken(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+  AsyncSignBlob(
+      ::google::iam::credentials::v1::SignBlobRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->SignBlob(request), background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::iam::credentials::v1::SignBlobRequest const& request) {
+          return stub->AsyncSignBlob(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+  AsyncSignJwt(
+      ::google::iam::credentials::v1::SignJwtRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->SignJwt(request), background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::iam::credentials::v1::SignJwtRequest const& request) {
+          return stub->AsyncSignJwt(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
  private:
+  std::unique_ptr<BackgroundThreads> background_;
   std::shared_ptr<iam_internal::IAMCredentialsStub> stub_;
   std::unique_ptr<IAMCredentialsRetryPolicy const> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
@@ -161,6 +265,7 @@ class IAMCredentialsConnectionImpl : public IAMCredentialsConnection {
 std::shared_ptr<IAMCredentialsConnection> MakeIAMCredentialsConnection(
     IAMCredentialsConnectionOptions const& options) {
   return std::make_shared<IAMCredentialsConnectionImpl>(
+      options.background_threads_factory()(),
       iam_internal::CreateDefaultIAMCredentialsStub(options));
 }
 
@@ -171,6 +276,7 @@ std::shared_ptr<IAMCredentialsConnection> MakeIAMCredentialsConnection(
     std::unique_ptr<IAMCredentialsConnectionIdempotencyPolicy>
         idempotency_policy) {
   return std::make_shared<IAMCredentialsConnectionImpl>(
+      options.background_threads_factory()(),
       iam_internal::CreateDefaultIAMCredentialsStub(options),
       std::move(retry_policy), std::move(backoff_policy),
       std::move(idempotency_policy));
@@ -183,7 +289,8 @@ std::shared_ptr<IAMCredentialsConnection> MakeIAMCredentialsConnection(
     std::unique_ptr<IAMCredentialsConnectionIdempotencyPolicy>
         idempotency_policy) {
   return std::make_shared<IAMCredentialsConnectionImpl>(
-      std::move(stub), std::move(retry_policy), std::move(backoff_policy),
+      google::cloud::internal::DefaultBackgroundThreads(1), std::move(stub),
+      std::move(retry_policy), std::move(backoff_policy),
       std::move(idempotency_policy));
 }
 
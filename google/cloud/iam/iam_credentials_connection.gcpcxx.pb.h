@@ -23,6 +23,8 @@
 #include "google/cloud/iam/retry_traits.h"
 #include "google/cloud/backoff_policy.h"
 #include "google/cloud/connection_options.h"
+#include "google/cloud/future.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/version.h"
 #include <memory>
@@ -53,6 +55,10 @@ using IAMCredentialsLimitedErrorCountRetryPolicy =
     google::cloud::internal::LimitedErrorCountRetryPolicy<
         iam_internal::IAMCredentialsRetryTraits>;
 
+using IAMCredentialsBudgetedRetryPolicy =
+    google::cloud::internal::BudgetedRetryPolicy<
+        iam_internal::IAMCredentialsRetryTraits>;
+
 class IAMCredentialsConnection {
  public:
   virtual ~IAMCredentialsConnection() = 0;
@@ -71,6 +77,25 @@ class IAMCredentialsConnection {
 
   virtual StatusOr<::google::iam::credentials::v1::SignJwtResponse> SignJwt(
       ::google::iam::credentials::v1::SignJwtRequest const& request);
+
+  virtual future<StatusOr<
+      ::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request);
+
+  virtual future<StatusOr<
+      ::google::iam::credentials::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(
+      ::google::iam::credentials::v1::GenerateIdTokenRequest const& request);
+
+  virtual future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+  AsyncSignBlob(
+      ::google::iam::credentials::v1::SignBlobRequest const& request);
+
+  virtual future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+  AsyncSignJwt(
+      ::google::iam::credentials::v1::SignJwtRequest const& request);
 };
 
 std::shared_ptr<IAMCredentialsConnection> MakeIAMCredentialsConnection(
@@ -81,6 +81,65 @@ IAMCredentialsLogging::SignJwt(
       context, request, __func__, tracing_options_);
 }
 
+future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+IAMCredentialsLogging::AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::GenerateAccessTokenRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+                 request) {
+        return child_->AsyncGenerateAccessToken(cq, std::move(context),
+                                                request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
+future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+IAMCredentialsLogging::AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::GenerateIdTokenRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+                 request) {
+        return child_->AsyncGenerateIdToken(cq, std::move(context), request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+IAMCredentialsLogging::AsyncSignBlob(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::SignBlobRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::credentials::v1::SignBlobRequest const& request) {
+        return child_->AsyncSignBlob(cq, std::move(context), request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+IAMCredentialsLogging::AsyncSignJwt(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::SignJwtRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::credentials::v1::SignJwtRequest const& request) {
+        return child_->AsyncSignJwt(cq, std::move(context), request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
 }  // namespace iam_internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -56,6 +56,32 @@ class IAMCredentialsLogging : public IAMCredentialsStub {
       grpc::ClientContext& context,
       ::google::iam::credentials::v1::SignJwtRequest const& request) override;
 
+  future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request) override;
+
+  future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+          request) override;
+
+  future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+  AsyncSignBlob(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::SignBlobRequest const& request) override;
+
+  future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+  AsyncSignJwt(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::SignJwtRequest const& request) override;
+
  private:
   std::shared_ptr<IAMCredentialsStub> child_;
   TracingOptions tracing_options_;
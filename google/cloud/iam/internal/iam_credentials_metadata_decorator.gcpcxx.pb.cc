@@ -63,6 +63,42 @@ IAMCredentialsMetadata::SignJwt(
   return child_->SignJwt(context, request);
 }
 
+future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+IAMCredentialsMetadata::AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::GenerateAccessTokenRequest const& request) {
+  SetMetadata(*context, "name=" + request.name());
+  return child_->AsyncGenerateAccessToken(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+IAMCredentialsMetadata::AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::GenerateIdTokenRequest const& request) {
+  SetMetadata(*context, "name=" + request.name());
+  return child_->AsyncGenerateIdToken(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+IAMCredentialsMetadata::AsyncSignBlob(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::SignBlobRequest const& request) {
+  SetMetadata(*context, "name=" + request.name());
+  return child_->AsyncSignBlob(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+IAMCredentialsMetadata::AsyncSignJwt(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::SignJwtRequest const& request) {
+  SetMetadata(*context, "name=" + request.name());
+  return child_->AsyncSignJwt(cq, std::move(context), request);
+}
+
 void IAMCredentialsMetadata::SetMetadata(grpc::ClientContext& context,
                                          std::string const& request_params) {
   context.AddMetadata("x-goog-request-params", request_params);
@@ -0,0 +1,150 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by the Codegen C++ plugin.
+// If you make any local changes, they will be lost.
+// source: google/iam/credentials/v1/iamcredentials.proto
+#include "google/cloud/iam/internal/iam_credentials_metrics_decorator.gcpcxx.pb.h"
+#include "google/cloud/instrumentation.h"
+#include "google/cloud/internal/metrics_wrapper.h"
+#include "google/cloud/status_or.h"
+#include <google/iam/credentials/v1/iamcredentials.grpc.pb.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace iam_internal {
+
+IAMCredentialsMetrics::IAMCredentialsMetrics(
+    std::shared_ptr<IAMCredentialsStub> child)
+    : child_(std::move(child)) {}
+
+StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>
+IAMCredentialsMetrics::GenerateAccessToken(
+    grpc::ClientContext& context,
+    ::google::iam::credentials::v1::GenerateAccessTokenRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+                 request) {
+        return child_->GenerateAccessToken(context, request);
+      },
+      context, request,
+      "google.iam.credentials.v1.IAMCredentials/GenerateAccessToken");
+}
+
+StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>
+IAMCredentialsMetrics::GenerateIdToken(
+    grpc::ClientContext& context,
+    ::google::iam::credentials::v1::GenerateIdTokenRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+                 request) { return child_->GenerateIdToken(context, request); },
+      context, request,
+      "google.iam.credentials.v1.IAMCredentials/GenerateIdToken");
+}
+
+StatusOr<::google::iam::credentials::v1::SignBlobResponse>
+IAMCredentialsMetrics::SignBlob(
+    grpc::ClientContext& context,
+    ::google::iam::credentials::v1::SignBlobRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::iam::credentials::v1::SignBlobRequest const& request) {
+        return child_->SignBlob(context, request);
+      },
+      context, request, "google.iam.credentials.v1.IAMCredentials/SignBlob");
+}
+
+StatusOr<::google::iam::credentials::v1::SignJwtResponse>
+IAMCredentialsMetrics::SignJwt(
+    grpc::ClientContext& context,
+    ::google::iam::credentials::v1::SignJwtRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::iam::credentials::v1::SignJwtRequest const& request) {
+        return child_->SignJwt(context, request);
+      },
+      context, request, "google.iam.credentials.v1.IAMCredentials/SignJwt");
+}
+
+future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+IAMCredentialsMetrics::AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::GenerateAccessTokenRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+                 request) {
+        return child_->AsyncGenerateAccessToken(cq, std::move(context),
+                                                request);
+      },
+      cq, std::move(context), request,
+      "google.iam.credentials.v1.IAMCredentials/GenerateAccessToken");
+}
+
+future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+IAMCredentialsMetrics::AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::GenerateIdTokenRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+                 request) {
+        return child_->AsyncGenerateIdToken(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.iam.credentials.v1.IAMCredentials/GenerateIdToken");
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+IAMCredentialsMetrics::AsyncSignBlob(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::SignBlobRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::credentials::v1::SignBlobRequest const& request) {
+        return child_->AsyncSignBlob(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.iam.credentials.v1.IAMCredentials/SignBlob");
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+IAMCredentialsMetrics::AsyncSignJwt(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::SignJwtRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::iam::credentials::v1::SignJwtRequest const& request) {
+        return child_->AsyncSignJwt(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.iam.credentials.v1.IAMCredentials/SignJwt");
+}
+
+}  // namespace iam_internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
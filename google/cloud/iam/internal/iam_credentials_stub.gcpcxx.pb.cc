@@ -79,6 +79,64 @@ DefaultIAMCredentialsStub::SignJwt(
   return response;
 }
 
+future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+DefaultIAMCredentialsStub::AsyncGenerateAccessToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::GenerateAccessTokenRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+                 request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncGenerateAccessToken(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+DefaultIAMCredentialsStub::AsyncGenerateIdToken(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::GenerateIdTokenRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+                 request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncGenerateIdToken(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+DefaultIAMCredentialsStub::AsyncSignBlob(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::SignBlobRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::iam::credentials::v1::SignBlobRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncSignBlob(context, request, cq);
+      },
+      request, std::move(context));
+}
+
+future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+DefaultIAMCredentialsStub::AsyncSignJwt(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::iam::credentials::v1::SignJwtRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::iam::credentials::v1::SignJwtRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncSignJwt(context, request, cq);
+      },
+      request, std::move(context));
+}
+
 }  // namespace iam_internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -18,6 +18,8 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_IAM_INTERNAL_IAM_CREDENTIALS_STUB_GCPCXX_PB_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_IAM_INTERNAL_IAM_CREDENTIALS_STUB_GCPCXX_PB_H
 
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/version.h"
 #include <google/iam/credentials/v1/iamcredentials.grpc.pb.h>
@@ -50,6 +52,34 @@ class IAMCredentialsStub {
   virtual StatusOr<::google::iam::credentials::v1::SignJwtResponse> SignJwt(
       grpc::ClientContext& context,
       ::google::iam::credentials::v1::SignJwtRequest const& request) = 0;
+
+  virtual future<StatusOr<
+      ::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request) = 0;
+
+  virtual future<StatusOr<
+      ::google::iam::credentials::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+          request) = 0;
+
+  virtual future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+  AsyncSignBlob(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::SignBlobRequest const& request) = 0;
+
+  virtual future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+  AsyncSignJwt(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::SignJwtRequest const& request) = 0;
 };
 
 class DefaultIAMCredentialsStub : public IAMCredentialsStub {
@@ -79,6 +109,32 @@ class DefaultIAMCredentialsStub : public IAMCredentialsStub {
       grpc::ClientContext& client_context,
       ::google::iam::credentials::v1::SignJwtRequest const& request) override;
 
+  future<StatusOr<::google::iam::credentials::v1::GenerateAccessTokenResponse>>
+  AsyncGenerateAccessToken(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+          request) override;
+
+  future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>
+  AsyncGenerateIdToken(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::GenerateIdTokenRequest const&
+          request) override;
+
+  future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>
+  AsyncSignBlob(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::SignBlobRequest const& request) override;
+
+  future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>
+  AsyncSignJwt(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::iam::credentials::v1::SignJwtRequest const& request) override;
+
  private:
   std::unique_ptr<::google::iam::credentials::v1::IAMCredentials::StubInterface>
       grpc_stub_;
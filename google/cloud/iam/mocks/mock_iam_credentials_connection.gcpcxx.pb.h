@@ -50,6 +50,32 @@ class MockIAMCredentialsConnection : public iam::IAMCredentialsConnection {
               SignJwt,
               (::google::iam::credentials::v1::SignJwtRequest const& request),
               (override));
+
+  MOCK_METHOD(
+      future<StatusOr<
+          ::google::iam::credentials::v1::GenerateAccessTokenResponse>>,
+      AsyncGenerateAccessToken,
+      (::google::iam::credentials::v1::GenerateAccessTokenRequest const&
+           request),
+      (override));
+
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::credentials::v1::GenerateIdTokenResponse>>,
+      AsyncGenerateIdToken,
+      (::google::iam::credentials::v1::GenerateIdTokenRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::credentials::v1::SignBlobResponse>>,
+      AsyncSignBlob,
+      (::google::iam::credentials::v1::SignBlobRequest const& request),
+      (override));
+
+  MOCK_METHOD(
+      future<StatusOr<::google::iam::credentials::v1::SignJwtResponse>>,
+      AsyncSignJwt,
+      (::google::iam::credentials::v1::SignJwtRequest const& request),
+      (override));
 };
 
 }  // namespace iam_mocks
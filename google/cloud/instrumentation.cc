@@ -0,0 +1,84 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/instrumentation.h"
+#include <atomic>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+
+struct InstrumentationState {
+  std::atomic<bool> enabled{false};
+  std::mutex mu;
+  std::shared_ptr<Instrumentation> instrumentation;  // GUARDED_BY(mu)
+};
+
+InstrumentationState& State() {
+  static auto* const kState = new InstrumentationState;
+  return *kState;
+}
+
+}  // namespace
+
+void Instrumentation::RecordRpc(RpcMetrics const& metrics) {
+  RecordDuration(metrics.rpc, metrics.latency);
+}
+
+void SetInstrumentation(std::shared_ptr<Instrumentation> instrumentation) {
+  auto& state = State();
+  std::lock_guard<std::mutex> lk(state.mu);
+  state.enabled.store(instrumentation != nullptr);
+  state.instrumentation = std::move(instrumentation);
+}
+
+namespace internal {
+
+bool InstrumentationEnabled() {
+  return State().enabled.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<Instrumentation> GetInstrumentation() {
+  if (!InstrumentationEnabled()) return nullptr;
+  auto& state = State();
+  std::lock_guard<std::mutex> lk(state.mu);
+  return state.instrumentation;
+}
+
+void RecordDuration(char const* metric, std::chrono::nanoseconds value) {
+  if (auto i = GetInstrumentation()) i->RecordDuration(metric, value);
+}
+
+void RecordValue(char const* metric, std::int64_t value) {
+  if (auto i = GetInstrumentation()) i->RecordValue(metric, value);
+}
+
+void RecordRpc(RpcMetrics const& metrics) {
+  if (auto i = GetInstrumentation()) i->RecordRpc(metrics);
+}
+
+InstrumentedSpan::InstrumentedSpan(char const* name) {
+  if (auto i = GetInstrumentation()) span_ = i->StartSpan(name);
+}
+
+InstrumentedSpan::~InstrumentedSpan() {
+  End(Status(StatusCode::kUnknown, "span abandoned"));
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
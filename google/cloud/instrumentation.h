@@ -0,0 +1,165 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INSTRUMENTATION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INSTRUMENTATION_H
+
+#include "google/cloud/status.h"
+#include "google/cloud/version.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+
+/**
+ * A span covering a unit of work, such as a single RPC attempt.
+ *
+ * Implementations typically forward to a tracing library, e.g. OpenTelemetry.
+ */
+class InstrumentationSpan {
+ public:
+  virtual ~InstrumentationSpan() = default;
+
+  /// Record a point-in-time event within the span.
+  virtual void AddEvent(char const* name) = 0;
+
+  /// Finish the span, @p status is the outcome of the work.
+  virtual void End(Status const& status) = 0;
+};
+
+/**
+ * The outcome of a single RPC, as reported by the generated stubs.
+ *
+ * Streaming RPCs also report the messages, and the size of the messages, sent
+ * and received. These are zero for unary RPCs.
+ */
+struct RpcMetrics {
+  /// The RPC name, e.g. `google.logging.v2.LoggingServiceV2/WriteLogEntries`.
+  char const* rpc = nullptr;
+  StatusCode code = StatusCode::kOk;
+  std::chrono::nanoseconds latency = std::chrono::nanoseconds(0);
+  std::int64_t messages_sent = 0;
+  std::int64_t bytes_sent = 0;
+  std::int64_t messages_received = 0;
+  std::int64_t bytes_received = 0;
+};
+
+/**
+ * Receives spans and metrics from the client libraries.
+ *
+ * Applications install an implementation with `SetInstrumentation()`. By
+ * default there is none, and the libraries only pay for a relaxed atomic load
+ * at each instrumentation point.
+ *
+ * The libraries create a span for each RPC attempt made by a retry loop, the
+ * span is named after the RPC. They also report the following metrics:
+ *
+ * - `rpc.retry.backoff`: (duration) the backoff before each retry.
+ * - `rpc.retry.attempts`: (value) the attempts made by each retry loop.
+ * - `spanner.session_pool.create`: (duration) the latency of each call to
+ *   create sessions, including retries.
+ * - `spanner.session_pool.wait`: (duration) the time spent waiting for a
+ *   session when the pool is exhausted.
+ * - `pubsub.publisher.batch_size`: (value) messages in each published batch.
+ * - `bigtable.mutation_batcher.batch_size`: (value) mutations in each batch.
+ *
+ * The stubs in the generated libraries report each RPC via `RecordRpc()`.
+ *
+ * Implementations must be thread-safe, they are called from any thread.
+ */
+class Instrumentation {
+ public:
+  virtual ~Instrumentation() = default;
+
+  /// Start a new span.
+  virtual std::unique_ptr<InstrumentationSpan> StartSpan(char const* name) = 0;
+
+  /// Record a duration sample, e.g. a backoff or a queueing delay.
+  virtual void RecordDuration(char const* metric,
+                              std::chrono::nanoseconds value) = 0;
+
+  /// Record a value sample, e.g. a batch size.
+  virtual void RecordValue(char const* metric, std::int64_t value) = 0;
+
+  /**
+   * Record the outcome of a single RPC.
+   *
+   * The default implementation records the latency as a duration named after
+   * the RPC.
+   */
+  virtual void RecordRpc(RpcMetrics const& metrics);
+};
+
+/**
+ * Install @p instrumentation for all the clients in this process.
+ *
+ * Use `nullptr` to disable the instrumentation.
+ */
+void SetInstrumentation(std::shared_ptr<Instrumentation> instrumentation);
+
+namespace internal {
+
+/// Return true if there is any instrumentation installed.
+bool InstrumentationEnabled();
+
+/// Return the current instrumentation, `nullptr` if there is none.
+std::shared_ptr<Instrumentation> GetInstrumentation();
+
+/// Record a duration, if there is any instrumentation installed.
+void RecordDuration(char const* metric, std::chrono::nanoseconds value);
+
+/// Record a value, if there is any instrumentation installed.
+void RecordValue(char const* metric, std::int64_t value);
+
+/// Record the outcome of an RPC, if there is any instrumentation installed.
+void RecordRpc(RpcMetrics const& metrics);
+
+/**
+ * A span that does nothing unless instrumentation is installed.
+ *
+ * Spans that are not explicitly ended are ended with an error when destroyed.
+ */
+class InstrumentedSpan {
+ public:
+  /// A span that was never started.
+  InstrumentedSpan() = default;
+  explicit InstrumentedSpan(char const* name);
+  ~InstrumentedSpan();
+
+  InstrumentedSpan(InstrumentedSpan&&) = default;
+  InstrumentedSpan& operator=(InstrumentedSpan&&) = default;
+
+  void AddEvent(char const* name) {
+    if (span_) span_->AddEvent(name);
+  }
+
+  void End(Status const& status) {
+    if (!span_) return;
+    span_->End(status);
+    span_.reset();
+  }
+
+ private:
+  std::unique_ptr<InstrumentationSpan> span_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INSTRUMENTATION_H
@@ -0,0 +1,107 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/instrumentation.h"
+#include "google/cloud/testing_util/capture_instrumentation.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(InstrumentationTest, DisabledByDefault) {
+  EXPECT_FALSE(internal::InstrumentationEnabled());
+  EXPECT_EQ(nullptr, internal::GetInstrumentation());
+  // These are no-ops, and must not crash.
+  internal::RecordValue("test.value", 42);
+  internal::RecordDuration("test.duration", std::chrono::seconds(1));
+  internal::InstrumentedSpan span("test-span");
+  span.AddEvent("event");
+  span.End(Status());
+}
+
+TEST(InstrumentationTest, Enabled) {
+  auto capture = std::make_shared<testing_util::CaptureInstrumentation>();
+  SetInstrumentation(capture);
+  EXPECT_TRUE(internal::InstrumentationEnabled());
+
+  internal::RecordValue("test.value", 42);
+  internal::RecordDuration("test.duration", std::chrono::seconds(1));
+  {
+    internal::InstrumentedSpan span("test-span");
+    span.AddEvent("event");
+    span.End(Status(StatusCode::kUnavailable, "try-again"));
+  }
+  { internal::InstrumentedSpan abandoned("abandoned"); }
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre("value:test.value=42", "duration:test.duration",
+                          "start:test-span", "event:test-span:event",
+                          "end:test-span:UNAVAILABLE", "start:abandoned",
+                          "end:abandoned:UNKNOWN"));
+
+  SetInstrumentation(nullptr);
+  EXPECT_FALSE(internal::InstrumentationEnabled());
+  internal::RecordValue("test.value", 42);
+  EXPECT_THAT(capture->ClearEvents(), IsEmpty());
+}
+
+TEST(InstrumentationTest, RecordRpc) {
+  auto capture = std::make_shared<testing_util::CaptureInstrumentation>();
+  SetInstrumentation(capture);
+
+  RpcMetrics unary;
+  unary.rpc = "test.Service/Unary";
+  unary.code = StatusCode::kNotFound;
+  internal::RecordRpc(unary);
+  RpcMetrics stream;
+  stream.rpc = "test.Service/Stream";
+  stream.messages_sent = 1;
+  stream.bytes_sent = 10;
+  stream.messages_received = 2;
+  stream.bytes_received = 20;
+  internal::RecordRpc(stream);
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre(
+                  "rpc:test.Service/Unary:NOT_FOUND",
+                  "rpc:test.Service/Stream:OK:sent=1/10:received=2/20"));
+  SetInstrumentation(nullptr);
+}
+
+/// An instrumentation that does not override `RecordRpc()`.
+class DurationsOnly : public testing_util::CaptureInstrumentation {
+ public:
+  void RecordRpc(RpcMetrics const& metrics) override {
+    Instrumentation::RecordRpc(metrics);
+  }
+};
+
+TEST(InstrumentationTest, RecordRpcDefault) {
+  auto capture = std::make_shared<DurationsOnly>();
+  SetInstrumentation(capture);
+  RpcMetrics metrics;
+  metrics.rpc = "test.Service/Unary";
+  internal::RecordRpc(metrics);
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre("duration:test.Service/Unary"));
+  SetInstrumentation(nullptr);
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
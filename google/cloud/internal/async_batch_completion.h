@@ -0,0 +1,59 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_BATCH_COMPLETION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_BATCH_COMPLETION_H
+
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
+#include "google/cloud/version.h"
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Satisfies all of @p promises with copies of @p value, in a single
+ * `CompletionQueue` task.
+ *
+ * Satisfying a promise may run its continuations inline, so callers holding
+ * locks often defer the work to the completion queue. Scheduling one task per
+ * promise is expensive when a batch of many messages or mutations completes at
+ * once. This function schedules a single task that satisfies all the promises
+ * in order.
+ */
+template <typename T>
+void AsyncSetValues(CompletionQueue& cq, std::vector<promise<T>> promises,
+                    T value) {
+  if (promises.empty()) return;
+  // C++11 lacks init-captures, use a struct to move the vector into the task.
+  struct MoveCapture {
+    std::vector<promise<T>> promises;
+    T value;
+    void operator()() {
+      for (auto& p : promises) p.set_value(value);
+    }
+  };
+  cq.RunAsync(MoveCapture{std::move(promises), std::move(value)});
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_BATCH_COMPLETION_H
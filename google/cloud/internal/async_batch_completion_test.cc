@@ -0,0 +1,63 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/async_batch_completion.h"
+#include "google/cloud/testing_util/fake_completion_queue_impl.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::FakeCompletionQueueImpl;
+
+TEST(AsyncBatchCompletionTest, SingleTask) {
+  auto mock = std::make_shared<FakeCompletionQueueImpl>();
+  CompletionQueue cq(mock);
+
+  auto constexpr kCount = 1000;
+  std::vector<promise<StatusOr<int>>> promises(kCount);
+  std::vector<future<StatusOr<int>>> futures;
+  for (auto& p : promises) futures.push_back(p.get_future());
+
+  AsyncSetValues(cq, std::move(promises), StatusOr<int>(42));
+  EXPECT_EQ(1, mock->size());
+  for (auto& f : futures) {
+    EXPECT_NE(std::future_status::ready,
+              f.wait_for(std::chrono::milliseconds(0)));
+  }
+
+  mock->SimulateCompletion(true);
+  EXPECT_EQ(0, mock->size());
+  for (auto& f : futures) {
+    auto v = f.get();
+    ASSERT_TRUE(v.ok());
+    EXPECT_EQ(42, *v);
+  }
+}
+
+TEST(AsyncBatchCompletionTest, Empty) {
+  auto mock = std::make_shared<FakeCompletionQueueImpl>();
+  CompletionQueue cq(mock);
+  AsyncSetValues(cq, std::vector<promise<Status>>{}, Status());
+  EXPECT_EQ(0, mock->size());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -158,7 +158,9 @@ class AsyncReadStreamImpl
     };
 
     context_ = std::move(context);
-    cq_ = std::move(cq);
+    // All the operations in the stream must use the same gRPC completion
+    // queue.
+    cq_ = PickShard(std::move(cq));
     auto callback = std::make_shared<NotifyStart>(this->shared_from_this());
     cq_->StartOperation(std::move(callback), [&](void* tag) {
       // @note If the the `CompletionQueue` has been `Shutdown()` this lambda is
@@ -152,6 +152,35 @@ class AsyncStreamingReadWriteRpcImpl
       stream_;
 };
 
+/**
+ * An asynchronous streaming read/write RPC that fails immediately.
+ *
+ * Used when a stream cannot be created, for example, when a connection does
+ * not implement a bidirectional streaming method. All the operations fail, and
+ * `Finish()` returns the status given in the constructor.
+ */
+template <typename Request, typename Response>
+class AsyncStreamingReadWriteRpcError
+    : public AsyncStreamingReadWriteRpc<Request, Response> {
+ public:
+  explicit AsyncStreamingReadWriteRpcError(Status status)
+      : status_(std::move(status)) {}
+
+  void Cancel() override {}
+  future<bool> Start() override { return make_ready_future(false); }
+  future<absl::optional<Response>> Read() override {
+    return make_ready_future(absl::optional<Response>{});
+  }
+  future<bool> Write(Request const&, grpc::WriteOptions) override {
+    return make_ready_future(false);
+  }
+  future<bool> WritesDone() override { return make_ready_future(false); }
+  future<Status> Finish() override { return make_ready_future(status_); }
+
+ private:
+  Status status_;
+};
+
 template <typename Request, typename Response>
 using PrepareAsyncReadWriteRpc = absl::FunctionRef<
     std::unique_ptr<grpc::ClientAsyncReaderWriterInterface<Request, Response>>(
@@ -172,7 +201,8 @@ std::unique_ptr<AsyncStreamingReadWriteRpc<Request, Response>>
 MakeStreamingReadWriteRpc(
     CompletionQueue& cq, std::unique_ptr<grpc::ClientContext> context,
     PrepareAsyncReadWriteRpc<Request, Response> async_call) {
-  auto cq_impl = GetCompletionQueueImpl(cq);
+  // All the operations in the stream must use the same gRPC completion queue.
+  auto cq_impl = PickShard(GetCompletionQueueImpl(cq));
   auto stream = async_call(context.get(), &cq_impl->cq());
   return absl::make_unique<AsyncStreamingReadWriteRpcImpl<Request, Response>>(
       std::move(cq_impl), std::move(context), std::move(stream));
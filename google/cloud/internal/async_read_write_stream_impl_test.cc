@@ -162,6 +162,16 @@ TEST(AsyncReadWriteStreamingRpcTest, Basic) {
   EXPECT_THAT(finish.get(), StatusIs(StatusCode::kOk));
 }
 
+TEST(AsyncReadWriteStreamingRpcTest, Error) {
+  AsyncStreamingReadWriteRpcError<FakeRequest, FakeResponse> stream(
+      Status(StatusCode::kUnimplemented, "not implemented"));
+  EXPECT_FALSE(stream.Start().get());
+  EXPECT_FALSE(stream.Write(FakeRequest{"k"}, grpc::WriteOptions()).get());
+  EXPECT_FALSE(stream.Read().get().has_value());
+  EXPECT_FALSE(stream.WritesDone().get());
+  EXPECT_THAT(stream.Finish().get(), StatusIs(StatusCode::kUnimplemented));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
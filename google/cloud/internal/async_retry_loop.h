@@ -16,9 +16,12 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_RETRY_LOOP_H
 
 #include "google/cloud/backoff_policy.h"
+#include "google/cloud/cancellation.h"
 #include "google/cloud/completion_queue.h"
 #include "google/cloud/future.h"
+#include "google/cloud/instrumentation.h"
 #include "google/cloud/internal/invoke_result.h"
+#include "google/cloud/internal/policy_holder.h"
 #include "google/cloud/internal/retry_loop_helpers.h"
 #include "google/cloud/internal/retry_policy.h"
 #include "google/cloud/version.h"
@@ -57,15 +60,26 @@ struct FutureValueType<future<T>> {
  * implementation of these stubs is very easy too.
  *
  * This class implements the retry loop for such an RPC.
+ *
+ * The retry and backoff policies are held either by pointer (the default), or
+ * by value when the caller knows their concrete types, see `RetryLoop()`.
+ *
+ * The loop can be cancelled through the returned future, or through the
+ * `CancellationToken` current when the loop starts, if any. Either way the
+ * pending attempt or backoff timer is cancelled, and the loop does not start
+ * new attempts.
  */
-template <typename Functor, typename Request>
-class AsyncRetryLoopImpl : public std::enable_shared_from_this<
-                               AsyncRetryLoopImpl<Functor, Request>> {
+template <typename Functor, typename Request,
+          typename RetryPolicyType = std::unique_ptr<RetryPolicy>,
+          typename BackoffPolicyType = std::unique_ptr<BackoffPolicy>>
+class AsyncRetryLoopImpl
+    : public std::enable_shared_from_this<AsyncRetryLoopImpl<
+          Functor, Request, RetryPolicyType, BackoffPolicyType>> {
  public:
-  AsyncRetryLoopImpl(std::unique_ptr<RetryPolicy> retry_policy,
-                     std::unique_ptr<BackoffPolicy> backoff_policy,
-                     Idempotency idempotency, google::cloud::CompletionQueue cq,
-                     Functor&& functor, Request request, char const* location)
+  AsyncRetryLoopImpl(RetryPolicyType retry_policy,
+                     BackoffPolicyType backoff_policy, Idempotency idempotency,
+                     google::cloud::CompletionQueue cq, Functor&& functor,
+                     Request request, char const* location)
       : retry_policy_(std::move(retry_policy)),
         backoff_policy_(std::move(backoff_policy)),
         idempotency_(idempotency),
@@ -84,6 +98,11 @@ class AsyncRetryLoopImpl : public std::enable_shared_from_this<
     result_ = promise<T>([weak] {
       if (auto self = weak.lock()) self->Cancel();
     });
+    token_ = CurrentCancellationToken();
+    cancel_registration_ = CancellationRegistration(token_, [weak] {
+      if (auto self = weak.lock()) self->Cancel();
+    });
+    if (Cancelled()) return result_.get_future();
 
     StartAttempt();
     return result_.get_future();
@@ -97,12 +116,14 @@ class AsyncRetryLoopImpl : public std::enable_shared_from_this<
   };
 
   void StartAttempt() {
-    if (retry_policy_->IsExhausted()) {
+    if (PolicyRef(retry_policy_).IsExhausted()) {
       SetDone(
           RetryLoopError("Retry policy exhausted in", location_, last_status_));
       return;
     }
     auto self = this->shared_from_this();
+    span_ = InstrumentedSpan(location_);
+    ++attempts_;
     auto op = functor_(cq_, absl::make_unique<grpc::ClientContext>(), request_)
                   .then([self](future<T> f) { self->OnAttempt(f.get()); });
     SetWaiting(std::move(op));
@@ -112,18 +133,22 @@ class AsyncRetryLoopImpl : public std::enable_shared_from_this<
     SetIdle();
     // A successful attempt, set the value and finish the loop.
     if (result.ok()) {
+      span_.End(Status{});
+      PolicyRef(retry_policy_).OnSuccess();
       SetDone(std::move(result));
       return;
     }
     // Some kind of failure, first verify that it is retryable.
     last_status_ = GetResultStatus(std::move(result));
+    failed_ = true;
+    span_.End(last_status_);
     if (idempotency_ == Idempotency::kNonIdempotent) {
       SetDone(RetryLoopError("Error in non-idempotent operation", location_,
                              last_status_));
       return;
     }
-    if (!retry_policy_->OnFailure(last_status_)) {
-      if (retry_policy_->IsPermanentFailure(last_status_)) {
+    if (!PolicyRef(retry_policy_).OnFailure(last_status_)) {
+      if (PolicyRef(retry_policy_).IsPermanentFailure(last_status_)) {
         SetDone(RetryLoopError("Permanent error in", location_, last_status_));
       } else {
         SetDone(RetryLoopError("Retry policy exhausted in", location_,
@@ -133,13 +158,12 @@ class AsyncRetryLoopImpl : public std::enable_shared_from_this<
     }
     if (Cancelled()) return;
     auto self = this->shared_from_this();
-    auto op =
-        cq_.MakeRelativeTimer(backoff_policy_->OnCompletion())
-            .then(
-                [self](
-                    future<StatusOr<std::chrono::system_clock::time_point>> f) {
-                  self->OnBackoffTimer(f.get());
-                });
+    auto const delay = PolicyRef(backoff_policy_).OnCompletion();
+    RecordDuration("rpc.retry.backoff", delay);
+    auto op = cq_.MakeRelativeTimer(delay).then(
+        [self](future<StatusOr<std::chrono::system_clock::time_point>> f) {
+          self->OnBackoffTimer(f.get());
+        });
     SetWaiting(std::move(op));
   }
 
@@ -148,9 +172,7 @@ class AsyncRetryLoopImpl : public std::enable_shared_from_this<
     if (!tp) {
       if (Cancelled()) {
         // The retry loop has been canceled and that cancelled the timer.
-        SetDone(
-            RetryLoopError("Retry loop cancelled", location_, last_status_));
-
+        SetDone(CancelledError());
       } else {
         // Some kind of error in the CompletionQueue, probably shutting down.
         SetDone(RetryLoopError("Timer failure in", location_,
@@ -186,6 +208,7 @@ class AsyncRetryLoopImpl : public std::enable_shared_from_this<
     if (state_ == kDone) return;
     state_ = kDone;
     lk.unlock();
+    RecordValue("rpc.retry.attempts", attempts_);
     result_.set_value(std::move(value));
   }
 
@@ -204,43 +227,56 @@ class AsyncRetryLoopImpl : public std::enable_shared_from_this<
     if (!cancelled_) return false;
     state_ = kDone;
     lk.unlock();
-    result_.set_value(
-        RetryLoopError("Retry loop cancelled", location_, last_status_));
+    result_.set_value(CancelledError());
     return true;
   }
 
-  std::unique_ptr<RetryPolicy> retry_policy_;
-  std::unique_ptr<BackoffPolicy> backoff_policy_;
+  Status CancelledError() const {
+    if (IsCancelled(token_)) {
+      return RetryLoopCancelled(location_, failed_ ? last_status_ : Status{});
+    }
+    return RetryLoopError("Retry loop cancelled", location_, last_status_);
+  }
+
+  RetryPolicyType retry_policy_;
+  BackoffPolicyType backoff_policy_;
   Idempotency idempotency_ = Idempotency::kNonIdempotent;
   google::cloud::CompletionQueue cq_;
   absl::decay_t<Functor> functor_;
   Request request_;
   char const* location_ = "unknown";
   Status last_status_ = Status(StatusCode::kUnknown, "Retry policy exhausted");
+  bool failed_ = false;
   promise<T> result_;
   std::mutex mu_;
   State state_ = kIdle;
   bool cancelled_ = false;
   future<void> pending_operation_;
+  InstrumentedSpan span_;
+  std::int64_t attempts_ = 0;
+  absl::optional<CancellationToken> token_;
+  CancellationRegistration cancel_registration_;
 };
 
 /**
  * Create the right AsyncRetryLoopImpl object and start the retry loop on it.
  */
-template <typename Functor, typename Request,
+template <typename RetryPolicyType, typename BackoffPolicyType,
+          typename Functor, typename Request,
           typename std::enable_if<
               google::cloud::internal::is_invocable<
                   Functor, google::cloud::CompletionQueue&,
                   std::unique_ptr<grpc::ClientContext>, Request const&>::value,
               int>::type = 0>
-auto AsyncRetryLoop(std::unique_ptr<RetryPolicy> retry_policy,
-                    std::unique_ptr<BackoffPolicy> backoff_policy,
-                    Idempotency idempotency, google::cloud::CompletionQueue cq,
-                    Functor&& functor, Request request, char const* location)
+auto AsyncRetryLoop(RetryPolicyType retry_policy,
+                    BackoffPolicyType backoff_policy, Idempotency idempotency,
+                    google::cloud::CompletionQueue cq, Functor&& functor,
+                    Request request, char const* location)
     -> google::cloud::internal::invoke_result_t<
         Functor, google::cloud::CompletionQueue&,
         std::unique_ptr<grpc::ClientContext>, Request const&> {
-  auto loop = std::make_shared<AsyncRetryLoopImpl<Functor, Request>>(
+  auto loop = std::make_shared<AsyncRetryLoopImpl<
+      Functor, Request, RetryPolicyType, BackoffPolicyType>>(
       std::move(retry_policy), std::move(backoff_policy), idempotency,
       std::move(cq), std::forward<Functor>(functor), std::move(request),
       location);
@@ -14,6 +14,7 @@
 
 #include "google/cloud/internal/async_retry_loop.h"
 #include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/testing_util/capture_instrumentation.h"
 #include "google/cloud/testing_util/fake_completion_queue_impl.h"
 #include "google/cloud/testing_util/status_matchers.h"
 #include <gmock/gmock.h>
@@ -27,6 +28,7 @@ namespace {
 
 using ::google::cloud::testing_util::StatusIs;
 using ::testing::AllOf;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Return;
 
@@ -128,6 +130,55 @@ TEST(AsyncRetryLoopTest, TransientThenSuccess) {
   EXPECT_EQ(84, *actual);
 }
 
+TEST(AsyncRetryLoopTest, PoliciesByValue) {
+  int counter = 0;
+  AutomaticallyCreatedBackgroundThreads background;
+  StatusOr<int> actual =
+      AsyncRetryLoop(
+          LimitedErrorCountRetryPolicy<TestRetryablePolicy>(2),
+          ExponentialBackoffPolicy(std::chrono::microseconds(1),
+                                   std::chrono::microseconds(5), 2.0),
+          Idempotency::kIdempotent, background.cq(),
+          [&](google::cloud::CompletionQueue&,
+              std::unique_ptr<grpc::ClientContext>, int) {
+            ++counter;
+            return make_ready_future(
+                StatusOr<int>(Status(StatusCode::kUnavailable, "try again")));
+          },
+          42, "error message")
+          .get();
+  EXPECT_THAT(actual.status(), StatusIs(StatusCode::kUnavailable,
+                                        HasSubstr("Retry policy exhausted")));
+  EXPECT_EQ(3, counter);
+}
+
+TEST(AsyncRetryLoopTest, Instrumentation) {
+  auto capture = std::make_shared<testing_util::CaptureInstrumentation>();
+  SetInstrumentation(capture);
+  int counter = 0;
+  AutomaticallyCreatedBackgroundThreads background;
+  StatusOr<int> actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), Idempotency::kIdempotent,
+          background.cq(),
+          [&](google::cloud::CompletionQueue&,
+              std::unique_ptr<grpc::ClientContext>, int request) {
+            if (++counter < 2) {
+              return make_ready_future(
+                  StatusOr<int>(Status(StatusCode::kUnavailable, "try again")));
+            }
+            return make_ready_future(StatusOr<int>(2 * request));
+          },
+          42, "Test")
+          .get();
+  SetInstrumentation(nullptr);
+  ASSERT_THAT(actual.status(), StatusIs(StatusCode::kOk));
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre("start:Test", "end:Test:UNAVAILABLE",
+                          "duration:rpc.retry.backoff", "start:Test",
+                          "end:Test:OK", "value:rpc.retry.attempts=2"));
+}
+
 TEST(AsyncRetryLoopTest, ReturnJustStatus) {
   int counter = 0;
   AutomaticallyCreatedBackgroundThreads background;
@@ -391,6 +442,79 @@ TEST_F(AsyncRetryLoopCancelTest, ShutdownDuringTimer) {
                                     HasSubstr("test-location"))));
 }
 
+TEST_F(AsyncRetryLoopCancelTest, TokenCancelledBeforeStart) {
+  CancellationToken token;
+  token.Cancel();
+  CancellationScope scope(token);
+  auto fake = std::make_shared<testing_util::FakeCompletionQueueImpl>();
+  google::cloud::CompletionQueue cq(fake);
+  future<StatusOr<int>> actual = AsyncRetryLoop(
+      TestRetryPolicy(), TestBackoffPolicy(), Idempotency::kIdempotent, cq,
+      [this](google::cloud::CompletionQueue&,
+             std::unique_ptr<grpc::ClientContext>,
+             int x) { return SimulateRequest(x); },
+      42, "test-location");
+  EXPECT_THAT(actual.get(),
+              StatusIs(StatusCode::kCancelled,
+                       AllOf(HasSubstr("Retry loop cancelled"),
+                             HasSubstr("test-location"))));
+  EXPECT_EQ(0, CancelCount());
+}
+
+TEST_F(AsyncRetryLoopCancelTest, TokenCancelDuringRequest) {
+  CancellationToken token;
+  future<StatusOr<int>> actual;
+  auto fake = std::make_shared<testing_util::FakeCompletionQueueImpl>();
+  google::cloud::CompletionQueue cq(fake);
+  {
+    // The loop captures the token when it starts, the scope can end before
+    // the loop completes.
+    CancellationScope scope(token);
+    actual = AsyncRetryLoop(
+        TestRetryPolicy(), TestBackoffPolicy(), Idempotency::kIdempotent, cq,
+        [this](google::cloud::CompletionQueue&,
+               std::unique_ptr<grpc::ClientContext>,
+               int x) { return SimulateRequest(x); },
+        42, "test-location");
+  }
+
+  auto p = WaitForRequest();
+  EXPECT_EQ(0, CancelCount());
+  token.Cancel();
+  EXPECT_EQ(1, CancelCount());
+  p.set_value(Status(StatusCode::kUnavailable, "try-again"));
+  EXPECT_THAT(actual.get(),
+              StatusIs(StatusCode::kCancelled,
+                       AllOf(HasSubstr("try-again"),
+                             HasSubstr("Retry loop cancelled"),
+                             HasSubstr("test-location"))));
+}
+
+TEST_F(AsyncRetryLoopCancelTest, TokenCancelDuringTimer) {
+  using ms = std::chrono::milliseconds;
+  CancellationToken token;
+  CancellationScope scope(token);
+  auto fake = std::make_shared<testing_util::FakeCompletionQueueImpl>();
+  google::cloud::CompletionQueue cq(fake);
+  future<StatusOr<int>> actual = AsyncRetryLoop(
+      TestRetryPolicy(), ExponentialBackoffPolicy(ms(2000), ms(8000), 2.0),
+      Idempotency::kIdempotent, cq,
+      [this](google::cloud::CompletionQueue&,
+             std::unique_ptr<grpc::ClientContext>,
+             int x) { return SimulateRequest(x); },
+      42, "test-location");
+
+  auto p = WaitForRequest();
+  p.set_value(Status(StatusCode::kUnavailable, "try-again"));
+  token.Cancel();
+  fake->SimulateCompletion(/*ok=*/false);
+  EXPECT_THAT(actual.get(),
+              StatusIs(StatusCode::kCancelled,
+                       AllOf(HasSubstr("try-again"),
+                             HasSubstr("Retry loop cancelled"),
+                             HasSubstr("test-location"))));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
@@ -0,0 +1,103 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_FAULT_INJECTION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_FAULT_INJECTION_H
+
+#include "google/cloud/internal/async_read_write_stream_impl.h"
+#include "google/cloud/internal/fault_injector.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include "google/cloud/version.h"
+#include "absl/types/optional.h"
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Fault injection decorator for AsyncStreamingReadWriteRpc.
+ *
+ * An injected error fails `Start()` without starting the stream. A stream
+ * reset cancels the stream and fails the `Read()`. In both cases `Finish()`
+ * returns the injected error.
+ */
+template <typename Request, typename Response>
+class AsyncStreamingReadWriteRpcFaultInjection
+    : public AsyncStreamingReadWriteRpc<Request, Response> {
+ public:
+  AsyncStreamingReadWriteRpcFaultInjection(
+      std::unique_ptr<AsyncStreamingReadWriteRpc<Request, Response>> stream,
+      std::shared_ptr<FaultInjector> injector)
+      : stream_(std::move(stream)), injector_(std::move(injector)) {}
+  ~AsyncStreamingReadWriteRpcFaultInjection() override = default;
+
+  void Cancel() override { stream_->Cancel(); }
+
+  future<bool> Start() override {
+    auto status = injector_->NextError("Start");
+    if (!status.ok()) {
+      started_ = false;
+      injected_ = std::move(status);
+      return make_ready_future(false);
+    }
+    return stream_->Start();
+  }
+
+  future<absl::optional<Response>> Read() override {
+    if (!injector_->NextStreamReset()) return stream_->Read();
+    injected_ = injector_->StreamResetError("Read");
+    stream_->Cancel();
+    return stream_->Read().then([](future<absl::optional<Response>> f) {
+      f.get();
+      return absl::optional<Response>{};
+    });
+  }
+
+  future<bool> Write(Request const& request,
+                     grpc::WriteOptions options) override {
+    if (!started_) return make_ready_future(false);
+    return stream_->Write(request, std::move(options));
+  }
+
+  future<bool> WritesDone() override {
+    if (!started_) return make_ready_future(false);
+    return stream_->WritesDone();
+  }
+
+  future<Status> Finish() override {
+    if (!started_) return make_ready_future(injected_);
+    if (injected_.ok()) return stream_->Finish();
+    auto injected = injected_;
+    return stream_->Finish().then([injected](future<Status> f) {
+      f.get();
+      return injected;
+    });
+  }
+
+ private:
+  std::unique_ptr<AsyncStreamingReadWriteRpc<Request, Response>> stream_;
+  std::shared_ptr<FaultInjector> injector_;
+  bool started_ = true;
+  Status injected_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_FAULT_INJECTION_H
@@ -0,0 +1,110 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/async_streaming_read_write_rpc_fault_injection.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+
+using Request = google::protobuf::Timestamp;
+using Response = google::protobuf::Duration;
+
+class MockAsyncStreamingReadWriteRpc
+    : public AsyncStreamingReadWriteRpc<Request, Response> {
+ public:
+  ~MockAsyncStreamingReadWriteRpc() override = default;
+  MOCK_METHOD(void, Cancel, (), (override));
+  MOCK_METHOD(future<bool>, Start, (), (override));
+  MOCK_METHOD(future<absl::optional<Response>>, Read, (), (override));
+  MOCK_METHOD(future<bool>, Write, (Request const&, grpc::WriteOptions),
+              (override));
+  MOCK_METHOD(future<bool>, WritesDone, (), (override));
+  MOCK_METHOD(future<Status>, Finish, (), (override));
+};
+
+using Tested = AsyncStreamingReadWriteRpcFaultInjection<Request, Response>;
+
+TEST(AsyncStreamingReadWriteRpcFaultInjectionTest, Disabled) {
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Start).WillOnce([] { return make_ready_future(true); });
+  EXPECT_CALL(*mock, Write(_, _))
+      .WillOnce([](Request const&, grpc::WriteOptions) {
+        return make_ready_future(true);
+      });
+  EXPECT_CALL(*mock, Read).WillOnce([] {
+    return make_ready_future(absl::make_optional(Response{}));
+  });
+  EXPECT_CALL(*mock, WritesDone).WillOnce([] {
+    return make_ready_future(true);
+  });
+  EXPECT_CALL(*mock, Finish).WillOnce([] {
+    return make_ready_future(Status{});
+  });
+  Tested stream(std::move(mock),
+                std::make_shared<FaultInjector>(FaultInjectionOptions{}));
+  EXPECT_TRUE(stream.Start().get());
+  EXPECT_TRUE(stream.Write(Request{}, grpc::WriteOptions()).get());
+  EXPECT_TRUE(stream.Read().get().has_value());
+  EXPECT_TRUE(stream.WritesDone().get());
+  EXPECT_STATUS_OK(stream.Finish().get());
+}
+
+TEST(AsyncStreamingReadWriteRpcFaultInjectionTest, StartError) {
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Start).Times(0);
+  EXPECT_CALL(*mock, Write).Times(0);
+  EXPECT_CALL(*mock, Finish).Times(0);
+  Tested stream(std::move(mock),
+                std::make_shared<FaultInjector>(
+                    FaultInjectionOptions{}.set_error_rate(1.0)));
+  EXPECT_FALSE(stream.Start().get());
+  EXPECT_FALSE(stream.Write(Request{}, grpc::WriteOptions()).get());
+  EXPECT_THAT(stream.Finish().get(), StatusIs(StatusCode::kUnavailable));
+}
+
+TEST(AsyncStreamingReadWriteRpcFaultInjectionTest, StreamReset) {
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Start).WillOnce([] { return make_ready_future(true); });
+  EXPECT_CALL(*mock, Cancel).Times(1);
+  EXPECT_CALL(*mock, Read).WillOnce([] {
+    return make_ready_future(absl::make_optional(Response{}));
+  });
+  EXPECT_CALL(*mock, Finish).WillOnce([] {
+    return make_ready_future(Status(StatusCode::kCancelled, "cancelled"));
+  });
+  Tested stream(std::move(mock),
+                std::make_shared<FaultInjector>(
+                    FaultInjectionOptions{}.set_stream_reset_rate(1.0)));
+  EXPECT_TRUE(stream.Start().get());
+  EXPECT_FALSE(stream.Read().get().has_value());
+  EXPECT_THAT(stream.Finish().get(), StatusIs(StatusCode::kUnavailable));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,134 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_LOGGING_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_LOGGING_H
+
+#include "google/cloud/internal/async_read_write_stream_impl.h"
+#include "google/cloud/internal/log_wrapper.h"
+#include "google/cloud/future.h"
+#include "google/cloud/log.h"
+#include "google/cloud/status.h"
+#include "google/cloud/tracing_options.h"
+#include "google/cloud/version.h"
+#include "absl/types/optional.h"
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Logging decorator for AsyncStreamingReadWriteRpc.
+ */
+template <typename Request, typename Response>
+class AsyncStreamingReadWriteRpcLogging
+    : public AsyncStreamingReadWriteRpc<Request, Response> {
+ public:
+  AsyncStreamingReadWriteRpcLogging(
+      std::unique_ptr<AsyncStreamingReadWriteRpc<Request, Response>> stream,
+      TracingOptions tracing_options, std::string request_id)
+      : stream_(std::move(stream)),
+        tracing_options_(std::move(tracing_options)),
+        request_id_(std::move(request_id)) {}
+  ~AsyncStreamingReadWriteRpcLogging() override = default;
+
+  void Cancel() override {
+    auto prefix = std::string(__func__) + "(" + request_id_ + ")";
+    GCP_LOG(DEBUG) << prefix << " <<";
+    stream_->Cancel();
+    GCP_LOG(DEBUG) << prefix << " >>";
+  }
+
+  future<bool> Start() override {
+    auto prefix = std::string(__func__) + "(" + request_id_ + ")";
+    GCP_LOG(DEBUG) << prefix << " <<";
+    return stream_->Start().then([prefix](future<bool> f) {
+      auto r = f.get();
+      GCP_LOG(DEBUG) << prefix << " >> response=" << r;
+      return r;
+    });
+  }
+
+  future<absl::optional<Response>> Read() override {
+    auto prefix = std::string(__func__) + "(" + request_id_ + ")";
+    GCP_LOG(DEBUG) << prefix << " <<";
+    auto options = tracing_options_;
+    return stream_->Read().then(
+        [prefix, options](future<absl::optional<Response>> f) {
+          auto response = f.get();
+          if (!response) {
+            GCP_LOG(DEBUG) << prefix << " >> response={}";
+          } else {
+            GCP_LOG(DEBUG) << prefix << " >> response="
+                           << DebugString(*response, options);
+          }
+          return response;
+        });
+  }
+
+  future<bool> Write(Request const& request,
+                     grpc::WriteOptions options) override {
+    auto prefix = std::string(__func__) + "(" + request_id_ + ")";
+    GCP_LOG(DEBUG) << prefix
+                   << " << request=" << DebugString(request, tracing_options_)
+                   << ", options={is_write_through="
+                   << options.is_write_through()
+                   << ", is_last_message=" << options.is_last_message()
+                   << ", is_corked=" << options.is_corked()
+                   << ", buffer_hint=" << options.get_buffer_hint()
+                   << ", no_compression=" << options.get_no_compression()
+                   << "}";
+    return stream_->Write(request, std::move(options))
+        .then([prefix](future<bool> f) {
+          auto r = f.get();
+          GCP_LOG(DEBUG) << prefix << " >> response=" << r;
+          return r;
+        });
+  }
+
+  future<bool> WritesDone() override {
+    auto prefix = std::string(__func__) + "(" + request_id_ + ")";
+    GCP_LOG(DEBUG) << prefix << " <<";
+    return stream_->WritesDone().then([prefix](future<bool> f) {
+      auto r = f.get();
+      GCP_LOG(DEBUG) << prefix << " >> response=" << r;
+      return r;
+    });
+  }
+
+  future<Status> Finish() override {
+    auto prefix = std::string(__func__) + "(" + request_id_ + ")";
+    GCP_LOG(DEBUG) << prefix << " <<";
+    return stream_->Finish().then([prefix](future<Status> f) {
+      auto r = f.get();
+      GCP_LOG(DEBUG) << prefix << " >> status=" << r;
+      return r;
+    });
+  }
+
+ private:
+  std::unique_ptr<AsyncStreamingReadWriteRpc<Request, Response>> stream_;
+  TracingOptions tracing_options_;
+  std::string request_id_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_LOGGING_H
@@ -0,0 +1,153 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/async_streaming_read_write_rpc_logging.h"
+#include "google/cloud/log.h"
+#include "google/cloud/status.h"
+#include "google/cloud/testing_util/capture_log_lines_backend.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "google/cloud/tracing_options.h"
+#include "absl/memory/memory.h"
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::Contains;
+using ::testing::HasSubstr;
+
+using Request = google::protobuf::Timestamp;
+using Response = google::protobuf::Duration;
+
+class MockAsyncStreamingReadWriteRpc
+    : public AsyncStreamingReadWriteRpc<Request, Response> {
+ public:
+  ~MockAsyncStreamingReadWriteRpc() override = default;
+  MOCK_METHOD(void, Cancel, (), (override));
+  MOCK_METHOD(future<bool>, Start, (), (override));
+  MOCK_METHOD(future<absl::optional<Response>>, Read, (), (override));
+  MOCK_METHOD(future<bool>, Write, (Request const&, grpc::WriteOptions),
+              (override));
+  MOCK_METHOD(future<bool>, WritesDone, (), (override));
+  MOCK_METHOD(future<Status>, Finish, (), (override));
+};
+
+class AsyncStreamingReadWriteRpcLoggingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    backend_ =
+        std::make_shared<google::cloud::testing_util::CaptureLogLinesBackend>();
+    logger_id_ = google::cloud::LogSink::Instance().AddBackend(backend_);
+  }
+  void TearDown() override {
+    google::cloud::LogSink::Instance().RemoveBackend(logger_id_);
+    logger_id_ = 0;
+  }
+
+  std::vector<std::string> ClearLogLines() { return backend_->ClearLogLines(); }
+
+ private:
+  std::shared_ptr<google::cloud::testing_util::CaptureLogLinesBackend> backend_;
+  long logger_id_ = 0;  // NOLINT
+};
+
+TEST_F(AsyncStreamingReadWriteRpcLoggingTest, Cancel) {
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Cancel()).Times(1);
+  AsyncStreamingReadWriteRpcLogging<Request, Response> stream(
+      std::move(mock), TracingOptions{}, RequestIdForLogging());
+  stream.Cancel();
+  EXPECT_THAT(ClearLogLines(), Contains(HasSubstr("Cancel")));
+}
+
+TEST_F(AsyncStreamingReadWriteRpcLoggingTest, StartAndWritesDone) {
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Start).WillOnce([] { return make_ready_future(true); });
+  EXPECT_CALL(*mock, WritesDone).WillOnce([] {
+    return make_ready_future(false);
+  });
+  AsyncStreamingReadWriteRpcLogging<Request, Response> stream(
+      std::move(mock), TracingOptions{}, RequestIdForLogging());
+  EXPECT_TRUE(stream.Start().get());
+  EXPECT_THAT(ClearLogLines(), Contains(HasSubstr("Start")));
+  EXPECT_FALSE(stream.WritesDone().get());
+  EXPECT_THAT(ClearLogLines(), Contains(HasSubstr("WritesDone")));
+}
+
+TEST_F(AsyncStreamingReadWriteRpcLoggingTest, Read) {
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Read)
+      .WillOnce([] {
+        Response response;
+        response.set_seconds(42);
+        return make_ready_future(absl::make_optional(response));
+      })
+      .WillOnce([] { return make_ready_future(absl::optional<Response>{}); });
+  AsyncStreamingReadWriteRpcLogging<Request, Response> stream(
+      std::move(mock), TracingOptions{}, RequestIdForLogging());
+  auto response = stream.Read().get();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ(42, response->seconds());
+  auto log_lines = ClearLogLines();
+  EXPECT_THAT(log_lines, Contains(HasSubstr("Read")));
+  EXPECT_THAT(log_lines, Contains(HasSubstr("42")));
+
+  EXPECT_FALSE(stream.Read().get().has_value());
+  EXPECT_THAT(ClearLogLines(), Contains(HasSubstr("response={}")));
+}
+
+TEST_F(AsyncStreamingReadWriteRpcLoggingTest, Write) {
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Write)
+      .WillOnce([](Request const& request, grpc::WriteOptions const& options) {
+        EXPECT_EQ(1234, request.seconds());
+        EXPECT_TRUE(options.is_last_message());
+        return make_ready_future(true);
+      });
+  AsyncStreamingReadWriteRpcLogging<Request, Response> stream(
+      std::move(mock), TracingOptions{}, RequestIdForLogging());
+  Request request;
+  request.set_seconds(1234);
+  EXPECT_TRUE(stream.Write(request, grpc::WriteOptions().set_last_message())
+                  .get());
+  auto log_lines = ClearLogLines();
+  EXPECT_THAT(log_lines, Contains(HasSubstr("Write")));
+  EXPECT_THAT(log_lines, Contains(HasSubstr("1234")));
+  EXPECT_THAT(log_lines, Contains(HasSubstr("is_last_message=1")));
+}
+
+TEST_F(AsyncStreamingReadWriteRpcLoggingTest, Finish) {
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Finish).WillOnce([] {
+    return make_ready_future(Status(StatusCode::kUnavailable, "try-again"));
+  });
+  AsyncStreamingReadWriteRpcLogging<Request, Response> stream(
+      std::move(mock), TracingOptions{}, RequestIdForLogging());
+  EXPECT_THAT(stream.Finish().get(), StatusIs(StatusCode::kUnavailable));
+  auto log_lines = ClearLogLines();
+  EXPECT_THAT(log_lines, Contains(HasSubstr("Finish")));
+  EXPECT_THAT(log_lines, Contains(HasSubstr("try-again")));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
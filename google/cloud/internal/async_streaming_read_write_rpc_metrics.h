@@ -0,0 +1,96 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_METRICS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_METRICS_H
+
+#include "google/cloud/internal/async_read_write_stream_impl.h"
+#include "google/cloud/internal/metrics_wrapper.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include "google/cloud/version.h"
+#include "absl/types/optional.h"
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Metrics decorator for AsyncStreamingReadWriteRpc.
+ *
+ * Counts the messages written and read, and their size, and reports them with
+ * the final status of the stream.
+ */
+template <typename Request, typename Response>
+class AsyncStreamingReadWriteRpcMetrics
+    : public AsyncStreamingReadWriteRpc<Request, Response> {
+ public:
+  AsyncStreamingReadWriteRpcMetrics(
+      std::unique_ptr<AsyncStreamingReadWriteRpc<Request, Response>> stream,
+      char const* rpc)
+      : stream_(std::move(stream)),
+        recorder_(std::make_shared<RpcMetricsRecorder>(rpc)) {}
+  ~AsyncStreamingReadWriteRpcMetrics() override = default;
+
+  void Cancel() override { stream_->Cancel(); }
+
+  future<bool> Start() override { return stream_->Start(); }
+
+  future<absl::optional<Response>> Read() override {
+    if (!recorder_->enabled()) return stream_->Read();
+    auto recorder = recorder_;
+    return stream_->Read().then(
+        [recorder](future<absl::optional<Response>> f) {
+          auto response = f.get();
+          if (response) {
+            recorder->Received(
+                static_cast<std::int64_t>(response->ByteSizeLong()));
+          }
+          return response;
+        });
+  }
+
+  future<bool> Write(Request const& request,
+                     grpc::WriteOptions options) override {
+    if (recorder_->enabled()) {
+      recorder_->Sent(static_cast<std::int64_t>(request.ByteSizeLong()));
+    }
+    return stream_->Write(request, std::move(options));
+  }
+
+  future<bool> WritesDone() override { return stream_->WritesDone(); }
+
+  future<Status> Finish() override {
+    auto recorder = recorder_;
+    return stream_->Finish().then([recorder](future<Status> f) {
+      auto status = f.get();
+      recorder->Finish(status.code());
+      return status;
+    });
+  }
+
+ private:
+  std::unique_ptr<AsyncStreamingReadWriteRpc<Request, Response>> stream_;
+  std::shared_ptr<RpcMetricsRecorder> recorder_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_ASYNC_STREAMING_READ_WRITE_RPC_METRICS_H
@@ -0,0 +1,101 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/async_streaming_read_write_rpc_metrics.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/capture_instrumentation.h"
+#include "absl/memory/memory.h"
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::CaptureInstrumentation;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+using Request = google::protobuf::Timestamp;
+using Response = google::protobuf::Duration;
+
+class MockAsyncStreamingReadWriteRpc
+    : public AsyncStreamingReadWriteRpc<Request, Response> {
+ public:
+  ~MockAsyncStreamingReadWriteRpc() override = default;
+  MOCK_METHOD(void, Cancel, (), (override));
+  MOCK_METHOD(future<bool>, Start, (), (override));
+  MOCK_METHOD(future<absl::optional<Response>>, Read, (), (override));
+  MOCK_METHOD(future<bool>, Write, (Request const&, grpc::WriteOptions),
+              (override));
+  MOCK_METHOD(future<bool>, WritesDone, (), (override));
+  MOCK_METHOD(future<Status>, Finish, (), (override));
+};
+
+using Tested = AsyncStreamingReadWriteRpcMetrics<Request, Response>;
+
+TEST(AsyncStreamingReadWriteRpcMetricsTest, Basic) {
+  auto capture = std::make_shared<CaptureInstrumentation>();
+  SetInstrumentation(capture);
+
+  Request request;
+  request.set_seconds(1);
+  Response response;
+  response.set_seconds(42);
+
+  auto mock = absl::make_unique<MockAsyncStreamingReadWriteRpc>();
+  EXPECT_CALL(*mock, Start).WillOnce([] { return make_ready_future(true); });
+  EXPECT_CALL(*mock, Write(_, _))
+      .WillOnce([](Request const&, grpc::WriteOptions) {
+        return make_ready_future(true);
+      });
+  EXPECT_CALL(*mock, Read)
+      .WillOnce([&response] {
+        return make_ready_future(absl::make_optional(response));
+      })
+      .WillOnce([] {
+        return make_ready_future(absl::optional<Response>{});
+      });
+  EXPECT_CALL(*mock, WritesDone).WillOnce([] {
+    return make_ready_future(true);
+  });
+  EXPECT_CALL(*mock, Finish).WillOnce([] {
+    return make_ready_future(Status());
+  });
+
+  Tested stream(std::move(mock), "test.Service/Stream");
+  EXPECT_TRUE(stream.Start().get());
+  EXPECT_TRUE(stream.Write(request, grpc::WriteOptions()).get());
+  EXPECT_TRUE(stream.Read().get().has_value());
+  EXPECT_FALSE(stream.Read().get().has_value());
+  EXPECT_TRUE(stream.WritesDone().get());
+  EXPECT_THAT(capture->ClearEvents(), IsEmpty());
+  ASSERT_STATUS_OK(stream.Finish().get());
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre("rpc:test.Service/Stream:OK:sent=1/" +
+                          std::to_string(request.ByteSizeLong()) +
+                          ":received=1/" +
+                          std::to_string(response.ByteSizeLong())));
+  SetInstrumentation(nullptr);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
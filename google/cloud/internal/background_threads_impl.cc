@@ -13,26 +13,75 @@
 // limitations under the License.
 
 #include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/internal/sharded_completion_queue_impl.h"
+#include "google/cloud/log.h"
 #include <algorithm>
+#include <iterator>
+#include <thread>
 
 namespace google {
 namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
 namespace internal {
 
+namespace {
+
+void RunBackgroundThread(CompletionQueue cq, CpuSet const& cpus,
+                         std::string const& name) {
+  if (!name.empty()) SetCurrentThreadName(name);
+  if (!cpus.empty()) {
+    auto status = SetCurrentThreadAffinity(cpus);
+    if (!status.ok()) {
+      GCP_LOG(WARNING) << "cannot set the affinity of background thread <"
+                       << name << ">: " << status;
+    }
+  }
+  cq.Run();
+}
+
+std::vector<CompletionQueue> MakeCompletionQueues(
+    BackgroundThreadsConfig const& config) {
+  std::vector<CompletionQueue> cqs;
+  auto const count = (std::max)(config.cpu_sets.size(), std::size_t{1});
+  std::generate_n(std::back_inserter(cqs), count, [&config] {
+    if (config.completion_queue_shards <= 1) return CompletionQueue{};
+    return CompletionQueue(std::make_shared<ShardedCompletionQueueImpl>(
+        config.completion_queue_shards));
+  });
+  return cqs;
+}
+
+}  // namespace
+
 AutomaticallyCreatedBackgroundThreads::AutomaticallyCreatedBackgroundThreads()
-    : AutomaticallyCreatedBackgroundThreads(1, {}) {}
+    : AutomaticallyCreatedBackgroundThreads(BackgroundThreadsConfig{}) {}
 
 AutomaticallyCreatedBackgroundThreads::AutomaticallyCreatedBackgroundThreads(
     std::size_t thread_count)
-    : AutomaticallyCreatedBackgroundThreads(thread_count, {}) {}
+    : AutomaticallyCreatedBackgroundThreads([thread_count] {
+        BackgroundThreadsConfig config;
+        config.thread_count = thread_count;
+        return config;
+      }()) {}
 
 AutomaticallyCreatedBackgroundThreads::AutomaticallyCreatedBackgroundThreads(
-    std::size_t thread_count, NormalizeTag)
-    : pool_(thread_count == 0 ? 1 : thread_count) {
-  std::generate_n(pool_.begin(), pool_.size(), [this] {
-    return std::thread([](CompletionQueue cq) { cq.Run(); }, cq_);
-  });
+    BackgroundThreadsConfig config)
+    : cqs_(MakeCompletionQueues(config)) {
+  auto const& sets = config.cpu_sets;
+  for (std::size_t i = 0; i != sets.size(); ++i) {
+    for (auto cpu : sets[i]) cpu_to_cq_.emplace(cpu, i % cqs_.size());
+  }
+  auto const shards =
+      (std::max)(config.completion_queue_shards, std::size_t{1});
+  pool_.resize((std::max)(config.thread_count, cqs_.size() * shards));
+  for (std::size_t i = 0; i != pool_.size(); ++i) {
+    auto set = sets.empty() ? CpuSet{} : sets[i % sets.size()];
+    auto name = config.thread_name.empty()
+                    ? std::string{}
+                    : config.thread_name + "-" + std::to_string(i);
+    pool_[i] = std::thread(RunBackgroundThread, cqs_[i % cqs_.size()],
+                           std::move(set), std::move(name));
+  }
 }
 
 AutomaticallyCreatedBackgroundThreads::
@@ -40,9 +89,25 @@ AutomaticallyCreatedBackgroundThreads::
   Shutdown();
 }
 
+CompletionQueue AutomaticallyCreatedBackgroundThreads::cq() const {
+  if (cqs_.size() == 1) return cqs_.front();
+  auto const loc = cpu_to_cq_.find(CurrentCpu());
+  if (loc == cpu_to_cq_.end()) return cqs_.front();
+  return cqs_[loc->second];
+}
+
 void AutomaticallyCreatedBackgroundThreads::Shutdown() {
-  cq_.Shutdown();
-  for (auto& t : pool_) t.join();
+  for (auto& cq : cqs_) cq.Shutdown();
+  for (auto& t : pool_) {
+    // The last reference to the owner may be released by a callback running
+    // in one of the pool threads, that thread cannot join itself. It exits
+    // once the (now shutdown) completion queue drains.
+    if (t.get_id() == std::this_thread::get_id()) {
+      t.detach();
+      continue;
+    }
+    t.join();
+  }
   pool_.clear();
 }
 
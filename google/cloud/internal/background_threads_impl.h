@@ -17,8 +17,11 @@
 
 #include "google/cloud/background_threads.h"
 #include "google/cloud/completion_queue.h"
+#include "google/cloud/internal/thread_affinity.h"
 #include "google/cloud/version.h"
+#include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace google {
@@ -39,22 +42,63 @@ class CustomerSuppliedBackgroundThreads : public BackgroundThreads {
   CompletionQueue cq_;
 };
 
+/// Configure the threads created by `AutomaticallyCreatedBackgroundThreads`.
+struct BackgroundThreadsConfig {
+  /// The number of threads, at least one per CPU set.
+  std::size_t thread_count = 1;
+
+  /**
+   * Pin the threads to these CPU sets.
+   *
+   * Each set gets its own `CompletionQueue`, and the threads are assigned to
+   * the sets round-robin. Typically there is one set per NUMA node, so the
+   * completion queue, its threads, and the memory they touch stay local to
+   * that node.
+   */
+  std::vector<CpuSet> cpu_sets;
+
+  /// If not empty, name the threads `<thread_name>-<index>` for profiling.
+  std::string thread_name;
+
+  /**
+   * Shard each completion queue, with at least one thread per shard.
+   *
+   * @see `ShardedCompletionQueueImpl` for details.
+   */
+  std::size_t completion_queue_shards = 1;
+};
+
 /// Create a background thread to perform background operations.
 class AutomaticallyCreatedBackgroundThreads : public BackgroundThreads {
  public:
   AutomaticallyCreatedBackgroundThreads();
   explicit AutomaticallyCreatedBackgroundThreads(std::size_t thread_count);
+  explicit AutomaticallyCreatedBackgroundThreads(
+      BackgroundThreadsConfig config);
   ~AutomaticallyCreatedBackgroundThreads() override;
 
-  CompletionQueue cq() const override { return cq_; }
+  /**
+   * The completion queue local to the CPU running the calling thread.
+   *
+   * Returns the first completion queue if the CPU is not in any of the
+   * configured CPU sets.
+   */
+  CompletionQueue cq() const override;
+
+  /// The number of completion queues, one per CPU set.
+  std::size_t cq_count() const { return cqs_.size(); }
+
+  /// The completion queue for the @p index CPU set, modulo `cq_count()`.
+  CompletionQueue cq(std::size_t index) const {
+    return cqs_[index % cqs_.size()];
+  }
+
   void Shutdown();
   std::size_t pool_size() const { return pool_.size(); }
 
  private:
-  struct NormalizeTag {};
-  AutomaticallyCreatedBackgroundThreads(std::size_t thread_count, NormalizeTag);
-
-  CompletionQueue cq_;
+  std::vector<CompletionQueue> cqs_;
+  std::unordered_map<int, std::size_t> cpu_to_cq_;
   std::vector<std::thread> pool_;
 };
 
@@ -15,6 +15,9 @@
 #include "google/cloud/internal/background_threads_impl.h"
 #include "google/cloud/testing_util/scoped_thread.h"
 #include <gmock/gmock.h>
+#ifdef __linux__
+#include <pthread.h>
+#endif  // __linux__
 
 namespace google {
 namespace cloud {
@@ -24,6 +27,7 @@ namespace {
 
 using ::testing::Contains;
 using ::testing::Not;
+using ::testing::StartsWith;
 using testing_util::ScopedThread;
 
 /// @test Verify we can create and use a CustomerSuppliedBackgroundThreads
@@ -123,6 +127,66 @@ TEST(AutomaticallyCreatedBackgroundThreads, ManualShutdown) {
   actual.Shutdown();
 }
 
+/// @test Verify the threads can be released from one of the pool threads.
+TEST(AutomaticallyCreatedBackgroundThreads, ReleasedFromPoolThread) {
+  auto actual = std::make_shared<AutomaticallyCreatedBackgroundThreads>(2);
+  auto cq = actual->cq();
+  promise<void> done;
+  cq.RunAsync([&actual, &done] {
+    actual.reset();
+    done.set_value();
+  });
+  done.get_future().get();
+  EXPECT_FALSE(actual);
+}
+
+/// @test Verify that threads are assigned to the CPU sets and named.
+TEST(AutomaticallyCreatedBackgroundThreads, CpuSets) {
+  BackgroundThreadsConfig config;
+  config.thread_count = 4;
+  config.cpu_sets = {{0}, {0}};
+  config.thread_name = "test-bg";
+  AutomaticallyCreatedBackgroundThreads actual(config);
+  EXPECT_EQ(4, actual.pool_size());
+  ASSERT_EQ(2, actual.cq_count());
+
+  std::set<std::thread::id> ids;
+  for (std::size_t i = 0; i != actual.cq_count(); ++i) {
+    promise<std::thread::id> bg;
+    actual.cq(i).RunAsync([&bg] {
+#ifdef __linux__
+      EXPECT_EQ(0, CurrentCpu());
+      char name[16];
+      pthread_getname_np(pthread_self(), name, sizeof(name));
+      EXPECT_THAT(std::string(name), StartsWith("test-bg-"));
+#endif  // __linux__
+      bg.set_value(std::this_thread::get_id());
+    });
+    ids.insert(bg.get_future().get());
+  }
+  // Each completion queue has its own threads.
+  EXPECT_EQ(2, ids.size());
+  EXPECT_THAT(ids, Not(Contains(std::this_thread::get_id())));
+
+  // There is always at least one thread per CPU set.
+  config.thread_count = 1;
+  AutomaticallyCreatedBackgroundThreads minimal(config);
+  EXPECT_EQ(2, minimal.pool_size());
+}
+
+/// @test Verify that sharded completion queues get enough threads.
+TEST(AutomaticallyCreatedBackgroundThreads, CompletionQueueShards) {
+  BackgroundThreadsConfig config;
+  config.completion_queue_shards = 3;
+  AutomaticallyCreatedBackgroundThreads actual(config);
+  EXPECT_EQ(3, actual.pool_size());
+  ASSERT_EQ(1, actual.cq_count());
+
+  std::vector<promise<void>> promises(30);
+  for (auto& p : promises) actual.cq().RunAsync([&p] { p.set_value(); });
+  for (auto& p : promises) p.get_future().get();
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
@@ -0,0 +1,151 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/base64.h"
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+static_assert(UCHAR_MAX == 255, "base64 requires 8-bit bytes");
+
+constexpr char kPadding = '=';
+constexpr char kIndexToChar[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Any bit in this mask marks an invalid character in the decode tables.
+constexpr std::uint32_t kInvalid = 0xff000000;
+
+struct Tables {
+  Tables() {
+    for (std::uint32_t i = 0; i != 4096; ++i) {
+      encode[2 * i] = kIndexToChar[i >> 6];
+      encode[2 * i + 1] = kIndexToChar[i & 0x3f];
+    }
+    for (auto& d : decode) d.fill(kInvalid);
+    for (std::uint32_t i = 0; i != 64; ++i) {
+      auto const c = static_cast<unsigned char>(kIndexToChar[i]);
+      decode[0][c] = i << 18;
+      decode[1][c] = i << 12;
+      decode[2][c] = i << 6;
+      decode[3][c] = i;
+    }
+  }
+
+  // Maps 12 bits of input to their 2 output characters.
+  std::array<char, 2 * 4096> encode;
+  // Maps the character in each position of a group to its (shifted) bits.
+  std::array<std::array<std::uint32_t, 256>, 4> decode;
+};
+
+Tables const& GetTables() {
+  static auto const* const kTables = new Tables;
+  return *kTables;
+}
+
+Status InvalidGroup(char const* data, std::size_t size, char const* p) {
+  auto const offset = static_cast<std::size_t>(p - data);
+  auto const group = std::string(p, (std::min)(size - offset, std::size_t{4}));
+  return Status(StatusCode::kInvalidArgument,
+                "Invalid base64 chunk \"" + group + "\" at offset " +
+                    std::to_string(offset));
+}
+
+}  // namespace
+
+void Base64Encode(char const* data, std::size_t size, std::string& out) {
+  auto const& encode = GetTables().encode;
+  auto const* p = reinterpret_cast<unsigned char const*>(data);
+  auto const offset = out.size();
+  out.resize(offset + (size + 2) / 3 * 4);
+  auto* q = &out[offset];
+  for (; size >= 3; size -= 3, p += 3, q += 4) {
+    std::uint32_t const v = p[0] << 16 | p[1] << 8 | p[2];
+    auto const* hi = &encode[2 * (v >> 12)];
+    auto const* lo = &encode[2 * (v & 0xfff)];
+    q[0] = hi[0];
+    q[1] = hi[1];
+    q[2] = lo[0];
+    q[3] = lo[1];
+  }
+  if (size == 0) return;
+  std::uint32_t const v = p[0] << 16 | (size == 2 ? p[1] << 8 : 0);
+  q[0] = kIndexToChar[v >> 18];
+  q[1] = kIndexToChar[v >> 12 & 0x3f];
+  q[2] = size == 2 ? kIndexToChar[v >> 6 & 0x3f] : kPadding;
+  q[3] = kPadding;
+}
+
+std::string Base64Encode(std::string const& bytes) {
+  std::string out;
+  Base64Encode(bytes.data(), bytes.size(), out);
+  return out;
+}
+
+Status Base64Decode(char const* data, std::size_t size, std::string& out) {
+  if (size % 4 != 0) {
+    return InvalidGroup(data, size, data + size / 4 * 4);
+  }
+  if (size == 0) return Status();
+  auto const& decode = GetTables().decode;
+  auto const* p = reinterpret_cast<unsigned char const*>(data);
+  auto const* last = p + size - 4;  // the only group that may have padding
+  auto const offset = out.size();
+  out.resize(offset + size / 4 * 3);
+  auto* q = &out[offset];
+  for (; p != last; p += 4, q += 3) {
+    auto const v = decode[0][p[0]] | decode[1][p[1]] | decode[2][p[2]] |
+                   decode[3][p[3]];
+    if ((v & kInvalid) != 0) {
+      return InvalidGroup(data, size, reinterpret_cast<char const*>(p));
+    }
+    q[0] = static_cast<char>(v >> 16);
+    q[1] = static_cast<char>(v >> 8);
+    q[2] = static_cast<char>(v);
+  }
+
+  // The last group, "xx==", "xxx=", or "xxxx", where the unused bits in the
+  // padded forms must be zero.
+  auto const padding = p[3] != kPadding ? 0 : p[2] != kPadding ? 1 : 2;
+  auto v = decode[0][p[0]] | decode[1][p[1]];
+  if (padding < 2) v |= decode[2][p[2]];
+  if (padding < 1) v |= decode[3][p[3]];
+  auto const unused = padding == 2 ? 0xffffU : padding == 1 ? 0xffU : 0U;
+  if ((v & kInvalid) != 0 || (v & unused) != 0) {
+    return InvalidGroup(data, size, reinterpret_cast<char const*>(p));
+  }
+  q[0] = static_cast<char>(v >> 16);
+  q[1] = static_cast<char>(v >> 8);
+  q[2] = static_cast<char>(v);
+  out.resize(out.size() - padding);
+  return Status();
+}
+
+StatusOr<std::string> Base64Decode(std::string const& base64) {
+  std::string out;
+  auto status = Base64Decode(base64.data(), base64.size(), out);
+  if (!status.ok()) return status;
+  return out;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
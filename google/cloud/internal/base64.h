@@ -0,0 +1,57 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_BASE64_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_BASE64_H
+
+#include "google/cloud/status_or.h"
+#include "google/cloud/version.h"
+#include <cstddef>
+#include <string>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Appends the base64 encoding (RFC 4648 section 4, with padding) of the
+ * @p size bytes at @p data to @p out.
+ *
+ * The codec converts whole 3-byte (or 4-character) groups using lookup tables,
+ * prefer it over byte-at-a-time loops or OpenSSL BIOs.
+ */
+void Base64Encode(char const* data, std::size_t size, std::string& out);
+
+/// Returns the base64 encoding of @p bytes.
+std::string Base64Encode(std::string const& bytes);
+
+/**
+ * Appends the bytes encoded by the base64 string at @p data to @p out.
+ *
+ * The input must be canonical: padded to a multiple of 4 characters, and with
+ * any unused bits in the last group set to zero. Returns an error, leaving
+ * @p out in an unspecified state, otherwise.
+ */
+Status Base64Decode(char const* data, std::size_t size, std::string& out);
+
+/// Returns the bytes encoded by the base64 string @p base64.
+StatusOr<std::string> Base64Decode(std::string const& base64);
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_BASE64_H
@@ -0,0 +1,100 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/base64.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <string>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::HasSubstr;
+
+TEST(Base64, RFC4648TestVectors) {
+  // https://tools.ietf.org/html/rfc4648#section-10
+  struct {
+    std::string bytes;
+    std::string base64;
+  } cases[] = {
+      {"", ""},
+      {"f", "Zg=="},
+      {"fo", "Zm8="},
+      {"foo", "Zm9v"},
+      {"foob", "Zm9vYg=="},
+      {"fooba", "Zm9vYmE="},
+      {"foobar", "Zm9vYmFy"},
+  };
+  for (auto const& c : cases) {
+    EXPECT_EQ(c.base64, Base64Encode(c.bytes));
+    auto decoded = Base64Decode(c.base64);
+    ASSERT_STATUS_OK(decoded);
+    EXPECT_EQ(c.bytes, *decoded);
+  }
+}
+
+TEST(Base64, RoundTrip) {
+  std::string bytes;
+  for (int i = 0; i != 1024; ++i) bytes.push_back(static_cast<char>(i * 7));
+  for (std::size_t n = 0; n != bytes.size(); ++n) {
+    auto const input = bytes.substr(0, n);
+    auto const encoded = Base64Encode(input);
+    EXPECT_EQ((n + 2) / 3 * 4, encoded.size());
+    auto decoded = Base64Decode(encoded);
+    ASSERT_STATUS_OK(decoded);
+    EXPECT_EQ(input, *decoded);
+  }
+}
+
+TEST(Base64, Append) {
+  std::string out = "prefix:";
+  Base64Encode("foo", 3, out);
+  EXPECT_EQ("prefix:Zm9v", out);
+  ASSERT_STATUS_OK(Base64Decode("Zm9vYg==", 8, out));
+  EXPECT_EQ("prefix:Zm9vfoob", out);
+}
+
+TEST(Base64, DecodeErrors) {
+  for (auto const* base64 : {
+           "Zg",        // missing padding
+           "Zm9vY",     // bad length
+           "Zm9v!mFy",  // bad character
+           "Zm=v",      // padding in the middle of a group
+           "Zg==Zm9v",  // padding before the last group
+           "Z===",      // too much padding
+           "Zh==",      // unused bits are not zero
+           "Zm9=",      // unused bits are not zero
+       }) {
+    EXPECT_THAT(Base64Decode(base64),
+                StatusIs(StatusCode::kInvalidArgument,
+                         HasSubstr("Invalid base64 chunk")))
+        << base64;
+  }
+  EXPECT_THAT(Base64Decode("Zm9vYmFy Zm9v"),
+              StatusIs(StatusCode::kInvalidArgument, HasSubstr("offset 12")));
+  EXPECT_THAT(Base64Decode("Zm9v!mFy"),
+              StatusIs(StatusCode::kInvalidArgument,
+                       HasSubstr("\"!mFy\" at offset 4")));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
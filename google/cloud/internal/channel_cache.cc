@@ -0,0 +1,135 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/channel_cache.h"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+std::shared_ptr<grpc::Channel> DefaultChannelFactory(
+    std::string const& endpoint,
+    std::shared_ptr<grpc::ChannelCredentials> const& credentials,
+    grpc::ChannelArguments const& arguments) {
+  return grpc::CreateCustomChannel(endpoint, credentials, arguments);
+}
+
+// Serialize the configuration of a channel. The arguments are sorted, so the
+// order in which they were set does not matter.
+std::string MakeKey(
+    std::string const& endpoint,
+    std::shared_ptr<grpc::ChannelCredentials> const& credentials,
+    grpc::ChannelArguments const& arguments) {
+  auto const c_args = arguments.c_channel_args();
+  std::vector<std::string> args;
+  args.reserve(c_args.num_args);
+  for (std::size_t i = 0; i != c_args.num_args; ++i) {
+    auto const& a = c_args.args[i];
+    std::string value;
+    switch (a.type) {
+      case GRPC_ARG_STRING:
+        value = std::string("s:") + a.value.string;
+        break;
+      case GRPC_ARG_INTEGER:
+        value = "i:" + std::to_string(a.value.integer);
+        break;
+      case GRPC_ARG_POINTER:
+        value = "p:" + std::to_string(reinterpret_cast<std::uintptr_t>(
+                           a.value.pointer.p));
+        break;
+    }
+    args.push_back(std::string(a.key) + '=' + value);
+  }
+  std::sort(args.begin(), args.end());
+
+  auto const id = reinterpret_cast<std::uintptr_t>(credentials.get());
+  auto key = endpoint + '\0' + std::to_string(id);
+  for (auto const& a : args) {
+    key += '\0';
+    key += a;
+  }
+  return key;
+}
+
+}  // namespace
+
+ChannelCache::ChannelCache() : ChannelCache(DefaultChannelFactory) {}
+
+ChannelCache::ChannelCache(ChannelFactory factory)
+    : factory_(std::move(factory)) {}
+
+ChannelCache& ChannelCache::Singleton() {
+  static auto* const kCache = new ChannelCache;
+  return *kCache;
+}
+
+std::shared_ptr<grpc::Channel> ChannelCache::GetChannel(
+    std::string const& endpoint,
+    std::shared_ptr<grpc::ChannelCredentials> const& credentials,
+    grpc::ChannelArguments const& arguments) {
+  auto key = MakeKey(endpoint, credentials, arguments);
+  std::lock_guard<std::mutex> lk(mu_);
+  auto i = entries_.find(key);
+  if (i != entries_.end()) {
+    // The address of a destroyed credentials object may be reused by a new
+    // one, so the entry must refer to the same (live) object.
+    auto channel = i->second.channel.lock();
+    if (channel && i->second.credentials.lock() == credentials) {
+      return channel;
+    }
+  }
+  // Creating a channel does not block, it only connects on the first request.
+  auto channel = factory_(endpoint, credentials, arguments);
+  // Drop the entries for released channels, this keeps the cache bounded by
+  // the number of channels in use.
+  for (auto e = entries_.begin(); e != entries_.end();) {
+    if (e->second.channel.expired()) {
+      e = entries_.erase(e);
+    } else {
+      ++e;
+    }
+  }
+  entries_[std::move(key)] = Entry{credentials, channel};
+  return channel;
+}
+
+std::size_t ChannelCache::size() {
+  std::lock_guard<std::mutex> lk(mu_);
+  return static_cast<std::size_t>(std::count_if(
+      entries_.begin(), entries_.end(),
+      [](std::pair<std::string const, Entry> const& e) {
+        return !e.second.channel.expired();
+      }));
+}
+
+std::shared_ptr<grpc::Channel> CreateCustomChannel(
+    std::string const& endpoint,
+    std::shared_ptr<grpc::ChannelCredentials> const& credentials,
+    grpc::ChannelArguments const& arguments, bool use_cache) {
+  if (!use_cache) {
+    return DefaultChannelFactory(endpoint, credentials, arguments);
+  }
+  return ChannelCache::Singleton().GetChannel(endpoint, credentials, arguments);
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
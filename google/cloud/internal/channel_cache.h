@@ -0,0 +1,103 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_CHANNEL_CACHE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_CHANNEL_CACHE_H
+
+#include "google/cloud/version.h"
+#include <grpcpp/grpcpp.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Shares gRPC channels across clients with the same configuration.
+ *
+ * Each library creates its own channels, even when several clients in the
+ * same process use the same endpoint and credentials. This cache returns the
+ * same channel to all the callers asking for the same endpoint, credentials
+ * object, and channel arguments.
+ *
+ * The cache does not own the channels: the channels are reference counted
+ * by the clients using them, and released when the last client is
+ * destroyed. The next request creates a new channel.
+ *
+ * Credentials are compared by identity, equivalent credentials in different
+ * objects do not share channels. Pointer channel arguments, such as the
+ * resource quota, are also compared by identity.
+ *
+ * @par Thread-safety
+ * Instances of this class are safe to use from multiple threads.
+ */
+class ChannelCache {
+ public:
+  using ChannelFactory = std::function<std::shared_ptr<grpc::Channel>(
+      std::string const& endpoint,
+      std::shared_ptr<grpc::ChannelCredentials> const& credentials,
+      grpc::ChannelArguments const& arguments)>;
+
+  /// Create a cache using `grpc::CreateCustomChannel()`.
+  ChannelCache();
+
+  /// Create a cache using @p factory to create new channels, used in tests.
+  explicit ChannelCache(ChannelFactory factory);
+
+  /// The process-wide cache, shared by all the libraries.
+  static ChannelCache& Singleton();
+
+  /// Return the cached channel for this configuration, or a new one.
+  std::shared_ptr<grpc::Channel> GetChannel(
+      std::string const& endpoint,
+      std::shared_ptr<grpc::ChannelCredentials> const& credentials,
+      grpc::ChannelArguments const& arguments);
+
+  /// The number of channels in the cache still in use.
+  std::size_t size();
+
+ private:
+  struct Entry {
+    std::weak_ptr<grpc::ChannelCredentials> credentials;
+    std::weak_ptr<grpc::Channel> channel;
+  };
+
+  ChannelFactory const factory_;
+  std::mutex mu_;
+  std::unordered_map<std::string, Entry> entries_;  // GUARDED_BY(mu_)
+};
+
+/**
+ * Create a channel, using the process-wide cache if @p use_cache is `true`.
+ *
+ * The libraries call this function with the values from their
+ * `ConnectionOptions`, in place of `grpc::CreateCustomChannel()`.
+ */
+std::shared_ptr<grpc::Channel> CreateCustomChannel(
+    std::string const& endpoint,
+    std::shared_ptr<grpc::ChannelCredentials> const& credentials,
+    grpc::ChannelArguments const& arguments, bool use_cache);
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_CHANNEL_CACHE_H
@@ -0,0 +1,98 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/channel_cache.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+class ChannelCacheTest : public ::testing::Test {
+ protected:
+  ChannelCache cache_{[this](std::string const& endpoint,
+                             std::shared_ptr<grpc::ChannelCredentials> const&
+                                 credentials,
+                             grpc::ChannelArguments const& arguments) {
+    ++created_;
+    return grpc::CreateCustomChannel(endpoint, credentials, arguments);
+  }};
+  int created_ = 0;
+  std::shared_ptr<grpc::ChannelCredentials> credentials_ =
+      grpc::InsecureChannelCredentials();
+};
+
+TEST_F(ChannelCacheTest, SharesChannels) {
+  grpc::ChannelArguments a1;
+  a1.SetInt("test-int", 1);
+  a1.SetString("test-string", "a");
+  // The same arguments, set in a different order.
+  grpc::ChannelArguments a2;
+  a2.SetString("test-string", "a");
+  a2.SetInt("test-int", 1);
+
+  auto c1 = cache_.GetChannel("localhost:1", credentials_, a1);
+  auto c2 = cache_.GetChannel("localhost:1", credentials_, a2);
+  EXPECT_EQ(c1, c2);
+  EXPECT_EQ(1, created_);
+  EXPECT_EQ(1, cache_.size());
+}
+
+TEST_F(ChannelCacheTest, DifferentConfigurations) {
+  grpc::ChannelArguments a1;
+  a1.SetInt("grpc.channel_id", 0);
+  grpc::ChannelArguments a2;
+  a2.SetInt("grpc.channel_id", 1);
+
+  auto c1 = cache_.GetChannel("localhost:1", credentials_, a1);
+  auto c2 = cache_.GetChannel("localhost:1", credentials_, a2);
+  auto c3 = cache_.GetChannel("localhost:2", credentials_, a1);
+  // Equivalent credentials in a different object do not share channels.
+  auto c4 =
+      cache_.GetChannel("localhost:1", grpc::InsecureChannelCredentials(), a1);
+  EXPECT_NE(c1, c2);
+  EXPECT_NE(c1, c3);
+  EXPECT_NE(c1, c4);
+  EXPECT_EQ(4, created_);
+}
+
+TEST_F(ChannelCacheTest, ReleasesUnusedChannels) {
+  grpc::ChannelArguments args;
+  auto c1 = cache_.GetChannel("localhost:1", credentials_, args);
+  EXPECT_EQ(1, cache_.size());
+  c1.reset();
+  EXPECT_EQ(0, cache_.size());
+
+  auto c2 = cache_.GetChannel("localhost:1", credentials_, args);
+  EXPECT_EQ(2, created_);
+  EXPECT_EQ(1, cache_.size());
+}
+
+TEST(ChannelCacheSingletonTest, OptIn) {
+  auto credentials = grpc::InsecureChannelCredentials();
+  grpc::ChannelArguments args;
+  auto c1 = CreateCustomChannel("localhost:1", credentials, args, true);
+  auto c2 = CreateCustomChannel("localhost:1", credentials, args, true);
+  auto c3 = CreateCustomChannel("localhost:1", credentials, args, false);
+  EXPECT_EQ(c1, c2);
+  EXPECT_NE(c1, c3);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,79 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/channel_pool.h"
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+ChannelLease::~ChannelLease() {
+  if (pool_) pool_->Release(index_);
+}
+
+ChannelPool::ChannelPool(std::vector<std::shared_ptr<grpc::Channel>> channels,
+                         std::chrono::milliseconds refresh_period)
+    : channels_(std::move(channels)),
+      refresh_period_(refresh_period),
+      state_(channels_.size()) {
+  auto const now = Clock::now();
+  for (auto& s : state_) s.next_refresh = now + refresh_period_;
+}
+
+void ChannelPool::WarmUp() {
+  for (auto const& c : channels_) {
+    if (c) c->GetState(/*try_to_connect=*/true);
+  }
+}
+
+ChannelLease ChannelPool::Acquire() {
+  auto const now = Clock::now();
+  std::unique_lock<std::mutex> lk(mu_);
+  auto const n = state_.size();
+  auto best = next_;
+  for (std::size_t i = 1; i != n; ++i) {
+    auto const candidate = (next_ + i) % n;
+    if (state_[candidate].outstanding < state_[best].outstanding) {
+      best = candidate;
+    }
+  }
+  next_ = (next_ + 1) % n;
+  auto& s = state_[best];
+  ++s.outstanding;
+  auto const refresh = now >= s.next_refresh;
+  if (refresh) s.next_refresh = now + refresh_period_;
+  lk.unlock();
+  // Asking a channel to connect is a no-op unless it is `IDLE`, but it
+  // acquires locks inside gRPC, so it is done outside our own lock.
+  if (refresh && channels_[best]) {
+    channels_[best]->GetState(/*try_to_connect=*/true);
+  }
+  return ChannelLease(shared_from_this(), best);
+}
+
+std::size_t ChannelPool::outstanding(std::size_t index) {
+  std::lock_guard<std::mutex> lk(mu_);
+  return state_[index].outstanding;
+}
+
+void ChannelPool::Release(std::size_t index) {
+  std::lock_guard<std::mutex> lk(mu_);
+  --state_[index].outstanding;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
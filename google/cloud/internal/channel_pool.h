@@ -0,0 +1,125 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_CHANNEL_POOL_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_CHANNEL_POOL_H
+
+#include "google/cloud/version.h"
+#include <grpcpp/channel.h>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+class ChannelPool;
+
+/**
+ * Represents a request in progress on one of the channels in a `ChannelPool`.
+ *
+ * The request is counted as outstanding until the lease is destroyed.
+ */
+class ChannelLease {
+ public:
+  ChannelLease(ChannelLease&& rhs) noexcept
+      : pool_(std::move(rhs.pool_)), index_(rhs.index_) {}
+  ChannelLease& operator=(ChannelLease&&) = delete;
+  ~ChannelLease();
+
+  /// The index of the channel (and stub) selected for this request.
+  std::size_t index() const { return index_; }
+
+ private:
+  friend class ChannelPool;
+  ChannelLease(std::shared_ptr<ChannelPool> pool, std::size_t index)
+      : pool_(std::move(pool)), index_(index) {}
+
+  std::shared_ptr<ChannelPool> pool_;
+  std::size_t index_;
+};
+
+/**
+ * Selects the channel for each request in a generated stub pool.
+ *
+ * The generated stub factories create one stub per channel. This class
+ * selects the channel with the fewest outstanding requests for each call,
+ * breaking ties in round-robin order.
+ *
+ * gRPC channels go `IDLE` after a period of inactivity, or when the server
+ * sends a `GOAWAY` frame. Such channels only reconnect when the next request
+ * starts, which adds the connection setup to the latency of that request.
+ * The pool asks each channel to reconnect, at most once per
+ * `refresh_period`, when the channel is selected. `WarmUp()` asks all the
+ * channels to connect before the first request.
+ *
+ * @par Thread-safety
+ * Instances of this class are safe to use from multiple threads.
+ */
+class ChannelPool : public std::enable_shared_from_this<ChannelPool> {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// The default period between attempts to reconnect an idle channel.
+  static std::chrono::milliseconds DefaultRefreshPeriod() {
+    return std::chrono::seconds(30);
+  }
+
+  /**
+   * Create a pool for @p channels, which must not be empty.
+   *
+   * Null elements in @p channels are selected as usual, but never connected or
+   * refreshed. This is useful in tests.
+   */
+  explicit ChannelPool(
+      std::vector<std::shared_ptr<grpc::Channel>> channels,
+      std::chrono::milliseconds refresh_period = DefaultRefreshPeriod());
+
+  std::size_t size() const { return channels_.size(); }
+
+  /// Ask all the channels to start connecting.
+  void WarmUp();
+
+  /// Select the channel for a new request.
+  ChannelLease Acquire();
+
+  /// The number of requests in progress on channel @p index.
+  std::size_t outstanding(std::size_t index);
+
+ private:
+  friend class ChannelLease;
+  void Release(std::size_t index);
+
+  struct ChannelState {
+    std::size_t outstanding = 0;
+    Clock::time_point next_refresh;
+  };
+
+  std::vector<std::shared_ptr<grpc::Channel>> const channels_;
+  std::chrono::milliseconds const refresh_period_;
+  std::mutex mu_;
+  std::vector<ChannelState> state_;  // GUARDED_BY(mu_)
+  std::size_t next_ = 0;             // GUARDED_BY(mu_)
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_CHANNEL_POOL_H
@@ -0,0 +1,110 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/channel_pool.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+
+std::vector<std::shared_ptr<grpc::Channel>> NullChannels(std::size_t n) {
+  return std::vector<std::shared_ptr<grpc::Channel>>(n);
+}
+
+TEST(ChannelPoolTest, RoundRobinWhenIdle) {
+  auto pool = std::make_shared<ChannelPool>(NullChannels(3));
+  std::vector<std::size_t> actual;
+  for (int i = 0; i != 6; ++i) actual.push_back(pool->Acquire().index());
+  EXPECT_THAT(actual, ElementsAre(0, 1, 2, 0, 1, 2));
+}
+
+TEST(ChannelPoolTest, PicksLeastOutstanding) {
+  auto pool = std::make_shared<ChannelPool>(NullChannels(3));
+  auto l0 = pool->Acquire();
+  auto l1 = absl::make_unique<ChannelLease>(pool->Acquire());
+  auto l2 = pool->Acquire();
+  EXPECT_EQ(0, l0.index());
+  EXPECT_EQ(1, l1->index());
+  EXPECT_EQ(2, l2.index());
+  // Release the request on channel 1, the next request must use it, even
+  // though the round-robin order would pick channel 0.
+  l1.reset();
+  EXPECT_EQ(0, pool->outstanding(1));
+  auto lease = pool->Acquire();
+  EXPECT_EQ(1, lease.index());
+  EXPECT_EQ(1, pool->outstanding(0));
+  EXPECT_EQ(1, pool->outstanding(1));
+  EXPECT_EQ(1, pool->outstanding(2));
+}
+
+TEST(ChannelPoolTest, LeaseReleasesOnDestruction) {
+  auto pool = std::make_shared<ChannelPool>(NullChannels(2));
+  {
+    auto lease = pool->Acquire();
+    EXPECT_EQ(1, pool->outstanding(lease.index()));
+    auto moved = std::move(lease);
+    EXPECT_EQ(1, pool->outstanding(moved.index()));
+  }
+  EXPECT_EQ(0, pool->outstanding(0));
+  EXPECT_EQ(0, pool->outstanding(1));
+}
+
+std::shared_ptr<grpc::Channel> MakeUnusedChannel(int id) {
+  grpc::ChannelArguments args;
+  args.SetInt("grpc.channel_id", id);
+  return grpc::CreateCustomChannel(
+      "localhost:1", grpc::InsecureChannelCredentials(), args);
+}
+
+TEST(ChannelPoolTest, WarmUp) {
+  auto channel = MakeUnusedChannel(0);
+  ASSERT_EQ(GRPC_CHANNEL_IDLE, channel->GetState(false));
+  auto pool = std::make_shared<ChannelPool>(
+      std::vector<std::shared_ptr<grpc::Channel>>{channel});
+  pool->WarmUp();
+  EXPECT_NE(GRPC_CHANNEL_IDLE, channel->GetState(false));
+}
+
+TEST(ChannelPoolTest, RefreshIdleChannel) {
+  auto channel = MakeUnusedChannel(1);
+  ASSERT_EQ(GRPC_CHANNEL_IDLE, channel->GetState(false));
+  auto pool = std::make_shared<ChannelPool>(
+      std::vector<std::shared_ptr<grpc::Channel>>{channel},
+      std::chrono::milliseconds(0));
+  (void)pool->Acquire();
+  EXPECT_NE(GRPC_CHANNEL_IDLE, channel->GetState(false));
+}
+
+TEST(ChannelPoolTest, NoRefreshBeforePeriod) {
+  auto channel = MakeUnusedChannel(2);
+  auto pool = std::make_shared<ChannelPool>(
+      std::vector<std::shared_ptr<grpc::Channel>>{channel},
+      std::chrono::hours(1));
+  (void)pool->Acquire();
+  EXPECT_EQ(GRPC_CHANNEL_IDLE, channel->GetState(false));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
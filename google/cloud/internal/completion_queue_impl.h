@@ -72,8 +72,26 @@ class CompletionQueueImpl {
 
   /// The underlying gRPC completion queue.
   virtual grpc::CompletionQueue& cq() = 0;
+
+  /**
+   * The implementation for a sequence of operations sharing a gRPC completion
+   * queue.
+   *
+   * All the operations in a streaming RPC must use the same
+   * `grpc::CompletionQueue`. Implementations with more than one (e.g., the
+   * sharded completion queue) return one of their shards, other
+   * implementations return `nullptr`, meaning that they can be used directly.
+   */
+  virtual std::shared_ptr<CompletionQueueImpl> PickShard() { return nullptr; }
 };
 
+/// Returns @p impl, or one of its shards if it has any.
+inline std::shared_ptr<CompletionQueueImpl> PickShard(
+    std::shared_ptr<CompletionQueueImpl> impl) {
+  auto shard = impl->PickShard();
+  return shard ? shard : impl;
+}
+
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -16,6 +16,7 @@
 #include "google/cloud/internal/throw_delegate.h"
 #include "absl/memory/memory.h"
 #include <grpcpp/alarm.h>
+#include <algorithm>
 #include <sstream>
 
 // There is no way to unblock the gRPC event loop, not even calling Shutdown(),
@@ -30,6 +31,14 @@ namespace internal {
 
 namespace {
 
+// The resolution of the timer wheel, timers expiring within the same
+// millisecond are coalesced.
+std::chrono::milliseconds constexpr kTimerWheelResolution(1);
+
+Status TimerCanceled() {
+  return Status{StatusCode::kCancelled, "timer canceled"};
+}
+
 /**
  * Wrap a gRPC timer into an `AsyncOperation`.
  *
@@ -74,14 +83,10 @@ class AsyncTimerFuture : public internal::AsyncGrpcOperation {
   explicit AsyncTimerFuture() : promise_(null_promise_t{}) {}
 
   bool Notify(bool ok) override {
-    promise_.set_value(ok ? ValueType(deadline_) : Canceled());
+    promise_.set_value(ok ? ValueType(deadline_) : TimerCanceled());
     return true;
   }
 
-  static ValueType Canceled() {
-    return Status{StatusCode::kCancelled, "timer canceled"};
-  }
-
   promise<ValueType> promise_;
   std::chrono::system_clock::time_point deadline_;
   grpc::Alarm alarm_;
@@ -89,6 +94,30 @@ class AsyncTimerFuture : public internal::AsyncGrpcOperation {
 
 }  // namespace
 
+// Deliver the result of a timer canceled in the wheel through the completion
+// queue, so its continuations run asynchronously, as they do for timers backed
+// by their own alarm.
+class DefaultCompletionQueueImpl::CanceledTimer
+    : public internal::AsyncGrpcOperation {
+ public:
+  explicit CanceledTimer(promise<TimerResult> p) : promise_(std::move(p)) {}
+
+  void Set(grpc::CompletionQueue& cq, void* tag) {
+    alarm_.Set(&cq, std::chrono::system_clock::now(), tag);
+  }
+
+  void Cancel() override {}
+
+ private:
+  bool Notify(bool) override {
+    promise_.set_value(TimerCanceled());
+    return true;
+  }
+
+  promise<TimerResult> promise_;
+  grpc::Alarm alarm_;
+};
+
 // A helper class to wake up the asynchronous thread and drain the RunAsync()
 // queue in a loop.
 class DefaultCompletionQueueImpl::WakeUpRunAsyncLoop
@@ -139,12 +168,49 @@ class DefaultCompletionQueueImpl::WakeUpRunAsyncOnIdle
   grpc::Alarm alarm_;
 };
 
+// The single alarm driving the timer wheel.
+class DefaultCompletionQueueImpl::TimerWheelAlarm
+    : public internal::AsyncGrpcOperation {
+ public:
+  explicit TimerWheelAlarm(std::weak_ptr<DefaultCompletionQueueImpl> w)
+      : weak_(std::move(w)) {}
+
+  void Set(grpc::CompletionQueue& cq,
+           std::chrono::system_clock::time_point deadline, void* tag) {
+    alarm_.Set(&cq, deadline, tag);
+  }
+
+  void Cancel() override { alarm_.Cancel(); }
+
+ private:
+  bool Notify(bool) override {
+    // Canceled alarms also advance the wheel, the timers may be due already.
+    if (auto self = weak_.lock()) self->OnTimerWheelAlarm(this);
+    return true;
+  }
+
+  std::weak_ptr<DefaultCompletionQueueImpl> weak_;
+  grpc::Alarm alarm_;
+};
+
 DefaultCompletionQueueImpl::DefaultCompletionQueueImpl()
+    : DefaultCompletionQueueImpl(nullptr) {}
+
+DefaultCompletionQueueImpl::DefaultCompletionQueueImpl(
+    std::unique_ptr<WorkStealingExecutor> executor)
     : shutdown_guard_(
           // Capturing `this` here is safe because the lifetime of copies of
           // this member do not outlive `StartOperation`.
           std::shared_ptr<void>(reinterpret_cast<void*>(this),
-                                [this](void*) { cq_.Shutdown(); })) {}
+                                [this](void*) { cq_.Shutdown(); })),
+      executor_(std::move(executor)),
+      timer_wheel_(std::chrono::system_clock::now(), kTimerWheelResolution) {}
+
+DefaultCompletionQueueImpl::~DefaultCompletionQueueImpl() {
+  // Release any operations that never completed, they own themselves while
+  // they are pending.
+  while (pending_ops_ != nullptr) UnlinkOperation(pending_ops_);
+}
 
 void DefaultCompletionQueueImpl::Run() {
   class ThreadPoolCount {
@@ -172,10 +238,11 @@ void DefaultCompletionQueueImpl::Run() {
       google::cloud::internal::ThrowRuntimeError(
           "unexpected status from AsyncNext()");
     }
-    auto op = FindOperation(tag);
+    // The tag is the operation, which keeps itself alive while it is pending.
+    auto* op = static_cast<AsyncGrpcOperation*>(tag);
     ++notify_counter_;
     if (op->Notify(ok)) {
-      ForgetOperation(tag);
+      ForgetOperation(op);
     }
   }
 }
@@ -186,29 +253,67 @@ void DefaultCompletionQueueImpl::Shutdown() {
     shutdown_ = true;
     shutdown_guard_.reset();
   }
+  if (executor_) executor_->Shutdown();
 }
 
 void DefaultCompletionQueueImpl::CancelAll() {
+  std::vector<std::shared_ptr<TimerWheelAlarm>> alarms;
+  {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    for (auto& t : timer_wheel_.Clear()) CompleteCanceledTimer(std::move(t));
+    alarms = ReleaseTimerWheel();
+  }
+  for (auto& a : alarms) a->Cancel();
+
   // Cancel all operations. We need to make a copy of the operations because
   // canceling them may trigger a recursive call that needs the lock. And we
   // need the lock because canceling might trigger calls that invalidate the
   // iterators.
   auto pending = [this] {
     std::unique_lock<std::mutex> lk(mu_);
-    return pending_ops_;
+    std::vector<std::shared_ptr<AsyncGrpcOperation>> ops;
+    for (auto* op = pending_ops_; op != nullptr; op = op->next_) {
+      ops.push_back(op->self_);
+    }
+    return ops;
   }();
-  for (auto& kv : pending) {
-    kv.second->Cancel();
+  for (auto& op : pending) {
+    op->Cancel();
   }
 }
 
 future<StatusOr<std::chrono::system_clock::time_point>>
 DefaultCompletionQueueImpl::MakeDeadlineTimer(
     std::chrono::system_clock::time_point deadline) {
-  auto p = AsyncTimerFuture::Create();
-  auto op = std::move(p.first);
-  StartOperation(op, [&](void* tag) { op->Set(cq(), deadline, tag); });
-  return std::move(p.second);
+  auto const now = std::chrono::system_clock::now();
+  // Expired timers do not benefit from the wheel, they still need a trip
+  // through the completion queue to run asynchronously.
+  if (deadline <= now) return MakeAlarmTimer(deadline);
+
+  std::unique_lock<std::mutex> timer_lk(timer_mu_);
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (shutdown_) {
+      lk.unlock();
+      timer_lk.unlock();
+      // This timer is canceled immediately, as any other operation started
+      // after `Shutdown()`.
+      return MakeAlarmTimer(deadline);
+    }
+    if (timer_wheel_.empty()) timer_guard_ = shutdown_guard_;
+  }
+  // Nothing can expire in an empty wheel, this just catches up with `now`.
+  if (timer_wheel_.empty()) timer_wheel_.Advance(now);
+
+  auto const id = ++next_timer_id_;
+  auto weak = std::weak_ptr<DefaultCompletionQueueImpl>(shared_from_this());
+  promise<TimerResult> p([weak, id] {
+    if (auto self = weak.lock()) self->CancelTimer(id);
+  });
+  auto f = p.get_future();
+  timer_wheel_.Add(id, deadline, WheelTimer{std::move(p), deadline});
+  ArmTimerWheelAlarm();
+  return f;
 }
 
 future<StatusOr<std::chrono::system_clock::time_point>>
@@ -221,6 +326,10 @@ DefaultCompletionQueueImpl::MakeRelativeTimer(
 
 void DefaultCompletionQueueImpl::RunAsync(
     std::unique_ptr<internal::RunAsyncBase> function) {
+  if (executor_) {
+    executor_->Schedule(std::move(function));
+    return;
+  }
   std::unique_lock<std::mutex> lk(mu_);
   run_async_queue_.push_back(std::move(function));
   WakeUpRunAsyncThread(std::move(lk));
@@ -235,6 +344,91 @@ void DefaultCompletionQueueImpl::StartOperation(
 
 grpc::CompletionQueue& DefaultCompletionQueueImpl::cq() { return cq_; }
 
+future<DefaultCompletionQueueImpl::TimerResult>
+DefaultCompletionQueueImpl::MakeAlarmTimer(
+    std::chrono::system_clock::time_point deadline) {
+  auto p = AsyncTimerFuture::Create();
+  auto op = std::move(p.first);
+  StartOperation(op, [&](void* tag) { op->Set(cq(), deadline, tag); });
+  return std::move(p.second);
+}
+
+void DefaultCompletionQueueImpl::ArmTimerWheelAlarm() {
+  auto const next = timer_wheel_.NextExpiration();
+  if (!next) return;
+  // Alarms are never reset, a new alarm is needed only if the next expiration
+  // is earlier than all the outstanding alarms.
+  if (!timer_alarms_.empty() && timer_alarms_.begin()->first <= *next) return;
+  auto alarm = std::make_shared<TimerWheelAlarm>(shared_from_this());
+  timer_alarms_.emplace(*next, alarm);
+  void* tag = static_cast<AsyncGrpcOperation*>(alarm.get());
+  {
+    // Bypass the `shutdown_` check in `StartOperation()`: the wheel is not
+    // empty, so `timer_guard_` keeps the completion queue running.
+    std::lock_guard<std::mutex> lk(mu_);
+    LinkOperation(alarm);
+  }
+  alarm->Set(cq_, *next, tag);
+}
+
+void DefaultCompletionQueueImpl::OnTimerWheelAlarm(TimerWheelAlarm* alarm) {
+  std::vector<WheelTimer> expired;
+  std::vector<std::shared_ptr<TimerWheelAlarm>> alarms;
+  {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    auto loc = std::find_if(
+        timer_alarms_.begin(), timer_alarms_.end(),
+        [alarm](decltype(timer_alarms_)::value_type const& kv) {
+          return kv.second.get() == alarm;
+        });
+    if (loc != timer_alarms_.end()) timer_alarms_.erase(loc);
+    expired = timer_wheel_.Advance(std::chrono::system_clock::now());
+    if (timer_wheel_.empty()) {
+      alarms = ReleaseTimerWheel();
+    } else {
+      ArmTimerWheelAlarm();
+    }
+  }
+  for (auto& a : alarms) a->Cancel();
+  for (auto& t : expired) t.result.set_value(t.deadline);
+}
+
+void DefaultCompletionQueueImpl::CancelTimer(std::uint64_t id) {
+  std::vector<std::shared_ptr<TimerWheelAlarm>> alarms;
+  {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    auto timer = timer_wheel_.Cancel(id);
+    if (!timer) return;
+    CompleteCanceledTimer(std::move(*timer));
+    if (timer_wheel_.empty()) alarms = ReleaseTimerWheel();
+  }
+  for (auto& a : alarms) a->Cancel();
+}
+
+void DefaultCompletionQueueImpl::CompleteCanceledTimer(WheelTimer timer) {
+  auto op = std::make_shared<CanceledTimer>(std::move(timer.result));
+  void* tag = static_cast<AsyncGrpcOperation*>(op.get());
+  {
+    // Bypass the `shutdown_` check in `StartOperation()`: the wheel still holds
+    // `timer_guard_`, so the completion queue is running.
+    std::lock_guard<std::mutex> lk(mu_);
+    LinkOperation(op);
+  }
+  op->Set(cq_, tag);
+}
+
+std::vector<std::shared_ptr<DefaultCompletionQueueImpl::TimerWheelAlarm>>
+DefaultCompletionQueueImpl::ReleaseTimerWheel() {
+  std::vector<std::shared_ptr<TimerWheelAlarm>> alarms;
+  alarms.reserve(timer_alarms_.size());
+  for (auto& kv : timer_alarms_) alarms.push_back(std::move(kv.second));
+  timer_alarms_.clear();
+  // The outstanding alarms are canceled by the caller, and they do not need a
+  // guard: gRPC allows pending operations to complete after `Shutdown()`.
+  timer_guard_.reset();
+  return alarms;
+}
+
 void DefaultCompletionQueueImpl::StartOperation(
     std::unique_lock<std::mutex> lk, std::shared_ptr<AsyncGrpcOperation> op,
     absl::FunctionRef<void(void*)> start) {
@@ -244,8 +438,8 @@ void DefaultCompletionQueueImpl::StartOperation(
     op->Notify(/*ok=*/false);
     return;
   }
-  auto ins = pending_ops_.emplace(tag, std::move(op));
-  if (ins.second) {
+  if (!op->self_) {
+    LinkOperation(std::move(op));
     // Do not start the operation with the `CompletionQueue`'s lock held. This
     // may trigger a deadlock if that operation schedules some more work on the
     // completion queue (e.g. a timer). We need to delay the underlying
@@ -266,25 +460,41 @@ void DefaultCompletionQueueImpl::StartOperation(
   google::cloud::internal::ThrowRuntimeError(std::move(os).str());
 }
 
-std::shared_ptr<AsyncGrpcOperation> DefaultCompletionQueueImpl::FindOperation(
-    void* tag) {
-  std::lock_guard<std::mutex> lk(mu_);
-  auto loc = pending_ops_.find(tag);
-  if (pending_ops_.end() == loc) {
-    google::cloud::internal::ThrowRuntimeError(
-        "assertion failure: searching for async op tag");
+void DefaultCompletionQueueImpl::LinkOperation(
+    std::shared_ptr<AsyncGrpcOperation> op) {
+  auto* p = op.get();
+  p->self_ = std::move(op);
+  p->prev_ = nullptr;
+  p->next_ = pending_ops_;
+  if (pending_ops_ != nullptr) pending_ops_->prev_ = p;
+  pending_ops_ = p;
+}
+
+std::shared_ptr<AsyncGrpcOperation> DefaultCompletionQueueImpl::UnlinkOperation(
+    AsyncGrpcOperation* op) {
+  if (op->prev_ != nullptr) {
+    op->prev_->next_ = op->next_;
+  } else {
+    pending_ops_ = op->next_;
   }
-  return loc->second;
+  if (op->next_ != nullptr) op->next_->prev_ = op->prev_;
+  op->prev_ = nullptr;
+  op->next_ = nullptr;
+  return std::move(op->self_);
 }
 
-void DefaultCompletionQueueImpl::ForgetOperation(void* tag) {
-  std::lock_guard<std::mutex> lk(mu_);
-  auto const num_erased = pending_ops_.erase(tag);
-  if (num_erased != 1) {
-    google::cloud::internal::ThrowRuntimeError(
-        "assertion failure: searching for async op tag when trying to "
-        "unregister");
+void DefaultCompletionQueueImpl::ForgetOperation(AsyncGrpcOperation* op) {
+  std::shared_ptr<AsyncGrpcOperation> self;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!op->self_) {
+      google::cloud::internal::ThrowRuntimeError(
+          "assertion failure: searching for async op tag when trying to "
+          "unregister");
+    }
+    self = UnlinkOperation(op);
   }
+  // The operation may be destroyed here, outside the lock.
 }
 
 void DefaultCompletionQueueImpl::DrainRunAsyncLoop() {
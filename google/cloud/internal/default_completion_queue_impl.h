@@ -16,11 +16,14 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_DEFAULT_COMPLETION_QUEUE_IMPL_H
 
 #include "google/cloud/internal/completion_queue_impl.h"
+#include "google/cloud/internal/timer_wheel.h"
+#include "google/cloud/internal/work_stealing_executor.h"
 #include "google/cloud/version.h"
 #include <atomic>
 #include <cinttypes>
 #include <deque>
-#include <unordered_map>
+#include <map>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -29,13 +32,29 @@ namespace internal {
 
 /**
  * The default implementation for `CompletionQueue`.
+ *
+ * Timers with a deadline in the future are kept in a `TimerWheel`, and a
+ * single `grpc::Alarm` is set for the next expiration of the wheel. This
+ * coalesces timers expiring within the same millisecond, and canceling a timer
+ * removes it from the wheel immediately. As with any other timer, the future
+ * of a canceled timer is satisfied in the threads running the completion
+ * queue, never in the thread calling `cancel()`.
  */
 class DefaultCompletionQueueImpl
     : public CompletionQueueImpl,
       public std::enable_shared_from_this<DefaultCompletionQueueImpl> {
  public:
   DefaultCompletionQueueImpl();
-  ~DefaultCompletionQueueImpl() override = default;
+
+  /**
+   * Create a completion queue that runs `RunAsync()` functors in @p executor.
+   *
+   * The functors run in the executor's threads instead of the threads calling
+   * `Run()`, the gRPC completion queue is only used for RPCs and timers.
+   */
+  explicit DefaultCompletionQueueImpl(
+      std::unique_ptr<WorkStealingExecutor> executor);
+  ~DefaultCompletionQueueImpl() override;
 
   /// Run the event loop until Shutdown() is called.
   void Run() override;
@@ -68,18 +87,57 @@ class DefaultCompletionQueueImpl
   std::int64_t notify_counter() const { return notify_counter_.load(); }
   std::size_t thread_pool_hwm() const { return thread_pool_hwm_; }
   std::size_t run_async_pool_hwm() const { return run_async_pool_hwm_; }
+  WorkStealingExecutor const* executor() const { return executor_.get(); }
+  std::size_t pending_timers() {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    return timer_wheel_.size();
+  }
 
  private:
+  using TimerResult = StatusOr<std::chrono::system_clock::time_point>;
+  struct WheelTimer {
+    promise<TimerResult> result;
+    std::chrono::system_clock::time_point deadline;
+  };
+  class TimerWheelAlarm;
+  class CanceledTimer;
+
+  /// Create a timer backed by its own `grpc::Alarm`.
+  future<TimerResult> MakeAlarmTimer(
+      std::chrono::system_clock::time_point deadline);
+
+  /// Set an alarm for the next expiration in the timer wheel, if needed.
+  void ArmTimerWheelAlarm();  // EXCLUSIVE_LOCKS_REQUIRED(timer_mu_)
+
+  /// Expire the timers in the wheel, called when a `TimerWheelAlarm` fires.
+  void OnTimerWheelAlarm(TimerWheelAlarm* alarm);
+
+  /// Cancel the timer identified by @p id, if it is still in the wheel.
+  void CancelTimer(std::uint64_t id);
+
+  /// Satisfy the future of a timer removed from the wheel, asynchronously.
+  void CompleteCanceledTimer(
+      WheelTimer timer);  // EXCLUSIVE_LOCKS_REQUIRED(timer_mu_)
+
+  /// Release the resources held while the (now empty) timer wheel is active.
+  std::vector<std::shared_ptr<TimerWheelAlarm>>
+  ReleaseTimerWheel();  // EXCLUSIVE_LOCKS_REQUIRED(timer_mu_)
+
   /// Start an operation with the lock already held.
   void StartOperation(std::unique_lock<std::mutex> lk,
                       std::shared_ptr<AsyncGrpcOperation> op,
                       absl::FunctionRef<void(void*)> start);
 
-  /// Return the asynchronous operation associated with @p tag.
-  std::shared_ptr<AsyncGrpcOperation> FindOperation(void* tag);
+  /// Add @p op to the pending operations, it must not be pending already.
+  void LinkOperation(
+      std::shared_ptr<AsyncGrpcOperation> op);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  /// Remove @p op from the pending operations, returning its ownership.
+  std::shared_ptr<AsyncGrpcOperation> UnlinkOperation(
+      AsyncGrpcOperation* op);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
 
-  /// Unregister @p tag from pending operations.
-  void ForgetOperation(void* tag);
+  /// Unregister the completed operation @p op.
+  void ForgetOperation(AsyncGrpcOperation* op);
 
   void RunStart() {
     std::lock_guard<std::mutex> lk(mu_);
@@ -105,11 +163,25 @@ class DefaultCompletionQueueImpl
   std::size_t run_async_pool_size_ = 0;
   std::deque<std::unique_ptr<internal::RunAsyncBase>> run_async_queue_;
   bool shutdown_{false};  // GUARDED_BY(mu_)
-  std::unordered_map<void*, std::shared_ptr<AsyncGrpcOperation>>
-      pending_ops_;  // GUARDED_BY(mu_)
+  // The pending operations form an intrusive list, each operation owns itself
+  // while it is in the list and its address is the gRPC tag.
+  AsyncGrpcOperation* pending_ops_ = nullptr;  // GUARDED_BY(mu_)
   // This member acts as a ref counter. When it drops to 0, it calls
   // `cq_.Shutdown()`. Look into `StartOperation` for why it is necessary.
   std::shared_ptr<void> shutdown_guard_;
+  // If set, `RunAsync()` functors run in this executor.
+  std::unique_ptr<WorkStealingExecutor> executor_;
+
+  // The timer wheel and its alarms. Lock `timer_mu_` before `mu_`.
+  std::mutex timer_mu_;
+  TimerWheel<WheelTimer> timer_wheel_;  // GUARDED_BY(timer_mu_)
+  std::uint64_t next_timer_id_ = 0;     // GUARDED_BY(timer_mu_)
+  // A copy of `shutdown_guard_` held while the wheel has timers, the timers
+  // still run to completion after `Shutdown()`.
+  std::shared_ptr<void> timer_guard_;  // GUARDED_BY(timer_mu_)
+  std::multimap<std::chrono::system_clock::time_point,
+                std::shared_ptr<TimerWheelAlarm>>
+      timer_alarms_;  // GUARDED_BY(timer_mu_)
 
   // These are metrics used in testing.
   std::atomic<std::int64_t> notify_counter_{0};
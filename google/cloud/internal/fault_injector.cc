@@ -0,0 +1,80 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/fault_injector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+// The 99th percentile of the standard normal distribution.
+auto constexpr kNormalP99 = 2.326;
+
+double LogMicros(std::chrono::microseconds d) {
+  return std::log(static_cast<double>((std::max)(d.count(), std::int64_t{1})));
+}
+
+}  // namespace
+
+// The delays have a log-normal distribution, whose median is exp(mu), and
+// 99th percentile is exp(mu + 2.326 * sigma).
+FaultInjector::FaultInjector(FaultInjectionOptions options)
+    : options_(std::move(options)),
+      log_median_(LogMicros(options_.latency_median())),
+      log_sigma_(
+          (std::max)(LogMicros(options_.latency_p99()) - log_median_, 0.0) /
+          kNormalP99),
+      generator_(MakeDefaultPRNG()) {}
+
+std::chrono::microseconds FaultInjector::NextLatency() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!Sample(options_.latency_rate())) return std::chrono::microseconds(0);
+  std::lognormal_distribution<double> latency(log_median_, log_sigma_);
+  return std::chrono::microseconds(
+      static_cast<std::int64_t>(latency(generator_)));
+}
+
+Status FaultInjector::NextError(char const* where) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!Sample(options_.error_rate())) return Status{};
+  return Status(options_.error_code(),
+                std::string("injected fault in ") + where);
+}
+
+bool FaultInjector::NextStreamReset() {
+  std::lock_guard<std::mutex> lk(mu_);
+  return Sample(options_.stream_reset_rate());
+}
+
+Status FaultInjector::StreamResetError(char const* where) const {
+  return Status(options_.error_code(),
+                std::string("injected stream reset in ") + where);
+}
+
+bool FaultInjector::Sample(double rate) {
+  if (rate <= 0) return false;
+  if (rate >= 1) return true;
+  return std::uniform_real_distribution<double>(0, 1)(generator_) < rate;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,87 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FAULT_INJECTOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FAULT_INJECTOR_H
+
+#include "google/cloud/fault_injection_options.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/status.h"
+#include "google/cloud/version.h"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Decides which faults to inject in each call.
+ *
+ * The fault injection stub decorators share one instance of this class for
+ * all their calls.
+ *
+ * @par Thread-safety
+ * Instances of this class are safe to use from multiple threads.
+ */
+class FaultInjector {
+ public:
+  explicit FaultInjector(FaultInjectionOptions options);
+
+  /// The delay to inject before a call, zero if the call is not delayed.
+  std::chrono::microseconds NextLatency();
+
+  /// The error to inject in a call to @p where, OK if the call succeeds.
+  Status NextError(char const* where);
+
+  /// Returns true if the next read in a streaming RPC should fail.
+  bool NextStreamReset();
+
+  /// The status for a stream broken by `NextStreamReset()`.
+  Status StreamResetError(char const* where) const;
+
+  /**
+   * Run a blocking call, injecting the delays and errors.
+   *
+   * The return type of @p call must be constructible from a `Status`, e.g.
+   * `Status` or `StatusOr<T>`.
+   */
+  template <typename Call>
+  auto Run(char const* where, Call&& call) -> decltype(call()) {
+    auto const delay = NextLatency();
+    if (delay.count() != 0) std::this_thread::sleep_for(delay);
+    auto status = NextError(where);
+    if (!status.ok()) return status;
+    return call();
+  }
+
+ private:
+  bool Sample(double rate);
+
+  FaultInjectionOptions const options_;
+  double const log_median_;
+  double const log_sigma_;
+  std::mutex mu_;
+  DefaultPRNG generator_;  // GUARDED_BY(mu_)
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FAULT_INJECTOR_H
@@ -0,0 +1,103 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/fault_injector.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::HasSubstr;
+
+TEST(FaultInjectorTest, Disabled) {
+  FaultInjectionOptions options;
+  EXPECT_FALSE(options.enabled());
+  FaultInjector tested(options);
+  for (int i = 0; i != 100; ++i) {
+    EXPECT_EQ(0, tested.NextLatency().count());
+    EXPECT_STATUS_OK(tested.NextError("Test"));
+    EXPECT_FALSE(tested.NextStreamReset());
+  }
+}
+
+TEST(FaultInjectorTest, AlwaysFail) {
+  auto options = FaultInjectionOptions{}
+                     .set_error_rate(1.0)
+                     .set_error_code(StatusCode::kDeadlineExceeded)
+                     .set_stream_reset_rate(1.0);
+  EXPECT_TRUE(options.enabled());
+  FaultInjector tested(options);
+  EXPECT_THAT(tested.NextError("Test"),
+              StatusIs(StatusCode::kDeadlineExceeded, HasSubstr("Test")));
+  EXPECT_TRUE(tested.NextStreamReset());
+  EXPECT_THAT(tested.StreamResetError("Read"),
+              StatusIs(StatusCode::kDeadlineExceeded, HasSubstr("Read")));
+
+  int calls = 0;
+  auto status = tested.Run("Run", [&calls] {
+    ++calls;
+    return Status{};
+  });
+  EXPECT_THAT(status, StatusIs(StatusCode::kDeadlineExceeded));
+  EXPECT_EQ(0, calls);
+}
+
+TEST(FaultInjectorTest, ErrorRate) {
+  FaultInjector tested(FaultInjectionOptions{}.set_error_rate(0.25));
+  int errors = 0;
+  for (int i = 0; i != 10000; ++i) {
+    if (!tested.NextError("Test").ok()) ++errors;
+  }
+  // With 10,000 samples this is more than 10 standard deviations.
+  EXPECT_GT(errors, 2000);
+  EXPECT_LT(errors, 3000);
+}
+
+TEST(FaultInjectorTest, LatencyDistribution) {
+  FaultInjector tested(FaultInjectionOptions{}
+                           .set_latency_rate(1.0)
+                           .set_latency_median(std::chrono::milliseconds(10))
+                           .set_latency_p99(std::chrono::milliseconds(100)));
+  std::vector<std::int64_t> samples;
+  for (int i = 0; i != 10000; ++i) {
+    samples.push_back(tested.NextLatency().count());
+  }
+  std::sort(samples.begin(), samples.end());
+  EXPECT_NEAR(10000, static_cast<double>(samples[5000]), 1000);
+  EXPECT_NEAR(100000, static_cast<double>(samples[9900]), 20000);
+}
+
+TEST(FaultInjectorTest, RunSuccess) {
+  FaultInjector tested(FaultInjectionOptions{}
+                           .set_latency_rate(1.0)
+                           .set_latency_median(std::chrono::microseconds(1))
+                           .set_latency_p99(std::chrono::microseconds(1)));
+  auto value = tested.Run("Run", [] { return StatusOr<int>(42); });
+  ASSERT_STATUS_OK(value);
+  EXPECT_EQ(42, *value);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -14,35 +14,160 @@
 
 #include "google/cloud/internal/format_time_point.h"
 #include "absl/time/time.h"
+#include <cstdint>
 
 namespace google {
 namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
 namespace internal {
+namespace {
+
+// These functions format timestamps for every request and every object
+// metadata field, they avoid the generic (and allocation heavy)
+// `absl::FormatTime()` for the years that can be printed as 4 digits, which
+// covers any time point with nanosecond precision.
+
+struct CivilTime {
+  std::int64_t year;
+  int month;
+  int day;
+  int hour;
+  int minute;
+  int second;
+  std::int64_t nanos;
+};
+
+// Converts days since 1970-01-01 to a date in the proleptic Gregorian calendar,
+// see http://howardhinnant.github.io/date_algorithms.html
+void CivilFromDays(std::int64_t z, CivilTime& ct) {
+  z += 719468;
+  std::int64_t const era = (z >= 0 ? z : z - 146096) / 146097;
+  auto const doe = z - era * 146097;
+  auto const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  auto const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  auto const mp = (5 * doy + 2) / 153;
+  ct.day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+  ct.month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+  ct.year = yoe + era * 400 + (ct.month <= 2 ? 1 : 0);
+}
+
+/// Breaks down @p tp in UTC, returns false if the year needs more than 4
+/// digits.
+bool ToCivilTime(std::chrono::system_clock::time_point tp, CivilTime& ct) {
+  using std::chrono::duration_cast;
+  auto const since_epoch = tp.time_since_epoch();
+  // Avoid overflows rounding the seconds below, such old time points are
+  // formatted by the slow path anyway.
+  auto const lowest =
+      std::chrono::system_clock::duration::min() + std::chrono::seconds(1);
+  if (since_epoch < lowest) return false;
+  auto s = duration_cast<std::chrono::seconds>(since_epoch);
+  // Round towards the past, `duration_cast<>` rounds towards zero.
+  if (s > since_epoch) s -= std::chrono::seconds(1);
+  ct.nanos = duration_cast<std::chrono::nanoseconds>(since_epoch - s).count();
+
+  auto const kSecondsPerDay = 86400;
+  auto seconds = s.count();
+  auto days = seconds / kSecondsPerDay;
+  auto sod = seconds % kSecondsPerDay;
+  if (sod < 0) {
+    sod += kSecondsPerDay;
+    --days;
+  }
+  CivilFromDays(days, ct);
+  ct.hour = static_cast<int>(sod / 3600);
+  ct.minute = static_cast<int>(sod / 60 % 60);
+  ct.second = static_cast<int>(sod % 60);
+  return ct.year >= 0 && ct.year <= 9999;
+}
+
+char* PutDigits(char* p, std::int64_t value, int width) {
+  for (int i = width - 1; i >= 0; --i) {
+    p[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  return p + width;
+}
+
+char* PutDate(char* p, CivilTime const& ct, bool separators) {
+  p = PutDigits(p, ct.year, 4);
+  if (separators) *p++ = '-';
+  p = PutDigits(p, ct.month, 2);
+  if (separators) *p++ = '-';
+  return PutDigits(p, ct.day, 2);
+}
+
+}  // namespace
 
 std::string FormatRfc3339(std::chrono::system_clock::time_point tp) {
-  auto constexpr kFormat = "%E4Y-%m-%dT%H:%M:%E*SZ";
-  auto const t = absl::FromChrono(tp);
-  return absl::FormatTime(kFormat, t, absl::UTCTimeZone());
+  CivilTime ct;
+  if (!ToCivilTime(tp, ct)) {
+    auto constexpr kFormat = "%E4Y-%m-%dT%H:%M:%E*SZ";
+    auto const t = absl::FromChrono(tp);
+    return absl::FormatTime(kFormat, t, absl::UTCTimeZone());
+  }
+  // YYYY-MM-DDTHH:MM:SS.NNNNNNNNNZ
+  char buffer[32];
+  char* p = PutDate(buffer, ct, true);
+  *p++ = 'T';
+  p = PutDigits(p, ct.hour, 2);
+  *p++ = ':';
+  p = PutDigits(p, ct.minute, 2);
+  *p++ = ':';
+  p = PutDigits(p, ct.second, 2);
+  if (ct.nanos != 0) {
+    // Print only the significant digits of the fractional seconds.
+    auto nanos = ct.nanos;
+    int width = 9;
+    while (nanos % 10 == 0) {
+      nanos /= 10;
+      --width;
+    }
+    *p++ = '.';
+    p = PutDigits(p, nanos, width);
+  }
+  *p++ = 'Z';
+  return std::string(buffer, p);
 }
 
 std::string FormatUtcDate(std::chrono::system_clock::time_point tp) {
-  auto constexpr kFormat = "%E4Y-%m-%d";
-  auto const t = absl::FromChrono(tp);
-  return absl::FormatTime(kFormat, t, absl::UTCTimeZone());
+  CivilTime ct;
+  if (!ToCivilTime(tp, ct)) {
+    auto constexpr kFormat = "%E4Y-%m-%d";
+    auto const t = absl::FromChrono(tp);
+    return absl::FormatTime(kFormat, t, absl::UTCTimeZone());
+  }
+  char buffer[16];
+  return std::string(buffer, PutDate(buffer, ct, true));
 }
 
 std::string FormatV4SignedUrlTimestamp(
     std::chrono::system_clock::time_point tp) {
-  auto constexpr kFormat = "%E4Y%m%dT%H%M%SZ";
-  auto const t = absl::FromChrono(tp);
-  return absl::FormatTime(kFormat, t, absl::UTCTimeZone());
+  CivilTime ct;
+  if (!ToCivilTime(tp, ct)) {
+    auto constexpr kFormat = "%E4Y%m%dT%H%M%SZ";
+    auto const t = absl::FromChrono(tp);
+    return absl::FormatTime(kFormat, t, absl::UTCTimeZone());
+  }
+  char buffer[24];
+  char* p = PutDate(buffer, ct, false);
+  *p++ = 'T';
+  p = PutDigits(p, ct.hour, 2);
+  p = PutDigits(p, ct.minute, 2);
+  p = PutDigits(p, ct.second, 2);
+  *p++ = 'Z';
+  return std::string(buffer, p);
 }
 
 std::string FormatV4SignedUrlScope(std::chrono::system_clock::time_point tp) {
-  auto constexpr kFormat = "%E4Y%m%d";
-  auto const t = absl::FromChrono(tp);
-  return absl::FormatTime(kFormat, t, absl::UTCTimeZone());
+  CivilTime ct;
+  if (!ToCivilTime(tp, ct)) {
+    auto constexpr kFormat = "%E4Y%m%d";
+    auto const t = absl::FromChrono(tp);
+    return absl::FormatTime(kFormat, t, absl::UTCTimeZone());
+  }
+  char buffer[16];
+  return std::string(buffer, PutDate(buffer, ct, false));
 }
 
 }  // namespace internal
@@ -72,6 +72,29 @@ TEST(FormatRfc3339Test, FractionalNanos) {
   }
 }
 
+TEST(FormatRfc3339Test, BeforeEpoch) {
+  auto timestamp = ParseRfc3339("1969-12-31T23:59:59.5Z");
+  EXPECT_EQ("1969-12-31T23:59:59.5Z", FormatRfc3339(timestamp));
+  timestamp = ParseRfc3339("1900-02-28T12:00:00Z");
+  EXPECT_EQ("1900-02-28T12:00:00Z", FormatRfc3339(timestamp));
+}
+
+TEST(FormatRfc3339Test, RoundTrip) {
+  for (auto const* input : {
+           "1970-01-01T00:00:00Z",
+           "2000-02-29T23:59:59.999Z",
+           "2020-12-31T00:00:00.000001Z",
+           "2100-03-01T01:02:03.1Z",
+       }) {
+    EXPECT_EQ(input, FormatRfc3339(ParseRfc3339(input)));
+  }
+}
+
+TEST(FormatUtcDateTest, Base) {
+  auto timestamp = ParseRfc3339("2019-08-02T01:02:03Z");
+  EXPECT_EQ("2019-08-02", FormatUtcDate(timestamp));
+}
+
 TEST(FormatV4SignedUrlTimestampTest, Base) {
   auto timestamp = ParseRfc3339("2019-08-02T01:02:03Z");
   std::string actual = FormatV4SignedUrlTimestamp(timestamp);
@@ -0,0 +1,137 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FUTURE_COROUTINES_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FUTURE_COROUTINES_H
+/**
+ * @file
+ *
+ * Support C++20 coroutines with `google::cloud::future<T>`.
+ *
+ * When the compiler supports coroutines, a `future<T>` can be awaited with
+ * `co_await`, and any function returning `future<T>` may be a coroutine:
+ *
+ * @code
+ * future<StatusOr<int>> Example(CompletionQueue cq) {
+ *   auto timer = co_await cq.MakeRelativeTimer(std::chrono::seconds(1));
+ *   if (!timer) co_return std::move(timer).status();
+ *   co_return 42;
+ * }
+ * @endcode
+ *
+ * The code after a `co_await` runs in the thread that satisfies the awaited
+ * future, typically a thread running `CompletionQueue::Run()`, exactly as a
+ * `.then()` continuation would.
+ */
+
+#include "google/cloud/internal/future_then_impl.h"
+#include "google/cloud/version.h"
+
+#if GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/// The awaiter returned by `co_await` on a `future<T>`.
+template <typename T>
+class FutureAwaiter {
+ public:
+  explicit FutureAwaiter(future<T> f) : future_(std::move(f)) {}
+
+  bool await_ready() const { return future_.is_ready(); }
+
+  void await_suspend(std::coroutine_handle<> h) {
+    // `then()` may run the continuation (and therefore resume the coroutine,
+    // possibly destroying `*this`) before it returns, so do not touch any
+    // members after this call.
+    auto f = std::move(future_);
+    f.then([this, h](future<T> ready) {
+      future_ = std::move(ready);
+      h.resume();
+    });
+  }
+
+  T await_resume() { return future_.get(); }
+
+ private:
+  future<T> future_;
+};
+
+/// The parts of the coroutine promise type shared by all `future<T>`.
+template <typename T>
+class FuturePromiseBase {
+ public:
+  future<T> get_return_object() { return promise_.get_future(); }
+
+  // The coroutine starts running immediately, like any other function, and
+  // its frame is destroyed as soon as it completes, the result lives in the
+  // future's shared state.
+  std::suspend_never initial_suspend() const noexcept { return {}; }
+  std::suspend_never final_suspend() const noexcept { return {}; }
+
+  void unhandled_exception() {
+    promise_.set_exception(std::current_exception());
+  }
+
+ protected:
+  promise<T> promise_;
+};
+
+/// The coroutine promise type for functions returning `future<T>`.
+template <typename T>
+class FuturePromise : public FuturePromiseBase<T> {
+ public:
+  void return_value(T value) { this->promise_.set_value(std::move(value)); }
+};
+
+/// The coroutine promise type for functions returning `future<void>`.
+template <>
+class FuturePromise<void> : public FuturePromiseBase<void> {
+ public:
+  void return_void() { this->promise_.set_value(); }
+};
+
+}  // namespace internal
+
+/**
+ * Suspends the current coroutine until @p f is satisfied.
+ *
+ * The future is consumed, `co_await` returns the value (or rethrows the
+ * exception) stored in it.
+ */
+template <typename T>
+internal::FutureAwaiter<T> operator co_await(future<T>&& f) {
+  return internal::FutureAwaiter<T>(std::move(f));
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+namespace std {
+/// Allow functions returning `google::cloud::future<T>` to be coroutines.
+template <typename T, typename... Args>
+struct coroutine_traits<google::cloud::future<T>, Args...> {
+  using promise_type = google::cloud::internal::FuturePromise<T>;
+};
+}  // namespace std
+
+#endif  // GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FUTURE_COROUTINES_H
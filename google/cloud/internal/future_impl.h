@@ -24,10 +24,13 @@
 #include "google/cloud/terminate_handler.h"
 #include "google/cloud/version.h"
 #include "absl/memory/memory.h"
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <exception>
 #include <future>
 #include <mutex>
+#include <type_traits>
 
 namespace google {
 namespace cloud {
@@ -61,6 +64,24 @@ class continuation_base {  // NOLINT(readability-identifier-naming)
  * `future<void>` share a lot of code. This class refactors that code, it
  * represents a shared state of unknown type.
  *
+ * The state transitions are implemented as a small state machine over a single
+ * atomic word:
+ *
+ * - A producer (`set_value()`, `set_exception()`, `abandon()`) first claims the
+ *   state by setting `kSatisfying`, stores the value or exception, and then
+ *   publishes the result by setting `kReady`.
+ * - A consumer (`.then()`) stores the continuation and publishes it by setting
+ *   `kHasContinuation`.
+ * - Whichever side sets its bit second runs the continuation, so it runs
+ *   exactly once, and without any locks held.
+ *
+ * The mutex and condition variable are only used when a thread blocks in
+ * `wait()`, `wait_for()`, `wait_until()` or `get()`. Such threads set
+ * `kHasWaiters`, and the producer only touches the mutex if that bit is set.
+ *
+ * Continuations small enough are stored in a buffer inside the shared state,
+ * avoiding a heap allocation for most `.then()` calls.
+ *
  * @note While most of the invariants for promises and futures are implemented
  *   by this class, not all of them are. Notably, future values can only be
  *   retrieved once, but this is enforced because calling `.get()` or `.then()`
@@ -71,12 +92,12 @@ class future_shared_state_base {  // NOLINT(readability-identifier-naming)
  public:
   future_shared_state_base() : future_shared_state_base([] {}) {}
   explicit future_shared_state_base(std::function<void()> cancellation_callback)
-      : current_state_(state::not_ready),
-        cancellation_callback_(std::move(cancellation_callback)) {}
+      : cancellation_callback_(std::move(cancellation_callback)) {}
+  ~future_shared_state_base() { destroy_continuation(); }
+
   /// Return true if the shared state has a value or an exception.
   bool is_ready() const {
-    std::unique_lock<std::mutex> lk(mu_);
-    return is_ready_unlocked();
+    return (state_.load(std::memory_order_acquire) & kReady) != 0;
   }
 
   /// Return true if the shared state can be cancelled.
@@ -84,8 +105,10 @@ class future_shared_state_base {  // NOLINT(readability-identifier-naming)
 
   /// Block until is_ready() returns true ...
   void wait() {
+    if (is_ready()) return;
     std::unique_lock<std::mutex> lk(mu_);
-    cv_.wait(lk, [this] { return is_ready_unlocked(); });
+    state_.fetch_or(kHasWaiters, std::memory_order_acq_rel);
+    cv_.wait(lk, [this] { return is_ready(); });
   }
 
   /**
@@ -112,13 +135,14 @@ class future_shared_state_base {  // NOLINT(readability-identifier-naming)
    */
   template <typename Rep, typename Period>
   std::future_status wait_for(std::chrono::duration<Rep, Period> duration) {
+    if (is_ready()) return std::future_status::ready;
     std::unique_lock<std::mutex> lk(mu_);
-    bool result =
-        cv_.wait_for(lk, duration, [this] { return is_ready_unlocked(); });
+    state_.fetch_or(kHasWaiters, std::memory_order_acq_rel);
+    bool result = cv_.wait_for(lk, duration, [this] { return is_ready(); });
     if (result) {
       return std::future_status::ready;
     }
-    if (continuation_) {
+    if (has_continuation()) {
       return std::future_status::deferred;
     }
     return std::future_status::timeout;
@@ -142,16 +166,14 @@ class future_shared_state_base {  // NOLINT(readability-identifier-naming)
    */
   template <typename Clock>
   std::future_status wait_until(std::chrono::time_point<Clock> deadline) {
+    if (is_ready()) return std::future_status::ready;
     std::unique_lock<std::mutex> lk(mu_);
-    if (!lk.owns_lock()) {
-      return std::future_status::timeout;
-    }
-    bool result =
-        cv_.wait_until(lk, deadline, [this] { return is_ready_unlocked(); });
+    state_.fetch_or(kHasWaiters, std::memory_order_acq_rel);
+    bool result = cv_.wait_until(lk, deadline, [this] { return is_ready(); });
     if (result) {
       return std::future_status::ready;
     }
-    if (continuation_) {
+    if (has_continuation()) {
       return std::future_status::deferred;
     }
     return std::future_status::timeout;
@@ -159,9 +181,9 @@ class future_shared_state_base {  // NOLINT(readability-identifier-naming)
 
   /// Set the shared state to hold an exception and notify immediately.
   void set_exception(std::exception_ptr ex) {
-    std::unique_lock<std::mutex> lk(mu_);
-    set_exception(std::move(ex), lk);
-    notify_now(std::move(lk));
+    claim(__func__);
+    exception_ = std::move(ex);
+    mark_ready(kHasException);
   }
 
   /**
@@ -171,36 +193,70 @@ class future_shared_state_base {  // NOLINT(readability-identifier-naming)
    * has no effect, but otherwise the state is satisfied with an
    * `std::future_error` exception. The error code is
    * `std::future_errc::broken_promise`.
+   *
+   * Abandoning the state wakes up any blocked threads, but does not run the
+   * continuation, if any.
    */
   void abandon() {
-    std::unique_lock<std::mutex> lk(mu_);
-    if (is_ready_unlocked()) {
-      return;
-    }
+    auto const old = state_.fetch_or(kSatisfying, std::memory_order_acq_rel);
+    if ((old & kSatisfying) != 0) return;
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
-    set_exception(std::make_exception_ptr(
-                      std::future_error(std::future_errc::broken_promise)),
-                  lk);
+    exception_ = std::make_exception_ptr(
+        std::future_error(std::future_errc::broken_promise));
 #else
-    set_exception(nullptr, lk);
+    exception_ = nullptr;
 #endif
-    cv_.notify_all();
+    mark_ready(kHasException, /*run_continuation=*/false);
   }
 
-  void set_continuation(std::unique_ptr<continuation_base> c) {
-    std::unique_lock<std::mutex> lk(mu_);
-    if (continuation_) {
+  /**
+   * Construct a continuation of type `C` in this shared state.
+   *
+   * The continuation is constructed in the small buffer inside the shared
+   * state if it fits, otherwise it is allocated on the heap. The continuation
+   * does not run until `publish_continuation()` is called.
+   *
+   * @return a pointer to the new continuation, owned by the shared state.
+   * @throws std::future_error if the state already has a continuation.
+   */
+  template <typename C, typename... Args>
+  C* emplace_continuation(Args&&... args) {
+    if (continuation_ != nullptr) {
       ThrowFutureError(std::future_errc::future_already_retrieved, __func__);
     }
-    // If the future is already satisfied, invoke the continuation immediately.
-    if (is_ready_unlocked()) {
-      // Release the lock before calling the user's code, holding locks during
-      // callbacks is a bad practice.
-      lk.unlock();
-      c->execute();
-      return;
+    using fits_inline =
+        std::integral_constant<bool,
+                               sizeof(C) <= sizeof(continuation_buffer_t) &&
+                                   alignof(C) <= alignof(continuation_buffer_t)>;
+    C* c = new_continuation<C>(fits_inline{}, std::forward<Args>(args)...);
+    continuation_inline_ = fits_inline::value;
+    continuation_ = c;
+    return c;
+  }
+
+  /**
+   * Make the continuation created by `emplace_continuation()` visible to the
+   * producer.
+   *
+   * If the shared state is already satisfied the continuation runs
+   * immediately, in the calling thread, otherwise it runs in the thread that
+   * satisfies the shared state.
+   */
+  void publish_continuation() {
+    auto const old =
+        state_.fetch_or(kHasContinuation, std::memory_order_acq_rel);
+    if ((old & kReady) == 0) return;
+    continuation_->execute();
+    destroy_continuation();
+  }
+
+  void set_continuation(std::unique_ptr<continuation_base> c) {
+    if (continuation_ != nullptr) {
+      ThrowFutureError(std::future_errc::future_already_retrieved, __func__);
     }
-    continuation_ = std::move(c);
+    continuation_ = c.release();
+    continuation_inline_ = false;
+    publish_continuation();
   }
 
   std::function<void()> release_cancellation_callback() {
@@ -221,32 +277,84 @@ class future_shared_state_base {  // NOLINT(readability-identifier-naming)
   }
 
  protected:
-  bool is_ready_unlocked() const { return current_state_ != state::not_ready; }
+  enum : unsigned {
+    /// A producer has claimed the state and is storing a value or exception.
+    kSatisfying = 1U << 0,
+    /// The value or exception is stored and visible to consumers.
+    kReady = 1U << 1,
+    /// The state holds an exception, only meaningful with `kReady`.
+    kHasException = 1U << 2,
+    /// A continuation is stored and visible to producers.
+    kHasContinuation = 1U << 3,
+    /// At least one thread is (or was) blocked on `cv_`.
+    kHasWaiters = 1U << 4,
+  };
+
+  bool has_value() const {
+    return (state_.load(std::memory_order_acquire) &
+            (kReady | kHasException)) == kReady;
+  }
+
+  bool has_exception() const {
+    auto const s = state_.load(std::memory_order_acquire);
+    return (s & kReady) != 0 && (s & kHasException) != 0;
+  }
 
-  /// Satisfy the shared state using an exception.
-  void set_exception(std::exception_ptr ex, std::unique_lock<std::mutex>&) {
-    if (is_ready_unlocked()) {
-      ThrowFutureError(std::future_errc::promise_already_satisfied, __func__);
+  bool has_continuation() const {
+    return (state_.load(std::memory_order_acquire) & kHasContinuation) != 0;
+  }
+
+  /**
+   * Claim the right to satisfy the shared state.
+   *
+   * @throws std::future_error if the state was already claimed. The error code
+   *     is `std::future_errc::promise_already_satisfied`.
+   */
+  void claim(char const* func) {
+    auto const old = state_.fetch_or(kSatisfying, std::memory_order_acq_rel);
+    if ((old & kSatisfying) != 0) {
+      ThrowFutureError(std::future_errc::promise_already_satisfied, func);
     }
-    exception_ = std::move(ex);
-    current_state_ = state::has_exception;
   }
 
-  /// If needed, notify any waiting threads that the shared state is satisfied.
-  void notify_now(std::unique_lock<std::mutex> lk) {
-    if (continuation_) {
-      // Release the lock before calling the continuation because the
-      // continuation will likely call get() to fetch the state of the future.
-      lk.unlock();
+  /// Release a claim if storing the value fails, the state can be satisfied
+  /// again.
+  void unclaim() {
+    state_.fetch_and(~static_cast<unsigned>(kSatisfying),
+                     std::memory_order_acq_rel);
+  }
+
+  /**
+   * Publish the value or exception and notify the consumer.
+   *
+   * Runs the continuation if one was published before this call, otherwise
+   * wakes up any threads blocked on the condition variable.
+   */
+  void mark_ready(unsigned kind, bool run_continuation = true) {
+    auto const old =
+        state_.fetch_or(kReady | kind, std::memory_order_acq_rel);
+    if (run_continuation && (old & kHasContinuation) != 0) {
       continuation_->execute();
       // If there is a continuation there can be no threads blocked on get() or
       // wait() because then() invalidates the future. Therefore we can return
       // without notifying any other threads.
       return;
     }
+    if ((old & kHasWaiters) == 0) return;
+    std::lock_guard<std::mutex> lk(mu_);
     cv_.notify_all();
   }
 
+  void destroy_continuation() {
+    if (continuation_ == nullptr) return;
+    if (continuation_inline_) {
+      continuation_->~continuation_base();
+    } else {
+      delete continuation_;
+    }
+    continuation_ = nullptr;
+  }
+
   /**
    * The implementation details for `promise<T>::get_future()`.
    *
@@ -284,24 +392,42 @@ class future_shared_state_base {  // NOLINT(readability-identifier-naming)
   /// Keep track of whether `get_future()` has been called.
   std::atomic_flag retrieved_ = ATOMIC_FLAG_INIT;
 
-  mutable std::mutex mu_;
+  /// The state machine, a combination of the `k*` bits.
+  std::atomic<unsigned> state_ = ATOMIC_VAR_INIT(0U);
+
+  /// Only used to block threads in `wait()` and friends.
+  std::mutex mu_;
   std::condition_variable cv_;
-  enum class state {
-    not_ready,      // NOLINT(readability-identifier-naming)
-    has_exception,  // NOLINT(readability-identifier-naming)
-    has_value,      // NOLINT(readability-identifier-naming)
-  };
-  state current_state_;
   std::exception_ptr exception_;
 
   /**
    * The continuation, if any, associated with this shared state.
    *
    * Note that continuations may be set independently of having a value or
-   * exception. Setting a continuation does not change the `current_state_`
-   * member variable and does not satisfy the shared state.
+   * exception. Setting a continuation does not satisfy the shared state.
+   *
+   * Points into `continuation_buffer_` when `continuation_inline_` is true,
+   * otherwise to a heap allocated object.
    */
-  std::unique_ptr<continuation_base> continuation_;
+  continuation_base* continuation_ = nullptr;
+  bool continuation_inline_ = false;
+
+  // Dispatch at compile time, a runtime branch makes GCC warn about the
+  // (unreachable) placement new of continuations larger than the buffer.
+  template <typename C, typename... Args>
+  C* new_continuation(std::true_type, Args&&... args) {
+    return new (&continuation_buffer_) C(std::forward<Args>(args)...);
+  }
+  template <typename C, typename... Args>
+  C* new_continuation(std::false_type, Args&&... args) {
+    return new C(std::forward<Args>(args)...);
+  }
+
+  /// Continuations up to this size do not require a heap allocation.
+  static std::size_t constexpr kContinuationBufferSize = 96;
+  using continuation_buffer_t =
+      std::aligned_storage<kContinuationBufferSize>::type;
+  continuation_buffer_t continuation_buffer_;
 
   // Allow users "cancel" the future with the given callback.
   std::atomic<bool> cancelled_ = ATOMIC_VAR_INIT(false);
@@ -337,8 +463,8 @@ class future_shared_state final : private future_shared_state_base {
   explicit future_shared_state(std::function<void()> cancellation_callback)
       : future_shared_state_base(std::move(cancellation_callback)), buffer_() {}
   ~future_shared_state() {
-    if (current_state_ == state::has_value) {
-      // Recall that state::has_value is a terminal state, once a value is
+    if (has_value()) {
+      // Recall that having a value is a terminal state, once a value is
       // stored in this class nothing else (no exceptions nor continuations)
       // can be stored.  And if a value was stored then we need to call the
       // destructor. Even if the value was moved out, the destructor still
@@ -349,7 +475,9 @@ class future_shared_state final : private future_shared_state_base {
 
   using future_shared_state_base::abandon;
   using future_shared_state_base::cancel;
+  using future_shared_state_base::emplace_continuation;
   using future_shared_state_base::is_ready;
+  using future_shared_state_base::publish_continuation;
   using future_shared_state_base::release_cancellation_callback;
   using future_shared_state_base::set_continuation;
   using future_shared_state_base::set_exception;
@@ -359,9 +487,8 @@ class future_shared_state final : private future_shared_state_base {
 
   /// The implementation details for `future<T>::get()`
   T get() {
-    std::unique_lock<std::mutex> lk(mu_);
-    cv_.wait(lk, [this] { return is_ready_unlocked(); });
-    if (current_state_ == state::has_exception) {
+    wait();
+    if (has_exception()) {
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
       std::rethrow_exception(exception_);
 #else
@@ -386,21 +513,22 @@ class future_shared_state final : private future_shared_state_base {
    *     error code is `std::future_errc::promise_already_satisfied`.
    */
   void set_value(T value) {
-    std::unique_lock<std::mutex> lk(mu_);
-    if (is_ready_unlocked()) {
-      ThrowFutureError(std::future_errc::promise_already_satisfied, __func__);
+    claim(__func__);
+    // Only one thread can claim the state. Therefore we know that `buffer_`
+    // has not been initialized and calling placement new via the move
+    // constructor is the best way to initialize the buffer. No locks are held
+    // while the move constructor runs.
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    try {
+      new (reinterpret_cast<T*>(&buffer_)) T(std::move(value));
+    } catch (...) {
+      unclaim();
+      throw;
     }
-    // We can only reach this point once, all other states are terminal.
-    // Therefore we know that `buffer_` has not been initialized and calling
-    // placement new via the move constructor is the best way to initialize the
-    // buffer.
-
-    // TODO(#1405) - this is calling application code while holding a lock.
-    // That could result in a deadlock (or at least unbounded priority
-    // inversions) if the move constructor for `T` takes a long time to execute.
+#else
     new (reinterpret_cast<T*>(&buffer_)) T(std::move(value));
-    current_state_ = state::has_value;
-    notify_now(std::move(lk));
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    mark_ready(0);
   }
 
   /**
@@ -478,7 +606,9 @@ class future_shared_state<void> final : private future_shared_state_base {
 
   using future_shared_state_base::abandon;
   using future_shared_state_base::cancel;
+  using future_shared_state_base::emplace_continuation;
   using future_shared_state_base::is_ready;
+  using future_shared_state_base::publish_continuation;
   using future_shared_state_base::release_cancellation_callback;
   using future_shared_state_base::set_continuation;
   using future_shared_state_base::set_exception;
@@ -488,9 +618,8 @@ class future_shared_state<void> final : private future_shared_state_base {
 
   /// The implementation details for `future<void>::get()`
   void get() {
-    std::unique_lock<std::mutex> lk(mu_);
-    cv_.wait(lk, [this] { return is_ready_unlocked(); });
-    if (current_state_ == state::has_exception) {
+    wait();
+    if (has_exception()) {
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
       std::rethrow_exception(exception_);
 #else
@@ -502,9 +631,8 @@ class future_shared_state<void> final : private future_shared_state_base {
 
   /// The implementation details for `promise<void>::set_value()`
   void set_value() {
-    std::unique_lock<std::mutex> lk(mu_);
-    set_value(lk);
-    notify_now(std::move(lk));
+    claim(__func__);
+    mark_ready(0);
   }
 
   /**
@@ -568,14 +696,6 @@ class future_shared_state<void> final : private future_shared_state_base {
   static void mark_retrieved(std::shared_ptr<future_shared_state> const& sh) {
     future_shared_state_base::mark_retrieved(sh.get());
   }
-
- private:
-  void set_value(std::unique_lock<std::mutex> const&) {
-    if (is_ready_unlocked()) {
-      ThrowFutureError(std::future_errc::promise_already_satisfied, __func__);
-    }
-    current_state_ = state::has_value;
-  }
 };
 
 /**
@@ -763,13 +883,12 @@ struct unwrapping_continuation : public continuation_base {
       return r->get();
     };
     using continuation_type = internal::continuation<decltype(unwrapper), R>;
-    auto continuation = absl::make_unique<continuation_type>(
-        std::move(unwrapper), intermediate, output);
     // assert(intermediate->continuation_ == nullptr)
     // If intermediate has a continuation then the associated future would have
     // been invalid, and we never get here.
-    intermediate->set_continuation(
-        std::unique_ptr<continuation_base>(std::move(continuation)));
+    intermediate->template emplace_continuation<continuation_type>(
+        std::move(unwrapper), intermediate, output);
+    intermediate->publish_continuation();
   }
 
   /// The functor called when `input` is satisfied.
@@ -792,11 +911,12 @@ std::shared_ptr<typename internal::continuation_helper<F, T>::state_t>
 future_shared_state<T>::make_continuation(
     std::shared_ptr<future_shared_state<T>> self, F&& functor) {
   using continuation_type = internal::continuation<F, T>;
-  auto continuation =
-      absl::make_unique<continuation_type>(std::forward<F>(functor), self);
+  auto* continuation = self->template emplace_continuation<continuation_type>(
+      std::forward<F>(functor), self);
+  // Save the value of `continuation->output`, because the continuation may
+  // run, and reset it, as soon as it is published.
   auto result = continuation->output;
-  self->set_continuation(
-      std::unique_ptr<continuation_base>(std::move(continuation)));
+  self->publish_continuation();
   return result;
 }
 
@@ -814,13 +934,12 @@ future_shared_state<T>::make_continuation(
 
   // First create a continuation that calls the functor, and stores the result
   // in a `future_shared_state<future_shared_state<R>>`
-  auto continuation =
-      absl::make_unique<continuation_type>(std::forward<F>(functor), self);
-  // Save the value of `continuation->output`, because the move will make it
-  // inaccessible.
+  auto* continuation = self->template emplace_continuation<continuation_type>(
+      std::forward<F>(functor), self);
+  // Save the value of `continuation->output`, because the continuation may
+  // run, and reset it, as soon as it is published.
   std::shared_ptr<future_shared_state<R>> result = continuation->output;
-  self->set_continuation(
-      std::unique_ptr<continuation_base>(std::move(continuation)));
+  self->publish_continuation();
   return result;
 }
 
@@ -830,13 +949,12 @@ std::shared_ptr<typename internal::continuation_helper<F, void>::state_t>
 future_shared_state<void>::make_continuation(
     std::shared_ptr<future_shared_state<void>> self, F&& functor) {
   using continuation_type = internal::continuation<F, void>;
-  auto continuation =
-      absl::make_unique<continuation_type>(std::forward<F>(functor), self);
-  // Save the value of `continuation->output`, because the move will make it
-  // inaccessible.
+  auto* continuation = self->template emplace_continuation<continuation_type>(
+      std::forward<F>(functor), self);
+  // Save the value of `continuation->output`, because the continuation may
+  // run, and reset it, as soon as it is published.
   auto result = continuation->output;
-  self->set_continuation(
-      std::unique_ptr<continuation_base>(std::move(continuation)));
+  self->publish_continuation();
   return result;
 }
 
@@ -856,13 +974,12 @@ future_shared_state<void>::make_continuation(
 
   // First create a continuation that calls the functor, and stores the result
   // in a `future_shared_state<future_shared_state<R>>`
-  auto continuation =
-      absl::make_unique<continuation_type>(std::forward<F>(functor), self);
-  // Save the value of `continuation->output`, because the move will make it
-  // inaccessible.
+  auto* continuation = self->template emplace_continuation<continuation_type>(
+      std::forward<F>(functor), self);
+  // Save the value of `continuation->output`, because the continuation may
+  // run, and reset it, as soon as it is published.
   std::shared_ptr<future_shared_state<R>> result = continuation->output;
-  self->set_continuation(
-      std::unique_ptr<continuation_base>(std::move(continuation)));
+  self->publish_continuation();
   return result;
 }
 
@@ -18,6 +18,8 @@
 #include "google/cloud/testing_util/testing_types.h"
 #include "absl/memory/memory.h"
 #include <gmock/gmock.h>
+#include <stdexcept>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -580,6 +582,125 @@ TEST(FutureImplObservable, SetValue) {
   EXPECT_EQ(3, Observable::destructor());
 }
 
+/// A continuation that records how many times it was executed and destroyed.
+template <std::size_t PayloadSize>
+class CountingContinuation : public continuation_base {
+ public:
+  CountingContinuation(int* executed, int* destroyed)
+      : executed_(executed), destroyed_(destroyed) {}
+  ~CountingContinuation() override { ++*destroyed_; }
+  void execute() override { ++*executed_; }
+
+ private:
+  int* executed_;
+  int* destroyed_;
+  char payload_[PayloadSize] = {};
+};
+
+TEST(FutureImplContinuationStorage, SmallContinuation) {
+  int executed = 0;
+  int destroyed = 0;
+  {
+    future_shared_state<void> shared_state;
+    shared_state.emplace_continuation<CountingContinuation<8>>(&executed,
+                                                               &destroyed);
+    shared_state.publish_continuation();
+    EXPECT_EQ(0, executed);
+    shared_state.set_value();
+    EXPECT_EQ(1, executed);
+    EXPECT_EQ(0, destroyed);
+  }
+  EXPECT_EQ(1, destroyed);
+}
+
+TEST(FutureImplContinuationStorage, LargeContinuation) {
+  int executed = 0;
+  int destroyed = 0;
+  {
+    future_shared_state<void> shared_state;
+    shared_state.emplace_continuation<CountingContinuation<1024>>(&executed,
+                                                                  &destroyed);
+    shared_state.publish_continuation();
+    EXPECT_EQ(0, executed);
+    shared_state.set_value();
+    EXPECT_EQ(1, executed);
+    EXPECT_EQ(0, destroyed);
+  }
+  EXPECT_EQ(1, destroyed);
+}
+
+TEST(FutureImplContinuationStorage, AlreadySatisfied) {
+  int executed = 0;
+  int destroyed = 0;
+  future_shared_state<void> shared_state;
+  shared_state.set_value();
+  shared_state.emplace_continuation<CountingContinuation<8>>(&executed,
+                                                             &destroyed);
+  shared_state.publish_continuation();
+  // The continuation runs immediately, and is released right away.
+  EXPECT_EQ(1, executed);
+  EXPECT_EQ(1, destroyed);
+}
+
+TEST(FutureImplContinuationStorage, AlreadySet) {
+  int executed = 0;
+  int destroyed = 0;
+  future_shared_state<void> shared_state;
+  shared_state.emplace_continuation<CountingContinuation<8>>(&executed,
+                                                             &destroyed);
+  ExpectFutureError(
+      [&] {
+        shared_state.emplace_continuation<CountingContinuation<8>>(&executed,
+                                                                   &destroyed);
+      },
+      std::future_errc::future_already_retrieved);
+}
+
+/// @test Verify the continuation runs exactly once when racing with set_value()
+TEST(FutureImplContinuationStorage, ConcurrentSetValueAndContinuation) {
+  for (int i = 0; i != 1000; ++i) {
+    int executed = 0;
+    int destroyed = 0;
+    future_shared_state<int> shared_state;
+    std::thread t([&shared_state, i] { shared_state.set_value(i); });
+    shared_state.emplace_continuation<CountingContinuation<8>>(&executed,
+                                                               &destroyed);
+    shared_state.publish_continuation();
+    t.join();
+    EXPECT_EQ(1, executed);
+    EXPECT_EQ(i, shared_state.get());
+  }
+}
+
+/// @test Verify threads blocked in get() are woken up by set_value()
+TEST(FutureImplContinuationStorage, ConcurrentSetValueAndGet) {
+  for (int i = 0; i != 1000; ++i) {
+    future_shared_state<int> shared_state;
+    std::thread t([&shared_state, i] { shared_state.set_value(i); });
+    EXPECT_EQ(i, shared_state.get());
+    t.join();
+  }
+}
+
+struct ThrowOnMove {
+  explicit ThrowOnMove(bool t) : throw_on_move(t) {}
+  ThrowOnMove(ThrowOnMove&& rhs) : throw_on_move(rhs.throw_on_move) {
+    if (throw_on_move) throw std::runtime_error("move failed");
+  }
+  bool throw_on_move;
+};
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify a failed set_value() leaves the state unsatisfied.
+TEST(FutureImplContinuationStorage, SetValueMoveThrows) {
+  future_shared_state<ThrowOnMove> shared_state;
+  EXPECT_THROW(shared_state.set_value(ThrowOnMove(true)), std::runtime_error);
+  EXPECT_FALSE(shared_state.is_ready());
+  shared_state.set_value(ThrowOnMove(false));
+  EXPECT_TRUE(shared_state.is_ready());
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
 }  // namespace
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
@@ -30,9 +30,37 @@ std::string DebugString(google::protobuf::Message const& m,
   p.SetTruncateStringFieldLongerThan(
       options.truncate_string_field_longer_than());
   p.PrintToString(m, &str);
+  auto const max = options.max_message_length();
+  if (max > 0 && str.size() > static_cast<std::size_t>(max)) {
+    str.resize(static_cast<std::size_t>(max));
+    str += "...<truncated>";
+  }
   return str;
 }
 
+RpcTracingSample::RpcTracingSample(TracingOptions const& options)
+    : sampled_(true),
+      eager_(!options.errors_only() &&
+             options.latency_threshold() == std::chrono::milliseconds(0)),
+      errors_only_(options.errors_only()),
+      latency_threshold_(options.latency_threshold()) {
+  auto const n = options.sample_one_in();
+  if (n > 1) {
+    // A per-thread counter avoids contention between threads making RPCs.
+    static thread_local std::uint64_t counter = 0;
+    sampled_ = counter++ % static_cast<std::uint64_t>(n) == 0;
+  }
+  if (sampled_ && !eager_) start_ = std::chrono::steady_clock::now();
+}
+
+bool RpcTracingSample::ShouldLog(bool ok) const {
+  if (errors_only_ && ok) return false;
+  if (latency_threshold_ == std::chrono::steady_clock::duration(0)) {
+    return true;
+  }
+  return std::chrono::steady_clock::now() - start_ >= latency_threshold_;
+}
+
 std::string RequestIdForLogging() {
   static std::atomic<std::uint64_t> generator{0};
   return std::to_string(++generator);
@@ -59,6 +59,32 @@ struct IsFutureStatus : public std::false_type {};
 template <>
 struct IsFutureStatus<future<Status>> : public std::true_type {};
 
+/**
+ * Applies the sampling options in `TracingOptions` to a single RPC.
+ *
+ * Create one before making the RPC. If `sampled()` is false the RPC is not
+ * logged at all. If `eager()` is true the request is logged before the RPC
+ * starts, otherwise the request and the response are logged after the RPC
+ * completes, and only if `ShouldLog()` returns true.
+ */
+class RpcTracingSample {
+ public:
+  explicit RpcTracingSample(TracingOptions const& options);
+
+  bool sampled() const { return sampled_; }
+  bool eager() const { return eager_; }
+
+  /// Return true if a completed RPC, with the given outcome, is logged.
+  bool ShouldLog(bool ok) const;
+
+ private:
+  bool sampled_;
+  bool eager_;
+  bool errors_only_;
+  std::chrono::steady_clock::duration latency_threshold_;
+  std::chrono::steady_clock::time_point start_;
+};
+
 template <
     typename Functor, typename Request,
     typename Result = google::cloud::internal::invoke_result_t<
@@ -68,8 +94,15 @@ template <
 Result LogWrapper(Functor&& functor, grpc::ClientContext& context,
                   Request const& request, char const* where,
                   TracingOptions const& options) {
-  GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(context, request);
+  auto log_request = [&] {
+    GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  };
+  if (sample.eager()) log_request();
   auto response = functor(context, request);
+  if (!sample.ShouldLog(response.ok())) return response;
+  if (!sample.eager()) log_request();
   GCP_LOG(DEBUG) << where << "() >> status=" << response;
   return response;
 }
@@ -81,8 +114,15 @@ template <typename Functor, typename Request,
 Result LogWrapper(Functor&& functor, grpc::ClientContext& context,
                   Request const& request, char const* where,
                   TracingOptions const& options) {
-  GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(context, request);
+  auto log_request = [&] {
+    GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  };
+  if (sample.eager()) log_request();
   auto response = functor(context, request);
+  if (!sample.ShouldLog(response.ok())) return response;
+  if (!sample.eager()) log_request();
   if (!response) {
     GCP_LOG(DEBUG) << where << "() >> status=" << response.status();
   } else {
@@ -99,8 +139,15 @@ template <typename Functor, typename Request,
 Result LogWrapper(Functor&& functor, grpc::ClientContext& context,
                   Request const& request, char const* where,
                   TracingOptions const& options) {
-  GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(context, request);
+  auto log_request = [&] {
+    GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  };
+  if (sample.eager()) log_request();
   auto response = functor(context, request);
+  if (!sample.ShouldLog(response != nullptr)) return response;
+  if (!sample.eager()) log_request();
   GCP_LOG(DEBUG) << where << "() >> " << (response ? "not null" : "null")
                  << " stream";
   return response;
@@ -113,8 +160,15 @@ template <
 Result LogWrapper(Functor&& functor, grpc::ClientContext& context,
                   Request const& request, grpc::CompletionQueue* cq,
                   char const* where, TracingOptions const& options) {
-  GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(context, request, cq);
+  auto log_request = [&] {
+    GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  };
+  if (sample.eager()) log_request();
   auto response = functor(context, request, cq);
+  if (!sample.ShouldLog(response != nullptr)) return response;
+  if (!sample.eager()) log_request();
   GCP_LOG(DEBUG) << where << "() >> " << (response ? "not null" : "null")
                  << " async response reader";
   return response;
@@ -127,27 +181,43 @@ template <
     typename std::enable_if<IsFutureStatusOr<Result>::value, int>::type = 0>
 Result LogWrapper(Functor&& functor, Request request, char const* where,
                   TracingOptions const& options) {
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(std::move(request));
   // Because this is an asynchronous request we need a unique identifier so
   // applications can match the request and response in the log.
   auto prefix = std::string(where) + "(" + RequestIdForLogging() + ")";
-  GCP_LOG(DEBUG) << prefix << " << " << DebugString(request, options);
+  // If the request is logged after the response we need to keep a copy.
+  std::shared_ptr<Request> deferred;
+  if (sample.eager()) {
+    GCP_LOG(DEBUG) << prefix << " << " << DebugString(request, options);
+  } else {
+    deferred = std::make_shared<Request>(request);
+  }
   auto response = functor(std::move(request));
   // Ideally we would have an ID to match the request with the asynchronous
   // response, but for functions with this signature there is nothing that comes
   // to mind.
-  GCP_LOG(DEBUG) << prefix << " >> future_status="
-                 << DebugFutureStatus(
-                        response.wait_for(std::chrono::microseconds(0)));
-  return response.then([prefix, options](decltype(response) f) {
-    auto response = f.get();
-    if (!response) {
-      GCP_LOG(DEBUG) << prefix << " >> status=" << response.status();
-    } else {
-      GCP_LOG(DEBUG) << prefix
-                     << " >> response=" << DebugString(*response, options);
-    }
-    return response;
-  });
+  if (sample.eager()) {
+    GCP_LOG(DEBUG) << prefix << " >> future_status="
+                   << DebugFutureStatus(
+                          response.wait_for(std::chrono::microseconds(0)));
+  }
+  return response.then(
+      [prefix, options, sample, deferred](decltype(response) f) {
+        auto response = f.get();
+        if (!sample.ShouldLog(response.ok())) return response;
+        if (deferred) {
+          GCP_LOG(DEBUG) << prefix << " << "
+                         << DebugString(*deferred, options);
+        }
+        if (!response) {
+          GCP_LOG(DEBUG) << prefix << " >> status=" << response.status();
+        } else {
+          GCP_LOG(DEBUG) << prefix << " >> response="
+                         << DebugString(*response, options);
+        }
+        return response;
+      });
 }
 
 template <
@@ -160,27 +230,43 @@ Result LogWrapper(Functor&& functor, google::cloud::CompletionQueue& cq,
                   std::unique_ptr<grpc::ClientContext> context,
                   Request const& request, char const* where,
                   TracingOptions const& options) {
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(cq, std::move(context), request);
   // Because this is an asynchronous request we need a unique identifier so
   // applications can match the request and response in the log.
   auto prefix = std::string(where) + "(" + RequestIdForLogging() + ")";
-  GCP_LOG(DEBUG) << prefix << " << " << DebugString(request, options);
+  // If the request is logged after the response we need to keep a copy.
+  std::shared_ptr<Request> deferred;
+  if (sample.eager()) {
+    GCP_LOG(DEBUG) << prefix << " << " << DebugString(request, options);
+  } else {
+    deferred = std::make_shared<Request>(request);
+  }
   auto response = functor(cq, std::move(context), request);
   // Ideally we would have an ID to match the request with the asynchronous
   // response, but for functions with this signature there is nothing that comes
   // to mind.
-  GCP_LOG(DEBUG) << prefix << " >> future_status="
-                 << DebugFutureStatus(
-                        response.wait_for(std::chrono::microseconds(0)));
-  return response.then([prefix, options](decltype(response) f) {
-    auto response = f.get();
-    if (!response) {
-      GCP_LOG(DEBUG) << prefix << " >> status=" << response.status();
-    } else {
-      GCP_LOG(DEBUG) << prefix
-                     << " >> response=" << DebugString(*response, options);
-    }
-    return response;
-  });
+  if (sample.eager()) {
+    GCP_LOG(DEBUG) << prefix << " >> future_status="
+                   << DebugFutureStatus(
+                          response.wait_for(std::chrono::microseconds(0)));
+  }
+  return response.then(
+      [prefix, options, sample, deferred](decltype(response) f) {
+        auto response = f.get();
+        if (!sample.ShouldLog(response.ok())) return response;
+        if (deferred) {
+          GCP_LOG(DEBUG) << prefix << " << "
+                         << DebugString(*deferred, options);
+        }
+        if (!response) {
+          GCP_LOG(DEBUG) << prefix << " >> status=" << response.status();
+        } else {
+          GCP_LOG(DEBUG) << prefix << " >> response="
+                         << DebugString(*response, options);
+        }
+        return response;
+      });
 }
 
 template <typename Functor, typename Request,
@@ -192,19 +278,33 @@ Result LogWrapper(Functor&& functor, google::cloud::CompletionQueue& cq,
                   std::unique_ptr<grpc::ClientContext> context,
                   Request const& request, char const* where,
                   TracingOptions const& options) {
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(cq, std::move(context), request);
   // Because this is an asynchronous request we need a unique identifier so
   // applications can match the request and response in the log.
   auto prefix = std::string(where) + "(" + RequestIdForLogging() + ")";
-  GCP_LOG(DEBUG) << prefix << " << " << DebugString(request, options);
+  // If the request is logged after the response we need to keep a copy.
+  std::shared_ptr<Request> deferred;
+  if (sample.eager()) {
+    GCP_LOG(DEBUG) << prefix << " << " << DebugString(request, options);
+  } else {
+    deferred = std::make_shared<Request>(request);
+  }
   auto response = functor(cq, std::move(context), request);
   // Ideally we would have an ID to match the request with the asynchronous
   // response, but for functions with this signature there is nothing that comes
   // to mind.
-  GCP_LOG(DEBUG) << prefix << " >> future_status="
-                 << DebugFutureStatus(
-                        response.wait_for(std::chrono::microseconds(0)));
-  return response.then([prefix](future<Status> f) {
+  if (sample.eager()) {
+    GCP_LOG(DEBUG) << prefix << " >> future_status="
+                   << DebugFutureStatus(
+                          response.wait_for(std::chrono::microseconds(0)));
+  }
+  return response.then([prefix, options, sample, deferred](future<Status> f) {
     auto response = f.get();
+    if (!sample.ShouldLog(response.ok())) return response;
+    if (deferred) {
+      GCP_LOG(DEBUG) << prefix << " << " << DebugString(*deferred, options);
+    }
     GCP_LOG(DEBUG) << prefix << " >> response=" << response;
     return response;
   });
@@ -218,8 +318,15 @@ template <typename Functor, typename Request, typename Response,
 Result LogWrapper(Functor&& functor, grpc::ClientContext* context,
                   Request const& request, Response* response, char const* where,
                   TracingOptions const& options) {
-  GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(context, request, response);
+  auto log_request = [&] {
+    GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  };
+  if (sample.eager()) log_request();
   auto status = functor(context, request, response);
+  if (!sample.ShouldLog(status.ok())) return status;
+  if (!sample.eager()) log_request();
   if (!status.ok()) {
     GCP_LOG(DEBUG) << where << "() >> status=" << status.error_message();
   } else {
@@ -235,8 +342,15 @@ template <typename Functor, typename Request,
 Result LogWrapper(Functor&& functor, grpc::ClientContext* context,
                   Request const& request, char const* where,
                   TracingOptions const& options) {
-  GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(context, request);
+  auto log_request = [&] {
+    GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  };
+  if (sample.eager()) log_request();
   auto response = functor(context, request);
+  if (!sample.ShouldLog(response != nullptr)) return response;
+  if (!sample.eager()) log_request();
   GCP_LOG(DEBUG) << where << "() >> " << (response ? "not null" : "null")
                  << " stream";
   return response;
@@ -250,8 +364,15 @@ template <
 Result LogWrapper(Functor&& functor, grpc::ClientContext* context,
                   Request const& request, grpc::CompletionQueue* cq,
                   char const* where, TracingOptions const& options) {
-  GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  RpcTracingSample sample(options);
+  if (!sample.sampled()) return functor(context, request, cq);
+  auto log_request = [&] {
+    GCP_LOG(DEBUG) << where << "() << " << DebugString(request, options);
+  };
+  if (sample.eager()) log_request();
   auto response = functor(context, request, cq);
+  if (!sample.ShouldLog(response != nullptr)) return response;
+  if (!sample.eager()) log_request();
   GCP_LOG(DEBUG) << where << "() >> " << (response ? "not null" : "null")
                  << " async response reader";
   return response;
@@ -19,6 +19,8 @@
 #include <google/protobuf/text_format.h>
 #include <google/spanner/v1/mutation.pb.h>
 #include <gmock/gmock.h>
+#include <algorithm>
+#include <thread>
 
 namespace btproto = google::bigtable::v2;
 
@@ -31,6 +33,8 @@ namespace {
 using ::testing::AllOf;
 using ::testing::Contains;
 using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Not;
 
 google::spanner::v1::Mutation MakeMutation() {
   auto constexpr kText = R"pb(
@@ -358,6 +362,96 @@ TEST(LogWrapper, UniquePointerClientReaderInterface) {
   google::cloud::LogSink::Instance().RemoveBackend(id);
 }
 
+TEST(LogWrapper, MaxMessageLength) {
+  TracingOptions tracing_options;
+  tracing_options.SetOptions("max_message_length=16");
+  EXPECT_EQ(R"pb(insert { table: ...<truncated>)pb",
+            internal::DebugString(MakeMutation(), tracing_options));
+}
+
+/// @test only one RPC in `sample_one_in` is logged
+TEST(LogWrapper, SampleOneIn) {
+  auto mock = [](grpc::ClientContext&,
+                 google::spanner::v1::Mutation const& m) {
+    return make_status_or(m);
+  };
+  TracingOptions tracing_options;
+  tracing_options.SetOptions("sample_one_in=5");
+
+  auto backend = std::make_shared<testing_util::CaptureLogLinesBackend>();
+  auto id = google::cloud::LogSink::Instance().AddBackend(backend);
+  for (int i = 0; i != 10; ++i) {
+    grpc::ClientContext context;
+    LogWrapper(mock, context, MakeMutation(), "in-test", tracing_options);
+  }
+
+  auto const log_lines = backend->ClearLogLines();
+  auto const requests =
+      std::count_if(log_lines.begin(), log_lines.end(),
+                    [](std::string const& l) {
+                      return l.find("in-test() << ") != std::string::npos;
+                    });
+  EXPECT_EQ(2, requests);
+
+  google::cloud::LogSink::Instance().RemoveBackend(id);
+}
+
+/// @test with `errors_only` successful RPCs are not logged
+TEST(LogWrapper, ErrorsOnly) {
+  auto status = Status(StatusCode::kPermissionDenied, "uh-oh");
+  auto mock = [&status](grpc::ClientContext&,
+                        google::spanner::v1::Mutation const& m) {
+    if (!status.ok()) return StatusOr<google::spanner::v1::Mutation>(status);
+    return make_status_or(m);
+  };
+  TracingOptions tracing_options;
+  tracing_options.SetOptions("errors_only=on");
+
+  auto backend = std::make_shared<testing_util::CaptureLogLinesBackend>();
+  auto id = google::cloud::LogSink::Instance().AddBackend(backend);
+  grpc::ClientContext c1;
+  LogWrapper(mock, c1, MakeMutation(), "in-test", tracing_options);
+  auto log_lines = backend->ClearLogLines();
+  EXPECT_THAT(log_lines, Contains(HasSubstr("in-test() << insert {")));
+  EXPECT_THAT(log_lines, Contains(HasSubstr("in-test() >> status=")));
+
+  status = Status();
+  grpc::ClientContext c2;
+  LogWrapper(mock, c2, MakeMutation(), "in-test", tracing_options);
+  log_lines = backend->ClearLogLines();
+  EXPECT_THAT(log_lines, Not(Contains(HasSubstr("in-test("))));
+
+  google::cloud::LogSink::Instance().RemoveBackend(id);
+}
+
+/// @test with `latency_threshold_ms` only slow RPCs are logged
+TEST(LogWrapper, LatencyThreshold) {
+  std::chrono::milliseconds delay(0);
+  auto mock = [&delay](google::spanner::v1::Mutation m) {
+    std::this_thread::sleep_for(delay);
+    return make_ready_future(make_status_or(std::move(m)));
+  };
+  TracingOptions tracing_options;
+  tracing_options.SetOptions("latency_threshold_ms=20");
+
+  auto backend = std::make_shared<testing_util::CaptureLogLinesBackend>();
+  auto id = google::cloud::LogSink::Instance().AddBackend(backend);
+  LogWrapper(mock, MakeMutation(), "in-test", tracing_options).get();
+  EXPECT_THAT(backend->ClearLogLines(), IsEmpty());
+
+  delay = std::chrono::milliseconds(40);
+  LogWrapper(mock, MakeMutation(), "in-test", tracing_options).get();
+  auto const log_lines = backend->ClearLogLines();
+  EXPECT_THAT(log_lines, Contains(AllOf(HasSubstr("in-test("),
+                                        HasSubstr(" << insert {"))));
+  EXPECT_THAT(log_lines, Contains(AllOf(HasSubstr("in-test("),
+                                        HasSubstr(" >> response="))));
+  // The request is logged after the RPC, the future status is not useful.
+  EXPECT_THAT(log_lines, Not(Contains(HasSubstr(" >> future_status="))));
+
+  google::cloud::LogSink::Instance().RemoveBackend(id);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
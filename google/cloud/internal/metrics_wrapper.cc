@@ -0,0 +1,42 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/metrics_wrapper.h"
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+RpcMetricsRecorder::RpcMetricsRecorder(char const* rpc)
+    : enabled_(InstrumentationEnabled()) {
+  metrics_.rpc = rpc;
+  if (enabled_) start_ = std::chrono::steady_clock::now();
+}
+
+RpcMetricsRecorder::~RpcMetricsRecorder() { Finish(StatusCode::kCancelled); }
+
+void RpcMetricsRecorder::Finish(StatusCode code) {
+  if (!enabled_) return;
+  enabled_ = false;
+  metrics_.code = code;
+  metrics_.latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_);
+  RecordRpc(metrics_);
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
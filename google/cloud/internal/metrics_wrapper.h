@@ -0,0 +1,116 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_METRICS_WRAPPER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_METRICS_WRAPPER_H
+
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
+#include "google/cloud/instrumentation.h"
+#include "google/cloud/internal/invoke_result.h"
+#include "google/cloud/status_or.h"
+#include "google/cloud/version.h"
+#include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Measures a single RPC and reports it via `RecordRpc()`.
+ *
+ * Nothing is measured unless some instrumentation is installed when the RPC
+ * starts. RPCs that are not explicitly finished, e.g. streams abandoned by the
+ * application, are reported as cancelled when the recorder is destroyed.
+ */
+class RpcMetricsRecorder {
+ public:
+  explicit RpcMetricsRecorder(char const* rpc);
+  ~RpcMetricsRecorder();
+
+  RpcMetricsRecorder(RpcMetricsRecorder const&) = delete;
+  RpcMetricsRecorder& operator=(RpcMetricsRecorder const&) = delete;
+
+  bool enabled() const { return enabled_; }
+
+  /// Count a message sent on a streaming RPC.
+  void Sent(std::int64_t bytes) {
+    ++metrics_.messages_sent;
+    metrics_.bytes_sent += bytes;
+  }
+
+  /// Count a message received on a streaming RPC.
+  void Received(std::int64_t bytes) {
+    ++metrics_.messages_received;
+    metrics_.bytes_received += bytes;
+  }
+
+  /// Report the RPC, only the first call has any effect.
+  void Finish(StatusCode code);
+
+ private:
+  RpcMetrics metrics_;
+  std::chrono::steady_clock::time_point start_;
+  bool enabled_;
+};
+
+inline Status const& RpcStatus(Status const& status) { return status; }
+
+template <typename T>
+Status const& RpcStatus(StatusOr<T> const& response) {
+  return response.status();
+}
+
+/// Measures a blocking unary RPC.
+template <typename Functor, typename Request,
+          typename Result = google::cloud::internal::invoke_result_t<
+              Functor, grpc::ClientContext&, Request const&>>
+Result MetricsWrapper(Functor&& functor, grpc::ClientContext& context,
+                      Request const& request, char const* rpc) {
+  if (!InstrumentationEnabled()) return functor(context, request);
+  RpcMetricsRecorder recorder(rpc);
+  auto response = functor(context, request);
+  recorder.Finish(RpcStatus(response).code());
+  return response;
+}
+
+/// Measures an asynchronous unary RPC.
+template <typename Functor, typename Request,
+          typename Result = google::cloud::internal::invoke_result_t<
+              Functor, CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+              Request const&>>
+Result MetricsWrapper(Functor&& functor, CompletionQueue& cq,
+                      std::unique_ptr<grpc::ClientContext> context,
+                      Request const& request, char const* rpc) {
+  if (!InstrumentationEnabled()) {
+    return functor(cq, std::move(context), request);
+  }
+  auto recorder = std::make_shared<RpcMetricsRecorder>(rpc);
+  return functor(cq, std::move(context), request).then([recorder](Result f) {
+    auto response = f.get();
+    recorder->Finish(RpcStatus(response).code());
+    return response;
+  });
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_METRICS_WRAPPER_H
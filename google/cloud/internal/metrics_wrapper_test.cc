@@ -0,0 +1,122 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/metrics_wrapper.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/capture_instrumentation.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::CaptureInstrumentation;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+using Request = google::protobuf::Timestamp;
+using Response = google::protobuf::Duration;
+
+class MetricsWrapperTest : public ::testing::Test {
+ protected:
+  void SetUp() override { SetInstrumentation(capture_); }
+  void TearDown() override { SetInstrumentation(nullptr); }
+
+  std::shared_ptr<CaptureInstrumentation> capture_ =
+      std::make_shared<CaptureInstrumentation>();
+};
+
+TEST_F(MetricsWrapperTest, Disabled) {
+  SetInstrumentation(nullptr);
+  grpc::ClientContext context;
+  auto status = MetricsWrapper(
+      [](grpc::ClientContext&, Request const&) { return Status(); }, context,
+      Request{}, "test.Service/Method");
+  EXPECT_STATUS_OK(status);
+  EXPECT_THAT(capture_->ClearEvents(), IsEmpty());
+}
+
+TEST_F(MetricsWrapperTest, Status) {
+  grpc::ClientContext context;
+  auto status = MetricsWrapper(
+      [](grpc::ClientContext&, Request const&) {
+        return Status(StatusCode::kPermissionDenied, "uh-oh");
+      },
+      context, Request{}, "test.Service/Method");
+  EXPECT_THAT(status, StatusIs(StatusCode::kPermissionDenied));
+  EXPECT_THAT(capture_->ClearEvents(),
+              ElementsAre("rpc:test.Service/Method:PERMISSION_DENIED"));
+}
+
+TEST_F(MetricsWrapperTest, StatusOr) {
+  grpc::ClientContext context;
+  auto response = MetricsWrapper(
+      [](grpc::ClientContext&, Request const&) {
+        return make_status_or(Response{});
+      },
+      context, Request{}, "test.Service/Method");
+  EXPECT_STATUS_OK(response);
+  EXPECT_THAT(capture_->ClearEvents(),
+              ElementsAre("rpc:test.Service/Method:OK"));
+}
+
+TEST_F(MetricsWrapperTest, FutureStatusOr) {
+  promise<StatusOr<Response>> p;
+  CompletionQueue cq;
+  auto f = MetricsWrapper(
+      [&p](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+           Request const&) { return p.get_future(); },
+      cq, absl::make_unique<grpc::ClientContext>(), Request{},
+      "test.Service/Method");
+  // Nothing is reported until the RPC completes.
+  EXPECT_THAT(capture_->ClearEvents(), IsEmpty());
+  p.set_value(Status(StatusCode::kUnavailable, "try-again"));
+  EXPECT_THAT(f.get(), StatusIs(StatusCode::kUnavailable));
+  EXPECT_THAT(capture_->ClearEvents(),
+              ElementsAre("rpc:test.Service/Method:UNAVAILABLE"));
+}
+
+TEST_F(MetricsWrapperTest, FutureStatus) {
+  CompletionQueue cq;
+  auto f = MetricsWrapper(
+      [](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+         Request const&) { return make_ready_future(Status()); },
+      cq, absl::make_unique<grpc::ClientContext>(), Request{},
+      "test.Service/Method");
+  EXPECT_STATUS_OK(f.get());
+  EXPECT_THAT(capture_->ClearEvents(),
+              ElementsAre("rpc:test.Service/Method:OK"));
+}
+
+TEST_F(MetricsWrapperTest, RecorderAbandoned) {
+  {
+    RpcMetricsRecorder recorder("test.Service/Stream");
+    recorder.Received(10);
+  }
+  EXPECT_THAT(capture_->ClearEvents(),
+              ElementsAre("rpc:test.Service/Stream:CANCELLED:sent=0/0:"
+                          "received=1/10"));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -19,9 +19,16 @@
 #include "google/cloud/status_or.h"
 #include "google/cloud/stream_range.h"
 #include "google/cloud/version.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -48,6 +55,45 @@ namespace internal {
 template <typename T>
 using PaginationRange = StreamRange<T>;
 
+/**
+ * ExtractPageToken() extracts (i.e., "moves") the page token out of the given
+ * response object. This function is overloaded based on whether the response
+ * object has a `.mutable_next_page_token()` member function (e.g., a protobuf),
+ * or a `.next_page_token` field (e.g., a regular struct such as is used in
+ * GCS).
+ */
+template <typename U>
+constexpr auto ExtractPageToken(U& u)
+    -> decltype(std::move(*u.mutable_next_page_token())) {
+  return std::move(*u.mutable_next_page_token());
+}
+template <typename U>
+constexpr auto ExtractPageToken(U& u)
+    -> decltype(std::move(u.next_page_token)) {
+  return std::move(u.next_page_token);
+}
+
+/**
+ * Moves the elements of @p page starting at @p current into a new vector.
+ *
+ * If no elements have been consumed, the page is returned without moving
+ * each element. On return @p page is empty and @p current is its end.
+ */
+template <typename T>
+std::vector<T> TakeRemaining(std::vector<T>& page,
+                             typename std::vector<T>::iterator& current) {
+  std::vector<T> batch;
+  if (current == page.begin()) {
+    batch.swap(page);
+  } else {
+    batch.assign(std::make_move_iterator(current),
+                 std::make_move_iterator(page.end()));
+  }
+  page.clear();
+  current = page.end();
+  return batch;
+}
+
 /**
  * Returns `T`s one at a time from pages of responses.
  *
@@ -94,36 +140,41 @@ class PagedStreamReader {
    */
   typename StreamReader<T>::result_type GetNext() {
     if (current_ == page_.end()) {
-      if (last_page_) return Status{};
-      request_.set_page_token(std::move(token_));
-      auto response = loader_(request_);
-      if (!response.ok()) return std::move(response).status();
-      token_ = ExtractPageToken(*response);
-      if (token_.empty()) last_page_ = true;
-      page_ = extractor_(*std::move(response));
-      current_ = page_.begin();
-      if (current_ == page_.end()) return Status{};
+      auto status = LoadPage();
+      if (!status.ok() || current_ == page_.end()) return status;
     }
+    partial_page_ = true;
     return std::move(*current_++);
   }
 
- private:
   /**
-   * ExtractPageToken() extracts (i.e., "moves") the page token out of the
-   * given response object. This function is overloaded based on whether the
-   * response object has a `.mutable_next_page_token()` member function (e.g.,
-   * a protobuf), or a `.next_page_token` field (e.g., a regular struct such as
-   * is used in GCS).
+   * Returns the objects not returned yet from the current page, or the next
+   * page if the current page was returned by a previous call.
+   *
+   * @return the objects, which may be empty only if `GetNext()` returned the
+   *     last object of the current page, or a `Status` as in `GetNext()`.
    */
-  template <typename U>
-  static constexpr auto ExtractPageToken(U& u)
-      -> decltype(std::move(*u.mutable_next_page_token())) {
-    return std::move(*u.mutable_next_page_token());
+  typename StreamBatchReader<T>::result_type GetNextBatch() {
+    if (current_ == page_.end() && !partial_page_) {
+      auto status = LoadPage();
+      if (!status.ok() || current_ == page_.end()) return status;
+    }
+    partial_page_ = false;
+    return TakeRemaining(page_, current_);
   }
-  template <typename U>
-  static constexpr auto ExtractPageToken(U& u)
-      -> decltype(std::move(u.next_page_token)) {
-    return std::move(u.next_page_token);
+
+ private:
+  // Loads the next page, the page is empty at the end of the stream.
+  Status LoadPage() {
+    if (last_page_) return Status{};
+    request_.set_page_token(std::move(token_));
+    auto response = loader_(request_);
+    if (!response.ok()) return std::move(response).status();
+    token_ = ExtractPageToken(*response);
+    if (token_.empty()) last_page_ = true;
+    page_ = extractor_(*std::move(response));
+    current_ = page_.begin();
+    return Status{};
   }
 
   Request request_;
@@ -133,6 +184,137 @@ class PagedStreamReader {
   typename std::vector<T>::iterator current_;
   std::string token_;
   bool last_page_;
+  // True if `GetNext()` returned some objects of the current page.
+  bool partial_page_ = false;
+};
+
+/**
+ * Returns `T`s one at a time from pages of responses, prefetching pages.
+ *
+ * This class works like `PagedStreamReader`, but once the application requests
+ * the first item it starts loading pages in a background thread. The
+ * application processes the items in page N while pages N+1, N+2, etc. are
+ * loaded, instead of alternating between loading a page and processing it.
+ * The thread loads at most @p max_prefetched_pages pages ahead of the page
+ * being consumed, which bounds the memory used by the reader.
+ *
+ * The @p loader is called from a background thread, it must be safe to call
+ * it from multiple threads (though it is never called concurrently).
+ */
+template <typename T, typename Request, typename Response>
+class PrefetchingPagedStreamReader {
+ public:
+  PrefetchingPagedStreamReader(
+      Request request, std::function<StatusOr<Response>(Request const&)> loader,
+      std::function<std::vector<T>(Response)> extractor,
+      std::size_t max_prefetched_pages = 1)
+      : request_(std::move(request)),
+        loader_(std::move(loader)),
+        extractor_(std::move(extractor)),
+        max_prefetched_pages_((std::max)(max_prefetched_pages, std::size_t{1})),
+        last_page_(false) {
+    current_ = page_.begin();
+  }
+
+  /// Blocks until any pending request completes.
+  ~PrefetchingPagedStreamReader() {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+    if (loader_thread_.joinable()) loader_thread_.join();
+  }
+
+  /// @copydoc PagedStreamReader::GetNext()
+  typename StreamReader<T>::result_type GetNext() {
+    if (current_ == page_.end()) {
+      auto status = LoadPage();
+      if (!status.ok() || current_ == page_.end()) return status;
+    }
+    partial_page_ = true;
+    return std::move(*current_++);
+  }
+
+  /// @copydoc PagedStreamReader::GetNextBatch()
+  typename StreamBatchReader<T>::result_type GetNextBatch() {
+    if (current_ == page_.end() && !partial_page_) {
+      auto status = LoadPage();
+      if (!status.ok() || current_ == page_.end()) return status;
+    }
+    partial_page_ = false;
+    return TakeRemaining(page_, current_);
+  }
+
+ private:
+  // Waits for the next prefetched page, the page is empty at the end of the
+  // stream.
+  Status LoadPage() {
+    if (last_page_) return Status{};
+    if (!loader_thread_.joinable()) {
+      loader_thread_ = std::thread(&PrefetchingPagedStreamReader::Run, this,
+                                   std::move(request_));
+    }
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [this] { return !pages_.empty(); });
+    auto page = std::move(pages_.front());
+    pages_.pop_front();
+    lk.unlock();
+    cv_.notify_all();
+    last_page_ = page.last;
+    if (!page.response.ok()) return std::move(page.response).status();
+    page_ = extractor_(*std::move(page.response));
+    current_ = page_.begin();
+    return Status{};
+  }
+
+  struct Page {
+    StatusOr<Response> response;
+    bool last;
+  };
+
+  void Run(Request request) {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lk(mu_);
+        cv_.wait(lk, [this] {
+          return shutdown_ || pages_.size() < max_prefetched_pages_;
+        });
+        // Once the reader is abandoned there is no need to load more pages,
+        // but the page following the one being consumed is always requested.
+        if (shutdown_ && !pages_.empty()) return;
+      }
+      auto response = loader_(request);
+      auto last = !response.ok();
+      if (!last) {
+        auto token = ExtractPageToken(*response);
+        last = token.empty();
+        request.set_page_token(std::move(token));
+      }
+      {
+        std::lock_guard<std::mutex> lk(mu_);
+        pages_.push_back(Page{std::move(response), last});
+      }
+      cv_.notify_all();
+      if (last) return;
+    }
+  }
+
+  Request request_;
+  std::function<StatusOr<Response>(Request const&)> loader_;
+  std::function<std::vector<T>(Response)> extractor_;
+  std::size_t const max_prefetched_pages_;
+  std::vector<T> page_;
+  typename std::vector<T>::iterator current_;
+  bool last_page_;
+  // True if `GetNext()` returned some objects of the current page.
+  bool partial_page_ = false;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Page> pages_;
+  bool shutdown_ = false;
+  std::thread loader_thread_;
 };
 
 /**
@@ -172,7 +354,39 @@ Range MakePaginationRange(Request request, Loader loader, Extractor extractor) {
   auto reader = std::make_shared<ReaderType>(
       std::move(request), std::move(loader), std::move(extractor));
   return MakeStreamRange<ValueType>(
-      {[reader]() mutable { return reader->GetNext(); }});
+      {[reader]() mutable { return reader->GetNext(); }},
+      {[reader]() mutable { return reader->GetNextBatch(); }});
+}
+
+/**
+ * A factory function for creating `PaginationRange<T>` instances that prefetch.
+ *
+ * This works like `MakePaginationRange()`, but the range loads up to
+ * @p max_prefetched_pages pages in the background while the application
+ * iterates over the current page. See `PrefetchingPagedStreamReader` for the
+ * requirements on @p loader.
+ */
+template <typename Range, typename Request, typename Loader, typename Extractor>
+Range MakePrefetchingPaginationRange(Request request, Loader loader,
+                                     Extractor extractor,
+                                     std::size_t max_prefetched_pages = 1) {
+  using ValueType = typename Range::value_type::value_type;
+  using LoaderResult = invoke_result_t<Loader, Request>;
+  using Response = typename LoaderResult::value_type;
+  using ExtractorResult = invoke_result_t<Extractor, Response>;
+  static_assert(std::is_same<Range, PaginationRange<ValueType>>::value,
+                "Expected Range is of type PaginationRange<ValueType>");
+  static_assert(std::is_same<LoaderResult, StatusOr<Response>>::value,
+                "Expected loader functor like StatusOr<Response>(Request)");
+  static_assert(std::is_same<ExtractorResult, std::vector<ValueType>>::value,
+                "Expected extractor functor like vector<ValueType>(Response)");
+  using ReaderType = PrefetchingPagedStreamReader<ValueType, Request, Response>;
+  auto reader =
+      std::make_shared<ReaderType>(std::move(request), std::move(loader),
+                                   std::move(extractor), max_prefetched_pages);
+  return MakeStreamRange<ValueType>(
+      {[reader]() mutable { return reader->GetNext(); }},
+      {[reader]() mutable { return reader->GetNextBatch(); }});
 }
 
 /**
@@ -13,8 +13,13 @@
 // limitations under the License.
 
 #include "google/cloud/internal/pagination_range.h"
+#include "google/cloud/testing_util/assert_ok.h"
 #include "google/cloud/testing_util/status_matchers.h"
 #include <gmock/gmock.h>
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -26,6 +31,7 @@ using ::google::cloud::testing_util::StatusIs;
 using ::testing::_;
 using ::testing::ElementsAre;
 using ::testing::HasSubstr;
+using ::testing::IsEmpty;
 
 struct Item {
   std::string data;
@@ -250,6 +256,247 @@ TYPED_TEST(PaginationRangeTest, IteratorCoverage) {
   EXPECT_TRUE(i1 == range.end());
 }
 
+TYPED_TEST(PaginationRangeTest, PrefetchTwoPages) {
+  using ResponseType = TypeParam;
+  MockRpc<ResponseType> mock;
+  // Signaled when the second page is requested.
+  std::promise<void> second_page_requested;
+  EXPECT_CALL(mock, Loader(_))
+      .WillOnce([](Request const& request) {
+        EXPECT_TRUE(request.testonly_page_token.empty());
+        ResponseType response;
+        response.testonly_set_page_token("t1");
+        response.testonly_items.push_back(Item{"p1"});
+        response.testonly_items.push_back(Item{"p2"});
+        return response;
+      })
+      .WillOnce([&second_page_requested](Request const& request) {
+        EXPECT_EQ("t1", request.testonly_page_token);
+        second_page_requested.set_value();
+        ResponseType response;
+        response.testonly_items.push_back(Item{"p3"});
+        response.testonly_items.push_back(Item{"p4"});
+        return response;
+      });
+
+  auto range = MakePrefetchingPaginationRange<ItemRange>(
+      Request{}, [&mock](Request const& r) { return mock.Loader(r); },
+      [](ResponseType const& r) { return r.testonly_items; });
+  auto i = range.begin();
+  ASSERT_NE(i, range.end());
+  ASSERT_TRUE(*i);
+  EXPECT_EQ("p1", (*i)->data);
+  // The second page is requested before the application consumes the first.
+  EXPECT_EQ(std::future_status::ready,
+            second_page_requested.get_future().wait_for(
+                std::chrono::seconds(30)));
+
+  std::vector<std::string> names;
+  for (; i != range.end(); ++i) {
+    if (!*i) break;
+    names.push_back((*i)->data);
+  }
+  EXPECT_THAT(names, ElementsAre("p1", "p2", "p3", "p4"));
+}
+
+TYPED_TEST(PaginationRangeTest, PrefetchMultiplePages) {
+  using ResponseType = TypeParam;
+  MockRpc<ResponseType> mock;
+  // Signaled when the third page is requested.
+  std::promise<void> third_page_requested;
+  EXPECT_CALL(mock, Loader(_))
+      .WillOnce([](Request const& request) {
+        EXPECT_TRUE(request.testonly_page_token.empty());
+        ResponseType response;
+        response.testonly_set_page_token("t1");
+        response.testonly_items.push_back(Item{"p1"});
+        return response;
+      })
+      .WillOnce([](Request const& request) {
+        EXPECT_EQ("t1", request.testonly_page_token);
+        ResponseType response;
+        response.testonly_set_page_token("t2");
+        response.testonly_items.push_back(Item{"p2"});
+        return response;
+      })
+      .WillOnce([&third_page_requested](Request const& request) {
+        EXPECT_EQ("t2", request.testonly_page_token);
+        third_page_requested.set_value();
+        ResponseType response;
+        response.testonly_items.push_back(Item{"p3"});
+        return response;
+      });
+
+  auto range = MakePrefetchingPaginationRange<ItemRange>(
+      Request{}, [&mock](Request const& r) { return mock.Loader(r); },
+      [](ResponseType const& r) { return r.testonly_items; },
+      /*max_prefetched_pages=*/2);
+  auto i = range.begin();
+  ASSERT_NE(i, range.end());
+  ASSERT_TRUE(*i);
+  EXPECT_EQ("p1", (*i)->data);
+  // Two pages are requested before the application consumes the first.
+  EXPECT_EQ(std::future_status::ready,
+            third_page_requested.get_future().wait_for(
+                std::chrono::seconds(30)));
+
+  std::vector<std::string> names;
+  for (; i != range.end(); ++i) {
+    if (!*i) break;
+    names.push_back((*i)->data);
+  }
+  EXPECT_THAT(names, ElementsAre("p1", "p2", "p3"));
+}
+
+TYPED_TEST(PaginationRangeTest, PrefetchWithError) {
+  using ResponseType = TypeParam;
+  MockRpc<ResponseType> mock;
+  EXPECT_CALL(mock, Loader(_))
+      .WillOnce([](Request const& request) {
+        EXPECT_TRUE(request.testonly_page_token.empty());
+        ResponseType response;
+        response.testonly_set_page_token("t1");
+        response.testonly_items.push_back(Item{"p1"});
+        return response;
+      })
+      .WillOnce([](Request const& request) {
+        EXPECT_EQ("t1", request.testonly_page_token);
+        return Status(StatusCode::kAborted, "bad-luck");
+      });
+
+  auto range = MakePrefetchingPaginationRange<ItemRange>(
+      Request{}, [&mock](Request const& r) { return mock.Loader(r); },
+      [](ResponseType const& r) { return r.testonly_items; });
+  std::vector<std::string> names;
+  Status status;
+  for (auto& p : range) {
+    if (!p) {
+      status = std::move(p).status();
+      break;
+    }
+    names.push_back(p->data);
+  }
+  EXPECT_THAT(names, ElementsAre("p1"));
+  EXPECT_THAT(status, StatusIs(StatusCode::kAborted, HasSubstr("bad-luck")));
+}
+
+TYPED_TEST(PaginationRangeTest, PrefetchAbandoned) {
+  using ResponseType = TypeParam;
+  MockRpc<ResponseType> mock;
+  EXPECT_CALL(mock, Loader(_))
+      .WillOnce([](Request const&) {
+        ResponseType response;
+        response.testonly_set_page_token("t1");
+        response.testonly_items.push_back(Item{"p1"});
+        return response;
+      })
+      .WillOnce([](Request const&) {
+        ResponseType response;
+        response.testonly_items.push_back(Item{"p2"});
+        return response;
+      });
+
+  // Destroying the range waits for the pending request, so `mock` outlives
+  // all the calls.
+  {
+    auto range = MakePrefetchingPaginationRange<ItemRange>(
+        Request{}, [&mock](Request const& r) { return mock.Loader(r); },
+        [](ResponseType const& r) { return r.testonly_items; });
+    auto i = range.begin();
+    ASSERT_NE(i, range.end());
+    EXPECT_EQ("p1", (*i)->data);
+  }
+}
+
+// Returns the names in a batch, or the error.
+StatusOr<std::vector<std::string>> BatchNames(
+    StatusOr<std::vector<Item>> batch) {
+  if (!batch) return std::move(batch).status();
+  std::vector<std::string> names;
+  for (auto const& i : *batch) names.push_back(i.data);
+  return names;
+}
+
+TYPED_TEST(PaginationRangeTest, NextBatch) {
+  using ResponseType = TypeParam;
+  MockRpc<ResponseType> mock;
+  EXPECT_CALL(mock, Loader(_))
+      .WillOnce([](Request const& request) {
+        EXPECT_TRUE(request.testonly_page_token.empty());
+        ResponseType response;
+        response.testonly_set_page_token("t1");
+        response.testonly_items.push_back(Item{"p1"});
+        response.testonly_items.push_back(Item{"p2"});
+        return response;
+      })
+      .WillOnce([](Request const& request) {
+        EXPECT_EQ("t1", request.testonly_page_token);
+        ResponseType response;
+        response.testonly_set_page_token("t2");
+        response.testonly_items.push_back(Item{"p3"});
+        response.testonly_items.push_back(Item{"p4"});
+        return response;
+      })
+      .WillOnce([](Request const& request) {
+        EXPECT_EQ("t2", request.testonly_page_token);
+        return Status(StatusCode::kAborted, "bad-luck");
+      });
+
+  auto range = MakePaginationRange<ItemRange>(
+      Request{}, [&mock](Request const& r) { return mock.Loader(r); },
+      [](ResponseType const& r) { return r.testonly_items; });
+  // Each batch is a page.
+  auto batch = BatchNames(range.NextBatch());
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre("p1", "p2"));
+  batch = BatchNames(range.NextBatch());
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre("p3", "p4"));
+  EXPECT_THAT(range.NextBatch(),
+              StatusIs(StatusCode::kAborted, HasSubstr("bad-luck")));
+  batch = BatchNames(range.NextBatch());
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, IsEmpty());
+}
+
+TYPED_TEST(PaginationRangeTest, PrefetchNextBatch) {
+  using ResponseType = TypeParam;
+  MockRpc<ResponseType> mock;
+  EXPECT_CALL(mock, Loader(_))
+      .WillOnce([](Request const& request) {
+        EXPECT_TRUE(request.testonly_page_token.empty());
+        ResponseType response;
+        response.testonly_set_page_token("t1");
+        response.testonly_items.push_back(Item{"p1"});
+        response.testonly_items.push_back(Item{"p2"});
+        return response;
+      })
+      .WillOnce([](Request const& request) {
+        EXPECT_EQ("t1", request.testonly_page_token);
+        ResponseType response;
+        response.testonly_items.push_back(Item{"p3"});
+        return response;
+      });
+
+  auto range = MakePrefetchingPaginationRange<ItemRange>(
+      Request{}, [&mock](Request const& r) { return mock.Loader(r); },
+      [](ResponseType const& r) { return r.testonly_items; });
+  // Consume one element with the iterators, and the rest in batches.
+  auto i = range.begin();
+  ASSERT_NE(i, range.end());
+  EXPECT_EQ("p1", (*i)->data);
+  ++i;
+  auto batch = BatchNames(range.NextBatch());
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre("p2"));
+  batch = BatchNames(range.NextBatch());
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre("p3"));
+  batch = BatchNames(range.NextBatch());
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, IsEmpty());
+}
+
 TEST(RangeFromPagination, Unimplemented) {
   using NonProtoRange = PaginationRange<std::string>;
   auto range = MakeUnimplementedPaginationRange<NonProtoRange>();
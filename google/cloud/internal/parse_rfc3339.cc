@@ -14,14 +14,149 @@
 
 #include "google/cloud/internal/parse_rfc3339.h"
 #include "google/cloud/internal/throw_delegate.h"
-#include "absl/strings/ascii.h"
 #include "absl/time/time.h"
+#include <cstdint>
 
 namespace google {
 namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
 namespace internal {
-std::chrono::system_clock::time_point ParseRfc3339(
+namespace {
+
+// The parser below is hand-rolled: timestamps are parsed for every field of
+// every object in a listing, and going through a generic format string parser
+// showed up in profiles. It accepts the same inputs as
+// `absl::ParseTime(absl::RFC3339_full, ...)`, which it replaced, for years
+// written with 4 digits. Other years (e.g. `-0001` or `10000`) are rare, they
+// are still parsed by absl.
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+/// Parses exactly @p width digits at @p p, advancing @p p on success.
+bool ParseDigits(char const*& p, char const* end, int width, int& value) {
+  if (end - p < width) return false;
+  int v = 0;
+  for (int i = 0; i != width; ++i) {
+    if (!IsDigit(p[i])) return false;
+    v = v * 10 + (p[i] - '0');
+  }
+  p += width;
+  value = v;
+  return true;
+}
+
+bool Expect(char const*& p, char const* end, char c) {
+  if (p == end || *p != c) return false;
+  ++p;
+  return true;
+}
+
+bool IsLeapYear(int y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+
+int DaysInMonth(int y, int m) {
+  static int const kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return m == 2 && IsLeapYear(y) ? 29 : kDays[m - 1];
+}
+
+// Returns the number of days since 1970-01-01 for a date in the proleptic
+// Gregorian calendar, see http://howardhinnant.github.io/date_algorithms.html
+std::int64_t DaysFromCivil(std::int64_t y, int m, int d) {
+  y -= m <= 2 ? 1 : 0;
+  std::int64_t const era = (y >= 0 ? y : y - 399) / 400;
+  auto const yoe = y - era * 400;
+  auto const doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  auto const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+struct ParsedTimestamp {
+  std::int64_t seconds;
+  std::int64_t nanos;
+};
+
+/// Returned by `Parse()` if the year is not written with 4 digits.
+char const kUnsupportedYear[] = "unsupported year";
+
+/// Parses @p timestamp, returns an error message on failure.
+char const* Parse(std::string const& timestamp, ParsedTimestamp& result) {
+  char const* p = timestamp.data();
+  char const* end = p + timestamp.size();
+  while (p != end && IsSpace(*p)) ++p;
+  while (end != p && IsSpace(end[-1])) --end;
+
+  int year;
+  if (!ParseDigits(p, end, 4, year) || !Expect(p, end, '-')) {
+    return kUnsupportedYear;
+  }
+  int month;
+  int mday;
+  if (!ParseDigits(p, end, 2, month) || !Expect(p, end, '-') ||
+      !ParseDigits(p, end, 2, mday)) {
+    return "invalid date";
+  }
+  if (month < 1 || month > 12) return "month out of range";
+  if (mday < 1 || mday > DaysInMonth(year, month)) {
+    return "day of month out of range";
+  }
+  if (p == end || (*p != 'T' && *p != 't')) return "missing 'T' separator";
+  ++p;
+
+  int hour;
+  int minute;
+  int second;
+  if (!ParseDigits(p, end, 2, hour) || !Expect(p, end, ':') ||
+      !ParseDigits(p, end, 2, minute) || !Expect(p, end, ':') ||
+      !ParseDigits(p, end, 2, second)) {
+    return "invalid time";
+  }
+  // Allow leap seconds, they are normalized to the start of the next minute.
+  if (hour > 23 || minute > 59 || second > 60) return "time out of range";
+
+  std::int64_t nanos = 0;
+  if (p != end && *p == '.') {
+    ++p;
+    if (p == end || !IsDigit(*p)) return "invalid fractional seconds";
+    // Any digits beyond nanoseconds are truncated.
+    int digits = 0;
+    for (; p != end && IsDigit(*p); ++p, ++digits) {
+      if (digits < 9) nanos = nanos * 10 + (*p - '0');
+    }
+    for (; digits < 9; ++digits) nanos *= 10;
+  }
+
+  int offset = 0;
+  if (p != end && (*p == 'Z' || *p == 'z')) {
+    ++p;
+  } else if (p != end && (*p == '+' || *p == '-')) {
+    int const sign = *p == '-' ? -1 : 1;
+    ++p;
+    int offset_hours;
+    int offset_minutes;
+    if (!ParseDigits(p, end, 2, offset_hours) || !Expect(p, end, ':') ||
+        !ParseDigits(p, end, 2, offset_minutes)) {
+      return "invalid UTC offset";
+    }
+    if (offset_hours > 23 || offset_minutes > 59) {
+      return "UTC offset out of range";
+    }
+    offset = sign * (offset_hours * 3600 + offset_minutes * 60);
+  } else {
+    return "missing UTC offset";
+  }
+  if (p != end) return "unexpected trailing characters";
+
+  result.seconds = DaysFromCivil(year, month, mday) * 86400 + hour * 3600 +
+                   minute * 60 + second - offset;
+  result.nanos = nanos;
+  return nullptr;
+}
+
+std::chrono::system_clock::time_point ParseWithAbsl(
     std::string const& timestamp) {
   std::string err;
   absl::Time t;
@@ -32,6 +167,37 @@ std::chrono::system_clock::time_point ParseRfc3339(
   return absl::ToChronoTime(t);
 }
 
+}  // namespace
+
+std::chrono::system_clock::time_point ParseRfc3339(
+    std::string const& timestamp) {
+  ParsedTimestamp parsed;
+  auto const* error = Parse(timestamp, parsed);
+  if (error == kUnsupportedYear) return ParseWithAbsl(timestamp);
+  if (error != nullptr) {
+    google::cloud::internal::ThrowInvalidArgument(
+        "Error parsing RFC-3339 timestamp: '" + timestamp + "': " + error);
+  }
+
+  using std::chrono::duration_cast;
+  using std::chrono::system_clock;
+  // Like `absl::ToChronoTime()`, saturate values that cannot be represented,
+  // and truncate towards the past any precision the clock lacks.
+  auto constexpr kMaxSeconds = duration_cast<std::chrono::seconds>(
+                                   system_clock::duration::max())
+                                   .count();
+  auto constexpr kMinSeconds = duration_cast<std::chrono::seconds>(
+                                   system_clock::duration::min())
+                                   .count();
+  if (parsed.seconds >= kMaxSeconds) return system_clock::time_point::max();
+  if (parsed.seconds <= kMinSeconds) return system_clock::time_point::min();
+  return system_clock::time_point(
+      duration_cast<system_clock::duration>(
+          std::chrono::seconds(parsed.seconds)) +
+      duration_cast<system_clock::duration>(
+          std::chrono::nanoseconds(parsed.nanos)));
+}
+
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "google/cloud/internal/parse_rfc3339.h"
+#include "google/cloud/internal/format_time_point.h"
+#include "absl/time/time.h"
 #include <gtest/gtest.h>
 #include <ctime>
 
@@ -155,6 +157,75 @@ TEST(ParseRfc3339Test, ParseFull) {
   EXPECT_EQ(500, actual_milliseconds.count());
 }
 
+TEST(ParseRfc3339Test, ParseBeforeEpoch) {
+  auto timestamp = ParseRfc3339("1969-12-31T23:59:59.25Z");
+  auto actual = duration_cast<milliseconds>(timestamp.time_since_epoch());
+  EXPECT_EQ(-750, actual.count());
+  // Use `date -u +%s --date='1900-01-01T00:00:00Z'` to get the magic value:
+  timestamp = ParseRfc3339("1900-01-01T00:00:00Z");
+  EXPECT_EQ(-2208988800L,
+            duration_cast<seconds>(timestamp.time_since_epoch()).count());
+}
+
+TEST(ParseRfc3339Test, ParseLeapSecond) {
+  auto timestamp = ParseRfc3339("2016-12-31T23:59:60Z");
+  // Use `date -u +%s --date='2017-01-01T00:00:00Z'` to get the magic value:
+  EXPECT_EQ(1483228800L,
+            duration_cast<seconds>(timestamp.time_since_epoch()).count());
+}
+
+TEST(ParseRfc3339Test, ParseSurroundingWhitespace) {
+  auto timestamp = ParseRfc3339(" 2018-05-18T14:42:03Z\n");
+  // Use `date -u +%s --date='2018-05-18T14:42:03'` to get the magic value:
+  EXPECT_EQ(1526654523L,
+            duration_cast<seconds>(timestamp.time_since_epoch()).count());
+}
+
+TEST(ParseRfc3339Test, ParseYearsOutsideFourDigits) {
+  for (auto year : {-1, 10000, 12345}) {
+    auto const t = absl::FromCivil(absl::CivilSecond(year, 6, 15, 12, 30, 45),
+                                   absl::UTCTimeZone());
+    auto const input = absl::FormatTime(absl::RFC3339_full, t,
+                                        absl::UTCTimeZone());
+    // Time points the system clock cannot represent saturate, as they did
+    // with `absl::ToChronoTime()`.
+    EXPECT_EQ(absl::ToChronoTime(t), ParseRfc3339(input)) << input;
+  }
+}
+
+TEST(ParseRfc3339Test, RoundTripYearsOutsideFourDigits) {
+  // `FormatRfc3339()` uses absl to format these years, verify the results can
+  // be parsed back.
+  for (auto year : {-1, 10000, 12345}) {
+    auto const t = absl::FromCivil(absl::CivilSecond(year, 6, 15, 12, 30, 45),
+                                   absl::UTCTimeZone());
+    auto const tp = absl::ToChronoTime(t);
+    // Skip the years the system clock cannot represent, with nanosecond
+    // precision it only covers the years 1678 to 2261.
+    if (absl::FromChrono(tp) != t) continue;
+    EXPECT_EQ(tp, ParseRfc3339(FormatRfc3339(tp))) << year;
+  }
+}
+
+TEST(ParseRfc3339Test, DetectMalformed) {
+  for (auto const* input : {
+           "",
+           "2018-05-18",
+           "2018-05-18T14:42:03",
+           "2018-05-18T14:42:03.Z",
+           "2018-05-18T14:42:03Zx",
+           "2018-05-18T14:42:03+08",
+           "2018-5-18T14:42:03Z",
+           "2018-05-18T14:42:3Z",
+       }) {
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    EXPECT_THROW(ParseRfc3339(input), std::invalid_argument) << input;
+#else
+    EXPECT_DEATH_IF_SUPPORTED(ParseRfc3339(input), "exceptions are disabled");
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  }
+}
+
 TEST(ParseRfc3339Test, DetectInvalidSeparator) {
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
   EXPECT_THROW(ParseRfc3339("2018-05-18x14:42:03Z"), std::invalid_argument);
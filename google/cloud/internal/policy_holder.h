@@ -0,0 +1,91 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_POLICY_HOLDER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_POLICY_HOLDER_H
+
+#include "google/cloud/version.h"
+#include <memory>
+#include <type_traits>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Determine if a retry, backoff, or idempotency policy is held by pointer.
+ *
+ * The retry loops and the generated connections accept policies either as
+ * `std::unique_ptr<>` / `std::shared_ptr<>` to a (typically abstract) base
+ * class, or as values of a concrete policy type. Holding the policy by value
+ * avoids a heap allocation to clone it on each call, and lets the compiler
+ * resolve (and inline) the calls into the policy.
+ */
+template <typename T>
+struct IsPolicyPointer : public std::false_type {};
+
+template <typename T, typename D>
+struct IsPolicyPointer<std::unique_ptr<T, D>> : public std::true_type {};
+
+template <typename T>
+struct IsPolicyPointer<std::shared_ptr<T>> : public std::true_type {};
+
+template <typename T>
+struct IsPolicyPointer<T const> : public IsPolicyPointer<T> {};
+
+/// Returns the policy referenced by @p p, which is held by pointer.
+template <typename T, typename std::enable_if<IsPolicyPointer<T>::value,
+                                              int>::type = 0>
+auto PolicyRef(T& p) -> decltype(*p) {
+  return *p;
+}
+
+/// Returns @p p, which is a policy held by value.
+template <typename T, typename std::enable_if<!IsPolicyPointer<T>::value,
+                                              int>::type = 0>
+T& PolicyRef(T& p) {
+  return p;
+}
+
+/**
+ * Creates a fresh copy of a policy prototype held by pointer.
+ *
+ * The copy preserves the dynamic type of the prototype, at the cost of a heap
+ * allocation.
+ */
+template <typename T, typename std::enable_if<IsPolicyPointer<T>::value,
+                                              int>::type = 0>
+auto ClonePolicy(T const& p) -> decltype(p->clone()) {
+  return p->clone();
+}
+
+/**
+ * Creates a fresh copy of a policy prototype held by value.
+ *
+ * The policies copy only their configuration, a copy starts with the same
+ * state as the result of `clone()`.
+ */
+template <typename T, typename std::enable_if<!IsPolicyPointer<T>::value,
+                                              int>::type = 0>
+T ClonePolicy(T const& p) {
+  return p;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_POLICY_HOLDER_H
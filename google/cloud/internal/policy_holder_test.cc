@@ -0,0 +1,86 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/policy_holder.h"
+#include "google/cloud/internal/backoff_policy.h"
+#include "google/cloud/internal/retry_policy.h"
+#include <gmock/gmock.h>
+#include <chrono>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+struct TestRetryablePolicy {
+  static bool IsPermanentFailure(Status const& s) {
+    return !s.ok() && (s.code() == StatusCode::kPermissionDenied);
+  }
+};
+
+using TestRetryPolicy = TraitBasedRetryPolicy<TestRetryablePolicy>;
+using TestLimitedErrorCountRetryPolicy =
+    LimitedErrorCountRetryPolicy<TestRetryablePolicy>;
+
+static_assert(IsPolicyPointer<std::unique_ptr<TestRetryPolicy>>::value, "");
+static_assert(IsPolicyPointer<std::shared_ptr<TestRetryPolicy const>>::value,
+              "");
+static_assert(IsPolicyPointer<std::unique_ptr<BackoffPolicy> const>::value, "");
+static_assert(!IsPolicyPointer<TestLimitedErrorCountRetryPolicy>::value, "");
+static_assert(!IsPolicyPointer<ExponentialBackoffPolicy const>::value, "");
+
+TEST(PolicyHolderTest, PolicyRefPointer) {
+  auto p = TestLimitedErrorCountRetryPolicy(1).clone();
+  TestRetryPolicy& ref = PolicyRef(p);
+  EXPECT_EQ(p.get(), &ref);
+}
+
+TEST(PolicyHolderTest, PolicyRefValue) {
+  TestLimitedErrorCountRetryPolicy p(1);
+  auto const& cp = p;
+  EXPECT_EQ(&p, &PolicyRef(p));
+  EXPECT_EQ(&p, &PolicyRef(cp));
+}
+
+TEST(PolicyHolderTest, ClonePolicyPointer) {
+  std::unique_ptr<TestRetryPolicy> prototype =
+      TestLimitedErrorCountRetryPolicy(1).clone();
+  ASSERT_TRUE(prototype->OnFailure(Status(StatusCode::kUnavailable, "")));
+  ASSERT_FALSE(prototype->OnFailure(Status(StatusCode::kUnavailable, "")));
+  ASSERT_TRUE(prototype->IsExhausted());
+
+  std::unique_ptr<TestRetryPolicy> copy = ClonePolicy(prototype);
+  EXPECT_NE(prototype.get(), copy.get());
+  EXPECT_FALSE(copy->IsExhausted());
+}
+
+TEST(PolicyHolderTest, ClonePolicyValue) {
+  TestLimitedErrorCountRetryPolicy prototype(1);
+  ASSERT_TRUE(prototype.OnFailure(Status(StatusCode::kUnavailable, "")));
+  ASSERT_FALSE(prototype.OnFailure(Status(StatusCode::kUnavailable, "")));
+  ASSERT_TRUE(prototype.IsExhausted());
+
+  // A copy of a value is a fresh policy, the same as the result of `clone()`.
+  TestLimitedErrorCountRetryPolicy copy = ClonePolicy(prototype);
+  EXPECT_FALSE(copy.IsExhausted());
+  EXPECT_TRUE(copy.OnFailure(Status(StatusCode::kUnavailable, "")));
+  EXPECT_FALSE(copy.OnFailure(Status(StatusCode::kUnavailable, "")));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
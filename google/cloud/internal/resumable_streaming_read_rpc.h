@@ -17,6 +17,7 @@
 
 #include "google/cloud/internal/streaming_read_rpc.h"
 #include "google/cloud/version.h"
+#include "absl/types/optional.h"
 #include <memory>
 #include <thread>
 
@@ -90,13 +91,20 @@ class ResumableStreamingReadRpc : public StreamingReadRpc<ResponseType> {
   void Cancel() override { impl_->Cancel(); }
 
   absl::variant<Status, ResponseType> Read() override {
-    auto response = impl_->Read();
-    if (absl::holds_alternative<ResponseType>(response)) {
-      updater_(absl::get<ResponseType>(response), request_);
+    ResponseType response;
+    auto status = ReadInto(response);
+    if (status) return *std::move(status);
+    return response;
+  }
+
+  absl::optional<Status> ReadInto(ResponseType& response) override {
+    auto status = impl_->ReadInto(response);
+    if (!status) {
+      updater_(response, request_);
       has_received_data_ = true;
-      return response;
+      return status;
     }
-    auto last_status = absl::get<Status>(std::move(response));
+    auto last_status = *std::move(status);
     if (last_status.ok()) return last_status;
     // Need to start a retry loop to connect again. Note that we *retry* to
     // start a streaming read, but once the streaming read succeeds at least
@@ -115,13 +123,13 @@ class ResumableStreamingReadRpc : public StreamingReadRpc<ResponseType> {
       sleeper_(backoff_policy->OnCompletion());
       has_received_data_ = false;
       impl_ = stream_factory_(request_);
-      auto r = impl_->Read();
-      if (absl::holds_alternative<ResponseType>(r)) {
-        updater_(absl::get<ResponseType>(r), request_);
+      status = impl_->ReadInto(response);
+      if (!status) {
+        updater_(response, request_);
         has_received_data_ = true;
-        return r;
+        return status;
       }
-      last_status = absl::get<Status>(std::move(r));
+      last_status = *std::move(status);
     }
     return last_status;
   }
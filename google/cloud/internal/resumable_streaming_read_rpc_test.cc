@@ -145,6 +145,42 @@ TEST(ResumableStreamingReadRpc, ResumeWithPartials) {
   EXPECT_THAT(values, ElementsAre("value-0", "value-1", "value-2"));
 }
 
+TEST(ResumableStreamingReadRpc, ResumeWithReadInto) {
+  MockStub mock;
+  EXPECT_CALL(mock, StreamingRead)
+      .WillOnce([](FakeRequest const&) {
+        auto stream = absl::make_unique<MockStreamingReadRpc>();
+        EXPECT_CALL(*stream, Read)
+            .WillOnce(Return(AsReadReturn(FakeResponse{"value-0", "token-1"})))
+            .WillOnce(Return(TransientFailure()));
+        return stream;
+      })
+      .WillOnce([](FakeRequest const& request) {
+        EXPECT_THAT(request.token, "token-1");
+        auto stream = absl::make_unique<MockStreamingReadRpc>();
+        EXPECT_CALL(*stream, Read)
+            .WillOnce(Return(AsReadReturn(FakeResponse{"value-1", "token-2"})))
+            .WillOnce(Return(StreamSuccess()));
+        return stream;
+      });
+  auto reader = MakeResumableStreamingReadRpc<FakeResponse, FakeRequest>(
+      DefaultRetryPolicy(), DefaultBackoffPolicy(),
+      [](std::chrono::milliseconds) {},
+      [&mock](FakeRequest const& request) {
+        return mock.StreamingRead(request);
+      },
+      DefaultUpdater, FakeRequest{"test-key", {}});
+
+  FakeResponse response;
+  std::vector<std::string> values;
+  absl::optional<Status> status;
+  while (!(status = reader->ReadInto(response))) {
+    values.push_back(response.value);
+  }
+  EXPECT_THAT(*status, StatusIs(StatusCode::kOk));
+  EXPECT_THAT(values, ElementsAre("value-0", "value-1"));
+}
+
 TEST(ResumableStreamingReadRpc, TooManyTransientFailures) {
   MockStub mock;
   EXPECT_CALL(mock, StreamingRead)
@@ -0,0 +1,76 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/retry_budget.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+RetryBudget::RetryBudget(double max_tokens, double token_ratio)
+    : RetryBudget(max_tokens, token_ratio, 0, std::chrono::milliseconds(0)) {}
+
+RetryBudget::RetryBudget(double max_tokens, double token_ratio,
+                         int failure_threshold,
+                         std::chrono::milliseconds cooldown)
+    : max_tokens_(max_tokens),
+      token_ratio_(token_ratio),
+      failure_threshold_(failure_threshold),
+      cooldown_(cooldown),
+      tokens_(max_tokens) {}
+
+bool RetryBudget::OnFailure() {
+  auto const now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lk(mu_);
+  tokens_ = (std::max)(tokens_ - 1.0, 0.0);
+  ++consecutive_failures_;
+  if (failure_threshold_ > 0 && consecutive_failures_ >= failure_threshold_) {
+    open_until_ = now + cooldown_;
+    // Stay at the threshold, once the cooldown expires a single failure is
+    // enough to open the circuit again.
+    consecutive_failures_ = failure_threshold_ - 1;
+    return false;
+  }
+  if (CircuitOpen(now)) return false;
+  return tokens_ > max_tokens_ / 2;
+}
+
+void RetryBudget::OnSuccess() {
+  std::lock_guard<std::mutex> lk(mu_);
+  tokens_ = (std::min)(tokens_ + token_ratio_, max_tokens_);
+  consecutive_failures_ = 0;
+  open_until_ = std::chrono::steady_clock::time_point{};
+}
+
+double RetryBudget::tokens() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return tokens_;
+}
+
+bool RetryBudget::circuit_open() const {
+  auto const now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lk(mu_);
+  return CircuitOpen(now);
+}
+
+bool RetryBudget::CircuitOpen(std::chrono::steady_clock::time_point now) const {
+  return failure_threshold_ > 0 && now < open_until_;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,170 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RETRY_BUDGET_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RETRY_BUDGET_H
+
+#include "google/cloud/internal/retry_policy.h"
+#include "google/cloud/status.h"
+#include "google/cloud/version.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * A retry budget shared by many calls, with an optional circuit breaker.
+ *
+ * Retry policies are cloned for each call, so during an outage every call
+ * independently retries until its own policy is exhausted. That multiplies the
+ * load on a backend that is already struggling. A `RetryBudget` is shared (via
+ * `std::shared_ptr<>`) by all the calls using a connection, and limits the
+ * number of retries across all of them.
+ *
+ * The budget is a token bucket, using the same algorithm as the gRPC retry
+ * throttling feature. The bucket starts full, with `max_tokens` tokens. Each
+ * transient failure removes one token, and each successful call adds
+ * `token_ratio` tokens (up to `max_tokens`). Retries are only allowed while
+ * the bucket holds more than half of `max_tokens`. The first attempt of a call
+ * is never blocked, so successful calls always refill the bucket.
+ *
+ * Optionally, the budget also implements a circuit breaker. After
+ * `failure_threshold` consecutive transient failures the circuit "opens" and
+ * all retries are denied for `cooldown`. While the circuit is open, or once
+ * the cooldown expires, any further failure restarts the cooldown. A single
+ * success closes the circuit.
+ *
+ * This class is thread-safe.
+ */
+class RetryBudget {
+ public:
+  /**
+   * Creates a budget without a circuit breaker.
+   *
+   * @param max_tokens the capacity of the token bucket, must be positive.
+   * @param token_ratio the number of tokens earned by each successful call.
+   */
+  RetryBudget(double max_tokens, double token_ratio);
+
+  /**
+   * Creates a budget with a circuit breaker.
+   *
+   * @param max_tokens the capacity of the token bucket, must be positive.
+   * @param token_ratio the number of tokens earned by each successful call.
+   * @param failure_threshold the number of consecutive failures that open the
+   *     circuit, a value `<= 0` disables the circuit breaker.
+   * @param cooldown how long the circuit stays open.
+   */
+  RetryBudget(double max_tokens, double token_ratio, int failure_threshold,
+              std::chrono::milliseconds cooldown);
+
+  /**
+   * Records a transient failure and returns true if it may be retried.
+   */
+  bool OnFailure();
+
+  /// Records a successful call.
+  void OnSuccess();
+
+  /// The number of tokens currently in the bucket.
+  double tokens() const;
+
+  /// Returns true if the circuit breaker is open.
+  bool circuit_open() const;
+
+ private:
+  bool CircuitOpen(std::chrono::steady_clock::time_point now) const;
+
+  double const max_tokens_;
+  double const token_ratio_;
+  int const failure_threshold_;
+  std::chrono::milliseconds const cooldown_;
+
+  mutable std::mutex mu_;
+  double tokens_;                // GUARDED_BY(mu_)
+  int consecutive_failures_ = 0;  // GUARDED_BY(mu_)
+  std::chrono::steady_clock::time_point open_until_;  // GUARDED_BY(mu_)
+};
+
+/**
+ * A retry policy that consults a shared `RetryBudget`.
+ *
+ * Wraps any other `TraitBasedRetryPolicy<>` with the same traits. The wrapped
+ * policy controls the retry loop for each call as usual, but a transient
+ * failure is only retried if the shared budget also allows it. When the
+ * budget denies a retry the policy reports itself as exhausted.
+ *
+ * Clones of this policy share the same `RetryBudget`, so all the calls on a
+ * connection configured with this policy draw from the same budget.
+ *
+ * @tparam RetryableTraits the traits to decide if a status represents a
+ *     permanent failure.
+ */
+template <typename RetryableTraits>
+class BudgetedRetryPolicy : public TraitBasedRetryPolicy<RetryableTraits> {
+ public:
+  using BaseType = TraitBasedRetryPolicy<RetryableTraits>;
+
+  BudgetedRetryPolicy(BaseType const& policy,
+                      std::shared_ptr<RetryBudget> budget)
+      : policy_(policy.clone()), budget_(std::move(budget)) {}
+
+  BudgetedRetryPolicy(BudgetedRetryPolicy&& rhs) noexcept = default;
+  BudgetedRetryPolicy(BudgetedRetryPolicy const& rhs)
+      : BudgetedRetryPolicy(*rhs.policy_, rhs.budget_) {}
+
+  std::unique_ptr<BaseType> clone() const override {
+    return std::unique_ptr<BaseType>(
+        new BudgetedRetryPolicy(*policy_, budget_));
+  }
+
+  bool OnFailure(Status const& status) override {
+    if (RetryableTraits::IsPermanentFailure(status)) return false;
+    // Always charge the budget, even if the wrapped policy is exhausted, the
+    // failure is still evidence that the service is unhealthy.
+    if (!budget_->OnFailure()) budget_denied_ = true;
+    auto const retry = policy_->OnFailure(status);
+    return retry && !budget_denied_;
+  }
+
+  bool IsExhausted() const override {
+    return budget_denied_ || policy_->IsExhausted();
+  }
+
+  void OnSuccess() override {
+    budget_->OnSuccess();
+    policy_->OnSuccess();
+  }
+
+  std::shared_ptr<RetryBudget> const& budget() const { return budget_; }
+
+ protected:
+  void OnFailureImpl() override {}
+
+ private:
+  std::unique_ptr<BaseType> policy_;
+  std::shared_ptr<RetryBudget> budget_;
+  bool budget_denied_ = false;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RETRY_BUDGET_H
@@ -0,0 +1,145 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/retry_budget.h"
+#include "google/cloud/status.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+struct TestRetryablePolicy {
+  static bool IsPermanentFailure(google::cloud::Status const& s) {
+    return !s.ok() &&
+           (s.code() == google::cloud::StatusCode::kPermissionDenied);
+  }
+};
+
+Status CreateTransientError() { return Status(StatusCode::kUnavailable, ""); }
+Status CreatePermanentError() {
+  return Status(StatusCode::kPermissionDenied, "");
+}
+
+using LimitedErrorCountRetryPolicyForTest =
+    google::cloud::internal::LimitedErrorCountRetryPolicy<TestRetryablePolicy>;
+using BudgetedRetryPolicyForTest =
+    google::cloud::internal::BudgetedRetryPolicy<TestRetryablePolicy>;
+
+/// @test Verify retries are allowed until half the tokens are spent.
+TEST(RetryBudget, SpendTokens) {
+  RetryBudget tested(10, 1);
+  EXPECT_DOUBLE_EQ(10, tested.tokens());
+  for (int i = 0; i != 4; ++i) {
+    EXPECT_TRUE(tested.OnFailure()) << "i=" << i;
+  }
+  EXPECT_FALSE(tested.OnFailure());
+  EXPECT_DOUBLE_EQ(5, tested.tokens());
+  EXPECT_FALSE(tested.circuit_open());
+}
+
+/// @test Verify successes refill the bucket, up to its capacity.
+TEST(RetryBudget, SuccessEarnsTokens) {
+  RetryBudget tested(10, 0.5);
+  for (int i = 0; i != 6; ++i) tested.OnFailure();
+  EXPECT_DOUBLE_EQ(4, tested.tokens());
+  EXPECT_FALSE(tested.OnFailure());
+  EXPECT_DOUBLE_EQ(3, tested.tokens());
+  for (int i = 0; i != 8; ++i) tested.OnSuccess();
+  EXPECT_DOUBLE_EQ(7, tested.tokens());
+  EXPECT_TRUE(tested.OnFailure());
+  for (int i = 0; i != 100; ++i) tested.OnSuccess();
+  EXPECT_DOUBLE_EQ(10, tested.tokens());
+}
+
+/// @test Verify the circuit breaker opens and closes.
+TEST(RetryBudget, CircuitBreaker) {
+  RetryBudget tested(1000, 1, 3, std::chrono::hours(1));
+  EXPECT_TRUE(tested.OnFailure());
+  EXPECT_TRUE(tested.OnFailure());
+  EXPECT_FALSE(tested.circuit_open());
+  EXPECT_FALSE(tested.OnFailure());
+  EXPECT_TRUE(tested.circuit_open());
+  EXPECT_FALSE(tested.OnFailure());
+  tested.OnSuccess();
+  EXPECT_FALSE(tested.circuit_open());
+  EXPECT_TRUE(tested.OnFailure());
+}
+
+/// @test Verify the circuit breaker reopens on the first failure after the
+/// cooldown.
+TEST(RetryBudget, CircuitBreakerCooldown) {
+  RetryBudget tested(1000, 1, 2, std::chrono::milliseconds(1));
+  EXPECT_TRUE(tested.OnFailure());
+  EXPECT_FALSE(tested.OnFailure());
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_FALSE(tested.circuit_open());
+  EXPECT_FALSE(tested.OnFailure());
+}
+
+/// @test Verify the policy retries while both the budget and the wrapped
+/// policy allow it.
+TEST(BudgetedRetryPolicy, Simple) {
+  auto budget = std::make_shared<RetryBudget>(100, 1);
+  BudgetedRetryPolicyForTest tested(LimitedErrorCountRetryPolicyForTest(3),
+                                    budget);
+  EXPECT_TRUE(tested.OnFailure(CreateTransientError()));
+  EXPECT_TRUE(tested.OnFailure(CreateTransientError()));
+  EXPECT_TRUE(tested.OnFailure(CreateTransientError()));
+  EXPECT_FALSE(tested.IsExhausted());
+  EXPECT_FALSE(tested.OnFailure(CreateTransientError()));
+  EXPECT_TRUE(tested.IsExhausted());
+  EXPECT_DOUBLE_EQ(96, budget->tokens());
+}
+
+/// @test Verify that permanent errors do not consume the budget.
+TEST(BudgetedRetryPolicy, OnNonRetryable) {
+  auto budget = std::make_shared<RetryBudget>(100, 1);
+  BudgetedRetryPolicyForTest tested(LimitedErrorCountRetryPolicyForTest(3),
+                                    budget);
+  EXPECT_FALSE(tested.OnFailure(CreatePermanentError()));
+  EXPECT_FALSE(tested.IsExhausted());
+  EXPECT_DOUBLE_EQ(100, budget->tokens());
+}
+
+/// @test Verify clones share the budget, and stop retrying once it is spent.
+TEST(BudgetedRetryPolicy, ClonesShareBudget) {
+  auto budget = std::make_shared<RetryBudget>(4, 1);
+  BudgetedRetryPolicyForTest original(LimitedErrorCountRetryPolicyForTest(5),
+                                      budget);
+  auto c1 = original.clone();
+  auto c2 = original.clone();
+  EXPECT_TRUE(c1->OnFailure(CreateTransientError()));
+  EXPECT_FALSE(c2->OnFailure(CreateTransientError()));
+  EXPECT_TRUE(c2->IsExhausted());
+  EXPECT_FALSE(c1->IsExhausted());
+
+  // Each clone starts with a fresh wrapped policy, and a success anywhere
+  // replenishes the shared budget.
+  auto c3 = original.clone();
+  EXPECT_FALSE(c3->IsExhausted());
+  c3->OnSuccess();
+  c3->OnSuccess();
+  EXPECT_DOUBLE_EQ(4, budget->tokens());
+  EXPECT_TRUE(c1->OnFailure(CreateTransientError()));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -16,13 +16,15 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RETRY_LOOP_H
 
 #include "google/cloud/backoff_policy.h"
+#include "google/cloud/cancellation.h"
+#include "google/cloud/instrumentation.h"
 #include "google/cloud/internal/invoke_result.h"
+#include "google/cloud/internal/policy_holder.h"
 #include "google/cloud/internal/retry_loop_helpers.h"
 #include "google/cloud/internal/retry_policy.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/version.h"
 #include <grpcpp/grpcpp.h>
-#include <thread>
 
 namespace google {
 namespace cloud {
@@ -45,6 +47,16 @@ namespace internal {
  *     stack can set timeouts and metadata through this context.
  * @param request the parameters for the request.
  * @param location a string to annotate any error returned by this function.
+ *
+ * If the calling thread has a current `CancellationToken` the loop cancels the
+ * context of the attempt in progress when the token is cancelled, and returns
+ * a `StatusCode::kCancelled` error instead of starting a new attempt.
+ *
+ * @tparam RetryPolicyType the type of @p retry_policy, either a pointer to a
+ *     `RetryPolicy` (such as `std::unique_ptr<RetryPolicy>`), or a concrete
+ *     retry policy held by value.
+ * @tparam BackoffPolicyType the type of @p backoff_policy, either a pointer to
+ *     a `BackoffPolicy`, or a concrete backoff policy held by value.
  * @tparam Functor the type of @p functor.
  * @tparam Request the type of @p request.
  * @tparam Sleeper a dependency injection point to verify (in tests) that the
@@ -52,39 +64,58 @@ namespace internal {
  * @return the result of the first successful call to @p functor, or a
  *     `google::cloud::Status` that indicates the final error for this request.
  */
-template <typename Functor, typename Request, typename Sleeper,
+template <typename RetryPolicyType, typename BackoffPolicyType,
+          typename Functor, typename Request, typename Sleeper,
           typename std::enable_if<
               google::cloud::internal::is_invocable<
                   Functor, grpc::ClientContext&, Request const&>::value,
               int>::type = 0>
-auto RetryLoopImpl(std::unique_ptr<RetryPolicy> retry_policy,
-                   std::unique_ptr<BackoffPolicy> backoff_policy,
-                   Idempotency idempotency, Functor&& functor,
-                   Request const& request, char const* location,
-                   Sleeper sleeper)
+auto RetryLoopImpl(RetryPolicyType retry_policy,
+                   BackoffPolicyType backoff_policy, Idempotency idempotency,
+                   Functor&& functor, Request const& request,
+                   char const* location, Sleeper sleeper)
     -> google::cloud::internal::invoke_result_t<Functor, grpc::ClientContext&,
                                                 Request const&> {
+  auto& retry = PolicyRef(retry_policy);
+  auto& backoff = PolicyRef(backoff_policy);
   Status last_status;
-  while (!retry_policy->IsExhausted()) {
+  std::int64_t attempts = 0;
+  // Report the number of attempts on every exit path.
+  struct RecordAttempts {
+    ~RecordAttempts() { RecordValue("rpc.retry.attempts", *attempts); }
+    std::int64_t const* attempts;
+  } record_attempts{&attempts};
+  auto const token = CurrentCancellationToken();
+  while (!retry.IsExhausted()) {
+    if (IsCancelled(token)) return RetryLoopCancelled(location, last_status);
     // Need to create a new context for each retry.
     grpc::ClientContext context;
+    CancellationRegistration cancel(token, [&context] { context.TryCancel(); });
+    InstrumentedSpan span(location);
+    ++attempts;
     auto result = functor(context, request);
     if (result.ok()) {
+      span.End(Status{});
+      retry.OnSuccess();
       return result;
     }
     last_status = GetResultStatus(std::move(result));
+    span.End(last_status);
+    if (IsCancelled(token)) return RetryLoopCancelled(location, last_status);
     if (idempotency == Idempotency::kNonIdempotent) {
       return RetryLoopError("Error in non-idempotent operation", location,
                             last_status);
     }
-    if (!retry_policy->OnFailure(last_status)) {
+    if (!retry.OnFailure(last_status)) {
       // The retry policy is exhausted or the error is not retryable, either
       // way, exit the loop.
       break;
     }
-    sleeper(backoff_policy->OnCompletion());
+    auto const delay = backoff.OnCompletion();
+    RecordDuration("rpc.retry.backoff", delay);
+    sleeper(delay);
   }
-  if (!retry_policy->IsExhausted()) {
+  if (!retry.IsExhausted()) {
     // The last error cannot be retried, but it is not because the retry
     // policy is exhausted, we call these "permanent errors", and they
     // get a special message.
@@ -94,13 +125,13 @@ auto RetryLoopImpl(std::unique_ptr<RetryPolicy> retry_policy,
 }
 
 /// @copydoc RetryLoopImpl
-template <typename Functor, typename Request,
+template <typename RetryPolicyType, typename BackoffPolicyType,
+          typename Functor, typename Request,
           typename std::enable_if<
               google::cloud::internal::is_invocable<
                   Functor, grpc::ClientContext&, Request const&>::value,
               int>::type = 0>
-auto RetryLoop(std::unique_ptr<RetryPolicy> retry_policy,
-               std::unique_ptr<BackoffPolicy> backoff_policy,
+auto RetryLoop(RetryPolicyType retry_policy, BackoffPolicyType backoff_policy,
                Idempotency idempotency, Functor&& functor,
                Request const& request, char const* location)
     -> google::cloud::internal::invoke_result_t<Functor, grpc::ClientContext&,
@@ -108,7 +139,11 @@ auto RetryLoop(std::unique_ptr<RetryPolicy> retry_policy,
   return RetryLoopImpl(
       std::move(retry_policy), std::move(backoff_policy), idempotency,
       std::forward<Functor>(functor), request, location,
-      [](std::chrono::milliseconds p) { std::this_thread::sleep_for(p); });
+      [](std::chrono::milliseconds p) {
+        // Wake up early if the call is cancelled, the loop checks the token
+        // before the next attempt.
+        SleepUnlessCancelled(CurrentCancellationToken(), p);
+      });
 }
 
 }  // namespace internal
@@ -0,0 +1,135 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/backoff_policy.h"
+#include "google/cloud/internal/policy_holder.h"
+#include "google/cloud/internal/retry_loop.h"
+#include "google/cloud/internal/retry_policy.h"
+#include "google/cloud/status_or.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+// Compare the per-call overhead of the retry loop when the policies are cloned
+// from prototypes held by `std::unique_ptr<>` (the default in generated
+// connections) against policies held by value (`static_retry_policies=true`).
+// The operation always succeeds on the first attempt, so the measurement is
+// dominated by creating the policies and consulting them.
+//
+// Run on (1 X 2000 MHz CPU )
+// CPU Caches:
+//  L1 Data 48 KiB (x1)
+//  L1 Instruction 32 KiB (x1)
+//  L2 Unified 2048 KiB (x1)
+//  L3 Unified 107520 KiB (x1)
+// Load Average: 0.44, 0.26, 0.30
+// ----------------------------------------------------------------------------
+// Benchmark                                  Time             CPU   Iterations
+// ----------------------------------------------------------------------------
+// BM_RetryLoopClonedPolicies               149 ns          148 ns      4735763
+// BM_RetryLoopValuePolicies                137 ns          132 ns      5278462
+
+struct BenchmarkRetryablePolicy {
+  static bool IsPermanentFailure(Status const& s) {
+    return !s.ok() && s.code() != StatusCode::kUnavailable;
+  }
+};
+
+using BenchmarkRetryPolicy = TraitBasedRetryPolicy<BenchmarkRetryablePolicy>;
+using BenchmarkLimitedTimeRetryPolicy =
+    LimitedTimeRetryPolicy<BenchmarkRetryablePolicy>;
+
+class IdempotencyPolicy {
+ public:
+  virtual ~IdempotencyPolicy() = default;
+  virtual Idempotency Method(int const&) = 0;
+};
+
+class DefaultIdempotencyPolicy final : public IdempotencyPolicy {
+ public:
+  Idempotency Method(int const&) override { return Idempotency::kIdempotent; }
+};
+
+auto constexpr kBackoffScaling = 2.0;
+
+/// A minimal version of the `*ConnectionImpl` classes in generated code.
+template <typename RetryPolicyType, typename BackoffPolicyType,
+          typename IdempotencyPolicyType>
+class Connection {
+ public:
+  Connection(RetryPolicyType retry_policy, BackoffPolicyType backoff_policy,
+             IdempotencyPolicyType idempotency_policy)
+      : retry_policy_prototype_(std::move(retry_policy)),
+        backoff_policy_prototype_(std::move(backoff_policy)),
+        idempotency_policy_(std::move(idempotency_policy)) {}
+
+  StatusOr<int> Method(int const& request) {
+    return RetryLoop(
+        ClonePolicy(retry_policy_prototype_),
+        ClonePolicy(backoff_policy_prototype_),
+        PolicyRef(idempotency_policy_).Method(request),
+        [](grpc::ClientContext&, int const& r) { return StatusOr<int>(r); },
+        request, __func__);
+  }
+
+ private:
+  RetryPolicyType retry_policy_prototype_;
+  BackoffPolicyType backoff_policy_prototype_;
+  IdempotencyPolicyType idempotency_policy_;
+};
+
+void BM_RetryLoopClonedPolicies(benchmark::State& state) {
+  using ConnectionType = Connection<std::unique_ptr<BenchmarkRetryPolicy const>,
+                                    std::unique_ptr<BackoffPolicy const>,
+                                    std::unique_ptr<IdempotencyPolicy>>;
+  ConnectionType connection(
+      BenchmarkLimitedTimeRetryPolicy(std::chrono::minutes(30)).clone(),
+      ExponentialBackoffPolicy(std::chrono::seconds(1), std::chrono::minutes(5),
+                               kBackoffScaling)
+          .clone(),
+      std::unique_ptr<IdempotencyPolicy>(new DefaultIdempotencyPolicy));
+  int request = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(connection.Method(++request));
+  }
+}
+BENCHMARK(BM_RetryLoopClonedPolicies);
+
+void BM_RetryLoopValuePolicies(benchmark::State& state) {
+  using ConnectionType =
+      Connection<BenchmarkLimitedTimeRetryPolicy, ExponentialBackoffPolicy,
+                 DefaultIdempotencyPolicy>;
+  ConnectionType connection(
+      BenchmarkLimitedTimeRetryPolicy(std::chrono::minutes(30)),
+      ExponentialBackoffPolicy(std::chrono::seconds(1), std::chrono::minutes(5),
+                               kBackoffScaling),
+      DefaultIdempotencyPolicy());
+  int request = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(connection.Method(++request));
+  }
+}
+BENCHMARK(BM_RetryLoopValuePolicies);
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
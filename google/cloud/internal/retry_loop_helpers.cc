@@ -27,6 +27,13 @@ Status RetryLoopError(char const* loop_message, char const* location,
   return Status(last_status.code(), std::move(os).str());
 }
 
+Status RetryLoopCancelled(char const* location, Status const& last_status) {
+  std::ostringstream os;
+  os << "Retry loop cancelled in " << location;
+  if (!last_status.ok()) os << ", last error: " << last_status;
+  return Status(StatusCode::kCancelled, std::move(os).str());
+}
+
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -36,6 +36,9 @@ Status GetResultStatus(StatusOr<T> result) {
 Status RetryLoopError(char const* loop_message, char const* location,
                       Status const& last_status);
 
+/// Generate the error Status for a loop stopped by a `CancellationToken`.
+Status RetryLoopCancelled(char const* location, Status const& last_status);
+
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
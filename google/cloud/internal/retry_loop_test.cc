@@ -13,8 +13,12 @@
 // limitations under the License.
 
 #include "google/cloud/internal/retry_loop.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/capture_instrumentation.h"
 #include <gmock/gmock.h>
+#include <future>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -25,6 +29,7 @@ namespace {
 using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Return;
+using ::testing::StartsWith;
 
 struct TestRetryablePolicy {
   static bool IsPermanentFailure(google::cloud::Status const& s) {
@@ -83,6 +88,23 @@ TEST(RetryLoopTest, ReturnJustStatus) {
   EXPECT_STATUS_OK(actual);
 }
 
+TEST(RetryLoopTest, PoliciesByValue) {
+  int counter = 0;
+  StatusOr<int> actual = RetryLoop(
+      LimitedErrorCountRetryPolicy<TestRetryablePolicy>(2),
+      ExponentialBackoffPolicy(std::chrono::microseconds(1),
+                               std::chrono::microseconds(5), 2.0),
+      Idempotency::kIdempotent,
+      [&counter](grpc::ClientContext&, int) {
+        ++counter;
+        return StatusOr<int>(Status(StatusCode::kUnavailable, "try again"));
+      },
+      42, "error message");
+  EXPECT_EQ(StatusCode::kUnavailable, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("exhausted"));
+  EXPECT_EQ(3, counter);
+}
+
 class MockBackoffPolicy : public BackoffPolicy {
  public:
   MOCK_CONST_METHOD0(clone, std::unique_ptr<BackoffPolicy>());
@@ -159,6 +181,114 @@ TEST(RetryLoopTest, TooManyTransientFailuresIdempotent) {
   EXPECT_THAT(actual.status().message(), HasSubstr("Retry policy exhausted"));
 }
 
+TEST(RetryLoopTest, Instrumentation) {
+  auto capture = std::make_shared<testing_util::CaptureInstrumentation>();
+  SetInstrumentation(capture);
+  int counter = 0;
+  StatusOr<int> actual = RetryLoop(
+      TestRetryPolicy(), TestBackoffPolicy(), Idempotency::kIdempotent,
+      [&counter](grpc::ClientContext&, int request) {
+        if (++counter < 2) {
+          return StatusOr<int>(Status(StatusCode::kUnavailable, "try again"));
+        }
+        return StatusOr<int>(2 * request);
+      },
+      42, "Test");
+  SetInstrumentation(nullptr);
+  EXPECT_STATUS_OK(actual);
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre("start:Test", "end:Test:UNAVAILABLE",
+                          "duration:rpc.retry.backoff", "start:Test",
+                          "end:Test:OK", "value:rpc.retry.attempts=2"));
+}
+
+TEST(RetryLoopTest, RetryBudget) {
+  auto budget = std::make_shared<RetryBudget>(4, 1);
+  BudgetedRetryPolicy<TestRetryablePolicy> policy(
+      LimitedErrorCountRetryPolicy<TestRetryablePolicy>(5), budget);
+  // The budget allows a single retry, even though the wrapped policy allows
+  // five.
+  int counter = 0;
+  StatusOr<int> actual = RetryLoop(
+      policy.clone(), TestBackoffPolicy(), Idempotency::kIdempotent,
+      [&counter](grpc::ClientContext&, int) {
+        ++counter;
+        return StatusOr<int>(Status(StatusCode::kUnavailable, "try again"));
+      },
+      42, "error message");
+  EXPECT_EQ(StatusCode::kUnavailable, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("exhausted"));
+  EXPECT_EQ(2, counter);
+
+  // Successful calls replenish the budget.
+  actual = RetryLoop(
+      policy.clone(), TestBackoffPolicy(), Idempotency::kIdempotent,
+      [](grpc::ClientContext&, int request) { return StatusOr<int>(request); },
+      42, "error message");
+  EXPECT_STATUS_OK(actual);
+  EXPECT_DOUBLE_EQ(3, budget->tokens());
+}
+
+TEST(RetryLoopTest, CancelledBeforeStart) {
+  CancellationToken token;
+  token.Cancel();
+  CancellationScope scope(token);
+  int counter = 0;
+  StatusOr<int> actual = RetryLoop(
+      TestRetryPolicy(), TestBackoffPolicy(), Idempotency::kIdempotent,
+      [&counter](grpc::ClientContext&, int request) {
+        ++counter;
+        return StatusOr<int>(request);
+      },
+      42, "error message");
+  EXPECT_EQ(StatusCode::kCancelled, actual.status().code());
+  EXPECT_EQ(0, counter);
+}
+
+TEST(RetryLoopTest, CancelDuringAttempt) {
+  CancellationToken token;
+  CancellationScope scope(token);
+  int counter = 0;
+  StatusOr<int> actual = RetryLoop(
+      TestRetryPolicy(), TestBackoffPolicy(), Idempotency::kIdempotent,
+      [&](grpc::ClientContext&, int) {
+        ++counter;
+        token.Cancel();
+        return StatusOr<int>(Status(StatusCode::kUnavailable, "try again"));
+      },
+      42, "error message");
+  EXPECT_EQ(StatusCode::kCancelled, actual.status().code());
+  EXPECT_THAT(actual.status().message(),
+              StartsWith("Retry loop cancelled in error message"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("try again"));
+  EXPECT_EQ(1, counter);
+}
+
+TEST(RetryLoopTest, CancelDuringBackoff) {
+  CancellationToken token;
+  CancellationScope scope(token);
+  auto canceller = std::async(std::launch::async, [token]() mutable {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    token.Cancel();
+  });
+  int counter = 0;
+  auto const start = std::chrono::steady_clock::now();
+  StatusOr<int> actual = RetryLoop(
+      TestRetryPolicy(),
+      ExponentialBackoffPolicy(std::chrono::hours(1), std::chrono::hours(1),
+                               2.0),
+      Idempotency::kIdempotent,
+      [&counter](grpc::ClientContext&, int) {
+        ++counter;
+        return StatusOr<int>(Status(StatusCode::kUnavailable, "try again"));
+      },
+      42, "error message");
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::minutes(1));
+  EXPECT_EQ(StatusCode::kCancelled, actual.status().code());
+  EXPECT_EQ(1, counter);
+  canceller.get();
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
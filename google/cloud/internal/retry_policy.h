@@ -65,6 +65,14 @@ class RetryPolicy {
   virtual bool IsExhausted() const = 0;
   virtual bool IsPermanentFailure(Status const&) const = 0;
   //@}
+
+  /**
+   * Called by the retry loop when an attempt succeeds.
+   *
+   * Most policies ignore successes, policies sharing state across calls (such
+   * as a retry budget) use this to replenish that state.
+   */
+  virtual void OnSuccess() {}
 };
 
 /**
@@ -181,6 +189,20 @@ class LimitedTimeRetryPolicy : public TraitBasedRetryPolicy<RetryablePolicy> {
             maximum_duration)),
         deadline_(std::chrono::system_clock::now() + maximum_duration_) {}
 
+  /**
+   * Constructor for a policy whose time budget started at @p start.
+   *
+   * Copies of this policy get a fresh time budget, as with the other
+   * constructors.
+   */
+  template <typename DurationRep, typename DurationPeriod>
+  LimitedTimeRetryPolicy(
+      std::chrono::duration<DurationRep, DurationPeriod> maximum_duration,
+      std::chrono::system_clock::time_point start)
+      : maximum_duration_(std::chrono::duration_cast<std::chrono::milliseconds>(
+            maximum_duration)),
+        deadline_(start + maximum_duration_) {}
+
   LimitedTimeRetryPolicy(LimitedTimeRetryPolicy&& rhs) noexcept
       : LimitedTimeRetryPolicy(rhs.maximum_duration_) {}
   LimitedTimeRetryPolicy(LimitedTimeRetryPolicy const& rhs)
@@ -195,6 +217,9 @@ class LimitedTimeRetryPolicy : public TraitBasedRetryPolicy<RetryablePolicy> {
   }
 
   std::chrono::system_clock::time_point deadline() const { return deadline_; }
+  std::chrono::milliseconds maximum_duration() const {
+    return maximum_duration_;
+  }
 
  protected:
   void OnFailureImpl() override {}
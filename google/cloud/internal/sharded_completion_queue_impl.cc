@@ -0,0 +1,96 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/sharded_completion_queue_impl.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+namespace {
+
+// The shard starting an operation in the current thread, if any.
+struct Starting {
+  ShardedCompletionQueueImpl const* owner;
+  DefaultCompletionQueueImpl* shard;
+};
+
+Starting& StartingShard() {
+  static thread_local Starting starting{nullptr, nullptr};
+  return starting;
+}
+
+}  // namespace
+
+ShardedCompletionQueueImpl::ShardedCompletionQueueImpl(std::size_t shard_count)
+    : shards_(shard_count == 0 ? 1 : shard_count) {
+  std::generate(shards_.begin(), shards_.end(),
+                [] { return std::make_shared<DefaultCompletionQueueImpl>(); });
+}
+
+void ShardedCompletionQueueImpl::Run() {
+  shards_[next_run_.fetch_add(1) % shards_.size()]->Run();
+}
+
+void ShardedCompletionQueueImpl::Shutdown() {
+  for (auto& s : shards_) s->Shutdown();
+}
+
+void ShardedCompletionQueueImpl::CancelAll() {
+  for (auto& s : shards_) s->CancelAll();
+}
+
+future<StatusOr<std::chrono::system_clock::time_point>>
+ShardedCompletionQueueImpl::MakeDeadlineTimer(
+    std::chrono::system_clock::time_point deadline) {
+  return NextShard()->MakeDeadlineTimer(deadline);
+}
+
+future<StatusOr<std::chrono::system_clock::time_point>>
+ShardedCompletionQueueImpl::MakeRelativeTimer(
+    std::chrono::nanoseconds duration) {
+  return NextShard()->MakeRelativeTimer(duration);
+}
+
+void ShardedCompletionQueueImpl::RunAsync(
+    std::unique_ptr<RunAsyncBase> function) {
+  NextShard()->RunAsync(std::move(function));
+}
+
+void ShardedCompletionQueueImpl::StartOperation(
+    std::shared_ptr<AsyncGrpcOperation> op,
+    absl::FunctionRef<void(void*)> start) {
+  auto const& shard = NextShard();
+  // Operations may be started recursively from `start`, restore the previous
+  // value when done.
+  struct Restore {
+    Starting previous;
+    ~Restore() { StartingShard() = previous; }
+  } restore{StartingShard()};
+  StartingShard() = Starting{this, shard.get()};
+  shard->StartOperation(std::move(op), start);
+}
+
+grpc::CompletionQueue& ShardedCompletionQueueImpl::cq() {
+  auto const& starting = StartingShard();
+  if (starting.owner == this) return starting.shard->cq();
+  return NextShard()->cq();
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
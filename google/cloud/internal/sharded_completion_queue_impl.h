@@ -0,0 +1,114 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_SHARDED_COMPLETION_QUEUE_IMPL_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_SHARDED_COMPLETION_QUEUE_IMPL_H
+
+#include "google/cloud/internal/completion_queue_impl.h"
+#include "google/cloud/internal/default_completion_queue_impl.h"
+#include "google/cloud/version.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * A `CompletionQueue` implementation spreading the work across many shards.
+ *
+ * Each shard is a `DefaultCompletionQueueImpl`, with its own
+ * `grpc::CompletionQueue`, its own map of pending operations, and its own
+ * threads. Operations are assigned to the shards round-robin, which reduces
+ * the contention on the locks of each shard when many threads start and
+ * complete operations.
+ *
+ * The threads calling `Run()` are assigned to the shards round-robin too. The
+ * application must call `Run()` from at least `shard_count()` threads, or
+ * some operations may never complete.
+ *
+ * Operations that must share a `grpc::CompletionQueue`, such as all the
+ * operations in a streaming RPC, use `PickShard()` to get one of the shards.
+ */
+class ShardedCompletionQueueImpl : public CompletionQueueImpl {
+ public:
+  explicit ShardedCompletionQueueImpl(std::size_t shard_count);
+  ~ShardedCompletionQueueImpl() override = default;
+
+  /// Run the event loop of one of the shards until Shutdown() is called.
+  void Run() override;
+
+  /// Terminate the event loop in all the shards.
+  void Shutdown() override;
+
+  /// Cancel all existing operations in all the shards.
+  void CancelAll() override;
+
+  /// Create a new timer.
+  future<StatusOr<std::chrono::system_clock::time_point>> MakeDeadlineTimer(
+      std::chrono::system_clock::time_point deadline) override;
+
+  /// Create a new timer.
+  future<StatusOr<std::chrono::system_clock::time_point>> MakeRelativeTimer(
+      std::chrono::nanoseconds duration) override;
+
+  /// Enqueue a new asynchronous function.
+  void RunAsync(std::unique_ptr<RunAsyncBase> function) override;
+
+  /**
+   * Atomically add a new operation to one of the shards and start it.
+   *
+   * Calls to `cq()` from @p start return the `grpc::CompletionQueue` of that
+   * shard.
+   */
+  void StartOperation(std::shared_ptr<AsyncGrpcOperation> op,
+                      absl::FunctionRef<void(void*)> start) override;
+
+  /**
+   * The gRPC completion queue of the shard starting an operation.
+   *
+   * Outside `StartOperation()` this returns the completion queue of an
+   * arbitrary shard, use `PickShard()` to get a consistent completion queue
+   * for a sequence of operations.
+   */
+  grpc::CompletionQueue& cq() override;
+
+  /// Returns one of the shards.
+  std::shared_ptr<CompletionQueueImpl> PickShard() override {
+    return NextShard();
+  }
+
+  std::size_t shard_count() const { return shards_.size(); }
+  std::shared_ptr<DefaultCompletionQueueImpl> shard(std::size_t i) const {
+    return shards_[i];
+  }
+
+ private:
+  std::shared_ptr<DefaultCompletionQueueImpl> const& NextShard() {
+    return shards_[next_shard_.fetch_add(1) % shards_.size()];
+  }
+
+  std::vector<std::shared_ptr<DefaultCompletionQueueImpl>> shards_;
+  std::atomic<std::size_t> next_shard_{0};
+  std::atomic<std::size_t> next_run_{0};
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_SHARDED_COMPLETION_QUEUE_IMPL_H
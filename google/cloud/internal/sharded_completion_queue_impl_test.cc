@@ -0,0 +1,169 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/sharded_completion_queue_impl.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <grpcpp/alarm.h>
+#include <gmock/gmock.h>
+#include <set>
+#include <thread>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using TimerFuture = future<StatusOr<std::chrono::system_clock::time_point>>;
+
+auto constexpr kShards = 4;
+
+class ShardedCompletionQueueTest : public ::testing::Test {
+ protected:
+  ShardedCompletionQueueTest()
+      : impl_(std::make_shared<ShardedCompletionQueueImpl>(kShards)),
+        cq_(impl_) {
+    std::generate_n(std::back_inserter(threads_), kShards, [this] {
+      return std::thread([](CompletionQueue cq) { cq.Run(); }, cq_);
+    });
+  }
+
+  ~ShardedCompletionQueueTest() override {
+    cq_.Shutdown();
+    for (auto& t : threads_) t.join();
+  }
+
+  std::shared_ptr<ShardedCompletionQueueImpl> impl_;
+  CompletionQueue cq_;
+  std::vector<std::thread> threads_;
+};
+
+/// An operation using a gRPC alarm on the completion queue returned by `cq()`.
+class AlarmOperation : public AsyncGrpcOperation {
+ public:
+  void Set(grpc::CompletionQueue* cq, void* tag) {
+    alarm_.Set(cq, std::chrono::system_clock::now(), tag);
+  }
+  future<bool> GetFuture() { return promise_.get_future(); }
+
+  void Cancel() override {}
+
+ private:
+  bool Notify(bool ok) override {
+    promise_.set_value(ok);
+    return true;
+  }
+
+  promise<bool> promise_;
+  grpc::Alarm alarm_;
+};
+
+TEST_F(ShardedCompletionQueueTest, Basic) {
+  EXPECT_EQ(kShards, impl_->shard_count());
+  EXPECT_EQ(1, ShardedCompletionQueueImpl(0).shard_count());
+
+  auto timer = cq_.MakeRelativeTimer(std::chrono::milliseconds(1));
+  EXPECT_STATUS_OK(timer.get());
+
+  promise<void> done;
+  cq_.RunAsync([&done] { done.set_value(); });
+  done.get_future().get();
+}
+
+/// @test Verify that all the shards get threads and operations.
+TEST_F(ShardedCompletionQueueTest, SpreadsWork) {
+  std::vector<TimerFuture> timers;
+  for (int i = 0; i != 10 * kShards; ++i) {
+    timers.push_back(cq_.MakeRelativeTimer(std::chrono::milliseconds(1)));
+  }
+  for (auto& t : timers) EXPECT_STATUS_OK(t.get());
+
+  std::mutex mu;
+  std::set<std::thread::id> ids;
+  std::vector<promise<void>> done(10 * kShards);
+  for (auto& p : done) {
+    cq_.RunAsync([&mu, &ids, &p] {
+      {
+        std::lock_guard<std::mutex> lk(mu);
+        ids.insert(std::this_thread::get_id());
+      }
+      p.set_value();
+    });
+  }
+  for (auto& p : done) p.get_future().get();
+  // Each shard runs the functors in its own thread.
+  EXPECT_EQ(kShards, ids.size());
+
+  for (std::size_t i = 0; i != impl_->shard_count(); ++i) {
+    EXPECT_LE(1, impl_->shard(i)->thread_pool_hwm());
+    EXPECT_LE(10, impl_->shard(i)->notify_counter());
+  }
+}
+
+/// @test Verify that `cq()` is consistent with `StartOperation()`.
+TEST_F(ShardedCompletionQueueTest, StartOperationUsesShardCompletionQueue) {
+  std::vector<future<bool>> results;
+  for (int i = 0; i != 10 * kShards; ++i) {
+    auto op = std::make_shared<AlarmOperation>();
+    results.push_back(op->GetFuture());
+    impl_->StartOperation(op, [&](void* tag) { op->Set(&impl_->cq(), tag); });
+  }
+  for (auto& r : results) EXPECT_TRUE(r.get());
+}
+
+/// @test Verify that `PickShard()` returns consistent shards.
+TEST_F(ShardedCompletionQueueTest, PickShard) {
+  std::set<CompletionQueueImpl*> shards;
+  for (int i = 0; i != 2 * kShards; ++i) {
+    auto shard = PickShard(impl_);
+    ASSERT_NE(shard.get(), impl_.get());
+    EXPECT_EQ(nullptr, shard->PickShard());
+    shards.insert(shard.get());
+
+    // Operations started in the shard use its completion queue.
+    auto op = std::make_shared<AlarmOperation>();
+    auto result = op->GetFuture();
+    auto* cq = &shard->cq();
+    shard->StartOperation(op, [&](void* tag) { op->Set(cq, tag); });
+    EXPECT_TRUE(result.get());
+  }
+  EXPECT_EQ(kShards, shards.size());
+}
+
+TEST(ShardedCompletionQueueImpl, ShutdownAndCancel) {
+  auto impl = std::make_shared<ShardedCompletionQueueImpl>(2);
+  CompletionQueue cq(impl);
+  std::vector<std::thread> threads;
+  std::generate_n(std::back_inserter(threads), 2, [&cq] {
+    return std::thread([](CompletionQueue cq) { cq.Run(); }, cq);
+  });
+
+  std::vector<TimerFuture> timers;
+  for (int i = 0; i != 4; ++i) {
+    timers.push_back(cq.MakeRelativeTimer(std::chrono::hours(1)));
+  }
+  cq.Shutdown();
+  cq.CancelAll();
+  for (auto& t : threads) t.join();
+  for (auto& t : timers) {
+    EXPECT_EQ(StatusCode::kCancelled, t.get().status().code());
+  }
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
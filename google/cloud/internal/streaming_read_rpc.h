@@ -18,6 +18,7 @@
 #include "google/cloud/grpc_error_delegate.h"
 #include "google/cloud/status.h"
 #include "google/cloud/version.h"
+#include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/support/sync_stream.h>
@@ -50,6 +51,25 @@ class StreamingReadRpc {
 
   /// Return the next element, or the final RPC status.
   virtual absl::variant<Status, ResponseType> Read() = 0;
+
+  /**
+   * Read the next element into @p response, reusing its memory.
+   *
+   * High-rate streams can call this function with the same @p response on
+   * each iteration, gRPC deserializes into the existing message, and reuses
+   * the storage of its (repeated and string) fields.
+   *
+   * @return `absl::nullopt` if @p response contains a new element, or the final
+   *     RPC status.
+   */
+  virtual absl::optional<Status> ReadInto(ResponseType& response) {
+    auto v = Read();
+    if (auto* r = absl::get_if<ResponseType>(&v)) {
+      response = std::move(*r);
+      return absl::nullopt;
+    }
+    return absl::get<Status>(std::move(v));
+  }
 };
 
 /// Report the errors in a standalone function to minimize includes
@@ -86,6 +106,11 @@ class StreamingReadRpcImpl : public StreamingReadRpc<ResponseType> {
     return Finish();
   }
 
+  absl::optional<Status> ReadInto(ResponseType& response) override {
+    if (stream_->Read(&response)) return absl::nullopt;
+    return Finish();
+  }
+
  private:
   Status Finish() {
     auto status = MakeStatusFromRpcError(stream_->Finish());
@@ -21,6 +21,7 @@
 #include "google/cloud/status.h"
 #include "google/cloud/tracing_options.h"
 #include "google/cloud/version.h"
+#include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/support/sync_stream.h>
@@ -61,6 +62,15 @@ class StreamingReadRpcLogging : public StreamingReadRpc<ResponseType> {
                    << absl::visit(ResultVisitor(tracing_options_), result);
     return result;
   }
+  absl::optional<Status> ReadInto(ResponseType& response) override {
+    auto const prefix = std::string(__func__) + "(" + request_id_ + ")";
+    GCP_LOG(DEBUG) << prefix << "() >> (void)";
+    auto result = reader_->ReadInto(response);
+    GCP_LOG(DEBUG) << prefix << "() >> "
+                   << (result ? ResultVisitor(tracing_options_)(*result)
+                              : ResultVisitor(tracing_options_)(response));
+    return result;
+  }
 
  private:
   class ResultVisitor {
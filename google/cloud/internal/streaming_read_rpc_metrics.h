@@ -0,0 +1,81 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_STREAMING_READ_RPC_METRICS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_STREAMING_READ_RPC_METRICS_H
+
+#include "google/cloud/internal/metrics_wrapper.h"
+#include "google/cloud/internal/streaming_read_rpc.h"
+#include "google/cloud/status.h"
+#include "google/cloud/version.h"
+#include "absl/types/optional.h"
+#include "absl/types/variant.h"
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * Metrics decorator for StreamingReadRpc.
+ *
+ * Counts the messages received, and their size, and reports them with the
+ * final status of the stream.
+ */
+template <typename ResponseType>
+class StreamingReadRpcMetrics : public StreamingReadRpc<ResponseType> {
+ public:
+  StreamingReadRpcMetrics(
+      std::unique_ptr<StreamingReadRpc<ResponseType>> reader, char const* rpc)
+      : reader_(std::move(reader)), recorder_(rpc) {}
+  ~StreamingReadRpcMetrics() override = default;
+
+  void Cancel() override { reader_->Cancel(); }
+
+  absl::variant<Status, ResponseType> Read() override {
+    auto result = reader_->Read();
+    if (!recorder_.enabled()) return result;
+    if (auto const* status = absl::get_if<Status>(&result)) {
+      recorder_.Finish(status->code());
+    } else {
+      recorder_.Received(static_cast<std::int64_t>(
+          absl::get<ResponseType>(result).ByteSizeLong()));
+    }
+    return result;
+  }
+
+  absl::optional<Status> ReadInto(ResponseType& response) override {
+    auto result = reader_->ReadInto(response);
+    if (!recorder_.enabled()) return result;
+    if (result) {
+      recorder_.Finish(result->code());
+    } else {
+      recorder_.Received(static_cast<std::int64_t>(response.ByteSizeLong()));
+    }
+    return result;
+  }
+
+ private:
+  std::unique_ptr<StreamingReadRpc<ResponseType>> reader_;
+  RpcMetricsRecorder recorder_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_STREAMING_READ_RPC_METRICS_H
@@ -0,0 +1,107 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/streaming_read_rpc_metrics.h"
+#include "google/cloud/testing_util/capture_instrumentation.h"
+#include "absl/memory/memory.h"
+#include <google/protobuf/duration.pb.h>
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::CaptureInstrumentation;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+using Response = google::protobuf::Duration;
+
+class MockStreamingReadRpc : public StreamingReadRpc<Response> {
+ public:
+  ~MockStreamingReadRpc() override = default;
+  MOCK_METHOD(void, Cancel, (), (override));
+  MOCK_METHOD((absl::variant<Status, Response>), Read, (), (override));
+};
+
+Response MakeResponse() {
+  Response response;
+  response.set_seconds(42);
+  return response;
+}
+
+TEST(StreamingReadRpcMetricsTest, Read) {
+  auto capture = std::make_shared<CaptureInstrumentation>();
+  SetInstrumentation(capture);
+  auto mock = absl::make_unique<MockStreamingReadRpc>();
+  EXPECT_CALL(*mock, Read)
+      .WillOnce([] { return MakeResponse(); })
+      .WillOnce([] { return MakeResponse(); })
+      .WillOnce([] { return Status(StatusCode::kUnavailable, "try-again"); });
+  StreamingReadRpcMetrics<Response> reader(std::move(mock),
+                                           "test.Service/Stream");
+  EXPECT_TRUE(absl::holds_alternative<Response>(reader.Read()));
+  EXPECT_TRUE(absl::holds_alternative<Response>(reader.Read()));
+  EXPECT_THAT(capture->ClearEvents(), IsEmpty());
+  EXPECT_TRUE(absl::holds_alternative<Status>(reader.Read()));
+  auto const size = std::to_string(2 * MakeResponse().ByteSizeLong());
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre("rpc:test.Service/Stream:UNAVAILABLE:sent=0/0:"
+                          "received=2/" +
+                          size));
+  SetInstrumentation(nullptr);
+}
+
+TEST(StreamingReadRpcMetricsTest, ReadInto) {
+  auto capture = std::make_shared<CaptureInstrumentation>();
+  SetInstrumentation(capture);
+  auto mock = absl::make_unique<MockStreamingReadRpc>();
+  EXPECT_CALL(*mock, Read)
+      .WillOnce([] { return MakeResponse(); })
+      .WillOnce([] { return Status(); });
+  StreamingReadRpcMetrics<Response> reader(std::move(mock),
+                                           "test.Service/Stream");
+  Response response;
+  EXPECT_FALSE(reader.ReadInto(response).has_value());
+  EXPECT_EQ(42, response.seconds());
+  EXPECT_TRUE(reader.ReadInto(response).has_value());
+  auto const size = std::to_string(MakeResponse().ByteSizeLong());
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre("rpc:test.Service/Stream:OK:sent=0/0:received=1/" +
+                          size));
+  SetInstrumentation(nullptr);
+}
+
+TEST(StreamingReadRpcMetricsTest, Abandoned) {
+  auto capture = std::make_shared<CaptureInstrumentation>();
+  SetInstrumentation(capture);
+  auto mock = absl::make_unique<MockStreamingReadRpc>();
+  EXPECT_CALL(*mock, Cancel).Times(1);
+  {
+    StreamingReadRpcMetrics<Response> reader(std::move(mock),
+                                             "test.Service/Stream");
+    reader.Cancel();
+  }
+  EXPECT_THAT(capture->ClearEvents(),
+              ElementsAre("rpc:test.Service/Stream:CANCELLED"));
+  SetInstrumentation(nullptr);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -83,6 +83,32 @@ TEST(StreamingReadRpcImpl, SuccessfulStream) {
   EXPECT_THAT(values, ElementsAre("value-0", "value-1", "value-2"));
 }
 
+TEST(StreamingReadRpcImpl, ReadIntoReusesResponse) {
+  auto mock = absl::make_unique<MockReader>();
+  std::vector<FakeResponse*> targets;
+  auto read = [&targets](FakeResponse* r) {
+    targets.push_back(r);
+    r->value = "value-" + std::to_string(targets.size() - 1);
+    return true;
+  };
+  EXPECT_CALL(*mock, Read)
+      .WillOnce(read)
+      .WillOnce(read)
+      .WillOnce(Return(false));
+  EXPECT_CALL(*mock, Finish).WillOnce(Return(grpc::Status::OK));
+
+  StreamingReadRpcImpl<FakeResponse> impl(
+      absl::make_unique<grpc::ClientContext>(), std::move(mock));
+  FakeResponse response;
+  std::vector<std::string> values;
+  absl::optional<Status> status;
+  while (!(status = impl.ReadInto(response))) values.push_back(response.value);
+  EXPECT_THAT(*status, StatusIs(StatusCode::kOk));
+  EXPECT_THAT(values, ElementsAre("value-0", "value-1"));
+  // gRPC deserializes each message into the caller's object.
+  EXPECT_THAT(targets, ElementsAre(&response, &response));
+}
+
 TEST(StreamingReadRpcImpl, EmptyStream) {
   auto mock = absl::make_unique<MockReader>();
   EXPECT_CALL(*mock, Read).WillOnce(Return(false));
@@ -0,0 +1,130 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/thread_affinity.h"
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif  // __linux__
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+Status SetCurrentThreadAffinity(CpuSet const& cpus) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return Status(StatusCode::kInvalidArgument,
+                    "invalid CPU index " + std::to_string(cpu));
+    }
+    CPU_SET(cpu, &set);
+  }
+  auto const r = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (r != 0) {
+    return Status(StatusCode::kInvalidArgument,
+                  "pthread_setaffinity_np() failed with error " +
+                      std::to_string(r));
+  }
+  return Status{};
+#else
+  (void)cpus;
+  return Status(StatusCode::kUnimplemented,
+                "thread affinity is not supported on this platform");
+#endif  // __linux__
+}
+
+void SetCurrentThreadName(std::string const& name) {
+#ifdef __linux__
+  // Linux limits thread names to 16 bytes, including the trailing NUL.
+  auto const truncated = name.substr(0, 15);
+  (void)pthread_setname_np(pthread_self(), truncated.c_str());
+#else
+  (void)name;
+#endif  // __linux__
+}
+
+int CurrentCpu() {
+#ifdef __linux__
+  return sched_getcpu();
+#else
+  return -1;
+#endif  // __linux__
+}
+
+StatusOr<CpuSet> ParseCpuList(std::string const& list) {
+  auto invalid = [&list] {
+    return Status(StatusCode::kInvalidArgument,
+                  "invalid CPU list <" + list + ">");
+  };
+  // Parse a non-negative number starting at `*pos`, advancing `*pos`.
+  auto parse_number = [&list](std::size_t* pos, int* value) {
+    auto is_digit = [&list](std::size_t i) {
+      return i != list.size() &&
+             std::isdigit(static_cast<unsigned char>(list[i])) != 0;
+    };
+    auto const start = *pos;
+    for (*value = 0; is_digit(*pos); ++*pos) {
+      *value = *value * 10 + (list[*pos] - '0');
+    }
+    return *pos != start;
+  };
+  CpuSet cpus;
+  auto const end = list.find_last_not_of('\n') + 1;
+  std::size_t pos = 0;
+  while (pos < end) {
+    int lo;
+    if (!parse_number(&pos, &lo)) return invalid();
+    int hi = lo;
+    if (pos != end && list[pos] == '-') {
+      ++pos;
+      if (!parse_number(&pos, &hi) || hi < lo) return invalid();
+    }
+    for (int cpu = lo; cpu <= hi; ++cpu) cpus.push_back(cpu);
+    if (pos == end) break;
+    if (list[pos] != ',' || ++pos == end) return invalid();
+  }
+  return cpus;
+}
+
+std::vector<CpuSet> NumaNodeCpuSets() {
+  std::vector<CpuSet> nodes;
+#ifdef __linux__
+  // Nodes are numbered consecutively, stop at the first missing node.
+  for (int node = 0;; ++node) {
+    std::ifstream is("/sys/devices/system/node/node" + std::to_string(node) +
+                     "/cpulist");
+    if (!is.is_open()) break;
+    std::ostringstream contents;
+    contents << is.rdbuf();
+    auto cpus = ParseCpuList(contents.str());
+    if (!cpus) return {};
+    // Memory-only nodes have no CPUs.
+    if (cpus->empty()) continue;
+    nodes.push_back(*std::move(cpus));
+  }
+#endif  // __linux__
+  return nodes;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
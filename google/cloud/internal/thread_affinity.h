@@ -0,0 +1,66 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_THREAD_AFFINITY_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_THREAD_AFFINITY_H
+
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include "google/cloud/version.h"
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/// A set of CPUs, identified by their operating system index.
+using CpuSet = std::vector<int>;
+
+/**
+ * Restrict the current thread to run on @p cpus.
+ *
+ * Returns `kUnimplemented` on platforms without support for thread affinity.
+ */
+Status SetCurrentThreadAffinity(CpuSet const& cpus);
+
+/**
+ * Name the current thread, as shown by debuggers and profilers.
+ *
+ * The name may be truncated, Linux only supports 15 characters. This is a
+ * no-op on platforms without support for thread names.
+ */
+void SetCurrentThreadName(std::string const& name);
+
+/// Returns the CPU running the current thread, or -1 if it is unknown.
+int CurrentCpu();
+
+/// Parse a Linux CPU list, e.g. `0-3,8,10-11`.
+StatusOr<CpuSet> ParseCpuList(std::string const& list);
+
+/**
+ * Returns the CPUs in each NUMA node of the host.
+ *
+ * Returns an empty vector if the NUMA topology is unknown, e.g. on platforms
+ * other than Linux.
+ */
+std::vector<CpuSet> NumaNodeCpuSets();
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_THREAD_AFFINITY_H
@@ -0,0 +1,83 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/thread_affinity.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Not;
+
+TEST(ThreadAffinityTest, ParseCpuList) {
+  auto actual = ParseCpuList("0-3,8,10-11\n");
+  ASSERT_STATUS_OK(actual);
+  EXPECT_THAT(*actual, ElementsAre(0, 1, 2, 3, 8, 10, 11));
+
+  actual = ParseCpuList("\n");
+  ASSERT_STATUS_OK(actual);
+  EXPECT_THAT(*actual, IsEmpty());
+
+  for (auto const* invalid : {"a", "1-", "3-1", "1-2-3", "-1", "1,,2"}) {
+    EXPECT_EQ(StatusCode::kInvalidArgument,
+              ParseCpuList(invalid).status().code())
+        << "input=" << invalid;
+  }
+}
+
+TEST(ThreadAffinityTest, NumaNodeCpuSets) {
+  // The topology depends on the host, verify it is at least consistent.
+  auto const nodes = NumaNodeCpuSets();
+  for (auto const& cpus : nodes) EXPECT_THAT(cpus, Not(IsEmpty()));
+}
+
+TEST(ThreadAffinityTest, SetCurrentThreadAffinity) {
+  std::thread t([] {
+    auto const cpu = CurrentCpu();
+    auto status = SetCurrentThreadAffinity({cpu < 0 ? 0 : cpu});
+#ifdef __linux__
+    ASSERT_STATUS_OK(status);
+    EXPECT_EQ(cpu, CurrentCpu());
+#else
+    EXPECT_EQ(StatusCode::kUnimplemented, status.code());
+#endif  // __linux__
+    status = SetCurrentThreadAffinity({-1});
+#ifdef __linux__
+    EXPECT_EQ(StatusCode::kInvalidArgument, status.code());
+#endif  // __linux__
+  });
+  t.join();
+}
+
+TEST(ThreadAffinityTest, SetCurrentThreadName) {
+  std::thread t([] {
+    // Just verify this does not crash with long names.
+    SetCurrentThreadName("a-rather-long-thread-name");
+    SetCurrentThreadName("short");
+  });
+  t.join();
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,283 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_TIMER_WHEEL_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_TIMER_WHEEL_H
+
+#include "google/cloud/version.h"
+#include "absl/types/optional.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * A hierarchical timer wheel.
+ *
+ * Holds a large number of timers, with O(1) insertion and cancellation, and
+ * tells the caller when it needs to be advanced next. The caller is expected
+ * to drive the wheel with a single underlying timer (e.g. a `grpc::Alarm`)
+ * set to `NextExpiration()`.
+ *
+ * Time is divided in ticks of `resolution` length, timers expiring in the
+ * same tick are coalesced, and expire together. Timers never expire early,
+ * but may expire up to one tick late.
+ *
+ * The wheel has `kLevels` levels of `kSlots` slots each. A slot in level `l`
+ * covers `kSlots^l` ticks. Timers are stored in the lowest level whose range
+ * includes both the current tick and the expiration tick, and move to lower
+ * levels ("cascade") as the current tick approaches their expiration. Timers
+ * beyond the range of the top level wait in an overflow list.
+ *
+ * This class is not thread-safe, callers must provide their own locking.
+ *
+ * @tparam T the type of the value associated with each timer, it must be
+ *     MoveConstructible.
+ */
+template <typename T>
+class TimerWheel {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  static int constexpr kSlotBits = 6;
+  static std::size_t constexpr kSlots = std::size_t{1} << kSlotBits;
+  static int constexpr kLevels = 4;
+
+  TimerWheel(Clock::time_point origin, Clock::duration resolution)
+      : origin_(origin), resolution_(resolution) {}
+
+  std::size_t size() const { return index_.size(); }
+  bool empty() const { return index_.empty(); }
+
+  /// Returns true if a timer for @p deadline would expire in the current tick.
+  bool IsDue(Clock::time_point deadline) const {
+    return CeilTick(deadline) <= now_;
+  }
+
+  /**
+   * Add a timer.
+   *
+   * @param id a unique identifier, used to cancel the timer.
+   * @param deadline the expiration time, timers that are already due expire
+   *     on the next call to `Advance()`.
+   * @param value the value returned by `Advance()` or `Cancel()`.
+   */
+  void Add(std::uint64_t id, Clock::time_point deadline, T value) {
+    auto const tick = (std::max)(CeilTick(deadline), now_ + 1);
+    List tmp;
+    tmp.push_back(Entry{id, tick, std::move(value), kLevels, 0});
+    auto it = tmp.begin();
+    Place(tmp, it);
+    index_.emplace(id, it);
+  }
+
+  /// Removes the timer with @p id, and returns its value if it was found.
+  absl::optional<T> Cancel(std::uint64_t id) {
+    auto loc = index_.find(id);
+    if (loc == index_.end()) return {};
+    auto it = loc->second;
+    index_.erase(loc);
+    absl::optional<T> value(std::move(it->value));
+    auto const level = it->level;
+    auto const slot = it->slot;
+    auto& list = ListFor(level, slot);
+    list.erase(it);
+    if (level != kLevels && list.empty()) {
+      occupied_[level] &= ~(std::uint64_t{1} << slot);
+    }
+    return value;
+  }
+
+  /// Removes all the timers and returns their values.
+  std::vector<T> Clear() {
+    std::vector<T> values;
+    values.reserve(index_.size());
+    auto drain = [&values](List& list) {
+      for (auto& e : list) values.push_back(std::move(e.value));
+      list.clear();
+    };
+    for (auto& level : slots_) {
+      for (auto& list : level) drain(list);
+    }
+    drain(overflow_);
+    occupied_.fill(0);
+    index_.clear();
+    return values;
+  }
+
+  /**
+   * Advance the current time to @p now and return the values of any expired
+   * timers.
+   */
+  std::vector<T> Advance(Clock::time_point now) {
+    std::vector<T> expired;
+    auto const target = FloorTick(now);
+    while (now_ < target) {
+      auto const next = NextEventTick();
+      if (next > target) {
+        now_ = target;
+        break;
+      }
+      now_ = next;
+      Cascade(expired);
+    }
+    return expired;
+  }
+
+  /**
+   * Returns the time when `Advance()` should be called next, or an empty
+   * optional if there are no timers.
+   *
+   * This may be earlier than the earliest expiration: timers far in the
+   * future must move to lower levels before they expire.
+   */
+  absl::optional<Clock::time_point> NextExpiration() const {
+    auto const tick = NextEventTick();
+    if (tick == kNever) return {};
+    return origin_ + resolution_ * static_cast<Clock::duration::rep>(tick);
+  }
+
+ private:
+  struct Entry {
+    std::uint64_t id;
+    std::uint64_t tick;
+    T value;
+    int level;  // kLevels for the overflow list
+    std::size_t slot;
+  };
+  using List = std::list<Entry>;
+
+  static std::uint64_t constexpr kNever =
+      (std::numeric_limits<std::uint64_t>::max)();
+
+  static int Shift(int level) { return kSlotBits * level; }
+
+  std::uint64_t FloorTick(Clock::time_point tp) const {
+    if (tp <= origin_) return 0;
+    return static_cast<std::uint64_t>((tp - origin_) / resolution_);
+  }
+
+  std::uint64_t CeilTick(Clock::time_point tp) const {
+    if (tp <= origin_) return 0;
+    auto const d = tp - origin_;
+    auto const tick = static_cast<std::uint64_t>(d / resolution_);
+    return d % resolution_ == Clock::duration::zero() ? tick : tick + 1;
+  }
+
+  List& ListFor(int level, std::size_t slot) {
+    return level == kLevels ? overflow_ : slots_[level][slot];
+  }
+
+  // Move `it` from `from` to the list for its expiration tick, which must be
+  // in the future.
+  void Place(List& from, typename List::iterator it) {
+    auto level = kLevels;
+    std::size_t slot = 0;
+    for (int l = 0; l != kLevels; ++l) {
+      if ((it->tick >> Shift(l + 1)) != (now_ >> Shift(l + 1))) continue;
+      level = l;
+      slot = static_cast<std::size_t>(it->tick >> Shift(l)) & (kSlots - 1);
+      break;
+    }
+    it->level = level;
+    it->slot = slot;
+    auto& to = ListFor(level, slot);
+    to.splice(to.end(), from, it);
+    if (level != kLevels) occupied_[level] |= std::uint64_t{1} << slot;
+  }
+
+  // Expire or move down all the timers in the slots starting at `now_`.
+  void Cascade(std::vector<T>& expired) {
+    auto drain = [&](List& list) {
+      while (!list.empty()) {
+        auto it = list.begin();
+        if (it->tick > now_) {
+          Place(list, it);
+          continue;
+        }
+        index_.erase(it->id);
+        expired.push_back(std::move(it->value));
+        list.erase(it);
+      }
+    };
+    if ((now_ & ((std::uint64_t{1} << Shift(kLevels)) - 1)) == 0) {
+      // Some of these timers may go back to the overflow list.
+      List overflow;
+      overflow.swap(overflow_);
+      drain(overflow);
+    }
+    for (int l = kLevels - 1; l >= 0; --l) {
+      if ((now_ & ((std::uint64_t{1} << Shift(l)) - 1)) != 0) continue;
+      auto const slot =
+          static_cast<std::size_t>(now_ >> Shift(l)) & (kSlots - 1);
+      if ((occupied_[l] & (std::uint64_t{1} << slot)) == 0) continue;
+      drain(slots_[l][slot]);
+      occupied_[l] &= ~(std::uint64_t{1} << slot);
+    }
+  }
+
+  // The first tick after `now_` where some slot needs to be processed.
+  std::uint64_t NextEventTick() const {
+    auto next = kNever;
+    for (int l = 0; l != kLevels; ++l) {
+      auto const current =
+          static_cast<std::size_t>(now_ >> Shift(l)) & (kSlots - 1);
+      if (current == kSlots - 1) continue;
+      auto const mask = occupied_[l] & (~std::uint64_t{0} << (current + 1));
+      if (mask == 0) continue;
+      std::uint64_t slot = current + 1;
+      while ((mask & (std::uint64_t{1} << slot)) == 0) ++slot;
+      auto const base = (now_ >> Shift(l + 1)) << Shift(l + 1);
+      next = (std::min)(next, base + (slot << Shift(l)));
+    }
+    if (!overflow_.empty()) {
+      auto const top = ((now_ >> Shift(kLevels)) + 1) << Shift(kLevels);
+      next = (std::min)(next, top);
+    }
+    return next;
+  }
+
+  Clock::time_point origin_;
+  Clock::duration resolution_;
+  std::uint64_t now_ = 0;
+  std::array<std::array<List, kSlots>, kLevels> slots_;
+  std::array<std::uint64_t, kLevels> occupied_{};
+  List overflow_;
+  std::unordered_map<std::uint64_t, typename List::iterator> index_;
+};
+
+template <typename T>
+int constexpr TimerWheel<T>::kSlotBits;
+template <typename T>
+std::size_t constexpr TimerWheel<T>::kSlots;
+template <typename T>
+int constexpr TimerWheel<T>::kLevels;
+template <typename T>
+std::uint64_t constexpr TimerWheel<T>::kNever;
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_TIMER_WHEEL_H
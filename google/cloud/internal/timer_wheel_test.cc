@@ -0,0 +1,187 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/timer_wheel.h"
+#include "google/cloud/internal/random.h"
+#include <gmock/gmock.h>
+#include <map>
+#include <random>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::std::chrono::hours;
+using ::std::chrono::milliseconds;
+using ::std::chrono::seconds;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using Wheel = TimerWheel<int>;
+using Clock = Wheel::Clock;
+
+auto const kOrigin = Clock::time_point{} + hours(24 * 365 * 50);
+
+TEST(TimerWheelTest, Empty) {
+  Wheel wheel(kOrigin, milliseconds(1));
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.NextExpiration().has_value());
+  EXPECT_THAT(wheel.Advance(kOrigin + hours(1)), IsEmpty());
+}
+
+TEST(TimerWheelTest, IsDue) {
+  Wheel wheel(kOrigin, milliseconds(1));
+  EXPECT_TRUE(wheel.IsDue(kOrigin - seconds(1)));
+  EXPECT_TRUE(wheel.IsDue(kOrigin));
+  EXPECT_FALSE(wheel.IsDue(kOrigin + std::chrono::microseconds(1)));
+  wheel.Advance(kOrigin + milliseconds(5));
+  EXPECT_TRUE(wheel.IsDue(kOrigin + milliseconds(5)));
+  EXPECT_FALSE(wheel.IsDue(kOrigin + milliseconds(6)));
+}
+
+TEST(TimerWheelTest, ExpiresInOrder) {
+  Wheel wheel(kOrigin, milliseconds(1));
+  // Cover all the levels, and the overflow list.
+  std::vector<Clock::duration> const offsets = {
+      milliseconds(1), milliseconds(5),   milliseconds(100), seconds(10),
+      hours(2),        hours(24 * 30)};
+  for (std::size_t i = 0; i != offsets.size(); ++i) {
+    wheel.Add(i, kOrigin + offsets[i], static_cast<int>(i));
+  }
+  EXPECT_EQ(offsets.size(), wheel.size());
+
+  std::vector<int> actual;
+  while (!wheel.empty()) {
+    auto const next = wheel.NextExpiration();
+    ASSERT_TRUE(next.has_value());
+    for (auto i : wheel.Advance(*next)) {
+      auto const deadline = kOrigin + offsets[i];
+      EXPECT_LE(deadline, *next);
+      EXPECT_GT(deadline + milliseconds(1), *next);
+      actual.push_back(i);
+    }
+  }
+  EXPECT_THAT(actual, ElementsAre(0, 1, 2, 3, 4, 5));
+}
+
+TEST(TimerWheelTest, Coalesces) {
+  Wheel wheel(kOrigin, milliseconds(10));
+  wheel.Add(1, kOrigin + milliseconds(11), 1);
+  wheel.Add(2, kOrigin + milliseconds(15), 2);
+  wheel.Add(3, kOrigin + milliseconds(20), 3);
+  wheel.Add(4, kOrigin + milliseconds(21), 4);
+  ASSERT_EQ(kOrigin + milliseconds(20), wheel.NextExpiration().value());
+  EXPECT_THAT(wheel.Advance(kOrigin + milliseconds(20)), ElementsAre(1, 2, 3));
+  ASSERT_EQ(kOrigin + milliseconds(30), wheel.NextExpiration().value());
+  EXPECT_THAT(wheel.Advance(kOrigin + milliseconds(35)), ElementsAre(4));
+}
+
+TEST(TimerWheelTest, Cancel) {
+  Wheel wheel(kOrigin, milliseconds(1));
+  wheel.Add(1, kOrigin + milliseconds(10), 1);
+  wheel.Add(2, kOrigin + hours(1), 2);
+  EXPECT_EQ(2, wheel.Cancel(2).value_or(0));
+  EXPECT_FALSE(wheel.Cancel(2).has_value());
+  EXPECT_EQ(1U, wheel.size());
+  EXPECT_THAT(wheel.Advance(kOrigin + hours(2)), ElementsAre(1));
+  EXPECT_FALSE(wheel.Cancel(1).has_value());
+  EXPECT_FALSE(wheel.NextExpiration().has_value());
+}
+
+TEST(TimerWheelTest, Clear) {
+  Wheel wheel(kOrigin, milliseconds(1));
+  wheel.Add(1, kOrigin + milliseconds(10), 1);
+  wheel.Add(2, kOrigin + hours(1), 2);
+  wheel.Add(3, kOrigin + hours(24 * 365), 3);
+  auto values = wheel.Clear();
+  std::sort(values.begin(), values.end());
+  EXPECT_THAT(values, ElementsAre(1, 2, 3));
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.NextExpiration().has_value());
+}
+
+/// @test Compare against a simple implementation using random timers.
+TEST(TimerWheelTest, Random) {
+  auto constexpr kTimers = 20000;
+  auto const resolution = milliseconds(1);
+  Wheel wheel(kOrigin, resolution);
+  std::multimap<Clock::time_point, int> expected;
+  std::map<int, Clock::time_point> deadlines;
+
+  auto generator = MakeDefaultPRNG();
+  auto now = kOrigin;
+  auto advance = [&](Clock::time_point tp) {
+    now = tp;
+    auto actual = wheel.Advance(now);
+    std::sort(actual.begin(), actual.end());
+    // A timer expires once the current tick starts at or after its deadline.
+    auto const tick_start =
+        kOrigin + resolution * ((now - kOrigin) / resolution);
+    std::vector<int> want;
+    auto end = expected.upper_bound(tick_start);
+    for (auto i = expected.begin(); i != end; ++i) want.push_back(i->second);
+    expected.erase(expected.begin(), end);
+    std::sort(want.begin(), want.end());
+    ASSERT_EQ(want, actual);
+    for (auto i : actual) deadlines.erase(i);
+  };
+
+  std::uniform_int_distribution<int> action(0, 9);
+  std::uniform_int_distribution<std::int64_t> delay_ms(1, 24 * 3600 * 1000);
+  std::uniform_int_distribution<int> delay_scale(0, 3);
+  std::uniform_int_distribution<std::int64_t> step_us(0, 5000000);
+  for (int id = 0; id != kTimers; ++id) {
+    auto const a = action(generator);
+    if (a < 6) {
+      // Spread the delays across many orders of magnitude.
+      auto d = std::chrono::microseconds(delay_ms(generator));
+      for (int s = delay_scale(generator); s != 0; --s) d /= 100;
+      auto const deadline = now + d + std::chrono::microseconds(1);
+      wheel.Add(id, deadline, id);
+      expected.emplace(deadline, id);
+      deadlines.emplace(id, deadline);
+    } else if (a < 7 && !deadlines.empty()) {
+      auto const loc = deadlines.begin();
+      EXPECT_EQ(loc->first, wheel.Cancel(loc->first).value_or(-1));
+      auto range = expected.equal_range(loc->second);
+      for (auto i = range.first; i != range.second; ++i) {
+        if (i->second != loc->first) continue;
+        expected.erase(i);
+        break;
+      }
+      deadlines.erase(loc);
+    } else if (a < 9) {
+      advance(now + std::chrono::microseconds(step_us(generator)));
+    } else {
+      auto const next = wheel.NextExpiration();
+      if (next) advance(*next);
+    }
+    ASSERT_EQ(expected.size(), wheel.size());
+  }
+  // Drain the wheel using `NextExpiration()`.
+  while (!wheel.empty()) {
+    auto const next = wheel.NextExpiration();
+    ASSERT_TRUE(next.has_value());
+    ASSERT_LE(*next, expected.begin()->first + resolution);
+    advance(*next);
+  }
+  EXPECT_TRUE(expected.empty());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,195 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/work_stealing_executor.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+struct WorkStealingExecutor::State {
+  struct Worker {
+    std::mutex mu;
+    std::deque<std::unique_ptr<RunAsyncBase>> queue;  // GUARDED_BY(mu)
+  };
+
+  explicit State(std::size_t n) : workers(n) {}
+
+  std::unique_ptr<RunAsyncBase> Pop(std::size_t index);
+  void WakeOne();
+  void WorkerLoop(std::size_t index);
+
+  std::vector<Worker> workers;
+  std::atomic<std::size_t> next_worker{0};
+  // The number of functors scheduled but not yet started. It is incremented
+  // before the functor is pushed, so it may be briefly ahead of the deques.
+  std::atomic<std::int64_t> pending{0};
+
+  std::mutex mu;
+  std::condition_variable cv;
+  // Modified only with `mu` held, but read without the lock as a fast path.
+  std::atomic<int> sleeping{0};
+  std::atomic<bool> wakeup_pending{false};
+  std::atomic<bool> shutdown{false};
+
+  std::atomic<std::int64_t> notify_counter{0};
+  std::atomic<std::int64_t> steal_counter{0};
+};
+
+namespace {
+// The executor state and worker index for the current thread, if it is a
+// worker thread.
+struct CurrentWorker {
+  void const* state;
+  std::size_t index;
+};
+
+CurrentWorker& current_worker() {
+  static thread_local CurrentWorker worker{nullptr, 0};
+  return worker;
+}
+}  // namespace
+
+std::unique_ptr<RunAsyncBase> WorkStealingExecutor::State::Pop(
+    std::size_t index) {
+  {
+    auto& w = workers[index];
+    std::lock_guard<std::mutex> lk(w.mu);
+    if (!w.queue.empty()) {
+      auto f = std::move(w.queue.front());
+      w.queue.pop_front();
+      --pending;
+      return f;
+    }
+  }
+  auto const n = workers.size();
+  for (std::size_t i = 1; i < n; ++i) {
+    auto& w = workers[(index + i) % n];
+    std::lock_guard<std::mutex> lk(w.mu);
+    if (w.queue.empty()) continue;
+    auto f = std::move(w.queue.back());
+    w.queue.pop_back();
+    --pending;
+    ++steal_counter;
+    return f;
+  }
+  return nullptr;
+}
+
+void WorkStealingExecutor::State::WakeOne() {
+  // Most calls return here: either all the workers are busy, or a wakeup is
+  // already in flight and the woken worker will wake up more if needed.
+  if (sleeping.load() == 0 || wakeup_pending.load()) return;
+  std::lock_guard<std::mutex> lk(mu);
+  // Workers only count themselves as sleeping, with `mu` held, right before
+  // they block on `cv`. Therefore the notification cannot be lost.
+  if (sleeping.load() == 0 || wakeup_pending.load()) return;
+  wakeup_pending = true;
+  ++notify_counter;
+  cv.notify_one();
+}
+
+void WorkStealingExecutor::State::WorkerLoop(std::size_t index) {
+  current_worker() = CurrentWorker{this, index};
+  for (;;) {
+    auto f = Pop(index);
+    if (f) {
+      // Batched wakeups: if there is more work, wake up one more worker, it
+      // will wake up another one when it finds work, and so on.
+      if (pending.load() > 0) WakeOne();
+      f->exec();
+      continue;
+    }
+    std::unique_lock<std::mutex> lk(mu);
+    if (pending.load() == 0 && shutdown.load()) break;
+    ++sleeping;
+    // Count this thread as sleeping before checking for work, the
+    // producers update `pending` before checking `sleeping`.
+    if (pending.load() > 0) {
+      --sleeping;
+      continue;
+    }
+    cv.wait(lk);
+    --sleeping;
+    wakeup_pending = false;
+  }
+  current_worker() = CurrentWorker{nullptr, 0};
+}
+
+WorkStealingExecutor::WorkStealingExecutor(std::size_t thread_count)
+    : state_(std::make_shared<State>(
+          (std::max)(thread_count, std::size_t{1}))) {
+  auto const n = state_->workers.size();
+  threads_.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    // The threads share ownership of the state, they may outlive this object
+    // if it is destroyed from one of the worker threads.
+    threads_.emplace_back(
+        [](std::shared_ptr<State> s, std::size_t index) {
+          s->WorkerLoop(index);
+        },
+        state_, i);
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  Shutdown();
+  for (auto& t : threads_) {
+    // The last reference to the executor may be released by a functor
+    // running in one of the workers. That thread cannot join itself, it exits
+    // on its own once the functor returns.
+    if (t.get_id() == std::this_thread::get_id()) {
+      t.detach();
+    } else {
+      t.join();
+    }
+  }
+}
+
+void WorkStealingExecutor::Schedule(std::unique_ptr<RunAsyncBase> function) {
+  if (state_->shutdown.load()) return;
+  auto const& current = current_worker();
+  auto const index =
+      current.state == state_.get()
+          ? current.index
+          : state_->next_worker.fetch_add(1) % state_->workers.size();
+  ++state_->pending;
+  {
+    auto& w = state_->workers[index];
+    std::lock_guard<std::mutex> lk(w.mu);
+    w.queue.push_back(std::move(function));
+  }
+  state_->WakeOne();
+}
+
+void WorkStealingExecutor::Shutdown() {
+  std::lock_guard<std::mutex> lk(state_->mu);
+  state_->shutdown = true;
+  state_->cv.notify_all();
+}
+
+std::int64_t WorkStealingExecutor::notify_counter() const {
+  return state_->notify_counter.load();
+}
+
+std::int64_t WorkStealingExecutor::steal_counter() const {
+  return state_->steal_counter.load();
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
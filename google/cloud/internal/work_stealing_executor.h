@@ -0,0 +1,95 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_WORK_STEALING_EXECUTOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_WORK_STEALING_EXECUTOR_H
+
+#include "google/cloud/internal/completion_queue_impl.h"
+#include "google/cloud/version.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+
+/**
+ * A thread pool to run `CompletionQueue::RunAsync()` functors.
+ *
+ * By default `CompletionQueue::RunAsync()` schedules each functor through the
+ * gRPC completion queue, using an alarm to wake up one of the threads blocked
+ * in `grpc::CompletionQueue::AsyncNext()`. That is a lot of overhead for
+ * functors that do not perform any I/O. This class runs such functors in its
+ * own pool of threads, leaving the gRPC completion queue for RPC and timer
+ * completions.
+ *
+ * Each worker thread owns a deque of pending functors:
+ * - Functors scheduled from a worker thread go to that thread's own deque,
+ *   which tends to keep their data hot in the caches.
+ * - Functors scheduled from any other thread are distributed round-robin
+ *   across the workers.
+ * - The owner runs its functors in FIFO order, so a functor that keeps
+ *   rescheduling itself cannot starve the others.
+ * - Idle workers steal from the back of other workers' deques before going
+ *   to sleep, away from the end used by the owner.
+ *
+ * Wakeups are batched: a producer only signals the condition variable if
+ * there are sleeping workers and no other wakeup is in flight. The woken
+ * worker wakes up another sleeper if it finds more work than it can handle,
+ * so a burst of `Schedule()` calls costs a single notification.
+ *
+ * Functors scheduled after `Shutdown()` are discarded, functors scheduled
+ * before `Shutdown()` are run before the workers exit.
+ */
+class WorkStealingExecutor {
+ public:
+  /// Create an executor with @p thread_count workers, at least 1.
+  explicit WorkStealingExecutor(std::size_t thread_count);
+  ~WorkStealingExecutor();
+
+  WorkStealingExecutor(WorkStealingExecutor const&) = delete;
+  WorkStealingExecutor& operator=(WorkStealingExecutor const&) = delete;
+
+  /// Schedule @p function to run in one of the worker threads.
+  void Schedule(std::unique_ptr<RunAsyncBase> function);
+
+  /// Stop accepting new work, the workers exit once their deques are empty.
+  void Shutdown();
+
+  std::size_t thread_count() const { return threads_.size(); }
+
+  /// Some counters for testing and debugging.
+  std::int64_t notify_counter() const;
+  std::int64_t steal_counter() const;
+
+ private:
+  struct State;
+
+  std::shared_ptr<State> state_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_WORK_STEALING_EXECUTOR_H
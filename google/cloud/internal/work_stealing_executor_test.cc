@@ -0,0 +1,157 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/work_stealing_executor.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <functional>
+#include <future>
+#include <set>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+using ::testing::Contains;
+using ::testing::Not;
+
+class Task : public RunAsyncBase {
+ public:
+  explicit Task(std::function<void()> f) : f_(std::move(f)) {}
+  void exec() override { f_(); }
+
+ private:
+  std::function<void()> f_;
+};
+
+std::unique_ptr<RunAsyncBase> MakeTask(std::function<void()> f) {
+  return absl::make_unique<Task>(std::move(f));
+}
+
+/// A simple countdown latch for the tests.
+class Latch {
+ public:
+  explicit Latch(int count) : count_(count) {}
+
+  void CountDown() {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (--count_ == 0) cv_.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [this] { return count_ <= 0; });
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  int count_;
+};
+
+TEST(WorkStealingExecutorTest, RunsAllFunctions) {
+  auto constexpr kTasks = 1000;
+  WorkStealingExecutor executor(4);
+  EXPECT_EQ(4U, executor.thread_count());
+
+  std::mutex mu;
+  std::set<std::thread::id> ids;
+  Latch done(kTasks);
+  for (int i = 0; i != kTasks; ++i) {
+    executor.Schedule(MakeTask([&] {
+      {
+        std::lock_guard<std::mutex> lk(mu);
+        ids.insert(std::this_thread::get_id());
+      }
+      done.CountDown();
+    }));
+  }
+  done.Wait();
+  EXPECT_THAT(ids, Not(Contains(std::this_thread::get_id())));
+}
+
+TEST(WorkStealingExecutorTest, AtLeastOneThread) {
+  WorkStealingExecutor executor(0);
+  EXPECT_EQ(1U, executor.thread_count());
+  std::promise<void> done;
+  executor.Schedule(MakeTask([&done] { done.set_value(); }));
+  done.get_future().get();
+}
+
+/// @test Verify functions scheduled from a worker thread run, and that idle
+/// workers steal them if the owner is busy.
+TEST(WorkStealingExecutorTest, StealsWork) {
+  auto constexpr kTasks = 100;
+  WorkStealingExecutor executor(4);
+
+  Latch done(kTasks);
+  std::promise<void> parent_done;
+  executor.Schedule(MakeTask([&] {
+    // These tasks go to this worker's deque, this worker is blocked until
+    // they complete, so other workers must steal them.
+    for (int i = 0; i != kTasks; ++i) {
+      executor.Schedule(MakeTask([&done] { done.CountDown(); }));
+    }
+    done.Wait();
+    parent_done.set_value();
+  }));
+  parent_done.get_future().get();
+  EXPECT_LE(kTasks, executor.steal_counter());
+}
+
+/// @test Verify a burst of functions does not require a notification each.
+TEST(WorkStealingExecutorTest, BatchesWakeups) {
+  auto constexpr kTasks = 1000;
+  WorkStealingExecutor executor(4);
+
+  Latch done(kTasks);
+  for (int i = 0; i != kTasks; ++i) {
+    executor.Schedule(MakeTask([&done] { done.CountDown(); }));
+  }
+  done.Wait();
+  EXPECT_LT(executor.notify_counter(), kTasks);
+}
+
+TEST(WorkStealingExecutorTest, NoWorkAfterShutdown) {
+  WorkStealingExecutor executor(2);
+  std::promise<void> a;
+  executor.Schedule(MakeTask([&a] { a.set_value(); }));
+  a.get_future().get();
+
+  executor.Shutdown();
+  bool called = false;
+  executor.Schedule(MakeTask([&called] { called = true; }));
+  EXPECT_FALSE(called);
+}
+
+/// @test Verify the executor can be destroyed by one of its own functions.
+TEST(WorkStealingExecutorTest, DestroyFromWorker) {
+  auto executor = std::make_shared<WorkStealingExecutor>(2);
+  std::promise<void> done;
+  auto* e = executor.get();
+  e->Schedule(MakeTask([&done, executor]() mutable {
+    executor.reset();
+    done.set_value();
+  }));
+  executor.reset();
+  done.get_future().get();
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -71,7 +71,8 @@ std::ostream& operator<<(std::ostream& os, LogRecord const& rhs) {
 
 LogSink::LogSink()
     : empty_(true),
-      minimum_severity_(static_cast<int>(Severity::GCP_LS_LOWEST_ENABLED)) {}
+      minimum_severity_(static_cast<int>(Severity::GCP_LS_LOWEST_ENABLED)),
+      backends_(std::make_shared<BackendMap const>()) {}
 
 LogSink& LogSink::Instance() {
   static auto* const kInstance = [] {
@@ -98,24 +99,22 @@ void LogSink::RemoveBackend(long id) {
 
 void LogSink::ClearBackends() {
   std::unique_lock<std::mutex> lk(mu_);
-  backends_.clear();
+  std::atomic_store(&backends_, std::make_shared<BackendMap const>());
   clog_backend_id_ = 0;
-  empty_.store(backends_.empty());
+  empty_.store(true);
 }
 
 std::size_t LogSink::BackendCount() const {
-  std::unique_lock<std::mutex> lk(mu_);
-  return backends_.size();
+  return std::atomic_load(&backends_)->size();
 }
 
 void LogSink::Log(LogRecord log_record) {
-  // Make a copy of the backends because calling user-defined functions while
-  // holding a lock is a bad idea: the application may change the backends while
-  // we are holding this lock, and soon deadlock occurs.
-  auto copy = [this]() {
-    std::unique_lock<std::mutex> lk(mu_);
-    return backends_;
-  }();
+  // Take a snapshot of the backends because calling user-defined functions
+  // while holding a lock is a bad idea: the application may change the backends
+  // while we are holding this lock, and soon deadlock occurs. The snapshot is
+  // immutable, so an atomic load of the pointer is enough, without `mu_`.
+  auto snapshot = std::atomic_load(&backends_);
+  auto const& copy = *snapshot;
   if (copy.empty()) {
     return;
   }
@@ -171,19 +170,25 @@ void LogSink::DisableStdClogImpl() {
 // NOLINTNEXTLINE(google-runtime-int)
 long LogSink::AddBackendImpl(std::shared_ptr<LogBackend> backend) {
   auto const id = ++next_id_;
-  backends_.emplace(id, std::move(backend));
-  empty_.store(backends_.empty());
+  auto backends = std::make_shared<BackendMap>(*backends_);
+  backends->emplace(id, std::move(backend));
+  std::atomic_store(&backends_,
+                    std::shared_ptr<BackendMap const>(std::move(backends)));
+  empty_.store(false);
   return id;
 }
 
 // NOLINTNEXTLINE(google-runtime-int)
 void LogSink::RemoveBackendImpl(long id) {
-  auto it = backends_.find(id);
-  if (backends_.end() == it) {
+  if (backends_->count(id) == 0) {
     return;
   }
-  backends_.erase(it);
-  empty_.store(backends_.empty());
+  auto backends = std::make_shared<BackendMap>(*backends_);
+  backends->erase(id);
+  auto const empty = backends->empty();
+  std::atomic_store(&backends_,
+                    std::shared_ptr<BackendMap const>(std::move(backends)));
+  empty_.store(empty);
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_NS
@@ -331,7 +331,11 @@ class LogSink {
   long next_id_ = 0;          // NOLINT(google-runtime-int)
   long clog_backend_id_ = 0;  // NOLINT(google-runtime-int)
   // NOLINTNEXTLINE(google-runtime-int)
-  std::map<long, std::shared_ptr<LogBackend>> backends_;
+  using BackendMap = std::map<long, std::shared_ptr<LogBackend>>;
+  // Replaced, never modified, when the backends change. Writers hold `mu_`
+  // and use `std::atomic_store()`, `Log()` only needs a `std::atomic_load()`
+  // of this pointer to get a stable snapshot.
+  std::shared_ptr<BackendMap const> backends_;
 };
 
 /**
@@ -410,8 +414,8 @@ class Logger {
 template <>
 class Logger<false> {
  public:
-  Logger<false>() = default;
-  Logger<false>(Severity, char const*, char const*, int, LogSink&) {}
+  Logger() = default;
+  Logger(Severity, char const*, char const*, int, LogSink&) {}
 
   //@{
   /**
@@ -0,0 +1,186 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/logging/batching_log_writer.h"
+#include "google/cloud/instrumentation.h"
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace logging {
+// A helper callable to handle a response, it is a bit large for a lambda, and
+// we need move-capture anyways.
+struct BatchingLogWriter::OnBatchResponse {
+  std::vector<promise<Status>> waiters;
+  std::size_t bytes;
+  std::weak_ptr<BatchingLogWriter> weak;
+
+  void operator()(
+      future<StatusOr<google::logging::v2::WriteLogEntriesResponse>> f) {
+    auto const status = f.get().status();
+    // Release the capacity first, so the next batches are sent while we
+    // satisfy the futures for this batch.
+    if (auto self = weak.lock()) self->OnBatchDone(waiters.size(), bytes);
+    for (auto& w : waiters) w.set_value(status);
+  }
+};
+
+BatchingLogWriter::~BatchingLogWriter() {
+  // Timers and pending responses only hold weak pointers, nothing else can
+  // use this object, we do not need the lock. Any batches waiting for a
+  // concurrency slot are sent too, the destructor cannot wait for them.
+  MakeBatch();
+  for (auto& batch : ready_) Send(std::move(batch), {});
+}
+
+future<Status> BatchingLogWriter::Write(google::logging::v2::LogEntry entry) {
+  auto const bytes = entry.ByteSizeLong();
+  std::unique_lock<std::mutex> lk(mu_);
+  while (!HasRoom(bytes)) {
+    if (options_.full_writer_rejects()) {
+      return make_ready_future(Status(StatusCode::kResourceExhausted,
+                                      "too many pending log entries"));
+    }
+    // Send the current batch, otherwise the writer may stay full until the
+    // hold time expires.
+    if (!waiters_.empty()) {
+      MakeBatch();
+      SendReady(std::move(lk));
+      lk = std::unique_lock<std::mutex>(mu_);
+      continue;
+    }
+    cv_.wait(lk);
+  }
+
+  // If the entry does not fit in the current batch, start a new one. An empty
+  // batch always accepts the entry, even if it is oversized.
+  if (!waiters_.empty() &&
+      (waiters_.size() >= options_.maximum_batch_entries() ||
+       current_bytes_ + bytes > options_.maximum_batch_bytes())) {
+    MakeBatch();
+  }
+
+  waiters_.emplace_back();
+  auto f = waiters_.back().get_future();
+
+  // Use RAII to preserve the strong exception guarantee.
+  struct UndoPush {
+    std::vector<promise<Status>>* waiters;
+
+    ~UndoPush() {
+      if (waiters != nullptr) waiters->pop_back();
+    }
+    void release() { waiters = nullptr; }
+  } undo{&waiters_};
+
+  *entries_.Add() = std::move(entry);
+  undo.release();  // no throws after this point, we can rest easy
+  current_bytes_ += bytes;
+  ++pending_entries_;
+  pending_bytes_ += bytes;
+
+  auto const start_timer = waiters_.size() == 1;
+  if (start_timer) {
+    batch_expiration_ =
+        std::chrono::system_clock::now() + options_.maximum_hold_time();
+  }
+  auto const expiration = batch_expiration_;
+  if (waiters_.size() >= options_.maximum_batch_entries() ||
+      current_bytes_ >= options_.maximum_batch_bytes()) {
+    MakeBatch();
+  }
+  SendReady(std::move(lk));
+  if (!start_timer) return f;
+
+  // We need a weak_ptr<> because the timer may outlive this object.
+  // Unfortunately some older compiler/libraries lack `weak_from_this()`.
+  auto weak = std::weak_ptr<BatchingLogWriter>(shared_from_this());
+  cq_.MakeDeadlineTimer(expiration)
+      .then([weak](future<StatusOr<std::chrono::system_clock::time_point>>) {
+        if (auto self = weak.lock()) self->OnTimer();
+      });
+  return f;
+}
+
+void BatchingLogWriter::Flush() {
+  std::unique_lock<std::mutex> lk(mu_);
+  MakeBatch();
+  SendReady(std::move(lk));
+}
+
+void BatchingLogWriter::OnTimer() {
+  std::unique_lock<std::mutex> lk(mu_);
+  // We may get many "old" timers for batches that have already flushed due to
+  // size. Trying to cancel these timers is a bit hopeless, they might trigger
+  // even if we attempt to cancel them. This test is more robust.
+  if (std::chrono::system_clock::now() < batch_expiration_) return;
+  MakeBatch();
+  SendReady(std::move(lk));
+}
+
+void BatchingLogWriter::OnBatchDone(std::size_t entries, std::size_t bytes) {
+  std::unique_lock<std::mutex> lk(mu_);
+  --running_batches_;
+  pending_entries_ -= entries;
+  pending_bytes_ -= bytes;
+  cv_.notify_all();
+  SendReady(std::move(lk));
+}
+
+bool BatchingLogWriter::HasRoom(std::size_t bytes) const {
+  // Always accept an entry when nothing is pending, otherwise an oversized
+  // entry would block forever.
+  if (pending_entries_ == 0) return true;
+  return pending_entries_ < options_.maximum_pending_entries() &&
+         pending_bytes_ + bytes <= options_.maximum_pending_bytes();
+}
+
+void BatchingLogWriter::MakeBatch() {
+  if (waiters_.empty()) return;
+  Batch batch;
+  batch.entries.Swap(&entries_);
+  batch.waiters.swap(waiters_);
+  batch.bytes = current_bytes_;
+  current_bytes_ = 0;
+  ready_.push_back(std::move(batch));
+}
+
+void BatchingLogWriter::SendReady(std::unique_lock<std::mutex> lk) {
+  std::vector<Batch> batches;
+  while (!ready_.empty() &&
+         running_batches_ < options_.maximum_concurrent_batches()) {
+    ++running_batches_;
+    batches.push_back(std::move(ready_.front()));
+    ready_.pop_front();
+  }
+  lk.unlock();
+  if (batches.empty()) return;
+  auto weak = std::weak_ptr<BatchingLogWriter>(shared_from_this());
+  for (auto& b : batches) Send(std::move(b), weak);
+}
+
+void BatchingLogWriter::Send(Batch batch,
+                             std::weak_ptr<BatchingLogWriter> weak) {
+  auto request = prototype_;
+  request.mutable_entries()->Swap(&batch.entries);
+  google::cloud::internal::RecordValue("logging.writer.batch_size",
+                                       request.entries_size());
+  connection_->AsyncWriteLogEntries(request).then(
+      OnBatchResponse{std::move(batch.waiters), batch.bytes, std::move(weak)});
+}
+
+}  // namespace logging
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
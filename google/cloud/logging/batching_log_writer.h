@@ -0,0 +1,152 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_BATCHING_LOG_WRITER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_BATCHING_LOG_WRITER_H
+
+#include "google/cloud/logging/batching_log_writer_options.h"
+#include "google/cloud/logging/logging_service_v2_connection.gcpcxx.pb.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include "google/cloud/version.h"
+#include <google/logging/v2/logging.pb.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace logging {
+
+/**
+ * Batches log entries into `WriteLogEntries()` RPCs.
+ *
+ * `LoggingServiceV2Connection::WriteLogEntries()` sends one RPC per call. An
+ * application shipping many log entries per second would need as many RPCs.
+ * This class accumulates the entries in batches, bounded by the number of
+ * entries, their size, and how long the first entry in the batch has waited,
+ * see `BatchingLogWriterOptions` for details. Several batches may be in flight
+ * at the same time, and the total number (and size) of the entries waiting for
+ * a response is bounded too.
+ *
+ * All the entries in a batch share the fields in the @p prototype request,
+ * such as `log_name`, `resource`, and `labels`. Each call to `Write()` returns
+ * a future satisfied when the batch containing the entry completes, including
+ * any retries performed by the connection.
+ *
+ * @par Example
+ * @code
+ * namespace logging = ::google::cloud::logging;
+ * google::cloud::CompletionQueue cq;
+ * std::thread t([&cq] { cq.Run(); });
+ * google::logging::v2::WriteLogEntriesRequest prototype;
+ * prototype.set_log_name("projects/my-project/logs/my-log");
+ * prototype.mutable_resource()->set_type("global");
+ * auto writer = logging::BatchingLogWriter::Create(
+ *     logging::MakeLoggingServiceV2Connection(), cq, std::move(prototype));
+ * google::logging::v2::LogEntry entry;
+ * entry.set_text_payload("Hello World");
+ * writer->Write(std::move(entry));
+ * @endcode
+ *
+ * @note The completion queue @p cq runs the timers that flush partial batches,
+ *     and the asynchronous RPCs if the connection uses it. The application
+ *     must keep it running while the writer is in use.
+ */
+class BatchingLogWriter
+    : public std::enable_shared_from_this<BatchingLogWriter> {
+ public:
+  static std::shared_ptr<BatchingLogWriter> Create(
+      std::shared_ptr<LoggingServiceV2Connection> connection,
+      google::cloud::CompletionQueue cq,
+      google::logging::v2::WriteLogEntriesRequest prototype,
+      BatchingLogWriterOptions options = {}) {
+    return std::shared_ptr<BatchingLogWriter>(
+        new BatchingLogWriter(std::move(connection), std::move(cq),
+                              std::move(prototype), std::move(options)));
+  }
+
+  /// Sends any pending entries, without waiting for the results.
+  ~BatchingLogWriter();
+
+  /**
+   * Adds @p entry to the current batch.
+   *
+   * If the writer is full, that is, the pending entries exceed the limits in
+   * `BatchingLogWriterOptions`, this function blocks until some batches
+   * complete, or returns a `StatusCode::kResourceExhausted` error, depending
+   * on the configuration. Applications should not call this function from the
+   * completion queue threads if the writer is configured to block, as these
+   * threads may be needed to complete the pending batches.
+   */
+  future<Status> Write(google::logging::v2::LogEntry entry);
+
+  /// Sends the current batch, without waiting for the hold time to expire.
+  void Flush();
+
+ private:
+  explicit BatchingLogWriter(
+      std::shared_ptr<LoggingServiceV2Connection> connection,
+      google::cloud::CompletionQueue cq,
+      google::logging::v2::WriteLogEntriesRequest prototype,
+      BatchingLogWriterOptions options)
+      : connection_(std::move(connection)),
+        cq_(std::move(cq)),
+        prototype_(std::move(prototype)),
+        options_(std::move(options)) {}
+
+  struct Batch {
+    google::protobuf::RepeatedPtrField<google::logging::v2::LogEntry> entries;
+    std::vector<promise<Status>> waiters;
+    std::size_t bytes;
+  };
+
+  struct OnBatchResponse;
+
+  void OnTimer();
+  void OnBatchDone(std::size_t entries, std::size_t bytes);
+  bool HasRoom(std::size_t bytes) const;
+  void MakeBatch();
+  void SendReady(std::unique_lock<std::mutex> lk);
+  void Send(Batch batch, std::weak_ptr<BatchingLogWriter> weak);
+
+  std::shared_ptr<LoggingServiceV2Connection> const connection_;
+  google::cloud::CompletionQueue cq_;
+  google::logging::v2::WriteLogEntriesRequest const prototype_;
+  BatchingLogWriterOptions const options_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<promise<Status>> waiters_;
+  google::protobuf::RepeatedPtrField<google::logging::v2::LogEntry> entries_;
+  std::size_t current_bytes_ = 0;
+  std::chrono::system_clock::time_point batch_expiration_;
+  std::deque<Batch> ready_;
+  std::size_t running_batches_ = 0;
+  std::size_t pending_entries_ = 0;
+  std::size_t pending_bytes_ = 0;
+};
+
+}  // namespace logging
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_BATCHING_LOG_WRITER_H
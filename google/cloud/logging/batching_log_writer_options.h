@@ -0,0 +1,172 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_BATCHING_LOG_WRITER_OPTIONS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_BATCHING_LOG_WRITER_OPTIONS_H
+
+#include "google/cloud/version.h"
+#include <chrono>
+#include <cstddef>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace logging {
+
+/**
+ * Configuration options for a `BatchingLogWriter`.
+ *
+ * A writer flushes a batch as soon as any of these conditions are met:
+ * - `maximum_hold_time()` after the first entry is put in the batch,
+ * - when the batch contains `maximum_batch_entries()` entries or more,
+ * - when the batch contains `maximum_batch_bytes()` bytes or more.
+ *
+ * By default the writer holds entries for at most 50ms, and flushes batches
+ * with 1,000 entries or 1MiB of data. Cloud Logging [limits][logging-quotas]
+ * the size of each `WriteLogEntries()` request, the library makes no attempt
+ * to validate the values provided here.
+ *
+ * [logging-quotas]: https://cloud.google.com/logging/quotas
+ */
+class BatchingLogWriterOptions {
+ public:
+  BatchingLogWriterOptions() = default;
+
+  /// The maximum hold time.
+  std::chrono::microseconds maximum_hold_time() const {
+    return maximum_hold_time_;
+  }
+
+  /**
+   * Sets the maximum hold time for the entries.
+   *
+   * @note the first entry in a batch starts the hold time counter. New entries
+   *     do not extend the life of the batch.
+   */
+  template <typename Rep, typename Period>
+  BatchingLogWriterOptions& set_maximum_hold_time(
+      std::chrono::duration<Rep, Period> v) {
+    maximum_hold_time_ =
+        std::chrono::duration_cast<std::chrono::microseconds>(v);
+    return *this;
+  }
+
+  /// The maximum number of entries in a batch.
+  std::size_t maximum_batch_entries() const { return maximum_batch_entries_; }
+
+  /// Set the maximum number of entries in a batch.
+  BatchingLogWriterOptions& set_maximum_batch_entries(std::size_t v) {
+    maximum_batch_entries_ = v;
+    return *this;
+  }
+
+  /// The maximum size of the entries in a batch.
+  std::size_t maximum_batch_bytes() const { return maximum_batch_bytes_; }
+
+  /// Set the maximum size of the entries in a batch.
+  BatchingLogWriterOptions& set_maximum_batch_bytes(std::size_t v) {
+    maximum_batch_bytes_ = v;
+    return *this;
+  }
+
+  /// The maximum number of concurrent `WriteLogEntries()` RPCs.
+  std::size_t maximum_concurrent_batches() const {
+    return maximum_concurrent_batches_;
+  }
+
+  /**
+   * Set the maximum number of concurrent `WriteLogEntries()` RPCs.
+   *
+   * Batches beyond this limit wait in the writer until a previous batch
+   * completes. Use a value of at least 1, with 0 no batch is ever sent.
+   */
+  BatchingLogWriterOptions& set_maximum_concurrent_batches(std::size_t v) {
+    maximum_concurrent_batches_ = v;
+    return *this;
+  }
+
+  /// The maximum number of entries written but not yet acknowledged.
+  std::size_t maximum_pending_entries() const {
+    return maximum_pending_entries_;
+  }
+
+  /**
+   * Set the maximum number of pending entries.
+   *
+   * An entry is pending from the time `BatchingLogWriter::Write()` is called
+   * until the future it returns is satisfied. Bounding the number (and size,
+   * see `set_maximum_pending_bytes()`) of pending entries bounds the memory
+   * used by the writer when the service cannot keep up with the application.
+   * What happens when the limit is reached is controlled by
+   * `set_full_writer_blocks()` and `set_full_writer_rejects()`.
+   */
+  BatchingLogWriterOptions& set_maximum_pending_entries(std::size_t v) {
+    maximum_pending_entries_ = v;
+    return *this;
+  }
+
+  /// The maximum size of the entries written but not yet acknowledged.
+  std::size_t maximum_pending_bytes() const { return maximum_pending_bytes_; }
+
+  /**
+   * Set the maximum size of the pending entries.
+   *
+   * @see `set_maximum_pending_entries()` for details.
+   */
+  BatchingLogWriterOptions& set_maximum_pending_bytes(std::size_t v) {
+    maximum_pending_bytes_ = v;
+    return *this;
+  }
+
+  /// Return `true` if `Write()` blocks when the writer is full (the default).
+  bool full_writer_blocks() const { return full_writer_blocks_; }
+
+  /// Return `true` if new entries are rejected when the writer is full.
+  bool full_writer_rejects() const { return !full_writer_blocks_; }
+
+  /// Block `Write()` until there is room for the new entry.
+  BatchingLogWriterOptions& set_full_writer_blocks() {
+    full_writer_blocks_ = true;
+    return *this;
+  }
+
+  /// Reject new entries with `StatusCode::kResourceExhausted`.
+  BatchingLogWriterOptions& set_full_writer_rejects() {
+    full_writer_blocks_ = false;
+    return *this;
+  }
+
+ private:
+  static std::size_t constexpr kDefaultMaximumBatchEntries = 1000;
+  static std::size_t constexpr kDefaultMaximumBatchBytes = 1024 * 1024L;
+  static std::size_t constexpr kDefaultMaximumConcurrentBatches = 8;
+  static std::size_t constexpr kDefaultMaximumPendingEntries = 100 * 1000;
+  static std::size_t constexpr kDefaultMaximumPendingBytes =
+      64 * 1024 * 1024L;
+
+  std::chrono::microseconds maximum_hold_time_ = std::chrono::milliseconds(50);
+  std::size_t maximum_batch_entries_ = kDefaultMaximumBatchEntries;
+  std::size_t maximum_batch_bytes_ = kDefaultMaximumBatchBytes;
+  std::size_t maximum_concurrent_batches_ = kDefaultMaximumConcurrentBatches;
+  std::size_t maximum_pending_entries_ = kDefaultMaximumPendingEntries;
+  std::size_t maximum_pending_bytes_ = kDefaultMaximumPendingBytes;
+  bool full_writer_blocks_ = true;
+};
+
+}  // namespace logging
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_BATCHING_LOG_WRITER_OPTIONS_H
@@ -0,0 +1,268 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/logging/batching_log_writer.h"
+#include "google/cloud/logging/mocks/mock_logging_service_v2_connection.gcpcxx.pb.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/async_sequencer.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace logging {
+namespace {
+
+using ::google::cloud::logging_mocks::MockLoggingServiceV2Connection;
+using ::google::cloud::testing_util::AsyncSequencer;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::ElementsAre;
+
+using WriteResponse = StatusOr<google::logging::v2::WriteLogEntriesResponse>;
+
+google::logging::v2::WriteLogEntriesRequest MakePrototype() {
+  google::logging::v2::WriteLogEntriesRequest prototype;
+  prototype.set_log_name("projects/test-project/logs/test-log");
+  return prototype;
+}
+
+google::logging::v2::LogEntry MakeEntry(std::string payload) {
+  google::logging::v2::LogEntry entry;
+  entry.set_text_payload(std::move(payload));
+  return entry;
+}
+
+std::vector<std::string> Payloads(
+    google::logging::v2::WriteLogEntriesRequest const& request) {
+  std::vector<std::string> payloads;
+  for (auto const& e : request.entries()) payloads.push_back(e.text_payload());
+  return payloads;
+}
+
+TEST(BatchingLogWriterTest, BatchesByEntryCount) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  std::vector<std::vector<std::string>> batches;
+  EXPECT_CALL(*mock, AsyncWriteLogEntries)
+      .Times(2)
+      .WillRepeatedly(
+          [&](google::logging::v2::WriteLogEntriesRequest const& request) {
+            EXPECT_EQ("projects/test-project/logs/test-log",
+                      request.log_name());
+            batches.push_back(Payloads(request));
+            return make_ready_future(
+                WriteResponse(google::logging::v2::WriteLogEntriesResponse{}));
+          });
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto writer = BatchingLogWriter::Create(
+      mock, background.cq(), MakePrototype(),
+      BatchingLogWriterOptions{}
+          .set_maximum_batch_entries(2)
+          .set_maximum_hold_time(std::chrono::hours(24)));
+  std::vector<future<Status>> results;
+  for (auto const* p : {"e0", "e1", "e2", "e3"}) {
+    results.push_back(writer->Write(MakeEntry(p)));
+  }
+  for (auto& r : results) EXPECT_STATUS_OK(r.get());
+  EXPECT_THAT(batches, ElementsAre(ElementsAre("e0", "e1"),
+                                   ElementsAre("e2", "e3")));
+  background.cq().CancelAll();
+}
+
+TEST(BatchingLogWriterTest, BatchesByBytes) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  std::vector<std::vector<std::string>> batches;
+  EXPECT_CALL(*mock, AsyncWriteLogEntries)
+      .Times(2)
+      .WillRepeatedly(
+          [&](google::logging::v2::WriteLogEntriesRequest const& request) {
+            batches.push_back(Payloads(request));
+            return make_ready_future(
+                WriteResponse(google::logging::v2::WriteLogEntriesResponse{}));
+          });
+
+  auto const e0 = MakeEntry("e0");
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto writer = BatchingLogWriter::Create(
+      mock, background.cq(), MakePrototype(),
+      BatchingLogWriterOptions{}
+          .set_maximum_batch_bytes(2 * e0.ByteSizeLong())
+          .set_maximum_hold_time(std::chrono::hours(24)));
+  std::vector<future<Status>> results;
+  for (auto const* p : {"e0", "e1", "e2"}) {
+    results.push_back(writer->Write(MakeEntry(p)));
+  }
+  writer->Flush();
+  for (auto& r : results) EXPECT_STATUS_OK(r.get());
+  EXPECT_THAT(batches,
+              ElementsAre(ElementsAre("e0", "e1"), ElementsAre("e2")));
+  background.cq().CancelAll();
+}
+
+TEST(BatchingLogWriterTest, FlushesOnTimer) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  EXPECT_CALL(*mock, AsyncWriteLogEntries)
+      .WillOnce(
+          [&](google::logging::v2::WriteLogEntriesRequest const& request) {
+            EXPECT_THAT(Payloads(request), ElementsAre("e0", "e1"));
+            return make_ready_future(
+                WriteResponse(google::logging::v2::WriteLogEntriesResponse{}));
+          });
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto writer = BatchingLogWriter::Create(
+      mock, background.cq(), MakePrototype(),
+      BatchingLogWriterOptions{}.set_maximum_hold_time(
+          std::chrono::milliseconds(5)));
+  auto r0 = writer->Write(MakeEntry("e0"));
+  auto r1 = writer->Write(MakeEntry("e1"));
+  EXPECT_STATUS_OK(r0.get());
+  EXPECT_STATUS_OK(r1.get());
+}
+
+TEST(BatchingLogWriterTest, ErrorSatisfiesAllEntries) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  EXPECT_CALL(*mock, AsyncWriteLogEntries).WillOnce([] {
+    return make_ready_future(
+        WriteResponse(Status(StatusCode::kPermissionDenied, "uh-oh")));
+  });
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto writer = BatchingLogWriter::Create(mock, background.cq(),
+                                          MakePrototype());
+  auto r0 = writer->Write(MakeEntry("e0"));
+  auto r1 = writer->Write(MakeEntry("e1"));
+  writer->Flush();
+  EXPECT_THAT(r0.get(), StatusIs(StatusCode::kPermissionDenied));
+  EXPECT_THAT(r1.get(), StatusIs(StatusCode::kPermissionDenied));
+}
+
+TEST(BatchingLogWriterTest, LimitsConcurrentBatches) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  AsyncSequencer<void> async;
+  EXPECT_CALL(*mock, AsyncWriteLogEntries)
+      .Times(3)
+      .WillRepeatedly([&](google::logging::v2::WriteLogEntriesRequest const&) {
+        return async.PushBack().then([](future<void>) {
+          return WriteResponse(google::logging::v2::WriteLogEntriesResponse{});
+        });
+      });
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto writer = BatchingLogWriter::Create(
+      mock, background.cq(), MakePrototype(),
+      BatchingLogWriterOptions{}
+          .set_maximum_batch_entries(1)
+          .set_maximum_concurrent_batches(2));
+  auto r0 = writer->Write(MakeEntry("e0"));
+  auto r1 = writer->Write(MakeEntry("e1"));
+  auto r2 = writer->Write(MakeEntry("e2"));
+
+  // The third batch is only sent once one of the first two completes.
+  async.PopFront().set_value();
+  EXPECT_STATUS_OK(r0.get());
+  async.PopFront().set_value();
+  async.PopFront().set_value();
+  EXPECT_STATUS_OK(r1.get());
+  EXPECT_STATUS_OK(r2.get());
+  EXPECT_EQ(2, async.MaxSize());
+}
+
+TEST(BatchingLogWriterTest, FullWriterRejects) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  AsyncSequencer<void> async;
+  EXPECT_CALL(*mock, AsyncWriteLogEntries)
+      .WillOnce([&](google::logging::v2::WriteLogEntriesRequest const&) {
+        return async.PushBack().then([](future<void>) {
+          return WriteResponse(google::logging::v2::WriteLogEntriesResponse{});
+        });
+      });
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto writer = BatchingLogWriter::Create(
+      mock, background.cq(), MakePrototype(),
+      BatchingLogWriterOptions{}
+          .set_maximum_pending_entries(1)
+          .set_full_writer_rejects());
+  auto r0 = writer->Write(MakeEntry("e0"));
+  writer->Flush();
+  auto r1 = writer->Write(MakeEntry("e1"));
+  EXPECT_THAT(r1.get(), StatusIs(StatusCode::kResourceExhausted));
+  async.PopFront().set_value();
+  EXPECT_STATUS_OK(r0.get());
+}
+
+TEST(BatchingLogWriterTest, FullWriterBlocks) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  AsyncSequencer<void> async;
+  EXPECT_CALL(*mock, AsyncWriteLogEntries)
+      .Times(2)
+      .WillRepeatedly([&](google::logging::v2::WriteLogEntriesRequest const&) {
+        return async.PushBack().then([](future<void>) {
+          return WriteResponse(google::logging::v2::WriteLogEntriesResponse{});
+        });
+      });
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto writer = BatchingLogWriter::Create(
+      mock, background.cq(), MakePrototype(),
+      BatchingLogWriterOptions{}
+          .set_maximum_pending_entries(1)
+          .set_maximum_hold_time(std::chrono::hours(24))
+          .set_full_writer_blocks());
+  auto r0 = writer->Write(MakeEntry("e0"));
+  // The second `Write()` flushes the first entry and blocks until it
+  // completes.
+  auto r1 = std::async(std::launch::async,
+                       [&] { return writer->Write(MakeEntry("e1")); });
+  async.PopFront().set_value();
+  EXPECT_STATUS_OK(r0.get());
+  auto f1 = r1.get();
+  writer->Flush();
+  async.PopFront().set_value();
+  EXPECT_STATUS_OK(f1.get());
+  background.cq().CancelAll();
+}
+
+TEST(BatchingLogWriterTest, DestructorSendsPendingEntries) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  EXPECT_CALL(*mock, AsyncWriteLogEntries)
+      .WillOnce(
+          [&](google::logging::v2::WriteLogEntriesRequest const& request) {
+            EXPECT_THAT(Payloads(request), ElementsAre("e0"));
+            return make_ready_future(
+                WriteResponse(google::logging::v2::WriteLogEntriesResponse{}));
+          });
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto writer = BatchingLogWriter::Create(
+      mock, background.cq(), MakePrototype(),
+      BatchingLogWriterOptions{}.set_maximum_hold_time(
+          std::chrono::hours(24)));
+  auto r0 = writer->Write(MakeEntry("e0"));
+  writer.reset();
+  EXPECT_STATUS_OK(r0.get());
+  background.cq().CancelAll();
+}
+
+}  // namespace
+}  // namespace logging
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
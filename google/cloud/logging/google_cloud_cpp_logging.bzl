@@ -17,22 +17,29 @@
 """Automatically generated source lists for google_cloud_cpp_logging - DO NOT EDIT."""
 
 google_cloud_cpp_logging_hdrs = [
+    "batching_log_writer.h",
+    "batching_log_writer_options.h",
     "internal/logging_service_v2_logging_decorator.gcpcxx.pb.h",
     "internal/logging_service_v2_metadata_decorator.gcpcxx.pb.h",
+    "internal/logging_service_v2_metrics_decorator.gcpcxx.pb.h",
     "internal/logging_service_v2_stub.gcpcxx.pb.h",
     "internal/logging_service_v2_stub_factory.gcpcxx.pb.h",
     "logging_service_v2_client.gcpcxx.pb.h",
     "logging_service_v2_connection.gcpcxx.pb.h",
     "logging_service_v2_connection_idempotency_policy.gcpcxx.pb.h",
+    "parallel_list_log_entries.h",
     "retry_traits.h",
 ]
 
 google_cloud_cpp_logging_srcs = [
+    "batching_log_writer.cc",
     "internal/logging_service_v2_logging_decorator.gcpcxx.pb.cc",
     "internal/logging_service_v2_metadata_decorator.gcpcxx.pb.cc",
+    "internal/logging_service_v2_metrics_decorator.gcpcxx.pb.cc",
     "internal/logging_service_v2_stub.gcpcxx.pb.cc",
     "internal/logging_service_v2_stub_factory.gcpcxx.pb.cc",
     "logging_service_v2_client.gcpcxx.pb.cc",
     "logging_service_v2_connection.gcpcxx.pb.cc",
     "logging_service_v2_connection_idempotency_policy.gcpcxx.pb.cc",
+    "parallel_list_log_entries.cc",
 ]
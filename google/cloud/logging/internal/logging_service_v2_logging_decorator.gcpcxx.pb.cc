@@ -95,6 +95,33 @@ LoggingServiceV2Logging::ListLogs(
       context, request, __func__, tracing_options_);
 }
 
+future<Status> LoggingServiceV2Logging::AsyncDeleteLog(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::logging::v2::DeleteLogRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::logging::v2::DeleteLogRequest const& request) {
+        return child_->AsyncDeleteLog(cq, std::move(context), request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
+future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+LoggingServiceV2Logging::AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::logging::v2::WriteLogEntriesRequest const& request) {
+  return google::cloud::internal::LogWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::logging::v2::WriteLogEntriesRequest const& request) {
+        return child_->AsyncWriteLogEntries(cq, std::move(context), request);
+      },
+      cq, std::move(context), request, __func__, tracing_options_);
+}
+
 }  // namespace logging_internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -59,6 +59,17 @@ class LoggingServiceV2Logging : public LoggingServiceV2Stub {
       grpc::ClientContext& context,
       ::google::logging::v2::ListLogsRequest const& request) override;
 
+  future<Status> AsyncDeleteLog(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::logging::v2::DeleteLogRequest const& request) override;
+
+  future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::logging::v2::WriteLogEntriesRequest const& request) override;
+
  private:
   std::shared_ptr<LoggingServiceV2Stub> child_;
   TracingOptions tracing_options_;
@@ -71,6 +71,23 @@ LoggingServiceV2Metadata::ListLogs(
   return child_->ListLogs(context, request);
 }
 
+future<Status> LoggingServiceV2Metadata::AsyncDeleteLog(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::logging::v2::DeleteLogRequest const& request) {
+  SetMetadata(*context, "log_name=" + request.log_name());
+  return child_->AsyncDeleteLog(cq, std::move(context), request);
+}
+
+future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+LoggingServiceV2Metadata::AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::logging::v2::WriteLogEntriesRequest const& request) {
+  SetMetadata(*context, {});
+  return child_->AsyncWriteLogEntries(cq, std::move(context), request);
+}
+
 void LoggingServiceV2Metadata::SetMetadata(grpc::ClientContext& context,
                                            std::string const& request_params) {
   context.AddMetadata("x-goog-request-params", request_params);
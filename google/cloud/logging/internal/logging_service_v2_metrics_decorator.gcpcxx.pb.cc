@@ -0,0 +1,129 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by the Codegen C++ plugin.
+// If you make any local changes, they will be lost.
+// source: google/logging/v2/logging.proto
+#include "google/cloud/logging/internal/logging_service_v2_metrics_decorator.gcpcxx.pb.h"
+#include "google/cloud/instrumentation.h"
+#include "google/cloud/internal/metrics_wrapper.h"
+#include "google/cloud/status_or.h"
+#include <google/logging/v2/logging.grpc.pb.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace logging_internal {
+
+LoggingServiceV2Metrics::LoggingServiceV2Metrics(
+    std::shared_ptr<LoggingServiceV2Stub> child)
+    : child_(std::move(child)) {}
+
+Status LoggingServiceV2Metrics::DeleteLog(
+    grpc::ClientContext& context,
+    ::google::logging::v2::DeleteLogRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::logging::v2::DeleteLogRequest const& request) {
+        return child_->DeleteLog(context, request);
+      },
+      context, request, "google.logging.v2.LoggingServiceV2/DeleteLog");
+}
+
+StatusOr<::google::logging::v2::WriteLogEntriesResponse>
+LoggingServiceV2Metrics::WriteLogEntries(
+    grpc::ClientContext& context,
+    ::google::logging::v2::WriteLogEntriesRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::logging::v2::WriteLogEntriesRequest const& request) {
+        return child_->WriteLogEntries(context, request);
+      },
+      context, request, "google.logging.v2.LoggingServiceV2/WriteLogEntries");
+}
+
+StatusOr<::google::logging::v2::ListLogEntriesResponse>
+LoggingServiceV2Metrics::ListLogEntries(
+    grpc::ClientContext& context,
+    ::google::logging::v2::ListLogEntriesRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::logging::v2::ListLogEntriesRequest const& request) {
+        return child_->ListLogEntries(context, request);
+      },
+      context, request, "google.logging.v2.LoggingServiceV2/ListLogEntries");
+}
+
+StatusOr<::google::logging::v2::ListMonitoredResourceDescriptorsResponse>
+LoggingServiceV2Metrics::ListMonitoredResourceDescriptors(
+    grpc::ClientContext& context,
+    ::google::logging::v2::ListMonitoredResourceDescriptorsRequest const&
+        request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](
+          grpc::ClientContext& context,
+          ::google::logging::v2::ListMonitoredResourceDescriptorsRequest const&
+              request) {
+        return child_->ListMonitoredResourceDescriptors(context, request);
+      },
+      context, request,
+      "google.logging.v2.LoggingServiceV2/ListMonitoredResourceDescriptors");
+}
+
+StatusOr<::google::logging::v2::ListLogsResponse>
+LoggingServiceV2Metrics::ListLogs(
+    grpc::ClientContext& context,
+    ::google::logging::v2::ListLogsRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](grpc::ClientContext& context,
+             ::google::logging::v2::ListLogsRequest const& request) {
+        return child_->ListLogs(context, request);
+      },
+      context, request, "google.logging.v2.LoggingServiceV2/ListLogs");
+}
+
+future<Status> LoggingServiceV2Metrics::AsyncDeleteLog(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::logging::v2::DeleteLogRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::logging::v2::DeleteLogRequest const& request) {
+        return child_->AsyncDeleteLog(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.logging.v2.LoggingServiceV2/DeleteLog");
+}
+
+future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+LoggingServiceV2Metrics::AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::logging::v2::WriteLogEntriesRequest const& request) {
+  return google::cloud::internal::MetricsWrapper(
+      [this](google::cloud::CompletionQueue& cq,
+             std::unique_ptr<grpc::ClientContext> context,
+             ::google::logging::v2::WriteLogEntriesRequest const& request) {
+        return child_->AsyncWriteLogEntries(cq, std::move(context), request);
+      },
+      cq, std::move(context), request,
+      "google.logging.v2.LoggingServiceV2/WriteLogEntries");
+}
+
+}  // namespace logging_internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
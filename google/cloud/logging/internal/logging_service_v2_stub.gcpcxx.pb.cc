@@ -91,6 +91,37 @@ DefaultLoggingServiceV2Stub::ListLogs(
   return response;
 }
 
+future<Status> DefaultLoggingServiceV2Stub::AsyncDeleteLog(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::logging::v2::DeleteLogRequest const& request) {
+  return cq
+      .MakeUnaryRpc(
+          [this](grpc::ClientContext* context,
+                 ::google::logging::v2::DeleteLogRequest const& request,
+                 grpc::CompletionQueue* cq) {
+            return grpc_stub_->AsyncDeleteLog(context, request, cq);
+          },
+          request, std::move(context))
+      .then([](future<StatusOr<::google::protobuf::Empty>> f) {
+        return f.get().status();
+      });
+}
+
+future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+DefaultLoggingServiceV2Stub::AsyncWriteLogEntries(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    ::google::logging::v2::WriteLogEntriesRequest const& request) {
+  return cq.MakeUnaryRpc(
+      [this](grpc::ClientContext* context,
+             ::google::logging::v2::WriteLogEntriesRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return grpc_stub_->AsyncWriteLogEntries(context, request, cq);
+      },
+      request, std::move(context));
+}
+
 }  // namespace logging_internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
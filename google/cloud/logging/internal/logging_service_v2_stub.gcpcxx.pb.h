@@ -18,6 +18,8 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_INTERNAL_LOGGING_SERVICE_V2_STUB_GCPCXX_PB_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_INTERNAL_LOGGING_SERVICE_V2_STUB_GCPCXX_PB_H
 
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/version.h"
 #include <google/logging/v2/logging.grpc.pb.h>
@@ -56,6 +58,17 @@ class LoggingServiceV2Stub {
   virtual StatusOr<::google::logging::v2::ListLogsResponse> ListLogs(
       grpc::ClientContext& context,
       ::google::logging::v2::ListLogsRequest const& request) = 0;
+
+  virtual future<Status> AsyncDeleteLog(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::logging::v2::DeleteLogRequest const& request) = 0;
+
+  virtual future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::logging::v2::WriteLogEntriesRequest const& request) = 0;
 };
 
 class DefaultLoggingServiceV2Stub : public LoggingServiceV2Stub {
@@ -87,6 +100,17 @@ class DefaultLoggingServiceV2Stub : public LoggingServiceV2Stub {
       grpc::ClientContext& client_context,
       ::google::logging::v2::ListLogsRequest const& request) override;
 
+  future<Status> AsyncDeleteLog(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::logging::v2::DeleteLogRequest const& request) override;
+
+  future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::logging::v2::WriteLogEntriesRequest const& request) override;
+
  private:
   std::unique_ptr<::google::logging::v2::LoggingServiceV2::StubInterface>
       grpc_stub_;
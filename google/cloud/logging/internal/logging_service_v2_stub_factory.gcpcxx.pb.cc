@@ -19,26 +19,134 @@
 #include "google/cloud/logging/internal/logging_service_v2_stub_factory.gcpcxx.pb.h"
 #include "google/cloud/logging/internal/logging_service_v2_logging_decorator.gcpcxx.pb.h"
 #include "google/cloud/logging/internal/logging_service_v2_metadata_decorator.gcpcxx.pb.h"
+#include "google/cloud/logging/internal/logging_service_v2_metrics_decorator.gcpcxx.pb.h"
 #include "google/cloud/logging/internal/logging_service_v2_stub.gcpcxx.pb.h"
+#include "google/cloud/internal/channel_cache.h"
+#include "google/cloud/internal/channel_pool.h"
 #include "google/cloud/log.h"
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace google {
 namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
 namespace logging_internal {
 
+namespace {
+
+/**
+ * Sends each call to the stub whose channel has the fewest outstanding
+ * requests.
+ *
+ * Streaming calls are balanced when they start, but are not counted as
+ * outstanding requests while the stream is open.
+ */
+class LoggingServiceV2StubPool : public LoggingServiceV2Stub {
+ public:
+  LoggingServiceV2StubPool(
+      std::shared_ptr<google::cloud::internal::ChannelPool> pool,
+      std::vector<std::shared_ptr<LoggingServiceV2Stub>> children)
+      : pool_(std::move(pool)), children_(std::move(children)) {}
+
+  Status DeleteLog(
+      grpc::ClientContext& context,
+      ::google::logging::v2::DeleteLogRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->DeleteLog(context, request);
+  }
+
+  StatusOr<::google::logging::v2::WriteLogEntriesResponse> WriteLogEntries(
+      grpc::ClientContext& context,
+      ::google::logging::v2::WriteLogEntriesRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->WriteLogEntries(context, request);
+  }
+
+  StatusOr<::google::logging::v2::ListLogEntriesResponse> ListLogEntries(
+      grpc::ClientContext& context,
+      ::google::logging::v2::ListLogEntriesRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->ListLogEntries(context, request);
+  }
+
+  StatusOr<::google::logging::v2::ListMonitoredResourceDescriptorsResponse>
+  ListMonitoredResourceDescriptors(
+      grpc::ClientContext& context,
+      ::google::logging::v2::ListMonitoredResourceDescriptorsRequest const&
+          request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->ListMonitoredResourceDescriptors(
+        context, request);
+  }
+
+  StatusOr<::google::logging::v2::ListLogsResponse> ListLogs(
+      grpc::ClientContext& context,
+      ::google::logging::v2::ListLogsRequest const& request) override {
+    auto lease = pool_->Acquire();
+    return children_[lease.index()]->ListLogs(context, request);
+  }
+
+  future<Status> AsyncDeleteLog(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::logging::v2::DeleteLogRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncDeleteLog(cq, std::move(context), request)
+        .then([lease](future<Status> f) { return f.get(); });
+  }
+
+  future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+      google::cloud::CompletionQueue& cq,
+      std::unique_ptr<grpc::ClientContext> context,
+      ::google::logging::v2::WriteLogEntriesRequest const& request) override {
+    auto lease = std::make_shared<google::cloud::internal::ChannelLease>(
+        pool_->Acquire());
+    return children_[lease->index()]
+        ->AsyncWriteLogEntries(cq, std::move(context), request)
+        .then([lease](future<StatusOr<
+                          ::google::logging::v2::WriteLogEntriesResponse>>
+                          f) { return f.get(); });
+  }
+
+ private:
+  std::shared_ptr<google::cloud::internal::ChannelPool> pool_;
+  std::vector<std::shared_ptr<LoggingServiceV2Stub>> children_;
+};
+
+}  // namespace
+
 std::shared_ptr<LoggingServiceV2Stub> CreateDefaultLoggingServiceV2Stub(
     logging::LoggingServiceV2ConnectionOptions const& options) {
-  auto channel =
-      grpc::CreateCustomChannel(options.endpoint(), options.credentials(),
-                                options.CreateChannelArguments());
-  auto service_grpc_stub =
-      ::google::logging::v2::LoggingServiceV2::NewStub(channel);
+  auto const num_channels = (std::max)(options.num_channels(), 1);
+  std::vector<std::shared_ptr<grpc::Channel>> channels;
+  std::vector<std::shared_ptr<LoggingServiceV2Stub>> children;
+  for (int id = 0; id != num_channels; ++id) {
+    auto arguments = options.CreateChannelArguments();
+    // A different `grpc.channel_id` value gives each channel its own
+    // connection.
+    arguments.SetInt("grpc.channel_id", id);
+    auto channel = google::cloud::internal::CreateCustomChannel(
+        options.endpoint(), options.credentials(), arguments,
+        options.channel_cache_enabled());
+    auto service_grpc_stub =
+        ::google::logging::v2::LoggingServiceV2::NewStub(channel);
+    children.push_back(std::make_shared<DefaultLoggingServiceV2Stub>(
+        std::move(service_grpc_stub)));
+    channels.push_back(std::move(channel));
+  }
+  auto pool = std::make_shared<google::cloud::internal::ChannelPool>(
+      std::move(channels));
+  pool->WarmUp();
+
   std::shared_ptr<LoggingServiceV2Stub> stub =
-      std::make_shared<DefaultLoggingServiceV2Stub>(
-          std::move(service_grpc_stub));
+      std::make_shared<LoggingServiceV2StubPool>(std::move(pool),
+                                                 std::move(children));
 
+  stub = std::make_shared<LoggingServiceV2Metrics>(std::move(stub));
   stub = std::make_shared<LoggingServiceV2Metadata>(std::move(stub));
 
   if (options.tracing_enabled("rpc")) {
@@ -17,6 +17,7 @@
 // source: google/logging/v2/logging.proto
 
 #include "google/cloud/logging/logging_service_v2_client.gcpcxx.pb.h"
+#include <google/protobuf/arena.h>
 #include <memory>
 
 namespace google {
@@ -30,7 +31,9 @@ LoggingServiceV2Client::LoggingServiceV2Client(
 LoggingServiceV2Client::~LoggingServiceV2Client() = default;
 
 Status LoggingServiceV2Client::DeleteLog(std::string const& log_name) {
-  ::google::logging::v2::DeleteLogRequest request;
+  google::protobuf::Arena arena;
+  auto& request = *google::protobuf::Arena::CreateMessage<
+      ::google::logging::v2::DeleteLogRequest>(&arena);
   request.set_log_name(log_name);
   return connection_->DeleteLog(request);
 }
@@ -41,7 +44,9 @@ LoggingServiceV2Client::WriteLogEntries(
     ::google::api::MonitoredResource const& resource,
     std::map<std::string, std::string> const& labels,
     std::vector<::google::logging::v2::LogEntry> const& entries) {
-  ::google::logging::v2::WriteLogEntriesRequest request;
+  google::protobuf::Arena arena;
+  auto& request = *google::protobuf::Arena::CreateMessage<
+      ::google::logging::v2::WriteLogEntriesRequest>(&arena);
   request.set_log_name(log_name);
   *request.mutable_resource() = resource;
   *request.mutable_labels() = {labels.begin(), labels.end()};
@@ -96,6 +101,17 @@ StreamRange<std::string> LoggingServiceV2Client::ListLogs(
   return connection_->ListLogs(std::move(request));
 }
 
+future<Status> LoggingServiceV2Client::AsyncDeleteLog(
+    ::google::logging::v2::DeleteLogRequest const& request) {
+  return connection_->AsyncDeleteLog(request);
+}
+
+future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+LoggingServiceV2Client::AsyncWriteLogEntries(
+    ::google::logging::v2::WriteLogEntriesRequest const& request) {
+  return connection_->AsyncWriteLogEntries(request);
+}
+
 }  // namespace logging
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -249,6 +249,25 @@ class LoggingServiceV2Client {
   StreamRange<std::string> ListLogs(
       ::google::logging::v2::ListLogsRequest request);
 
+  /**
+   * Asynchronous version of `DeleteLog()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<Status> AsyncDeleteLog(
+      ::google::logging::v2::DeleteLogRequest const& request);
+
+  /**
+   * Asynchronous version of `WriteLogEntries()`.
+   *
+   * The returned future is satisfied when the RPC, including any retries,
+   * completes.
+   */
+  future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+      ::google::logging::v2::WriteLogEntriesRequest const& request);
+
  private:
   std::shared_ptr<LoggingServiceV2Connection> connection_;
 };
@@ -18,6 +18,8 @@
 
 #include "google/cloud/logging/logging_service_v2_connection.gcpcxx.pb.h"
 #include "google/cloud/logging/internal/logging_service_v2_stub_factory.gcpcxx.pb.h"
+#include "google/cloud/background_threads.h"
+#include "google/cloud/internal/async_retry_loop.h"
 #include "google/cloud/internal/pagination_range.h"
 #include "google/cloud/internal/retry_loop.h"
 #include "google/cloud/internal/user_agent_prefix.h"
@@ -96,6 +98,20 @@ StreamRange<std::string> LoggingServiceV2Connection::ListLogs(
       });
 }
 
+future<Status> LoggingServiceV2Connection::AsyncDeleteLog(
+    ::google::logging::v2::DeleteLogRequest const&) {
+  return google::cloud::make_ready_future(
+      Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+LoggingServiceV2Connection::AsyncWriteLogEntries(
+    ::google::logging::v2::WriteLogEntriesRequest const&) {
+  return google::cloud::make_ready_future<
+      StatusOr<::google::logging::v2::WriteLogEntriesResponse>>(
+      Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
 namespace {
 std::unique_ptr<LoggingServiceV2RetryPolicy> DefaultRetryPolicy() {
   return LoggingServiceV2LimitedTimeRetryPolicy(std::chrono::minutes(30))
@@ -112,20 +128,24 @@ std::unique_ptr<BackoffPolicy> DefaultBackoffPolicy() {
 class LoggingServiceV2ConnectionImpl : public LoggingServiceV2Connection {
  public:
   explicit LoggingServiceV2ConnectionImpl(
+      std::unique_ptr<BackgroundThreads> background,
       std::shared_ptr<logging_internal::LoggingServiceV2Stub> stub,
       std::unique_ptr<LoggingServiceV2RetryPolicy> retry_policy,
       std::unique_ptr<BackoffPolicy> backoff_policy,
       std::unique_ptr<LoggingServiceV2ConnectionIdempotencyPolicy>
           idempotency_policy)
-      : stub_(std::move(stub)),
+      : background_(std::move(background)),
+        stub_(std::move(stub)),
         retry_policy_prototype_(std::move(retry_policy)),
         backoff_policy_prototype_(std::move(backoff_policy)),
         idempotency_policy_(std::move(idempotency_policy)) {}
 
   explicit LoggingServiceV2ConnectionImpl(
+      std::unique_ptr<BackgroundThreads> background,
       std::shared_ptr<logging_internal::LoggingServiceV2Stub> stub)
       : LoggingServiceV2ConnectionImpl(
-            std::move(stub), DefaultRetryPolicy(), DefaultBackoffPolicy(),
+            std::move(background), std::move(stub), DefaultRetryPolicy(),
+            DefaultBackoffPolicy(),
             MakeDefaultLoggingServiceV2ConnectionIdempotencyPolicy()) {}
 
   ~LoggingServiceV2ConnectionImpl() override = default;
@@ -164,7 +184,7 @@ class LoggingServiceV2ConnectionImpl : public LoggingServiceV2Connection {
         backoff_policy_prototype_->clone());
     auto idempotency = idempotency_policy_->ListLogEntries(request);
     char const* function_name = __func__;
-    return google::cloud::internal::MakePaginationRange<
+    return google::cloud::internal::MakePrefetchingPaginationRange<
         StreamRange<::google::logging::v2::LogEntry>>(
         std::move(request),
         [stub, retry, backoff, idempotency,
@@ -184,7 +204,8 @@ class LoggingServiceV2ConnectionImpl : public LoggingServiceV2Connection {
           auto& messages = *r.mutable_entries();
           std::move(messages.begin(), messages.end(), result.begin());
           return result;
-        });
+        },
+        2);
   }
 
   StreamRange<::google::api::MonitoredResourceDescriptor>
@@ -200,7 +221,7 @@ class LoggingServiceV2ConnectionImpl : public LoggingServiceV2Connection {
     auto idempotency =
         idempotency_policy_->ListMonitoredResourceDescriptors(request);
     char const* function_name = __func__;
-    return google::cloud::internal::MakePaginationRange<
+    return google::cloud::internal::MakePrefetchingPaginationRange<
         StreamRange<::google::api::MonitoredResourceDescriptor>>(
         std::move(request),
         [stub, retry, backoff, idempotency,
@@ -222,7 +243,8 @@ class LoggingServiceV2ConnectionImpl : public LoggingServiceV2Connection {
           auto& messages = *r.mutable_resource_descriptors();
           std::move(messages.begin(), messages.end(), result.begin());
           return result;
-        });
+        },
+        2);
   }
 
   StreamRange<std::string> ListLogs(
@@ -235,7 +257,7 @@ class LoggingServiceV2ConnectionImpl : public LoggingServiceV2Connection {
         backoff_policy_prototype_->clone());
     auto idempotency = idempotency_policy_->ListLogs(request);
     char const* function_name = __func__;
-    return google::cloud::internal::MakePaginationRange<
+    return google::cloud::internal::MakePrefetchingPaginationRange<
         StreamRange<std::string>>(
         std::move(request),
         [stub, retry, backoff, idempotency,
@@ -253,10 +275,41 @@ class LoggingServiceV2ConnectionImpl : public LoggingServiceV2Connection {
           auto& messages = *r.mutable_log_names();
           std::move(messages.begin(), messages.end(), result.begin());
           return result;
-        });
+        },
+        2);
+  }
+
+  future<Status> AsyncDeleteLog(
+      ::google::logging::v2::DeleteLogRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->DeleteLog(request), background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::logging::v2::DeleteLogRequest const& request) {
+          return stub->AsyncDeleteLog(cq, std::move(context), request);
+        },
+        request, __func__);
+  }
+
+  future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+      ::google::logging::v2::WriteLogEntriesRequest const& request) override {
+    auto stub = stub_;
+    return google::cloud::internal::AsyncRetryLoop(
+        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+        idempotency_policy_->WriteLogEntries(request), background_->cq(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               ::google::logging::v2::WriteLogEntriesRequest const& request) {
+          return stub->AsyncWriteLogEntries(cq, std::move(context), request);
+        },
+        request, __func__);
   }
 
  private:
+  std::unique_ptr<BackgroundThreads> background_;
   std::shared_ptr<logging_internal::LoggingServiceV2Stub> stub_;
   std::unique_ptr<LoggingServiceV2RetryPolicy const> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
@@ -268,6 +321,7 @@ class LoggingServiceV2ConnectionImpl : public LoggingServiceV2Connection {
 std::shared_ptr<LoggingServiceV2Connection> MakeLoggingServiceV2Connection(
     LoggingServiceV2ConnectionOptions const& options) {
   return std::make_shared<LoggingServiceV2ConnectionImpl>(
+      options.background_threads_factory()(),
       logging_internal::CreateDefaultLoggingServiceV2Stub(options));
 }
 
@@ -278,6 +332,7 @@ std::shared_ptr<LoggingServiceV2Connection> MakeLoggingServiceV2Connection(
     std::unique_ptr<LoggingServiceV2ConnectionIdempotencyPolicy>
         idempotency_policy) {
   return std::make_shared<LoggingServiceV2ConnectionImpl>(
+      options.background_threads_factory()(),
       logging_internal::CreateDefaultLoggingServiceV2Stub(options),
       std::move(retry_policy), std::move(backoff_policy),
       std::move(idempotency_policy));
@@ -290,7 +345,8 @@ std::shared_ptr<LoggingServiceV2Connection> MakeLoggingServiceV2Connection(
     std::unique_ptr<LoggingServiceV2ConnectionIdempotencyPolicy>
         idempotency_policy) {
   return std::make_shared<LoggingServiceV2ConnectionImpl>(
-      std::move(stub), std::move(retry_policy), std::move(backoff_policy),
+      google::cloud::internal::DefaultBackgroundThreads(1), std::move(stub),
+      std::move(retry_policy), std::move(backoff_policy),
       std::move(idempotency_policy));
 }
 
@@ -23,6 +23,8 @@
 #include "google/cloud/logging/retry_traits.h"
 #include "google/cloud/backoff_policy.h"
 #include "google/cloud/connection_options.h"
+#include "google/cloud/future.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/status_or.h"
 #include "google/cloud/stream_range.h"
 #include "google/cloud/version.h"
@@ -54,6 +56,10 @@ using LoggingServiceV2LimitedErrorCountRetryPolicy =
     google::cloud::internal::LimitedErrorCountRetryPolicy<
         logging_internal::LoggingServiceV2RetryTraits>;
 
+using LoggingServiceV2BudgetedRetryPolicy =
+    google::cloud::internal::BudgetedRetryPolicy<
+        logging_internal::LoggingServiceV2RetryTraits>;
+
 class LoggingServiceV2Connection {
  public:
   virtual ~LoggingServiceV2Connection() = 0;
@@ -73,6 +79,13 @@ class LoggingServiceV2Connection {
 
   virtual StreamRange<std::string> ListLogs(
       ::google::logging::v2::ListLogsRequest request);
+
+  virtual future<Status> AsyncDeleteLog(
+      ::google::logging::v2::DeleteLogRequest const& request);
+
+  virtual future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>
+  AsyncWriteLogEntries(
+      ::google::logging::v2::WriteLogEntriesRequest const& request);
 };
 
 std::shared_ptr<LoggingServiceV2Connection> MakeLoggingServiceV2Connection(
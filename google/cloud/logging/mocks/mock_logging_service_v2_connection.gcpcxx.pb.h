@@ -50,6 +50,16 @@ class MockLoggingServiceV2Connection
 
   MOCK_METHOD(StreamRange<std::string>, ListLogs,
               (::google::logging::v2::ListLogsRequest request), (override));
+
+  MOCK_METHOD(
+      future<Status>, AsyncDeleteLog,
+      (::google::logging::v2::DeleteLogRequest const& request), (override));
+
+  MOCK_METHOD(
+      future<StatusOr<::google::logging::v2::WriteLogEntriesResponse>>,
+      AsyncWriteLogEntries,
+      (::google::logging::v2::WriteLogEntriesRequest const& request),
+      (override));
 };
 
 }  // namespace logging_mocks
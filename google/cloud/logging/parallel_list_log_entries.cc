@@ -0,0 +1,360 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/logging/parallel_list_log_entries.h"
+#include "google/cloud/internal/format_time_point.h"
+#include "absl/types/optional.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace logging_internal {
+namespace {
+
+// The number of entries pushed to the application at a time.
+std::size_t constexpr kChunkSize = 256;
+// The number of chunks, per shard, buffered for the application.
+std::size_t constexpr kBufferedChunksPerShard = 4;
+
+using LogEntry = google::logging::v2::LogEntry;
+
+bool TimestampLess(LogEntry const& a, LogEntry const& b) {
+  if (a.timestamp().seconds() != b.timestamp().seconds()) {
+    return a.timestamp().seconds() < b.timestamp().seconds();
+  }
+  return a.timestamp().nanos() < b.timestamp().nanos();
+}
+
+/**
+ * Lists several shards in background threads, and merges the results.
+ *
+ * Each background thread picks the next shard to list, and pushes chunks of
+ * results into a queue for that shard. The threads block while the queue is
+ * full. The application consumes the results from any shard, or, if the
+ * results are ordered, from the shards in the current time window, merging
+ * them by timestamp.
+ */
+class ParallelLogEntriesLister {
+ public:
+  ParallelLogEntriesLister(
+      std::shared_ptr<logging::LoggingServiceV2Connection> connection,
+      google::logging::v2::ListLogEntriesRequest request,
+      std::vector<LogEntriesShard> shards, std::size_t stream_count,
+      bool ordered, bool descending)
+      : connection_(std::move(connection)),
+        request_(std::move(request)),
+        shards_(std::move(shards)),
+        ordered_(ordered),
+        descending_(descending),
+        state_(shards_.size()),
+        cursors_((std::max<std::size_t>)(1, shards_.size())) {
+    // Find the range of shards in each time window.
+    for (std::size_t i = 0; i != shards_.size(); ++i) {
+      if (i == 0 || shards_[i].start != shards_[i - 1].start) {
+        windows_.emplace_back(i, i);
+      }
+      ++windows_.back().second;
+    }
+    workers_.reserve(stream_count);
+    for (std::size_t i = 0; i != stream_count; ++i) {
+      workers_.emplace_back([this] { Worker(); });
+    }
+  }
+
+  ~ParallelLogEntriesLister() {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      cancelled_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+  }
+
+  using ResultType =
+      google::cloud::internal::StreamReader<LogEntry>::result_type;
+
+  ResultType GetNext() { return ordered_ ? GetNextOrdered() : GetNextAny(); }
+
+ private:
+  struct ShardState {
+    std::deque<std::vector<LogEntry>> chunks;
+    bool done = false;
+    Status status;
+  };
+
+  // Only used by the application thread.
+  struct Cursor {
+    std::vector<LogEntry> chunk;
+    std::size_t next = 0;
+
+    bool has_value() const { return next < chunk.size(); }
+    LogEntry& value() { return chunk[next]; }
+  };
+
+  ResultType GetNextAny() {
+    auto& cursor = cursors_.front();
+    while (!cursor.has_value()) {
+      std::unique_lock<std::mutex> lk(mu_);
+      absl::optional<std::size_t> ready;
+      cv_.wait(lk, [&] {
+        for (std::size_t i = 0; i != state_.size(); ++i) {
+          auto const& s = state_[i];
+          if (!s.chunks.empty() || (s.done && !s.status.ok())) {
+            ready = i;
+            return true;
+          }
+        }
+        return done_count_ == state_.size();
+      });
+      if (!ready.has_value()) return Status{};
+      auto& s = state_[*ready];
+      if (s.chunks.empty()) return Cancel(std::move(lk), s.status);
+      cursor.chunk = std::move(s.chunks.front());
+      cursor.next = 0;
+      s.chunks.pop_front();
+      lk.unlock();
+      cv_.notify_all();
+    }
+    return std::move(cursor.chunk[cursor.next++]);
+  }
+
+  ResultType GetNextOrdered() {
+    for (; current_window_ != windows_.size(); ++current_window_) {
+      auto const& w = windows_[WindowIndex(current_window_)];
+      // Make sure each shard in the window has a value, or is finished.
+      std::unique_lock<std::mutex> lk(mu_);
+      auto refilled = false;
+      for (auto i = w.first; i != w.second; ++i) {
+        if (cursors_[i].has_value()) continue;
+        auto& s = state_[i];
+        cv_.wait(lk, [&s] { return !s.chunks.empty() || s.done; });
+        if (!s.chunks.empty()) {
+          cursors_[i].chunk = std::move(s.chunks.front());
+          cursors_[i].next = 0;
+          s.chunks.pop_front();
+          refilled = true;
+          continue;
+        }
+        if (!s.status.ok()) return Cancel(std::move(lk), s.status);
+      }
+      lk.unlock();
+      if (refilled) cv_.notify_all();
+
+      // Pick the first entry, in timestamp order, among the shards.
+      Cursor* best = nullptr;
+      for (auto i = w.first; i != w.second; ++i) {
+        auto& c = cursors_[i];
+        if (!c.has_value()) continue;
+        if (best == nullptr || Before(c.value(), best->value())) best = &c;
+      }
+      if (best != nullptr) return std::move(best->chunk[best->next++]);
+    }
+    return Status{};
+  }
+
+  std::size_t WindowIndex(std::size_t i) const {
+    return descending_ ? windows_.size() - 1 - i : i;
+  }
+
+  bool Before(LogEntry const& a, LogEntry const& b) const {
+    return descending_ ? TimestampLess(b, a) : TimestampLess(a, b);
+  }
+
+  ResultType Cancel(std::unique_lock<std::mutex> lk, Status status) {
+    cancelled_ = true;
+    lk.unlock();
+    cv_.notify_all();
+    return status;
+  }
+
+  void Worker() {
+    for (auto shard = NextShard(); shard.has_value(); shard = NextShard()) {
+      if (!ListShard(*shard)) break;
+    }
+  }
+
+  absl::optional<std::size_t> NextShard() {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (cancelled_ || next_shard_ == shards_.size()) return {};
+    // With descending order the application consumes the last window first.
+    if (!descending_) return next_shard_++;
+    auto const& w = windows_[windows_.size() - 1 - next_window_];
+    auto const shard = w.first + next_shard_in_window_++;
+    ++next_shard_;
+    if (shard + 1 == w.second) {
+      ++next_window_;
+      next_shard_in_window_ = 0;
+    }
+    return shard;
+  }
+
+  /// List all the entries in shard @p i, returns false if listing stopped.
+  bool ListShard(std::size_t i) {
+    auto range = connection_->ListLogEntries(
+        MakeShardRequest(request_, shards_[i]));
+    std::vector<LogEntry> chunk;
+    for (auto& entry : range) {
+      if (!entry) return Finish(i, std::move(entry).status());
+      chunk.push_back(*std::move(entry));
+      if (chunk.size() < kChunkSize) continue;
+      if (!Push(i, std::move(chunk))) return false;
+      chunk = {};
+    }
+    if (!chunk.empty() && !Push(i, std::move(chunk))) return false;
+    return Finish(i, Status{});
+  }
+
+  /// Push a chunk into the queue, returns false if the listing was cancelled.
+  bool Push(std::size_t i, std::vector<LogEntry> chunk) {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto& s = state_[i];
+    cv_.wait(lk, [&] {
+      return cancelled_ || s.chunks.size() < kBufferedChunksPerShard;
+    });
+    if (cancelled_) return false;
+    s.chunks.push_back(std::move(chunk));
+    lk.unlock();
+    cv_.notify_all();
+    return true;
+  }
+
+  /// Mark shard @p i as finished, returns false on errors.
+  bool Finish(std::size_t i, Status status) {
+    auto const ok = status.ok();
+    std::unique_lock<std::mutex> lk(mu_);
+    auto& s = state_[i];
+    s.done = true;
+    s.status = std::move(status);
+    ++done_count_;
+    lk.unlock();
+    cv_.notify_all();
+    return ok;
+  }
+
+  std::shared_ptr<logging::LoggingServiceV2Connection> const connection_;
+  google::logging::v2::ListLogEntriesRequest const request_;
+  std::vector<LogEntriesShard> const shards_;
+  bool const ordered_;
+  bool const descending_;
+  // The `[begin, end)` range of shards in each time window.
+  std::vector<std::pair<std::size_t, std::size_t>> windows_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<ShardState> state_;
+  std::size_t next_shard_ = 0;
+  std::size_t next_window_ = 0;
+  std::size_t next_shard_in_window_ = 0;
+  std::size_t done_count_ = 0;
+  bool cancelled_ = false;
+
+  // Only used by the application thread, in `GetNext()`. Unordered listings
+  // only use the first cursor.
+  std::vector<Cursor> cursors_;
+  std::size_t current_window_ = 0;
+
+  // Declared last, so the threads are started after all the other members are
+  // initialized.
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace
+
+std::vector<LogEntriesShard> ComputeLogEntriesShards(
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end,
+    std::chrono::microseconds shard_duration,
+    std::vector<std::string> const& resource_names) {
+  std::vector<LogEntriesShard> shards;
+  auto add_window = [&](std::chrono::system_clock::time_point s,
+                        std::chrono::system_clock::time_point e) {
+    if (resource_names.empty()) {
+      shards.push_back(LogEntriesShard{s, e, {}});
+      return;
+    }
+    for (auto const& r : resource_names) {
+      shards.push_back(LogEntriesShard{s, e, r});
+    }
+  };
+  if (shard_duration <= std::chrono::microseconds(0)) {
+    add_window(start, end);
+    return shards;
+  }
+  for (auto s = start; s < end; s += shard_duration) {
+    add_window(s, (std::min)(end, s + shard_duration));
+  }
+  return shards;
+}
+
+google::logging::v2::ListLogEntriesRequest MakeShardRequest(
+    google::logging::v2::ListLogEntriesRequest request,
+    LogEntriesShard const& shard) {
+  auto restriction = "timestamp>=\"" +
+                     google::cloud::internal::FormatRfc3339(shard.start) +
+                     "\" AND timestamp<\"" +
+                     google::cloud::internal::FormatRfc3339(shard.end) + "\"";
+  if (!request.filter().empty()) {
+    restriction = "(" + request.filter() + ") AND " + restriction;
+  }
+  request.set_filter(std::move(restriction));
+  if (!shard.resource_name.empty()) {
+    request.clear_resource_names();
+    request.add_resource_names(shard.resource_name);
+  }
+  request.clear_page_token();
+  return request;
+}
+
+}  // namespace logging_internal
+
+namespace logging {
+
+StreamRange<google::logging::v2::LogEntry> ParallelListLogEntries(
+    std::shared_ptr<LoggingServiceV2Connection> connection,
+    google::logging::v2::ListLogEntriesRequest request,
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end,
+    ParallelListLogEntriesOptions options) {
+  std::vector<std::string> resource_names;
+  if (options.shard_by_resource_name()) {
+    resource_names.assign(request.resource_names().begin(),
+                          request.resource_names().end());
+  }
+  auto shards = logging_internal::ComputeLogEntriesShards(
+      start, end, options.shard_duration(), resource_names);
+  auto stream_count = (std::max<std::size_t>)(
+      1, (std::min)(shards.size(), options.maximum_streams()));
+  // With ordered results the application waits for all the shards in a time
+  // window, they must all be running to make progress.
+  if (options.ordered() && !resource_names.empty()) {
+    stream_count = (std::max)(stream_count, resource_names.size());
+  }
+  auto const descending = request.order_by() == "timestamp desc";
+  auto lister = std::make_shared<logging_internal::ParallelLogEntriesLister>(
+      std::move(connection), std::move(request), std::move(shards),
+      stream_count, options.ordered(), descending);
+  return google::cloud::internal::MakeStreamRange<
+      google::logging::v2::LogEntry>([lister] { return lister->GetNext(); });
+}
+
+}  // namespace logging
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
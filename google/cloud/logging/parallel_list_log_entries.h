@@ -0,0 +1,185 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_PARALLEL_LIST_LOG_ENTRIES_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_PARALLEL_LIST_LOG_ENTRIES_H
+
+#include "google/cloud/logging/logging_service_v2_connection.gcpcxx.pb.h"
+#include "google/cloud/stream_range.h"
+#include "google/cloud/version.h"
+#include <google/logging/v2/logging.pb.h>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace logging {
+
+/**
+ * Configuration options for `ParallelListLogEntries()`.
+ *
+ * By default the time range is split in 1 hour windows, listed using up to 16
+ * concurrent streams, and the results are returned in the order they arrive.
+ */
+class ParallelListLogEntriesOptions {
+ public:
+  ParallelListLogEntriesOptions() = default;
+
+  /// The duration of the time window listed by each shard.
+  std::chrono::microseconds shard_duration() const { return shard_duration_; }
+
+  /// Set the duration of the time window listed by each shard.
+  template <typename Rep, typename Period>
+  ParallelListLogEntriesOptions& set_shard_duration(
+      std::chrono::duration<Rep, Period> v) {
+    shard_duration_ = std::chrono::duration_cast<std::chrono::microseconds>(v);
+    return *this;
+  }
+
+  /// The maximum number of concurrent `ListLogEntries()` streams.
+  std::size_t maximum_streams() const { return maximum_streams_; }
+
+  /// Set the maximum number of concurrent `ListLogEntries()` streams.
+  ParallelListLogEntriesOptions& set_maximum_streams(std::size_t v) {
+    maximum_streams_ = v;
+    return *this;
+  }
+
+  /// Return `true` if each resource name is listed in a separate shard.
+  bool shard_by_resource_name() const { return shard_by_resource_name_; }
+
+  /**
+   * List each of the `resource_names` in the request in separate shards.
+   *
+   * By default each shard lists all the resource names in the request. With
+   * this option each time window is split further, into one shard per
+   * resource name.
+   */
+  ParallelListLogEntriesOptions& set_shard_by_resource_name(bool v) {
+    shard_by_resource_name_ = v;
+    return *this;
+  }
+
+  /// Return `true` if the results are returned in timestamp order.
+  bool ordered() const { return ordered_; }
+
+  /**
+   * Return the results in timestamp order.
+   *
+   * The results are ordered as specified by the `order_by` field in the
+   * request, `timestamp asc` (the default) or `timestamp desc`. The shards are
+   * still listed in parallel, but the application receives the results from
+   * one time window at a time, merging the results for each resource name if
+   * needed.
+   */
+  ParallelListLogEntriesOptions& set_ordered(bool v) {
+    ordered_ = v;
+    return *this;
+  }
+
+ private:
+  static std::size_t constexpr kDefaultMaximumStreams = 16;
+
+  std::chrono::microseconds shard_duration_ = std::chrono::hours(1);
+  std::size_t maximum_streams_ = kDefaultMaximumStreams;
+  bool shard_by_resource_name_ = false;
+  bool ordered_ = false;
+};
+
+}  // namespace logging
+
+namespace logging_internal {
+
+/// A shard of a parallel listing, the time range is right-open.
+struct LogEntriesShard {
+  std::chrono::system_clock::time_point start;
+  std::chrono::system_clock::time_point end;
+  /// If empty, the shard lists all the resource names in the request.
+  std::string resource_name;
+};
+
+/**
+ * Split the `[start, end)` time range into shards.
+ *
+ * The shards are sorted by time window, and then by resource name. If
+ * @p resource_names is empty each window is a single shard.
+ */
+std::vector<LogEntriesShard> ComputeLogEntriesShards(
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end,
+    std::chrono::microseconds shard_duration,
+    std::vector<std::string> const& resource_names);
+
+/// Restrict @p request to the time range (and resource name) in @p shard.
+google::logging::v2::ListLogEntriesRequest MakeShardRequest(
+    google::logging::v2::ListLogEntriesRequest request,
+    LogEntriesShard const& shard);
+
+}  // namespace logging_internal
+
+namespace logging {
+
+/**
+ * List the log entries in the `[start, end)` time range using multiple
+ * parallel streams.
+ *
+ * `LoggingServiceV2Connection::ListLogEntries()` fetches the pages of results
+ * one at a time, each request depends on the page token returned by the
+ * previous request. Exporting a large volume of logs this way is bound by the
+ * latency of each request. This function splits the time range into windows,
+ * and optionally each window by resource name, and lists the shards in
+ * parallel. Each shard adds a timestamp restriction to the `filter` in
+ * @p request, and uses the connection's retry policies for its requests.
+ *
+ * Unless `ParallelListLogEntriesOptions::set_ordered()` is used the results
+ * from different shards are interleaved as they arrive. The background
+ * threads stop listing when the results not yet consumed by the application
+ * fill a small buffer per shard, and when the returned range is destroyed. If
+ * listing any shard fails the range returns that error, and stops listing the
+ * remaining shards.
+ *
+ * @par Example
+ * @code
+ * namespace logging = ::google::cloud::logging;
+ * google::logging::v2::ListLogEntriesRequest request;
+ * request.add_resource_names("projects/my-project");
+ * request.set_filter("severity>=WARNING");
+ * auto const end = std::chrono::system_clock::now();
+ * auto range = logging::ParallelListLogEntries(
+ *     logging::MakeLoggingServiceV2Connection(), std::move(request),
+ *     end - std::chrono::hours(24), end,
+ *     logging::ParallelListLogEntriesOptions{}.set_maximum_streams(24));
+ * for (auto& entry : range) {
+ *   if (!entry) throw std::runtime_error(entry.status().message());
+ *   std::cout << entry->text_payload() << "\n";
+ * }
+ * @endcode
+ */
+StreamRange<google::logging::v2::LogEntry> ParallelListLogEntries(
+    std::shared_ptr<LoggingServiceV2Connection> connection,
+    google::logging::v2::ListLogEntriesRequest request,
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end,
+    ParallelListLogEntriesOptions options = {});
+
+}  // namespace logging
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_LOGGING_PARALLEL_LIST_LOG_ENTRIES_H
@@ -0,0 +1,244 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/logging/parallel_list_log_entries.h"
+#include "google/cloud/logging/mocks/mock_logging_service_v2_connection.gcpcxx.pb.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace logging {
+namespace {
+
+using ::google::cloud::logging_internal::ComputeLogEntriesShards;
+using ::google::cloud::logging_internal::MakeShardRequest;
+using ::google::cloud::logging_mocks::MockLoggingServiceV2Connection;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::UnorderedElementsAre;
+using LogEntry = ::google::logging::v2::LogEntry;
+
+// 2021-01-01T00:00:00Z
+auto const kStart = std::chrono::system_clock::from_time_t(1609459200);
+
+LogEntry MakeEntry(std::string payload, std::chrono::seconds offset) {
+  LogEntry entry;
+  entry.set_text_payload(std::move(payload));
+  entry.mutable_timestamp()->set_seconds(1609459200 + offset.count());
+  return entry;
+}
+
+StreamRange<LogEntry> MakeRange(std::vector<LogEntry> entries,
+                                Status last = {}) {
+  auto data = std::make_shared<std::deque<LogEntry>>(entries.begin(),
+                                                    entries.end());
+  return google::cloud::internal::MakeStreamRange<LogEntry>(
+      [data, last]() -> google::cloud::internal::StreamReader<
+                         LogEntry>::result_type {
+        if (data->empty()) return last;
+        auto e = std::move(data->front());
+        data->pop_front();
+        return e;
+      });
+}
+
+// Returns the entries for each shard, identified by the start of its time
+// window (in hours) and its resource name.
+StreamRange<LogEntry> FakeListLogEntries(
+    google::logging::v2::ListLogEntriesRequest const& request) {
+  auto const second_window =
+      request.filter().find("2021-01-01T01:00:00") <
+      request.filter().find("AND timestamp<");
+  auto const resource =
+      request.resource_names().size() == 1 ? request.resource_names(0) : "";
+  if (!second_window && resource == "projects/p1") {
+    return MakeRange({MakeEntry("w0-p1-a", std::chrono::seconds(10)),
+                      MakeEntry("w0-p1-b", std::chrono::seconds(30))});
+  }
+  if (!second_window && resource == "projects/p2") {
+    return MakeRange({MakeEntry("w0-p2-a", std::chrono::seconds(20)),
+                      MakeEntry("w0-p2-b", std::chrono::seconds(40))});
+  }
+  if (second_window && resource == "projects/p1") {
+    return MakeRange({MakeEntry("w1-p1-a", std::chrono::seconds(3610))});
+  }
+  if (second_window && resource == "projects/p2") {
+    return MakeRange({MakeEntry("w1-p2-a", std::chrono::seconds(3605))});
+  }
+  return MakeRange({});
+}
+
+std::vector<std::string> Payloads(StreamRange<LogEntry> range) {
+  std::vector<std::string> payloads;
+  for (auto& e : range) {
+    EXPECT_STATUS_OK(e);
+    if (!e) break;
+    payloads.push_back(e->text_payload());
+  }
+  return payloads;
+}
+
+google::logging::v2::ListLogEntriesRequest MakeRequest() {
+  google::logging::v2::ListLogEntriesRequest request;
+  request.add_resource_names("projects/p1");
+  request.add_resource_names("projects/p2");
+  return request;
+}
+
+TEST(ParallelListLogEntriesTest, ComputeShards) {
+  auto const shards =
+      ComputeLogEntriesShards(kStart, kStart + std::chrono::minutes(150),
+                              std::chrono::hours(1), {"r1", "r2"});
+  ASSERT_EQ(6, shards.size());
+  EXPECT_EQ(kStart, shards[0].start);
+  EXPECT_EQ(kStart + std::chrono::hours(1), shards[0].end);
+  EXPECT_EQ("r1", shards[0].resource_name);
+  EXPECT_EQ("r2", shards[1].resource_name);
+  EXPECT_EQ(kStart + std::chrono::hours(2), shards[5].start);
+  EXPECT_EQ(kStart + std::chrono::minutes(150), shards[5].end);
+
+  auto const single =
+      ComputeLogEntriesShards(kStart, kStart + std::chrono::hours(2),
+                              std::chrono::microseconds(0), {});
+  ASSERT_EQ(1, single.size());
+  EXPECT_EQ(kStart + std::chrono::hours(2), single[0].end);
+  EXPECT_TRUE(single[0].resource_name.empty());
+}
+
+TEST(ParallelListLogEntriesTest, MakeShardRequest) {
+  auto request = MakeRequest();
+  request.set_filter("severity>=WARNING");
+  request.set_page_token("stale");
+  auto const actual = MakeShardRequest(
+      request, logging_internal::LogEntriesShard{
+                   kStart, kStart + std::chrono::hours(1), "projects/p2"});
+  EXPECT_THAT(actual.filter(),
+              HasSubstr("(severity>=WARNING) AND "
+                        "timestamp>=\"2021-01-01T00:00:00"));
+  EXPECT_THAT(actual.filter(), HasSubstr("timestamp<\"2021-01-01T01:00:00"));
+  EXPECT_THAT(actual.resource_names(), ElementsAre("projects/p2"));
+  EXPECT_TRUE(actual.page_token().empty());
+}
+
+TEST(ParallelListLogEntriesTest, Unordered) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  EXPECT_CALL(*mock, ListLogEntries)
+      .Times(4)
+      .WillRepeatedly(FakeListLogEntries);
+
+  auto range = ParallelListLogEntries(
+      mock, MakeRequest(), kStart, kStart + std::chrono::hours(2),
+      ParallelListLogEntriesOptions{}.set_shard_by_resource_name(true));
+  EXPECT_THAT(Payloads(std::move(range)),
+              UnorderedElementsAre("w0-p1-a", "w0-p1-b", "w0-p2-a", "w0-p2-b",
+                                   "w1-p1-a", "w1-p2-a"));
+}
+
+TEST(ParallelListLogEntriesTest, OrderedAscending) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  EXPECT_CALL(*mock, ListLogEntries)
+      .Times(4)
+      .WillRepeatedly(FakeListLogEntries);
+
+  auto range = ParallelListLogEntries(mock, MakeRequest(), kStart,
+                                      kStart + std::chrono::hours(2),
+                                      ParallelListLogEntriesOptions{}
+                                          .set_shard_by_resource_name(true)
+                                          .set_maximum_streams(1)
+                                          .set_ordered(true));
+  EXPECT_THAT(Payloads(std::move(range)),
+              ElementsAre("w0-p1-a", "w0-p2-a", "w0-p1-b", "w0-p2-b",
+                          "w1-p2-a", "w1-p1-a"));
+}
+
+TEST(ParallelListLogEntriesTest, OrderedDescending) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  EXPECT_CALL(*mock, ListLogEntries)
+      .Times(4)
+      .WillRepeatedly(
+          [](google::logging::v2::ListLogEntriesRequest const& request) {
+            EXPECT_EQ("timestamp desc", request.order_by());
+            // Reverse the results, as the service would.
+            std::vector<LogEntry> entries;
+            for (auto& e : FakeListLogEntries(request)) {
+              entries.insert(entries.begin(), *std::move(e));
+            }
+            return MakeRange(std::move(entries));
+          });
+
+  auto request = MakeRequest();
+  request.set_order_by("timestamp desc");
+  auto range = ParallelListLogEntries(
+      mock, std::move(request), kStart, kStart + std::chrono::hours(2),
+      ParallelListLogEntriesOptions{}
+          .set_shard_by_resource_name(true)
+          .set_ordered(true));
+  EXPECT_THAT(Payloads(std::move(range)),
+              ElementsAre("w1-p1-a", "w1-p2-a", "w0-p2-b", "w0-p1-b",
+                          "w0-p2-a", "w0-p1-a"));
+}
+
+TEST(ParallelListLogEntriesTest, ErrorStopsListing) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  EXPECT_CALL(*mock, ListLogEntries)
+      .WillRepeatedly(
+          [](google::logging::v2::ListLogEntriesRequest const& request) {
+            if (request.filter().find("2021-01-01T01:00:00") <
+                request.filter().find("AND timestamp<")) {
+              return MakeRange({}, Status(StatusCode::kPermissionDenied,
+                                          "uh-oh"));
+            }
+            return FakeListLogEntries(request);
+          });
+
+  auto range = ParallelListLogEntries(
+      mock, MakeRequest(), kStart, kStart + std::chrono::hours(2),
+      ParallelListLogEntriesOptions{}
+          .set_shard_by_resource_name(true)
+          .set_ordered(true));
+  std::vector<std::string> payloads;
+  Status status;
+  for (auto& e : range) {
+    if (!e) {
+      status = std::move(e).status();
+      break;
+    }
+    payloads.push_back(e->text_payload());
+  }
+  EXPECT_THAT(payloads,
+              ElementsAre("w0-p1-a", "w0-p2-a", "w0-p1-b", "w0-p2-b"));
+  EXPECT_THAT(status, StatusIs(StatusCode::kPermissionDenied));
+}
+
+TEST(ParallelListLogEntriesTest, EmptyTimeRange) {
+  auto mock = std::make_shared<MockLoggingServiceV2Connection>();
+  EXPECT_CALL(*mock, ListLogEntries).Times(0);
+
+  auto range = ParallelListLogEntries(mock, MakeRequest(), kStart, kStart);
+  EXPECT_THAT(Payloads(std::move(range)), ElementsAre());
+}
+
+}  // namespace
+}  // namespace logging
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,71 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/memory_budget.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+
+std::size_t MemoryBudget::used_bytes() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return used_bytes_;
+}
+
+std::vector<MemoryUsage> MemoryBudget::Usage() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  std::vector<MemoryUsage> result;
+  result.reserve(usage_.size());
+  for (auto const& u : usage_) {
+    result.push_back(MemoryUsage{u.first.first, u.first.second, u.second});
+  }
+  return result;
+}
+
+bool MemoryBudget::TryAcquire(Key const& key, std::size_t bytes) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!HasRoom(key, bytes)) return false;
+  used_bytes_ += bytes;
+  usage_[key] += bytes;
+  return true;
+}
+
+void MemoryBudget::Acquire(Key const& key, std::size_t bytes) {
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [&] { return HasRoom(key, bytes); });
+  used_bytes_ += bytes;
+  usage_[key] += bytes;
+}
+
+void MemoryBudget::Release(Key const& key, std::size_t bytes) {
+  std::unique_lock<std::mutex> lk(mu_);
+  auto i = usage_.find(key);
+  if (i == usage_.end()) return;
+  bytes = (std::min)(bytes, i->second);
+  i->second -= bytes;
+  used_bytes_ -= bytes;
+  if (i->second == 0) usage_.erase(i);
+  lk.unlock();
+  cv_.notify_all();
+}
+
+bool MemoryBudget::HasRoom(Key const& key, std::size_t bytes) const {
+  if (max_bytes_ == 0 || usage_.count(key) == 0) return true;
+  return used_bytes_ + bytes <= max_bytes_;
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,142 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_MEMORY_BUDGET_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_MEMORY_BUDGET_H
+
+#include "google/cloud/version.h"
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+
+/// The memory held by one subsystem of one client, see `MemoryBudget`.
+struct MemoryUsage {
+  std::string client;
+  std::string subsystem;
+  std::size_t bytes;
+};
+
+inline bool operator==(MemoryUsage const& a, MemoryUsage const& b) {
+  return a.client == b.client && a.subsystem == b.subsystem &&
+         a.bytes == b.bytes;
+}
+
+inline bool operator!=(MemoryUsage const& a, MemoryUsage const& b) {
+  return !(a == b);
+}
+
+/**
+ * Tracks the memory held in buffers by the clients in a process.
+ *
+ * Clients configured with a `MemoryBudget` report the bytes they hold in
+ * their buffers, e.g. the pending messages in a Pub/Sub publisher, or the
+ * outstanding mutations in a Bigtable `MutationBatcher`. Applications can
+ * share one budget across all their clients, and use `Usage()` to find out
+ * which clients hold the memory.
+ *
+ * If `max_bytes()` is not zero the budget also applies backpressure: once the
+ * clients hold `max_bytes()` in total, new buffers wait, or are rejected,
+ * depending on the client, until other buffers are released. A client that
+ * holds no memory in a subsystem can always acquire memory for it, otherwise
+ * a client could wait forever for memory held by other clients. Therefore,
+ * the limit can be exceeded by one buffer for each client and subsystem.
+ *
+ * @par Thread-safety
+ * Instances of this class are safe to use from multiple threads.
+ */
+class MemoryBudget {
+ public:
+  /// Create a budget, a @p max_bytes of 0 tracks the memory without limits.
+  explicit MemoryBudget(std::size_t max_bytes = 0) : max_bytes_(max_bytes) {}
+
+  MemoryBudget(MemoryBudget const&) = delete;
+  MemoryBudget& operator=(MemoryBudget const&) = delete;
+
+  /// The maximum number of bytes held by all the clients, 0 if unlimited.
+  std::size_t max_bytes() const { return max_bytes_; }
+
+  /// The number of bytes currently held by all the clients.
+  std::size_t used_bytes() const;
+
+  /// The bytes held by each client and subsystem, excluding idle ones.
+  std::vector<MemoryUsage> Usage() const;
+
+ private:
+  friend class MemoryAccount;
+  using Key = std::pair<std::string, std::string>;
+
+  bool TryAcquire(Key const& key, std::size_t bytes);
+  void Acquire(Key const& key, std::size_t bytes);
+  void Release(Key const& key, std::size_t bytes);
+  bool HasRoom(Key const& key, std::size_t bytes) const;
+
+  std::size_t const max_bytes_;
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::size_t used_bytes_ = 0;         // GUARDED_BY(mu_)
+  std::map<Key, std::size_t> usage_;  // GUARDED_BY(mu_)
+};
+
+/**
+ * The memory held by one subsystem of one client in a `MemoryBudget`.
+ *
+ * Libraries create one account for each buffer they want to report. A
+ * default-constructed account has no budget, all its operations succeed
+ * without any accounting.
+ */
+class MemoryAccount {
+ public:
+  MemoryAccount() = default;
+  MemoryAccount(std::shared_ptr<MemoryBudget> budget, std::string client,
+                std::string subsystem)
+      : budget_(std::move(budget)),
+        key_(std::move(client), std::move(subsystem)) {}
+
+  /// Returns true if this account reports to a budget.
+  bool enabled() const { return budget_ != nullptr; }
+
+  /// Acquire @p bytes if the budget has room for them.
+  bool TryAcquire(std::size_t bytes) {
+    return !budget_ || budget_->TryAcquire(key_, bytes);
+  }
+
+  /// Acquire @p bytes, blocking until the budget has room for them.
+  void Acquire(std::size_t bytes) {
+    if (budget_) budget_->Acquire(key_, bytes);
+  }
+
+  /// Release @p bytes acquired earlier.
+  void Release(std::size_t bytes) {
+    if (budget_) budget_->Release(key_, bytes);
+  }
+
+ private:
+  std::shared_ptr<MemoryBudget> budget_;
+  MemoryBudget::Key key_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_MEMORY_BUDGET_H
@@ -0,0 +1,92 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/memory_budget.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <future>
+#include <thread>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(MemoryBudgetTest, Accounting) {
+  auto budget = std::make_shared<MemoryBudget>();
+  EXPECT_EQ(0, budget->max_bytes());
+  MemoryAccount a(budget, "client-a", "batches");
+  MemoryAccount b(budget, "client-b", "batches");
+  EXPECT_TRUE(a.TryAcquire(100));
+  a.Acquire(50);
+  b.Acquire(1000);
+  EXPECT_EQ(1150, budget->used_bytes());
+  EXPECT_THAT(budget->Usage(),
+              ElementsAre(MemoryUsage{"client-a", "batches", 150},
+                          MemoryUsage{"client-b", "batches", 1000}));
+
+  a.Release(150);
+  b.Release(1000);
+  EXPECT_EQ(0, budget->used_bytes());
+  EXPECT_THAT(budget->Usage(), IsEmpty());
+}
+
+TEST(MemoryBudgetTest, TryAcquireLimit) {
+  auto budget = std::make_shared<MemoryBudget>(100);
+  MemoryAccount a(budget, "client-a", "batches");
+  MemoryAccount b(budget, "client-b", "batches");
+  // An idle account can always acquire memory, even beyond the limit.
+  EXPECT_TRUE(a.TryAcquire(80));
+  EXPECT_TRUE(a.TryAcquire(20));
+  EXPECT_FALSE(a.TryAcquire(1));
+  EXPECT_TRUE(b.TryAcquire(10));
+  EXPECT_EQ(110, budget->used_bytes());
+  EXPECT_FALSE(b.TryAcquire(1));
+
+  a.Release(100);
+  EXPECT_TRUE(b.TryAcquire(90));
+}
+
+TEST(MemoryBudgetTest, AcquireBlocks) {
+  auto budget = std::make_shared<MemoryBudget>(100);
+  MemoryAccount a(budget, "client-a", "batches");
+  a.Acquire(100);
+  a.Acquire(0);
+
+  auto done = std::async(std::launch::async, [a]() mutable {
+    a.Acquire(50);
+    return true;
+  });
+  EXPECT_EQ(std::future_status::timeout,
+            done.wait_for(std::chrono::milliseconds(50)));
+  a.Release(60);
+  EXPECT_TRUE(done.get());
+  EXPECT_EQ(90, budget->used_bytes());
+}
+
+TEST(MemoryBudgetTest, NoBudget) {
+  MemoryAccount account;
+  EXPECT_FALSE(account.enabled());
+  EXPECT_TRUE(account.TryAcquire(1000));
+  account.Acquire(1000);
+  account.Release(2000);
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
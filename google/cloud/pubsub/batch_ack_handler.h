@@ -0,0 +1,73 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_BATCH_ACK_HANDLER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_BATCH_ACK_HANDLER_H
+
+#include "google/cloud/pubsub/ack_handler.h"
+#include "google/cloud/pubsub/version.h"
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * Acknowledges or rejects a batch of messages.
+ *
+ * Applications that receive messages in batches, via
+ * `Subscriber::SubscribeBatch()`, receive one of these objects with each
+ * batch. The handler for the i-th message in the batch is at position i.
+ *
+ * Applications can acknowledge (or reject) all the messages with a single
+ * call, or release the individual handlers and act on each message separately.
+ * Any messages that are not acknowledged when the object is destroyed are
+ * rejected, as with `AckHandler`.
+ *
+ * @par Thread Safety
+ * This class is *thread compatible*, only one thread should call non-const
+ * member functions of this class at a time.
+ */
+class BatchAckHandler {
+ public:
+  BatchAckHandler() = default;
+  explicit BatchAckHandler(std::vector<AckHandler> handlers)
+      : handlers_(std::move(handlers)) {}
+
+  BatchAckHandler(BatchAckHandler&&) noexcept = default;
+  BatchAckHandler& operator=(BatchAckHandler&&) noexcept = default;
+
+  /// Acknowledges all the messages in the batch.
+  void ack() &&;
+
+  /// Rejects all the messages in the batch.
+  void nack() &&;
+
+  /// The number of messages in the batch.
+  std::size_t size() const { return handlers_.size(); }
+
+  /// Returns the handlers for each message, to ack or nack them individually.
+  std::vector<AckHandler> Release() && { return std::move(handlers_); }
+
+ private:
+  std::vector<AckHandler> handlers_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_BATCH_ACK_HANDLER_H
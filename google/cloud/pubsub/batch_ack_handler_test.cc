@@ -0,0 +1,73 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/batch_ack_handler.h"
+#include "google/cloud/pubsub/mocks/mock_ack_handler.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace pubsub {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+std::vector<AckHandler> MakeHandlers(int count, char const* expected) {
+  std::vector<AckHandler> handlers;
+  for (int i = 0; i != count; ++i) {
+    auto mock = absl::make_unique<pubsub_mocks::MockAckHandler>();
+    if (std::string(expected) == "ack") {
+      EXPECT_CALL(*mock, ack()).Times(1);
+    } else {
+      EXPECT_CALL(*mock, nack()).Times(1);
+    }
+    handlers.emplace_back(std::move(mock));
+  }
+  return handlers;
+}
+
+TEST(BatchAckHandlerTest, Ack) {
+  BatchAckHandler handler(MakeHandlers(3, "ack"));
+  EXPECT_EQ(3, handler.size());
+  std::move(handler).ack();
+}
+
+TEST(BatchAckHandlerTest, Nack) {
+  BatchAckHandler handler(MakeHandlers(3, "nack"));
+  std::move(handler).nack();
+}
+
+TEST(BatchAckHandlerTest, AutoNack) {
+  { BatchAckHandler handler(MakeHandlers(3, "nack")); }
+}
+
+TEST(BatchAckHandlerTest, Release) {
+  auto handlers = MakeHandlers(2, "ack");
+  auto mock = absl::make_unique<pubsub_mocks::MockAckHandler>();
+  EXPECT_CALL(*mock, nack()).Times(1);
+  handlers.emplace_back(std::move(mock));
+
+  BatchAckHandler handler(std::move(handlers));
+  auto released = std::move(handler).Release();
+  ASSERT_EQ(3, released.size());
+  std::move(released[0]).ack();
+  std::move(released[1]).ack();
+  std::move(released[2]).nack();
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub
+}  // namespace cloud
+}  // namespace google
@@ -23,13 +23,19 @@
 #include "google/cloud/testing_util/command_line_parsing.h"
 #include "google/cloud/testing_util/timer.h"
 #include "absl/strings/str_format.h"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cinttypes>
+#include <cmath>
 #include <functional>
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <vector>
+#if GOOGLE_CLOUD_CPP_HAVE_GETRUSAGE
+#include <sys/resource.h>
+#endif  // GOOGLE_CLOUD_CPP_HAVE_GETRUSAGE
 
 namespace {
 namespace pubsub = ::google::cloud::pubsub;
@@ -44,9 +50,23 @@ auto constexpr kDescription = R"""(
 A throughput vs. CPU benchmark for the Cloud Pub/Sub C++ client library.
 
 Measure the throughput for publishers and/or subscribers in the Cloud Pub/Sub
-C++ client library.
+C++ client library. The benchmark also reports the publish latency, the
+end-to-end (publish to receive) latency, the CPU time per message, and the
+memory high-water mark of the process.
+
+Some publisher and subscriber options accept a comma-separated list of values,
+the benchmark runs once for each combination of these values.
 )""";
 
+/// The values for each option in a sweep, empty lists use the default value.
+struct Sweep {
+  std::vector<int> publisher_max_batch_size;
+  std::vector<std::int64_t> publisher_max_batch_bytes;
+  std::vector<int> subscriber_max_outstanding_messages;
+  std::vector<std::int64_t> subscriber_max_outstanding_bytes;
+  std::vector<int> subscriber_max_concurrency;
+};
+
 struct Config {
   std::string endpoint;
   std::string project_id;
@@ -79,11 +99,19 @@ struct Config {
   std::chrono::seconds minimum_runtime = std::chrono::seconds(5);
   std::chrono::seconds maximum_runtime = std::chrono::seconds(300);
 
+  Sweep sweep;
+  int sweep_point = 0;
+
   bool show_help = false;
 };
 
 void Print(std::ostream& os, Config const&);
 
+/// Returns one `Config` for each combination of the values in `config.sweep`.
+std::vector<Config> ExpandSweep(Config const& config);
+
+void PrintSweepPoint(std::ostream& os, Config const& config);
+
 StatusOr<Config> ParseArgs(std::vector<std::string> args);
 
 class Cleanup {
@@ -154,17 +182,21 @@ int main(int argc, char* argv[]) {
 
   auto const topic = pubsub::Topic(config->project_id, config->topic_id);
 
-  std::cout << "timestamp,elapsed(us),op,iteration,count,msgs/s,bytes,MB/s"
-            << std::endl;
+  std::cout << "timestamp,elapsed(us),op,sweep_point,iteration,count,msgs/s"
+            << ",bytes,MB/s,cpu(us)/msg,maxrss(KiB)"
+            << ",p50(us),p90(us),p99(us),p99.9(us)" << std::endl;
 
-  std::vector<std::thread> tasks;
-  if (config->publisher) {
-    tasks.emplace_back(PublisherTask, *config);
-  }
-  if (config->subscriber) {
-    tasks.emplace_back(SubscriberTask, *config);
+  for (auto const& point : ExpandSweep(*config)) {
+    PrintSweepPoint(std::cout, point);
+    std::vector<std::thread> tasks;
+    if (point.publisher) {
+      tasks.emplace_back(PublisherTask, point);
+    }
+    if (point.subscriber) {
+      tasks.emplace_back(SubscriberTask, point);
+    }
+    for (auto& t : tasks) t.join();
   }
-  for (auto& t : tasks) t.join();
 
   return 0;
 }
@@ -172,6 +204,7 @@ int main(int argc, char* argv[]) {
 namespace {
 
 using ::google::cloud::pubsub_internal::MessageSize;
+using ::google::cloud::pubsub_internal::ToProto;
 using ::google::cloud::testing_util::Timer;
 
 std::mutex cout_mu;
@@ -190,8 +223,112 @@ std::string Timestamp() {
       std::chrono::system_clock::now());
 }
 
-void PrintResult(std::string const& operation, int iteration,
-                 std::int64_t count, std::int64_t bytes, Timer const& usage) {
+/// The time since the epoch, used to compute the end-to-end latency.
+std::int64_t TimestampMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * The CPU time and memory high-water mark for the process.
+ *
+ * The publisher and subscriber threads are not the only threads consuming CPU,
+ * the library's background threads do most of the work. We use the usage for
+ * the whole process, which includes both roles when they run in the same
+ * program.
+ */
+struct ProcessUsage {
+  std::chrono::microseconds cpu_time{0};
+  std::int64_t max_rss_kib = 0;
+};
+
+ProcessUsage GetProcessUsage() {
+  ProcessUsage usage;
+#if GOOGLE_CLOUD_CPP_HAVE_GETRUSAGE
+  auto as_usec = [](timeval const& tv) {
+    return std::chrono::microseconds(std::chrono::seconds(tv.tv_sec)) +
+           std::chrono::microseconds(tv.tv_usec);
+  };
+  struct rusage ru {};
+  (void)getrusage(RUSAGE_SELF, &ru);
+  usage.cpu_time = as_usec(ru.ru_utime) + as_usec(ru.ru_stime);
+  usage.max_rss_kib = ru.ru_maxrss;
+#endif  // GOOGLE_CLOUD_CPP_HAVE_GETRUSAGE
+  return usage;
+}
+
+/**
+ * A latency histogram, safe to update from many threads.
+ *
+ * The subscriber may receive millions of messages per second, a mutex-guarded
+ * list of samples would become the bottleneck. Instead we count the samples
+ * in fixed-width buckets, and compute the percentiles for each iteration from
+ * the difference between two snapshots.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram() : counts_(kBucketCount) {}
+
+  void Record(std::int64_t latency_us) {
+    auto const b = (std::max)(std::int64_t{0}, latency_us) / kBucketWidthUs;
+    auto const index =
+        (std::min)(static_cast<std::size_t>(b), counts_.size() - 1);
+    counts_[index].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::vector<std::int64_t> Snapshot() const {
+    std::vector<std::int64_t> result(counts_.size());
+    std::transform(counts_.begin(), counts_.end(), result.begin(),
+                   [](std::atomic<std::int64_t> const& c) { return c.load(); });
+    return result;
+  }
+
+ private:
+  // Buckets of 100us, up to 10s. Larger values are counted in the last bucket.
+  static std::int64_t constexpr kBucketWidthUs = 100;
+  static std::size_t constexpr kBucketCount = 100 * 1000;
+
+  std::vector<std::atomic<std::int64_t>> counts_;
+
+  friend std::string FormatPercentiles(std::vector<std::int64_t> const&,
+                                       std::vector<std::int64_t> const&);
+};
+
+std::int64_t constexpr LatencyHistogram::kBucketWidthUs;
+
+/// Format the p50, p90, p99, and p99.9 latency between two snapshots as CSV.
+std::string FormatPercentiles(std::vector<std::int64_t> const& start,
+                              std::vector<std::int64_t> const& end) {
+  std::vector<std::int64_t> counts(end.size());
+  std::transform(end.begin(), end.end(), start.begin(), counts.begin(),
+                 std::minus<std::int64_t>());
+  auto const total =
+      std::accumulate(counts.begin(), counts.end(), std::int64_t{0});
+  if (total == 0) return ",,,";
+  std::ostringstream os;
+  char const* sep = "";
+  for (auto const p : {0.50, 0.90, 0.99, 0.999}) {
+    auto const rank =
+        static_cast<std::int64_t>(std::ceil(p * static_cast<double>(total)));
+    std::int64_t seen = 0;
+    std::size_t i = 0;
+    for (; i != counts.size(); ++i) {
+      seen += counts[i];
+      if (seen >= rank) break;
+    }
+    // Report the upper bound of the bucket.
+    os << sep << (static_cast<std::int64_t>(i) + 1) *
+                     LatencyHistogram::kBucketWidthUs;
+    sep = ",";
+  }
+  return std::move(os).str();
+}
+
+void PrintResult(Config const& config, std::string const& operation,
+                 int iteration, std::int64_t count, std::int64_t bytes,
+                 Timer const& usage, ProcessUsage const& start,
+                 ProcessUsage const& end, std::string const& percentiles) {
   using std::chrono::duration_cast;
   using std::chrono::microseconds;
   using std::chrono::seconds;
@@ -203,10 +340,17 @@ void PrintResult(std::string const& operation, int iteration,
   auto const msgs =
       absl::StrFormat("%.02f", static_cast<double>(count) * 1000000.0 /
                                    static_cast<double>(elapsed_us.count()));
+  auto const cpu = (end.cpu_time - start.cpu_time).count();
+  auto const cpu_per_message = absl::StrFormat(
+      "%.02f",
+      count == 0 ? 0.0
+                 : static_cast<double>(cpu) / static_cast<double>(count));
   std::lock_guard<std::mutex> lk(cout_mu);
   std::cout << Timestamp() << ',' << elapsed_us.count() << ',' << operation
-            << ',' << iteration << ',' << count << ',' << msgs << ',' << bytes
-            << ',' << mbs << std::endl;
+            << ',' << config.sweep_point << ',' << iteration << ',' << count
+            << ',' << msgs << ',' << bytes << ',' << mbs << ','
+            << cpu_per_message << ',' << end.max_rss_kib << ',' << percentiles
+            << std::endl;
 }
 
 pubsub::Publisher CreatePublisher(Config const& config) {
@@ -238,6 +382,10 @@ std::atomic<std::int64_t> send_bytes{0};
 std::atomic<std::int64_t> ack_count{0};
 std::atomic<std::int64_t> ack_bytes{0};
 std::atomic<std::int64_t> error_count{0};
+// The time from `Publish()` to its future being satisfied.
+LatencyHistogram publish_latency;
+// The time from `Publish()` to the subscriber receiving the message.
+LatencyHistogram end_to_end_latency;
 
 /// Run a single thread publishing events
 class PublishWorker {
@@ -279,11 +427,11 @@ class PublishWorker {
     auto const start = std::chrono::steady_clock::now();
     auto pacing_time = start + pacing_period;
     for (std::int64_t i = 0; NotShutdownAndReady(); ++i) {
-      auto const elapsed =
-          duration_cast<std::chrono::microseconds>(steady_clock::now() - start);
+      // Use the system clock, the subscriber may run in a different host.
+      auto const send_time = TimestampMicroseconds();
       auto message = pubsub::MessageBuilder{}
                          .SetAttributes({
-                             {"sendTime", std::to_string(elapsed.count())},
+                             {"sendTime", std::to_string(send_time)},
                              {"clientId", std::to_string(id_)},
                              {"sequenceNumber", std::to_string(i)},
                          })
@@ -291,7 +439,8 @@ class PublishWorker {
                          .Build();
       auto const bytes = MessageSize(message);
       publisher.Publish(std::move(message))
-          .then([this, bytes](future<StatusOr<std::string>> f) {
+          .then([this, bytes, send_time](future<StatusOr<std::string>> f) {
+            publish_latency.Record(TimestampMicroseconds() - send_time);
             ++ack_count;
             ack_bytes.fetch_add(bytes);
             if (!f.get()) ++error_count;
@@ -355,6 +504,13 @@ class PublishWorker {
 };
 
 void PublisherTask(Config const& config) {
+  // Each sweep point reports its own totals.
+  send_count = 0;
+  send_bytes = 0;
+  ack_count = 0;
+  ack_bytes = 0;
+  error_count = 0;
+
   std::vector<std::shared_ptr<PublishWorker>> workers;
   int task_id = 0;
   std::generate_n(
@@ -375,14 +531,21 @@ void PublisherTask(Config const& config) {
     auto const start_send_bytes = send_bytes.load();
     auto const start_ack_count = ack_count.load();
     auto const start_ack_bytes = ack_bytes.load();
+    auto const start_latency = publish_latency.Snapshot();
+    auto const start_usage = GetProcessUsage();
     std::this_thread::sleep_for(config.iteration_duration);
     auto const send_count_last = send_count.load() - start_send_count;
     auto const send_bytes_last = send_bytes.load() - start_send_bytes;
     auto const ack_count_last = ack_count.load() - start_ack_count;
     auto const ack_bytes_last = ack_bytes.load() - start_ack_bytes;
+    auto const end_usage = GetProcessUsage();
+    auto const percentiles =
+        FormatPercentiles(start_latency, publish_latency.Snapshot());
     usage.Stop();
-    PrintResult("Pub", i, send_count_last, send_bytes_last, usage);
-    PrintResult("Ack", i, ack_count_last, ack_bytes_last, usage);
+    PrintResult(config, "Pub", i, send_count_last, send_bytes_last, usage,
+                start_usage, end_usage, ",,,");
+    PrintResult(config, "Ack", i, ack_count_last, ack_bytes_last, usage,
+                start_usage, end_usage, percentiles);
   }
 
   for (auto& w : workers) w->Shutdown();
@@ -438,8 +601,15 @@ void SubscriberTask(Config const& config) {
   std::atomic<std::int64_t> received_bytes{0};
   auto handler = [&received_count, &received_bytes](pubsub::Message const& m,
                                                     pubsub::AckHandler h) {
+    auto const now = TimestampMicroseconds();
     ++received_count;
     received_bytes.fetch_add(MessageSize(m));
+    // Avoid copying the attributes, this is in the critical path.
+    auto const& attributes = ToProto(m).attributes();
+    auto const l = attributes.find("sendTime");
+    if (l != attributes.end()) {
+      end_to_end_latency.Record(now - std::stoll(l->second));
+    }
     std::move(h).ack();
   };
 
@@ -455,11 +625,17 @@ void SubscriberTask(Config const& config) {
     usage.Start();
     auto const start_count = received_count.load();
     auto const start_bytes = received_bytes.load();
+    auto const start_latency = end_to_end_latency.Snapshot();
+    auto const start_usage = GetProcessUsage();
     std::this_thread::sleep_for(config.iteration_duration);
     auto const count = received_count.load() - start_count;
     auto const bytes = received_bytes.load() - start_bytes;
+    auto const end_usage = GetProcessUsage();
+    auto const percentiles =
+        FormatPercentiles(start_latency, end_to_end_latency.Snapshot());
     usage.Stop();
-    PrintResult("Sub", i, count, bytes, usage);
+    PrintResult(config, "Sub", i, count, bytes, usage, start_usage, end_usage,
+                percentiles);
   }
   for (auto& s : sessions) s.cancel();
   Status last_status;
@@ -504,6 +680,58 @@ void PrintSubscriber(std::ostream& os, Config const& config) {
      << "\n# Subscriber Max Concurrency: " << config.subscriber_max_concurrency;
 }
 
+template <typename T, typename Setter>
+std::vector<Config> ExpandOne(std::vector<Config> points,
+                              std::vector<T> const& values, Setter setter) {
+  if (values.empty()) return points;
+  std::vector<Config> result;
+  for (auto const& p : points) {
+    for (auto const& v : values) {
+      result.push_back(p);
+      setter(result.back(), v);
+    }
+  }
+  return result;
+}
+
+std::vector<Config> ExpandSweep(Config const& config) {
+  auto const& sweep = config.sweep;
+  std::vector<Config> points{config};
+  points = ExpandOne(points, sweep.publisher_max_batch_size,
+                     [](Config& c, int v) { c.publisher_max_batch_size = v; });
+  points = ExpandOne(
+      points, sweep.publisher_max_batch_bytes,
+      [](Config& c, std::int64_t v) { c.publisher_max_batch_bytes = v; });
+  points = ExpandOne(points, sweep.subscriber_max_outstanding_messages,
+                     [](Config& c, int v) {
+                       c.subscriber_max_outstanding_messages = v;
+                     });
+  points = ExpandOne(points, sweep.subscriber_max_outstanding_bytes,
+                     [](Config& c, std::int64_t v) {
+                       c.subscriber_max_outstanding_bytes = v;
+                     });
+  points = ExpandOne(
+      points, sweep.subscriber_max_concurrency,
+      [](Config& c, int v) { c.subscriber_max_concurrency = v; });
+  int index = 0;
+  for (auto& p : points) p.sweep_point = index++;
+  return points;
+}
+
+void PrintSweepPoint(std::ostream& os, Config const& config) {
+  std::lock_guard<std::mutex> lk(cout_mu);
+  os << "# Sweep point " << config.sweep_point
+     << ": publisher-max-batch-size=" << config.publisher_max_batch_size
+     << ", publisher-max-batch-bytes="
+     << FormatSize(config.publisher_max_batch_bytes)
+     << ", subscriber-max-outstanding-messages="
+     << config.subscriber_max_outstanding_messages
+     << ", subscriber-max-outstanding-bytes="
+     << FormatSize(config.subscriber_max_outstanding_bytes)
+     << ", subscriber-max-concurrency=" << config.subscriber_max_concurrency
+     << std::endl;
+}
+
 void Print(std::ostream& os, Config const& config) {
   os << "# Running Cloud Pub/Sub experiment"
      << "\n# Start time: "
@@ -528,6 +756,21 @@ using ::google::cloud::testing_util::ParseBoolean;
 using ::google::cloud::testing_util::ParseDuration;
 using ::google::cloud::testing_util::ParseSize;
 
+int ParseInt(std::string const& val) { return std::stoi(val); }
+
+/// Parse a comma-separated list of values, such as `1,10,100`.
+template <typename Parser>
+auto ParseList(std::string const& val, Parser parser)
+    -> std::vector<decltype(parser(val))> {
+  std::vector<decltype(parser(val))> result;
+  std::istringstream is(val);
+  std::string item;
+  while (std::getline(is, item, ',')) {
+    if (!item.empty()) result.push_back(parser(item));
+  }
+  return result;
+}
+
 google::cloud::StatusOr<Config> ParseArgsImpl(std::vector<std::string> args,
                                               std::string const& description) {
   Config options;
@@ -580,13 +823,15 @@ google::cloud::StatusOr<Config> ParseArgsImpl(std::vector<std::string> args,
        [&options](std::string const& val) {
          options.publisher_io_channels = std::stoi(val);
        }},
-      {"--publisher-max-batch-size", "configure batching parameters",
+      {"--publisher-max-batch-size",
+       "configure batching parameters, accepts a list of values to sweep",
        [&options](std::string const& val) {
-         options.publisher_max_batch_size = std::stoi(val);
+         options.sweep.publisher_max_batch_size = ParseList(val, ParseInt);
        }},
-      {"--publisher-max-batch-bytes", "configure batching parameters",
+      {"--publisher-max-batch-bytes",
+       "configure batching parameters, accepts a list of values to sweep",
        [&options](std::string const& val) {
-         options.publisher_max_batch_bytes = ParseSize(val);
+         options.sweep.publisher_max_batch_bytes = ParseList(val, ParseSize);
        }},
       {"--publisher-pending-lwm",
        "message generation flow control, maximum size of messages with a "
@@ -629,17 +874,21 @@ google::cloud::StatusOr<Config> ParseArgsImpl(std::vector<std::string> args,
          options.subscriber_io_channels = std::stoi(val);
        }},
       {"--subscriber-max-outstanding-messages",
-       "configure message flow control",
+       "configure message flow control, accepts a list of values to sweep",
        [&options](std::string const& val) {
-         options.subscriber_max_outstanding_messages = std::stoi(val);
+         options.sweep.subscriber_max_outstanding_messages =
+             ParseList(val, ParseInt);
        }},
-      {"--subscriber-max-outstanding-bytes", "configure message flow control",
+      {"--subscriber-max-outstanding-bytes",
+       "configure message flow control, accepts a list of values to sweep",
        [&options](std::string const& val) {
-         options.subscriber_max_outstanding_bytes = ParseSize(val);
+         options.sweep.subscriber_max_outstanding_bytes =
+             ParseList(val, ParseSize);
        }},
-      {"--subscriber-max-concurrency", "configure message flow control",
+      {"--subscriber-max-concurrency",
+       "configure message flow control, accepts a list of values to sweep",
        [&options](std::string const& val) {
-         options.subscriber_max_concurrency = std::stoi(val);
+         options.sweep.subscriber_max_concurrency = ParseList(val, ParseInt);
        }},
 
       {"--minimum-samples", "minimum number of samples to capture",
@@ -713,7 +962,7 @@ google::cloud::StatusOr<Config> SelfTest(std::string const& cmd) {
           "--publisher-thread-count=1",
           "--publisher-io-threads=1",
           "--publisher-io-channels=1",
-          "--publisher-max-batch-size=2",
+          "--publisher-max-batch-size=2,4",
           "--publisher-max-batch-bytes=1KiB",
           "--publisher-pending-lwm=8MiB",
           "--publisher-pending-hwm=10MiB",
@@ -20,14 +20,22 @@ google_cloud_cpp_pubsub_hdrs = [
     "ack_handler.h",
     "application_callback.h",
     "backoff_policy.h",
+    "batch_ack_handler.h",
     "connection_options.h",
     "internal/batch_sink.h",
     "internal/batching_publisher_connection.h",
+    "internal/concurrency_limited_batch_sink.h",
     "internal/create_channel.h",
+    "internal/deduplicating_batch_source.h",
     "internal/default_batch_sink.h",
     "internal/default_retry_policies.h",
     "internal/emulator_overrides.h",
+    "internal/flow_controlled_publisher_connection.h",
+    "internal/flush_scheduler.h",
+    "internal/multiplexed_batch_source.h",
     "internal/ordering_key_publisher_connection.h",
+    "internal/processing_time_distribution.h",
+    "internal/publisher_fault_injection.h",
     "internal/publisher_logging.h",
     "internal/publisher_metadata.h",
     "internal/publisher_round_robin.h",
@@ -35,7 +43,10 @@ google_cloud_cpp_pubsub_hdrs = [
     "internal/rejects_with_ordering_key.h",
     "internal/sequential_batch_sink.h",
     "internal/session_shutdown_manager.h",
+    "internal/shared_background_threads.h",
     "internal/streaming_subscription_batch_source.h",
+    "internal/stub_pool.h",
+    "internal/subscriber_fault_injection.h",
     "internal/subscriber_logging.h",
     "internal/subscriber_metadata.h",
     "internal/subscriber_round_robin.h",
@@ -48,6 +59,7 @@ google_cloud_cpp_pubsub_hdrs = [
     "internal/subscription_session.h",
     "internal/user_agent_prefix.h",
     "message.h",
+    "multi_topic_publisher.h",
     "publisher.h",
     "publisher_connection.h",
     "publisher_options.h",
@@ -56,6 +68,7 @@ google_cloud_cpp_pubsub_hdrs = [
     "snapshot_builder.h",
     "subscriber.h",
     "subscriber_connection.h",
+    "subscriber_metrics.h",
     "subscriber_options.h",
     "subscription.h",
     "subscription_admin_client.h",
@@ -71,13 +84,21 @@ google_cloud_cpp_pubsub_hdrs = [
 
 google_cloud_cpp_pubsub_srcs = [
     "ack_handler.cc",
+    "batch_ack_handler.cc",
     "connection_options.cc",
     "internal/batching_publisher_connection.cc",
+    "internal/concurrency_limited_batch_sink.cc",
     "internal/create_channel.cc",
+    "internal/deduplicating_batch_source.cc",
     "internal/default_batch_sink.cc",
     "internal/default_retry_policies.cc",
     "internal/emulator_overrides.cc",
+    "internal/flow_controlled_publisher_connection.cc",
+    "internal/flush_scheduler.cc",
+    "internal/multiplexed_batch_source.cc",
     "internal/ordering_key_publisher_connection.cc",
+    "internal/processing_time_distribution.cc",
+    "internal/publisher_fault_injection.cc",
     "internal/publisher_logging.cc",
     "internal/publisher_metadata.cc",
     "internal/publisher_round_robin.cc",
@@ -85,7 +106,10 @@ google_cloud_cpp_pubsub_srcs = [
     "internal/rejects_with_ordering_key.cc",
     "internal/sequential_batch_sink.cc",
     "internal/session_shutdown_manager.cc",
+    "internal/shared_background_threads.cc",
     "internal/streaming_subscription_batch_source.cc",
+    "internal/stub_pool.cc",
+    "internal/subscriber_fault_injection.cc",
     "internal/subscriber_logging.cc",
     "internal/subscriber_metadata.cc",
     "internal/subscriber_round_robin.cc",
@@ -96,12 +120,14 @@ google_cloud_cpp_pubsub_srcs = [
     "internal/subscription_session.cc",
     "internal/user_agent_prefix.cc",
     "message.cc",
+    "multi_topic_publisher.cc",
     "publisher.cc",
     "publisher_connection.cc",
     "publisher_options.cc",
     "snapshot.cc",
     "snapshot_builder.cc",
     "subscriber_connection.cc",
+    "subscriber_metrics.cc",
     "subscriber_options.cc",
     "subscription.cc",
     "subscription_admin_client.cc",
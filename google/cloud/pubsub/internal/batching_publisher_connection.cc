@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "google/cloud/pubsub/internal/batching_publisher_connection.h"
+#include "google/cloud/instrumentation.h"
+#include "google/cloud/internal/async_batch_completion.h"
 
 namespace google {
 namespace cloud {
@@ -114,14 +116,8 @@ void BatchingPublisherConnection::HandleError(Status const& status) {
   std::vector<promise<StatusOr<std::string>>> waiters;
   waiters.swap(waiters_);
   lk.unlock();
-  for (auto& p : waiters) {
-    struct MoveCapture {
-      promise<StatusOr<std::string>> p;
-      Status status;
-      void operator()() { p.set_value(std::move(status)); }
-    };
-    cq_.RunAsync(MoveCapture{std::move(p), status});
-  }
+  google::cloud::internal::AsyncSetValues(cq_, std::move(waiters),
+                                          StatusOr<std::string>(status));
 }
 
 void BatchingPublisherConnection::MaybeFlush(std::unique_lock<std::mutex> lk) {
@@ -144,6 +140,12 @@ void BatchingPublisherConnection::MaybeFlush(std::unique_lock<std::mutex> lk) {
   // cycle.  Unfortunately some older compiler/libraries lack
   // `weak_from_this()`.
   auto weak = std::weak_ptr<BatchingPublisherConnection>(shared_from_this());
+  if (flush_scheduler_) {
+    flush_scheduler_->Schedule(expiration, [weak] {
+      if (auto self = weak.lock()) self->OnTimer();
+    });
+    return;
+  }
   // Note that at this point the lock is released, so whether the timer
   // schedules later on schedules in this thread has no effect.
   cq_.MakeDeadlineTimer(expiration)
@@ -192,6 +194,8 @@ void BatchingPublisherConnection::FlushImpl(std::unique_lock<std::mutex> lk) {
 
   batch.weak = shared_from_this();
   request.set_topic(topic_full_name_);
+  google::cloud::internal::RecordValue("pubsub.publisher.batch_size",
+                                       request.messages_size());
   sink_->AsyncPublish(std::move(request)).then(std::move(batch));
 }
 
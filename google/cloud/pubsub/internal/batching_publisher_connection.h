@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_BATCHING_PUBLISHER_CONNECTION_H
 
 #include "google/cloud/pubsub/internal/batch_sink.h"
+#include "google/cloud/pubsub/internal/flush_scheduler.h"
 #include "google/cloud/pubsub/publisher_connection.h"
 #include "google/cloud/pubsub/version.h"
 #include <memory>
@@ -33,11 +34,12 @@ class BatchingPublisherConnection
   static std::shared_ptr<BatchingPublisherConnection> Create(
       pubsub::Topic topic, pubsub::PublisherOptions options,
       std::string ordering_key, std::shared_ptr<BatchSink> sink,
-      google::cloud::CompletionQueue cq) {
+      google::cloud::CompletionQueue cq,
+      std::shared_ptr<FlushScheduler> flush_scheduler = {}) {
     return std::shared_ptr<BatchingPublisherConnection>(
-        new BatchingPublisherConnection(std::move(topic), std::move(options),
-                                        std::move(ordering_key),
-                                        std::move(sink), std::move(cq)));
+        new BatchingPublisherConnection(
+            std::move(topic), std::move(options), std::move(ordering_key),
+            std::move(sink), std::move(cq), std::move(flush_scheduler)));
   }
 
   future<StatusOr<std::string>> Publish(PublishParams p) override;
@@ -51,13 +53,15 @@ class BatchingPublisherConnection
                                        pubsub::PublisherOptions options,
                                        std::string ordering_key,
                                        std::shared_ptr<BatchSink> sink,
-                                       google::cloud::CompletionQueue cq)
+                                       google::cloud::CompletionQueue cq,
+                                       std::shared_ptr<FlushScheduler> fs)
       : topic_(std::move(topic)),
         topic_full_name_(topic_.FullName()),
         options_(std::move(options)),
         ordering_key_(std::move(ordering_key)),
         sink_(std::move(sink)),
-        cq_(std::move(cq)) {}
+        cq_(std::move(cq)),
+        flush_scheduler_(std::move(fs)) {}
 
   void OnTimer();
   future<StatusOr<std::string>> CorkedError();
@@ -72,6 +76,7 @@ class BatchingPublisherConnection
   std::string const ordering_key_;
   std::shared_ptr<BatchSink> const sink_;
   google::cloud::CompletionQueue cq_;
+  std::shared_ptr<FlushScheduler> const flush_scheduler_;
 
   std::mutex mu_;
   std::vector<promise<StatusOr<std::string>>> waiters_;
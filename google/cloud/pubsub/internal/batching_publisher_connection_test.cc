@@ -108,6 +108,35 @@ TEST(BatchingPublisherConnectionTest, DefaultMakesProgress) {
   for (auto& p : published) p.get();
 }
 
+TEST(BatchingPublisherConnectionTest, PayloadIsNotCopied) {
+  auto mock = std::make_shared<pubsub_testing::MockBatchSink>();
+  pubsub::Topic const topic("test-project", "test-topic");
+
+  // Use a payload large enough to avoid the small string optimization.
+  std::string payload(1024 * 1024, 'x');
+  auto const* buffer = payload.data();
+  EXPECT_CALL(*mock, AsyncPublish)
+      .WillOnce([&](google::pubsub::v1::PublishRequest const& request) {
+        EXPECT_EQ(1, request.messages_size());
+        EXPECT_EQ(buffer, request.messages(0).data().data());
+        google::pubsub::v1::PublishResponse response;
+        response.add_message_ids("test-message-id-0");
+        return make_ready_future(make_status_or(response));
+      });
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto publisher = BatchingPublisherConnection::Create(
+      topic, pubsub::PublisherOptions{}.set_maximum_batch_message_count(1),
+      std::string{}, mock, background.cq());
+  auto r = publisher
+               ->Publish({pubsub::MessageBuilder{}
+                              .SetData(std::move(payload))
+                              .Build()})
+               .get();
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ("test-message-id-0", *r);
+}
+
 TEST(BatchingPublisherConnectionTest, BatchByMessageCount) {
   auto mock = std::make_shared<pubsub_testing::MockBatchSink>();
   pubsub::Topic const topic("test-project", "test-topic");
@@ -462,6 +491,60 @@ TEST(BatchingPublisherConnectionTest, BatchByMaximumHoldTime) {
   t.join();
 }
 
+TEST(BatchingPublisherConnectionTest, BatchByMaximumHoldTimeShared) {
+  auto mock = std::make_shared<pubsub_testing::MockBatchSink>();
+  pubsub::Topic const topic("test-project", "test-topic");
+
+  std::mutex mu;
+  std::vector<std::string> keys;
+  EXPECT_CALL(*mock, AsyncPublish)
+      .Times(2)
+      .WillRepeatedly([&](google::pubsub::v1::PublishRequest const& request) {
+        EXPECT_EQ(2, request.messages_size());
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          keys.push_back(request.messages(0).ordering_key());
+        }
+        return make_ready_future(make_status_or(MakeResponse(request)));
+      });
+  EXPECT_CALL(*mock, ResumePublish).Times(0);
+
+  // Start with an inactive message queue, to avoid flakes due to scheduling
+  // problems.
+  CompletionQueue cq;
+  auto scheduler = FlushScheduler::Create(cq);
+  auto const options = pubsub::PublisherOptions{}
+                           .set_maximum_hold_time(std::chrono::milliseconds(5))
+                           .set_maximum_batch_message_count(4);
+  auto p0 = BatchingPublisherConnection::Create(topic, options, "key-0", mock,
+                                                cq, scheduler);
+  auto p1 = BatchingPublisherConnection::Create(topic, options, "key-1", mock,
+                                                cq, scheduler);
+  std::vector<future<StatusOr<std::string>>> results;
+  auto publish = [&](std::shared_ptr<BatchingPublisherConnection> const& p,
+                     std::string const& key) {
+    auto m = pubsub::MessageBuilder{}.SetData("data").SetOrderingKey(key);
+    results.push_back(p->Publish({std::move(m).Build()}));
+  };
+  publish(p0, "key-0");
+  publish(p1, "key-1");
+  publish(p0, "key-0");
+  publish(p1, "key-1");
+  // Both ordering keys share the same scheduler.
+  EXPECT_EQ(2, scheduler->pending());
+
+  std::thread t{[](CompletionQueue cq) { cq.Run(); }, cq};
+  for (auto& r : results) EXPECT_STATUS_OK(r.get());
+  EXPECT_EQ(0, scheduler->pending());
+  {
+    std::lock_guard<std::mutex> lk(mu);
+    EXPECT_THAT(keys, ::testing::UnorderedElementsAre("key-0", "key-1"));
+  }
+
+  cq.Shutdown();
+  t.join();
+}
+
 TEST(BatchingPublisherConnectionTest, BatchByFlush) {
   auto mock = std::make_shared<pubsub_testing::MockBatchSink>();
   pubsub::Topic const topic("test-project", "test-topic");
@@ -0,0 +1,79 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/concurrency_limited_batch_sink.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+ConcurrencyLimitedBatchSink::ConcurrencyLimitedBatchSink(
+    std::shared_ptr<BatchSink> sink, std::size_t maximum_concurrency)
+    : sink_(std::move(sink)),
+      maximum_concurrency_((std::max)(maximum_concurrency, std::size_t{1})) {}
+
+future<StatusOr<google::pubsub::v1::PublishResponse>>
+ConcurrencyLimitedBatchSink::AsyncPublish(
+    google::pubsub::v1::PublishRequest request) {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (in_flight_ >= maximum_concurrency_) {
+    queue_.push_back({std::move(request), {}});
+    return queue_.back().promise.get_future();
+  }
+  ++in_flight_;
+  lk.unlock();
+  return Send(std::move(request));
+}
+
+void ConcurrencyLimitedBatchSink::ResumePublish(
+    std::string const& ordering_key) {
+  sink_->ResumePublish(ordering_key);
+}
+
+future<StatusOr<google::pubsub::v1::PublishResponse>>
+ConcurrencyLimitedBatchSink::Send(google::pubsub::v1::PublishRequest request) {
+  auto weak = std::weak_ptr<ConcurrencyLimitedBatchSink>(shared_from_this());
+  return sink_->AsyncPublish(std::move(request))
+      .then([weak](future<StatusOr<PublishResponse>> f) {
+        if (auto self = weak.lock()) self->OnPublish();
+        return f.get();
+      });
+}
+
+void ConcurrencyLimitedBatchSink::OnPublish() {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (queue_.empty()) {
+    --in_flight_;
+    return;
+  }
+  // Reuse the slot released by the completed request.
+  auto pr = std::move(queue_.front());
+  queue_.pop_front();
+  lk.unlock();
+
+  struct MoveCapture {
+    google::cloud::promise<StatusOr<PublishResponse>> promise;
+    void operator()(future<StatusOr<PublishResponse>> f) {
+      promise.set_value(f.get());
+    }
+  };
+  Send(std::move(pr.request)).then(MoveCapture{std::move(pr.promise)});
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
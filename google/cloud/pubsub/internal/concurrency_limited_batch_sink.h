@@ -0,0 +1,85 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_CONCURRENCY_LIMITED_BATCH_SINK_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_CONCURRENCY_LIMITED_BATCH_SINK_H
+
+#include "google/cloud/pubsub/internal/batch_sink.h"
+#include "google/cloud/pubsub/version.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * Limit the number of concurrent requests sent to a child sink.
+ *
+ * Batches beyond the limit wait in a queue, and are sent, in the order they
+ * were received, as previous requests complete. Unlike `SequentialBatchSink`
+ * errors have no effect on the other batches.
+ */
+class ConcurrencyLimitedBatchSink
+    : public BatchSink,
+      public std::enable_shared_from_this<ConcurrencyLimitedBatchSink> {
+ public:
+  static std::shared_ptr<ConcurrencyLimitedBatchSink> Create(
+      std::shared_ptr<BatchSink> sink, std::size_t maximum_concurrency) {
+    return std::shared_ptr<ConcurrencyLimitedBatchSink>(
+        new ConcurrencyLimitedBatchSink(std::move(sink), maximum_concurrency));
+  }
+
+  ~ConcurrencyLimitedBatchSink() override = default;
+
+  future<StatusOr<google::pubsub::v1::PublishResponse>> AsyncPublish(
+      google::pubsub::v1::PublishRequest request) override;
+  void ResumePublish(std::string const& ordering_key) override;
+
+  // Useful for testing.
+  std::size_t QueueDepth() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return queue_.size();
+  }
+
+ private:
+  ConcurrencyLimitedBatchSink(std::shared_ptr<BatchSink> sink,
+                              std::size_t maximum_concurrency);
+
+  using PublishResponse = google::pubsub::v1::PublishResponse;
+  using PublishRequest = google::pubsub::v1::PublishRequest;
+
+  future<StatusOr<PublishResponse>> Send(PublishRequest request);
+  void OnPublish();
+
+  struct PendingRequest {
+    PublishRequest request;
+    google::cloud::promise<StatusOr<PublishResponse>> promise;
+  };
+
+  std::shared_ptr<BatchSink> const sink_;
+  std::size_t const maximum_concurrency_;
+  std::mutex mu_;
+  std::deque<PendingRequest> queue_;
+  std::size_t in_flight_ = 0;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_CONCURRENCY_LIMITED_BATCH_SINK_H
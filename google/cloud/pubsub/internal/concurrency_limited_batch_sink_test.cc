@@ -0,0 +1,134 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/concurrency_limited_batch_sink.h"
+#include "google/cloud/pubsub/testing/mock_batch_sink.h"
+#include "google/cloud/pubsub/topic.h"
+#include "google/cloud/testing_util/async_sequencer.h"
+#include "google/cloud/testing_util/is_proto_equal.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::google::cloud::testing_util::AsyncSequencer;
+using ::google::cloud::testing_util::IsProtoEqual;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::Unused;
+
+google::pubsub::v1::PublishRequest MakeRequest(int n) {
+  google::pubsub::v1::PublishRequest request;
+  request.set_topic(pubsub::Topic("test-project", "test-topic").FullName());
+  for (int i = 0; i != n; ++i) {
+    request.add_messages()->set_message_id("message-" + std::to_string(i));
+  }
+  return request;
+}
+
+google::pubsub::v1::PublishResponse MakeResponse(
+    google::pubsub::v1::PublishRequest const& request) {
+  google::pubsub::v1::PublishResponse response;
+  for (auto const& m : request.messages()) {
+    response.add_message_ids("id-" + m.message_id());
+  }
+  return response;
+}
+
+TEST(ConcurrencyLimitedBatchSinkTest, Basic) {
+  AsyncSequencer<void> sequencer;
+  std::vector<int> sizes;
+
+  auto mock = std::make_shared<pubsub_testing::MockBatchSink>();
+  EXPECT_CALL(*mock, AsyncPublish)
+      .Times(4)
+      .WillRepeatedly([&](google::pubsub::v1::PublishRequest const& r) {
+        sizes.push_back(r.messages_size());
+        return sequencer.PushBack().then(
+            [r](future<void>) { return make_status_or(MakeResponse(r)); });
+      });
+
+  auto uut = ConcurrencyLimitedBatchSink::Create(mock, 2);
+  auto f1 = uut->AsyncPublish(MakeRequest(1));
+  auto f2 = uut->AsyncPublish(MakeRequest(2));
+  auto f3 = uut->AsyncPublish(MakeRequest(3));
+  auto f4 = uut->AsyncPublish(MakeRequest(4));
+  // Only two requests are sent, the others wait.
+  EXPECT_THAT(sizes, ::testing::ElementsAre(1, 2));
+  EXPECT_EQ(2, uut->QueueDepth());
+
+  // Completing any request sends the next one in the queue.
+  sequencer.PopFront().set_value();
+  auto r1 = f1.get();
+  ASSERT_THAT(r1, StatusIs(StatusCode::kOk));
+  EXPECT_THAT(*r1, IsProtoEqual(MakeResponse(MakeRequest(1))));
+  EXPECT_THAT(sizes, ::testing::ElementsAre(1, 2, 3));
+  EXPECT_EQ(1, uut->QueueDepth());
+
+  sequencer.PopFront().set_value();
+  EXPECT_THAT(sizes, ::testing::ElementsAre(1, 2, 3, 4));
+  EXPECT_EQ(0, uut->QueueDepth());
+  sequencer.PopFront().set_value();
+  sequencer.PopFront().set_value();
+
+  auto r2 = f2.get();
+  ASSERT_THAT(r2, StatusIs(StatusCode::kOk));
+  EXPECT_THAT(*r2, IsProtoEqual(MakeResponse(MakeRequest(2))));
+  auto r3 = f3.get();
+  ASSERT_THAT(r3, StatusIs(StatusCode::kOk));
+  EXPECT_THAT(*r3, IsProtoEqual(MakeResponse(MakeRequest(3))));
+  auto r4 = f4.get();
+  ASSERT_THAT(r4, StatusIs(StatusCode::kOk));
+  EXPECT_THAT(*r4, IsProtoEqual(MakeResponse(MakeRequest(4))));
+}
+
+TEST(ConcurrencyLimitedBatchSinkTest, ErrorsDoNotStopPublishing) {
+  AsyncSequencer<void> sequencer;
+
+  auto mock = std::make_shared<pubsub_testing::MockBatchSink>();
+  EXPECT_CALL(*mock, ResumePublish).Times(1);
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*mock, AsyncPublish).WillOnce([&](Unused) {
+      return sequencer.PushBack().then([](future<void>) {
+        return StatusOr<google::pubsub::v1::PublishResponse>(
+            Status{StatusCode::kPermissionDenied, "uh-oh"});
+      });
+    });
+    EXPECT_CALL(*mock, AsyncPublish)
+        .WillOnce([&](google::pubsub::v1::PublishRequest const& r) {
+          return sequencer.PushBack().then(
+              [r](future<void>) { return make_status_or(MakeResponse(r)); });
+        });
+  }
+
+  auto uut = ConcurrencyLimitedBatchSink::Create(mock, 1);
+  auto f1 = uut->AsyncPublish(MakeRequest(1));
+  auto f2 = uut->AsyncPublish(MakeRequest(2));
+  sequencer.PopFront().set_value();
+  EXPECT_THAT(f1.get(), StatusIs(StatusCode::kPermissionDenied));
+  sequencer.PopFront().set_value();
+  EXPECT_THAT(f2.get(), StatusIs(StatusCode::kOk));
+
+  uut->ResumePublish("test-key");
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -14,6 +14,7 @@
 
 #include "google/cloud/pubsub/internal/create_channel.h"
 #include "google/cloud/pubsub/internal/emulator_overrides.h"
+#include "google/cloud/internal/channel_cache.h"
 
 namespace google {
 namespace cloud {
@@ -39,8 +40,9 @@ std::shared_ptr<grpc::Channel> CreateChannel(pubsub::ConnectionOptions options,
   channel_arguments.SetMaxSendMessageSize(16 * 1024 * 1024);
   channel_arguments.SetMaxReceiveMessageSize(16 * 1024 * 1024);
 
-  return grpc::CreateCustomChannel(options.endpoint(), options.credentials(),
-                                   std::move(channel_arguments));
+  return google::cloud::internal::CreateCustomChannel(
+      options.endpoint(), options.credentials(), channel_arguments,
+      options.channel_cache_enabled());
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
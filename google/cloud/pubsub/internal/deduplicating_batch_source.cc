@@ -0,0 +1,134 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/deduplicating_batch_source.h"
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+void DeduplicatingBatchSource::Start(BatchCallback cb) {
+  auto weak = std::weak_ptr<DeduplicatingBatchSource>(shared_from_this());
+  child_->Start(
+      [weak, cb](StatusOr<google::pubsub::v1::StreamingPullResponse> r) {
+        auto self = weak.lock();
+        cb(self ? self->OnRead(std::move(r)) : std::move(r));
+      });
+}
+
+void DeduplicatingBatchSource::Shutdown() { child_->Shutdown(); }
+
+void DeduplicatingBatchSource::AckMessage(std::string const& ack_id) {
+  std::unique_lock<std::mutex> lk(mu_);
+  auto duplicates = Forget(lk, ack_id, /*acked=*/true);
+  lk.unlock();
+  child_->AckMessage(ack_id);
+  for (auto const& d : duplicates) child_->AckMessage(d);
+}
+
+void DeduplicatingBatchSource::NackMessage(std::string const& ack_id) {
+  std::unique_lock<std::mutex> lk(mu_);
+  auto duplicates = Forget(lk, ack_id, /*acked=*/false);
+  lk.unlock();
+  child_->NackMessage(ack_id);
+  if (!duplicates.empty()) child_->BulkNack(std::move(duplicates));
+}
+
+void DeduplicatingBatchSource::BulkNack(std::vector<std::string> ack_ids) {
+  std::unique_lock<std::mutex> lk(mu_);
+  std::vector<std::string> duplicates;
+  for (auto const& id : ack_ids) {
+    auto d = Forget(lk, id, /*acked=*/false);
+    duplicates.insert(duplicates.end(), std::make_move_iterator(d.begin()),
+                      std::make_move_iterator(d.end()));
+  }
+  lk.unlock();
+  ack_ids.insert(ack_ids.end(), std::make_move_iterator(duplicates.begin()),
+                 std::make_move_iterator(duplicates.end()));
+  child_->BulkNack(std::move(ack_ids));
+}
+
+void DeduplicatingBatchSource::ExtendLeases(std::vector<std::string> ack_ids,
+                                            std::chrono::seconds extension) {
+  child_->ExtendLeases(std::move(ack_ids), extension);
+}
+
+StatusOr<google::pubsub::v1::StreamingPullResponse>
+DeduplicatingBatchSource::OnRead(
+    StatusOr<google::pubsub::v1::StreamingPullResponse> r) {
+  if (!r) return r;
+  google::pubsub::v1::StreamingPullResponse forward;
+  std::vector<std::string> acks;
+  std::size_t suppressed = 0;
+  std::unique_lock<std::mutex> lk(mu_);
+  Expire(lk, now_());
+  for (auto& m : *r->mutable_received_messages()) {
+    auto const& message_id = m.message().message_id();
+    if (!message_id.empty()) {
+      auto i = messages_.emplace(message_id, Entry{});
+      if (!i.second) {
+        ++suppressed;
+        auto& entry = i.first->second;
+        if (entry.acked) {
+          acks.push_back(std::move(*m.mutable_ack_id()));
+        } else {
+          entry.duplicates.push_back(std::move(*m.mutable_ack_id()));
+        }
+        continue;
+      }
+      message_ids_.emplace(m.ack_id(), message_id);
+    }
+    *forward.add_received_messages() = std::move(m);
+  }
+  lk.unlock();
+  if (metrics_ && suppressed != 0) metrics_->RecordDuplicates(suppressed);
+  for (auto const& a : acks) child_->AckMessage(a);
+  return forward;
+}
+
+std::vector<std::string> DeduplicatingBatchSource::Forget(
+    std::unique_lock<std::mutex> const&, std::string const& ack_id,
+    bool acked) {
+  auto i = message_ids_.find(ack_id);
+  if (i == message_ids_.end()) return {};
+  auto message_id = std::move(i->second);
+  message_ids_.erase(i);
+  auto e = messages_.find(message_id);
+  if (e == messages_.end()) return {};
+  auto duplicates = std::move(e->second.duplicates);
+  if (!acked) {
+    // Rejected messages are redelivered, and must run the callback again.
+    messages_.erase(e);
+    return duplicates;
+  }
+  e->second.acked = true;
+  e->second.duplicates.clear();
+  acked_.emplace_back(now_() + window_, std::move(message_id));
+  return duplicates;
+}
+
+void DeduplicatingBatchSource::Expire(std::unique_lock<std::mutex> const&,
+                                      Clock::time_point now) {
+  while (!acked_.empty() &&
+         (acked_.front().first <= now || acked_.size() > max_entries_)) {
+    messages_.erase(acked_.front().second);
+    acked_.pop_front();
+  }
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,126 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_DEDUPLICATING_BATCH_SOURCE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_DEDUPLICATING_BATCH_SOURCE_H
+
+#include "google/cloud/pubsub/internal/subscription_batch_source.h"
+#include "google/cloud/pubsub/subscriber_metrics.h"
+#include "google/cloud/pubsub/version.h"
+#include "google/cloud/internal/absl_flat_hash_map_quiet.h"
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * Suppresses redeliveries of messages that are outstanding or recently acked.
+ *
+ * Cloud Pub/Sub delivers messages at least once, a message may be redelivered
+ * if its lease expires, or when a stream reconnects. This decorator remembers
+ * the `message_id` of each message it forwards:
+ * - A duplicate of an outstanding message is held, and acknowledged (or
+ *   rejected) together with the original message.
+ * - A duplicate of a message acknowledged less than @p window ago is
+ *   acknowledged immediately.
+ * In both cases the application callback does not see the duplicate. A
+ * rejected message is forgotten, so its redelivery runs the callback again.
+ *
+ * At most @p max_entries acknowledged messages are remembered, the oldest are
+ * forgotten first. This class must be above the lease management layer, so
+ * the leases for held duplicates are extended with the original message.
+ */
+class DeduplicatingBatchSource
+    : public SubscriptionBatchSource,
+      public std::enable_shared_from_this<DeduplicatingBatchSource> {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using NowFunction = std::function<Clock::time_point()>;
+
+  static std::shared_ptr<DeduplicatingBatchSource> Create(
+      std::shared_ptr<SubscriptionBatchSource> child,
+      std::chrono::milliseconds window, std::size_t max_entries,
+      std::shared_ptr<pubsub::SubscriberMetrics> metrics = {},
+      NowFunction now = [] { return Clock::now(); }) {
+    return std::shared_ptr<DeduplicatingBatchSource>(
+        new DeduplicatingBatchSource(std::move(child), window, max_entries,
+                                     std::move(metrics), std::move(now)));
+  }
+
+  void Start(BatchCallback cb) override;
+  void Shutdown() override;
+  void AckMessage(std::string const& ack_id) override;
+  void NackMessage(std::string const& ack_id) override;
+  void BulkNack(std::vector<std::string> ack_ids) override;
+  void ExtendLeases(std::vector<std::string> ack_ids,
+                    std::chrono::seconds extension) override;
+
+ private:
+  DeduplicatingBatchSource(std::shared_ptr<SubscriptionBatchSource> child,
+                           std::chrono::milliseconds window,
+                           std::size_t max_entries,
+                           std::shared_ptr<pubsub::SubscriberMetrics> metrics,
+                           NowFunction now)
+      : child_(std::move(child)),
+        window_(window),
+        max_entries_(max_entries),
+        metrics_(std::move(metrics)),
+        now_(std::move(now)) {}
+
+  StatusOr<google::pubsub::v1::StreamingPullResponse> OnRead(
+      StatusOr<google::pubsub::v1::StreamingPullResponse> r);
+
+  /// Forget the original message for @p ack_id, returns its held duplicates.
+  std::vector<std::string> Forget(std::unique_lock<std::mutex> const& lk,
+                                  std::string const& ack_id, bool acked);
+
+  /// Forget the acknowledged messages that expired, or exceed `max_entries_`.
+  void Expire(std::unique_lock<std::mutex> const& lk, Clock::time_point now);
+
+  std::shared_ptr<SubscriptionBatchSource> const child_;
+  std::chrono::milliseconds const window_;
+  std::size_t const max_entries_;
+  std::shared_ptr<pubsub::SubscriberMetrics> const metrics_;
+  NowFunction const now_;
+
+  struct Entry {
+    bool acked = false;
+    // The ack ids of duplicates received while the original is outstanding.
+    std::vector<std::string> duplicates;
+  };
+
+  std::mutex mu_;
+  absl::flat_hash_map<std::string, Entry> messages_;
+  // The message id for the ack id of each outstanding (original) message.
+  absl::flat_hash_map<std::string, std::string> message_ids_;
+  // The acknowledged messages, in the order they expire.
+  std::deque<std::pair<Clock::time_point, std::string>> acked_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_DEDUPLICATING_BATCH_SOURCE_H
@@ -0,0 +1,175 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/deduplicating_batch_source.h"
+#include "google/cloud/pubsub/testing/mock_subscription_batch_source.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+
+using Response = google::pubsub::v1::StreamingPullResponse;
+
+/// Each pair is {ack_id, message_id}.
+Response MakeResponse(
+    std::vector<std::pair<std::string, std::string>> const& messages) {
+  Response response;
+  for (auto const& m : messages) {
+    auto& rm = *response.add_received_messages();
+    rm.set_ack_id(m.first);
+    rm.mutable_message()->set_message_id(m.second);
+  }
+  return response;
+}
+
+std::vector<std::string> AckIds(Response const& response) {
+  std::vector<std::string> ids;
+  for (auto const& m : response.received_messages()) ids.push_back(m.ack_id());
+  return ids;
+}
+
+class DeduplicatingBatchSourceTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<DeduplicatingBatchSource> MakeTested(
+      std::chrono::milliseconds window, std::size_t max_entries = 1000) {
+    EXPECT_CALL(*mock_, Start).WillOnce([this](BatchCallback cb) {
+      callback_ = std::move(cb);
+    });
+    auto tested = DeduplicatingBatchSource::Create(
+        mock_, window, max_entries, metrics_, [this] { return now_; });
+    tested->Start([this](StatusOr<Response> r) {
+      if (r) {
+        received_.push_back(*std::move(r));
+      } else {
+        status_ = std::move(r).status();
+      }
+    });
+    return tested;
+  }
+
+  std::shared_ptr<pubsub_testing::MockSubscriptionBatchSource> mock_ =
+      std::make_shared<pubsub_testing::MockSubscriptionBatchSource>();
+  std::shared_ptr<pubsub::SubscriberMetrics> metrics_ =
+      std::make_shared<pubsub::SubscriberMetrics>();
+  DeduplicatingBatchSource::Clock::time_point now_ =
+      DeduplicatingBatchSource::Clock::now();
+  BatchCallback callback_;
+  std::vector<Response> received_;
+  Status status_;
+};
+
+TEST_F(DeduplicatingBatchSourceTest, DuplicateOfOutstandingIsHeld) {
+  auto tested = MakeTested(std::chrono::minutes(1));
+  callback_(MakeResponse({{"a1", "m1"}, {"a2", "m2"}}));
+  callback_(MakeResponse({{"a3", "m1"}, {"a4", "m3"}}));
+  ASSERT_EQ(2, received_.size());
+  EXPECT_THAT(AckIds(received_[0]), ElementsAre("a1", "a2"));
+  EXPECT_THAT(AckIds(received_[1]), ElementsAre("a4"));
+
+  // The duplicate is acked with the original message.
+  std::vector<std::string> acks;
+  EXPECT_CALL(*mock_, AckMessage).WillRepeatedly([&](std::string const& id) {
+    acks.push_back(id);
+  });
+  tested->AckMessage("a1");
+  EXPECT_THAT(acks, ElementsAre("a1", "a3"));
+  EXPECT_EQ(1, metrics_->Snapshot().duplicates_suppressed);
+}
+
+TEST_F(DeduplicatingBatchSourceTest, DuplicateOfAckedIsAcked) {
+  auto tested = MakeTested(std::chrono::minutes(1));
+  std::vector<std::string> acks;
+  EXPECT_CALL(*mock_, AckMessage).WillRepeatedly([&](std::string const& id) {
+    acks.push_back(id);
+  });
+  callback_(MakeResponse({{"a1", "m1"}}));
+  tested->AckMessage("a1");
+  now_ += std::chrono::seconds(30);
+  callback_(MakeResponse({{"a2", "m1"}}));
+  ASSERT_EQ(2, received_.size());
+  EXPECT_TRUE(received_[1].received_messages().empty());
+  EXPECT_THAT(acks, ElementsAre("a1", "a2"));
+
+  // After the window expires the message is delivered again.
+  now_ += std::chrono::seconds(31);
+  callback_(MakeResponse({{"a3", "m1"}}));
+  ASSERT_EQ(3, received_.size());
+  EXPECT_THAT(AckIds(received_[2]), ElementsAre("a3"));
+  EXPECT_EQ(1, metrics_->Snapshot().duplicates_suppressed);
+}
+
+TEST_F(DeduplicatingBatchSourceTest, NackedIsRedelivered) {
+  auto tested = MakeTested(std::chrono::minutes(1));
+  EXPECT_CALL(*mock_, NackMessage("a1")).Times(1);
+  EXPECT_CALL(*mock_, BulkNack(ElementsAre("a2"))).Times(1);
+  callback_(MakeResponse({{"a1", "m1"}}));
+  callback_(MakeResponse({{"a2", "m1"}}));
+  tested->NackMessage("a1");
+  callback_(MakeResponse({{"a3", "m1"}}));
+  ASSERT_EQ(3, received_.size());
+  EXPECT_THAT(AckIds(received_[2]), ElementsAre("a3"));
+}
+
+TEST_F(DeduplicatingBatchSourceTest, BulkNackIncludesDuplicates) {
+  auto tested = MakeTested(std::chrono::minutes(1));
+  EXPECT_CALL(*mock_, BulkNack(UnorderedElementsAre("a1", "a2", "a3")))
+      .Times(1);
+  callback_(MakeResponse({{"a1", "m1"}, {"a2", "m2"}}));
+  callback_(MakeResponse({{"a3", "m1"}}));
+  tested->BulkNack({"a1", "a2"});
+}
+
+TEST_F(DeduplicatingBatchSourceTest, MaxEntries) {
+  auto tested = MakeTested(std::chrono::minutes(1), /*max_entries=*/1);
+  EXPECT_CALL(*mock_, AckMessage).Times(2);
+  callback_(MakeResponse({{"a1", "m1"}, {"a2", "m2"}}));
+  tested->AckMessage("a1");
+  tested->AckMessage("a2");
+  // Only the last acked message is remembered.
+  callback_(MakeResponse({{"a3", "m1"}}));
+  ASSERT_EQ(2, received_.size());
+  EXPECT_THAT(AckIds(received_[1]), ElementsAre("a3"));
+}
+
+TEST_F(DeduplicatingBatchSourceTest, PassThrough) {
+  auto tested = MakeTested(std::chrono::minutes(1));
+  EXPECT_CALL(*mock_, ExtendLeases(ElementsAre("a1"), std::chrono::seconds(10)))
+      .Times(1);
+  EXPECT_CALL(*mock_, Shutdown).Times(1);
+  // Messages without an id are never considered duplicates.
+  callback_(MakeResponse({{"a1", ""}, {"a2", ""}}));
+  ASSERT_EQ(1, received_.size());
+  EXPECT_THAT(AckIds(received_[0]), ElementsAre("a1", "a2"));
+  callback_(Status(StatusCode::kUnavailable, "try-again"));
+  EXPECT_THAT(status_, StatusIs(StatusCode::kUnavailable));
+  tested->ExtendLeases({"a1"}, std::chrono::seconds(10));
+  tested->Shutdown();
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -24,21 +24,28 @@ DefaultBatchSink::DefaultBatchSink(
     std::shared_ptr<pubsub_internal::PublisherStub> stub,
     google::cloud::CompletionQueue cq,
     std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
-    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy)
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    absl::optional<std::size_t> compression_threshold)
     : stub_(std::move(stub)),
       cq_(std::move(cq)),
       retry_policy_(std::move(retry_policy)),
-      backoff_policy_(std::move(backoff_policy)) {}
+      backoff_policy_(std::move(backoff_policy)),
+      compression_threshold_(compression_threshold) {}
 
 future<StatusOr<google::pubsub::v1::PublishResponse>>
 DefaultBatchSink::AsyncPublish(google::pubsub::v1::PublishRequest request) {
   auto& stub = stub_;
+  // Compute this once, and not on each retry attempt.
+  auto const compress =
+      compression_threshold_.has_value() &&
+      request.ByteSizeLong() >= compression_threshold_.value();
   return google::cloud::internal::AsyncRetryLoop(
       retry_policy_->clone(), backoff_policy_->clone(),
       google::cloud::internal::Idempotency::kIdempotent, cq_,
-      [stub](google::cloud::CompletionQueue& cq,
-             std::unique_ptr<grpc::ClientContext> context,
-             google::pubsub::v1::PublishRequest const& request) {
+      [stub, compress](google::cloud::CompletionQueue& cq,
+                       std::unique_ptr<grpc::ClientContext> context,
+                       google::pubsub::v1::PublishRequest const& request) {
+        if (compress) context->set_compression_algorithm(GRPC_COMPRESS_GZIP);
         return stub->AsyncPublish(cq, std::move(context), request);
       },
       std::move(request), __func__);
@@ -20,6 +20,7 @@
 #include "google/cloud/pubsub/internal/publisher_stub.h"
 #include "google/cloud/pubsub/retry_policy.h"
 #include "google/cloud/pubsub/version.h"
+#include "absl/types/optional.h"
 #include <memory>
 
 namespace google {
@@ -28,16 +29,23 @@ namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
 /// Publish message batches using a stub, with retries, but no queueing.
+/**
+ * Sends each batch using a `Publish()` RPC, retrying transient errors.
+ *
+ * If @p compression_threshold is set, batches of at least that many bytes are
+ * compressed using gRPC message compression.
+ */
 class DefaultBatchSink : public BatchSink {
  public:
   static std::shared_ptr<DefaultBatchSink> Create(
       std::shared_ptr<pubsub_internal::PublisherStub> stub,
       google::cloud::CompletionQueue cq,
       std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
-      std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy) {
+      std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+      absl::optional<std::size_t> compression_threshold = {}) {
     return std::shared_ptr<DefaultBatchSink>(new DefaultBatchSink(
         std::move(stub), std::move(cq), std::move(retry_policy),
-        std::move(backoff_policy)));
+        std::move(backoff_policy), compression_threshold));
   }
 
   ~DefaultBatchSink() override = default;
@@ -51,12 +59,14 @@ class DefaultBatchSink : public BatchSink {
   DefaultBatchSink(std::shared_ptr<pubsub_internal::PublisherStub> stub,
                    google::cloud::CompletionQueue cq,
                    std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
-                   std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy);
+                   std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+                   absl::optional<std::size_t> compression_threshold);
 
   std::shared_ptr<pubsub_internal::PublisherStub> stub_;
   google::cloud::CompletionQueue cq_;
   std::unique_ptr<pubsub::RetryPolicy const> retry_policy_;
   std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy_;
+  absl::optional<std::size_t> const compression_threshold_;
 };
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
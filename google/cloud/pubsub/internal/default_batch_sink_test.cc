@@ -29,6 +29,7 @@ namespace {
 using ::google::cloud::testing_util::IsProtoEqual;
 using ::google::cloud::testing_util::StatusIs;
 using ::testing::AtLeast;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Unused;
 
@@ -79,6 +80,31 @@ TEST(DefaultBatchSinkTest, BasicWithRetry) {
   uut->ResumePublish("unused");  // No observable side-effects
 }
 
+TEST(DefaultBatchSinkTest, Compression) {
+  auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
+  std::vector<grpc_compression_algorithm> algorithms;
+  EXPECT_CALL(*mock, AsyncPublish)
+      .Times(2)
+      .WillRepeatedly([&](Unused, std::unique_ptr<grpc::ClientContext> context,
+                          google::pubsub::v1::PublishRequest const& request) {
+        algorithms.push_back(context->compression_algorithm());
+        return make_ready_future(make_status_or(MakeResponse(request)));
+      });
+
+  internal::AutomaticallyCreatedBackgroundThreads background;
+  auto const threshold = MakeRequest(3).ByteSizeLong();
+  auto uut = DefaultBatchSink::Create(
+      mock, background.cq(), pubsub_testing::TestRetryPolicy(),
+      pubsub_testing::TestBackoffPolicy(), threshold);
+
+  // Only the requests at or above the threshold are compressed.
+  ASSERT_THAT(uut->AsyncPublish(MakeRequest(1)).get(),
+              StatusIs(StatusCode::kOk));
+  ASSERT_THAT(uut->AsyncPublish(MakeRequest(3)).get(),
+              StatusIs(StatusCode::kOk));
+  EXPECT_THAT(algorithms, ElementsAre(GRPC_COMPRESS_NONE, GRPC_COMPRESS_GZIP));
+}
+
 TEST(DefaultBatchSinkTest, PermanentError) {
   auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
   EXPECT_CALL(*mock, AsyncPublish).WillOnce([](Unused, Unused, Unused) {
@@ -0,0 +1,180 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/flow_controlled_publisher_connection.h"
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+Status PublisherFull() {
+  return Status(StatusCode::kFailedPrecondition,
+                "The publisher has too many pending messages");
+}
+
+Status MemoryBudgetExhausted() {
+  return Status(StatusCode::kFailedPrecondition,
+                "The memory budget for the publisher is exhausted");
+}
+}  // namespace
+
+FlowControlledPublisherConnection::~FlowControlledPublisherConnection() {
+  // Any messages still in the backlog will never be published, satisfy their
+  // futures, otherwise the application may wait forever.
+  for (auto& b : backlog_) {
+    if (memory_) memory_->Release(b.bytes);
+    b.result.set_value(Status(StatusCode::kCancelled,
+                              "The publisher was deleted before the message"
+                              " could be published"));
+  }
+}
+
+future<StatusOr<std::string>> FlowControlledPublisherConnection::Publish(
+    PublishParams p) {
+  auto const bytes = pubsub_internal::MessageSize(p.message);
+  if (!ReserveMemory(bytes)) {
+    return make_ready_future(StatusOr<std::string>(MemoryBudgetExhausted()));
+  }
+  std::unique_lock<std::mutex> lk(mu_);
+  if (options_.full_publisher_blocks()) {
+    cv_.wait(lk, [&] { return HasCapacity(bytes); });
+  } else if (options_.full_publisher_rejects()) {
+    if (!HasCapacity(bytes)) {
+      lk.unlock();
+      if (memory_) memory_->Release(bytes);
+      return make_ready_future(StatusOr<std::string>(PublisherFull()));
+    }
+  } else if (options_.full_publisher_discards_oldest()) {
+    // Messages in the backlog go first, otherwise we would reorder messages.
+    if (!backlog_.empty() || !HasCapacity(bytes)) {
+      return Backlog(std::move(lk), std::move(p), bytes);
+    }
+  }
+  ++pending_messages_;
+  pending_bytes_ += bytes;
+  lk.unlock();
+  return Forward(std::move(p), bytes);
+}
+
+void FlowControlledPublisherConnection::Flush(FlushParams p) {
+  child_->Flush(std::move(p));
+}
+
+void FlowControlledPublisherConnection::ResumePublish(ResumePublishParams p) {
+  child_->ResumePublish(std::move(p));
+}
+
+std::size_t FlowControlledPublisherConnection::pending_messages() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return pending_messages_;
+}
+
+std::size_t FlowControlledPublisherConnection::pending_bytes() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return pending_bytes_;
+}
+
+std::size_t FlowControlledPublisherConnection::backlog_messages() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return backlog_.size();
+}
+
+bool FlowControlledPublisherConnection::HasCapacity(std::size_t bytes) const {
+  if (pending_messages_ == 0) return true;
+  return pending_messages_ < options_.maximum_pending_messages() &&
+         pending_bytes_ + bytes <= options_.maximum_pending_bytes();
+}
+
+bool FlowControlledPublisherConnection::ReserveMemory(std::size_t bytes) {
+  if (!memory_) return true;
+  // Blocking is only safe if the application opted into it.
+  if (options_.full_publisher_blocks()) {
+    memory_->Acquire(bytes);
+    return true;
+  }
+  return memory_->TryAcquire(bytes);
+}
+
+future<StatusOr<std::string>> FlowControlledPublisherConnection::Backlog(
+    std::unique_lock<std::mutex> lk, PublishParams p, std::size_t bytes) {
+  backlog_.push_back(Backlogged{std::move(p), bytes, {}});
+  backlog_bytes_ += bytes;
+  auto f = backlog_.back().result.get_future();
+  // The backlog has the same limits as the pending messages, but always keeps
+  // the newest message.
+  std::vector<promise<StatusOr<std::string>>> discarded;
+  std::size_t discarded_bytes = 0;
+  while (backlog_.size() > 1 &&
+         (backlog_.size() > options_.maximum_pending_messages() ||
+          backlog_bytes_ > options_.maximum_pending_bytes())) {
+    backlog_bytes_ -= backlog_.front().bytes;
+    discarded_bytes += backlog_.front().bytes;
+    discarded.push_back(std::move(backlog_.front().result));
+    backlog_.pop_front();
+  }
+  lk.unlock();
+  if (memory_) memory_->Release(discarded_bytes);
+  for (auto& d : discarded) d.set_value(PublisherFull());
+  return f;
+}
+
+future<StatusOr<std::string>> FlowControlledPublisherConnection::Forward(
+    PublishParams p, std::size_t bytes) {
+  // The child connection may outlive this object, the callbacks must not
+  // extend its lifetime.
+  auto weak =
+      std::weak_ptr<FlowControlledPublisherConnection>(shared_from_this());
+  auto memory = memory_;
+  return child_->Publish(std::move(p))
+      .then([weak, memory, bytes](future<StatusOr<std::string>> f) {
+        if (memory) memory->Release(bytes);
+        if (auto self = weak.lock()) self->OnPublish(bytes);
+        return f.get();
+      });
+}
+
+void FlowControlledPublisherConnection::OnPublish(std::size_t bytes) {
+  std::vector<Backlogged> ready;
+  std::unique_lock<std::mutex> lk(mu_);
+  --pending_messages_;
+  pending_bytes_ -= bytes;
+  while (!backlog_.empty() && HasCapacity(backlog_.front().bytes)) {
+    auto& b = backlog_.front();
+    ++pending_messages_;
+    pending_bytes_ += b.bytes;
+    backlog_bytes_ -= b.bytes;
+    ready.push_back(std::move(b));
+    backlog_.pop_front();
+  }
+  lk.unlock();
+  cv_.notify_all();
+
+  struct MoveCapture {
+    promise<StatusOr<std::string>> result;
+    void operator()(future<StatusOr<std::string>> f) {
+      result.set_value(f.get());
+    }
+  };
+  for (auto& b : ready) {
+    Forward(std::move(b.params), b.bytes)
+        .then(MoveCapture{std::move(b.result)});
+  }
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
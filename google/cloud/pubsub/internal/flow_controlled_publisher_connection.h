@@ -0,0 +1,111 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_FLOW_CONTROLLED_PUBLISHER_CONNECTION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_FLOW_CONTROLLED_PUBLISHER_CONNECTION_H
+
+#include "google/cloud/pubsub/publisher_connection.h"
+#include "google/cloud/pubsub/publisher_options.h"
+#include "google/cloud/pubsub/version.h"
+#include "google/cloud/memory_budget.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * Bounds the number and size of the pending messages in a publisher.
+ *
+ * A message is pending from the time it is given to the child connection until
+ * the future returned by the child is satisfied. When a new message would
+ * exceed the limits it is rejected, blocks the caller, or waits in a bounded
+ * backlog that discards its oldest messages, depending on the
+ * `PublisherOptions`. A message is always accepted if there are no pending
+ * messages, even if it exceeds the limits by itself, otherwise it could never
+ * be published.
+ *
+ * The pending and backlogged messages are also reported to the optional
+ * `MemoryAccount`. If its budget is exhausted the message is rejected, or the
+ * caller blocks when the publisher is configured to block.
+ */
+class FlowControlledPublisherConnection
+    : public pubsub::PublisherConnection,
+      public std::enable_shared_from_this<FlowControlledPublisherConnection> {
+ public:
+  static std::shared_ptr<FlowControlledPublisherConnection> Create(
+      pubsub::PublisherOptions options,
+      std::shared_ptr<pubsub::PublisherConnection> child,
+      MemoryAccount memory = {}) {
+    return std::shared_ptr<FlowControlledPublisherConnection>(
+        new FlowControlledPublisherConnection(
+            std::move(options), std::move(child), std::move(memory)));
+  }
+
+  ~FlowControlledPublisherConnection() override;
+
+  future<StatusOr<std::string>> Publish(PublishParams p) override;
+  void Flush(FlushParams) override;
+  void ResumePublish(ResumePublishParams p) override;
+
+  std::size_t pending_messages() const;
+  std::size_t pending_bytes() const;
+  std::size_t backlog_messages() const;
+
+ private:
+  FlowControlledPublisherConnection(
+      pubsub::PublisherOptions options,
+      std::shared_ptr<pubsub::PublisherConnection> child, MemoryAccount memory)
+      : options_(std::move(options)),
+        child_(std::move(child)),
+        memory_(memory.enabled()
+                    ? std::make_shared<MemoryAccount>(std::move(memory))
+                    : nullptr) {}
+
+  struct Backlogged {
+    PublishParams params;
+    std::size_t bytes;
+    promise<StatusOr<std::string>> result;
+  };
+
+  bool HasCapacity(std::size_t bytes) const;
+  bool ReserveMemory(std::size_t bytes);
+  future<StatusOr<std::string>> Backlog(std::unique_lock<std::mutex> lk,
+                                        PublishParams p, std::size_t bytes);
+  future<StatusOr<std::string>> Forward(PublishParams p, std::size_t bytes);
+  void OnPublish(std::size_t bytes);
+
+  pubsub::PublisherOptions const options_;
+  std::shared_ptr<pubsub::PublisherConnection> const child_;
+  // Shared with the callbacks, which may outlive this object.
+  std::shared_ptr<MemoryAccount> const memory_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::size_t pending_messages_ = 0;
+  std::size_t pending_bytes_ = 0;
+  std::deque<Backlogged> backlog_;
+  std::size_t backlog_bytes_ = 0;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_FLOW_CONTROLLED_PUBLISHER_CONNECTION_H
@@ -0,0 +1,273 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/flow_controlled_publisher_connection.h"
+#include "google/cloud/pubsub/mocks/mock_publisher_connection.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+
+/// Captures the messages published by the mock, and lets the test satisfy them.
+class PublishCapture {
+ public:
+  future<StatusOr<std::string>> operator()(
+      pubsub::PublisherConnection::PublishParams const& p) {
+    std::lock_guard<std::mutex> lk(mu_);
+    data_.push_back(std::string(p.message.data()));
+    promises_.emplace_back();
+    return promises_.back().get_future();
+  }
+
+  std::vector<std::string> data() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return data_;
+  }
+
+  /// Satisfy the oldest unsatisfied message with its data as the id.
+  void Complete() {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto p = std::move(promises_[completed_]);
+    auto id = "id-" + data_[completed_];
+    ++completed_;
+    lk.unlock();
+    p.set_value(std::move(id));
+  }
+
+ private:
+  std::mutex mu_;
+  std::vector<std::string> data_;
+  std::vector<promise<StatusOr<std::string>>> promises_;
+  std::size_t completed_ = 0;
+};
+
+pubsub::PublisherConnection::PublishParams MakeParams(std::string data) {
+  return {pubsub::MessageBuilder{}.SetData(std::move(data)).Build()};
+}
+
+std::shared_ptr<pubsub_mocks::MockPublisherConnection> MakeMock(
+    std::shared_ptr<PublishCapture> const& capture) {
+  auto mock = std::make_shared<pubsub_mocks::MockPublisherConnection>();
+  EXPECT_CALL(*mock, Publish)
+      .WillRepeatedly([capture](
+                          pubsub::PublisherConnection::PublishParams const& p) {
+        return (*capture)(p);
+      });
+  return mock;
+}
+
+TEST(FlowControlledPublisherConnectionTest, Ignored) {
+  auto capture = std::make_shared<PublishCapture>();
+  auto mock = MakeMock(capture);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}.set_maximum_pending_messages(1), mock);
+
+  auto f0 = tested->Publish(MakeParams("d0"));
+  auto f1 = tested->Publish(MakeParams("d1"));
+  EXPECT_EQ(2, tested->pending_messages());
+  capture->Complete();
+  capture->Complete();
+  EXPECT_EQ(0, tested->pending_messages());
+  EXPECT_EQ(0, tested->pending_bytes());
+  ASSERT_STATUS_OK(f0.get());
+  ASSERT_STATUS_OK(f1.get());
+}
+
+TEST(FlowControlledPublisherConnectionTest, RejectsMessages) {
+  auto capture = std::make_shared<PublishCapture>();
+  auto mock = MakeMock(capture);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}
+          .set_maximum_pending_messages(2)
+          .set_full_publisher_rejects(),
+      mock);
+
+  auto f0 = tested->Publish(MakeParams("d0"));
+  auto f1 = tested->Publish(MakeParams("d1"));
+  auto f2 = tested->Publish(MakeParams("d2"));
+  EXPECT_THAT(f2.get().status(), StatusIs(StatusCode::kFailedPrecondition));
+  EXPECT_EQ(2, tested->pending_messages());
+
+  capture->Complete();
+  auto r0 = f0.get();
+  ASSERT_STATUS_OK(r0);
+  EXPECT_EQ("id-d0", *r0);
+  auto f3 = tested->Publish(MakeParams("d3"));
+  capture->Complete();
+  capture->Complete();
+  ASSERT_STATUS_OK(f1.get());
+  ASSERT_STATUS_OK(f3.get());
+  EXPECT_THAT(capture->data(), ::testing::ElementsAre("d0", "d1", "d3"));
+}
+
+TEST(FlowControlledPublisherConnectionTest, RejectsBytes) {
+  auto capture = std::make_shared<PublishCapture>();
+  auto mock = MakeMock(capture);
+  auto const message_size = MessageSize(MakeParams("d0").message);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}
+          .set_maximum_pending_bytes(message_size + message_size / 2)
+          .set_full_publisher_rejects(),
+      mock);
+
+  auto f0 = tested->Publish(MakeParams("d0"));
+  EXPECT_EQ(message_size, tested->pending_bytes());
+  auto f1 = tested->Publish(MakeParams("d1"));
+  EXPECT_THAT(f1.get().status(), StatusIs(StatusCode::kFailedPrecondition));
+  capture->Complete();
+  ASSERT_STATUS_OK(f0.get());
+  EXPECT_EQ(0, tested->pending_bytes());
+}
+
+TEST(FlowControlledPublisherConnectionTest, LargeMessageAcceptedWhenEmpty) {
+  auto capture = std::make_shared<PublishCapture>();
+  auto mock = MakeMock(capture);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}
+          .set_maximum_pending_bytes(1)
+          .set_full_publisher_rejects(),
+      mock);
+
+  auto f0 = tested->Publish(MakeParams("larger-than-the-limit"));
+  capture->Complete();
+  ASSERT_STATUS_OK(f0.get());
+}
+
+TEST(FlowControlledPublisherConnectionTest, Blocks) {
+  auto capture = std::make_shared<PublishCapture>();
+  auto mock = MakeMock(capture);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}
+          .set_maximum_pending_messages(1)
+          .set_full_publisher_blocks(),
+      mock);
+
+  auto f0 = tested->Publish(MakeParams("d0"));
+  promise<void> started;
+  std::thread t([&] {
+    started.set_value();
+    auto f1 = tested->Publish(MakeParams("d1"));
+    capture->Complete();
+    ASSERT_STATUS_OK(f1.get());
+  });
+  started.get_future().get();
+  // The second message cannot be published until the first one completes.
+  EXPECT_THAT(capture->data(), ::testing::ElementsAre("d0"));
+  capture->Complete();
+  ASSERT_STATUS_OK(f0.get());
+  t.join();
+  EXPECT_THAT(capture->data(), ::testing::ElementsAre("d0", "d1"));
+  EXPECT_EQ(0, tested->pending_messages());
+}
+
+TEST(FlowControlledPublisherConnectionTest, DiscardsOldest) {
+  auto capture = std::make_shared<PublishCapture>();
+  auto mock = MakeMock(capture);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}
+          .set_maximum_pending_messages(2)
+          .set_full_publisher_discards_oldest(),
+      mock);
+
+  std::vector<future<StatusOr<std::string>>> results;
+  for (int i = 0; i != 6; ++i) {
+    results.push_back(tested->Publish(MakeParams("d" + std::to_string(i))));
+  }
+  EXPECT_EQ(2, tested->pending_messages());
+  EXPECT_EQ(2, tested->backlog_messages());
+  // The oldest messages in the backlog are discarded.
+  EXPECT_THAT(results[2].get().status(),
+              StatusIs(StatusCode::kFailedPrecondition));
+  EXPECT_THAT(results[3].get().status(),
+              StatusIs(StatusCode::kFailedPrecondition));
+
+  // As pending messages complete the backlog is published, in order.
+  for (int i = 0; i != 4; ++i) capture->Complete();
+  EXPECT_THAT(capture->data(),
+              ::testing::ElementsAre("d0", "d1", "d4", "d5"));
+  for (auto i : {0, 1, 4, 5}) {
+    auto r = results[i].get();
+    ASSERT_STATUS_OK(r);
+    EXPECT_EQ("id-d" + std::to_string(i), *r);
+  }
+  EXPECT_EQ(0, tested->pending_messages());
+  EXPECT_EQ(0, tested->backlog_messages());
+}
+
+TEST(FlowControlledPublisherConnectionTest, BacklogCancelledOnDelete) {
+  auto capture = std::make_shared<PublishCapture>();
+  auto mock = MakeMock(capture);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}
+          .set_maximum_pending_messages(1)
+          .set_full_publisher_discards_oldest(),
+      mock);
+
+  auto f0 = tested->Publish(MakeParams("d0"));
+  auto f1 = tested->Publish(MakeParams("d1"));
+  tested.reset();
+  EXPECT_THAT(f1.get().status(), StatusIs(StatusCode::kCancelled));
+  capture->Complete();
+  ASSERT_STATUS_OK(f0.get());
+}
+
+TEST(FlowControlledPublisherConnectionTest, FlushAndResume) {
+  auto mock = std::make_shared<pubsub_mocks::MockPublisherConnection>();
+  EXPECT_CALL(*mock, Flush).Times(1);
+  EXPECT_CALL(*mock, ResumePublish).Times(1);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}.set_full_publisher_blocks(), mock);
+  tested->Flush({});
+  tested->ResumePublish({"test-ordering-key"});
+}
+
+TEST(FlowControlledPublisherConnectionTest, MemoryBudget) {
+  auto capture = std::make_shared<PublishCapture>();
+  auto mock = MakeMock(capture);
+  auto budget = std::make_shared<MemoryBudget>(1);
+  // Another client holds the whole budget.
+  MemoryAccount other(budget, "other-client", "buffers");
+  other.Acquire(1);
+  auto tested = FlowControlledPublisherConnection::Create(
+      pubsub::PublisherOptions{}, mock,
+      MemoryAccount(budget, "test-topic", "pending-messages"));
+
+  // The first message is accepted, because the publisher holds no memory.
+  auto f0 = tested->Publish(MakeParams("d0"));
+  auto f1 = tested->Publish(MakeParams("d1"));
+  EXPECT_THAT(f1.get().status(), StatusIs(StatusCode::kFailedPrecondition));
+  auto const usage = budget->Usage();
+  ASSERT_EQ(2, usage.size());
+  EXPECT_EQ("test-topic", usage[1].client);
+  EXPECT_EQ("pending-messages", usage[1].subsystem);
+  EXPECT_LT(0, usage[1].bytes);
+
+  capture->Complete();
+  ASSERT_STATUS_OK(f0.get());
+  EXPECT_EQ(1, budget->used_bytes());
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,78 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/flush_scheduler.h"
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+void FlushScheduler::Schedule(Clock::time_point deadline,
+                              std::function<void()> callback) {
+  std::unique_lock<std::mutex> lk(mu_);
+  pending_.emplace(deadline, std::move(callback));
+  if (timer_running_ && timer_deadline_ <= deadline) return;
+  StartTimer(std::move(lk), deadline);
+}
+
+std::size_t FlushScheduler::pending() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return pending_.size();
+}
+
+void FlushScheduler::StartTimer(std::unique_lock<std::mutex> lk,
+                                Clock::time_point deadline) {
+  timer_running_ = true;
+  timer_deadline_ = deadline;
+  lk.unlock();
+  // This class is owned by the publisher connections, which own the
+  // completion queue, a `shared_ptr<>` would create a cycle.
+  std::weak_ptr<FlushScheduler> weak = shared_from_this();
+  cq_.MakeDeadlineTimer(deadline).then(
+      [weak, deadline](future<StatusOr<Clock::time_point>> f) {
+        if (auto self = weak.lock()) self->OnTimer(deadline, f.get().ok());
+      });
+}
+
+void FlushScheduler::OnTimer(Clock::time_point deadline, bool ok) {
+  std::unique_lock<std::mutex> lk(mu_);
+  // A timer replaced by an earlier one may still fire, only the earliest timer
+  // needs to be replaced.
+  if (timer_running_ && timer_deadline_ == deadline) timer_running_ = false;
+  // The completion queue is shutting down, the timers would fail immediately.
+  if (!ok) return;
+
+  std::vector<std::function<void()>> due;
+  auto const now = Clock::now();
+  auto end = pending_.upper_bound(now);
+  for (auto i = pending_.begin(); i != end; ++i) {
+    due.push_back(std::move(i->second));
+  }
+  pending_.erase(pending_.begin(), end);
+  if (!pending_.empty() && !timer_running_) {
+    StartTimer(std::move(lk), pending_.begin()->first);
+  } else {
+    lk.unlock();
+  }
+  // The callbacks flush their batches, run them without holding the lock so
+  // they can schedule new deadlines.
+  for (auto& f : due) f();
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
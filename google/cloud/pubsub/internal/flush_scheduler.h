@@ -0,0 +1,80 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_FLUSH_SCHEDULER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_FLUSH_SCHEDULER_H
+
+#include "google/cloud/pubsub/version.h"
+#include "google/cloud/completion_queue.h"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * Runs the hold-time flushes for many batching publishers from one timer.
+ *
+ * With message ordering there is a `BatchingPublisherConnection` per ordering
+ * key. Applications may use hundreds of thousands of keys, and if each
+ * connection created its own timer for `maximum_hold_time`, the completion
+ * queue would manage a timer per key. Instead, the connections register their
+ * flush deadlines here. The scheduler keeps the deadlines in a single ordered
+ * structure and only keeps a timer for the earliest one. All the flushes that
+ * are due when a timer fires run in the same pass.
+ *
+ * Since all the connections use the same hold time, a new deadline is almost
+ * always later than the pending ones, and does not create a new timer.
+ */
+class FlushScheduler : public std::enable_shared_from_this<FlushScheduler> {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  static std::shared_ptr<FlushScheduler> Create(
+      google::cloud::CompletionQueue cq) {
+    return std::shared_ptr<FlushScheduler>(new FlushScheduler(std::move(cq)));
+  }
+
+  /// Run @p callback at (or shortly after) @p deadline.
+  void Schedule(Clock::time_point deadline, std::function<void()> callback);
+
+  /// The number of callbacks waiting for their deadline, for testing.
+  std::size_t pending() const;
+
+ private:
+  explicit FlushScheduler(google::cloud::CompletionQueue cq)
+      : cq_(std::move(cq)) {}
+
+  void StartTimer(std::unique_lock<std::mutex> lk, Clock::time_point deadline);
+  void OnTimer(Clock::time_point deadline, bool ok);
+
+  google::cloud::CompletionQueue cq_;
+  mutable std::mutex mu_;
+  std::multimap<Clock::time_point, std::function<void()>> pending_;
+  // The deadline of the earliest timer, if `timer_running_` is true.
+  bool timer_running_ = false;
+  Clock::time_point timer_deadline_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_FLUSH_SCHEDULER_H
@@ -0,0 +1,93 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/flush_scheduler.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include <gmock/gmock.h>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(FlushSchedulerTest, RunsInDeadlineOrder) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto tested = FlushScheduler::Create(background.cq());
+
+  std::mutex mu;
+  std::vector<int> calls;
+  promise<void> done;
+  auto record = [&](int id) {
+    return [&mu, &calls, &done, id] {
+      std::lock_guard<std::mutex> lk(mu);
+      calls.push_back(id);
+      if (calls.size() == 3) done.set_value();
+    };
+  };
+  auto const now = FlushScheduler::Clock::now();
+  using ms = std::chrono::milliseconds;
+  tested->Schedule(now + ms(20), record(2));
+  tested->Schedule(now + ms(30), record(3));
+  // An earlier deadline replaces the timer.
+  tested->Schedule(now + ms(10), record(1));
+
+  done.get_future().get();
+  std::lock_guard<std::mutex> lk(mu);
+  EXPECT_THAT(calls, ElementsAre(1, 2, 3));
+  EXPECT_EQ(0, tested->pending());
+}
+
+TEST(FlushSchedulerTest, RunsDueCallbacksTogether) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto tested = FlushScheduler::Create(background.cq());
+
+  auto constexpr kCount = 1000;
+  std::mutex mu;
+  int count = 0;
+  promise<void> done;
+  auto const deadline =
+      FlushScheduler::Clock::now() + std::chrono::milliseconds(10);
+  for (int i = 0; i != kCount; ++i) {
+    tested->Schedule(deadline, [&] {
+      std::lock_guard<std::mutex> lk(mu);
+      if (++count == kCount) done.set_value();
+    });
+  }
+  done.get_future().get();
+  EXPECT_EQ(0, tested->pending());
+}
+
+TEST(FlushSchedulerTest, CallbackCanSchedule) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto tested = FlushScheduler::Create(background.cq());
+
+  promise<void> done;
+  auto const now = FlushScheduler::Clock::now();
+  tested->Schedule(now, [&] {
+    tested->Schedule(FlushScheduler::Clock::now(),
+                     [&done] { done.set_value(); });
+  });
+  done.get_future().get();
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,87 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/multiplexed_batch_source.h"
+#include <functional>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+void MultiplexedBatchSource::Start(BatchCallback callback) {
+  for (auto& c : children_) c->Start(callback);
+}
+
+void MultiplexedBatchSource::Shutdown() {
+  for (auto& c : children_) c->Shutdown();
+}
+
+void MultiplexedBatchSource::AckMessage(std::string const& ack_id) {
+  Child(ack_id).AckMessage(ack_id);
+}
+
+void MultiplexedBatchSource::NackMessage(std::string const& ack_id) {
+  Child(ack_id).NackMessage(ack_id);
+}
+
+void MultiplexedBatchSource::BulkNack(std::vector<std::string> ack_ids) {
+  auto partitions = Partition(std::move(ack_ids));
+  for (std::size_t i = 0; i != children_.size(); ++i) {
+    if (partitions[i].empty()) continue;
+    children_[i]->BulkNack(std::move(partitions[i]));
+  }
+}
+
+void MultiplexedBatchSource::ExtendLeases(std::vector<std::string> ack_ids,
+                                          std::chrono::seconds extension) {
+  auto partitions = Partition(std::move(ack_ids));
+  for (std::size_t i = 0; i != children_.size(); ++i) {
+    if (partitions[i].empty()) continue;
+    children_[i]->ExtendLeases(std::move(partitions[i]), extension);
+  }
+}
+
+SubscriptionBatchSource& MultiplexedBatchSource::Child(
+    std::string const& ack_id) {
+  return *children_[std::hash<std::string>{}(ack_id) % children_.size()];
+}
+
+std::vector<std::vector<std::string>> MultiplexedBatchSource::Partition(
+    std::vector<std::string> ack_ids) {
+  std::vector<std::vector<std::string>> partitions(children_.size());
+  for (auto& a : ack_ids) {
+    auto const i = std::hash<std::string>{}(a) % children_.size();
+    partitions[i].push_back(std::move(a));
+  }
+  return partitions;
+}
+
+pubsub::SubscriberOptions PerStreamOptions(pubsub::SubscriberOptions options,
+                                           std::size_t streams) {
+  if (streams <= 1) return options;
+  auto const n = static_cast<std::int64_t>(streams);
+  // Round up, so each stream can receive at least one message. A value of 0
+  // means "unlimited" and is preserved.
+  auto divide = [n](std::int64_t v) { return v <= 0 ? v : (v + n - 1) / n; };
+  options.set_max_outstanding_messages(
+      divide(options.max_outstanding_messages()));
+  options.set_max_outstanding_bytes(divide(options.max_outstanding_bytes()));
+  return options;
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
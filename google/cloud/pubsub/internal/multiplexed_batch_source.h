@@ -0,0 +1,78 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_MULTIPLEXED_BATCH_SOURCE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_MULTIPLEXED_BATCH_SOURCE_H
+
+#include "google/cloud/pubsub/internal/subscription_batch_source.h"
+#include "google/cloud/pubsub/subscriber_options.h"
+#include "google/cloud/pubsub/version.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * Combines several batch sources, typically one per streaming pull.
+ *
+ * A single streaming pull caps the throughput of a subscription. This class
+ * merges the messages from several sources into a single callback, so the rest
+ * of the pipeline (lease management, message queue, and concurrency control)
+ * is shared by all of them.
+ *
+ * The service accepts acknowledgements for a subscription on any stream, the
+ * acks, nacks and lease extensions are spread across the children using the
+ * hash of their ack id.
+ */
+class MultiplexedBatchSource : public SubscriptionBatchSource {
+ public:
+  explicit MultiplexedBatchSource(
+      std::vector<std::shared_ptr<SubscriptionBatchSource>> children)
+      : children_(std::move(children)) {}
+
+  void Start(BatchCallback callback) override;
+  void Shutdown() override;
+  void AckMessage(std::string const& ack_id) override;
+  void NackMessage(std::string const& ack_id) override;
+  void BulkNack(std::vector<std::string> ack_ids) override;
+  void ExtendLeases(std::vector<std::string> ack_ids,
+                    std::chrono::seconds extension) override;
+
+ private:
+  SubscriptionBatchSource& Child(std::string const& ack_id);
+  std::vector<std::vector<std::string>> Partition(
+      std::vector<std::string> ack_ids);
+
+  std::vector<std::shared_ptr<SubscriptionBatchSource>> const children_;
+};
+
+/**
+ * Returns the options for each of @p streams concurrent streaming pulls.
+ *
+ * The flow control limits in @p options apply to the subscription, they are
+ * divided across the streams so the total is respected.
+ */
+pubsub::SubscriberOptions PerStreamOptions(pubsub::SubscriberOptions options,
+                                           std::size_t streams);
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_MULTIPLEXED_BATCH_SOURCE_H
@@ -0,0 +1,132 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/multiplexed_batch_source.h"
+#include "google/cloud/pubsub/testing/mock_subscription_batch_source.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::testing::_;
+using ::testing::UnorderedElementsAreArray;
+
+std::vector<std::shared_ptr<pubsub_testing::MockSubscriptionBatchSource>>
+MakeMocks(int count) {
+  std::vector<std::shared_ptr<pubsub_testing::MockSubscriptionBatchSource>>
+      mocks(count);
+  for (auto& m : mocks) {
+    m = std::make_shared<pubsub_testing::MockSubscriptionBatchSource>();
+  }
+  return mocks;
+}
+
+std::vector<std::shared_ptr<SubscriptionBatchSource>> AsChildren(
+    std::vector<std::shared_ptr<pubsub_testing::MockSubscriptionBatchSource>>
+        mocks) {
+  return {mocks.begin(), mocks.end()};
+}
+
+TEST(MultiplexedBatchSourceTest, StartAndShutdown) {
+  auto mocks = MakeMocks(3);
+  std::vector<BatchCallback> callbacks;
+  for (auto& m : mocks) {
+    EXPECT_CALL(*m, Start).WillOnce([&callbacks](BatchCallback cb) {
+      callbacks.push_back(std::move(cb));
+    });
+    EXPECT_CALL(*m, Shutdown).Times(1);
+  }
+  MultiplexedBatchSource tested(AsChildren(mocks));
+
+  int count = 0;
+  tested.Start([&count](StatusOr<google::pubsub::v1::StreamingPullResponse>) {
+    ++count;
+  });
+  ASSERT_EQ(3, callbacks.size());
+  // Messages from all the children are delivered to the same callback.
+  for (auto& cb : callbacks) cb(google::pubsub::v1::StreamingPullResponse{});
+  EXPECT_EQ(3, count);
+
+  tested.Shutdown();
+}
+
+TEST(MultiplexedBatchSourceTest, AckNackRouting) {
+  auto constexpr kChildren = 4;
+  auto constexpr kCount = 100;
+  auto mocks = MakeMocks(kChildren);
+  std::vector<std::string> acked;
+  std::vector<std::string> nacked;
+  std::vector<std::string> bulk_nacked;
+  std::vector<std::string> extended;
+  for (auto& m : mocks) {
+    EXPECT_CALL(*m, AckMessage)
+        .WillRepeatedly([&](std::string const& a) { acked.push_back(a); });
+    EXPECT_CALL(*m, NackMessage)
+        .WillRepeatedly([&](std::string const& a) { nacked.push_back(a); });
+    EXPECT_CALL(*m, BulkNack)
+        .Times(testing::AtMost(1))
+        .WillRepeatedly([&](std::vector<std::string> const& ids) {
+          EXPECT_FALSE(ids.empty());
+          bulk_nacked.insert(bulk_nacked.end(), ids.begin(), ids.end());
+        });
+    EXPECT_CALL(*m, ExtendLeases(_, std::chrono::seconds(30)))
+        .Times(testing::AtMost(1))
+        .WillRepeatedly([&](std::vector<std::string> const& ids,
+                            std::chrono::seconds) {
+          EXPECT_FALSE(ids.empty());
+          extended.insert(extended.end(), ids.begin(), ids.end());
+        });
+  }
+  MultiplexedBatchSource tested(AsChildren(mocks));
+
+  std::vector<std::string> ids;
+  for (int i = 0; i != kCount; ++i) ids.push_back("ack-" + std::to_string(i));
+  for (auto const& id : ids) {
+    tested.AckMessage(id);
+    tested.NackMessage(id);
+  }
+  tested.BulkNack(ids);
+  tested.ExtendLeases(ids, std::chrono::seconds(30));
+
+  EXPECT_THAT(acked, UnorderedElementsAreArray(ids));
+  EXPECT_THAT(nacked, UnorderedElementsAreArray(ids));
+  EXPECT_THAT(bulk_nacked, UnorderedElementsAreArray(ids));
+  EXPECT_THAT(extended, UnorderedElementsAreArray(ids));
+}
+
+TEST(MultiplexedBatchSourceTest, PerStreamOptions) {
+  auto const options = pubsub::SubscriberOptions{}
+                           .set_max_outstanding_messages(100)
+                           .set_max_outstanding_bytes(1000);
+  auto single = PerStreamOptions(options, 1);
+  EXPECT_EQ(100, single.max_outstanding_messages());
+  EXPECT_EQ(1000, single.max_outstanding_bytes());
+
+  auto actual = PerStreamOptions(options, 3);
+  EXPECT_EQ(34, actual.max_outstanding_messages());
+  EXPECT_EQ(334, actual.max_outstanding_bytes());
+
+  auto unlimited = PerStreamOptions(
+      pubsub::SubscriberOptions{}.set_max_outstanding_messages(0), 3);
+  EXPECT_EQ(0, unlimited.max_outstanding_messages());
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
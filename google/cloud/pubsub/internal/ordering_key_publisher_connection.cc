@@ -19,10 +19,23 @@ namespace cloud {
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
+std::chrono::seconds constexpr OrderingKeyPublisherConnection::
+    kDefaultIdleTimeout;
+std::size_t constexpr OrderingKeyPublisherConnection::kShardCount;
+
 future<StatusOr<std::string>> OrderingKeyPublisherConnection::Publish(
     PublishParams p) {
-  auto child = GetChild(p.message.ordering_key());
-  return child->Publish(std::move(p));
+  auto child = GetChild(p.message.ordering_key(), /*publish=*/true);
+  auto& connection = child->connection;
+  return connection->Publish(std::move(p))
+      .then([child](future<StatusOr<std::string>> f) {
+        auto r = f.get();
+        // A failure pauses the ordering key until `ResumePublish()`, the child
+        // must be preserved until then.
+        if (!r) child->paused = true;
+        --child->outstanding;
+        return r;
+      });
 }
 
 void OrderingKeyPublisherConnection::Flush(FlushParams p) {
@@ -30,25 +43,77 @@ void OrderingKeyPublisherConnection::Flush(FlushParams p) {
   // other threads may be interested in publishing events and/or adding new
   // ordering keys. Locking while performing many (potentially long) requests is
   // just not a good idea.
-  auto copy_children = [this] {
-    std::lock_guard<std::mutex> lk(mu_);
-    return children_;
-  };
-  for (auto const& kv : copy_children()) kv.second->Flush(p);
+  for (auto& shard : shards_) {
+    auto copy_children = [&shard] {
+      std::vector<std::shared_ptr<PublisherConnection>> children;
+      std::lock_guard<std::mutex> lk(shard.mu);
+      children.reserve(shard.children.size());
+      for (auto const& kv : shard.children) {
+        children.push_back(kv.second->connection);
+      }
+      return children;
+    };
+    for (auto const& c : copy_children()) c->Flush(p);
+  }
 }
 
 void OrderingKeyPublisherConnection::ResumePublish(ResumePublishParams p) {
-  auto child = GetChild(p.ordering_key);
-  child->ResumePublish(std::move(p));
+  auto child = GetChild(p.ordering_key, /*publish=*/false);
+  child->paused = false;
+  child->connection->ResumePublish(std::move(p));
+}
+
+std::size_t OrderingKeyPublisherConnection::child_count() {
+  std::size_t count = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lk(shard.mu);
+    count += shard.children.size();
+  }
+  return count;
+}
+
+OrderingKeyPublisherConnection::Shard& OrderingKeyPublisherConnection::GetShard(
+    std::string const& ordering_key) {
+  return shards_[std::hash<std::string>{}(ordering_key) % kShardCount];
+}
+
+std::shared_ptr<OrderingKeyPublisherConnection::Child>
+OrderingKeyPublisherConnection::GetChild(std::string const& ordering_key,
+                                         bool publish) {
+  auto& shard = GetShard(ordering_key);
+  auto const now = Clock::now();
+  // Destroy any removed children after releasing the lock.
+  std::vector<std::shared_ptr<Child>> removed;
+  std::lock_guard<std::mutex> lk(shard.mu);
+  if (now >= shard.next_cleanup) {
+    RemoveIdleChildren(shard, now, removed);
+    shard.next_cleanup = now + idle_timeout_;
+  }
+  auto i = shard.children.emplace(ordering_key, std::shared_ptr<Child>{});
+  if (i.second) {
+    i.first->second = std::make_shared<Child>(factory_(ordering_key));
+  }
+  auto child = i.first->second;
+  child->last_used = now;
+  // Increment while holding the lock, so the child is not removed before the
+  // message is published.
+  if (publish) ++child->outstanding;
+  return child;
 }
 
-std::shared_ptr<pubsub::PublisherConnection>
-OrderingKeyPublisherConnection::GetChild(std::string const& ordering_key) {
-  std::lock_guard<std::mutex> lk(mu_);
-  auto i =
-      children_.emplace(ordering_key, std::shared_ptr<PublisherConnection>{});
-  if (i.second) i.first->second = factory_(ordering_key);
-  return i.first->second;
+void OrderingKeyPublisherConnection::RemoveIdleChildren(
+    Shard& shard, Clock::time_point now,
+    std::vector<std::shared_ptr<Child>>& removed) {
+  for (auto i = shard.children.begin(); i != shard.children.end();) {
+    auto const& child = *i->second;
+    if (child.outstanding.load() != 0 || child.paused.load() ||
+        now - child.last_used < idle_timeout_) {
+      ++i;
+      continue;
+    }
+    removed.push_back(std::move(i->second));
+    i = shard.children.erase(i);
+  }
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
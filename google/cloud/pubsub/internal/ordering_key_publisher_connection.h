@@ -17,24 +17,43 @@
 
 #include "google/cloud/pubsub/publisher_connection.h"
 #include "google/cloud/pubsub/version.h"
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
-#include <map>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace google {
 namespace cloud {
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
+/**
+ * Publishes messages with ordering keys, using a separate child connection for
+ * each ordering key.
+ *
+ * Applications may use hundreds of thousands of ordering keys, from many
+ * threads. The map from ordering keys to child connections is sharded, each
+ * shard with its own mutex, to reduce contention. Children that have been idle
+ * (no outstanding messages, and not paused by an error) for more than
+ * @p idle_timeout are removed, they are recreated if the ordering key is used
+ * again.
+ */
 class OrderingKeyPublisherConnection : public pubsub::PublisherConnection {
  public:
   using ConnectionFactory =
       std::function<std::shared_ptr<PublisherConnection>(std::string const&)>;
 
+  static auto constexpr kDefaultIdleTimeout = std::chrono::seconds(60);
+
   static std::shared_ptr<OrderingKeyPublisherConnection> Create(
-      ConnectionFactory factory) {
+      ConnectionFactory factory,
+      std::chrono::milliseconds idle_timeout = kDefaultIdleTimeout) {
     return std::shared_ptr<OrderingKeyPublisherConnection>(
-        new OrderingKeyPublisherConnection(std::move(factory)));
+        new OrderingKeyPublisherConnection(std::move(factory), idle_timeout));
   }
 
   ~OrderingKeyPublisherConnection() override = default;
@@ -43,16 +62,47 @@ class OrderingKeyPublisherConnection : public pubsub::PublisherConnection {
   void Flush(FlushParams) override;
   void ResumePublish(ResumePublishParams p) override;
 
+  /// The number of child connections, for testing.
+  std::size_t child_count();
+
  private:
-  explicit OrderingKeyPublisherConnection(ConnectionFactory factory)
-      : factory_(std::move(factory)) {}
+  OrderingKeyPublisherConnection(ConnectionFactory factory,
+                                 std::chrono::milliseconds idle_timeout)
+      : factory_(std::move(factory)), idle_timeout_(idle_timeout) {}
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Child {
+    explicit Child(std::shared_ptr<PublisherConnection> c)
+        : connection(std::move(c)) {}
+
+    std::shared_ptr<PublisherConnection> const connection;
+    // The number of messages published and not yet completed, and whether a
+    // failure paused the ordering key. These are updated without holding the
+    // shard lock.
+    std::atomic<std::size_t> outstanding{0};
+    std::atomic<bool> paused{false};
+    // Guarded by the shard mutex.
+    Clock::time_point last_used;
+  };
+
+  struct Shard {
+    std::mutex mu;
+    std::unordered_map<std::string, std::shared_ptr<Child>> children;
+    Clock::time_point next_cleanup;
+  };
+
+  Shard& GetShard(std::string const& ordering_key);
+  std::shared_ptr<Child> GetChild(std::string const& ordering_key,
+                                  bool publish);
+  void RemoveIdleChildren(Shard& shard, Clock::time_point now,
+                          std::vector<std::shared_ptr<Child>>& removed);
 
-  std::shared_ptr<PublisherConnection> GetChild(
-      std::string const& ordering_key);
+  static std::size_t constexpr kShardCount = 32;
 
   ConnectionFactory factory_;
-  std::mutex mu_;
-  std::map<std::string, std::shared_ptr<PublisherConnection>> children_;
+  std::chrono::milliseconds const idle_timeout_;
+  std::array<Shard, kShardCount> shards_;
 };
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
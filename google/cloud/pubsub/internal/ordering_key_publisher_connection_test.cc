@@ -25,6 +25,9 @@ namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 namespace {
 
+using ::testing::AtMost;
+using ::testing::Unused;
+
 TEST(OrderingKeyPublisherConnectionTest, Publish) {
   struct TestStep {
     std::string ordering_key;
@@ -75,6 +78,97 @@ TEST(OrderingKeyPublisherConnectionTest, Publish) {
   publisher->Flush({});
 }
 
+pubsub::PublisherConnection::PublishParams MakeParams(
+    std::string const& ordering_key) {
+  return {pubsub::MessageBuilder{}
+              .SetData("test-data")
+              .SetOrderingKey(ordering_key)
+              .Build()};
+}
+
+TEST(OrderingKeyPublisherConnectionTest, ManyKeys) {
+  auto constexpr kKeyCount = 1000;
+  int factory_count = 0;
+  auto factory = [&](std::string const&) {
+    ++factory_count;
+    auto mock = std::make_shared<pubsub_mocks::MockPublisherConnection>();
+    EXPECT_CALL(*mock, Publish).WillRepeatedly([](Unused) {
+      return make_ready_future(make_status_or(std::string{"ack-id"}));
+    });
+    EXPECT_CALL(*mock, Flush).Times(1);
+    return mock;
+  };
+
+  auto publisher = OrderingKeyPublisherConnection::Create(factory);
+  for (int i = 0; i != kKeyCount; ++i) {
+    ASSERT_STATUS_OK(
+        publisher->Publish(MakeParams("key-" + std::to_string(i))).get());
+  }
+  EXPECT_EQ(kKeyCount, factory_count);
+  EXPECT_EQ(kKeyCount, publisher->child_count());
+  publisher->Flush({});
+}
+
+TEST(OrderingKeyPublisherConnectionTest, RemoveIdleChildren) {
+  std::vector<promise<StatusOr<std::string>>> pending;
+  int factory_count = 0;
+  auto factory = [&](std::string const&) {
+    ++factory_count;
+    auto mock = std::make_shared<pubsub_mocks::MockPublisherConnection>();
+    EXPECT_CALL(*mock, Publish).WillRepeatedly([&](Unused) {
+      pending.emplace_back();
+      return pending.back().get_future();
+    });
+    return mock;
+  };
+
+  // With a zero timeout the children are removed as soon as they are idle.
+  auto publisher =
+      OrderingKeyPublisherConnection::Create(factory, std::chrono::seconds(0));
+  auto f0 = publisher->Publish(MakeParams("k0"));
+  auto f1 = publisher->Publish(MakeParams("k0"));
+  // The child has outstanding messages, it cannot be removed.
+  EXPECT_EQ(1, factory_count);
+  ASSERT_EQ(2, pending.size());
+  pending[0].set_value(std::string{"ack-0"});
+  pending[1].set_value(std::string{"ack-1"});
+  ASSERT_STATUS_OK(f0.get());
+  ASSERT_STATUS_OK(f1.get());
+
+  // The child is idle, it is removed and then recreated.
+  auto f2 = publisher->Publish(MakeParams("k0"));
+  EXPECT_EQ(2, factory_count);
+  EXPECT_EQ(1, publisher->child_count());
+  ASSERT_EQ(3, pending.size());
+  pending[2].set_value(std::string{"ack-2"});
+  ASSERT_STATUS_OK(f2.get());
+}
+
+TEST(OrderingKeyPublisherConnectionTest, PausedChildrenAreNotRemoved) {
+  int factory_count = 0;
+  auto factory = [&](std::string const&) {
+    ++factory_count;
+    auto mock = std::make_shared<pubsub_mocks::MockPublisherConnection>();
+    EXPECT_CALL(*mock, Publish).WillRepeatedly([](Unused) {
+      return make_ready_future(StatusOr<std::string>(
+          Status{StatusCode::kPermissionDenied, "uh-oh"}));
+    });
+    EXPECT_CALL(*mock, ResumePublish).Times(AtMost(1));
+    return mock;
+  };
+
+  auto publisher =
+      OrderingKeyPublisherConnection::Create(factory, std::chrono::seconds(0));
+  EXPECT_FALSE(publisher->Publish(MakeParams("k0")).get());
+  EXPECT_FALSE(publisher->Publish(MakeParams("k0")).get());
+  // The failure paused the ordering key, the child must be preserved.
+  EXPECT_EQ(1, factory_count);
+
+  publisher->ResumePublish({"k0"});
+  EXPECT_FALSE(publisher->Publish(MakeParams("k0")).get());
+  EXPECT_EQ(2, factory_count);
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
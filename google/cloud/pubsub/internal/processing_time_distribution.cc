@@ -0,0 +1,69 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/processing_time_distribution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+std::chrono::seconds constexpr ProcessingTimeDistribution::kMaximumValue;
+
+ProcessingTimeDistribution::ProcessingTimeDistribution(std::size_t window_size)
+    : window_size_((std::max)(window_size, std::size_t{1})),
+      buckets_(static_cast<std::size_t>(kMaximumValue.count()) + 1) {}
+
+void ProcessingTimeDistribution::Record(
+    std::chrono::nanoseconds processing_time) {
+  auto const max = static_cast<std::size_t>(kMaximumValue.count());
+  auto seconds =
+      std::chrono::duration_cast<std::chrono::seconds>(processing_time);
+  if (seconds < processing_time) ++seconds;
+  auto const bucket =
+      seconds.count() <= 0
+          ? std::size_t{0}
+          : (std::min)(max, static_cast<std::size_t>(seconds.count()));
+  if (samples_.size() == window_size_) {
+    --buckets_[samples_.front()];
+    samples_.pop_front();
+  }
+  samples_.push_back(bucket);
+  ++buckets_[bucket];
+}
+
+std::chrono::seconds ProcessingTimeDistribution::Percentile(
+    double percentile) const {
+  if (samples_.empty()) return std::chrono::seconds(0);
+  auto const p = (std::min)(100.0, (std::max)(0.0, percentile));
+  // The number of samples that must be at or below the returned value.
+  auto const rank = (std::max)(
+      std::size_t{1}, static_cast<std::size_t>(std::ceil(
+                          static_cast<double>(samples_.size()) * p / 100.0)));
+  std::size_t count = 0;
+  for (std::size_t i = 0; i != buckets_.size(); ++i) {
+    count += buckets_[i];
+    if (count >= rank) {
+      return std::chrono::seconds(static_cast<std::int64_t>(i));
+    }
+  }
+  return kMaximumValue;
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,72 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_PROCESSING_TIME_DISTRIBUTION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_PROCESSING_TIME_DISTRIBUTION_H
+
+#include "google/cloud/pubsub/version.h"
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * Tracks how long the application takes to handle messages.
+ *
+ * The lease management layer uses this distribution to pick ack deadline
+ * extensions that fit the application: messages handled in milliseconds do not
+ * need long leases (which delay redelivery if the client crashes), and
+ * messages handled in minutes should not be extended every few seconds.
+ *
+ * The distribution keeps the last `window_size` samples, with a resolution of
+ * one second, which is also the resolution of the ack deadlines. Samples are
+ * rounded up and capped at `kMaximumValue`.
+ *
+ * This class is not thread-safe, the caller must provide any synchronization.
+ */
+class ProcessingTimeDistribution {
+ public:
+  static auto constexpr kMaximumValue = std::chrono::seconds(600);
+
+  explicit ProcessingTimeDistribution(std::size_t window_size = 1000);
+
+  /// Record the time to handle one message.
+  void Record(std::chrono::nanoseconds processing_time);
+
+  /**
+   * Returns the @p percentile (in the [0, 100] range) of the samples.
+   *
+   * Returns 0 if there are no samples.
+   */
+  std::chrono::seconds Percentile(double percentile) const;
+
+  std::size_t size() const { return samples_.size(); }
+
+ private:
+  std::size_t window_size_;
+  std::deque<std::size_t> samples_;
+  std::vector<std::size_t> buckets_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_PROCESSING_TIME_DISTRIBUTION_H
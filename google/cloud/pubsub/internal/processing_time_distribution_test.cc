@@ -0,0 +1,69 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/processing_time_distribution.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::std::chrono::milliseconds;
+using ::std::chrono::seconds;
+
+TEST(ProcessingTimeDistributionTest, Empty) {
+  ProcessingTimeDistribution tested;
+  EXPECT_EQ(0, tested.size());
+  EXPECT_EQ(seconds(0), tested.Percentile(99));
+}
+
+TEST(ProcessingTimeDistributionTest, Percentile) {
+  ProcessingTimeDistribution tested;
+  for (int i = 1; i <= 100; ++i) tested.Record(seconds(i));
+  EXPECT_EQ(100, tested.size());
+  EXPECT_EQ(seconds(1), tested.Percentile(0));
+  EXPECT_EQ(seconds(50), tested.Percentile(50));
+  EXPECT_EQ(seconds(99), tested.Percentile(99));
+  EXPECT_EQ(seconds(100), tested.Percentile(100));
+}
+
+TEST(ProcessingTimeDistributionTest, RoundsUpAndCaps) {
+  ProcessingTimeDistribution tested;
+  tested.Record(milliseconds(50));
+  EXPECT_EQ(seconds(1), tested.Percentile(100));
+  tested.Record(milliseconds(2001));
+  EXPECT_EQ(seconds(3), tested.Percentile(100));
+  tested.Record(std::chrono::hours(1));
+  EXPECT_EQ(ProcessingTimeDistribution::kMaximumValue, tested.Percentile(100));
+  tested.Record(milliseconds(-5));
+  EXPECT_EQ(seconds(0), tested.Percentile(0));
+}
+
+TEST(ProcessingTimeDistributionTest, MovingWindow) {
+  ProcessingTimeDistribution tested(10);
+  for (int i = 0; i != 10; ++i) tested.Record(seconds(300));
+  EXPECT_EQ(seconds(300), tested.Percentile(99));
+  // Once the application speeds up the old samples are forgotten.
+  for (int i = 0; i != 10; ++i) tested.Record(seconds(2));
+  EXPECT_EQ(10, tested.size());
+  EXPECT_EQ(seconds(2), tested.Percentile(99));
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,119 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/publisher_fault_injection.h"
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+StatusOr<google::pubsub::v1::Topic> PublisherFaultInjection::CreateTopic(
+    grpc::ClientContext& context, google::pubsub::v1::Topic const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->CreateTopic(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::Topic> PublisherFaultInjection::GetTopic(
+    grpc::ClientContext& context,
+    google::pubsub::v1::GetTopicRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->GetTopic(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::Topic> PublisherFaultInjection::UpdateTopic(
+    grpc::ClientContext& context,
+    google::pubsub::v1::UpdateTopicRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->UpdateTopic(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::ListTopicsResponse>
+PublisherFaultInjection::ListTopics(
+    grpc::ClientContext& context,
+    google::pubsub::v1::ListTopicsRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ListTopics(context, request);
+  });
+}
+
+Status PublisherFaultInjection::DeleteTopic(
+    grpc::ClientContext& context,
+    google::pubsub::v1::DeleteTopicRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->DeleteTopic(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::DetachSubscriptionResponse>
+PublisherFaultInjection::DetachSubscription(
+    grpc::ClientContext& context,
+    google::pubsub::v1::DetachSubscriptionRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->DetachSubscription(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::ListTopicSubscriptionsResponse>
+PublisherFaultInjection::ListTopicSubscriptions(
+    grpc::ClientContext& context,
+    google::pubsub::v1::ListTopicSubscriptionsRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ListTopicSubscriptions(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::ListTopicSnapshotsResponse>
+PublisherFaultInjection::ListTopicSnapshots(
+    grpc::ClientContext& context,
+    google::pubsub::v1::ListTopicSnapshotsRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ListTopicSnapshots(context, request);
+  });
+}
+
+future<StatusOr<google::pubsub::v1::PublishResponse>>
+PublisherFaultInjection::AsyncPublish(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    google::pubsub::v1::PublishRequest const& request) {
+  using Response = StatusOr<google::pubsub::v1::PublishResponse>;
+  auto const delay = injector_->NextLatency();
+  auto status = injector_->NextError(__func__);
+  if (delay.count() == 0) {
+    if (!status.ok()) return make_ready_future(Response(std::move(status)));
+    return child_->AsyncPublish(cq, std::move(context), request);
+  }
+  // The delay must not block the caller, which may be a completion queue
+  // thread, use a timer instead. `std::function<>` requires copyable
+  // callbacks, so the context is held in a `shared_ptr<>`.
+  auto child = child_;
+  auto ctx = std::make_shared<std::unique_ptr<grpc::ClientContext>>(
+      std::move(context));
+  return cq.MakeRelativeTimer(delay).then(
+      [cq, child, ctx, request, status](
+          future<StatusOr<std::chrono::system_clock::time_point>>) mutable
+      -> future<Response> {
+        if (!status.ok()) return make_ready_future(Response(std::move(status)));
+        return child->AsyncPublish(cq, std::move(*ctx), request);
+      });
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,101 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/publisher_fault_injection.h"
+#include "google/cloud/pubsub/testing/mock_publisher_stub.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::google::cloud::internal::FaultInjector;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::HasSubstr;
+using ::testing::Return;
+
+std::shared_ptr<FaultInjector> MakeInjector(FaultInjectionOptions options) {
+  return std::make_shared<FaultInjector>(std::move(options));
+}
+
+TEST(PublisherFaultInjectionTest, Disabled) {
+  auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
+  EXPECT_CALL(*mock, GetTopic)
+      .WillOnce(Return(make_status_or(google::pubsub::v1::Topic{})));
+  PublisherFaultInjection stub(mock, MakeInjector(FaultInjectionOptions{}));
+  grpc::ClientContext context;
+  EXPECT_STATUS_OK(
+      stub.GetTopic(context, google::pubsub::v1::GetTopicRequest{}));
+}
+
+TEST(PublisherFaultInjectionTest, InjectError) {
+  auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
+  EXPECT_CALL(*mock, CreateTopic).Times(0);
+  PublisherFaultInjection stub(
+      mock, MakeInjector(FaultInjectionOptions{}.set_error_rate(1.0)));
+  grpc::ClientContext context;
+  EXPECT_THAT(stub.CreateTopic(context, google::pubsub::v1::Topic{}),
+              StatusIs(StatusCode::kUnavailable, HasSubstr("CreateTopic")));
+}
+
+TEST(PublisherFaultInjectionTest, AsyncPublishError) {
+  auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
+  EXPECT_CALL(*mock, AsyncPublish).Times(0);
+  PublisherFaultInjection stub(
+      mock, MakeInjector(FaultInjectionOptions{}.set_error_rate(1.0)));
+  google::cloud::CompletionQueue cq;
+  auto response =
+      stub.AsyncPublish(cq, absl::make_unique<grpc::ClientContext>(),
+                        google::pubsub::v1::PublishRequest{})
+          .get();
+  EXPECT_THAT(response,
+              StatusIs(StatusCode::kUnavailable, HasSubstr("AsyncPublish")));
+}
+
+TEST(PublisherFaultInjectionTest, AsyncPublishLatency) {
+  auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
+  EXPECT_CALL(*mock, AsyncPublish)
+      .WillOnce([](google::cloud::CompletionQueue&,
+                   std::unique_ptr<grpc::ClientContext>,
+                   google::pubsub::v1::PublishRequest const& request) {
+        EXPECT_EQ("test-topic-name", request.topic());
+        return make_ready_future(
+            make_status_or(google::pubsub::v1::PublishResponse{}));
+      });
+  PublisherFaultInjection stub(
+      mock, MakeInjector(FaultInjectionOptions{}
+                             .set_latency_rate(1.0)
+                             .set_latency_median(std::chrono::milliseconds(1))
+                             .set_latency_p99(std::chrono::milliseconds(2))));
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  auto cq = background.cq();
+  google::pubsub::v1::PublishRequest request;
+  request.set_topic("test-topic-name");
+  auto response =
+      stub.AsyncPublish(cq, absl::make_unique<grpc::ClientContext>(), request)
+          .get();
+  EXPECT_STATUS_OK(response);
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
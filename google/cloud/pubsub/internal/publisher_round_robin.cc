@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "google/cloud/pubsub/internal/publisher_round_robin.h"
+#include <chrono>
+#include <functional>
+#include <tuple>
 
 namespace google {
 namespace cloud {
@@ -75,14 +78,33 @@ PublisherRoundRobin::AsyncPublish(
     google::cloud::CompletionQueue& cq,
     std::unique_ptr<grpc::ClientContext> context,
     google::pubsub::v1::PublishRequest const& request) {
-  return Child()->AsyncPublish(cq, std::move(context), request);
+  // All the batches for an ordering key use the same channel, so they are
+  // received in the order they were sent, even if several are in flight.
+  std::size_t index;
+  std::shared_ptr<PublisherStub> child;
+  if (!request.messages().empty() &&
+      !request.messages(0).ordering_key().empty()) {
+    auto const hash =
+        std::hash<std::string>{}(request.messages(0).ordering_key());
+    index = hash % pool_->size();
+    child = pool_->StartRpc(index);
+  } else {
+    std::tie(index, child) = pool_->StartRpc();
+  }
+  auto pool = pool_;
+  auto const start = std::chrono::steady_clock::now();
+  return child->AsyncPublish(cq, std::move(context), request)
+      .then([pool, index, start](
+                future<StatusOr<google::pubsub::v1::PublishResponse>> f) {
+        pool->FinishRpc(index,
+                        std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start));
+        return f.get();
+      });
 }
 
 std::shared_ptr<PublisherStub> PublisherRoundRobin::Child() {
-  std::lock_guard<std::mutex> lk(mu_);
-  auto child = children_[current_];
-  current_ = (current_ + 1) % children_.size();
-  return child;
+  return pool_->Next();
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
@@ -16,9 +16,9 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_PUBLISHER_ROUND_ROBIN_H
 
 #include "google/cloud/pubsub/internal/publisher_stub.h"
+#include "google/cloud/pubsub/internal/stub_pool.h"
 #include "google/cloud/pubsub/version.h"
 #include <memory>
-#include <mutex>
 #include <vector>
 
 namespace google {
@@ -26,11 +26,23 @@ namespace cloud {
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
+/**
+ * Spreads the RPCs across several stubs, each using a different channel.
+ *
+ * The administrative RPCs use the stubs in round-robin order. The data path
+ * RPCs use the stub with the fewest RPCs in flight, so a stalled channel
+ * stops receiving new work. If @p factory is set, channels that are
+ * persistently slower than the others are reconnected.
+ */
 class PublisherRoundRobin : public PublisherStub {
  public:
+  using StubFactory = StubPool<PublisherStub>::StubFactory;
+
   explicit PublisherRoundRobin(
-      std::vector<std::shared_ptr<PublisherStub>> children)
-      : children_(std::move(children)) {}
+      std::vector<std::shared_ptr<PublisherStub>> children,
+      StubFactory factory = {})
+      : pool_(std::make_shared<StubPool<PublisherStub>>(std::move(children),
+                                                     std::move(factory))) {}
 
   StatusOr<google::pubsub::v1::Topic> CreateTopic(
       grpc::ClientContext& context,
@@ -74,9 +86,7 @@ class PublisherRoundRobin : public PublisherStub {
  private:
   std::shared_ptr<PublisherStub> Child();
 
-  std::vector<std::shared_ptr<PublisherStub>> const children_;
-  std::mutex mu_;
-  std::size_t current_ = 0;
+  std::shared_ptr<StubPool<PublisherStub>> pool_;
 };
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
@@ -227,6 +227,34 @@ TEST(PublisherRoundRobinTest, AsyncPublish) {
   }
 }
 
+TEST(PublisherRoundRobinTest, AsyncPublishOrderingKeyAffinity) {
+  auto mocks = MakeMocks();
+  std::vector<int> calls(mocks.size());
+  for (std::size_t i = 0; i != mocks.size(); ++i) {
+    EXPECT_CALL(*mocks[i], AsyncPublish)
+        .WillRepeatedly([&calls, i](google::cloud::CompletionQueue&,
+                                    std::unique_ptr<grpc::ClientContext>,
+                                    google::pubsub::v1::PublishRequest const&) {
+          ++calls[i];
+          return make_ready_future(
+              make_status_or(google::pubsub::v1::PublishResponse{}));
+        });
+  }
+  PublisherRoundRobin stub(AsPlainStubs(mocks));
+  for (int i = 0; i != kRepeats * kMockCount; ++i) {
+    google::cloud::CompletionQueue cq;
+    google::pubsub::v1::PublishRequest request;
+    request.set_topic("test-topic-name");
+    request.add_messages()->set_ordering_key("test-ordering-key");
+    auto status =
+        stub.AsyncPublish(cq, absl::make_unique<grpc::ClientContext>(), request)
+            .get();
+    EXPECT_STATUS_OK(status);
+  }
+  // All the requests for the same ordering key use the same child.
+  EXPECT_THAT(calls, ::testing::Contains(kRepeats * kMockCount));
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
@@ -14,6 +14,8 @@
 
 #include "google/cloud/pubsub/internal/sequential_batch_sink.h"
 #include "google/cloud/internal/async_retry_loop.h"
+#include <algorithm>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -21,8 +23,10 @@ namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
 SequentialBatchSink::SequentialBatchSink(
-    std::shared_ptr<pubsub_internal::BatchSink> sink)
-    : sink_(std::move(sink)) {}
+    std::shared_ptr<pubsub_internal::BatchSink> sink,
+    std::size_t pipeline_depth)
+    : sink_(std::move(sink)),
+      pipeline_depth_((std::max)(pipeline_depth, std::size_t{1})) {}
 
 future<StatusOr<google::pubsub::v1::PublishResponse>>
 SequentialBatchSink::AsyncPublish(google::pubsub::v1::PublishRequest request) {
@@ -30,11 +34,11 @@ SequentialBatchSink::AsyncPublish(google::pubsub::v1::PublishRequest request) {
   if (!corked_on_error_.ok()) {
     return make_ready_future(StatusOr<PublishResponse>(corked_on_error_));
   }
-  if (corked_on_pending_) {
+  if (in_flight_ >= pipeline_depth_) {
     queue_.push_back({std::move(request), {}});
     return queue_.back().promise.get_future();
   }
-  corked_on_pending_ = true;
+  ++in_flight_;
   lk.unlock();
 
   auto weak = WeakFromThis();
@@ -57,8 +61,10 @@ void SequentialBatchSink::ResumePublish(std::string const& ordering_key) {
 
 void SequentialBatchSink::OnPublish(Status s) {
   std::unique_lock<std::mutex> lk(mu_);
-  corked_on_pending_ = false;
-  corked_on_error_ = std::move(s);
+  --in_flight_;
+  // With more than one request in flight, a successful request completing
+  // after a failed one must not clear the error.
+  if (corked_on_error_.ok()) corked_on_error_ = std::move(s);
 
   // If the last result is an error drain the queue with that status, note that
   // no new elements will be added to the queue until ResumePublish() is called
@@ -74,14 +80,15 @@ void SequentialBatchSink::OnPublish(Status s) {
     return;
   }
 
-  // If necessary, schedule the next call.
-  if (queue_.empty()) return;
-  corked_on_pending_ = true;
-  auto pr = std::move(queue_.front());
-  queue_.pop_front();
+  // If necessary, schedule the next call(s).
+  std::vector<PendingRequest> ready;
+  while (!queue_.empty() && in_flight_ < pipeline_depth_) {
+    ++in_flight_;
+    ready.push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
   lk.unlock();
 
-  auto weak = WeakFromThis();
   struct MoveCaptureRequest {
     std::weak_ptr<SequentialBatchSink> weak;
     google::cloud::promise<StatusOr<PublishResponse>> promise;
@@ -92,8 +99,10 @@ void SequentialBatchSink::OnPublish(Status s) {
       if (auto self = weak.lock()) self->OnPublish(std::move(status));
     }
   };
-  sink_->AsyncPublish(std::move(pr.request))
-      .then(MoveCaptureRequest{WeakFromThis(), std::move(pr.promise)});
+  for (auto& pr : ready) {
+    sink_->AsyncPublish(std::move(pr.request))
+        .then(MoveCaptureRequest{WeakFromThis(), std::move(pr.promise)});
+  }
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
@@ -26,15 +26,24 @@ namespace cloud {
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
-/// Publish message batches using a stub, with retries, but no queueing.
+/**
+ * Publish message batches in order, stopping on the first error.
+ *
+ * The batches are sent to the child sink in the order they are received, with
+ * at most @p pipeline_depth requests in flight. The default sends each batch
+ * only after the previous one completes. After an error, the queued batches
+ * (and any new batches) fail with the same error, until `ResumePublish()` is
+ * called.
+ */
 class SequentialBatchSink
     : public BatchSink,
       public std::enable_shared_from_this<SequentialBatchSink> {
  public:
   static std::shared_ptr<SequentialBatchSink> Create(
-      std::shared_ptr<pubsub_internal::BatchSink> sink) {
+      std::shared_ptr<pubsub_internal::BatchSink> sink,
+      std::size_t pipeline_depth = 1) {
     return std::shared_ptr<SequentialBatchSink>(
-        new SequentialBatchSink(std::move(sink)));
+        new SequentialBatchSink(std::move(sink), pipeline_depth));
   }
 
   ~SequentialBatchSink() override = default;
@@ -50,8 +59,8 @@ class SequentialBatchSink
   }
 
  private:
-  explicit SequentialBatchSink(
-      std::shared_ptr<pubsub_internal::BatchSink> sink);
+  SequentialBatchSink(std::shared_ptr<pubsub_internal::BatchSink> sink,
+                      std::size_t pipeline_depth);
 
   using PublishResponse = google::pubsub::v1::PublishResponse;
   using PublishRequest = google::pubsub::v1::PublishRequest;
@@ -67,9 +76,10 @@ class SequentialBatchSink
   };
 
   std::shared_ptr<pubsub_internal::BatchSink> const sink_;
+  std::size_t const pipeline_depth_;
   std::mutex mu_;
   std::deque<PendingRequest> queue_;
-  bool corked_on_pending_ = false;
+  std::size_t in_flight_ = 0;
   Status corked_on_error_;
 };
 
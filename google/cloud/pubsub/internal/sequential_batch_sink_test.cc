@@ -174,6 +174,74 @@ TEST(DefaultBatchSinkTest, BasicErrorHandling) {
   EXPECT_THAT(*r5, IsProtoEqual(MakeResponse(MakeRequest(2))));
 }
 
+TEST(DefaultBatchSinkTest, Pipelined) {
+  AsyncSequencer<void> sequencer;
+  std::vector<int> sizes;
+
+  auto mock = std::make_shared<pubsub_testing::MockBatchSink>();
+  EXPECT_CALL(*mock, AsyncPublish)
+      .Times(3)
+      .WillRepeatedly([&](google::pubsub::v1::PublishRequest const& r) {
+        sizes.push_back(r.messages_size());
+        return sequencer.PushBack().then(
+            [r](future<void>) { return make_status_or(MakeResponse(r)); });
+      });
+
+  auto uut = SequentialBatchSink::Create(mock, 2);
+  auto f1 = uut->AsyncPublish(MakeRequest(1));
+  auto f2 = uut->AsyncPublish(MakeRequest(2));
+  auto f3 = uut->AsyncPublish(MakeRequest(3));
+  // The first two requests are sent without waiting.
+  EXPECT_THAT(sizes, ::testing::ElementsAre(1, 2));
+  EXPECT_EQ(1, uut->QueueDepth());
+
+  sequencer.PopFront().set_value();
+  ASSERT_THAT(f1.get(), StatusIs(StatusCode::kOk));
+  EXPECT_THAT(sizes, ::testing::ElementsAre(1, 2, 3));
+  EXPECT_EQ(0, uut->QueueDepth());
+
+  sequencer.PopFront().set_value();
+  sequencer.PopFront().set_value();
+  ASSERT_THAT(f2.get(), StatusIs(StatusCode::kOk));
+  ASSERT_THAT(f3.get(), StatusIs(StatusCode::kOk));
+}
+
+TEST(DefaultBatchSinkTest, PipelinedErrorHandling) {
+  AsyncSequencer<void> sequencer;
+
+  auto mock = std::make_shared<pubsub_testing::MockBatchSink>();
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*mock, AsyncPublish).WillOnce([&](Unused) {
+      return sequencer.PushBack().then([](future<void>) {
+        return StatusOr<google::pubsub::v1::PublishResponse>(
+            Status{StatusCode::kPermissionDenied, "uh-oh"});
+      });
+    });
+    EXPECT_CALL(*mock, AsyncPublish)
+        .WillOnce([&](google::pubsub::v1::PublishRequest const& r) {
+          return sequencer.PushBack().then(
+              [r](future<void>) { return make_status_or(MakeResponse(r)); });
+        });
+  }
+
+  auto uut = SequentialBatchSink::Create(mock, 2);
+  auto f1 = uut->AsyncPublish(MakeRequest(1));
+  auto f2 = uut->AsyncPublish(MakeRequest(2));
+  auto f3 = uut->AsyncPublish(MakeRequest(3));
+  EXPECT_EQ(1, uut->QueueDepth());
+
+  sequencer.PopFront().set_value();
+  ASSERT_THAT(f1.get(), StatusIs(StatusCode::kPermissionDenied));
+  // The queued request fails, but the request already in flight completes on
+  // its own, and its success does not clear the error.
+  ASSERT_THAT(f3.get(), StatusIs(StatusCode::kPermissionDenied));
+  sequencer.PopFront().set_value();
+  ASSERT_THAT(f2.get(), StatusIs(StatusCode::kOk));
+  auto r4 = uut->AsyncPublish(MakeRequest(3)).get();
+  ASSERT_THAT(r4, StatusIs(StatusCode::kPermissionDenied));
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
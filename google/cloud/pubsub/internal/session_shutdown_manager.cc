@@ -77,6 +77,21 @@ void SessionShutdownManager::SignalOnShutdown(std::unique_lock<std::mutex> lk) {
                  << ", outstanding_operations=" << outstanding_operations_
                  << ", result=" << result_ << ", ops=" << FormatOps(ops_);
   if (outstanding_operations_ > 0 || !shutdown_ || signaled_) return;
+  Signal(std::move(lk));
+}
+
+void SessionShutdownManager::ForceShutdownComplete(char const* caller) {
+  std::unique_lock<std::mutex> lk(mu_);
+  GCP_LOG(TRACE) << __func__ << "() - from " << caller << "()"
+                 << ", shutdown=" << shutdown_ << ", signaled=" << signaled_
+                 << ", outstanding_operations=" << outstanding_operations_
+                 << ", result=" << result_ << ", ops=" << FormatOps(ops_);
+  shutdown_ = true;
+  if (signaled_) return;
+  Signal(std::move(lk));
+}
+
+void SessionShutdownManager::Signal(std::unique_lock<std::mutex> lk) {
   // No other thread will go beyond this point, as `signaled_` is only set
   // once.
   signaled_ = true;
@@ -108,9 +108,18 @@ class SessionShutdownManager {
   // Start the shutdown process
   void MarkAsShutdown(char const* caller, Status status);
 
+  /**
+   * Complete the shutdown without waiting for the outstanding operations.
+   *
+   * The operations may still run to completion, but the promise set in
+   * `Start()` is satisfied immediately.
+   */
+  void ForceShutdownComplete(char const* caller);
+
  private:
   void LogStart(char const* caller, char const* name);
   void SignalOnShutdown(std::unique_lock<std::mutex> lk);
+  void Signal(std::unique_lock<std::mutex> lk);
 
   std::mutex mu_;
   bool shutdown_ = false;
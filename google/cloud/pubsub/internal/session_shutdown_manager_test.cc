@@ -59,6 +59,25 @@ TEST(SessionShutdownManagerTest, Basic) {
   EXPECT_EQ(expected_status, shutdown.get());
 }
 
+/// @test Verify ForceShutdownComplete() does not wait for operations.
+TEST(SessionShutdownManagerTest, ForceShutdownComplete) {
+  SessionShutdownManager tested;
+  auto shutdown = tested.Start({});
+  EXPECT_TRUE(tested.StartOperation("testing", "operation-1", [] {}));
+
+  auto const expected_status = Status{StatusCode::kAborted, "test-message"};
+  tested.MarkAsShutdown("testing", expected_status);
+  EXPECT_EQ(std::future_status::timeout,
+            shutdown.wait_for(std::chrono::milliseconds(0)));
+
+  tested.ForceShutdownComplete("testing");
+  EXPECT_EQ(expected_status, shutdown.get());
+
+  // Late operations are still accounted for, but signal nothing.
+  EXPECT_FALSE(tested.StartOperation("testing", "operation-2", [] {}));
+  EXPECT_TRUE(tested.FinishedOperation("operation-1"));
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
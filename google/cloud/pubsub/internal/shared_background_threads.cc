@@ -0,0 +1,59 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/shared_background_threads.h"
+#include "absl/memory/memory.h"
+#include <mutex>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+using ::google::cloud::internal::AutomaticallyCreatedBackgroundThreads;
+
+std::shared_ptr<AutomaticallyCreatedBackgroundThreads> AcquirePool() {
+  // Intentionally leaked, the handles may be released during static
+  // destruction.
+  static auto* const kMutex = new std::mutex;
+  static auto* const kPool =
+      new std::weak_ptr<AutomaticallyCreatedBackgroundThreads>;
+  std::lock_guard<std::mutex> lk(*kMutex);
+  auto pool = kPool->lock();
+  if (pool) return pool;
+  auto constexpr kDefaultThreadPoolSize = 4;
+  auto const n = std::thread::hardware_concurrency();
+  pool = std::make_shared<AutomaticallyCreatedBackgroundThreads>(
+      n == 0 ? kDefaultThreadPoolSize : n);
+  *kPool = pool;
+  return pool;
+}
+
+}  // namespace
+
+SharedBackgroundThreads::SharedBackgroundThreads() : pool_(AcquirePool()) {}
+
+std::unique_ptr<BackgroundThreads> MakeBackgroundThreads(
+    pubsub::ConnectionOptions const& options) {
+  if (options.background_threads_configured()) {
+    return options.background_threads_factory()();
+  }
+  return absl::make_unique<SharedBackgroundThreads>();
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
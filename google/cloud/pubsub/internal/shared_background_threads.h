@@ -0,0 +1,68 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_SHARED_BACKGROUND_THREADS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_SHARED_BACKGROUND_THREADS_H
+
+#include "google/cloud/pubsub/connection_options.h"
+#include "google/cloud/pubsub/version.h"
+#include "google/cloud/background_threads.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * A handle to the background threads shared by all the Pub/Sub connections.
+ *
+ * Applications often create one publisher for each topic, and one subscriber
+ * for each subscription. With a separate thread pool for each connection a
+ * process may end up with hundreds of mostly idle threads. Instead, the
+ * connections share a single pool, with one thread per core. The pool is
+ * created on demand and released when the last handle is destroyed.
+ */
+class SharedBackgroundThreads : public BackgroundThreads {
+ public:
+  using Pool = google::cloud::internal::AutomaticallyCreatedBackgroundThreads;
+
+  SharedBackgroundThreads();
+  ~SharedBackgroundThreads() override = default;
+
+  CompletionQueue cq() const override { return pool_->cq(); }
+
+  /// The shared pool, for testing.
+  std::shared_ptr<Pool> pool() const { return pool_; }
+
+ private:
+  std::shared_ptr<Pool> pool_;
+};
+
+/**
+ * Creates the background threads for a Pub/Sub connection.
+ *
+ * Returns a handle to the shared background threads unless the application
+ * configured the background threads in @p options.
+ */
+std::unique_ptr<BackgroundThreads> MakeBackgroundThreads(
+    pubsub::ConnectionOptions const& options);
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_SHARED_BACKGROUND_THREADS_H
@@ -0,0 +1,83 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/shared_background_threads.h"
+#include "google/cloud/future.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::google::cloud::internal::AutomaticallyCreatedBackgroundThreads;
+using ::google::cloud::internal::CustomerSuppliedBackgroundThreads;
+
+pubsub::ConnectionOptions TestOptions() {
+  return pubsub::ConnectionOptions(grpc::InsecureChannelCredentials());
+}
+
+TEST(SharedBackgroundThreadsTest, SharedByDefault) {
+  auto a = MakeBackgroundThreads(TestOptions());
+  auto b = MakeBackgroundThreads(TestOptions());
+  auto* sa = dynamic_cast<SharedBackgroundThreads*>(a.get());
+  auto* sb = dynamic_cast<SharedBackgroundThreads*>(b.get());
+  ASSERT_NE(nullptr, sa);
+  ASSERT_NE(nullptr, sb);
+  EXPECT_EQ(sa->pool(), sb->pool());
+  EXPECT_LE(1, sa->pool()->pool_size());
+
+  // Verify the threads run work scheduled on the completion queue.
+  promise<std::thread::id> p;
+  a->cq().RunAsync(
+      [&p](CompletionQueue&) { p.set_value(std::this_thread::get_id()); });
+  EXPECT_NE(std::this_thread::get_id(), p.get_future().get());
+}
+
+TEST(SharedBackgroundThreadsTest, ReleasedWhenUnused) {
+  std::weak_ptr<SharedBackgroundThreads::Pool> weak;
+  {
+    SharedBackgroundThreads handle;
+    weak = handle.pool();
+    EXPECT_FALSE(weak.expired());
+  }
+  EXPECT_TRUE(weak.expired());
+}
+
+TEST(SharedBackgroundThreadsTest, ConfiguredPoolSize) {
+  auto background = MakeBackgroundThreads(
+      TestOptions().set_background_thread_pool_size(2));
+  EXPECT_EQ(nullptr, dynamic_cast<SharedBackgroundThreads*>(background.get()));
+  auto* tp =
+      dynamic_cast<AutomaticallyCreatedBackgroundThreads*>(background.get());
+  ASSERT_NE(nullptr, tp);
+  EXPECT_EQ(2, tp->pool_size());
+}
+
+TEST(SharedBackgroundThreadsTest, CustomCompletionQueue) {
+  CompletionQueue cq;
+  auto background =
+      MakeBackgroundThreads(TestOptions().DisableBackgroundThreads(cq));
+  EXPECT_EQ(nullptr, dynamic_cast<SharedBackgroundThreads*>(background.get()));
+  EXPECT_NE(nullptr, dynamic_cast<CustomerSuppliedBackgroundThreads*>(
+                         background.get()));
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -14,12 +14,46 @@
 
 #include "google/cloud/pubsub/internal/streaming_subscription_batch_source.h"
 #include "google/cloud/log.h"
+#include <algorithm>
+#include <iterator>
 #include <ostream>
 
 namespace google {
 namespace cloud {
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+std::size_t RequestBytes(std::string const& ack_id) { return ack_id.size(); }
+
+std::size_t RequestBytes(
+    std::pair<std::string, std::chrono::seconds> const& deadline) {
+  return deadline.first.size() + sizeof(std::int32_t);
+}
+
+/**
+ * Remove a prefix of @p queue that fits in the remaining @p bytes budget.
+ *
+ * The first element of a request is always included, so very large ack ids
+ * make progress.
+ */
+template <typename T>
+std::vector<T> TakeFront(std::vector<T>& queue, std::size_t& bytes,
+                         std::size_t max_bytes) {
+  auto end = queue.begin();
+  while (end != queue.end() && bytes < max_bytes) {
+    auto const size = RequestBytes(*end);
+    if (bytes != 0 && bytes + size > max_bytes) break;
+    bytes += size;
+    ++end;
+  }
+  std::vector<T> result(std::make_move_iterator(queue.begin()),
+                        std::make_move_iterator(end));
+  queue.erase(queue.begin(), end);
+  return result;
+}
+
+}  // namespace
 
 void StreamingSubscriptionBatchSource::Start(BatchCallback callback) {
   std::unique_lock<std::mutex> lk(mu_);
@@ -37,18 +71,27 @@ void StreamingSubscriptionBatchSource::Shutdown() {
   std::unique_lock<std::mutex> lk(mu_);
   if (shutdown_ || !stream_) return;
   shutdown_ = true;
-  if (stream_) stream_->Cancel();
+  // Flush any queued acks and nacks before closing the stream, `OnWrite()`
+  // cancels the stream once the queues are empty.
+  if (pending_write_) return;
+  if (stream_state_ == StreamState::kActive && HasQueuedRequests(lk)) {
+    DrainQueues(std::move(lk), true);
+    return;
+  }
+  stream_->Cancel();
 }
 
 void StreamingSubscriptionBatchSource::AckMessage(std::string const& ack_id) {
   std::unique_lock<std::mutex> lk(mu_);
   ack_queue_.push_back(ack_id);
+  queued_bytes_ += RequestBytes(ack_id);
   DrainQueues(std::move(lk), false);
 }
 
 void StreamingSubscriptionBatchSource::NackMessage(std::string const& ack_id) {
   std::unique_lock<std::mutex> lk(mu_);
   nack_queue_.push_back(ack_id);
+  queued_bytes_ += RequestBytes(ack_id);
   DrainQueues(std::move(lk), false);
 }
 
@@ -56,6 +99,7 @@ void StreamingSubscriptionBatchSource::BulkNack(
     std::vector<std::string> ack_ids) {
   std::unique_lock<std::mutex> lk(mu_);
   for (auto& a : ack_ids) {
+    queued_bytes_ += RequestBytes(a);
     nack_queue_.push_back(std::move(a));
   }
   DrainQueues(std::move(lk), false);
@@ -66,6 +110,7 @@ void StreamingSubscriptionBatchSource::ExtendLeases(
   std::unique_lock<std::mutex> lk(mu_);
   for (auto& a : ack_ids) {
     deadlines_queue_.emplace_back(std::move(a), extension);
+    queued_bytes_ += RequestBytes(deadlines_queue_.back());
   }
   DrainQueues(std::move(lk), false);
 }
@@ -295,23 +340,42 @@ void StreamingSubscriptionBatchSource::OnFinish(Status status) {
   });
 }
 
+bool StreamingSubscriptionBatchSource::HasQueuedRequests(
+    std::unique_lock<std::mutex> const&) const {
+  return !ack_queue_.empty() || !nack_queue_.empty() ||
+         !deadlines_queue_.empty();
+}
+
 void StreamingSubscriptionBatchSource::DrainQueues(
     std::unique_lock<std::mutex> lk, bool force_flush) {
-  auto const threshold = force_flush ? 1 : ack_batching_config_.max_batch_size;
-  if (ack_queue_.size() < threshold && nack_queue_.size() < threshold &&
-      deadlines_queue_.empty()) {
+  // Acks, nacks and deadline extensions are coalesced into a single request,
+  // which is sent once enough of them are queued, or when the timer expires.
+  auto const count =
+      ack_queue_.size() + nack_queue_.size() + deadlines_queue_.size();
+  if (count == 0) return;
+  if (!force_flush && count < ack_batching_config_.max_batch_size &&
+      queued_bytes_ < ack_batching_config_.max_batch_bytes) {
     return;
   }
   if (stream_state_ != StreamState::kActive || pending_write_) return;
   auto stream = stream_;
   pending_write_ = true;
 
-  std::vector<std::string> acks;
-  acks.swap(ack_queue_);
-  std::vector<std::string> nacks;
-  nacks.swap(nack_queue_);
-  std::vector<std::pair<std::string, std::chrono::seconds>> deadlines;
-  deadlines.swap(deadlines_queue_);
+  // Each request is capped at `max_batch_bytes`, anything left over is sent
+  // once this write completes.
+  std::size_t bytes = 0;
+  auto const max_bytes = ack_batching_config_.max_batch_bytes;
+  auto acks = TakeFront(ack_queue_, bytes, max_bytes);
+  auto nacks = TakeFront(nack_queue_, bytes, max_bytes);
+  auto deadlines = TakeFront(deadlines_queue_, bytes, max_bytes);
+  queued_bytes_ -= (std::min)(queued_bytes_, bytes);
+  // If the request did not fit all the queued data, the rest is sent as soon
+  // as this write completes. Hint gRPC to hold this request until then, so
+  // both requests can share the same HTTP/2 frames and `sendmsg()` calls.
+  corked_write_ = HasQueuedRequests(lk);
+  auto const options = corked_write_
+                           ? grpc::WriteOptions{}.set_buffer_hint()
+                           : grpc::WriteOptions{}.set_write_through();
   lk.unlock();
 
   google::pubsub::v1::StreamingPullRequest request;
@@ -329,19 +393,25 @@ void StreamingSubscriptionBatchSource::DrainQueues(
   // best-effort anyway, there is no guarantee that the server will act on any
   // of these.
   auto weak = WeakFromThis();
-  stream->Write(request, grpc::WriteOptions{}.set_write_through())
-      .then([weak, stream](future<bool> f) {
-        if (auto self = weak.lock()) self->OnWrite(f.get());
-      });
+  stream->Write(request, options).then([weak, stream](future<bool> f) {
+    if (auto self = weak.lock()) self->OnWrite(f.get());
+  });
 }
 
 void StreamingSubscriptionBatchSource::OnWrite(bool ok) {
   std::unique_lock<std::mutex> lk(mu_);
   pending_write_ = false;
   if (ok && stream_state_ == StreamState::kActive && !shutdown_) {
-    DrainQueues(std::move(lk), false);
+    // A corked write is only flushed by the next write, send it right away.
+    DrainQueues(std::move(lk), corked_write_);
+    return;
+  }
+  // During shutdown keep writing until the queues are empty.
+  if (ok && stream_state_ == StreamState::kActive && HasQueuedRequests(lk)) {
+    DrainQueues(std::move(lk), true);
     return;
   }
+  if (shutdown_ && stream_) stream_->Cancel();
   ShutdownStream(std::move(lk), ok ? "state" : "write error");
 }
 
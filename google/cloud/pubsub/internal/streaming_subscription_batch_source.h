@@ -40,22 +40,27 @@ inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 /**
  * Configuration parameters to batch Ack/Nack responses.
  *
- * To minimize I/O overhead we batch the Ack/Nack responses from the application
- * into larger `Write()` requests. Some test set these numbers to different
- * values, and in the future we may expose them to the application via
- * `pubsub::SubscriberOptions`. For now they are only available in
- * `pubsub_internal` because it is always easy to add new APIs later vs.
- * removing these any APIs or accessors.
+ * To minimize I/O overhead we batch the Ack/Nack responses (and the deadline
+ * extensions) from the application into larger `Write()` requests. The
+ * application configures these values via `pubsub::SubscriberOptions`, some
+ * tests set them directly.
  */
 struct AckBatchingConfig {
   AckBatchingConfig() = default;
   AckBatchingConfig(std::size_t s, std::chrono::milliseconds t)
       : max_batch_size(s), max_hold_time(t) {}
+  AckBatchingConfig(std::size_t s, std::size_t b, std::chrono::milliseconds t)
+      : max_batch_size(s), max_batch_bytes(b), max_hold_time(t) {}
+  explicit AckBatchingConfig(pubsub::SubscriberOptions const& options)
+      : AckBatchingConfig(options.max_ack_batch_size(),
+                          options.max_ack_batch_bytes(),
+                          options.max_ack_hold_time()) {}
 
   // The defaults are biased towards high-throughput applications. Note that
   // the max_hold_time is small enough that it should not make a big difference,
   // the minimum ack deadline is 10 seconds.
   std::size_t max_batch_size = 1000;
+  std::size_t max_batch_bytes = 512 * 1024;
   std::chrono::milliseconds max_hold_time{100};
 };
 
@@ -139,6 +144,7 @@ class StreamingSubscriptionBatchSource
   void ShutdownStream(std::unique_lock<std::mutex> lk, char const* reason);
   void OnFinish(Status status);
 
+  bool HasQueuedRequests(std::unique_lock<std::mutex> const&) const;
   void DrainQueues(std::unique_lock<std::mutex> lk, bool force_flush);
   void OnWrite(bool ok);
 
@@ -165,12 +171,14 @@ class StreamingSubscriptionBatchSource
   StreamState stream_state_ = StreamState::kNull;
   bool shutdown_ = false;
   bool pending_write_ = false;
+  bool corked_write_ = false;
   bool pending_read_ = false;
   Status status_;
   std::shared_ptr<AsyncPullStream> stream_;
   std::vector<std::string> ack_queue_;
   std::vector<std::string> nack_queue_;
   std::vector<std::pair<std::string, std::chrono::seconds>> deadlines_queue_;
+  std::size_t queued_bytes_ = 0;
 };
 
 std::ostream& operator<<(std::ostream& os,
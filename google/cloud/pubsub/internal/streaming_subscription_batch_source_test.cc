@@ -699,6 +699,114 @@ TEST(StreamingSubscriptionBatchSourceTest, AckBatching) {
   EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
 }
 
+TEST(StreamingSubscriptionBatchSourceTest, AckBatchingBytes) {
+  auto subscription = pubsub::Subscription("test-project", "test-subscription");
+  std::string const client_id = "fake-client-id";
+
+  AsyncSequencer<void> async;
+  auto cq_impl =
+      std::make_shared<google::cloud::testing_util::MockCompletionQueueImpl>();
+  EXPECT_CALL(*cq_impl, MakeRelativeTimer)
+      .WillRepeatedly([&async](std::chrono::nanoseconds) {
+        return async.PushBack().then([](future<void>) {
+          return make_status_or(std::chrono::system_clock::now());
+        });
+      });
+  EXPECT_CALL(*cq_impl, RunAsync)
+      .WillRepeatedly([&async](std::unique_ptr<internal::RunAsyncBase> f) {
+        struct MoveCapture {
+          std::unique_ptr<internal::RunAsyncBase> function;
+          void operator()(future<void>) const { function->exec(); }
+        };
+        return async.PushBack().then(MoveCapture{std::move(f)});
+      });
+
+  // All the ack ids have the same size, the batches are limited to 3 of them.
+  auto constexpr kAckIdSize = 6;
+  auto constexpr kMaxBatchBytes = 3 * kAckIdSize;
+  FakeStream success_stream(Status{});
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  EXPECT_CALL(*mock, AsyncStreamingPull)
+      .WillOnce([&](google::cloud::CompletionQueue& cq,
+                    std::unique_ptr<grpc::ClientContext> context,
+                    google::pubsub::v1::StreamingPullRequest const& request) {
+        auto stream = success_stream.MakeWriteFailureStream(
+            cq, std::move(context), request);
+        using Request = google::pubsub::v1::StreamingPullRequest;
+        EXPECT_CALL(*stream,
+                    Write(Property(&Request::subscription, std::string{}), _))
+            .WillOnce([&](Request const& request,
+                          grpc::WriteOptions const& options) {
+              EXPECT_THAT(request.ack_ids(),
+                          ElementsAre("ack-00", "ack-01", "ack-02"));
+              EXPECT_THAT(request.modify_deadline_ack_ids(), IsEmpty());
+              EXPECT_TRUE(options.is_write_through());
+              return success_stream.AddAction("Write");
+            })
+            // Acks, nacks and deadline extensions are coalesced, but the
+            // request is capped at kMaxBatchBytes. The rest is queued, so
+            // this request is corked until the next one.
+            .WillOnce([&](Request const& request,
+                          grpc::WriteOptions const& options) {
+              EXPECT_THAT(request.ack_ids(), ElementsAre("ack-03"));
+              EXPECT_THAT(request.modify_deadline_ack_ids(),
+                          ElementsAre("nck-04"));
+              EXPECT_THAT(request.modify_deadline_seconds(), ElementsAre(0));
+              EXPECT_TRUE(options.get_buffer_hint());
+              EXPECT_FALSE(options.is_write_through());
+              return success_stream.AddAction("Write");
+            })
+            .WillOnce([&](Request const& request,
+                          grpc::WriteOptions const& options) {
+              EXPECT_THAT(request.ack_ids(), IsEmpty());
+              EXPECT_THAT(request.modify_deadline_ack_ids(),
+                          ElementsAre("ext-05"));
+              EXPECT_THAT(request.modify_deadline_seconds(), ElementsAre(10));
+              EXPECT_TRUE(options.is_write_through());
+              return success_stream.AddAction("Write");
+            });
+        return stream;
+      });
+
+  google::cloud::CompletionQueue cq(cq_impl);
+  auto shutdown = std::make_shared<SessionShutdownManager>();
+  auto uut = std::make_shared<StreamingSubscriptionBatchSource>(
+      cq, shutdown, mock, subscription.FullName(), client_id,
+      TestSubscriptionOptions(), TestRetryPolicy(), TestBackoffPolicy(),
+      AckBatchingConfig(1000, kMaxBatchBytes, std::chrono::hours(24)));
+
+  auto done = shutdown->Start({});
+  uut->Start([](StatusOr<google::pubsub::v1::StreamingPullResponse> const&) {});
+  auto timer = async.PopFront();                   // MakeRelativeTimer()
+  success_stream.WaitForAction().set_value(true);  // Start()
+  success_stream.WaitForAction().set_value(true);  // Write()
+  success_stream.WaitForAction().set_value(true);  // Read()
+  async.PopFront().set_value();                    // RunAsync()
+  auto last_read = success_stream.WaitForAction();
+
+  uut->AckMessage("ack-00");
+  uut->AckMessage("ack-01");
+  uut->AckMessage("ack-02");
+  success_stream.WaitForAction().set_value(true);
+
+  uut->AckMessage("ack-03");
+  uut->NackMessage("nck-04");
+  uut->ExtendLeases({"ext-05"}, std::chrono::seconds(10));
+  success_stream.WaitForAction().set_value(true);
+
+  // The remaining extension is below the thresholds, but it flushes the
+  // corked request, so it is sent without waiting for the timer.
+  success_stream.WaitForAction().set_value(true);
+  timer.set_value();
+
+  shutdown->MarkAsShutdown("test", {});
+  uut->Shutdown();
+  last_read.set_value(false);                      // Read()
+  success_stream.WaitForAction().set_value(true);  // Finish()
+
+  EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
+}
+
 TEST(StreamingSubscriptionBatchSourceTest, ReadErrorWaitsForWrite) {
   auto subscription = pubsub::Subscription("test-project", "test-subscription");
   std::string const client_id = "fake-client-id";
@@ -933,6 +1041,91 @@ TEST(StreamingSubscriptionBatchSourceTest, ShutdownWithPendingReadCancel) {
   EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
 }
 
+/// @test verify that a shutdown flushes the queued acks before the Cancel()
+TEST(StreamingSubscriptionBatchSourceTest, ShutdownFlushesAcks) {
+  auto subscription = pubsub::Subscription("test-project", "test-subscription");
+  std::string const client_id = "fake-client-id";
+  AutomaticallyCreatedBackgroundThreads background;
+
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  AsyncSequencer<bool> async;
+
+  auto wait_and_check_name = [&async](std::string const& name) {
+    auto p = async.PopFrontWithName();
+    EXPECT_EQ(p.second, name);
+    return std::move(p.first);
+  };
+
+  std::vector<std::string> acks;
+  auto async_pull_mock = [&](google::cloud::CompletionQueue&,
+                             std::unique_ptr<grpc::ClientContext>,
+                             google::pubsub::v1::StreamingPullRequest const&) {
+    using Response = google::pubsub::v1::StreamingPullResponse;
+    using Request = google::pubsub::v1::StreamingPullRequest;
+    auto start_response = [&async] {
+      return async.PushBack("Start").then(
+          [](future<bool> f) { return f.get(); });
+    };
+    auto write_response = [&](Request const& request,
+                              grpc::WriteOptions const&) mutable {
+      for (auto const& a : request.ack_ids()) acks.push_back(a);
+      return async.PushBack("Write").then(
+          [](future<bool> f) { return f.get(); });
+    };
+    auto read_response = [&] {
+      return async.PushBack("Read").then([](future<bool> f) {
+        if (f.get()) return absl::make_optional(Response{});
+        return absl::optional<Response>{};
+      });
+    };
+    auto cancel = [&] { async.PushBack("Cancel"); };
+    auto finish_response = [&] {
+      return async.PushBack("Finish").then(
+          [](future<bool>) { return Status{}; });
+    };
+
+    auto stream = absl::make_unique<pubsub_testing::MockAsyncPullStream>();
+    EXPECT_CALL(*stream, Start).WillOnce(start_response);
+    EXPECT_CALL(*stream, Write).WillRepeatedly(write_response);
+    EXPECT_CALL(*stream, Read).WillRepeatedly(read_response);
+    EXPECT_CALL(*stream, Cancel).WillRepeatedly(cancel);
+    EXPECT_CALL(*stream, Finish).WillOnce(finish_response);
+
+    return stream;
+  };
+  EXPECT_CALL(*mock, AsyncStreamingPull).WillOnce(async_pull_mock);
+
+  using CallbackArg = StatusOr<google::pubsub::v1::StreamingPullResponse>;
+  ::testing::MockFunction<void(CallbackArg const&)> callback;
+  EXPECT_CALL(callback, Call(StatusIs(StatusCode::kOk))).Times(0);
+
+  // Hold the acks for a long time, only the shutdown can flush them.
+  auto shutdown = std::make_shared<SessionShutdownManager>();
+  auto uut = std::make_shared<StreamingSubscriptionBatchSource>(
+      background.cq(), shutdown, mock, subscription.FullName(), client_id,
+      TestSubscriptionOptions(), TestRetryPolicy(), TestBackoffPolicy(),
+      AckBatchingConfig(100, std::chrono::seconds(60)));
+
+  auto done = shutdown->Start({});
+  uut->Start(callback.AsStdFunction());
+
+  wait_and_check_name("Start").set_value(true);
+  wait_and_check_name("Write").set_value(true);
+  auto read = wait_and_check_name("Read");
+
+  uut->AckMessage("fake-001");
+  uut->AckMessage("fake-002");
+  uut->Shutdown();
+
+  wait_and_check_name("Write").set_value(true);
+  EXPECT_THAT(acks, ElementsAre("fake-001", "fake-002"));
+  auto cancel = wait_and_check_name("Cancel");
+  read.set_value(false);
+  shutdown->MarkAsShutdown("test", Status{});
+  wait_and_check_name("Finish").set_value(true);
+  EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
+}
+
 TEST(StreamingSubscriptionBatchSourceTest, StateOStream) {
   auto as_string = [](StreamingSubscriptionBatchSource::StreamState s) {
     std::ostringstream os;
@@ -0,0 +1,92 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/stub_pool.h"
+#include <algorithm>
+#include <limits>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+// The weight of each new latency sample in the moving average.
+auto constexpr kLatencyWeight = 0.1;
+
+int constexpr ChannelLoadTracker::kMinSamples;
+double constexpr ChannelLoadTracker::kSlowFactor;
+
+std::size_t ChannelLoadTracker::StartRpc() {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto const n = channels_.size();
+  auto best = next_;
+  for (std::size_t i = 1; i != n; ++i) {
+    auto const candidate = (next_ + i) % n;
+    if (channels_[candidate].in_flight < channels_[best].in_flight) {
+      best = candidate;
+    }
+  }
+  next_ = (best + 1) % n;
+  ++channels_[best].in_flight;
+  return best;
+}
+
+void ChannelLoadTracker::StartRpc(std::size_t index) {
+  std::lock_guard<std::mutex> lk(mu_);
+  ++channels_[index].in_flight;
+}
+
+bool ChannelLoadTracker::FinishRpc(std::size_t index,
+                                   std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& c = channels_[index];
+  if (c.in_flight != 0) --c.in_flight;
+  auto const sample = static_cast<double>(latency.count());
+  c.average_latency = c.samples == 0 ? sample
+                                     : c.average_latency +
+                                           kLatencyWeight *
+                                               (sample - c.average_latency);
+  ++c.samples;
+  if (c.samples < kMinSamples) return false;
+
+  auto fastest = std::numeric_limits<double>::max();
+  for (std::size_t i = 0; i != channels_.size(); ++i) {
+    auto const& other = channels_[i];
+    if (i == index || other.samples < kMinSamples) continue;
+    fastest = (std::min)(fastest, other.average_latency);
+  }
+  if (fastest == std::numeric_limits<double>::max() || fastest <= 0) {
+    return false;
+  }
+  if (c.average_latency < kSlowFactor * fastest) return false;
+  c.average_latency = 0;
+  c.samples = 0;
+  return true;
+}
+
+void ChannelLoadTracker::FinishStream(std::size_t index) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& c = channels_[index];
+  if (c.in_flight != 0) --c.in_flight;
+}
+
+std::size_t ChannelLoadTracker::in_flight(std::size_t index) const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return channels_[index].in_flight;
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,157 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_STUB_POOL_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_STUB_POOL_H
+
+#include "google/cloud/pubsub/version.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * Tracks the RPCs in flight and the latency of each channel in a pool.
+ *
+ * New RPCs go to the channel with the fewest RPCs in flight, ties are broken
+ * in round-robin order. A channel that stalls accumulates RPCs in flight, and
+ * stops receiving new ones until they complete.
+ *
+ * The tracker also keeps a moving average of the latency of each channel. A
+ * channel whose average is persistently several times higher than the fastest
+ * channel is reported as slow, so the caller can reconnect it.
+ */
+class ChannelLoadTracker {
+ public:
+  explicit ChannelLoadTracker(std::size_t size) : channels_(size) {}
+
+  /// Picks the least loaded channel, and counts a new RPC on it.
+  std::size_t StartRpc();
+
+  /// Counts a new RPC on a channel picked by the caller.
+  void StartRpc(std::size_t index);
+
+  /**
+   * Records the completion of an RPC on channel @p index.
+   *
+   * @return true if the channel is persistently slower than the others. The
+   *     latency history of the channel is reset, so only one caller sees
+   *     `true` for each slow period.
+   */
+  bool FinishRpc(std::size_t index, std::chrono::microseconds latency);
+
+  /// Records the completion of an RPC without a meaningful latency, e.g. a
+  /// streaming RPC.
+  void FinishStream(std::size_t index);
+
+  std::size_t in_flight(std::size_t index) const;
+
+  /// The number of samples before a channel can be considered slow.
+  static int constexpr kMinSamples = 100;
+  /// How much slower than the fastest channel is considered slow.
+  static double constexpr kSlowFactor = 4.0;
+
+ private:
+  struct Channel {
+    std::size_t in_flight = 0;
+    double average_latency = 0;
+    int samples = 0;
+  };
+
+  mutable std::mutex mu_;
+  std::vector<Channel> channels_;
+  std::size_t next_ = 0;
+};
+
+/**
+ * A pool of stubs, each using a different channel, with load tracking.
+ *
+ * If @p factory is set, the pool replaces the stubs for channels that are
+ * persistently slow with new stubs created by @p factory.
+ */
+template <typename Stub>
+class StubPool {
+ public:
+  using StubFactory = std::function<std::shared_ptr<Stub>(int channel_id)>;
+
+  StubPool(std::vector<std::shared_ptr<Stub>> children, StubFactory factory)
+      : children_(std::move(children)),
+        factory_(std::move(factory)),
+        load_(children_.size()),
+        next_channel_id_(static_cast<int>(children_.size())) {}
+
+  std::size_t size() const { return children_.size(); }
+
+  /// Returns the next stub in round-robin order, without load tracking.
+  std::shared_ptr<Stub> Next() {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto child = children_[current_];
+    current_ = (current_ + 1) % children_.size();
+    return child;
+  }
+
+  /// Picks the least loaded stub, the caller must call `Finish*(index)`.
+  std::pair<std::size_t, std::shared_ptr<Stub>> StartRpc() {
+    auto const index = load_.StartRpc();
+    return {index, Get(index)};
+  }
+
+  /// Starts an RPC on a specific stub, the caller must call `Finish*(index)`.
+  std::shared_ptr<Stub> StartRpc(std::size_t index) {
+    load_.StartRpc(index);
+    return Get(index);
+  }
+
+  void FinishRpc(std::size_t index, std::chrono::microseconds latency) {
+    if (!load_.FinishRpc(index, latency) || !factory_) return;
+    std::unique_lock<std::mutex> lk(mu_);
+    auto const id = next_channel_id_++;
+    lk.unlock();
+    // Creating a stub may be slow, do it without holding the lock. RPCs in
+    // flight on the old stub complete normally.
+    auto stub = factory_(id);
+    lk.lock();
+    children_[index] = std::move(stub);
+  }
+
+  void FinishStream(std::size_t index) { load_.FinishStream(index); }
+
+ private:
+  std::shared_ptr<Stub> Get(std::size_t index) {
+    std::lock_guard<std::mutex> lk(mu_);
+    return children_[index];
+  }
+
+  std::mutex mu_;
+  std::vector<std::shared_ptr<Stub>> children_;
+  StubFactory const factory_;
+  ChannelLoadTracker load_;
+  std::size_t current_ = 0;
+  int next_channel_id_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_STUB_POOL_H
@@ -0,0 +1,147 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/stub_pool.h"
+#include <gmock/gmock.h>
+#include <set>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(ChannelLoadTrackerTest, RoundRobinWhenIdle) {
+  ChannelLoadTracker tested(3);
+  std::vector<std::size_t> picks;
+  for (int i = 0; i != 6; ++i) {
+    auto const index = tested.StartRpc();
+    picks.push_back(index);
+    tested.FinishStream(index);
+  }
+  EXPECT_THAT(picks, ElementsAre(0, 1, 2, 0, 1, 2));
+}
+
+TEST(ChannelLoadTrackerTest, PicksLeastLoaded) {
+  ChannelLoadTracker tested(3);
+  // Simulate a stalled channel with several RPCs in flight.
+  for (int i = 0; i != 3; ++i) tested.StartRpc(1);
+  std::set<std::size_t> picks;
+  for (int i = 0; i != 4; ++i) picks.insert(tested.StartRpc());
+  EXPECT_EQ(0, picks.count(1));
+  EXPECT_EQ(2, tested.in_flight(0));
+  EXPECT_EQ(3, tested.in_flight(1));
+  EXPECT_EQ(2, tested.in_flight(2));
+
+  tested.FinishStream(1);
+  tested.FinishStream(1);
+  tested.FinishStream(1);
+  EXPECT_EQ(1, tested.StartRpc());
+}
+
+TEST(ChannelLoadTrackerTest, DetectsSlowChannel) {
+  ChannelLoadTracker tested(2);
+  auto const fast = std::chrono::microseconds(1000);
+  auto const slow = std::chrono::microseconds(10000);
+  int const min_samples = ChannelLoadTracker::kMinSamples;
+  for (int i = 0; i != min_samples; ++i) {
+    tested.StartRpc(0);
+    EXPECT_FALSE(tested.FinishRpc(0, fast));
+  }
+  for (int i = 0; i != min_samples - 1; ++i) {
+    tested.StartRpc(1);
+    EXPECT_FALSE(tested.FinishRpc(1, slow));
+  }
+  tested.StartRpc(1);
+  EXPECT_TRUE(tested.FinishRpc(1, slow));
+  EXPECT_EQ(0, tested.in_flight(1));
+
+  // The history is reset after reporting a slow channel.
+  tested.StartRpc(1);
+  EXPECT_FALSE(tested.FinishRpc(1, slow));
+}
+
+TEST(ChannelLoadTrackerTest, SimilarChannelsAreNotSlow) {
+  ChannelLoadTracker tested(2);
+  int const min_samples = ChannelLoadTracker::kMinSamples;
+  for (int i = 0; i != 2 * min_samples; ++i) {
+    auto const index = tested.StartRpc();
+    auto const latency = std::chrono::microseconds(index == 0 ? 1000 : 2000);
+    EXPECT_FALSE(tested.FinishRpc(index, latency));
+  }
+}
+
+struct FakeStub {
+  int channel_id;
+};
+
+TEST(StubPoolTest, NextIsRoundRobin) {
+  StubPool<FakeStub> tested(
+      {std::make_shared<FakeStub>(FakeStub{0}),
+       std::make_shared<FakeStub>(FakeStub{1})},
+      {});
+  EXPECT_EQ(2, tested.size());
+  EXPECT_EQ(0, tested.Next()->channel_id);
+  EXPECT_EQ(1, tested.Next()->channel_id);
+  EXPECT_EQ(0, tested.Next()->channel_id);
+}
+
+TEST(StubPoolTest, ReplacesSlowStub) {
+  std::vector<int> created;
+  StubPool<FakeStub> tested(
+      {std::make_shared<FakeStub>(FakeStub{0}),
+       std::make_shared<FakeStub>(FakeStub{1})},
+      [&created](int channel_id) {
+        created.push_back(channel_id);
+        return std::make_shared<FakeStub>(FakeStub{channel_id});
+      });
+
+  auto const fast = std::chrono::microseconds(1000);
+  auto const slow = std::chrono::microseconds(10000);
+  int const min_samples = ChannelLoadTracker::kMinSamples;
+  for (int i = 0; i != min_samples; ++i) {
+    EXPECT_EQ(0, tested.StartRpc(0)->channel_id);
+    tested.FinishRpc(0, fast);
+    EXPECT_EQ(1, tested.StartRpc(1)->channel_id);
+    tested.FinishRpc(1, slow);
+  }
+  EXPECT_THAT(created, ElementsAre(2));
+  EXPECT_EQ(0, tested.StartRpc(0)->channel_id);
+  EXPECT_EQ(2, tested.StartRpc(1)->channel_id);
+}
+
+TEST(StubPoolTest, NoFactoryKeepsStub) {
+  StubPool<FakeStub> tested(
+      {std::make_shared<FakeStub>(FakeStub{0}),
+       std::make_shared<FakeStub>(FakeStub{1})},
+      {});
+  auto const fast = std::chrono::microseconds(1000);
+  auto const slow = std::chrono::microseconds(10000);
+  int const min_samples = ChannelLoadTracker::kMinSamples;
+  for (int i = 0; i != min_samples; ++i) {
+    tested.StartRpc(0);
+    tested.FinishRpc(0, fast);
+    tested.StartRpc(1);
+    tested.FinishRpc(1, slow);
+  }
+  EXPECT_EQ(1, tested.StartRpc(1)->channel_id);
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
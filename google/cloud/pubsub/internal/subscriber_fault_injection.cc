@@ -0,0 +1,158 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/subscriber_fault_injection.h"
+#include "google/cloud/internal/async_streaming_read_write_rpc_fault_injection.h"
+#include "absl/memory/memory.h"
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+StatusOr<google::pubsub::v1::Subscription>
+SubscriberFaultInjection::CreateSubscription(
+    grpc::ClientContext& context,
+    google::pubsub::v1::Subscription const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->CreateSubscription(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::Subscription>
+SubscriberFaultInjection::GetSubscription(
+    grpc::ClientContext& context,
+    google::pubsub::v1::GetSubscriptionRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->GetSubscription(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::Subscription>
+SubscriberFaultInjection::UpdateSubscription(
+    grpc::ClientContext& context,
+    google::pubsub::v1::UpdateSubscriptionRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->UpdateSubscription(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::ListSubscriptionsResponse>
+SubscriberFaultInjection::ListSubscriptions(
+    grpc::ClientContext& context,
+    google::pubsub::v1::ListSubscriptionsRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ListSubscriptions(context, request);
+  });
+}
+
+Status SubscriberFaultInjection::DeleteSubscription(
+    grpc::ClientContext& context,
+    google::pubsub::v1::DeleteSubscriptionRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->DeleteSubscription(context, request);
+  });
+}
+
+Status SubscriberFaultInjection::ModifyPushConfig(
+    grpc::ClientContext& context,
+    google::pubsub::v1::ModifyPushConfigRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ModifyPushConfig(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::PullResponse> SubscriberFaultInjection::Pull(
+    grpc::ClientContext& context,
+    google::pubsub::v1::PullRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->Pull(context, request);
+  });
+}
+
+Status SubscriberFaultInjection::Acknowledge(
+    grpc::ClientContext& context,
+    google::pubsub::v1::AcknowledgeRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->Acknowledge(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::Snapshot> SubscriberFaultInjection::CreateSnapshot(
+    grpc::ClientContext& context,
+    google::pubsub::v1::CreateSnapshotRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->CreateSnapshot(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::Snapshot> SubscriberFaultInjection::GetSnapshot(
+    grpc::ClientContext& context,
+    google::pubsub::v1::GetSnapshotRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->GetSnapshot(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::ListSnapshotsResponse>
+SubscriberFaultInjection::ListSnapshots(
+    grpc::ClientContext& context,
+    google::pubsub::v1::ListSnapshotsRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ListSnapshots(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::Snapshot> SubscriberFaultInjection::UpdateSnapshot(
+    grpc::ClientContext& context,
+    google::pubsub::v1::UpdateSnapshotRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->UpdateSnapshot(context, request);
+  });
+}
+
+Status SubscriberFaultInjection::DeleteSnapshot(
+    grpc::ClientContext& context,
+    google::pubsub::v1::DeleteSnapshotRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->DeleteSnapshot(context, request);
+  });
+}
+
+StatusOr<google::pubsub::v1::SeekResponse> SubscriberFaultInjection::Seek(
+    grpc::ClientContext& context,
+    google::pubsub::v1::SeekRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->Seek(context, request);
+  });
+}
+
+std::unique_ptr<SubscriberStub::AsyncPullStream>
+SubscriberFaultInjection::AsyncStreamingPull(
+    google::cloud::CompletionQueue& cq,
+    std::unique_ptr<grpc::ClientContext> context,
+    google::pubsub::v1::StreamingPullRequest const& request) {
+  // Only the stream is decorated, delaying the `Start()` would need a timer,
+  // and errors in `Start()` and `Read()` already exercise the resume loop.
+  using google::cloud::internal::AsyncStreamingReadWriteRpcFaultInjection;
+  return absl::make_unique<AsyncStreamingReadWriteRpcFaultInjection<
+      google::pubsub::v1::StreamingPullRequest,
+      google::pubsub::v1::StreamingPullResponse>>(
+      child_->AsyncStreamingPull(cq, std::move(context), request), injector_);
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,93 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/internal/subscriber_fault_injection.h"
+#include "google/cloud/pubsub/testing/mock_subscriber_stub.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::google::cloud::internal::FaultInjector;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::HasSubstr;
+using ::testing::Return;
+
+std::shared_ptr<FaultInjector> MakeInjector(FaultInjectionOptions options) {
+  return std::make_shared<FaultInjector>(std::move(options));
+}
+
+TEST(SubscriberFaultInjectionTest, Disabled) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  EXPECT_CALL(*mock, Acknowledge).WillOnce(Return(Status{}));
+  SubscriberFaultInjection stub(mock, MakeInjector(FaultInjectionOptions{}));
+  grpc::ClientContext context;
+  EXPECT_STATUS_OK(
+      stub.Acknowledge(context, google::pubsub::v1::AcknowledgeRequest{}));
+}
+
+TEST(SubscriberFaultInjectionTest, InjectError) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  EXPECT_CALL(*mock, Pull).Times(0);
+  SubscriberFaultInjection stub(
+      mock, MakeInjector(FaultInjectionOptions{}
+                             .set_error_rate(1.0)
+                             .set_error_code(StatusCode::kDeadlineExceeded)));
+  grpc::ClientContext context;
+  EXPECT_THAT(stub.Pull(context, google::pubsub::v1::PullRequest{}),
+              StatusIs(StatusCode::kDeadlineExceeded, HasSubstr("Pull")));
+}
+
+TEST(SubscriberFaultInjectionTest, AsyncStreamingPullReset) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  EXPECT_CALL(*mock, AsyncStreamingPull)
+      .WillOnce([](google::cloud::CompletionQueue&,
+                   std::unique_ptr<grpc::ClientContext>,
+                   google::pubsub::v1::StreamingPullRequest const&) {
+        auto stream = absl::make_unique<pubsub_testing::MockAsyncPullStream>();
+        EXPECT_CALL(*stream, Start).WillOnce([] {
+          return make_ready_future(true);
+        });
+        EXPECT_CALL(*stream, Cancel).Times(1);
+        EXPECT_CALL(*stream, Read).WillOnce([] {
+          return make_ready_future(
+              absl::make_optional(google::pubsub::v1::StreamingPullResponse{}));
+        });
+        EXPECT_CALL(*stream, Finish).WillOnce([] {
+          return make_ready_future(Status(StatusCode::kCancelled, "cancel"));
+        });
+        return stream;
+      });
+  SubscriberFaultInjection stub(
+      mock, MakeInjector(FaultInjectionOptions{}.set_stream_reset_rate(1.0)));
+  google::cloud::CompletionQueue cq;
+  auto stream =
+      stub.AsyncStreamingPull(cq, absl::make_unique<grpc::ClientContext>(),
+                              google::pubsub::v1::StreamingPullRequest{});
+  EXPECT_TRUE(stream->Start().get());
+  EXPECT_FALSE(stream->Read().get().has_value());
+  EXPECT_THAT(stream->Finish().get(), StatusIs(StatusCode::kUnavailable));
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
@@ -107,6 +107,28 @@ SubscriberLogging::AsyncStreamingPull(
       std::move(stream), tracing_options_, request_id);
 }
 
+StatusOr<google::pubsub::v1::PullResponse> SubscriberLogging::Pull(
+    grpc::ClientContext& context,
+    google::pubsub::v1::PullRequest const& request) {
+  return LogWrapper(
+      [this](grpc::ClientContext& context,
+             google::pubsub::v1::PullRequest const& request) {
+        return child_->Pull(context, request);
+      },
+      context, request, __func__, tracing_options_);
+}
+
+Status SubscriberLogging::Acknowledge(
+    grpc::ClientContext& context,
+    google::pubsub::v1::AcknowledgeRequest const& request) {
+  return LogWrapper(
+      [this](grpc::ClientContext& context,
+             google::pubsub::v1::AcknowledgeRequest const& request) {
+        return child_->Acknowledge(context, request);
+      },
+      context, request, __func__, tracing_options_);
+}
+
 StatusOr<google::pubsub::v1::Snapshot> SubscriberLogging::CreateSnapshot(
     grpc::ClientContext& context,
     google::pubsub::v1::CreateSnapshotRequest const& request) {
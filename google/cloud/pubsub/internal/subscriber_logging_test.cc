@@ -211,6 +211,38 @@ TEST_F(SubscriberLoggingTest, AsyncStreamingPull) {
   EXPECT_THAT(backend_->ClearLogLines(), Contains(HasSubstr("Cancel")));
 }
 
+TEST_F(SubscriberLoggingTest, Pull) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  EXPECT_CALL(*mock, Pull)
+      .WillOnce(Return(make_status_or(google::pubsub::v1::PullResponse{})));
+  SubscriberLogging stub(mock, TracingOptions{}.SetOptions("single_line_mode"),
+                         false);
+  grpc::ClientContext context;
+  google::pubsub::v1::PullRequest request;
+  request.set_subscription("test-subscription-name");
+  auto response = stub.Pull(context, request);
+  EXPECT_STATUS_OK(response);
+  EXPECT_THAT(backend_->ClearLogLines(),
+              Contains(AllOf(HasSubstr("Pull"),
+                             HasSubstr("test-subscription-name"))));
+}
+
+TEST_F(SubscriberLoggingTest, Acknowledge) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  EXPECT_CALL(*mock, Acknowledge).WillOnce(Return(Status{}));
+  SubscriberLogging stub(mock, TracingOptions{}.SetOptions("single_line_mode"),
+                         false);
+  grpc::ClientContext context;
+  google::pubsub::v1::AcknowledgeRequest request;
+  request.set_subscription("test-subscription-name");
+  request.add_ack_ids("test-ack-id");
+  auto status = stub.Acknowledge(context, request);
+  EXPECT_STATUS_OK(status);
+  EXPECT_THAT(
+      backend_->ClearLogLines(),
+      Contains(AllOf(HasSubstr("Acknowledge"), HasSubstr("test-ack-id"))));
+}
+
 TEST_F(SubscriberLoggingTest, CreateSnapshot) {
   auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
   EXPECT_CALL(*mock, CreateSnapshot)
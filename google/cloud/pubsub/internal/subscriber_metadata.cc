@@ -79,6 +79,20 @@ SubscriberMetadata::AsyncStreamingPull(
   return child_->AsyncStreamingPull(cq, std::move(context), request);
 }
 
+StatusOr<google::pubsub::v1::PullResponse> SubscriberMetadata::Pull(
+    grpc::ClientContext& context,
+    google::pubsub::v1::PullRequest const& request) {
+  SetMetadata(context, "subscription=" + request.subscription());
+  return child_->Pull(context, request);
+}
+
+Status SubscriberMetadata::Acknowledge(
+    grpc::ClientContext& context,
+    google::pubsub::v1::AcknowledgeRequest const& request) {
+  SetMetadata(context, "subscription=" + request.subscription());
+  return child_->Acknowledge(context, request);
+}
+
 StatusOr<google::pubsub::v1::Snapshot> SubscriberMetadata::CreateSnapshot(
     grpc::ClientContext& context,
     google::pubsub::v1::CreateSnapshotRequest const& request) {
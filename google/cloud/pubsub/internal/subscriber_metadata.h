@@ -58,6 +58,14 @@ class SubscriberMetadata : public SubscriberStub {
       std::unique_ptr<grpc::ClientContext> context,
       google::pubsub::v1::StreamingPullRequest const& request) override;
 
+  StatusOr<google::pubsub::v1::PullResponse> Pull(
+      grpc::ClientContext& context,
+      google::pubsub::v1::PullRequest const& request) override;
+
+  Status Acknowledge(
+      grpc::ClientContext& context,
+      google::pubsub::v1::AcknowledgeRequest const& request) override;
+
   StatusOr<google::pubsub::v1::Snapshot> CreateSnapshot(
       grpc::ClientContext& context,
       google::pubsub::v1::CreateSnapshotRequest const& request) override;
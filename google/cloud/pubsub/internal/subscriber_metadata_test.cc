@@ -164,6 +164,44 @@ TEST(SubscriberMetadataTest, AsyncStreamingPull) {
   EXPECT_TRUE(stream);
 }
 
+TEST(SubscriberMetadataTest, Pull) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  EXPECT_CALL(*mock, Pull)
+      .WillOnce([](grpc::ClientContext& context,
+                   google::pubsub::v1::PullRequest const&) {
+        EXPECT_STATUS_OK(
+            IsContextMDValid(context, "google.pubsub.v1.Subscriber.Pull",
+                             google::cloud::internal::ApiClientHeader()));
+        return make_status_or(google::pubsub::v1::PullResponse{});
+      });
+  SubscriberMetadata stub(mock);
+  grpc::ClientContext context;
+  google::pubsub::v1::PullRequest request;
+  request.set_subscription(
+      pubsub::Subscription("test-project", "test-subscription").FullName());
+  auto response = stub.Pull(context, request);
+  EXPECT_STATUS_OK(response);
+}
+
+TEST(SubscriberMetadataTest, Acknowledge) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  EXPECT_CALL(*mock, Acknowledge)
+      .WillOnce([](grpc::ClientContext& context,
+                   google::pubsub::v1::AcknowledgeRequest const&) {
+        EXPECT_STATUS_OK(IsContextMDValid(
+            context, "google.pubsub.v1.Subscriber.Acknowledge",
+            google::cloud::internal::ApiClientHeader()));
+        return Status{};
+      });
+  SubscriberMetadata stub(mock);
+  grpc::ClientContext context;
+  google::pubsub::v1::AcknowledgeRequest request;
+  request.set_subscription(
+      pubsub::Subscription("test-project", "test-subscription").FullName());
+  auto status = stub.Acknowledge(context, request);
+  EXPECT_STATUS_OK(status);
+}
+
 TEST(SubscriberMetadataTest, CreateSnapshot) {
   auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
   EXPECT_CALL(*mock, CreateSnapshot)
@@ -13,11 +13,44 @@
 // limitations under the License.
 
 #include "google/cloud/pubsub/internal/subscriber_round_robin.h"
+#include "absl/memory/memory.h"
+#include <chrono>
 
 namespace google {
 namespace cloud {
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+/// Counts the stream as in flight on its channel until it is destroyed.
+class LoadTrackingPullStream : public SubscriberStub::AsyncPullStream {
+ public:
+  LoadTrackingPullStream(
+      std::unique_ptr<SubscriberStub::AsyncPullStream> child,
+      std::shared_ptr<StubPool<SubscriberStub>> pool, std::size_t index)
+      : child_(std::move(child)), pool_(std::move(pool)), index_(index) {}
+  ~LoadTrackingPullStream() override { pool_->FinishStream(index_); }
+
+  void Cancel() override { child_->Cancel(); }
+  future<bool> Start() override { return child_->Start(); }
+  future<absl::optional<google::pubsub::v1::StreamingPullResponse>> Read()
+      override {
+    return child_->Read();
+  }
+  future<bool> Write(google::pubsub::v1::StreamingPullRequest const& request,
+                     grpc::WriteOptions options) override {
+    return child_->Write(request, std::move(options));
+  }
+  future<bool> WritesDone() override { return child_->WritesDone(); }
+  future<Status> Finish() override { return child_->Finish(); }
+
+ private:
+  std::unique_ptr<SubscriberStub::AsyncPullStream> child_;
+  std::shared_ptr<StubPool<SubscriberStub>> pool_;
+  std::size_t index_;
+};
+
+}  // namespace
 
 StatusOr<google::pubsub::v1::Subscription>
 SubscriberRoundRobin::CreateSubscription(
@@ -64,7 +97,33 @@ SubscriberRoundRobin::AsyncStreamingPull(
     google::cloud::CompletionQueue& cq,
     std::unique_ptr<grpc::ClientContext> context,
     google::pubsub::v1::StreamingPullRequest const& request) {
-  return Child()->AsyncStreamingPull(cq, std::move(context), request);
+  auto picked = pool_->StartRpc();
+  auto stream =
+      picked.second->AsyncStreamingPull(cq, std::move(context), request);
+  if (!stream) {
+    pool_->FinishStream(picked.first);
+    return stream;
+  }
+  return absl::make_unique<LoadTrackingPullStream>(std::move(stream), pool_,
+                                                   picked.first);
+}
+
+StatusOr<google::pubsub::v1::PullResponse> SubscriberRoundRobin::Pull(
+    grpc::ClientContext& context,
+    google::pubsub::v1::PullRequest const& request) {
+  auto picked = pool_->StartRpc();
+  auto const start = std::chrono::steady_clock::now();
+  auto response = picked.second->Pull(context, request);
+  pool_->FinishRpc(picked.first,
+                   std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start));
+  return response;
+}
+
+Status SubscriberRoundRobin::Acknowledge(
+    grpc::ClientContext& context,
+    google::pubsub::v1::AcknowledgeRequest const& request) {
+  return Child()->Acknowledge(context, request);
 }
 
 StatusOr<google::pubsub::v1::Snapshot> SubscriberRoundRobin::CreateSnapshot(
@@ -105,10 +164,7 @@ StatusOr<google::pubsub::v1::SeekResponse> SubscriberRoundRobin::Seek(
 }
 
 std::shared_ptr<SubscriberStub> SubscriberRoundRobin::Child() {
-  std::lock_guard<std::mutex> lk(mu_);
-  auto child = children_[current_];
-  current_ = (current_ + 1) % children_.size();
-  return child;
+  return pool_->Next();
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
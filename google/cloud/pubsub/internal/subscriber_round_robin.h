@@ -16,9 +16,9 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_SUBSCRIBER_ROUND_ROBIN_H
 
 #include "google/cloud/pubsub/internal/subscriber_stub.h"
+#include "google/cloud/pubsub/internal/stub_pool.h"
 #include "google/cloud/pubsub/version.h"
 #include <memory>
-#include <mutex>
 #include <vector>
 
 namespace google {
@@ -26,11 +26,23 @@ namespace cloud {
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
+/**
+ * Spreads the RPCs across several stubs, each using a different channel.
+ *
+ * The administrative RPCs use the stubs in round-robin order. The data path
+ * RPCs use the stub with the fewest RPCs in flight, so a stalled channel
+ * stops receiving new work. If @p factory is set, channels that are
+ * persistently slower than the others are reconnected.
+ */
 class SubscriberRoundRobin : public SubscriberStub {
  public:
+  using StubFactory = StubPool<SubscriberStub>::StubFactory;
+
   explicit SubscriberRoundRobin(
-      std::vector<std::shared_ptr<SubscriberStub>> children)
-      : children_(std::move(children)) {}
+      std::vector<std::shared_ptr<SubscriberStub>> children,
+      StubFactory factory = {})
+      : pool_(std::make_shared<StubPool<SubscriberStub>>(std::move(children),
+                                                     std::move(factory))) {}
 
   StatusOr<google::pubsub::v1::Subscription> CreateSubscription(
       grpc::ClientContext& context,
@@ -61,6 +73,14 @@ class SubscriberRoundRobin : public SubscriberStub {
       std::unique_ptr<grpc::ClientContext> context,
       google::pubsub::v1::StreamingPullRequest const& request) override;
 
+  StatusOr<google::pubsub::v1::PullResponse> Pull(
+      grpc::ClientContext& context,
+      google::pubsub::v1::PullRequest const& request) override;
+
+  Status Acknowledge(
+      grpc::ClientContext& context,
+      google::pubsub::v1::AcknowledgeRequest const& request) override;
+
   StatusOr<google::pubsub::v1::Snapshot> CreateSnapshot(
       grpc::ClientContext& context,
       google::pubsub::v1::CreateSnapshotRequest const& request) override;
@@ -88,9 +108,7 @@ class SubscriberRoundRobin : public SubscriberStub {
  private:
   std::shared_ptr<SubscriberStub> Child();
 
-  std::vector<std::shared_ptr<SubscriberStub>> const children_;
-  std::mutex mu_;
-  std::size_t current_ = 0;
+  std::shared_ptr<StubPool<SubscriberStub>> pool_;
 };
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
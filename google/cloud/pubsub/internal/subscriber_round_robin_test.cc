@@ -178,6 +178,44 @@ TEST(SubscriberLoggingTest, AsyncStreamingPull) {
   }
 }
 
+TEST(SubscriberLoggingTest, Pull) {
+  auto mocks = MakeMocks();
+  InSequence sequence;
+  for (int i = 0; i != kRepeats; ++i) {
+    for (auto& m : mocks) {
+      EXPECT_CALL(*m, Pull)
+          .WillOnce(
+              Return(make_status_or(google::pubsub::v1::PullResponse{})));
+    }
+  }
+  SubscriberRoundRobin stub(AsPlainStubs(mocks));
+  for (std::size_t i = 0; i != kRepeats * mocks.size(); ++i) {
+    grpc::ClientContext context;
+    google::pubsub::v1::PullRequest request;
+    request.set_subscription("test-subscription-name");
+    auto response = stub.Pull(context, request);
+    EXPECT_STATUS_OK(response);
+  }
+}
+
+TEST(SubscriberLoggingTest, Acknowledge) {
+  auto mocks = MakeMocks();
+  InSequence sequence;
+  for (int i = 0; i != kRepeats; ++i) {
+    for (auto& m : mocks) {
+      EXPECT_CALL(*m, Acknowledge).WillOnce(Return(Status{}));
+    }
+  }
+  SubscriberRoundRobin stub(AsPlainStubs(mocks));
+  for (std::size_t i = 0; i != kRepeats * mocks.size(); ++i) {
+    grpc::ClientContext context;
+    google::pubsub::v1::AcknowledgeRequest request;
+    request.set_subscription("test-subscription-name");
+    auto status = stub.Acknowledge(context, request);
+    EXPECT_STATUS_OK(status);
+  }
+}
+
 TEST(SubscriberLoggingTest, CreateSnapshot) {
   auto mocks = MakeMocks();
   InSequence sequence;
@@ -80,6 +80,16 @@ class SubscriberStub {
       google::cloud::CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
       google::pubsub::v1::StreamingPullRequest const& request) = 0;
 
+  /// Pull a batch of messages, without a streaming session.
+  virtual StatusOr<google::pubsub::v1::PullResponse> Pull(
+      grpc::ClientContext& client_context,
+      google::pubsub::v1::PullRequest const& request) = 0;
+
+  /// Acknowledge a batch of messages.
+  virtual Status Acknowledge(
+      grpc::ClientContext& client_context,
+      google::pubsub::v1::AcknowledgeRequest const& request) = 0;
+
   /// Create a new snapshot.
   virtual StatusOr<google::pubsub::v1::Snapshot> CreateSnapshot(
       grpc::ClientContext& client_context,
@@ -49,8 +49,21 @@ class AckHandlerImpl : public pubsub::AckHandler::Impl {
 
 void SubscriptionConcurrencyControl::Start(pubsub::ApplicationCallback cb) {
   std::unique_lock<std::mutex> lk(mu_);
-  if (callback_) return;
+  if (callback_ || batch_callback_) return;
   callback_ = std::move(cb);
+  StartSource(std::move(lk));
+}
+
+void SubscriptionConcurrencyControl::StartBatch(
+    pubsub::BatchApplicationCallback cb) {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (callback_ || batch_callback_) return;
+  batch_callback_ = std::move(cb);
+  StartSource(std::move(lk));
+}
+
+void SubscriptionConcurrencyControl::StartSource(
+    std::unique_lock<std::mutex> lk) {
   std::weak_ptr<SubscriptionConcurrencyControl> weak = shared_from_this();
   source_->Start([weak](google::pubsub::v1::ReceivedMessage r) {
     if (auto self = weak.lock()) self->OnMessage(std::move(r));
@@ -64,6 +77,10 @@ void SubscriptionConcurrencyControl::Start(pubsub::ApplicationCallback cb) {
 
 void SubscriptionConcurrencyControl::Shutdown() {
   shutdown_manager_->MarkAsShutdown(__func__, {});
+  std::unique_lock<std::mutex> lk(mu_);
+  auto timer = std::move(batch_timer_);
+  lk.unlock();
+  if (timer.valid()) timer.cancel();
   source_->Shutdown();
 }
 
@@ -94,6 +111,10 @@ void SubscriptionConcurrencyControl::OnMessage(
   std::unique_lock<std::mutex> lk(mu_);
   if (messages_requested_ > 0) --messages_requested_;
   ++message_count_;
+  if (batch_callback_) {
+    OnBatchMessage(std::move(lk), std::move(m));
+    return;
+  }
   lk.unlock();
 
   struct MoveCapture {
@@ -111,6 +132,7 @@ void SubscriptionConcurrencyControl::OnMessageAsync(
     google::pubsub::v1::ReceivedMessage m,
     std::weak_ptr<SubscriptionConcurrencyControl> w) {
   shutdown_manager_->StartOperation(__func__, "handler", [&] {
+    if (metrics_) metrics_->RecordCallbackStart(m.ack_id());
     pubsub::AckHandler h(absl::make_unique<AckHandlerImpl>(
         std::move(w), std::move(*m.mutable_ack_id()), m.delivery_attempt()));
     callback_(FromProto(std::move(*m.mutable_message())), std::move(h));
@@ -118,6 +140,82 @@ void SubscriptionConcurrencyControl::OnMessageAsync(
   shutdown_manager_->FinishedOperation("callback");
 }
 
+void SubscriptionConcurrencyControl::OnBatchMessage(
+    std::unique_lock<std::mutex> lk, google::pubsub::v1::ReceivedMessage m) {
+  batch_.push_back(std::move(m));
+  // There is no point in waiting if no more messages can arrive until some of
+  // the outstanding messages are handled.
+  if (batch_.size() >= max_batch_size_ || messages_requested_ == 0) {
+    FlushBatch(std::move(lk));
+    return;
+  }
+  if (batch_.size() != 1) return;
+  auto const generation = batch_generation_;
+  lk.unlock();
+
+  std::weak_ptr<SubscriptionConcurrencyControl> weak = shared_from_this();
+  using F = future<StatusOr<std::chrono::system_clock::time_point>>;
+  auto timer =
+      cq_.MakeRelativeTimer(max_batch_latency_).then([weak, generation](F) {
+        if (auto self = weak.lock()) self->OnBatchTimer(generation);
+      });
+  // Keep the timer so it can be canceled if the batch fills up first, pending
+  // timers would otherwise delay the completion queue shutdown.
+  lk.lock();
+  if (generation == batch_generation_) batch_timer_ = std::move(timer);
+}
+
+void SubscriptionConcurrencyControl::FlushBatch(
+    std::unique_lock<std::mutex> lk) {
+  std::vector<google::pubsub::v1::ReceivedMessage> batch;
+  batch.swap(batch_);
+  ++batch_generation_;
+  auto timer = std::move(batch_timer_);
+  lk.unlock();
+  if (timer.valid()) timer.cancel();
+  if (batch.empty()) return;
+
+  struct MoveCapture {
+    std::weak_ptr<SubscriptionConcurrencyControl> w;
+    std::vector<google::pubsub::v1::ReceivedMessage> batch;
+    void operator()() {
+      if (auto s = w.lock()) s->OnBatchAsync(std::move(batch), std::move(w));
+    }
+  };
+  shutdown_manager_->StartAsyncOperation(
+      __func__, "callback", cq_,
+      MoveCapture{shared_from_this(), std::move(batch)});
+}
+
+void SubscriptionConcurrencyControl::OnBatchTimer(std::uint64_t generation) {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (generation != batch_generation_) return;
+  FlushBatch(std::move(lk));
+}
+
+void SubscriptionConcurrencyControl::OnBatchAsync(
+    std::vector<google::pubsub::v1::ReceivedMessage> batch,
+    std::weak_ptr<SubscriptionConcurrencyControl> w) {
+  std::vector<pubsub::Message> messages;
+  std::vector<pubsub::AckHandler> handlers;
+  messages.reserve(batch.size());
+  handlers.reserve(batch.size());
+  for (auto& m : batch) {
+    // Each message is a separate "handler" operation, as each one is
+    // acknowledged separately.
+    if (!shutdown_manager_->StartOperation(__func__, "handler", [] {})) break;
+    if (metrics_) metrics_->RecordCallbackStart(m.ack_id());
+    handlers.emplace_back(absl::make_unique<AckHandlerImpl>(
+        w, std::move(*m.mutable_ack_id()), m.delivery_attempt()));
+    messages.push_back(FromProto(std::move(*m.mutable_message())));
+  }
+  if (!messages.empty()) {
+    batch_callback_(std::move(messages),
+                    pubsub::BatchAckHandler(std::move(handlers)));
+  }
+  shutdown_manager_->FinishedOperation("callback");
+}
+
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
 }  // namespace cloud
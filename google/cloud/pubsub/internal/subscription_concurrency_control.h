@@ -16,18 +16,34 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_SUBSCRIPTION_CONCURRENCY_CONTROL_H
 
 #include "google/cloud/pubsub/application_callback.h"
+#include "google/cloud/pubsub/batch_ack_handler.h"
 #include "google/cloud/pubsub/internal/session_shutdown_manager.h"
 #include "google/cloud/pubsub/internal/subscription_message_source.h"
 #include "google/cloud/pubsub/message.h"
+#include "google/cloud/pubsub/subscriber_metrics.h"
 #include "google/cloud/pubsub/version.h"
+#include "google/cloud/future.h"
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace google {
 namespace cloud {
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
+/**
+ * Schedules the application callbacks.
+ *
+ * The callbacks run in the `CompletionQueue` threads, at most
+ * `max_concurrency` messages are outstanding (scheduled or running) at a time.
+ *
+ * With `StartBatch()` the messages are delivered in batches of up to
+ * `max_batch_size` messages, amortizing the cost to schedule each callback. A
+ * partial batch is sent after `max_batch_latency`, or as soon as no more
+ * messages can be received without handling some of the outstanding messages.
+ */
 class SubscriptionConcurrencyControl
     : public std::enable_shared_from_this<SubscriptionConcurrencyControl> {
  public:
@@ -35,14 +51,18 @@ class SubscriptionConcurrencyControl
       google::cloud::CompletionQueue cq,
       std::shared_ptr<SessionShutdownManager> shutdown_manager,
       std::shared_ptr<SubscriptionMessageSource> source,
-      std::size_t max_concurrency) {
+      std::size_t max_concurrency, std::size_t max_batch_size = 1,
+      std::chrono::milliseconds max_batch_latency = {},
+      std::shared_ptr<pubsub::SubscriberMetrics> metrics = {}) {
     return std::shared_ptr<SubscriptionConcurrencyControl>(
-        new SubscriptionConcurrencyControl(std::move(cq),
-                                           std::move(shutdown_manager),
-                                           std::move(source), max_concurrency));
+        new SubscriptionConcurrencyControl(
+            std::move(cq), std::move(shutdown_manager), std::move(source),
+            max_concurrency, max_batch_size, max_batch_latency,
+            std::move(metrics)));
   }
 
   void Start(pubsub::ApplicationCallback);
+  void StartBatch(pubsub::BatchApplicationCallback);
   void Shutdown();
   void AckMessage(std::string const& ack_id);
   void NackMessage(std::string const& ack_id);
@@ -52,16 +72,28 @@ class SubscriptionConcurrencyControl
       google::cloud::CompletionQueue cq,
       std::shared_ptr<SessionShutdownManager> shutdown_manager,
       std::shared_ptr<SubscriptionMessageSource> source,
-      std::size_t max_concurrency)
+      std::size_t max_concurrency, std::size_t max_batch_size,
+      std::chrono::milliseconds max_batch_latency,
+      std::shared_ptr<pubsub::SubscriberMetrics> metrics)
       : cq_(std::move(cq)),
         shutdown_manager_(std::move(shutdown_manager)),
         source_(std::move(source)),
-        max_concurrency_(max_concurrency) {}
+        max_concurrency_(max_concurrency),
+        max_batch_size_(max_batch_size == 0 ? 1 : max_batch_size),
+        max_batch_latency_(max_batch_latency),
+        metrics_(std::move(metrics)) {}
 
+  void StartSource(std::unique_lock<std::mutex> lk);
   void MessageHandled();
   void OnMessage(google::pubsub::v1::ReceivedMessage m);
   void OnMessageAsync(google::pubsub::v1::ReceivedMessage m,
                       std::weak_ptr<SubscriptionConcurrencyControl> w);
+  void OnBatchMessage(std::unique_lock<std::mutex> lk,
+                      google::pubsub::v1::ReceivedMessage m);
+  void FlushBatch(std::unique_lock<std::mutex> lk);
+  void OnBatchTimer(std::uint64_t generation);
+  void OnBatchAsync(std::vector<google::pubsub::v1::ReceivedMessage> batch,
+                    std::weak_ptr<SubscriptionConcurrencyControl> w);
 
   std::size_t total_messages() const {
     return message_count_ + messages_requested_;
@@ -71,9 +103,17 @@ class SubscriptionConcurrencyControl
   std::shared_ptr<SessionShutdownManager> const shutdown_manager_;
   std::shared_ptr<SubscriptionMessageSource> const source_;
   std::size_t const max_concurrency_;
+  std::size_t const max_batch_size_;
+  std::chrono::milliseconds const max_batch_latency_;
+  std::shared_ptr<pubsub::SubscriberMetrics> const metrics_;
 
   std::mutex mu_;
   pubsub::ApplicationCallback callback_;
+  pubsub::BatchApplicationCallback batch_callback_;
+  std::vector<google::pubsub::v1::ReceivedMessage> batch_;
+  // Incremented each time a batch is sent, to ignore stale timers.
+  std::uint64_t batch_generation_ = 0;
+  future<void> batch_timer_;
   std::size_t message_count_ = 0;
   std::size_t messages_requested_ = 0;
 };
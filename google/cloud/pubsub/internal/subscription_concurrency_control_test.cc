@@ -33,6 +33,7 @@ namespace {
 using ::google::cloud::testing_util::StatusIs;
 using ::testing::AtLeast;
 using ::testing::StartsWith;
+using ::testing::UnorderedElementsAre;
 
 class SubscriptionConcurrencyControlTest : public ::testing::Test {
  protected:
@@ -502,6 +503,108 @@ TEST_F(SubscriptionConcurrencyControlTest, MessageContents) {
   EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
 }
 
+/// @test Verify SubscriptionConcurrencyControl delivers batches of messages.
+TEST_F(SubscriptionConcurrencyControlTest, BatchCallbacks) {
+  auto source =
+      std::make_shared<pubsub_testing::MockSubscriptionMessageSource>();
+  MessageCallback message_callback;
+  auto push_messages = [&](std::size_t n) {
+    PushMessages(message_callback, n);
+  };
+  PrepareMessages("ack-0-", 10);
+  EXPECT_CALL(*source, Shutdown).Times(1);
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*source, Start)
+        .WillOnce([&message_callback](MessageCallback cb) {
+          message_callback = std::move(cb);
+        });
+    EXPECT_CALL(*source, Read(10)).WillOnce(push_messages);
+  }
+  EXPECT_CALL(*source, AckMessage).Times(10);
+  EXPECT_CALL(*source, Read(1)).Times(10);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background(4);
+  auto shutdown = std::make_shared<SessionShutdownManager>();
+  // Use a long latency, the batches are sent because they are full, or because
+  // no more messages can be received.
+  auto uut = SubscriptionConcurrencyControl::Create(
+      background.cq(), shutdown, source, /*max_concurrency=*/10,
+      /*max_batch_size=*/4, /*max_batch_latency=*/std::chrono::hours(1));
+
+  std::mutex handler_mu;
+  std::condition_variable handler_cv;
+  std::vector<std::size_t> batch_sizes;
+  std::vector<pubsub::BatchAckHandler> handlers;
+  auto handler = [&](std::vector<pubsub::Message> const& messages,
+                     pubsub::BatchAckHandler h) {
+    std::lock_guard<std::mutex> lk(handler_mu);
+    for (auto const& m : messages) {
+      EXPECT_THAT(m.message_id(), StartsWith("message:ack-0-"));
+    }
+    EXPECT_EQ(messages.size(), h.size());
+    batch_sizes.push_back(messages.size());
+    handlers.push_back(std::move(h));
+    handler_cv.notify_one();
+  };
+
+  auto done = shutdown->Start({});
+  uut->StartBatch(handler);
+  {
+    std::unique_lock<std::mutex> lk(handler_mu);
+    handler_cv.wait(lk, [&] { return handlers.size() == 3; });
+    EXPECT_THAT(batch_sizes, UnorderedElementsAre(4, 4, 2));
+    for (auto& h : handlers) std::move(h).ack();
+  }
+
+  shutdown->MarkAsShutdown(__func__, {});
+  uut->Shutdown();
+  EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
+}
+
+/// @test Verify partial batches are sent after the maximum latency.
+TEST_F(SubscriptionConcurrencyControlTest, BatchCallbacksLatency) {
+  auto source =
+      std::make_shared<pubsub_testing::MockSubscriptionMessageSource>();
+  MessageCallback message_callback;
+  auto push_messages = [&](std::size_t n) {
+    PushMessages(message_callback, n);
+  };
+  PrepareMessages("ack-0-", 3);
+  EXPECT_CALL(*source, Shutdown).Times(1);
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*source, Start)
+        .WillOnce([&message_callback](MessageCallback cb) {
+          message_callback = std::move(cb);
+        });
+    EXPECT_CALL(*source, Read(10)).WillOnce(push_messages);
+  }
+  EXPECT_CALL(*source, AckMessage).Times(3);
+  EXPECT_CALL(*source, Read(1)).Times(3);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background(4);
+  auto shutdown = std::make_shared<SessionShutdownManager>();
+  auto uut = SubscriptionConcurrencyControl::Create(
+      background.cq(), shutdown, source, /*max_concurrency=*/10,
+      /*max_batch_size=*/4, /*max_batch_latency=*/std::chrono::milliseconds(5));
+
+  promise<pubsub::BatchAckHandler> received;
+  auto handler = [&](std::vector<pubsub::Message> const& messages,
+                     pubsub::BatchAckHandler h) {
+    EXPECT_EQ(3, messages.size());
+    received.set_value(std::move(h));
+  };
+
+  auto done = shutdown->Start({});
+  uut->StartBatch(handler);
+  received.get_future().get().ack();
+
+  shutdown->MarkAsShutdown(__func__, {});
+  uut->Shutdown();
+  EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/pubsub/internal/subscription_lease_management.h"
+#include <algorithm>
 
 namespace google {
 namespace cloud {
@@ -23,6 +24,11 @@ std::chrono::seconds constexpr SubscriptionLeaseManagement::kMinimumAckDeadline;
 std::chrono::seconds constexpr SubscriptionLeaseManagement::kMaximumAckDeadline;
 std::chrono::seconds constexpr SubscriptionLeaseManagement::kAckDeadlineSlack;
 
+namespace {
+// The percentile of the processing time used to set the lease extensions.
+auto constexpr kAckDeadlinePercentile = 99.0;
+}  // namespace
+
 void SubscriptionLeaseManagement::Start(BatchCallback cb) {
   auto weak = std::weak_ptr<SubscriptionLeaseManagement>(shared_from_this());
   child_->Start(
@@ -42,20 +48,25 @@ void SubscriptionLeaseManagement::Shutdown() {
 }
 
 void SubscriptionLeaseManagement::AckMessage(std::string const& ack_id) {
+  if (metrics_) metrics_->RecordAck(ack_id);
   std::unique_lock<std::mutex> lk(mu_);
-  leases_.erase(ack_id);
+  ForgetLease(lk, ack_id);
   lk.unlock();
   child_->AckMessage(ack_id);
 }
 
 void SubscriptionLeaseManagement::NackMessage(std::string const& ack_id) {
+  if (metrics_) metrics_->RecordNack(ack_id);
   std::unique_lock<std::mutex> lk(mu_);
-  leases_.erase(ack_id);
+  ForgetLease(lk, ack_id);
   lk.unlock();
   child_->NackMessage(ack_id);
 }
 
 void SubscriptionLeaseManagement::BulkNack(std::vector<std::string> ack_ids) {
+  if (metrics_) {
+    for (auto const& id : ack_ids) metrics_->RecordNack(id);
+  }
   std::unique_lock<std::mutex> lk(mu_);
   for (auto const& id : ack_ids) leases_.erase(id);
   lk.unlock();
@@ -82,8 +93,11 @@ void SubscriptionLeaseManagement::OnRead(
   auto const estimated_server_deadline = now + std::chrono::seconds(10);
   auto const handling_deadline = now + max_deadline_time_;
   for (auto const& rm : response->received_messages()) {
-    leases_.emplace(rm.ack_id(),
-                    LeaseStatus{estimated_server_deadline, handling_deadline});
+    leases_.emplace(rm.ack_id(), LeaseStatus{estimated_server_deadline,
+                                             handling_deadline, now});
+    if (metrics_) {
+      metrics_->RecordReceived(rm.ack_id(), rm.message().data().size());
+    }
   }
   // Setup a timer to refresh the message leases. We do not want to immediately
   // refresh them because there is a good chance they will be handled before
@@ -101,7 +115,7 @@ void SubscriptionLeaseManagement::RefreshMessageLeases(
 
   std::vector<std::string> ack_ids;
   ack_ids.reserve(leases_.size());
-  auto extension = kMaximumAckDeadline;
+  auto extension = AdaptiveAckDeadline(lk);
   auto const now = std::chrono::system_clock::now();
   for (auto const& kv : leases_) {
     // This message lease cannot be extended any further, and we do not want to
@@ -118,6 +132,7 @@ void SubscriptionLeaseManagement::RefreshMessageLeases(
     return;
   }
   lk.unlock();
+  if (metrics_) metrics_->RecordLeaseExtensions(ack_ids.size());
   child_->ExtendLeases(ack_ids, extension);
   lk.lock();
   for (auto const& ack : ack_ids) {
@@ -148,6 +163,24 @@ void SubscriptionLeaseManagement::OnRefreshTimer(bool cancelled) {
   RefreshMessageLeases(std::unique_lock<std::mutex>(mu_));
 }
 
+void SubscriptionLeaseManagement::ForgetLease(
+    std::unique_lock<std::mutex> const&, std::string const& ack_id) {
+  auto i = leases_.find(ack_id);
+  if (i == leases_.end()) return;
+  processing_times_.Record(std::chrono::system_clock::now() -
+                           i->second.received);
+  leases_.erase(i);
+}
+
+std::chrono::seconds SubscriptionLeaseManagement::AdaptiveAckDeadline(
+    std::unique_lock<std::mutex> const&) const {
+  // Without any samples use the longest possible extension, the messages may
+  // take a long time to process, and we do not want to redeliver them.
+  if (processing_times_.size() == 0) return kMaximumAckDeadline;
+  auto const p = processing_times_.Percentile(kAckDeadlinePercentile);
+  return (std::min)(kMaximumAckDeadline, (std::max)(kMinimumAckDeadline, p));
+}
+
 void SubscriptionLeaseManagement::NackAll(std::unique_lock<std::mutex> lk) {
   if (leases_.empty()) return;
   std::vector<std::string> ack_ids;
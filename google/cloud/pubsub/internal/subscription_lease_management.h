@@ -15,9 +15,11 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_SUBSCRIPTION_LEASE_MANAGEMENT_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_INTERNAL_SUBSCRIPTION_LEASE_MANAGEMENT_H
 
+#include "google/cloud/pubsub/internal/processing_time_distribution.h"
 #include "google/cloud/pubsub/internal/session_shutdown_manager.h"
 #include "google/cloud/pubsub/internal/subscriber_stub.h"
 #include "google/cloud/pubsub/internal/subscription_batch_source.h"
+#include "google/cloud/pubsub/subscriber_metrics.h"
 #include "google/cloud/pubsub/version.h"
 #include "google/cloud/internal/absl_flat_hash_map_quiet.h"
 #include <chrono>
@@ -48,7 +50,8 @@ class SubscriptionLeaseManagement
       google::cloud::CompletionQueue cq,
       std::shared_ptr<SessionShutdownManager> shutdown_manager,
       std::shared_ptr<SubscriptionBatchSource> child,
-      std::chrono::seconds max_deadline_time) {
+      std::chrono::seconds max_deadline_time,
+      std::shared_ptr<pubsub::SubscriberMetrics> metrics = {}) {
     auto timer_factory =
         [cq](std::chrono::system_clock::time_point tp) mutable {
           return cq.MakeDeadlineTimer(tp).then(
@@ -59,7 +62,8 @@ class SubscriptionLeaseManagement
     return std::shared_ptr<SubscriptionLeaseManagement>(
         new SubscriptionLeaseManagement(
             std::move(cq), std::move(shutdown_manager),
-            std::move(timer_factory), std::move(child), max_deadline_time));
+            std::move(timer_factory), std::move(child), max_deadline_time,
+            std::move(metrics)));
   }
 
   static std::shared_ptr<SubscriptionLeaseManagement> CreateForTesting(
@@ -67,11 +71,13 @@ class SubscriptionLeaseManagement
       std::shared_ptr<SessionShutdownManager> shutdown_manager,
       TimerFactory timer_factory,
       std::shared_ptr<SubscriptionBatchSource> child,
-      std::chrono::seconds max_deadline_time) {
+      std::chrono::seconds max_deadline_time,
+      std::shared_ptr<pubsub::SubscriberMetrics> metrics = {}) {
     return std::shared_ptr<SubscriptionLeaseManagement>(
         new SubscriptionLeaseManagement(
             std::move(cq), std::move(shutdown_manager),
-            std::move(timer_factory), std::move(child), max_deadline_time));
+            std::move(timer_factory), std::move(child), max_deadline_time,
+            std::move(metrics)));
   }
 
   void Start(BatchCallback cb) override;
@@ -88,12 +94,14 @@ class SubscriptionLeaseManagement
       std::shared_ptr<SessionShutdownManager> shutdown_manager,
       TimerFactory timer_factory,
       std::shared_ptr<SubscriptionBatchSource> child,
-      std::chrono::seconds max_deadline_time)
+      std::chrono::seconds max_deadline_time,
+      std::shared_ptr<pubsub::SubscriberMetrics> metrics)
       : cq_(std::move(cq)),
         timer_factory_(std::move(timer_factory)),
         child_(std::move(child)),
         shutdown_manager_(std::move(shutdown_manager)),
-        max_deadline_time_(max_deadline_time) {}
+        max_deadline_time_(max_deadline_time),
+        metrics_(std::move(metrics)) {}
 
   void OnRead(
       StatusOr<google::pubsub::v1::StreamingPullResponse> const& response);
@@ -111,11 +119,20 @@ class SubscriptionLeaseManagement
 
   void NackAll(std::unique_lock<std::mutex> lk);
 
+  /// Remove @p ack_id from the leases, and record its processing time.
+  void ForgetLease(std::unique_lock<std::mutex> const& lk,
+                   std::string const& ack_id);
+
+  /// The lease extension for messages, based on their observed processing time
+  std::chrono::seconds AdaptiveAckDeadline(
+      std::unique_lock<std::mutex> const& lk) const;
+
   google::cloud::CompletionQueue cq_;
   TimerFactory const timer_factory_;
   std::shared_ptr<SubscriptionBatchSource> const child_;
   std::shared_ptr<SessionShutdownManager> const shutdown_manager_;
   std::chrono::seconds const max_deadline_time_;
+  std::shared_ptr<pubsub::SubscriberMetrics> const metrics_;
 
   std::mutex mu_;
 
@@ -123,9 +140,15 @@ class SubscriptionLeaseManagement
   struct LeaseStatus {
     std::chrono::system_clock::time_point estimated_server_deadline;
     std::chrono::system_clock::time_point handling_deadline;
+    std::chrono::system_clock::time_point received;
   };
   absl::flat_hash_map<std::string, LeaseStatus> leases_;
 
+  // How long the application takes to ack (or nack) messages. The 99th
+  // percentile sets the lease extensions, so most messages need a single
+  // extension, without holding the leases of abandoned messages for too long.
+  ProcessingTimeDistribution processing_times_;
+
   bool refreshing_leases_ = false;
   future<void> refresh_timer_;
 };
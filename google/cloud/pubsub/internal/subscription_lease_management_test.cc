@@ -62,7 +62,10 @@ TEST(SubscriptionLeaseManagementTest, NormalLifecycle) {
         .WillOnce([&](std::vector<std::string> const& ack_ids,
                       std::chrono::seconds extension) {
           EXPECT_THAT(ack_ids, UnorderedElementsAre("ack-0-0", "ack-0-2"));
-          EXPECT_LE(std::abs((kTestDeadline - extension).count()), 2);
+          // The acked message was handled quickly, so the extension is based
+          // on its processing time, and not on `kTestDeadline`.
+          EXPECT_EQ(SubscriptionLeaseManagement::kMinimumAckDeadline,
+                    extension);
           return make_ready_future(Status{});
         });
     // Then a message is nacked.
@@ -72,7 +75,8 @@ TEST(SubscriptionLeaseManagementTest, NormalLifecycle) {
         .WillOnce([&](std::vector<std::string> const& ack_ids,
                       std::chrono::seconds extension) {
           EXPECT_THAT(ack_ids, UnorderedElementsAre("ack-0-0"));
-          EXPECT_LE(std::abs((kTestDeadline - extension).count()), 2);
+          EXPECT_EQ(SubscriptionLeaseManagement::kMinimumAckDeadline,
+                    extension);
           return make_ready_future(Status{});
         });
     // Then all unhandled messages are nacked on shutdown.
@@ -121,6 +125,50 @@ TEST(SubscriptionLeaseManagementTest, NormalLifecycle) {
   EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
 }
 
+/// @test Without processing time samples the leases are fully extended.
+TEST(SubscriptionLeaseManagementTest, ExtendWithoutSamples) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriptionBatchSource>();
+  BatchCallback batch_callback;
+  EXPECT_CALL(*mock, Start).WillOnce([&](BatchCallback cb) {
+    batch_callback = std::move(cb);
+  });
+
+  auto constexpr kTestDeadline = std::chrono::seconds(345);
+  EXPECT_CALL(*mock, ExtendLeases)
+      .WillOnce([&](std::vector<std::string> const& ack_ids,
+                    std::chrono::seconds extension) {
+        EXPECT_THAT(ack_ids, UnorderedElementsAre("ack-0-0", "ack-0-1"));
+        EXPECT_LE(std::abs((kTestDeadline - extension).count()), 2);
+        return make_ready_future(Status{});
+      });
+  EXPECT_CALL(*mock, BulkNack).Times(1);
+  EXPECT_CALL(*mock, Shutdown).Times(1);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  std::vector<promise<Status>> timers;
+  auto make_timer = [&](std::chrono::system_clock::time_point) {
+    promise<Status> p;
+    auto f = p.get_future();
+    timers.push_back(std::move(p));
+    return f;
+  };
+  auto shutdown_manager = std::make_shared<SessionShutdownManager>();
+  auto uut = SubscriptionLeaseManagement::CreateForTesting(
+      background.cq(), shutdown_manager, make_timer, mock, kTestDeadline);
+
+  auto done = shutdown_manager->Start({});
+  uut->Start([](StatusOr<google::pubsub::v1::StreamingPullResponse> const&) {});
+  batch_callback(GenerateMessages("0-", 2));
+  ASSERT_EQ(1, timers.size());
+  timers[0].set_value({});
+  ASSERT_EQ(2, timers.size());
+
+  shutdown_manager->MarkAsShutdown(__func__, Status{});
+  uut->Shutdown();
+  timers[1].set_value(Status(StatusCode::kCancelled, "test-cancel"));
+  EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
+}
+
 TEST(SubscriptionLeaseManagementTest, ShutdownOnError) {
   auto mock = std::make_shared<pubsub_testing::MockSubscriptionBatchSource>();
   BatchCallback batch_callback;
@@ -169,6 +217,63 @@ TEST(SubscriptionLeaseManagementTest, DoesNotPropagateExtendLeases) {
   uut->ExtendLeases({"a", "b", "c"}, std::chrono::seconds(10));
 }
 
+TEST(SubscriptionLeaseManagementTest, RecordsMetrics) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriptionBatchSource>();
+  BatchCallback batch_callback;
+  EXPECT_CALL(*mock, Start).WillOnce([&](BatchCallback cb) {
+    batch_callback = std::move(cb);
+  });
+  EXPECT_CALL(*mock, AckMessage("ack-0-0")).WillOnce(SimpleAckNack);
+  EXPECT_CALL(*mock, ExtendLeases)
+      .WillOnce([](std::vector<std::string> const&, std::chrono::seconds) {
+        return make_ready_future(Status{});
+      });
+  EXPECT_CALL(*mock, NackMessage("ack-0-1")).WillOnce(SimpleAckNack);
+  EXPECT_CALL(*mock, BulkNack(UnorderedElementsAre("ack-0-2")))
+      .WillOnce([](std::vector<std::string> const&) {
+        return make_ready_future(Status{});
+      });
+  EXPECT_CALL(*mock, Shutdown).Times(1);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads background;
+  std::vector<promise<Status>> timers;
+  auto make_timer = [&](std::chrono::system_clock::time_point) {
+    promise<Status> p;
+    auto f = p.get_future();
+    timers.push_back(std::move(p));
+    return f;
+  };
+  auto metrics = std::make_shared<pubsub::SubscriberMetrics>();
+  auto shutdown_manager = std::make_shared<SessionShutdownManager>();
+  auto uut = SubscriptionLeaseManagement::CreateForTesting(
+      background.cq(), shutdown_manager, make_timer, mock,
+      std::chrono::seconds(30), metrics);
+
+  auto done = shutdown_manager->Start({});
+  uut->Start([](StatusOr<google::pubsub::v1::StreamingPullResponse> const&) {});
+  batch_callback(GenerateMessages("0-", 3));
+  EXPECT_EQ(3, metrics->Snapshot().outstanding_messages);
+
+  uut->AckMessage("ack-0-0");
+  ASSERT_EQ(1, timers.size());
+  auto first = std::move(timers[0]);
+  first.set_value({});
+  ASSERT_EQ(2, timers.size());
+  uut->NackMessage("ack-0-1");
+
+  shutdown_manager->MarkAsShutdown(__func__, Status{});
+  uut->Shutdown();
+  timers[1].set_value(Status(StatusCode::kCancelled, "test-cancel"));
+  EXPECT_THAT(done.get(), StatusIs(StatusCode::kOk));
+
+  auto const s = metrics->Snapshot();
+  EXPECT_EQ(3, s.messages_received);
+  EXPECT_EQ(1, s.acks);
+  EXPECT_EQ(2, s.nacks);
+  EXPECT_EQ(2, s.lease_extensions);
+  EXPECT_EQ(0, s.outstanding_messages);
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
@@ -71,7 +71,7 @@ void SubscriptionMessageQueue::OnRead(
   auto handle_response = [&] {
     shutdown_manager_->FinishedOperation("OnRead");
     for (auto& m : *r.mutable_received_messages()) {
-      auto key = m.message().ordering_key();
+      auto const& key = m.message().ordering_key();
       if (key.empty()) {
         // Empty key, requires no ordering and therefore immediately runnable.
         runnable_messages_.push_back(std::move(m));
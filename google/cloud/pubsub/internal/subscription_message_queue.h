@@ -55,6 +55,15 @@ inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
  * For messages with an ordering key, this class also maintains a mapping of
  * ack_id to ordering key. This is necessary to determine which ordering key
  * queue is drained when the message is acknowledged or rejected.
+ *
+ * The runnable messages are a single FIFO queue. At most one message for each
+ * ordering key is in this queue (or running), and when it is handled the next
+ * message for the key is added at the end. That is, the runnable keys are
+ * scheduled round-robin, a key with a large backlog gets no more than one
+ * callback slot at a time, and cannot starve other keys. The callbacks run in
+ * the `CompletionQueue` threads, which already balance the work across the
+ * threads, so the ordered subscriptions scale with the callback concurrency
+ * and the number of keys with pending messages.
  */
 class SubscriptionMessageQueue
     : public SubscriptionMessageSource,
@@ -294,6 +294,49 @@ TEST(SubscriptionMessageQueueTest, RespectOrderingKeys) {
   uut->Shutdown();
 }
 
+/// @test Verify a hot ordering key does not starve other keys
+TEST(SubscriptionMessageQueueTest, OrderingKeysAreFair) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriptionBatchSource>();
+  EXPECT_CALL(*mock, Shutdown).Times(1);
+  BatchCallback batch_callback;
+  EXPECT_CALL(*mock, Start).WillOnce([&](BatchCallback cb) {
+    batch_callback = std::move(cb);
+  });
+  EXPECT_CALL(*mock, AckMessage).Times(AtLeast(1));
+  EXPECT_CALL(*mock, BulkNack).Times(AtMost(1));
+
+  std::vector<std::string> received;
+  auto handler = [&received](google::pubsub::v1::ReceivedMessage const& m) {
+    received.push_back(m.message().message_id());
+  };
+
+  auto shutdown = std::make_shared<SessionShutdownManager>();
+  shutdown->Start({});
+  auto uut = SubscriptionMessageQueue::Create(shutdown, mock);
+  uut->Start(handler);
+
+  // The hot key has a large backlog, the other keys have a single message.
+  auto messages = GenerateOrderKeyMessages("hot", 0, 100);
+  for (auto const* key : {"k0", "k1", "k2"}) {
+    auto m = GenerateOrderKeyMessages(key, 0, 1);
+    messages.insert(messages.end(), m.begin(), m.end());
+  }
+  batch_callback(AsPullResponse(messages));
+
+  uut->Read(1);
+  EXPECT_THAT(received, ElementsAre("id-hot-000000"));
+  received.clear();
+
+  // Handling a message of the hot key makes its next message runnable, but it
+  // waits behind the messages from other keys that were already runnable.
+  uut->AckMessage("ack-hot-000000");
+  uut->Read(4);
+  EXPECT_THAT(received, ElementsAre("id-k0-000000", "id-k1-000000",
+                                    "id-k2-000000", "id-hot-000001"));
+
+  uut->Shutdown();
+}
+
 /// @test Verify duplicate messages are handled correctly
 TEST(SubscriptionMessageQueueTest, DuplicateMessagesNoKey) {
   auto mock = std::make_shared<pubsub_testing::MockSubscriptionBatchSource>();
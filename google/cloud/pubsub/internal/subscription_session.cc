@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "google/cloud/pubsub/internal/subscription_session.h"
+#include "google/cloud/pubsub/internal/deduplicating_batch_source.h"
+#include "google/cloud/pubsub/internal/multiplexed_batch_source.h"
 #include "google/cloud/pubsub/internal/streaming_subscription_batch_source.h"
 #include "google/cloud/pubsub/internal/subscription_lease_management.h"
 #include "google/cloud/pubsub/internal/subscription_message_queue.h"
@@ -25,6 +27,46 @@ namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 namespace {
 
+/// Create the batch source, with one streaming pull per concurrent stream.
+std::shared_ptr<SubscriptionBatchSource> MakeBatchSource(
+    pubsub::Subscription const& subscription,
+    pubsub::SubscriberOptions const& options,
+    std::shared_ptr<pubsub_internal::SubscriberStub> const& stub,
+    google::cloud::CompletionQueue const& executor,
+    std::shared_ptr<SessionShutdownManager> const& shutdown_manager,
+    std::string const& client_id, pubsub::RetryPolicy const& retry_policy,
+    pubsub::BackoffPolicy const& backoff_policy) {
+  auto const streams = options.concurrent_streams();
+  if (streams <= 1) {
+    return std::make_shared<StreamingSubscriptionBatchSource>(
+        executor, shutdown_manager, stub, subscription.FullName(), client_id,
+        options, retry_policy.clone(), backoff_policy.clone(),
+        AckBatchingConfig(options));
+  }
+  // The service uses the client id to transfer state when a stream reconnects,
+  // each stream needs a different value.
+  auto const stream_options = PerStreamOptions(options, streams);
+  std::vector<std::shared_ptr<SubscriptionBatchSource>> children(streams);
+  for (std::size_t i = 0; i != streams; ++i) {
+    children[i] = std::make_shared<StreamingSubscriptionBatchSource>(
+        executor, shutdown_manager, stub, subscription.FullName(),
+        client_id + "-" + std::to_string(i), stream_options,
+        retry_policy.clone(), backoff_policy.clone(),
+        AckBatchingConfig(options));
+  }
+  return std::make_shared<MultiplexedBatchSource>(std::move(children));
+}
+
+/// Suppress duplicate deliveries, if enabled in @p options.
+std::shared_ptr<SubscriptionBatchSource> MaybeDeduplicate(
+    pubsub::SubscriberOptions const& options,
+    std::shared_ptr<SubscriptionBatchSource> source) {
+  if (options.deduplication_window().count() == 0) return source;
+  return DeduplicatingBatchSource::Create(
+      std::move(source), options.deduplication_window(),
+      options.max_deduplication_entries(), options.metrics());
+}
+
 class SubscriptionSessionImpl
     : public std::enable_shared_from_this<SubscriptionSessionImpl> {
  public:
@@ -37,12 +79,19 @@ class SubscriptionSessionImpl
     auto queue =
         SubscriptionMessageQueue::Create(shutdown_manager, std::move(source));
     auto concurrency_control = SubscriptionConcurrencyControl::Create(
-        executor, shutdown_manager, std::move(queue),
-        options.max_concurrency());
+        executor, shutdown_manager, std::move(queue), options.max_concurrency(),
+        options.max_callback_batch_size(), options.max_callback_batch_latency(),
+        options.metrics());
+    if (options.metrics()) {
+      options.metrics()->SetLimits(options.max_outstanding_messages(),
+                                   options.max_outstanding_bytes(),
+                                   options.max_concurrency());
+    }
 
     auto self = std::make_shared<SubscriptionSessionImpl>(
         std::move(executor), std::move(shutdown_manager),
-        std::move(concurrency_control), options.shutdown_polling_period());
+        std::move(concurrency_control), options.shutdown_polling_period(),
+        options.max_shutdown_time());
 
     auto weak = std::weak_ptr<SubscriptionSessionImpl>(self);
     auto result = self->shutdown_manager_->Start(promise<Status>([weak] {
@@ -54,7 +103,11 @@ class SubscriptionSessionImpl
     // 2) When the completion queue is shutdown, the timer is canceled and
     //    `self` gets a chance to shutdown the pipeline.
     self->ScheduleTimer();
-    self->pipeline_->Start(std::move(p.callback));
+    if (p.batch_callback) {
+      self->pipeline_->StartBatch(std::move(p.batch_callback));
+    } else {
+      self->pipeline_->Start(std::move(p.callback));
+    }
     return result.then([weak](future<Status> f) {
       if (auto self = weak.lock()) self->ShutdownCompleted();
       return f.get();
@@ -65,10 +118,12 @@ class SubscriptionSessionImpl
       CompletionQueue cq,
       std::shared_ptr<SessionShutdownManager> shutdown_manager,
       std::shared_ptr<SubscriptionConcurrencyControl> pipeline,
-      std::chrono::milliseconds shutdown_polling_period)
+      std::chrono::milliseconds shutdown_polling_period,
+      std::chrono::milliseconds max_shutdown_time)
       : cq_(std::move(cq)),
         shutdown_manager_(std::move(shutdown_manager)),
         shutdown_polling_period_(shutdown_polling_period),
+        max_shutdown_time_(max_shutdown_time),
         pipeline_(std::move(pipeline)) {}
 
  private:
@@ -95,6 +150,7 @@ class SubscriptionSessionImpl
     std::unique_lock<std::mutex> lk(mu_);
     switch (shutdown_state_) {
       case kNotInShutdown:
+        StartShutdownDeadline(lk);
         MarkAsShutdown(std::move(lk), kShutdownByApplication, __func__);
         break;
       case kShutdownByApplication:
@@ -104,6 +160,20 @@ class SubscriptionSessionImpl
     }
   }
 
+  // Complete the shutdown after `max_shutdown_time_`, even if some callbacks
+  // are still running.
+  void StartShutdownDeadline(std::unique_lock<std::mutex> const&) {
+    if (max_shutdown_time_.count() == 0) return;
+    using TimerArg = future<StatusOr<std::chrono::system_clock::time_point>>;
+    auto manager = shutdown_manager_;
+    shutdown_deadline_ = cq_.MakeRelativeTimer(max_shutdown_time_)
+                             .then([manager](TimerArg f) {
+                               if (!f.get().ok()) return;
+                               manager->ForceShutdownComplete(
+                                   "ShutdownDeadline");
+                             });
+  }
+
   void ShutdownCompleted() {
     ShutdownCompleted(std::unique_lock<std::mutex>(mu_));
   }
@@ -112,6 +182,7 @@ class SubscriptionSessionImpl
     pipeline_.reset();
     shutdown_state_ = kShutdownCompleted;
     if (timer_.valid()) timer_.cancel();
+    if (shutdown_deadline_.valid()) shutdown_deadline_.cancel();
   }
 
   void ScheduleTimer() {
@@ -149,11 +220,13 @@ class SubscriptionSessionImpl
   CompletionQueue cq_;
   std::shared_ptr<SessionShutdownManager> const shutdown_manager_;
   std::chrono::milliseconds const shutdown_polling_period_;
+  std::chrono::milliseconds const max_shutdown_time_;
 
   std::mutex mu_;
   std::shared_ptr<SubscriptionConcurrencyControl> pipeline_;
   ShutdownState shutdown_state_ = kNotInShutdown;
   future<void> timer_;
+  future<void> shutdown_deadline_;
 };
 }  // namespace
 
@@ -166,17 +239,17 @@ future<Status> CreateSubscriptionSession(
     std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
     std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy) {
   auto shutdown_manager = std::make_shared<SessionShutdownManager>();
-  auto batch = std::make_shared<StreamingSubscriptionBatchSource>(
-      executor, shutdown_manager, stub, subscription.FullName(),
-      std::move(client_id), options, std::move(retry_policy),
-      std::move(backoff_policy));
+  auto batch =
+      MakeBatchSource(subscription, options, stub, executor, shutdown_manager,
+                      client_id, *retry_policy, *backoff_policy);
   auto lease_management = SubscriptionLeaseManagement::Create(
       executor, shutdown_manager, std::move(batch),
-      options.max_deadline_time());
+      options.max_deadline_time(), options.metrics());
+  auto source = MaybeDeduplicate(options, std::move(lease_management));
 
   return SubscriptionSessionImpl::Create(
       options, std::move(executor), std::move(shutdown_manager),
-      std::move(lease_management), std::move(p));
+      std::move(source), std::move(p));
 }
 
 future<Status> CreateTestingSubscriptionSession(
@@ -198,10 +271,9 @@ future<Status> CreateTestingSubscriptionSession(
             .clone();
   }
   auto shutdown_manager = std::make_shared<SessionShutdownManager>();
-  auto batch = std::make_shared<StreamingSubscriptionBatchSource>(
-      executor, shutdown_manager, stub, subscription.FullName(),
-      "test-client-id", options, std::move(retry_policy),
-      std::move(backoff_policy));
+  auto batch =
+      MakeBatchSource(subscription, options, stub, executor, shutdown_manager,
+                      "test-client-id", *retry_policy, *backoff_policy);
 
   auto cq = executor;  // need a copy to make it mutable
   auto timer = [cq](std::chrono::system_clock::time_point) mutable {
@@ -212,11 +284,12 @@ future<Status> CreateTestingSubscriptionSession(
   };
   auto lease_management = SubscriptionLeaseManagement::CreateForTesting(
       executor, shutdown_manager, timer, std::move(batch),
-      options.max_deadline_time());
+      options.max_deadline_time(), options.metrics());
+  auto source = MaybeDeduplicate(options, std::move(lease_management));
 
   return SubscriptionSessionImpl::Create(
       options, std::move(executor), std::move(shutdown_manager),
-      std::move(lease_management), std::move(p));
+      std::move(source), std::move(p));
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
@@ -22,6 +22,8 @@
 #include "google/cloud/testing_util/fake_completion_queue_impl.h"
 #include <gmock/gmock.h>
 #include <atomic>
+#include <mutex>
+#include <set>
 #include <thread>
 
 namespace google {
@@ -191,6 +193,59 @@ TEST(SubscriptionSessionTest, SequencedCallbacks) {
   t.join();
 }
 
+/// @test Verify the session starts one streaming pull per concurrent stream.
+TEST(SubscriptionSessionTest, ConcurrentStreams) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  pubsub::Subscription const subscription("test-project", "test-subscription");
+
+  auto constexpr kStreams = 3;
+  std::mutex mu;
+  std::set<std::string> client_ids;
+  EXPECT_CALL(*mock, AsyncStreamingPull)
+      .Times(AtLeast(kStreams))
+      .WillRepeatedly(
+          [&](google::cloud::CompletionQueue& cq,
+              std::unique_ptr<grpc::ClientContext> context,
+              google::pubsub::v1::StreamingPullRequest const& request) {
+            {
+              std::lock_guard<std::mutex> lk(mu);
+              client_ids.insert(request.client_id());
+            }
+            // The flow control limits are divided across the streams.
+            EXPECT_EQ(10, request.max_outstanding_messages());
+            return FakeAsyncStreamingPull(cq, std::move(context), request);
+          });
+
+  promise<void> enough_messages;
+  std::atomic<int> received_counter{0};
+  auto constexpr kMaximumMessages = 9;
+  auto handler = [&](pubsub::Message const&, pubsub::AckHandler h) {
+    if (++received_counter == kMaximumMessages) {
+      enough_messages.set_value();
+    }
+    std::move(h).ack();
+  };
+
+  google::cloud::CompletionQueue cq;
+  std::thread t([&cq] { cq.Run(); });
+  auto response = CreateTestingSubscriptionSession(
+      subscription,
+      pubsub::SubscriberOptions{}
+          .set_concurrent_streams(kStreams)
+          .set_max_outstanding_messages(30),
+      mock, cq, {handler});
+  enough_messages.get_future()
+      .then([&](future<void>) { response.cancel(); })
+      .get();
+  EXPECT_STATUS_OK(response.get());
+
+  cq.Shutdown();
+  t.join();
+
+  std::lock_guard<std::mutex> lk(mu);
+  EXPECT_EQ(kStreams, client_ids.size());
+}
+
 /// @test Verify pending callbacks are nacked on shutdown.
 TEST(SubscriptionSessionTest, ShutdownNackCallbacks) {
   auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
@@ -282,6 +337,50 @@ TEST(SubscriptionSessionTest, ShutdownWaitsFutures) {
   EXPECT_EQ(initial_value, final_value);
 }
 
+/// @test Verify the shutdown does not wait beyond `max_shutdown_time()`.
+TEST(SubscriptionSessionTest, ShutdownBoundedTime) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  pubsub::Subscription const subscription("test-project", "test-subscription");
+
+  EXPECT_CALL(*mock, AsyncStreamingPull)
+      .Times(AtLeast(1))
+      .WillRepeatedly(FakeAsyncStreamingPull);
+
+  // The callbacks may still run after the shutdown completes, the variables
+  // they use must outlive the background threads.
+  std::mutex mu;
+  std::vector<pubsub::AckHandler> held;
+  promise<void> got_one;
+  std::atomic<int> handler_counter{0};
+  internal::AutomaticallyCreatedBackgroundThreads background;
+  {
+    // The handler never acks the messages, the session would wait forever
+    // without a bound.
+    auto handler = [&](pubsub::Message const&, pubsub::AckHandler h) {
+      {
+        std::lock_guard<std::mutex> lk(mu);
+        held.push_back(std::move(h));
+      }
+      if (++handler_counter == 1) got_one.set_value();
+    };
+
+    auto session = CreateSubscriptionSession(
+        subscription,
+        pubsub::SubscriberOptions{}.set_max_shutdown_time(
+            std::chrono::milliseconds(10)),
+        mock, background.cq(), "fake-client-id", {handler},
+        pubsub_testing::TestRetryPolicy(), pubsub_testing::TestBackoffPolicy());
+    got_one.get_future()
+        .then([&session](future<void>) { session.cancel(); })
+        .get();
+
+    EXPECT_STATUS_OK(session.get());
+  }
+  // Acknowledging the messages after the shutdown is harmless.
+  std::lock_guard<std::mutex> lk(mu);
+  for (auto& h : held) std::move(h).ack();
+}
+
 /// @test Verify shutting down a session waits for pending tasks.
 TEST(SubscriptionSessionTest, ShutdownWaitsConditionVars) {
   auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
@@ -72,6 +72,15 @@ using PubsubMessageDataType = std::decay<decltype(
  * Cloud Pub/Sub applications communicate to each other using messages. Note
  * that messages must provide at least some data or some attributes. Use
  * `MessageBuilder` to create instances of this class.
+ *
+ * @par Performance
+ * The message payload is never copied by the client library, as long as the
+ * application moves it. When publishing, move the payload into
+ * `MessageBuilder::SetData()`, and the message into `Publisher::Publish()`,
+ * the payload buffer is then moved into the batch sent to the service. When
+ * receiving, use `std::move(message).data()` to take ownership of the buffer
+ * created when the message was received. In both cases the only copy is made
+ * by gRPC, to serialize (or parse) the RPC.
  */
 class Message {
  public:
@@ -146,7 +155,12 @@ class MessageBuilder {
   /// Creates a new message.
   Message Build() && { return Message(std::move(proto_)); }
 
-  /// Sets the message payload to @p data
+  /**
+   * Sets the message payload to @p data
+   *
+   * @note Move the payload into this function (and the message into
+   *     `Publisher::Publish()`) to avoid copies of large payloads.
+   */
   MessageBuilder& SetData(std::string data) & {
     proto_.set_data(std::move(data));
     return *this;
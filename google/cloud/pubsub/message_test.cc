@@ -186,6 +186,22 @@ TEST(Message, DataMove) {
   EXPECT_EQ("contents-0", d);
 }
 
+TEST(Message, DataIsNotCopied) {
+  // Use a payload large enough to avoid the small string optimization.
+  std::string payload(1024 * 1024, 'x');
+  auto const* buffer = payload.data();
+  auto m = MessageBuilder{}.SetData(std::move(payload)).Build();
+  EXPECT_EQ(buffer, m.data().data());
+
+  auto proto = pubsub_internal::ToProto(std::move(m));
+  EXPECT_EQ(buffer, proto.data().data());
+
+  auto received = pubsub_internal::FromProto(std::move(proto));
+  EXPECT_EQ(buffer, received.data().data());
+  auto const data = std::move(received).data();
+  EXPECT_EQ(buffer, data.data());
+}
+
 TEST(Message, FromProto) {
   auto constexpr kText = R"pb(
     data: "test-data"
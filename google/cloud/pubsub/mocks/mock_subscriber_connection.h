@@ -34,6 +34,12 @@ class MockSubscriberConnection : public pubsub::SubscriberConnection {
  public:
   MOCK_METHOD(future<Status>, Subscribe,
               (pubsub::SubscriberConnection::SubscribeParams), (override));
+
+  MOCK_METHOD(StatusOr<std::vector<pubsub::PulledMessage>>, Pull,
+              (pubsub::SubscriberConnection::PullParams), (override));
+
+  MOCK_METHOD(Status, Acknowledge,
+              (pubsub::SubscriberConnection::AcknowledgeParams), (override));
 };
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
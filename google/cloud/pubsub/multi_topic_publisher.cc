@@ -0,0 +1,172 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/multi_topic_publisher.h"
+#include "google/cloud/pubsub/internal/default_retry_policies.h"
+#include "google/cloud/pubsub/internal/flush_scheduler.h"
+#include "google/cloud/pubsub/internal/shared_background_threads.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace google {
+namespace cloud {
+namespace pubsub {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+MultiTopicPublisherConnection::~MultiTopicPublisherConnection() = default;
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+std::shared_ptr<PublisherConnection>
+MultiTopicPublisherConnection::TopicConnection(Topic) {
+  return std::make_shared<PublisherConnection>();
+}
+
+void MultiTopicPublisherConnection::Flush() {}
+
+std::shared_ptr<MultiTopicPublisherConnection>
+MakeMultiTopicPublisherConnection(
+    PublisherOptions options, ConnectionOptions connection_options,
+    std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy) {
+  std::vector<std::shared_ptr<pubsub_internal::PublisherStub>> children(
+      connection_options.num_channels());
+  int id = 0;
+  std::generate(children.begin(), children.end(), [&id, &connection_options] {
+    return pubsub_internal::CreateDefaultPublisherStub(connection_options,
+                                                       id++);
+  });
+  auto factory = [connection_options](int channel_id) {
+    return pubsub_internal::CreateDefaultPublisherStub(connection_options,
+                                                       channel_id);
+  };
+  return pubsub_internal::MakeMultiTopicPublisherConnection(
+      std::move(options), std::move(connection_options), std::move(children),
+      std::move(retry_policy), std::move(backoff_policy), std::move(factory));
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub
+
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+class MultiTopicPublisherConnectionImpl
+    : public pubsub::MultiTopicPublisherConnection,
+      public std::enable_shared_from_this<MultiTopicPublisherConnectionImpl> {
+ public:
+  MultiTopicPublisherConnectionImpl(
+      pubsub::PublisherOptions options,
+      std::unique_ptr<BackgroundThreads> background,
+      std::shared_ptr<PublisherStub> stub,
+      std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
+      std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy)
+      : options_(std::move(options)),
+        background_(std::move(background)),
+        stub_(std::move(stub)),
+        flush_scheduler_(FlushScheduler::Create(background_->cq())),
+        retry_policy_(std::move(retry_policy)),
+        backoff_policy_(std::move(backoff_policy)) {}
+
+  std::shared_ptr<pubsub::PublisherConnection> TopicConnection(
+      pubsub::Topic topic) override;
+
+  void Flush() override {
+    std::vector<std::shared_ptr<pubsub::PublisherConnection>> topics;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      topics.reserve(topics_.size());
+      for (auto const& kv : topics_) topics.push_back(kv.second);
+    }
+    for (auto const& t : topics) t->Flush({});
+  }
+
+ private:
+  pubsub::PublisherOptions const options_;
+  std::unique_ptr<BackgroundThreads> background_;
+  std::shared_ptr<PublisherStub> const stub_;
+  std::shared_ptr<FlushScheduler> const flush_scheduler_;
+  std::unique_ptr<pubsub::RetryPolicy const> const retry_policy_;
+  std::unique_ptr<pubsub::BackoffPolicy const> const backoff_policy_;
+
+  std::mutex mu_;
+  std::unordered_map<std::string, std::shared_ptr<pubsub::PublisherConnection>>
+      topics_;  // GUARDED_BY(mu_)
+};
+
+/// Keeps the shared resources alive while the application uses a topic.
+class TopicPublisherConnection : public pubsub::PublisherConnection {
+ public:
+  TopicPublisherConnection(
+      std::shared_ptr<MultiTopicPublisherConnectionImpl> owner,
+      std::shared_ptr<pubsub::PublisherConnection> child)
+      : owner_(std::move(owner)), child_(std::move(child)) {}
+
+  future<StatusOr<std::string>> Publish(PublishParams p) override {
+    return child_->Publish(std::move(p));
+  }
+  void Flush(FlushParams p) override { child_->Flush(std::move(p)); }
+  void ResumePublish(ResumePublishParams p) override {
+    child_->ResumePublish(std::move(p));
+  }
+
+ private:
+  std::shared_ptr<MultiTopicPublisherConnectionImpl> owner_;
+  std::shared_ptr<pubsub::PublisherConnection> child_;
+};
+
+std::shared_ptr<pubsub::PublisherConnection>
+MultiTopicPublisherConnectionImpl::TopicConnection(pubsub::Topic topic) {
+  auto name = topic.FullName();
+  std::unique_lock<std::mutex> lk(mu_);
+  auto i = topics_.find(name);
+  if (i == topics_.end()) {
+    // Creating the pipeline does not make any RPCs, it is cheap enough to do
+    // while holding the lock.
+    auto child = MakeTopicPublisherConnection(
+        std::move(topic), options_, stub_, background_->cq(),
+        retry_policy_->clone(), backoff_policy_->clone(), flush_scheduler_);
+    i = topics_.emplace(std::move(name), std::move(child)).first;
+  }
+  auto child = i->second;
+  lk.unlock();
+  return std::make_shared<TopicPublisherConnection>(shared_from_this(),
+                                                    std::move(child));
+}
+
+}  // namespace
+
+std::shared_ptr<pubsub::MultiTopicPublisherConnection>
+MakeMultiTopicPublisherConnection(
+    pubsub::PublisherOptions options,
+    pubsub::ConnectionOptions connection_options,
+    std::vector<std::shared_ptr<PublisherStub>> stubs,
+    std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    std::function<std::shared_ptr<PublisherStub>(int)> stub_factory) {
+  if (stubs.empty()) return nullptr;
+  if (!retry_policy) retry_policy = DefaultRetryPolicy();
+  if (!backoff_policy) backoff_policy = DefaultBackoffPolicy();
+  auto stub = MakePublisherStub(connection_options, std::move(stubs),
+                                std::move(stub_factory));
+  return std::make_shared<MultiTopicPublisherConnectionImpl>(
+      std::move(options), MakeBackgroundThreads(connection_options),
+      std::move(stub), std::move(retry_policy), std::move(backoff_policy));
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
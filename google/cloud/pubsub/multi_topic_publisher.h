@@ -0,0 +1,167 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_MULTI_TOPIC_PUBLISHER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_MULTI_TOPIC_PUBLISHER_H
+
+#include "google/cloud/pubsub/backoff_policy.h"
+#include "google/cloud/pubsub/connection_options.h"
+#include "google/cloud/pubsub/internal/publisher_stub.h"
+#include "google/cloud/pubsub/message.h"
+#include "google/cloud/pubsub/publisher.h"
+#include "google/cloud/pubsub/publisher_connection.h"
+#include "google/cloud/pubsub/publisher_options.h"
+#include "google/cloud/pubsub/retry_policy.h"
+#include "google/cloud/pubsub/topic.h"
+#include "google/cloud/pubsub/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status_or.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * A connection to publish messages to any number of topics.
+ *
+ * Each `MakePublisherConnection()` call creates its own gRPC channels and
+ * hold-time timers. Applications publishing to hundreds of topics multiply
+ * these resources by the number of topics. A `MultiTopicPublisherConnection`
+ * shares one set of channels, one handle to the background threads, and one
+ * set of hold-time timers across all the topics it publishes to.
+ *
+ * Messages are still batched, flow controlled, and ordered independently for
+ * each topic: a `PublishRequest` targets a single topic, and the limits in
+ * `PublisherOptions` apply to each topic separately.
+ *
+ * The pipeline for a topic is created on its first use, and kept until the
+ * connection is destroyed.
+ */
+class MultiTopicPublisherConnection {
+ public:
+  virtual ~MultiTopicPublisherConnection() = 0;
+
+  /**
+   * Returns a connection to publish to @p topic.
+   *
+   * All the calls for the same topic return connections sharing the same
+   * batching pipeline. The returned connection keeps this connection alive.
+   */
+  virtual std::shared_ptr<PublisherConnection> TopicConnection(Topic topic);
+
+  /// Flushes the pending messages for all the topics.
+  virtual void Flush();
+};
+
+/**
+ * Creates a new `MultiTopicPublisherConnection`.
+ *
+ * @param options configure the batching, flow control, and ordering for each
+ *     topic.
+ * @param connection_options (optional) general configuration for this
+ *     connection, this type is also used to configure `pubsub::Subscriber`.
+ * @param retry_policy (optional) configure the retry loop.
+ * @param backoff_policy (optional) configure the backoff period between
+ *     retries.
+ */
+std::shared_ptr<MultiTopicPublisherConnection>
+MakeMultiTopicPublisherConnection(
+    PublisherOptions options = {}, ConnectionOptions connection_options = {},
+    std::unique_ptr<pubsub::RetryPolicy const> retry_policy = {},
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy = {});
+
+/**
+ * Publish messages to multiple Cloud Pub/Sub topics.
+ *
+ * This class is a thin wrapper around `MultiTopicPublisherConnection`, see its
+ * documentation for the resources shared across topics.
+ *
+ * @par Example
+ * @code
+ * namespace pubsub = ::google::cloud::pubsub;
+ * auto publisher = pubsub::MultiTopicPublisher(
+ *     pubsub::MakeMultiTopicPublisherConnection());
+ * for (auto const& id : topic_ids) {
+ *   publisher.Publish(pubsub::Topic(project_id, id),
+ *                     pubsub::MessageBuilder{}.SetData("event").Build());
+ * }
+ * publisher.Flush();
+ * @endcode
+ *
+ * @par Thread Safety
+ * Instances of this class created via copy-construction or copy-assignment
+ * share the underlying pool of connections. Access to these copies via
+ * multiple threads is guaranteed to work. Two threads operating on the same
+ * instance of this class is not guaranteed to work.
+ */
+class MultiTopicPublisher {
+ public:
+  explicit MultiTopicPublisher(
+      std::shared_ptr<MultiTopicPublisherConnection> connection)
+      : connection_(std::move(connection)) {}
+
+  /// Returns a `Publisher` for @p topic, sharing this publisher's resources.
+  Publisher ForTopic(Topic topic) {
+    return Publisher(connection_->TopicConnection(std::move(topic)));
+  }
+
+  /**
+   * Publishes a message to @p topic.
+   *
+   * @see `Publisher::Publish()` for the batching behavior.
+   */
+  future<StatusOr<std::string>> Publish(Topic topic, Message m) {
+    return connection_->TopicConnection(std::move(topic))
+        ->Publish({std::move(m)});
+  }
+
+  /// Forcibly publishes any batched messages, for all topics.
+  void Flush() { connection_->Flush(); }
+
+  /// Resumes publishing to @p topic after an error.
+  void ResumePublish(Topic topic, std::string ordering_key) {
+    connection_->TopicConnection(std::move(topic))
+        ->ResumePublish({std::move(ordering_key)});
+  }
+
+ private:
+  std::shared_ptr<MultiTopicPublisherConnection> connection_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub
+
+namespace pubsub_internal {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+std::shared_ptr<pubsub::MultiTopicPublisherConnection>
+MakeMultiTopicPublisherConnection(
+    pubsub::PublisherOptions options,
+    pubsub::ConnectionOptions connection_options,
+    std::vector<std::shared_ptr<PublisherStub>> stubs,
+    std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    std::function<std::shared_ptr<PublisherStub>(int)> stub_factory = {});
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_MULTI_TOPIC_PUBLISHER_H
@@ -0,0 +1,107 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/multi_topic_publisher.h"
+#include "google/cloud/pubsub/testing/mock_publisher_stub.h"
+#include "google/cloud/pubsub/testing/test_retry_policies.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <map>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace pubsub {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using ::testing::AtLeast;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+TEST(MultiTopicPublisherTest, SharesStub) {
+  auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
+  Topic const t1("test-project", "test-topic-1");
+  Topic const t2("test-project", "test-topic-2");
+
+  std::mutex mu;
+  std::map<std::string, int> messages;
+  EXPECT_CALL(*mock, AsyncPublish)
+      .Times(AtLeast(2))
+      .WillRepeatedly([&](google::cloud::CompletionQueue&,
+                          std::unique_ptr<grpc::ClientContext>,
+                          google::pubsub::v1::PublishRequest const& request) {
+        google::pubsub::v1::PublishResponse response;
+        for (auto const& m : request.messages()) {
+          response.add_message_ids(request.topic() + "/" + m.data());
+        }
+        std::lock_guard<std::mutex> lk(mu);
+        messages[request.topic()] += request.messages_size();
+        return make_ready_future(make_status_or(response));
+      });
+
+  auto connection = pubsub_internal::MakeMultiTopicPublisherConnection(
+      PublisherOptions{}.set_maximum_hold_time(std::chrono::hours(1)), {},
+      {mock}, pubsub_testing::TestRetryPolicy(),
+      pubsub_testing::TestBackoffPolicy());
+  MultiTopicPublisher publisher(connection);
+  auto r1 = publisher.Publish(t1, MessageBuilder{}.SetData("m1").Build());
+  auto r2 = publisher.Publish(t2, MessageBuilder{}.SetData("m2").Build());
+  auto r3 =
+      publisher.ForTopic(t1).Publish(MessageBuilder{}.SetData("m3").Build());
+  publisher.Flush();
+
+  ASSERT_STATUS_OK(r1.get());
+  EXPECT_EQ(t2.FullName() + "/m2", *r2.get());
+  auto id3 = r3.get();
+  ASSERT_STATUS_OK(id3);
+  EXPECT_EQ(t1.FullName() + "/m3", *id3);
+
+  std::lock_guard<std::mutex> lk(mu);
+  EXPECT_THAT(messages,
+              ElementsAre(Pair(t1.FullName(), 2), Pair(t2.FullName(), 1)));
+}
+
+TEST(MultiTopicPublisherTest, TopicConnectionOutlivesPublisher) {
+  auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
+  Topic const topic("test-project", "test-topic");
+
+  EXPECT_CALL(*mock, AsyncPublish)
+      .WillOnce([&](google::cloud::CompletionQueue&,
+                    std::unique_ptr<grpc::ClientContext>,
+                    google::pubsub::v1::PublishRequest const& request) {
+        EXPECT_EQ(topic.FullName(), request.topic());
+        google::pubsub::v1::PublishResponse response;
+        response.add_message_ids("test-message-id-0");
+        return make_ready_future(make_status_or(response));
+      });
+
+  auto publisher = [&] {
+    MultiTopicPublisher multi(
+        pubsub_internal::MakeMultiTopicPublisherConnection(
+            {}, {}, {mock}, pubsub_testing::TestRetryPolicy(),
+            pubsub_testing::TestBackoffPolicy()));
+    return multi.ForTopic(topic);
+  }();
+  auto response =
+      publisher.Publish(MessageBuilder{}.SetData("test-data-0").Build()).get();
+  ASSERT_STATUS_OK(response);
+  EXPECT_EQ("test-message-id-0", *response);
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub
+}  // namespace cloud
+}  // namespace google
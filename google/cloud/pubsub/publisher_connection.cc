@@ -14,17 +14,23 @@
 
 #include "google/cloud/pubsub/publisher_connection.h"
 #include "google/cloud/pubsub/internal/batching_publisher_connection.h"
+#include "google/cloud/pubsub/internal/concurrency_limited_batch_sink.h"
 #include "google/cloud/pubsub/internal/default_batch_sink.h"
 #include "google/cloud/pubsub/internal/default_retry_policies.h"
+#include "google/cloud/pubsub/internal/flow_controlled_publisher_connection.h"
+#include "google/cloud/pubsub/internal/flush_scheduler.h"
 #include "google/cloud/pubsub/internal/ordering_key_publisher_connection.h"
+#include "google/cloud/pubsub/internal/publisher_fault_injection.h"
 #include "google/cloud/pubsub/internal/publisher_logging.h"
 #include "google/cloud/pubsub/internal/publisher_metadata.h"
 #include "google/cloud/pubsub/internal/publisher_round_robin.h"
 #include "google/cloud/pubsub/internal/publisher_stub.h"
 #include "google/cloud/pubsub/internal/rejects_with_ordering_key.h"
 #include "google/cloud/pubsub/internal/sequential_batch_sink.h"
+#include "google/cloud/pubsub/internal/shared_background_threads.h"
 #include "google/cloud/future_void.h"
 #include "google/cloud/log.h"
+#include <limits>
 #include <memory>
 
 namespace google {
@@ -78,9 +84,15 @@ std::shared_ptr<PublisherConnection> MakePublisherConnection(
     return pubsub_internal::CreateDefaultPublisherStub(connection_options,
                                                        id++);
   });
+  // Slow channels are reconnected with new stubs.
+  auto factory = [connection_options](int channel_id) {
+    return pubsub_internal::CreateDefaultPublisherStub(connection_options,
+                                                       channel_id);
+  };
   return pubsub_internal::MakePublisherConnection(
       std::move(topic), std::move(options), std::move(connection_options),
-      std::move(children), std::move(retry_policy), std::move(backoff_policy));
+      std::move(children), std::move(retry_policy), std::move(backoff_policy),
+      std::move(factory));
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
@@ -106,47 +118,90 @@ std::shared_ptr<pubsub::PublisherConnection> MakePublisherConnection(
     pubsub::ConnectionOptions connection_options,
     std::vector<std::shared_ptr<PublisherStub>> stubs,
     std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
-    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy) {
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    std::function<std::shared_ptr<PublisherStub>(int)> stub_factory) {
   if (stubs.empty()) return nullptr;
-  if (!retry_policy) retry_policy = DefaultRetryPolicy();
-  if (!backoff_policy) backoff_policy = DefaultBackoffPolicy();
-  std::shared_ptr<PublisherStub> stub =
-      std::make_shared<PublisherRoundRobin>(std::move(stubs));
+  auto stub = MakePublisherStub(connection_options, std::move(stubs),
+                                std::move(stub_factory));
+  auto background = MakeBackgroundThreads(connection_options);
+  auto connection = MakeTopicPublisherConnection(
+      std::move(topic), std::move(options), std::move(stub), background->cq(),
+      std::move(retry_policy), std::move(backoff_policy));
+  return std::make_shared<pubsub::ContainingPublisherConnection>(
+      std::move(background), std::move(connection));
+}
+
+std::shared_ptr<PublisherStub> MakePublisherStub(
+    pubsub::ConnectionOptions const& connection_options,
+    std::vector<std::shared_ptr<PublisherStub>> stubs,
+    std::function<std::shared_ptr<PublisherStub>(int)> stub_factory) {
+  std::shared_ptr<PublisherStub> stub = std::make_shared<PublisherRoundRobin>(
+      std::move(stubs), std::move(stub_factory));
   stub = std::make_shared<PublisherMetadata>(std::move(stub));
+  if (connection_options.fault_injection().enabled()) {
+    GCP_LOG(WARNING) << "Enabled fault injection for gRPC calls";
+    auto injector = std::make_shared<google::cloud::internal::FaultInjector>(
+        connection_options.fault_injection());
+    stub = std::make_shared<PublisherFaultInjection>(std::move(stub),
+                                                     std::move(injector));
+  }
   if (connection_options.tracing_enabled("rpc")) {
     GCP_LOG(INFO) << "Enabled logging for gRPC calls";
     stub = std::make_shared<PublisherLogging>(
         std::move(stub), connection_options.tracing_options());
   }
+  return stub;
+}
 
-  auto default_thread_pool_size = []() -> std::size_t {
-    auto constexpr kDefaultThreadPoolSize = 4;
-    auto const n = std::thread::hardware_concurrency();
-    return n == 0 ? kDefaultThreadPoolSize : n;
-  };
-  if (connection_options.background_thread_pool_size() == 0) {
-    connection_options.set_background_thread_pool_size(
-        default_thread_pool_size());
-  }
-
-  auto background = connection_options.background_threads_factory()();
-  auto make_connection = [&]() -> std::shared_ptr<pubsub::PublisherConnection> {
-    auto cq = background->cq();
+std::shared_ptr<pubsub::PublisherConnection> MakeTopicPublisherConnection(
+    pubsub::Topic topic, pubsub::PublisherOptions options,
+    std::shared_ptr<PublisherStub> stub, google::cloud::CompletionQueue cq,
+    std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    std::shared_ptr<FlushScheduler> flush_scheduler) {
+  if (!retry_policy) retry_policy = DefaultRetryPolicy();
+  if (!backoff_policy) backoff_policy = DefaultBackoffPolicy();
+  auto make_batching = [&]() -> std::shared_ptr<pubsub::PublisherConnection> {
+    auto const pipeline_depth = options.ordering_key_pipeline_depth();
+    // A retry could be received after the next batches in the pipeline.
+    if (options.message_ordering() && pipeline_depth > 1) {
+      retry_policy = pubsub::LimitedErrorCountRetryPolicy(0).clone();
+    }
+    absl::optional<std::size_t> compression_threshold;
+    if (options.compression()) {
+      compression_threshold = options.compression_threshold();
+    }
     std::shared_ptr<BatchSink> sink = DefaultBatchSink::Create(
-        stub, cq, std::move(retry_policy), std::move(backoff_policy));
+        stub, cq, std::move(retry_policy), std::move(backoff_policy),
+        compression_threshold);
+    if (options.maximum_concurrent_batches() !=
+        (std::numeric_limits<std::size_t>::max)()) {
+      sink = ConcurrencyLimitedBatchSink::Create(
+          std::move(sink), options.maximum_concurrent_batches());
+    }
     if (options.message_ordering()) {
-      auto factory = [topic, options, sink, cq](std::string const& key) {
+      // All the ordering keys share the hold-time timers.
+      if (!flush_scheduler) flush_scheduler = FlushScheduler::Create(cq);
+      auto factory = [topic, options, sink, cq, pipeline_depth,
+                      flush_scheduler](std::string const& key) {
         return BatchingPublisherConnection::Create(
-            topic, options, key, SequentialBatchSink::Create(std::move(sink)),
-            cq);
+            topic, options, key,
+            SequentialBatchSink::Create(sink, pipeline_depth), cq,
+            flush_scheduler);
       };
       return OrderingKeyPublisherConnection::Create(std::move(factory));
     }
     return RejectsWithOrderingKey::Create(BatchingPublisherConnection::Create(
-        std::move(topic), std::move(options), {}, sink, std::move(cq)));
+        topic, options, {}, sink, std::move(cq), std::move(flush_scheduler)));
   };
-  return std::make_shared<pubsub::ContainingPublisherConnection>(
-      std::move(background), make_connection());
+  auto connection = make_batching();
+  if (options.full_publisher_ignored() && !options.memory_budget()) {
+    return connection;
+  }
+  MemoryAccount memory(options.memory_budget(), topic.FullName(),
+                       "pending-messages");
+  return FlowControlledPublisherConnection::Create(
+      std::move(options), std::move(connection), std::move(memory));
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
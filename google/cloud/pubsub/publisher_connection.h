@@ -17,14 +17,19 @@
 
 #include "google/cloud/pubsub/backoff_policy.h"
 #include "google/cloud/pubsub/connection_options.h"
+#include "google/cloud/pubsub/internal/flush_scheduler.h"
 #include "google/cloud/pubsub/internal/publisher_stub.h"
 #include "google/cloud/pubsub/message.h"
 #include "google/cloud/pubsub/publisher_options.h"
 #include "google/cloud/pubsub/retry_policy.h"
 #include "google/cloud/pubsub/topic.h"
 #include "google/cloud/pubsub/version.h"
+#include "google/cloud/completion_queue.h"
 #include "google/cloud/future.h"
 #include "google/cloud/status_or.h"
+#include <functional>
+#include <memory>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -92,6 +97,14 @@ class PublisherConnection {
  * same `ConnectionOptions` parameters. However, this behavior is not guaranteed
  * and applications should not rely on it.
  *
+ * @par Background Threads
+ * Unless the application configures the background threads in
+ * @p connection_options, all the Pub/Sub connections in a process share a
+ * single pool of background threads, with one thread per core. Applications
+ * can use `ConnectionOptions::set_background_thread_pool_size()` to create a
+ * dedicated pool for a connection, or `DisableBackgroundThreads()` to provide
+ * their own `CompletionQueue`.
+ *
  * @see `PublisherConnection`
  *
  * @param topic the Cloud Pub/Sub topic used by the returned
@@ -130,7 +143,29 @@ std::shared_ptr<pubsub::PublisherConnection> MakePublisherConnection(
     pubsub::ConnectionOptions connection_options,
     std::vector<std::shared_ptr<PublisherStub>> stubs,
     std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
-    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy);
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    std::function<std::shared_ptr<PublisherStub>(int)> stub_factory = {});
+
+/// Decorates the stubs for each channel with round-robin, metadata, and
+/// (optional) logging.
+std::shared_ptr<PublisherStub> MakePublisherStub(
+    pubsub::ConnectionOptions const& connection_options,
+    std::vector<std::shared_ptr<PublisherStub>> stubs,
+    std::function<std::shared_ptr<PublisherStub>(int)> stub_factory = {});
+
+/**
+ * Creates the batching and flow control pipeline to publish to @p topic.
+ *
+ * The pipeline uses @p stub and @p cq, but does not own any background
+ * threads. If set, @p flush_scheduler runs the hold-time flushes, otherwise
+ * the pipeline creates its own timers.
+ */
+std::shared_ptr<pubsub::PublisherConnection> MakeTopicPublisherConnection(
+    pubsub::Topic topic, pubsub::PublisherOptions options,
+    std::shared_ptr<PublisherStub> stub, google::cloud::CompletionQueue cq,
+    std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    std::shared_ptr<FlushScheduler> flush_scheduler = {});
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
@@ -162,6 +162,41 @@ TEST(PublisherConnectionTest, OrderingKeyWithoutMessageOrdering) {
               HasSubstr("does not have message ordering enabled"));
 }
 
+TEST(PublisherConnectionTest, FlowControlRejects) {
+  auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
+  Topic const topic("test-project", "test-topic");
+
+  promise<StatusOr<google::pubsub::v1::PublishResponse>> response;
+  EXPECT_CALL(*mock, AsyncPublish)
+      .WillOnce([&](google::cloud::CompletionQueue&,
+                    std::unique_ptr<grpc::ClientContext>,
+                    google::pubsub::v1::PublishRequest const&) {
+        return response.get_future();
+      });
+
+  auto publisher = pubsub_internal::MakePublisherConnection(
+      topic,
+      PublisherOptions{}
+          .set_maximum_batch_message_count(1)
+          .set_maximum_pending_messages(1)
+          .set_full_publisher_rejects(),
+      {}, mock, pubsub_testing::TestRetryPolicy(),
+      pubsub_testing::TestBackoffPolicy());
+  auto f0 =
+      publisher->Publish({MessageBuilder{}.SetData("test-data-0").Build()});
+  auto r1 =
+      publisher->Publish({MessageBuilder{}.SetData("test-data-1").Build()})
+          .get();
+  EXPECT_THAT(r1.status(), StatusIs(StatusCode::kFailedPrecondition));
+
+  google::pubsub::v1::PublishResponse r;
+  r.add_message_ids("test-message-id-0");
+  response.set_value(std::move(r));
+  auto r0 = f0.get();
+  ASSERT_STATUS_OK(r0);
+  EXPECT_EQ("test-message-id-0", *r0);
+}
+
 TEST(PublisherConnectionTest, HandleInvalidResponse) {
   auto mock = std::make_shared<pubsub_testing::MockPublisherStub>();
   Topic const topic("test-project", "test-topic");
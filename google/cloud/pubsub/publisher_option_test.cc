@@ -14,6 +14,7 @@
 
 #include "google/cloud/pubsub/publisher_options.h"
 #include <gmock/gmock.h>
+#include <limits>
 
 namespace google {
 namespace cloud {
@@ -43,6 +44,63 @@ TEST(PublisherOptions, Setters) {
   EXPECT_FALSE(b1.message_ordering());
 }
 
+TEST(PublisherOptions, Concurrency) {
+  auto const b0 = PublisherOptions{};
+  EXPECT_EQ((std::numeric_limits<std::size_t>::max)(),
+            b0.maximum_concurrent_batches());
+  EXPECT_EQ(1, b0.ordering_key_pipeline_depth());
+
+  auto const b = PublisherOptions{}
+                     .set_maximum_concurrent_batches(8)
+                     .set_ordering_key_pipeline_depth(4);
+  EXPECT_EQ(8, b.maximum_concurrent_batches());
+  EXPECT_EQ(4, b.ordering_key_pipeline_depth());
+}
+
+TEST(PublisherOptions, Compression) {
+  auto const b0 = PublisherOptions{};
+  EXPECT_FALSE(b0.compression());
+
+  auto const b = PublisherOptions{}.enable_compression(256);
+  EXPECT_TRUE(b.compression());
+  EXPECT_EQ(256, b.compression_threshold());
+
+  auto const b1 = PublisherOptions{}.enable_compression();
+  EXPECT_TRUE(b1.compression());
+  EXPECT_EQ(b0.compression_threshold(), b1.compression_threshold());
+
+  auto const b2 = PublisherOptions{}.enable_compression().disable_compression();
+  EXPECT_FALSE(b2.compression());
+}
+
+TEST(PublisherOptions, FlowControl) {
+  auto const b0 = PublisherOptions{};
+  EXPECT_TRUE(b0.full_publisher_ignored());
+  EXPECT_EQ((std::numeric_limits<std::size_t>::max)(),
+            b0.maximum_pending_messages());
+  EXPECT_EQ((std::numeric_limits<std::size_t>::max)(),
+            b0.maximum_pending_bytes());
+
+  auto const b = PublisherOptions{}
+                     .set_maximum_pending_messages(100)
+                     .set_maximum_pending_bytes(1024)
+                     .set_full_publisher_rejects();
+  EXPECT_EQ(100, b.maximum_pending_messages());
+  EXPECT_EQ(1024, b.maximum_pending_bytes());
+  EXPECT_TRUE(b.full_publisher_rejects());
+  EXPECT_FALSE(b.full_publisher_ignored());
+
+  EXPECT_TRUE(
+      PublisherOptions{}.set_full_publisher_blocks().full_publisher_blocks());
+  EXPECT_TRUE(PublisherOptions{}
+                  .set_full_publisher_discards_oldest()
+                  .full_publisher_discards_oldest());
+  EXPECT_TRUE(PublisherOptions{}
+                  .set_full_publisher_blocks()
+                  .set_full_publisher_ignored()
+                  .full_publisher_ignored());
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub
@@ -22,6 +22,7 @@ inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 std::chrono::milliseconds constexpr PublisherOptions::kDefaultMaximumHoldTime;
 std::size_t constexpr PublisherOptions::kDefaultMaximumMessageCount;
 std::size_t constexpr PublisherOptions::kDefaultMaximumMessageSize;
+std::size_t constexpr PublisherOptions::kDefaultCompressionThreshold;
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub
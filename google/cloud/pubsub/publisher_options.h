@@ -16,9 +16,11 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_PUBLISHER_OPTIONS_H
 
 #include "google/cloud/pubsub/version.h"
+#include "google/cloud/memory_budget.h"
 #include <chrono>
 #include <cstddef>
 #include <limits>
+#include <memory>
 
 namespace google {
 namespace cloud {
@@ -133,15 +135,236 @@ class PublisherOptions {
     return *this;
   }
 
+  /// Return `true` if large `Publish()` requests are compressed.
+  bool compression() const { return compression_; }
+
+  /// The minimum size, in bytes, of the compressed `Publish()` requests.
+  std::size_t compression_threshold() const { return compression_threshold_; }
+
+  /**
+   * Compress `Publish()` requests of at least @p threshold bytes.
+   *
+   * The publisher uses gRPC message compression (gzip) for each batch whose
+   * serialized size is at least @p threshold bytes. Text payloads, such as
+   * JSON, often compress very well, and compressing them reduces the network
+   * traffic, at the cost of some CPU in the publisher. Smaller batches are not
+   * compressed, as the savings rarely justify the CPU cost.
+   *
+   * The service decompresses the messages, subscribers receive them unchanged
+   * and need no configuration.
+   */
+  PublisherOptions& enable_compression(
+      std::size_t threshold = kDefaultCompressionThreshold) {
+    compression_ = true;
+    compression_threshold_ = threshold;
+    return *this;
+  }
+
+  /// Disable compression, this is the default.
+  PublisherOptions& disable_compression() {
+    compression_ = false;
+    return *this;
+  }
+
+  /// The maximum number of concurrent `Publish()` RPCs.
+  std::size_t maximum_concurrent_batches() const {
+    return maximum_concurrent_batches_;
+  }
+
+  /**
+   * Set the maximum number of concurrent `Publish()` RPCs.
+   *
+   * By default each batch is sent as soon as it is ready, without waiting for
+   * previous batches. Applications can bound the number of concurrent RPCs,
+   * across all ordering keys, for example to share the channels with other
+   * work. Batches beyond this limit wait in the publisher.
+   */
+  PublisherOptions& set_maximum_concurrent_batches(std::size_t v) {
+    maximum_concurrent_batches_ = v;
+    return *this;
+  }
+
+  /// The maximum number of concurrent `Publish()` RPCs for each ordering key.
+  std::size_t ordering_key_pipeline_depth() const {
+    return ordering_key_pipeline_depth_;
+  }
+
+  /**
+   * Set the maximum number of concurrent `Publish()` RPCs for each ordering
+   * key.
+   *
+   * With message ordering enabled, the publisher sends the batches for an
+   * ordering key one at a time (the default depth is 1), which limits the
+   * throughput of each key to one batch per round-trip. With a larger depth
+   * the publisher sends the next batches before the previous ones complete.
+   * The batches for each ordering key are always sent, in order, over the
+   * same gRPC channel, so the service receives them in order.
+   *
+   * @warning With a depth larger than 1 failed batches are not retried, as a
+   *     retry could be received after the following batches. A failure stops
+   *     publishing for the ordering key, as usual, but the batches sent before
+   *     the failure was detected may succeed. Use `Publisher::ResumePublish()`
+   *     to continue publishing.
+   */
+  PublisherOptions& set_ordering_key_pipeline_depth(std::size_t v) {
+    ordering_key_pipeline_depth_ = v;
+    return *this;
+  }
+
+  /// The maximum number of messages published but not yet acknowledged.
+  std::size_t maximum_pending_messages() const {
+    return maximum_pending_messages_;
+  }
+
+  /**
+   * Set the maximum number of pending messages.
+   *
+   * A message is pending from the time `Publisher::Publish()` is called until
+   * the future it returns is satisfied. Bounding the number (and size, see
+   * `set_maximum_pending_bytes()`) of pending messages bounds the memory used
+   * by the publisher when the service cannot keep up with the application.
+   * What happens when the limit is reached is controlled by the
+   * `set_full_publisher_*()` functions.
+   *
+   * @note The limits are ignored unless one of `set_full_publisher_blocks()`,
+   *     `set_full_publisher_rejects()`, or
+   *     `set_full_publisher_discards_oldest()` is called.
+   */
+  PublisherOptions& set_maximum_pending_messages(std::size_t v) {
+    maximum_pending_messages_ = v;
+    return *this;
+  }
+
+  /// The maximum size of the messages published but not yet acknowledged.
+  std::size_t maximum_pending_bytes() const { return maximum_pending_bytes_; }
+
+  /**
+   * Set the maximum size of the pending messages.
+   *
+   * @see `set_maximum_pending_messages()` for details.
+   */
+  PublisherOptions& set_maximum_pending_bytes(std::size_t v) {
+    maximum_pending_bytes_ = v;
+    return *this;
+  }
+
+  /// Return `true` if the pending message limits are ignored (the default).
+  bool full_publisher_ignored() const {
+    return full_action_ == FullPublisherAction::kIgnored;
+  }
+
+  /// Return `true` if new messages are rejected when the publisher is full.
+  bool full_publisher_rejects() const {
+    return full_action_ == FullPublisherAction::kRejects;
+  }
+
+  /// Return `true` if `Publish()` blocks when the publisher is full.
+  bool full_publisher_blocks() const {
+    return full_action_ == FullPublisherAction::kBlocks;
+  }
+
+  /// Return `true` if old messages are discarded when the publisher is full.
+  bool full_publisher_discards_oldest() const {
+    return full_action_ == FullPublisherAction::kDiscardsOldest;
+  }
+
+  /// Ignore the pending message limits, this is the default.
+  PublisherOptions& set_full_publisher_ignored() {
+    full_action_ = FullPublisherAction::kIgnored;
+    return *this;
+  }
+
+  /**
+   * Reject new messages when the publisher is full.
+   *
+   * The future returned by `Publish()` is satisfied immediately with a
+   * `kFailedPrecondition` error.
+   */
+  PublisherOptions& set_full_publisher_rejects() {
+    full_action_ = FullPublisherAction::kRejects;
+    return *this;
+  }
+
+  /**
+   * Block the caller of `Publish()` until the publisher has room for the new
+   * message.
+   *
+   * @warning Do not call `Publish()` from the background threads used by the
+   *     publisher (e.g. in a `.then()` callback) with this setting. If all the
+   *     background threads are blocked the pending messages never complete, and
+   *     the application deadlocks.
+   */
+  PublisherOptions& set_full_publisher_blocks() {
+    full_action_ = FullPublisherAction::kBlocks;
+    return *this;
+  }
+
+  /**
+   * Discard the oldest messages, not yet sent to the service, when the
+   * publisher is full.
+   *
+   * Messages sent to the service are pending until the service responds, and
+   * only messages beyond the limits wait in the publisher. When this backlog
+   * is full the oldest messages in it are discarded to make room for new
+   * messages, their futures are satisfied with a `kFailedPrecondition` error.
+   * This is useful for applications, such as telemetry, where recent messages
+   * are more valuable than old ones. The memory used by the publisher is at
+   * most twice the configured limits.
+   *
+   * @note With message ordering enabled the discarded messages create gaps in
+   *     the sequence of messages for their ordering key.
+   */
+  PublisherOptions& set_full_publisher_discards_oldest() {
+    full_action_ = FullPublisherAction::kDiscardsOldest;
+    return *this;
+  }
+
+  /// The budget for the memory used by the pending messages, if any.
+  std::shared_ptr<MemoryBudget> const& memory_budget() const {
+    return memory_budget_;
+  }
+
+  /**
+   * Report the memory used by the pending messages to @p budget.
+   *
+   * The messages are reported as the `pending-messages` subsystem of a client
+   * named after the topic. Several publishers, and other clients, can share
+   * the same budget. When the budget is exhausted new messages are rejected
+   * with a `kFailedPrecondition` error, or `Publish()` blocks if
+   * `set_full_publisher_blocks()` is in effect.
+   */
+  PublisherOptions& set_memory_budget(std::shared_ptr<MemoryBudget> v) {
+    memory_budget_ = std::move(v);
+    return *this;
+  }
+
  private:
   static auto constexpr kDefaultMaximumHoldTime = std::chrono::milliseconds(10);
   static std::size_t constexpr kDefaultMaximumMessageCount = 100;
   static std::size_t constexpr kDefaultMaximumMessageSize = 1024 * 1024L;
+  static std::size_t constexpr kDefaultCompressionThreshold = 1024;
 
   std::chrono::microseconds maximum_hold_time_ = kDefaultMaximumHoldTime;
   std::size_t maximum_batch_message_count_ = kDefaultMaximumMessageCount;
   std::size_t maximum_batch_bytes_ = kDefaultMaximumMessageSize;
   bool message_ordering_ = false;
+  bool compression_ = false;
+  std::size_t compression_threshold_ = kDefaultCompressionThreshold;
+  std::size_t maximum_concurrent_batches_ =
+      (std::numeric_limits<std::size_t>::max)();
+  std::size_t ordering_key_pipeline_depth_ = 1;
+  std::size_t maximum_pending_messages_ =
+      (std::numeric_limits<std::size_t>::max)();
+  std::size_t maximum_pending_bytes_ =
+      (std::numeric_limits<std::size_t>::max)();
+  enum class FullPublisherAction {
+    kIgnored,
+    kRejects,
+    kBlocks,
+    kDiscardsOldest
+  };
+  FullPublisherAction full_action_ = FullPublisherAction::kIgnored;
+  std::shared_ptr<MemoryBudget> memory_budget_;
 };
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
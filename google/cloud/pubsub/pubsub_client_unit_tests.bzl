@@ -18,17 +18,28 @@
 
 pubsub_client_unit_tests = [
     "ack_handler_test.cc",
+    "batch_ack_handler_test.cc",
     "internal/batching_publisher_connection_test.cc",
+    "internal/concurrency_limited_batch_sink_test.cc",
+    "internal/deduplicating_batch_source_test.cc",
     "internal/default_batch_sink_test.cc",
     "internal/emulator_overrides_test.cc",
+    "internal/flow_controlled_publisher_connection_test.cc",
+    "internal/flush_scheduler_test.cc",
+    "internal/multiplexed_batch_source_test.cc",
     "internal/ordering_key_publisher_connection_test.cc",
+    "internal/processing_time_distribution_test.cc",
+    "internal/publisher_fault_injection_test.cc",
     "internal/publisher_logging_test.cc",
     "internal/publisher_metadata_test.cc",
     "internal/publisher_round_robin_test.cc",
     "internal/rejects_with_ordering_key_test.cc",
     "internal/sequential_batch_sink_test.cc",
     "internal/session_shutdown_manager_test.cc",
+    "internal/shared_background_threads_test.cc",
     "internal/streaming_subscription_batch_source_test.cc",
+    "internal/stub_pool_test.cc",
+    "internal/subscriber_fault_injection_test.cc",
     "internal/subscriber_logging_test.cc",
     "internal/subscriber_metadata_test.cc",
     "internal/subscriber_round_robin_test.cc",
@@ -38,12 +49,14 @@ pubsub_client_unit_tests = [
     "internal/subscription_session_test.cc",
     "internal/user_agent_prefix_test.cc",
     "message_test.cc",
+    "multi_topic_publisher_test.cc",
     "publisher_connection_test.cc",
     "publisher_option_test.cc",
     "publisher_test.cc",
     "snapshot_builder_test.cc",
     "snapshot_test.cc",
     "subscriber_connection_test.cc",
+    "subscriber_metrics_test.cc",
     "subscriber_options_test.cc",
     "subscriber_test.cc",
     "subscription_admin_client_test.cc",
@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_RETRY_POLICY_H
 
 #include "google/cloud/pubsub/version.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/internal/retry_policy.h"
 #include "google/cloud/status.h"
 
@@ -54,6 +55,13 @@ using LimitedErrorCountRetryPolicy =
     google::cloud::internal::LimitedErrorCountRetryPolicy<
         pubsub_internal::RetryTraits>;
 
+/// A retry budget (and optional circuit breaker) shared across many calls.
+using RetryBudget = google::cloud::internal::RetryBudget;
+
+/// A retry policy that also consults a shared `RetryBudget`.
+using BudgetedRetryPolicy = google::cloud::internal::BudgetedRetryPolicy<
+    pubsub_internal::RetryTraits>;
+
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub
 }  // namespace cloud
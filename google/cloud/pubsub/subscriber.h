@@ -20,7 +20,10 @@
 #include "google/cloud/pubsub/subscription.h"
 #include "google/cloud/pubsub/version.h"
 #include "google/cloud/status.h"
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -131,6 +134,88 @@ class Subscriber {
     return connection_->Subscribe({std::move(f)});
   }
 
+  /**
+   * Creates a new session to receive batches of messages from @p subscription.
+   *
+   * This is similar to `Subscribe()`, but the callback receives several
+   * messages at a time, together with a `BatchAckHandler` to acknowledge them.
+   * Applications that process messages in bulk, for example, writing them to
+   * columnar storage, can use this function to amortize the per-message
+   * overhead.
+   *
+   * The library sends a batch once
+   * `SubscriberOptions::max_callback_batch_size()` messages are available,
+   * once no more messages can be received without
+   * acknowledging some of the outstanding messages, or after
+   * `SubscriberOptions::max_callback_batch_latency()`. Note that
+   * `SubscriberOptions::max_concurrency()` limits the number of outstanding
+   * messages, including the messages in batches, applications using large
+   * batches should increase it accordingly. The flow control limits in
+   * `SubscriberOptions` are respected as usual.
+   *
+   * Messages with the same ordering key are never in the same batch, the next
+   * message for an ordering key is delivered once the previous one is
+   * acknowledged or rejected.
+   *
+   * @note Callable must be `CopyConstructible`, as @p cb will be stored in a
+   *   [`std::function<>`][std-function-link].
+   *
+   * @param cb the callable invoked when messages are received. This must be
+   *     usable to construct a
+   *     `std::function<void(std::vector<pubsub::Message>, BatchAckHandler)>`.
+   * @return a future that is satisfied when the session will no longer receive
+   *     messages. Calling `.cancel()` in this object will (eventually)
+   *     terminate the session and satisfy the future.
+   *
+   * [std-function-link]:
+   * https://en.cppreference.com/w/cpp/utility/functional/function
+   */
+  template <typename Callable>
+  future<Status> SubscribeBatch(Callable&& cb) {
+    std::function<void(std::vector<Message>, BatchAckHandler)> f(
+        std::forward<Callable>(cb));
+    return connection_->Subscribe({ApplicationCallback{}, std::move(f)});
+  }
+
+  /**
+   * Receives up to @p max_messages messages from the subscription.
+   *
+   * Applications that drain a subscription in batch jobs can use this function
+   * and `Acknowledge()` instead of `Subscribe()`, avoiding the setup of a
+   * streaming session and the lease management. The library splits the request
+   * across the channels in the `SubscriberConnection`, and sends the requests
+   * in parallel using the background threads.
+   *
+   * The messages are not leased, applications must acknowledge them before
+   * the subscription's acknowledgement deadline expires, otherwise the service
+   * redelivers them. Returning fewer messages than requested, including none,
+   * does not imply that the subscription is empty.
+   *
+   * @par Idempotency
+   * This is treated as an idempotent operation, the messages from a failed
+   * request are redelivered by the service once their deadline expires.
+   *
+   * @param max_messages the maximum number of messages to return.
+   */
+  StatusOr<std::vector<PulledMessage>> Pull(std::int32_t max_messages) {
+    return connection_->Pull({max_messages});
+  }
+
+  /**
+   * Acknowledges the messages identified by @p ack_ids.
+   *
+   * The ack ids are sent in as few requests as possible.
+   *
+   * @par Idempotency
+   * This is an idempotent operation, acknowledging a message more than once
+   * has no effect.
+   *
+   * @param ack_ids the values of `PulledMessage::ack_id` for the messages.
+   */
+  Status Acknowledge(std::vector<std::string> ack_ids) {
+    return connection_->Acknowledge({std::move(ack_ids)});
+  }
+
  private:
   std::shared_ptr<SubscriberConnection> connection_;
 };
@@ -14,14 +14,19 @@
 
 #include "google/cloud/pubsub/subscriber_connection.h"
 #include "google/cloud/pubsub/internal/default_retry_policies.h"
+#include "google/cloud/pubsub/internal/shared_background_threads.h"
+#include "google/cloud/pubsub/internal/subscriber_fault_injection.h"
 #include "google/cloud/pubsub/internal/subscriber_logging.h"
 #include "google/cloud/pubsub/internal/subscriber_metadata.h"
 #include "google/cloud/pubsub/internal/subscriber_round_robin.h"
 #include "google/cloud/pubsub/internal/subscription_session.h"
 #include "google/cloud/pubsub/retry_policy.h"
 #include "google/cloud/internal/random.h"
+#include "google/cloud/internal/retry_loop.h"
 #include "google/cloud/log.h"
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <limits>
 #include <memory>
 
@@ -38,6 +43,15 @@ future<Status> SubscriberConnection::Subscribe(SubscribeParams) {
       Status{StatusCode::kUnimplemented, "needs-override"});
 }
 
+StatusOr<std::vector<PulledMessage>> SubscriberConnection::Pull(PullParams) {
+  return Status{StatusCode::kUnimplemented, "needs-override"};
+}
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+Status SubscriberConnection::Acknowledge(AcknowledgeParams) {
+  return Status{StatusCode::kUnimplemented, "needs-override"};
+}
+
 std::shared_ptr<SubscriberConnection> MakeSubscriberConnection(
     Subscription subscription, SubscriberOptions options,
     ConnectionOptions connection_options,
@@ -50,10 +64,15 @@ std::shared_ptr<SubscriberConnection> MakeSubscriberConnection(
     return pubsub_internal::CreateDefaultSubscriberStub(connection_options,
                                                         id++);
   });
+  // Slow channels are reconnected with new stubs.
+  auto factory = [connection_options](int channel_id) {
+    return pubsub_internal::CreateDefaultSubscriberStub(connection_options,
+                                                        channel_id);
+  };
   return pubsub_internal::MakeSubscriberConnection(
       std::move(subscription), std::move(options),
       std::move(connection_options), std::move(children),
-      std::move(retry_policy), std::move(backoff_policy));
+      std::move(retry_policy), std::move(backoff_policy), std::move(factory));
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
@@ -62,18 +81,27 @@ std::shared_ptr<SubscriberConnection> MakeSubscriberConnection(
 namespace pubsub_internal {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 namespace {
+
+using ::google::cloud::internal::Idempotency;
+using ::google::cloud::internal::RetryLoop;
+
+// The service rejects `Acknowledge()` requests with more ack ids.
+auto constexpr kMaxAckIdsPerRequest = 2500;
+
 class SubscriberConnectionImpl : public pubsub::SubscriberConnection {
  public:
   explicit SubscriberConnectionImpl(
       pubsub::Subscription subscription, pubsub::SubscriberOptions options,
       pubsub::ConnectionOptions const& connection_options,
       std::shared_ptr<pubsub_internal::SubscriberStub> stub,
+      std::size_t pull_parallelism,
       std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
       std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy)
       : subscription_(std::move(subscription)),
         options_(std::move(options)),
         stub_(std::move(stub)),
-        background_(connection_options.background_threads_factory()()),
+        pull_parallelism_((std::max)(pull_parallelism, std::size_t{1})),
+        background_(MakeBackgroundThreads(connection_options)),
         retry_policy_(std::move(retry_policy)),
         backoff_policy_(std::move(backoff_policy)),
         generator_(google::cloud::internal::MakeDefaultPRNG()) {}
@@ -92,10 +120,89 @@ class SubscriberConnectionImpl : public pubsub::SubscriberConnection {
         std::move(p), retry_policy_->clone(), backoff_policy_->clone());
   }
 
+  StatusOr<std::vector<pubsub::PulledMessage>> Pull(PullParams p) override {
+    // Split the request across the channels, each `Pull()` returns at most
+    // the messages available in one server, and running them in parallel
+    // drains the subscription faster.
+    auto const max_messages = (std::max)(p.max_messages, std::int32_t{1});
+    auto const n = static_cast<std::int32_t>((std::min)(
+        pull_parallelism_, static_cast<std::size_t>(max_messages)));
+    std::vector<future<StatusOr<google::pubsub::v1::PullResponse>>> pending;
+    for (std::int32_t i = 1; i < n; ++i) {
+      auto size = max_messages / n + (i < max_messages % n ? 1 : 0);
+      auto done = std::make_shared<
+          promise<StatusOr<google::pubsub::v1::PullResponse>>>();
+      pending.push_back(done->get_future());
+      background_->cq().RunAsync(
+          [this, size, done] { done->set_value(PullOnce(size)); });
+    }
+    // The first request runs in this thread.
+    auto first = PullOnce(max_messages / n + (max_messages % n != 0 ? 1 : 0));
+
+    std::vector<pubsub::PulledMessage> messages;
+    Status error;
+    auto merge = [&](StatusOr<google::pubsub::v1::PullResponse> r) {
+      if (!r) {
+        if (error.ok()) error = std::move(r).status();
+        return;
+      }
+      for (auto& m : *r->mutable_received_messages()) {
+        messages.push_back(pubsub::PulledMessage{
+            FromProto(std::move(*m.mutable_message())),
+            std::move(*m.mutable_ack_id())});
+      }
+    };
+    merge(std::move(first));
+    for (auto& f : pending) merge(f.get());
+    // Once the messages are received they are leased to this client, return
+    // them even if some of the requests failed.
+    if (messages.empty() && !error.ok()) return error;
+    return messages;
+  }
+
+  Status Acknowledge(AcknowledgeParams p) override {
+    auto& ids = p.ack_ids;
+    for (auto b = ids.begin(); b != ids.end();) {
+      auto const count = (std::min)(std::distance(b, ids.end()),
+                                    std::ptrdiff_t{kMaxAckIdsPerRequest});
+      auto e = std::next(b, count);
+      google::pubsub::v1::AcknowledgeRequest request;
+      request.set_subscription(subscription_.FullName());
+      for (auto i = b; i != e; ++i) request.add_ack_ids(std::move(*i));
+      auto status = RetryLoop(
+          retry_policy_->clone(), backoff_policy_->clone(),
+          Idempotency::kIdempotent,
+          [this](grpc::ClientContext& context,
+                 google::pubsub::v1::AcknowledgeRequest const& request) {
+            return stub_->Acknowledge(context, request);
+          },
+          request, __func__);
+      if (!status.ok()) return status;
+      b = e;
+    }
+    return Status{};
+  }
+
  private:
+  StatusOr<google::pubsub::v1::PullResponse> PullOnce(
+      std::int32_t max_messages) {
+    google::pubsub::v1::PullRequest request;
+    request.set_subscription(subscription_.FullName());
+    request.set_max_messages(max_messages);
+    return RetryLoop(
+        retry_policy_->clone(), backoff_policy_->clone(),
+        Idempotency::kIdempotent,
+        [this](grpc::ClientContext& context,
+               google::pubsub::v1::PullRequest const& request) {
+          return stub_->Pull(context, request);
+        },
+        request, "Pull");
+  }
+
   pubsub::Subscription const subscription_;
   pubsub::SubscriberOptions const options_;
   std::shared_ptr<pubsub_internal::SubscriberStub> stub_;
+  std::size_t const pull_parallelism_;
   std::shared_ptr<BackgroundThreads> background_;
   std::unique_ptr<pubsub::RetryPolicy const> retry_policy_;
   std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy_;
@@ -122,7 +229,8 @@ std::shared_ptr<pubsub::SubscriberConnection> MakeSubscriberConnection(
     pubsub::ConnectionOptions connection_options,
     std::vector<std::shared_ptr<SubscriberStub>> stubs,
     std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
-    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy) {
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    std::function<std::shared_ptr<SubscriberStub>(int)> stub_factory) {
   auto default_retry_policy = [] {
     // Subscribers are special: by default we want to retry essentially forever
     // because (a) the service will disconnect the streaming pull from time to
@@ -135,28 +243,27 @@ std::shared_ptr<pubsub::SubscriberConnection> MakeSubscriberConnection(
   if (stubs.empty()) return nullptr;
   if (!retry_policy) retry_policy = default_retry_policy();
   if (!backoff_policy) backoff_policy = DefaultBackoffPolicy();
-  std::shared_ptr<SubscriberStub> stub =
-      std::make_shared<SubscriberRoundRobin>(std::move(stubs));
+  auto const pull_parallelism = stubs.size();
+  std::shared_ptr<SubscriberStub> stub = std::make_shared<SubscriberRoundRobin>(
+      std::move(stubs), std::move(stub_factory));
   stub = std::make_shared<SubscriberMetadata>(std::move(stub));
+  if (connection_options.fault_injection().enabled()) {
+    GCP_LOG(WARNING) << "Enabled fault injection for gRPC calls";
+    auto injector = std::make_shared<google::cloud::internal::FaultInjector>(
+        connection_options.fault_injection());
+    stub = std::make_shared<pubsub_internal::SubscriberFaultInjection>(
+        std::move(stub), std::move(injector));
+  }
   if (connection_options.tracing_enabled("rpc")) {
     GCP_LOG(INFO) << "Enabled logging for gRPC calls";
     stub = std::make_shared<pubsub_internal::SubscriberLogging>(
         std::move(stub), connection_options.tracing_options(),
         connection_options.tracing_enabled("rpc-streams"));
   }
-  auto default_thread_pool_size = []() -> std::size_t {
-    auto constexpr kDefaultThreadPoolSize = 4;
-    auto const n = std::thread::hardware_concurrency();
-    return n == 0 ? kDefaultThreadPoolSize : n;
-  };
-  if (connection_options.background_thread_pool_size() == 0) {
-    connection_options.set_background_thread_pool_size(
-        default_thread_pool_size());
-  }
   return std::make_shared<SubscriberConnectionImpl>(
       std::move(subscription), std::move(options),
-      std::move(connection_options), std::move(stub), std::move(retry_policy),
-      std::move(backoff_policy));
+      std::move(connection_options), std::move(stub), pull_parallelism,
+      std::move(retry_policy), std::move(backoff_policy));
 }
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
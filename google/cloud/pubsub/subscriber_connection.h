@@ -18,6 +18,7 @@
 #include "google/cloud/pubsub/ack_handler.h"
 #include "google/cloud/pubsub/application_callback.h"
 #include "google/cloud/pubsub/backoff_policy.h"
+#include "google/cloud/pubsub/batch_ack_handler.h"
 #include "google/cloud/pubsub/connection_options.h"
 #include "google/cloud/pubsub/internal/subscriber_stub.h"
 #include "google/cloud/pubsub/message.h"
@@ -26,13 +27,23 @@
 #include "google/cloud/pubsub/subscription.h"
 #include "google/cloud/pubsub/version.h"
 #include "google/cloud/status_or.h"
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
 namespace pubsub {
 inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 
+/// A message received by `Subscriber::Pull()`.
+struct PulledMessage {
+  Message message;
+  /// Use this value to acknowledge the message via `Subscriber::Acknowledge()`.
+  std::string ack_id;
+};
+
 /**
  * A connection to the Cloud Pub/Sub service to receive events.
  *
@@ -58,10 +69,28 @@ class SubscriberConnection {
   /// Wrap the arguments for `Subscribe()`
   struct SubscribeParams {
     ApplicationCallback callback;
+    /// If set, the messages are delivered in batches, `callback` is not used.
+    BatchApplicationCallback batch_callback;
   };
 
   /// Defines the interface for `Subscriber::Subscribe()`
   virtual future<Status> Subscribe(SubscribeParams p);
+
+  /// Wrap the arguments for `Pull()`
+  struct PullParams {
+    std::int32_t max_messages;
+  };
+
+  /// Defines the interface for `Subscriber::Pull()`
+  virtual StatusOr<std::vector<PulledMessage>> Pull(PullParams p);
+
+  /// Wrap the arguments for `Acknowledge()`
+  struct AcknowledgeParams {
+    std::vector<std::string> ack_ids;
+  };
+
+  /// Defines the interface for `Subscriber::Acknowledge()`
+  virtual Status Acknowledge(AcknowledgeParams p);
 };
 
 /**
@@ -80,6 +109,14 @@ class SubscriberConnection {
  * same `ConnectionOptions` parameters. However, this behavior is not guaranteed
  * and applications should not rely on it.
  *
+ * @par Background Threads
+ * Unless the application configures the background threads in
+ * @p connection_options, all the Pub/Sub connections in a process share a
+ * single pool of background threads, with one thread per core. Applications
+ * can use `ConnectionOptions::set_background_thread_pool_size()` to create a
+ * dedicated pool for a connection, or `DisableBackgroundThreads()` to provide
+ * their own `CompletionQueue`.
+ *
  * @see `SubscriberConnection`
  *
  * @par Changing Retry Parameters Example
@@ -120,7 +157,8 @@ std::shared_ptr<pubsub::SubscriberConnection> MakeSubscriberConnection(
     pubsub::ConnectionOptions connection_options,
     std::vector<std::shared_ptr<SubscriberStub>> stubs,
     std::unique_ptr<pubsub::RetryPolicy const> retry_policy,
-    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy);
+    std::unique_ptr<pubsub::BackoffPolicy const> backoff_policy,
+    std::function<std::shared_ptr<SubscriberStub>(int)> stub_factory = {});
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub_internal
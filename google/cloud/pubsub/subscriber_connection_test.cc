@@ -22,7 +22,9 @@
 #include "google/cloud/testing_util/status_matchers.h"
 #include "google/cloud/testing_util/validate_metadata.h"
 #include <gmock/gmock.h>
+#include <algorithm>
 #include <atomic>
+#include <mutex>
 
 namespace google {
 namespace cloud {
@@ -35,8 +37,11 @@ using ::google::cloud::testing_util::IsContextMDValid;
 using ::google::cloud::testing_util::StatusIs;
 using ::testing::AtLeast;
 using ::testing::Contains;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
+using ::testing::Return;
 using ::testing::StartsWith;
+using ::testing::UnorderedElementsAre;
 
 TEST(SubscriberConnectionTest, Basic) {
   auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
@@ -196,6 +201,86 @@ TEST(SubscriberConnectionTest, MakeSubscriberConnectionSetupsMetadata) {
   ASSERT_STATUS_OK(response.get());
 }
 
+TEST(SubscriberConnectionTest, PullParallel) {
+  Subscription const subscription("test-project", "test-subscription");
+  std::mutex mu;
+  std::vector<int> sizes;
+  std::vector<std::shared_ptr<pubsub_internal::SubscriberStub>> stubs;
+  for (int i = 0; i != 3; ++i) {
+    auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+    EXPECT_CALL(*mock, Pull)
+        .WillOnce([&, i](grpc::ClientContext&,
+                         google::pubsub::v1::PullRequest const& request) {
+          EXPECT_EQ(subscription.FullName(), request.subscription());
+          {
+            std::lock_guard<std::mutex> lk(mu);
+            sizes.push_back(request.max_messages());
+          }
+          google::pubsub::v1::PullResponse response;
+          auto& m = *response.add_received_messages();
+          m.set_ack_id("ack-" + std::to_string(i));
+          m.mutable_message()->set_data("data-" + std::to_string(i));
+          return make_status_or(response);
+        });
+    stubs.push_back(std::move(mock));
+  }
+
+  auto subscriber = pubsub_internal::MakeSubscriberConnection(
+      subscription, {}, ConnectionOptions{grpc::InsecureChannelCredentials()},
+      std::move(stubs), pubsub_testing::TestRetryPolicy(),
+      pubsub_testing::TestBackoffPolicy());
+  auto messages = subscriber->Pull({10});
+  ASSERT_STATUS_OK(messages);
+  std::vector<std::string> ack_ids;
+  for (auto const& m : *messages) {
+    EXPECT_EQ("data-" + m.ack_id.substr(4), m.message.data());
+    ack_ids.push_back(m.ack_id);
+  }
+  EXPECT_THAT(ack_ids, UnorderedElementsAre("ack-0", "ack-1", "ack-2"));
+  // 10 messages over 3 channels.
+  EXPECT_THAT(sizes, UnorderedElementsAre(4, 3, 3));
+}
+
+TEST(SubscriberConnectionTest, PullFailureNoMessages) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  Subscription const subscription("test-project", "test-subscription");
+  EXPECT_CALL(*mock, Pull)
+      .WillOnce(Return(Status(StatusCode::kPermissionDenied, "uh-oh")));
+
+  auto subscriber = pubsub_internal::MakeSubscriberConnection(
+      subscription, {}, ConnectionOptions{grpc::InsecureChannelCredentials()},
+      mock, pubsub_testing::TestRetryPolicy(),
+      pubsub_testing::TestBackoffPolicy());
+  EXPECT_THAT(subscriber->Pull({10}),
+              StatusIs(StatusCode::kPermissionDenied, HasSubstr("uh-oh")));
+}
+
+TEST(SubscriberConnectionTest, AcknowledgeInChunks) {
+  auto mock = std::make_shared<pubsub_testing::MockSubscriberStub>();
+  Subscription const subscription("test-project", "test-subscription");
+  std::vector<int> sizes;
+  EXPECT_CALL(*mock, Acknowledge)
+      .Times(2)
+      .WillRepeatedly(
+          [&](grpc::ClientContext&,
+              google::pubsub::v1::AcknowledgeRequest const& request) {
+            EXPECT_EQ(subscription.FullName(), request.subscription());
+            sizes.push_back(request.ack_ids_size());
+            return Status{};
+          });
+
+  auto subscriber = pubsub_internal::MakeSubscriberConnection(
+      subscription, {}, ConnectionOptions{grpc::InsecureChannelCredentials()},
+      mock, pubsub_testing::TestRetryPolicy(),
+      pubsub_testing::TestBackoffPolicy());
+  std::vector<std::string> ack_ids(3000);
+  int id = 0;
+  std::generate(ack_ids.begin(), ack_ids.end(),
+                [&id] { return "ack-" + std::to_string(id++); });
+  ASSERT_STATUS_OK(subscriber->Acknowledge({std::move(ack_ids)}));
+  EXPECT_THAT(sizes, ElementsAre(2500, 500));
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub
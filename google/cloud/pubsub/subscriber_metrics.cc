@@ -0,0 +1,214 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/subscriber_metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace google {
+namespace cloud {
+namespace pubsub {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+// Each power of two is split into `kSubBuckets` buckets.
+int constexpr kSubBucketBits = 3;
+std::uint64_t constexpr kSubBuckets = 1 << kSubBucketBits;
+// Values up to 2^kMaxExponent microseconds (about 12 days) are recorded in
+// separate buckets, larger values are recorded in the last bucket.
+int constexpr kMaxExponent = 40;
+std::size_t constexpr kBucketCount =
+    kSubBuckets * (kMaxExponent - kSubBucketBits + 2);
+
+int Log2(std::uint64_t value) {
+  int r = 0;
+  while (value >>= 1) ++r;
+  return r;
+}
+
+std::size_t BucketIndex(std::uint64_t value) {
+  if (value < 2 * kSubBuckets) return static_cast<std::size_t>(value);
+  auto const exponent = Log2(value);
+  if (exponent > kMaxExponent) return kBucketCount - 1;
+  auto const shift = exponent - kSubBucketBits;
+  auto const sub_bucket = (value >> shift) - kSubBuckets;
+  return static_cast<std::size_t>(kSubBuckets * (shift + 1) + sub_bucket);
+}
+
+std::uint64_t BucketUpperBound(std::size_t index) {
+  if (index < 2 * kSubBuckets) return index;
+  auto const shift = index / kSubBuckets - 1;
+  auto const sub_bucket = index % kSubBuckets;
+  return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+}
+
+std::chrono::microseconds Elapsed(std::chrono::steady_clock::time_point start,
+                                  std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() : counts_(kBucketCount) {}
+
+void LatencyHistogram::Record(std::chrono::microseconds value) {
+  auto const v = static_cast<std::uint64_t>((std::max)(
+      value, std::chrono::microseconds(0)).count());
+  ++counts_[BucketIndex(v)];
+  min_ = count_ == 0 ? v : (std::min)(min_, v);
+  max_ = count_ == 0 ? v : (std::max)(max_, v);
+  sum_ += v;
+  ++count_;
+}
+
+std::chrono::microseconds LatencyHistogram::min() const {
+  return std::chrono::microseconds(min_);
+}
+
+std::chrono::microseconds LatencyHistogram::max() const {
+  return std::chrono::microseconds(max_);
+}
+
+std::chrono::microseconds LatencyHistogram::mean() const {
+  if (count_ == 0) return std::chrono::microseconds(0);
+  return std::chrono::microseconds(sum_ / count_);
+}
+
+std::chrono::microseconds LatencyHistogram::Percentile(
+    double percentile) const {
+  if (count_ == 0) return std::chrono::microseconds(0);
+  auto const p = (std::min)(100.0, (std::max)(0.0, percentile));
+  auto const rank = (std::max<std::uint64_t>)(
+      1, static_cast<std::uint64_t>(
+             std::ceil(p / 100.0 * static_cast<double>(count_))));
+  std::uint64_t cumulative = 0;
+  for (std::size_t i = 0; i != counts_.size(); ++i) {
+    cumulative += counts_[i];
+    if (cumulative >= rank) {
+      return std::chrono::microseconds(
+          (std::min)(max_, (std::max)(min_, BucketUpperBound(i))));
+    }
+  }
+  return max();
+}
+
+std::vector<LatencyHistogram::Bucket> LatencyHistogram::buckets() const {
+  std::vector<Bucket> result;
+  for (std::size_t i = 0; i != counts_.size(); ++i) {
+    if (counts_[i] == 0) continue;
+    result.push_back(
+        Bucket{std::chrono::microseconds(BucketUpperBound(i)), counts_[i]});
+  }
+  return result;
+}
+
+SubscriberMetrics::SubscriberMetrics()
+    : start_(std::chrono::steady_clock::now()) {}
+
+SubscriberMetricsSnapshot SubscriberMetrics::Snapshot() const {
+  std::unique_lock<std::mutex> lk(mu_);
+  return SnapshotImpl(lk);
+}
+
+SubscriberMetricsSnapshot SubscriberMetrics::SnapshotAndReset() {
+  std::unique_lock<std::mutex> lk(mu_);
+  auto result = SnapshotImpl(lk);
+  // Keep the limits, they only change when a new session starts.
+  SubscriberMetricsSnapshot reset;
+  reset.max_outstanding_messages = metrics_.max_outstanding_messages;
+  reset.max_outstanding_bytes = metrics_.max_outstanding_bytes;
+  reset.max_concurrency = metrics_.max_concurrency;
+  metrics_ = std::move(reset);
+  start_ = std::chrono::steady_clock::now();
+  return result;
+}
+
+void SubscriberMetrics::SetLimits(std::int64_t max_outstanding_messages,
+                                  std::int64_t max_outstanding_bytes,
+                                  std::size_t max_concurrency) {
+  std::lock_guard<std::mutex> lk(mu_);
+  metrics_.max_outstanding_messages = max_outstanding_messages;
+  metrics_.max_outstanding_bytes = max_outstanding_bytes;
+  metrics_.max_concurrency = max_concurrency;
+}
+
+void SubscriberMetrics::RecordReceived(std::string const& ack_id,
+                                       std::size_t bytes) {
+  auto const now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lk(mu_);
+  ++metrics_.messages_received;
+  outstanding_.emplace(ack_id, Outstanding{now, now, bytes, false});
+}
+
+void SubscriberMetrics::RecordCallbackStart(std::string const& ack_id) {
+  auto const now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lk(mu_);
+  auto i = outstanding_.find(ack_id);
+  if (i == outstanding_.end() || i->second.running) return;
+  i->second.running = true;
+  i->second.callback_start = now;
+  metrics_.queueing_delay.Record(Elapsed(i->second.received, now));
+}
+
+void SubscriberMetrics::RecordAck(std::string const& ack_id) {
+  std::unique_lock<std::mutex> lk(mu_);
+  ++metrics_.acks;
+  RecordHandled(lk, ack_id);
+}
+
+void SubscriberMetrics::RecordNack(std::string const& ack_id) {
+  std::unique_lock<std::mutex> lk(mu_);
+  ++metrics_.nacks;
+  RecordHandled(lk, ack_id);
+}
+
+void SubscriberMetrics::RecordLeaseExtensions(std::size_t count) {
+  std::lock_guard<std::mutex> lk(mu_);
+  metrics_.lease_extensions += count;
+}
+
+void SubscriberMetrics::RecordDuplicates(std::size_t count) {
+  std::lock_guard<std::mutex> lk(mu_);
+  metrics_.duplicates_suppressed += count;
+}
+
+SubscriberMetricsSnapshot SubscriberMetrics::SnapshotImpl(
+    std::unique_lock<std::mutex> const&) const {
+  auto result = metrics_;
+  result.interval = Elapsed(start_, std::chrono::steady_clock::now());
+  result.outstanding_messages = outstanding_.size();
+  for (auto const& kv : outstanding_) {
+    result.outstanding_bytes += kv.second.bytes;
+    if (kv.second.running) ++result.running_callbacks;
+  }
+  return result;
+}
+
+void SubscriberMetrics::RecordHandled(std::unique_lock<std::mutex> const&,
+                                      std::string const& ack_id) {
+  auto i = outstanding_.find(ack_id);
+  if (i == outstanding_.end()) return;
+  // Messages nacked before their callback started, e.g. on shutdown, have no
+  // processing time.
+  if (i->second.running) {
+    metrics_.processing_time.Record(
+        Elapsed(i->second.callback_start, std::chrono::steady_clock::now()));
+  }
+  outstanding_.erase(i);
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub
+}  // namespace cloud
+}  // namespace google
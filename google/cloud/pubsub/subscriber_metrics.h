@@ -0,0 +1,207 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_SUBSCRIBER_METRICS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_SUBSCRIBER_METRICS_H
+
+#include "google/cloud/pubsub/version.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace pubsub {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+
+/**
+ * A histogram of latencies with logarithmic buckets.
+ *
+ * The buckets are exact for values up to 16us, and then each power of two is
+ * divided in 8 buckets. The relative error of any reported value is therefore
+ * below 12.5%, independent of the magnitude of the value.
+ */
+class LatencyHistogram {
+ public:
+  /// A non-empty bucket in the histogram.
+  struct Bucket {
+    /// The largest value counted in this bucket.
+    std::chrono::microseconds upper_bound;
+    std::uint64_t count;
+  };
+
+  LatencyHistogram();
+
+  void Record(std::chrono::microseconds value);
+
+  std::uint64_t count() const { return count_; }
+  std::chrono::microseconds min() const;
+  std::chrono::microseconds max() const;
+  std::chrono::microseconds mean() const;
+
+  /**
+   * Returns an upper bound for the @p percentile (in the [0, 100] range) of the
+   * recorded values.
+   *
+   * Returns zero if the histogram is empty.
+   */
+  std::chrono::microseconds Percentile(double percentile) const;
+
+  /// The non-empty buckets, sorted by their upper bound.
+  std::vector<Bucket> buckets() const;
+
+ private:
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t count_ = 0;
+  std::uint64_t sum_ = 0;
+  std::uint64_t min_ = 0;
+  std::uint64_t max_ = 0;
+};
+
+/**
+ * The metrics for a subscription.
+ *
+ * The histograms and counters cover the period since the `SubscriberMetrics`
+ * object was created, or since the last call to `SnapshotAndReset()`. The
+ * gauges (`outstanding_*` and `running_callbacks`) are the values at the time
+ * of the snapshot.
+ *
+ * To find the bottleneck of a subscriber compare the gauges against their
+ * limits:
+ * - If `running_callbacks` is close to `max_concurrency` and the
+ *   `queueing_delay` is high, the messages wait for a callback slot, consider
+ *   increasing `SubscriberOptions::set_max_concurrency()`.
+ * - If `outstanding_messages` (or `outstanding_bytes`) is close to its limit,
+ *   flow control stops the service from sending more messages, consider
+ *   increasing the limits in `SubscriberOptions`.
+ * - If the `processing_time` is high, the application callbacks are the
+ *   bottleneck.
+ */
+struct SubscriberMetricsSnapshot {
+  /// The time covered by the histograms and counters.
+  std::chrono::microseconds interval = std::chrono::microseconds(0);
+
+  /// The number of messages received from the service.
+  std::uint64_t messages_received = 0;
+  /// The number of messages acknowledged.
+  std::uint64_t acks = 0;
+  /// The number of messages rejected, including those nacked on shutdown.
+  std::uint64_t nacks = 0;
+  /// The number of lease extensions (modacks), counting each message.
+  std::uint64_t lease_extensions = 0;
+  /// The number of redelivered messages suppressed by deduplication.
+  std::uint64_t duplicates_suppressed = 0;
+
+  /// The time from receiving a message until its callback starts.
+  LatencyHistogram queueing_delay;
+  /// The time from the start of a callback until the message is acked/nacked.
+  LatencyHistogram processing_time;
+
+  /// The messages received, but not yet acknowledged or rejected.
+  std::size_t outstanding_messages = 0;
+  /// The payload bytes in `outstanding_messages`.
+  std::size_t outstanding_bytes = 0;
+  /// The messages with a callback started, but not yet acked or nacked.
+  std::size_t running_callbacks = 0;
+
+  ///@{
+  /// @name The limits for the gauges, from the `SubscriberOptions`.
+  std::int64_t max_outstanding_messages = 0;
+  std::int64_t max_outstanding_bytes = 0;
+  std::size_t max_concurrency = 0;
+  ///@}
+
+  ///@{
+  /// @name The rate (per second) of each counter over `interval`.
+  double ack_rate() const { return Rate(acks); }
+  double nack_rate() const { return Rate(nacks); }
+  double lease_extension_rate() const { return Rate(lease_extensions); }
+  ///@}
+
+ private:
+  double Rate(std::uint64_t count) const {
+    if (interval.count() <= 0) return 0;
+    return static_cast<double>(count) * 1.0E6 /
+           static_cast<double>(interval.count());
+  }
+};
+
+/**
+ * Collects queueing, processing time, and flow control metrics for a
+ * subscription.
+ *
+ * Applications configure a `SubscriberMetrics` object via
+ * `SubscriberOptions::set_metrics()`, and then periodically call
+ * `Snapshot()` or `SnapshotAndReset()` to export the metrics to their
+ * monitoring system. Recording a metric only updates a few counters in a short
+ * critical section, so the metrics can remain enabled in production.
+ *
+ * Use a separate object for each subscription, the gauges in the snapshot
+ * would be meaningless if multiple subscriptions share an object.
+ *
+ * This class is thread-safe.
+ */
+class SubscriberMetrics {
+ public:
+  SubscriberMetrics();
+
+  /// Returns the metrics recorded so far.
+  SubscriberMetricsSnapshot Snapshot() const;
+
+  /// Returns the metrics recorded so far, and resets the histograms and
+  /// counters.
+  SubscriberMetricsSnapshot SnapshotAndReset();
+
+  ///@{
+  /// @name Record metrics, the library calls these functions.
+  void SetLimits(std::int64_t max_outstanding_messages,
+                 std::int64_t max_outstanding_bytes,
+                 std::size_t max_concurrency);
+  void RecordReceived(std::string const& ack_id, std::size_t bytes);
+  void RecordCallbackStart(std::string const& ack_id);
+  void RecordAck(std::string const& ack_id);
+  void RecordNack(std::string const& ack_id);
+  void RecordLeaseExtensions(std::size_t count);
+  void RecordDuplicates(std::size_t count);
+  ///@}
+
+ private:
+  struct Outstanding {
+    std::chrono::steady_clock::time_point received;
+    std::chrono::steady_clock::time_point callback_start;
+    std::size_t bytes;
+    bool running;
+  };
+
+  SubscriberMetricsSnapshot SnapshotImpl(
+      std::unique_lock<std::mutex> const& lk) const;
+  void RecordHandled(std::unique_lock<std::mutex> const& lk,
+                     std::string const& ack_id);
+
+  mutable std::mutex mu_;
+  std::chrono::steady_clock::time_point start_;
+  SubscriberMetricsSnapshot metrics_;
+  std::unordered_map<std::string, Outstanding> outstanding_;
+};
+
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_SUBSCRIBER_METRICS_H
@@ -0,0 +1,150 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/pubsub/subscriber_metrics.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace pubsub {
+inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
+namespace {
+
+using std::chrono::microseconds;
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram h;
+  EXPECT_EQ(0, h.count());
+  EXPECT_EQ(microseconds(0), h.mean());
+  EXPECT_EQ(microseconds(0), h.Percentile(50));
+  EXPECT_TRUE(h.buckets().empty());
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram h;
+  for (int i = 1; i <= 10; ++i) h.Record(microseconds(i));
+  EXPECT_EQ(10, h.count());
+  EXPECT_EQ(microseconds(1), h.min());
+  EXPECT_EQ(microseconds(10), h.max());
+  EXPECT_EQ(microseconds(5), h.mean());
+  EXPECT_EQ(microseconds(5), h.Percentile(50));
+  EXPECT_EQ(microseconds(10), h.Percentile(100));
+  EXPECT_EQ(10, h.buckets().size());
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram h;
+  for (int i = 0; i != 990; ++i) h.Record(microseconds(1000));
+  for (int i = 0; i != 10; ++i) h.Record(microseconds(100 * 1000));
+  EXPECT_LE(h.Percentile(50).count(), 1000 + 1000 / 8);
+  EXPECT_LE(h.Percentile(99).count(), 1000 + 1000 / 8);
+  EXPECT_GE(h.Percentile(99.9).count(), 100 * 1000);
+  EXPECT_EQ(microseconds(100 * 1000), h.Percentile(100));
+}
+
+TEST(SubscriberMetricsTest, MessageLifecycle) {
+  SubscriberMetrics metrics;
+  metrics.SetLimits(1000, 2000, 4);
+  metrics.RecordReceived("ack-1", 10);
+  metrics.RecordReceived("ack-2", 20);
+  metrics.RecordReceived("ack-3", 30);
+  metrics.RecordCallbackStart("ack-1");
+  metrics.RecordCallbackStart("ack-2");
+
+  auto s = metrics.Snapshot();
+  EXPECT_EQ(3, s.messages_received);
+  EXPECT_EQ(3, s.outstanding_messages);
+  EXPECT_EQ(60, s.outstanding_bytes);
+  EXPECT_EQ(2, s.running_callbacks);
+  EXPECT_EQ(2, s.queueing_delay.count());
+  EXPECT_EQ(0, s.processing_time.count());
+  EXPECT_EQ(1000, s.max_outstanding_messages);
+  EXPECT_EQ(2000, s.max_outstanding_bytes);
+  EXPECT_EQ(4, s.max_concurrency);
+
+  metrics.RecordAck("ack-1");
+  metrics.RecordNack("ack-2");
+  // A message nacked before its callback starts has no processing time.
+  metrics.RecordNack("ack-3");
+  metrics.RecordLeaseExtensions(5);
+  metrics.RecordDuplicates(2);
+
+  s = metrics.Snapshot();
+  EXPECT_EQ(1, s.acks);
+  EXPECT_EQ(2, s.nacks);
+  EXPECT_EQ(5, s.lease_extensions);
+  EXPECT_EQ(2, s.duplicates_suppressed);
+  EXPECT_EQ(0, s.outstanding_messages);
+  EXPECT_EQ(0, s.outstanding_bytes);
+  EXPECT_EQ(0, s.running_callbacks);
+  EXPECT_EQ(2, s.queueing_delay.count());
+  EXPECT_EQ(2, s.processing_time.count());
+}
+
+TEST(SubscriberMetricsTest, ProcessingTime) {
+  SubscriberMetrics metrics;
+  metrics.RecordReceived("ack-1", 0);
+  metrics.RecordCallbackStart("ack-1");
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  metrics.RecordAck("ack-1");
+  auto const s = metrics.Snapshot();
+  ASSERT_EQ(1, s.processing_time.count());
+  EXPECT_GE(s.processing_time.max(), std::chrono::milliseconds(5));
+  EXPECT_GE(s.interval, s.processing_time.max());
+}
+
+TEST(SubscriberMetricsTest, SnapshotAndReset) {
+  SubscriberMetrics metrics;
+  metrics.SetLimits(1000, 2000, 4);
+  metrics.RecordReceived("ack-1", 10);
+  metrics.RecordReceived("ack-2", 20);
+  metrics.RecordCallbackStart("ack-1");
+  metrics.RecordAck("ack-1");
+  metrics.RecordLeaseExtensions(1);
+
+  auto s = metrics.SnapshotAndReset();
+  EXPECT_EQ(2, s.messages_received);
+  EXPECT_EQ(1, s.acks);
+  EXPECT_EQ(1, s.outstanding_messages);
+
+  // The counters are reset, but the gauges and limits are not.
+  s = metrics.Snapshot();
+  EXPECT_EQ(0, s.messages_received);
+  EXPECT_EQ(0, s.acks);
+  EXPECT_EQ(0, s.lease_extensions);
+  EXPECT_EQ(0, s.queueing_delay.count());
+  EXPECT_EQ(1, s.outstanding_messages);
+  EXPECT_EQ(20, s.outstanding_bytes);
+  EXPECT_EQ(1000, s.max_outstanding_messages);
+  EXPECT_EQ(4, s.max_concurrency);
+}
+
+TEST(SubscriberMetricsSnapshotTest, Rates) {
+  SubscriberMetricsSnapshot s;
+  EXPECT_EQ(0, s.ack_rate());
+  s.interval = std::chrono::seconds(2);
+  s.acks = 100;
+  s.nacks = 10;
+  s.lease_extensions = 4;
+  EXPECT_DOUBLE_EQ(50.0, s.ack_rate());
+  EXPECT_DOUBLE_EQ(5.0, s.nack_rate());
+  EXPECT_DOUBLE_EQ(2.0, s.lease_extension_rate());
+}
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
+}  // namespace pubsub
+}  // namespace cloud
+}  // namespace google
@@ -37,6 +37,22 @@ SubscriberOptions& SubscriberOptions::set_max_concurrency(std::size_t v) {
   return *this;
 }
 
+SubscriberOptions& SubscriberOptions::set_max_callback_batch_size(
+    std::size_t v) {
+  max_callback_batch_size_ = v == 0 ? kDefaultMaxCallbackBatchSize : v;
+  return *this;
+}
+
+SubscriberOptions& SubscriberOptions::set_max_ack_batch_size(std::size_t v) {
+  max_ack_batch_size_ = v == 0 ? kDefaultMaxAckBatchSize : v;
+  return *this;
+}
+
+SubscriberOptions& SubscriberOptions::set_max_ack_batch_bytes(std::size_t v) {
+  max_ack_batch_bytes_ = v == 0 ? kDefaultMaxAckBatchBytes : v;
+  return *this;
+}
+
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub
 }  // namespace cloud
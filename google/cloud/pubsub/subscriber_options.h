@@ -15,8 +15,10 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_SUBSCRIBER_OPTIONS_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_PUBSUB_SUBSCRIBER_OPTIONS_H
 
+#include "google/cloud/pubsub/subscriber_metrics.h"
 #include "google/cloud/pubsub/version.h"
 #include <chrono>
+#include <memory>
 #include <thread>
 
 namespace google {
@@ -166,6 +168,92 @@ class SubscriberOptions {
   /// Maximum number of callbacks scheduled by the library at a time.
   std::size_t max_concurrency() const { return max_concurrency_; }
 
+  /**
+   * Set the number of concurrent streaming pulls for each subscription.
+   *
+   * A single streaming pull may limit the throughput of a subscription. With
+   * more than one stream the library spreads them across the gRPC channels
+   * (see `ConnectionOptions::set_num_channels()`), and delivers the messages
+   * from all of them to the same callback. The flow control limits, i.e.,
+   * `max_outstanding_messages()` and `max_outstanding_bytes()`, apply to the
+   * subscription and are divided across the streams.
+   *
+   * @param v the new value, 0 resets to the default (1)
+   */
+  SubscriberOptions& set_concurrent_streams(std::size_t v) {
+    concurrent_streams_ = v == 0 ? 1 : v;
+    return *this;
+  }
+  std::size_t concurrent_streams() const { return concurrent_streams_; }
+
+  /**
+   * Set the maximum number of messages in each `Subscriber::SubscribeBatch()`
+   * callback.
+   *
+   * Note that the number of outstanding messages, including any messages in
+   * batches, is also limited by `max_concurrency()`.
+   *
+   * @param v the new value, 0 resets to the default
+   */
+  SubscriberOptions& set_max_callback_batch_size(std::size_t v);
+  std::size_t max_callback_batch_size() const {
+    return max_callback_batch_size_;
+  }
+
+  /**
+   * Set the maximum time a message waits for a `Subscriber::SubscribeBatch()`
+   * batch to fill.
+   */
+  SubscriberOptions& set_max_callback_batch_latency(
+      std::chrono::milliseconds v) {
+    max_callback_batch_latency_ = v;
+    return *this;
+  }
+  std::chrono::milliseconds max_callback_batch_latency() const {
+    return max_callback_batch_latency_;
+  }
+
+  /**
+   * Set the maximum number of acknowledgements sent in a single request.
+   *
+   * The library coalesces the acknowledgements, rejections (nacks), and
+   * deadline extensions from the application into larger requests, reducing
+   * the number of RPCs (and their overhead) in high-throughput applications.
+   * A request is sent once this many of them are pending, once
+   * `max_ack_batch_bytes()` worth of acknowledgement ids are pending, or after
+   * `max_ack_hold_time()`, whichever happens first.
+   *
+   * @param v the new value, 0 resets to the default
+   */
+  SubscriberOptions& set_max_ack_batch_size(std::size_t v);
+  std::size_t max_ack_batch_size() const { return max_ack_batch_size_; }
+
+  /**
+   * Set the maximum size of the acknowledgement ids sent in a single request.
+   *
+   * Larger batches are split into multiple requests.
+   *
+   * @param v the new value, 0 resets to the default
+   */
+  SubscriberOptions& set_max_ack_batch_bytes(std::size_t v);
+  std::size_t max_ack_batch_bytes() const { return max_ack_batch_bytes_; }
+
+  /**
+   * Set the maximum time an acknowledgement is held waiting for a batch.
+   *
+   * Smaller values reduce the latency for acknowledgements, at the cost of
+   * more (and smaller) requests. The minimum acknowledgement deadline is 10
+   * seconds, the default value (100ms) is small enough to make little
+   * difference for most applications.
+   */
+  SubscriberOptions& set_max_ack_hold_time(std::chrono::milliseconds v) {
+    max_ack_hold_time_ = v;
+    return *this;
+  }
+  std::chrono::milliseconds max_ack_hold_time() const {
+    return max_ack_hold_time_;
+  }
+
   /**
    * Control how often the session polls for automatic shutdowns.
    *
@@ -183,6 +271,73 @@ class SubscriberOptions {
     return shutdown_polling_period_;
   }
 
+  /**
+   * Bound the time to shutdown a session.
+   *
+   * When the application shuts down a session, any messages not yet
+   * acknowledged, including messages held by running callbacks, are nacked,
+   * and the queued acknowledgements are flushed. By default the session then
+   * waits until all the callbacks return and the stream closes. If this value
+   * is not zero, the session completes its shutdown after (at most) this
+   * time, even if some callbacks are still running. Acknowledgements from
+   * such callbacks are best-effort, the messages may be redelivered.
+   *
+   * Applications that must release their resources quickly, for example,
+   * during a rolling restart, can set this to a few milliseconds.
+   */
+  SubscriberOptions& set_max_shutdown_time(std::chrono::milliseconds v) {
+    max_shutdown_time_ = v;
+    return *this;
+  }
+  std::chrono::milliseconds max_shutdown_time() const {
+    return max_shutdown_time_;
+  }
+
+  /**
+   * Suppress redeliveries of outstanding or recently acknowledged messages.
+   *
+   * Cloud Pub/Sub delivers messages at least once. If this value is not zero,
+   * the session remembers the `message_id` of each message:
+   * - redeliveries of a message whose callback has not acked or nacked it yet
+   *   are acked (or nacked) together with the original message,
+   * - redeliveries of a message acked less than @p v ago are acked
+   *   immediately,
+   * and in both cases the callback does not run again. Messages that are
+   * nacked are forgotten, and their redeliveries do run the callback.
+   *
+   * Deduplication is disabled by default. Note that it is best-effort, it
+   * only detects duplicates received by the same session.
+   */
+  SubscriberOptions& set_deduplication_window(std::chrono::milliseconds v) {
+    deduplication_window_ = v;
+    return *this;
+  }
+  std::chrono::milliseconds deduplication_window() const {
+    return deduplication_window_;
+  }
+
+  /// Limit the number of acknowledged messages remembered for deduplication.
+  SubscriberOptions& set_max_deduplication_entries(std::size_t v) {
+    max_deduplication_entries_ = v;
+    return *this;
+  }
+  std::size_t max_deduplication_entries() const {
+    return max_deduplication_entries_;
+  }
+
+  /**
+   * Record queueing, processing time, and flow control metrics.
+   *
+   * If set, the sessions for this subscription record their metrics in this
+   * object, see `SubscriberMetrics` for details. This is disabled by default
+   * (`nullptr`).
+   */
+  SubscriberOptions& set_metrics(std::shared_ptr<SubscriberMetrics> v) {
+    metrics_ = std::move(v);
+    return *this;
+  }
+  std::shared_ptr<SubscriberMetrics> const& metrics() const { return metrics_; }
+
  private:
   static std::size_t DefaultMaxConcurrency() {
     auto constexpr kDefaultMaxConcurrency = 4;
@@ -190,11 +345,28 @@ class SubscriberOptions {
     return n == 0 ? kDefaultMaxConcurrency : n;
   }
 
+  static auto constexpr kDefaultMaxCallbackBatchSize = 100;
+  static auto constexpr kDefaultMaxAckBatchSize = 1000;
+  static auto constexpr kDefaultMaxAckBatchBytes = 512 * 1024;
+  static auto constexpr kDefaultMaxDeduplicationEntries = 100 * 1000;
+
   std::chrono::seconds max_deadline_time_ = std::chrono::seconds(0);
   std::int64_t max_outstanding_messages_ = 1000;
   std::int64_t max_outstanding_bytes_ = 100 * 1024 * 1024L;
   std::size_t max_concurrency_ = DefaultMaxConcurrency();
+  std::size_t concurrent_streams_ = 1;
+  std::size_t max_callback_batch_size_ = kDefaultMaxCallbackBatchSize;
+  std::chrono::milliseconds max_callback_batch_latency_ =
+      std::chrono::milliseconds(100);
+  std::size_t max_ack_batch_size_ = kDefaultMaxAckBatchSize;
+  std::size_t max_ack_batch_bytes_ = kDefaultMaxAckBatchBytes;
+  std::chrono::milliseconds max_ack_hold_time_ = std::chrono::milliseconds(100);
   std::chrono::milliseconds shutdown_polling_period_ = std::chrono::seconds(5);
+  std::chrono::milliseconds max_shutdown_time_ = std::chrono::milliseconds(0);
+  std::chrono::milliseconds deduplication_window_ =
+      std::chrono::milliseconds(0);
+  std::size_t max_deduplication_entries_ = kDefaultMaxDeduplicationEntries;
+  std::shared_ptr<SubscriberMetrics> metrics_;
 };
 
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
@@ -53,6 +53,74 @@ TEST(SubscriberOptionsTest, SetConcurrency) {
   EXPECT_EQ(SubscriberOptions{}.max_concurrency(), options.max_concurrency());
 }
 
+TEST(SubscriberOptionsTest, SetConcurrentStreams) {
+  EXPECT_EQ(1, SubscriberOptions{}.concurrent_streams());
+  auto options = SubscriberOptions{}.set_concurrent_streams(4);
+  EXPECT_EQ(4, options.concurrent_streams());
+
+  // 0 resets to default
+  options.set_concurrent_streams(0);
+  EXPECT_EQ(1, options.concurrent_streams());
+}
+
+TEST(SubscriberOptionsTest, CallbackBatching) {
+  auto const defaults = SubscriberOptions{};
+  EXPECT_LT(0, defaults.max_callback_batch_size());
+  EXPECT_LT(std::chrono::milliseconds(0),
+            defaults.max_callback_batch_latency());
+
+  auto options = SubscriberOptions{}
+                     .set_max_callback_batch_size(16)
+                     .set_max_callback_batch_latency(
+                         std::chrono::milliseconds(5));
+  EXPECT_EQ(16, options.max_callback_batch_size());
+  EXPECT_EQ(std::chrono::milliseconds(5), options.max_callback_batch_latency());
+
+  // 0 resets to default
+  options.set_max_callback_batch_size(0);
+  EXPECT_EQ(defaults.max_callback_batch_size(),
+            options.max_callback_batch_size());
+}
+
+TEST(SubscriberOptionsTest, AckBatching) {
+  auto const defaults = SubscriberOptions{};
+  EXPECT_LT(0, defaults.max_ack_batch_size());
+  EXPECT_LT(0, defaults.max_ack_batch_bytes());
+  EXPECT_LT(std::chrono::milliseconds(0), defaults.max_ack_hold_time());
+
+  auto options = SubscriberOptions{}
+                     .set_max_ack_batch_size(16)
+                     .set_max_ack_batch_bytes(1024)
+                     .set_max_ack_hold_time(std::chrono::milliseconds(5));
+  EXPECT_EQ(16, options.max_ack_batch_size());
+  EXPECT_EQ(1024, options.max_ack_batch_bytes());
+  EXPECT_EQ(std::chrono::milliseconds(5), options.max_ack_hold_time());
+
+  // 0 resets to default
+  options.set_max_ack_batch_size(0).set_max_ack_batch_bytes(0);
+  EXPECT_EQ(defaults.max_ack_batch_size(), options.max_ack_batch_size());
+  EXPECT_EQ(defaults.max_ack_batch_bytes(), options.max_ack_batch_bytes());
+}
+
+TEST(SubscriberOptionsTest, MaxShutdownTime) {
+  EXPECT_EQ(std::chrono::milliseconds(0),
+            SubscriberOptions{}.max_shutdown_time());
+  auto options = SubscriberOptions{}.set_max_shutdown_time(
+      std::chrono::milliseconds(50));
+  EXPECT_EQ(std::chrono::milliseconds(50), options.max_shutdown_time());
+}
+
+TEST(SubscriberOptionsTest, Deduplication) {
+  auto const defaults = SubscriberOptions{};
+  EXPECT_EQ(std::chrono::milliseconds(0), defaults.deduplication_window());
+  EXPECT_LT(0, defaults.max_deduplication_entries());
+  auto options = SubscriberOptions{}
+                     .set_deduplication_window(std::chrono::minutes(10))
+                     .set_max_deduplication_entries(1000);
+  EXPECT_EQ(std::chrono::minutes(10), options.deduplication_window());
+  EXPECT_EQ(1000, options.max_deduplication_entries());
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub
@@ -26,6 +26,7 @@ inline namespace GOOGLE_CLOUD_CPP_PUBSUB_NS {
 namespace {
 
 using ::testing::_;
+using ::testing::ElementsAre;
 
 /// @test Verify Subscriber::Subscribe() works, including mocks.
 TEST(SubscriberTest, SubscribeSimple) {
@@ -78,6 +79,71 @@ TEST(SubscriberTest, SubscribeWithOptions) {
   ASSERT_STATUS_OK(status);
 }
 
+/// @test Verify Subscriber::SubscribeBatch() works, including mocks.
+TEST(SubscriberTest, SubscribeBatch) {
+  auto mock = std::make_shared<pubsub_mocks::MockSubscriberConnection>();
+  EXPECT_CALL(*mock, Subscribe(_))
+      .WillOnce([&](SubscriberConnection::SubscribeParams const& p) {
+        EXPECT_FALSE(p.callback);
+        EXPECT_TRUE(p.batch_callback);
+        std::vector<Message> messages;
+        messages.push_back(MessageBuilder{}.SetData("d0").Build());
+        messages.push_back(MessageBuilder{}.SetData("d1").Build());
+        std::vector<AckHandler> handlers;
+        for (int i = 0; i != 2; ++i) {
+          auto h = absl::make_unique<pubsub_mocks::MockAckHandler>();
+          EXPECT_CALL(*h, ack()).Times(1);
+          handlers.emplace_back(std::move(h));
+        }
+        p.batch_callback(std::move(messages),
+                         BatchAckHandler(std::move(handlers)));
+        return make_ready_future(Status{});
+      });
+
+  Subscriber subscriber(mock);
+  std::vector<std::string> received;
+  auto status = subscriber
+                    .SubscribeBatch([&](std::vector<Message> const& messages,
+                                        BatchAckHandler h) {
+                      for (auto const& m : messages) {
+                        received.push_back(m.data());
+                      }
+                      std::move(h).ack();
+                    })
+                    .get();
+  ASSERT_STATUS_OK(status);
+  EXPECT_THAT(received, ElementsAre("d0", "d1"));
+}
+
+/// @test Verify Subscriber::Pull() and Subscriber::Acknowledge() work.
+TEST(SubscriberTest, PullAndAcknowledge) {
+  auto mock = std::make_shared<pubsub_mocks::MockSubscriberConnection>();
+  EXPECT_CALL(*mock, Pull(_))
+      .WillOnce([](SubscriberConnection::PullParams const& p) {
+        EXPECT_EQ(10, p.max_messages);
+        return std::vector<PulledMessage>{
+            {MessageBuilder{}.SetData("d0").Build(), "a0"},
+            {MessageBuilder{}.SetData("d1").Build(), "a1"}};
+      });
+  EXPECT_CALL(*mock, Acknowledge(_))
+      .WillOnce([](SubscriberConnection::AcknowledgeParams const& p) {
+        EXPECT_THAT(p.ack_ids, ElementsAre("a0", "a1"));
+        return Status{};
+      });
+
+  Subscriber subscriber(mock);
+  auto messages = subscriber.Pull(10);
+  ASSERT_STATUS_OK(messages);
+  std::vector<std::string> received;
+  std::vector<std::string> ack_ids;
+  for (auto const& m : *messages) {
+    received.push_back(m.message.data());
+    ack_ids.push_back(m.ack_id);
+  }
+  EXPECT_THAT(received, ElementsAre("d0", "d1"));
+  ASSERT_STATUS_OK(subscriber.Acknowledge(std::move(ack_ids)));
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_PUBSUB_NS
 }  // namespace pubsub
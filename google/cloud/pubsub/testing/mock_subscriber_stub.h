@@ -68,6 +68,15 @@ class MockSubscriberStub : public pubsub_internal::SubscriberStub {
                google::pubsub::v1::StreamingPullRequest const&),
               (override));
 
+  MOCK_METHOD(StatusOr<google::pubsub::v1::PullResponse>, Pull,
+              (grpc::ClientContext&, google::pubsub::v1::PullRequest const&),
+              (override));
+
+  MOCK_METHOD(Status, Acknowledge,
+              (grpc::ClientContext&,
+               google::pubsub::v1::AcknowledgeRequest const&),
+              (override));
+
   MOCK_METHOD(StatusOr<google::pubsub::v1::Snapshot>, CreateSnapshot,
               (grpc::ClientContext&,
                google::pubsub::v1::CreateSnapshotRequest const&),
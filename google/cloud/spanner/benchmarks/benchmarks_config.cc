@@ -38,6 +38,7 @@ std::ostream& operator<<(std::ostream& os, Config const& config) {
             << "s"
             << "\n# Table Size: " << config.table_size
             << "\n# Query Size: " << config.query_size
+            << "\n# Session Pool Shards: " << config.session_pool_shards
             << "\n# Use Only Stubs: " << config.use_only_stubs
             << "\n# Use Only Clients: " << config.use_only_clients
             << "\n# Compiler: " << google::cloud::internal::CompilerId() << "-"
@@ -114,6 +115,10 @@ google::cloud::StatusOr<Config> ParseArgs(std::vector<std::string> args) {
        [](Config& c, std::string const& v) { c.table_size = std::stoi(v); }},
       {"--query-size=",
        [](Config& c, std::string const& v) { c.query_size = std::stoi(v); }},
+      {"--session-pool-shards=",
+       [](Config& c, std::string const& v) {
+         c.session_pool_shards = std::stoi(v);
+       }},
 
       {"--use-only-stubs",
        [](Config& c, std::string const&) { c.use_only_stubs = true; }},
@@ -192,6 +197,13 @@ google::cloud::StatusOr<Config> ParseArgs(std::vector<std::string> args) {
     return invalid_argument(os.str());
   }
 
+  if (config.session_pool_shards <= 0) {
+    std::ostringstream os;
+    os << "The number of session pool shards (" << config.session_pool_shards
+       << ") should be > 0";
+    return invalid_argument(os.str());
+  }
+
   if (config.use_only_stubs && config.use_only_clients) {
     std::ostringstream os;
     os << "Only one of --use-only-stubs or --use-only-clients can be set";
@@ -45,6 +45,8 @@ struct Config {
   std::int32_t table_size = 1000 * 1000L;
   std::int32_t query_size = 1000;
 
+  int session_pool_shards = 1;
+
   bool use_only_clients = false;
   bool use_only_stubs = false;
 };
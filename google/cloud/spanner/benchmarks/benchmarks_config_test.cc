@@ -30,7 +30,8 @@ TEST(BenchmarkConfigTest, ParseAll) {
       {"placeholder", "--experiment=test-experiment", "--project=test-project",
        "--instance=test-instance", "--samples=50", "--iteration-duration=10",
        "--minimum-threads=1", "--maximum-threads=1", "--minimum-clients=2",
-       "--maximum-clients=8", "--table-size=1000", "--query-size=10"});
+       "--maximum-clients=8", "--table-size=1000", "--query-size=10",
+       "--session-pool-shards=16"});
   ASSERT_STATUS_OK(config);
 
   EXPECT_EQ("test-experiment", config->experiment);
@@ -44,6 +45,7 @@ TEST(BenchmarkConfigTest, ParseAll) {
   EXPECT_EQ(8, config->maximum_clients);
   EXPECT_EQ(1000, config->table_size);
   EXPECT_EQ(10, config->query_size);
+  EXPECT_EQ(16, config->session_pool_shards);
 }
 
 TEST(BenchmarkConfigTest, ParseNone) {
@@ -112,6 +114,12 @@ TEST(BenchmarkConfigTest, InvalidTableSize) {
   EXPECT_THAT(config, StatusIs(StatusCode::kInvalidArgument));
 }
 
+TEST(BenchmarkConfigTest, InvalidSessionPoolShards) {
+  auto config = ParseArgs(
+      {"placeholder", "--project=test-project", "--session-pool-shards=0"});
+  EXPECT_THAT(config, StatusIs(StatusCode::kInvalidArgument));
+}
+
 TEST(BenchmarkConfigTest, OnlyStubsAndOnlyClients) {
   auto config = ParseArgs({"placeholder", "--project=test-project",
                            "--use-only-stubs", "--use-only-clients"});
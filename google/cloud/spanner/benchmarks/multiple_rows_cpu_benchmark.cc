@@ -760,7 +760,7 @@ class ReadExperiment : public Experiment {
       auto rows = client.Read(table_name_, key, column_names);
       int row_count = 0;
       Status status;
-      for (auto& row : spanner::StreamOf<RowType>(rows)) {
+      for (auto& row : spanner::DecodeStreamOf<RowType>(rows)) {
         if (!row) {
           status = std::move(row).status();
           break;
@@ -984,7 +984,7 @@ class SelectExperiment : public Experiment {
                       {"end", spanner::Value(key + config.query_size)}}));
       int row_count = 0;
       Status status;
-      for (auto& row : spanner::StreamOf<RowType>(rows)) {
+      for (auto& row : spanner::DecodeStreamOf<RowType>(rows)) {
         if (!row) {
           status = std::move(row).status();
           break;
@@ -244,7 +244,9 @@ spanner::Client MakeClient(Config const& config, int num_channels,
   auto connection = spanner::MakeConnection(
       database, spanner::ConnectionOptions().set_num_channels(num_channels),
       // This pre-creates all the Sessions we will need (one per thread).
-      spanner::SessionPoolOptions().set_min_sessions(config.maximum_threads));
+      spanner::SessionPoolOptions()
+          .set_min_sessions(config.maximum_threads)
+          .set_idle_session_shards(config.session_pool_shards));
   return spanner::Client(std::move(connection));
 }
 
@@ -0,0 +1,619 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/benchmarks/benchmarks_config.h"
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/database_admin_client.h"
+#include "google/cloud/spanner/testing/pick_random_instance.h"
+#include "google/cloud/spanner/testing/random_database_name.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/timer.h"
+#include <algorithm>
+#include <array>
+#include <future>
+#include <map>
+#include <random>
+#include <thread>
+
+namespace {
+
+namespace spanner = ::google::cloud::spanner;
+using ::google::cloud::spanner_benchmarks::Config;
+using ::google::cloud::testing_util::Timer;
+
+/// The operations in a transaction mix.
+enum Operation {
+  kPointRead,
+  kScan,
+  kReadWrite,
+  kDml,
+  kOperationCount,
+};
+
+char const* OperationName(int op) {
+  switch (op) {
+    case kPointRead:
+      return "PointRead";
+    case kScan:
+      return "Scan";
+    case kReadWrite:
+      return "ReadWrite";
+    case kDml:
+      return "Dml";
+    default:
+      break;
+  }
+  return "Unknown";
+}
+
+/**
+ * Describes a workload.
+ *
+ * Each operation is chosen with probability proportional to its weight. Keys
+ * are chosen uniformly from the table, except that a `hot_fraction` of the
+ * operations use one of `hot_keys` keys, creating contention between the
+ * read-write transactions and the DML statements.
+ */
+struct Mix {
+  std::array<int, kOperationCount> weights;
+  double hot_fraction;
+  std::int64_t hot_keys;
+};
+
+/// The results for one operation type in one worker thread.
+struct OperationStats {
+  int count = 0;
+  int errors = 0;
+  int aborts = 0;
+  std::vector<std::chrono::microseconds> latencies;
+};
+
+struct TaskResult {
+  std::array<OperationStats, kOperationCount> stats;
+  std::chrono::microseconds cpu_time;
+  std::vector<google::cloud::Status> errors;
+};
+
+struct TransactionMixSample {
+  int client_count;
+  int thread_count;
+  int operation;
+  OperationStats stats;
+  std::chrono::microseconds elapsed;
+  std::chrono::microseconds cpu_time;
+};
+
+using SampleSink = std::function<void(std::vector<TransactionMixSample>)>;
+
+class Experiment {
+ public:
+  virtual ~Experiment() = default;
+
+  virtual void SetUp(Config const& config,
+                     spanner::Database const& database) = 0;
+  virtual void Run(Config const& config, spanner::Database const& database,
+                   SampleSink const& sink) = 0;
+};
+
+std::map<std::string, std::shared_ptr<Experiment>> AvailableExperiments();
+
+std::chrono::microseconds Percentile(
+    std::vector<std::chrono::microseconds> const& sorted, int p) {
+  if (sorted.empty()) return std::chrono::microseconds(0);
+  auto index = (sorted.size() - 1) * p / 100;
+  return sorted[index];
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // Set any "sticky" I/O format flags before we fork threads.
+  std::cout.setf(std::ios::boolalpha);
+
+  Config config;
+  {
+    std::vector<std::string> args{argv, argv + argc};
+    auto c = google::cloud::spanner_benchmarks::ParseArgs(args);
+    if (!c) {
+      std::cerr << "Error parsing command-line arguments: " << c.status()
+                << "\n";
+      return 1;
+    }
+    config = *std::move(c);
+  }
+
+  if (!Timer::SupportPerThreadUsage()) {
+    std::cerr << "# Your platform does not support per-thread getrusage()"
+              << " data, the CpuTime column includes all the threads.\n";
+  }
+
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  if (config.instance_id.empty()) {
+    auto instance = google::cloud::spanner_testing::PickRandomInstance(
+        generator, config.project_id);
+    if (!instance) {
+      std::cerr << "Error selecting an instance to run the experiment: "
+                << instance.status() << "\n";
+      return 1;
+    }
+    config.instance_id = *std::move(instance);
+  }
+
+  // If the user specified a database name on the command line, re-use it to
+  // reduce setup time when running the benchmark repeatedly. It's assumed that
+  // other flags related to database creation have not been changed across runs.
+  bool user_specified_database = !config.database_id.empty();
+  if (!user_specified_database) {
+    config.database_id =
+        google::cloud::spanner_testing::RandomDatabaseName(generator);
+  }
+  google::cloud::spanner::Database database(
+      config.project_id, config.instance_id, config.database_id);
+  auto available = AvailableExperiments();
+  auto e = available.find(config.experiment);
+  if (e == available.end()) {
+    std::cerr << "Experiment " << config.experiment << " not found\n";
+    return 1;
+  }
+
+  google::cloud::spanner::DatabaseAdminClient admin_client;
+
+  std::cout << "# Waiting for database creation to complete " << std::flush;
+  google::cloud::StatusOr<google::spanner::admin::database::v1::Database> db;
+  int constexpr kMaxCreateDatabaseRetries = 3;
+  for (int retry = 0; retry <= kMaxCreateDatabaseRetries; ++retry) {
+    auto create_future =
+        admin_client.CreateDatabase(database, {R"sql(CREATE TABLE KeyValue (
+                                Key   INT64 NOT NULL,
+                                Data  STRING(1024),
+                             ) PRIMARY KEY (Key))sql"});
+    for (;;) {
+      auto status = create_future.wait_for(std::chrono::seconds(1));
+      if (status == std::future_status::ready) break;
+      std::cout << '.' << std::flush;
+    }
+    db = create_future.get();
+    if (db) break;
+    if (db.status().code() != google::cloud::StatusCode::kUnavailable) break;
+    std::this_thread::sleep_for(retry * std::chrono::seconds(3));
+  }
+  std::cout << " DONE\n";
+
+  bool database_created = true;
+  if (!db) {
+    if (user_specified_database &&
+        db.status().code() == google::cloud::StatusCode::kAlreadyExists) {
+      std::cout << "# Re-using existing database\n";
+      database_created = false;
+    } else {
+      std::cerr << "Error creating database: " << db.status() << "\n";
+      return 1;
+    }
+  }
+
+  std::cout << "ChannelCount,ThreadCount,Operation,Count,Errors,Aborts"
+            << ",AbortRate,P50,P90,P99,Max,ElapsedTime,CpuTime\n"
+            << std::flush;
+
+  std::mutex cout_mu;
+  auto cout_sink =
+      [&cout_mu](std::vector<TransactionMixSample> const& samples) mutable {
+        std::unique_lock<std::mutex> lk(cout_mu);
+        for (auto const& s : samples) {
+          auto sorted = s.stats.latencies;
+          std::sort(sorted.begin(), sorted.end());
+          auto const abort_rate =
+              s.stats.count == 0
+                  ? 0.0
+                  : static_cast<double>(s.stats.aborts) / s.stats.count;
+          std::cout << s.client_count << ',' << s.thread_count << ','
+                    << OperationName(s.operation) << ',' << s.stats.count
+                    << ',' << s.stats.errors << ',' << s.stats.aborts << ','
+                    << abort_rate << ',' << Percentile(sorted, 50).count()
+                    << ',' << Percentile(sorted, 90).count() << ','
+                    << Percentile(sorted, 99).count() << ','
+                    << Percentile(sorted, 100).count() << ','
+                    << s.elapsed.count() << ',' << s.cpu_time.count() << '\n'
+                    << std::flush;
+        }
+      };
+
+  auto experiment = e->second;
+  if (database_created) {
+    experiment->SetUp(config, database);
+  }
+  experiment->Run(config, database, cout_sink);
+
+  if (!user_specified_database) {
+    auto drop = admin_client.DropDatabase(database);
+    if (!drop.ok()) {
+      std::cerr << "# Error dropping database: " << drop << "\n";
+    }
+  }
+  std::cout << "# Experiment finished, "
+            << (user_specified_database ? "user-specified database kept\n"
+                                        : "database dropped\n");
+  return 0;
+}
+
+namespace {
+
+using ErrorSink = std::function<void(std::vector<google::cloud::Status>)>;
+
+/// Picks the operation and key for each step of a worker thread.
+class WorkloadGenerator {
+ public:
+  WorkloadGenerator(Config const& config, Mix const& mix)
+      : generator_(std::random_device{}()),
+        operation_(mix.weights.begin(), mix.weights.end()),
+        hot_(mix.hot_fraction),
+        hot_key_(0, (std::min)(mix.hot_keys,
+                                 std::int64_t{config.table_size} - 1)),
+        key_(0, config.table_size - 1) {}
+
+  int NextOperation() { return operation_(generator_); }
+  std::int64_t NextKey() {
+    return hot_(generator_) ? hot_key_(generator_) : key_(generator_);
+  }
+
+ private:
+  google::cloud::internal::DefaultPRNG generator_;
+  std::discrete_distribution<int> operation_;
+  std::bernoulli_distribution hot_;
+  std::uniform_int_distribution<std::int64_t> hot_key_;
+  std::uniform_int_distribution<std::int64_t> key_;
+};
+
+void FillTableTask(Config const& config, spanner::Client client, std::mutex& mu,
+                   std::string const& value, int task_count, int task_id) {
+  auto mutation =
+      spanner::InsertOrUpdateMutationBuilder("KeyValue", {"Key", "Data"});
+  int current_mutations = 0;
+
+  auto maybe_flush = [&mutation, &current_mutations, &client, &mu](bool force) {
+    if (current_mutations == 0) {
+      return;
+    }
+    if (!force && current_mutations < 1000) {
+      return;
+    }
+    auto result =
+        client.Commit(spanner::Mutations{std::move(mutation).Build()});
+    if (!result) {
+      std::lock_guard<std::mutex> lk(mu);
+      std::cerr << "# Error in Commit() " << result.status() << "\n";
+    }
+    mutation =
+        spanner::InsertOrUpdateMutationBuilder("KeyValue", {"Key", "Data"});
+    current_mutations = 0;
+  };
+  auto force_flush = [&maybe_flush] { maybe_flush(true); };
+  auto flush_as_needed = [&maybe_flush] { maybe_flush(false); };
+
+  auto const report_period =
+      (std::max)(static_cast<std::int32_t>(2), config.table_size / 50);
+  for (std::int64_t key = 0; key != config.table_size; ++key) {
+    // Each thread does a fraction of the key space.
+    if (key % task_count != task_id) continue;
+    // Have one of the threads report progress about 50 times.
+    if (task_id == 0 && key % report_period == 0) {
+      std::cout << '.' << std::flush;
+    }
+    mutation.EmplaceRow(key, value);
+    current_mutations++;
+    flush_as_needed();
+  }
+  force_flush();
+}
+
+void FillTable(Config const& config, spanner::Database const& database,
+               std::mutex& mu, std::string const& value) {
+  // We need to populate some data or all the requests to read will fail.
+  spanner::Client client(spanner::MakeConnection(database));
+  std::cout << "# Populating database " << std::flush;
+  int const task_count = 16;
+  std::vector<std::future<void>> tasks(task_count);
+  int task_id = 0;
+  for (auto& t : tasks) {
+    t = std::async(
+        std::launch::async,
+        [&config, &client, &mu, &value](int tc, int ti) {
+          FillTableTask(config, client, mu, value, tc, ti);
+        },
+        task_count, task_id++);
+  }
+  for (auto& t : tasks) {
+    t.get();
+  }
+  std::cout << " DONE\n";
+}
+
+spanner::Client MakeClient(Config const& config, int num_channels,
+                           spanner::Database const& database) {
+  std::cout << "# Creating 1 client using shared connection with "
+            << num_channels << " channels\n"
+            << std::flush;
+
+  auto connection = spanner::MakeConnection(
+      database, spanner::ConnectionOptions().set_num_channels(num_channels),
+      // This pre-creates all the Sessions we will need (one per thread).
+      spanner::SessionPoolOptions()
+          .set_min_sessions(config.maximum_threads)
+          .set_idle_session_shards(config.session_pool_shards));
+  return spanner::Client(std::move(connection));
+}
+
+class TransactionMixExperiment : public Experiment {
+ public:
+  explicit TransactionMixExperiment(Mix mix)
+      : mix_(std::move(mix)), generator_(std::random_device{}()) {}
+
+  void SetUp(Config const& config, spanner::Database const& database) override {
+    std::string value = [this] {
+      std::lock_guard<std::mutex> lk(mu_);
+      return google::cloud::internal::Sample(
+          generator_, 1024, "#@$%^&*()-=+_0123456789[]{}|;:,./<>?");
+    }();
+    FillTable(config, database, mu_, value);
+  }
+
+  void Run(Config const& config, spanner::Database const& database,
+           SampleSink const& sink) override {
+    std::cout << config << std::flush;
+
+    std::uniform_int_distribution<int> thread_count_gen(config.minimum_threads,
+                                                        config.maximum_threads);
+
+    std::uniform_int_distribution<int> channel_count_gen(
+        config.minimum_clients, config.maximum_clients);
+    // Capture some overall getrusage() statistics as comments.
+    Timer overall;
+    overall.Start();
+    for (int i = 0; i != config.samples; ++i) {
+      auto const thread_count = thread_count_gen(generator_);
+      auto const channel_count = channel_count_gen(generator_);
+      RunIteration(config, MakeClient(config, channel_count, database),
+                   channel_count, thread_count, sink);
+    }
+    overall.Stop();
+    std::cout << overall.annotations();
+  }
+
+  void RunIteration(Config const& config, spanner::Client const& client,
+                    int channel_count, int thread_count,
+                    SampleSink const& sink) {
+    std::mutex cerr_mu;
+    ErrorSink error_sink =
+        [&cerr_mu](std::vector<google::cloud::Status> const& errors) {
+          std::lock_guard<std::mutex> lk(cerr_mu);
+          for (auto const& e : errors) {
+            std::cerr << "# " << e << "\n";
+          }
+        };
+
+    std::vector<std::future<TaskResult>> tasks(thread_count);
+    auto start = std::chrono::steady_clock::now();
+    for (auto& t : tasks) {
+      t = std::async(std::launch::async, &TransactionMixExperiment::RunTask,
+                     config, client, mix_);
+    }
+    std::vector<TransactionMixSample> samples(kOperationCount);
+    std::chrono::microseconds cpu_time(0);
+    for (auto& t : tasks) {
+      auto result = t.get();
+      cpu_time += result.cpu_time;
+      error_sink(std::move(result.errors));
+      for (int op = 0; op != kOperationCount; ++op) {
+        auto& s = samples[op].stats;
+        auto& r = result.stats[op];
+        s.count += r.count;
+        s.errors += r.errors;
+        s.aborts += r.aborts;
+        s.latencies.insert(s.latencies.end(), r.latencies.begin(),
+                           r.latencies.end());
+      }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    for (int op = 0; op != kOperationCount; ++op) {
+      auto& s = samples[op];
+      s.client_count = channel_count;
+      s.thread_count = thread_count;
+      s.operation = op;
+      s.elapsed = elapsed;
+      s.cpu_time = cpu_time;
+    }
+    sink(std::move(samples));
+  }
+
+  static TaskResult RunTask(Config const& config, spanner::Client client,
+                            Mix const& mix) {
+    WorkloadGenerator workload(config, mix);
+    TaskResult result;
+    std::string value(1024, 'A');
+    Timer timer;
+    timer.Start();
+    for (auto start = std::chrono::steady_clock::now(),
+              deadline = start + config.iteration_duration;
+         start < deadline; start = std::chrono::steady_clock::now()) {
+      auto const op = workload.NextOperation();
+      auto const key = workload.NextKey();
+      int attempts = 0;
+      google::cloud::Status status;
+      switch (op) {
+        case kPointRead:
+          status = PointRead(client, key);
+          break;
+        case kScan:
+          status = Scan(config, client, key);
+          break;
+        case kReadWrite:
+          status = ReadWrite(client, key, value, attempts);
+          break;
+        case kDml:
+          status = Dml(client, key, value, attempts);
+          break;
+        default:
+          continue;
+      }
+      auto& stats = result.stats[op];
+      stats.latencies.push_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - start));
+      ++stats.count;
+      // The commit loop calls the mutator once per attempt, each additional
+      // attempt means the previous one was aborted.
+      if (attempts > 1) stats.aborts += attempts - 1;
+      if (!status.ok()) {
+        ++stats.errors;
+        if (status.code() == google::cloud::StatusCode::kAborted) {
+          ++stats.aborts;
+        }
+        result.errors.push_back(std::move(status));
+      }
+    }
+    timer.Stop();
+    result.cpu_time = timer.cpu_time();
+    return result;
+  }
+
+ private:
+  static google::cloud::Status PointRead(spanner::Client client,
+                                         std::int64_t key) {
+    auto rows = client.Read("KeyValue",
+                            spanner::KeySet().AddKey(spanner::MakeKey(key)),
+                            {"Key", "Data"});
+    for (auto& row :
+         spanner::StreamOf<std::tuple<std::int64_t, std::string>>(rows)) {
+      if (!row) return std::move(row).status();
+    }
+    return {};
+  }
+
+  static google::cloud::Status Scan(Config const& config,
+                                    spanner::Client client, std::int64_t key) {
+    auto rows = client.ExecuteQuery(spanner::SqlStatement(
+        "SELECT Key, Data FROM KeyValue"
+        " WHERE Key >= @begin AND Key < @end",
+        {{"begin", spanner::Value(key)},
+         {"end", spanner::Value(key + config.query_size)}}));
+    for (auto& row :
+         spanner::StreamOf<std::tuple<std::int64_t, std::string>>(rows)) {
+      if (!row) return std::move(row).status();
+    }
+    return {};
+  }
+
+  static google::cloud::Status ReadWrite(spanner::Client client,
+                                         std::int64_t key,
+                                         std::string const& value,
+                                         int& attempts) {
+    auto commit = client.Commit(
+        [&client, key, &value, &attempts](spanner::Transaction const& txn)
+            -> google::cloud::StatusOr<spanner::Mutations> {
+          ++attempts;
+          auto rows = client.Read(
+              txn, "KeyValue", spanner::KeySet().AddKey(spanner::MakeKey(key)),
+              {"Data"});
+          std::string data;
+          for (auto& row : spanner::StreamOf<std::tuple<std::string>>(rows)) {
+            if (!row) return std::move(row).status();
+            data = std::get<0>(*std::move(row));
+          }
+          // Modify the value so the write depends on the read.
+          data = data.empty() ? value : data.substr(1) + data.front();
+          return spanner::Mutations{spanner::MakeUpdateMutation(
+              "KeyValue", {"Key", "Data"}, key, std::move(data))};
+        });
+    return std::move(commit).status();
+  }
+
+  static google::cloud::Status Dml(spanner::Client client, std::int64_t key,
+                                   std::string const& value, int& attempts) {
+    auto commit =
+        client.Commit([&client, key, &value, &attempts](
+                          spanner::Transaction const& txn)
+                          -> google::cloud::StatusOr<spanner::Mutations> {
+          ++attempts;
+          auto result = client.ExecuteDml(
+              txn, spanner::SqlStatement(
+                       "UPDATE KeyValue SET Data = @data WHERE Key = @key",
+                       {{"key", spanner::Value(key)},
+                        {"data", spanner::Value(value)}}));
+          if (!result) return std::move(result).status();
+          return spanner::Mutations{};
+        });
+    return std::move(commit).status();
+  }
+
+  Mix mix_;
+  std::mutex mu_;
+  google::cloud::internal::DefaultPRNG generator_;
+};
+
+class RunAllExperiment : public Experiment {
+ public:
+  void SetUp(Config const&, spanner::Database const&) override {
+    setup_called_ = true;
+  }
+
+  void Run(Config const& cfg, spanner::Database const& database,
+           SampleSink const& sink) override {
+    // Smoke test all the experiments by running a very small version of each.
+    for (auto& kv : AvailableExperiments()) {
+      // Do not recurse, skip this experiment.
+      if (kv.first == "run-all") continue;
+      Config config = cfg;
+      config.table_size = 10;
+      config.query_size = 2;
+      config.samples = 1;
+      config.iteration_duration = std::chrono::seconds(1);
+      std::cout << "# Smoke test for experiment: " << kv.first << "\n";
+      if (setup_called_) {
+        // Only call SetUp() on each experiment if our own SetUp() was called.
+        kv.second->SetUp(config, database);
+      }
+      kv.second->Run(config, database, sink);
+    }
+  }
+
+ private:
+  bool setup_called_ = false;
+};
+
+std::map<std::string, std::shared_ptr<Experiment>> AvailableExperiments() {
+  auto make = [](std::array<int, kOperationCount> weights, double hot_fraction,
+                 std::int64_t hot_keys) {
+    return std::make_shared<TransactionMixExperiment>(
+        Mix{weights, hot_fraction, hot_keys});
+  };
+  // The weights are, in order: point reads, scans, read-write transactions,
+  // and DML statements.
+  return {
+      {"run-all", std::make_shared<RunAllExperiment>()},
+      // Similar to YCSB workload A: 50% reads, 50% updates.
+      {"update-heavy", make({50, 0, 50, 0}, 0.0, 0)},
+      // Similar to YCSB workload B: 95% reads, 5% updates.
+      {"read-mostly", make({95, 0, 5, 0}, 0.0, 0)},
+      // Similar to YCSB workload E: 95% short scans, 5% updates.
+      {"short-ranges", make({0, 95, 5, 0}, 0.0, 0)},
+      // All the operation types, uniformly distributed keys.
+      {"mixed", make({40, 10, 30, 20}, 0.0, 0)},
+      // All the operation types, with most writes contending on a few keys.
+      {"contention", make({40, 10, 30, 20}, 0.8, 10)},
+  };
+}
+
+}  // namespace
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/bytes.h"
+#include "google/cloud/internal/base64.h"
 #include "google/cloud/status.h"
 #include <array>
 #include <cctype>
@@ -28,16 +29,6 @@ namespace {
 
 constexpr char kPadding = '=';
 
-// The extra braces are working around an old clang bug that was fixed in 6.0
-// https://bugs.llvm.org/show_bug.cgi?id=21629
-constexpr std::array<char, 64> kIndexToChar = {{
-    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
-    'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
-    'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
-    'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
-    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/',
-}};
-
 // The extra braces are working around an old clang bug that was fixed in 6.0
 // https://bugs.llvm.org/show_bug.cgi?id=21629
 constexpr std::array<unsigned char, UCHAR_MAX + 1> kCharToIndexExcessOne = {{
@@ -87,34 +78,11 @@ std::ostream& operator<<(std::ostream& os, Bytes const& bytes) {
 }
 
 void Bytes::Encoder::Flush() {
-  unsigned int const v = buf_[0] << 16 | buf_[1] << 8 | buf_[2];
-  rep_.push_back(kIndexToChar[v >> 18]);
-  rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
-  rep_.push_back(kIndexToChar[v >> 6 & 0x3f]);
-  rep_.push_back(kIndexToChar[v & 0x3f]);
+  google::cloud::internal::Base64Encode(
+      reinterpret_cast<char const*>(buf_.data()), len_, rep_);
   len_ = 0;
 }
 
-void Bytes::Encoder::FlushAndPad() {
-  switch (len_) {
-    case 2: {
-      unsigned int const v = buf_[0] << 16 | buf_[1] << 8;
-      rep_.push_back(kIndexToChar[v >> 18]);
-      rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
-      rep_.push_back(kIndexToChar[v >> 6 & 0x3f]);
-      rep_.push_back(kPadding);
-      break;
-    }
-    case 1: {
-      unsigned int const v = buf_[0] << 16;
-      rep_.push_back(kIndexToChar[v >> 18]);
-      rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
-      rep_.append(2, kPadding);
-      break;
-    }
-  }
-}
-
 void Bytes::Decoder::Iterator::Fill() {
   if (pos_ != end_) {
     unsigned char p0 = *pos_++;
@@ -141,6 +109,14 @@ void Bytes::Decoder::Iterator::Fill() {
   }
 }
 
+std::string Bytes::Decode() const {
+  std::string bytes;
+  // Cannot fail, `base64_rep_` is always valid.
+  google::cloud::internal::Base64Decode(base64_rep_.data(), base64_rep_.size(),
+                                        bytes);
+  return bytes;
+}
+
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
 
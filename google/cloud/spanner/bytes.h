@@ -54,7 +54,7 @@ class Bytes {
       encoder.buf_[encoder.len_++] = *first++;
       if (encoder.len_ == encoder.buf_.size()) encoder.Flush();
     }
-    if (encoder.len_ != 0) encoder.FlushAndPad();
+    encoder.Flush();
   }
   template <typename Container>
   explicit Bytes(Container const& c) : Bytes(std::begin(c), std::end(c)) {}
@@ -64,8 +64,9 @@ class Bytes {
   /// construction from a range specified as a pair of input iterators.
   template <typename Container>
   Container get() const {
-    Decoder decoder(base64_rep_);
-    return Container(decoder.begin(), decoder.end());
+    auto const bytes = Decode();
+    auto const* p = reinterpret_cast<unsigned char const*>(bytes.data());
+    return Container(p, p + bytes.size());
   }
 
   /// @name Relational operators
@@ -87,14 +88,14 @@ class Bytes {
  private:
   friend struct spanner_internal::SPANNER_CLIENT_NS::BytesInternals;
 
+  // Octets are buffered, and encoded a block at a time.
   struct Encoder {
     explicit Encoder(std::string& rep) : rep_(rep), len_(0) {}
-    void Flush();
-    void FlushAndPad();
+    void Flush();  // encodes (and pads) buf_[0 .. len_-1]
 
     std::string& rep_;  // encoded
     std::size_t len_;   // buf_[0 .. len_-1] pending encode
-    std::array<unsigned char, 3> buf_;
+    std::array<unsigned char, 3 * 256> buf_;
   };
 
   struct Decoder {
@@ -148,6 +149,8 @@ class Bytes {
     std::string const& rep_;  // encoded
   };
 
+  std::string Decode() const;
+
   std::string base64_rep_;  // valid base64 representation
 };
 
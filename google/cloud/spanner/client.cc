@@ -117,6 +117,48 @@ RowStream Client::ExecuteQuery(QueryPartition const& partition,
   return conn_->ExecuteQuery(std::move(params));
 }
 
+future<RowStream> Client::AsyncRead(std::string table, KeySet keys,
+                                    std::vector<std::string> columns,
+                                    ReadOptions read_options) {
+  return conn_->AsyncRead({spanner_internal::MakeSingleUseTransaction(
+                               Transaction::ReadOnlyOptions()),
+                           std::move(table),
+                           std::move(keys),
+                           std::move(columns),
+                           std::move(read_options),
+                           {}});
+}
+
+future<RowStream> Client::AsyncRead(Transaction transaction, std::string table,
+                                    KeySet keys,
+                                    std::vector<std::string> columns,
+                                    ReadOptions read_options) {
+  return conn_->AsyncRead({std::move(transaction),
+                           std::move(table),
+                           std::move(keys),
+                           std::move(columns),
+                           std::move(read_options),
+                           {}});
+}
+
+future<RowStream> Client::AsyncExecuteQuery(SqlStatement statement,
+                                            QueryOptions const& opts) {
+  return conn_->AsyncExecuteQuery({spanner_internal::MakeSingleUseTransaction(
+                                       Transaction::ReadOnlyOptions()),
+                                   std::move(statement),
+                                   OverlayQueryOptions(opts),
+                                   {}});
+}
+
+future<RowStream> Client::AsyncExecuteQuery(Transaction transaction,
+                                            SqlStatement statement,
+                                            QueryOptions const& opts) {
+  return conn_->AsyncExecuteQuery({std::move(transaction),
+                                   std::move(statement),
+                                   OverlayQueryOptions(opts),
+                                   {}});
+}
+
 ProfileQueryResult Client::ProfileQuery(SqlStatement statement,
                                         QueryOptions const& opts) {
   return conn_->ProfileQuery({spanner_internal::MakeSingleUseTransaction(
@@ -288,6 +330,13 @@ StatusOr<CommitResult> Client::Commit(Transaction transaction,
   return conn_->Commit({std::move(transaction), std::move(mutations), options});
 }
 
+future<StatusOr<CommitResult>> Client::AsyncCommit(
+    Transaction transaction, Mutations mutations,
+    CommitOptions const& options) {
+  return conn_->AsyncCommit(
+      {std::move(transaction), std::move(mutations), options});
+}
+
 Status Client::Rollback(Transaction transaction) {
   return conn_->Rollback({std::move(transaction)});
 }
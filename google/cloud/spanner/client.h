@@ -36,6 +36,7 @@
 #include "google/cloud/spanner/transaction.h"
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/backoff_policy.h"
+#include "google/cloud/future.h"
 #include "google/cloud/optional.h"
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
@@ -630,6 +631,69 @@ class Client {
    */
   StatusOr<PartitionedDmlResult> ExecutePartitionedDml(SqlStatement statement);
 
+  //@{
+  /**
+   * Starts a read and returns a future satisfied when the read has started.
+   *
+   * These functions behave like the corresponding `Read()` overloads, but do
+   * not block the calling thread while a session is allocated and the first
+   * results are received. Applications with many concurrent point reads can
+   * use them to keep many requests in flight from a few threads.
+   *
+   * Iterating over the returned `RowStream` may still block if the results
+   * span multiple responses.
+   *
+   * @par Example
+   * @code
+   * auto f = client.AsyncRead("Albums", spanner::KeySet::All(), {"AlbumId"});
+   * // ... do other work ...
+   * for (auto& row : spanner::StreamOf<std::tuple<std::int64_t>>(f.get())) {
+   *   if (!row) throw std::runtime_error(row.status().message());
+   * }
+   * @endcode
+   */
+  future<RowStream> AsyncRead(std::string table, KeySet keys,
+                              std::vector<std::string> columns,
+                              ReadOptions read_options = {});
+
+  /// @copydoc AsyncRead(std::string, KeySet, std::vector<std::string>, ReadOptions)
+  future<RowStream> AsyncRead(Transaction transaction, std::string table,
+                              KeySet keys, std::vector<std::string> columns,
+                              ReadOptions read_options = {});
+  //@}
+
+  //@{
+  /**
+   * Starts a SQL query and returns a future satisfied when the query has
+   * started.
+   *
+   * These functions behave like the corresponding `ExecuteQuery()` overloads,
+   * but do not block the calling thread while a session is allocated and the
+   * first results are received.
+   */
+  future<RowStream> AsyncExecuteQuery(SqlStatement statement,
+                                      QueryOptions const& opts = {});
+
+  /// @copydoc AsyncExecuteQuery(SqlStatement, QueryOptions const&)
+  future<RowStream> AsyncExecuteQuery(Transaction transaction,
+                                      SqlStatement statement,
+                                      QueryOptions const& opts = {});
+  //@}
+
+  /**
+   * Commits a read-write transaction asynchronously.
+   *
+   * Behaves like `Commit(Transaction, Mutations, CommitOptions const&)`, but
+   * returns immediately. The returned future is satisfied with the result of
+   * the commit.
+   *
+   * @warning It is an error to call `AsyncCommit` with a read-only
+   *     transaction.
+   */
+  future<StatusOr<CommitResult>> AsyncCommit(Transaction transaction,
+                                             Mutations mutations,
+                                             CommitOptions const& options = {});
+
  private:
   QueryOptions OverlayQueryOptions(QueryOptions const&);
 
@@ -169,6 +169,47 @@ TEST(ClientTest, ReadFailure) {
   EXPECT_THAT(*iter, StatusIs(StatusCode::kDeadlineExceeded));
 }
 
+TEST(ClientTest, AsyncReadUsesRead) {
+  auto conn = std::make_shared<MockConnection>();
+  Client client(conn);
+
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(Status(StatusCode::kPermissionDenied, "uh-oh")));
+
+  EXPECT_CALL(*conn, Read(_))
+      .WillOnce([&source](Connection::ReadParams const& params) {
+        EXPECT_EQ("table", params.table);
+        return RowStream(std::move(source));
+      });
+
+  auto rows = client.AsyncRead("table", KeySet::All(), {"column1"}).get();
+  auto row = rows.begin();
+  ASSERT_NE(row, rows.end());
+  EXPECT_THAT(*row, StatusIs(StatusCode::kPermissionDenied, "uh-oh"));
+}
+
+TEST(ClientTest, AsyncExecuteQueryUsesExecuteQuery) {
+  auto conn = std::make_shared<MockConnection>();
+  Client client(conn);
+
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(Status(StatusCode::kPermissionDenied, "uh-oh")));
+
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .WillOnce([&source](Connection::SqlParams const& params) {
+        EXPECT_EQ("select * from table;", params.statement.sql());
+        return RowStream(std::move(source));
+      });
+
+  auto rows =
+      client.AsyncExecuteQuery(SqlStatement("select * from table;")).get();
+  auto row = rows.begin();
+  ASSERT_NE(row, rows.end());
+  EXPECT_THAT(*row, StatusIs(StatusCode::kPermissionDenied, "uh-oh"));
+}
+
 TEST(ClientTest, ExecuteQuerySuccess) {
   auto conn = std::make_shared<MockConnection>();
   Client client(conn);
@@ -346,6 +387,22 @@ TEST(ClientTest, CommitSuccess) {
   EXPECT_EQ(ts, commit->commit_timestamp);
 }
 
+TEST(ClientTest, AsyncCommitUsesCommit) {
+  auto conn = std::make_shared<MockConnection>();
+
+  auto ts = MakeTimestamp(std::chrono::system_clock::from_time_t(123)).value();
+  CommitResult result;
+  result.commit_timestamp = ts;
+
+  Client client(conn);
+  EXPECT_CALL(*conn, Commit(_)).WillOnce(Return(result));
+
+  auto txn = MakeReadWriteTransaction();
+  auto commit = client.AsyncCommit(txn, {}).get();
+  EXPECT_STATUS_OK(commit);
+  EXPECT_EQ(ts, commit->commit_timestamp);
+}
+
 TEST(ClientTest, CommitError) {
   auto conn = std::make_shared<MockConnection>();
 
@@ -0,0 +1,146 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/columnar_export.h"
+#include "google/cloud/spanner/value.h"
+#include <algorithm>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+using ::google::cloud::spanner_internal::ValueInternals;
+
+StatusOr<ColumnarType> ToColumnarType(spanner_proto::Type const& type) {
+  switch (type.code()) {
+    case spanner_proto::TypeCode::BOOL:
+      return ColumnarType::kBool;
+    case spanner_proto::TypeCode::INT64:
+      return ColumnarType::kInt64;
+    case spanner_proto::TypeCode::FLOAT64:
+      return ColumnarType::kFloat64;
+    case spanner_proto::TypeCode::STRING:
+      return ColumnarType::kString;
+    case spanner_proto::TypeCode::BYTES:
+      return ColumnarType::kBytes;
+    case spanner_proto::TypeCode::NUMERIC:
+      return ColumnarType::kNumeric;
+    case spanner_proto::TypeCode::TIMESTAMP:
+      return ColumnarType::kTimestamp;
+    case spanner_proto::TypeCode::DATE:
+      return ColumnarType::kDate;
+    default:
+      break;
+  }
+  return Status(StatusCode::kInvalidArgument,
+                "unsupported column type for columnar export: " +
+                    spanner_proto::TypeCode_Name(type.code()));
+}
+
+// Decodes @p proto as a `T` and passes it to @p append.
+template <typename T, typename Append>
+Status DecodeAndAppend(spanner_proto::Type const& type,
+                       google::protobuf::Value& proto, Append append) {
+  auto value = ValueInternals::FromProtoAs<T>(type, std::move(proto));
+  if (!value) return std::move(value).status();
+  append(*std::move(value));
+  return Status();
+}
+
+Status AppendValue(ColumnarSink& sink, std::size_t column, ColumnarType type,
+                   Value& value) {
+  auto& proto = ValueInternals::MutableProto(value);
+  if (proto.kind_case() == google::protobuf::Value::kNullValue) {
+    sink.AppendNull(column);
+    return Status();
+  }
+  auto const& t = ValueInternals::TypeOf(value);
+  switch (type) {
+    case ColumnarType::kBool:
+      return DecodeAndAppend<bool>(
+          t, proto, [&](bool v) { sink.AppendBool(column, v); });
+    case ColumnarType::kInt64:
+      return DecodeAndAppend<std::int64_t>(
+          t, proto, [&](std::int64_t v) { sink.AppendInt64(column, v); });
+    case ColumnarType::kFloat64:
+      return DecodeAndAppend<double>(
+          t, proto, [&](double v) { sink.AppendFloat64(column, v); });
+    case ColumnarType::kString:
+      return DecodeAndAppend<std::string>(t, proto, [&](std::string v) {
+        sink.AppendString(column, std::move(v));
+      });
+    case ColumnarType::kBytes:
+      return DecodeAndAppend<Bytes>(
+          t, proto, [&](Bytes v) { sink.AppendBytes(column, std::move(v)); });
+    case ColumnarType::kNumeric:
+      return DecodeAndAppend<Numeric>(t, proto, [&](Numeric v) {
+        sink.AppendNumeric(column, std::move(v));
+      });
+    case ColumnarType::kTimestamp:
+      return DecodeAndAppend<Timestamp>(
+          t, proto, [&](Timestamp v) { sink.AppendTimestamp(column, v); });
+    case ColumnarType::kDate:
+      return DecodeAndAppend<absl::CivilDay>(
+          t, proto, [&](absl::CivilDay v) { sink.AppendDate(column, v); });
+  }
+  return Status(StatusCode::kInternal, "unexpected columnar type");
+}
+
+}  // namespace
+
+Status ExportColumnar(RowStream& rows, ColumnarSink& sink,
+                      ColumnarExportOptions const& options) {
+  auto const batch_size = (std::max)(options.batch_size(), std::size_t{1});
+  bool started = false;
+  std::vector<ColumnarType> types;
+  std::size_t batch_rows = 0;
+  for (auto& row : rows) {
+    if (!row) return std::move(row).status();
+    if (!started) {
+      std::vector<ColumnarField> fields;
+      auto const& names = row->columns();
+      auto const& values = row->values();
+      for (std::size_t i = 0; i != values.size(); ++i) {
+        auto type = ToColumnarType(ValueInternals::TypeOf(values[i]));
+        if (!type) return std::move(type).status();
+        fields.push_back({i < names.size() ? names[i] : std::string{}, *type});
+        types.push_back(*type);
+      }
+      auto status = sink.Start(fields);
+      if (!status.ok()) return status;
+      started = true;
+    }
+    auto values = std::move(*row).values();
+    auto const n = (std::min)(values.size(), types.size());
+    for (std::size_t i = 0; i != n; ++i) {
+      auto status = AppendValue(sink, i, types[i], values[i]);
+      if (!status.ok()) return status;
+    }
+    if (++batch_rows != batch_size) continue;
+    auto status = sink.FinishBatch(batch_rows);
+    if (!status.ok()) return status;
+    batch_rows = 0;
+  }
+  if (batch_rows != 0) return sink.FinishBatch(batch_rows);
+  return Status();
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,140 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COLUMNAR_EXPORT_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COLUMNAR_EXPORT_H
+
+#include "google/cloud/spanner/bytes.h"
+#include "google/cloud/spanner/numeric.h"
+#include "google/cloud/spanner/results.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include "absl/time/civil_time.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// The column types supported by `ExportColumnar()`.
+enum class ColumnarType {
+  kBool,
+  kInt64,
+  kFloat64,
+  kString,
+  kBytes,
+  kNumeric,
+  kTimestamp,
+  kDate,
+};
+
+/// Describes a column in the output of `ExportColumnar()`.
+struct ColumnarField {
+  std::string name;
+  ColumnarType type;
+};
+
+/**
+ * Receives the values of a `RowStream` column by column.
+ *
+ * Implement this interface to build columnar data, e.g., using Apache Arrow
+ * array builders, one builder per column. `ExportColumnar()` calls `Start()`
+ * once, then the `Append*()` function matching the type of each column (or
+ * `AppendNull()`) for every value, and `FinishBatch()` after each batch of
+ * rows, where an Arrow implementation would create a `RecordBatch`.
+ *
+ * The `column` argument is the position of the column in the fields passed to
+ * `Start()`.
+ */
+class ColumnarSink {
+ public:
+  virtual ~ColumnarSink() = default;
+
+  /// Called before the first value, returning an error stops the export.
+  virtual Status Start(std::vector<ColumnarField> const& fields) = 0;
+
+  virtual void AppendNull(std::size_t column) = 0;
+  virtual void AppendBool(std::size_t column, bool value) = 0;
+  virtual void AppendInt64(std::size_t column, std::int64_t value) = 0;
+  virtual void AppendFloat64(std::size_t column, double value) = 0;
+  virtual void AppendString(std::size_t column, std::string value) = 0;
+  virtual void AppendBytes(std::size_t column, Bytes value) = 0;
+  virtual void AppendNumeric(std::size_t column, Numeric value) = 0;
+  virtual void AppendTimestamp(std::size_t column, Timestamp value) = 0;
+  virtual void AppendDate(std::size_t column, absl::CivilDay value) = 0;
+
+  /// Called after each batch of @p rows, returning an error stops the export.
+  virtual Status FinishBatch(std::size_t rows) = 0;
+};
+
+/// Configure `ExportColumnar()`.
+class ColumnarExportOptions {
+ public:
+  ColumnarExportOptions() = default;
+
+  /// The maximum number of rows in each batch. The default is 8192. Values
+  /// < 1 are treated as 1.
+  std::size_t batch_size() const { return batch_size_; }
+  ColumnarExportOptions& set_batch_size(std::size_t v) {
+    batch_size_ = v;
+    return *this;
+  }
+
+ private:
+  std::size_t batch_size_ = 8192;
+};
+
+/**
+ * Consumes @p rows and sends their values to @p sink, one batch at a time.
+ *
+ * Each value is decoded straight from its wire representation into the type
+ * expected by the sink. This avoids the `StreamOf<std::tuple<...>>`
+ * conversions, and the intermediate `Value` copies, of a row by row
+ * conversion.
+ *
+ * The column types are taken from the first row, a stream without rows does
+ * not call `sink`. Columns of `ARRAY` or `STRUCT` type are not supported.
+ *
+ * For parallel exports, partition the query with `Client::PartitionQuery()`,
+ * and export each partition, e.g. `client.ExecuteQuery(partition)`, from its
+ * own thread and with its own sink. Alternatively, export the stream returned
+ * by `MergePartitions()` to a single sink.
+ *
+ * @return the first error in @p rows, or returned by @p sink, or an OK status
+ *     once all the rows are exported.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * ArrowSink sink;  // implements spanner::ColumnarSink using Arrow builders
+ * auto rows = client.ExecuteQuery(
+ *     spanner::SqlStatement("SELECT SingerId, FirstName FROM Singers"));
+ * auto status = spanner::ExportColumnar(
+ *     rows, sink, spanner::ColumnarExportOptions().set_batch_size(64 * 1024));
+ * @endcode
+ */
+Status ExportColumnar(RowStream& rows, ColumnarSink& sink,
+                      ColumnarExportOptions const& options = {});
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COLUMNAR_EXPORT_H
@@ -0,0 +1,190 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/columnar_export.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockResultSetSource;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::Return;
+
+// Records each call as a string, e.g. "int64[0]=1".
+class RecordingSink : public ColumnarSink {
+ public:
+  Status Start(std::vector<ColumnarField> const& fields) override {
+    for (auto const& f : fields) {
+      calls.push_back("field " + f.name + ":" +
+                      std::to_string(static_cast<int>(f.type)));
+    }
+    return Status();
+  }
+
+  void AppendNull(std::size_t column) override {
+    Record("null", column, "");
+  }
+  void AppendBool(std::size_t column, bool value) override {
+    Record("bool", column, value ? "true" : "false");
+  }
+  void AppendInt64(std::size_t column, std::int64_t value) override {
+    Record("int64", column, std::to_string(value));
+  }
+  void AppendFloat64(std::size_t column, double value) override {
+    Record("float64", column, std::to_string(value));
+  }
+  void AppendString(std::size_t column, std::string value) override {
+    Record("string", column, value);
+  }
+  void AppendBytes(std::size_t column, Bytes value) override {
+    Record("bytes", column, value.get<std::string>());
+  }
+  void AppendNumeric(std::size_t column, Numeric value) override {
+    Record("numeric", column, value.ToString());
+  }
+  void AppendTimestamp(std::size_t column, Timestamp) override {
+    Record("timestamp", column, "");
+  }
+  void AppendDate(std::size_t column, absl::CivilDay value) override {
+    Record("date", column, absl::FormatCivilTime(value));
+  }
+
+  Status FinishBatch(std::size_t rows) override {
+    calls.push_back("batch " + std::to_string(rows));
+    return finish_status;
+  }
+
+  std::vector<std::string> calls;
+  Status finish_status;
+
+ private:
+  void Record(std::string const& type, std::size_t column,
+              std::string const& value) {
+    calls.push_back(type + "[" + std::to_string(column) + "]=" + value);
+  }
+};
+
+TEST(ExportColumnarTest, Batches) {
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(MakeTestRow({{"id", Value(1)},
+                                    {"name", Value("a")},
+                                    {"score", Value(0.5)}})))
+      .WillOnce(Return(MakeTestRow({{"id", Value(2)},
+                                    {"name", Value("b")},
+                                    {"score", MakeNullValue<double>()}})))
+      .WillOnce(Return(MakeTestRow({{"id", Value(3)},
+                                    {"name", Value("c")},
+                                    {"score", Value(1.5)}})))
+      .WillOnce(Return(Row()));
+  RowStream rows(std::move(source));
+
+  RecordingSink sink;
+  EXPECT_STATUS_OK(
+      ExportColumnar(rows, sink, ColumnarExportOptions().set_batch_size(2)));
+  EXPECT_THAT(
+      sink.calls,
+      ElementsAre("field id:1", "field name:3", "field score:2", "int64[0]=1",
+                  "string[1]=a", "float64[2]=0.500000", "int64[0]=2",
+                  "string[1]=b", "null[2]=", "batch 2", "int64[0]=3",
+                  "string[1]=c", "float64[2]=1.500000", "batch 1"));
+}
+
+TEST(ExportColumnarTest, AllTypes) {
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(MakeTestRow({
+          {"b", Value(true)},
+          {"y", Value(Bytes("xyz"))},
+          {"n", Value(MakeNumeric(42).value())},
+          {"t", Value(Timestamp())},
+          {"d", Value(absl::CivilDay(2021, 2, 3))},
+      })))
+      .WillOnce(Return(Row()));
+  RowStream rows(std::move(source));
+
+  RecordingSink sink;
+  EXPECT_STATUS_OK(ExportColumnar(rows, sink));
+  EXPECT_THAT(sink.calls,
+              ElementsAre("field b:0", "field y:4", "field n:5", "field t:6",
+                          "field d:7", "bool[0]=true", "bytes[1]=xyz",
+                          "numeric[2]=42", "timestamp[3]=",
+                          "date[4]=2021-02-03", "batch 1"));
+}
+
+TEST(ExportColumnarTest, NoRows) {
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, NextRow()).WillOnce(Return(Row()));
+  RowStream rows(std::move(source));
+
+  RecordingSink sink;
+  EXPECT_STATUS_OK(ExportColumnar(rows, sink));
+  EXPECT_TRUE(sink.calls.empty());
+}
+
+TEST(ExportColumnarTest, StreamError) {
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(MakeTestRow({{"id", Value(1)}})))
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+  RowStream rows(std::move(source));
+
+  RecordingSink sink;
+  EXPECT_THAT(ExportColumnar(rows, sink),
+              StatusIs(StatusCode::kUnavailable, "try-again"));
+  EXPECT_THAT(sink.calls, ElementsAre("field id:1", "int64[0]=1"));
+}
+
+TEST(ExportColumnarTest, SinkError) {
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(MakeTestRow({{"id", Value(1)}})));
+  RowStream rows(std::move(source));
+
+  RecordingSink sink;
+  sink.finish_status = Status(StatusCode::kResourceExhausted, "full");
+  EXPECT_THAT(
+      ExportColumnar(rows, sink, ColumnarExportOptions().set_batch_size(1)),
+      StatusIs(StatusCode::kResourceExhausted, "full"));
+}
+
+TEST(ExportColumnarTest, UnsupportedType) {
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(
+          MakeTestRow({{"ids", Value(std::vector<std::int64_t>{1, 2})}})));
+  RowStream rows(std::move(source));
+
+  RecordingSink sink;
+  EXPECT_THAT(ExportColumnar(rows, sink),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_TRUE(sink.calls.empty());
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -29,6 +29,7 @@
 #include "google/cloud/spanner/sql_statement.h"
 #include "google/cloud/spanner/transaction.h"
 #include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
 #include "google/cloud/optional.h"
 #include "google/cloud/status_or.h"
 #include "absl/types/optional.h"
@@ -164,6 +165,28 @@ class Connection {
 
   /// Defines the interface for `Client::Rollback()`
   virtual Status Rollback(RollbackParams) = 0;
+
+  /**
+   * Defines the interface for `Client::AsyncRead()`
+   *
+   * The default implementation calls `Read()` and returns a satisfied future,
+   * so existing `Connection` classes (including mocks) need no changes.
+   */
+  virtual future<RowStream> AsyncRead(ReadParams params) {
+    return make_ready_future(Read(std::move(params)));
+  }
+
+  /// Defines the interface for `Client::AsyncExecuteQuery()`, the default
+  /// implementation calls `ExecuteQuery()`.
+  virtual future<RowStream> AsyncExecuteQuery(SqlParams params) {
+    return make_ready_future(ExecuteQuery(std::move(params)));
+  }
+
+  /// Defines the interface for `Client::AsyncCommit()`, the default
+  /// implementation calls `Commit()`.
+  virtual future<StatusOr<CommitResult>> AsyncCommit(CommitParams params) {
+    return make_ready_future(Commit(std::move(params)));
+  }
 };
 
 }  // namespace SPANNER_CLIENT_NS
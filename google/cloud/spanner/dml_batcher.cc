@@ -0,0 +1,126 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/dml_batcher.h"
+#include "absl/memory/memory.h"
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace {
+
+// A stream that returns a single error, used when the flush before a read
+// fails.
+class StatusOnlySource : public spanner_internal::ResultSourceInterface {
+ public:
+  explicit StatusOnlySource(Status status) : status_(std::move(status)) {}
+
+  StatusOr<Row> NextRow() override { return status_; }
+  absl::optional<google::spanner::v1::ResultSetMetadata> Metadata() override {
+    return {};
+  }
+  absl::optional<google::spanner::v1::ResultSetStats> Stats() const override {
+    return {};
+  }
+
+ private:
+  Status status_;
+};
+
+}  // namespace
+
+DmlBatcher::DmlBatcher(Client client, Transaction transaction)
+    : client_(std::move(client)), transaction_(std::move(transaction)) {}
+
+DmlBatcher::~DmlBatcher() {
+  for (auto& r : results_) {
+    r.set_value(Status(StatusCode::kCancelled,
+                       "DmlBatcher destroyed before the statement was sent"));
+  }
+}
+
+future<StatusOr<std::int64_t>> DmlBatcher::ExecuteDml(SqlStatement statement) {
+  statements_.push_back(std::move(statement));
+  results_.emplace_back();
+  return results_.back().get_future();
+}
+
+Status DmlBatcher::Flush() {
+  if (statements_.empty()) return Status();
+  auto statements = std::move(statements_);
+  auto results = std::move(results_);
+  statements_.clear();
+  results_.clear();
+
+  auto batch = client_.ExecuteBatchDml(transaction_, std::move(statements));
+  if (!batch) {
+    for (auto& r : results) r.set_value(batch.status());
+    return std::move(batch).status();
+  }
+  std::size_t i = 0;
+  for (; i != results.size() && i != batch->stats.size(); ++i) {
+    results[i].set_value(batch->stats[i].row_count);
+  }
+  if (i != results.size()) {
+    // The service returns an OK status when it executes fewer statements than
+    // requested, treat that as an error too.
+    auto status = batch->status.ok()
+                      ? Status(StatusCode::kInternal,
+                               "ExecuteBatchDml returned fewer results than "
+                               "statements, without an error")
+                      : batch->status;
+    results[i++].set_value(status);
+    for (; i != results.size(); ++i) {
+      results[i].set_value(Status(
+          StatusCode::kCancelled,
+          "statement not executed, an earlier statement in the batch failed"));
+    }
+    return status;
+  }
+  return batch->status;
+}
+
+StatusOr<Mutations> DmlBatcher::Finish(Mutations mutations) {
+  auto status = Flush();
+  if (!status.ok()) return status;
+  return mutations;
+}
+
+RowStream DmlBatcher::Read(std::string table, KeySet keys,
+                           std::vector<std::string> columns,
+                           ReadOptions read_options) {
+  auto status = Flush();
+  if (!status.ok()) {
+    return RowStream(absl::make_unique<StatusOnlySource>(std::move(status)));
+  }
+  return client_.Read(transaction_, std::move(table), std::move(keys),
+                      std::move(columns), std::move(read_options));
+}
+
+RowStream DmlBatcher::ExecuteQuery(SqlStatement statement,
+                                   QueryOptions const& opts) {
+  auto status = Flush();
+  if (!status.ok()) {
+    return RowStream(absl::make_unique<StatusOnlySource>(std::move(status)));
+  }
+  return client_.ExecuteQuery(transaction_, std::move(statement), opts);
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
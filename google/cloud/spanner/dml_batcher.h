@@ -0,0 +1,144 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_DML_BATCHER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_DML_BATCHER_H
+
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/keys.h"
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/query_options.h"
+#include "google/cloud/spanner/read_options.h"
+#include "google/cloud/spanner/results.h"
+#include "google/cloud/spanner/sql_statement.h"
+#include "google/cloud/spanner/transaction.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * Buffers the DML statements of a read-write transaction and sends them using
+ * `Client::ExecuteBatchDml()`.
+ *
+ * Each `Client::ExecuteDml()` call is a round trip to the service. Many
+ * transactions run a sequence of DML statements without looking at their
+ * results until much later. With this class those statements are queued, and
+ * sent as a single batch the next time the transaction reads data (through
+ * this class), or when the transaction is about to commit. The number of
+ * modified rows for each statement is returned via a future, satisfied once
+ * the batch runs.
+ *
+ * The statements run in the order they were queued. If a statement fails,
+ * the statements after it in the same batch are not executed, and their
+ * futures are satisfied with a `kCancelled` error.
+ *
+ * Any statements still queued when the object is destroyed are discarded, and
+ * their futures are satisfied with a `kCancelled` error. This class is not
+ * thread-safe.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * auto commit = client.Commit(
+ *     [&](spanner::Transaction txn) -> StatusOr<spanner::Mutations> {
+ *       spanner::DmlBatcher batcher(client, std::move(txn));
+ *       auto updated = batcher.ExecuteDml(spanner::SqlStatement(
+ *           "UPDATE Albums SET MarketingBudget = 0 WHERE SingerId = 1"));
+ *       batcher.ExecuteDml(spanner::SqlStatement(
+ *           "DELETE FROM Singers WHERE SingerId = 2"));
+ *       // Sends both statements, then commits.
+ *       return batcher.Finish();
+ *     });
+ * @endcode
+ */
+class DmlBatcher {
+ public:
+  DmlBatcher(Client client, Transaction transaction);
+  ~DmlBatcher();
+
+  DmlBatcher(DmlBatcher const&) = delete;
+  DmlBatcher& operator=(DmlBatcher const&) = delete;
+
+  /**
+   * Queues @p statement, returns the number of rows it modifies.
+   *
+   * The returned future is satisfied when the statement runs, see `Flush()`.
+   * Do not block on the future before flushing the queue.
+   */
+  future<StatusOr<std::int64_t>> ExecuteDml(SqlStatement statement);
+
+  /**
+   * Sends all the queued statements as a single batch.
+   *
+   * Does nothing if no statements are queued.
+   *
+   * @return the status of the first statement that failed, or an OK status if
+   *     all the statements ran successfully.
+   */
+  Status Flush();
+
+  /**
+   * Flushes the queue, and then returns @p mutations.
+   *
+   * Use the result as the return value of the mutator passed to
+   * `Client::Commit()`, this flushes the queued statements before the
+   * transaction commits, and aborts the commit if any of them failed.
+   */
+  StatusOr<Mutations> Finish(Mutations mutations = {});
+
+  /**
+   * Flushes the queue, and then reads from the transaction.
+   *
+   * The read observes the changes made by the queued statements. If the queued
+   * statements fail, the returned stream has the same error.
+   */
+  RowStream Read(std::string table, KeySet keys,
+                 std::vector<std::string> columns,
+                 ReadOptions read_options = {});
+
+  /**
+   * Flushes the queue, and then runs a query in the transaction.
+   *
+   * The query observes the changes made by the queued statements. If the
+   * queued statements fail, the returned stream has the same error.
+   */
+  RowStream ExecuteQuery(SqlStatement statement,
+                         QueryOptions const& opts = {});
+
+  /// The number of statements waiting for the next flush.
+  std::size_t pending() const { return statements_.size(); }
+
+ private:
+  Client client_;
+  Transaction transaction_;
+  std::vector<SqlStatement> statements_;
+  std::vector<promise<StatusOr<std::int64_t>>> results_;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_DML_BATCHER_H
@@ -0,0 +1,140 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/dml_batcher.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::google::cloud::spanner_mocks::MockResultSetSource;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Return;
+
+std::vector<std::string> Sql(std::vector<SqlStatement> const& statements) {
+  std::vector<std::string> sql;
+  for (auto const& s : statements) sql.push_back(s.sql());
+  return sql;
+}
+
+BatchDmlResult MakeBatchResult(std::vector<std::int64_t> const& row_counts,
+                               Status status = {}) {
+  BatchDmlResult result;
+  for (auto c : row_counts) result.stats.push_back({c});
+  result.status = std::move(status);
+  return result;
+}
+
+TEST(DmlBatcherTest, FlushSendsOneBatch) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteBatchDml(_))
+      .WillOnce([](Connection::ExecuteBatchDmlParams const& p) {
+        EXPECT_THAT(Sql(p.statements), ElementsAre("UPDATE 1", "UPDATE 2"));
+        return MakeBatchResult({3, 4});
+      });
+  DmlBatcher tested(Client(conn), MakeReadWriteTransaction());
+  auto f1 = tested.ExecuteDml(SqlStatement("UPDATE 1"));
+  auto f2 = tested.ExecuteDml(SqlStatement("UPDATE 2"));
+  EXPECT_EQ(2, tested.pending());
+  EXPECT_STATUS_OK(tested.Flush());
+  EXPECT_EQ(0, tested.pending());
+  EXPECT_EQ(3, f1.get().value());
+  EXPECT_EQ(4, f2.get().value());
+
+  // Nothing to send.
+  EXPECT_STATUS_OK(tested.Flush());
+}
+
+TEST(DmlBatcherTest, StatementFailure) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteBatchDml(_))
+      .WillOnce([](Connection::ExecuteBatchDmlParams const&) {
+        return MakeBatchResult({3},
+                               Status(StatusCode::kInvalidArgument, "bad"));
+      });
+  DmlBatcher tested(Client(conn), MakeReadWriteTransaction());
+  auto f1 = tested.ExecuteDml(SqlStatement("UPDATE 1"));
+  auto f2 = tested.ExecuteDml(SqlStatement("UPDATE 2"));
+  auto f3 = tested.ExecuteDml(SqlStatement("UPDATE 3"));
+  auto mutations = tested.Finish();
+  EXPECT_THAT(mutations, StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(3, f1.get().value());
+  EXPECT_THAT(f2.get(), StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(f3.get(), StatusIs(StatusCode::kCancelled));
+}
+
+TEST(DmlBatcherTest, RpcFailure) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteBatchDml(_))
+      .WillOnce([](Connection::ExecuteBatchDmlParams const&) {
+        return Status(StatusCode::kAborted, "aborted");
+      });
+  EXPECT_CALL(*conn, ExecuteQuery(_)).Times(0);
+  DmlBatcher tested(Client(conn), MakeReadWriteTransaction());
+  auto f1 = tested.ExecuteDml(SqlStatement("UPDATE 1"));
+  auto rows = tested.ExecuteQuery(SqlStatement("SELECT 1"));
+  auto row = rows.begin();
+  ASSERT_NE(row, rows.end());
+  EXPECT_THAT(*row, StatusIs(StatusCode::kAborted));
+  EXPECT_THAT(f1.get(), StatusIs(StatusCode::kAborted));
+}
+
+TEST(DmlBatcherTest, ReadFlushesFirst) {
+  auto conn = std::make_shared<MockConnection>();
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*conn, ExecuteBatchDml(_))
+      .WillOnce([](Connection::ExecuteBatchDmlParams const&) {
+        return MakeBatchResult({1});
+      });
+  EXPECT_CALL(*conn, Read(_)).WillOnce([](Connection::ReadParams const& p) {
+    EXPECT_EQ("Singers", p.table);
+    auto source = absl::make_unique<MockResultSetSource>();
+    EXPECT_CALL(*source, NextRow()).WillOnce(Return(Row()));
+    return RowStream(std::move(source));
+  });
+  DmlBatcher tested(Client(conn), MakeReadWriteTransaction());
+  auto f1 = tested.ExecuteDml(SqlStatement("UPDATE 1"));
+  auto rows = tested.Read("Singers", KeySet::All(), {"SingerId"});
+  EXPECT_EQ(rows.begin(), rows.end());
+  EXPECT_EQ(1, f1.get().value());
+}
+
+TEST(DmlBatcherTest, DestroyedBeforeFlush) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteBatchDml(_)).Times(0);
+  future<StatusOr<std::int64_t>> f1;
+  {
+    DmlBatcher tested(Client(conn), MakeReadWriteTransaction());
+    f1 = tested.ExecuteDml(SqlStatement("UPDATE 1"));
+  }
+  EXPECT_THAT(f1.get(), StatusIs(StatusCode::kCancelled));
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -23,6 +23,7 @@ google_cloud_cpp_spanner_hdrs = [
     "bytes.h",
     "client.h",
     "client_options.h",
+    "columnar_export.h",
     "commit_options.h",
     "commit_result.h",
     "connection.h",
@@ -32,6 +33,7 @@ google_cloud_cpp_spanner_hdrs = [
     "database_admin_client.h",
     "database_admin_connection.h",
     "date.h",
+    "dml_batcher.h",
     "iam_updater.h",
     "instance.h",
     "instance_admin_client.h",
@@ -42,6 +44,7 @@ google_cloud_cpp_spanner_hdrs = [
     "internal/database_admin_logging.h",
     "internal/database_admin_metadata.h",
     "internal/database_admin_stub.h",
+    "internal/fault_injection_spanner_stub.h",
     "internal/instance_admin_logging.h",
     "internal/instance_admin_metadata.h",
     "internal/instance_admin_stub.h",
@@ -49,30 +52,41 @@ google_cloud_cpp_spanner_hdrs = [
     "internal/logging_spanner_stub.h",
     "internal/merge_chunk.h",
     "internal/metadata_spanner_stub.h",
+    "internal/partial_result_set_prefetch.h",
     "internal/partial_result_set_reader.h",
     "internal/partial_result_set_resume.h",
     "internal/partial_result_set_source.h",
+    "internal/read_caching_connection.h",
+    "internal/read_coalescing_connection.h",
     "internal/session.h",
     "internal/session_pool.h",
     "internal/spanner_stub.h",
+    "internal/statement_stats_connection.h",
     "internal/status_utils.h",
     "internal/transaction_impl.h",
     "internal/tuple_utils.h",
     "keys.h",
+    "mutation_batcher.h",
     "mutations.h",
     "numeric.h",
+    "partition_coordinator.h",
+    "partition_executor.h",
     "partition_options.h",
     "partitioned_dml_result.h",
     "polling_policy.h",
     "query_options.h",
     "query_partition.h",
+    "read_cache.h",
+    "read_coalescing.h",
     "read_options.h",
     "read_partition.h",
     "results.h",
     "retry_policy.h",
     "row.h",
+    "session_pool_metrics.h",
     "session_pool_options.h",
     "sql_statement.h",
+    "statement_stats.h",
     "timestamp.h",
     "tracing_options.h",
     "transaction.h",
@@ -86,10 +100,12 @@ google_cloud_cpp_spanner_srcs = [
     "backup.cc",
     "bytes.cc",
     "client.cc",
+    "columnar_export.cc",
     "connection_options.cc",
     "database.cc",
     "database_admin_client.cc",
     "database_admin_connection.cc",
+    "dml_batcher.cc",
     "instance.cc",
     "instance_admin_client.cc",
     "instance_admin_connection.cc",
@@ -97,6 +113,7 @@ google_cloud_cpp_spanner_srcs = [
     "internal/database_admin_logging.cc",
     "internal/database_admin_metadata.cc",
     "internal/database_admin_stub.cc",
+    "internal/fault_injection_spanner_stub.cc",
     "internal/instance_admin_logging.cc",
     "internal/instance_admin_metadata.cc",
     "internal/instance_admin_stub.cc",
@@ -104,22 +121,32 @@ google_cloud_cpp_spanner_srcs = [
     "internal/logging_spanner_stub.cc",
     "internal/merge_chunk.cc",
     "internal/metadata_spanner_stub.cc",
+    "internal/partial_result_set_prefetch.cc",
     "internal/partial_result_set_resume.cc",
     "internal/partial_result_set_source.cc",
+    "internal/read_caching_connection.cc",
+    "internal/read_coalescing_connection.cc",
     "internal/session.cc",
     "internal/session_pool.cc",
     "internal/spanner_stub.cc",
+    "internal/statement_stats_connection.cc",
     "internal/status_utils.cc",
     "internal/transaction_impl.cc",
     "keys.cc",
+    "mutation_batcher.cc",
     "mutations.cc",
     "numeric.cc",
+    "partition_coordinator.cc",
+    "partition_executor.cc",
     "partition_options.cc",
     "query_partition.cc",
+    "read_cache.cc",
+    "read_coalescing.cc",
     "read_partition.cc",
     "results.cc",
     "row.cc",
     "sql_statement.cc",
+    "statement_stats.cc",
     "timestamp.cc",
     "transaction.cc",
     "value.cc",
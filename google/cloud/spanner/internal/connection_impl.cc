@@ -120,7 +120,8 @@ ConnectionImpl::ConnectionImpl(
           background_threads_->cq(), retry_policy_prototype_->clone(),
           backoff_policy_prototype_->clone())),
       rpc_stream_tracing_enabled_(options.tracing_enabled("rpc-streams")),
-      tracing_options_(options.tracing_options()) {}
+      tracing_options_(options.tracing_options()),
+      prefetch_options_(PrefetchOptionsFromEnv()) {}
 
 spanner::RowStream ConnectionImpl::Read(ReadParams params) {
   return Visit(std::move(params.transaction),
@@ -326,6 +327,62 @@ class StreamingPartitionedDmlResult {
   std::unique_ptr<ResultSourceInterface> source_;
 };
 
+namespace {
+
+/// Runs @p work on one of the background threads of @p cq.
+template <typename R, typename Work>
+future<R> RunOnCompletionQueue(CompletionQueue& cq, Work work) {
+  struct MoveCapture {
+    promise<R> p;
+    Work work;
+    void operator()() { p.set_value(work()); }
+  };
+  promise<R> p;
+  auto f = p.get_future();
+  cq.RunAsync(MoveCapture{std::move(p), std::move(work)});
+  return f;
+}
+
+}  // namespace
+
+future<spanner::RowStream> ConnectionImpl::AsyncRead(ReadParams params) {
+  struct Work {
+    std::shared_ptr<ConnectionImpl> self;
+    ReadParams params;
+    spanner::RowStream operator()() {
+      return self->Read(std::move(params));
+    }
+  };
+  return RunOnCompletionQueue<spanner::RowStream>(
+      background_threads_->cq(), Work{shared_from_this(), std::move(params)});
+}
+
+future<spanner::RowStream> ConnectionImpl::AsyncExecuteQuery(
+    SqlParams params) {
+  struct Work {
+    std::shared_ptr<ConnectionImpl> self;
+    SqlParams params;
+    spanner::RowStream operator()() {
+      return self->ExecuteQuery(std::move(params));
+    }
+  };
+  return RunOnCompletionQueue<spanner::RowStream>(
+      background_threads_->cq(), Work{shared_from_this(), std::move(params)});
+}
+
+future<StatusOr<spanner::CommitResult>> ConnectionImpl::AsyncCommit(
+    CommitParams params) {
+  struct Work {
+    std::shared_ptr<ConnectionImpl> self;
+    CommitParams params;
+    StatusOr<spanner::CommitResult> operator()() {
+      return self->Commit(std::move(params));
+    }
+  };
+  return RunOnCompletionQueue<StatusOr<spanner::CommitResult>>(
+      background_threads_->cq(), Work{shared_from_this(), std::move(params)});
+}
+
 /**
  * Helper function that ensures `session` holds a valid `Session`, or returns
  * an error if `session` is empty and no `Session` can be allocated.
@@ -345,6 +402,14 @@ Status ConnectionImpl::PrepareSession(SessionHolder& session,
 /**
  * Performs an explicit `BeginTransaction` in cases where that is needed.
  *
+ * Read-write transactions normally begin inline: the first `Read`,
+ * `ExecuteSql`, or `ExecuteBatchDml` request carries a `begin` selector and
+ * its response returns the transaction id. An explicit `BeginTransaction` is
+ * only used when that inlined request fails, for partitioned DML, and to
+ * commit a transaction that executed no statements. The last case could use
+ * `CommitRequest.single_use_transaction`, but a retried single-use commit may
+ * apply the mutations twice, while a commit by transaction id may not.
+ *
  * @param session identifies the Session to use.
  * @param options `TransactionOptions` to use in the request.
  * @param func identifies the calling function for logging purposes.
@@ -405,8 +470,9 @@ spanner::RowStream ConnectionImpl::ReadImpl(
   auto stub = session_pool_->GetStub(*session);
   auto const tracing_enabled = rpc_stream_tracing_enabled_;
   auto const tracing_options = tracing_options_;
-  auto factory = [stub, &request, tracing_enabled,
-                  tracing_options](std::string const& resume_token) mutable {
+  auto const prefetch_options = prefetch_options_;
+  auto factory = [stub, &request, tracing_enabled, tracing_options,
+                  prefetch_options](std::string const& resume_token) mutable {
     request.set_resume_token(resume_token);
     auto context = absl::make_unique<grpc::ClientContext>();
     std::unique_ptr<PartialResultSetReader> reader =
@@ -416,7 +482,7 @@ spanner::RowStream ConnectionImpl::ReadImpl(
       reader = absl::make_unique<LoggingResultSetReader>(std::move(reader),
                                                          tracing_options);
     }
-    return reader;
+    return MaybePrefetch(std::move(reader), prefetch_options);
   };
   for (;;) {
     auto rpc = absl::make_unique<PartialResultSetResume>(
@@ -601,12 +667,13 @@ ResultType ConnectionImpl::CommonQueryImpl(
   auto const& backoff_policy = backoff_policy_prototype_;
   auto const tracing_enabled = rpc_stream_tracing_enabled_;
   auto const tracing_options = tracing_options_;
+  auto const prefetch_options = prefetch_options_;
   auto retry_resume_fn =
-      [stub, retry_policy, backoff_policy, tracing_enabled,
-       tracing_options](spanner_proto::ExecuteSqlRequest& request) mutable
+      [stub, retry_policy, backoff_policy, tracing_enabled, tracing_options,
+       prefetch_options](spanner_proto::ExecuteSqlRequest& request) mutable
       -> StatusOr<std::unique_ptr<ResultSourceInterface>> {
-    auto factory = [stub, request, tracing_enabled,
-                    tracing_options](std::string const& resume_token) mutable {
+    auto factory = [stub, request, tracing_enabled, tracing_options,
+                    prefetch_options](std::string const& resume_token) mutable {
       request.set_resume_token(resume_token);
       auto context = absl::make_unique<grpc::ClientContext>();
       std::unique_ptr<PartialResultSetReader> reader =
@@ -616,7 +683,7 @@ ResultType ConnectionImpl::CommonQueryImpl(
         reader = absl::make_unique<LoggingResultSetReader>(std::move(reader),
                                                            tracing_options);
       }
-      return reader;
+      return MaybePrefetch(std::move(reader), prefetch_options);
     };
     auto rpc = absl::make_unique<PartialResultSetResume>(
         std::move(factory), Idempotency::kIdempotent, retry_policy->clone(),
@@ -957,20 +1024,19 @@ Status ConnectionImpl::RollbackImpl(
                   "Cannot rollback a single-use transaction");
   }
 
+  if (s->has_begin()) {
+    // No statement has begun the transaction (the begin is inlined into the
+    // first statement), so the service has nothing to roll back. Skip the
+    // `BeginTransaction` and `Rollback` round trips.
+    s = Status(StatusCode::kFailedPrecondition, "transaction rolled back");
+    return Status();
+  }
+
   auto prepare_status = PrepareSession(session);
   if (!prepare_status.ok()) {
     return prepare_status;
   }
 
-  if (s->has_begin()) {
-    auto begin = BeginTransaction(session, s->begin(), __func__);
-    if (!begin.ok()) {
-      s = begin.status();  // invalidate the transaction
-      return begin.status();
-    }
-    s->set_id(begin->id());
-  }
-
   spanner_proto::RollbackRequest request;
   request.set_session(session->session_name());
   request.set_transaction_id(s->id());
@@ -18,6 +18,7 @@
 #include "google/cloud/spanner/backoff_policy.h"
 #include "google/cloud/spanner/connection.h"
 #include "google/cloud/spanner/database.h"
+#include "google/cloud/spanner/internal/partial_result_set_prefetch.h"
 #include "google/cloud/spanner/internal/session.h"
 #include "google/cloud/spanner/internal/session_pool.h"
 #include "google/cloud/spanner/internal/spanner_stub.h"
@@ -26,6 +27,7 @@
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/background_threads.h"
 #include "google/cloud/backoff_policy.h"
+#include "google/cloud/future.h"
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
 #include <google/spanner/v1/spanner.pb.h>
@@ -67,7 +69,8 @@ std::shared_ptr<ConnectionImpl> MakeConnection(
  * Spanner instance. See `MakeConnection()` for a factory function that creates
  * and returns instances of this class.
  */
-class ConnectionImpl : public spanner::Connection {
+class ConnectionImpl : public spanner::Connection,
+                       public std::enable_shared_from_this<ConnectionImpl> {
  public:
   spanner::RowStream Read(ReadParams) override;
   StatusOr<std::vector<spanner::ReadPartition>> PartitionRead(
@@ -86,6 +89,21 @@ class ConnectionImpl : public spanner::Connection {
   StatusOr<spanner::CommitResult> Commit(CommitParams) override;
   Status Rollback(RollbackParams) override;
 
+  /**
+   * The asynchronous operations run on the connection's background threads.
+   *
+   * The underlying RPCs are streaming reads (or, for commits, a sequence of
+   * unary calls with session allocation and retries), they are executed by
+   * the same code as the synchronous functions. The returned futures are
+   * satisfied once the first results (or the commit response) are received.
+   * Applications that start many concurrent operations should increase the
+   * number of background threads, see
+   * `ConnectionOptions::set_background_thread_pool_size()`.
+   */
+  future<spanner::RowStream> AsyncRead(ReadParams) override;
+  future<spanner::RowStream> AsyncExecuteQuery(SqlParams) override;
+  future<StatusOr<spanner::CommitResult>> AsyncCommit(CommitParams) override;
+
  private:
   // Only the factory method can construct instances of this class.
   friend std::shared_ptr<ConnectionImpl> MakeConnection(
@@ -194,6 +212,7 @@ class ConnectionImpl : public spanner::Connection {
   std::shared_ptr<SessionPool> session_pool_;
   bool rpc_stream_tracing_enabled_ = false;
   TracingOptions tracing_options_;
+  PrefetchOptions prefetch_options_;
 };
 
 }  // namespace SPANNER_CLIENT_NS
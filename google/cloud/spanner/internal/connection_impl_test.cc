@@ -348,6 +348,49 @@ TEST(ConnectionImplTest, ReadSuccess) {
   EXPECT_EQ(row_number, expected.size());
 }
 
+TEST(ConnectionImplTest, AsyncReadSuccess) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+
+  auto db =
+      spanner::Database("dummy_project", "dummy_instance", "dummy_database_id");
+  auto conn = MakeConnection(
+      db, {mock},
+      spanner::ConnectionOptions{grpc::InsecureChannelCredentials()});
+  EXPECT_CALL(*mock, BatchCreateSessions(_, HasDatabase(db)))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+
+  auto constexpr kText = R"pb(
+    metadata: {
+      row_type: {
+        fields: {
+          name: "UserId",
+          type: { code: INT64 }
+        }
+      }
+    }
+    values: { string_value: "12" }
+    values: { string_value: "42" }
+  )pb";
+  EXPECT_CALL(*mock, StreamingRead(_, _))
+      .WillOnce(Return(ByMove(MakeReader({kText}))));
+
+  auto f = conn->AsyncRead(
+      {MakeSingleUseTransaction(spanner::Transaction::ReadOnlyOptions()),
+       "table",
+       spanner::KeySet::All(),
+       {"UserId"}});
+  auto rows = f.get();
+  using RowType = std::tuple<std::int64_t>;
+  auto expected = std::vector<RowType>{RowType(12), RowType(42)};
+  int row_number = 0;
+  for (auto& row : spanner::StreamOf<RowType>(rows)) {
+    EXPECT_STATUS_OK(row);
+    EXPECT_EQ(*row, expected[row_number]);
+    ++row_number;
+  }
+  EXPECT_EQ(row_number, expected.size());
+}
+
 TEST(ConnectionImplTest, ReadPermanentFailure) {
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
 
@@ -1847,6 +1890,31 @@ TEST(ConnectionImplTest, CommitCommitIdempotentTransientSuccess) {
   EXPECT_EQ(commit_timestamp, commit->commit_timestamp);
 }
 
+TEST(ConnectionImplTest, AsyncCommitSuccess) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+
+  auto db =
+      spanner::Database("dummy_project", "dummy_instance", "dummy_database_id");
+  auto conn = MakeConnection(
+      db, {mock},
+      spanner::ConnectionOptions{grpc::InsecureChannelCredentials()});
+  EXPECT_CALL(*mock, BatchCreateSessions(_, HasDatabase(db)))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto const commit_timestamp =
+      spanner::MakeTimestamp(std::chrono::system_clock::from_time_t(123))
+          .value();
+  EXPECT_CALL(*mock, Commit(_, AllOf(HasSession("test-session-name"),
+                                     HasNakedTransactionId("test-txn-id"))))
+      .WillOnce(Return(MakeCommitResponse(commit_timestamp)));
+
+  auto txn = spanner::MakeReadWriteTransaction();
+  SetTransactionId(txn, "test-txn-id");
+
+  auto commit = conn->AsyncCommit({txn}).get();
+  EXPECT_STATUS_OK(commit);
+  EXPECT_EQ(commit_timestamp, commit->commit_timestamp);
+}
+
 TEST(ConnectionImplTest, CommitSuccessWithTransactionId) {
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
 
@@ -1917,19 +1985,15 @@ TEST(ConnectionImplTest, RollbackGetSessionFailure) {
                                  HasSubstr("uh-oh in GetSession")));
 }
 
-TEST(ConnectionImplTest, RollbackBeginTransaction) {
+TEST(ConnectionImplTest, RollbackBeforeBegin) {
   auto db = spanner::Database("project", "instance", "database");
-  std::string const session_name = "test-session-name";
-  std::string const transaction_id = "RollbackBeginTransaction";
 
+  // The transaction has not begun, so there is nothing to roll back.
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
-  EXPECT_CALL(*mock, BatchCreateSessions(_, HasDatabase(db)))
-      .WillOnce(Return(MakeSessionsResponse({session_name})));
-  EXPECT_CALL(*mock, BeginTransaction(_, _))
-      .WillOnce(Return(MakeTestTransaction(transaction_id)));
-  EXPECT_CALL(*mock, Rollback(_, AllOf(HasSession(session_name),
-                                       HasNakedTransactionId(transaction_id))))
-      .WillOnce(Return(Status()));
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _)).Times(0);
+  EXPECT_CALL(*mock, BeginTransaction(_, _)).Times(0);
+  EXPECT_CALL(*mock, Rollback(_, _)).Times(0);
+  EXPECT_CALL(*mock, ExecuteStreamingSql(_, _)).Times(0);
 
   auto conn = MakeConnection(
       db, {mock},
@@ -1937,6 +2001,12 @@ TEST(ConnectionImplTest, RollbackBeginTransaction) {
   auto txn = spanner::MakeReadWriteTransaction();
   auto rollback = conn->Rollback({txn});
   EXPECT_STATUS_OK(rollback);
+
+  // The transaction cannot be used after the rollback.
+  auto rows = conn->ExecuteQuery({txn, spanner::SqlStatement("SELECT 1")});
+  auto row = rows.begin();
+  ASSERT_NE(row, rows.end());
+  EXPECT_THAT(*row, StatusIs(StatusCode::kFailedPrecondition));
 }
 
 TEST(ConnectionImplTest, RollbackSingleUseTransaction) {
@@ -0,0 +1,253 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/fault_injection_spanner_stub.h"
+#include "absl/memory/memory.h"
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace spanner_proto = ::google::spanner::v1;
+using ::google::cloud::internal::FaultInjector;
+
+namespace {
+
+using PartialResultSetReader =
+    grpc::ClientReaderInterface<spanner_proto::PartialResultSet>;
+
+/**
+ * Breaks a streaming read, or fails it before it starts.
+ *
+ * A broken stream cancels the call, discards any responses already in
+ * flight, and then reports the injected error from `Finish()`.
+ */
+class FaultInjectionReader : public PartialResultSetReader {
+ public:
+  FaultInjectionReader(grpc::ClientContext& context,
+                       std::unique_ptr<PartialResultSetReader> child,
+                       std::shared_ptr<FaultInjector> injector,
+                       Status injected)
+      : context_(context),
+        child_(std::move(child)),
+        injector_(std::move(injector)),
+        injected_(std::move(injected)) {}
+
+  bool Read(spanner_proto::PartialResultSet* msg) override {
+    if (!child_ || !injected_.ok()) return false;
+    if (!injector_->NextStreamReset()) return child_->Read(msg);
+    injected_ = injector_->StreamResetError("Read");
+    context_.TryCancel();
+    spanner_proto::PartialResultSet discard;
+    while (child_->Read(&discard)) continue;
+    return false;
+  }
+
+  bool NextMessageSize(std::uint32_t* sz) override {
+    if (!child_ || !injected_.ok()) return false;
+    return child_->NextMessageSize(sz);
+  }
+
+  grpc::Status Finish() override {
+    if (child_) {
+      auto status = child_->Finish();
+      if (injected_.ok()) return status;
+    }
+    return grpc::Status(static_cast<grpc::StatusCode>(injected_.code()),
+                        injected_.message());
+  }
+
+  void WaitForInitialMetadata() override {
+    if (child_) child_->WaitForInitialMetadata();
+  }
+
+ private:
+  grpc::ClientContext& context_;
+  std::unique_ptr<PartialResultSetReader> child_;
+  std::shared_ptr<FaultInjector> injector_;
+  Status injected_;
+};
+
+template <typename Call>
+std::unique_ptr<PartialResultSetReader> InjectStream(
+    std::shared_ptr<FaultInjector> const& injector,
+    grpc::ClientContext& context, char const* where, Call&& call) {
+  auto const delay = injector->NextLatency();
+  if (delay.count() != 0) std::this_thread::sleep_for(delay);
+  auto status = injector->NextError(where);
+  if (!status.ok()) {
+    return absl::make_unique<FaultInjectionReader>(context, nullptr, injector,
+                                                   std::move(status));
+  }
+  return absl::make_unique<FaultInjectionReader>(context, call(), injector,
+                                                 Status{});
+}
+
+}  // namespace
+
+StatusOr<spanner_proto::Session> FaultInjectionSpannerStub::CreateSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::CreateSessionRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->CreateSession(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::BatchCreateSessionsResponse>
+FaultInjectionSpannerStub::BatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->BatchCreateSessions(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    spanner_proto::BatchCreateSessionsResponse>>
+FaultInjectionSpannerStub::AsyncBatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncBatchCreateSessions(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::Session> FaultInjectionSpannerStub::GetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->GetSession(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::ListSessionsResponse>
+FaultInjectionSpannerStub::ListSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::ListSessionsRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ListSessions(client_context, request);
+  });
+}
+
+Status FaultInjectionSpannerStub::DeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->DeleteSession(client_context, request);
+  });
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+FaultInjectionSpannerStub::AsyncDeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncDeleteSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ResultSet> FaultInjectionSpannerStub::ExecuteSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ExecuteSql(client_context, request);
+  });
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::ResultSet>>
+FaultInjectionSpannerStub::AsyncExecuteSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncExecuteSql(client_context, request, cq);
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+FaultInjectionSpannerStub::ExecuteStreamingSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return InjectStream(injector_, client_context, __func__, [&] {
+    return child_->ExecuteStreamingSql(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::ExecuteBatchDmlResponse>
+FaultInjectionSpannerStub::ExecuteBatchDml(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteBatchDmlRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->ExecuteBatchDml(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+FaultInjectionSpannerStub::StreamingRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::ReadRequest const& request) {
+  return InjectStream(injector_, client_context, __func__, [&] {
+    return child_->StreamingRead(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::Transaction>
+FaultInjectionSpannerStub::BeginTransaction(
+    grpc::ClientContext& client_context,
+    spanner_proto::BeginTransactionRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->BeginTransaction(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::CommitResponse> FaultInjectionSpannerStub::Commit(
+    grpc::ClientContext& client_context,
+    spanner_proto::CommitRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->Commit(client_context, request);
+  });
+}
+
+Status FaultInjectionSpannerStub::Rollback(
+    grpc::ClientContext& client_context,
+    spanner_proto::RollbackRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->Rollback(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::PartitionResponse>
+FaultInjectionSpannerStub::PartitionQuery(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionQueryRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->PartitionQuery(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::PartitionResponse>
+FaultInjectionSpannerStub::PartitionRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionReadRequest const& request) {
+  return injector_->Run(__func__, [&] {
+    return child_->PartitionRead(client_context, request);
+  });
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,112 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/fault_injection_spanner_stub.h"
+#include "google/cloud/spanner/testing/mock_spanner_stub.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using ::google::cloud::internal::FaultInjector;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::HasSubstr;
+using ::testing::Return;
+
+class MockGrpcReader
+    : public ::grpc::ClientReaderInterface<spanner_proto::PartialResultSet> {
+ public:
+  MOCK_METHOD1(Read, bool(spanner_proto::PartialResultSet*));
+  MOCK_METHOD1(NextMessageSize, bool(std::uint32_t*));
+  MOCK_METHOD0(Finish, grpc::Status());
+  MOCK_METHOD0(WaitForInitialMetadata, void());
+};
+
+std::shared_ptr<FaultInjector> MakeInjector(FaultInjectionOptions options) {
+  return std::make_shared<FaultInjector>(std::move(options));
+}
+
+TEST(FaultInjectionSpannerStubTest, Disabled) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, Commit(_, _))
+      .WillOnce(Return(make_status_or(spanner_proto::CommitResponse{})));
+  FaultInjectionSpannerStub stub(mock, MakeInjector(FaultInjectionOptions{}));
+  grpc::ClientContext context;
+  EXPECT_STATUS_OK(stub.Commit(context, spanner_proto::CommitRequest{}));
+}
+
+TEST(FaultInjectionSpannerStubTest, InjectError) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BeginTransaction(_, _)).Times(0);
+  FaultInjectionSpannerStub stub(
+      mock, MakeInjector(FaultInjectionOptions{}.set_error_rate(1.0)));
+  grpc::ClientContext context;
+  EXPECT_THAT(
+      stub.BeginTransaction(context, spanner_proto::BeginTransactionRequest{}),
+      StatusIs(StatusCode::kUnavailable, HasSubstr("BeginTransaction")));
+}
+
+TEST(FaultInjectionSpannerStubTest, StreamingReadError) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, StreamingRead(_, _)).Times(0);
+  FaultInjectionSpannerStub stub(
+      mock, MakeInjector(FaultInjectionOptions{}.set_error_rate(1.0)));
+  grpc::ClientContext context;
+  auto reader = stub.StreamingRead(context, spanner_proto::ReadRequest{});
+  spanner_proto::PartialResultSet response;
+  EXPECT_FALSE(reader->Read(&response));
+  auto status = reader->Finish();
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+}
+
+TEST(FaultInjectionSpannerStubTest, ExecuteStreamingSqlReset) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, ExecuteStreamingSql(_, _))
+      .WillOnce([](grpc::ClientContext&,
+                   spanner_proto::ExecuteSqlRequest const&) {
+        auto reader = absl::make_unique<MockGrpcReader>();
+        // The decorator drains the stream after cancelling it.
+        EXPECT_CALL(*reader, Read(_))
+            .WillOnce(Return(true))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*reader, Finish())
+            .WillOnce(Return(grpc::Status(grpc::StatusCode::CANCELLED, "")));
+        return reader;
+      });
+  FaultInjectionSpannerStub stub(
+      mock, MakeInjector(FaultInjectionOptions{}.set_stream_reset_rate(1.0)));
+  grpc::ClientContext context;
+  auto reader =
+      stub.ExecuteStreamingSql(context, spanner_proto::ExecuteSqlRequest{});
+  spanner_proto::PartialResultSet response;
+  EXPECT_FALSE(reader->Read(&response));
+  auto status = reader->Finish();
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+  EXPECT_THAT(status.error_message(), HasSubstr("Read"));
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
@@ -16,6 +16,7 @@
 #include "google/cloud/spanner/internal/instance_admin_logging.h"
 #include "google/cloud/spanner/internal/instance_admin_metadata.h"
 #include "google/cloud/grpc_error_delegate.h"
+#include "google/cloud/internal/channel_cache.h"
 #include "google/cloud/log.h"
 #include <google/longrunning/operations.grpc.pb.h>
 
@@ -174,9 +175,9 @@ class DefaultInstanceAdminStub : public InstanceAdminStub {
 std::shared_ptr<InstanceAdminStub> CreateDefaultInstanceAdminStub(
     spanner::ConnectionOptions options) {
   options = EmulatorOverrides(std::move(options));
-  auto channel =
-      grpc::CreateCustomChannel(options.endpoint(), options.credentials(),
-                                options.CreateChannelArguments());
+  auto channel = google::cloud::internal::CreateCustomChannel(
+      options.endpoint(), options.credentials(),
+      options.CreateChannelArguments(), options.channel_cache_enabled());
   auto spanner_grpc_stub = gcsa::InstanceAdmin::NewStub(channel);
   auto longrunning_grpc_stub =
       google::longrunning::Operations::NewStub(channel);
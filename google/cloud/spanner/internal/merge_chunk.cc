@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/merge_chunk.h"
+#include <iterator>
+#include <string>
+#include <utility>
 
 namespace google {
 namespace cloud {
@@ -73,6 +76,79 @@ Status MergeChunk(google::protobuf::Value& value,  // NOLINT(misc-no-recursion)
   return Status(StatusCode::kUnknown, "unknown Value type");
 }
 
+StatusOr<google::protobuf::Value> MergeChunks(  // NOLINT(misc-no-recursion)
+    std::vector<google::protobuf::Value> chunks) {
+  if (chunks.empty()) return google::protobuf::Value{};
+  if (chunks.size() == 1) return std::move(chunks.front());
+
+  auto const kind = chunks.front().kind_case();
+  for (auto const& c : chunks) {
+    if (c.kind_case() != kind) {
+      return Status(StatusCode::kInvalidArgument, "mismatched types");
+    }
+  }
+  switch (kind) {
+    case google::protobuf::Value::kBoolValue:
+    case google::protobuf::Value::kNumberValue:
+    case google::protobuf::Value::kNullValue:
+    case google::protobuf::Value::kStructValue:
+      return Status(StatusCode::kInvalidArgument, "invalid type");
+
+    case google::protobuf::Value::kStringValue: {
+      std::size_t size = 0;
+      for (auto const& c : chunks) size += c.string_value().size();
+      std::string merged;
+      merged.reserve(size);
+      for (auto const& c : chunks) merged += c.string_value();
+      google::protobuf::Value value;
+      value.set_string_value(std::move(merged));
+      return value;
+    }
+
+    case google::protobuf::Value::kListValue: {
+      google::protobuf::Value value;
+      auto& values = *value.mutable_list_value()->mutable_values();
+      // The fragments of the last element seen so far, which may continue in
+      // the following chunks.
+      std::vector<google::protobuf::Value> open;
+      auto close = [&open, &values]() -> Status {
+        if (open.empty()) return {};
+        auto merged = MergeChunks(std::move(open));
+        open.clear();
+        if (!merged) return std::move(merged).status();
+        *values.Add() = *std::move(merged);
+        return {};
+      };
+      for (auto& c : chunks) {
+        auto& list = *c.mutable_list_value()->mutable_values();
+        if (list.empty()) continue;  // There's nothing to merge.
+        auto it = list.begin();
+        // Only strings and lists are merged with the first element of the
+        // next chunk, as in `MergeChunk()`.
+        if (!open.empty() &&
+            (open.front().kind_case() ==
+                 google::protobuf::Value::kStringValue ||
+             open.front().kind_case() == google::protobuf::Value::kListValue)) {
+          open.push_back(std::move(*it++));
+        }
+        if (it == list.end()) continue;
+        auto status = close();
+        if (!status.ok()) return status;
+        auto last = std::prev(list.end());
+        for (; it != last; ++it) *values.Add() = std::move(*it);
+        open.push_back(std::move(*last));
+      }
+      auto status = close();
+      if (!status.ok()) return status;
+      return value;
+    }
+
+    default:
+      break;
+  }
+  return Status(StatusCode::kUnknown, "unknown Value type");
+}
+
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner_internal
 }  // namespace cloud
@@ -17,7 +17,9 @@
 
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
 #include <google/protobuf/struct.pb.h>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -47,6 +49,17 @@ inline namespace SPANNER_CLIENT_NS {
 Status MergeChunk(google::protobuf::Value& value,
                   google::protobuf::Value&& chunk);
 
+/**
+ * Merges all the @p chunks of a value, or returns an error.
+ *
+ * The result is the same as calling `MergeChunk()` with each chunk in order,
+ * but large values split across many chunks are assembled in linear time: the
+ * fragments of each string are concatenated once, into a string with enough
+ * capacity for all of them, instead of growing the string with each chunk.
+ */
+StatusOr<google::protobuf::Value> MergeChunks(
+    std::vector<google::protobuf::Value> chunks);
+
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner_internal
 }  // namespace cloud
@@ -15,6 +15,9 @@
 #include "google/cloud/spanner/internal/merge_chunk.h"
 #include "google/cloud/spanner/value.h"
 #include <benchmark/benchmark.h>
+#include <iterator>
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -115,6 +118,70 @@ void BM_MergeChunkListsOfListOfString(benchmark::State& state) {
 }
 BENCHMARK(BM_MergeChunkListsOfListOfString);
 
+// Splits a value of @p size bytes into @p count string chunks.
+std::vector<google::protobuf::Value> MakeStringChunks(std::size_t size,
+                                                      std::size_t count) {
+  std::vector<google::protobuf::Value> chunks;
+  for (std::size_t i = 0; i != count; ++i) {
+    chunks.push_back(MakeProtoValue(std::string(size / count, 'x')));
+  }
+  return chunks;
+}
+
+// Merges a large BYTES (or STRING) value, such as a 16MiB value split into 256
+// chunks, by appending each chunk as it arrives.
+void BM_MergeChunkLargeString(benchmark::State& state) {
+  auto const chunks =
+      MakeStringChunks(static_cast<std::size_t>(state.range(0)),
+                       static_cast<std::size_t>(state.range(1)));
+  for (auto _ : state) {
+    auto copy = chunks;
+    auto value = std::move(copy.front());
+    for (auto i = std::next(copy.begin()); i != copy.end(); ++i) {
+      benchmark::DoNotOptimize(MergeChunk(value, std::move(*i)));
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MergeChunkLargeString)
+    ->Args({10 * 1000 * 1000, 100})
+    ->Args({16 * 1024 * 1024, 256})
+    ->Args({64 * 1024 * 1024, 1024});
+
+// Merges the same values as `BM_MergeChunkLargeString`, but accumulates all
+// the chunks before merging them.
+void BM_MergeChunksLargeString(benchmark::State& state) {
+  auto const chunks =
+      MakeStringChunks(static_cast<std::size_t>(state.range(0)),
+                       static_cast<std::size_t>(state.range(1)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(MergeChunks(chunks));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MergeChunksLargeString)
+    ->Args({10 * 1000 * 1000, 100})
+    ->Args({16 * 1024 * 1024, 256})
+    ->Args({64 * 1024 * 1024, 1024});
+
+// Merges an ARRAY<BYTES> whose last element is large and split across many
+// chunks.
+void BM_MergeChunksLargeListElement(benchmark::State& state) {
+  auto const size = static_cast<std::size_t>(state.range(0));
+  auto const count = static_cast<std::size_t>(state.range(1));
+  auto const fragment = std::string(size / count, 'x');
+  std::vector<google::protobuf::Value> chunks;
+  for (std::size_t i = 0; i != count; ++i) {
+    chunks.push_back(MakeProtoValue(std::vector<std::string>{fragment}));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(MergeChunks(chunks));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MergeChunksLargeListElement)->Args({16 * 1024 * 1024, 256});
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner_internal
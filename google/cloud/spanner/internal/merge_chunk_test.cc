@@ -19,6 +19,7 @@
 #include "google/cloud/testing_util/status_matchers.h"
 #include <google/protobuf/struct.pb.h>
 #include <gmock/gmock.h>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -221,6 +222,78 @@ TEST(MergeChunk, CannotMergeStruct) {
                                testing::HasSubstr("invalid type")));
 }
 
+TEST(MergeChunks, LargeString) {
+  std::string expected;
+  std::vector<google::protobuf::Value> chunks;
+  for (int i = 0; i != 100; ++i) {
+    auto fragment = std::string(1000, static_cast<char>('a' + i % 26));
+    expected += fragment;
+    chunks.push_back(MakeProtoValue(std::move(fragment)));
+  }
+  auto merged = MergeChunks(std::move(chunks));
+  ASSERT_STATUS_OK(merged);
+  EXPECT_THAT(*merged, IsProtoEqual(MakeProtoValue(expected)));
+}
+
+// ["a", "b1"], ["b2"], [], ["b3", "c"] => ["a", "b1b2b3", "c"]
+TEST(MergeChunks, ListElementSpansManyChunks) {
+  google::protobuf::Value empty_list;
+  empty_list.mutable_list_value();
+  std::vector<google::protobuf::Value> chunks{
+      MakeProtoValue(std::vector<std::string>{"a", "b1"}),
+      MakeProtoValue(std::vector<std::string>{"b2"}), empty_list,
+      MakeProtoValue(std::vector<std::string>{"b3", "c"})};
+  auto merged = MergeChunks(std::move(chunks));
+  ASSERT_STATUS_OK(merged);
+  EXPECT_THAT(*merged, IsProtoEqual(MakeProtoValue(
+                           std::vector<std::string>{"a", "b1b2b3", "c"})));
+}
+
+TEST(MergeChunks, SameAsMergeChunk) {
+  using Strings = std::vector<std::string>;
+  std::vector<std::vector<google::protobuf::Value>> cases{
+      {MakeProtoValue("foo"), MakeProtoValue(""), MakeProtoValue("bar")},
+      {MakeProtoValue(std::vector<double>{2, 3}),
+       MakeProtoValue(std::vector<double>{4}),
+       MakeProtoValue(std::vector<double>{5, 6})},
+      {MakeProtoValue(std::vector<Strings>{{"a"}, {"b", "c"}}),
+       MakeProtoValue(std::vector<Strings>{{"d"}}),
+       MakeProtoValue(std::vector<Strings>{{"e", "f"}, {"g"}})},
+  };
+  for (auto& chunks : cases) {
+    auto expected = chunks.front();
+    for (auto i = std::next(chunks.begin()); i != chunks.end(); ++i) {
+      ASSERT_STATUS_OK(MergeChunk(expected, google::protobuf::Value(*i)));
+    }
+    auto merged = MergeChunks(std::move(chunks));
+    ASSERT_STATUS_OK(merged);
+    EXPECT_THAT(*merged, IsProtoEqual(expected));
+  }
+}
+
+TEST(MergeChunks, ErrorMismatchedTypes) {
+  std::vector<google::protobuf::Value> chunks{
+      MakeProtoValue(std::vector<std::string>{"hello"}),
+      MakeProtoValue("world")};
+  EXPECT_THAT(MergeChunks(std::move(chunks)),
+              StatusIs(Not(StatusCode::kOk), HasSubstr("mismatched types")));
+}
+
+TEST(MergeChunks, ErrorMismatchedElementTypes) {
+  std::vector<google::protobuf::Value> chunks{
+      MakeProtoValue(std::vector<std::string>{"hello"}),
+      MakeProtoValue(std::vector<double>{42})};
+  EXPECT_THAT(MergeChunks(std::move(chunks)),
+              StatusIs(Not(StatusCode::kOk), HasSubstr("mismatched types")));
+}
+
+TEST(MergeChunks, CannotMergeNumbers) {
+  std::vector<google::protobuf::Value> chunks{MakeProtoValue(1.0),
+                                              MakeProtoValue(2.0)};
+  EXPECT_THAT(MergeChunks(std::move(chunks)),
+              StatusIs(Not(StatusCode::kOk), HasSubstr("invalid type")));
+}
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner_internal
@@ -24,11 +24,27 @@ inline namespace SPANNER_CLIENT_NS {
 
 namespace spanner_proto = ::google::spanner::v1;
 
+namespace {
+
+bool IsReadWrite(spanner_proto::TransactionOptions const& options) {
+  return options.has_read_write() || options.has_partitioned_dml();
+}
+
+// Requests in a transaction started by an earlier request only have its id,
+// the transaction type is not known.
+bool IsReadWrite(spanner_proto::TransactionSelector const& selector) {
+  return selector.has_begin() && IsReadWrite(selector.begin());
+}
+
+}  // namespace
+
 MetadataSpannerStub::MetadataSpannerStub(std::shared_ptr<SpannerStub> child,
-                                         std::string resource_prefix_header)
+                                         std::string resource_prefix_header,
+                                         bool route_to_leader)
     : child_(std::move(child)),
       api_client_header_(google::cloud::internal::ApiClientHeader()),
-      resource_prefix_header_(std::move(resource_prefix_header)) {}
+      resource_prefix_header_(std::move(resource_prefix_header)),
+      route_to_leader_(route_to_leader) {}
 
 StatusOr<spanner_proto::Session> MetadataSpannerStub::CreateSession(
     grpc::ClientContext& client_context,
@@ -89,7 +105,8 @@ MetadataSpannerStub::AsyncDeleteSession(
 StatusOr<spanner_proto::ResultSet> MetadataSpannerStub::ExecuteSql(
     grpc::ClientContext& client_context,
     spanner_proto::ExecuteSqlRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=" + request.session(),
+              IsReadWrite(request.transaction()));
   return child_->ExecuteSql(client_context, request);
 }
 
@@ -99,7 +116,8 @@ MetadataSpannerStub::AsyncExecuteSql(
     grpc::ClientContext& client_context,
     spanner_proto::ExecuteSqlRequest const& request,
     grpc::CompletionQueue* cq) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=" + request.session(),
+              IsReadWrite(request.transaction()));
   return child_->AsyncExecuteSql(client_context, request, cq);
 }
 
@@ -107,7 +125,8 @@ std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
 MetadataSpannerStub::ExecuteStreamingSql(
     grpc::ClientContext& client_context,
     spanner_proto::ExecuteSqlRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=" + request.session(),
+              IsReadWrite(request.transaction()));
   return child_->ExecuteStreamingSql(client_context, request);
 }
 
@@ -115,35 +134,37 @@ StatusOr<spanner_proto::ExecuteBatchDmlResponse>
 MetadataSpannerStub::ExecuteBatchDml(
     grpc::ClientContext& client_context,
     spanner_proto::ExecuteBatchDmlRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=" + request.session(), true);
   return child_->ExecuteBatchDml(client_context, request);
 }
 
 std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
 MetadataSpannerStub::StreamingRead(grpc::ClientContext& client_context,
                                    spanner_proto::ReadRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=" + request.session(),
+              IsReadWrite(request.transaction()));
   return child_->StreamingRead(client_context, request);
 }
 
 StatusOr<spanner_proto::Transaction> MetadataSpannerStub::BeginTransaction(
     grpc::ClientContext& client_context,
     spanner_proto::BeginTransactionRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=" + request.session(),
+              IsReadWrite(request.options()));
   return child_->BeginTransaction(client_context, request);
 }
 
 StatusOr<spanner_proto::CommitResponse> MetadataSpannerStub::Commit(
     grpc::ClientContext& client_context,
     spanner_proto::CommitRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=" + request.session(), true);
   return child_->Commit(client_context, request);
 }
 
 Status MetadataSpannerStub::Rollback(
     grpc::ClientContext& client_context,
     spanner_proto::RollbackRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=" + request.session(), true);
   return child_->Rollback(client_context, request);
 }
 
@@ -162,10 +183,14 @@ StatusOr<spanner_proto::PartitionResponse> MetadataSpannerStub::PartitionRead(
 }
 
 void MetadataSpannerStub::SetMetadata(grpc::ClientContext& context,
-                                      std::string const& request_params) {
+                                      std::string const& request_params,
+                                      bool read_write) {
   context.AddMetadata("x-goog-request-params", request_params);
   context.AddMetadata("x-goog-api-client", api_client_header_);
   context.AddMetadata("google-cloud-resource-prefix", resource_prefix_header_);
+  if (read_write && route_to_leader_) {
+    context.AddMetadata("x-goog-spanner-route-to-leader", "true");
+  }
 }
 
 }  // namespace SPANNER_CLIENT_NS
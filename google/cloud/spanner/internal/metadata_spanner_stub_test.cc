@@ -26,8 +26,13 @@ namespace spanner_internal {
 inline namespace SPANNER_CLIENT_NS {
 namespace {
 
+using ::google::cloud::testing_util::GetMetadata;
 using ::google::cloud::testing_util::IsContextMDValid;
 using ::testing::_;
+using ::testing::Contains;
+using ::testing::Key;
+using ::testing::Not;
+using ::testing::Pair;
 namespace spanner_proto = ::google::spanner::v1;
 
 // This ugly macro and the supporting template member function refactor most
@@ -259,6 +264,67 @@ TEST_F(MetadataSpannerStubTest, PartitionRead) {
   SESSION_TEST(PartitionRead, spanner_proto::PartitionReadRequest);
 }
 
+TEST_F(MetadataSpannerStubTest, RouteToLeader) {
+  auto const leader = Pair("x-goog-spanner-route-to-leader", "true");
+  EXPECT_CALL(*mock_, Commit(_, _))
+      .WillOnce([&leader](grpc::ClientContext& context,
+                          spanner_proto::CommitRequest const&) {
+        EXPECT_THAT(GetMetadata(context), Contains(leader));
+        return TransientError();
+      });
+  EXPECT_CALL(*mock_, ExecuteSql(_, _))
+      .WillOnce([&leader](grpc::ClientContext& context,
+                          spanner_proto::ExecuteSqlRequest const&) {
+        EXPECT_THAT(GetMetadata(context), Contains(leader));
+        return TransientError();
+      })
+      .WillOnce([](grpc::ClientContext& context,
+                   spanner_proto::ExecuteSqlRequest const&) {
+        EXPECT_THAT(GetMetadata(context),
+                    Not(Contains(Key("x-goog-spanner-route-to-leader"))));
+        return TransientError();
+      });
+
+  MetadataSpannerStub stub(mock_, db_.FullName(), true);
+  {
+    grpc::ClientContext context;
+    spanner_proto::CommitRequest request;
+    ExpectTransientError(stub.Commit(context, request));
+  }
+  {
+    grpc::ClientContext context;
+    spanner_proto::ExecuteSqlRequest request;
+    request.mutable_transaction()->mutable_begin()->mutable_read_write();
+    ExpectTransientError(stub.ExecuteSql(context, request));
+  }
+  {
+    // Stale reads are served by the nearest replica.
+    grpc::ClientContext context;
+    spanner_proto::ExecuteSqlRequest request;
+    request.mutable_transaction()
+        ->mutable_single_use()
+        ->mutable_read_only()
+        ->mutable_max_staleness()
+        ->set_seconds(10);
+    ExpectTransientError(stub.ExecuteSql(context, request));
+  }
+}
+
+TEST_F(MetadataSpannerStubTest, RouteToLeaderDisabled) {
+  EXPECT_CALL(*mock_, Commit(_, _))
+      .WillOnce([](grpc::ClientContext& context,
+                   spanner_proto::CommitRequest const&) {
+        EXPECT_THAT(GetMetadata(context),
+                    Not(Contains(Key("x-goog-spanner-route-to-leader"))));
+        return TransientError();
+      });
+
+  MetadataSpannerStub stub(mock_, db_.FullName());
+  grpc::ClientContext context;
+  spanner_proto::CommitRequest request;
+  ExpectTransientError(stub.Commit(context, request));
+}
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner_internal
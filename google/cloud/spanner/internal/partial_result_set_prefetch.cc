@@ -0,0 +1,127 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/partial_result_set_prefetch.h"
+#include "google/cloud/internal/getenv.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace {
+
+void SizeFromEnv(char const* name, std::size_t& value) {
+  auto v = google::cloud::internal::GetEnv(name);
+  if (!v) return;
+  char* end;
+  auto const n = std::strtoull(v->c_str(), &end, 10);
+  if (end == v->c_str() || *end != '\0') return;
+  value = static_cast<std::size_t>(n);
+}
+
+}  // namespace
+
+PrefetchOptions PrefetchOptionsFromEnv() {
+  PrefetchOptions options;
+  SizeFromEnv("GOOGLE_CLOUD_CPP_SPANNER_PREFETCH_MESSAGES",
+              options.max_messages);
+  SizeFromEnv("GOOGLE_CLOUD_CPP_SPANNER_PREFETCH_BYTES", options.max_bytes);
+  return options;
+}
+
+std::unique_ptr<PartialResultSetReader> MaybePrefetch(
+    std::unique_ptr<PartialResultSetReader> reader,
+    PrefetchOptions const& options) {
+  if (options.max_messages == 0) return reader;
+  return absl::make_unique<PartialResultSetPrefetch>(
+      std::move(reader), options.max_messages, options.max_bytes);
+}
+
+PartialResultSetPrefetch::PartialResultSetPrefetch(
+    std::unique_ptr<PartialResultSetReader> child, std::size_t max_messages,
+    std::size_t max_bytes)
+    : child_(std::move(child)),
+      max_messages_((std::max)(max_messages, std::size_t{1})),
+      max_bytes_(max_bytes),
+      thread_([this] { Run(); }) {}
+
+PartialResultSetPrefetch::~PartialResultSetPrefetch() {
+  if (!thread_.joinable()) return;
+  // The caller abandoned the stream without calling `Finish()`, the thread
+  // may be blocked in `Read()`.
+  child_->TryCancel();
+  Stop();
+}
+
+void PartialResultSetPrefetch::TryCancel() {
+  // Cancelling the RPC is thread-safe, it unblocks any pending `Read()`.
+  child_->TryCancel();
+}
+
+absl::optional<google::spanner::v1::PartialResultSet>
+PartialResultSetPrefetch::Read() {
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [this] { return !buffer_.empty() || done_; });
+  if (buffer_.empty()) return {};
+  auto result = std::move(buffer_.front().message);
+  buffer_bytes_ -= buffer_.front().bytes;
+  buffer_.pop_front();
+  cv_.notify_all();
+  return result;
+}
+
+Status PartialResultSetPrefetch::Finish() {
+  Stop();
+  return child_->Finish();
+}
+
+void PartialResultSetPrefetch::Run() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    cv_.wait(lk, [this] {
+      return stop_ ||
+             (buffer_.size() < max_messages_ && buffer_bytes_ < max_bytes_);
+    });
+    if (stop_) break;
+    lk.unlock();
+    auto result = child_->Read();
+    lk.lock();
+    if (!result) break;
+    auto const bytes = result->ByteSizeLong();
+    buffer_bytes_ += bytes;
+    buffer_.push_back(Buffered{*std::move(result), bytes});
+    cv_.notify_all();
+  }
+  done_ = true;
+  cv_.notify_all();
+}
+
+void PartialResultSetPrefetch::Stop() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
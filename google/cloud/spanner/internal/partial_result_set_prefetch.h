@@ -0,0 +1,103 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_PARTIAL_RESULT_SET_PREFETCH_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_PARTIAL_RESULT_SET_PREFETCH_H
+
+#include "google/cloud/spanner/internal/partial_result_set_reader.h"
+#include "google/cloud/spanner/version.h"
+#include "absl/types/optional.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * A PartialResultSetReader that reads ahead of its caller.
+ *
+ * A background thread reads from the wrapped streaming RPC into a buffer of
+ * up to @p max_messages messages (and, approximately, @p max_bytes bytes), so
+ * the network reads overlap with the decoding of the previous results.
+ *
+ * This wraps a single streaming RPC, below `PartialResultSetResume`. If the
+ * stream fails any buffered messages are discarded with it, and the new
+ * stream resumes from the last message delivered to the caller.
+ */
+class PartialResultSetPrefetch : public PartialResultSetReader {
+ public:
+  PartialResultSetPrefetch(std::unique_ptr<PartialResultSetReader> child,
+                           std::size_t max_messages, std::size_t max_bytes);
+  ~PartialResultSetPrefetch() override;
+
+  void TryCancel() override;
+  absl::optional<google::spanner::v1::PartialResultSet> Read() override;
+  Status Finish() override;
+
+ private:
+  void Run();
+  void Stop();
+
+  struct Buffered {
+    google::spanner::v1::PartialResultSet message;
+    std::size_t bytes;
+  };
+
+  std::unique_ptr<PartialResultSetReader> child_;
+  std::size_t const max_messages_;
+  std::size_t const max_bytes_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Buffered> buffer_;   // GUARDED_BY(mu_)
+  std::size_t buffer_bytes_ = 0;  // GUARDED_BY(mu_)
+  bool done_ = false;  // GUARDED_BY(mu_), the stream has no more messages
+  bool stop_ = false;  // GUARDED_BY(mu_), stop reading the stream
+  std::thread thread_;
+};
+
+/// Configure the read-ahead for streaming reads and queries.
+struct PrefetchOptions {
+  /// The maximum number of buffered messages, 0 disables the read-ahead.
+  std::size_t max_messages = 0;
+  /// The (approximate) maximum number of buffered bytes.
+  std::size_t max_bytes = 16 * 1024 * 1024;
+};
+
+/**
+ * Returns the read-ahead configured via the environment.
+ *
+ * The read-ahead is disabled by default, it is enabled by setting
+ * `GOOGLE_CLOUD_CPP_SPANNER_PREFETCH_MESSAGES`, and optionally
+ * `GOOGLE_CLOUD_CPP_SPANNER_PREFETCH_BYTES`, to a positive integer.
+ */
+PrefetchOptions PrefetchOptionsFromEnv();
+
+/// Returns @p reader, wrapped in a `PartialResultSetPrefetch` if enabled.
+std::unique_ptr<PartialResultSetReader> MaybePrefetch(
+    std::unique_ptr<PartialResultSetReader> reader,
+    PrefetchOptions const& options);
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_PARTIAL_RESULT_SET_PREFETCH_H
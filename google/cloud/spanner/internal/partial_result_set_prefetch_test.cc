@@ -0,0 +1,174 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/partial_result_set_prefetch.h"
+#include "google/cloud/spanner/testing/mock_partial_result_set_reader.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/scoped_environment.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using ::google::cloud::spanner_testing::MockPartialResultSetReader;
+using ::google::cloud::testing_util::ScopedEnvironment;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::Return;
+
+using ReadReturn = absl::optional<spanner_proto::PartialResultSet>;
+
+spanner_proto::PartialResultSet MakeResponse(std::string const& token) {
+  spanner_proto::PartialResultSet response;
+  response.set_resume_token(token);
+  return response;
+}
+
+// Waits until @p counter reaches @p expected, or a (generous) deadline.
+void WaitFor(std::atomic<int> const& counter, int expected) {
+  auto const deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (counter.load() < expected &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+TEST(PartialResultSetPrefetch, ReadsAll) {
+  auto mock = absl::make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*mock, Read())
+      .WillOnce(Return(MakeResponse("t0")))
+      .WillOnce(Return(MakeResponse("t1")))
+      .WillOnce(Return(MakeResponse("t2")))
+      .WillOnce(Return(ReadReturn{}));
+  EXPECT_CALL(*mock, Finish())
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+
+  PartialResultSetPrefetch reader(std::move(mock), 2, 1024 * 1024);
+  for (auto const* token : {"t0", "t1", "t2"}) {
+    auto response = reader.Read();
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(token, response->resume_token());
+  }
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_THAT(reader.Finish(), StatusIs(StatusCode::kUnavailable));
+}
+
+TEST(PartialResultSetPrefetch, BoundedByMessages) {
+  std::atomic<int> reads{0};
+  auto mock = absl::make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*mock, Read()).WillRepeatedly([&reads] {
+    return MakeResponse("t" + std::to_string(reads++));
+  });
+  EXPECT_CALL(*mock, TryCancel());
+  EXPECT_CALL(*mock, Finish()).WillOnce(Return(Status()));
+
+  PartialResultSetPrefetch reader(std::move(mock), 3, 1024 * 1024);
+  WaitFor(reads, 3);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(3, reads.load());
+
+  // Consuming one message makes room for one more.
+  auto response = reader.Read();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ("t0", response->resume_token());
+  WaitFor(reads, 4);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(4, reads.load());
+
+  reader.TryCancel();
+  EXPECT_STATUS_OK(reader.Finish());
+}
+
+TEST(PartialResultSetPrefetch, BoundedByBytes) {
+  std::atomic<int> reads{0};
+  auto mock = absl::make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*mock, Read()).WillRepeatedly([&reads] {
+    return MakeResponse("t" + std::to_string(reads++));
+  });
+  EXPECT_CALL(*mock, TryCancel());
+  EXPECT_CALL(*mock, Finish()).WillOnce(Return(Status()));
+
+  // Any message exceeds the byte limit, but one is always buffered.
+  PartialResultSetPrefetch reader(std::move(mock), 100, 1);
+  WaitFor(reads, 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(1, reads.load());
+
+  reader.TryCancel();
+  EXPECT_STATUS_OK(reader.Finish());
+}
+
+TEST(PartialResultSetPrefetch, DestructorCancels) {
+  std::promise<void> cancelled;
+  auto mock = absl::make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*mock, Read())
+      .WillOnce(Return(MakeResponse("t0")))
+      .WillOnce([&cancelled] {
+        // Block, like a streaming RPC with no data, until cancelled.
+        cancelled.get_future().wait();
+        return ReadReturn{};
+      });
+  EXPECT_CALL(*mock, TryCancel()).WillOnce([&cancelled] {
+    cancelled.set_value();
+  });
+
+  PartialResultSetPrefetch reader(std::move(mock), 10, 1024 * 1024);
+  auto response = reader.Read();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ("t0", response->resume_token());
+}
+
+TEST(PartialResultSetPrefetch, OptionsFromEnv) {
+  {
+    ScopedEnvironment messages("GOOGLE_CLOUD_CPP_SPANNER_PREFETCH_MESSAGES",
+                               absl::nullopt);
+    auto options = PrefetchOptionsFromEnv();
+    EXPECT_EQ(0, options.max_messages);
+    auto reader = MaybePrefetch(
+        absl::make_unique<MockPartialResultSetReader>(), options);
+    EXPECT_EQ(nullptr, dynamic_cast<PartialResultSetPrefetch*>(reader.get()));
+  }
+  {
+    ScopedEnvironment messages("GOOGLE_CLOUD_CPP_SPANNER_PREFETCH_MESSAGES",
+                               "8");
+    ScopedEnvironment bytes("GOOGLE_CLOUD_CPP_SPANNER_PREFETCH_BYTES",
+                            "4096");
+    auto options = PrefetchOptionsFromEnv();
+    EXPECT_EQ(8, options.max_messages);
+    EXPECT_EQ(4096, options.max_bytes);
+  }
+  {
+    ScopedEnvironment messages("GOOGLE_CLOUD_CPP_SPANNER_PREFETCH_MESSAGES",
+                               "lots");
+    EXPECT_EQ(0, PrefetchOptionsFromEnv().max_messages);
+  }
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
@@ -13,7 +13,6 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/partial_result_set_resume.h"
-#include <thread>
 
 namespace google {
 namespace cloud {
@@ -33,17 +32,37 @@ PartialResultSetResume::Read() {
     }
     auto status = Finish();
     if (status.ok()) return {};
+    auto cancelled = [&] {
+      last_status_ = Status(StatusCode::kCancelled,
+                            "Operation cancelled, last error: " +
+                                status.message());
+      return absl::optional<google::spanner::v1::PartialResultSet>{};
+    };
+    if (google::cloud::internal::IsCancelled(cancellation_token_)) {
+      return cancelled();
+    }
     if (idempotency_ == google::cloud::internal::Idempotency::kNonIdempotent ||
         !retry_policy_prototype_->OnFailure(status)) {
       return {};
     }
-    std::this_thread::sleep_for(backoff_policy_prototype_->OnCompletion());
+    if (!google::cloud::internal::SleepUnlessCancelled(
+            cancellation_token_, backoff_policy_prototype_->OnCompletion())) {
+      return cancelled();
+    }
     last_status_.reset();
+    cancel_registration_.Reset();
     child_ = factory_(last_resume_token_);
+    WatchChild();
   } while (!retry_policy_prototype_->IsExhausted());
   return {};
 }
 
+void PartialResultSetResume::WatchChild() {
+  auto* child = child_.get();
+  cancel_registration_ = CancellationRegistration(
+      cancellation_token_, [child] { child->TryCancel(); });
+}
+
 Status PartialResultSetResume::Finish() {
   // Finish() can be called only once, so cache the last result.
   if (last_status_.has_value()) {
@@ -20,6 +20,7 @@
 #include "google/cloud/spanner/retry_policy.h"
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/backoff_policy.h"
+#include "google/cloud/cancellation.h"
 #include "google/cloud/internal/retry_policy.h"
 #include "absl/types/optional.h"
 #include <functional>
@@ -36,6 +37,9 @@ using PartialResultSetReaderFactory =
 
 /**
  * A PartialResultSetReader that resumes the streaming RPC on retryable errors.
+ *
+ * If a `CancellationToken` is current when the reader is created, cancelling
+ * the token cancels the streaming RPC in progress and stops any resumes.
  */
 class PartialResultSetResume : public PartialResultSetReader {
  public:
@@ -47,7 +51,11 @@ class PartialResultSetResume : public PartialResultSetReader {
         idempotency_(idempotency),
         retry_policy_prototype_(std::move(retry_policy)),
         backoff_policy_prototype_(std::move(backoff_policy)),
-        child_(factory_(last_resume_token_)) {}
+        child_(factory_(last_resume_token_)),
+        cancellation_token_(
+            google::cloud::internal::CurrentCancellationToken()) {
+    WatchChild();
+  }
 
   ~PartialResultSetResume() override = default;
 
@@ -56,6 +64,9 @@ class PartialResultSetResume : public PartialResultSetReader {
   Status Finish() override;
 
  private:
+  /// Cancels the current child when the cancellation token is cancelled.
+  void WatchChild();
+
   PartialResultSetReaderFactory factory_;
   google::cloud::internal::Idempotency idempotency_;
   std::unique_ptr<spanner::RetryPolicy> retry_policy_prototype_;
@@ -63,6 +74,8 @@ class PartialResultSetResume : public PartialResultSetReader {
   std::string last_resume_token_;
   std::unique_ptr<PartialResultSetReader> child_;
   absl::optional<Status> last_status_;
+  absl::optional<CancellationToken> cancellation_token_;
+  CancellationRegistration cancel_registration_;
 };
 
 }  // namespace SPANNER_CLIENT_NS
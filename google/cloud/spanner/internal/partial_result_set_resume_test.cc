@@ -15,6 +15,7 @@
 #include "google/cloud/spanner/internal/partial_result_set_resume.h"
 #include "google/cloud/spanner/testing/mock_partial_result_set_reader.h"
 #include "google/cloud/spanner/value.h"
+#include "google/cloud/cancellation.h"
 #include "google/cloud/testing_util/assert_ok.h"
 #include "google/cloud/testing_util/is_proto_equal.h"
 #include "google/cloud/testing_util/status_matchers.h"
@@ -297,6 +298,36 @@ TEST(PartialResultSetResume, TooManyTransients) {
               StatusIs(StatusCode::kUnavailable, HasSubstr("try-again-N")));
 }
 
+TEST(PartialResultSetResume, CancelledToken) {
+  CancellationToken token;
+  MockFactory mock_factory;
+  EXPECT_CALL(mock_factory, MakeReader(_))
+      .WillOnce([&token](std::string const&) {
+        auto mock = absl::make_unique<MockPartialResultSetReader>();
+        {
+          ::testing::InSequence sequence;
+          // Cancelling the token cancels the RPC in progress.
+          EXPECT_CALL(*mock, TryCancel()).Times(1);
+          EXPECT_CALL(*mock, Read()).WillOnce(Return(ReadReturn{}));
+          EXPECT_CALL(*mock, Finish())
+              .WillOnce(Return(Status(StatusCode::kCancelled, "cancelled")));
+        }
+        token.Cancel();
+        return mock;
+      });
+
+  auto factory = [&mock_factory](std::string const& token) {
+    return mock_factory.MakeReader(token);
+  };
+  CancellationScope scope(token);
+  // The retry policy would allow resuming, the token prevents it.
+  auto reader = MakeTestResume(factory, Idempotency::kIdempotent);
+  auto v = reader->Read();
+  ASSERT_FALSE(v.has_value());
+  EXPECT_THAT(reader->Finish(), StatusIs(StatusCode::kCancelled,
+                                         HasSubstr("Operation cancelled")));
+}
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner_internal
@@ -41,9 +41,41 @@ StatusOr<std::unique_ptr<ResultSourceInterface>> PartialResultSetSource::Create(
 }
 
 StatusOr<spanner::Row> PartialResultSetSource::NextRow() {
-  if (finished_) {
-    return spanner::Row();
+  auto ready = BufferRow();
+  if (!ready) return std::move(ready).status();
+  if (!*ready) return spanner::Row();
+
+  std::vector<spanner::Value> values;
+  values.reserve(column_types_.size());
+  auto iter = buffer_.begin();
+  for (auto const& type : column_types_) {
+    values.push_back(FromProto(type, std::move(*iter)));
+    ++iter;
   }
+  buffer_.erase(buffer_.begin(), iter);
+  return MakeRow(std::move(values), columns_);
+}
+
+Status PartialResultSetSource::NextRawRow(RawRow& row) {
+  row.values.clear();
+  auto ready = BufferRow();
+  if (!ready) return std::move(ready).status();
+  if (!*ready) return {};
+
+  auto const size = static_cast<std::size_t>(row_type_->fields_size());
+  row.values.reserve(size);
+  auto iter = buffer_.begin();
+  for (std::size_t i = 0; i != size; ++i) {
+    row.values.push_back(std::move(*iter));
+    ++iter;
+  }
+  buffer_.erase(buffer_.begin(), iter);
+  row.row_type = row_type_;
+  return {};
+}
+
+StatusOr<bool> PartialResultSetSource::BufferRow() {
+  if (finished_) return false;
 
   while (buffer_.empty() || buffer_.size() < columns_->size()) {
     auto status = ReadFromStream();
@@ -51,32 +83,22 @@ StatusOr<spanner::Row> PartialResultSetSource::NextRow() {
       return status;
     }
     if (finished_) {
-      if (chunk_) {
+      if (!chunks_.empty()) {
         return Status(StatusCode::kInternal,
                       "incomplete chunked_value at end of stream");
       }
       if (!buffer_.empty()) {
         return Status(StatusCode::kInternal, "incomplete row at end of stream");
       }
-      return spanner::Row();
+      return false;
     }
   }
 
-  auto const& fields = metadata_->row_type().fields();
-  if (fields.empty()) {
+  if (row_type_->fields().empty()) {
     return Status(StatusCode::kInternal,
                   "response metadata is missing row type information");
   }
-
-  std::vector<spanner::Value> values;
-  values.reserve(fields.size());
-  auto iter = buffer_.begin();
-  for (auto const& field : fields) {
-    values.push_back(FromProto(field.type(), std::move(*iter)));
-    ++iter;
-  }
-  buffer_.erase(buffer_.begin(), iter);
-  return MakeRow(std::move(values), columns_);
+  return true;
 }
 
 PartialResultSetSource::~PartialResultSetSource() {
@@ -109,6 +131,12 @@ Status PartialResultSetSource::ReadFromStream() {
       GCP_LOG(WARNING) << "Unexpectedly received two sets of metadata";
     } else {
       metadata_ = std::move(*result_set->mutable_metadata());
+      // The row type is shared with every RawRow returned from NextRawRow().
+      row_type_ = std::make_shared<google::spanner::v1::StructType>(
+          metadata_->row_type());
+      for (auto const& field : row_type_->fields()) {
+        column_types_.emplace_back(row_type_, &field.type());
+      }
       // Copies the column names into a shared_ptr that will be shared with
       // every Row object returned from NextRow().
       columns_ = std::make_shared<std::vector<std::string>>();
@@ -143,22 +171,24 @@ Status PartialResultSetSource::ReadFromStream() {
   //
   // The final values yielded are: `A`, `B`, `C1C2`, `D`, `E1E2E3`, `F`.
   //
-  // n.b. One value can span more than two responses (the `E1E2E3` case above);
-  // the code "just works" without needing to treat that as a special-case.
-  if (chunk_) {
+  // n.b. One value can span more than two responses (the `E1E2E3` case above).
+  // The chunks are accumulated in `chunks_` until the value is complete, and
+  // then merged at once, so large values split into many chunks are not
+  // copied each time a chunk arrives.
+  if (!chunks_.empty()) {
     if (new_values.empty()) {
       return Status(StatusCode::kInternal,
                     "PartialResultSet contained no values "
                     "to merge with prior chunked_value");
     }
-    auto& front = new_values[0];
-    auto merge_status = MergeChunk(*chunk_, std::move(front));
-    if (!merge_status.ok()) {
-      return merge_status;
+    chunks_.push_back(std::move(new_values[0]));
+    if (result_set->chunked_value() && new_values.size() == 1) {
+      return {};  // The value continues in the next response.
     }
-    using std::swap;
-    swap(*chunk_, front);
-    chunk_ = {};
+    auto merged = MergeChunks(std::move(chunks_));
+    chunks_.clear();
+    if (!merged) return std::move(merged).status();
+    new_values[0] = *std::move(merged);
   }
 
   if (result_set->chunked_value()) {
@@ -167,7 +197,7 @@ Status PartialResultSetSource::ReadFromStream() {
                     "PartialResultSet had chunked_value "
                     "set true but contained no values");
     }
-    chunk_ = std::move(new_values[new_values.size() - 1]);
+    chunks_.push_back(std::move(new_values[new_values.size() - 1]));
     new_values.RemoveLast();
   }
 
@@ -27,6 +27,8 @@
 #include <grpcpp/grpcpp.h>
 #include <deque>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -48,6 +50,8 @@ class PartialResultSetSource : public ResultSourceInterface {
 
   StatusOr<spanner::Row> NextRow() override;
 
+  Status NextRawRow(RawRow& row) override;
+
   absl::optional<google::spanner::v1::ResultSetMetadata> Metadata() override {
     return metadata_;
   }
@@ -63,12 +67,21 @@ class PartialResultSetSource : public ResultSourceInterface {
 
   Status ReadFromStream();
 
+  // Reads from the stream until `buffer_` contains a complete row. Returns
+  // false at end-of-stream.
+  StatusOr<bool> BufferRow();
+
   std::unique_ptr<PartialResultSetReader> reader_;
   absl::optional<google::spanner::v1::ResultSetMetadata> metadata_;
   absl::optional<google::spanner::v1::ResultSetStats> stats_;
   std::deque<google::protobuf::Value> buffer_;
-  absl::optional<google::protobuf::Value> chunk_;
+  // The chunks of a value split across responses, see ReadFromStream().
+  std::vector<google::protobuf::Value> chunks_;
   std::shared_ptr<std::vector<std::string>> columns_;
+  std::shared_ptr<google::spanner::v1::StructType const> row_type_;
+  // The type of each column, these alias `row_type_` and are shared with
+  // every Value returned from NextRow().
+  std::vector<std::shared_ptr<google::spanner::v1::Type const>> column_types_;
   bool finished_ = false;
 };
 
@@ -255,6 +255,65 @@ TEST(PartialResultSetSourceTest, SingleResponse) {
   EXPECT_THAT(*actual_stats, IsProtoEqual(expected_stats));
 }
 
+/**
+ * @test Verify NextRawRow() returns the protos received from the reader,
+ * sharing the row type across rows.
+ */
+TEST(PartialResultSetSourceTest, NextRawRow) {
+  auto grpc_reader = absl::make_unique<MockPartialResultSetReader>();
+  auto constexpr kText = R"pb(
+    metadata: {
+      row_type: {
+        fields: {
+          name: "UserId",
+          type: { code: INT64 }
+        }
+        fields: {
+          name: "UserName",
+          type: { code: STRING }
+        }
+      }
+    }
+    values: { string_value: "10" }
+    values: { string_value: "user10" }
+    values: { string_value: "22" }
+    values: { string_value: "user22" }
+  )pb";
+  spanner_proto::PartialResultSet response;
+  ASSERT_TRUE(TextFormat::ParseFromString(kText, &response));
+  EXPECT_CALL(*grpc_reader, Read())
+      .WillOnce(Return(response))
+      .WillOnce(Return(absl::optional<spanner_proto::PartialResultSet>{}));
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+  auto reader = PartialResultSetSource::Create(std::move(grpc_reader));
+  ASSERT_STATUS_OK(reader);
+
+  RawRow row;
+  ASSERT_STATUS_OK((*reader)->NextRawRow(row));
+  ASSERT_EQ(2U, row.values.size());
+  EXPECT_EQ("10", row.values[0].string_value());
+  EXPECT_EQ("user10", row.values[1].string_value());
+  ASSERT_NE(nullptr, row.row_type);
+  EXPECT_THAT(*row.row_type, IsProtoEqual(response.metadata().row_type()));
+  auto const row_type = row.row_type;
+
+  using RowType = std::tuple<std::int64_t, std::string>;
+  auto decoded = DecodeRawRow<RowType>(row);
+  ASSERT_STATUS_OK(decoded);
+  EXPECT_EQ(RowType(10, "user10"), *decoded);
+
+  ASSERT_STATUS_OK((*reader)->NextRawRow(row));
+  EXPECT_EQ(row_type, row.row_type);
+  decoded = DecodeRawRow<RowType>(row);
+  ASSERT_STATUS_OK(decoded);
+  EXPECT_EQ(RowType(22, "user22"), *decoded);
+
+  // At end of stream, we get an 'ok' response with no values.
+  ASSERT_STATUS_OK((*reader)->NextRawRow(row));
+  EXPECT_TRUE(row.values.empty());
+}
+
 /**
  * @test Verify the functionality of the PartialResultSetSource when the gRPC
  * reader returns data across multiple Read() calls.
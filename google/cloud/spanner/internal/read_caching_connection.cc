@@ -0,0 +1,256 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/read_caching_connection.h"
+#include "google/cloud/spanner/internal/session.h"
+#include "google/cloud/spanner/keys.h"
+#include "google/cloud/spanner/results.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/spanner/transaction.h"
+#include "absl/memory/memory.h"
+#include "absl/types/optional.h"
+#include <google/protobuf/duration.pb.h>
+#include <google/spanner/v1/spanner.pb.h>
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+std::chrono::nanoseconds FromProto(google::protobuf::Duration const& proto) {
+  return std::chrono::seconds(proto.seconds()) +
+         std::chrono::nanoseconds(proto.nanos());
+}
+
+absl::optional<std::chrono::nanoseconds> StalenessBound(
+    StatusOr<spanner_proto::TransactionSelector> const& s) {
+  if (!s || !s->has_single_use()) return absl::nullopt;
+  auto const& opts = s->single_use();
+  if (!opts.has_read_only()) return absl::nullopt;
+  auto const& ro = opts.read_only();
+  if (ro.has_max_staleness()) return FromProto(ro.max_staleness());
+  if (ro.has_exact_staleness()) return FromProto(ro.exact_staleness());
+  return absl::nullopt;
+}
+
+// Returns the staleness bound of the transaction used by @p params, if the
+// read can be served from the cache.
+absl::optional<std::chrono::nanoseconds> CacheableStaleness(
+    spanner::Connection::ReadParams const& params) {
+  if (params.partition_token) return absl::nullopt;
+  return Visit(params.transaction,
+               [](SessionHolder&,
+                  StatusOr<spanner_proto::TransactionSelector>& s,
+                  std::int64_t) { return StalenessBound(s); });
+}
+
+// The cache key includes all the `ReadParams` fields that change the result.
+std::string CacheKey(spanner::Connection::ReadParams const& params) {
+  spanner_proto::ReadRequest request;
+  request.set_table(params.table);
+  request.set_index(params.read_options.index_name);
+  for (auto const& c : params.columns) request.add_columns(c);
+  *request.mutable_key_set() = ToProto(params.keys);
+  request.set_limit(params.read_options.limit);
+  return request.SerializeAsString();
+}
+
+// Returns the rows of a (cached or just completed) read.
+class CachedResultSource : public ResultSourceInterface {
+ public:
+  CachedResultSource(std::shared_ptr<ReadCachingConnection::Entry const> entry,
+                     Status status)
+      : entry_(std::move(entry)), status_(std::move(status)) {}
+
+  StatusOr<spanner::Row> NextRow() override {
+    if (next_ != entry_->rows.size()) return entry_->rows[next_++];
+    if (!status_.ok()) return status_;
+    return spanner::Row();
+  }
+
+  absl::optional<spanner_proto::ResultSetMetadata> Metadata() override {
+    return entry_->metadata;
+  }
+
+  absl::optional<spanner_proto::ResultSetStats> Stats() const override {
+    return absl::nullopt;
+  }
+
+ private:
+  std::shared_ptr<ReadCachingConnection::Entry const> entry_;
+  Status status_;
+  std::size_t next_ = 0;
+};
+
+}  // namespace
+
+ReadCachingConnection::ReadCachingConnection(
+    std::shared_ptr<spanner::Connection> child,
+    spanner::ReadCacheOptions options, std::shared_ptr<SystemClock> clock)
+    : child_(std::move(child)),
+      options_(std::move(options)),
+      clock_(std::move(clock)) {}
+
+spanner::RowStream ReadCachingConnection::Read(ReadParams params) {
+  auto staleness = CacheableStaleness(params);
+  if (!staleness) return child_->Read(std::move(params));
+  return CachedRead(std::move(params), *staleness);
+}
+
+StatusOr<std::vector<spanner::ReadPartition>>
+ReadCachingConnection::PartitionRead(PartitionReadParams params) {
+  return child_->PartitionRead(std::move(params));
+}
+
+spanner::RowStream ReadCachingConnection::ExecuteQuery(SqlParams params) {
+  return child_->ExecuteQuery(std::move(params));
+}
+
+StatusOr<spanner::DmlResult> ReadCachingConnection::ExecuteDml(
+    SqlParams params) {
+  return child_->ExecuteDml(std::move(params));
+}
+
+spanner::ProfileQueryResult ReadCachingConnection::ProfileQuery(
+    SqlParams params) {
+  return child_->ProfileQuery(std::move(params));
+}
+
+StatusOr<spanner::ProfileDmlResult> ReadCachingConnection::ProfileDml(
+    SqlParams params) {
+  return child_->ProfileDml(std::move(params));
+}
+
+StatusOr<spanner::ExecutionPlan> ReadCachingConnection::AnalyzeSql(
+    SqlParams params) {
+  return child_->AnalyzeSql(std::move(params));
+}
+
+StatusOr<spanner::PartitionedDmlResult>
+ReadCachingConnection::ExecutePartitionedDml(
+    ExecutePartitionedDmlParams params) {
+  return child_->ExecutePartitionedDml(std::move(params));
+}
+
+StatusOr<std::vector<spanner::QueryPartition>>
+ReadCachingConnection::PartitionQuery(PartitionQueryParams params) {
+  return child_->PartitionQuery(std::move(params));
+}
+
+StatusOr<spanner::BatchDmlResult> ReadCachingConnection::ExecuteBatchDml(
+    ExecuteBatchDmlParams params) {
+  return child_->ExecuteBatchDml(std::move(params));
+}
+
+StatusOr<spanner::CommitResult> ReadCachingConnection::Commit(
+    CommitParams params) {
+  return child_->Commit(std::move(params));
+}
+
+Status ReadCachingConnection::Rollback(RollbackParams params) {
+  return child_->Rollback(std::move(params));
+}
+
+future<spanner::RowStream> ReadCachingConnection::AsyncRead(
+    ReadParams params) {
+  auto staleness = CacheableStaleness(params);
+  if (!staleness) return child_->AsyncRead(std::move(params));
+  return make_ready_future(CachedRead(std::move(params), *staleness));
+}
+
+future<spanner::RowStream> ReadCachingConnection::AsyncExecuteQuery(
+    SqlParams params) {
+  return child_->AsyncExecuteQuery(std::move(params));
+}
+
+future<StatusOr<spanner::CommitResult>> ReadCachingConnection::AsyncCommit(
+    CommitParams params) {
+  return child_->AsyncCommit(std::move(params));
+}
+
+spanner::RowStream ReadCachingConnection::CachedRead(
+    ReadParams params, std::chrono::nanoseconds staleness) {
+  auto key = CacheKey(params);
+  auto cached = Lookup(key, staleness);
+  if (cached) {
+    return spanner::RowStream(
+        absl::make_unique<CachedResultSource>(std::move(cached), Status()));
+  }
+
+  // Read all the rows, so they can be returned again.
+  auto stream = child_->Read(std::move(params));
+  auto entry = std::make_shared<Entry>();
+  Status status;
+  for (auto& row : stream) {
+    if (!row) {
+      status = std::move(row).status();
+      break;
+    }
+    entry->rows.push_back(*std::move(row));
+  }
+  auto read_timestamp = stream.ReadTimestamp();
+  if (read_timestamp) {
+    *entry->metadata.mutable_transaction()->mutable_read_timestamp() =
+        TimestampToProto(*read_timestamp);
+    auto read_time =
+        read_timestamp->get<std::chrono::system_clock::time_point>();
+    // Without a read timestamp there is no way to honor the staleness bound.
+    if (status.ok() && read_time) {
+      entry->read_time = *read_time;
+      Insert(std::move(key), entry);
+    }
+  }
+  return spanner::RowStream(absl::make_unique<CachedResultSource>(
+      std::move(entry), std::move(status)));
+}
+
+std::shared_ptr<ReadCachingConnection::Entry const>
+ReadCachingConnection::Lookup(std::string const& key,
+                              std::chrono::nanoseconds staleness) {
+  auto const now = clock_->Now();
+  std::lock_guard<std::mutex> lk(mu_);
+  auto i = index_.find(key);
+  if (i == index_.end()) return nullptr;
+  auto const& entry = i->second->second;
+  if (now - entry->read_time > staleness) return nullptr;
+  entries_.splice(entries_.begin(), entries_, i->second);
+  return entry;
+}
+
+void ReadCachingConnection::Insert(std::string key,
+                                   std::shared_ptr<Entry const> entry) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (options_.max_entries() == 0) return;
+  auto i = index_.find(key);
+  if (i != index_.end()) {
+    entries_.erase(i->second);
+    index_.erase(i);
+  }
+  entries_.emplace_front(key, std::move(entry));
+  index_.emplace(std::move(key), entries_.begin());
+  while (entries_.size() > options_.max_entries()) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,104 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_CACHING_CONNECTION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_CACHING_CONNECTION_H
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/internal/clock.h"
+#include "google/cloud/spanner/read_cache.h"
+#include "google/cloud/spanner/row.h"
+#include "google/cloud/spanner/version.h"
+#include <google/spanner/v1/result_set.pb.h>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * A `Connection` decorator that caches the results of stale reads.
+ *
+ * See `spanner::MakeReadCachingConnection()` for the caching rules.
+ */
+class ReadCachingConnection : public spanner::Connection {
+ public:
+  ReadCachingConnection(
+      std::shared_ptr<spanner::Connection> child,
+      spanner::ReadCacheOptions options,
+      std::shared_ptr<SystemClock> clock = std::make_shared<SystemClock>());
+
+  spanner::RowStream Read(ReadParams params) override;
+  StatusOr<std::vector<spanner::ReadPartition>> PartitionRead(
+      PartitionReadParams params) override;
+  spanner::RowStream ExecuteQuery(SqlParams params) override;
+  StatusOr<spanner::DmlResult> ExecuteDml(SqlParams params) override;
+  spanner::ProfileQueryResult ProfileQuery(SqlParams params) override;
+  StatusOr<spanner::ProfileDmlResult> ProfileDml(SqlParams params) override;
+  StatusOr<spanner::ExecutionPlan> AnalyzeSql(SqlParams params) override;
+  StatusOr<spanner::PartitionedDmlResult> ExecutePartitionedDml(
+      ExecutePartitionedDmlParams params) override;
+  StatusOr<std::vector<spanner::QueryPartition>> PartitionQuery(
+      PartitionQueryParams params) override;
+  StatusOr<spanner::BatchDmlResult> ExecuteBatchDml(
+      ExecuteBatchDmlParams params) override;
+  StatusOr<spanner::CommitResult> Commit(CommitParams params) override;
+  Status Rollback(RollbackParams params) override;
+  future<spanner::RowStream> AsyncRead(ReadParams params) override;
+  future<spanner::RowStream> AsyncExecuteQuery(SqlParams params) override;
+  future<StatusOr<spanner::CommitResult>> AsyncCommit(
+      CommitParams params) override;
+
+  /// The rows returned by a read, and the timestamp they were read at.
+  struct Entry {
+    google::spanner::v1::ResultSetMetadata metadata;
+    std::vector<spanner::Row> rows;
+    std::chrono::system_clock::time_point read_time;
+  };
+
+ private:
+  spanner::RowStream CachedRead(ReadParams params,
+                                std::chrono::nanoseconds staleness);
+
+  std::shared_ptr<Entry const> Lookup(std::string const& key,
+                                      std::chrono::nanoseconds staleness);
+  void Insert(std::string key, std::shared_ptr<Entry const> entry);
+
+  std::shared_ptr<spanner::Connection> child_;
+  spanner::ReadCacheOptions const options_;
+  std::shared_ptr<SystemClock> clock_;
+
+  using EntryList =
+      std::list<std::pair<std::string, std::shared_ptr<Entry const>>>;
+  std::mutex mu_;
+  // The cached reads, the most recently used first.
+  EntryList entries_;  // GUARDED_BY(mu_)
+  std::unordered_map<std::string, EntryList::iterator>
+      index_;  // GUARDED_BY(mu_)
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_CACHING_CONNECTION_H
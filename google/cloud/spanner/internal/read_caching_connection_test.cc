@@ -0,0 +1,202 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/read_caching_connection.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/testing/fake_clock.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/spanner/transaction.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::google::cloud::spanner_mocks::MockResultSetSource;
+using ::google::cloud::spanner_testing::FakeSystemClock;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Return;
+
+namespace spanner_proto = ::google::spanner::v1;
+
+auto const kNow = std::chrono::system_clock::time_point(
+    std::chrono::seconds(1600000000));
+
+// Returns a stream with one row for each value in @p values, read at
+// @p read_time, and then @p status.
+spanner::RowStream MakeStream(std::vector<std::string> const& values,
+                              std::chrono::system_clock::time_point read_time,
+                              Status status = Status()) {
+  auto source = absl::make_unique<MockResultSetSource>();
+  spanner_proto::ResultSetMetadata metadata;
+  *metadata.mutable_transaction()->mutable_read_timestamp() =
+      TimestampToProto(spanner::MakeTimestamp(read_time).value());
+  EXPECT_CALL(*source, Metadata()).WillRepeatedly(Return(metadata));
+  auto next = std::make_shared<std::size_t>(0);
+  std::vector<spanner::Row> rows;
+  for (auto const& v : values) {
+    rows.push_back(spanner::MakeTestRow({{"Value", spanner::Value(v)}}));
+  }
+  EXPECT_CALL(*source, NextRow())
+      .WillRepeatedly([rows, next, status]() -> StatusOr<spanner::Row> {
+        if (*next != rows.size()) return rows[(*next)++];
+        if (!status.ok()) return status;
+        return spanner::Row();
+      });
+  return spanner::RowStream(std::move(source));
+}
+
+spanner::Connection::ReadParams MakeReadParams(spanner::Transaction txn,
+                                               std::string table = "T") {
+  return {std::move(txn),
+          std::move(table),
+          spanner::KeySet::All(),
+          {"Value"},
+          spanner::ReadOptions(),
+          absl::nullopt};
+}
+
+spanner::Transaction Stale(std::chrono::seconds staleness) {
+  return MakeSingleUseTransaction(
+      spanner::Transaction::SingleUseOptions(staleness));
+}
+
+std::vector<std::string> Values(spanner::RowStream& rows) {
+  std::vector<std::string> values;
+  for (auto& row : spanner::StreamOf<std::tuple<std::string>>(rows)) {
+    if (!row) {
+      values.push_back(row.status().message());
+      break;
+    }
+    values.push_back(std::get<0>(*row));
+  }
+  return values;
+}
+
+class ReadCachingConnectionTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<ReadCachingConnection> MakeTested(
+      spanner::ReadCacheOptions options = spanner::ReadCacheOptions()) {
+    clock_->SetTime(kNow);
+    return std::make_shared<ReadCachingConnection>(mock_, std::move(options),
+                                                   clock_);
+  }
+
+  std::shared_ptr<MockConnection> mock_ = std::make_shared<MockConnection>();
+  std::shared_ptr<FakeSystemClock> clock_ =
+      std::make_shared<FakeSystemClock>();
+};
+
+TEST_F(ReadCachingConnectionTest, CachesStaleReads) {
+  EXPECT_CALL(*mock_, Read(_)).WillOnce([](spanner::Connection::ReadParams) {
+    return MakeStream({"a", "b"}, kNow - std::chrono::seconds(2));
+  });
+  auto conn = MakeTested();
+  auto r1 = conn->Read(MakeReadParams(Stale(std::chrono::seconds(10))));
+  EXPECT_THAT(Values(r1), ElementsAre("a", "b"));
+  auto r2 = conn->Read(MakeReadParams(Stale(std::chrono::seconds(10))));
+  EXPECT_THAT(Values(r2), ElementsAre("a", "b"));
+  EXPECT_EQ(spanner::MakeTimestamp(kNow - std::chrono::seconds(2)).value(),
+            r2.ReadTimestamp());
+}
+
+TEST_F(ReadCachingConnectionTest, HonorsStalenessBound) {
+  EXPECT_CALL(*mock_, Read(_))
+      .WillOnce([](spanner::Connection::ReadParams) {
+        return MakeStream({"a"}, kNow - std::chrono::seconds(2));
+      })
+      .WillOnce([](spanner::Connection::ReadParams) {
+        return MakeStream({"b"}, kNow + std::chrono::seconds(7));
+      });
+  auto conn = MakeTested();
+  auto r1 = conn->Read(MakeReadParams(Stale(std::chrono::seconds(10))));
+  EXPECT_THAT(Values(r1), ElementsAre("a"));
+
+  // The cached rows are 9 seconds old.
+  clock_->AdvanceTime(std::chrono::seconds(7));
+  auto r2 = conn->Read(MakeReadParams(Stale(std::chrono::seconds(10))));
+  EXPECT_THAT(Values(r2), ElementsAre("a"));
+  auto r3 = conn->Read(MakeReadParams(Stale(std::chrono::seconds(5))));
+  EXPECT_THAT(Values(r3), ElementsAre("b"));
+
+  // The new rows replaced the old ones.
+  clock_->AdvanceTime(std::chrono::seconds(4));
+  auto r4 = conn->Read(MakeReadParams(Stale(std::chrono::seconds(10))));
+  EXPECT_THAT(Values(r4), ElementsAre("b"));
+}
+
+TEST_F(ReadCachingConnectionTest, StrongReadsNotCached) {
+  EXPECT_CALL(*mock_, Read(_))
+      .Times(4)
+      .WillRepeatedly([](spanner::Connection::ReadParams) {
+        return MakeStream({"a"}, kNow);
+      });
+  auto conn = MakeTested();
+  for (int i = 0; i != 2; ++i) {
+    auto rows = conn->Read(MakeReadParams(MakeSingleUseTransaction(
+        spanner::Transaction::SingleUseOptions(
+            spanner::Transaction::ReadOnlyOptions()))));
+    EXPECT_THAT(Values(rows), ElementsAre("a"));
+  }
+  auto txn = spanner::MakeReadOnlyTransaction(
+      spanner::Transaction::ReadOnlyOptions(std::chrono::seconds(10)));
+  for (int i = 0; i != 2; ++i) {
+    auto rows = conn->Read(MakeReadParams(txn));
+    EXPECT_THAT(Values(rows), ElementsAre("a"));
+  }
+}
+
+TEST_F(ReadCachingConnectionTest, ErrorsNotCached) {
+  EXPECT_CALL(*mock_, Read(_))
+      .Times(2)
+      .WillRepeatedly([](spanner::Connection::ReadParams) {
+        return MakeStream({"a"}, kNow,
+                          Status(StatusCode::kUnavailable, "try-again"));
+      });
+  auto conn = MakeTested();
+  for (int i = 0; i != 2; ++i) {
+    auto rows = conn->Read(MakeReadParams(Stale(std::chrono::seconds(10))));
+    EXPECT_THAT(Values(rows), ElementsAre("a", "try-again"));
+  }
+}
+
+TEST_F(ReadCachingConnectionTest, EvictsLeastRecentlyUsed) {
+  EXPECT_CALL(*mock_, Read(_))
+      .Times(3)
+      .WillRepeatedly([](spanner::Connection::ReadParams const& p) {
+        return MakeStream({p.table}, kNow);
+      });
+  auto conn = MakeTested(spanner::ReadCacheOptions{}.set_max_entries(1));
+  for (auto const* table : {"A", "B", "B", "A"}) {
+    auto rows =
+        conn->Read(MakeReadParams(Stale(std::chrono::seconds(10)), table));
+    EXPECT_THAT(Values(rows), ElementsAre(table));
+  }
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
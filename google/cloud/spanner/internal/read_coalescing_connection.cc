@@ -0,0 +1,326 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/read_coalescing_connection.h"
+#include "google/cloud/spanner/internal/session.h"
+#include "google/cloud/spanner/keys.h"
+#include "google/cloud/spanner/results.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/spanner/transaction.h"
+#include "google/cloud/spanner/value.h"
+#include "absl/memory/memory.h"
+#include "absl/types/optional.h"
+#include <google/spanner/v1/spanner.pb.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+struct ReadCoalescingConnection::Batch {
+  explicit Batch(spanner::Connection::ReadParams p) : params(std::move(p)) {}
+
+  // Add @p key to the batch, returns its position in the results.
+  std::size_t AddKey(std::string encoded, google::protobuf::ListValue key) {
+    auto ins = slots.emplace(std::move(encoded), keys.size());
+    if (ins.second) keys.push_back(std::move(key));
+    return ins.first->second;
+  }
+
+  // The leader's read, the merged read uses its transaction.
+  spanner::Connection::ReadParams params;
+  // The distinct keys in the batch, and their position in `keys`, indexed by
+  // their serialized representation. Guarded by the connection mutex while the
+  // batch is open, only used by the leader once it is closed.
+  std::vector<google::protobuf::ListValue> keys;
+  std::unordered_map<std::string, std::size_t> slots;
+  bool closed = false;
+
+  // The results, set once by the leader.
+  std::mutex mu;
+  std::condition_variable cv;
+  bool done = false;  // GUARDED_BY(mu)
+  Status status;
+  spanner_proto::ResultSetMetadata metadata;
+  std::vector<absl::optional<spanner::Row>> rows;
+};
+
+namespace {
+
+// Returns the transaction selector used by @p params, if it is a single-use,
+// read-only transaction.
+absl::optional<spanner_proto::TransactionSelector> SingleUseReadOnly(
+    spanner::Connection::ReadParams const& params) {
+  return Visit(params.transaction,
+               [](SessionHolder&,
+                  StatusOr<spanner_proto::TransactionSelector>& s,
+                  std::int64_t) -> absl::optional<
+                                    spanner_proto::TransactionSelector> {
+                 if (!s || !s->has_single_use()) return absl::nullopt;
+                 if (!s->single_use().has_read_only()) return absl::nullopt;
+                 return *s;
+               });
+}
+
+// The reads in a batch must have the same value for all the fields in this
+// key, they can only differ in their `KeySet`.
+std::string BatchKey(spanner::Connection::ReadParams const& params,
+                     spanner_proto::TransactionSelector selector) {
+  spanner_proto::ReadRequest request;
+  *request.mutable_transaction() = std::move(selector);
+  request.set_table(params.table);
+  request.set_index(params.read_options.index_name);
+  for (auto const& c : params.columns) request.add_columns(c);
+  return request.SerializeAsString();
+}
+
+// Returns the row (if any) read for one of the keys in a batch.
+class CoalescedResultSource : public ResultSourceInterface {
+ public:
+  CoalescedResultSource(absl::optional<spanner::Row> row, Status status,
+                        spanner_proto::ResultSetMetadata metadata)
+      : row_(std::move(row)),
+        status_(std::move(status)),
+        metadata_(std::move(metadata)) {}
+
+  StatusOr<spanner::Row> NextRow() override {
+    if (row_) {
+      auto row = *std::move(row_);
+      row_.reset();
+      return row;
+    }
+    if (!status_.ok()) return status_;
+    return spanner::Row();
+  }
+
+  absl::optional<spanner_proto::ResultSetMetadata> Metadata() override {
+    return metadata_;
+  }
+
+  absl::optional<spanner_proto::ResultSetStats> Stats() const override {
+    return absl::nullopt;
+  }
+
+ private:
+  absl::optional<spanner::Row> row_;
+  Status status_;
+  spanner_proto::ResultSetMetadata metadata_;
+};
+
+spanner::RowStream WaitForResult(ReadCoalescingConnection::Batch& batch,
+                                 std::size_t slot) {
+  std::unique_lock<std::mutex> lk(batch.mu);
+  batch.cv.wait(lk, [&batch] { return batch.done; });
+  auto const& row = batch.rows[slot];
+  // A point read returns at most one row, once it is received any errors in
+  // the rest of the stream are irrelevant.
+  auto status = row ? Status() : batch.status;
+  return spanner::RowStream(absl::make_unique<CoalescedResultSource>(
+      row, std::move(status), batch.metadata));
+}
+
+}  // namespace
+
+ReadCoalescingConnection::ReadCoalescingConnection(
+    std::shared_ptr<spanner::Connection> child,
+    spanner::ReadCoalescingOptions options)
+    : child_(std::move(child)), options_(std::move(options)) {}
+
+spanner::RowStream ReadCoalescingConnection::Read(ReadParams params) {
+  auto const* key_columns =
+      options_.key_columns(params.table, params.read_options.index_name);
+  if (key_columns == nullptr || params.partition_token ||
+      params.read_options.limit != 0) {
+    return child_->Read(std::move(params));
+  }
+  auto selector = SingleUseReadOnly(params);
+  if (!selector) return child_->Read(std::move(params));
+  auto keys = ToProto(params.keys);
+  if (keys.all() || keys.ranges_size() != 0 || keys.keys_size() != 1 ||
+      static_cast<std::size_t>(keys.keys(0).values_size()) !=
+          key_columns->size()) {
+    return child_->Read(std::move(params));
+  }
+  auto batch_key = BatchKey(params, *std::move(selector));
+  return CoalescedRead(std::move(params), *key_columns, std::move(batch_key),
+                       std::move(*keys.mutable_keys(0)));
+}
+
+StatusOr<std::vector<spanner::ReadPartition>>
+ReadCoalescingConnection::PartitionRead(PartitionReadParams params) {
+  return child_->PartitionRead(std::move(params));
+}
+
+spanner::RowStream ReadCoalescingConnection::ExecuteQuery(SqlParams params) {
+  return child_->ExecuteQuery(std::move(params));
+}
+
+StatusOr<spanner::DmlResult> ReadCoalescingConnection::ExecuteDml(
+    SqlParams params) {
+  return child_->ExecuteDml(std::move(params));
+}
+
+spanner::ProfileQueryResult ReadCoalescingConnection::ProfileQuery(
+    SqlParams params) {
+  return child_->ProfileQuery(std::move(params));
+}
+
+StatusOr<spanner::ProfileDmlResult> ReadCoalescingConnection::ProfileDml(
+    SqlParams params) {
+  return child_->ProfileDml(std::move(params));
+}
+
+StatusOr<spanner::ExecutionPlan> ReadCoalescingConnection::AnalyzeSql(
+    SqlParams params) {
+  return child_->AnalyzeSql(std::move(params));
+}
+
+StatusOr<spanner::PartitionedDmlResult>
+ReadCoalescingConnection::ExecutePartitionedDml(
+    ExecutePartitionedDmlParams params) {
+  return child_->ExecutePartitionedDml(std::move(params));
+}
+
+StatusOr<std::vector<spanner::QueryPartition>>
+ReadCoalescingConnection::PartitionQuery(PartitionQueryParams params) {
+  return child_->PartitionQuery(std::move(params));
+}
+
+StatusOr<spanner::BatchDmlResult> ReadCoalescingConnection::ExecuteBatchDml(
+    ExecuteBatchDmlParams params) {
+  return child_->ExecuteBatchDml(std::move(params));
+}
+
+StatusOr<spanner::CommitResult> ReadCoalescingConnection::Commit(
+    CommitParams params) {
+  return child_->Commit(std::move(params));
+}
+
+Status ReadCoalescingConnection::Rollback(RollbackParams params) {
+  return child_->Rollback(std::move(params));
+}
+
+future<spanner::RowStream> ReadCoalescingConnection::AsyncRead(
+    ReadParams params) {
+  return child_->AsyncRead(std::move(params));
+}
+
+future<spanner::RowStream> ReadCoalescingConnection::AsyncExecuteQuery(
+    SqlParams params) {
+  return child_->AsyncExecuteQuery(std::move(params));
+}
+
+future<StatusOr<spanner::CommitResult>> ReadCoalescingConnection::AsyncCommit(
+    CommitParams params) {
+  return child_->AsyncCommit(std::move(params));
+}
+
+spanner::RowStream ReadCoalescingConnection::CoalescedRead(
+    ReadParams params, std::vector<std::string> const& key_columns,
+    std::string batch_key, google::protobuf::ListValue key) {
+  auto encoded = key.SerializeAsString();
+  std::unique_lock<std::mutex> lk(mu_);
+  auto i = open_batches_.find(batch_key);
+  if (i != open_batches_.end()) {
+    auto batch = i->second;
+    auto slot = batch->AddKey(std::move(encoded), std::move(key));
+    if (batch->keys.size() >= options_.max_batch_size()) {
+      batch->closed = true;
+      open_batches_.erase(i);
+      cv_.notify_all();
+    }
+    lk.unlock();
+    return WaitForResult(*batch, slot);
+  }
+
+  auto batch = std::make_shared<Batch>(std::move(params));
+  auto slot = batch->AddKey(std::move(encoded), std::move(key));
+  if (options_.max_batch_size() > 1) {
+    open_batches_.emplace(batch_key, batch);
+    cv_.wait_for(lk, options_.window(), [&batch] { return batch->closed; });
+    // If the batch is full it was already removed, and the key may be in use
+    // by a newer batch.
+    if (!batch->closed) open_batches_.erase(batch_key);
+    batch->closed = true;
+  }
+  lk.unlock();
+
+  // There is nothing to merge, avoid the overhead of demultiplexing the rows.
+  if (batch->keys.size() == 1) return child_->Read(std::move(batch->params));
+  RunBatch(*batch, key_columns);
+  return WaitForResult(*batch, slot);
+}
+
+void ReadCoalescingConnection::RunBatch(
+    Batch& batch, std::vector<std::string> const& key_columns) {
+  auto params = std::move(batch.params);
+  spanner_proto::KeySet merged;
+  for (auto& k : batch.keys) *merged.add_keys() = std::move(k);
+  params.keys = FromProto(std::move(merged));
+
+  // The key columns are needed to match each row to its key, request them if
+  // the callers did not.
+  auto const requested = params.columns.size();
+  auto columns = std::make_shared<std::vector<std::string> const>(
+      params.columns);
+  std::vector<std::size_t> key_positions;
+  for (auto const& c : key_columns) {
+    auto const pos = static_cast<std::size_t>(
+        std::find(params.columns.begin(), params.columns.end(), c) -
+        params.columns.begin());
+    if (pos == params.columns.size()) params.columns.push_back(c);
+    key_positions.push_back(pos);
+  }
+
+  std::vector<absl::optional<spanner::Row>> rows(batch.slots.size());
+  Status status;
+  auto stream = child_->Read(std::move(params));
+  for (auto& row : stream) {
+    if (!row) {
+      status = std::move(row).status();
+      break;
+    }
+    google::protobuf::ListValue key;
+    for (auto p : key_positions) {
+      *key.add_values() = ValueInternals::ToProto(row->values()[p]).second;
+    }
+    auto s = batch.slots.find(key.SerializeAsString());
+    if (s == batch.slots.end()) continue;
+    std::vector<spanner::Value> values = std::move(*row).values();
+    values.resize(requested);
+    rows[s->second] = MakeRow(std::move(values), columns);
+  }
+  spanner_proto::ResultSetMetadata metadata;
+  auto read_timestamp = stream.ReadTimestamp();
+  if (read_timestamp) {
+    *metadata.mutable_transaction()->mutable_read_timestamp() =
+        TimestampToProto(*read_timestamp);
+  }
+
+  std::lock_guard<std::mutex> lk(batch.mu);
+  batch.status = std::move(status);
+  batch.metadata = std::move(metadata);
+  batch.rows = std::move(rows);
+  batch.done = true;
+  batch.cv.notify_all();
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,96 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_COALESCING_CONNECTION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_COALESCING_CONNECTION_H
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/read_coalescing.h"
+#include "google/cloud/spanner/version.h"
+#include <google/protobuf/struct.pb.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * A `Connection` decorator that merges concurrent point reads.
+ *
+ * See `spanner::MakeReadCoalescingConnection()` for the coalescing rules.
+ *
+ * The first read for a given table, index, columns, and timestamp bound starts
+ * a new batch and becomes its leader. Other reads with the same parameters
+ * join the batch while it is open. Once the window expires, or the batch is
+ * full, the leader closes the batch, issues the merged read, and delivers the
+ * rows to all the members. No background threads are needed.
+ */
+class ReadCoalescingConnection : public spanner::Connection {
+ public:
+  ReadCoalescingConnection(std::shared_ptr<spanner::Connection> child,
+                           spanner::ReadCoalescingOptions options);
+
+  spanner::RowStream Read(ReadParams params) override;
+  StatusOr<std::vector<spanner::ReadPartition>> PartitionRead(
+      PartitionReadParams params) override;
+  spanner::RowStream ExecuteQuery(SqlParams params) override;
+  StatusOr<spanner::DmlResult> ExecuteDml(SqlParams params) override;
+  spanner::ProfileQueryResult ProfileQuery(SqlParams params) override;
+  StatusOr<spanner::ProfileDmlResult> ProfileDml(SqlParams params) override;
+  StatusOr<spanner::ExecutionPlan> AnalyzeSql(SqlParams params) override;
+  StatusOr<spanner::PartitionedDmlResult> ExecutePartitionedDml(
+      ExecutePartitionedDmlParams params) override;
+  StatusOr<std::vector<spanner::QueryPartition>> PartitionQuery(
+      PartitionQueryParams params) override;
+  StatusOr<spanner::BatchDmlResult> ExecuteBatchDml(
+      ExecuteBatchDmlParams params) override;
+  StatusOr<spanner::CommitResult> Commit(CommitParams params) override;
+  Status Rollback(RollbackParams params) override;
+  future<spanner::RowStream> AsyncRead(ReadParams params) override;
+  future<spanner::RowStream> AsyncExecuteQuery(SqlParams params) override;
+  future<StatusOr<spanner::CommitResult>> AsyncCommit(
+      CommitParams params) override;
+
+  struct Batch;
+
+ private:
+  spanner::RowStream CoalescedRead(ReadParams params,
+                                   std::vector<std::string> const& key_columns,
+                                   std::string batch_key,
+                                   google::protobuf::ListValue key);
+  void RunBatch(Batch& batch, std::vector<std::string> const& key_columns);
+
+  std::shared_ptr<spanner::Connection> child_;
+  spanner::ReadCoalescingOptions const options_;
+
+  std::mutex mu_;
+  // Signaled when a batch becomes full.
+  std::condition_variable cv_;
+  // The batches accepting new reads.
+  std::unordered_map<std::string, std::shared_ptr<Batch>>
+      open_batches_;  // GUARDED_BY(mu_)
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_COALESCING_CONNECTION_H
@@ -0,0 +1,179 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/read_coalescing_connection.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/keys.h"
+#include "google/cloud/spanner/transaction.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::google::cloud::spanner_mocks::MockResultSetSource;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Return;
+
+namespace spanner_proto = ::google::spanner::v1;
+
+// Returns a stream with one row for each of @p ids, with the "Value" and "Id"
+// columns, and then @p status.
+spanner::RowStream MakeStream(std::vector<std::int64_t> const& ids,
+                              Status status = Status()) {
+  auto source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, Metadata())
+      .WillRepeatedly(Return(spanner_proto::ResultSetMetadata()));
+  auto next = std::make_shared<std::size_t>(0);
+  std::vector<spanner::Row> rows;
+  for (auto id : ids) {
+    rows.push_back(spanner::MakeTestRow(
+        {{"Value", spanner::Value("v" + std::to_string(id))},
+         {"Id", spanner::Value(id)}}));
+  }
+  EXPECT_CALL(*source, NextRow())
+      .WillRepeatedly([rows, next, status]() -> StatusOr<spanner::Row> {
+        if (*next != rows.size()) return rows[(*next)++];
+        if (!status.ok()) return status;
+        return spanner::Row();
+      });
+  return spanner::RowStream(std::move(source));
+}
+
+spanner::Connection::ReadParams MakeReadParams(std::int64_t id,
+                                               std::string table = "T") {
+  return {MakeSingleUseTransaction(spanner::Transaction::SingleUseOptions(
+              std::chrono::seconds(10))),
+          std::move(table),
+          spanner::KeySet().AddKey(spanner::MakeKey(id)),
+          {"Value"},
+          spanner::ReadOptions(),
+          absl::nullopt};
+}
+
+std::vector<std::string> Values(spanner::RowStream rows) {
+  std::vector<std::string> values;
+  for (auto& row : spanner::StreamOf<std::tuple<std::string>>(rows)) {
+    if (!row) {
+      values.push_back(row.status().message());
+      break;
+    }
+    values.push_back(std::get<0>(*row));
+  }
+  return values;
+}
+
+spanner::ReadCoalescingOptions MakeOptions(std::size_t max_batch_size) {
+  return spanner::ReadCoalescingOptions()
+      .set_window(std::chrono::seconds(30))
+      .set_max_batch_size(max_batch_size)
+      .set_key_columns("T", "", {"Id"});
+}
+
+// Runs a read for each of @p ids concurrently, returns the values read.
+std::vector<std::vector<std::string>> ConcurrentReads(
+    std::shared_ptr<spanner::Connection> const& conn,
+    std::vector<std::int64_t> const& ids) {
+  std::vector<std::future<std::vector<std::string>>> tasks;
+  for (auto id : ids) {
+    tasks.push_back(std::async(std::launch::async, [conn, id] {
+      return Values(conn->Read(MakeReadParams(id)));
+    }));
+  }
+  std::vector<std::vector<std::string>> results;
+  for (auto& t : tasks) results.push_back(t.get());
+  return results;
+}
+
+TEST(ReadCoalescingConnectionTest, PassThroughIneligibleReads) {
+  auto mock = std::make_shared<MockConnection>();
+  EXPECT_CALL(*mock, Read(_))
+      .Times(3)
+      .WillRepeatedly([](spanner::Connection::ReadParams p) {
+        EXPECT_THAT(p.columns, ElementsAre("Value"));
+        return MakeStream({1});
+      });
+  ReadCoalescingConnection conn(mock, MakeOptions(100));
+
+  // Not configured.
+  EXPECT_THAT(Values(conn.Read(MakeReadParams(1, "Other"))),
+              ElementsAre("v1"));
+  // Not a point read.
+  auto params = MakeReadParams(1);
+  params.keys = spanner::KeySet::All();
+  EXPECT_THAT(Values(conn.Read(std::move(params))), ElementsAre("v1"));
+  // Not a single-use transaction.
+  params = MakeReadParams(1);
+  params.transaction = spanner::MakeReadOnlyTransaction();
+  EXPECT_THAT(Values(conn.Read(std::move(params))), ElementsAre("v1"));
+}
+
+TEST(ReadCoalescingConnectionTest, SingleReadAfterWindow) {
+  auto mock = std::make_shared<MockConnection>();
+  EXPECT_CALL(*mock, Read(_)).WillOnce([](spanner::Connection::ReadParams p) {
+    EXPECT_THAT(p.columns, ElementsAre("Value"));
+    return MakeStream({1});
+  });
+  ReadCoalescingConnection conn(
+      mock, MakeOptions(100).set_window(std::chrono::milliseconds(1)));
+  EXPECT_THAT(Values(conn.Read(MakeReadParams(1))), ElementsAre("v1"));
+}
+
+TEST(ReadCoalescingConnectionTest, MergesConcurrentReads) {
+  auto mock = std::make_shared<MockConnection>();
+  EXPECT_CALL(*mock, Read(_)).WillOnce([](spanner::Connection::ReadParams p) {
+    EXPECT_THAT(p.columns, ElementsAre("Value", "Id"));
+    EXPECT_EQ(3, ToProto(p.keys).keys_size());
+    // There is no row for key 2.
+    return MakeStream({3, 1});
+  });
+  // The batch is sent once full, the test does not wait for the window.
+  auto conn = std::make_shared<ReadCoalescingConnection>(mock, MakeOptions(3));
+  auto results = ConcurrentReads(conn, {1, 2, 3});
+  EXPECT_THAT(results[0], ElementsAre("v1"));
+  EXPECT_THAT(results[1], IsEmpty());
+  EXPECT_THAT(results[2], ElementsAre("v3"));
+}
+
+TEST(ReadCoalescingConnectionTest, MergedReadError) {
+  auto mock = std::make_shared<MockConnection>();
+  EXPECT_CALL(*mock, Read(_)).WillOnce([](spanner::Connection::ReadParams) {
+    return MakeStream({1}, Status(StatusCode::kUnavailable, "try-again"));
+  });
+  auto conn = std::make_shared<ReadCoalescingConnection>(mock, MakeOptions(2));
+  auto results = ConcurrentReads(conn, {1, 2});
+  // The row for key 1 was received before the error.
+  EXPECT_THAT(results[0], ElementsAre("v1"));
+  EXPECT_THAT(results[1], ElementsAre("try-again"));
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
@@ -66,6 +66,7 @@ class Session {
   // thread-safe manner (i.e. using external locking).
   Clock::time_point last_use_time() const { return last_use_time_; }
   void update_last_use_time() { last_use_time_ = clock_->Now(); }
+  void set_last_use_time(Clock::time_point t) { last_use_time_ = t; }
 
   std::string const session_name_;
   std::shared_ptr<Channel> const channel_;
@@ -23,8 +23,11 @@
 #include "absl/memory/memory.h"
 #include <algorithm>
 #include <chrono>
+#include <functional>
+#include <iterator>
 #include <random>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -78,12 +81,22 @@ SessionPool::SessionPool(spanner::Database db,
   }
   // `channels_` is never resized after this point.
   next_dissociated_stub_channel_ = channels_.begin();
+
+  if (options_.idle_session_shards() > 1) {
+    idle_shards_.reserve(options_.idle_session_shards());
+    for (int i = 0; i != options_.idle_session_shards(); ++i) {
+      idle_shards_.push_back(absl::make_unique<IdleShard>());
+    }
+  }
 }
 
 void SessionPool::Initialize() {
   if (options_.min_sessions() > 0) {
     std::unique_lock<std::mutex> lk(mu_);
-    (void)Grow(lk, options_.min_sessions(), WaitForSessionAllocation::kWait);
+    (void)Grow(lk, options_.min_sessions(),
+               options_.wait_for_min_sessions()
+                   ? WaitForSessionAllocation::kWait
+                   : WaitForSessionAllocation::kNoWait);
   }
   ScheduleBackgroundWork(std::chrono::seconds(5));
 }
@@ -120,6 +133,7 @@ void SessionPool::ScheduleBackgroundWork(std::chrono::seconds relative_time) {
 void SessionPool::DoBackgroundWork() {
   MaintainPoolSize();
   RefreshExpiringSessions();
+  if (options_.metrics_callback()) options_.metrics_callback()(Metrics());
   ScheduleBackgroundWork(std::chrono::seconds(5));
 }
 
@@ -129,47 +143,192 @@ void SessionPool::MaintainPoolSize() {
   std::unique_lock<std::mutex> lk(mu_);
   if (create_calls_in_progress_ == 0 &&
       total_sessions_ < options_.min_sessions()) {
-    Grow(lk, total_sessions_ - options_.min_sessions(),
+    Grow(lk, options_.min_sessions() - total_sessions_,
          WaitForSessionAllocation::kNoWait);
   }
+  if (options_.autoscaling()) Autoscale(lk);
+  Replenish(lk);
+}
+
+// Grow the pool when requests waited for sessions since the last run, shrink
+// it gradually when sessions stay idle for a while.
+void SessionPool::Autoscale(std::unique_lock<std::mutex>& lk) {
+  // The number of runs without waits before deleting sessions, about a minute,
+  // and the fraction of the surplus sessions deleted on each run after that.
+  auto constexpr kQuietRunsBeforeShrink = 12;
+  auto constexpr kShrinkDivisor = 10;
+  // Grow by this fraction of the pool when requests waited.
+  auto constexpr kGrowDivisor = 4;
+
+  std::int64_t waits = 0;
+  for (auto count : allocation_wait_histogram_) waits += count;
+  auto const new_waits = waits - autoscale_waits_;
+  autoscale_waits_ = waits;
+  auto const waiters = num_waiting_for_session_.load();
+  auto const idle = num_idle_sessions_.load();
+
+  if (new_waits > 0 || waiters > 0) {
+    autoscale_quiet_runs_ = 0;
+    if (create_calls_in_progress_ > 0 || total_sessions_ >= max_pool_size_) {
+      return;
+    }
+    auto const demand = static_cast<int>((std::min)(
+        new_waits + waiters, static_cast<std::int64_t>(max_pool_size_)));
+    (void)Grow(lk, (std::max)({total_sessions_ / kGrowDivisor, demand, 1}),
+               WaitForSessionAllocation::kNoWait);
+    return;
+  }
+
+  autoscale_min_idle_ = autoscale_quiet_runs_ == 0
+                            ? idle
+                            : (std::min)(autoscale_min_idle_, idle);
+  if (++autoscale_quiet_runs_ < kQuietRunsBeforeShrink) return;
+  // Sessions that stayed idle during all the quiet runs are not needed, keep
+  // `min_idle_sessions` of them and `min_sessions` in the pool.
+  auto const surplus =
+      (std::min)(autoscale_min_idle_ - options_.min_idle_sessions(),
+                 total_sessions_ - options_.min_sessions());
+  if (surplus <= 0) return;
+  auto const count = (std::max)(surplus / kShrinkDivisor, 1);
+  autoscale_min_idle_ -= count;
+  Shrink(lk, count);
+}
+
+// Remove up to `sessions_to_delete` of the least recently used idle sessions
+// from the pool and delete them, without waiting for the deletions.
+void SessionPool::Shrink(std::unique_lock<std::mutex>& lk,
+                         int sessions_to_delete) {
+  std::vector<std::unique_ptr<Session>> sessions;
+  auto take_oldest = [&](std::vector<std::unique_ptr<Session>>& idle) {
+    // Idle sessions are allocated from the back, the front holds the sessions
+    // used least recently.
+    auto const n = (std::min)(
+        idle.size(), static_cast<std::size_t>(sessions_to_delete) -
+                         sessions.size());
+    auto const end = idle.begin() + static_cast<std::ptrdiff_t>(n);
+    std::move(idle.begin(), end, std::back_inserter(sessions));
+    idle.erase(idle.begin(), end);
+  };
+  take_oldest(sessions_);
+  for (auto const& shard : idle_shards_) {
+    std::lock_guard<std::mutex> shard_lk(shard->mu);
+    take_oldest(shard->sessions);
+  }
+  if (sessions.empty()) return;
+
+  auto const deleted = static_cast<int>(sessions.size());
+  num_idle_sessions_ -= deleted;
+  total_sessions_ -= deleted;
+  sessions_deleted_ += deleted;
+  for (auto const& session : sessions) --session->channel()->session_count;
+  lk.unlock();
+  for (auto const& session : sessions) {
+    // Like keep-alive failures, deletion failures are ignored: the service
+    // eventually collects the session anyway.
+    AsyncDeleteSession(cq_, session->channel()->stub, session->session_name())
+        .then([](future<StatusOr<google::protobuf::Empty>> result) {
+          (void)result.get();
+        });
+  }
+  lk.lock();
 }
 
-// Refresh all sessions whose last-use time is older than the keep-alive
-// interval. Issues asynchronous RPCs, so this method does not block.
+void SessionPool::MaybeReplenish() {
+  if (!NeedsReplenish()) return;
+  std::unique_lock<std::mutex> lk(mu_);
+  Replenish(lk);
+}
+
+// Start creating sessions, without waiting for them, if the number of idle
+// sessions is below the low watermark. At most one such call is in progress.
+void SessionPool::Replenish(std::unique_lock<std::mutex>& lk) {
+  if (!NeedsReplenish() || create_calls_in_progress_ > 0 ||
+      total_sessions_ >= max_pool_size_) {
+    return;
+  }
+  (void)Grow(lk, options_.min_idle_sessions() - num_idle_sessions_.load(),
+             WaitForSessionAllocation::kNoWait);
+}
+
+bool SessionPool::NeedsReplenish() const {
+  return num_idle_sessions_.load() < options_.min_idle_sessions();
+}
+
+// Queue a refresh for all sessions whose last-use time is older than the
+// keep-alive interval. Issues asynchronous RPCs, so this method does not block,
+// and the sessions remain available for allocation while they are refreshed.
 void SessionPool::RefreshExpiringSessions() {
-  std::vector<std::pair<std::shared_ptr<SpannerStub>, std::string>>
-      sessions_to_refresh;
   auto now = clock_->Now();
   auto refresh_limit = now - options_.keep_alive_interval();
-  {
-    std::unique_lock<std::mutex> lk(mu_);
-    if (last_use_time_lower_bound_ <= refresh_limit) {
-      last_use_time_lower_bound_ = now;
-      for (auto const& session : sessions_) {
-        auto last_use_time = session->last_use_time();
-        if (last_use_time <= refresh_limit) {
-          sessions_to_refresh.emplace_back(session->channel()->stub,
-                                           session->session_name());
-          session->update_last_use_time();
-        } else if (last_use_time < last_use_time_lower_bound_) {
-          last_use_time_lower_bound_ = last_use_time;
-        }
+  std::unique_lock<std::mutex> lk(mu_);
+  if (last_use_time_lower_bound_ <= refresh_limit) {
+    // Refreshed sessions are treated as if they were last used up to a quarter
+    // of the interval ago. Sessions created (or refreshed) together thus drift
+    // apart, and their refreshes spread over the interval.
+    auto const max_jitter =
+        std::chrono::duration_cast<Session::Clock::duration>(
+            options_.keep_alive_interval()) /
+        4;
+    std::uniform_int_distribution<Session::Clock::duration::rep> jitter(
+        0, (std::max)(max_jitter.count(), Session::Clock::duration::rep{0}));
+    last_use_time_lower_bound_ = now;
+    auto visit = [&](std::unique_ptr<Session> const& session) {
+      auto last_use_time = session->last_use_time();
+      if (last_use_time <= refresh_limit) {
+        refresh_queue_.emplace_back(session->channel()->stub,
+                                    session->session_name());
+        last_use_time =
+            now - Session::Clock::duration(jitter(random_generator_));
+        session->set_last_use_time(last_use_time);
       }
+      if (last_use_time < last_use_time_lower_bound_) {
+        last_use_time_lower_bound_ = last_use_time;
+      }
+    };
+    for (auto const& session : sessions_) visit(session);
+    for (auto const& shard : idle_shards_) {
+      std::lock_guard<std::mutex> shard_lk(shard->mu);
+      for (auto const& session : shard->sessions) visit(session);
     }
   }
-  for (auto& refresh : sessions_to_refresh) {
+  StartRefreshes(std::move(lk));
+}
+
+// Send queued refreshes, up to the configured number of concurrent requests.
+void SessionPool::StartRefreshes(std::unique_lock<std::mutex> lk) {
+  auto const max_in_progress =
+      (std::max)(options_.max_concurrent_keep_alive_refreshes(), 1);
+  std::vector<std::pair<std::shared_ptr<SpannerStub>, std::string>> refreshes;
+  while (refreshes_in_progress_ < max_in_progress && !refresh_queue_.empty()) {
+    refreshes.push_back(std::move(refresh_queue_.front()));
+    refresh_queue_.pop_front();
+    ++refreshes_in_progress_;
+  }
+  keep_alive_refreshes_ += static_cast<std::int64_t>(refreshes.size());
+  lk.unlock();
+
+  if (refreshes.empty()) return;
+  std::weak_ptr<SessionPool> pool = shared_from_this();
+  for (auto& refresh : refreshes) {
     AsyncRefreshSession(cq_, refresh.first, std::move(refresh.second))
-        .then([](future<StatusOr<spanner_proto::ResultSet>> result) {
+        .then([pool](future<StatusOr<spanner_proto::ResultSet>> result) {
           // We simply discard the response as handling IsSessionNotFound()
           // by removing the session from the pool is problematic (and would
           // not eliminate the possibility of IsSessionNotFound() elsewhere).
           // The last-use time has already been updated to throttle attempts.
           // TODO(#1430): Re-evaluate these decisions.
           (void)result.get();
+          if (auto shared_pool = pool.lock()) shared_pool->HandleRefreshDone();
         });
   }
 }
 
+void SessionPool::HandleRefreshDone() {
+  std::unique_lock<std::mutex> lk(mu_);
+  --refreshes_in_progress_;
+  StartRefreshes(std::move(lk));
+}
+
 /**
  * Grow the session pool by creating up to `sessions_to_create` sessions and
  * adding them to the pool.  Note that `lk` may be released and reacquired in
@@ -247,32 +406,56 @@ SessionPool::ComputeCreateCounts(int sessions_to_create) {
 Status SessionPool::CreateSessions(
     std::vector<CreateCount> const& create_counts,
     WaitForSessionAllocation wait) {
-  Status return_status;
-  for (auto const& op : create_counts) {
-    switch (wait) {
-      case WaitForSessionAllocation::kWait: {
-        Status status =
-            CreateSessionsSync(op.channel, options_.labels(), op.session_count);
-        if (!status.ok()) {
-          return_status = status;
-        }
-        break;
-      }
-      case WaitForSessionAllocation::kNoWait:
-        CreateSessionsAsync(op.channel, options_.labels(), op.session_count);
-        break;
+  if (wait == WaitForSessionAllocation::kNoWait) {
+    for (auto const& op : create_counts) {
+      CreateSessionsAsync(op.channel, options_.labels(), op.session_count);
     }
+    return Status();
+  }
+
+  // Each call is a round trip to the service, create the sessions on all the
+  // channels in parallel, the last one on this thread.
+  std::vector<Status> statuses(create_counts.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i + 1 < create_counts.size(); ++i) {
+    threads.emplace_back([this, &create_counts, &statuses, i] {
+      auto const& op = create_counts[i];
+      statuses[i] =
+          CreateSessionsSync(op.channel, options_.labels(), op.session_count);
+    });
+  }
+  if (!create_counts.empty()) {
+    auto const& op = create_counts.back();
+    statuses.back() =
+        CreateSessionsSync(op.channel, options_.labels(), op.session_count);
+  }
+  for (auto& t : threads) t.join();
+
+  Status return_status;
+  for (auto& status : statuses) {
+    if (!status.ok()) return_status = std::move(status);
   }
   return return_status;
 }
 
 StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
+  // Fast path: take an idle session without acquiring `mu_`. Dissociated
+  // sessions change the pool counters, so they always use the slow path.
+  if (!dissociate_from_pool && !idle_shards_.empty()) {
+    auto session = TakeFromShards();
+    if (session) {
+      ++allocations_;
+      MaybeReplenish();
+      return {MakeSessionHolder(std::move(session), false)};
+    }
+  }
+
   std::unique_lock<std::mutex> lk(mu_);
   for (;;) {
-    if (!sessions_.empty()) {
-      // return the most recently used session.
-      auto session = std::move(sessions_.back());
-      sessions_.pop_back();
+    // return the most recently used session.
+    auto session = TakeIdleSession();
+    if (session) {
+      ++allocations_;
       if (dissociate_from_pool) {
         --total_sessions_;
         auto const& channel = session->channel();
@@ -280,6 +463,7 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
           --channel->session_count;
         }
       }
+      Replenish(lk);
       return {MakeSessionHolder(std::move(session), dissociate_from_pool)};
     }
 
@@ -291,7 +475,7 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
         return Status(StatusCode::kResourceExhausted, "session pool exhausted");
       }
       Wait(lk, [this] {
-        return !sessions_.empty() || total_sessions_ < max_pool_size_;
+        return HasIdleSession() || total_sessions_ < max_pool_size_;
       });
       continue;
     }
@@ -304,7 +488,7 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
     // number of waiters in the `sessions_to_create` calculation below.
     if (create_calls_in_progress_ > 0) {
       Wait(lk, [this] {
-        return !sessions_.empty() || create_calls_in_progress_ == 0;
+        return HasIdleSession() || create_calls_in_progress_ == 0;
       });
       continue;
     }
@@ -336,7 +520,112 @@ std::shared_ptr<SpannerStub> SessionPool::GetStub(Session const& session) {
   return stub;
 }
 
+spanner::SessionPoolMetrics SessionPool::Metrics() {
+  spanner::SessionPoolMetrics metrics;
+  std::lock_guard<std::mutex> lk(mu_);
+  std::unordered_map<Channel const*, std::size_t> index;
+  metrics.channels.resize(channels_.size());
+  for (std::size_t i = 0; i != channels_.size(); ++i) {
+    index.emplace(channels_[i].get(), i);
+    metrics.channels[i].total_sessions = channels_[i]->session_count;
+  }
+  auto count_idle = [&](std::unique_ptr<Session> const& session) {
+    auto i = index.find(session->channel().get());
+    if (i != index.end()) ++metrics.channels[i->second].idle_sessions;
+  };
+  for (auto const& session : sessions_) count_idle(session);
+  for (auto const& shard : idle_shards_) {
+    std::lock_guard<std::mutex> shard_lk(shard->mu);
+    for (auto const& session : shard->sessions) count_idle(session);
+  }
+  for (auto& c : metrics.channels) {
+    c.in_use_sessions = c.total_sessions - c.idle_sessions;
+    metrics.total_sessions += c.total_sessions;
+    metrics.idle_sessions += c.idle_sessions;
+    metrics.in_use_sessions += c.in_use_sessions;
+  }
+  metrics.waiters = num_waiting_for_session_.load();
+  metrics.create_calls_in_progress = create_calls_in_progress_;
+  metrics.create_calls = create_calls_;
+  metrics.create_call_failures = create_call_failures_;
+  metrics.create_latency_total = create_latency_total_;
+  metrics.create_latency_max = create_latency_max_;
+  metrics.allocations = allocations_.load();
+  metrics.allocation_wait_histogram = allocation_wait_histogram_;
+  metrics.keep_alive_refreshes = keep_alive_refreshes_;
+  metrics.sessions_deleted = sessions_deleted_;
+  return metrics;
+}
+
+void SessionPool::RecordWait(std::chrono::nanoseconds elapsed) {
+  std::size_t bucket = 0;
+  auto bound = std::chrono::nanoseconds(std::chrono::milliseconds(1));
+  while (bucket + 1 < allocation_wait_histogram_.size() && elapsed >= bound) {
+    ++bucket;
+    bound *= 10;
+  }
+  ++allocation_wait_histogram_[bucket];
+}
+
+std::unique_ptr<Session> SessionPool::TakeIdleSession() {
+  if (!sessions_.empty()) {
+    auto session = std::move(sessions_.back());
+    sessions_.pop_back();
+    --num_idle_sessions_;
+    return session;
+  }
+  if (idle_shards_.empty()) return nullptr;
+  return TakeFromShards();
+}
+
+bool SessionPool::HasIdleSession() {
+  if (!sessions_.empty()) return true;
+  for (auto const& shard : idle_shards_) {
+    std::lock_guard<std::mutex> shard_lk(shard->mu);
+    if (!shard->sessions.empty()) return true;
+  }
+  return false;
+}
+
+std::unique_ptr<Session> SessionPool::TakeFromShards() {
+  auto const count = idle_shards_.size();
+  auto const home = HomeShardIndex();
+  for (std::size_t i = 0; i != count; ++i) {
+    auto& shard = *idle_shards_[(home + i) % count];
+    std::lock_guard<std::mutex> shard_lk(shard.mu);
+    if (shard.sessions.empty()) continue;
+    auto session = std::move(shard.sessions.back());
+    shard.sessions.pop_back();
+    --num_idle_sessions_;
+    return session;
+  }
+  return nullptr;
+}
+
+std::size_t SessionPool::HomeShardIndex() const {
+  return std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+         idle_shards_.size();
+}
+
 void SessionPool::Release(std::unique_ptr<Session> session) {
+  if (!idle_shards_.empty() && !session->is_bad()) {
+    session->update_last_use_time();
+    auto& shard = *idle_shards_[HomeShardIndex()];
+    {
+      std::lock_guard<std::mutex> shard_lk(shard.mu);
+      shard.sessions.push_back(std::move(session));
+    }
+    ++num_idle_sessions_;
+    // A waiting thread increments the counter and then checks the shards with
+    // `mu_` held. Acquiring `mu_` here guarantees it either found this session
+    // or is blocked on `cond_` and receives the notification.
+    if (num_waiting_for_session_.load() > 0) {
+      { std::lock_guard<std::mutex> lk(mu_); }
+      cond_.notify_one();
+    }
+    return;
+  }
+
   std::unique_lock<std::mutex> lk(mu_);
   if (session->is_bad()) {
     // Once we have support for background processing, we may want to signal
@@ -350,6 +639,7 @@ void SessionPool::Release(std::unique_ptr<Session> session) {
   }
   session->update_last_use_time();
   sessions_.push_back(std::move(session));
+  ++num_idle_sessions_;
   if (num_waiting_for_session_ > 0) {
     lk.unlock();
     cond_.notify_one();
@@ -366,6 +656,7 @@ Status SessionPool::CreateSessionsSync(
                                                                labels.end());
   request.set_session_count(std::int32_t{num_sessions});
   auto const& stub = channel->stub;
+  auto const start = std::chrono::steady_clock::now();
   auto response = RetryLoop(
       retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
       google::cloud::internal::Idempotency::kIdempotent,
@@ -374,20 +665,23 @@ Status SessionPool::CreateSessionsSync(
         return stub->BatchCreateSessions(context, request);
       },
       request, __func__);
-  return HandleBatchCreateSessionsDone(channel, std::move(response));
+  return HandleBatchCreateSessionsDone(
+      channel, std::move(response), std::chrono::steady_clock::now() - start);
 }
 
 void SessionPool::CreateSessionsAsync(
     std::shared_ptr<Channel> const& channel,
     std::map<std::string, std::string> const& labels, int num_sessions) {
   std::weak_ptr<SessionPool> pool = shared_from_this();
+  auto const start = std::chrono::steady_clock::now();
   AsyncBatchCreateSessions(cq_, channel->stub, labels, num_sessions)
-      .then([pool, channel](
+      .then([pool, channel, start](
                 future<StatusOr<spanner_proto::BatchCreateSessionsResponse>>
                     result) {
         if (auto shared_pool = pool.lock()) {
-          shared_pool->HandleBatchCreateSessionsDone(channel,
-                                                     std::move(result).get());
+          shared_pool->HandleBatchCreateSessionsDone(
+              channel, std::move(result).get(),
+              std::chrono::steady_clock::now() - start);
         }
       });
 }
@@ -464,10 +758,21 @@ future<StatusOr<spanner_proto::ResultSet>> SessionPool::AsyncRefreshSession(
 
 Status SessionPool::HandleBatchCreateSessionsDone(
     std::shared_ptr<Channel> const& channel,
-    StatusOr<spanner_proto::BatchCreateSessionsResponse> response) {
+    StatusOr<spanner_proto::BatchCreateSessionsResponse> response,
+    std::chrono::nanoseconds latency) {
+  google::cloud::internal::RecordDuration("spanner.session_pool.create",
+                                          latency);
   std::unique_lock<std::mutex> lk(mu_);
   --create_calls_in_progress_;
+  ++create_calls_;
+  create_latency_total_ += latency;
+  create_latency_max_ = (std::max)(create_latency_max_, latency);
   if (!response.ok()) {
+    ++create_call_failures_;
+    // Wake up anyone waiting for this call to complete, they will try to
+    // create the sessions themselves.
+    lk.unlock();
+    cond_.notify_all();
     return response.status();
   }
   // Add sessions to the pool and update counters for `channel` and the pool.
@@ -479,6 +784,7 @@ Status SessionPool::HandleBatchCreateSessionsDone(
     sessions_.push_back(absl::make_unique<Session>(
         std::move(*session.mutable_name()), channel, clock_));
   }
+  num_idle_sessions_ += sessions_created;
   // Shuffle the pool so we distribute returned sessions across channels.
   std::shuffle(sessions_.begin(), sessions_.end(), random_generator_);
 
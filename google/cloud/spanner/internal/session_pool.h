@@ -21,17 +21,23 @@
 #include "google/cloud/spanner/internal/session.h"
 #include "google/cloud/spanner/internal/spanner_stub.h"
 #include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/spanner/session_pool_metrics.h"
 #include "google/cloud/spanner/session_pool_options.h"
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/backoff_policy.h"
 #include "google/cloud/completion_queue.h"
 #include "google/cloud/future.h"
+#include "google/cloud/instrumentation.h"
 #include "google/cloud/status_or.h"
 #include "absl/container/fixed_array.h"
 #include <google/spanner/v1/spanner.pb.h>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -58,6 +64,12 @@ struct SessionPoolFriendForTest;
  * Allocation from the pool is LIFO to take advantage of the fact the Spanner
  * backends maintain a cache of sessions which is valid for 30 seconds, so
  * re-using Sessions as quickly as possible has performance advantages.
+ *
+ * If `SessionPoolOptions::idle_session_shards()` is greater than one, the
+ * sessions released by the application are kept in several lists, each with
+ * its own mutex. Threads release to (and allocate from) a list selected by
+ * their thread id, and take sessions from the other lists only when their own
+ * list is empty. In that case allocation is LIFO within each list.
  */
 class SessionPool : public std::enable_shared_from_this<SessionPool> {
  public:
@@ -102,6 +114,9 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
    */
   std::shared_ptr<SpannerStub> GetStub(Session const& session);
 
+  /// Return a snapshot of the pool state, see `spanner::SessionPoolMetrics`.
+  spanner::SessionPoolMetrics Metrics();
+
  private:
   // Represents a request to create `session_count` sessions on `channel`
   // See `ComputeCreateCounts` and `CreateSessions`.
@@ -111,17 +126,47 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   };
   enum class WaitForSessionAllocation { kWait, kNoWait };
 
+  // A list of idle sessions, see `idle_shards_`.
+  struct IdleShard {
+    std::mutex mu;
+    std::vector<std::unique_ptr<Session>> sessions;  // GUARDED_BY(mu)
+  };
+
   // Release session back to the pool.
   void Release(std::unique_ptr<Session> session);
 
+  // Remove and return an idle session from `sessions_` or `idle_shards_`, or
+  // return `nullptr` if there are no idle sessions.
+  std::unique_ptr<Session> TakeIdleSession();  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+  bool HasIdleSession();                       // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // Remove and return an idle session from `idle_shards_`, starting with the
+  // shard for the calling thread.
+  std::unique_ptr<Session> TakeFromShards();
+  std::size_t HomeShardIndex() const;
+
   // Called when a thread needs to wait for a `Session` to become available.
   // @p specifies the condition to wait for.
   template <typename Predicate>
   void Wait(std::unique_lock<std::mutex>& lk, Predicate&& p) {
+    auto const start = std::chrono::steady_clock::now();
     ++num_waiting_for_session_;
     cond_.wait(lk, std::forward<Predicate>(p));
     --num_waiting_for_session_;
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    RecordWait(elapsed);
+    google::cloud::internal::RecordDuration("spanner.session_pool.wait",
+                                            elapsed);
   }
+  void RecordWait(
+      std::chrono::nanoseconds elapsed);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // Create sessions in the background if the number of idle sessions is
+  // below `options_.min_idle_sessions()`.
+  void MaybeReplenish();  // LOCKS_EXCLUDED(mu_)
+  void Replenish(
+      std::unique_lock<std::mutex>& lk);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+  bool NeedsReplenish() const;
 
   Status Grow(std::unique_lock<std::mutex>& lk, int sessions_to_create,
               WaitForSessionAllocation wait);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
@@ -155,12 +200,17 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
 
   Status HandleBatchCreateSessionsDone(
       std::shared_ptr<Channel> const& channel,
-      StatusOr<google::spanner::v1::BatchCreateSessionsResponse> response);
+      StatusOr<google::spanner::v1::BatchCreateSessionsResponse> response,
+      std::chrono::nanoseconds latency);
 
   void ScheduleBackgroundWork(std::chrono::seconds relative_time);
   void DoBackgroundWork();
   void MaintainPoolSize();
+  void Autoscale(std::unique_lock<std::mutex>& lk);
+  void Shrink(std::unique_lock<std::mutex>& lk, int sessions_to_delete);
   void RefreshExpiringSessions();
+  void StartRefreshes(std::unique_lock<std::mutex> lk);
+  void HandleRefreshDone();
 
   spanner::Database const db_;
   spanner::SessionPoolOptions const options_;
@@ -176,14 +226,47 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   std::vector<std::unique_ptr<Session>> sessions_;  // GUARDED_BY(mu_)
   int total_sessions_ = 0;                          // GUARDED_BY(mu_)
   int create_calls_in_progress_ = 0;                // GUARDED_BY(mu_)
-  int num_waiting_for_session_ = 0;                 // GUARDED_BY(mu_)
+  // Read without `mu_` held when releasing sessions to `idle_shards_`.
+  std::atomic<int> num_waiting_for_session_{0};
+  // The number of sessions in `sessions_` and `idle_shards_`. Read without
+  // `mu_` held to decide whether to replenish the pool.
+  std::atomic<int> num_idle_sessions_{0};
+
+  // The counters reported by `Metrics()`.
+  std::atomic<std::int64_t> allocations_{0};
+  std::int64_t create_calls_ = 0;                            // GUARDED_BY(mu_)
+  std::int64_t create_call_failures_ = 0;                    // GUARDED_BY(mu_)
+  std::chrono::nanoseconds create_latency_total_{0};         // GUARDED_BY(mu_)
+  std::chrono::nanoseconds create_latency_max_{0};           // GUARDED_BY(mu_)
+  std::array<std::int64_t, 6> allocation_wait_histogram_{};  // GUARDED_BY(mu_)
+  std::int64_t keep_alive_refreshes_ = 0;                    // GUARDED_BY(mu_)
+  std::int64_t sessions_deleted_ = 0;                        // GUARDED_BY(mu_)
+
+  // The state used by `Autoscale()`: the number of waits seen on its last
+  // run, the consecutive runs without waits, and the fewest idle sessions
+  // seen during those runs.
+  std::int64_t autoscale_waits_ = 0;  // GUARDED_BY(mu_)
+  int autoscale_quiet_runs_ = 0;      // GUARDED_BY(mu_)
+  int autoscale_min_idle_ = 0;        // GUARDED_BY(mu_)
 
   // Lower bound on all `sessions_[i]->last_use_time()` values.
   Session::Clock::time_point last_use_time_lower_bound_ =
       clock_->Now();  // GUARDED_BY(mu_)
 
+  // The sessions waiting for a keep-alive request, and the number of requests
+  // in progress, bounded by `options_.max_concurrent_keep_alive_refreshes()`.
+  std::deque<std::pair<std::shared_ptr<SpannerStub>, std::string>>
+      refresh_queue_;              // GUARDED_BY(mu_)
+  int refreshes_in_progress_ = 0;  // GUARDED_BY(mu_)
+
   future<void> current_timer_;
 
+  // Only used if `options_.idle_session_shards() > 1`, holds the sessions
+  // released by the application. Allocating and releasing sessions from these
+  // lists does not require `mu_`. Not resized after the constructor runs.
+  // Lock ordering: `mu_` must be acquired before any `IdleShard::mu`.
+  std::vector<std::unique_ptr<IdleShard>> idle_shards_;
+
   // `channels_` is guaranteed to be non-empty and will not be resized after
   // the constructor runs.
   // n.b. `FixedArray` iterators are never invalidated.
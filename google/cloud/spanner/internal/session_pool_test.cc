@@ -44,6 +44,7 @@ using ::google::cloud::testing_util::MockAsyncResponseReader;
 using ::google::cloud::testing_util::StatusIs;
 using ::google::protobuf::TextFormat;
 using ::testing::_;
+using ::testing::AnyOf;
 using ::testing::ByMove;
 using ::testing::HasSubstr;
 using ::testing::Return;
@@ -250,6 +251,87 @@ TEST(SessionPool, MinSessionsMultipleAllocations) {
               UnorderedElementsAre("s1", "s2", "s3", "s4", "s5", "s6", "s7"));
 }
 
+TEST(SessionPool, MinSessionsNoWait) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  auto reader = absl::make_unique<StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>>();
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(3), _))
+      .WillOnce([&reader](grpc::ClientContext&,
+                          spanner_proto::BatchCreateSessionsRequest const&,
+                          grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::BatchCreateSessionsResponse>>(reader.get());
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](spanner_proto::BatchCreateSessionsResponse* response,
+                   grpc::Status* status, void*) {
+        *response = MakeSessionsResponse({"s1", "s2", "s3"});
+        *status = grpc::Status::OK;
+      });
+
+  auto db = spanner::Database("project", "instance", "database");
+  spanner::SessionPoolOptions options;
+  options.set_min_sessions(3).set_wait_for_min_sessions(false);
+  auto impl = std::make_shared<FakeCompletionQueueImpl>();
+  auto pool = MakeSessionPool(db, {mock}, options, CompletionQueue(impl));
+
+  // The sessions are created in the background, the mock would reject any
+  // synchronous `BatchCreateSessions()` call.
+  impl->SimulateCompletion(true);
+  std::vector<SessionHolder> sessions;
+  for (int i = 0; i != 3; ++i) {
+    auto session = pool->Allocate();
+    ASSERT_STATUS_OK(session);
+    sessions.push_back(*std::move(session));
+  }
+}
+
+TEST(SessionPool, ReplenishIdleSessions) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, SessionCountIs(1)))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+  auto reader = absl::make_unique<StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>>();
+  // Allocating "s1" leaves no idle sessions, so the pool creates two more in
+  // the background.
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(2), _))
+      .WillOnce([&reader](grpc::ClientContext&,
+                          spanner_proto::BatchCreateSessionsRequest const&,
+                          grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::BatchCreateSessionsResponse>>(reader.get());
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](spanner_proto::BatchCreateSessionsResponse* response,
+                   grpc::Status* status, void*) {
+        *response = MakeSessionsResponse({"s2", "s3"});
+        *status = grpc::Status::OK;
+      });
+
+  auto db = spanner::Database("project", "instance", "database");
+  spanner::SessionPoolOptions options;
+  options.set_min_idle_sessions(2).set_max_sessions_per_channel(3);
+  auto impl = std::make_shared<FakeCompletionQueueImpl>();
+  auto pool = MakeSessionPool(db, {mock}, options, CompletionQueue(impl));
+
+  auto s1 = pool->Allocate();
+  ASSERT_STATUS_OK(s1);
+  EXPECT_EQ("s1", (*s1)->session_name());
+  impl->SimulateCompletion(true);
+
+  // The pool is at its maximum size, allocating more sessions does not
+  // create any more.
+  auto s2 = pool->Allocate();
+  ASSERT_STATUS_OK(s2);
+  auto s3 = pool->Allocate();
+  ASSERT_STATUS_OK(s3);
+  EXPECT_THAT((std::vector<std::string>{(*s2)->session_name(),
+                                        (*s3)->session_name()}),
+              UnorderedElementsAre("s2", "s3"));
+}
+
 TEST(SessionPool, MaxSessionsFailOnExhaustion) {
   int const max_sessions_per_channel = 3;
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
@@ -305,6 +387,65 @@ TEST(SessionPool, MaxSessionsBlockUntilRelease) {
   t.join();
 }
 
+TEST(SessionPool, IdleShardsLifo) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = spanner::Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"session1"}))))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"session2"}))));
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(
+      db, {mock}, spanner::SessionPoolOptions{}.set_idle_session_shards(8),
+      threads.cq());
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  auto session2 = pool->Allocate();
+  ASSERT_STATUS_OK(session2);
+
+  session->reset();
+  session2->reset();
+
+  // Both sessions were released to the shard for this thread, which is also
+  // Last-In-First-Out.
+  auto session3 = pool->Allocate();
+  ASSERT_STATUS_OK(session3);
+  EXPECT_EQ((*session3)->session_name(), "session2");
+  auto session4 = pool->Allocate();
+  ASSERT_STATUS_OK(session4);
+  EXPECT_EQ((*session4)->session_name(), "session1");
+}
+
+TEST(SessionPool, IdleShardsManyThreads) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = spanner::Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1", "s2"}))));
+
+  spanner::SessionPoolOptions options;
+  options.set_max_sessions_per_channel(2)
+      .set_action_on_exhaustion(spanner::ActionOnExhaustion::kBlock)
+      .set_idle_session_shards(4);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+
+  // More threads than sessions, so some of them block until another thread
+  // releases a session, possibly to a different shard.
+  auto constexpr kThreadCount = 8;
+  auto constexpr kIterations = 100;
+  std::vector<std::thread> tasks;
+  for (int i = 0; i != kThreadCount; ++i) {
+    tasks.emplace_back([&pool] {
+      for (int j = 0; j != kIterations; ++j) {
+        auto session = pool->Allocate();
+        ASSERT_STATUS_OK(session);
+        EXPECT_THAT((*session)->session_name(), AnyOf("s1", "s2"));
+      }
+    });
+  }
+  for (auto& t : tasks) t.join();
+}
+
 TEST(SessionPool, Labels) {
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
   auto db = spanner::Database("project", "instance", "database");
@@ -462,6 +603,239 @@ TEST(SessionPool, SessionRefresh) {
   impl->SimulateCompletion(true);
 }
 
+TEST(SessionPool, SessionRefreshBoundedConcurrency) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1", "s2", "s3"}))));
+
+  auto reader = absl::make_unique<
+      StrictMock<MockAsyncResponseReader<spanner_proto::ResultSet>>>();
+  std::vector<std::string> refreshed;
+  EXPECT_CALL(*mock, AsyncExecuteSql(_, _, _))
+      .Times(3)
+      .WillRepeatedly([&](grpc::ClientContext&,
+                          spanner_proto::ExecuteSqlRequest const& request,
+                          grpc::CompletionQueue*) {
+        refreshed.push_back(request.session());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<
+            grpc::ClientAsyncResponseReaderInterface<spanner_proto::ResultSet>>(
+            reader.get());
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .Times(3)
+      .WillRepeatedly([](spanner_proto::ResultSet*, grpc::Status* status,
+                         void*) { *status = grpc::Status::OK; });
+
+  auto db = spanner::Database("project", "instance", "database");
+  spanner::SessionPoolOptions options;
+  options.set_min_sessions(3)
+      .set_keep_alive_interval(std::chrono::seconds(1))
+      .set_max_concurrent_keep_alive_refreshes(1);
+  auto impl = std::make_shared<FakeCompletionQueueImpl>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+  clock->AdvanceTime(options.keep_alive_interval() * 2);
+
+  // The background task queues all three sessions, but sends a single
+  // request, the next one is sent only when the previous one completes.
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(1, refreshed.size());
+  EXPECT_EQ(1, pool->Metrics().keep_alive_refreshes);
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(2, refreshed.size());
+  impl->SimulateCompletion(true);
+  EXPECT_THAT(refreshed, UnorderedElementsAre("s1", "s2", "s3"));
+
+  // The refreshed sessions do not need another refresh yet, and remain
+  // available for allocation.
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(3, pool->Metrics().keep_alive_refreshes);
+  EXPECT_EQ(3, pool->Metrics().idle_sessions);
+}
+
+TEST(SessionPool, AutoscalingGrowsAfterWaits) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  auto reader = absl::make_unique<StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>>();
+  // The initial session, and the sessions added after a request waited.
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(1), _))
+      .Times(2)
+      .WillRepeatedly(
+          [&reader](grpc::ClientContext&,
+                    spanner_proto::BatchCreateSessionsRequest const&,
+                    grpc::CompletionQueue*) {
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::BatchCreateSessionsResponse>>(reader.get());
+          });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](spanner_proto::BatchCreateSessionsResponse* response,
+                   grpc::Status* status, void*) {
+        *response = MakeSessionsResponse({"s1"});
+        *status = grpc::Status::OK;
+      });
+
+  auto db = spanner::Database("project", "instance", "database");
+  spanner::SessionPoolOptions options;
+  options.set_min_sessions(1).set_wait_for_min_sessions(false).set_autoscaling(
+      true);
+  auto impl = std::make_shared<FakeCompletionQueueImpl>();
+  auto pool = MakeSessionPool(db, {mock}, options, CompletionQueue(impl));
+
+  // This thread waits for the initial session.
+  std::thread t([&pool] {
+    auto session = pool->Allocate();
+    EXPECT_STATUS_OK(session);
+  });
+  while (pool->Metrics().waiters == 0) std::this_thread::yield();
+
+  // Complete the initial `BatchCreateSessions()` call, and run the background
+  // task, which creates more sessions ahead of the next request.
+  impl->SimulateCompletion(true);
+  t.join();
+  auto metrics = pool->Metrics();
+  EXPECT_EQ(1, metrics.total_sessions);
+  EXPECT_EQ(1, metrics.create_calls_in_progress);
+}
+
+TEST(SessionPool, AutoscalingShrinksIdleSessions) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  std::vector<std::string> names;
+  for (int i = 0; i != 20; ++i) names.push_back("s" + std::to_string(i));
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse(names))));
+
+  auto reader = absl::make_unique<
+      StrictMock<MockAsyncResponseReader<google::protobuf::Empty>>>();
+  std::vector<std::string> deleted;
+  EXPECT_CALL(*mock, AsyncDeleteSession(_, _, _))
+      .WillRepeatedly([&](grpc::ClientContext&,
+                          spanner_proto::DeleteSessionRequest const& request,
+                          grpc::CompletionQueue*) {
+        deleted.push_back(request.name());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<
+            grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>(
+            reader.get());
+      });
+
+  auto db = spanner::Database("project", "instance", "database");
+  spanner::SessionPoolOptions options;
+  options.set_min_sessions(0).set_min_idle_sessions(2).set_autoscaling(true);
+  auto impl = std::make_shared<FakeCompletionQueueImpl>();
+  auto pool = MakeSessionPool(db, {mock}, options, CompletionQueue(impl));
+  // Creates all 20 sessions, which then stay idle.
+  ASSERT_STATUS_OK(pool->Allocate());
+
+  // The pool waits for a number of background runs without waits before
+  // deleting any sessions.
+  for (int i = 0; i != 11; ++i) impl->SimulateCompletion(true);
+  EXPECT_TRUE(deleted.empty());
+
+  // Then deletes a tenth of the surplus idle sessions on each run.
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(1, deleted.size());
+  auto metrics = pool->Metrics();
+  EXPECT_EQ(19, metrics.total_sessions);
+  EXPECT_EQ(19, metrics.idle_sessions);
+  EXPECT_EQ(1, metrics.sessions_deleted);
+}
+
+TEST(SessionPool, Metrics) {
+  auto mock1 = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock1, BatchCreateSessions(_, SessionCountIs(2)))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"c1s1", "c1s2"}))));
+  auto mock2 = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock2, BatchCreateSessions(_, SessionCountIs(2)))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"c2s1", "c2s2"}))));
+
+  auto db = spanner::Database("project", "instance", "database");
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(
+      db, {mock1, mock2}, spanner::SessionPoolOptions{}.set_min_sessions(4),
+      threads.cq());
+  auto s1 = pool->Allocate();
+  ASSERT_STATUS_OK(s1);
+  auto s2 = pool->Allocate();
+  ASSERT_STATUS_OK(s2);
+
+  auto metrics = pool->Metrics();
+  ASSERT_EQ(2, metrics.channels.size());
+  EXPECT_EQ(2, metrics.channels[0].total_sessions);
+  EXPECT_EQ(2, metrics.channels[1].total_sessions);
+  EXPECT_EQ(4, metrics.total_sessions);
+  EXPECT_EQ(2, metrics.idle_sessions);
+  EXPECT_EQ(2, metrics.in_use_sessions);
+  EXPECT_EQ(metrics.channels[0].in_use_sessions +
+                metrics.channels[1].in_use_sessions,
+            metrics.in_use_sessions);
+  EXPECT_EQ(0, metrics.waiters);
+  EXPECT_EQ(2, metrics.create_calls);
+  EXPECT_EQ(0, metrics.create_call_failures);
+  EXPECT_GE(metrics.create_latency_total, metrics.create_latency_max);
+  EXPECT_EQ(2, metrics.allocations);
+
+  s1->reset();
+  metrics = pool->Metrics();
+  EXPECT_EQ(3, metrics.idle_sessions);
+  EXPECT_EQ(1, metrics.in_use_sessions);
+}
+
+TEST(SessionPool, MetricsWaitHistogram) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = spanner::Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  spanner::SessionPoolOptions options;
+  options.set_max_sessions_per_channel(1).set_action_on_exhaustion(
+      spanner::ActionOnExhaustion::kBlock);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+
+  std::thread t([&pool]() {
+    auto session = pool->Allocate();
+    ASSERT_STATUS_OK(session);
+  });
+  while (pool->Metrics().waiters == 0) std::this_thread::yield();
+  session->reset();
+  t.join();
+
+  auto metrics = pool->Metrics();
+  EXPECT_EQ(0, metrics.waiters);
+  EXPECT_EQ(2, metrics.allocations);
+  std::int64_t waits = 0;
+  for (auto count : metrics.allocation_wait_histogram) waits += count;
+  EXPECT_EQ(1, waits);
+}
+
+TEST(SessionPool, MetricsCallback) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  std::vector<spanner::SessionPoolMetrics> received;
+  auto db = spanner::Database("project", "instance", "database");
+  spanner::SessionPoolOptions options;
+  options.set_min_sessions(1).set_metrics_callback(
+      [&received](spanner::SessionPoolMetrics const& m) {
+        received.push_back(m);
+      });
+  auto impl = std::make_shared<FakeCompletionQueueImpl>();
+  auto pool = MakeSessionPool(db, {mock}, options, CompletionQueue(impl));
+  EXPECT_TRUE(received.empty());
+
+  // Run the background maintenance task.
+  impl->SimulateCompletion(true);
+  ASSERT_EQ(1, received.size());
+  EXPECT_EQ(1, received[0].total_sessions);
+  EXPECT_EQ(1, received[0].idle_sessions);
+}
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner_internal
@@ -13,9 +13,12 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/spanner_stub.h"
+#include "google/cloud/spanner/internal/fault_injection_spanner_stub.h"
 #include "google/cloud/spanner/internal/logging_spanner_stub.h"
 #include "google/cloud/spanner/internal/metadata_spanner_stub.h"
 #include "google/cloud/grpc_error_delegate.h"
+#include "google/cloud/internal/channel_cache.h"
+#include "google/cloud/internal/getenv.h"
 #include "google/cloud/log.h"
 #include <google/spanner/v1/spanner.grpc.pb.h>
 
@@ -281,6 +284,14 @@ StatusOr<spanner_proto::PartitionResponse> DefaultSpannerStub::PartitionRead(
   return response;
 }
 
+// Leader-aware routing is enabled by setting
+// `GOOGLE_CLOUD_CPP_SPANNER_ROUTE_TO_LEADER` to `true`.
+bool RouteToLeader() {
+  auto v = google::cloud::internal::GetEnv(
+      "GOOGLE_CLOUD_CPP_SPANNER_ROUTE_TO_LEADER");
+  return v.has_value() && (*v == "true" || *v == "1");
+}
+
 }  // namespace
 
 std::shared_ptr<SpannerStub> CreateDefaultSpannerStub(
@@ -293,13 +304,22 @@ std::shared_ptr<SpannerStub> CreateDefaultSpannerStub(
   // its value here to allow compiling against older versions.
   channel_arguments.SetInt("grpc.channel_id", channel_id);
 
-  auto spanner_grpc_stub =
-      spanner_proto::Spanner::NewStub(grpc::CreateCustomChannel(
-          options.endpoint(), options.credentials(), channel_arguments));
+  auto channel = google::cloud::internal::CreateCustomChannel(
+      options.endpoint(), options.credentials(), channel_arguments,
+      options.channel_cache_enabled());
+  auto spanner_grpc_stub = spanner_proto::Spanner::NewStub(std::move(channel));
 
   std::shared_ptr<SpannerStub> stub =
       std::make_shared<DefaultSpannerStub>(std::move(spanner_grpc_stub));
-  stub = std::make_shared<MetadataSpannerStub>(std::move(stub), db.FullName());
+  stub = std::make_shared<MetadataSpannerStub>(std::move(stub), db.FullName(),
+                                               RouteToLeader());
+  if (options.fault_injection().enabled()) {
+    GCP_LOG(WARNING) << "Enabled fault injection for gRPC calls";
+    auto injector = std::make_shared<google::cloud::internal::FaultInjector>(
+        options.fault_injection());
+    stub = std::make_shared<FaultInjectionSpannerStub>(std::move(stub),
+                                                       std::move(injector));
+  }
 
   if (options.tracing_enabled("rpc")) {
     GCP_LOG(INFO) << "Enabled logging for gRPC calls";
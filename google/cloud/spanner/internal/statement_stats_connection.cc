@@ -0,0 +1,150 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/statement_stats_connection.h"
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace {
+
+void RecordLatency(spanner::StatementStatsRecorder& recorder,
+                   SteadyClock const& clock, std::string const& sql,
+                   SteadyClock::time_point start) {
+  recorder.Record(sql, std::chrono::duration_cast<std::chrono::microseconds>(
+                           clock.Now() - start));
+}
+
+}  // namespace
+
+StatementStatsConnection::StatementStatsConnection(
+    std::shared_ptr<spanner::Connection> child,
+    std::shared_ptr<spanner::StatementStatsRecorder> recorder,
+    std::shared_ptr<SteadyClock> clock)
+    : child_(std::move(child)),
+      recorder_(std::move(recorder)),
+      clock_(std::move(clock)) {}
+
+spanner::RowStream StatementStatsConnection::Read(ReadParams params) {
+  return child_->Read(std::move(params));
+}
+
+StatusOr<std::vector<spanner::ReadPartition>>
+StatementStatsConnection::PartitionRead(PartitionReadParams params) {
+  return child_->PartitionRead(std::move(params));
+}
+
+spanner::RowStream StatementStatsConnection::ExecuteQuery(SqlParams params) {
+  auto const start = clock_->Now();
+  auto sql = params.statement.sql();
+  auto result = child_->ExecuteQuery(std::move(params));
+  Record(sql, start);
+  return result;
+}
+
+StatusOr<spanner::DmlResult> StatementStatsConnection::ExecuteDml(
+    SqlParams params) {
+  auto const start = clock_->Now();
+  auto sql = params.statement.sql();
+  auto result = child_->ExecuteDml(std::move(params));
+  Record(sql, start);
+  return result;
+}
+
+spanner::ProfileQueryResult StatementStatsConnection::ProfileQuery(
+    SqlParams params) {
+  auto const start = clock_->Now();
+  auto sql = params.statement.sql();
+  auto result = child_->ProfileQuery(std::move(params));
+  Record(sql, start);
+  return result;
+}
+
+StatusOr<spanner::ProfileDmlResult> StatementStatsConnection::ProfileDml(
+    SqlParams params) {
+  auto const start = clock_->Now();
+  auto sql = params.statement.sql();
+  auto result = child_->ProfileDml(std::move(params));
+  Record(sql, start);
+  return result;
+}
+
+StatusOr<spanner::ExecutionPlan> StatementStatsConnection::AnalyzeSql(
+    SqlParams params) {
+  return child_->AnalyzeSql(std::move(params));
+}
+
+StatusOr<spanner::PartitionedDmlResult>
+StatementStatsConnection::ExecutePartitionedDml(
+    ExecutePartitionedDmlParams params) {
+  auto const start = clock_->Now();
+  auto sql = params.statement.sql();
+  auto result = child_->ExecutePartitionedDml(std::move(params));
+  Record(sql, start);
+  return result;
+}
+
+StatusOr<std::vector<spanner::QueryPartition>>
+StatementStatsConnection::PartitionQuery(PartitionQueryParams params) {
+  return child_->PartitionQuery(std::move(params));
+}
+
+StatusOr<spanner::BatchDmlResult> StatementStatsConnection::ExecuteBatchDml(
+    ExecuteBatchDmlParams params) {
+  return child_->ExecuteBatchDml(std::move(params));
+}
+
+StatusOr<spanner::CommitResult> StatementStatsConnection::Commit(
+    CommitParams params) {
+  return child_->Commit(std::move(params));
+}
+
+Status StatementStatsConnection::Rollback(RollbackParams params) {
+  return child_->Rollback(std::move(params));
+}
+
+future<spanner::RowStream> StatementStatsConnection::AsyncRead(
+    ReadParams params) {
+  return child_->AsyncRead(std::move(params));
+}
+
+future<spanner::RowStream> StatementStatsConnection::AsyncExecuteQuery(
+    SqlParams params) {
+  auto const start = clock_->Now();
+  auto sql = params.statement.sql();
+  auto recorder = recorder_;
+  auto clock = clock_;
+  return child_->AsyncExecuteQuery(std::move(params))
+      .then([recorder, clock, sql, start](future<spanner::RowStream> f) {
+        RecordLatency(*recorder, *clock, sql, start);
+        return f.get();
+      });
+}
+
+future<StatusOr<spanner::CommitResult>> StatementStatsConnection::AsyncCommit(
+    CommitParams params) {
+  return child_->AsyncCommit(std::move(params));
+}
+
+void StatementStatsConnection::Record(std::string const& sql,
+                                      SteadyClock::time_point start) {
+  RecordLatency(*recorder_, *clock_, sql, start);
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,78 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_STATEMENT_STATS_CONNECTION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_STATEMENT_STATS_CONNECTION_H
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/internal/clock.h"
+#include "google/cloud/spanner/statement_stats.h"
+#include "google/cloud/spanner/version.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * A `Connection` decorator that records the latency of each SQL statement.
+ *
+ * See `spanner::MakeStatementStatsConnection()` for details.
+ */
+class StatementStatsConnection : public spanner::Connection {
+ public:
+  StatementStatsConnection(
+      std::shared_ptr<spanner::Connection> child,
+      std::shared_ptr<spanner::StatementStatsRecorder> recorder,
+      std::shared_ptr<SteadyClock> clock = std::make_shared<SteadyClock>());
+
+  spanner::RowStream Read(ReadParams params) override;
+  StatusOr<std::vector<spanner::ReadPartition>> PartitionRead(
+      PartitionReadParams params) override;
+  spanner::RowStream ExecuteQuery(SqlParams params) override;
+  StatusOr<spanner::DmlResult> ExecuteDml(SqlParams params) override;
+  spanner::ProfileQueryResult ProfileQuery(SqlParams params) override;
+  StatusOr<spanner::ProfileDmlResult> ProfileDml(SqlParams params) override;
+  StatusOr<spanner::ExecutionPlan> AnalyzeSql(SqlParams params) override;
+  StatusOr<spanner::PartitionedDmlResult> ExecutePartitionedDml(
+      ExecutePartitionedDmlParams params) override;
+  StatusOr<std::vector<spanner::QueryPartition>> PartitionQuery(
+      PartitionQueryParams params) override;
+  StatusOr<spanner::BatchDmlResult> ExecuteBatchDml(
+      ExecuteBatchDmlParams params) override;
+  StatusOr<spanner::CommitResult> Commit(CommitParams params) override;
+  Status Rollback(RollbackParams params) override;
+  future<spanner::RowStream> AsyncRead(ReadParams params) override;
+  future<spanner::RowStream> AsyncExecuteQuery(SqlParams params) override;
+  future<StatusOr<spanner::CommitResult>> AsyncCommit(
+      CommitParams params) override;
+
+ private:
+  // Records the time since @p start as the latency of @p sql.
+  void Record(std::string const& sql, SteadyClock::time_point start);
+
+  std::shared_ptr<spanner::Connection> child_;
+  std::shared_ptr<spanner::StatementStatsRecorder> recorder_;
+  std::shared_ptr<SteadyClock> clock_;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_STATEMENT_STATS_CONNECTION_H
@@ -0,0 +1,125 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/statement_stats_connection.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/testing/fake_clock.h"
+#include "google/cloud/spanner/transaction.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::google::cloud::spanner_mocks::MockResultSetSource;
+using ::google::cloud::spanner_testing::FakeSteadyClock;
+using ::google::cloud::testing_util::StatusIs;
+using ::std::chrono::milliseconds;
+using ::testing::_;
+
+spanner::Connection::SqlParams MakeSqlParams(std::string sql) {
+  return {spanner::Transaction::SingleUseOptions(
+              spanner::Transaction::ReadOnlyOptions()),
+          spanner::SqlStatement(std::move(sql)),
+          spanner::QueryOptions(),
+          absl::nullopt};
+}
+
+class StatementStatsConnectionTest : public ::testing::Test {
+ protected:
+  StatementStatsConnectionTest()
+      : mock_(std::make_shared<MockConnection>()),
+        recorder_(std::make_shared<spanner::StatementStatsRecorder>()),
+        clock_(std::make_shared<FakeSteadyClock>()),
+        conn_(mock_, recorder_, clock_) {}
+
+  std::shared_ptr<MockConnection> mock_;
+  std::shared_ptr<spanner::StatementStatsRecorder> recorder_;
+  std::shared_ptr<FakeSteadyClock> clock_;
+  StatementStatsConnection conn_;
+};
+
+TEST_F(StatementStatsConnectionTest, RecordsLatency) {
+  EXPECT_CALL(*mock_, ExecuteQuery(_))
+      .WillOnce([this](spanner::Connection::SqlParams const&) {
+        clock_->AdvanceTime(milliseconds(10));
+        return spanner::RowStream(absl::make_unique<MockResultSetSource>());
+      })
+      .WillOnce([this](spanner::Connection::SqlParams const&) {
+        clock_->AdvanceTime(milliseconds(20));
+        return spanner::RowStream(absl::make_unique<MockResultSetSource>());
+      });
+  EXPECT_CALL(*mock_, ExecuteDml(_))
+      .WillOnce([this](spanner::Connection::SqlParams const&) {
+        clock_->AdvanceTime(milliseconds(5));
+        return Status(StatusCode::kAborted, "aborted");
+      });
+
+  conn_.ExecuteQuery(MakeSqlParams("SELECT 1"));
+  conn_.ExecuteQuery(MakeSqlParams("SELECT 1"));
+  EXPECT_THAT(conn_.ExecuteDml(MakeSqlParams("UPDATE T SET C = 1")),
+              StatusIs(StatusCode::kAborted));
+
+  auto top = recorder_->Top(10);
+  ASSERT_EQ(2, top.size());
+  EXPECT_EQ("SELECT 1", top[0].sql);
+  EXPECT_EQ(2, top[0].count);
+  EXPECT_EQ(milliseconds(30), top[0].total_latency);
+  EXPECT_EQ(milliseconds(20), top[0].max_latency);
+  EXPECT_EQ("UPDATE T SET C = 1", top[1].sql);
+  EXPECT_EQ(1, top[1].count);
+  EXPECT_EQ(milliseconds(5), top[1].total_latency);
+}
+
+TEST_F(StatementStatsConnectionTest, AsyncExecuteQuery) {
+  promise<spanner::RowStream> p;
+  EXPECT_CALL(*mock_, AsyncExecuteQuery(_))
+      .WillOnce([&p](spanner::Connection::SqlParams const&) {
+        return p.get_future();
+      });
+
+  auto f = conn_.AsyncExecuteQuery(MakeSqlParams("SELECT 1"));
+  EXPECT_TRUE(recorder_->Top(10).empty());
+  clock_->AdvanceTime(milliseconds(7));
+  p.set_value(spanner::RowStream(absl::make_unique<MockResultSetSource>()));
+  f.get();
+
+  auto top = recorder_->Top(10);
+  ASSERT_EQ(1, top.size());
+  EXPECT_EQ(milliseconds(7), top[0].total_latency);
+}
+
+TEST_F(StatementStatsConnectionTest, OtherOperationsNotRecorded) {
+  EXPECT_CALL(*mock_, AnalyzeSql(_))
+      .WillOnce([](spanner::Connection::SqlParams const&) {
+        return Status(StatusCode::kPermissionDenied, "uh-oh");
+      });
+  EXPECT_THAT(conn_.AnalyzeSql(MakeSqlParams("SELECT 1")),
+              StatusIs(StatusCode::kPermissionDenied));
+  EXPECT_TRUE(recorder_->Top(10).empty());
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,249 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/mutation_batcher.h"
+#include "google/cloud/spanner/transaction.h"
+#include <algorithm>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+// Returns the number of mutations in @p m, as counted by Cloud Spanner towards
+// the commit limit, and sets @p table to the name of the modified table.
+std::size_t CountMutations(google::spanner::v1::Mutation const& m,
+                           std::string& table) {
+  auto write = [&table](google::spanner::v1::Mutation::Write const& w) {
+    table = w.table();
+    return static_cast<std::size_t>(w.columns_size()) *
+           static_cast<std::size_t>(w.values_size());
+  };
+  switch (m.operation_case()) {
+    case google::spanner::v1::Mutation::kInsert:
+      return write(m.insert());
+    case google::spanner::v1::Mutation::kUpdate:
+      return write(m.update());
+    case google::spanner::v1::Mutation::kInsertOrUpdate:
+      return write(m.insert_or_update());
+    case google::spanner::v1::Mutation::kReplace:
+      return write(m.replace());
+    case google::spanner::v1::Mutation::kDelete: {
+      table = m.delete_().table();
+      auto const& ks = m.delete_().key_set();
+      if (ks.all()) return 1;
+      // Deleting an empty key set is valid, it just does nothing.
+      return (std::max)(std::size_t{1},
+                        static_cast<std::size_t>(ks.keys_size()) +
+                            static_cast<std::size_t>(ks.ranges_size()));
+    }
+    default:
+      break;
+  }
+  return 0;
+}
+
+MutationBatcherOptions Normalize(MutationBatcherOptions options) {
+  if (options.max_mutations_per_batch() == 0) {
+    options.set_max_mutations_per_batch(1);
+  }
+  if (options.max_batches() == 0) options.set_max_batches(1);
+  return options.set_max_outstanding_mutations(
+      options.max_outstanding_mutations());
+}
+
+}  // namespace
+
+MutationBatcher::MutationBatcher(Client client, MutationBatcherOptions options)
+    : client_(std::move(client)), options_(Normalize(std::move(options))) {}
+
+std::pair<future<void>, future<Status>> MutationBatcher::AsyncApply(
+    Mutation mut) {
+  AdmissionPromise admission_promise;
+  CompletionPromise completion_promise;
+  auto res = std::make_pair(admission_promise.get_future(),
+                            completion_promise.get_future());
+
+  std::string table;
+  auto const num_mutations = CountMutations(
+      spanner_internal::MutationInternals::Proto(mut), table);
+  // Objects of this class need to be aware of the maximum allowed number of
+  // mutations in a batch because it should not pack more. If we have this
+  // knowledge, we might as well simplify everything and not admit larger
+  // mutations.
+  if (num_mutations == 0 ||
+      num_mutations > options_.max_mutations_per_batch()) {
+    std::ostringstream os;
+    if (num_mutations == 0) {
+      os << "Supplied Mutation has no entries";
+    } else {
+      os << "Too many (" << num_mutations << ") mutations in a Mutation, "
+         << options_.max_mutations_per_batch() << " is the limit";
+    }
+    // Destroy the mutation before satisfying the admission promise so that we
+    // can limit the memory usage.
+    mut = Mutation();
+    completion_promise.set_value(
+        Status(StatusCode::kInvalidArgument, std::move(os).str()));
+    admission_promise.set_value();
+    return res;
+  }
+
+  PendingMutation pending{std::move(mut), std::move(table), num_mutations,
+                          std::move(completion_promise),
+                          std::move(admission_promise)};
+  std::unique_lock<std::mutex> lk(mu_);
+  ++num_requests_pending_;
+  // If some mutations are already subject to flow control, don't admit any
+  // new, even if there's space for them. Otherwise we might starve big
+  // mutations.
+  if (!pending_mutations_.empty() || !HasSpaceFor(pending)) {
+    pending_mutations_.push_back(std::move(pending));
+    return res;
+  }
+  auto admitted = Admit(std::move(pending));
+  auto batches = FlushIfPossible();
+  lk.unlock();
+  admitted.set_value();
+  Commit(std::move(batches));
+  return res;
+}
+
+future<void> MutationBatcher::AsyncWaitForNoPendingRequests() {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (num_requests_pending_ == 0) {
+    return make_ready_future();
+  }
+  no_more_pending_promises_.emplace_back();
+  return no_more_pending_promises_.back().get_future();
+}
+
+future<StatusOr<CommitResult>> MutationBatcher::AsyncCommitImpl(
+    Mutations mutations) {
+  return client_.AsyncCommit(MakeReadWriteTransaction(), std::move(mutations));
+}
+
+bool MutationBatcher::HasSpaceFor(PendingMutation const& pending) const {
+  // A mutation larger than the limit is admitted when nothing else is
+  // outstanding, otherwise it would never be admitted.
+  return outstanding_mutations_ == 0 ||
+         outstanding_mutations_ + pending.num_mutations <=
+             options_.max_outstanding_mutations();
+}
+
+MutationBatcher::AdmissionPromise MutationBatcher::Admit(
+    PendingMutation pending) {
+  outstanding_mutations_ += pending.num_mutations;
+  auto& batch = open_batches_[pending.table];
+  if (batch.num_mutations + pending.num_mutations >
+      options_.max_mutations_per_batch()) {
+    full_batches_.push_back(std::move(batch));
+    batch = Batch{};
+  }
+  batch.num_mutations += pending.num_mutations;
+  batch.mutations.push_back(std::move(pending.mut));
+  batch.completion_promises.push_back(std::move(pending.completion_promise));
+  if (batch.num_mutations == options_.max_mutations_per_batch()) {
+    full_batches_.push_back(std::move(batch));
+    open_batches_.erase(pending.table);
+  }
+  return std::move(pending.admission_promise);
+}
+
+std::vector<MutationBatcher::AdmissionPromise> MutationBatcher::TryAdmit() {
+  std::vector<AdmissionPromise> admitted;
+  while (!pending_mutations_.empty() &&
+         HasSpaceFor(pending_mutations_.front())) {
+    admitted.push_back(Admit(std::move(pending_mutations_.front())));
+    pending_mutations_.pop_front();
+  }
+  return admitted;
+}
+
+std::vector<std::shared_ptr<MutationBatcher::Batch>>
+MutationBatcher::FlushIfPossible() {
+  using Entry = std::map<std::string, Batch>::value_type;
+  std::vector<std::shared_ptr<Batch>> batches;
+  while (num_outstanding_batches_ < options_.max_batches()) {
+    std::shared_ptr<Batch> batch;
+    if (!full_batches_.empty()) {
+      batch = std::make_shared<Batch>(std::move(full_batches_.front()));
+      full_batches_.pop_front();
+    } else if (!open_batches_.empty()) {
+      auto largest = std::max_element(
+          open_batches_.begin(), open_batches_.end(),
+          [](Entry const& a, Entry const& b) {
+            return a.second.num_mutations < b.second.num_mutations;
+          });
+      batch = std::make_shared<Batch>(std::move(largest->second));
+      open_batches_.erase(largest);
+    } else {
+      break;
+    }
+    ++num_outstanding_batches_;
+    batches.push_back(std::move(batch));
+  }
+  return batches;
+}
+
+void MutationBatcher::Commit(std::vector<std::shared_ptr<Batch>> batches) {
+  for (auto& b : batches) Commit(std::move(b));
+}
+
+void MutationBatcher::Commit(std::shared_ptr<Batch> batch) {
+  ++batch->attempts;
+  Mutations mutations;
+  if (batch->attempts < options_.max_commit_attempts()) {
+    // Keep the mutations in case the transaction is aborted.
+    mutations = batch->mutations;
+  } else {
+    mutations = std::move(batch->mutations);
+  }
+  AsyncCommitImpl(std::move(mutations))
+      .then([this, batch](future<StatusOr<CommitResult>> f) {
+        OnCommitDone(batch, f.get().status());
+      });
+}
+
+void MutationBatcher::OnCommitDone(std::shared_ptr<Batch> batch,
+                                   Status status) {
+  if (status.code() == StatusCode::kAborted &&
+      batch->attempts < options_.max_commit_attempts()) {
+    Commit(std::move(batch));
+    return;
+  }
+  for (auto& p : batch->completion_promises) p.set_value(status);
+
+  std::unique_lock<std::mutex> lk(mu_);
+  --num_outstanding_batches_;
+  outstanding_mutations_ -= batch->num_mutations;
+  num_requests_pending_ -= batch->completion_promises.size();
+  auto admitted = TryAdmit();
+  auto batches = FlushIfPossible();
+  std::vector<NoMorePendingPromise> no_more_pending;
+  if (num_requests_pending_ == 0) {
+    no_more_pending.swap(no_more_pending_promises_);
+  }
+  lk.unlock();
+  for (auto& p : admitted) p.set_value();
+  for (auto& p : no_more_pending) p.set_value();
+  Commit(std::move(batches));
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,291 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_MUTATION_BATCHER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_MUTATION_BATCHER_H
+
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/commit_result.h"
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// Configure `MutationBatcher`.
+class MutationBatcherOptions {
+ public:
+  MutationBatcherOptions() = default;
+
+  /**
+   * A single commit will not have more mutations than this.
+   *
+   * The mutations are counted as Cloud Spanner does: each column value in an
+   * insert, update, or replace, and each key or key range in a delete, is one
+   * mutation. Cloud Spanner rejects commits with more than 20,000 mutations,
+   * including the mutations to secondary indexes, which the client cannot
+   * count. The default (5,000) leaves room for a few indexes.
+   */
+  std::size_t max_mutations_per_batch() const {
+    return max_mutations_per_batch_;
+  }
+  MutationBatcherOptions& set_max_mutations_per_batch(std::size_t v) {
+    max_mutations_per_batch_ = v;
+    return *this;
+  }
+
+  /**
+   * There will be no more commits in progress than this.
+   *
+   * Each commit uses a session from the session pool while it is in progress.
+   * The default is 8. Values < 1 are treated as 1.
+   */
+  std::size_t max_batches() const { return max_batches_; }
+  MutationBatcherOptions& set_max_batches(std::size_t v) {
+    max_batches_ = v;
+    return *this;
+  }
+
+  /**
+   * `MutationBatcher` will at most admit this many uncommitted mutations.
+   *
+   * Mutations beyond this limit wait, and their *admission* future is not
+   * satisfied, until enough of the admitted mutations are committed. The
+   * default is `max_mutations_per_batch() * max_batches() * 2`.
+   */
+  std::size_t max_outstanding_mutations() const {
+    return max_outstanding_mutations_ != 0
+               ? max_outstanding_mutations_
+               : max_mutations_per_batch_ * max_batches_ * 2;
+  }
+  MutationBatcherOptions& set_max_outstanding_mutations(std::size_t v) {
+    max_outstanding_mutations_ = v;
+    return *this;
+  }
+
+  /**
+   * The maximum number of attempts to commit each batch.
+   *
+   * Batches are committed in their own read-write transaction. If Cloud
+   * Spanner aborts the transaction, usually because of contention with other
+   * transactions, the batch is committed again in a new transaction. The
+   * default is 5.
+   */
+  int max_commit_attempts() const { return max_commit_attempts_; }
+  MutationBatcherOptions& set_max_commit_attempts(int v) {
+    max_commit_attempts_ = v;
+    return *this;
+  }
+
+ private:
+  std::size_t max_mutations_per_batch_ = 5000;
+  std::size_t max_batches_ = 8;
+  std::size_t max_outstanding_mutations_ = 0;
+  int max_commit_attempts_ = 5;
+};
+
+/**
+ * Objects of this class pack mutations into batches, and commit them.
+ *
+ * Each `Client::Commit()` is a separate transaction and a round trip to Cloud
+ * Spanner. Applications that write a large stream of independent mutations,
+ * such as when loading data, get much higher throughput committing many
+ * mutations in each transaction. Create a `MutationBatcher` and use
+ * `MutationBatcher::AsyncApply()` to submit each mutation. Objects of this
+ * class group the mutations by table, pack them into batches up to
+ * `MutationBatcherOptions::max_mutations_per_batch()`, and keep several
+ * batches "in flight" at the same time, each in its own transaction.
+ *
+ * Mutations in the same batch are committed atomically, but there are no
+ * guarantees about which mutations share a batch, nor about the order in which
+ * batches are committed. Only use this class for mutations that do not depend
+ * on each other.
+ *
+ * This class also offers an easy-to-use flow control mechanism to avoid
+ * unbounded growth in its internal buffers.
+ *
+ * The batches are committed using `Client::AsyncCommit()`, which runs on the
+ * background threads of the client's `Connection`.
+ *
+ * @par Thread-safety
+ * Instances of this class are guaranteed to work when accessed concurrently
+ * from multiple threads. The application must wait for the future returned by
+ * `AsyncWaitForNoPendingRequests()` before destroying the batcher.
+ */
+class MutationBatcher {
+ public:
+  explicit MutationBatcher(
+      Client client, MutationBatcherOptions options = MutationBatcherOptions());
+
+  virtual ~MutationBatcher() = default;
+
+  /**
+   * Asynchronously apply a mutation.
+   *
+   * The mutation will most likely be committed together with others to
+   * optimize for throughput. As a result, latency is likely to be worse than
+   * `Client::Commit()`.
+   *
+   * @param mut the mutation. Note that this function takes ownership of (and
+   *     then discards) the mutation.
+   *
+   * @return *admission* and *completion* futures
+   *
+   * The *completion* future reports the result of committing the batch that
+   * contains the mutation.
+   *
+   * The *admission* future should be used for flow control. In order to bound
+   * the memory used by the `MutationBatcher`, one should not submit more
+   * mutations before the *admission* future is satisfied. Note that while the
+   * future is often already satisfied when the function returns, applications
+   * should not assume that this is always the case.
+   *
+   * One should not make assumptions on which future will be satisfied first.
+   *
+   * This quasi-synchronous example shows the intended use:
+   * @code
+   * namespace spanner = ::google::cloud::spanner;
+   * spanner::MutationBatcher batcher(spanner::Client(...));
+   * while (HasMoreMutations()) {
+   *   auto admission_completion = batcher.AsyncApply(GenerateMutation());
+   *   auto& admission_future = admission_completion.first;
+   *   auto& completion_future = admission_completion.second;
+   *   completion_future.then([](future<Status> completion_status) {
+   *       // handle mutation completion asynchronously
+   *       });
+   *   // Potentially slow down submission not to make buffers in
+   *   // MutationBatcher grow unbounded.
+   *   admission_future.get();
+   * }
+   * // Wait for all mutations to complete
+   * batcher.AsyncWaitForNoPendingRequests().get();
+   * @endcode
+   */
+  std::pair<future<void>, future<Status>> AsyncApply(Mutation mut);
+
+  /**
+   * Asynchronously wait until all submitted mutations complete.
+   *
+   * @return a future which will be satisfied once all mutations submitted
+   *     before calling this function finish; if there are no such mutations,
+   *     the returned future is already satisfied.
+   */
+  future<void> AsyncWaitForNoPendingRequests();
+
+ protected:
+  // Wrap calling the underlying operation in a virtual function to ease
+  // testing.
+  virtual future<StatusOr<CommitResult>> AsyncCommitImpl(Mutations mutations);
+
+ private:
+  using CompletionPromise = promise<Status>;
+  using AdmissionPromise = promise<void>;
+  using NoMorePendingPromise = promise<void>;
+
+  /// A single mutation before it is admitted.
+  struct PendingMutation {
+    Mutation mut;
+    std::string table;
+    std::size_t num_mutations;
+    CompletionPromise completion_promise;
+    AdmissionPromise admission_promise;
+  };
+
+  /// The mutations committed in a single transaction.
+  struct Batch {
+    std::size_t num_mutations = 0;
+    Mutations mutations;
+    std::vector<CompletionPromise> completion_promises;
+    int attempts = 0;
+  };
+
+  /// Check whether the flow control limits allow admitting @p pending.
+  bool HasSpaceFor(PendingMutation const& pending) const;
+
+  /**
+   * Append @p pending to the batch for its table.
+   *
+   * @return the admission promise of @p pending.
+   */
+  AdmissionPromise Admit(PendingMutation pending);
+
+  /**
+   * Try to admit mutations waiting in `pending_mutations_`.
+   *
+   * @return the admission promises of the newly admitted mutations.
+   */
+  std::vector<AdmissionPromise> TryAdmit();
+
+  /**
+   * Take as many batches as the limit of outstanding batches allows.
+   *
+   * Full batches are sent first, then the largest partially filled batches.
+   * The caller must commit the returned batches after releasing the lock.
+   */
+  std::vector<std::shared_ptr<Batch>> FlushIfPossible();
+
+  /// Start committing @p batches, must be called without holding the lock.
+  void Commit(std::vector<std::shared_ptr<Batch>> batches);
+  void Commit(std::shared_ptr<Batch> batch);
+
+  /// Handle a completed commit.
+  void OnCommitDone(std::shared_ptr<Batch> batch, Status status);
+
+  std::mutex mu_;
+  Client client_;
+  MutationBatcherOptions options_;
+
+  /// Number of batches sent but not completed.
+  std::size_t num_outstanding_batches_ = 0;  // GUARDED_BY(mu_)
+  /// Number of admitted but uncompleted mutations.
+  std::size_t outstanding_mutations_ = 0;  // GUARDED_BY(mu_)
+  /// Number of uncompleted `AsyncApply()` calls (including not admitted).
+  std::size_t num_requests_pending_ = 0;  // GUARDED_BY(mu_)
+
+  /// The batches under construction, one for each table.
+  std::map<std::string, Batch> open_batches_;  // GUARDED_BY(mu_)
+  /// The batches that cannot fit more mutations, ready to commit.
+  std::deque<Batch> full_batches_;  // GUARDED_BY(mu_)
+
+  /**
+   * These are the mutations which have not been admitted yet. If the user is
+   * properly reacting to `admission_promise`s, there should be very few of
+   * these (likely no more than one).
+   */
+  std::deque<PendingMutation> pending_mutations_;  // GUARDED_BY(mu_)
+
+  /// The promises returned by `AsyncWaitForNoPendingRequests()`.
+  std::vector<NoMorePendingPromise>
+      no_more_pending_promises_;  // GUARDED_BY(mu_)
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_MUTATION_BATCHER_H
@@ -0,0 +1,237 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/mutation_batcher.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::ElementsAre;
+
+class TestMutationBatcher : public MutationBatcher {
+ public:
+  explicit TestMutationBatcher(MutationBatcherOptions options)
+      : MutationBatcher(
+            Client(std::make_shared<spanner_mocks::MockConnection>()),
+            std::move(options)) {}
+
+  /// The mutations in each commit, in the order they were started.
+  std::vector<Mutations> commits;
+
+  /// Complete the oldest commit in progress with @p status.
+  void Complete(Status status = Status()) {
+    auto p = std::move(promises_.front());
+    promises_.pop_front();
+    if (status.ok()) {
+      p.set_value(CommitResult{});
+    } else {
+      p.set_value(std::move(status));
+    }
+  }
+
+  std::size_t in_progress() const { return promises_.size(); }
+
+ protected:
+  future<StatusOr<CommitResult>> AsyncCommitImpl(Mutations mutations) override {
+    commits.push_back(std::move(mutations));
+    promises_.emplace_back();
+    return promises_.back().get_future();
+  }
+
+ private:
+  std::deque<promise<StatusOr<CommitResult>>> promises_;
+};
+
+Mutation MakeInsert(std::string const& table, int key) {
+  return MakeInsertMutation(table, {"key", "value"}, key, "v");
+}
+
+TEST(MutationBatcherTest, SingleMutation) {
+  TestMutationBatcher batcher(MutationBatcherOptions{});
+  auto res = batcher.AsyncApply(MakeInsert("T", 1));
+  EXPECT_TRUE(res.first.is_ready());
+  EXPECT_FALSE(res.second.is_ready());
+  ASSERT_EQ(1U, batcher.commits.size());
+  EXPECT_THAT(batcher.commits[0], ElementsAre(MakeInsert("T", 1)));
+
+  auto no_pending = batcher.AsyncWaitForNoPendingRequests();
+  EXPECT_FALSE(no_pending.is_ready());
+  batcher.Complete();
+  EXPECT_STATUS_OK(res.second.get());
+  EXPECT_TRUE(no_pending.is_ready());
+  EXPECT_TRUE(batcher.AsyncWaitForNoPendingRequests().is_ready());
+}
+
+TEST(MutationBatcherTest, BatchWhileBusy) {
+  TestMutationBatcher batcher(MutationBatcherOptions{}.set_max_batches(1));
+  auto r1 = batcher.AsyncApply(MakeInsert("T", 1));
+  auto r2 = batcher.AsyncApply(MakeInsert("T", 2));
+  auto r3 = batcher.AsyncApply(MakeInsert("T", 3));
+  ASSERT_EQ(1U, batcher.commits.size());
+
+  // The mutations that arrived while the first commit was in progress are
+  // committed together.
+  batcher.Complete();
+  EXPECT_STATUS_OK(r1.second.get());
+  ASSERT_EQ(2U, batcher.commits.size());
+  EXPECT_THAT(batcher.commits[1],
+              ElementsAre(MakeInsert("T", 2), MakeInsert("T", 3)));
+  batcher.Complete();
+  EXPECT_STATUS_OK(r2.second.get());
+  EXPECT_STATUS_OK(r3.second.get());
+  EXPECT_EQ(0U, batcher.in_progress());
+}
+
+TEST(MutationBatcherTest, GroupByTable) {
+  TestMutationBatcher batcher(MutationBatcherOptions{}.set_max_batches(1));
+  std::vector<future<Status>> completions;
+  completions.push_back(batcher.AsyncApply(MakeInsert("T0", 0)).second);
+  completions.push_back(batcher.AsyncApply(MakeInsert("T1", 1)).second);
+  completions.push_back(batcher.AsyncApply(MakeInsert("T2", 2)).second);
+  completions.push_back(batcher.AsyncApply(MakeInsert("T2", 3)).second);
+  completions.push_back(batcher.AsyncApply(MakeInsert("T1", 4)).second);
+  completions.push_back(batcher.AsyncApply(MakeInsert("T2", 5)).second);
+
+  // The largest batch is sent first, each batch has a single table.
+  for (int i = 0; i != 3; ++i) batcher.Complete();
+  ASSERT_EQ(4U, batcher.commits.size());
+  EXPECT_THAT(batcher.commits[0], ElementsAre(MakeInsert("T0", 0)));
+  EXPECT_THAT(batcher.commits[1],
+              ElementsAre(MakeInsert("T2", 2), MakeInsert("T2", 3),
+                          MakeInsert("T2", 5)));
+  EXPECT_THAT(batcher.commits[2],
+              ElementsAre(MakeInsert("T1", 1), MakeInsert("T1", 4)));
+  batcher.Complete();
+  for (auto& c : completions) EXPECT_STATUS_OK(c.get());
+}
+
+TEST(MutationBatcherTest, MaxMutationsPerBatch) {
+  // Each insert has 2 columns and 1 row, so 2 mutations.
+  TestMutationBatcher batcher(MutationBatcherOptions{}
+                                  .set_max_batches(1)
+                                  .set_max_mutations_per_batch(5));
+  std::vector<future<Status>> completions;
+  for (int i = 0; i != 6; ++i) {
+    completions.push_back(batcher.AsyncApply(MakeInsert("T", i)).second);
+  }
+  while (batcher.in_progress() != 0) batcher.Complete();
+  ASSERT_EQ(4U, batcher.commits.size());
+  EXPECT_THAT(batcher.commits[0], ElementsAre(MakeInsert("T", 0)));
+  EXPECT_THAT(batcher.commits[1],
+              ElementsAre(MakeInsert("T", 1), MakeInsert("T", 2)));
+  EXPECT_THAT(batcher.commits[2],
+              ElementsAre(MakeInsert("T", 3), MakeInsert("T", 4)));
+  EXPECT_THAT(batcher.commits[3], ElementsAre(MakeInsert("T", 5)));
+  for (auto& c : completions) EXPECT_STATUS_OK(c.get());
+}
+
+TEST(MutationBatcherTest, FlowControl) {
+  TestMutationBatcher batcher(MutationBatcherOptions{}
+                                  .set_max_batches(1)
+                                  .set_max_outstanding_mutations(4));
+  auto r1 = batcher.AsyncApply(MakeInsert("T", 1));
+  auto r2 = batcher.AsyncApply(MakeInsert("T", 2));
+  auto r3 = batcher.AsyncApply(MakeInsert("T", 3));
+  EXPECT_TRUE(r1.first.is_ready());
+  EXPECT_TRUE(r2.first.is_ready());
+  EXPECT_FALSE(r3.first.is_ready());
+
+  batcher.Complete();
+  EXPECT_TRUE(r3.first.is_ready());
+  ASSERT_EQ(2U, batcher.commits.size());
+  EXPECT_THAT(batcher.commits[1],
+              ElementsAre(MakeInsert("T", 2), MakeInsert("T", 3)));
+  batcher.Complete();
+  EXPECT_STATUS_OK(r3.second.get());
+}
+
+TEST(MutationBatcherTest, RetryAborted) {
+  TestMutationBatcher batcher(MutationBatcherOptions{});
+  auto res = batcher.AsyncApply(MakeInsert("T", 1));
+  batcher.Complete(Status(StatusCode::kAborted, "try-again"));
+  EXPECT_FALSE(res.second.is_ready());
+  batcher.Complete();
+  EXPECT_STATUS_OK(res.second.get());
+  ASSERT_EQ(2U, batcher.commits.size());
+  EXPECT_EQ(batcher.commits[0], batcher.commits[1]);
+}
+
+TEST(MutationBatcherTest, TooManyAborted) {
+  TestMutationBatcher batcher(
+      MutationBatcherOptions{}.set_max_commit_attempts(2));
+  auto res = batcher.AsyncApply(MakeInsert("T", 1));
+  batcher.Complete(Status(StatusCode::kAborted, "try-again"));
+  batcher.Complete(Status(StatusCode::kAborted, "try-again"));
+  EXPECT_THAT(res.second.get(), StatusIs(StatusCode::kAborted));
+  EXPECT_EQ(2U, batcher.commits.size());
+  EXPECT_TRUE(batcher.AsyncWaitForNoPendingRequests().is_ready());
+}
+
+TEST(MutationBatcherTest, PermanentError) {
+  TestMutationBatcher batcher(MutationBatcherOptions{});
+  auto res = batcher.AsyncApply(MakeInsert("T", 1));
+  batcher.Complete(Status(StatusCode::kPermissionDenied, "uh-oh"));
+  EXPECT_THAT(res.second.get(), StatusIs(StatusCode::kPermissionDenied));
+  EXPECT_EQ(1U, batcher.commits.size());
+}
+
+TEST(MutationBatcherTest, InvalidMutations) {
+  TestMutationBatcher batcher(
+      MutationBatcherOptions{}.set_max_mutations_per_batch(3));
+  auto empty = batcher.AsyncApply(Mutation());
+  EXPECT_TRUE(empty.first.is_ready());
+  EXPECT_THAT(empty.second.get(), StatusIs(StatusCode::kInvalidArgument));
+
+  auto large = batcher.AsyncApply(
+      MakeInsertMutation("T", {"key", "value"}, 1, "v", 2, "w"));
+  EXPECT_TRUE(large.first.is_ready());
+  EXPECT_THAT(large.second.get(), StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_TRUE(batcher.commits.empty());
+}
+
+TEST(MutationBatcherTest, DeleteMutations) {
+  TestMutationBatcher batcher(MutationBatcherOptions{}
+                                  .set_max_batches(1)
+                                  .set_max_mutations_per_batch(2));
+  auto r1 = batcher.AsyncApply(MakeDeleteMutation("T", KeySet::All()));
+  auto r2 = batcher.AsyncApply(
+      MakeDeleteMutation("T", KeySet().AddKey(MakeKey(1)).AddKey(MakeKey(2))));
+  auto r3 = batcher.AsyncApply(MakeDeleteMutation("T", KeySet::All()));
+  batcher.Complete();
+  ASSERT_EQ(2U, batcher.commits.size());
+  EXPECT_EQ(1U, batcher.commits[1].size());
+  batcher.Complete();
+  ASSERT_EQ(3U, batcher.commits.size());
+  batcher.Complete();
+  EXPECT_STATUS_OK(r1.second.get());
+  EXPECT_STATUS_OK(r2.second.get());
+  EXPECT_STATUS_OK(r3.second.get());
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -15,10 +15,14 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_MUTATIONS_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_MUTATIONS_H
 
+#include "google/cloud/spanner/internal/tuple_utils.h"
 #include "google/cloud/spanner/keys.h"
 #include "google/cloud/spanner/value.h"
 #include "google/cloud/spanner/version.h"
 #include <google/spanner/v1/mutation.pb.h>
+#include <cstddef>
+#include <string>
+#include <tuple>
 #include <vector>
 
 namespace google {
@@ -27,7 +31,10 @@ namespace spanner_internal {
 inline namespace SPANNER_CLIENT_NS {
 template <typename Op>
 class WriteMutationBuilder;
+template <typename Op, typename... Ts>
+class TypedWriteMutationBuilder;
 class DeleteMutationBuilder;
+struct MutationInternals;
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner_internal
 
@@ -85,7 +92,10 @@ class Mutation {
 
   template <typename Op>
   friend class spanner_internal::SPANNER_CLIENT_NS::WriteMutationBuilder;
+  template <typename Op, typename... Ts>
+  friend class spanner_internal::SPANNER_CLIENT_NS::TypedWriteMutationBuilder;
   friend class spanner_internal::SPANNER_CLIENT_NS::DeleteMutationBuilder;
+  friend struct spanner_internal::SPANNER_CLIENT_NS::MutationInternals;
   explicit Mutation(google::spanner::v1::Mutation m) : m_(std::move(m)) {}
 
   google::spanner::v1::Mutation m_;
@@ -105,6 +115,14 @@ using Mutations = std::vector<Mutation>;
 namespace spanner_internal {
 inline namespace SPANNER_CLIENT_NS {
 
+struct MutationInternals {
+  // Inspects the proto without copying it, `as_proto() const&` makes a copy.
+  static google::spanner::v1::Mutation const& Proto(
+      spanner::Mutation const& m) {
+    return m.m_;
+  }
+};
+
 template <typename Op>
 class WriteMutationBuilder {
  public:
@@ -148,6 +166,66 @@ class WriteMutationBuilder {
   spanner::Mutation m_;
 };
 
+// Like `WriteMutationBuilder`, but the column types are known at compile
+// time. Each value is encoded directly into the mutation, without creating a
+// `spanner::Value` (and its `Type`) for each cell.
+template <typename Op, typename... Ts>
+class TypedWriteMutationBuilder {
+ public:
+  TypedWriteMutationBuilder(std::string table_name,
+                            std::vector<std::string> column_names) {
+    auto& field = Op::mutable_field(m_.proto());
+    field.set_table(std::move(table_name));
+    field.mutable_columns()->Reserve(static_cast<int>(column_names.size()));
+    for (auto& name : column_names) {
+      field.add_columns(std::move(name));
+    }
+  }
+
+  spanner::Mutation Build() const& { return m_; }
+  spanner::Mutation&& Build() && { return std::move(m_); }
+
+  // Preallocates space for @p rows additional rows.
+  TypedWriteMutationBuilder& Reserve(std::size_t rows) & {
+    auto& values = *Op::mutable_field(m_.proto()).mutable_values();
+    values.Reserve(values.size() + static_cast<int>(rows));
+    return *this;
+  }
+
+  TypedWriteMutationBuilder&& Reserve(std::size_t rows) && {
+    return std::move(Reserve(rows));
+  }
+
+  TypedWriteMutationBuilder& AddRow(std::tuple<Ts...> row) & {
+    auto& lv = *Op::mutable_field(m_.proto()).add_values();
+    lv.mutable_values()->Reserve(static_cast<int>(sizeof...(Ts)));
+    spanner_internal::ForEach(std::move(row), AddValue{}, lv);
+    return *this;
+  }
+
+  TypedWriteMutationBuilder&& AddRow(std::tuple<Ts...> row) && {
+    return std::move(AddRow(std::move(row)));
+  }
+
+  TypedWriteMutationBuilder& AddRow(Ts... values) & {
+    return AddRow(std::tuple<Ts...>(std::move(values)...));
+  }
+
+  TypedWriteMutationBuilder&& AddRow(Ts... values) && {
+    return std::move(AddRow(std::move(values)...));
+  }
+
+ private:
+  struct AddValue {
+    template <typename T>
+    void operator()(T&& t, google::protobuf::ListValue& lv) const {
+      *lv.add_values() = ValueInternals::ToValueProto(std::forward<T>(t));
+    }
+  };
+
+  spanner::Mutation m_;
+};
+
 struct InsertOp {
   static google::spanner::v1::Mutation::Write& mutable_field(
       google::spanner::v1::Mutation& m) {
@@ -339,6 +417,45 @@ Mutation MakeReplaceMutation(std::string table_name,
       .Build();
 }
 
+//@{
+/**
+ * Helper classes to construct write mutations for columns of known types.
+ *
+ * These builders produce the same mutations as `InsertMutationBuilder`,
+ * `UpdateMutationBuilder`, `InsertOrUpdateMutationBuilder`, and
+ * `ReplaceMutationBuilder`, but the type of each column is fixed at compile
+ * time. The values are encoded directly into the mutation, without creating a
+ * `Value` for each cell, which reduces the cost of large batches of rows.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * auto builder = spanner::TypedInsertMutationBuilder<std::int64_t,
+ *                                                    std::string>(
+ *     "Singers", {"SingerId", "FirstName"});
+ * builder.Reserve(singers.size());
+ * for (auto const& s : singers) builder.AddRow(s.id, s.first_name);
+ * auto mutation = std::move(builder).Build();
+ * @endcode
+ */
+template <typename... Ts>
+using TypedInsertMutationBuilder =
+    spanner_internal::TypedWriteMutationBuilder<spanner_internal::InsertOp,
+                                                Ts...>;
+template <typename... Ts>
+using TypedUpdateMutationBuilder =
+    spanner_internal::TypedWriteMutationBuilder<spanner_internal::UpdateOp,
+                                                Ts...>;
+template <typename... Ts>
+using TypedInsertOrUpdateMutationBuilder =
+    spanner_internal::TypedWriteMutationBuilder<
+        spanner_internal::InsertOrUpdateOp, Ts...>;
+template <typename... Ts>
+using TypedReplaceMutationBuilder =
+    spanner_internal::TypedWriteMutationBuilder<spanner_internal::ReplaceOp,
+                                                Ts...>;
+//@}
+
 /**
  * A helper class to construct "delete" mutations.
  *
@@ -421,6 +421,43 @@ TEST(MutationsTest, FluentDeleteBuilder) {
   EXPECT_THAT(actual, IsProtoEqual(expected));
 }
 
+TEST(MutationsTest, TypedBuilders) {
+  using Row = std::tuple<std::int64_t, std::string, absl::optional<double>>;
+  std::vector<Row> rows = {Row(1, "foo", 2.5), Row(2, "bar", absl::nullopt)};
+
+  auto typed = TypedInsertMutationBuilder<std::int64_t, std::string,
+                                          absl::optional<double>>(
+                   "table-name", {"col1", "col2", "col3"})
+                   .Reserve(rows.size())
+                   .AddRow(rows[0])
+                   .AddRow(std::get<0>(rows[1]), std::get<1>(rows[1]),
+                           std::get<2>(rows[1]))
+                   .Build();
+  auto untyped = InsertMutationBuilder("table-name", {"col1", "col2", "col3"})
+                     .AddRow({Value(std::get<0>(rows[0])),
+                              Value(std::get<1>(rows[0])),
+                              Value(std::get<2>(rows[0]))})
+                     .AddRow({Value(std::get<0>(rows[1])),
+                              Value(std::get<1>(rows[1])),
+                              Value(std::get<2>(rows[1]))})
+                     .Build();
+  EXPECT_EQ(untyped, typed);
+
+  EXPECT_EQ(MakeUpdateMutation("table-name", {"col1"}, std::int64_t{3}),
+            TypedUpdateMutationBuilder<std::int64_t>("table-name", {"col1"})
+                .AddRow(3)
+                .Build());
+  EXPECT_EQ(
+      MakeInsertOrUpdateMutation("table-name", {"col1"}, std::int64_t{3}),
+      TypedInsertOrUpdateMutationBuilder<std::int64_t>("table-name", {"col1"})
+          .AddRow(3)
+          .Build());
+  EXPECT_EQ(MakeReplaceMutation("table-name", {"col1"}, std::int64_t{3}),
+            TypedReplaceMutationBuilder<std::int64_t>("table-name", {"col1"})
+                .AddRow(3)
+                .Build());
+}
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
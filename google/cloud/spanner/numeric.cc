@@ -34,9 +34,8 @@ inline namespace SPANNER_CLIENT_NS {
 
 namespace {
 
-inline bool IsDigit(char ch) {
-  return std::isdigit(static_cast<unsigned char>(ch)) != 0;
-}
+// Unlike `std::isdigit()` this does not depend on the current locale.
+inline bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
 
 inline bool IsSpace(char ch) {
   return std::isspace(static_cast<unsigned char>(ch)) != 0;
@@ -76,10 +75,8 @@ bool IsCanonical(absl::string_view sign_part, absl::string_view int_part,
 // cases rounding away from zero.
 void Round(std::deque<char>& int_rep, std::deque<char>& frac_rep,
            std::size_t prec) {
-  static constexpr auto kDigits = "0123456789";
-
   auto it = frac_rep.begin() + (std::min)(prec, frac_rep.size());
-  if (frac_rep.size() <= prec || std::strchr(kDigits, *it) - kDigits < 5) {
+  if (frac_rep.size() <= prec || *it < '5') {
     // Round towards zero.
     while (it != frac_rep.begin() && *(it - 1) == '0') --it;
     frac_rep.erase(it, frac_rep.end());
@@ -89,7 +86,7 @@ void Round(std::deque<char>& int_rep, std::deque<char>& frac_rep,
   // Round away from zero (requires add and carry).
   while (it != frac_rep.begin()) {
     if (*--it != '9') {
-      *it = *(std::strchr(kDigits, *it) + 1);
+      ++*it;
       frac_rep.erase(++it, frac_rep.end());
       return;
     }
@@ -100,21 +97,46 @@ void Round(std::deque<char>& int_rep, std::deque<char>& frac_rep,
   int_rep.push_front('0');
   it = int_rep.end();
   while (*--it == '9') *it = '0';
-  *it = *(std::strchr(kDigits, *it) + 1);
+  ++*it;
+}
+
+// Formats `value` so that its digits end at `end`, returns where they start.
+char* FormatDigits(absl::uint128 value, char* end) {
+  // Peel off 19 digits at a time, so most of the work uses 64-bit division.
+  auto constexpr kChunk = 10000000000000000000ULL;  // 10^19
+  auto* p = end;
+  while (value >= kChunk) {
+    auto chunk = absl::Uint128Low64(value % kChunk);
+    value /= kChunk;
+    for (int i = 0; i != 19; ++i, chunk /= 10) {
+      *--p = static_cast<char>('0' + chunk % 10);
+    }
+  }
+  auto v = absl::Uint128Low64(value);
+  do {
+    *--p = static_cast<char>('0' + v % 10);
+    v /= 10;
+  } while (v != 0);
+  return p;
 }
 
 }  // namespace
 
 std::string ToString(absl::int128 value) {
-  std::ostringstream ss;
-  ss << value;
-  return std::move(ss).str();
+  char buf[41];  // "-170141183460469231731687303715884105728"
+  auto const negative = value < 0;
+  // Negate in the unsigned domain, which is well defined for the minimum.
+  auto const magnitude = negative ? -static_cast<absl::uint128>(value)
+                                  : static_cast<absl::uint128>(value);
+  auto* p = FormatDigits(magnitude, buf + sizeof(buf));
+  if (negative) *--p = '-';
+  return std::string(p, buf + sizeof(buf));
 }
 
 std::string ToString(absl::uint128 value) {
-  std::ostringstream ss;
-  ss << value;
-  return std::move(ss).str();
+  char buf[39];  // "340282366920938463463374607431768211455"
+  auto* p = FormatDigits(value, buf + sizeof(buf));
+  return std::string(p, buf + sizeof(buf));
 }
 
 Status DataLoss(std::string message) {
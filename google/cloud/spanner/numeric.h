@@ -20,7 +20,6 @@
 #include "google/cloud/status_or.h"
 #include "absl/numeric/int128.h"
 #include <cstdlib>
-#include <cstring>
 #include <limits>
 #include <ostream>
 #include <string>
@@ -213,27 +212,26 @@ StatusOr<T> ToInteger(  // NOLINT(misc-no-recursion)
     return en ? ToInteger<T>(*en, 0) : en.status();
   }
   T v = 0;
-  constexpr auto kDigits = "0123456789";
   constexpr auto kMax = (std::numeric_limits<T>::max)();
   enum { kIntPart, kFracPart } state = kIntPart;
   for (auto const ch : rep) {
-    auto const* dp = std::strchr(kDigits, ch);
+    auto const d = static_cast<unsigned char>(ch - '0');
     if (state == kFracPart) {
-      if (dp - kDigits >= 5) {  // dp != nullptr
+      if (d >= 5 && d <= 9) {
         if (v == kMax) return spanner_internal::DataLoss(rep);
         v = static_cast<T>(v + 1);
       }
       break;
     }
-    if (dp == nullptr) {
+    if (d > 9) {
       if (ch == '-') return spanner_internal::DataLoss(rep);
       state = kFracPart;  // ch == '.'
     } else {
       if (v > kMax / 10) return spanner_internal::DataLoss(rep);
       v = static_cast<T>(v * 10);
-      auto d = static_cast<T>(dp - kDigits);
-      if (v > kMax - d) return spanner_internal::DataLoss(rep);
-      v = static_cast<T>(v + d);
+      auto const digit = static_cast<T>(d);
+      if (v > kMax - digit) return spanner_internal::DataLoss(rep);
+      v = static_cast<T>(v + digit);
     }
   }
   return v;
@@ -251,20 +249,19 @@ StatusOr<T> ToInteger(  // NOLINT(misc-no-recursion)
     return en ? ToInteger<T>(*en, 0) : en.status();
   }
   T v = 0;
-  constexpr auto kDigits = "0123456789";
   constexpr auto kMin = (std::numeric_limits<T>::min)();
   bool negate = true;
   enum { kIntPart, kFracPart } state = kIntPart;
   for (auto const ch : rep) {
-    auto const* dp = std::strchr(kDigits, ch);
+    auto const d = static_cast<unsigned char>(ch - '0');
     if (state == kFracPart) {
-      if (dp - kDigits >= 5) {  // dp != nullptr
+      if (d >= 5 && d <= 9) {
         if (v == kMin) return spanner_internal::DataLoss(rep);
         v = static_cast<T>(v - 1);
       }
       break;
     }
-    if (dp == nullptr) {
+    if (d > 9) {
       if (ch == '-') {
         negate = false;
       } else {
@@ -273,9 +270,9 @@ StatusOr<T> ToInteger(  // NOLINT(misc-no-recursion)
     } else {
       if (v < kMin / 10) return spanner_internal::DataLoss(rep);
       v = static_cast<T>(v * 10);
-      auto d = static_cast<T>(dp - kDigits);
-      if (v < kMin + d) return spanner_internal::DataLoss(rep);
-      v = static_cast<T>(v - d);
+      auto const digit = static_cast<T>(d);
+      if (v < kMin + digit) return spanner_internal::DataLoss(rep);
+      v = static_cast<T>(v - digit);
     }
   }
   if (!negate) return v;
@@ -0,0 +1,380 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/partition_coordinator.h"
+#include "google/cloud/spanner/results.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+auto constexpr kTaskMagic = "spanner.PartitionTask.v1";
+auto constexpr kReportMagic = "spanner.PartitionReport.v1";
+auto constexpr kQueryKind = "query";
+auto constexpr kReadKind = "read";
+
+// Each field is encoded as its decimal length, a colon, and its bytes, so the
+// fields may contain arbitrary data.
+void AppendField(std::string& out, std::string const& field) {
+  out += std::to_string(field.size());
+  out += ':';
+  out += field;
+}
+
+bool ParseNumber(std::string const& s, std::uint64_t& n) {
+  // Reject anything that could overflow, no valid field is that large.
+  if (s.empty() || s.size() > 18) return false;
+  n = 0;
+  for (auto c : s) {
+    if (c < '0' || c > '9') return false;
+    n = n * 10 + static_cast<std::uint64_t>(c - '0');
+  }
+  return true;
+}
+
+bool ParseFields(std::string const& s, std::vector<std::string>& fields) {
+  std::size_t pos = 0;
+  while (pos != s.size()) {
+    auto const colon = s.find(':', pos);
+    if (colon == std::string::npos) return false;
+    std::uint64_t length;
+    if (!ParseNumber(s.substr(pos, colon - pos), length)) return false;
+    pos = colon + 1;
+    if (length > s.size() - pos) return false;
+    auto const n = static_cast<std::size_t>(length);
+    fields.push_back(s.substr(pos, n));
+    pos += n;
+  }
+  return true;
+}
+
+Status InvalidTask(std::string const& what) {
+  return Status(StatusCode::kInvalidArgument,
+                "cannot deserialize PartitionTask: " + what);
+}
+
+Status InvalidReport(std::string const& what) {
+  return Status(StatusCode::kInvalidArgument,
+                "cannot deserialize PartitionReport: " + what);
+}
+
+std::vector<StatusOr<std::string>> SerializeAll(
+    std::vector<QueryPartition> const& partitions) {
+  std::vector<StatusOr<std::string>> result;
+  result.reserve(partitions.size());
+  for (auto const& p : partitions) {
+    result.push_back(SerializeQueryPartition(p));
+  }
+  return result;
+}
+
+std::vector<StatusOr<std::string>> SerializeAll(
+    std::vector<ReadPartition> const& partitions) {
+  std::vector<StatusOr<std::string>> result;
+  result.reserve(partitions.size());
+  for (auto const& p : partitions) {
+    result.push_back(SerializeReadPartition(p));
+  }
+  return result;
+}
+
+Status ReadAll(RowStream rows, std::function<Status(Row)> const& callback) {
+  for (auto& row : rows) {
+    if (!row) return std::move(row).status();
+    auto status = callback(*std::move(row));
+    if (!status.ok()) return status;
+  }
+  return Status();
+}
+
+Status RunTask(Client client, PartitionTask const& task,
+               std::function<Status(Row)> const& callback) {
+  if (task.kind == PartitionTask::Kind::kQuery) {
+    auto partition = DeserializeQueryPartition(task.partition);
+    if (!partition) return std::move(partition).status();
+    return ReadAll(client.ExecuteQuery(*partition), callback);
+  }
+  auto partition = DeserializeReadPartition(task.partition);
+  if (!partition) return std::move(partition).status();
+  return ReadAll(client.Read(*partition), callback);
+}
+
+}  // namespace
+
+std::string SerializePartitionTask(PartitionTask const& task) {
+  std::string out;
+  AppendField(out, kTaskMagic);
+  AppendField(out, task.export_id);
+  AppendField(out, task.kind == PartitionTask::Kind::kQuery ? kQueryKind
+                                                            : kReadKind);
+  AppendField(out, std::to_string(task.index));
+  AppendField(out, std::to_string(task.attempt));
+  AppendField(out, task.partition);
+  return out;
+}
+
+StatusOr<PartitionTask> DeserializePartitionTask(std::string const& s) {
+  std::vector<std::string> fields;
+  if (!ParseFields(s, fields) || fields.size() != 6) {
+    return InvalidTask("malformed input");
+  }
+  if (fields[0] != kTaskMagic) return InvalidTask("unknown format");
+  PartitionTask task;
+  task.export_id = std::move(fields[1]);
+  if (fields[2] == kQueryKind) {
+    task.kind = PartitionTask::Kind::kQuery;
+  } else if (fields[2] == kReadKind) {
+    task.kind = PartitionTask::Kind::kRead;
+  } else {
+    return InvalidTask("unknown partition kind <" + fields[2] + ">");
+  }
+  std::uint64_t index;
+  std::uint64_t attempt;
+  if (!ParseNumber(fields[3], index) || !ParseNumber(fields[4], attempt) ||
+      attempt > static_cast<std::uint64_t>((std::numeric_limits<int>::max)())) {
+    return InvalidTask("invalid index or attempt");
+  }
+  task.index = static_cast<std::size_t>(index);
+  task.attempt = static_cast<int>(attempt);
+  task.partition = std::move(fields[5]);
+  return task;
+}
+
+std::string SerializePartitionReport(PartitionReport const& report) {
+  std::string out;
+  AppendField(out, kReportMagic);
+  AppendField(out, report.export_id);
+  AppendField(out, std::to_string(report.index));
+  AppendField(out, std::to_string(report.attempt));
+  AppendField(out, std::to_string(static_cast<int>(report.status.code())));
+  AppendField(out, report.status.message());
+  return out;
+}
+
+StatusOr<PartitionReport> DeserializePartitionReport(std::string const& s) {
+  std::vector<std::string> fields;
+  if (!ParseFields(s, fields) || fields.size() != 6) {
+    return InvalidReport("malformed input");
+  }
+  if (fields[0] != kReportMagic) return InvalidReport("unknown format");
+  std::uint64_t index;
+  std::uint64_t attempt;
+  std::uint64_t code;
+  if (!ParseNumber(fields[2], index) || !ParseNumber(fields[3], attempt) ||
+      attempt > static_cast<std::uint64_t>((std::numeric_limits<int>::max)())) {
+    return InvalidReport("invalid index or attempt");
+  }
+  if (!ParseNumber(fields[4], code) ||
+      code > static_cast<std::uint64_t>(StatusCode::kUnauthenticated)) {
+    return InvalidReport("invalid status code");
+  }
+  PartitionReport report;
+  report.export_id = std::move(fields[1]);
+  report.index = static_cast<std::size_t>(index);
+  report.attempt = static_cast<int>(attempt);
+  report.status = Status(static_cast<StatusCode>(code), std::move(fields[5]));
+  return report;
+}
+
+PartitionCoordinator::PartitionCoordinator(
+    std::string export_id, std::vector<QueryPartition> partitions,
+    std::shared_ptr<PartitionTaskQueue> queue,
+    PartitionCoordinatorOptions options)
+    : PartitionCoordinator(std::move(export_id), PartitionTask::Kind::kQuery,
+                           SerializeAll(partitions), std::move(queue),
+                           std::move(options)) {}
+
+PartitionCoordinator::PartitionCoordinator(
+    std::string export_id, std::vector<ReadPartition> partitions,
+    std::shared_ptr<PartitionTaskQueue> queue,
+    PartitionCoordinatorOptions options)
+    : PartitionCoordinator(std::move(export_id), PartitionTask::Kind::kRead,
+                           SerializeAll(partitions), std::move(queue),
+                           std::move(options)) {}
+
+PartitionCoordinator::PartitionCoordinator(
+    std::string export_id, PartitionTask::Kind kind,
+    std::vector<StatusOr<std::string>> partitions,
+    std::shared_ptr<PartitionTaskQueue> queue,
+    PartitionCoordinatorOptions options)
+    : export_id_(std::move(export_id)),
+      kind_(kind),
+      queue_(std::move(queue)),
+      options_(std::move(options)),
+      tasks_(partitions.size()) {
+  for (std::size_t i = 0; i != partitions.size(); ++i) {
+    auto& p = partitions[i];
+    if (p) {
+      tasks_[i].partition = *std::move(p);
+    } else if (status_.ok()) {
+      status_ = std::move(p).status();
+    }
+  }
+}
+
+Status PartitionCoordinator::Start() {
+  std::vector<PartitionTask> tasks;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!status_.ok()) return status_;
+    for (std::size_t i = 0; i != tasks_.size(); ++i) {
+      if (tasks_[i].attempt == 0) tasks.push_back(NextAttempt(i));
+    }
+  }
+  return Send(std::move(tasks));
+}
+
+Status PartitionCoordinator::OnReport(PartitionReport const& report) {
+  if (report.export_id != export_id_) {
+    return Status(StatusCode::kInvalidArgument,
+                  "report for export <" + report.export_id +
+                      ">, expected <" + export_id_ + ">");
+  }
+  std::vector<PartitionTask> retry;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (report.index >= tasks_.size()) {
+      return Status(StatusCode::kInvalidArgument,
+                    "report for unknown partition " +
+                        std::to_string(report.index));
+    }
+    auto& task = tasks_[report.index];
+    if (DoneLocked() || task.completed || report.attempt > task.attempt) {
+      return Status();
+    }
+    if (report.status.ok()) {
+      task.completed = true;
+      ++completed_;
+    } else if (report.attempt < task.attempt) {
+      // A newer attempt is already in progress.
+      return Status();
+    } else if (task.attempt >= (std::max)(options_.max_attempts(), 1)) {
+      status_ = Status(report.status.code(),
+                       "partition " + std::to_string(report.index) +
+                           " failed: " + report.status.message());
+    } else {
+      retry.push_back(NextAttempt(report.index));
+    }
+  }
+  cv_.notify_all();
+  return Send(std::move(retry));
+}
+
+Status PartitionCoordinator::ExpireLeases() {
+  auto const now = std::chrono::steady_clock::now();
+  std::vector<PartitionTask> retry;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (DoneLocked()) return Status();
+    for (std::size_t i = 0; i != tasks_.size(); ++i) {
+      auto const& task = tasks_[i];
+      if (task.completed || task.attempt == 0 || task.lease_deadline > now) {
+        continue;
+      }
+      if (task.attempt >= (std::max)(options_.max_attempts(), 1)) {
+        status_ = Status(StatusCode::kDeadlineExceeded,
+                         "partition " + std::to_string(i) +
+                             " has no report after " +
+                             std::to_string(task.attempt) + " attempts");
+        retry.clear();
+        break;
+      }
+      retry.push_back(NextAttempt(i));
+    }
+  }
+  cv_.notify_all();
+  return Send(std::move(retry));
+}
+
+Status PartitionCoordinator::Wait() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (!DoneLocked()) {
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    for (auto const& task : tasks_) {
+      if (task.completed || task.attempt == 0) continue;
+      deadline = (std::min)(deadline, task.lease_deadline);
+    }
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+      cv_.wait(lk);
+      continue;
+    }
+    if (cv_.wait_until(lk, deadline) != std::cv_status::timeout) continue;
+    lk.unlock();
+    // Tasks that cannot be sent are retried when their new lease expires.
+    ExpireLeases();
+    lk.lock();
+  }
+  return status_;
+}
+
+std::size_t PartitionCoordinator::completed() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return completed_;
+}
+
+bool PartitionCoordinator::done() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return DoneLocked();
+}
+
+PartitionTask PartitionCoordinator::NextAttempt(std::size_t index) {
+  auto& task = tasks_[index];
+  ++task.attempt;
+  task.lease_deadline =
+      std::chrono::steady_clock::now() + options_.lease_duration();
+  PartitionTask result;
+  result.export_id = export_id_;
+  result.index = index;
+  result.attempt = task.attempt;
+  result.kind = kind_;
+  result.partition = task.partition;
+  return result;
+}
+
+Status PartitionCoordinator::Send(std::vector<PartitionTask> tasks) {
+  Status result;
+  for (auto const& task : tasks) {
+    auto status = queue_->Send(SerializePartitionTask(task));
+    if (result.ok()) result = std::move(status);
+  }
+  return result;
+}
+
+bool PartitionCoordinator::DoneLocked() const {
+  return !status_.ok() || completed_ == tasks_.size();
+}
+
+StatusOr<PartitionReport> ExecutePartitionTask(
+    Client client, std::string const& serialized_task,
+    std::function<Status(Row)> const& callback) {
+  auto task = DeserializePartitionTask(serialized_task);
+  if (!task) return std::move(task).status();
+  PartitionReport report;
+  report.export_id = task->export_id;
+  report.index = task->index;
+  report.attempt = task->attempt;
+  report.status = RunTask(std::move(client), *task, callback);
+  return report;
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,252 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_PARTITION_COORDINATOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_PARTITION_COORDINATOR_H
+
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/query_partition.h"
+#include "google/cloud/spanner/read_partition.h"
+#include "google/cloud/spanner/row.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * A partition sent by a `PartitionCoordinator` to the workers.
+ *
+ * Use `SerializePartitionTask()` and `DeserializePartitionTask()` to send
+ * tasks between nodes. The format is independent of the transport.
+ */
+struct PartitionTask {
+  enum class Kind { kQuery, kRead };
+
+  /// Identifies the export, so several exports can share a queue.
+  std::string export_id;
+  /// The position of the partition in the export.
+  std::size_t index = 0;
+  /// Starts at 1, and increases each time the partition is sent again.
+  int attempt = 0;
+  Kind kind = Kind::kQuery;
+  /// The output of `SerializeQueryPartition()` or `SerializeReadPartition()`.
+  std::string partition;
+};
+
+/// The result of running a `PartitionTask`, sent back to the coordinator.
+struct PartitionReport {
+  std::string export_id;
+  std::size_t index = 0;
+  int attempt = 0;
+  Status status;
+};
+
+std::string SerializePartitionTask(PartitionTask const& task);
+StatusOr<PartitionTask> DeserializePartitionTask(std::string const& s);
+std::string SerializePartitionReport(PartitionReport const& report);
+StatusOr<PartitionReport> DeserializePartitionReport(std::string const& s);
+
+/**
+ * Delivers serialized `PartitionTask`s to the workers.
+ *
+ * Applications implement this class for their transport, e.g. publishing each
+ * task as a Pub/Sub message. A task may be delivered more than once.
+ */
+class PartitionTaskQueue {
+ public:
+  virtual ~PartitionTaskQueue() = default;
+  virtual Status Send(std::string serialized_task) = 0;
+};
+
+/// Configure a `PartitionCoordinator`.
+class PartitionCoordinatorOptions {
+ public:
+  /**
+   * How long a worker has to report on a task.
+   *
+   * Tasks without a report after this time, e.g. because the worker crashed,
+   * are sent again. The default is 10 minutes.
+   */
+  std::chrono::milliseconds lease_duration() const { return lease_duration_; }
+  PartitionCoordinatorOptions& set_lease_duration(std::chrono::milliseconds v) {
+    lease_duration_ = v;
+    return *this;
+  }
+
+  /**
+   * The maximum number of times each partition is sent.
+   *
+   * A partition that fails, or whose lease expires, this many times fails the
+   * export. The default is 3. Values < 1 are treated as 1.
+   */
+  int max_attempts() const { return max_attempts_; }
+  PartitionCoordinatorOptions& set_max_attempts(int v) {
+    max_attempts_ = v;
+    return *this;
+  }
+
+ private:
+  std::chrono::milliseconds lease_duration_ = std::chrono::minutes(10);
+  int max_attempts_ = 3;
+};
+
+/**
+ * Distributes the partitions of a query or read to workers on other nodes.
+ *
+ * `ExecutePartitions()` runs all the partitions in the calling process. To
+ * spread a large export across many nodes, create the partitions on a single
+ * node (the coordinator), and send them to workers running
+ * `ExecutePartitionTask()`. The workers send a `PartitionReport` back, using
+ * any transport, and the application gives it to `OnReport()`.
+ *
+ * The coordinator tracks a lease for each task. Failed tasks, and tasks whose
+ * lease expires, are sent again up to `max_attempts()` times. Thus a
+ * partition may run more than once: workers should write the output for each
+ * partition so that running it again replaces, rather than duplicates, that
+ * output.
+ *
+ * All the partitions of a single `Client::PartitionQuery()` or
+ * `Client::PartitionRead()` call use the same read-only transaction, and
+ * therefore read the same snapshot, regardless of which worker runs them.
+ *
+ * @par Thread-safety
+ * Instances of this class are guaranteed to work when accessed concurrently
+ * from multiple threads, e.g. `OnReport()` called from a subscriber callback
+ * while another thread blocks in `Wait()`.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * auto partitions = client.PartitionQuery(
+ *     spanner::MakeReadOnlyTransaction(),
+ *     spanner::SqlStatement("SELECT * FROM Singers"));
+ * if (!partitions) throw std::runtime_error(partitions.status().message());
+ * spanner::PartitionCoordinator coordinator("export-1", *std::move(partitions),
+ *                                           queue);
+ * auto status = coordinator.Start();
+ * // ... call coordinator.OnReport() as reports arrive ...
+ * if (status.ok()) status = coordinator.Wait();
+ * @endcode
+ */
+class PartitionCoordinator {
+ public:
+  PartitionCoordinator(std::string export_id,
+                       std::vector<QueryPartition> partitions,
+                       std::shared_ptr<PartitionTaskQueue> queue,
+                       PartitionCoordinatorOptions options = {});
+  PartitionCoordinator(std::string export_id,
+                       std::vector<ReadPartition> partitions,
+                       std::shared_ptr<PartitionTaskQueue> queue,
+                       PartitionCoordinatorOptions options = {});
+
+  PartitionCoordinator(PartitionCoordinator const&) = delete;
+  PartitionCoordinator& operator=(PartitionCoordinator const&) = delete;
+
+  /**
+   * Sends the first attempt of every partition.
+   *
+   * Returns the first error from the queue, if any. Tasks that could not be
+   * sent are sent again when their lease expires.
+   */
+  Status Start();
+
+  /**
+   * Records the outcome of a task.
+   *
+   * Failed tasks are sent again, unless they have no attempts left, in which
+   * case the export fails. A success from any attempt completes the
+   * partition, failures from earlier attempts are ignored. Reports for other
+   * exports, or for unknown partitions, return an error.
+   */
+  Status OnReport(PartitionReport const& report);
+
+  /// Sends again the tasks whose lease has expired.
+  Status ExpireLeases();
+
+  /**
+   * Blocks until all the partitions complete, or the export fails.
+   *
+   * Expired leases are handled while waiting.
+   */
+  Status Wait();
+
+  /// The number of partitions that have completed successfully.
+  std::size_t completed() const;
+
+  /// True if all the partitions completed, or the export failed.
+  bool done() const;
+
+ private:
+  struct Task {
+    std::string partition;
+    int attempt = 0;
+    bool completed = false;
+    std::chrono::steady_clock::time_point lease_deadline;
+  };
+
+  PartitionCoordinator(std::string export_id, PartitionTask::Kind kind,
+                       std::vector<StatusOr<std::string>> partitions,
+                       std::shared_ptr<PartitionTaskQueue> queue,
+                       PartitionCoordinatorOptions options);
+
+  // Starts a new attempt for the task at @p index, must hold `mu_`.
+  PartitionTask NextAttempt(std::size_t index);
+  Status Send(std::vector<PartitionTask> tasks);
+  bool DoneLocked() const;
+
+  std::string const export_id_;
+  PartitionTask::Kind const kind_;
+  std::shared_ptr<PartitionTaskQueue> const queue_;
+  PartitionCoordinatorOptions const options_;
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<Task> tasks_;    // GUARDED_BY(mu_)
+  std::size_t completed_ = 0;  // GUARDED_BY(mu_)
+  Status status_;              // GUARDED_BY(mu_)
+};
+
+/**
+ * Runs a task sent by a `PartitionCoordinator`, calling @p callback for each
+ * row.
+ *
+ * The partition is read using @p client, exactly as
+ * `Client::ExecuteQuery(QueryPartition const&)` (or
+ * `Client::Read(ReadPartition const&)`) would. Errors reading the partition,
+ * or returned by @p callback, are recorded in the report.
+ *
+ * @return the report to send back to the coordinator, or an error if
+ *     @p serialized_task is not a valid task.
+ */
+StatusOr<PartitionReport> ExecutePartitionTask(
+    Client client, std::string const& serialized_task,
+    std::function<Status(Row)> const& callback);
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_PARTITION_COORDINATOR_H
@@ -0,0 +1,333 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/partition_coordinator.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/query_partition.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+
+// Records the tasks sent to the workers.
+class FakeQueue : public PartitionTaskQueue {
+ public:
+  Status Send(std::string serialized_task) override {
+    auto task = DeserializePartitionTask(serialized_task);
+    if (!task) return std::move(task).status();
+    std::lock_guard<std::mutex> lk(mu_);
+    tasks_.push_back(*std::move(task));
+    return Status();
+  }
+
+  std::vector<PartitionTask> Take() {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::vector<PartitionTask> tasks;
+    tasks.swap(tasks_);
+    return tasks;
+  }
+
+ private:
+  std::mutex mu_;
+  std::vector<PartitionTask> tasks_;
+};
+
+std::vector<QueryPartition> MakeQueryPartitions(int count) {
+  std::vector<QueryPartition> partitions;
+  for (int i = 0; i != count; ++i) {
+    partitions.push_back(spanner_internal::MakeQueryPartition(
+        "txn", "session", "p" + std::to_string(i),
+        SqlStatement("SELECT * FROM Table")));
+  }
+  return partitions;
+}
+
+PartitionReport MakeReport(PartitionTask const& task, Status status = {}) {
+  PartitionReport report;
+  report.export_id = task.export_id;
+  report.index = task.index;
+  report.attempt = task.attempt;
+  report.status = std::move(status);
+  return report;
+}
+
+std::vector<std::size_t> Indexes(std::vector<PartitionTask> const& tasks) {
+  std::vector<std::size_t> indexes;
+  for (auto const& t : tasks) indexes.push_back(t.index);
+  return indexes;
+}
+
+Status TransientError() {
+  return Status(StatusCode::kUnavailable, "try-again");
+}
+
+TEST(PartitionCoordinatorTest, TaskRoundTrip) {
+  PartitionTask task;
+  task.export_id = "export:1";
+  task.index = 42;
+  task.attempt = 3;
+  task.kind = PartitionTask::Kind::kRead;
+  task.partition = std::string("12:\0binary", 10);
+
+  auto actual = DeserializePartitionTask(SerializePartitionTask(task));
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(task.export_id, actual->export_id);
+  EXPECT_EQ(task.index, actual->index);
+  EXPECT_EQ(task.attempt, actual->attempt);
+  EXPECT_EQ(task.kind, actual->kind);
+  EXPECT_EQ(task.partition, actual->partition);
+}
+
+TEST(PartitionCoordinatorTest, ReportRoundTrip) {
+  PartitionReport report;
+  report.export_id = "export-1";
+  report.index = 7;
+  report.attempt = 2;
+  report.status = Status(StatusCode::kNotFound, "no such table");
+
+  auto actual = DeserializePartitionReport(SerializePartitionReport(report));
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(report.export_id, actual->export_id);
+  EXPECT_EQ(report.index, actual->index);
+  EXPECT_EQ(report.attempt, actual->attempt);
+  EXPECT_EQ(report.status, actual->status);
+}
+
+TEST(PartitionCoordinatorTest, DeserializeInvalid) {
+  PartitionTask task;
+  task.export_id = "export-1";
+  auto const serialized = SerializePartitionTask(task);
+  for (auto const& input :
+       {std::string{}, std::string("garbage"),
+        serialized.substr(0, serialized.size() - 1),
+        SerializePartitionReport(PartitionReport{})}) {
+    SCOPED_TRACE("Testing with <" + input + ">");
+    EXPECT_THAT(DeserializePartitionTask(input),
+                StatusIs(StatusCode::kInvalidArgument));
+  }
+  EXPECT_THAT(DeserializePartitionReport(serialized),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(PartitionCoordinatorTest, Complete) {
+  auto queue = std::make_shared<FakeQueue>();
+  PartitionCoordinator tested("export-1", MakeQueryPartitions(3), queue);
+  ASSERT_STATUS_OK(tested.Start());
+  auto tasks = queue->Take();
+  ASSERT_THAT(Indexes(tasks), ElementsAre(0, 1, 2));
+  for (auto const& t : tasks) {
+    EXPECT_EQ("export-1", t.export_id);
+    EXPECT_EQ(1, t.attempt);
+    EXPECT_EQ(PartitionTask::Kind::kQuery, t.kind);
+    auto partition = DeserializeQueryPartition(t.partition);
+    ASSERT_STATUS_OK(partition);
+    EXPECT_EQ("p" + std::to_string(t.index), partition->partition_token());
+  }
+
+  for (auto const& t : tasks) {
+    EXPECT_FALSE(tested.done());
+    ASSERT_STATUS_OK(tested.OnReport(MakeReport(t)));
+  }
+  EXPECT_TRUE(tested.done());
+  EXPECT_EQ(3, tested.completed());
+  EXPECT_STATUS_OK(tested.Wait());
+  EXPECT_TRUE(queue->Take().empty());
+}
+
+TEST(PartitionCoordinatorTest, RetryFailures) {
+  auto queue = std::make_shared<FakeQueue>();
+  PartitionCoordinator tested(
+      "export-1", MakeQueryPartitions(2), queue,
+      PartitionCoordinatorOptions{}.set_max_attempts(2));
+  ASSERT_STATUS_OK(tested.Start());
+  auto tasks = queue->Take();
+  ASSERT_EQ(2, tasks.size());
+
+  ASSERT_STATUS_OK(tested.OnReport(MakeReport(tasks[0], TransientError())));
+  auto retry = queue->Take();
+  ASSERT_THAT(Indexes(retry), ElementsAre(0));
+  EXPECT_EQ(2, retry[0].attempt);
+
+  // A late failure from the first attempt is ignored.
+  ASSERT_STATUS_OK(tested.OnReport(MakeReport(tasks[0], TransientError())));
+  EXPECT_TRUE(queue->Take().empty());
+  EXPECT_FALSE(tested.done());
+
+  // The second attempt is the last one.
+  ASSERT_STATUS_OK(tested.OnReport(
+      MakeReport(retry[0], Status(StatusCode::kPermissionDenied, "uh-oh"))));
+  EXPECT_TRUE(queue->Take().empty());
+  EXPECT_TRUE(tested.done());
+  EXPECT_THAT(tested.Wait(), StatusIs(StatusCode::kPermissionDenied));
+}
+
+TEST(PartitionCoordinatorTest, EarlierAttemptSucceeds) {
+  auto queue = std::make_shared<FakeQueue>();
+  PartitionCoordinator tested(
+      "export-1", MakeQueryPartitions(1), queue,
+      PartitionCoordinatorOptions{}.set_lease_duration(
+          std::chrono::milliseconds(0)));
+  ASSERT_STATUS_OK(tested.Start());
+  auto tasks = queue->Take();
+  ASSERT_STATUS_OK(tested.ExpireLeases());
+  ASSERT_EQ(1, queue->Take().size());
+
+  // The first attempt was slow, but it did complete the partition.
+  ASSERT_STATUS_OK(tested.OnReport(MakeReport(tasks[0])));
+  EXPECT_TRUE(tested.done());
+  EXPECT_STATUS_OK(tested.Wait());
+}
+
+TEST(PartitionCoordinatorTest, RejectUnknownReports) {
+  auto queue = std::make_shared<FakeQueue>();
+  PartitionCoordinator tested("export-1", MakeQueryPartitions(1), queue);
+  ASSERT_STATUS_OK(tested.Start());
+  auto tasks = queue->Take();
+  ASSERT_EQ(1, tasks.size());
+
+  auto report = MakeReport(tasks[0]);
+  report.export_id = "export-2";
+  EXPECT_THAT(tested.OnReport(report), StatusIs(StatusCode::kInvalidArgument));
+  report = MakeReport(tasks[0]);
+  report.index = 1;
+  EXPECT_THAT(tested.OnReport(report), StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(0, tested.completed());
+}
+
+TEST(PartitionCoordinatorTest, ExpireLeases) {
+  auto queue = std::make_shared<FakeQueue>();
+  PartitionCoordinator tested(
+      "export-1", MakeQueryPartitions(2), queue,
+      PartitionCoordinatorOptions{}
+          .set_lease_duration(std::chrono::milliseconds(0))
+          .set_max_attempts(2));
+  ASSERT_STATUS_OK(tested.Start());
+  auto tasks = queue->Take();
+  ASSERT_STATUS_OK(tested.OnReport(MakeReport(tasks[1])));
+
+  // Only the partition without a report is sent again.
+  ASSERT_STATUS_OK(tested.ExpireLeases());
+  auto retry = queue->Take();
+  ASSERT_THAT(Indexes(retry), ElementsAre(0));
+  EXPECT_EQ(2, retry[0].attempt);
+
+  ASSERT_STATUS_OK(tested.ExpireLeases());
+  EXPECT_TRUE(queue->Take().empty());
+  EXPECT_TRUE(tested.done());
+  EXPECT_THAT(tested.Wait(), StatusIs(StatusCode::kDeadlineExceeded));
+}
+
+TEST(PartitionCoordinatorTest, WaitExpiresLeases) {
+  auto queue = std::make_shared<FakeQueue>();
+  PartitionCoordinator tested(
+      "export-1", MakeQueryPartitions(1), queue,
+      PartitionCoordinatorOptions{}
+          .set_lease_duration(std::chrono::milliseconds(5))
+          .set_max_attempts(3));
+  ASSERT_STATUS_OK(tested.Start());
+  EXPECT_THAT(tested.Wait(), StatusIs(StatusCode::kDeadlineExceeded));
+  EXPECT_EQ(3, queue->Take().size());
+}
+
+TEST(PartitionCoordinatorTest, ExecuteTask) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .WillOnce([](Connection::SqlParams const& params) {
+        EXPECT_EQ("p1", params.partition_token.value_or(""));
+        auto source = absl::make_unique<spanner_mocks::MockResultSetSource>();
+        EXPECT_CALL(*source, NextRow)
+            .WillOnce([] { return MakeTestRow(std::int64_t{1}); })
+            .WillOnce([] { return MakeTestRow(std::int64_t{2}); })
+            .WillOnce([] { return Row(); });
+        return RowStream(std::move(source));
+      });
+
+  auto queue = std::make_shared<FakeQueue>();
+  PartitionCoordinator coordinator("export-1", MakeQueryPartitions(2), queue);
+  ASSERT_STATUS_OK(coordinator.Start());
+  auto tasks = queue->Take();
+  ASSERT_EQ(2, tasks.size());
+
+  std::vector<std::int64_t> values;
+  auto report = ExecutePartitionTask(
+      Client(conn), SerializePartitionTask(tasks[1]), [&](Row row) {
+        auto value = row.get<std::int64_t>(0);
+        if (!value) return std::move(value).status();
+        values.push_back(*value);
+        return Status();
+      });
+  ASSERT_STATUS_OK(report);
+  EXPECT_STATUS_OK(report->status);
+  EXPECT_EQ(1, report->index);
+  EXPECT_EQ(1, report->attempt);
+  EXPECT_THAT(values, ElementsAre(1, 2));
+
+  // The report travels back to the coordinator in serialized form.
+  auto received = DeserializePartitionReport(SerializePartitionReport(*report));
+  ASSERT_STATUS_OK(received);
+  ASSERT_STATUS_OK(coordinator.OnReport(*received));
+  EXPECT_EQ(1, coordinator.completed());
+}
+
+TEST(PartitionCoordinatorTest, ExecuteTaskError) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .WillOnce([](Connection::SqlParams const&) {
+        auto source = absl::make_unique<spanner_mocks::MockResultSetSource>();
+        EXPECT_CALL(*source, NextRow).WillOnce([] {
+          return Status(StatusCode::kUnavailable, "try-again");
+        });
+        return RowStream(std::move(source));
+      });
+
+  PartitionTask task;
+  task.export_id = "export-1";
+  task.attempt = 1;
+  task.partition = *SerializeQueryPartition(MakeQueryPartitions(1)[0]);
+  auto report = ExecutePartitionTask(Client(conn),
+                                     SerializePartitionTask(task),
+                                     [](Row) { return Status(); });
+  ASSERT_STATUS_OK(report);
+  EXPECT_THAT(report->status, StatusIs(StatusCode::kUnavailable));
+}
+
+TEST(PartitionCoordinatorTest, ExecuteInvalidTask) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_)).Times(0);
+  auto report = ExecutePartitionTask(Client(conn), "garbage",
+                                     [](Row) { return Status(); });
+  EXPECT_THAT(report, StatusIs(StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
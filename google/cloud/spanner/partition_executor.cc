@@ -0,0 +1,439 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/partition_executor.h"
+#include "google/cloud/spanner/retry_policy.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+// Starts reading the partition with the given index.
+using OpenPartition = std::function<RowStream(std::size_t)>;
+
+std::size_t DefaultConcurrency() {
+  auto const n = std::thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+std::size_t ThreadCount(PartitionExecutorOptions const& options,
+                        std::size_t partition_count) {
+  return (std::min)((std::max)(options.max_concurrency(), std::size_t{1}),
+                    partition_count);
+}
+
+Status CancelledStatus() {
+  return Status(StatusCode::kCancelled, "partition execution cancelled");
+}
+
+/**
+ * Reads the partition with the given @p index, sending each row to @p sink.
+ *
+ * Returns early if @p sink returns an error, or if @p cancelled is set.
+ */
+Status RunPartition(OpenPartition const& open, std::size_t index,
+                    int max_attempts, std::function<Status(Row)> const& sink,
+                    std::atomic<bool> const& cancelled) {
+  for (int attempt = 1;; ++attempt) {
+    auto rows = open(index);
+    bool delivered = false;
+    Status status;
+    for (auto& row : rows) {
+      if (cancelled.load()) return CancelledStatus();
+      if (!row) {
+        status = std::move(row).status();
+        break;
+      }
+      delivered = true;
+      auto s = sink(*std::move(row));
+      if (!s.ok()) return s;
+    }
+    // Retrying after some rows were delivered would deliver them twice.
+    if (status.ok() || delivered || attempt >= max_attempts ||
+        !spanner_internal::SafeGrpcRetry::IsTransientFailure(status)) {
+      return status;
+    }
+  }
+}
+
+Status ExecutePartitionsImpl(OpenPartition const& open, std::size_t count,
+                             PartitionRowCallback const& callback,
+                             PartitionExecutorOptions const& options) {
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool> cancelled{false};
+  std::mutex mu;
+  Status first_error;  // GUARDED_BY(mu)
+  auto worker = [&] {
+    for (auto i = next++; i < count && !cancelled.load(); i = next++) {
+      auto status = RunPartition(
+          open, i, options.max_attempts(),
+          [&callback, i](Row row) { return callback(i, std::move(row)); },
+          cancelled);
+      if (status.ok()) continue;
+      std::lock_guard<std::mutex> lk(mu);
+      if (first_error.ok()) first_error = std::move(status);
+      cancelled.store(true);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < ThreadCount(options, count); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) t.join();
+  return first_error;
+}
+
+/**
+ * Reads the partitions on a pool of threads and returns their rows.
+ *
+ * The threads take the partitions in order. In ordered mode this guarantees
+ * the partition the application is waiting for is always in progress (or
+ * finished), even when all the other threads are blocked on full buffers.
+ */
+class MergedPartitionsSource : public spanner_internal::ResultSourceInterface {
+ public:
+  MergedPartitionsSource(OpenPartition open, std::size_t count,
+                         PartitionExecutorOptions const& options)
+      : open_(std::move(open)),
+        options_(options),
+        capacity_((std::max)(options.buffered_rows_per_partition(),
+                             std::size_t{1})),
+        partitions_(count) {
+    for (std::size_t i = 0; i != ThreadCount(options_, count); ++i) {
+      workers_.emplace_back([this] { Worker(); });
+    }
+  }
+
+  ~MergedPartitionsSource() override {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      cancelled_.store(true);
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+  }
+
+  StatusOr<Row> NextRow() override {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+      if (!final_status_.ok()) return final_status_;
+      if (options_.ordered()) {
+        while (current_ != partitions_.size()) {
+          auto& p = partitions_[current_];
+          if (!p.rows.empty()) return Pop(lk, p);
+          if (!p.done) break;
+          if (!p.status.ok()) return Fail(lk, p.status);
+          ++current_;
+        }
+        if (current_ == partitions_.size()) return Row{};
+      } else {
+        // Start the scan after the last partition that returned a row, so all
+        // the partitions make progress.
+        auto const size = partitions_.size();
+        for (std::size_t i = 0; i != size; ++i) {
+          auto const index = (current_ + i) % size;
+          auto& p = partitions_[index];
+          if (!p.rows.empty()) {
+            current_ = (index + 1) % size;
+            return Pop(lk, p);
+          }
+          if (p.done && !p.status.ok()) return Fail(lk, p.status);
+        }
+        if (done_count_ == size) return Row{};
+      }
+      cv_.wait(lk);
+    }
+  }
+
+  absl::optional<google::spanner::v1::ResultSetMetadata> Metadata() override {
+    return {};
+  }
+
+  absl::optional<google::spanner::v1::ResultSetStats> Stats() const override {
+    return {};
+  }
+
+ private:
+  struct Partition {
+    std::deque<Row> rows;
+    bool done = false;
+    Status status;
+  };
+
+  void Worker() {
+    for (;;) {
+      std::size_t index;
+      {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (cancelled_.load() || next_partition_ == partitions_.size()) return;
+        index = next_partition_++;
+      }
+      auto status = RunPartition(
+          open_, index, options_.max_attempts(),
+          [this, index](Row row) { return Push(index, std::move(row)); },
+          cancelled_);
+      {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto& p = partitions_[index];
+        p.done = true;
+        p.status = std::move(status);
+        ++done_count_;
+      }
+      cv_.notify_all();
+    }
+  }
+
+  Status Push(std::size_t index, Row row) {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto& p = partitions_[index];
+    cv_.wait(lk,
+             [&] { return cancelled_.load() || p.rows.size() < capacity_; });
+    if (cancelled_.load()) return CancelledStatus();
+    p.rows.push_back(std::move(row));
+    lk.unlock();
+    cv_.notify_all();
+    return Status();
+  }
+
+  StatusOr<Row> Pop(std::unique_lock<std::mutex>& lk, Partition& p) {
+    auto row = std::move(p.rows.front());
+    p.rows.pop_front();
+    lk.unlock();
+    cv_.notify_all();
+    return StatusOr<Row>(std::move(row));
+  }
+
+  StatusOr<Row> Fail(std::unique_lock<std::mutex>& lk, Status const& status) {
+    final_status_ = status;
+    cancelled_.store(true);
+    lk.unlock();
+    cv_.notify_all();
+    return status;
+  }
+
+  OpenPartition const open_;
+  PartitionExecutorOptions const options_;
+  std::size_t const capacity_;
+  std::atomic<bool> cancelled_{false};
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<Partition> partitions_;  // GUARDED_BY(mu_)
+  std::size_t next_partition_ = 0;     // GUARDED_BY(mu_)
+  std::size_t current_ = 0;            // GUARDED_BY(mu_)
+  std::size_t done_count_ = 0;         // GUARDED_BY(mu_)
+  Status final_status_;                // GUARDED_BY(mu_)
+  std::vector<std::thread> workers_;
+};
+
+OpenPartition MakeOpenPartition(Client client,
+                                std::vector<QueryPartition> partitions) {
+  auto p = std::make_shared<std::vector<QueryPartition>>(std::move(partitions));
+  return [client, p](std::size_t index) {
+    auto c = client;
+    return c.ExecuteQuery((*p)[index]);
+  };
+}
+
+OpenPartition MakeOpenPartition(Client client,
+                                std::vector<ReadPartition> partitions) {
+  auto p = std::make_shared<std::vector<ReadPartition>>(std::move(partitions));
+  return [client, p](std::size_t index) {
+    auto c = client;
+    return c.Read((*p)[index]);
+  };
+}
+
+OpenPartition MakeOpenChunk(Client client,
+                            Transaction::SingleUseOptions transaction_options,
+                            std::string table, std::vector<KeySet> chunks,
+                            std::vector<std::string> columns,
+                            ReadOptions read_options) {
+  auto p = std::make_shared<std::vector<KeySet>>(std::move(chunks));
+  return [client, transaction_options, table, p, columns,
+          read_options](std::size_t index) {
+    auto c = client;
+    return c.Read(transaction_options, table, (*p)[index], columns,
+                  read_options);
+  };
+}
+
+// Returns true and sets @p n if @p s is the wire representation of an INT64.
+bool ParseInt64(std::string const& s, std::int64_t& n) {
+  if (s.empty()) return false;
+  char* end = nullptr;
+  errno = 0;
+  auto v = std::strtoll(s.c_str(), &end, 10);
+  if (errno != 0 || end != s.c_str() + s.size()) return false;
+  n = static_cast<std::int64_t>(v);
+  return true;
+}
+
+// Compares two key values, returns <0, 0, or >0 as `strcmp()` does.
+int CompareKeyValue(google::protobuf::Value const& a,
+                    google::protobuf::Value const& b) {
+  if (a.kind_case() != b.kind_case()) {
+    return a.kind_case() < b.kind_case() ? -1 : 1;
+  }
+  switch (a.kind_case()) {
+    case google::protobuf::Value::kNumberValue:
+      if (a.number_value() == b.number_value()) return 0;
+      return a.number_value() < b.number_value() ? -1 : 1;
+    case google::protobuf::Value::kBoolValue:
+      return static_cast<int>(a.bool_value()) -
+             static_cast<int>(b.bool_value());
+    case google::protobuf::Value::kStringValue: {
+      std::int64_t x;
+      std::int64_t y;
+      if (ParseInt64(a.string_value(), x) && ParseInt64(b.string_value(), y)) {
+        if (x == y) return 0;
+        return x < y ? -1 : 1;
+      }
+      return a.string_value().compare(b.string_value());
+    }
+    default:
+      return 0;
+  }
+}
+
+bool KeyLess(google::protobuf::ListValue const& a,
+             google::protobuf::ListValue const& b) {
+  auto const n = (std::min)(a.values_size(), b.values_size());
+  for (int i = 0; i != n; ++i) {
+    auto c = CompareKeyValue(a.values(i), b.values(i));
+    if (c != 0) return c < 0;
+  }
+  return a.values_size() < b.values_size();
+}
+
+}  // namespace
+
+PartitionExecutorOptions::PartitionExecutorOptions()
+    : max_concurrency_(DefaultConcurrency()) {}
+
+Status ExecutePartitions(Client client, std::vector<QueryPartition> partitions,
+                         PartitionRowCallback callback,
+                         PartitionExecutorOptions const& options) {
+  auto const count = partitions.size();
+  return ExecutePartitionsImpl(
+      MakeOpenPartition(std::move(client), std::move(partitions)), count,
+      callback, options);
+}
+
+Status ExecutePartitions(Client client, std::vector<ReadPartition> partitions,
+                         PartitionRowCallback callback,
+                         PartitionExecutorOptions const& options) {
+  auto const count = partitions.size();
+  return ExecutePartitionsImpl(
+      MakeOpenPartition(std::move(client), std::move(partitions)), count,
+      callback, options);
+}
+
+RowStream MergePartitions(Client client, std::vector<QueryPartition> partitions,
+                          PartitionExecutorOptions const& options) {
+  auto const count = partitions.size();
+  return RowStream(absl::make_unique<MergedPartitionsSource>(
+      MakeOpenPartition(std::move(client), std::move(partitions)), count,
+      options));
+}
+
+RowStream MergePartitions(Client client, std::vector<ReadPartition> partitions,
+                          PartitionExecutorOptions const& options) {
+  auto const count = partitions.size();
+  return RowStream(absl::make_unique<MergedPartitionsSource>(
+      MakeOpenPartition(std::move(client), std::move(partitions)), count,
+      options));
+}
+
+std::vector<KeySet> SplitKeySet(KeySet keys, std::size_t max_keys_per_chunk) {
+  auto proto = spanner_internal::ToProto(std::move(keys));
+  if (proto.all()) return {KeySet::All()};
+  max_keys_per_chunk = (std::max)(max_keys_per_chunk, std::size_t{1});
+
+  std::vector<google::protobuf::ListValue> sorted(
+      std::make_move_iterator(proto.mutable_keys()->begin()),
+      std::make_move_iterator(proto.mutable_keys()->end()));
+  std::sort(sorted.begin(), sorted.end(), KeyLess);
+
+  std::vector<KeySet> chunks;
+  google::spanner::v1::KeySet chunk;
+  for (auto& k : sorted) {
+    *chunk.add_keys() = std::move(k);
+    if (static_cast<std::size_t>(chunk.keys_size()) < max_keys_per_chunk) {
+      continue;
+    }
+    chunks.push_back(spanner_internal::FromProto(std::move(chunk)));
+    chunk = google::spanner::v1::KeySet();
+  }
+  if (chunk.keys_size() != 0) {
+    chunks.push_back(spanner_internal::FromProto(std::move(chunk)));
+  }
+  for (auto& r : *proto.mutable_ranges()) {
+    google::spanner::v1::KeySet range;
+    *range.add_ranges() = std::move(r);
+    chunks.push_back(spanner_internal::FromProto(std::move(range)));
+  }
+  return chunks;
+}
+
+Status ParallelRead(Client client,
+                    Transaction::SingleUseOptions transaction_options,
+                    std::string table, KeySet keys,
+                    std::vector<std::string> columns,
+                    PartitionRowCallback callback, ReadOptions read_options,
+                    PartitionExecutorOptions const& options) {
+  auto chunks = SplitKeySet(std::move(keys), options.max_keys_per_chunk());
+  auto const count = chunks.size();
+  return ExecutePartitionsImpl(
+      MakeOpenChunk(std::move(client), std::move(transaction_options),
+                    std::move(table), std::move(chunks), std::move(columns),
+                    std::move(read_options)),
+      count, callback, options);
+}
+
+RowStream ParallelRead(Client client,
+                       Transaction::SingleUseOptions transaction_options,
+                       std::string table, KeySet keys,
+                       std::vector<std::string> columns,
+                       ReadOptions read_options,
+                       PartitionExecutorOptions const& options) {
+  auto chunks = SplitKeySet(std::move(keys), options.max_keys_per_chunk());
+  auto const count = chunks.size();
+  return RowStream(absl::make_unique<MergedPartitionsSource>(
+      MakeOpenChunk(std::move(client), std::move(transaction_options),
+                    std::move(table), std::move(chunks), std::move(columns),
+                    std::move(read_options)),
+      count, options));
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,248 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_PARTITION_EXECUTOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_PARTITION_EXECUTOR_H
+
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/keys.h"
+#include "google/cloud/spanner/query_partition.h"
+#include "google/cloud/spanner/read_options.h"
+#include "google/cloud/spanner/read_partition.h"
+#include "google/cloud/spanner/results.h"
+#include "google/cloud/spanner/row.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// Configure `ExecutePartitions()` and `MergePartitions()`.
+class PartitionExecutorOptions {
+ public:
+  PartitionExecutorOptions();
+
+  /**
+   * The maximum number of partitions processed at the same time.
+   *
+   * Each partition in progress uses a thread. The default is the number of
+   * hardware threads. Values < 1 are treated as 1.
+   */
+  std::size_t max_concurrency() const { return max_concurrency_; }
+  PartitionExecutorOptions& set_max_concurrency(std::size_t v) {
+    max_concurrency_ = v;
+    return *this;
+  }
+
+  /**
+   * The maximum number of attempts for each partition.
+   *
+   * A partition is retried if it fails with a transient error before
+   * returning any rows. Once rows are returned the error is reported, because
+   * retrying would return the same rows twice. The default is 3.
+   */
+  int max_attempts() const { return max_attempts_; }
+  PartitionExecutorOptions& set_max_attempts(int v) {
+    max_attempts_ = v;
+    return *this;
+  }
+
+  /**
+   * Return the rows of `MergePartitions()` in partition order.
+   *
+   * By default the rows are returned as soon as they are received, from all
+   * the partitions in progress. With this option all the rows from the first
+   * partition are returned before the rows from the second partition, and so
+   * on. The partitions are still read concurrently, up to
+   * `buffered_rows_per_partition()` rows ahead of the application.
+   */
+  bool ordered() const { return ordered_; }
+  PartitionExecutorOptions& set_ordered(bool v) {
+    ordered_ = v;
+    return *this;
+  }
+
+  /**
+   * The maximum number of rows `MergePartitions()` buffers for each partition.
+   *
+   * Reading a partition pauses when its buffer is full, this bounds the memory
+   * used when the application consumes rows slower than they arrive. The
+   * default is 1024. Values < 1 are treated as 1.
+   */
+  std::size_t buffered_rows_per_partition() const {
+    return buffered_rows_per_partition_;
+  }
+  PartitionExecutorOptions& set_buffered_rows_per_partition(std::size_t v) {
+    buffered_rows_per_partition_ = v;
+    return *this;
+  }
+
+  /**
+   * The maximum number of keys in each chunk of a `ParallelRead()`.
+   *
+   * Smaller chunks spread the read over more sessions, larger chunks reduce
+   * the number of RPCs. The default is 1000. Values < 1 are treated as 1.
+   */
+  std::size_t max_keys_per_chunk() const { return max_keys_per_chunk_; }
+  PartitionExecutorOptions& set_max_keys_per_chunk(std::size_t v) {
+    max_keys_per_chunk_ = v;
+    return *this;
+  }
+
+ private:
+  std::size_t max_concurrency_;
+  int max_attempts_ = 3;
+  bool ordered_ = false;
+  std::size_t buffered_rows_per_partition_ = 1024;
+  std::size_t max_keys_per_chunk_ = 1000;
+};
+
+/**
+ * Receives the rows from `ExecutePartitions()`.
+ *
+ * The first argument is the index of the partition that returned the row. The
+ * callback is invoked from several threads at the same time, but only from one
+ * thread at a time for any given partition, and in the order the rows are
+ * received from that partition. Returning an error stops the execution.
+ */
+using PartitionRowCallback = std::function<Status(std::size_t, Row)>;
+
+//@{
+/**
+ * Reads all the @p partitions in parallel and calls @p callback for each row.
+ *
+ * The partitions run on a bounded pool of threads, see
+ * `PartitionExecutorOptions`. Each partition is read using `client`, exactly
+ * as `Client::ExecuteQuery(QueryPartition const&)` (or
+ * `Client::Read(ReadPartition const&)`) would.
+ *
+ * @return the first error returned by a partition or by @p callback, in which
+ *     case the remaining partitions are cancelled, or an OK status once all
+ *     the rows were delivered.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * auto partitions = client.PartitionQuery(
+ *     txn, spanner::SqlStatement("SELECT SingerId, FirstName FROM Singers"));
+ * if (!partitions) throw std::runtime_error(partitions.status().message());
+ * std::atomic<std::int64_t> count{0};
+ * auto status = spanner::ExecutePartitions(
+ *     client, *std::move(partitions), [&](std::size_t, spanner::Row) {
+ *       ++count;
+ *       return google::cloud::Status();
+ *     });
+ * @endcode
+ */
+Status ExecutePartitions(Client client, std::vector<QueryPartition> partitions,
+                         PartitionRowCallback callback,
+                         PartitionExecutorOptions const& options = {});
+Status ExecutePartitions(Client client, std::vector<ReadPartition> partitions,
+                         PartitionRowCallback callback,
+                         PartitionExecutorOptions const& options = {});
+//@}
+
+//@{
+/**
+ * Reads all the @p partitions in parallel and returns their rows as a single
+ * `RowStream`.
+ *
+ * The partitions run on a bounded pool of threads, see
+ * `PartitionExecutorOptions`. The first error from any partition is returned
+ * by the stream, after which the remaining partitions are cancelled.
+ * Destroying the stream also cancels the partitions still in progress.
+ *
+ * @note The returned stream has no `ReadTimestamp()`.
+ */
+RowStream MergePartitions(Client client, std::vector<QueryPartition> partitions,
+                          PartitionExecutorOptions const& options = {});
+RowStream MergePartitions(Client client, std::vector<ReadPartition> partitions,
+                          PartitionExecutorOptions const& options = {});
+//@}
+
+/**
+ * Splits @p keys into chunks that can be read independently.
+ *
+ * The keys are sorted, so each chunk covers a narrow part of the table, and
+ * then grouped into chunks of up to @p max_keys_per_chunk keys. Each key
+ * range becomes a chunk on its own, as its size is unknown. `KeySet::All()`
+ * cannot be split and is returned as a single chunk.
+ *
+ * Keys are sorted using their values only: numbers (including `INT64`
+ * values) in numeric order, and other values in the lexicographic order of
+ * their wire representation. For some types (e.g. `BYTES`) this does not
+ * match the table order. The chunks are still correct, only less compact.
+ */
+std::vector<KeySet> SplitKeySet(KeySet keys, std::size_t max_keys_per_chunk);
+
+//@{
+/**
+ * Reads the rows for a large @p keys set using many concurrent reads.
+ *
+ * `Client::Read()` runs as a single streaming RPC, which limits its
+ * throughput. This function splits @p keys (see `SplitKeySet()` and
+ * `PartitionExecutorOptions::max_keys_per_chunk()`), and reads the chunks in
+ * parallel, as separate single-use transactions. Each chunk uses its own
+ * session, and is retried (see `PartitionExecutorOptions::max_attempts()`)
+ * like a partition.
+ *
+ * The first overload calls @p callback for each row, with the index of its
+ * chunk, as `ExecutePartitions()` does. The second overload returns all the
+ * rows in a single stream, as `MergePartitions()` does. Set
+ * `PartitionExecutorOptions::set_ordered()` to receive the rows in chunk
+ * order.
+ *
+ * @warning Each chunk is a separate transaction. Use an exact read timestamp,
+ *     i.e., `Transaction::ReadOnlyOptions(Timestamp)`, if all the chunks must
+ *     read the same snapshot.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * auto rows = spanner::ParallelRead(
+ *     client, spanner::Transaction::ReadOnlyOptions(read_timestamp),
+ *     "Singers", std::move(keys), {"SingerId", "FirstName"});
+ * for (auto const& row : rows) {
+ *   if (!row) throw std::runtime_error(row.status().message());
+ *   // ... use the row ...
+ * }
+ * @endcode
+ */
+Status ParallelRead(Client client,
+                    Transaction::SingleUseOptions transaction_options,
+                    std::string table, KeySet keys,
+                    std::vector<std::string> columns,
+                    PartitionRowCallback callback,
+                    ReadOptions read_options = {},
+                    PartitionExecutorOptions const& options = {});
+RowStream ParallelRead(Client client,
+                       Transaction::SingleUseOptions transaction_options,
+                       std::string table, KeySet keys,
+                       std::vector<std::string> columns,
+                       ReadOptions read_options = {},
+                       PartitionExecutorOptions const& options = {});
+//@}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_PARTITION_EXECUTOR_H
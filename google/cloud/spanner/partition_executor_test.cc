@@ -0,0 +1,313 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/partition_executor.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/query_partition.h"
+#include "google/cloud/spanner/read_partition.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+
+// Returns the rows in `values`, then `status` (or the end of the stream).
+class FakeSource : public spanner_internal::ResultSourceInterface {
+ public:
+  explicit FakeSource(std::vector<std::int64_t> values, Status status = {})
+      : values_(std::move(values)), status_(std::move(status)) {}
+
+  StatusOr<Row> NextRow() override {
+    if (next_ != values_.size()) return MakeTestRow(values_[next_++]);
+    if (!status_.ok()) return status_;
+    return Row();
+  }
+  absl::optional<google::spanner::v1::ResultSetMetadata> Metadata() override {
+    return {};
+  }
+  absl::optional<google::spanner::v1::ResultSetStats> Stats() const override {
+    return {};
+  }
+
+ private:
+  std::vector<std::int64_t> values_;
+  Status status_;
+  std::size_t next_ = 0;
+};
+
+RowStream MakeRows(std::vector<std::int64_t> values, Status status = {}) {
+  return RowStream(
+      absl::make_unique<FakeSource>(std::move(values), std::move(status)));
+}
+
+// Partition "p<i>" returns the values 10 * i, 10 * i + 1, 10 * i + 2.
+RowStream RowsForPartition(std::string const& token) {
+  auto const i = std::stoi(token.substr(1));
+  return MakeRows({10 * i, 10 * i + 1, 10 * i + 2});
+}
+
+std::vector<QueryPartition> MakeQueryPartitions(int count) {
+  std::vector<QueryPartition> partitions;
+  for (int i = 0; i != count; ++i) {
+    partitions.push_back(spanner_internal::MakeQueryPartition(
+        "txn", "session", "p" + std::to_string(i),
+        SqlStatement("SELECT * FROM Table")));
+  }
+  return partitions;
+}
+
+std::vector<std::int64_t> Values(RowStream& rows, Status& status) {
+  std::vector<std::int64_t> values;
+  for (auto& row : StreamOf<std::tuple<std::int64_t>>(rows)) {
+    if (!row) {
+      status = std::move(row).status();
+      break;
+    }
+    values.push_back(std::get<0>(*row));
+  }
+  return values;
+}
+
+TEST(PartitionExecutorTest, ExecuteQueryPartitions) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .Times(4)
+      .WillRepeatedly([](Connection::SqlParams const& params) {
+        return RowsForPartition(params.partition_token.value_or(""));
+      });
+
+  std::mutex mu;
+  std::vector<std::vector<std::int64_t>> received(4);
+  auto status = ExecutePartitions(
+      Client(conn), MakeQueryPartitions(4),
+      [&](std::size_t index, Row row) {
+        auto value = row.get<std::int64_t>(0);
+        if (!value) return std::move(value).status();
+        std::lock_guard<std::mutex> lk(mu);
+        received[index].push_back(*value);
+        return Status();
+      },
+      PartitionExecutorOptions{}.set_max_concurrency(2));
+  ASSERT_STATUS_OK(status);
+  EXPECT_THAT(received[0], ElementsAre(0, 1, 2));
+  EXPECT_THAT(received[1], ElementsAre(10, 11, 12));
+  EXPECT_THAT(received[2], ElementsAre(20, 21, 22));
+  EXPECT_THAT(received[3], ElementsAre(30, 31, 32));
+}
+
+TEST(PartitionExecutorTest, ExecuteRetriesTransientFailures) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .WillOnce([](Connection::SqlParams const&) {
+        return MakeRows({}, Status(StatusCode::kUnavailable, "try-again"));
+      })
+      .WillOnce([](Connection::SqlParams const& params) {
+        return RowsForPartition(params.partition_token.value_or(""));
+      });
+
+  int count = 0;
+  auto status = ExecutePartitions(
+      Client(conn), MakeQueryPartitions(1), [&](std::size_t, Row) {
+        ++count;
+        return Status();
+      });
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(3, count);
+}
+
+TEST(PartitionExecutorTest, ExecuteNoRetryAfterRows) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .WillOnce([](Connection::SqlParams const&) {
+        return MakeRows({1}, Status(StatusCode::kUnavailable, "try-again"));
+      });
+
+  auto status = ExecutePartitions(Client(conn), MakeQueryPartitions(1),
+                                  [](std::size_t, Row) { return Status(); });
+  EXPECT_THAT(status, StatusIs(StatusCode::kUnavailable, "try-again"));
+}
+
+TEST(PartitionExecutorTest, ExecuteCallbackError) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .WillRepeatedly([](Connection::SqlParams const& params) {
+        return RowsForPartition(params.partition_token.value_or(""));
+      });
+
+  auto status = ExecutePartitions(
+      Client(conn), MakeQueryPartitions(8),
+      [](std::size_t, Row) { return Status(StatusCode::kAborted, "stop"); });
+  EXPECT_THAT(status, StatusIs(StatusCode::kAborted, "stop"));
+}
+
+TEST(PartitionExecutorTest, MergeUnordered) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .Times(3)
+      .WillRepeatedly([](Connection::SqlParams const& params) {
+        return RowsForPartition(params.partition_token.value_or(""));
+      });
+
+  auto rows = MergePartitions(Client(conn), MakeQueryPartitions(3),
+                              PartitionExecutorOptions{}
+                                  .set_max_concurrency(2)
+                                  .set_buffered_rows_per_partition(1));
+  Status status;
+  EXPECT_THAT(Values(rows, status),
+              UnorderedElementsAre(0, 1, 2, 10, 11, 12, 20, 21, 22));
+  EXPECT_STATUS_OK(status);
+}
+
+TEST(PartitionExecutorTest, MergeOrdered) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .Times(5)
+      .WillRepeatedly([](Connection::SqlParams const& params) {
+        return RowsForPartition(params.partition_token.value_or(""));
+      });
+
+  auto rows = MergePartitions(Client(conn), MakeQueryPartitions(5),
+                              PartitionExecutorOptions{}
+                                  .set_max_concurrency(2)
+                                  .set_ordered(true)
+                                  .set_buffered_rows_per_partition(1));
+  Status status;
+  EXPECT_THAT(Values(rows, status),
+              ElementsAre(0, 1, 2, 10, 11, 12, 20, 21, 22, 30, 31, 32, 40, 41,
+                          42));
+  EXPECT_STATUS_OK(status);
+}
+
+TEST(PartitionExecutorTest, MergeError) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .WillRepeatedly([](Connection::SqlParams const& params) {
+        if (params.partition_token.value_or("") == "p1") {
+          return MakeRows({}, Status(StatusCode::kPermissionDenied, "uh-oh"));
+        }
+        return RowsForPartition(params.partition_token.value_or(""));
+      });
+
+  auto rows = MergePartitions(
+      Client(conn), MakeQueryPartitions(3),
+      PartitionExecutorOptions{}.set_max_concurrency(1).set_ordered(true));
+  Status status;
+  EXPECT_THAT(Values(rows, status), ElementsAre(0, 1, 2));
+  EXPECT_THAT(status, StatusIs(StatusCode::kPermissionDenied, "uh-oh"));
+}
+
+TEST(PartitionExecutorTest, MergeReadPartitions) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Read(_))
+      .Times(2)
+      .WillRepeatedly([](Connection::ReadParams const& params) {
+        EXPECT_EQ("Table", params.table);
+        return RowsForPartition(params.partition_token.value_or(""));
+      });
+
+  std::vector<ReadPartition> partitions;
+  for (int i = 0; i != 2; ++i) {
+    partitions.push_back(spanner_internal::MakeReadPartition(
+        "txn", "session", "p" + std::to_string(i), "Table", KeySet::All(),
+        {"Value"}));
+  }
+  auto rows = MergePartitions(Client(conn), std::move(partitions));
+  Status status;
+  EXPECT_THAT(Values(rows, status), UnorderedElementsAre(0, 1, 2, 10, 11, 12));
+  EXPECT_STATUS_OK(status);
+}
+
+TEST(PartitionExecutorTest, MergeEmpty) {
+  auto conn = std::make_shared<MockConnection>();
+  auto rows = MergePartitions(Client(conn), std::vector<QueryPartition>{});
+  Status status;
+  EXPECT_THAT(Values(rows, status), ElementsAre());
+  EXPECT_STATUS_OK(status);
+}
+
+TEST(PartitionExecutorTest, SplitKeySet) {
+  auto keys = KeySet()
+                  .AddKey(MakeKey(std::int64_t{10}))
+                  .AddKey(MakeKey(std::int64_t{2}))
+                  .AddKey(MakeKey(std::int64_t{-1}))
+                  .AddRange(MakeKeyBoundClosed(std::int64_t{20}),
+                            MakeKeyBoundOpen(std::int64_t{30}))
+                  .AddKey(MakeKey(std::int64_t{3}));
+  auto chunks = SplitKeySet(std::move(keys), 2);
+  ASSERT_EQ(3, chunks.size());
+  EXPECT_EQ(KeySet()
+                .AddKey(MakeKey(std::int64_t{-1}))
+                .AddKey(MakeKey(std::int64_t{2})),
+            chunks[0]);
+  EXPECT_EQ(KeySet()
+                .AddKey(MakeKey(std::int64_t{3}))
+                .AddKey(MakeKey(std::int64_t{10})),
+            chunks[1]);
+  EXPECT_EQ(KeySet().AddRange(MakeKeyBoundClosed(std::int64_t{20}),
+                              MakeKeyBoundOpen(std::int64_t{30})),
+            chunks[2]);
+
+  chunks = SplitKeySet(KeySet::All(), 2);
+  ASSERT_EQ(1, chunks.size());
+  EXPECT_EQ(KeySet::All(), chunks[0]);
+}
+
+TEST(PartitionExecutorTest, ParallelRead) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Read(_))
+      .Times(3)
+      .WillRepeatedly([](Connection::ReadParams const& params) {
+        EXPECT_EQ("Table", params.table);
+        // Return the values of the keys in the chunk.
+        std::vector<std::int64_t> values;
+        for (auto const& k : spanner_internal::ToProto(params.keys).keys()) {
+          values.push_back(std::stoll(k.values(0).string_value()));
+        }
+        return MakeRows(std::move(values));
+      });
+
+  KeySet keys;
+  for (std::int64_t i = 0; i != 5; ++i) keys.AddKey(MakeKey(4 - i));
+  auto rows = ParallelRead(Client(conn),
+                           Transaction::SingleUseOptions(
+                               Transaction::ReadOnlyOptions()),
+                           "Table", std::move(keys), {"Value"}, {},
+                           PartitionExecutorOptions{}
+                               .set_max_concurrency(2)
+                               .set_max_keys_per_chunk(2)
+                               .set_ordered(true));
+  Status status;
+  EXPECT_THAT(Values(rows, status), ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_STATUS_OK(status);
+}
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,84 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_READ_CACHE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_READ_CACHE_H
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/version.h"
+#include <cstddef>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// Configure the connections created by `MakeReadCachingConnection()`.
+class ReadCacheOptions {
+ public:
+  ReadCacheOptions() = default;
+
+  /**
+   * The maximum number of cached reads.
+   *
+   * When the cache is full the least recently used read is discarded. The
+   * default is 1,000. Each entry keeps all the rows returned by a read, only
+   * cache reads of a few rows, such as configuration or feature flag rows.
+   */
+  std::size_t max_entries() const { return max_entries_; }
+  ReadCacheOptions& set_max_entries(std::size_t v) {
+    max_entries_ = v;
+    return *this;
+  }
+
+ private:
+  std::size_t max_entries_ = 1000;
+};
+
+/**
+ * Returns a `Connection` that serves repeated stale reads from a local cache.
+ *
+ * Reads using a single-use, read-only transaction with a staleness bound,
+ * that is, `Transaction::SingleUseOptions(std::chrono::nanoseconds)` or
+ * `Transaction::ReadOnlyOptions(std::chrono::nanoseconds)`, are cached by
+ * table, index, key set, columns, and limit. A later read with the same
+ * parameters is served from the cache, without a `Read` RPC, if the cached
+ * rows were read at a timestamp within its staleness bound. All other
+ * operations, including reads in other transactions, go to @p conn.
+ *
+ * Note that an exact staleness is treated as an upper bound: the cached rows
+ * may be more recent than the requested timestamp, but never older.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * auto conn = spanner::MakeReadCachingConnection(spanner::MakeConnection(db));
+ * spanner::Client client(conn);
+ * auto rows = client.Read(
+ *     spanner::Transaction::SingleUseOptions(std::chrono::seconds(15)),
+ *     "Flags", spanner::KeySet().AddKey(spanner::MakeKey("checkout-v2")),
+ *     {"Enabled"});
+ * @endcode
+ */
+std::shared_ptr<Connection> MakeReadCachingConnection(
+    std::shared_ptr<Connection> conn,
+    ReadCacheOptions options = ReadCacheOptions());
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_READ_CACHE_H
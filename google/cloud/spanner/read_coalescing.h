@@ -0,0 +1,136 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_READ_COALESCING_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_READ_COALESCING_H
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/version.h"
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// Configure the connections created by `MakeReadCoalescingConnection()`.
+class ReadCoalescingOptions {
+ public:
+  ReadCoalescingOptions() = default;
+
+  /**
+   * How long the first read in a batch waits for other reads to join it.
+   *
+   * This delay is added to the latency of every coalesced read. The default is
+   * 500 microseconds.
+   */
+  std::chrono::microseconds window() const { return window_; }
+  ReadCoalescingOptions& set_window(std::chrono::microseconds v) {
+    window_ = v;
+    return *this;
+  }
+
+  /**
+   * The maximum number of distinct keys in a merged read.
+   *
+   * A batch is sent as soon as it reaches this size, without waiting for the
+   * full window. The default is 1,000.
+   */
+  std::size_t max_batch_size() const { return max_batch_size_; }
+  ReadCoalescingOptions& set_max_batch_size(std::size_t v) {
+    max_batch_size_ = v;
+    return *this;
+  }
+
+  /**
+   * Enable coalescing for reads of @p table using @p index.
+   *
+   * The rows returned by a merged read are matched to the waiting callers
+   * using the values of the key columns, @p key_columns must list them in the
+   * same order as the keys used in the reads. Use an empty @p index for reads
+   * using the primary key. Reads of other tables or indexes are not coalesced.
+   */
+  ReadCoalescingOptions& set_key_columns(std::string table, std::string index,
+                                         std::vector<std::string> key_columns) {
+    key_columns_[std::make_pair(std::move(table), std::move(index))] =
+        std::move(key_columns);
+    return *this;
+  }
+
+  /// The key columns for @p table and @p index, `nullptr` if not configured.
+  std::vector<std::string> const* key_columns(std::string const& table,
+                                              std::string const& index) const {
+    auto i = key_columns_.find(std::make_pair(table, index));
+    if (i == key_columns_.end()) return nullptr;
+    return &i->second;
+  }
+
+ private:
+  std::chrono::microseconds window_ = std::chrono::microseconds(500);
+  std::size_t max_batch_size_ = 1000;
+  std::map<std::pair<std::string, std::string>, std::vector<std::string>>
+      key_columns_;
+};
+
+/**
+ * Returns a `Connection` that merges concurrent point reads.
+ *
+ * Applications that issue many concurrent single-key reads of the same table
+ * can use this connection to reduce the number of `Read` RPCs, and the number
+ * of sessions in use. Reads of a single key, using a single-use read-only
+ * transaction, of a table (or index) configured via
+ * `ReadCoalescingOptions::set_key_columns()`, are coalesced. Such reads, with
+ * the same table, index, columns, and timestamp bound, issued within
+ * `ReadCoalescingOptions::window()` of each other are sent as a single `Read`
+ * with all their keys. The returned rows are then delivered to each caller.
+ *
+ * The merged read also requests the key columns, so the rows can be matched
+ * to the callers. These extra columns are removed before the rows are
+ * returned. Keys are matched using their wire representation, all the reads
+ * must use the same types for the key values as the table schema.
+ *
+ * If the merged read fails, all the callers whose row was not yet received
+ * get the same error. All other operations, including `AsyncRead()` and reads
+ * in other transactions, go to @p conn.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * auto conn = spanner::MakeReadCoalescingConnection(
+ *     spanner::MakeConnection(db),
+ *     spanner::ReadCoalescingOptions().set_key_columns("Singers", "",
+ *                                                      {"SingerId"}));
+ * spanner::Client client(conn);
+ * // Concurrent calls like this one are merged:
+ * auto rows = client.Read("Singers", spanner::KeySet().AddKey(
+ *                                        spanner::MakeKey(singer_id)),
+ *                         {"FirstName", "LastName"});
+ * @endcode
+ */
+std::shared_ptr<Connection> MakeReadCoalescingConnection(
+    std::shared_ptr<Connection> conn,
+    ReadCoalescingOptions options = ReadCoalescingOptions());
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_READ_COALESCING_H
@@ -21,6 +21,33 @@
 
 namespace google {
 namespace cloud {
+namespace spanner_internal {
+inline namespace SPANNER_CLIENT_NS {
+
+Status ResultSourceInterface::NextRawRow(RawRow& row) {
+  row.values.clear();
+  auto next = NextRow();
+  if (!next) return std::move(next).status();
+  if (next->size() == 0) return {};  // end-of-stream
+
+  auto row_type = std::make_shared<google::spanner::v1::StructType>();
+  auto const& columns = next->columns();
+  auto values = std::move(*next).values();
+  row.values.reserve(values.size());
+  for (std::size_t i = 0; i != values.size(); ++i) {
+    auto proto = ToProto(std::move(values[i]));
+    auto& field = *row_type->add_fields();
+    field.set_name(columns[i]);
+    *field.mutable_type() = std::move(proto.first);
+    row.values.push_back(std::move(proto.second));
+  }
+  row.row_type = std::move(row_type);
+  return {};
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_internal
+
 namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 namespace {
@@ -21,14 +21,29 @@
 #include "google/cloud/optional.h"
 #include "absl/types/optional.h"
 #include <google/spanner/v1/spanner.pb.h>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace google {
 namespace cloud {
 namespace spanner_internal {
 inline namespace SPANNER_CLIENT_NS {
+/**
+ * The values of a row as received from Cloud Spanner, before they are wrapped
+ * in `spanner::Value` objects.
+ *
+ * The `row_type` is shared by all the rows in a stream, so decoding a row does
+ * not need to copy the type of each column.
+ */
+struct RawRow {
+  std::shared_ptr<google::spanner::v1::StructType const> row_type;
+  std::vector<google::protobuf::Value> values;
+};
+
 class ResultSourceInterface {
  public:
   virtual ~ResultSourceInterface() = default;
@@ -36,6 +51,113 @@ class ResultSourceInterface {
   virtual StatusOr<spanner::Row> NextRow() = 0;
   virtual absl::optional<google::spanner::v1::ResultSetMetadata> Metadata() = 0;
   virtual absl::optional<google::spanner::v1::ResultSetStats> Stats() const = 0;
+
+  // Moves the values of the next row into `row`, reusing its storage. Returns
+  // OK Status with empty `row.values` to indicate end-of-stream. The default
+  // implementation is based on `NextRow()`, sources that receive the protos
+  // directly should override it to avoid creating `spanner::Value` objects.
+  virtual Status NextRawRow(RawRow& row);
+};
+
+// Decodes the C++ values of a `RawRow` into a tuple, see `DecodeRawRow()`.
+struct DecodeRawValue {
+  Status& status;
+  template <typename T>
+  void operator()(T& t, RawRow& row, std::size_t& i) const {
+    if (!status.ok()) return;
+    auto const pos = static_cast<int>(i);
+    auto x = ValueInternals::FromProtoAs<T>(row.row_type->fields(pos).type(),
+                                            std::move(row.values[i]));
+    ++i;
+    if (!x) {
+      status = std::move(x).status();
+    } else {
+      t = *std::move(x);
+    }
+  }
+};
+
+// Appends the C++ values of a `RawRow` to each column, see `AppendRawRow()`.
+struct AppendRawValue {
+  Status& status;
+  template <typename T>
+  void operator()(std::vector<T>& column, RawRow& row, std::size_t& i) const {
+    if (!status.ok()) return;
+    auto const pos = static_cast<int>(i);
+    auto x = ValueInternals::FromProtoAs<T>(row.row_type->fields(pos).type(),
+                                            std::move(row.values[i]));
+    ++i;
+    if (!x) {
+      status = std::move(x).status();
+    } else {
+      column.push_back(*std::move(x));
+    }
+  }
+};
+
+// Discards any values past the first `size` elements of each column.
+struct TruncateColumn {
+  template <typename T>
+  void operator()(std::vector<T>& column, std::size_t size) const {
+    if (column.size() > size) column.resize(size);
+  }
+};
+
+inline Status CheckRawRowSize(RawRow const& row, std::size_t expected) {
+  if (row.values.size() != expected) {
+    auto constexpr kMsg = "Tuple has the wrong number of elements";
+    return Status(StatusCode::kInvalidArgument, kMsg);
+  }
+  if (!row.row_type ||
+      static_cast<std::size_t>(row.row_type->fields_size()) < expected) {
+    return Status(StatusCode::kInternal,
+                  "response metadata is missing row type information");
+  }
+  return {};
+}
+
+/**
+ * Decodes @p row into a `Tuple`, consuming its values.
+ *
+ * This is equivalent to `Row::get<Tuple>()`, but does not require creating a
+ * `spanner::Value` for each column.
+ */
+template <typename Tuple>
+StatusOr<Tuple> DecodeRawRow(RawRow& row) {
+  auto status = CheckRawRowSize(row, std::tuple_size<Tuple>::value);
+  if (!status.ok()) return status;
+  Tuple tup;
+  std::size_t i = 0;
+  ForEach(tup, DecodeRawValue{status}, row, i);
+  if (!status.ok()) return status;
+  return tup;
+}
+
+/**
+ * Decodes @p row and appends each value to the corresponding vector in
+ * @p columns, consuming the values of @p row.
+ *
+ * On failure @p columns is left unchanged.
+ */
+template <typename... Ts>
+Status AppendRawRow(RawRow& row, std::tuple<std::vector<Ts>...>& columns) {
+  static_assert(sizeof...(Ts) > 0, "AppendRawRow() requires some columns");
+  auto status = CheckRawRowSize(row, sizeof...(Ts));
+  if (!status.ok()) return status;
+  auto const size = std::get<0>(columns).size();
+  std::size_t i = 0;
+  ForEach(columns, AppendRawValue{status}, row, i);
+  if (!status.ok()) ForEach(columns, TruncateColumn{}, size);
+  return status;
+}
+
+// Maps `std::tuple<Ts...>` to `std::tuple<std::vector<Ts>...>`.
+template <typename Tuple>
+struct ColumnsOf;
+
+template <typename... Ts>
+struct ColumnsOf<std::tuple<Ts...>> {
+  using type = std::tuple<std::vector<Ts>...>;
 };
 
 }  // namespace SPANNER_CLIENT_NS
@@ -90,6 +212,69 @@ class RowStream {
   // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
   RowStreamIterator end() { return {}; }
 
+  /**
+   * Returns the next row as a `Tuple`, or an empty optional at the end of the
+   * stream.
+   *
+   * Unlike `Row::get<Tuple>()`, this function decodes the values received from
+   * Cloud Spanner directly into the `Tuple` elements, without creating
+   * intermediate `Row` or `Value` objects. Prefer it (or `DecodeStreamOf()`)
+   * for large result sets.
+   *
+   * @tparam Tuple the `std::tuple` type that each row must unpack into.
+   */
+  template <typename Tuple>
+  StatusOr<absl::optional<Tuple>> NextTuple() {
+    auto status = source_->NextRawRow(raw_row_);
+    if (!status.ok()) return status;
+    if (raw_row_.values.empty()) return absl::optional<Tuple>{};
+    auto tup = spanner_internal::DecodeRawRow<Tuple>(raw_row_);
+    if (!tup) return std::move(tup).status();
+    return absl::optional<Tuple>(*std::move(tup));
+  }
+
+  /**
+   * Decodes up to @p max_rows rows, appending the value of each column to the
+   * corresponding vector in @p batch.
+   *
+   * Like `NextTuple()`, this function does not create intermediate `Row` or
+   * `Value` objects. Storing the values by column avoids a `std::tuple` per
+   * row, which is convenient for applications that process the results in
+   * bulk.
+   *
+   * @return the number of rows appended to @p batch, which is less than
+   *     @p max_rows only at the end of the stream. On failure @p batch
+   *     contains the rows decoded before the failing row.
+   *
+   * @par Example
+   * @code
+   * using RowType = std::tuple<std::int64_t, std::string>;
+   * spanner::ColumnBatch<RowType> batch;
+   * for (;;) {
+   *   auto n = rows.NextColumns<RowType>(batch, 1024);
+   *   if (!n) throw std::runtime_error(n.status().message());
+   *   ProcessKeys(std::get<0>(batch));
+   *   if (*n < 1024) break;
+   *   batch = {};
+   * }
+   * @endcode
+   */
+  template <typename Tuple>
+  StatusOr<std::size_t> NextColumns(
+      typename spanner_internal::ColumnsOf<Tuple>::type& batch,
+      std::size_t max_rows) {
+    std::size_t count = 0;
+    while (count < max_rows) {
+      auto status = source_->NextRawRow(raw_row_);
+      if (!status.ok()) return status;
+      if (raw_row_.values.empty()) break;
+      status = spanner_internal::AppendRawRow(raw_row_, batch);
+      if (!status.ok()) return status;
+      ++count;
+    }
+    return count;
+  }
+
   /**
    * Retrieves the timestamp at which the read occurred.
    *
@@ -99,8 +284,147 @@ class RowStream {
 
  private:
   std::unique_ptr<spanner_internal::ResultSourceInterface> source_;
+  spanner_internal::RawRow raw_row_;
+};
+
+/**
+ * Column-major storage for the rows decoded by `RowStream::NextColumns()`.
+ *
+ * For example, `ColumnBatch<std::tuple<std::int64_t, std::string>>` is a
+ * `std::tuple<std::vector<std::int64_t>, std::vector<std::string>>`.
+ */
+template <typename Tuple>
+using ColumnBatch = typename spanner_internal::ColumnsOf<Tuple>::type;
+
+/**
+ * An input iterator over the rows of a `RowStream` decoded as `Tuple`s via
+ * `RowStream::NextTuple()`.
+ *
+ * Default constructing this object creates an instance that represents "end".
+ *
+ * @tparam Tuple the std::tuple<...> to parse each row into.
+ */
+template <typename Tuple>
+class DecodedTupleStreamIterator {
+ public:
+  /// @name Iterator type aliases
+  ///@{
+  using iterator_category = std::input_iterator_tag;
+  using value_type = StatusOr<Tuple>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type*;
+  using reference = value_type&;
+  using const_pointer = value_type const*;
+  using const_reference = value_type const&;
+  ///@}
+
+  /// Default constructs an "end" iterator.
+  DecodedTupleStreamIterator() = default;
+
+  /// Creates an iterator that consumes the rows of @p rows.
+  explicit DecodedTupleStreamIterator(RowStream* rows) : rows_(rows) {
+    Decode();
+  }
+
+  reference operator*() { return tup_; }
+  pointer operator->() { return &tup_; }
+
+  const_reference operator*() const { return tup_; }
+  const_pointer operator->() const { return &tup_; }
+
+  DecodedTupleStreamIterator& operator++() {
+    if (!tup_) {
+      rows_ = nullptr;  // Last row was an error; become "end"
+      return *this;
+    }
+    Decode();
+    return *this;
+  }
+
+  DecodedTupleStreamIterator operator++(int) {
+    auto const old = *this;
+    ++*this;
+    return old;
+  }
+
+  friend bool operator==(DecodedTupleStreamIterator const& a,
+                         DecodedTupleStreamIterator const& b) {
+    // Input iterators may only be compared to (copies of) themselves and end.
+    return !a.rows_ == !b.rows_;
+  }
+
+  friend bool operator!=(DecodedTupleStreamIterator const& a,
+                         DecodedTupleStreamIterator const& b) {
+    return !(a == b);
+  }
+
+ private:
+  void Decode() {
+    if (rows_ == nullptr) return;
+    auto next = rows_->template NextTuple<Tuple>();
+    if (!next) {
+      tup_ = std::move(next).status();
+      return;
+    }
+    if (!next->has_value()) {
+      rows_ = nullptr;  // No more rows to consume; become "end"
+      return;
+    }
+    tup_ = std::move(**next);
+  }
+
+  value_type tup_;
+  RowStream* rows_ = nullptr;
 };
 
+/**
+ * A range of `StatusOr<Tuple>` decoded directly from the values received by a
+ * `RowStream`, see `DecodeStreamOf()`.
+ *
+ * @tparam Tuple the std::tuple<...> to parse each row into.
+ */
+template <typename Tuple>
+class DecodedTupleStream {
+ public:
+  using iterator = DecodedTupleStreamIterator<Tuple>;
+  static_assert(spanner_internal::IsTuple<Tuple>::value,
+                "DecodedTupleStream<T> requires a std::tuple parameter");
+
+  explicit DecodedTupleStream(RowStream& rows) : rows_(&rows) {}
+
+  iterator begin() const { return iterator(rows_); }
+  iterator end() const { return {}; }
+
+ private:
+  RowStream* rows_;
+};
+
+/**
+ * A factory that creates a `DecodedTupleStream<Tuple>` over @p rows.
+ *
+ * The result is used like `StreamOf<Tuple>(rows)`, but each row is decoded
+ * directly from the values received from Cloud Spanner, without creating
+ * intermediate `Row` or `Value` objects. This significantly reduces the CPU
+ * cost of scanning large result sets.
+ *
+ * @par Example
+ * @code
+ * auto rows = client.ExecuteQuery(spanner::SqlStatement("SELECT ..."));
+ * using RowType = std::tuple<std::int64_t, std::string>;
+ * for (auto& row : spanner::DecodeStreamOf<RowType>(rows)) {
+ *   if (!row) throw std::runtime_error(row.status().message());
+ *   std::cout << std::get<0>(*row) << ": " << std::get<1>(*row) << "\n";
+ * }
+ * @endcode
+ *
+ * @note ownership of @p rows is not transferred, so it must outlive the
+ *     returned `DecodedTupleStream`.
+ */
+template <typename Tuple>
+DecodedTupleStream<Tuple> DecodeStreamOf(RowStream& rows) {
+  return DecodedTupleStream<Tuple>(rows);
+}
+
 /**
  * Represents the result of a data modifying operation using
  * `spanner::Client::ExecuteDml()`.
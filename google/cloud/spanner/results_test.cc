@@ -24,6 +24,7 @@
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -37,6 +38,7 @@ using ::google::cloud::spanner_mocks::MockResultSetSource;
 using ::google::cloud::testing_util::IsProtoEqual;
 using ::google::cloud::testing_util::StatusIs;
 using ::google::protobuf::TextFormat;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Return;
 using ::testing::UnorderedPointwise;
@@ -118,6 +120,80 @@ TEST(RowStream, IterateError) {
   EXPECT_EQ(num_rows, 2);
 }
 
+TEST(RowStream, DecodeStreamOf) {
+  auto mock_source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(5, true, "foo")))
+      .WillOnce(Return(MakeTestRow(10, false, "bar")))
+      .WillOnce(Return(Row()));
+
+  RowStream rows(std::move(mock_source));
+  using RowType = std::tuple<std::int64_t, bool, std::string>;
+  std::vector<RowType> actual;
+  for (auto& row : DecodeStreamOf<RowType>(rows)) {
+    ASSERT_STATUS_OK(row);
+    actual.push_back(*std::move(row));
+  }
+  EXPECT_THAT(actual, ElementsAre(RowType(5, true, "foo"),
+                                  RowType(10, false, "bar")));
+}
+
+TEST(RowStream, DecodeStreamOfError) {
+  auto mock_source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(5, true, "foo")))
+      .WillOnce(Return(MakeTestRow(10, "wrong-type", "bar")))
+      .WillOnce(Return(Status(StatusCode::kUnknown, "oops")));
+
+  RowStream rows(std::move(mock_source));
+  using RowType = std::tuple<std::int64_t, bool, std::string>;
+  auto next = rows.NextTuple<RowType>();
+  ASSERT_STATUS_OK(next);
+  ASSERT_TRUE(next->has_value());
+  EXPECT_EQ(RowType(5, true, "foo"), **next);
+  EXPECT_THAT(rows.NextTuple<RowType>(),
+              StatusIs(StatusCode::kUnknown, "wrong type"));
+  EXPECT_THAT(rows.NextTuple<std::tuple<std::int64_t>>(),
+              StatusIs(StatusCode::kUnknown, "oops"));
+}
+
+TEST(RowStream, NextColumns) {
+  auto mock_source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(5, "foo")))
+      .WillOnce(Return(MakeTestRow(10, "bar")))
+      .WillOnce(Return(MakeTestRow(15, "baz")))
+      .WillOnce(Return(Row()));
+
+  RowStream rows(std::move(mock_source));
+  using RowType = std::tuple<std::int64_t, std::string>;
+  ColumnBatch<RowType> batch;
+  auto count = rows.NextColumns<RowType>(batch, 2);
+  ASSERT_STATUS_OK(count);
+  EXPECT_EQ(2U, *count);
+  count = rows.NextColumns<RowType>(batch, 2);
+  ASSERT_STATUS_OK(count);
+  EXPECT_EQ(1U, *count);
+  EXPECT_THAT(std::get<0>(batch), ElementsAre(5, 10, 15));
+  EXPECT_THAT(std::get<1>(batch), ElementsAre("foo", "bar", "baz"));
+}
+
+TEST(RowStream, NextColumnsError) {
+  auto mock_source = absl::make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(5, "foo")))
+      .WillOnce(Return(MakeTestRow(10, 42)));
+
+  RowStream rows(std::move(mock_source));
+  using RowType = std::tuple<std::int64_t, std::string>;
+  ColumnBatch<RowType> batch;
+  auto count = rows.NextColumns<RowType>(batch, 10);
+  EXPECT_THAT(count, StatusIs(StatusCode::kUnknown, "wrong type"));
+  // The columns of the failed row are discarded.
+  EXPECT_THAT(std::get<0>(batch), ElementsAre(5));
+  EXPECT_THAT(std::get<1>(batch), ElementsAre("foo"));
+}
+
 TEST(RowStream, TimestampNoTransaction) {
   auto mock_source = absl::make_unique<MockResultSetSource>();
   spanner_proto::ResultSetMetadata no_transaction;
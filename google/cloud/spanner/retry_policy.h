@@ -17,6 +17,7 @@
 
 #include "google/cloud/spanner/internal/status_utils.h"
 #include "google/cloud/spanner/version.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/internal/retry_policy.h"
 #include "google/cloud/status.h"
 #include "absl/strings/match.h"
@@ -86,6 +87,13 @@ using LimitedErrorCountRetryPolicy =
     google::cloud::internal::LimitedErrorCountRetryPolicy<
         spanner_internal::SafeGrpcRetry>;
 
+/// A retry budget (and optional circuit breaker) shared across many calls.
+using RetryBudget = google::cloud::internal::RetryBudget;
+
+/// A retry policy that also consults a shared `RetryBudget`.
+using BudgetedRetryPolicy = google::cloud::internal::BudgetedRetryPolicy<
+    spanner_internal::SafeGrpcRetry>;
+
 /// The base class for transaction rerun policies.
 using TransactionRerunPolicy = google::cloud::internal::TraitBasedRetryPolicy<
     spanner_internal::SafeTransactionRerun>;
@@ -12,8 +12,33 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "google/cloud/spanner/internal/partial_result_set_source.h"
 #include "google/cloud/spanner/row.h"
+#include "absl/memory/memory.h"
 #include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+std::atomic<std::uint64_t> allocation_count{0};
+// Some compilers "see through" the replacement functions and incorrectly
+// report a mismatched `operator new` / `std::free()` pair, calling through a
+// volatile pointer prevents that analysis.
+void (*volatile free_function)(void*) = std::free;
+}  // namespace
+
+// Count all the allocations in the program, BM_ResultSetNextRow reports the
+// number of allocations per row.
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (auto* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free_function(p); }
+void operator delete(void* p, std::size_t) noexcept { free_function(p); }
 
 namespace google {
 namespace cloud {
@@ -58,6 +83,75 @@ void BM_RowGetByColumnName(benchmark::State& state) {
 }
 BENCHMARK(BM_RowGetByColumnName);
 
+// Returns a single PartialResultSet with all the rows, and then end-of-stream.
+class FakeReader : public spanner_internal::PartialResultSetReader {
+ public:
+  explicit FakeReader(google::spanner::v1::PartialResultSet response)
+      : response_(std::move(response)) {}
+
+  void TryCancel() override {}
+  absl::optional<google::spanner::v1::PartialResultSet> Read() override {
+    if (done_) return {};
+    done_ = true;
+    return std::move(response_);
+  }
+  Status Finish() override { return {}; }
+
+ private:
+  google::spanner::v1::PartialResultSet response_;
+  bool done_ = false;
+};
+
+google::spanner::v1::PartialResultSet MakeResultSet(int rows, int columns) {
+  google::spanner::v1::PartialResultSet response;
+  auto& row_type = *response.mutable_metadata()->mutable_row_type();
+  for (int c = 0; c != columns; ++c) {
+    auto& field = *row_type.add_fields();
+    field.set_name("c" + std::to_string(c));
+    field.mutable_type()->set_code(google::spanner::v1::TypeCode::INT64);
+  }
+  for (int i = 0; i != rows * columns; ++i) {
+    response.add_values()->set_string_value(std::to_string(i));
+  }
+  return response;
+}
+
+// Measures the cost to create each `Row` from the values received in a
+// `PartialResultSet`, and reports the number of allocations per row. The
+// `Type` of each column is shared by all the `Value`s in that column, so
+// reading wide rows does not allocate per cell.
+void BM_ResultSetNextRow(benchmark::State& state) {
+  auto const rows = 1000;
+  auto const columns = static_cast<int>(state.range(0));
+  auto const response = MakeResultSet(rows, columns);
+  std::uint64_t allocations = 0;
+  std::int64_t row_count = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto source = spanner_internal::PartialResultSetSource::Create(
+        absl::make_unique<FakeReader>(response));
+    if (!source) {
+      state.SkipWithError("cannot create PartialResultSetSource");
+      break;
+    }
+    state.ResumeTiming();
+    auto const start = allocation_count.load();
+    for (;;) {
+      auto row = (*source)->NextRow();
+      if (!row || row->size() == 0) break;
+      ++row_count;
+      benchmark::DoNotOptimize(row);
+    }
+    allocations += allocation_count.load() - start;
+  }
+  state.SetItemsProcessed(row_count);
+  state.counters["allocs/row"] =
+      row_count == 0 ? 0.0
+                     : static_cast<double>(allocations) /
+                           static_cast<double>(row_count);
+}
+BENCHMARK(BM_ResultSetNextRow)->Arg(1)->Arg(10)->Arg(100);
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
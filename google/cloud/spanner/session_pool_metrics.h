@@ -0,0 +1,113 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_SESSION_POOL_METRICS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_SESSION_POOL_METRICS_H
+
+#include "google/cloud/spanner/version.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * A snapshot of the state of a session pool.
+ *
+ * The gauges (e.g. `idle_sessions`) describe the pool when the snapshot was
+ * taken. The counters (e.g. `allocations`) are totals since the pool was
+ * created, applications compute rates from consecutive snapshots.
+ *
+ * Use these values to size the `SessionPoolOptions`, for example: waiters, or
+ * a long tail in `allocation_wait_histogram`, suggest a larger
+ * `max_sessions_per_channel`, while many idle sessions suggest a smaller
+ * `min_sessions`.
+ *
+ * @see `SessionPoolOptions::set_metrics_callback()`.
+ */
+struct SessionPoolMetrics {
+  /// The sessions associated with each channel.
+  struct ChannelMetrics {
+    int total_sessions = 0;
+    int idle_sessions = 0;
+    int in_use_sessions = 0;
+  };
+
+  /// The sessions in each channel, in the order the channels were created.
+  std::vector<ChannelMetrics> channels;
+
+  //@{
+  /// @name The sessions in the pool, the sum of the values for all channels.
+  int total_sessions = 0;
+  int idle_sessions = 0;
+  int in_use_sessions = 0;
+  //@}
+
+  /// The number of threads waiting for a session.
+  int waiters = 0;
+
+  /// The number of `BatchCreateSessions` calls in progress.
+  int create_calls_in_progress = 0;
+
+  //@{
+  /**
+   * @name The completed `BatchCreateSessions` calls.
+   *
+   * The latency includes any retries.
+   */
+  std::int64_t create_calls = 0;
+  std::int64_t create_call_failures = 0;
+  std::chrono::nanoseconds create_latency_total{0};
+  std::chrono::nanoseconds create_latency_max{0};
+  //@}
+
+  /// The number of sessions allocated from the pool.
+  std::int64_t allocations = 0;
+
+  /**
+   * The time spent waiting for a session, by the allocations that waited.
+   *
+   * Bucket `i` counts the waits shorter than `10^i` milliseconds, and longer
+   * than the bound of bucket `i - 1`. The last bucket counts the waits longer
+   * than 10 seconds.
+   */
+  std::array<std::int64_t, 6> allocation_wait_histogram{};
+
+  /// The number of idle sessions refreshed to keep them alive.
+  std::int64_t keep_alive_refreshes = 0;
+
+  /// The number of idle sessions deleted to shrink the pool.
+  std::int64_t sessions_deleted = 0;
+};
+
+/**
+ * Receives periodic `SessionPoolMetrics` snapshots.
+ *
+ * @see `SessionPoolOptions::set_metrics_callback()`.
+ */
+using SessionPoolMetricsCallback =
+    std::function<void(SessionPoolMetrics const&)>;
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_SESSION_POOL_METRICS_H
@@ -15,11 +15,13 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_SESSION_POOL_OPTIONS_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_SESSION_POOL_OPTIONS_H
 
+#include "google/cloud/spanner/session_pool_metrics.h"
 #include "google/cloud/spanner/version.h"
 #include <algorithm>
 #include <chrono>
 #include <map>
 #include <string>
+#include <utility>
 
 namespace google {
 namespace cloud {
@@ -61,6 +63,8 @@ class SessionPoolOptions {
     min_sessions_ =
         (std::min)(min_sessions_, max_sessions_per_channel_ * num_channels);
     max_idle_sessions_ = (std::max)(max_idle_sessions_, 0);
+    min_idle_sessions_ = (std::max)(min_idle_sessions_, 0);
+    idle_session_shards_ = (std::max)(idle_session_shards_, 1);
     return *this;
   }
 
@@ -78,6 +82,24 @@ class SessionPoolOptions {
   /// Return the minimum number of sessions to keep in the pool.
   int min_sessions() const { return min_sessions_; }
 
+  /**
+   * Set whether creating the `Client` waits until the `min_sessions` are
+   * created.
+   *
+   * By default the pool creates the initial sessions before the `Client`
+   * (or more precisely, the `Connection`) constructor returns. If set to
+   * `false` the sessions are created in the background, and requests issued
+   * before they are ready wait for them instead of creating more sessions.
+   * In both cases the sessions on different channels are created in parallel.
+   */
+  SessionPoolOptions& set_wait_for_min_sessions(bool wait) {
+    wait_for_min_sessions_ = wait;
+    return *this;
+  }
+
+  /// Return whether creating the pool waits for the `min_sessions`.
+  bool wait_for_min_sessions() const { return wait_for_min_sessions_; }
+
   /**
    * Set the maximum number of sessions to create on each channel.
    * Values <= 1 are treated as 1.
@@ -102,6 +124,70 @@ class SessionPoolOptions {
   /// Return the maximum number of idle sessions to keep in the pool.
   int max_idle_sessions() const { return max_idle_sessions_; }
 
+  /**
+   * Set the low watermark for idle sessions in the pool.
+   * Values <= 0 are treated as 0, which disables this feature.
+   *
+   * Creating a session takes a round trip to Cloud Spanner. By default, the
+   * pool creates sessions only when a request finds no idle session, and that
+   * request waits for them. When the number of idle sessions falls below this
+   * value, the pool creates more sessions in the background, so bursts of
+   * requests do not pay for the session creation. The pool still never grows
+   * above `max_sessions_per_channel` times the number of channels.
+   */
+  SessionPoolOptions& set_min_idle_sessions(int count) {
+    min_idle_sessions_ = count;
+    return *this;
+  }
+
+  /// Return the low watermark for idle sessions in the pool.
+  int min_idle_sessions() const { return min_idle_sessions_; }
+
+  /**
+   * Set whether the pool resizes itself to follow demand.
+   *
+   * By default the pool only grows when a request finds no idle session, and
+   * never shrinks. With autoscaling enabled, the pool's background task (which
+   * runs every few seconds) also:
+   *
+   * - grows the pool by a quarter of its size, in the background, whenever
+   *   requests waited for a session since the last run, so the next burst of
+   *   requests finds idle sessions.
+   * - after about a minute without such waits, deletes up to a tenth of the
+   *   sessions that stayed idle during that time, on each run, until demand
+   *   rises again.
+   *
+   * The pool stays within `min_sessions` and `max_sessions_per_channel` times
+   * the number of channels, and keeps at least `min_idle_sessions` idle.
+   */
+  SessionPoolOptions& set_autoscaling(bool enabled) {
+    autoscaling_ = enabled;
+    return *this;
+  }
+
+  /// Return whether the pool resizes itself to follow demand.
+  bool autoscaling() const { return autoscaling_; }
+
+  /**
+   * Set the number of lists used to hold idle sessions.
+   * Values <= 1 are treated as 1.
+   *
+   * With the default (a single list) every allocation and release of a
+   * session serializes on one lock. Applications running many threads (or
+   * many thousands of transactions per second) on a single `Client` can use
+   * more lists to reduce that contention. Each thread releases sessions to,
+   * and allocates sessions from, its own list first, and takes sessions from
+   * the other lists only when its own list is empty. Using a few more lists
+   * than the number of CPUs works well.
+   */
+  SessionPoolOptions& set_idle_session_shards(int count) {
+    idle_session_shards_ = count;
+    return *this;
+  }
+
+  /// Return the number of lists used to hold idle sessions.
+  int idle_session_shards() const { return idle_session_shards_; }
+
   /// Set whether to block or fail on pool exhaustion.
   SessionPoolOptions& set_action_on_exhaustion(ActionOnExhaustion action) {
     action_on_exhaustion_ = action;
@@ -121,6 +207,9 @@ class SessionPoolOptions {
    * collected by the backend GC. The GC collects objects older than 60
    * minutes, so any duration below that (less some slack to allow the calls
    * to be made to refresh the sessions) should suffice.
+   *
+   * Each session is refreshed at a random point in the last quarter of the
+   * interval, so sessions created together are not refreshed together.
    */
   SessionPoolOptions& set_keep_alive_interval(std::chrono::seconds interval) {
     keep_alive_interval_ = interval;
@@ -132,6 +221,24 @@ class SessionPoolOptions {
     return keep_alive_interval_;
   }
 
+  /**
+   * Set the maximum number of concurrent keep-alive requests.
+   *
+   * Sessions are refreshed asynchronously, without removing them from the
+   * pool. Refreshes beyond this limit are queued and sent as earlier ones
+   * complete, so large pools do not send bursts of requests. Values < 1 are
+   * treated as 1.
+   */
+  SessionPoolOptions& set_max_concurrent_keep_alive_refreshes(int count) {
+    max_concurrent_keep_alive_refreshes_ = count;
+    return *this;
+  }
+
+  /// Return the maximum number of concurrent keep-alive requests.
+  int max_concurrent_keep_alive_refreshes() const {
+    return max_concurrent_keep_alive_refreshes_;
+  }
+
   /**
    * Set the labels used when creating sessions within the pool.
    *  * Label keys must match `[a-z]([-a-z0-9]{0,61}[a-z0-9])?`.
@@ -146,13 +253,38 @@ class SessionPoolOptions {
   /// Return the labels used when creating sessions within the pool.
   std::map<std::string, std::string> const& labels() const { return labels_; }
 
+  /**
+   * Set a callback to receive `SessionPoolMetrics` snapshots.
+   *
+   * The pool calls @p callback from its background maintenance task, roughly
+   * every 5 seconds, with a snapshot of its state. Use this to export the
+   * metrics to a monitoring system. The callback runs on a background thread,
+   * and must not block.
+   */
+  SessionPoolOptions& set_metrics_callback(
+      SessionPoolMetricsCallback callback) {
+    metrics_callback_ = std::move(callback);
+    return *this;
+  }
+
+  /// Return the callback to receive `SessionPoolMetrics` snapshots.
+  SessionPoolMetricsCallback const& metrics_callback() const {
+    return metrics_callback_;
+  }
+
  private:
   int min_sessions_ = 0;
   int max_sessions_per_channel_ = 100;
   int max_idle_sessions_ = 0;
+  int min_idle_sessions_ = 0;
+  bool autoscaling_ = false;
+  bool wait_for_min_sessions_ = true;
+  int idle_session_shards_ = 1;
   ActionOnExhaustion action_on_exhaustion_ = ActionOnExhaustion::kBlock;
   std::chrono::seconds keep_alive_interval_ = std::chrono::minutes(55);
+  int max_concurrent_keep_alive_refreshes_ = 16;
   std::map<std::string, std::string> labels_;
+  SessionPoolMetricsCallback metrics_callback_;
 };
 
 }  // namespace SPANNER_CLIENT_NS
@@ -42,6 +42,17 @@ TEST(SessionPoolOptionsTest, MaxIdleSessions) {
   EXPECT_EQ(0, options.max_idle_sessions());
 }
 
+TEST(SessionPoolOptionsTest, IdleSessionShards) {
+  SessionPoolOptions options;
+  EXPECT_EQ(1, options.idle_session_shards());
+  options.set_idle_session_shards(0).EnforceConstraints(
+      /*num_channels=*/1);
+  EXPECT_EQ(1, options.idle_session_shards());
+  options.set_idle_session_shards(16).EnforceConstraints(
+      /*num_channels=*/1);
+  EXPECT_EQ(16, options.idle_session_shards());
+}
+
 TEST(SessionPoolOptionsTest, MaxMinSessionsConflict) {
   SessionPoolOptions options;
   options.set_min_sessions(10)
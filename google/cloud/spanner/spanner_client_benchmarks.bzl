@@ -21,4 +21,5 @@ spanner_client_benchmarks = [
     "internal/merge_chunk_benchmark.cc",
     "numeric_benchmark.cc",
     "row_benchmark.cc",
+    "timestamp_benchmark.cc",
 ]
@@ -21,12 +21,14 @@ spanner_client_unit_tests = [
     "bytes_test.cc",
     "client_options_test.cc",
     "client_test.cc",
+    "columnar_export_test.cc",
     "commit_options_test.cc",
     "connection_options_test.cc",
     "create_instance_request_builder_test.cc",
     "database_admin_client_test.cc",
     "database_admin_connection_test.cc",
     "database_test.cc",
+    "dml_batcher_test.cc",
     "instance_admin_client_test.cc",
     "instance_admin_connection_test.cc",
     "instance_test.cc",
@@ -34,22 +36,30 @@ spanner_client_unit_tests = [
     "internal/connection_impl_test.cc",
     "internal/database_admin_logging_test.cc",
     "internal/database_admin_metadata_test.cc",
+    "internal/fault_injection_spanner_stub_test.cc",
     "internal/instance_admin_logging_test.cc",
     "internal/instance_admin_metadata_test.cc",
     "internal/logging_result_set_reader_test.cc",
     "internal/logging_spanner_stub_test.cc",
     "internal/merge_chunk_test.cc",
     "internal/metadata_spanner_stub_test.cc",
+    "internal/partial_result_set_prefetch_test.cc",
     "internal/partial_result_set_resume_test.cc",
     "internal/partial_result_set_source_test.cc",
+    "internal/read_caching_connection_test.cc",
+    "internal/read_coalescing_connection_test.cc",
     "internal/session_pool_test.cc",
     "internal/spanner_stub_test.cc",
+    "internal/statement_stats_connection_test.cc",
     "internal/status_utils_test.cc",
     "internal/transaction_impl_test.cc",
     "internal/tuple_utils_test.cc",
     "keys_test.cc",
+    "mutation_batcher_test.cc",
     "mutations_test.cc",
     "numeric_test.cc",
+    "partition_coordinator_test.cc",
+    "partition_executor_test.cc",
     "partition_options_test.cc",
     "query_options_test.cc",
     "query_partition_test.cc",
@@ -61,6 +71,7 @@ spanner_client_unit_tests = [
     "session_pool_options_test.cc",
     "spanner_version_test.cc",
     "sql_statement_test.cc",
+    "statement_stats_test.cc",
     "testing/cleanup_stale_databases_test.cc",
     "testing/random_database_name_test.cc",
     "timestamp_test.cc",
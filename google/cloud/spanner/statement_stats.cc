@@ -0,0 +1,71 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/statement_stats.h"
+#include "google/cloud/spanner/internal/statement_stats_connection.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+void StatementStatsRecorder::Record(std::string const& sql,
+                                    std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto i = stats_.find(sql);
+  if (i == stats_.end()) {
+    if (stats_.size() >= max_statements_) return;
+    i = stats_.emplace(sql, StatementStats{}).first;
+    i->second.sql = sql;
+  }
+  auto& s = i->second;
+  ++s.count;
+  s.total_latency += latency;
+  s.max_latency = (std::max)(s.max_latency, latency);
+}
+
+std::vector<StatementStats> StatementStatsRecorder::Top(std::size_t n) const {
+  std::vector<StatementStats> result;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    result.reserve(stats_.size());
+    for (auto const& kv : stats_) result.push_back(kv.second);
+  }
+  auto by_total = [](StatementStats const& a, StatementStats const& b) {
+    return a.total_latency > b.total_latency;
+  };
+  n = (std::min)(n, result.size());
+  std::partial_sort(result.begin(), result.begin() + n, result.end(),
+                    by_total);
+  result.resize(n);
+  return result;
+}
+
+void StatementStatsRecorder::Reset() {
+  std::lock_guard<std::mutex> lk(mu_);
+  stats_.clear();
+}
+
+std::shared_ptr<Connection> MakeStatementStatsConnection(
+    std::shared_ptr<Connection> conn,
+    std::shared_ptr<StatementStatsRecorder> recorder) {
+  return std::make_shared<spanner_internal::StatementStatsConnection>(
+      std::move(conn), std::move(recorder));
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,105 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_STATEMENT_STATS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_STATEMENT_STATS_H
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/version.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// The latency statistics for one SQL statement.
+struct StatementStats {
+  /// The SQL text, parameters are not included.
+  std::string sql;
+  /// The number of times the statement was executed.
+  std::int64_t count = 0;
+  /// The total, and maximum, latency of those executions.
+  std::chrono::microseconds total_latency = std::chrono::microseconds(0);
+  std::chrono::microseconds max_latency = std::chrono::microseconds(0);
+};
+
+/**
+ * Accumulates per-statement latency statistics.
+ *
+ * Statements are identified by their SQL text, so all the executions of a
+ * parameterized statement are aggregated, whatever their parameter values.
+ * To bound its memory usage the recorder tracks at most `max_statements`
+ * distinct statements, executions of any other statements are ignored.
+ *
+ * This class is thread-safe.
+ */
+class StatementStatsRecorder {
+ public:
+  explicit StatementStatsRecorder(std::size_t max_statements = 1000)
+      : max_statements_(max_statements) {}
+
+  /// Records one execution of @p sql, which took @p latency.
+  void Record(std::string const& sql, std::chrono::microseconds latency);
+
+  /// Returns the (up to) @p n statements with the highest total latency.
+  std::vector<StatementStats> Top(std::size_t n) const;
+
+  /// Discards all the statistics.
+  void Reset();
+
+ private:
+  std::size_t const max_statements_;
+  mutable std::mutex mu_;
+  std::unordered_map<std::string, StatementStats> stats_;  // GUARDED_BY(mu_)
+};
+
+/**
+ * Returns a `Connection` that records the latency of each SQL statement.
+ *
+ * The latency of `ExecuteQuery()` and `ProfileQuery()` is the time until the
+ * first results are available, as the rest of the stream is consumed at the
+ * application's pace. The latency of DML statements is the time until they
+ * complete. All operations are forwarded to @p conn.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * auto stats = std::make_shared<spanner::StatementStatsRecorder>();
+ * spanner::Client client(spanner::MakeStatementStatsConnection(
+ *     spanner::MakeConnection(db), stats));
+ * // ... run the workload ...
+ * for (auto const& s : stats->Top(10)) {
+ *   std::cout << s.sql << ": " << s.count << " executions, "
+ *             << (s.total_latency / s.count).count() << "us average\n";
+ * }
+ * @endcode
+ */
+std::shared_ptr<Connection> MakeStatementStatsConnection(
+    std::shared_ptr<Connection> conn,
+    std::shared_ptr<StatementStatsRecorder> recorder);
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_STATEMENT_STATS_H
@@ -0,0 +1,67 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/statement_stats.h"
+#include <gmock/gmock.h>
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::std::chrono::milliseconds;
+
+TEST(StatementStatsRecorder, Top) {
+  StatementStatsRecorder recorder;
+  recorder.Record("A", milliseconds(1));
+  recorder.Record("B", milliseconds(5));
+  recorder.Record("C", milliseconds(3));
+  recorder.Record("A", milliseconds(6));
+
+  auto top = recorder.Top(2);
+  ASSERT_EQ(2, top.size());
+  EXPECT_EQ("A", top[0].sql);
+  EXPECT_EQ(2, top[0].count);
+  EXPECT_EQ(milliseconds(7), top[0].total_latency);
+  EXPECT_EQ(milliseconds(6), top[0].max_latency);
+  EXPECT_EQ("B", top[1].sql);
+
+  EXPECT_EQ(3, recorder.Top(10).size());
+  EXPECT_TRUE(recorder.Top(0).empty());
+
+  recorder.Reset();
+  EXPECT_TRUE(recorder.Top(10).empty());
+}
+
+TEST(StatementStatsRecorder, MaxStatements) {
+  StatementStatsRecorder recorder(2);
+  recorder.Record("A", milliseconds(1));
+  recorder.Record("B", milliseconds(1));
+  recorder.Record("C", milliseconds(100));  // ignored
+  recorder.Record("A", milliseconds(1));    // tracked statements still count
+
+  auto top = recorder.Top(10);
+  ASSERT_EQ(2, top.size());
+  EXPECT_EQ("A", top[0].sql);
+  EXPECT_EQ(2, top[0].count);
+  EXPECT_EQ("B", top[1].sql);
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -15,6 +15,7 @@
 #include "google/cloud/spanner/timestamp.h"
 #include "google/cloud/internal/time_utils.h"
 #include "google/cloud/status.h"
+#include <cstdint>
 #include <string>
 
 namespace google {
@@ -73,19 +74,110 @@ namespace spanner_internal {
 inline namespace SPANNER_CLIENT_NS {
 
 namespace {
+
 Status InvalidArgument(std::string message) {
   return Status(StatusCode::kInvalidArgument, std::move(message));
 }
+
+// Days since 1970-01-01 of the given date in the proleptic Gregorian
+// calendar, see http://howardhinnant.github.io/date_algorithms.html
+std::int64_t DaysFromCivil(std::int64_t y, int m, int d) {
+  y -= m <= 2 ? 1 : 0;
+  auto const era = (y >= 0 ? y : y - 399) / 400;
+  auto const yoe = y - era * 400;                          // [0, 399]
+  auto const doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  auto const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;  // [0, 146096]
+  return era * 146097 + doe - 719468;
+}
+
+// The inverse of `DaysFromCivil()`.
+void CivilFromDays(std::int64_t z, std::int64_t& y, int& m, int& d) {
+  z += 719468;
+  auto const era = (z >= 0 ? z : z - 146096) / 146097;
+  auto const doe = z - era * 146097;                         // [0, 146096]
+  auto const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  auto const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);  // [0, 365]
+  auto const mp = (5 * doy + 2) / 153;                       // [0, 11]
+  d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+  m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+  y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+}
+
+bool IsLeapYear(int y) {
+  return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+}
+
+int DaysInMonth(int y, int m) {
+  static int const kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return m == 2 && IsLeapYear(y) ? 29 : kDays[m - 1];
+}
+
+// Parses the `n` decimal digits at `p`, returns -1 if any is not a digit.
+int ParseDigits(char const* p, int n) {
+  int v = 0;
+  for (int i = 0; i != n; ++i) {
+    auto const d = static_cast<unsigned>(p[i] - '0');
+    if (d > 9) return -1;
+    v = v * 10 + static_cast<int>(d);
+  }
+  return v;
+}
+
+char* FormatDigits(char* p, int v, int n) {
+  for (int i = n - 1; i >= 0; --i) {
+    p[i] = static_cast<char>('0' + v % 10);
+    v /= 10;
+  }
+  return p + n;
+}
+
+// Parses timestamps in the format produced by Cloud Spanner (and by
+// `TimestampToRFC3339()`), that is "YYYY-MM-DDTHH:MM:SS[.F{1,9}]Z", without
+// any allocations. Returns false if `s` is in any other format, or if any
+// field is out of range, the caller must then use the general parser.
+bool ParseCanonical(std::string const& s, absl::Time& t) {
+  auto const n = s.size();
+  if (n < 20 || n > 30 || s[n - 1] != 'Z') return false;
+  char const* p = s.data();
+  if (p[4] != '-' || p[7] != '-' || p[10] != 'T' || p[13] != ':' ||
+      p[16] != ':') {
+    return false;
+  }
+  auto const year = ParseDigits(p, 4);
+  auto const month = ParseDigits(p + 5, 2);
+  auto const day = ParseDigits(p + 8, 2);
+  auto const hour = ParseDigits(p + 11, 2);
+  auto const minute = ParseDigits(p + 14, 2);
+  auto const second = ParseDigits(p + 17, 2);
+  if (year < 1 || month < 1 || month > 12 || day < 1 ||
+      day > DaysInMonth(year, month) || hour < 0 || hour > 23 || minute < 0 ||
+      minute > 59 || second < 0 || second > 59) {
+    return false;
+  }
+  int nanos = 0;
+  if (n != 20) {
+    auto const digits = static_cast<int>(n) - 21;
+    if (p[19] != '.' || digits < 1) return false;
+    nanos = ParseDigits(p + 20, digits);
+    if (nanos < 0) return false;
+    for (int i = digits; i != 9; ++i) nanos *= 10;
+  }
+  auto const seconds = DaysFromCivil(year, month, day) * 86400 +
+                       hour * 3600 + minute * 60 + second;
+  t = absl::FromUnixSeconds(seconds) + absl::Nanoseconds(nanos);
+  return true;
+}
+
 }  // namespace
 
 // Timestamp objects are always formatted in UTC, and we always format them
 // with a trailing 'Z'. However, we're a bit more liberal in the UTC offsets we
 // accept, thus the use of '%Ez' in kParseSpec.
-auto constexpr kFormatSpec = "%E4Y-%m-%dT%H:%M:%E*SZ";
 auto constexpr kParseSpec = "%Y-%m-%dT%H:%M:%E*S%Ez";
 
 StatusOr<spanner::Timestamp> TimestampFromRFC3339(std::string const& s) {
   absl::Time t;
+  if (ParseCanonical(s, t)) return spanner::MakeTimestamp(t);
   std::string err;
   if (absl::ParseTime(kParseSpec, s, &t, &err)) {
     return spanner::MakeTimestamp(t);
@@ -93,9 +185,48 @@ StatusOr<spanner::Timestamp> TimestampFromRFC3339(std::string const& s) {
   return InvalidArgument(s + ": " + err);
 }
 
+// Equivalent to `absl::FormatTime("%E4Y-%m-%dT%H:%M:%E*SZ", ...)` for the
+// range of valid timestamps, without its (many) allocations.
 std::string TimestampToRFC3339(spanner::Timestamp ts) {
   auto const t = ts.get<absl::Time>().value();  // Cannot fail.
-  return absl::FormatTime(kFormatSpec, t, absl::UTCTimeZone());
+  auto const seconds = absl::ToUnixSeconds(t);
+  auto nanos = static_cast<int>(
+      (t - absl::FromUnixSeconds(seconds)) / absl::Nanoseconds(1));
+  auto days = seconds / 86400;
+  auto sod = static_cast<int>(seconds % 86400);
+  if (sod < 0) {
+    sod += 86400;
+    --days;
+  }
+  std::int64_t year;
+  int month;
+  int day;
+  CivilFromDays(days, year, month, day);
+
+  char buf[32];
+  char* p = FormatDigits(buf, static_cast<int>(year), 4);
+  *p++ = '-';
+  p = FormatDigits(p, month, 2);
+  *p++ = '-';
+  p = FormatDigits(p, day, 2);
+  *p++ = 'T';
+  p = FormatDigits(p, sod / 3600, 2);
+  *p++ = ':';
+  p = FormatDigits(p, sod / 60 % 60, 2);
+  *p++ = ':';
+  p = FormatDigits(p, sod % 60, 2);
+  if (nanos != 0) {
+    // Like "%E*S", use as few digits as possible.
+    int digits = 9;
+    while (nanos % 10 == 0) {
+      nanos /= 10;
+      --digits;
+    }
+    *p++ = '.';
+    p = FormatDigits(p, nanos, digits);
+  }
+  *p++ = 'Z';
+  return std::string(buf, p);
 }
 
 StatusOr<spanner::Timestamp> TimestampFromProto(
@@ -14,6 +14,7 @@
 
 #include "google/cloud/spanner/timestamp.h"
 #include "google/cloud/testing_util/status_matchers.h"
+#include "absl/time/time.h"
 #include <google/protobuf/timestamp.pb.h>
 #include <gmock/gmock.h>
 #include <cstdint>
@@ -410,6 +411,49 @@ TEST(Timestamp, ToRFC3339Limit) {
                     .value()));
 }
 
+TEST(Timestamp, RFC3339MatchesAbsl) {
+  // The conversions have fast paths for the canonical format, verify they
+  // match the general-purpose functions in Abseil.
+  auto const utc = absl::UTCTimeZone();
+  auto const format = "%E4Y-%m-%dT%H:%M:%E*SZ";
+  std::int64_t const seconds[] = {
+      -62135596800,  // 0001-01-01T00:00:00Z
+      -62104060801,  // 0001-12-31T23:59:59Z
+      -2208988800,   // 1900-01-01T00:00:00Z
+      -1,            // 1969-12-31T23:59:59Z
+      0,             // 1970-01-01T00:00:00Z
+      951782400,     // 2000-02-29T00:00:00Z
+      1561135942,    // 2019-06-21T16:52:22Z
+      4107542400,    // 2100-03-01T00:00:00Z
+      253402300799,  // 9999-12-31T23:59:59Z
+  };
+  std::int32_t const nanos[] = {0, 1, 10, 120000000, 999999999};
+  for (auto s : seconds) {
+    for (auto n : nanos) {
+      auto const t = absl::FromUnixSeconds(s) + absl::Nanoseconds(n);
+      auto const ts = MakeTimestamp(t).value();
+      auto const expected = absl::FormatTime(format, t, utc);
+      EXPECT_EQ(expected, spanner_internal::TimestampToRFC3339(ts));
+      EXPECT_EQ(ts, spanner_internal::TimestampFromRFC3339(expected).value());
+    }
+  }
+
+  // Out of range fields are rejected, whichever path parses them.
+  for (auto const* s : {
+           "2019-02-29T00:00:00Z",
+           "2019-04-31T00:00:00Z",
+           "2019-13-01T00:00:00Z",
+           "2019-00-01T00:00:00Z",
+           "2019-01-00T00:00:00Z",
+           "2019-01-01T24:00:00Z",
+           "2019-01-01T00:60:00Z",
+           "2019-01-01T00:00:00,1Z",
+           "2019-01-01 00:00:00Z",
+       }) {
+    EXPECT_FALSE(spanner_internal::TimestampFromRFC3339(s)) << s;
+  }
+}
+
 TEST(Timestamp, FromProto) {
   auto proto = MakeProtoTimestamp(0, 0);
   EXPECT_EQ("1970-01-01T00:00:00Z",
@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <iomanip>
 #include <ios>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -30,6 +31,14 @@ inline namespace SPANNER_CLIENT_NS {
 
 namespace {
 
+// The shared types are intentionally leaked, values may be destroyed during
+// program shutdown.
+std::shared_ptr<google::spanner::v1::Type const>* NewSharedType(
+    google::spanner::v1::Type t) {
+  return new std::shared_ptr<google::spanner::v1::Type const>(
+      std::make_shared<google::spanner::v1::Type>(std::move(t)));
+}
+
 // Compares two sets of Type and Value protos for equality. This method calls
 // itself recursively to compare subtypes and subvalues.
 bool Equal(google::spanner::v1::Type const& pt1,  // NOLINT(misc-no-recursion)
@@ -186,11 +195,18 @@ std::ostream& StreamHelper(std::ostream& os,  // NOLINT(misc-no-recursion)
 }  // namespace
 
 bool operator==(Value const& a, Value const& b) {
-  return Equal(a.type_, a.value_, b.type_, b.value_);
+  return Equal(a.type(), a.value_, b.type(), b.value_);
 }
 
 std::ostream& operator<<(std::ostream& os, Value const& v) {
-  return StreamHelper(os, v.value_, v.type_, StreamMode::kScalar);
+  return StreamHelper(os, v.value_, v.type(), StreamMode::kScalar);
+}
+
+google::spanner::v1::Type const& Value::type() const {
+  if (type_) return *type_;
+  // Leaked for the same reason as the types in `NewSharedType()`.
+  static auto const* const kUnspecified = new google::spanner::v1::Type;
+  return *kUnspecified;
 }
 
 //
@@ -301,6 +317,74 @@ google::spanner::v1::Type Value::MakeTypeProto(char const*) {
   return MakeTypeProto(std::string{});
 }
 
+//
+// Value::MakeSharedTypeProto
+//
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    bool v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    std::int64_t v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    double v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    std::string const& v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    Bytes const& v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    Numeric const& v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    Timestamp v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    CommitTimestamp v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    absl::CivilDay v) {
+  static auto const* const kType = NewSharedType(MakeTypeProto(v));
+  return *kType;
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    int) {
+  return MakeSharedTypeProto(std::int64_t{});
+}
+
+std::shared_ptr<google::spanner::v1::Type const> Value::MakeSharedTypeProto(
+    char const*) {
+  return MakeSharedTypeProto(std::string{});
+}
+
 //
 // Value::MakeValueProto
 //
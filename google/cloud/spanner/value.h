@@ -29,6 +29,7 @@
 #include <google/protobuf/struct.pb.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <google/spanner/v1/type.pb.h>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <tuple>
@@ -290,26 +291,26 @@ class Value {
    */
   template <typename T>
   StatusOr<T> get() const& {
-    if (!TypeProtoIs(T{}, type_))
+    if (!TypeProtoIs(T{}, type()))
       return Status(StatusCode::kUnknown, "wrong type");
     if (value_.kind_case() == google::protobuf::Value::kNullValue) {
       if (IsOptional<T>::value) return T{};
       return Status(StatusCode::kUnknown, "null value");
     }
-    return GetValue(T{}, value_, type_);
+    return GetValue(T{}, value_, type());
   }
 
   /// @copydoc get()
   template <typename T>
   StatusOr<T> get() && {
-    if (!TypeProtoIs(T{}, type_))
+    if (!TypeProtoIs(T{}, type()))
       return Status(StatusCode::kUnknown, "wrong type");
     if (value_.kind_case() == google::protobuf::Value::kNullValue) {
       if (IsOptional<T>::value) return T{};
       return Status(StatusCode::kUnknown, "null value");
     }
     auto tag = T{};  // Works around an odd msvc issue
-    return GetValue(std::move(tag), std::move(value_), type_);
+    return GetValue(std::move(tag), std::move(value_), type());
   }
 
   /**
@@ -409,6 +410,41 @@ class Value {
   static google::spanner::v1::Type MakeTypeProto(absl::CivilDay);
   static google::spanner::v1::Type MakeTypeProto(int);
   static google::spanner::v1::Type MakeTypeProto(char const*);
+  // Like `MakeTypeProto()`, but the result for scalar types (and optionals of
+  // them) is allocated only once and shared by all the values of that type.
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      bool);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      std::int64_t);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      double);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      std::string const&);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      Bytes const&);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      Numeric const&);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      Timestamp);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      CommitTimestamp);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      absl::CivilDay);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      int);
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      char const*);
+  template <typename T>
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      absl::optional<T> const&) {
+    return MakeSharedTypeProto(T{});
+  }
+  template <typename T>
+  static std::shared_ptr<google::spanner::v1::Type const> MakeSharedTypeProto(
+      T const& t) {
+    return std::make_shared<google::spanner::v1::Type>(MakeTypeProto(t));
+  }
+
   template <typename T>
   static google::spanner::v1::Type MakeTypeProto(absl::optional<T> const&) {
     return MakeTypeProto(T{});
@@ -633,14 +669,22 @@ class Value {
   struct PrivateConstructor {};
   template <typename T>
   Value(PrivateConstructor, T&& t)
-      : type_(MakeTypeProto(t)), value_(MakeValueProto(std::forward<T>(t))) {}
+      : type_(MakeSharedTypeProto(t)),
+        value_(MakeValueProto(std::forward<T>(t))) {}
 
-  Value(google::spanner::v1::Type t, google::protobuf::Value v)
+  Value(std::shared_ptr<google::spanner::v1::Type const> t,
+        google::protobuf::Value v)
       : type_(std::move(t)), value_(std::move(v)) {}
 
+  // Returns the type of this value, which is `TYPE_CODE_UNSPECIFIED` for
+  // default-constructed (and moved-from) values.
+  google::spanner::v1::Type const& type() const;
+
   friend struct spanner_internal::SPANNER_CLIENT_NS::ValueInternals;
 
-  google::spanner::v1::Type type_;
+  // The `Type` is immutable, and shared by all the values of the same scalar
+  // type, and by all the values in the same column of a result set.
+  std::shared_ptr<google::spanner::v1::Type const> type_;
   google::protobuf::Value value_;
 };
 
@@ -665,12 +709,53 @@ inline namespace SPANNER_CLIENT_NS {
 struct ValueInternals {
   static spanner::Value FromProto(google::spanner::v1::Type t,
                                   google::protobuf::Value v) {
+    return spanner::Value(
+        std::make_shared<google::spanner::v1::Type>(std::move(t)),
+        std::move(v));
+  }
+
+  // Creates a `spanner::Value` that shares @p t with other values, such as the
+  // other values in the same column of a result set.
+  static spanner::Value FromProto(
+      std::shared_ptr<google::spanner::v1::Type const> t,
+      google::protobuf::Value v) {
     return spanner::Value(std::move(t), std::move(v));
   }
 
   static std::pair<google::spanner::v1::Type, google::protobuf::Value> ToProto(
       spanner::Value v) {
-    return std::make_pair(std::move(v.type_), std::move(v.value_));
+    return std::make_pair(v.type(), std::move(v.value_));
+  }
+
+  // Access the parts of @p v without copying its `Type`, unlike `ToProto()`.
+  static google::spanner::v1::Type const& TypeOf(spanner::Value const& v) {
+    return v.type();
+  }
+  static google::protobuf::Value& MutableProto(spanner::Value& v) {
+    return v.value_;
+  }
+
+  // Equivalent to `ToProto(spanner::Value(t)).second`, but without creating
+  // the intermediate `spanner::Value`, and therefore without its `Type`.
+  template <typename T>
+  static google::protobuf::Value ToValueProto(T&& t) {
+    return spanner::Value::MakeValueProto(std::forward<T>(t));
+  }
+
+  // Equivalent to `FromProto(t, std::move(v)).get<T>()`, but without creating
+  // the intermediate `spanner::Value`, and therefore without copying `t`.
+  template <typename T>
+  static StatusOr<T> FromProtoAs(google::spanner::v1::Type const& t,
+                                 google::protobuf::Value&& v) {
+    if (!spanner::Value::TypeProtoIs(T{}, t)) {
+      return Status(StatusCode::kUnknown, "wrong type");
+    }
+    if (v.kind_case() == google::protobuf::Value::kNullValue) {
+      if (spanner::Value::IsOptional<T>::value) return T{};
+      return Status(StatusCode::kUnknown, "null value");
+    }
+    auto tag = T{};  // Works around an odd msvc issue
+    return spanner::Value::GetValue(std::move(tag), std::move(v), t);
   }
 };
 
@@ -679,6 +764,12 @@ inline spanner::Value FromProto(google::spanner::v1::Type t,
   return ValueInternals::FromProto(std::move(t), std::move(v));
 }
 
+inline spanner::Value FromProto(
+    std::shared_ptr<google::spanner::v1::Type const> t,
+    google::protobuf::Value v) {
+  return ValueInternals::FromProto(std::move(t), std::move(v));
+}
+
 inline std::pair<google::spanner::v1::Type, google::protobuf::Value> ToProto(
     spanner::Value v) {
   return ValueInternals::ToProto(std::move(v));
@@ -208,6 +208,24 @@ TEST(Value, BasicSemantics) {
   TestBasicSemantics(v);
 }
 
+TEST(Value, DefaultConstructed) {
+  Value v;
+  EXPECT_EQ(v, Value());
+  EXPECT_NE(v, Value(42));
+  EXPECT_FALSE(v.get<std::int64_t>().ok());
+  auto const p = spanner_internal::ToProto(v);
+  EXPECT_EQ(google::spanner::v1::TypeCode::TYPE_CODE_UNSPECIFIED,
+            p.first.code());
+
+  // Values of the same type share their `Type`, changing one does not affect
+  // the others.
+  Value a(42);
+  Value b(42);
+  a = Value("42");
+  EXPECT_EQ(b, Value(42));
+  EXPECT_EQ(a, Value("42"));
+}
+
 TEST(Value, Equality) {
   std::vector<std::pair<Value, Value>> test_cases = {
       {Value(false), Value(true)},
@@ -71,6 +71,11 @@ std::ostream& operator<<(std::ostream& os, StatusCode code) {
   return os << StatusCodeToString(code);
 }
 
+std::string const& Status::EmptyMessage() {
+  static auto const* const kEmpty = new std::string;
+  return *kEmpty;
+}
+
 RuntimeStatusError::RuntimeStatusError(Status status)
     : std::runtime_error(StatusWhat(status)), status_(std::move(status)) {}
 
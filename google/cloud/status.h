@@ -17,6 +17,8 @@
 
 #include "google/cloud/version.h"
 #include <iostream>
+#include <memory>
+#include <string>
 #include <tuple>
 
 namespace google {
@@ -59,22 +61,54 @@ std::ostream& operator<<(std::ostream& os, StatusCode code);
  *
  * This class is modeled after `grpc::Status`, it contains the status code and
  * error message (if applicable) from a JSON request.
+ *
+ * An OK status is a single null pointer, it does not allocate and it is cheap
+ * to create, copy, and destroy. The code and message of an error status are
+ * allocated in the heap.
  */
 class Status {
  public:
   Status() = default;
 
+  /**
+   * Creates a status with the given code and message.
+   *
+   * @note The message is discarded if @p status_code is `StatusCode::kOk`.
+   */
   explicit Status(StatusCode status_code, std::string message)
-      : code_(status_code), message_(std::move(message)) {}
-
-  bool ok() const { return code_ == StatusCode::kOk; }
-
-  StatusCode code() const { return code_; }
-  std::string const& message() const { return message_; }
+      : rep_(status_code == StatusCode::kOk
+                 ? nullptr
+                 : new Rep{status_code, std::move(message)}) {}
+
+  Status(Status const& rhs) : rep_(rhs.rep_ ? new Rep(*rhs.rep_) : nullptr) {}
+  Status& operator=(Status const& rhs) {
+    if (!rhs.rep_) {
+      rep_.reset();
+    } else if (rep_) {
+      *rep_ = *rhs.rep_;
+    } else {
+      rep_.reset(new Rep(*rhs.rep_));
+    }
+    return *this;
+  }
+  Status(Status&&) noexcept = default;
+  Status& operator=(Status&&) noexcept = default;
+
+  bool ok() const { return !rep_; }
+
+  StatusCode code() const { return rep_ ? rep_->code : StatusCode::kOk; }
+  std::string const& message() const {
+    return rep_ ? rep_->message : EmptyMessage();
+  }
 
  private:
-  StatusCode code_{StatusCode::kOk};
-  std::string message_;
+  static std::string const& EmptyMessage();
+
+  struct Rep {
+    StatusCode code;
+    std::string message;
+  };
+  std::unique_ptr<Rep> rep_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, Status const& rhs) {
@@ -132,8 +132,8 @@ class StatusOr final {
 
   // NOLINTNEXTLINE(performance-noexcept-move-constructor)
   StatusOr(StatusOr&& rhs) noexcept(noexcept(T(std::move(*rhs))))
-      : status_(std::move(rhs.status_)) {
-    if (status_.ok()) {
+      : status_(std::move(rhs.status_)), has_value_(rhs.has_value_) {
+    if (has_value_) {
       new (&value_) T(std::move(*rhs));
     }
   }
@@ -149,21 +149,23 @@ class StatusOr final {
         return *this;
       }
       new (&value_) T(std::move(*rhs));
+      has_value_ = true;
       status_ = Status();
       return *this;
     }
     if (!rhs.ok()) {
       value_.~T();
+      has_value_ = false;
       status_ = std::move(rhs.status_);
       return *this;
     }
     **this = *std::move(rhs);
-    status_ = Status();
     return *this;
   }
 
-  StatusOr(StatusOr const& rhs) : status_(rhs.status_) {
-    if (status_.ok()) {
+  StatusOr(StatusOr const& rhs)
+      : status_(rhs.status_), has_value_(rhs.has_value_) {
+    if (has_value_) {
       new (&value_) T(*rhs);
     }
   }
@@ -178,21 +180,22 @@ class StatusOr final {
         return *this;
       }
       new (&value_) T(*rhs);
-      status_ = rhs.status_;
+      has_value_ = true;
+      status_ = Status();
       return *this;
     }
     if (!rhs.ok()) {
       value_.~T();
+      has_value_ = false;
       status_ = rhs.status_;
       return *this;
     }
     **this = *rhs;
-    status_ = rhs.status_;
     return *this;
   }
 
   ~StatusOr() {
-    if (ok()) {
+    if (has_value_) {
       value_.~T();
     }
   }
@@ -213,11 +216,11 @@ class StatusOr final {
     // the destination and/or default initializing it unless really needed.
     if (!ok()) {
       new (&value_) T(std::forward<U>(rhs));
+      has_value_ = true;
       status_ = Status();
       return *this;
     }
     **this = std::forward<U>(rhs);
-    status_ = Status();
     return *this;
   }
 
@@ -232,13 +235,13 @@ class StatusOr final {
    * @throws only if `T`'s move constructor throws.
    */
   // NOLINTNEXTLINE(google-explicit-constructor)
-  StatusOr(T&& rhs) { new (&value_) T(std::move(rhs)); }
+  StatusOr(T&& rhs) : has_value_(true) { new (&value_) T(std::move(rhs)); }
 
   // NOLINTNEXTLINE(google-explicit-constructor)
-  StatusOr(T const& rhs) { new (&value_) T(rhs); }
+  StatusOr(T const& rhs) : has_value_(true) { new (&value_) T(rhs); }
 
-  bool ok() const { return status_.ok(); }
-  explicit operator bool() const { return status_.ok(); }
+  bool ok() const { return has_value_; }
+  explicit operator bool() const { return has_value_; }
 
   //@{
   /**
@@ -311,12 +314,14 @@ class StatusOr final {
    *
    * @return All these member functions return the (properly ref and
    *     const-qualified) status. If the object contains a value then
-   *     `status().ok() == true`.
+   *     `status().ok() == true`. The rvalue overloads return the status by
+   *     value, an error `StatusOr<T>` keeps its status code after the status
+   *     is moved out, so `ok()` and `status().ok()` always agree.
    */
   Status& status() & { return status_; }
   Status const& status() const& { return status_; }
-  Status&& status() && { return std::move(status_); }
-  Status const&& status() const&& { return std::move(status_); }
+  Status status() && { return TakeStatus(); }
+  Status status() const&& { return status_; }
   //@}
 
  private:
@@ -329,11 +334,25 @@ class StatusOr final {
   // When possible, do not copy the status.
   void CheckHasValue() && {
     if (!ok()) {
-      internal::ThrowStatus(std::move(status_));
+      internal::ThrowStatus(TakeStatus());
     }
   }
 
+  // Move the status out, leaving an error with the same code behind. This
+  // avoids copying the message, and a moved-from error is still an error.
+  Status TakeStatus() {
+    if (ok()) return Status();
+    auto const code = status_.code();
+    auto status = std::move(status_);
+    status_ = Status(code, {});
+    return status;
+  }
+
+  // An OK `Status` is a null pointer, so a `StatusOr<T>` is only a pointer and
+  // a flag larger than `T`. The flag is separate from `status_` because a
+  // moved-from `StatusOr<T>` has no value and an OK `status_`.
   Status status_;
+  bool has_value_ = false;
   union {
     T value_;
   };
@@ -468,6 +468,23 @@ TEST(StatusOrObservableTest, MoveValue) {
   EXPECT_EQ("moved-out", other->str());
 }
 
+/// @test Moving the status out leaves an error behind.
+TEST(StatusOrObservableTest, MoveStatus) {
+  StatusOr<Observable> other(Status(StatusCode::kNotFound, "not found"));
+
+  auto status = std::move(other).status();
+  EXPECT_EQ(StatusCode::kNotFound, status.code());
+  EXPECT_EQ("not found", status.message());
+  // NOLINTNEXTLINE(bugprone-use-after-move)
+  EXPECT_FALSE(other.ok());
+  EXPECT_FALSE(other.status().ok());
+  EXPECT_EQ(StatusCode::kNotFound, other.status().code());
+
+  other = Observable("foo");
+  EXPECT_STATUS_OK(other);
+  EXPECT_EQ("foo", other->str());
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -49,6 +49,41 @@ TEST(Status, StatusCodeToString) {
             StatusCodeToString(static_cast<StatusCode>(42)));
 }
 
+TEST(Status, DefaultIsOk) {
+  Status status;
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(StatusCode::kOk, status.code());
+  EXPECT_EQ("", status.message());
+  EXPECT_EQ(Status(StatusCode::kOk, ""), status);
+}
+
+TEST(Status, OkDiscardsMessage) {
+  Status status(StatusCode::kOk, "ignored");
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ("", status.message());
+}
+
+TEST(Status, CopyAndMove) {
+  Status const expected(StatusCode::kNotFound, "not found");
+  Status copy = expected;
+  EXPECT_EQ(expected, copy);
+  EXPECT_EQ(StatusCode::kNotFound, copy.code());
+  EXPECT_EQ("not found", copy.message());
+
+  Status assigned;
+  assigned = copy;
+  EXPECT_EQ(expected, assigned);
+  assigned = Status(StatusCode::kAborted, "aborted");
+  EXPECT_EQ(StatusCode::kAborted, assigned.code());
+  assigned = Status();
+  EXPECT_TRUE(assigned.ok());
+
+  Status moved = std::move(copy);
+  EXPECT_EQ(expected, moved);
+  copy = expected;  // Reuse the moved-from object.
+  EXPECT_EQ(expected, copy);
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -0,0 +1,206 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_ASYNC_CLIENT_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_ASYNC_CLIENT_H
+
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/internal/async_connection.h"
+#include "google/cloud/storage/internal/curl_client.h"
+#include "google/cloud/storage/internal/retry_client.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage_experimental {
+inline namespace STORAGE_CLIENT_NS {
+
+/**
+ * A client for Google Cloud Storage offering asynchronous operations.
+ *
+ * The member functions in this class start the operation and return
+ * immediately, the returned `future<>` is satisfied when the operation
+ * completes. Applications can wait on the future, or attach a callback using
+ * `.then()`. This makes it possible to keep many operations in flight without
+ * creating a separate thread for each one.
+ *
+ * The operations use the same retry, backoff, and idempotency policies as the
+ * `google::cloud::storage::Client` used to create the `AsyncClient`.
+ *
+ * @warning this is an experimental feature, and subject to change without
+ *     notice.
+ *
+ * @par Example
+ * @snippet storage_async_samples.cc async get object metadata
+ */
+class AsyncClient {
+ public:
+  /// The default number of background threads used by `AsyncClient`.
+  static std::size_t constexpr kDefaultBackgroundThreads = 16;
+
+  /**
+   * Create an `AsyncClient` using the same configuration as @p client.
+   *
+   * @param client the client to perform the operations with.
+   * @param background_threads the maximum number of operations to run at the
+   *     same time, other operations are queued until an operation completes.
+   */
+  explicit AsyncClient(
+      google::cloud::storage::Client const& client,
+      std::size_t background_threads = kDefaultBackgroundThreads)
+      : connection_(
+            google::cloud::storage::internal::
+                MakeBackgroundThreadsAsyncConnection(client.raw_client(),
+                                                     background_threads)) {}
+
+  /**
+   * Create an `AsyncClient` running all the operations on a single thread.
+   *
+   * The operations are multiplexed over a shared libcurl multi handle, and
+   * (with HTTP/2) over a small number of connections. The number of
+   * operations in flight is not limited by the number of threads.
+   *
+   * @param options the client configuration, including the credentials.
+   * @param policies the client policies, this constructor accepts the same
+   *     retry, backoff, and idempotency policies as
+   *     `google::cloud::storage::Client`.
+   */
+  template <typename... Policies>
+  explicit AsyncClient(google::cloud::storage::ClientOptions options,
+                       Policies&&... policies)
+      : AsyncClient(MakeCurlConnection(
+            google::cloud::storage::internal::CurlClient::Create(
+                std::move(options)),
+            std::forward<Policies>(policies)...)) {}
+
+  /// Create an `AsyncClient` using a custom connection, useful for testing.
+  explicit AsyncClient(
+      std::shared_ptr<google::cloud::storage::internal::AsyncConnection>
+          connection)
+      : connection_(std::move(connection)) {}
+
+  /**
+   * Fetches the object metadata.
+   *
+   * @param bucket_name the bucket containing the object.
+   * @param object_name the object name.
+   * @param options a list of optional query parameters and/or request headers.
+   *     Valid types for this operation include `Generation`,
+   *     `IfGenerationMatch`, `IfGenerationNotMatch`, `IfMetagenerationMatch`,
+   *     `IfMetagenerationNotMatch`, `Projection`, and `UserProject`.
+   *
+   * @par Idempotency
+   * This is a read-only operation and is always idempotent.
+   *
+   * @par Example
+   * @snippet storage_async_samples.cc async get object metadata
+   */
+  template <typename... Options>
+  future<StatusOr<google::cloud::storage::ObjectMetadata>> GetObjectMetadata(
+      std::string const& bucket_name, std::string const& object_name,
+      Options&&... options) {
+    google::cloud::storage::internal::GetObjectMetadataRequest request(
+        bucket_name, object_name);
+    request.set_multiple_options(std::forward<Options>(options)...);
+    return connection_->AsyncGetObjectMetadata(request);
+  }
+
+  /**
+   * Creates an object given its name and contents.
+   *
+   * @param bucket_name the name of the bucket that will contain the object.
+   * @param object_name the name of the object to be created.
+   * @param contents the contents (media) for the new object.
+   * @param options a list of optional query parameters and/or request headers.
+   *     Valid types for this operation include the same options as
+   *     `google::cloud::storage::Client::InsertObject()`.
+   *
+   * @par Idempotency
+   * This operation is only idempotent if restricted by pre-conditions, in this
+   * case, `IfGenerationMatch`.
+   *
+   * @par Example
+   * @snippet storage_async_samples.cc async insert object
+   */
+  template <typename... Options>
+  future<StatusOr<google::cloud::storage::ObjectMetadata>> InsertObject(
+      std::string const& bucket_name, std::string const& object_name,
+      std::string contents, Options&&... options) {
+    google::cloud::storage::internal::InsertObjectMediaRequest request(
+        bucket_name, object_name, std::move(contents));
+    request.set_multiple_options(std::forward<Options>(options)...);
+    return connection_->AsyncInsertObjectMedia(request);
+  }
+
+  /**
+   * Deletes an object.
+   *
+   * @param bucket_name the name of the bucket that contains the object.
+   * @param object_name the name of the object to be deleted.
+   * @param options a list of optional query parameters and/or request headers.
+   *     Valid types for this operation include `Generation`,
+   *     `IfGenerationMatch`, `IfGenerationNotMatch`, `IfMetagenerationMatch`,
+   *     `IfMetagenerationNotMatch`, and `UserProject`.
+   *
+   * @par Idempotency
+   * This operation is only idempotent if:
+   * - restricted by pre-conditions, in this case, `IfGenerationMatch`
+   * - or, if it applies to only one object version via `Generation`.
+   *
+   * @par Example
+   * @snippet storage_async_samples.cc async delete object
+   */
+  template <typename... Options>
+  future<Status> DeleteObject(std::string const& bucket_name,
+                              std::string const& object_name,
+                              Options&&... options) {
+    google::cloud::storage::internal::DeleteObjectRequest request(bucket_name,
+                                                                  object_name);
+    request.set_multiple_options(std::forward<Options>(options)...);
+    return connection_->AsyncDeleteObject(request).then(
+        [](future<StatusOr<google::cloud::storage::internal::EmptyResponse>>
+               f) { return f.get().status(); });
+  }
+
+ private:
+  template <typename... Policies>
+  static std::shared_ptr<google::cloud::storage::internal::AsyncConnection>
+  MakeCurlConnection(
+      std::shared_ptr<google::cloud::storage::internal::CurlClient> client,
+      Policies&&... policies) {
+    // Use a `RetryClient` to apply the policies and their defaults, the
+    // operations do not run through this client.
+    google::cloud::storage::internal::RetryClient retry(
+        client, std::forward<Policies>(policies)...);
+    return google::cloud::storage::internal::MakeCurlAsyncConnection(
+        std::move(client), retry.retry_policy_prototype(),
+        retry.backoff_policy_prototype(), retry.idempotency_policy());
+  }
+
+  std::shared_ptr<google::cloud::storage::internal::AsyncConnection>
+      connection_;
+};
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage_experimental
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_ASYNC_CLIENT_H
@@ -0,0 +1,203 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/async_client.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/oauth2/google_credentials.h"
+#include "google/cloud/storage/retry_policy.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage_experimental {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+namespace gcs = ::google::cloud::storage;
+using ::google::cloud::storage::internal::DeleteObjectRequest;
+using ::google::cloud::storage::internal::EmptyResponse;
+using ::google::cloud::storage::internal::GetObjectMetadataRequest;
+using ::google::cloud::storage::internal::InsertObjectMediaRequest;
+using ::google::cloud::storage::internal::ObjectMetadataParser;
+using ::google::cloud::storage::testing::MockClient;
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::storage::testing::canonical_errors::TransientError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::HasSubstr;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+gcs::ObjectMetadata MockObject(std::string const& name) {
+  return ObjectMetadataParser::FromJson(
+             nlohmann::json{
+                 {"bucket", "test-bucket"}, {"name", name}, {"generation", 42}})
+      .value();
+}
+
+class AsyncClientTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<MockClient>();
+    EXPECT_CALL(*mock_, client_options())
+        .WillRepeatedly(ReturnRef(client_options_));
+    client_.reset(new gcs::Client{
+        std::shared_ptr<gcs::internal::RawClient>(mock_),
+        gcs::LimitedErrorCountRetryPolicy(2),
+        gcs::ExponentialBackoffPolicy(std::chrono::milliseconds(1),
+                                      std::chrono::milliseconds(1), 2.0)});
+  }
+  void TearDown() override {
+    client_.reset();
+    mock_.reset();
+  }
+
+  std::shared_ptr<MockClient> mock_;
+  std::unique_ptr<gcs::Client> client_;
+  gcs::ClientOptions client_options_ =
+      gcs::ClientOptions(gcs::oauth2::CreateAnonymousCredentials());
+};
+
+TEST_F(AsyncClientTest, GetObjectMetadata) {
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<gcs::ObjectMetadata>(TransientError())))
+      .WillOnce([](GetObjectMetadataRequest const& r) {
+        EXPECT_EQ("test-bucket", r.bucket_name());
+        EXPECT_EQ("test-object", r.object_name());
+        EXPECT_EQ(42, r.GetOption<gcs::Generation>().value_or(0));
+        return make_status_or(MockObject(r.object_name()));
+      });
+
+  AsyncClient async(*client_, 2);
+  auto metadata =
+      async.GetObjectMetadata("test-bucket", "test-object", gcs::Generation(42))
+          .get();
+  ASSERT_STATUS_OK(metadata);
+  EXPECT_EQ("test-object", metadata->name());
+}
+
+TEST_F(AsyncClientTest, GetObjectMetadataPermanentError) {
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<gcs::ObjectMetadata>(PermanentError())));
+
+  AsyncClient async(*client_, 2);
+  auto metadata = async.GetObjectMetadata("test-bucket", "test-object").get();
+  EXPECT_THAT(metadata, StatusIs(PermanentError().code()));
+}
+
+TEST_F(AsyncClientTest, InsertObject) {
+  EXPECT_CALL(*mock_, InsertObjectMedia(_))
+      .WillOnce([](InsertObjectMediaRequest const& r) {
+        EXPECT_EQ("test-bucket", r.bucket_name());
+        EXPECT_EQ("test-object", r.object_name());
+        EXPECT_EQ("some contents", r.contents());
+        EXPECT_EQ(0, r.GetOption<gcs::IfGenerationMatch>().value_or(-1));
+        return make_status_or(MockObject(r.object_name()));
+      });
+
+  AsyncClient async(*client_, 2);
+  auto metadata = async
+                      .InsertObject("test-bucket", "test-object",
+                                    "some contents", gcs::IfGenerationMatch(0))
+                      .get();
+  ASSERT_STATUS_OK(metadata);
+  EXPECT_EQ("test-object", metadata->name());
+}
+
+TEST_F(AsyncClientTest, DeleteObject) {
+  EXPECT_CALL(*mock_, DeleteObject(_))
+      .WillOnce([](DeleteObjectRequest const& r) {
+        EXPECT_EQ("test-bucket", r.bucket_name());
+        EXPECT_EQ("test-object", r.object_name());
+        return make_status_or(EmptyResponse{});
+      })
+      .WillOnce(Return(StatusOr<EmptyResponse>(PermanentError())));
+
+  AsyncClient async(*client_, 2);
+  EXPECT_STATUS_OK(async.DeleteObject("test-bucket", "test-object").get());
+  EXPECT_THAT(async.DeleteObject("test-bucket", "test-object").get(),
+              StatusIs(PermanentError().code()));
+}
+
+TEST_F(AsyncClientTest, ManyPending) {
+  auto constexpr kCount = 100;
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .Times(kCount)
+      .WillRepeatedly([](GetObjectMetadataRequest const& r) {
+        return make_status_or(MockObject(r.object_name()));
+      });
+
+  AsyncClient async(*client_, 4);
+  std::vector<future<StatusOr<gcs::ObjectMetadata>>> pending;
+  for (int i = 0; i != kCount; ++i) {
+    pending.push_back(
+        async.GetObjectMetadata("test-bucket", "object-" + std::to_string(i)));
+  }
+  for (int i = 0; i != kCount; ++i) {
+    auto metadata = pending[i].get();
+    ASSERT_STATUS_OK(metadata);
+    EXPECT_EQ("object-" + std::to_string(i), metadata->name());
+  }
+}
+
+TEST_F(AsyncClientTest, PendingOperationsCompleteOnDestruction) {
+  EXPECT_CALL(*mock_, DeleteObject(_))
+      .Times(10)
+      .WillRepeatedly(Return(make_status_or(EmptyResponse{})));
+
+  std::vector<future<Status>> pending;
+  {
+    AsyncClient async(*client_, 1);
+    for (int i = 0; i != 10; ++i) {
+      pending.push_back(
+          async.DeleteObject("test-bucket", "object-" + std::to_string(i)));
+    }
+  }
+  for (auto& f : pending) EXPECT_STATUS_OK(f.get());
+}
+
+/// @test Verify the curl-based connection retries transient failures.
+TEST(AsyncClientCurlTest, RetryPolicyExhausted) {
+  // Use an invalid port to force a libcurl failure.
+  auto options = gcs::ClientOptions(gcs::oauth2::CreateAnonymousCredentials())
+                     .set_endpoint("http://localhost:1");
+  AsyncClient async(std::move(options), gcs::LimitedErrorCountRetryPolicy(2),
+                    gcs::ExponentialBackoffPolicy(std::chrono::milliseconds(1),
+                                                  std::chrono::milliseconds(1),
+                                                  2.0));
+  auto actual = async.GetObjectMetadata("test-bucket", "test-object").get();
+  EXPECT_THAT(actual, StatusIs(StatusCode::kUnavailable,
+                               HasSubstr("Retry policy exhausted")));
+}
+
+/// @test Verify the curl-based connection does not retry non-idempotent calls.
+TEST(AsyncClientCurlTest, NonIdempotent) {
+  auto options = gcs::ClientOptions(gcs::oauth2::CreateAnonymousCredentials())
+                     .set_endpoint("http://localhost:1");
+  AsyncClient async(std::move(options), gcs::StrictIdempotencyPolicy());
+  auto actual = async.DeleteObject("test-bucket", "test-object").get();
+  EXPECT_THAT(actual, StatusIs(StatusCode::kUnavailable,
+                               HasSubstr("non-idempotent")));
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage_experimental
+}  // namespace cloud
+}  // namespace google
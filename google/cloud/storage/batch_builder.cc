@@ -0,0 +1,127 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/batch_builder.h"
+#include <algorithm>
+#include <iterator>
+
+namespace google {
+namespace cloud {
+namespace storage_experimental {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+namespace gcs = ::google::cloud::storage;
+using ::google::cloud::storage::internal::BatchRequest;
+using ::google::cloud::storage::internal::BatchResponse;
+using ::google::cloud::storage::internal::DeleteObjectRequest;
+using ::google::cloud::storage::internal::EmptyResponse;
+using ::google::cloud::storage::internal::PatchObjectRequest;
+using ::google::cloud::storage::internal::RawClient;
+using ::google::cloud::storage::internal::UpdateObjectAclRequest;
+
+/// Performs a single operation, used when batch requests are not supported.
+struct RunOperation {
+  gcs::internal::BatchOperationResult operator()(
+      DeleteObjectRequest const& r) const {
+    return client.DeleteObject(r);
+  }
+  gcs::internal::BatchOperationResult operator()(
+      PatchObjectRequest const& r) const {
+    return client.PatchObject(r);
+  }
+  gcs::internal::BatchOperationResult operator()(
+      UpdateObjectAclRequest const& r) const {
+    return client.UpdateObjectAcl(r);
+  }
+
+  RawClient& client;
+};
+
+/// Creates an error result for each operation type.
+struct MakeError {
+  gcs::internal::BatchOperationResult operator()(
+      DeleteObjectRequest const&) const {
+    return StatusOr<EmptyResponse>(status);
+  }
+  gcs::internal::BatchOperationResult operator()(
+      PatchObjectRequest const&) const {
+    return StatusOr<gcs::ObjectMetadata>(status);
+  }
+  gcs::internal::BatchOperationResult operator()(
+      UpdateObjectAclRequest const&) const {
+    return StatusOr<gcs::ObjectAccessControl>(status);
+  }
+
+  Status const& status;
+};
+
+/// Converts the internal result types to the public result types.
+struct ToPublicResult {
+  BatchOperationResult operator()(StatusOr<EmptyResponse> const& r) const {
+    return r.status();
+  }
+  template <typename T>
+  BatchOperationResult operator()(StatusOr<T> const& r) const {
+    return r;
+  }
+};
+
+BatchResponse ExecuteOneBatch(RawClient& client, BatchRequest const& batch) {
+  auto response = client.ExecuteBatch(batch);
+  if (response) return *std::move(response);
+  BatchResponse result;
+  result.results.reserve(batch.size());
+  if (response.status().code() == StatusCode::kUnimplemented) {
+    for (auto const& op : batch.operations()) {
+      result.results.push_back(absl::visit(RunOperation{client}, op));
+    }
+    return result;
+  }
+  // The batch request failed as a whole, report the error in each operation.
+  for (auto const& op : batch.operations()) {
+    result.results.push_back(absl::visit(MakeError{response.status()}, op));
+  }
+  return result;
+}
+
+}  // namespace
+
+std::vector<BatchOperationResult> BatchBuilder::Execute() {
+  auto operations = std::move(operations_);
+  operations_.clear();
+
+  auto client = client_.raw_client();
+  std::vector<BatchOperationResult> results;
+  results.reserve(operations.size());
+  auto begin = operations.begin();
+  while (begin != operations.end()) {
+    auto const n = (std::min)(
+        BatchRequest::kMaxOperations,
+        static_cast<std::size_t>(std::distance(begin, operations.end())));
+    auto end = std::next(begin, static_cast<std::ptrdiff_t>(n));
+    BatchRequest batch(std::vector<gcs::internal::BatchOperation>(
+        std::make_move_iterator(begin), std::make_move_iterator(end)));
+    begin = end;
+    for (auto const& r : ExecuteOneBatch(*client, batch).results) {
+      results.push_back(absl::visit(ToPublicResult{}, r));
+    }
+  }
+  return results;
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage_experimental
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,153 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BATCH_BUILDER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BATCH_BUILDER_H
+
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/internal/batch_requests.h"
+#include "google/cloud/storage/object_access_control.h"
+#include "google/cloud/storage/object_metadata.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/variant.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage_experimental {
+inline namespace STORAGE_CLIENT_NS {
+
+/**
+ * The result of each operation in a `BatchBuilder`.
+ *
+ * The result type matches the return type of the corresponding
+ * `google::cloud::storage::Client` member function. That is, `DeleteObject()`
+ * returns a `Status`, `PatchObject()` returns a `StatusOr<ObjectMetadata>`,
+ * and `UpdateObjectAcl()` returns a `StatusOr<ObjectAccessControl>`.
+ */
+using BatchOperationResult =
+    absl::variant<Status, StatusOr<google::cloud::storage::ObjectMetadata>,
+                  StatusOr<google::cloud::storage::ObjectAccessControl>>;
+
+/**
+ * Packs many metadata operations into batch requests.
+ *
+ * Each operation in the Cloud Storage JSON API requires a separate HTTP
+ * request. For workloads with many small metadata operations, e.g., deleting
+ * millions of objects, this is dominated by the request latency. Batch
+ * requests pack up to 100 operations in a single HTTP request.
+ *
+ * Applications add operations to a `BatchBuilder` and then call `Execute()`,
+ * which sends as many batch requests as needed, and returns the result of each
+ * operation, in the order they were added.
+ *
+ * If a batch request fails as a whole it is retried using the client's retry
+ * policies, but only if all the operations in the batch are idempotent.
+ * Failures in individual operations are not retried. If the client does not
+ * support batch requests (e.g. when using gRPC), each operation is performed
+ * individually.
+ *
+ * @see https://cloud.google.com/storage/docs/batch for more information about
+ *     batch requests, including their limitations.
+ *
+ * @warning this is an experimental feature, and subject to change without
+ *     notice.
+ */
+class BatchBuilder {
+ public:
+  explicit BatchBuilder(google::cloud::storage::Client client)
+      : client_(std::move(client)) {}
+
+  /**
+   * Adds an operation to delete an object.
+   *
+   * @param options a list of optional query parameters and/or request headers.
+   *     Valid types for this operation include the same options as
+   *     `google::cloud::storage::Client::DeleteObject()`.
+   */
+  template <typename... Options>
+  BatchBuilder& DeleteObject(std::string const& bucket_name,
+                             std::string const& object_name,
+                             Options&&... options) {
+    google::cloud::storage::internal::DeleteObjectRequest request(bucket_name,
+                                                                  object_name);
+    request.set_multiple_options(std::forward<Options>(options)...);
+    operations_.emplace_back(std::move(request));
+    return *this;
+  }
+
+  /**
+   * Adds an operation to patch the metadata of an object.
+   *
+   * @param options a list of optional query parameters and/or request headers.
+   *     Valid types for this operation include the same options as
+   *     `google::cloud::storage::Client::PatchObject()`.
+   */
+  template <typename... Options>
+  BatchBuilder& PatchObject(
+      std::string bucket_name, std::string object_name,
+      google::cloud::storage::ObjectMetadataPatchBuilder const& builder,
+      Options&&... options) {
+    google::cloud::storage::internal::PatchObjectRequest request(
+        std::move(bucket_name), std::move(object_name), builder);
+    request.set_multiple_options(std::forward<Options>(options)...);
+    operations_.emplace_back(std::move(request));
+    return *this;
+  }
+
+  /**
+   * Adds an operation to update an object ACL entry.
+   *
+   * @param options a list of optional query parameters and/or request headers.
+   *     Valid types for this operation include the same options as
+   *     `google::cloud::storage::Client::UpdateObjectAcl()`.
+   */
+  template <typename... Options>
+  BatchBuilder& UpdateObjectAcl(
+      std::string const& bucket_name, std::string const& object_name,
+      google::cloud::storage::ObjectAccessControl const& acl,
+      Options&&... options) {
+    google::cloud::storage::internal::UpdateObjectAclRequest request(
+        bucket_name, object_name, acl.entity(), acl.role());
+    request.set_multiple_options(std::forward<Options>(options)...);
+    operations_.emplace_back(std::move(request));
+    return *this;
+  }
+
+  /// The number of operations waiting to be executed.
+  std::size_t size() const { return operations_.size(); }
+
+  /**
+   * Executes all the operations added since the last call.
+   *
+   * @return the result of each operation, in the order they were added. If a
+   *     batch request fails as a whole, all its operations report that error.
+   */
+  std::vector<BatchOperationResult> Execute();
+
+ private:
+  google::cloud::storage::Client client_;
+  std::vector<google::cloud::storage::internal::BatchOperation> operations_;
+};
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage_experimental
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BATCH_BUILDER_H
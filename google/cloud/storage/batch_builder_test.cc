@@ -0,0 +1,174 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/batch_builder.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage_experimental {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+namespace gcs = ::google::cloud::storage;
+using ::google::cloud::storage::testing::MockClient;
+using ::google::cloud::storage::testing::MockClientWithBatch;
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+gcs::Client MakeClient(std::shared_ptr<MockClient> const& mock,
+                       gcs::ClientOptions const& options) {
+  EXPECT_CALL(*mock, client_options()).WillRepeatedly(ReturnRef(options));
+  return gcs::Client(
+      mock, gcs::LimitedErrorCountRetryPolicy(2),
+      gcs::ExponentialBackoffPolicy(std::chrono::milliseconds(1),
+                                    std::chrono::milliseconds(1), 2.0));
+}
+
+StatusOr<gcs::internal::BatchResponse> SuccessfulBatch(
+    gcs::internal::BatchRequest const& r) {
+  gcs::internal::BatchResponse response;
+  for (auto const& op : r.operations()) {
+    auto const& d = absl::get<gcs::internal::DeleteObjectRequest>(op);
+    if (d.object_name() == "o-13") {
+      response.results.emplace_back(
+          StatusOr<gcs::internal::EmptyResponse>(PermanentError()));
+      continue;
+    }
+    response.results.emplace_back(
+        make_status_or(gcs::internal::EmptyResponse{}));
+  }
+  return response;
+}
+
+TEST(BatchBuilderTest, SplitsBatches) {
+  auto mock = std::make_shared<MockClientWithBatch>();
+  auto const options =
+      gcs::ClientOptions(gcs::oauth2::CreateAnonymousCredentials());
+  std::vector<std::size_t> sizes;
+  EXPECT_CALL(*mock, ExecuteBatch(_))
+      .Times(3)
+      .WillRepeatedly([&sizes](gcs::internal::BatchRequest const& r) {
+        sizes.push_back(r.size());
+        return SuccessfulBatch(r);
+      });
+  EXPECT_CALL(*mock, DeleteObject(_)).Times(0);
+
+  BatchBuilder builder(MakeClient(mock, options));
+  for (int i = 0; i != 250; ++i) {
+    builder.DeleteObject("test-bucket", "o-" + std::to_string(i),
+                         gcs::IfGenerationMatch(i));
+  }
+  EXPECT_EQ(250, builder.size());
+  auto results = builder.Execute();
+  EXPECT_EQ(0, builder.size());
+  EXPECT_THAT(sizes, ::testing::ElementsAre(100, 100, 50));
+  ASSERT_EQ(250, results.size());
+  for (std::size_t i = 0; i != results.size(); ++i) {
+    auto const& status = absl::get<Status>(results[i]);
+    if (i == 13) {
+      EXPECT_THAT(status, StatusIs(StatusCode::kNotFound));
+    } else {
+      EXPECT_STATUS_OK(status);
+    }
+  }
+}
+
+TEST(BatchBuilderTest, MixedOperations) {
+  auto mock = std::make_shared<MockClientWithBatch>();
+  auto const options =
+      gcs::ClientOptions(gcs::oauth2::CreateAnonymousCredentials());
+  EXPECT_CALL(*mock, ExecuteBatch(_))
+      .WillOnce([](gcs::internal::BatchRequest const& r) {
+        EXPECT_EQ(3, r.size());
+        gcs::internal::BatchResponse response;
+        response.results.emplace_back(
+            make_status_or(gcs::internal::EmptyResponse{}));
+        response.results.emplace_back(make_status_or(
+            gcs::ObjectMetadata{}.set_content_type("text/plain")));
+        response.results.emplace_back(make_status_or(
+            gcs::ObjectAccessControl{}.set_entity("allUsers")));
+        return make_status_or(std::move(response));
+      });
+
+  auto results =
+      BatchBuilder(MakeClient(mock, options))
+          .DeleteObject("test-bucket", "o1")
+          .PatchObject(
+              "test-bucket", "o2",
+              gcs::ObjectMetadataPatchBuilder().SetContentType("text/plain"))
+          .UpdateObjectAcl("test-bucket", "o3",
+                           gcs::ObjectAccessControl{}
+                               .set_entity("allUsers")
+                               .set_role("READER"))
+          .Execute();
+  ASSERT_EQ(3, results.size());
+  EXPECT_STATUS_OK(absl::get<Status>(results[0]));
+  auto const& r1 = absl::get<StatusOr<gcs::ObjectMetadata>>(results[1]);
+  ASSERT_STATUS_OK(r1);
+  EXPECT_EQ("text/plain", r1->content_type());
+  auto const& r2 = absl::get<StatusOr<gcs::ObjectAccessControl>>(results[2]);
+  ASSERT_STATUS_OK(r2);
+  EXPECT_EQ("allUsers", r2->entity());
+}
+
+TEST(BatchBuilderTest, FallbackWhenUnimplemented) {
+  // The base `RawClient::ExecuteBatch()` returns kUnimplemented.
+  auto mock = std::make_shared<MockClient>();
+  auto const options =
+      gcs::ClientOptions(gcs::oauth2::CreateAnonymousCredentials());
+  EXPECT_CALL(*mock, DeleteObject(_))
+      .WillOnce(Return(make_status_or(gcs::internal::EmptyResponse{})))
+      .WillOnce(Return(StatusOr<gcs::internal::EmptyResponse>(
+          Status(StatusCode::kNotFound, "not found"))));
+
+  BatchBuilder builder(MakeClient(mock, options));
+  builder.DeleteObject("test-bucket", "o1").DeleteObject("test-bucket", "o2");
+  auto results = builder.Execute();
+  ASSERT_EQ(2, results.size());
+  EXPECT_STATUS_OK(absl::get<Status>(results[0]));
+  EXPECT_THAT(absl::get<Status>(results[1]), StatusIs(StatusCode::kNotFound));
+}
+
+TEST(BatchBuilderTest, BatchFailure) {
+  auto mock = std::make_shared<MockClientWithBatch>();
+  auto const options =
+      gcs::ClientOptions(gcs::oauth2::CreateAnonymousCredentials());
+  EXPECT_CALL(*mock, ExecuteBatch(_))
+      .WillOnce(
+          Return(StatusOr<gcs::internal::BatchResponse>(PermanentError())));
+
+  BatchBuilder builder(MakeClient(mock, options));
+  builder.DeleteObject("test-bucket", "o1")
+      .PatchObject("test-bucket", "o2", gcs::ObjectMetadataPatchBuilder());
+  auto results = builder.Execute();
+  ASSERT_EQ(2, results.size());
+  EXPECT_THAT(absl::get<Status>(results[0]),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_THAT(absl::get<StatusOr<gcs::ObjectMetadata>>(results[1]),
+              StatusIs(StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage_experimental
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,101 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/benchmarks/perf_counters.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif  // __linux__
+
+namespace google {
+namespace cloud {
+namespace storage_benchmarks {
+
+namespace {
+
+std::int64_t Subtract(std::int64_t a, std::int64_t b) {
+  if (a < 0 || b < 0) return -1;
+  return a - b;
+}
+
+#ifdef __linux__
+int OpenCounter(std::uint64_t config) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // pid == 0 and cpu == -1 count the calling thread on any CPU.
+  return static_cast<int>(
+      ::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+std::int64_t ReadCounter(int fd) {
+  if (fd < 0) return -1;
+  std::uint64_t value;
+  if (::read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+  return static_cast<std::int64_t>(value);
+}
+
+void CloseCounter(int fd) {
+  if (fd >= 0) ::close(fd);
+}
+#else
+int OpenCounter(std::uint64_t) { return -1; }
+std::int64_t ReadCounter(int) { return -1; }
+void CloseCounter(int) {}
+#endif  // __linux__
+
+}  // namespace
+
+HardwareCounters operator-(HardwareCounters const& a,
+                           HardwareCounters const& b) {
+  return HardwareCounters{Subtract(a.cycles, b.cycles),
+                          Subtract(a.instructions, b.instructions),
+                          Subtract(a.cache_misses, b.cache_misses)};
+}
+
+#ifdef __linux__
+PerfCounters::PerfCounters()
+    : cycles_fd_(OpenCounter(PERF_COUNT_HW_CPU_CYCLES)),
+      instructions_fd_(OpenCounter(PERF_COUNT_HW_INSTRUCTIONS)),
+      cache_misses_fd_(OpenCounter(PERF_COUNT_HW_CACHE_MISSES)) {}
+#else
+PerfCounters::PerfCounters()
+    : cycles_fd_(-1), instructions_fd_(-1), cache_misses_fd_(-1) {}
+#endif  // __linux__
+
+PerfCounters::~PerfCounters() {
+  CloseCounter(cycles_fd_);
+  CloseCounter(instructions_fd_);
+  CloseCounter(cache_misses_fd_);
+}
+
+bool PerfCounters::available() const {
+  return cycles_fd_ >= 0 || instructions_fd_ >= 0 || cache_misses_fd_ >= 0;
+}
+
+HardwareCounters PerfCounters::Read() const {
+  return HardwareCounters{ReadCounter(cycles_fd_),
+                          ReadCounter(instructions_fd_),
+                          ReadCounter(cache_misses_fd_)};
+}
+
+}  // namespace storage_benchmarks
+}  // namespace cloud
+}  // namespace google
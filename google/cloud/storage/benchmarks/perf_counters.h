@@ -0,0 +1,68 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BENCHMARKS_PERF_COUNTERS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BENCHMARKS_PERF_COUNTERS_H
+
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+namespace storage_benchmarks {
+
+/// The values of the hardware counters, or -1 if they are not available.
+struct HardwareCounters {
+  std::int64_t cycles;
+  std::int64_t instructions;
+  std::int64_t cache_misses;
+};
+
+/// Returns `a - b`, preserving the -1 values for unavailable counters.
+HardwareCounters operator-(HardwareCounters const& a,
+                           HardwareCounters const& b);
+
+/**
+ * Hardware performance counters for the calling thread.
+ *
+ * The counters are read using `perf_event_open(2)`, and only count user-space
+ * events in the thread that created this object. The counters are not
+ * available on platforms other than Linux, or if the kernel does not allow
+ * them (see `/proc/sys/kernel/perf_event_paranoid`), in that case all the
+ * values are -1.
+ */
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(PerfCounters const&) = delete;
+  PerfCounters& operator=(PerfCounters const&) = delete;
+
+  /// Returns true if at least one counter is available.
+  bool available() const;
+
+  /// The current value of the counters.
+  HardwareCounters Read() const;
+
+ private:
+  int cycles_fd_;
+  int instructions_fd_;
+  int cache_misses_fd_;
+};
+
+}  // namespace storage_benchmarks
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BENCHMARKS_PERF_COUNTERS_H
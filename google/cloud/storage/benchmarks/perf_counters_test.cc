@@ -0,0 +1,53 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/benchmarks/perf_counters.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage_benchmarks {
+namespace {
+
+TEST(PerfCounters, Subtract) {
+  auto const diff =
+      HardwareCounters{100, 200, -1} - HardwareCounters{40, 50, 3};
+  EXPECT_EQ(60, diff.cycles);
+  EXPECT_EQ(150, diff.instructions);
+  EXPECT_EQ(-1, diff.cache_misses);
+}
+
+TEST(PerfCounters, Read) {
+  PerfCounters counters;
+  auto const start = counters.Read();
+  std::int64_t sum = 0;
+  for (int i = 0; i != 1000000; ++i) sum += i % 7;
+  EXPECT_LT(0, sum);
+  auto const diff = counters.Read() - start;
+  if (!counters.available()) {
+    EXPECT_EQ(-1, diff.cycles);
+    EXPECT_EQ(-1, diff.instructions);
+    EXPECT_EQ(-1, diff.cache_misses);
+    return;
+  }
+  // Some counters may be unavailable even if others work, for example, in
+  // virtual machines.
+  EXPECT_NE(0, diff.cycles);
+  EXPECT_NE(0, diff.instructions);
+}
+
+}  // namespace
+}  // namespace storage_benchmarks
+}  // namespace cloud
+}  // namespace google
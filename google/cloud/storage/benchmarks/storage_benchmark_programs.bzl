@@ -19,7 +19,10 @@
 storage_benchmark_programs = [
     "throughput_experiment_test.cc",
     "storage_file_transfer_benchmark.cc",
+    "storage_list_objects_parser_benchmark.cc",
     "storage_parallel_uploads_benchmark.cc",
+    "storage_request_setup_benchmark.cc",
     "storage_shard_throughput_benchmark.cc",
+    "storage_small_objects_benchmark.cc",
     "storage_throughput_vs_cpu_benchmark.cc",
 ]
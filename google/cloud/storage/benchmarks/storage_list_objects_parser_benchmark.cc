@@ -0,0 +1,261 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/benchmarks/benchmark_utils.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/internal/object_metadata_sax_parser.h"
+#include "google/cloud/internal/build_info.h"
+#include "google/cloud/internal/getenv.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+namespace {
+std::atomic<std::uint64_t> allocation_count{0};
+// Some compilers "see through" the replacement functions and incorrectly
+// report a mismatched `operator new` / `std::free()` pair, calling through a
+// volatile pointer prevents that analysis.
+void (*volatile free_function)(void*) = std::free;
+}  // namespace
+
+// Count all the allocations in the program, the benchmark reports the number
+// of allocations per parsed response.
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (auto* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free_function(p); }
+void operator delete(void* p, std::size_t) noexcept { free_function(p); }
+
+namespace {
+namespace gcs = google::cloud::storage;
+
+char const kDescription[] = R"""(
+A benchmark for the parsers of `ListObjects` responses.
+
+This program generates a synthetic `ListObjects` response, with the same
+fields returned by the service for `projection=full`, and then parses it
+repeatedly. The program reports the elapsed time and the number of memory
+allocations for each parser: the original parser, which creates a
+`nlohmann::json` DOM for the full response, and the streaming (SAX) parser
+which populates `ObjectMetadata` directly.
+
+The program does not contact the service, it only measures the CPU and memory
+overhead of parsing.
+)""";
+
+struct Options {
+  int object_count = 1000;
+  int iteration_count = 100;
+};
+
+google::cloud::StatusOr<Options> ParseArgs(int argc, char* argv[]);
+
+std::string MakeResponse(int object_count) {
+  auto const bucket = std::string("test-bucket");
+  nlohmann::json items = nlohmann::json::array();
+  for (int i = 0; i != object_count; ++i) {
+    auto const name = "folder/subfolder/object-" + std::to_string(i);
+    auto const generation = std::to_string(1600000000000000 + i);
+    items.push_back(nlohmann::json{
+        {"kind", "storage#object"},
+        {"id", bucket + "/" + name + "/" + generation},
+        {"selfLink", "https://www.googleapis.com/storage/v1/b/" + bucket +
+                         "/o/" + name},
+        {"mediaLink", "https://storage.googleapis.com/download/storage/v1/b/" +
+                          bucket + "/o/" + name + "?generation=" + generation +
+                          "&alt=media"},
+        {"name", name},
+        {"bucket", bucket},
+        {"generation", generation},
+        {"metageneration", "1"},
+        {"contentType", "application/octet-stream"},
+        {"storageClass", "STANDARD"},
+        {"size", std::to_string(1024 * i)},
+        {"md5Hash", "1B2M2Y8AsgTpgAmY7PhCfg=="},
+        {"crc32c", "AAAAAA=="},
+        {"etag", "CJ3Vq5/Q5u4CEAE="},
+        {"timeCreated", "2021-01-29T17:31:14.145Z"},
+        {"updated", "2021-01-29T17:31:14.145Z"},
+        {"timeStorageClassUpdated", "2021-01-29T17:31:14.145Z"},
+        {"metadata", {{"key", "value-" + std::to_string(i)}}},
+        {"owner", {{"entity", "project-owners-123456789"}}},
+    });
+  }
+  return nlohmann::json{{"kind", "storage#objects"},
+                        {"nextPageToken", "some-page-token"},
+                        {"items", std::move(items)}}
+      .dump();
+}
+
+// The original implementation of `ListObjectsResponse::FromHttpResponse()`.
+google::cloud::StatusOr<gcs::internal::ListObjectsResponse> ParseWithDom(
+    std::string const& payload) {
+  auto json = nlohmann::json::parse(payload, nullptr, false);
+  if (!json.is_object()) {
+    return google::cloud::Status(google::cloud::StatusCode::kInvalidArgument,
+                                 __func__);
+  }
+  gcs::internal::ListObjectsResponse result;
+  result.next_page_token = json.value("nextPageToken", "");
+  for (auto const& kv : json["items"].items()) {
+    auto parsed = gcs::internal::ObjectMetadataParser::FromJson(kv.value());
+    if (!parsed) return std::move(parsed).status();
+    result.items.push_back(*std::move(parsed));
+  }
+  for (auto const& kv : json["prefixes"].items()) {
+    result.prefixes.push_back(kv.value().get<std::string>());
+  }
+  return result;
+}
+
+template <typename Parser>
+void RunParser(char const* name, std::string const& payload,
+               Options const& options, Parser parser) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  std::size_t object_count = 0;
+  auto const allocations_start = allocation_count.load();
+  auto const start = std::chrono::steady_clock::now();
+  for (int i = 0; i != options.iteration_count; ++i) {
+    auto response = parser(payload);
+    if (!response) {
+      std::cerr << "Error parsing response with " << name << ": "
+                << response.status() << "\n";
+      std::exit(1);
+    }
+    object_count += response->items.size();
+  }
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  auto const allocations = allocation_count.load() - allocations_start;
+  auto const usecs = duration_cast<microseconds>(elapsed).count();
+  auto const bytes = static_cast<double>(payload.size()) *
+                     static_cast<double>(options.iteration_count);
+  std::cout << name << "," << options.iteration_count << "," << object_count
+            << "," << usecs << ","
+            << (usecs == 0 ? 0.0 : bytes / static_cast<double>(usecs)) << ","
+            << allocations / options.iteration_count << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::cloud::StatusOr<Options> options = ParseArgs(argc, argv);
+  if (!options) {
+    std::cerr << options.status() << "\n";
+    return 1;
+  }
+
+  auto const payload = MakeResponse(options->object_count);
+  std::cout << "# Compiler: " << google::cloud::internal::compiler()
+            << "\n# Build Flags: " << google::cloud::internal::compiler_flags()
+            << "\n# Object Count: " << options->object_count
+            << "\n# Iteration Count: " << options->iteration_count
+            << "\n# Payload Size: " << payload.size() << std::endl;
+
+  std::cout << "Parser,IterationCount,ObjectCount,ElapsedMicroseconds,"
+               "MBs,AllocationsPerResponse\n";
+  RunParser("DOM", payload, *options, ParseWithDom);
+  RunParser("SAX", payload, *options, [](std::string const& p) {
+    return gcs::internal::ParseListObjectsResponse(p);
+  });
+
+  return 0;
+}
+
+namespace {
+
+using ::google::cloud::testing_util::OptionDescriptor;
+
+google::cloud::StatusOr<Options> ParseArgsDefault(
+    std::vector<std::string> argv) {
+  Options options;
+  bool wants_help = false;
+  bool wants_description = false;
+  std::vector<OptionDescriptor> desc{
+      {"--help", "print usage information",
+       [&wants_help](std::string const&) { wants_help = true; }},
+      {"--description", "print benchmark description",
+       [&wants_description](std::string const&) { wants_description = true; }},
+      {"--object-count", "set the number of objects in each response",
+       [&options](std::string const& val) {
+         options.object_count = std::stoi(val);
+       }},
+      {"--iteration-count", "set the number of responses parsed",
+       [&options](std::string const& val) {
+         options.iteration_count = std::stoi(val);
+       }},
+  };
+  auto usage = BuildUsage(desc, argv[0]);
+
+  auto unparsed = OptionsParse(desc, argv);
+  if (wants_help) {
+    std::cout << usage << "\n";
+  }
+
+  if (wants_description) {
+    std::cout << kDescription << "\n";
+  }
+
+  if (unparsed.size() != 1) {
+    std::ostringstream os;
+    os << "Unknown arguments or options\n" << usage << "\n";
+    return google::cloud::Status{google::cloud::StatusCode::kInvalidArgument,
+                                 std::move(os).str()};
+  }
+  if (options.iteration_count <= 0) {
+    std::ostringstream os;
+    os << "Invalid value for --iteration-count\n" << usage << "\n";
+    return google::cloud::Status{google::cloud::StatusCode::kInvalidArgument,
+                                 std::move(os).str()};
+  }
+
+  return options;
+}
+
+google::cloud::StatusOr<Options> SelfTest() {
+  google::cloud::Status const self_test_error(
+      google::cloud::StatusCode::kUnknown, "self-test failure");
+
+  {
+    auto options = ParseArgsDefault({"self-test", "--help", "--description"});
+    if (!options) return options;
+  }
+  {
+    // Positional arguments should be an error
+    auto options = ParseArgsDefault({"self-test", "unused-1"});
+    if (options) return self_test_error;
+  }
+  return ParseArgsDefault({
+      "self-test",
+      "--object-count=10",
+      "--iteration-count=2",
+  });
+}
+
+google::cloud::StatusOr<Options> ParseArgs(int argc, char* argv[]) {
+  bool auto_run =
+      google::cloud::internal::GetEnv("GOOGLE_CLOUD_CPP_AUTO_RUN_EXAMPLES")
+          .value_or("") == "yes";
+  if (auto_run) return SelfTest();
+
+  return ParseArgsDefault({argv, argv + argc});
+}
+
+}  // namespace
@@ -0,0 +1,217 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/benchmarks/benchmark_utils.h"
+#include "google/cloud/storage/client_options.h"
+#include "google/cloud/storage/internal/curl_handle_factory.h"
+#include "google/cloud/storage/internal/curl_request_builder.h"
+#include "google/cloud/storage/oauth2/google_credentials.h"
+#include "google/cloud/internal/build_info.h"
+#include "google/cloud/internal/getenv.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+namespace {
+std::atomic<std::uint64_t> allocation_count{0};
+// Some compilers "see through" the replacement functions and incorrectly
+// report a mismatched `operator new` / `std::free()` pair, calling through a
+// volatile pointer prevents that analysis.
+void (*volatile free_function)(void*) = std::free;
+}  // namespace
+
+// Count all the allocations in the program, the benchmark reports the number
+// of allocations per request.
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (auto* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free_function(p); }
+void operator delete(void* p, std::size_t) noexcept { free_function(p); }
+
+namespace {
+namespace gcs = google::cloud::storage;
+
+char const kDescription[] = R"""(
+A benchmark for the per-request setup cost in the libcurl-based client.
+
+This program repeatedly creates the same request, configured as the client
+configures a typical JSON API request: the client options, the authorization
+header, the `x-goog-api-client` and `Host` headers, and a query parameter. The
+program reports the elapsed time and the number of memory allocations per
+request when the configuration is computed from the `ClientOptions` on each
+request, and when it is copied from a pre-computed request template.
+
+The program does not contact the service, it only measures the CPU and memory
+overhead of creating the requests.
+)""";
+
+struct Options {
+  int iteration_count = 100000;
+};
+
+google::cloud::StatusOr<Options> ParseArgs(int argc, char* argv[]);
+
+auto constexpr kBaseUrl =
+    "https://storage.googleapis.com/storage/v1/b/test-bucket/o/test-object";
+auto constexpr kAuthorizationHeader = "Authorization: Bearer test-only-token";
+auto constexpr kHost = "storage.googleapis.com";
+
+template <typename Setup>
+void RunSetup(char const* name, Options const& options,
+              std::shared_ptr<gcs::internal::CurlHandleFactory> const& factory,
+              Setup setup) {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+
+  auto const allocations_start = allocation_count.load();
+  auto const start = std::chrono::steady_clock::now();
+  for (int i = 0; i != options.iteration_count; ++i) {
+    gcs::internal::CurlRequestBuilder builder(kBaseUrl, factory);
+    setup(builder);
+    builder.AddQueryParameter("alt", "media");
+    auto request = builder.BuildRequest();
+    (void)request;
+  }
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  auto const allocations = allocation_count.load() - allocations_start;
+  auto const nsecs = duration_cast<nanoseconds>(elapsed).count();
+  std::cout << name << "," << options.iteration_count << "," << nsecs << ","
+            << nsecs / options.iteration_count << ","
+            << allocations / options.iteration_count << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::cloud::StatusOr<Options> options = ParseArgs(argc, argv);
+  if (!options) {
+    std::cerr << options.status() << "\n";
+    return 1;
+  }
+
+  auto const client_options =
+      gcs::ClientOptions(gcs::oauth2::CreateAnonymousCredentials());
+  auto const x_goog_api_client_header =
+      std::string("x-goog-api-client: ") + gcs::x_goog_api_client();
+  auto const host = std::string(kHost);
+  auto const request_template = gcs::internal::MakeCurlRequestTemplate(
+      client_options, {x_goog_api_client_header});
+  auto const host_header = "Host: " + host;
+  auto factory = std::make_shared<gcs::internal::PooledCurlHandleFactory>(4);
+
+  std::cout << "# Compiler: " << google::cloud::internal::compiler()
+            << "\n# Build Flags: " << google::cloud::internal::compiler_flags()
+            << "\n# Iteration Count: " << options->iteration_count
+            << std::endl;
+
+  std::cout << "Setup,IterationCount,ElapsedNanoseconds,"
+               "NanosecondsPerRequest,AllocationsPerRequest\n";
+  RunSetup("ClientOptions", *options, factory,
+           [&](gcs::internal::CurlRequestBuilder& builder) {
+             builder.SetMethod("GET")
+                 .ApplyClientOptions(client_options)
+                 .AddHeader(kAuthorizationHeader)
+                 .AddHeader(x_goog_api_client_header)
+                 .AddHeader("Host: " + host);
+           });
+  RunSetup("Template", *options, factory,
+           [&](gcs::internal::CurlRequestBuilder& builder) {
+             builder.SetMethod("GET")
+                 .AddHeader(kAuthorizationHeader)
+                 .ApplyTemplate(request_template)
+                 .AddHeader(host_header);
+           });
+
+  return 0;
+}
+
+namespace {
+
+using ::google::cloud::testing_util::OptionDescriptor;
+
+google::cloud::StatusOr<Options> ParseArgsDefault(
+    std::vector<std::string> argv) {
+  Options options;
+  bool wants_help = false;
+  bool wants_description = false;
+  std::vector<OptionDescriptor> desc{
+      {"--help", "print usage information",
+       [&wants_help](std::string const&) { wants_help = true; }},
+      {"--description", "print benchmark description",
+       [&wants_description](std::string const&) { wants_description = true; }},
+      {"--iteration-count", "set the number of requests created",
+       [&options](std::string const& val) {
+         options.iteration_count = std::stoi(val);
+       }},
+  };
+  auto usage = BuildUsage(desc, argv[0]);
+
+  auto unparsed = OptionsParse(desc, argv);
+  if (wants_help) {
+    std::cout << usage << "\n";
+  }
+
+  if (wants_description) {
+    std::cout << kDescription << "\n";
+  }
+
+  if (unparsed.size() != 1) {
+    std::ostringstream os;
+    os << "Unknown arguments or options\n" << usage << "\n";
+    return google::cloud::Status{google::cloud::StatusCode::kInvalidArgument,
+                                 std::move(os).str()};
+  }
+  if (options.iteration_count <= 0) {
+    std::ostringstream os;
+    os << "Invalid value for --iteration-count\n" << usage << "\n";
+    return google::cloud::Status{google::cloud::StatusCode::kInvalidArgument,
+                                 std::move(os).str()};
+  }
+
+  return options;
+}
+
+google::cloud::StatusOr<Options> SelfTest() {
+  google::cloud::Status const self_test_error(
+      google::cloud::StatusCode::kUnknown, "self-test failure");
+
+  {
+    auto options = ParseArgsDefault({"self-test", "--help", "--description"});
+    if (!options) return options;
+  }
+  {
+    // Positional arguments should be an error
+    auto options = ParseArgsDefault({"self-test", "unused-1"});
+    if (options) return self_test_error;
+  }
+  return ParseArgsDefault({
+      "self-test",
+      "--iteration-count=10",
+  });
+}
+
+google::cloud::StatusOr<Options> ParseArgs(int argc, char* argv[]) {
+  bool auto_run =
+      google::cloud::internal::GetEnv("GOOGLE_CLOUD_CPP_AUTO_RUN_EXAMPLES")
+          .value_or("") == "yes";
+  if (auto_run) return SelfTest();
+
+  return ParseArgsDefault({argv, argv + argc});
+}
+
+}  // namespace
@@ -0,0 +1,359 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/benchmarks/benchmark_utils.h"
+#include "google/cloud/storage/benchmarks/throughput_options.h"
+#include "google/cloud/storage/benchmarks/throughput_result.h"
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/grpc_plugin.h"
+#include "google/cloud/internal/absl_str_join_quiet.h"
+#include "google/cloud/internal/build_info.h"
+#include "google/cloud/internal/format_time_point.h"
+#include "google/cloud/internal/getenv.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/timer.h"
+#include <algorithm>
+#include <future>
+#include <map>
+#include <sstream>
+
+namespace {
+namespace gcs = google::cloud::storage;
+namespace gcs_bm = google::cloud::storage_benchmarks;
+using gcs_bm::ApiName;
+using gcs_bm::ThroughputOptions;
+using gcs_bm::ThroughputResult;
+using ::google::cloud::testing_util::Timer;
+
+char const kDescription[] = R"""(
+A latency and throughput benchmark for small objects.
+
+This program measures the operations per second, and the latency distribution,
+when uploading, downloading, and fetching the metadata of small objects (a few
+KiB each) using the Google Cloud Storage (GCS) C++ client library. With objects
+this small the performance is dominated by the per-request overhead, so the
+program reports p50, p90, p99, and p99.9 latencies instead of bandwidth.
+
+The program first creates a GCS bucket that will contain all the objects used
+by that run of the program. The name of this bucket is selected at random, so
+multiple copies of the program can run simultaneously. The bucket is deleted at
+the end of the run of this program.
+
+The program runs the experiment with 1, 2, 4, ... threads, doubling the number
+of threads until it reaches the value configured via `--thread-count`. For each
+level of concurrency, each thread repeats the following steps:
+
+- Select a random object size, between two values configured in the command
+  line, and a random API (XML, JSON, or gRPC).
+- Upload an object of that size using `InsertObject()`.
+- Fetch the object metadata using `GetObjectMetadata()`. The XML API does not
+  support this operation, the JSON API is used instead.
+- Download the object using `ReadObject()`.
+- Delete the object, this operation is not measured.
+
+The threads stop when they have obtained at least a "minimum number of samples"
+*and* the test has been running for more than the prescribed "duration", or
+when they obtain the "maximum number of samples".
+
+Once all the threads for a concurrency level finish, the program prints, for
+each operation and API, the number of operations per second, the number of
+samples and errors, and the latency percentiles in microseconds.
+)""";
+
+using TestResults = std::vector<ThroughputResult>;
+
+TestResults RunThread(ThroughputOptions const& options,
+                      gcs::ClientOptions const& client_options,
+                      std::string const& bucket_name, int thread_id);
+void PrintSummary(int thread_count, std::chrono::microseconds elapsed,
+                  TestResults const& results);
+
+google::cloud::StatusOr<ThroughputOptions> ParseArgs(int argc, char* argv[]);
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::cloud::StatusOr<ThroughputOptions> options = ParseArgs(argc, argv);
+  if (!options) {
+    std::cerr << options.status() << "\n";
+    return 1;
+  }
+
+  google::cloud::StatusOr<gcs::ClientOptions> client_options =
+      gcs::ClientOptions::CreateDefaultClientOptions();
+  if (!client_options) {
+    std::cerr << "Could not create ClientOptions, status="
+              << client_options.status() << "\n";
+    return 1;
+  }
+  if (!options->project_id.empty()) {
+    client_options->set_project_id(options->project_id);
+  }
+  gcs::Client client(*client_options);
+
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto bucket_name = gcs_bm::MakeRandomBucketName(generator);
+  std::string notes = google::cloud::storage::version_string() + ";" +
+                      google::cloud::internal::compiler() + ";" +
+                      google::cloud::internal::compiler_flags();
+  std::transform(notes.begin(), notes.end(), notes.begin(),
+                 [](char c) { return c == '\n' ? ';' : c; });
+
+  struct Formatter {
+    void operator()(std::string* out, ApiName api) const {
+      out->append(gcs_bm::ToString(api));
+    }
+  };
+
+  std::cout << "# Running test on bucket: " << bucket_name << "\n# Start time: "
+            << google::cloud::internal::FormatRfc3339(
+                   std::chrono::system_clock::now())
+            << "\n# Region: " << options->region
+            << "\n# Duration: " << options->duration.count() << "s"
+            << "\n# Thread Count: " << options->thread_count
+            << "\n# Min Object Size: " << options->minimum_object_size
+            << "\n# Max Object Size: " << options->maximum_object_size
+            << "\n# Min Object Size (KiB): "
+            << options->minimum_object_size / gcs_bm::kKiB
+            << "\n# Max Object Size (KiB): "
+            << options->maximum_object_size / gcs_bm::kKiB
+            << "\n# Minimum Sample Count: " << options->minimum_sample_count
+            << "\n# Maximum Sample Count: " << options->maximum_sample_count
+            << "\n# Enabled APIs: "
+            << absl::StrJoin(options->enabled_apis, ",", Formatter{})
+            << "\n# Build info: " << notes << "\n";
+  // Make the output generated so far immediately visible, helps with debugging.
+  std::cout << std::flush;
+
+  auto meta =
+      client.CreateBucket(bucket_name,
+                          gcs::BucketMetadata()
+                              .set_storage_class(gcs::storage_class::Standard())
+                              .set_location(options->region),
+                          gcs::PredefinedAcl("private"),
+                          gcs::PredefinedDefaultObjectAcl("projectPrivate"),
+                          gcs::Projection("full"));
+  if (!meta) {
+    std::cerr << "Error creating bucket: " << meta.status() << "\n";
+    return 1;
+  }
+
+  std::cout << "ThreadCount,OpsPerSecond,";
+  gcs_bm::PrintLatencySummaryHeader(std::cout);
+  // Run with 1, 2, 4, ... threads, and always include the maximum thread
+  // count, even if it is not a power of 2.
+  std::vector<int> thread_counts;
+  for (int t = 1; t < options->thread_count; t *= 2) thread_counts.push_back(t);
+  thread_counts.push_back(options->thread_count);
+  for (auto const thread_count : thread_counts) {
+    auto const start = std::chrono::steady_clock::now();
+    std::vector<std::future<TestResults>> tasks;
+    for (int i = 0; i != thread_count; ++i) {
+      tasks.emplace_back(std::async(std::launch::async, RunThread, *options,
+                                    *client_options, bucket_name, i));
+    }
+    TestResults results;
+    for (auto& f : tasks) {
+      auto r = f.get();
+      results.insert(results.end(), std::make_move_iterator(r.begin()),
+                     std::make_move_iterator(r.end()));
+    }
+    PrintSummary(thread_count,
+                 std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - start),
+                 results);
+  }
+
+  gcs_bm::DeleteAllObjects(client, bucket_name, options->thread_count);
+  auto status = client.DeleteBucket(bucket_name);
+  if (!status.ok()) {
+    std::cerr << "# Error deleting bucket, status=" << status << "\n";
+    return 1;
+  }
+  std::cout << "# DONE\n" << std::flush;
+
+  return 0;
+}
+
+namespace {
+
+void PrintSummary(int thread_count, std::chrono::microseconds elapsed,
+                  TestResults const& results) {
+  using seconds = std::chrono::duration<double>;
+  auto const elapsed_seconds =
+      (std::max)(std::chrono::duration_cast<seconds>(elapsed).count(), 1e-6);
+  for (auto const& s : gcs_bm::SummarizeLatency(results)) {
+    std::cout << thread_count << ','
+              << static_cast<double>(s.sample_count) / elapsed_seconds << ',';
+    gcs_bm::PrintAsCsv(std::cout, s);
+  }
+  std::cout << std::flush;
+}
+
+ThroughputResult MakeResult(gcs_bm::OpType op, ApiName api,
+                            std::int64_t object_size, Timer& timer,
+                            google::cloud::Status status) {
+  timer.Stop();
+  return ThroughputResult{op,
+                          object_size,
+                          /*app_buffer_size=*/0,
+                          /*lib_buffer_size=*/0,
+                          /*crc_enabled=*/true,
+                          /*md5_enabled=*/false,
+                          api,
+                          timer.elapsed_time(),
+                          timer.cpu_time(),
+                          std::move(status),
+                          /*stage_cpu_time=*/{},
+                          gcs_bm::NoHardwareCounters()};
+}
+
+TestResults RunThread(ThroughputOptions const& options,
+                      gcs::ClientOptions const& client_options,
+                      std::string const& bucket_name, int thread_id) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const random_data = gcs_bm::MakeRandomData(
+      generator, static_cast<std::size_t>(options.maximum_object_size));
+
+  gcs::Client rest_client(client_options);
+  std::map<ApiName, gcs::Client> clients;
+  for (auto api : options.enabled_apis) {
+    switch (api) {
+      case ApiName::kApiJson:
+      case ApiName::kApiXml:
+        clients.emplace(api, rest_client);
+        break;
+#if GOOGLE_CLOUD_CPP_STORAGE_HAVE_GRPC
+      case ApiName::kApiGrpc:
+        clients.emplace(api,
+                        google::cloud::storage_experimental::DefaultGrpcClient(
+                            client_options, thread_id));
+        break;
+#else
+      case ApiName::kApiGrpc:
+        (void)thread_id;
+        break;
+#endif  // GOOGLE_CLOUD_CPP_STORAGE_HAVE_GRPC
+      // This benchmark measures the client library, the raw protocols are
+      // not supported.
+      case ApiName::kApiRawJson:
+      case ApiName::kApiRawXml:
+      case ApiName::kApiRawGrpc:
+        break;
+    }
+  }
+  if (clients.empty()) {
+    std::cout << "# None of the APIs configured are available\n";
+    return {};
+  }
+  std::vector<ApiName> apis;
+  for (auto const& kv : clients) apis.push_back(kv.first);
+
+  std::uniform_int_distribution<std::size_t> api_generator(0, apis.size() - 1);
+  std::uniform_int_distribution<std::int64_t> size_generator(
+      options.minimum_object_size, options.maximum_object_size);
+
+  auto deadline = std::chrono::steady_clock::now() + options.duration;
+
+  Timer timer;
+  TestResults results;
+
+  std::int32_t iteration_count = 0;
+  for (auto start = std::chrono::steady_clock::now();
+       iteration_count < options.maximum_sample_count &&
+       (iteration_count < options.minimum_sample_count || start < deadline);
+       start = std::chrono::steady_clock::now(), ++iteration_count) {
+    auto const object_name = gcs_bm::MakeRandomObjectName(generator);
+    auto const object_size = size_generator(generator);
+    auto const api = apis[api_generator(generator)];
+    auto& client = clients.at(api);
+
+    // The default API for uploads is JSON, we force XML by not using features
+    // that XML does not implement.
+    auto const insert_selector =
+        api == ApiName::kApiXml ? gcs::Fields("") : gcs::Fields();
+    // The default API for downloads is XML, we force JSON by using a feature
+    // not available in XML.
+    auto const read_selector = api == ApiName::kApiJson
+                                   ? gcs::IfGenerationNotMatch(0)
+                                   : gcs::IfGenerationNotMatch();
+
+    timer.Start();
+    auto insert = client.InsertObject(
+        bucket_name, object_name,
+        random_data.substr(0, static_cast<std::size_t>(object_size)),
+        gcs::DisableMD5Hash(true), insert_selector);
+    results.push_back(MakeResult(gcs_bm::kOpInsert, api, object_size, timer,
+                                 insert.status()));
+    if (!insert) continue;
+
+    timer.Start();
+    auto metadata = client.GetObjectMetadata(bucket_name, object_name);
+    results.push_back(MakeResult(gcs_bm::kOpGetMetadata,
+                                 api == ApiName::kApiXml ? ApiName::kApiJson
+                                                         : api,
+                                 object_size, timer, metadata.status()));
+
+    timer.Start();
+    auto reader =
+        client.ReadObject(bucket_name, object_name, gcs::DisableMD5Hash(true),
+                          read_selector);
+    std::string contents{std::istreambuf_iterator<char>{reader}, {}};
+    results.push_back(MakeResult(gcs_bm::kOpRead0, api, object_size, timer,
+                                 reader.status()));
+
+    (void)rest_client.DeleteObject(bucket_name, object_name);
+  }
+  return results;
+}
+
+google::cloud::StatusOr<ThroughputOptions> SelfTest(char const* argv0) {
+  using google::cloud::internal::GetEnv;
+
+  for (auto const& var :
+       {"GOOGLE_CLOUD_PROJECT", "GOOGLE_CLOUD_CPP_STORAGE_TEST_REGION_ID"}) {
+    auto const value = GetEnv(var).value_or("");
+    if (!value.empty()) continue;
+    std::ostringstream os;
+    os << "The environment variable " << var << " is not set or empty";
+    return google::cloud::Status(google::cloud::StatusCode::kUnknown,
+                                 std::move(os).str());
+  }
+  return gcs_bm::ParseThroughputOptions(
+      {
+          argv0,
+          "--project-id=" + GetEnv("GOOGLE_CLOUD_PROJECT").value(),
+          "--region=" +
+              GetEnv("GOOGLE_CLOUD_CPP_STORAGE_TEST_REGION_ID").value(),
+          "--thread-count=2",
+          "--minimum-object-size=4KiB",
+          "--maximum-object-size=64KiB",
+          "--duration=1s",
+          "--minimum-sample-count=4",
+          "--maximum-sample-count=10",
+          "--enabled-apis=JSON,XML",
+      },
+      kDescription);
+}
+
+google::cloud::StatusOr<ThroughputOptions> ParseArgs(int argc, char* argv[]) {
+  bool auto_run =
+      google::cloud::internal::GetEnv("GOOGLE_CLOUD_CPP_AUTO_RUN_EXAMPLES")
+          .value_or("") == "yes";
+  if (auto_run) return SelfTest(argv[0]);
+
+  return gcs_bm::ParseThroughputOptions({argv, argv + argc}, kDescription);
+}
+
+}  // namespace
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/storage/benchmarks/benchmark_utils.h"
+#include "google/cloud/storage/benchmarks/perf_counters.h"
 #include "google/cloud/storage/benchmarks/throughput_experiment.h"
 #include "google/cloud/storage/benchmarks/throughput_options.h"
 #include "google/cloud/storage/benchmarks/throughput_result.h"
@@ -22,6 +23,7 @@
 #include "google/cloud/internal/format_time_point.h"
 #include "google/cloud/internal/getenv.h"
 #include "google/cloud/internal/random.h"
+#include "absl/memory/memory.h"
 #include <future>
 #include <set>
 #include <sstream>
@@ -93,6 +95,16 @@ The loop stops when any of the following conditions are met:
 - The test has obtained at least a prescribed "minimum number of samples" *and*
   the test has been running for more than a prescribed "duration".
 
+The CPU time is also broken down by stage: transport (libcurl and TLS),
+hashing, data copies, and JSON parsing. These values are zero unless the library
+is compiled with `GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS`. The helper
+script reports the hashing share of the CPU time from these values. Both the
+CPU time and the stage times are measured for the thread running the
+experiment, the benchmark does not use `UseBackgroundHashing`. With
+`--enable-perf-counters` the program also captures the CPU cycles, instructions,
+and cache misses for each upload and download. These are only available on
+Linux, and are reported as -1 if the kernel does not allow them.
+
 Once the threads finish running their loops the program prints the captured
 performance data. The bucket is deleted after the program terminates.
 
@@ -102,6 +114,12 @@ this program.
 
 using TestResults = std::vector<ThroughputResult>;
 
+ThroughputResult RunExperiment(
+    gcs_bm::ThroughputExperiment& experiment,
+    gcs_bm::PerfCounters const* perf_counters, std::string const& bucket_name,
+    std::string const& object_name,
+    gcs_bm::ThroughputExperimentConfig const& config);
+
 TestResults RunThread(ThroughputOptions const& ThroughputOptions,
                       std::string const& bucket_name, int thread_id);
 void PrintResults(TestResults const& results);
@@ -288,6 +306,16 @@ TestResults RunThread(ThroughputOptions const& options,
 
   auto deadline = std::chrono::steady_clock::now() + options.duration;
 
+  // The counters measure the thread that creates them, this is the thread
+  // running all the experiments.
+  std::unique_ptr<gcs_bm::PerfCounters> perf_counters;
+  if (options.enable_perf_counters) {
+    perf_counters = absl::make_unique<gcs_bm::PerfCounters>();
+    if (!perf_counters->available()) {
+      std::cout << "# Hardware performance counters are not available\n";
+    }
+  }
+
   gcs_bm::Timer timer;
   TestResults results;
 
@@ -305,11 +333,11 @@ TestResults RunThread(ThroughputOptions const& options,
     auto const api = options.enabled_apis[api_generator(generator)];
 
     auto& uploader = uploaders[uploader_generator(generator)];
-    auto upload_result =
-        uploader->Run(bucket_name, object_name,
-                      gcs_bm::ThroughputExperimentConfig{
-                          gcs_bm::kOpWrite, object_size, write_size,
-                          upload_buffer_size, enable_crc, enable_md5});
+    auto upload_result = RunExperiment(
+        *uploader, perf_counters.get(), bucket_name, object_name,
+        gcs_bm::ThroughputExperimentConfig{gcs_bm::kOpWrite, object_size,
+                                           write_size, upload_buffer_size,
+                                           enable_crc, enable_md5});
     auto status = upload_result.status;
     results.emplace_back(std::move(upload_result));
 
@@ -323,8 +351,8 @@ TestResults RunThread(ThroughputOptions const& options,
 
     auto& downloader = downloaders[downloader_generator(generator)];
     for (auto op : {gcs_bm::kOpRead0, gcs_bm::kOpRead1, gcs_bm::kOpRead2}) {
-      results.emplace_back(downloader->Run(
-          bucket_name, object_name,
+      results.emplace_back(RunExperiment(
+          *downloader, perf_counters.get(), bucket_name, object_name,
           gcs_bm::ThroughputExperimentConfig{op, object_size, read_size,
                                              download_buffer_size, enable_crc,
                                              enable_md5}));
@@ -340,6 +368,22 @@ TestResults RunThread(ThroughputOptions const& options,
   return results;
 }
 
+ThroughputResult RunExperiment(
+    gcs_bm::ThroughputExperiment& experiment,
+    gcs_bm::PerfCounters const* perf_counters, std::string const& bucket_name,
+    std::string const& object_name,
+    gcs_bm::ThroughputExperimentConfig const& config) {
+  auto const stages = gcs::internal::ThreadStageCpuTimes();
+  auto const counters = perf_counters ? perf_counters->Read()
+                                      : gcs_bm::NoHardwareCounters();
+  auto result = experiment.Run(bucket_name, object_name, config);
+  result.stage_cpu_time = gcs::internal::ElapsedStageCpuTimes(stages);
+  if (perf_counters) {
+    result.hardware_counters = perf_counters->Read() - counters;
+  }
+  return result;
+}
+
 google::cloud::StatusOr<ThroughputOptions> SelfTest(char const* argv0) {
   using google::cloud::internal::GetEnv;
   using google::cloud::internal::Sample;
@@ -374,6 +418,7 @@ google::cloud::StatusOr<ThroughputOptions> SelfTest(char const* argv0) {
           "--enabled-apis=JSON,XML",
           "--enabled-crc32c=enabled",
           "--enabled-md5=disabled",
+          "--enable-perf-counters=true",
       },
       kDescription);
 }
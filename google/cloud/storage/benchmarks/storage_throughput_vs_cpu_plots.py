@@ -34,6 +34,9 @@ def load_throughput_vs_cpu_output(file):
     df["ElapsedSeconds"] = df.ElapsedTimeUs / 1_000_000
     df["MiBs"] = df.MiB / df.ElapsedSeconds
     df["CpuNanosPerByte"] = (df.CpuTimeUs * 1_000) / df.ObjectSize
+    # The stage timers are zero unless the library is compiled with
+    # GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS.
+    df["HashingShare"] = (df.HashingCpuUs / df.CpuTimeUs).where(df.CpuTimeUs > 0, 0)
     return df
 
 
@@ -73,6 +76,11 @@ print("")
 print("Latency Summary")
 print(subset.groupby(["Op", "ApiName"])["ElapsedSeconds"].describe().unstack(1))
 
+# %%
+print("")
+print("Hashing Share of CPU Time Summary")
+print(data.groupby(["Op", "Crc32cEnabled", "MD5Enabled"])["HashingShare"].describe())
+
 # %%
 # Runs with small uploads/downloads look better with log scale.
 use_y_log10 = max(data["MiB"]) <= 8.0
@@ -103,6 +111,13 @@ plot = (
     args.output_prefix + ".cpu-vs-size.png"
 )
 
+# %%
+(
+    p9.ggplot(data=data, mapping=p9.aes(x="MiB", y="HashingShare", color="ApiName"))
+    + p9.geom_point()
+    + facet
+).save(args.output_prefix + ".hashing-share-vs-size.png")
+
 # %%
 (
     p9.ggplot(data=data, mapping=p9.aes(x="MiB", y="MiBs", color="ApiName"))
@@ -78,7 +78,9 @@ class UploadObject : public ThroughputExperiment {
                               api_,
                               timer.elapsed_time(),
                               timer.cpu_time(),
-                              object_metadata.status()};
+                              object_metadata.status(),
+                              /*stage_cpu_time=*/{},
+                              NoHardwareCounters()};
     }
     Timer timer;
     timer.Start();
@@ -106,7 +108,9 @@ class UploadObject : public ThroughputExperiment {
                             api_,
                             timer.elapsed_time(),
                             timer.cpu_time(),
-                            writer.metadata().status()};
+                            writer.metadata().status(),
+                            /*stage_cpu_time=*/{},
+                            NoHardwareCounters()};
   }
 
  private:
@@ -156,7 +160,9 @@ class DownloadObject : public ThroughputExperiment {
                             api_,
                             timer.elapsed_time(),
                             timer.cpu_time(),
-                            reader.status()};
+                            reader.status(),
+                            /*stage_cpu_time=*/{},
+                            NoHardwareCounters()};
   }
 
  private:
@@ -238,7 +244,9 @@ class DownloadObjectLibcurl : public ThroughputExperiment {
                             api_,
                             timer.elapsed_time(),
                             timer.cpu_time(),
-                            status};
+                            status,
+                            /*stage_cpu_time=*/{},
+                            NoHardwareCounters()};
   }
 
  private:
@@ -296,7 +304,9 @@ class DownloadObjectRawGrpc : public ThroughputExperiment {
                             ApiName::kApiRawGrpc,
                             timer.elapsed_time(),
                             timer.cpu_time(),
-                            status};
+                            status,
+                            /*stage_cpu_time=*/{},
+                            NoHardwareCounters()};
   }
 
  private:
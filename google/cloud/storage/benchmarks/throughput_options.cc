@@ -135,6 +135,11 @@ google::cloud::StatusOr<ThroughputOptions> ParseThroughputOptions(
        [&options, &parse_checksums](std::string const& val) {
          options.enabled_md5 = parse_checksums(val);
        }},
+      {"--enable-perf-counters",
+       "collect hardware performance counters (Linux only)",
+       [&options](std::string const& val) {
+         options.enable_perf_counters = ParseBoolean(val).value_or(true);
+       }},
   };
   auto usage = BuildUsage(desc, argv[0]);
 
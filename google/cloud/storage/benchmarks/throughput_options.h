@@ -48,6 +48,7 @@ struct ThroughputOptions {
   };
   std::vector<bool> enabled_crc32c = {false, true};
   std::vector<bool> enabled_md5 = {false, true};
+  bool enable_perf_counters = false;
 };
 
 google::cloud::StatusOr<ThroughputOptions> ParseThroughputOptions(
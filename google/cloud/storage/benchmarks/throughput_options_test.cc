@@ -46,6 +46,7 @@ TEST(ThroughputOptions, Basic) {
       "--enabled-apis=JSON,GRPC,XML",
       "--enabled-crc32c=enabled",
       "--enabled-md5=disabled",
+      "--enable-perf-counters=true",
   });
   ASSERT_STATUS_OK(options);
   EXPECT_EQ("test-project", options->project_id);
@@ -67,6 +68,7 @@ TEST(ThroughputOptions, Basic) {
                                    ApiName::kApiJson));
   EXPECT_THAT(options->enabled_crc32c, ElementsAre(true));
   EXPECT_THAT(options->enabled_md5, ElementsAre(false));
+  EXPECT_TRUE(options->enable_perf_counters);
 }
 
 TEST(ThroughputOptions, Description) {
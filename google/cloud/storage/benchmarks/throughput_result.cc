@@ -15,13 +15,19 @@
 #include "google/cloud/storage/benchmarks/throughput_result.h"
 #include "google/cloud/internal/absl_str_cat_quiet.h"
 #include "google/cloud/internal/absl_str_replace_quiet.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
 #include <sstream>
 #include <string>
+#include <utility>
 
 namespace google {
 namespace cloud {
 namespace storage_benchmarks {
 
+namespace gcs = google::cloud::storage;
+
 namespace {
 template <typename T>
 std::string QuoteCsv(T const& element) {
@@ -42,13 +48,24 @@ void PrintAsCsv(std::ostream& os, ThroughputResult const& r) {
   os << ToString(r.op) << ',' << r.object_size << ',' << r.app_buffer_size
      << ',' << r.lib_buffer_size << ',' << r.crc_enabled << ',' << r.md5_enabled
      << ',' << ToString(r.api) << ',' << r.elapsed_time.count() << ','
-     << r.cpu_time.count() << ',' << QuoteCsv(r.status) << '\n';
+     << r.cpu_time.count();
+  using std::chrono::microseconds;
+  for (auto const& t : r.stage_cpu_time) {
+    os << ',' << std::chrono::duration_cast<microseconds>(t).count();
+  }
+  os << ',' << r.hardware_counters.cycles << ','
+     << r.hardware_counters.instructions << ','
+     << r.hardware_counters.cache_misses << ',' << QuoteCsv(r.status) << '\n';
 }
 
 void PrintThroughputResultHeader(std::ostream& os) {
   os << "Op,ObjectSize,AppBufferSize,LibBufferSize"
      << ",Crc32cEnabled,MD5Enabled,ApiName"
-     << ",ElapsedTimeUs,CpuTimeUs,Status\n";
+     << ",ElapsedTimeUs,CpuTimeUs";
+  for (std::size_t i = 0; i != gcs::internal::kStageCount; ++i) {
+    os << ',' << ToString(static_cast<gcs::internal::Stage>(i)) << "CpuUs";
+  }
+  os << ",Cycles,Instructions,CacheMisses,Status\n";
 }
 
 char const* ToString(OpType op) {
@@ -63,10 +80,59 @@ char const* ToString(OpType op) {
       return "WRITE";
     case kOpInsert:
       return "INSERT";
+    case kOpGetMetadata:
+      return "METADATA";
   }
   return nullptr;  // silence g++ error.
 }
 
+std::vector<LatencySummary> SummarizeLatency(
+    std::vector<ThroughputResult> const& results) {
+  struct Group {
+    std::vector<std::chrono::microseconds> latencies;
+    std::int64_t error_count = 0;
+  };
+  std::map<std::pair<OpType, ApiName>, Group> groups;
+  for (auto const& r : results) {
+    auto& g = groups[{r.op, r.api}];
+    if (!r.status.ok()) {
+      ++g.error_count;
+      continue;
+    }
+    g.latencies.push_back(r.elapsed_time);
+  }
+
+  std::vector<LatencySummary> summaries;
+  for (auto& kv : groups) {
+    auto& latencies = kv.second.latencies;
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+      if (latencies.empty()) return std::chrono::microseconds(0);
+      auto const rank = static_cast<std::size_t>(
+          std::ceil(p * static_cast<double>(latencies.size())));
+      return latencies[(std::max)(rank, std::size_t{1}) - 1];
+    };
+    summaries.push_back(LatencySummary{
+        kv.first.first, kv.first.second,
+        static_cast<std::int64_t>(latencies.size()), kv.second.error_count,
+        percentile(0.50), percentile(0.90), percentile(0.99),
+        percentile(0.999), percentile(1.0)});
+  }
+  return summaries;
+}
+
+void PrintAsCsv(std::ostream& os, LatencySummary const& s) {
+  os << ToString(s.op) << ',' << ToString(s.api) << ',' << s.sample_count
+     << ',' << s.error_count << ',' << s.p50.count() << ',' << s.p90.count()
+     << ',' << s.p99.count() << ',' << s.p999.count() << ',' << s.max.count()
+     << '\n';
+}
+
+void PrintLatencySummaryHeader(std::ostream& os) {
+  os << "Op,ApiName,SampleCount,ErrorCount"
+     << ",P50Us,P90Us,P99Us,P999Us,MaxUs\n";
+}
+
 }  // namespace storage_benchmarks
 }  // namespace cloud
 }  // namespace google
@@ -16,8 +16,11 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BENCHMARKS_THROUGHPUT_RESULT_H
 
 #include "google/cloud/storage/benchmarks/benchmark_utils.h"
+#include "google/cloud/storage/benchmarks/perf_counters.h"
+#include "google/cloud/storage/internal/stage_timer.h"
 #include <chrono>
 #include <cstdint>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -45,6 +48,9 @@ enum OpType {
   /// equivalent function.
   /// This was the third download of this object in the experiment.
   kOpRead2,
+  /// The experiment fetched the object metadata, using
+  /// Client::GetObjectMetadata() or an equivalent function.
+  kOpGetMetadata,
 };
 
 /**
@@ -81,8 +87,17 @@ struct ThroughputResult {
   /// The result of the operation. The analysis may need to discard failed
   /// uploads or downloads.
   google::cloud::Status status;
+  /// The CPU time in each stage of the client library. All zeros unless the
+  /// library is compiled with `GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS`.
+  google::cloud::storage::internal::StageCpuTimes stage_cpu_time;
+  /// The hardware counters for the thread running the experiment, -1 if they
+  /// were not collected.
+  HardwareCounters hardware_counters;
 };
 
+/// The value for `ThroughputResult::hardware_counters` when not collected.
+inline HardwareCounters NoHardwareCounters() { return {-1, -1, -1}; }
+
 /// Print @p r as a CSV line.
 void PrintAsCsv(std::ostream& os, ThroughputResult const& r);
 
@@ -91,6 +106,45 @@ void PrintThroughputResultHeader(std::ostream& os);
 
 char const* ToString(OpType op);
 
+/**
+ * The latency distribution for a group of `ThroughputResult`s.
+ *
+ * Benchmarks for small objects are dominated by the per-request latency, and
+ * the tail of the latency distribution is often more interesting than the
+ * average. The percentiles only include successful operations.
+ */
+struct LatencySummary {
+  /// The operation for all the results in this group.
+  OpType op;
+  /// The API for all the results in this group.
+  ApiName api;
+  /// The number of successful operations.
+  std::int64_t sample_count;
+  /// The number of failed operations.
+  std::int64_t error_count;
+  std::chrono::microseconds p50;
+  std::chrono::microseconds p90;
+  std::chrono::microseconds p99;
+  std::chrono::microseconds p999;
+  std::chrono::microseconds max;
+};
+
+/**
+ * Group @p results by operation and API, and summarize their latency.
+ *
+ * The percentiles use the nearest-rank method, and are zero for groups
+ * without successful operations.
+ */
+std::vector<LatencySummary> SummarizeLatency(
+    std::vector<ThroughputResult> const& results);
+
+/// Print @p s as a CSV line.
+void PrintAsCsv(std::ostream& os, LatencySummary const& s);
+
+/// Print the field names produced by `PrintAsCsv(std::ostream&, LatencySummary
+/// const&)`.
+void PrintLatencySummaryHeader(std::ostream& os);
+
 }  // namespace storage_benchmarks
 }  // namespace cloud
 }  // namespace google
@@ -72,7 +72,11 @@ TEST(ThroughputResult, HeaderMatches) {
       /*app_buffer_size=*/2 * kMiB, /*lib_buffer_size=*/4 * kMiB,
       /*crc_enabled=*/true, /*md5_enabled=*/false, ApiName::kApiGrpc,
       std::chrono::microseconds(234000), std::chrono::microseconds(345000),
-      Status{StatusCode::kOutOfRange, "OOR-status-message"}});
+      Status{StatusCode::kOutOfRange, "OOR-status-message"},
+      /*stage_cpu_time=*/
+      {std::chrono::microseconds(4567), std::chrono::microseconds(0),
+       std::chrono::microseconds(0), std::chrono::microseconds(0)},
+      HardwareCounters{1234567, 7654321, 42}});
   ASSERT_STATUS_OK(line);
   ASSERT_FALSE(header.empty());
   ASSERT_FALSE(line->empty());
@@ -94,6 +98,8 @@ TEST(ThroughputResult, HeaderMatches) {
   EXPECT_THAT(*line, HasSubstr(ToString(ApiName::kApiGrpc)));
   EXPECT_THAT(*line, HasSubstr(",234000,"));
   EXPECT_THAT(*line, HasSubstr(",345000,"));
+  EXPECT_THAT(*line, HasSubstr(",4567,"));
+  EXPECT_THAT(*line, HasSubstr(",1234567,7654321,42,"));
   EXPECT_THAT(*line, HasSubstr(StatusCodeToString(StatusCode::kOutOfRange)));
   EXPECT_THAT(*line, HasSubstr("OOR-status-message"));
 }
@@ -130,6 +136,72 @@ TEST(ThroughputResult, QuoteCsv) {
                                      "\r\nand CRLF"));
 }
 
+TEST(ThroughputResult, SummarizeLatency) {
+  auto make = [](OpType op, ApiName api, int us, Status status = Status{}) {
+    return ThroughputResult{op,
+                            /*object_size=*/4 * kKiB,
+                            /*app_buffer_size=*/0,
+                            /*lib_buffer_size=*/0,
+                            /*crc_enabled=*/false,
+                            /*md5_enabled=*/false,
+                            api,
+                            std::chrono::microseconds(us),
+                            std::chrono::microseconds(0),
+                            std::move(status),
+                            /*stage_cpu_time=*/{},
+                            NoHardwareCounters()};
+  };
+  std::vector<ThroughputResult> results;
+  for (int i = 1000; i != 0; --i) {
+    results.push_back(make(kOpRead0, ApiName::kApiXml, i));
+  }
+  results.push_back(make(kOpInsert, ApiName::kApiJson, 10));
+  results.push_back(make(kOpInsert, ApiName::kApiJson, 20,
+                         Status{StatusCode::kUnavailable, "try-again"}));
+  results.push_back(make(kOpGetMetadata, ApiName::kApiJson, 30,
+                         Status{StatusCode::kUnavailable, "try-again"}));
+
+  auto const summaries = SummarizeLatency(results);
+  ASSERT_EQ(3U, summaries.size());
+  auto find = [&summaries](OpType op) {
+    return *std::find_if(
+        summaries.begin(), summaries.end(),
+        [op](LatencySummary const& s) { return s.op == op; });
+  };
+
+  auto const read = find(kOpRead0);
+  EXPECT_EQ(ApiName::kApiXml, read.api);
+  EXPECT_EQ(1000, read.sample_count);
+  EXPECT_EQ(0, read.error_count);
+  EXPECT_EQ(500, read.p50.count());
+  EXPECT_EQ(900, read.p90.count());
+  EXPECT_EQ(990, read.p99.count());
+  EXPECT_EQ(999, read.p999.count());
+  EXPECT_EQ(1000, read.max.count());
+
+  auto const insert = find(kOpInsert);
+  EXPECT_EQ(1, insert.sample_count);
+  EXPECT_EQ(1, insert.error_count);
+  EXPECT_EQ(10, insert.p50.count());
+  EXPECT_EQ(10, insert.p999.count());
+
+  auto const metadata = find(kOpGetMetadata);
+  EXPECT_EQ(0, metadata.sample_count);
+  EXPECT_EQ(1, metadata.error_count);
+  EXPECT_EQ(0, metadata.max.count());
+
+  std::ostringstream header;
+  PrintLatencySummaryHeader(header);
+  std::ostringstream line;
+  PrintAsCsv(line, read);
+  auto const h = std::move(header).str();
+  auto const l = std::move(line).str();
+  EXPECT_EQ(std::count(h.begin(), h.end(), ','),
+            std::count(l.begin(), l.end(), ','));
+  EXPECT_THAT(l, HasSubstr(ToString(kOpRead0)));
+  EXPECT_THAT(l, HasSubstr(",500,900,990,999,1000\n"));
+}
+
 }  // namespace
 }  // namespace storage_benchmarks
 }  // namespace cloud
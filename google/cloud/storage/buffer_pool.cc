@@ -0,0 +1,147 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/buffer_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+#ifdef _WIN32
+#include <malloc.h>
+#endif  // _WIN32
+#ifdef __linux__
+#include <sys/mman.h>
+#endif  // __linux__
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+std::size_t constexpr kHugePageSize = 2 * 1024 * 1024L;
+
+class DefaultBufferPoolImpl : public BufferPool {
+ public:
+  char* Allocate(std::size_t size) override { return new char[size]; }
+  void Deallocate(char* buffer, std::size_t) override { delete[] buffer; }
+};
+
+class RecyclingBufferPool : public BufferPool {
+ public:
+  explicit RecyclingBufferPool(RecyclingBufferPoolOptions options)
+      : options_(std::move(options)) {}
+
+  ~RecyclingBufferPool() override {
+    for (auto& kv : free_) {
+      for (auto* b : kv.second) Free(b, kv.first);
+    }
+  }
+
+  char* Allocate(std::size_t size) override {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      auto l = free_.find(size);
+      if (l != free_.end() && !l->second.empty()) {
+        auto* b = l->second.back();
+        l->second.pop_back();
+        cached_bytes_ -= size;
+        return b;
+      }
+    }
+    return Alloc(size);
+  }
+
+  void Deallocate(char* buffer, std::size_t size) override {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if (cached_bytes_ + size <= options_.max_cached_bytes()) {
+        free_[size].push_back(buffer);
+        cached_bytes_ += size;
+        return;
+      }
+    }
+    Free(buffer, size);
+  }
+
+ private:
+  std::size_t Alignment(std::size_t size) const {
+    auto alignment = options_.alignment();
+#ifdef __linux__
+    if (options_.use_huge_pages() && size >= kHugePageSize) {
+      alignment = (std::max)(alignment, kHugePageSize);
+    }
+#else
+    (void)size;
+#endif  // __linux__
+    return alignment;
+  }
+
+  char* Alloc(std::size_t size) const {
+    auto const alignment = Alignment(size);
+    if (alignment == 0) return new char[size];
+#ifdef _WIN32
+    auto* b = static_cast<char*>(_aligned_malloc(size, alignment));
+    if (b == nullptr) throw std::bad_alloc();
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, (std::max)(alignment, sizeof(void*)), size) != 0) {
+      throw std::bad_alloc();
+    }
+    auto* b = static_cast<char*>(p);
+#endif  // _WIN32
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (alignment >= kHugePageSize) (void)madvise(b, size, MADV_HUGEPAGE);
+#endif  // __linux__ && MADV_HUGEPAGE
+    return b;
+  }
+
+  void Free(char* buffer, std::size_t size) const {
+    // The alignment is a function of the size, so is the allocation function.
+    if (Alignment(size) == 0) {
+      delete[] buffer;
+      return;
+    }
+#ifdef _WIN32
+    _aligned_free(buffer);
+#else
+    std::free(buffer);
+#endif  // _WIN32
+  }
+
+  RecyclingBufferPoolOptions const options_;
+  std::mutex mu_;
+  std::map<std::size_t, std::vector<char*>> free_;
+  std::size_t cached_bytes_ = 0;
+};
+
+}  // namespace
+
+std::shared_ptr<BufferPool> DefaultBufferPool() {
+  static auto* const kPool = new std::shared_ptr<BufferPool>(
+      std::make_shared<DefaultBufferPoolImpl>());
+  return *kPool;
+}
+
+std::shared_ptr<BufferPool> MakeRecyclingBufferPool(
+    RecyclingBufferPoolOptions options) {
+  return std::make_shared<RecyclingBufferPool>(std::move(options));
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
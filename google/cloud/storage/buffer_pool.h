@@ -0,0 +1,131 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BUFFER_POOL_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BUFFER_POOL_H
+
+#include "google/cloud/storage/version.h"
+#include <cstddef>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * Provides the memory for the buffers used in uploads and downloads.
+ *
+ * Each `ObjectReadStream`, `ObjectWriteStream`, and each download request
+ * allocates its own buffers. Applications that open many short-lived streams
+ * can recycle these buffers by configuring a pool, via
+ * `ClientOptions::set_buffer_pool()`.
+ *
+ * Implementations must be thread-safe, buffers are allocated and released
+ * from multiple threads.
+ */
+class BufferPool {
+ public:
+  virtual ~BufferPool() = default;
+
+  /// Returns a buffer with room for (at least) @p size bytes.
+  virtual char* Allocate(std::size_t size) = 0;
+
+  /// Releases a buffer returned by `Allocate(size)`.
+  virtual void Deallocate(char* buffer, std::size_t size) = 0;
+};
+
+/**
+ * Returns the pool used by default.
+ *
+ * This pool does not recycle buffers, it allocates memory in each call to
+ * `Allocate()` and releases it in each call to `Deallocate()`.
+ */
+std::shared_ptr<BufferPool> DefaultBufferPool();
+
+/// Configure the pools created by `MakeRecyclingBufferPool()`.
+class RecyclingBufferPoolOptions {
+ public:
+  RecyclingBufferPoolOptions() = default;
+
+  /**
+   * The maximum number of bytes kept in the pool for reuse.
+   *
+   * Buffers released while the pool is full are freed. The default is 64MiB.
+   */
+  std::size_t max_cached_bytes() const { return max_cached_bytes_; }
+  RecyclingBufferPoolOptions& set_max_cached_bytes(std::size_t v) {
+    max_cached_bytes_ = v;
+    return *this;
+  }
+
+  /**
+   * The alignment for the buffers, it must be a power of two, or 0.
+   *
+   * Use the page size (typically 4KiB) for buffers that are used with
+   * unbuffered (`O_DIRECT`) file I/O. The default (0) uses the alignment of
+   * `new char[]`.
+   */
+  std::size_t alignment() const { return alignment_; }
+  RecyclingBufferPoolOptions& set_alignment(std::size_t v) {
+    alignment_ = v;
+    return *this;
+  }
+
+  /**
+   * Request transparent huge pages for large buffers.
+   *
+   * On Linux, buffers of 2MiB or more are aligned to 2MiB and the kernel is
+   * advised to back them with huge pages, reducing TLB misses when the buffers
+   * are large. This option is ignored on other platforms.
+   */
+  bool use_huge_pages() const { return use_huge_pages_; }
+  RecyclingBufferPoolOptions& set_use_huge_pages(bool v) {
+    use_huge_pages_ = v;
+    return *this;
+  }
+
+ private:
+  std::size_t max_cached_bytes_ = 64 * 1024 * 1024L;
+  std::size_t alignment_ = 0;
+  bool use_huge_pages_ = false;
+};
+
+/**
+ * Creates a pool that recycles the buffers released by the streams.
+ *
+ * The pool keeps the released buffers, grouped by size, and returns them in
+ * future calls to `Allocate()` with the same size. Streams created with the
+ * same `ClientOptions` use buffers of a few different sizes only, so most
+ * allocations are served from the pool once it is warmed up.
+ *
+ * @par Example
+ * @code
+ * namespace gcs = google::cloud::storage;
+ * auto options = gcs::ClientOptions::CreateDefaultClientOptions();
+ * if (!options) throw std::runtime_error(options.status().message());
+ * auto pool_options = gcs::RecyclingBufferPoolOptions{}.set_max_cached_bytes(
+ *     256 * 1024 * 1024L);
+ * options->set_buffer_pool(gcs::MakeRecyclingBufferPool(pool_options));
+ * gcs::Client client(*std::move(options));
+ * @endcode
+ */
+std::shared_ptr<BufferPool> MakeRecyclingBufferPool(
+    RecyclingBufferPoolOptions options = {});
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BUFFER_POOL_H
@@ -0,0 +1,112 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/buffer_pool.h"
+#include "google/cloud/storage/internal/pooled_buffer.h"
+#include <gmock/gmock.h>
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+using ::google::cloud::storage::internal::PooledBuffer;
+
+TEST(BufferPoolTest, Default) {
+  auto pool = DefaultBufferPool();
+  ASSERT_NE(nullptr, pool);
+  EXPECT_EQ(pool, DefaultBufferPool());
+  auto* b = pool->Allocate(1024);
+  ASSERT_NE(nullptr, b);
+  b[0] = 'a';
+  b[1023] = 'z';
+  pool->Deallocate(b, 1024);
+}
+
+TEST(BufferPoolTest, RecyclingReusesBuffers) {
+  auto pool = MakeRecyclingBufferPool();
+  auto* b0 = pool->Allocate(1024);
+  auto* b1 = pool->Allocate(2048);
+  pool->Deallocate(b0, 1024);
+  pool->Deallocate(b1, 2048);
+  EXPECT_EQ(b1, pool->Allocate(2048));
+  EXPECT_EQ(b0, pool->Allocate(1024));
+  pool->Deallocate(b0, 1024);
+  pool->Deallocate(b1, 2048);
+}
+
+TEST(BufferPoolTest, RecyclingRespectsMaxCachedBytes) {
+  auto pool = MakeRecyclingBufferPool(
+      RecyclingBufferPoolOptions{}.set_max_cached_bytes(1024));
+  auto* b0 = pool->Allocate(1024);
+  auto* b1 = pool->Allocate(1024);
+  pool->Deallocate(b0, 1024);
+  // The pool is full, this buffer is released.
+  pool->Deallocate(b1, 1024);
+  auto* b2 = pool->Allocate(1024);
+  EXPECT_EQ(b0, b2);
+  pool->Deallocate(b2, 1024);
+}
+
+TEST(BufferPoolTest, RecyclingAlignment) {
+  auto constexpr kAlignment = 4096;
+  auto pool = MakeRecyclingBufferPool(
+      RecyclingBufferPoolOptions{}.set_alignment(kAlignment));
+  for (std::size_t size : {1000, 4096, 256 * 1024}) {
+    auto* b = pool->Allocate(size);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(b) % kAlignment);
+    pool->Deallocate(b, size);
+  }
+}
+
+TEST(BufferPoolTest, RecyclingHugePages) {
+  auto constexpr kSize = 4 * 1024 * 1024L;
+  auto pool = MakeRecyclingBufferPool(
+      RecyclingBufferPoolOptions{}.set_use_huge_pages(true));
+  auto* small = pool->Allocate(1024);
+  auto* large = pool->Allocate(kSize);
+  ASSERT_NE(nullptr, small);
+  ASSERT_NE(nullptr, large);
+  large[kSize - 1] = 'z';
+  pool->Deallocate(small, 1024);
+  pool->Deallocate(large, kSize);
+}
+
+TEST(BufferPoolTest, PooledBuffer) {
+  auto pool = MakeRecyclingBufferPool();
+  PooledBuffer buffer(pool, 1024);
+  ASSERT_NE(nullptr, buffer.data());
+  EXPECT_EQ(1024, buffer.size());
+  auto* data = buffer.data();
+
+  PooledBuffer moved(std::move(buffer));
+  EXPECT_EQ(data, moved.data());
+  EXPECT_TRUE(buffer.empty());  // NOLINT(bugprone-use-after-move)
+
+  moved.reset();
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(nullptr, moved.data());
+
+  // The buffer was returned to the pool, and is reused.
+  PooledBuffer reused(pool, 1024);
+  EXPECT_EQ(data, reused.data());
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
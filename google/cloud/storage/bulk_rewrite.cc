@@ -0,0 +1,135 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/bulk_rewrite.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+namespace {
+
+/// The state shared by all the rewrites in a `BulkRewriteImpl()` call.
+class BulkRewriteState {
+ public:
+  BulkRewriteState(std::size_t total_objects,
+                   std::function<void(BulkRewriteProgress const&)> const& cb)
+      : progress_{total_objects, 0, 0, 0, 0}, cb_(cb) {}
+
+  /// Block until any pause requested by `Pause()` expires.
+  void WaitIfPaused() {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto const until = pause_until_;
+    lk.unlock();
+    std::this_thread::sleep_until(until);
+  }
+
+  /// Pause all the rewrites for @p delay.
+  void Pause(std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lk(mu_);
+    pause_until_ =
+        (std::max)(pause_until_, std::chrono::steady_clock::now() + delay);
+  }
+
+  void OnIteration(std::uint64_t bytes_rewritten, std::uint64_t new_bytes) {
+    std::lock_guard<std::mutex> lk(mu_);
+    progress_.bytes_rewritten += bytes_rewritten;
+    progress_.total_bytes += new_bytes;
+    cb_(progress_);
+  }
+
+  void OnFinished(bool success) {
+    std::lock_guard<std::mutex> lk(mu_);
+    ++(success ? progress_.completed_objects : progress_.failed_objects);
+    cb_(progress_);
+  }
+
+ private:
+  std::mutex mu_;
+  BulkRewriteProgress progress_;
+  std::chrono::steady_clock::time_point pause_until_;
+  std::function<void(BulkRewriteProgress const&)> const& cb_;
+};
+
+BulkRewriteResult RewriteOne(BulkRewriteItem const& item,
+                             BulkRewriterFactory const& factory,
+                             RetryPolicy const& retry_policy,
+                             BackoffPolicy const& backoff_policy,
+                             BulkRewriteState& state) {
+  auto retry = retry_policy.clone();
+  auto backoff = backoff_policy.clone();
+  auto token = item.rewrite_token;
+  std::uint64_t bytes_rewritten = 0;
+  bool started = false;
+  while (true) {
+    state.WaitIfPaused();
+    // Each iteration creates a new rewriter, this is cheap and simplifies
+    // resuming from the last token after a failure.
+    auto rewriter = factory(item, token);
+    auto progress = rewriter.Iterate();
+    if (!progress) {
+      auto status = std::move(progress).status();
+      if (!retry->OnFailure(status)) {
+        state.OnFinished(false);
+        return BulkRewriteResult{item, std::move(status), std::move(token)};
+      }
+      auto const delay = backoff->OnCompletion();
+      if (status.code() == StatusCode::kResourceExhausted) state.Pause(delay);
+      std::this_thread::sleep_for(delay);
+      continue;
+    }
+    token = rewriter.token();
+    // The counters restart if the service restarts the rewrite.
+    auto const delta = progress->total_bytes_rewritten > bytes_rewritten
+                           ? progress->total_bytes_rewritten - bytes_rewritten
+                           : 0;
+    bytes_rewritten =
+        (std::max)(bytes_rewritten, progress->total_bytes_rewritten);
+    state.OnIteration(delta, started ? 0 : progress->object_size);
+    started = true;
+    if (progress->done) {
+      state.OnFinished(true);
+      return BulkRewriteResult{item, rewriter.Result(), std::string{}};
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<BulkRewriteResult> BulkRewriteImpl(
+    std::vector<BulkRewriteItem> const& items,
+    BulkRewriterFactory const& factory, std::size_t max_concurrency,
+    RetryPolicy const& retry_policy, BackoffPolicy const& backoff_policy,
+    std::function<void(BulkRewriteProgress const&)> const& progress) {
+  BulkRewriteState state(items.size(), progress);
+  std::vector<BulkRewriteResult> results(items.size());
+  RunConcurrently(items.size(), (std::max<std::size_t>)(1, max_concurrency),
+                  [&](std::size_t i) {
+                    results[i] = RewriteOne(items[i], factory, retry_policy,
+                                            backoff_policy, state);
+                  });
+  return results;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,260 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BULK_REWRITE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BULK_REWRITE_H
+
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/parallel_upload.h"
+#include "google/cloud/storage/retry_policy.h"
+#include "google/cloud/storage/version.h"
+#include "absl/memory/memory.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/// One object copied by `BulkRewriteObjects()`.
+struct BulkRewriteItem {
+  std::string source_bucket;
+  std::string source_object;
+  std::string destination_bucket;
+  std::string destination_object;
+  /// Resume a partially completed rewrite, leave empty to start a new one.
+  std::string rewrite_token;
+};
+
+/// The aggregate progress of a `BulkRewriteObjects()` call.
+struct BulkRewriteProgress {
+  std::size_t total_objects;
+  std::size_t completed_objects;
+  std::size_t failed_objects;
+  /// The bytes copied so far, across all the objects.
+  std::uint64_t bytes_rewritten;
+  /// The total size of the objects whose rewrite has started.
+  std::uint64_t total_bytes;
+};
+
+/// The result for each object in a `BulkRewriteObjects()` call.
+struct BulkRewriteResult {
+  BulkRewriteItem item;
+  /// The metadata of the new object, or the error that stopped the rewrite.
+  StatusOr<ObjectMetadata> metadata;
+  /**
+   * For failed rewrites, a token to resume the rewrite.
+   *
+   * Applications can copy the item, and set its `rewrite_token` to this value,
+   * to resume the rewrite without copying the same data again.
+   */
+  std::string rewrite_token;
+};
+
+/**
+ * The maximum number of rewrites in progress in a `BulkRewriteObjects()` call.
+ *
+ * The default is 16.
+ */
+class MaxConcurrentRewrites {
+ public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  MaxConcurrentRewrites(std::size_t value) : value_(value) {}
+  std::size_t value() const { return value_; }
+
+ private:
+  std::size_t value_;
+};
+
+/**
+ * Receive the progress of a `BulkRewriteObjects()` call.
+ *
+ * The callback is invoked after each rewrite iteration, and after each object
+ * completes or fails. The invocations are serialized, but they happen in the
+ * threads running the rewrites, so the callback should return quickly.
+ */
+class BulkRewriteProgressCallback {
+ public:
+  explicit BulkRewriteProgressCallback(
+      std::function<void(BulkRewriteProgress const&)> value)
+      : value_(std::move(value)) {}
+  std::function<void(BulkRewriteProgress const&)> const& value() const {
+    return value_;
+  }
+
+ private:
+  std::function<void(BulkRewriteProgress const&)> value_;
+};
+
+namespace internal {
+
+/// Creates the `ObjectRewriter` for one iteration of a bulk rewrite.
+using BulkRewriterFactory = std::function<ObjectRewriter(
+    BulkRewriteItem const&, std::string const& rewrite_token)>;
+
+/**
+ * Run the rewrites in @p items, using up to @p max_concurrency threads.
+ *
+ * Each rewrite resumes from its last rewrite token after a transient failure,
+ * using the @p retry_policy and @p backoff_policy prototypes. If the service
+ * reports `kResourceExhausted` (HTTP 429) all the rewrites pause for the
+ * backoff period.
+ */
+std::vector<BulkRewriteResult> BulkRewriteImpl(
+    std::vector<BulkRewriteItem> const& items,
+    BulkRewriterFactory const& factory, std::size_t max_concurrency,
+    RetryPolicy const& retry_policy, BackoffPolicy const& backoff_policy,
+    std::function<void(BulkRewriteProgress const&)> const& progress);
+
+struct BulkRewriteApplyHelper {
+  template <typename... Options>
+  ObjectRewriter operator()(Options&&... options) const {
+    return client.ResumeRewriteObject(
+        item.source_bucket, item.source_object, item.destination_bucket,
+        item.destination_object, rewrite_token,
+        std::forward<Options>(options)...);
+  }
+
+  Client& client;
+  BulkRewriteItem const& item;
+  std::string const& rewrite_token;
+};
+
+struct BulkRewriteListApplyHelper {
+  template <typename... Options>
+  ListObjectsReader operator()(Options&&... options) const {
+    return client.ListObjects(bucket_name, Prefix(prefix),
+                              std::forward<Options>(options)...);
+  }
+
+  Client& client;
+  std::string const& bucket_name;
+  std::string const& prefix;
+};
+
+}  // namespace internal
+
+/**
+ * Copy many objects, running multiple rewrites concurrently.
+ *
+ * This function uses `Client::RewriteObject()` to copy each object, running up
+ * to `MaxConcurrentRewrites` rewrites at a time. Rewrites that fail with a
+ * transient error resume from their last rewrite token. If the service reports
+ * that the application is sending too many requests (HTTP 429) all the rewrites
+ * pause before sending more requests.
+ *
+ * @param client the client used to perform the rewrites.
+ * @param items the objects to copy.
+ * @param options a list of optional query parameters and/or request headers.
+ *   In addition to the options valid in `Client::RewriteObject()`, this
+ *   function accepts `MaxConcurrentRewrites`, `BulkRewriteProgressCallback`,
+ *   `LimitedErrorCountRetryPolicy`, `LimitedTimeRetryPolicy`, and
+ *   `ExponentialBackoffPolicy`. The retry and backoff policies apply to each
+ *   object, and are in addition to the policies configured in @p client.
+ *
+ * @return the result for each element in @p items, in the same order.
+ */
+template <typename... Options>
+std::vector<BulkRewriteResult> BulkRewriteObjects(
+    Client client, std::vector<BulkRewriteItem> const& items,
+    Options&&... options) {
+  using internal::Among;
+  using internal::ExtractFirstOccurenceOfType;
+  using internal::NotAmong;
+  using internal::StaticTupleFilter;
+  auto all_options = std::tie(options...);
+
+  auto const max_concurrency =
+      ExtractFirstOccurenceOfType<MaxConcurrentRewrites>(all_options)
+          .value_or(MaxConcurrentRewrites(16))
+          .value();
+  auto const progress =
+      ExtractFirstOccurenceOfType<BulkRewriteProgressCallback>(all_options)
+          .value_or(BulkRewriteProgressCallback(
+              [](BulkRewriteProgress const&) {}));
+  auto const error_count =
+      ExtractFirstOccurenceOfType<LimitedErrorCountRetryPolicy>(all_options);
+  auto const retry_time =
+      ExtractFirstOccurenceOfType<LimitedTimeRetryPolicy>(all_options);
+  auto const backoff =
+      ExtractFirstOccurenceOfType<ExponentialBackoffPolicy>(all_options)
+          .value_or(ExponentialBackoffPolicy(std::chrono::seconds(1),
+                                             std::chrono::minutes(1), 2.0));
+  std::unique_ptr<RetryPolicy> retry =
+      absl::make_unique<LimitedErrorCountRetryPolicy>(8);
+  if (retry_time) retry = retry_time->clone();
+  if (error_count) retry = error_count->clone();
+
+  auto rewrite_options = StaticTupleFilter<NotAmong<
+      MaxConcurrentRewrites, BulkRewriteProgressCallback,
+      LimitedErrorCountRetryPolicy, LimitedTimeRetryPolicy,
+      ExponentialBackoffPolicy>::TPred>(all_options);
+  auto factory = [&client, &rewrite_options](BulkRewriteItem const& item,
+                                             std::string const& token) {
+    return google::cloud::internal::apply(
+        internal::BulkRewriteApplyHelper{client, item, token},
+        rewrite_options);
+  };
+  return internal::BulkRewriteImpl(items, factory, max_concurrency, *retry,
+                                   backoff, progress.value());
+}
+
+/**
+ * Copy all the objects with a given prefix to a different bucket or prefix.
+ *
+ * Each object named `<source_prefix><suffix>` in @p source_bucket is copied to
+ * `<destination_prefix><suffix>` in @p destination_bucket.
+ *
+ * @param client the client used to list the objects and perform the rewrites.
+ * @param source_bucket the bucket containing the objects to copy.
+ * @param source_prefix only objects with this prefix are copied.
+ * @param destination_bucket the bucket receiving the new objects.
+ * @param destination_prefix the prefix for the names of the new objects.
+ * @param options the same options as `BulkRewriteObjects()`. The `QuotaUser`,
+ *   `UserIp`, and `UserProject` options also apply to the listing request.
+ *
+ * @return the result for each object, or the error listing the objects.
+ */
+template <typename... Options>
+StatusOr<std::vector<BulkRewriteResult>> BulkRewriteObjectsWithPrefix(
+    Client client, std::string const& source_bucket,
+    std::string const& source_prefix, std::string const& destination_bucket,
+    std::string const& destination_prefix, Options&&... options) {
+  auto list_options = internal::StaticTupleFilter<
+      internal::Among<QuotaUser, UserIp, UserProject>::TPred>(
+      std::tie(options...));
+  auto reader = google::cloud::internal::apply(
+      internal::BulkRewriteListApplyHelper{client, source_bucket,
+                                           source_prefix},
+      list_options);
+  std::vector<BulkRewriteItem> items;
+  for (auto& object : reader) {
+    if (!object) return std::move(object).status();
+    items.push_back(BulkRewriteItem{
+        source_bucket, object->name(), destination_bucket,
+        destination_prefix + object->name().substr(source_prefix.size()),
+        std::string{}});
+  }
+  return BulkRewriteObjects(std::move(client), items,
+                            std::forward<Options>(options)...);
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_BULK_REWRITE_H
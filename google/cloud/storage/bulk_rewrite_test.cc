@@ -0,0 +1,203 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/bulk_rewrite.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <nlohmann/json.hpp>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+using ::google::cloud::storage::internal::ListObjectsRequest;
+using ::google::cloud::storage::internal::ListObjectsResponse;
+using ::google::cloud::storage::internal::RewriteObjectRequest;
+using ::google::cloud::storage::internal::RewriteObjectResponse;
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::storage::testing::canonical_errors::TransientError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::UnorderedElementsAre;
+
+ObjectMetadata MockObject(std::string const& bucket, std::string const& name) {
+  return internal::ObjectMetadataParser::FromJson(
+             nlohmann::json{{"bucket", bucket}, {"name", name}})
+      .value();
+}
+
+/// Simulate rewrites that complete in two iterations of 512 bytes.
+StatusOr<RewriteObjectResponse> TwoIterations(
+    RewriteObjectRequest const& request) {
+  if (request.rewrite_token().empty()) {
+    return RewriteObjectResponse{512, 1024, false,
+                                 "token-" + request.source_object(), {}};
+  }
+  EXPECT_EQ("token-" + request.source_object(), request.rewrite_token());
+  return RewriteObjectResponse{
+      1024, 1024, true, "",
+      MockObject(request.destination_bucket(), request.destination_object())};
+}
+
+class BulkRewriteTest : public ::testing::Test {
+ protected:
+  void SetUp() override { mock_ = std::make_shared<testing::MockClient>(); }
+
+  Client MakeClient() {
+    return Client(std::shared_ptr<internal::RawClient>(mock_),
+                  Client::NoDecorations{});
+  }
+
+  static ExponentialBackoffPolicy FastBackoff() {
+    return ExponentialBackoffPolicy(std::chrono::milliseconds(1),
+                                    std::chrono::milliseconds(2), 2.0);
+  }
+
+  std::shared_ptr<testing::MockClient> mock_;
+};
+
+TEST_F(BulkRewriteTest, Success) {
+  EXPECT_CALL(*mock_, RewriteObject(_)).WillRepeatedly(TwoIterations);
+
+  std::vector<BulkRewriteItem> items;
+  for (int i = 0; i != 10; ++i) {
+    items.push_back(BulkRewriteItem{"src", "o" + std::to_string(i), "dst",
+                                    "n" + std::to_string(i), {}});
+  }
+  std::mutex mu;
+  BulkRewriteProgress last{0, 0, 0, 0, 0};
+  auto results = BulkRewriteObjects(
+      MakeClient(), items, MaxConcurrentRewrites(3),
+      BulkRewriteProgressCallback([&](BulkRewriteProgress const& p) {
+        std::lock_guard<std::mutex> lk(mu);
+        last = p;
+      }));
+  ASSERT_EQ(items.size(), results.size());
+  for (std::size_t i = 0; i != items.size(); ++i) {
+    ASSERT_STATUS_OK(results[i].metadata);
+    EXPECT_EQ(items[i].destination_object, results[i].metadata->name());
+    EXPECT_EQ(items[i].source_object, results[i].item.source_object);
+  }
+  EXPECT_EQ(10, last.total_objects);
+  EXPECT_EQ(10, last.completed_objects);
+  EXPECT_EQ(0, last.failed_objects);
+  EXPECT_EQ(10 * 1024, last.bytes_rewritten);
+  EXPECT_EQ(10 * 1024, last.total_bytes);
+}
+
+TEST_F(BulkRewriteTest, ResumesAfterTransientError) {
+  int calls = 0;
+  EXPECT_CALL(*mock_, RewriteObject(_))
+      .WillRepeatedly([&](RewriteObjectRequest const& request) {
+        // Fail the second iteration once, it should resume with the same
+        // token.
+        if (++calls == 2) {
+          EXPECT_EQ("token-o", request.rewrite_token());
+          return StatusOr<RewriteObjectResponse>(TransientError());
+        }
+        return TwoIterations(request);
+      });
+
+  auto results = BulkRewriteObjects(
+      MakeClient(), {BulkRewriteItem{"src", "o", "dst", "n", {}}},
+      FastBackoff());
+  ASSERT_EQ(1, results.size());
+  EXPECT_STATUS_OK(results[0].metadata);
+  EXPECT_EQ(3, calls);
+}
+
+TEST_F(BulkRewriteTest, PermanentError) {
+  EXPECT_CALL(*mock_, RewriteObject(_))
+      .WillRepeatedly([](RewriteObjectRequest const& request) {
+        if (request.rewrite_token().empty()) return TwoIterations(request);
+        return StatusOr<RewriteObjectResponse>(PermanentError());
+      });
+
+  BulkRewriteProgress last{0, 0, 0, 0, 0};
+  auto results = BulkRewriteObjects(
+      MakeClient(), {BulkRewriteItem{"src", "o", "dst", "n", {}}},
+      FastBackoff(),
+      BulkRewriteProgressCallback(
+          [&](BulkRewriteProgress const& p) { last = p; }));
+  ASSERT_EQ(1, results.size());
+  EXPECT_THAT(results[0].metadata, StatusIs(PermanentError().code()));
+  // The application can resume the rewrite using this token.
+  EXPECT_EQ("token-o", results[0].rewrite_token);
+  EXPECT_EQ(1, last.failed_objects);
+  EXPECT_EQ(512, last.bytes_rewritten);
+}
+
+TEST_F(BulkRewriteTest, TooManyTransientErrors) {
+  EXPECT_CALL(*mock_, RewriteObject(_))
+      .Times(3)
+      .WillRepeatedly([](RewriteObjectRequest const&) {
+        return StatusOr<RewriteObjectResponse>(
+            Status(StatusCode::kResourceExhausted, "slow down"));
+      });
+
+  auto results = BulkRewriteObjects(
+      MakeClient(), {BulkRewriteItem{"src", "o", "dst", "n", {}}},
+      FastBackoff(), LimitedErrorCountRetryPolicy(2));
+  ASSERT_EQ(1, results.size());
+  EXPECT_THAT(results[0].metadata, StatusIs(StatusCode::kResourceExhausted));
+}
+
+TEST_F(BulkRewriteTest, WithPrefix) {
+  EXPECT_CALL(*mock_, ListObjects(_))
+      .WillOnce([](ListObjectsRequest const& request) {
+        EXPECT_EQ("src", request.bucket_name());
+        EXPECT_EQ("data/", request.GetOption<Prefix>().value());
+        ListObjectsResponse response;
+        response.items.push_back(MockObject("src", "data/a"));
+        response.items.push_back(MockObject("src", "data/b/c"));
+        return make_status_or(response);
+      });
+  EXPECT_CALL(*mock_, RewriteObject(_)).WillRepeatedly(TwoIterations);
+
+  auto results = BulkRewriteObjectsWithPrefix(MakeClient(), "src", "data/",
+                                              "dst", "backup/");
+  ASSERT_STATUS_OK(results);
+  std::vector<std::string> names;
+  for (auto const& r : *results) {
+    ASSERT_STATUS_OK(r.metadata);
+    EXPECT_EQ("dst", r.metadata->bucket());
+    names.push_back(r.metadata->name());
+  }
+  EXPECT_THAT(names, UnorderedElementsAre("backup/a", "backup/b/c"));
+}
+
+TEST_F(BulkRewriteTest, WithPrefixListError) {
+  EXPECT_CALL(*mock_, ListObjects(_))
+      .WillOnce([](ListObjectsRequest const&) {
+        return StatusOr<ListObjectsResponse>(PermanentError());
+      });
+  EXPECT_CALL(*mock_, RewriteObject(_)).Times(0);
+
+  auto results = BulkRewriteObjectsWithPrefix(MakeClient(), "src", "data/",
+                                              "dst", "backup/");
+  EXPECT_THAT(results, StatusIs(PermanentError().code()));
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -13,14 +13,25 @@
 // limitations under the License.
 
 #include "google/cloud/storage/client.h"
+#include "google/cloud/storage/internal/adaptive_chunk_size.h"
+#include "google/cloud/storage/internal/cached_object_read_source.h"
 #include "google/cloud/storage/internal/curl_client.h"
 #include "google/cloud/storage/internal/curl_handle.h"
+#include "google/cloud/storage/internal/direct_file_io.h"
+#include "google/cloud/storage/internal/gzip_object_read_source.h"
+#include "google/cloud/storage/internal/gzip_object_write_streambuf.h"
+#include "google/cloud/storage/internal/mapped_file.h"
 #include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/storage/internal/pipelined_object_write_streambuf.h"
+#include "google/cloud/storage/internal/pooled_buffer.h"
 #include "google/cloud/storage/oauth2/service_account_credentials.h"
 #include "google/cloud/internal/filesystem.h"
 #include "google/cloud/log.h"
 #include "absl/memory/memory.h"
 #include <openssl/md5.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <thread>
 
@@ -33,6 +44,59 @@ static_assert(std::is_copy_constructible<storage::Client>::value,
 static_assert(std::is_copy_assignable<storage::Client>::value,
               "storage::Client must be assignable");
 
+namespace {
+/// Opens @p file_name for reading, using direct I/O if requested and possible.
+StatusOr<std::unique_ptr<std::streambuf>> OpenFileSource(
+    std::string const& file_name, bool direct_io, std::size_t block_size) {
+  if (direct_io) {
+    auto buf = internal::OpenDirectFileForRead(file_name, block_size);
+    if (buf || buf.status().code() != StatusCode::kUnimplemented) return buf;
+  }
+  auto buf = absl::make_unique<std::filebuf>();
+  if (buf->open(file_name, std::ios::in | std::ios::binary) == nullptr) {
+    return Status(StatusCode::kNotFound, "filebuf::open()");
+  }
+  return std::unique_ptr<std::streambuf>(std::move(buf));
+}
+
+/// Opens @p file_name for writing, using direct I/O if requested and possible.
+StatusOr<std::unique_ptr<std::streambuf>> OpenFileDestination(
+    std::string const& file_name, bool direct_io, std::size_t block_size) {
+  if (direct_io) {
+    auto buf = internal::OpenDirectFileForWrite(file_name, block_size);
+    if (buf || buf.status().code() != StatusCode::kUnimplemented) return buf;
+  }
+  auto buf = absl::make_unique<std::filebuf>();
+  if (buf->open(file_name, std::ios::out | std::ios::trunc |
+                               std::ios::binary) == nullptr) {
+    return Status(StatusCode::kInvalidArgument, "filebuf::open()");
+  }
+  return std::unique_ptr<std::streambuf>(std::move(buf));
+}
+
+/// Creates an `ObjectReadStream` and starts the download.
+ObjectReadStream MakeObjectReadStream(
+    internal::ReadObjectRangeRequest const& request,
+    std::unique_ptr<internal::ObjectReadSource> source,
+    std::shared_ptr<BufferPool> buffer_pool) {
+  auto stream =
+      ObjectReadStream(absl::make_unique<internal::ObjectReadStreambuf>(
+          request, std::move(source),
+          request.GetOption<ReadFromOffset>().value_or(0),
+          std::move(buffer_pool)));
+  (void)stream.peek();
+#if !GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  // Without exceptions the streambuf cannot report errors, so we have to
+  // manually update the status bits.
+  if (!stream.status().ok()) {
+    stream.setstate(std::ios::badbit | std::ios::eofbit);
+  }
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  return stream;
+}
+
+}  // namespace
+
 std::shared_ptr<internal::RawClient> Client::CreateDefaultInternalClient(
     ClientOptions options) {
   return internal::CurlClient::Create(std::move(options));
@@ -48,7 +112,11 @@ StatusOr<Client> Client::CreateDefaultClient() {
 
 ObjectReadStream Client::ReadObjectImpl(
     internal::ReadObjectRangeRequest const& request) {
-  auto source = raw_client_->ReadObject(request);
+  auto const& cache = raw_client_->client_options().object_read_cache();
+  auto source = cache && internal::IsCacheableRead(request)
+                    ? internal::ReadObjectThroughCache(raw_client_, cache,
+                                                       request)
+                    : raw_client_->ReadObject(request);
   if (!source) {
     ObjectReadStream error_stream(
         absl::make_unique<internal::ObjectReadStreambuf>(
@@ -56,24 +124,34 @@ ObjectReadStream Client::ReadObjectImpl(
     error_stream.setstate(std::ios::badbit | std::ios::eofbit);
     return error_stream;
   }
-  auto stream =
-      ObjectReadStream(absl::make_unique<internal::ObjectReadStreambuf>(
-          request, *std::move(source),
-          request.GetOption<ReadFromOffset>().value_or(0)));
-  (void)stream.peek();
-#if !GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
-  // Without exceptions the streambuf cannot report errors, so we have to
-  // manually update the status bits.
-  if (!stream.status().ok()) {
-    stream.setstate(std::ios::badbit | std::ios::eofbit);
+  auto const& options = raw_client_->client_options();
+  if (request.GetOption<DecompressGzip>().value_or(false) &&
+      !request.RequiresRangeHeader()) {
+    // The decompressing source validates the checksums of the compressed
+    // data, the streambuf cannot validate the decompressed data.
+    auto unvalidated = request;
+    unvalidated.set_multiple_options(DisableCrc32cChecksum(true),
+                                     DisableMD5Hash(true));
+    return MakeObjectReadStream(
+        unvalidated,
+        absl::make_unique<internal::GzipObjectReadSource>(
+            *std::move(source), internal::CreateHashValidator(request),
+            options.download_buffer_size(), options.buffer_pool()),
+        options.buffer_pool());
   }
-#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
-  return stream;
+  return MakeObjectReadStream(request, *std::move(source),
+                              options.buffer_pool());
 }
 
 ObjectWriteStream Client::WriteObjectImpl(
     internal::ResumableUploadRequest const& request) {
-  auto session = raw_client_->CreateResumableSession(request);
+  auto session =
+      request.HasOption<GzipCompression>() &&
+              !request.HasOption<ContentEncoding>()
+          ? raw_client_->CreateResumableSession(
+                internal::ResumableUploadRequest(request).set_option(
+                    ContentEncoding("gzip")))
+          : raw_client_->CreateResumableSession(request);
   if (!session) {
     auto error = absl::make_unique<internal::ResumableUploadSessionError>(
         std::move(session).status());
@@ -86,9 +164,31 @@ ObjectWriteStream Client::WriteObjectImpl(
     error_stream.Close();
     return error_stream;
   }
-  return ObjectWriteStream(absl::make_unique<internal::ObjectWriteStreambuf>(
-      *std::move(session), raw_client_->client_options().upload_buffer_size(),
-      internal::CreateHashValidator(request)));
+  auto const& options = raw_client_->client_options();
+  std::unique_ptr<internal::ObjectWriteStreambuf> buf;
+  if (request.GetOption<PipelinedUploadBuffers>().value_or(0) != 0) {
+    buf = absl::make_unique<internal::PipelinedObjectWriteStreambuf>(
+        *std::move(session), options.upload_buffer_size(),
+        internal::CreateHashValidator(request),
+        request.GetOption<PipelinedUploadBuffers>().value(),
+        options.buffer_pool());
+  } else {
+    absl::optional<std::size_t> adaptive_max_buffer_size;
+    if (request.HasOption<AdaptiveUploadChunkSize>()) {
+      adaptive_max_buffer_size =
+          request.GetOption<AdaptiveUploadChunkSize>().value();
+    }
+    buf = absl::make_unique<internal::ObjectWriteStreambuf>(
+        *std::move(session), options.upload_buffer_size(),
+        internal::CreateHashValidator(request), adaptive_max_buffer_size,
+        options.buffer_pool());
+  }
+  if (request.HasOption<GzipCompression>()) {
+    buf = absl::make_unique<internal::GzipObjectWriteStreambuf>(
+        std::move(buf), request.GetOption<GzipCompression>().value(),
+        options.upload_buffer_size(), options.buffer_pool());
+  }
+  return ObjectWriteStream(std::move(buf));
 }
 
 bool Client::UseSimpleUpload(std::string const& file_name,
@@ -120,13 +220,29 @@ StatusOr<ObjectMetadata> Client::UploadFileSimple(
       request.GetOption<UploadLimit>().value_or(file_size - upload_offset),
       file_size - upload_offset);
 
-  std::ifstream is(file_name, std::ios::binary);
-  if (!is.is_open()) {
+  auto const direct_io = request.GetOption<UseDirectFileIO>().value_or(false);
+  // Upload directly from a memory-mapped region of the file, this avoids a
+  // (possibly very large) temporary buffer and a copy of the data. Direct I/O
+  // bypasses the page cache, so it cannot use a mapping. If the file cannot be
+  // mapped read it into a buffer, that also reports any errors.
+  if (!direct_io) {
+    auto mapped = internal::MapFileRegion(
+        file_name, upload_offset, static_cast<std::size_t>(upload_size));
+    if (mapped) {
+      request.set_contents(*std::move(mapped));
+      return raw_client_->InsertObjectMedia(request);
+    }
+  }
+
+  auto source = OpenFileSource(
+      file_name, direct_io, raw_client_->client_options().upload_buffer_size());
+  if (!source) {
     std::ostringstream os;
     os << __func__ << "(" << request << ", " << file_name
-       << "): cannot open upload file source";
-    return Status(StatusCode::kNotFound, std::move(os).str());
+       << "): cannot open upload file source - " << source.status().message();
+    return Status(source.status().code(), std::move(os).str());
   }
+  std::istream is(source->get());
 
   std::string payload(static_cast<std::size_t>(upload_size), char{});
   is.seekg(upload_offset, std::ios::beg);
@@ -138,7 +254,9 @@ StatusOr<ObjectMetadata> Client::UploadFileSimple(
        << ")";
     return Status(StatusCode::kInternal, std::move(os).str());
   }
-  is.close();
+  // Close the file before starting the upload.
+  is.rdbuf(nullptr);
+  source->reset();
   request.set_contents(std::move(payload));
 
   return raw_client_->InsertObjectMedia(request);
@@ -181,13 +299,16 @@ integrity checks using the DisableMD5Hash() and DisableCrc32cChecksum() options.
         file_size - upload_offset);
     request.set_option(UploadContentLength(upload_size));
   }
-  std::ifstream source(file_name, std::ios::binary);
-  if (!source.is_open()) {
+  auto buf = OpenFileSource(
+      file_name, request.GetOption<UseDirectFileIO>().value_or(false),
+      raw_client_->client_options().upload_buffer_size());
+  if (!buf) {
     std::ostringstream os;
     os << __func__ << "(" << request << ", " << file_name
-       << "): cannot open upload file source";
-    return Status(StatusCode::kNotFound, std::move(os).str());
+       << "): cannot open upload file source - " << buf.status().message();
+    return Status(buf.status().code(), std::move(os).str());
   }
+  std::istream source(buf->get());
   // We set its offset before passing it to `UploadStreamResumable` so we don't
   // need to compute `UploadFromOffset` again.
   source.seekg(upload_offset, std::ios::beg);
@@ -221,6 +342,12 @@ StatusOr<ObjectMetadata> Client::UploadStreamResumable(
   // GCS requires chunks to be a multiple of 256KiB.
   auto chunk_size = internal::UploadChunkRequest::RoundUpToQuantum(
       raw_client()->client_options().upload_buffer_size());
+  absl::optional<internal::AdaptiveChunkSize> adaptive_chunk_size;
+  if (request.HasOption<AdaptiveUploadChunkSize>()) {
+    adaptive_chunk_size.emplace(
+        chunk_size, request.GetOption<AdaptiveUploadChunkSize>().value());
+    chunk_size = adaptive_chunk_size->chunk_size();
+  }
 
   StatusOr<internal::ResumableUploadResponse> upload_response(
       internal::ResumableUploadResponse{});
@@ -228,7 +355,8 @@ StatusOr<ObjectMetadata> Client::UploadStreamResumable(
   // `UploadLimit` and the retry policy has not been exhausted.
   bool reach_upload_limit = false;
   internal::ConstBufferSequence buffers(1);
-  std::vector<char> buffer(chunk_size);
+  auto const& pool = raw_client()->client_options().buffer_pool();
+  internal::PooledBuffer buffer(pool, chunk_size);
   while (!source.eof() && upload_response &&
          !upload_response->payload.has_value() && !reach_upload_limit) {
     // Read a chunk of data from the source file.
@@ -243,6 +371,8 @@ StatusOr<ObjectMetadata> Client::UploadStreamResumable(
     auto source_size = session->next_expected_byte() + gcount;
     auto expected = source_size;
     buffers[0] = internal::ConstBuffer{buffer.data(), gcount};
+    auto const retry_count = session->retry_count();
+    auto const start = std::chrono::steady_clock::now();
     if (final_chunk) {
       upload_response = session->UploadFinalChunk(buffers, source_size);
     } else {
@@ -264,6 +394,18 @@ StatusOr<ObjectMetadata> Client::UploadStreamResumable(
 
     // We only update `server_size` when uploading is successful.
     server_size = expected;
+
+    if (adaptive_chunk_size && !final_chunk) {
+      adaptive_chunk_size->OnChunkUploaded(
+          gcount,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - start),
+          session->retry_count() - retry_count);
+      chunk_size = adaptive_chunk_size->chunk_size();
+      if (chunk_size != buffer.size()) {
+        buffer = internal::PooledBuffer(pool, chunk_size);
+      }
+    }
   }
 
   if (!upload_response) {
@@ -273,6 +415,24 @@ StatusOr<ObjectMetadata> Client::UploadStreamResumable(
   return *std::move(upload_response->payload);
 }
 
+StatusOr<CompactObjectList> Client::ListObjectsCompactImpl(
+    internal::ListObjectsRequest request) {
+  if (!request.HasOption<Fields>()) {
+    request.set_option(Fields(
+        "items(name,size,generation,crc32c,timeCreated,updated),prefixes,"
+        "nextPageToken"));
+  }
+  CompactObjectList result;
+  for (;;) {
+    auto response = raw_client_->ListObjectsCompact(request);
+    if (!response) return std::move(response).status();
+    result.Append(response->items);
+    if (response->next_page_token.empty()) break;
+    request.set_page_token(std::move(response->next_page_token));
+  }
+  return result;
+}
+
 Status Client::DownloadFileImpl(internal::ReadObjectRangeRequest const& request,
                                 std::string const& file_name) {
   auto report_error = [&request, file_name](char const* func, char const* what,
@@ -290,23 +450,26 @@ Status Client::DownloadFileImpl(internal::ReadObjectRangeRequest const& request,
   }
 
   // Open the destination file, and immediate raise an exception on failure.
-  std::ofstream os(file_name, std::ios::binary);
-  if (!os.is_open()) {
-    return report_error(
-        __func__, "cannot open download destination file",
-        Status(StatusCode::kInvalidArgument, "ofstream::open()"));
+  auto destination = OpenFileDestination(
+      file_name, request.GetOption<UseDirectFileIO>().value_or(false),
+      raw_client_->client_options().download_buffer_size());
+  if (!destination) {
+    return report_error(__func__, "cannot open download destination file",
+                        destination.status());
   }
+  std::ostream os(destination->get());
 
-  std::string buffer;
-  buffer.resize(raw_client_->client_options().download_buffer_size(), '\0');
+  internal::PooledBuffer buffer(
+      raw_client_->client_options().buffer_pool(),
+      raw_client_->client_options().download_buffer_size());
   do {
-    stream.read(&buffer[0], buffer.size());
+    stream.read(buffer.data(), buffer.size());
     os.write(buffer.data(), stream.gcount());
   } while (os.good() && stream.good());
-  os.close();
+  os.flush();
   if (!os.good()) {
     return report_error(__func__, "cannot close download destination file",
-                        Status(StatusCode::kUnknown, "ofstream::close()"));
+                        Status(StatusCode::kUnknown, "ostream::flush()"));
   }
   if (!stream.status().ok()) {
     return report_error(__func__, "error reading download source object",
@@ -399,6 +562,20 @@ StatusOr<std::string> Client::SignUrlV4(internal::V4SignUrlRequest request) {
   return std::move(os).str();
 }
 
+std::vector<StatusOr<std::string>> Client::SignUrlsV4(
+    std::vector<internal::V4SignUrlRequest> requests, std::size_t max_threads) {
+  if (max_threads == 0) {
+    max_threads = (std::max)(1U, std::thread::hardware_concurrency());
+  }
+  std::vector<StatusOr<std::string>> result(
+      requests.size(), Status(StatusCode::kUnknown, "URL not signed"));
+  internal::RunConcurrently(requests.size(), max_threads,
+                            [&](std::size_t i) {
+                              result[i] = SignUrlV4(std::move(requests[i]));
+                            });
+  return result;
+}
+
 StatusOr<PolicyDocumentResult> Client::SignPolicyDocument(
     internal::PolicyDocumentRequest const& request) {
   SigningAccount const& signing_account = request.signing_account();
@@ -492,6 +669,56 @@ Status ScopedDeleter::ExecuteDelete() {
   return Status();
 }
 
+void RunConcurrently(std::size_t count, std::size_t max_threads,
+                     std::function<void(std::size_t)> const& work) {
+  if (count == 0) return;
+  if (count == 1 || max_threads <= 1) {
+    for (std::size_t i = 0; i != count; ++i) work(i);
+    return;
+  }
+  std::atomic<std::size_t> next{0};
+  auto worker = [&next, count, &work] {
+    for (auto i = next++; i < count; i = next++) work(i);
+  };
+  std::vector<std::thread> threads((std::min)(count, max_threads) - 1);
+  for (auto& t : threads) t = std::thread(worker);
+  worker();
+  for (auto& t : threads) t.join();
+}
+
+Status BatchDeleter::Add(DeleteObjectRequest request) {
+  if (!batch_supported_) return client_->DeleteObject(request).status();
+  batch_.Add(std::move(request));
+  if (!batch_.full()) return Status();
+  return Flush();
+}
+
+Status BatchDeleter::Flush() {
+  BatchRequest batch;
+  std::swap(batch, batch_);
+  if (batch.empty()) return Status();
+  auto response = client_->ExecuteBatch(batch);
+  if (!response && response.status().code() == StatusCode::kUnimplemented) {
+    batch_supported_ = false;
+    return DeleteOneByOne(batch);
+  }
+  if (!response) return std::move(response).status();
+  for (auto const& r : response->results) {
+    auto status = BatchOperationStatus(r);
+    if (!status.ok()) return status;
+  }
+  return Status();
+}
+
+Status BatchDeleter::DeleteOneByOne(BatchRequest const& batch) {
+  for (auto const& op : batch.operations()) {
+    auto status =
+        client_->DeleteObject(absl::get<DeleteObjectRequest>(op)).status();
+    if (!status.ok()) return status;
+  }
+  return Status();
+}
+
 }  // namespace internal
 
 }  // namespace STORAGE_CLIENT_NS
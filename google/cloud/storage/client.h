@@ -15,8 +15,12 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CLIENT_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CLIENT_H
 
+#include "google/cloud/storage/compact_object_list.h"
 #include "google/cloud/storage/hmac_key_metadata.h"
+#include "google/cloud/storage/internal/coalescing_client.h"
 #include "google/cloud/storage/internal/logging_client.h"
+#include "google/cloud/storage/internal/metadata_cache_client.h"
+#include "google/cloud/storage/internal/metrics_client.h"
 #include "google/cloud/storage/internal/parameter_pack_validation.h"
 #include "google/cloud/storage/internal/policy_document_request.h"
 #include "google/cloud/storage/internal/retry_client.h"
@@ -25,6 +29,7 @@
 #include "google/cloud/storage/list_buckets_reader.h"
 #include "google/cloud/storage/list_hmac_keys_reader.h"
 #include "google/cloud/storage/list_objects_and_prefixes_reader.h"
+#include "google/cloud/storage/list_objects_options.h"
 #include "google/cloud/storage/list_objects_reader.h"
 #include "google/cloud/storage/notification_event_type.h"
 #include "google/cloud/storage/notification_payload_format.h"
@@ -35,6 +40,7 @@
 #include "google/cloud/storage/upload_options.h"
 #include "google/cloud/storage/version.h"
 #include "google/cloud/internal/throw_delegate.h"
+#include "google/cloud/internal/tuple.h"
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
 #include "absl/meta/type_traits.h"
@@ -183,6 +189,9 @@ class ResumableParallelUploadState;
  *
  * @see `AlwaysRetryIdempotencyPolicy` and `StrictIdempotencyPolicy` for
  * alternative idempotency policies.
+ *
+ * @see `FixedDelayHedgedReadPolicy` and `PercentileHedgedReadPolicy` to
+ * reduce the tail latency of downloads.
  */
 class Client {
  public:
@@ -251,6 +260,21 @@ class Client {
     return raw_client_;
   }
 
+  /**
+   * Establishes the connections in the connection pool.
+   *
+   * By default the client creates connections on demand, so the first requests
+   * pay the cost of the DNS resolution and the TCP and TLS handshakes. Short
+   * lived applications can call this function to establish up to
+   * `ClientOptions::connection_pool_size()` connections in parallel, before
+   * making any requests.
+   *
+   * This is an optimization, any connections that could not be established are
+   * created on demand by future requests. The function returns the first error
+   * found, if any, and it does not retry failures.
+   */
+  Status WarmUpConnectionPool() { return raw_client_->WarmUpConnectionPool(); }
+
   //@{
   /**
    * @name Bucket operations.
@@ -996,7 +1020,7 @@ class Client {
    *     Valid types for this operation include
    *     `IfMetagenerationMatch`, `IfMetagenerationNotMatch`, `UserProject`,
    *     `Projection`, `Prefix`, `Delimiter`, `IncludeTrailingDelimiter`,
-   *     `StartOffset`, `EndOffset`, and `Versions`.
+   *     `StartOffset`, `EndOffset`, `PrefetchNextPage`, and `Versions`.
    *
    * @par Idempotency
    * This is a read-only operation and is always idempotent.
@@ -1010,12 +1034,18 @@ class Client {
     internal::ListObjectsRequest request(bucket_name);
     request.set_multiple_options(std::forward<Options>(options)...);
     auto client = raw_client_;
+    auto loader = [client](internal::ListObjectsRequest const& r) {
+      return client->ListObjects(r);
+    };
+    auto extractor = [](internal::ListObjectsResponse r) {
+      return std::move(r.items);
+    };
+    if (request.GetOption<PrefetchNextPage>().value_or(false)) {
+      return google::cloud::internal::MakePrefetchingPaginationRange<
+          ListObjectsReader>(request, std::move(loader), std::move(extractor));
+    }
     return google::cloud::internal::MakePaginationRange<ListObjectsReader>(
-        request,
-        [client](internal::ListObjectsRequest const& r) {
-          return client->ListObjects(r);
-        },
-        [](internal::ListObjectsResponse r) { return std::move(r.items); });
+        request, std::move(loader), std::move(extractor));
   }
 
   /**
@@ -1026,7 +1056,7 @@ class Client {
    *     Valid types for this operation include
    *     `IfMetagenerationMatch`, `IfMetagenerationNotMatch`, `UserProject`,
    *     `Projection`, `Prefix`, `Delimiter`, `IncludeTrailingDelimiter`,
-   *     `StartOffset`, `EndOffset`, and `Versions`.
+   *     `StartOffset`, `EndOffset`, `PrefetchNextPage`, and `Versions`.
    *
    * @par Idempotency
    * This is a read-only operation and is always idempotent.
@@ -1040,23 +1070,59 @@ class Client {
     internal::ListObjectsRequest request(bucket_name);
     request.set_multiple_options(std::forward<Options>(options)...);
     auto client = raw_client_;
+    auto loader = [client](internal::ListObjectsRequest const& r) {
+      return client->ListObjects(r);
+    };
+    auto extractor = [](internal::ListObjectsResponse r) {
+      std::vector<ObjectOrPrefix> result;
+      for (auto& item : r.items) {
+        result.emplace_back(std::move(item));
+      }
+      for (auto& prefix : r.prefixes) {
+        result.emplace_back(std::move(prefix));
+      }
+      internal::SortObjectsAndPrefixes(result);
+      return result;
+    };
+    if (request.GetOption<PrefetchNextPage>().value_or(false)) {
+      return google::cloud::internal::MakePrefetchingPaginationRange<
+          ListObjectsAndPrefixesReader>(request, std::move(loader),
+                                        std::move(extractor));
+    }
     return google::cloud::internal::MakePaginationRange<
-        ListObjectsAndPrefixesReader>(
-        request,
-        [client](internal::ListObjectsRequest const& r) {
-          return client->ListObjects(r);
-        },
-        [](internal::ListObjectsResponse r) {
-          std::vector<ObjectOrPrefix> result;
-          for (auto& item : r.items) {
-            result.emplace_back(std::move(item));
-          }
-          for (auto& prefix : r.prefixes) {
-            result.emplace_back(std::move(prefix));
-          }
-          internal::SortObjectsAndPrefixes(result);
-          return result;
-        });
+        ListObjectsAndPrefixesReader>(request, std::move(loader),
+                                      std::move(extractor));
+  }
+
+  /**
+   * Lists all the objects in a bucket, using a compact representation.
+   *
+   * This function reads all the pages in the listing, and returns the results
+   * as a single `CompactObjectList`. The list keeps only the name, size,
+   * generation, CRC32C checksum, and timestamps of each object, using about 48
+   * bytes plus the length of the name, so applications can keep the listing
+   * for buckets with millions of objects in memory.
+   *
+   * Unless the application provides a `Fields` option, the request asks the
+   * service for only these fields, which also reduces the size of the
+   * responses.
+   *
+   * @param bucket_name the name of the bucket to list.
+   * @param options a list of optional query parameters and/or request headers.
+   *     Valid types for this operation include
+   *     `IfMetagenerationMatch`, `IfMetagenerationNotMatch`, `UserProject`,
+   *     `Prefix`, `Delimiter`, `IncludeTrailingDelimiter`, `StartOffset`,
+   *     `EndOffset`, `MaxResults`, and `Versions`.
+   *
+   * @par Idempotency
+   * This is a read-only operation and is always idempotent.
+   */
+  template <typename... Options>
+  StatusOr<CompactObjectList> ListObjectsCompact(std::string const& bucket_name,
+                                                 Options&&... options) {
+    internal::ListObjectsRequest request(bucket_name);
+    request.set_multiple_options(std::forward<Options>(options)...);
+    return ListObjectsCompactImpl(std::move(request));
   }
 
   /**
@@ -1076,8 +1142,8 @@ class Client {
    *     Valid types for this operation include `DisableCrc32cChecksum`,
    *     `DisableMD5Hash`, `IfGenerationMatch`, `EncryptionKey`, `Generation`,
    *     `IfGenerationMatch`, `IfGenerationNotMatch`, `IfMetagenerationMatch`,
-   *     `IfMetagenerationNotMatch`, `ReadFromOffset`, `ReadRange`, `ReadLast`
-   *     and `UserProject`.
+   *     `IfMetagenerationNotMatch`, `ParallelReadStreams`, `ReadFromOffset`,
+   *     `ReadRange`, `ReadLast`, `UseBackgroundHashing`, and `UserProject`.
    *
    * @par Idempotency
    * This is a read-only operation and is always idempotent.
@@ -1167,13 +1233,14 @@ class Client {
    * @param bucket_name the name of the bucket that contains the object.
    * @param object_name the name of the object to be read.
    * @param options a list of optional query parameters and/or request headers.
-   *   Valid types for this operation include `ContentEncoding`, `ContentType`,
-   *   `Crc32cChecksumValue`, `DisableCrc32cChecksum`, `DisableMD5Hash`,
-   *   `EncryptionKey`, `IfGenerationMatch`, `IfGenerationNotMatch`,
-   *   `IfMetagenerationMatch`, `IfMetagenerationNotMatch`, `KmsKeyName`,
-   *   `MD5HashValue`, `PredefinedAcl`, `Projection`,
-   *   `UseResumableUploadSession`, `UserProject`, `WithObjectMetadata` and
-   *   `UploadContentLength`.
+   *   Valid types for this operation include `AdaptiveUploadChunkSize`,
+   *   `ContentEncoding`, `ContentType`, `Crc32cChecksumValue`,
+   *   `DisableCrc32cChecksum`, `DisableMD5Hash`, `EncryptionKey`,
+   *   `IfGenerationMatch`, `IfGenerationNotMatch`, `IfMetagenerationMatch`,
+   *   `IfMetagenerationNotMatch`, `KmsKeyName`, `MD5HashValue`,
+   *   `PipelinedUploadBuffers`, `PredefinedAcl`, `Projection`,
+   *   `UseBackgroundHashing`, `UseResumableUploadSession`, `UserProject`,
+   *   `WithObjectMetadata` and `UploadContentLength`.
    *
    * @par Idempotency
    * This operation is only idempotent if restricted by pre-conditions, in this
@@ -1220,11 +1287,12 @@ class Client {
    * @param bucket_name the name of the bucket that contains the object.
    * @param object_name the name of the object to be read.
    * @param options a list of optional query parameters and/or request headers.
-   *   Valid types for this operation include `ContentEncoding`, `ContentType`,
-   *   `Crc32cChecksumValue`, `DisableCrc32cChecksum`, `DisableMD5Hash`,
-   *   `EncryptionKey`, `IfGenerationMatch`, `IfGenerationNotMatch`,
-   *   `IfMetagenerationMatch`, `IfMetagenerationNotMatch`, `KmsKeyName`,
-   *   `MD5HashValue`, `PredefinedAcl`, `Projection`, `UserProject`,
+   *   Valid types for this operation include `AdaptiveUploadChunkSize`,
+   *   `ContentEncoding`, `ContentType`, `Crc32cChecksumValue`,
+   *   `DisableCrc32cChecksum`, `DisableMD5Hash`, `EncryptionKey`,
+   *   `IfGenerationMatch`, `IfGenerationNotMatch`, `IfMetagenerationMatch`,
+   *   `IfMetagenerationNotMatch`, `KmsKeyName`, `MD5HashValue`,
+   *   `PredefinedAcl`, `Projection`, `UseDirectFileIO`, `UserProject`,
    *   `UploadFromOffset`, `UploadLimit` and `WithObjectMetadata`.
    *
    * @par Idempotency
@@ -1284,7 +1352,7 @@ class Client {
    *   Valid types for this operation include `IfGenerationMatch`,
    *   `IfGenerationNotMatch`, `IfMetagenerationMatch`,
    *   `IfMetagenerationNotMatch`, `Generation`, `ReadFromOffset`, `ReadRange`,
-   *   and `UserProject`.
+   *   `UseDirectFileIO`, and `UserProject`.
    *
    * @par Idempotency
    * This is a read-only operation and is always idempotent.
@@ -2868,6 +2936,44 @@ class Client {
   }
   //@}
 
+  /**
+   * Create many V4 signed URLs with the same options.
+   *
+   * This function is equivalent to calling `CreateV4SignedUrl()` for each
+   * element in @p items, but it signs the URLs using multiple threads. When
+   * the client credentials contain a service account key, the key is parsed
+   * only once and all the URLs are signed locally. Otherwise, the function
+   * sends concurrent requests to the IAM SignBlob API.
+   *
+   * @param items the verb, bucket, and object for each URL.
+   * @param options a list of optional parameters for the signed URLs, these
+   *     apply to all the URLs. In addition to the options valid in
+   *     `CreateV4SignedUrl()`, this function accepts `MaxSigningThreads`.
+   *
+   * @return the signed URL (or the error) for each element of @p items, in the
+   *     same order.
+   */
+  template <typename... Options>
+  std::vector<StatusOr<std::string>> CreateV4SignedUrls(
+      std::vector<SignedUrlItem> const& items, Options&&... options) {
+    auto const max_threads =
+        internal::ExtractFirstOccurenceOfType<MaxSigningThreads>(
+            std::tie(options...))
+            .value_or(MaxSigningThreads(0));
+    auto request_options = internal::StaticTupleFilter<
+        internal::NotAmong<MaxSigningThreads>::TPred>(std::tie(options...));
+    std::vector<internal::V4SignUrlRequest> requests;
+    requests.reserve(items.size());
+    for (auto const& item : items) {
+      requests.emplace_back(item.verb, item.bucket_name, item.object_name);
+      google::cloud::internal::apply(
+          internal::V4SignUrlRequestSetOptions{requests.back()},
+          request_options);
+    }
+    return SignUrlsV4(std::move(requests),
+                      max_threads.has_value() ? max_threads.value() : 0);
+  }
+
   /**
    * Create a signed policy document.
    *
@@ -3114,14 +3220,46 @@ class Client {
     if (client->client_options().enable_raw_client_tracing()) {
       client = std::make_shared<internal::LoggingClient>(std::move(client));
     }
-    auto retry = std::make_shared<internal::RetryClient>(
-        std::move(client), std::forward<Policies>(policies)...);
-    return retry;
+    auto const& options = client->client_options();
+    auto const cache_entries = options.metadata_cache_max_entries();
+    auto const cache_ttl = options.metadata_cache_ttl();
+    auto cache_invalidator = options.metadata_cache_invalidator();
+    auto const coalescing = options.enable_request_coalescing();
+    auto metrics = options.client_metrics();
+    auto rate_limiter = options.rate_limiter();
+    // The metrics are recorded twice: below the retry loop to count each
+    // attempt, and above it to measure the latency seen by the application.
+    if (metrics) {
+      client = std::make_shared<internal::MetricsClient>(
+          std::move(client), metrics, internal::MetricsClient::Mode::kAttempts);
+    }
+    std::shared_ptr<internal::RawClient> retry =
+        std::make_shared<internal::RetryClient>(
+            std::move(client), std::forward<Policies>(policies)...,
+            std::move(rate_limiter));
+    // Coalesced requests share a single retry loop, but each caller is
+    // measured as a separate operation.
+    if (coalescing) {
+      retry = std::make_shared<internal::CoalescingClient>(std::move(retry));
+    }
+    if (metrics) {
+      retry = std::make_shared<internal::MetricsClient>(
+          std::move(retry), std::move(metrics),
+          internal::MetricsClient::Mode::kOperations);
+    }
+    if (cache_entries == 0) return retry;
+    // Cache hits should not go through the retry loop.
+    return std::make_shared<internal::MetadataCacheClient>(
+        std::move(retry), cache_entries, cache_ttl,
+        std::move(cache_invalidator));
   }
 
   ObjectReadStream ReadObjectImpl(
       internal::ReadObjectRangeRequest const& request);
 
+  StatusOr<CompactObjectList> ListObjectsCompactImpl(
+      internal::ListObjectsRequest request);
+
   ObjectWriteStream WriteObjectImpl(
       internal::ResumableUploadRequest const& request);
 
@@ -3190,6 +3328,9 @@ class Client {
 
   StatusOr<std::string> SignUrlV2(internal::V2SignUrlRequest const& request);
   StatusOr<std::string> SignUrlV4(internal::V4SignUrlRequest request);
+  std::vector<StatusOr<std::string>> SignUrlsV4(
+      std::vector<internal::V4SignUrlRequest> requests,
+      std::size_t max_threads);
 
   StatusOr<PolicyDocumentResult> SignPolicyDocument(
       internal::PolicyDocumentRequest const& request);
@@ -3235,6 +3376,42 @@ struct DeleteApplyHelper {
   std::string object_name;
 };
 
+// Just a wrapper to allow for using in `google::cloud::internal::apply`.
+struct DeleteObjectRequestApplyHelper {
+  template <typename... Options>
+  void operator()(Options&&... options) const {
+    request.set_multiple_options(std::forward<Options>(options)...);
+  }
+
+  DeleteObjectRequest& request;
+};
+
+/**
+ * Deletes objects using batch requests, when the client supports them.
+ *
+ * The deletions are buffered until there are enough operations to fill a
+ * batch request. If the client does not support batch requests the objects
+ * are deleted one at a time.
+ */
+class BatchDeleter {
+ public:
+  explicit BatchDeleter(std::shared_ptr<RawClient> client)
+      : client_(std::move(client)) {}
+
+  /// Delete the object in @p request, possibly deferring the deletion.
+  Status Add(DeleteObjectRequest request);
+
+  /// Delete any deferred objects, return the first error, if any.
+  Status Flush();
+
+ private:
+  Status DeleteOneByOne(BatchRequest const& batch);
+
+  std::shared_ptr<RawClient> client_;
+  BatchRequest batch_;
+  bool batch_supported_ = true;
+};
+
 // Just a wrapper to allow for using in `google::cloud::internal::apply`.
 struct InsertObjectApplyHelper {
   template <typename... Options>
@@ -3288,6 +3465,9 @@ StatusOr<ObjectMetadata> LockPrefix(Client& client,
  * @param options a list of optional query parameters and/or request headers.
  *     Valid types for this operation include `QuotaUser`, `UserIp`,
  *     `UserProject` and `Versions`.
+ *
+ * When the client supports it, the objects are deleted using batch requests,
+ * each batch request deletes up to 100 objects.
  */
 template <typename... Options>
 Status DeleteByPrefix(Client& client, std::string const& bucket_name,
@@ -3304,6 +3484,7 @@ Status DeleteByPrefix(Client& client, std::string const& bucket_name,
                   all_options))>::value == 0,
       "This functions accepts only options of type QuotaUser, UserIp, "
       "UserProject or Versions.");
+  internal::BatchDeleter deleter(client.raw_client());
   for (auto const& object :
        client.ListObjects(bucket_name, Projection::NoAcl(), Prefix(prefix),
                           std::forward<Options>(options)...)) {
@@ -3311,17 +3492,19 @@ Status DeleteByPrefix(Client& client, std::string const& bucket_name,
       return object.status();
     }
 
-    auto deletion_status = google::cloud::internal::apply(
-        internal::DeleteApplyHelper{client, bucket_name, object->name()},
+    internal::DeleteObjectRequest request(bucket_name, object->name());
+    google::cloud::internal::apply(
+        internal::DeleteObjectRequestApplyHelper{request},
         std::tuple_cat(
             std::make_tuple(IfGenerationMatch(object->generation())),
             StaticTupleFilter<NotAmong<Versions>::TPred>(all_options)));
 
+    auto deletion_status = deleter.Add(std::move(request));
     if (!deletion_status.ok()) {
       return deletion_status;
     }
   }
-  return Status();
+  return deleter.Flush();
 }
 
 namespace internal {
@@ -3369,6 +3552,16 @@ class ScopedDeleter {
   std::vector<std::pair<std::string, std::int64_t>> object_list_;
 };
 
+/**
+ * Call @p work for each value in `[0, count)`, using up to @p max_threads
+ * threads.
+ *
+ * The function returns once all the calls complete. If `count` is 1 the call
+ * runs on the calling thread.
+ */
+void RunConcurrently(std::size_t count, std::size_t max_threads,
+                     std::function<void(std::size_t)> const& work);
+
 }  // namespace internal
 
 /**
@@ -3424,6 +3617,7 @@ StatusOr<ObjectMetadata> ComposeMany(
   using internal::NotAmong;
   using internal::StaticTupleFilter;
   std::size_t const max_num_objects = 32;
+  std::size_t const max_concurrent_compositions = 32;
 
   if (source_objects.empty()) {
     return Status(StatusCode::kInvalidArgument,
@@ -3478,8 +3672,8 @@ StatusOr<ObjectMetadata> ComposeMany(
   };
 
   auto composer = [&](std::vector<ComposeSourceObject> compose_range,
-                      bool is_final) -> StatusOr<ObjectMetadata> {
-    if (is_final) {
+                      std::string const& tmp_name) -> StatusOr<ObjectMetadata> {
+    if (tmp_name.empty()) {
       return google::cloud::internal::apply(
           internal::ComposeApplyHelper{client, bucket_name,
                                        std::move(compose_range),
@@ -3488,8 +3682,7 @@ StatusOr<ObjectMetadata> ComposeMany(
     }
     return google::cloud::internal::apply(
         internal::ComposeApplyHelper{client, bucket_name,
-                                     std::move(compose_range),
-                                     tmpobject_name_gen()},
+                                     std::move(compose_range), tmp_name},
         StaticTupleFilter<
             NotAmong<IfGenerationMatch, IfMetagenerationMatch>::TPred>(
             all_options));
@@ -3497,27 +3690,43 @@ StatusOr<ObjectMetadata> ComposeMany(
 
   auto reduce = [&](std::vector<ComposeSourceObject> source_objects)
       -> StatusOr<std::vector<ObjectMetadata>> {
-    std::vector<ObjectMetadata> objects;
+    if (source_objects.size() <= max_num_objects) {
+      auto object = composer(std::move(source_objects), std::string{});
+      if (!object) return std::move(object).status();
+      return std::vector<ObjectMetadata>{*std::move(object)};
+    }
+    std::vector<std::vector<ComposeSourceObject>> ranges;
+    std::vector<std::string> tmp_names;
     for (auto range_begin = source_objects.begin();
          range_begin != source_objects.end();) {
       std::size_t range_size = std::min<std::size_t>(
           std::distance(range_begin, source_objects.end()), max_num_objects);
       auto range_end = std::next(range_begin, range_size);
-      std::vector<ComposeSourceObject> compose_range(range_size);
-      std::move(range_begin, range_end, compose_range.begin());
-
-      bool const is_final_composition =
-          source_objects.size() <= max_num_objects;
-      auto object = composer(std::move(compose_range), is_final_composition);
+      ranges.emplace_back(std::make_move_iterator(range_begin),
+                          std::make_move_iterator(range_end));
+      tmp_names.push_back(tmpobject_name_gen());
+      range_begin = range_end;
+    }
+    // The compositions in each level of the tree are independent, run them
+    // concurrently.
+    std::vector<StatusOr<ObjectMetadata>> results(ranges.size());
+    internal::RunConcurrently(
+        ranges.size(), max_concurrent_compositions, [&](std::size_t i) {
+          results[i] = composer(std::move(ranges[i]), tmp_names[i]);
+        });
+    std::vector<ObjectMetadata> objects;
+    Status status;
+    for (auto& object : results) {
       if (!object) {
-        return std::move(object).status();
+        // Preserve the first error, but keep the other objects to clean them
+        // up.
+        if (status.ok()) status = std::move(object).status();
+        continue;
       }
+      deleter.Add(*object);
       objects.push_back(*std::move(object));
-      if (!is_final_composition) {
-        deleter.Add(objects.back());
-      }
-      range_begin = range_end;
     }
+    if (!status.ok()) return status;
     return objects;
   };
 
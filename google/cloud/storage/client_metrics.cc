@@ -0,0 +1,162 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/client_metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+// Each power of two is split into `kSubBuckets` buckets.
+int constexpr kSubBucketBits = 3;
+std::uint64_t constexpr kSubBuckets = 1 << kSubBucketBits;
+// Values up to 2^kMaxExponent microseconds (about 12 days) are recorded in
+// separate buckets, larger values are recorded in the last bucket.
+int constexpr kMaxExponent = 40;
+std::size_t constexpr kBucketCount =
+    kSubBuckets * (kMaxExponent - kSubBucketBits + 2);
+
+int Log2(std::uint64_t value) {
+  int r = 0;
+  while (value >>= 1) ++r;
+  return r;
+}
+
+std::size_t BucketIndex(std::uint64_t value) {
+  if (value < 2 * kSubBuckets) return static_cast<std::size_t>(value);
+  auto const exponent = Log2(value);
+  if (exponent > kMaxExponent) return kBucketCount - 1;
+  auto const shift = exponent - kSubBucketBits;
+  auto const sub_bucket = (value >> shift) - kSubBuckets;
+  return static_cast<std::size_t>(kSubBuckets * (shift + 1) + sub_bucket);
+}
+
+std::uint64_t BucketUpperBound(std::size_t index) {
+  if (index < 2 * kSubBuckets) return index;
+  auto const shift = index / kSubBuckets - 1;
+  auto const sub_bucket = index % kSubBuckets;
+  return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() : counts_(kBucketCount) {}
+
+void LatencyHistogram::Record(std::chrono::microseconds value) {
+  auto const v = static_cast<std::uint64_t>((std::max)(
+      value, std::chrono::microseconds(0)).count());
+  ++counts_[BucketIndex(v)];
+  min_ = count_ == 0 ? v : (std::min)(min_, v);
+  max_ = count_ == 0 ? v : (std::max)(max_, v);
+  sum_ += v;
+  ++count_;
+}
+
+void LatencyHistogram::Merge(LatencyHistogram const& other) {
+  if (other.count_ == 0) return;
+  for (std::size_t i = 0; i != counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  min_ = count_ == 0 ? other.min_ : (std::min)(min_, other.min_);
+  max_ = count_ == 0 ? other.max_ : (std::max)(max_, other.max_);
+  sum_ += other.sum_;
+  count_ += other.count_;
+}
+
+std::chrono::microseconds LatencyHistogram::min() const {
+  return std::chrono::microseconds(min_);
+}
+
+std::chrono::microseconds LatencyHistogram::max() const {
+  return std::chrono::microseconds(max_);
+}
+
+std::chrono::microseconds LatencyHistogram::mean() const {
+  if (count_ == 0) return std::chrono::microseconds(0);
+  return std::chrono::microseconds(sum_ / count_);
+}
+
+std::chrono::microseconds LatencyHistogram::Percentile(
+    double percentile) const {
+  if (count_ == 0) return std::chrono::microseconds(0);
+  auto const p = (std::min)(100.0, (std::max)(0.0, percentile));
+  auto const rank = (std::max<std::uint64_t>)(
+      1, static_cast<std::uint64_t>(
+             std::ceil(p / 100.0 * static_cast<double>(count_))));
+  std::uint64_t cumulative = 0;
+  for (std::size_t i = 0; i != counts_.size(); ++i) {
+    cumulative += counts_[i];
+    if (cumulative >= rank) {
+      return std::chrono::microseconds(
+          (std::min)(max_, (std::max)(min_, BucketUpperBound(i))));
+    }
+  }
+  return max();
+}
+
+std::vector<LatencyHistogram::Bucket> LatencyHistogram::buckets() const {
+  std::vector<Bucket> result;
+  for (std::size_t i = 0; i != counts_.size(); ++i) {
+    if (counts_[i] == 0) continue;
+    result.push_back(
+        Bucket{std::chrono::microseconds(BucketUpperBound(i)), counts_[i]});
+  }
+  return result;
+}
+
+ClientMetricsSnapshot ClientMetrics::Snapshot() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return metrics_;
+}
+
+ClientMetricsSnapshot ClientMetrics::SnapshotAndReset() {
+  ClientMetricsSnapshot result;
+  std::lock_guard<std::mutex> lk(mu_);
+  result.swap(metrics_);
+  return result;
+}
+
+void ClientMetrics::RecordOperation(char const* operation,
+                                    std::chrono::microseconds latency, bool ok,
+                                    std::uint64_t bytes_sent) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& m = metrics_[operation];
+  ++m.count;
+  if (!ok) ++m.errors;
+  m.bytes_sent += bytes_sent;
+  m.latency.Record(latency);
+}
+
+void ClientMetrics::RecordAttempt(char const* operation) {
+  std::lock_guard<std::mutex> lk(mu_);
+  ++metrics_[operation].attempts;
+}
+
+void ClientMetrics::RecordDownload(char const* operation,
+                                   std::chrono::microseconds time_to_first_byte,
+                                   std::uint64_t bytes_received) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& m = metrics_[operation];
+  m.bytes_received += bytes_received;
+  m.time_to_first_byte.Record(time_to_first_byte);
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,153 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CLIENT_METRICS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CLIENT_METRICS_H
+
+#include "google/cloud/storage/version.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * A histogram of latencies with logarithmic buckets.
+ *
+ * The buckets are exact for values up to 16us, and then each power of two is
+ * divided in 8 buckets. The relative error of any reported value is therefore
+ * below 12.5%, independent of the magnitude of the value.
+ */
+class LatencyHistogram {
+ public:
+  /// A non-empty bucket in the histogram.
+  struct Bucket {
+    /// The largest value counted in this bucket.
+    std::chrono::microseconds upper_bound;
+    std::uint64_t count;
+  };
+
+  LatencyHistogram();
+
+  void Record(std::chrono::microseconds value);
+
+  /// Add all the values recorded in @p other to this histogram.
+  void Merge(LatencyHistogram const& other);
+
+  std::uint64_t count() const { return count_; }
+  std::chrono::microseconds min() const;
+  std::chrono::microseconds max() const;
+  std::chrono::microseconds mean() const;
+
+  /**
+   * Returns an upper bound for the @p percentile (in the [0, 100] range) of the
+   * recorded values.
+   *
+   * Returns zero if the histogram is empty.
+   */
+  std::chrono::microseconds Percentile(double percentile) const;
+
+  /// The non-empty buckets, sorted by their upper bound.
+  std::vector<Bucket> buckets() const;
+
+ private:
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t count_ = 0;
+  std::uint64_t sum_ = 0;
+  std::uint64_t min_ = 0;
+  std::uint64_t max_ = 0;
+};
+
+/// The metrics for one type of operation, e.g., `GetObjectMetadata`.
+struct OperationMetrics {
+  /// The number of operations completed, including those that failed.
+  std::uint64_t count = 0;
+  /// The number of operations that failed, after exhausting any retries.
+  std::uint64_t errors = 0;
+  /// The number of requests sent to the service, including retries.
+  std::uint64_t attempts = 0;
+  /// The number of bytes uploaded, as payload, by these operations.
+  std::uint64_t bytes_sent = 0;
+  /// The number of bytes downloaded, as payload, by these operations.
+  std::uint64_t bytes_received = 0;
+  /// The latency of each operation, including any retries.
+  LatencyHistogram latency;
+  /// For downloads, the time until the first byte of data is received.
+  LatencyHistogram time_to_first_byte;
+
+  /// The number of requests that were retries of a previous request.
+  std::uint64_t retries() const {
+    return attempts > count ? attempts - count : 0;
+  }
+};
+
+/// The metrics for each operation, indexed by the operation name.
+using ClientMetricsSnapshot = std::map<std::string, OperationMetrics>;
+
+/**
+ * Collects latency histograms and counters for the operations in a `Client`.
+ *
+ * Applications configure a `ClientMetrics` object via
+ * `ClientOptions::set_client_metrics()`, and then periodically call
+ * `Snapshot()` to export the metrics to their monitoring system. Recording a
+ * metric only updates a few counters in a short critical section, so the
+ * metrics can remain enabled in production.
+ *
+ * The operations are named after the `internal::RawClient` member functions,
+ * e.g., `GetObjectMetadata`, `ReadObject`, or `InsertObjectMedia`. Uploads
+ * using resumable sessions appear as `UploadChunk` and `UploadFinalChunk`
+ * operations. The latency of `ReadObject` is the time to start the download,
+ * the time to receive the data is reported in the `time_to_first_byte`
+ * histogram and the `bytes_received` counter.
+ *
+ * This class is thread-safe.
+ */
+class ClientMetrics {
+ public:
+  ClientMetrics() = default;
+
+  /// Returns the metrics recorded so far.
+  ClientMetricsSnapshot Snapshot() const;
+
+  /// Returns the metrics recorded so far, and resets all the counters.
+  ClientMetricsSnapshot SnapshotAndReset();
+
+  ///@{
+  /// @name Record metrics, the library calls these functions.
+  void RecordOperation(char const* operation,
+                       std::chrono::microseconds latency, bool ok,
+                       std::uint64_t bytes_sent = 0);
+  void RecordAttempt(char const* operation);
+  void RecordDownload(char const* operation,
+                      std::chrono::microseconds time_to_first_byte,
+                      std::uint64_t bytes_received);
+  ///@}
+
+ private:
+  mutable std::mutex mu_;
+  ClientMetricsSnapshot metrics_;
+};
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CLIENT_METRICS_H
@@ -0,0 +1,114 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/client_metrics.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+using std::chrono::microseconds;
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram h;
+  EXPECT_EQ(0, h.count());
+  EXPECT_EQ(microseconds(0), h.mean());
+  EXPECT_EQ(microseconds(0), h.Percentile(50));
+  EXPECT_TRUE(h.buckets().empty());
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram h;
+  for (int i = 1; i <= 10; ++i) h.Record(microseconds(i));
+  EXPECT_EQ(10, h.count());
+  EXPECT_EQ(microseconds(1), h.min());
+  EXPECT_EQ(microseconds(10), h.max());
+  EXPECT_EQ(microseconds(5), h.mean());
+  EXPECT_EQ(microseconds(5), h.Percentile(50));
+  EXPECT_EQ(microseconds(9), h.Percentile(90));
+  EXPECT_EQ(microseconds(10), h.Percentile(100));
+  EXPECT_EQ(10, h.buckets().size());
+}
+
+TEST(LatencyHistogramTest, RelativeError) {
+  LatencyHistogram h;
+  for (std::int64_t v = 1; v < 1000 * 1000 * 1000; v = v * 3 + 1) {
+    LatencyHistogram single;
+    single.Record(microseconds(v));
+    single.Record(microseconds(1));
+    // The upper bound is within 12.5% of the actual value.
+    auto const p = single.Percentile(100).count();
+    EXPECT_GE(p, v);
+    EXPECT_LE(p, v + v / 8) << "v=" << v;
+    auto const buckets = single.buckets();
+    ASSERT_FALSE(buckets.empty());
+    EXPECT_GE(buckets.back().upper_bound.count(), v);
+    EXPECT_LE(buckets.back().upper_bound.count(), v + v / 8) << "v=" << v;
+    h.Record(microseconds(v));
+  }
+  EXPECT_GT(h.buckets().size(), 10);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram h;
+  for (int i = 0; i != 990; ++i) h.Record(microseconds(1000));
+  for (int i = 0; i != 10; ++i) h.Record(microseconds(100 * 1000));
+  EXPECT_LE(h.Percentile(50).count(), 1000 + 1000 / 8);
+  EXPECT_LE(h.Percentile(99).count(), 1000 + 1000 / 8);
+  EXPECT_GE(h.Percentile(99.9).count(), 100 * 1000);
+  EXPECT_EQ(microseconds(100 * 1000), h.Percentile(100));
+}
+
+TEST(LatencyHistogramTest, Merge) {
+  LatencyHistogram a;
+  LatencyHistogram b;
+  a.Record(microseconds(10));
+  b.Record(microseconds(2));
+  b.Record(microseconds(30));
+  a.Merge(b);
+  EXPECT_EQ(3, a.count());
+  EXPECT_EQ(microseconds(2), a.min());
+  EXPECT_EQ(microseconds(30), a.max());
+  EXPECT_EQ(microseconds(14), a.mean());
+}
+
+TEST(ClientMetricsTest, SnapshotAndReset) {
+  ClientMetrics metrics;
+  metrics.RecordAttempt("GetObjectMetadata");
+  metrics.RecordAttempt("GetObjectMetadata");
+  metrics.RecordOperation("GetObjectMetadata", microseconds(100), true);
+  metrics.RecordOperation("InsertObjectMedia", microseconds(200), false, 1024);
+  metrics.RecordDownload("ReadObject", microseconds(50), 2048);
+
+  auto snapshot = metrics.Snapshot();
+  EXPECT_EQ(3, snapshot.size());
+  EXPECT_EQ(1, snapshot["GetObjectMetadata"].count);
+  EXPECT_EQ(1, snapshot["GetObjectMetadata"].retries());
+  EXPECT_EQ(1, snapshot["InsertObjectMedia"].errors);
+  EXPECT_EQ(1024, snapshot["InsertObjectMedia"].bytes_sent);
+  EXPECT_EQ(2048, snapshot["ReadObject"].bytes_received);
+  EXPECT_EQ(1, snapshot["ReadObject"].time_to_first_byte.count());
+
+  EXPECT_EQ(3, metrics.SnapshotAndReset().size());
+  EXPECT_TRUE(metrics.Snapshot().empty());
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -113,6 +113,17 @@ StatusOr<ClientOptions> ClientOptions::CreateDefaultClientOptions(
   return ClientOptions(*creds, channel_options);
 }
 
+ClientOptions ClientOptions::CreateLazyDefaultClientOptions(
+    ChannelOptions const& channel_options) {
+  if (internal::GetEmulator().has_value()) {
+    return ClientOptions(oauth2::CreateAnonymousCredentials(),
+                         channel_options);
+  }
+  return ClientOptions(
+      oauth2::CreateLazyGoogleDefaultCredentials(channel_options),
+      channel_options);
+}
+
 ClientOptions::ClientOptions(std::shared_ptr<oauth2::Credentials> credentials,
                              ChannelOptions channel_options)
     : credentials_(std::move(credentials)),
@@ -165,6 +176,10 @@ void ClientOptions::SetupFromEnvironment() {
   if (project_id.has_value()) {
     project_id_ = std::move(*project_id);
   }
+
+  auto rest_config =
+      google::cloud::internal::GetEnv("GOOGLE_CLOUD_CPP_STORAGE_REST_CONFIG");
+  if (rest_config.value_or("") == "lean-xml") set_enable_lean_xml(true);
 }
 
 ClientOptions& ClientOptions::SetDownloadBufferSize(std::size_t size) {
@@ -15,8 +15,15 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CLIENT_OPTIONS_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CLIENT_OPTIONS_H
 
+#include "google/cloud/storage/buffer_pool.h"
+#include "google/cloud/storage/client_metrics.h"
 #include "google/cloud/storage/oauth2/credentials.h"
+#include "google/cloud/storage/metadata_cache_invalidator.h"
+#include "google/cloud/storage/object_read_cache.h"
+#include "google/cloud/storage/rate_limiter.h"
 #include "google/cloud/storage/version.h"
+#include <algorithm>
+#include <chrono>
 #include <memory>
 
 namespace google {
@@ -51,8 +58,106 @@ class ChannelOptions {
     return *this;
   }
 
+  /**
+   * The number of gRPC channels created by the client.
+   *
+   * Downloads using `ParallelReadStreams` use a different channel, and
+   * therefore a different connection, for each stream. The default is 1.
+   */
+  std::size_t channel_pool_size() const { return channel_pool_size_; }
+
+  ChannelOptions& set_channel_pool_size(std::size_t v) {
+    channel_pool_size_ = (std::max<std::size_t>)(1, v);
+    return *this;
+  }
+
+  /**
+   * The maximum number of gRPC channels created by the client.
+   *
+   * Streaming RPCs, i.e. uploads and downloads, use the channel with the
+   * fewest active streams. If all the channels have
+   * `max_streams_per_channel()` active streams the client creates a new
+   * channel, up to this limit. Values smaller than `channel_pool_size()` are
+   * treated as `channel_pool_size()`, which disables growing the pool. The
+   * default is 8.
+   */
+  std::size_t max_channel_pool_size() const { return max_channel_pool_size_; }
+
+  ChannelOptions& set_max_channel_pool_size(std::size_t v) {
+    max_channel_pool_size_ = (std::max<std::size_t>)(1, v);
+    return *this;
+  }
+
+  /**
+   * The number of concurrent streams that saturates a gRPC channel.
+   *
+   * Most HTTP/2 servers, including GCS, limit the number of concurrent
+   * streams in each connection, additional streams wait until an existing
+   * stream completes. Set this to the server's limit. The default is 100.
+   */
+  std::size_t max_streams_per_channel() const {
+    return max_streams_per_channel_;
+  }
+
+  ChannelOptions& set_max_streams_per_channel(std::size_t v) {
+    max_streams_per_channel_ = (std::max<std::size_t>)(1, v);
+    return *this;
+  }
+
+  /**
+   * Use DirectPath to connect directly to the GCS backends.
+   *
+   * On Google Compute Engine (and GKE) DirectPath bypasses the Google Front
+   * Ends, using ALTS over IPv6 to connect to the backends. Where DirectPath is
+   * not available the channels fallback to the public endpoint (CloudPath).
+   * DirectPath can also be enabled by including `storage` in the
+   * `GOOGLE_CLOUD_ENABLE_DIRECT_PATH` environment variable. The default is
+   * `false`.
+   */
+  bool enable_direct_path() const { return enable_direct_path_; }
+
+  ChannelOptions& set_enable_direct_path(bool v) {
+    enable_direct_path_ = v;
+    return *this;
+  }
+
+  /**
+   * Discover the DirectPath backends using xDS, instead of grpclb.
+   *
+   * Only used if DirectPath is enabled. The default is `false`.
+   */
+  bool direct_path_xds() const { return direct_path_xds_; }
+
+  ChannelOptions& set_direct_path_xds(bool v) {
+    direct_path_xds_ = v;
+    return *this;
+  }
+
+  /**
+   * How long to wait for the DirectPath (grpclb) balancers before falling back
+   * to CloudPath.
+   *
+   * With xDS the fallback is automatic, when the client is not running on
+   * Google Cloud. The default is 10 seconds.
+   */
+  std::chrono::milliseconds direct_path_fallback_timeout() const {
+    return direct_path_fallback_timeout_;
+  }
+
+  ChannelOptions& set_direct_path_fallback_timeout(std::chrono::milliseconds v) {
+    direct_path_fallback_timeout_ = v;
+    return *this;
+  }
+
  private:
   std::string ssl_root_path_;
+  std::size_t channel_pool_size_ = 1;
+  std::size_t max_channel_pool_size_ = 8;
+  std::size_t max_streams_per_channel_ = 100;
+  bool enable_direct_path_ = false;
+  bool direct_path_xds_ = false;
+  std::chrono::milliseconds direct_path_fallback_timeout_ =
+      std::chrono::seconds(10);
 };
 
 /**
@@ -90,6 +195,19 @@ class ClientOptions {
   static StatusOr<ClientOptions> CreateDefaultClientOptions(
       ChannelOptions const& channel_options);
 
+  /**
+   * Creates a `ClientOptions` with Google Application Default %Credentials,
+   * discovered in the background.
+   *
+   * Unlike `CreateDefaultClientOptions()` this function does not block while
+   * the credentials are discovered. The first request made by a client using
+   * these options waits for the discovery, and fails if the credentials could
+   * not be loaded. If the `CLOUD_STORAGE_EMULATOR_ENDPOINT` environment
+   * variable is set, this function uses an `AnonymousCredentials`.
+   */
+  static ClientOptions CreateLazyDefaultClientOptions(
+      ChannelOptions const& channel_options = {});
+
   std::shared_ptr<oauth2::Credentials> credentials() const {
     return credentials_;
   }
@@ -225,6 +343,188 @@ class ClientOptions {
   }
   //@}
 
+  //@{
+  /**
+   * Route all eligible object reads and uploads to the XML API.
+   *
+   * By default `InsertObject()` uses the JSON API, unless the application sets
+   * `Fields("")`, because the JSON API returns the full object metadata. In
+   * "lean XML" mode, `InsertObject()` and `ReadObject()` use the XML API unless
+   * the request uses an option that only the JSON API supports (for example
+   * `IfGenerationNotMatch`, `Projection`, `QuotaUser`, or a non-empty `Fields`).
+   * The `ObjectMetadata` returned by these uploads contains only the bucket,
+   * name, generation, and checksums. Downloads discard all the response
+   * headers, except for `x-goog-hash` and `x-goog-generation`.
+   *
+   * This reduces the CPU and bytes consumed by each request, which dominate
+   * the cost of small object reads and writes. The default is `false`, and can
+   * also be enabled by setting the `GOOGLE_CLOUD_CPP_STORAGE_REST_CONFIG`
+   * environment variable to `lean-xml`.
+   */
+  bool enable_lean_xml() const { return enable_lean_xml_; }
+  ClientOptions& set_enable_lean_xml(bool v) {
+    enable_lean_xml_ = v;
+    return *this;
+  }
+  //@}
+
+  //@{
+  /**
+   * Control the in-memory cache for object and bucket metadata.
+   *
+   * If `metadata_cache_max_entries()` is not zero, the client caches the
+   * results of `GetObjectMetadata()` and `GetBucketMetadata()`, as well as the
+   * metadata returned by operations such as `InsertObject()`. Operations
+   * through the same client invalidate any affected entries, but changes made
+   * by other clients are only observed once the entry expires, after
+   * `metadata_cache_ttl()`, or when a `metadata_cache_invalidator()` receives
+   * a notification for the object.
+   *
+   * The cache is disabled by default, the default TTL is 60 seconds.
+   */
+  std::size_t metadata_cache_max_entries() const {
+    return metadata_cache_max_entries_;
+  }
+  ClientOptions& set_metadata_cache_max_entries(std::size_t v) {
+    metadata_cache_max_entries_ = v;
+    return *this;
+  }
+
+  std::chrono::milliseconds metadata_cache_ttl() const {
+    return metadata_cache_ttl_;
+  }
+  ClientOptions& set_metadata_cache_ttl(std::chrono::milliseconds v) {
+    metadata_cache_ttl_ = v;
+    return *this;
+  }
+
+  /**
+   * Evict cached object metadata when notified of changes.
+   *
+   * This is `nullptr` by default. Each client created with this option
+   * registers its metadata cache with the invalidator.
+   *
+   * @see `MetadataCacheInvalidator` for how to feed it Pub/Sub notifications.
+   */
+  std::shared_ptr<MetadataCacheInvalidator> const&
+  metadata_cache_invalidator() const {
+    return metadata_cache_invalidator_;
+  }
+  ClientOptions& set_metadata_cache_invalidator(
+      std::shared_ptr<MetadataCacheInvalidator> v) {
+    metadata_cache_invalidator_ = std::move(v);
+    return *this;
+  }
+  //@}
+
+  //@{
+  /**
+   * Coalesce identical concurrent requests.
+   *
+   * If enabled, identical `GetObjectMetadata()`, `GetBucketMetadata()`, and
+   * `ReadObject()` requests issued while one of them is in progress share a
+   * single request to the service, and all the callers receive its result.
+   * This reduces the load when many threads request the same object at the
+   * same time. Shared downloads are buffered in memory until all the callers
+   * consume the data. Disabled by default.
+   *
+   * @warning A coalesced request may return the result of a request that
+   *     started shortly before it, and therefore miss a change made in the
+   *     meantime. To bound this, requests only join requests started in the
+   *     last 100 milliseconds, except `ReadObject()` requests with a
+   *     `Generation` option: the contents of a generation never change, so
+   *     they join any in-progress or buffered download. Do not enable this
+   *     option if the application requires strict read-after-write
+   *     consistency for requests not pinned to a generation.
+   */
+  bool enable_request_coalescing() const { return enable_request_coalescing_; }
+  ClientOptions& set_enable_request_coalescing(bool v) {
+    enable_request_coalescing_ = v;
+    return *this;
+  }
+  //@}
+
+  //@{
+  /**
+   * Serve downloads from a local cache of the object contents.
+   *
+   * If set, `ReadObject()` and `DownloadToFile()` first fetch the object
+   * metadata, and then serve the data from this cache, downloading only the
+   * blocks missing from the cache. This is disabled by default (`nullptr`).
+   * Downloads of encrypted objects (with `EncryptionKey`) bypass the cache.
+   *
+   * Consider enabling the metadata cache too, see
+   * `set_metadata_cache_max_entries()`, so repeated downloads of the same
+   * object do not need any requests to the service.
+   *
+   * @see `MakeInMemoryObjectReadCache()`, `MakeFileObjectReadCache()`.
+   */
+  std::shared_ptr<ObjectReadCache> const& object_read_cache() const {
+    return object_read_cache_;
+  }
+  ClientOptions& set_object_read_cache(std::shared_ptr<ObjectReadCache> v) {
+    object_read_cache_ = std::move(v);
+    return *this;
+  }
+  //@}
+
+  //@{
+  /**
+   * Record latency histograms and counters for each operation.
+   *
+   * If set, the client records the metrics for each operation in this object.
+   * The application can share the same object across multiple clients, and
+   * periodically export its contents, see `ClientMetrics::Snapshot()` for
+   * details. This is disabled by default (`nullptr`).
+   */
+  std::shared_ptr<ClientMetrics> const& client_metrics() const {
+    return client_metrics_;
+  }
+  ClientOptions& set_client_metrics(std::shared_ptr<ClientMetrics> v) {
+    client_metrics_ = std::move(v);
+    return *this;
+  }
+  //@}
+
+  //@{
+  /**
+   * Limit the rate of requests and bytes transferred.
+   *
+   * If set, the client waits as needed before each request, and during each
+   * upload and download, to stay within the limits of this object. The
+   * application can share the same object across multiple clients, to limit
+   * their aggregate traffic. This is disabled by default (`nullptr`).
+   *
+   * @see `MakeTokenBucketRateLimiter()`.
+   */
+  std::shared_ptr<RateLimiter> const& rate_limiter() const {
+    return rate_limiter_;
+  }
+  ClientOptions& set_rate_limiter(std::shared_ptr<RateLimiter> v) {
+    rate_limiter_ = std::move(v);
+    return *this;
+  }
+  //@}
+
+  //@{
+  /**
+   * Control how the buffers for uploads and downloads are allocated.
+   *
+   * The default pool allocates a new buffer for each stream and download, and
+   * releases it when the stream is closed. Setting a `nullptr` restores this
+   * default.
+   *
+   * @see `MakeRecyclingBufferPool()` for a pool that reuses the buffers.
+   */
+  std::shared_ptr<BufferPool> const& buffer_pool() const {
+    return buffer_pool_;
+  }
+  ClientOptions& set_buffer_pool(std::shared_ptr<BufferPool> v) {
+    buffer_pool_ = v ? std::move(v) : DefaultBufferPool();
+    return *this;
+  }
+  //@}
+
  private:
   friend std::string internal::JsonEndpoint(ClientOptions const&);
   friend std::string internal::JsonUploadEndpoint(ClientOptions const&);
@@ -250,6 +550,15 @@ class ClientOptions {
   std::size_t maximum_socket_recv_size_ = 0;
   std::size_t maximum_socket_send_size_ = 0;
   std::chrono::seconds download_stall_timeout_;
+  bool enable_lean_xml_ = false;
+  std::size_t metadata_cache_max_entries_ = 0;
+  std::chrono::milliseconds metadata_cache_ttl_ = std::chrono::seconds(60);
+  std::shared_ptr<MetadataCacheInvalidator> metadata_cache_invalidator_;
+  bool enable_request_coalescing_ = false;
+  std::shared_ptr<BufferPool> buffer_pool_ = DefaultBufferPool();
+  std::shared_ptr<ObjectReadCache> object_read_cache_;
+  std::shared_ptr<ClientMetrics> client_metrics_;
+  std::shared_ptr<RateLimiter> rate_limiter_;
   ChannelOptions channel_options_;
 };
 
@@ -296,6 +296,112 @@ TEST_F(ClientOptionsTest, SetMaximumDownloadStall) {
   EXPECT_EQ(60, client_options.download_stall_timeout().count());
 }
 
+TEST_F(ClientOptionsTest, SetChannelPoolSize) {
+  ChannelOptions channel_options;
+  EXPECT_EQ(1, channel_options.channel_pool_size());
+  channel_options.set_channel_pool_size(8);
+  EXPECT_EQ(8, channel_options.channel_pool_size());
+  channel_options.set_channel_pool_size(0);
+  EXPECT_EQ(1, channel_options.channel_pool_size());
+}
+
+TEST_F(ClientOptionsTest, SetMaxChannelPoolSize) {
+  ChannelOptions channel_options;
+  EXPECT_EQ(8, channel_options.max_channel_pool_size());
+  channel_options.set_max_channel_pool_size(16);
+  EXPECT_EQ(16, channel_options.max_channel_pool_size());
+  channel_options.set_max_channel_pool_size(0);
+  EXPECT_EQ(1, channel_options.max_channel_pool_size());
+}
+
+TEST_F(ClientOptionsTest, SetMaxStreamsPerChannel) {
+  ChannelOptions channel_options;
+  EXPECT_EQ(100, channel_options.max_streams_per_channel());
+  channel_options.set_max_streams_per_channel(200);
+  EXPECT_EQ(200, channel_options.max_streams_per_channel());
+  channel_options.set_max_streams_per_channel(0);
+  EXPECT_EQ(1, channel_options.max_streams_per_channel());
+}
+
+TEST_F(ClientOptionsTest, SetDirectPath) {
+  ChannelOptions channel_options;
+  EXPECT_FALSE(channel_options.enable_direct_path());
+  EXPECT_FALSE(channel_options.direct_path_xds());
+  EXPECT_EQ(std::chrono::seconds(10),
+            channel_options.direct_path_fallback_timeout());
+  channel_options.set_enable_direct_path(true)
+      .set_direct_path_xds(true)
+      .set_direct_path_fallback_timeout(std::chrono::milliseconds(500));
+  EXPECT_TRUE(channel_options.enable_direct_path());
+  EXPECT_TRUE(channel_options.direct_path_xds());
+  EXPECT_EQ(std::chrono::milliseconds(500),
+            channel_options.direct_path_fallback_timeout());
+}
+
+TEST_F(ClientOptionsTest, SetLeanXml) {
+  testing_util::ScopedEnvironment rest_config(
+      "GOOGLE_CLOUD_CPP_STORAGE_REST_CONFIG", {});
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_FALSE(client_options.enable_lean_xml());
+  client_options.set_enable_lean_xml(true);
+  EXPECT_TRUE(client_options.enable_lean_xml());
+}
+
+TEST_F(ClientOptionsTest, LeanXmlFromEnvironment) {
+  testing_util::ScopedEnvironment rest_config(
+      "GOOGLE_CLOUD_CPP_STORAGE_REST_CONFIG", "lean-xml");
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_TRUE(client_options.enable_lean_xml());
+}
+
+TEST_F(ClientOptionsTest, SetMetadataCache) {
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(0, client_options.metadata_cache_max_entries());
+  EXPECT_EQ(std::chrono::seconds(60), client_options.metadata_cache_ttl());
+  client_options.set_metadata_cache_max_entries(1000).set_metadata_cache_ttl(
+      std::chrono::seconds(5));
+  EXPECT_EQ(1000, client_options.metadata_cache_max_entries());
+  EXPECT_EQ(std::chrono::seconds(5), client_options.metadata_cache_ttl());
+  EXPECT_EQ(nullptr, client_options.metadata_cache_invalidator());
+  auto invalidator = std::make_shared<MetadataCacheInvalidator>();
+  client_options.set_metadata_cache_invalidator(invalidator);
+  EXPECT_EQ(invalidator, client_options.metadata_cache_invalidator());
+}
+
+TEST_F(ClientOptionsTest, SetRequestCoalescing) {
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_FALSE(client_options.enable_request_coalescing());
+  client_options.set_enable_request_coalescing(true);
+  EXPECT_TRUE(client_options.enable_request_coalescing());
+}
+
+TEST_F(ClientOptionsTest, SetBufferPool) {
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(DefaultBufferPool(), client_options.buffer_pool());
+  auto pool = MakeRecyclingBufferPool();
+  client_options.set_buffer_pool(pool);
+  EXPECT_EQ(pool, client_options.buffer_pool());
+  client_options.set_buffer_pool(nullptr);
+  EXPECT_EQ(DefaultBufferPool(), client_options.buffer_pool());
+}
+
+TEST_F(ClientOptionsTest, SetClientMetrics) {
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(nullptr, client_options.client_metrics());
+  auto metrics = std::make_shared<ClientMetrics>();
+  client_options.set_client_metrics(metrics);
+  EXPECT_EQ(metrics, client_options.client_metrics());
+}
+
+TEST_F(ClientOptionsTest, SetRateLimiter) {
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(nullptr, client_options.rate_limiter());
+  auto limiter = MakeTokenBucketRateLimiter(
+      TokenBucketRateLimiterOptions{}.set_requests_per_second(100));
+  client_options.set_rate_limiter(limiter);
+  EXPECT_EQ(limiter, client_options.rate_limiter());
+}
+
 }  // namespace
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
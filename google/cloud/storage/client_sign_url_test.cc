@@ -300,6 +300,74 @@ TEST_F(CreateSignedUrlTest, V4SignPermanentFailure) {
       "SignBlob");
 }
 
+/// @test Verify that CreateV4SignedUrls() matches CreateV4SignedUrl().
+TEST_F(CreateSignedUrlTest, V4SignMany) {
+  auto creds = oauth2::CreateServiceAccountCredentialsFromJsonContents(
+      kJsonKeyfileContentsForV4);
+  ASSERT_STATUS_OK(creds);
+  Client client(*creds);
+
+  auto const timestamp =
+      google::cloud::internal::ParseRfc3339("2019-02-01T09:00:00Z");
+  std::vector<SignedUrlItem> items;
+  for (int i = 0; i != 16; ++i) {
+    items.push_back(SignedUrlItem{i % 2 == 0 ? "GET" : "PUT", "test-bucket",
+                                  "test-object-" + std::to_string(i)});
+  }
+  auto actual = client.CreateV4SignedUrls(
+      items, SignedUrlTimestamp(timestamp),
+      SignedUrlDuration(std::chrono::seconds(10)), MaxSigningThreads(4));
+  ASSERT_EQ(items.size(), actual.size());
+  for (std::size_t i = 0; i != items.size(); ++i) {
+    auto expected = client.CreateV4SignedUrl(
+        items[i].verb, items[i].bucket_name, items[i].object_name,
+        SignedUrlTimestamp(timestamp),
+        SignedUrlDuration(std::chrono::seconds(10)));
+    ASSERT_STATUS_OK(expected);
+    ASSERT_STATUS_OK(actual[i]);
+    EXPECT_EQ(*expected, *actual[i]);
+  }
+}
+
+/// @test Verify that CreateV4SignedUrls() uses the SignBlob API when needed.
+TEST_F(CreateSignedUrlTest, V4SignManyRemote) {
+  // Use `echo -n test-signed-blob | openssl base64 -e` to create the magic
+  // string.
+  std::string expected_signed_blob = "dGVzdC1zaWduZWQtYmxvYg==";
+  // Use `echo -n test-signed-blob | od -x` to create the magic string.
+  std::string expected_signed_blob_hex = "746573742d7369676e65642d626c6f62";
+
+  EXPECT_CALL(*mock_, SignBlob(_))
+      .Times(8)
+      .WillRepeatedly(
+          [&expected_signed_blob](internal::SignBlobRequest const&) {
+            return make_status_or(internal::SignBlobResponse{
+                "test-key-id", expected_signed_blob});
+          });
+  std::vector<SignedUrlItem> items(
+      8, SignedUrlItem{"GET", "test-bucket", "test-object"});
+  auto actual = client_->CreateV4SignedUrls(items, MaxSigningThreads(3));
+  ASSERT_EQ(items.size(), actual.size());
+  for (auto const& url : actual) {
+    ASSERT_STATUS_OK(url);
+    EXPECT_THAT(*url, HasSubstr(expected_signed_blob_hex));
+  }
+}
+
+/// @test Verify that CreateV4SignedUrls() reports errors for each URL.
+TEST_F(CreateSignedUrlTest, V4SignManyInvalid) {
+  auto creds = oauth2::CreateServiceAccountCredentialsFromJsonContents(
+      kJsonKeyfileContentsForV4);
+  ASSERT_STATUS_OK(creds);
+  Client client(*creds);
+
+  auto actual = client.CreateV4SignedUrls(
+      {SignedUrlItem{"GET", "test-bucket", "test-object"}},
+      VirtualHostname(true), BucketBoundHostname("mydomain.tld"));
+  ASSERT_EQ(1U, actual.size());
+  EXPECT_FALSE(actual[0].ok());
+}
+
 }  // namespace
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
@@ -18,6 +18,7 @@
 #include "google/cloud/storage/retry_policy.h"
 #include "google/cloud/storage/testing/canonical_errors.h"
 #include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/status_matchers.h"
 #include <gmock/gmock.h>
 
 namespace google {
@@ -27,6 +28,7 @@ inline namespace STORAGE_CLIENT_NS {
 namespace {
 
 using ::google::cloud::storage::testing::canonical_errors::TransientError;
+using ::google::cloud::testing_util::StatusIs;
 using ::testing::_;
 using ::testing::Return;
 using ::testing::ReturnRef;
@@ -170,6 +172,67 @@ TEST_F(ClientTest, LoggingDecorators) {
   ASSERT_TRUE(curl != nullptr);
 }
 
+/// @test Verify the constructor creates the right set of RawClient decorations.
+TEST_F(ClientTest, MetadataCacheDecorators) {
+  // Create a client, use the anonymous credentials because on the CI
+  // environment there may not be other credentials configured.
+  ClientOptions options(oauth2::CreateAnonymousCredentials());
+  options.set_metadata_cache_max_entries(100);
+  Client tested(options);
+
+  EXPECT_TRUE(tested.raw_client() != nullptr);
+  auto* cache = dynamic_cast<internal::MetadataCacheClient*>(
+      tested.raw_client().get());
+  ASSERT_TRUE(cache != nullptr);
+
+  auto* retry = dynamic_cast<internal::RetryClient*>(cache->client().get());
+  ASSERT_TRUE(retry != nullptr);
+
+  auto* curl = dynamic_cast<internal::CurlClient*>(retry->client().get());
+  ASSERT_TRUE(curl != nullptr);
+}
+
+/// @test Verify the constructor creates the right set of RawClient decorations.
+TEST_F(ClientTest, MetricsDecorators) {
+  // Create a client, use the anonymous credentials because on the CI
+  // environment there may not be other credentials configured.
+  ClientOptions options(oauth2::CreateAnonymousCredentials());
+  options.set_client_metrics(std::make_shared<ClientMetrics>());
+  Client tested(options);
+
+  EXPECT_TRUE(tested.raw_client() != nullptr);
+  auto* operations =
+      dynamic_cast<internal::MetricsClient*>(tested.raw_client().get());
+  ASSERT_TRUE(operations != nullptr);
+  EXPECT_EQ(internal::MetricsClient::Mode::kOperations, operations->mode());
+
+  auto* retry =
+      dynamic_cast<internal::RetryClient*>(operations->client().get());
+  ASSERT_TRUE(retry != nullptr);
+
+  auto* attempts =
+      dynamic_cast<internal::MetricsClient*>(retry->client().get());
+  ASSERT_TRUE(attempts != nullptr);
+  EXPECT_EQ(internal::MetricsClient::Mode::kAttempts, attempts->mode());
+
+  auto* curl = dynamic_cast<internal::CurlClient*>(attempts->client().get());
+  ASSERT_TRUE(curl != nullptr);
+}
+
+/// @test Verify WarmUpConnectionPool() is forwarded and not retried.
+TEST_F(ClientTest, WarmUpConnectionPool) {
+  auto const mock_options = ClientOptions(oauth2::CreateAnonymousCredentials());
+  EXPECT_CALL(*mock_, client_options()).WillRepeatedly(ReturnRef(mock_options));
+  Client client{std::shared_ptr<internal::RawClient>(mock_),
+                ObservableRetryPolicy(3)};
+
+  EXPECT_CALL(*mock_, WarmUpConnectionPool())
+      .WillOnce(Return(TransientError()));
+  EXPECT_THAT(client.WarmUpConnectionPool(),
+              StatusIs(TransientError().code()));
+  EXPECT_EQ(0, ObservableRetryPolicy::is_exhausted_call_count_);
+}
+
 }  // namespace
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
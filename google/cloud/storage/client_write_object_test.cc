@@ -24,6 +24,7 @@
 #include "google/cloud/testing_util/status_matchers.h"
 #include "absl/memory/memory.h"
 #include <gmock/gmock.h>
+#include <atomic>
 #include <fstream>
 
 namespace google {
@@ -117,6 +118,92 @@ TEST_F(WriteObjectTest, WriteObject) {
   EXPECT_EQ(expected, actual);
 }
 
+TEST_F(WriteObjectTest, WriteObjectPipelined) {
+  std::string text = R"""({
+      "name": "test-bucket-name/test-object-name/1"
+})""";
+  auto expected = internal::ObjectMetadataParser::FromString(text).value();
+  auto const quantum = internal::UploadChunkRequest::kChunkSizeQuantum;
+  std::string const session_id = "test-session-id";
+  std::atomic<std::uint64_t> next_byte{0};
+
+  EXPECT_CALL(*mock_, CreateResumableSession(_))
+      .WillOnce([&](internal::ResumableUploadRequest const& request) {
+        EXPECT_EQ(3U, request.GetOption<PipelinedUploadBuffers>().value());
+
+        auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+        using internal::ResumableUploadResponse;
+        EXPECT_CALL(*mock, done()).WillRepeatedly(Return(false));
+        EXPECT_CALL(*mock, session_id()).WillRepeatedly(ReturnRef(session_id));
+        EXPECT_CALL(*mock, next_expected_byte()).WillRepeatedly([&] {
+          return next_byte.load();
+        });
+        EXPECT_CALL(*mock, UploadChunk(_))
+            .WillOnce([&](internal::ConstBufferSequence const& p) {
+              EXPECT_EQ(2 * quantum, internal::TotalBytes(p));
+              next_byte += internal::TotalBytes(p);
+              return make_status_or(ResumableUploadResponse{
+                  "fake-url", next_byte - 1, {},
+                  ResumableUploadResponse::kInProgress, {}});
+            });
+        EXPECT_CALL(*mock, UploadFinalChunk(_, 2 * quantum + 1))
+            .WillOnce(Return(make_status_or(ResumableUploadResponse{
+                "fake-url", 0, expected, ResumableUploadResponse::kDone, {}})));
+
+        return make_status_or(
+            std::unique_ptr<internal::ResumableUploadSession>(std::move(mock)));
+      });
+
+  auto stream = client_->WriteObject("test-bucket-name", "test-object-name",
+                                     PipelinedUploadBuffers(3));
+  stream << std::string(2 * quantum, 'A') << "B";
+  stream.Close();
+  ObjectMetadata actual = stream.metadata().value();
+  EXPECT_EQ(expected, actual);
+}
+
+TEST_F(WriteObjectTest, WriteObjectGzip) {
+  std::string text = R"""({
+      "name": "test-bucket-name/test-object-name/1"
+})""";
+  auto expected = internal::ObjectMetadataParser::FromString(text).value();
+  std::string const session_id = "test-session-id";
+  std::string uploaded;
+
+  EXPECT_CALL(*mock_, CreateResumableSession(_))
+      .WillOnce([&](internal::ResumableUploadRequest const& request) {
+        EXPECT_EQ("gzip", request.GetOption<ContentEncoding>().value());
+
+        auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+        using internal::ResumableUploadResponse;
+        EXPECT_CALL(*mock, done()).WillRepeatedly(Return(false));
+        EXPECT_CALL(*mock, session_id()).WillRepeatedly(ReturnRef(session_id));
+        EXPECT_CALL(*mock, next_expected_byte()).WillRepeatedly(Return(0));
+        EXPECT_CALL(*mock, UploadChunk(_)).Times(0);
+        EXPECT_CALL(*mock, UploadFinalChunk(_, _))
+            .WillOnce([&](internal::ConstBufferSequence const& p,
+                          std::uint64_t) {
+              for (auto const& b : p) uploaded.append(b.data(), b.size());
+              return make_status_or(ResumableUploadResponse{
+                  "fake-url", 0, expected, ResumableUploadResponse::kDone, {}});
+            });
+
+        return make_status_or(
+            std::unique_ptr<internal::ResumableUploadSession>(std::move(mock)));
+      });
+
+  auto stream = client_->WriteObject("test-bucket-name", "test-object-name",
+                                     GzipCompression(9));
+  std::string const contents(1024 * 1024, 'A');
+  stream << contents;
+  stream.Close();
+  ObjectMetadata actual = stream.metadata().value();
+  EXPECT_EQ(expected, actual);
+  // The data is much smaller, and starts with the gzip magic number.
+  ASSERT_LT(uploaded.size(), contents.size() / 100);
+  EXPECT_EQ("\x1f\x8b", uploaded.substr(0, 2));
+}
+
 TEST_F(WriteObjectTest, WriteObjectTooManyFailures) {
   Client client{std::shared_ptr<internal::RawClient>(mock_),
                 LimitedErrorCountRetryPolicy(2),
@@ -361,6 +448,56 @@ TEST_F(WriteObjectTest, UploadFile) {
   EXPECT_EQ(expected, *res);
 }
 
+TEST_F(WriteObjectTest, UploadFileDirectIO) {
+  auto const quantum = internal::UploadChunkRequest::kChunkSizeQuantum;
+  auto rng = google::cloud::internal::MakeDefaultPRNG();
+  auto const contents =
+      google::cloud::storage::testing::MakeRandomData(rng, 3 * quantum + 10);
+  google::cloud::storage::testing::TempFile temp_file(contents);
+
+  std::string text = R"""({
+      "name": "test-bucket-name/test-object-name/1"
+})""";
+  auto expected = internal::ObjectMetadataParser::FromString(text).value();
+
+  std::string uploaded;
+  EXPECT_CALL(*mock_, CreateResumableSession(_))
+      .WillOnce([&](internal::ResumableUploadRequest const& request) {
+        EXPECT_TRUE(request.GetOption<UseDirectFileIO>().value_or(false));
+        auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+        using internal::ResumableUploadResponse;
+        EXPECT_CALL(*mock, done()).WillRepeatedly(Return(false));
+        EXPECT_CALL(*mock, next_expected_byte()).WillRepeatedly([&uploaded] {
+          return static_cast<std::uint64_t>(uploaded.size());
+        });
+        EXPECT_CALL(*mock, UploadChunk)
+            .WillRepeatedly([&](internal::ConstBufferSequence const& data) {
+              for (auto const& b : data) uploaded.append(b.data(), b.size());
+              return make_status_or(ResumableUploadResponse{
+                  "fake-url", uploaded.size() - 1, {},
+                  ResumableUploadResponse::kInProgress, {}});
+            });
+        EXPECT_CALL(*mock, UploadFinalChunk(_, _))
+            .WillOnce([&](internal::ConstBufferSequence const& data,
+                          std::uint64_t size) {
+              for (auto const& b : data) uploaded.append(b.data(), b.size());
+              EXPECT_EQ(uploaded.size(), size);
+              return make_status_or(ResumableUploadResponse{
+                  "fake-url", 0, expected, ResumableUploadResponse::kDone, {}});
+            });
+
+        return make_status_or(
+            std::unique_ptr<internal::ResumableUploadSession>(std::move(mock)));
+      });
+
+  auto res = client_->UploadFile(temp_file.name(), "test-bucket-name",
+                                 "test-object-name", UseResumableUploadSession(),
+                                 UploadFromOffset(5), UseDirectFileIO(true));
+  ASSERT_STATUS_OK(res);
+  EXPECT_EQ(expected, *res);
+  EXPECT_EQ(contents.substr(5), uploaded);
+}
+
 }  // namespace
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
@@ -0,0 +1,134 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/compact_object_list.h"
+#include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/internal/format_time_point.h"
+#include <iostream>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+using ::google::cloud::internal::FormatRfc3339;
+using std::chrono::system_clock;
+
+std::int64_t ToMicroseconds(system_clock::time_point tp) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             tp.time_since_epoch())
+      .count();
+}
+
+system_clock::time_point FromMicroseconds(std::int64_t us) {
+  return system_clock::time_point(
+      std::chrono::duration_cast<system_clock::duration>(
+          std::chrono::microseconds(us)));
+}
+
+}  // namespace
+
+CompactObjectMetadata CompactObjectList::operator[](std::size_t i) const {
+  auto const& e = entries_[i];
+  CompactObjectMetadata result;
+  result.name = absl::string_view(names_.data() + e.name_offset, e.name_size);
+  result.size = e.size;
+  result.generation = e.generation;
+  if (has_crc32c_[i]) result.crc32c = e.crc32c;
+  result.time_created = FromMicroseconds(e.time_created);
+  result.updated = FromMicroseconds(e.updated);
+  return result;
+}
+
+void CompactObjectList::reserve(std::size_t objects, std::size_t name_bytes) {
+  entries_.reserve(objects);
+  has_crc32c_.reserve(objects);
+  names_.reserve(name_bytes);
+}
+
+void CompactObjectList::Append(ObjectMetadata const& object) {
+  CompactObjectMetadata m;
+  m.name = object.name();
+  m.size = object.size();
+  m.generation = object.generation();
+  m.crc32c = internal::DecodeCrc32c(object.crc32c());
+  m.time_created = object.time_created();
+  m.updated = object.updated();
+  Append(m);
+}
+
+void CompactObjectList::Append(CompactObjectMetadata const& object) {
+  Entry e;
+  e.name_offset = names_.size();
+  e.name_size = static_cast<std::uint32_t>(object.name.size());
+  e.crc32c = object.crc32c.value_or(0);
+  e.size = object.size;
+  e.generation = object.generation;
+  e.time_created = ToMicroseconds(object.time_created);
+  e.updated = ToMicroseconds(object.updated);
+  names_.append(object.name.data(), object.name.size());
+  entries_.push_back(e);
+  has_crc32c_.push_back(object.crc32c.has_value());
+}
+
+void CompactObjectList::Append(CompactObjectList const& other) {
+  auto const offset = names_.size();
+  names_.append(other.names_);
+  entries_.reserve(entries_.size() + other.entries_.size());
+  for (auto e : other.entries_) {
+    e.name_offset += offset;
+    entries_.push_back(e);
+  }
+  has_crc32c_.insert(has_crc32c_.end(), other.has_crc32c_.begin(),
+                     other.has_crc32c_.end());
+  prefixes_.insert(prefixes_.end(), other.prefixes_.begin(),
+                   other.prefixes_.end());
+}
+
+std::size_t CompactObjectList::memory_usage() const {
+  auto result = names_.capacity() + entries_.capacity() * sizeof(Entry) +
+                has_crc32c_.capacity() / 8;
+  for (auto const& p : prefixes_) result += sizeof(p) + p.capacity();
+  return result;
+}
+
+std::ostream& operator<<(std::ostream& os, CompactObjectMetadata const& rhs) {
+  os << "CompactObjectMetadata={name=" << rhs.name << ", size=" << rhs.size
+     << ", generation=" << rhs.generation << ", crc32c=";
+  if (rhs.crc32c.has_value()) {
+    os << *rhs.crc32c;
+  } else {
+    os << "<not set>";
+  }
+  return os << ", time_created=" << FormatRfc3339(rhs.time_created)
+            << ", updated=" << FormatRfc3339(rhs.updated) << "}";
+}
+
+namespace internal {
+
+absl::optional<std::uint32_t> DecodeCrc32c(std::string const& base64) {
+  if (base64.empty()) return absl::nullopt;
+  auto const bytes = Base64Decode(base64);
+  if (bytes.size() != sizeof(std::uint32_t)) return absl::nullopt;
+  std::uint32_t result = 0;
+  for (auto b : bytes) result = (result << 8) | b;
+  return result;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
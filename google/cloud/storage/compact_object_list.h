@@ -0,0 +1,135 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_COMPACT_OBJECT_LIST_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_COMPACT_OBJECT_LIST_H
+
+#include "google/cloud/storage/object_metadata.h"
+#include "google/cloud/storage/version.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * The subset of the object metadata kept by a `CompactObjectList`.
+ *
+ * The `name` refers to the storage owned by the list. It is only valid while
+ * the list exists, and it is invalidated by any changes to the list.
+ */
+struct CompactObjectMetadata {
+  absl::string_view name;
+  std::uint64_t size = 0;
+  std::int64_t generation = 0;
+  /// The CRC32C checksum, decoded from its base64 representation.
+  absl::optional<std::uint32_t> crc32c;
+  std::chrono::system_clock::time_point time_created;
+  std::chrono::system_clock::time_point updated;
+};
+
+/**
+ * A compact representation for the results of listing many objects.
+ *
+ * Each `ObjectMetadata` uses about 2 KiB of memory, mostly in its many
+ * `std::string`, `std::map`, and ACL members. That makes it impractical to
+ * keep the listing for a bucket with millions of objects in memory. This class
+ * keeps only the fields needed by most inventory applications. The object
+ * names are stored in a single buffer shared by all the objects, and the other
+ * fields use fixed-width integers, so each object uses about 48 bytes plus the
+ * length of its name.
+ *
+ * Use `Client::ListObjectsCompact()` to create these lists, the list responses
+ * are parsed directly into this representation.
+ *
+ * @par Example
+ * @code
+ * auto list = client.ListObjectsCompact("my-bucket");
+ * if (!list) throw std::runtime_error(list.status().message());
+ * std::uint64_t total = 0;
+ * for (std::size_t i = 0; i != list->size(); ++i) total += (*list)[i].size;
+ * @endcode
+ */
+class CompactObjectList {
+ public:
+  CompactObjectList() = default;
+
+  std::size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  /// Returns the metadata for the object at position @p i.
+  CompactObjectMetadata operator[](std::size_t i) const;
+
+  /**
+   * The prefixes found when listing with a `Delimiter`.
+   *
+   * Prefixes are rare compared to objects, they are stored as strings.
+   */
+  std::vector<std::string> const& prefixes() const { return prefixes_; }
+
+  /// Reserve space for @p objects objects, with names of @p name_bytes total.
+  void reserve(std::size_t objects, std::size_t name_bytes);
+
+  /// Copy the fields kept by this class from @p object.
+  void Append(ObjectMetadata const& object);
+
+  /// Add the object described by @p object, including a copy of its name.
+  void Append(CompactObjectMetadata const& object);
+
+  /// Add all the objects and prefixes in @p other, preserving their order.
+  void Append(CompactObjectList const& other);
+
+  void AddPrefix(std::string prefix) { prefixes_.push_back(std::move(prefix)); }
+
+  /// The memory allocated by this list, in bytes.
+  std::size_t memory_usage() const;
+
+ private:
+  // Timestamps are stored as microseconds since the epoch, the service
+  // reports them with millisecond precision.
+  struct Entry {
+    std::uint64_t name_offset;
+    std::uint32_t name_size;
+    std::uint32_t crc32c;
+    std::uint64_t size;
+    std::int64_t generation;
+    std::int64_t time_created;
+    std::int64_t updated;
+  };
+
+  std::string names_;
+  std::vector<Entry> entries_;
+  std::vector<bool> has_crc32c_;
+  std::vector<std::string> prefixes_;
+};
+
+std::ostream& operator<<(std::ostream& os, CompactObjectMetadata const& rhs);
+
+namespace internal {
+/// Decode a CRC32C checksum from its base64 representation.
+absl::optional<std::uint32_t> DecodeCrc32c(std::string const& base64);
+}  // namespace internal
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_COMPACT_OBJECT_LIST_H
@@ -0,0 +1,139 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/compact_object_list.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+CompactObjectMetadata MakeObject(std::string const& name, std::uint64_t size) {
+  CompactObjectMetadata object;
+  object.name = name;
+  object.size = size;
+  object.generation = 7;
+  object.crc32c = 0x22620404U;
+  object.time_created = std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::milliseconds(1526758274123)));
+  object.updated = object.time_created + std::chrono::seconds(10);
+  return object;
+}
+
+TEST(CompactObjectListTest, AppendAndRead) {
+  CompactObjectList list;
+  EXPECT_TRUE(list.empty());
+  auto const expected = MakeObject("foo/bar", 1024);
+  list.Append(expected);
+  list.Append(MakeObject("foo/baz", 2048));
+  ASSERT_EQ(2U, list.size());
+
+  auto const actual = list[0];
+  EXPECT_EQ("foo/bar", std::string(actual.name));
+  EXPECT_EQ(1024U, actual.size);
+  EXPECT_EQ(7, actual.generation);
+  EXPECT_EQ(expected.crc32c, actual.crc32c);
+  EXPECT_EQ(expected.time_created, actual.time_created);
+  EXPECT_EQ(expected.updated, actual.updated);
+  EXPECT_EQ("foo/baz", std::string(list[1].name));
+  EXPECT_EQ(2048U, list[1].size);
+}
+
+TEST(CompactObjectListTest, AppendObjectMetadata) {
+  auto metadata = internal::ObjectMetadataParser::FromJson(nlohmann::json{
+      {"bucket", "test-bucket"},
+      {"name", "test-object"},
+      {"generation", "42"},
+      {"size", "123"},
+      {"crc32c", "ImIEBA=="},
+      {"timeCreated", "2018-05-19T19:31:14Z"},
+      {"updated", "2018-05-19T19:31:24Z"},
+  });
+  ASSERT_STATUS_OK(metadata);
+  CompactObjectList list;
+  list.Append(*metadata);
+  ASSERT_EQ(1U, list.size());
+  EXPECT_EQ("test-object", std::string(list[0].name));
+  EXPECT_EQ(123U, list[0].size);
+  EXPECT_EQ(42, list[0].generation);
+  EXPECT_EQ(0x22620404U, list[0].crc32c.value_or(0));
+  EXPECT_EQ(metadata->time_created(), list[0].time_created);
+  EXPECT_EQ(metadata->updated(), list[0].updated);
+}
+
+TEST(CompactObjectListTest, MissingCrc32c) {
+  auto object = MakeObject("foo", 1);
+  object.crc32c = absl::nullopt;
+  CompactObjectList list;
+  list.Append(object);
+  EXPECT_FALSE(list[0].crc32c.has_value());
+}
+
+TEST(CompactObjectListTest, AppendList) {
+  CompactObjectList a;
+  a.Append(MakeObject("a0", 0));
+  a.AddPrefix("p0/");
+  CompactObjectList b;
+  b.Append(MakeObject("b0", 1));
+  b.Append(MakeObject("b1", 2));
+  b.AddPrefix("p1/");
+  a.Append(b);
+  ASSERT_EQ(3U, a.size());
+  EXPECT_EQ("a0", std::string(a[0].name));
+  EXPECT_EQ("b0", std::string(a[1].name));
+  EXPECT_EQ("b1", std::string(a[2].name));
+  EXPECT_EQ(2U, a[2].size);
+  EXPECT_THAT(a.prefixes(), ElementsAre("p0/", "p1/"));
+}
+
+TEST(CompactObjectListTest, MemoryUsage) {
+  auto constexpr kCount = 1000;
+  std::string const name(100, 'x');
+  CompactObjectList list;
+  list.reserve(kCount, kCount * name.size());
+  for (int i = 0; i != kCount; ++i) list.Append(MakeObject(name, 1));
+  // Each object should use far less memory than an `ObjectMetadata`.
+  EXPECT_LE(list.memory_usage(), kCount * (name.size() + 64));
+}
+
+TEST(CompactObjectListTest, DecodeCrc32c) {
+  EXPECT_EQ(0x22620404U, internal::DecodeCrc32c("ImIEBA==").value_or(0));
+  EXPECT_EQ(0U, internal::DecodeCrc32c("AAAAAA==").value_or(1));
+  EXPECT_FALSE(internal::DecodeCrc32c("").has_value());
+  EXPECT_FALSE(internal::DecodeCrc32c("AAAAAAAA").has_value());
+}
+
+TEST(CompactObjectListTest, Print) {
+  std::ostringstream os;
+  os << MakeObject("foo/bar", 1024);
+  EXPECT_THAT(os.str(), HasSubstr("name=foo/bar"));
+  EXPECT_THAT(os.str(), HasSubstr("size=1024"));
+  EXPECT_THAT(os.str(), HasSubstr("2018-05-19T19:31:14.123Z"));
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
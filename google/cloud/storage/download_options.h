@@ -17,6 +17,7 @@
 
 #include "google/cloud/storage/internal/complex_option.h"
 #include "google/cloud/storage/version.h"
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <string>
@@ -71,6 +72,52 @@ struct ReadLast : public internal::ComplexOption<ReadLast, std::int64_t> {
   static char const* name() { return "read-last"; }
 };
 
+/**
+ * Download an object using multiple concurrent streams.
+ *
+ * With the gRPC transport this option splits the download into (up to) this
+ * many ranges, and downloads the ranges concurrently, each stream using a
+ * different channel from the channel pool (see
+ * `ChannelOptions::set_channel_pool_size()`). The data is returned in order.
+ * Each stream downloads at least 8MiB, so small downloads use fewer streams.
+ * Only downloads with a `ReadRange` option are split, as the library needs to
+ * know the size of the download in advance.
+ *
+ * The REST transport ignores this option.
+ */
+struct ParallelReadStreams
+    : public internal::ComplexOption<ParallelReadStreams, std::size_t> {
+  using ComplexOption::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  ParallelReadStreams() = default;
+  static char const* name() { return "parallel-read-streams"; }
+};
+
+/**
+ * Download gzip-encoded objects compressed, and decompress them in the client.
+ *
+ * By default the service decompresses objects stored with
+ * `Content-Encoding: gzip` before sending them, what is known as
+ * [decompressive transcoding][transcoding]. With this option the library sends
+ * `Accept-Encoding: gzip`, so the data is transferred compressed, and
+ * decompresses it as the application reads from the stream. The checksums are
+ * validated against the compressed data. Objects that are not gzip-encoded are
+ * returned unmodified.
+ *
+ * This option is ignored for downloads with `ReadRange`, `ReadFromOffset`, or
+ * `ReadLast`, as a range of compressed data cannot be decompressed.
+ *
+ * [transcoding]: https://cloud.google.com/storage/docs/transcoding
+ */
+struct DecompressGzip : public internal::ComplexOption<DecompressGzip, bool> {
+  using ComplexOption::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  DecompressGzip() = default;
+  static char const* name() { return "decompress-gzip"; }
+};
+
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
 }  // namespace cloud
@@ -0,0 +1,138 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/async_client.h"
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/examples/storage_examples_common.h"
+#include "google/cloud/internal/getenv.h"
+#include <iostream>
+#include <vector>
+
+namespace {
+
+void AsyncGetObjectMetadata(google::cloud::storage::Client client,
+                            std::vector<std::string> const& argv) {
+  //! [async get object metadata]
+  namespace gcs = google::cloud::storage;
+  namespace gcs_ex = google::cloud::storage_experimental;
+  using ::google::cloud::future;
+  using ::google::cloud::StatusOr;
+  [](gcs::Client client, std::string const& bucket_name,
+     std::vector<std::string> const& object_names) {
+    gcs_ex::AsyncClient async(client);
+    // Start all the requests, then wait for the results.
+    std::vector<future<StatusOr<gcs::ObjectMetadata>>> pending;
+    for (auto const& name : object_names) {
+      pending.push_back(async.GetObjectMetadata(bucket_name, name));
+    }
+    for (auto& f : pending) {
+      StatusOr<gcs::ObjectMetadata> metadata = f.get();
+      if (!metadata) throw std::runtime_error(metadata.status().message());
+      std::cout << "The metadata for object " << metadata->name() << " is "
+                << *metadata << "\n";
+    }
+  }
+  //! [async get object metadata]
+  (std::move(client), argv.at(0), {argv.begin() + 1, argv.end()});
+}
+
+void AsyncInsertObject(google::cloud::storage::Client client,
+                       std::vector<std::string> const& argv) {
+  //! [async insert object]
+  namespace gcs = google::cloud::storage;
+  namespace gcs_ex = google::cloud::storage_experimental;
+  using ::google::cloud::future;
+  using ::google::cloud::StatusOr;
+  [](gcs::Client client, std::string const& bucket_name,
+     std::string const& object_name, std::string contents) {
+    gcs_ex::AsyncClient async(client);
+    future<void> done =
+        async.InsertObject(bucket_name, object_name, std::move(contents))
+            .then([](future<StatusOr<gcs::ObjectMetadata>> f) {
+              auto metadata = f.get();
+              if (!metadata) {
+                throw std::runtime_error(metadata.status().message());
+              }
+              std::cout << "Object successfully created: " << *metadata
+                        << "\n";
+            });
+    done.get();
+  }
+  //! [async insert object]
+  (std::move(client), argv.at(0), argv.at(1), argv.at(2));
+}
+
+void AsyncDeleteObject(google::cloud::storage::Client client,
+                       std::vector<std::string> const& argv) {
+  //! [async delete object]
+  namespace gcs = google::cloud::storage;
+  namespace gcs_ex = google::cloud::storage_experimental;
+  [](gcs::Client client, std::string const& bucket_name,
+     std::string const& object_name) {
+    gcs_ex::AsyncClient async(client);
+    google::cloud::Status status =
+        async.DeleteObject(bucket_name, object_name).get();
+    if (!status.ok()) throw std::runtime_error(status.message());
+    std::cout << "Deleted " << object_name << " in bucket " << bucket_name
+              << "\n";
+  }
+  //! [async delete object]
+  (std::move(client), argv.at(0), argv.at(1));
+}
+
+void RunAll(std::vector<std::string> const& argv) {
+  namespace examples = ::google::cloud::storage::examples;
+  namespace gcs = ::google::cloud::storage;
+
+  if (!argv.empty()) throw examples::Usage{"auto"};
+  examples::CheckEnvironmentVariablesAreSet({
+      "GOOGLE_CLOUD_CPP_STORAGE_TEST_BUCKET_NAME",
+  });
+  auto const bucket_name = google::cloud::internal::GetEnv(
+                               "GOOGLE_CLOUD_CPP_STORAGE_TEST_BUCKET_NAME")
+                               .value();
+  auto client = gcs::Client::CreateDefaultClient().value();
+
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const object_name =
+      examples::MakeRandomObjectName(generator, "object-");
+
+  std::cout << "\nRunning the AsyncInsertObject() example" << std::endl;
+  AsyncInsertObject(client, {bucket_name, object_name, "some contents"});
+
+  std::cout << "\nRunning the AsyncGetObjectMetadata() example" << std::endl;
+  AsyncGetObjectMetadata(client, {bucket_name, object_name});
+
+  std::cout << "\nRunning the AsyncDeleteObject() example" << std::endl;
+  AsyncDeleteObject(client, {bucket_name, object_name});
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  namespace examples = ::google::cloud::storage::examples;
+  examples::Example example({
+      examples::CreateCommandEntry("async-get-object-metadata",
+                                   {"<bucket-name>", "<object-name>..."},
+                                   AsyncGetObjectMetadata),
+      examples::CreateCommandEntry(
+          "async-insert-object",
+          {"<bucket-name>", "<object-name>", "<contents>"}, AsyncInsertObject),
+      examples::CreateCommandEntry("async-delete-object",
+                                   {"<bucket-name>", "<object-name>"},
+                                   AsyncDeleteObject),
+      {"auto", RunAll},
+  });
+  return example.Run(argc, argv);
+}
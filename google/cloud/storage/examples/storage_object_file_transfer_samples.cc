@@ -14,6 +14,7 @@
 
 #include "google/cloud/storage/client.h"
 #include "google/cloud/storage/examples/storage_examples_common.h"
+#include "google/cloud/storage/parallel_download.h"
 #include "google/cloud/storage/parallel_upload.h"
 #include "google/cloud/internal/getenv.h"
 #include <cstdlib>
@@ -104,6 +105,39 @@ void DownloadFile(google::cloud::storage::Client client,
   (std::move(client), argv.at(0), argv.at(1), argv.at(2));
 }
 
+void ParallelDownloadFile(google::cloud::storage::Client client,
+                          std::vector<std::string> const& argv) {
+  //! [parallel download file]
+  namespace gcs = google::cloud::storage;
+  [](gcs::Client client, std::string const& bucket_name,
+     std::string const& object_name, std::string const& file_name) {
+    google::cloud::Status status = gcs::ParallelDownloadFile(
+        std::move(client), bucket_name, object_name, file_name);
+    if (!status.ok()) throw std::runtime_error(status.message());
+
+    std::cout << "Downloaded " << object_name << " to " << file_name << "\n";
+  }
+  //! [parallel download file]
+  (std::move(client), argv.at(0), argv.at(1), argv.at(2));
+}
+
+void ResumableParallelDownload(google::cloud::storage::Client client,
+                               std::vector<std::string> const& argv) {
+  //! [resumable parallel download]
+  namespace gcs = google::cloud::storage;
+  [](gcs::Client client, std::string const& bucket_name,
+     std::string const& object_name, std::string const& file_name) {
+    // If a previous call was interrupted, this continues from its checkpoint.
+    google::cloud::Status status = gcs::ResumableParallelDownloadFile(
+        std::move(client), bucket_name, object_name, file_name);
+    if (!status.ok()) throw std::runtime_error(status.message());
+
+    std::cout << "Downloaded " << object_name << " to " << file_name << "\n";
+  }
+  //! [resumable parallel download]
+  (std::move(client), argv.at(0), argv.at(1), argv.at(2));
+}
+
 std::string MakeRandomFilename(
     google::cloud::internal::DefaultPRNG& generator) {
   auto constexpr kMaxBasenameLength = 28;
@@ -152,6 +186,13 @@ culpa qui officia deserunt mollit anim id est laborum.
   std::cout << "\nRunning the DownloadFile() example" << std::endl;
   DownloadFile(client, {bucket_name, object_name, filename_1});
 
+  std::cout << "\nRunning the ParallelDownloadFile() example" << std::endl;
+  ParallelDownloadFile(client, {bucket_name, object_name, filename_1});
+
+  std::cout << "\nRunning the ResumableParallelDownload() example"
+            << std::endl;
+  ResumableParallelDownload(client, {bucket_name, object_name, filename_1});
+
   std::cout << "\nDeleting uploaded object" << std::endl;
   (void)client.DeleteObject(bucket_name, object_name);
 
@@ -195,6 +236,14 @@ int main(int argc, char* argv[]) {
       examples::CreateCommandEntry(
           "download-file", {"<bucket-name>", "<object-name>", "<filename>"},
           DownloadFile),
+      examples::CreateCommandEntry(
+          "parallel-download-file",
+          {"<bucket-name>", "<object-name>", "<filename>"},
+          ParallelDownloadFile),
+      examples::CreateCommandEntry(
+          "resumable-parallel-download",
+          {"<bucket-name>", "<object-name>", "<filename>"},
+          ResumableParallelDownload),
       {"auto", RunAll},
   });
   return example.Run(argc, argv);
@@ -0,0 +1,54 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_FILE_IO_OPTIONS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_FILE_IO_OPTIONS_H
+
+#include "google/cloud/storage/internal/complex_option.h"
+#include "google/cloud/storage/version.h"
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * Use unbuffered (direct) I/O for the local file in `UploadFile()` and
+ * `DownloadToFile()`.
+ *
+ * By default these functions use `std::ifstream` and `std::ofstream`, the data
+ * goes through the operating system page cache. For multi-GiB transfers this
+ * evicts the application working set from the page cache, and adds a copy.
+ * With this option the file is opened with `O_DIRECT` (or equivalent) and read
+ * (or written) in large aligned blocks, a background thread reads the next
+ * block (or writes the previous block) while the current block is sent (or
+ * received) over the network.
+ *
+ * The library falls back to buffered I/O if the platform, or the filesystem
+ * containing the file, does not support direct I/O. The option is ignored on
+ * Windows.
+ */
+struct UseDirectFileIO : public internal::ComplexOption<UseDirectFileIO, bool> {
+  using ComplexOption<UseDirectFileIO, bool>::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  UseDirectFileIO() = default;
+  static char const* name() { return "use-direct-file-io"; }
+};
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_FILE_IO_OPTIONS_H
@@ -17,61 +17,88 @@
 """Automatically generated source lists for google_cloud_cpp_storage - DO NOT EDIT."""
 
 google_cloud_cpp_storage_hdrs = [
+    "batch_builder.h",
     "bucket_access_control.h",
     "bucket_metadata.h",
+    "buffer_pool.h",
+    "bulk_rewrite.h",
     "client.h",
+    "client_metrics.h",
     "client_options.h",
+    "compact_object_list.h",
     "download_options.h",
+    "file_io_options.h",
     "hashing_options.h",
+    "hedged_read_policy.h",
     "hmac_key_metadata.h",
     "iam_policy.h",
     "idempotency_policy.h",
     "internal/access_control_common.h",
     "internal/access_control_common_parser.h",
+    "internal/adaptive_chunk_size.h",
+    "internal/async_connection.h",
+    "internal/batch_requests.h",
     "internal/binary_data_as_debug_string.h",
+    "internal/bounded_queue.h",
     "internal/bucket_access_control_parser.h",
     "internal/bucket_acl_requests.h",
     "internal/bucket_metadata_parser.h",
     "internal/bucket_requests.h",
+    "internal/cached_object_read_source.h",
+    "internal/coalescing_client.h",
     "internal/common_metadata.h",
     "internal/common_metadata_parser.h",
     "internal/complex_option.h",
     "internal/compute_engine_util.h",
     "internal/const_buffer.h",
+    "internal/crc32c_combine.h",
     "internal/curl_client.h",
     "internal/curl_download_request.h",
     "internal/curl_handle.h",
     "internal/curl_handle_factory.h",
+    "internal/curl_multi_reactor.h",
     "internal/curl_request.h",
     "internal/curl_request_builder.h",
     "internal/curl_resumable_upload_session.h",
     "internal/curl_wrappers.h",
     "internal/default_object_acl_requests.h",
+    "internal/direct_file_io.h",
     "internal/empty_response.h",
+    "internal/expiring_lru_cache.h",
     "internal/generate_message_boundary.h",
     "internal/generic_object_request.h",
     "internal/generic_request.h",
     "internal/hash_validator.h",
+    "internal/gzip_object_read_source.h",
+    "internal/gzip_object_write_streambuf.h",
     "internal/hash_validator_impl.h",
+    "internal/hedged_object_read_source.h",
     "internal/hmac_key_metadata_parser.h",
     "internal/hmac_key_requests.h",
     "internal/http_response.h",
     "internal/lifecycle_rule_parser.h",
     "internal/logging_client.h",
     "internal/logging_resumable_upload_session.h",
+    "internal/mapped_file.h",
+    "internal/metadata_cache_client.h",
     "internal/metadata_parser.h",
+    "internal/metrics_client.h",
     "internal/notification_metadata_parser.h",
     "internal/notification_requests.h",
     "internal/object_access_control_parser.h",
     "internal/object_acl_requests.h",
     "internal/object_metadata_parser.h",
+    "internal/object_metadata_sax_parser.h",
     "internal/object_read_source.h",
     "internal/object_requests.h",
     "internal/object_streambuf.h",
     "internal/openssl_util.h",
+    "internal/parallel_object_read_source.h",
     "internal/parameter_pack_validation.h",
     "internal/patch_builder.h",
+    "internal/pipelined_object_write_streambuf.h",
     "internal/policy_document_request.h",
+    "internal/pooled_buffer.h",
     "internal/raw_client.h",
     "internal/raw_client_wrapper_utils.h",
     "internal/resumable_upload_session.h",
@@ -83,12 +110,16 @@ google_cloud_cpp_storage_hdrs = [
     "internal/sha256_hash.h",
     "internal/sign_blob_requests.h",
     "internal/signed_url_requests.h",
+    "internal/stage_timer.h",
+    "internal/token_bucket_rate_limiter.h",
     "internal/tuple_filter.h",
     "lifecycle_rule.h",
     "list_buckets_reader.h",
     "list_hmac_keys_reader.h",
     "list_objects_and_prefixes_reader.h",
+    "list_objects_options.h",
     "list_objects_reader.h",
+    "metadata_cache_invalidator.h",
     "notification_event_type.h",
     "notification_metadata.h",
     "notification_payload_format.h",
@@ -99,19 +130,29 @@ google_cloud_cpp_storage_hdrs = [
     "oauth2/credentials.h",
     "oauth2/google_application_default_credentials_file.h",
     "oauth2/google_credentials.h",
+    "oauth2/lazy_credentials.h",
     "oauth2/refreshing_credentials_wrapper.h",
     "oauth2/service_account_credentials.h",
     "object_access_control.h",
     "object_metadata.h",
+    "object_read_cache.h",
     "object_rewriter.h",
     "object_stream.h",
+    "operation_deadline.h",
     "override_default_project.h",
+    "parallel_download.h",
+    "parallel_list_objects.h",
     "parallel_upload.h",
     "policy_document.h",
+    "rate_limiter.h",
+    "read_ranges.h",
     "retry_policy.h",
     "service_account.h",
     "signed_url_options.h",
     "storage_class.h",
+    "streaming_copy.h",
+    "sync_directory.h",
+    "transfer_manager.h",
     "upload_options.h",
     "version.h",
     "version_info.h",
@@ -120,50 +161,73 @@ google_cloud_cpp_storage_hdrs = [
 ]
 
 google_cloud_cpp_storage_srcs = [
+    "batch_builder.cc",
     "bucket_access_control.cc",
     "bucket_metadata.cc",
+    "buffer_pool.cc",
+    "bulk_rewrite.cc",
     "client.cc",
+    "client_metrics.cc",
     "client_options.cc",
+    "compact_object_list.cc",
     "hashing_options.cc",
+    "hedged_read_policy.cc",
     "hmac_key_metadata.cc",
     "iam_policy.cc",
     "idempotency_policy.cc",
     "internal/access_control_common_parser.cc",
+    "internal/adaptive_chunk_size.cc",
+    "internal/async_connection.cc",
+    "internal/batch_requests.cc",
     "internal/binary_data_as_debug_string.cc",
     "internal/bucket_access_control_parser.cc",
     "internal/bucket_acl_requests.cc",
     "internal/bucket_metadata_parser.cc",
     "internal/bucket_requests.cc",
+    "internal/cached_object_read_source.cc",
+    "internal/coalescing_client.cc",
     "internal/compute_engine_util.cc",
     "internal/const_buffer.cc",
+    "internal/crc32c_combine.cc",
     "internal/curl_client.cc",
     "internal/curl_download_request.cc",
     "internal/curl_handle.cc",
     "internal/curl_handle_factory.cc",
+    "internal/curl_multi_reactor.cc",
     "internal/curl_request.cc",
     "internal/curl_request_builder.cc",
     "internal/curl_resumable_upload_session.cc",
     "internal/curl_wrappers.cc",
     "internal/default_object_acl_requests.cc",
+    "internal/direct_file_io.cc",
     "internal/empty_response.cc",
     "internal/hash_validator.cc",
+    "internal/gzip_object_read_source.cc",
+    "internal/gzip_object_write_streambuf.cc",
     "internal/hash_validator_impl.cc",
+    "internal/hedged_object_read_source.cc",
     "internal/hmac_key_metadata_parser.cc",
     "internal/hmac_key_requests.cc",
     "internal/http_response.cc",
     "internal/lifecycle_rule_parser.cc",
     "internal/logging_client.cc",
     "internal/logging_resumable_upload_session.cc",
+    "internal/mapped_file.cc",
+    "internal/metadata_cache_client.cc",
     "internal/metadata_parser.cc",
+    "internal/metrics_client.cc",
     "internal/notification_metadata_parser.cc",
     "internal/notification_requests.cc",
     "internal/object_access_control_parser.cc",
     "internal/object_acl_requests.cc",
     "internal/object_metadata_parser.cc",
+    "internal/object_metadata_sax_parser.cc",
     "internal/object_requests.cc",
     "internal/object_streambuf.cc",
     "internal/openssl_util.cc",
+    "internal/parallel_object_read_source.cc",
     "internal/patch_builder.cc",
+    "internal/pipelined_object_write_streambuf.cc",
     "internal/policy_document_request.cc",
     "internal/resumable_upload_session.cc",
     "internal/retry_client.cc",
@@ -174,10 +238,13 @@ google_cloud_cpp_storage_srcs = [
     "internal/sha256_hash.cc",
     "internal/sign_blob_requests.cc",
     "internal/signed_url_requests.cc",
+    "internal/stage_timer.cc",
+    "internal/token_bucket_rate_limiter.cc",
     "lifecycle_rule.cc",
     "list_buckets_reader.cc",
     "list_hmac_keys_reader.cc",
     "list_objects_reader.cc",
+    "metadata_cache_invalidator.cc",
     "notification_metadata.cc",
     "oauth2/anonymous_credentials.cc",
     "oauth2/authorized_user_credentials.cc",
@@ -185,15 +252,25 @@ google_cloud_cpp_storage_srcs = [
     "oauth2/credentials.cc",
     "oauth2/google_application_default_credentials_file.cc",
     "oauth2/google_credentials.cc",
+    "oauth2/lazy_credentials.cc",
     "oauth2/refreshing_credentials_wrapper.cc",
     "oauth2/service_account_credentials.cc",
     "object_access_control.cc",
     "object_metadata.cc",
+    "object_read_cache.cc",
     "object_rewriter.cc",
     "object_stream.cc",
+    "operation_deadline.cc",
+    "parallel_download.cc",
+    "parallel_list_objects.cc",
     "parallel_upload.cc",
     "policy_document.cc",
+    "rate_limiter.cc",
+    "read_ranges.cc",
     "service_account.cc",
+    "streaming_copy.cc",
+    "sync_directory.cc",
+    "transfer_manager.cc",
     "version.cc",
     "well_known_headers.cc",
     "well_known_parameters.cc",
@@ -18,11 +18,13 @@
 
 google_cloud_cpp_storage_grpc_hdrs = [
     "grpc_plugin.h",
+    "internal/grpc_channel_pool.h",
     "internal/grpc_client.h",
     "internal/grpc_object_read_source.h",
     "internal/grpc_resumable_upload_session.h",
     "internal/grpc_resumable_upload_session_url.h",
     "internal/hybrid_client.h",
+    "internal/transport_selector.h",
 ]
 
 google_cloud_cpp_storage_grpc_srcs = [
@@ -32,4 +34,5 @@ google_cloud_cpp_storage_grpc_srcs = [
     "internal/grpc_resumable_upload_session.cc",
     "internal/grpc_resumable_upload_session_url.cc",
     "internal/hybrid_client.cc",
+    "internal/transport_selector.cc",
 ]
@@ -23,11 +23,13 @@ namespace storage_experimental {
 inline namespace STORAGE_CLIENT_NS {
 
 namespace {
-bool UseGrpcForMetadata() {
-  auto v =
-      google::cloud::internal::GetEnv("GOOGLE_CLOUD_CPP_STORAGE_GRPC_CONFIG")
-          .value_or("");
-  return v.find("metadata") != std::string::npos;
+std::string GrpcConfig() {
+  return google::cloud::internal::GetEnv("GOOGLE_CLOUD_CPP_STORAGE_GRPC_CONFIG")
+      .value_or("");
+}
+
+bool UseGrpcForMetadata(std::string const& config) {
+  return config.find("metadata") != std::string::npos;
 }
 }  // namespace
 
@@ -40,12 +42,14 @@ StatusOr<google::cloud::storage::Client> DefaultGrpcClient() {
 
 google::cloud::storage::Client DefaultGrpcClient(
     google::cloud::storage::ClientOptions options, int channel_id) {
-  if (UseGrpcForMetadata()) {
+  auto const config = GrpcConfig();
+  if (UseGrpcForMetadata(config)) {
     return storage::Client(std::make_shared<storage::internal::GrpcClient>(
         std::move(options), channel_id));
   }
   return storage::Client(std::make_shared<storage::internal::HybridClient>(
-      std::move(options), channel_id));
+      std::move(options), channel_id,
+      storage::internal::TransportSelector::FromConfig(config)));
 }
 
 }  // namespace STORAGE_CLIENT_NS
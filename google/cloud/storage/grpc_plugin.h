@@ -33,6 +33,19 @@ inline namespace STORAGE_CLIENT_NS {
 /**
  * Create a `google::cloud::storage::Client` object configured to use gRPC.
  *
+ * By default media uploads and downloads use gRPC, and all other operations
+ * use JSON. The `GOOGLE_CLOUD_CPP_STORAGE_GRPC_CONFIG` environment variable
+ * changes this routing, it is a comma-separated list of:
+ * - `metadata`: use gRPC for all the operations.
+ * - `adaptive`: measure the throughput of both transports, per operation and
+ *   object size, and route uploads and downloads to the faster transport.
+ * - `<operation>=<transport>`: pin `insert`, `read`, or `resumable` (uploads)
+ *   to `grpc` or `json`.
+ *
+ * On Google Cloud the gRPC channels can use DirectPath, which connects
+ * directly to the GCS backends, see `ChannelOptions::set_enable_direct_path()`
+ * in `options.channel_options()`.
+ *
  * @note the Credentials parameter in the configuration is ignored. The gRPC
  *     client only supports Google Default Credentials.
  *
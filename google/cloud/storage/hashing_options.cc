@@ -14,6 +14,7 @@
 
 #include "google/cloud/storage/hashing_options.h"
 #include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/storage/internal/stage_timer.h"
 #include "google/cloud/internal/big_endian.h"
 #include <crc32c/crc32c.h>
 #include <openssl/md5.h>
@@ -23,17 +24,19 @@ namespace google {
 namespace cloud {
 namespace storage {
 inline namespace STORAGE_CLIENT_NS {
-std::string ComputeMD5Hash(std::string const& payload) {
+std::string ComputeMD5Hash(absl::string_view payload) {
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(internal::Stage::kHashing);
   MD5_CTX md5;
   MD5_Init(&md5);
-  MD5_Update(&md5, payload.c_str(), payload.size());
+  MD5_Update(&md5, payload.data(), payload.size());
 
   std::string hash(MD5_DIGEST_LENGTH, ' ');
   MD5_Final(reinterpret_cast<unsigned char*>(&hash[0]), &md5);
   return internal::Base64Encode(hash);
 }
 
-std::string ComputeCrc32cChecksum(std::string const& payload) {
+std::string ComputeCrc32cChecksum(absl::string_view payload) {
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(internal::Stage::kHashing);
   auto checksum = crc32c::Extend(
       0, reinterpret_cast<std::uint8_t const*>(payload.data()), payload.size());
   std::string const hash = google::cloud::internal::EncodeBigEndian(checksum);
@@ -17,6 +17,7 @@
 
 #include "google/cloud/storage/internal/complex_option.h"
 #include "google/cloud/storage/version.h"
+#include "absl/strings/string_view.h"
 #include <string>
 
 namespace google {
@@ -43,7 +44,7 @@ struct MD5HashValue
 /**
  * Compute the MD5 Hash of a string in the format preferred by GCS.
  */
-std::string ComputeMD5Hash(std::string const& payload);
+std::string ComputeMD5Hash(absl::string_view payload);
 
 /**
  * Disable or enable MD5 Hashing computations.
@@ -92,7 +93,7 @@ struct Crc32cChecksumValue
 /**
  * Compute the MD5 Hash of a string in the format preferred by GCS.
  */
-std::string ComputeCrc32cChecksum(std::string const& payload);
+std::string ComputeCrc32cChecksum(absl::string_view payload);
 
 /**
  * Disable MD5 Hashing computations.
@@ -114,6 +115,29 @@ struct DisableCrc32cChecksum
   static char const* name() { return "disable-crc32c-checksum"; }
 };
 
+/**
+ * Compute the upload or download checksums and hashes on a separate thread.
+ *
+ * By default the client library computes the CRC32C checksum and MD5 hash (if
+ * enabled) on the thread that calls `read()` or `write()`, which serializes
+ * the hash computations with the network I/O. With this option the data is
+ * copied to a background thread that computes the hashes while the calling
+ * thread continues with the next read or write. The amount of data buffered
+ * for the background thread is bounded, the calling thread blocks if the
+ * background thread falls behind.
+ *
+ * This is most useful for single-stream transfers with `EnableMD5Hash()`, as
+ * computing MD5 hashes is slower than computing CRC32C checksums.
+ */
+struct UseBackgroundHashing
+    : public internal::ComplexOption<UseBackgroundHashing, bool> {
+  using ComplexOption<UseBackgroundHashing, bool>::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  UseBackgroundHashing() = default;
+  static char const* name() { return "use-background-hashing"; }
+};
+
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
 }  // namespace cloud
@@ -0,0 +1,64 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/hedged_read_policy.h"
+#include "absl/memory/memory.h"
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+
+std::unique_ptr<HedgedReadPolicy> FixedDelayHedgedReadPolicy::clone() const {
+  return absl::make_unique<FixedDelayHedgedReadPolicy>(*this);
+}
+
+PercentileHedgedReadPolicy::PercentileHedgedReadPolicy(
+    PercentileHedgedReadPolicy const& rhs)
+    : percentile_(rhs.percentile_),
+      initial_delay_(rhs.initial_delay_),
+      window_size_(rhs.window_size_) {
+  std::lock_guard<std::mutex> lk(rhs.mu_);
+  current_ = rhs.current_;
+  previous_ = rhs.previous_;
+}
+
+std::unique_ptr<HedgedReadPolicy> PercentileHedgedReadPolicy::clone() const {
+  return absl::make_unique<PercentileHedgedReadPolicy>(*this);
+}
+
+absl::optional<std::chrono::microseconds>
+PercentileHedgedReadPolicy::HedgeDelay() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (current_.count() + previous_.count() < window_size_) {
+    return initial_delay_;
+  }
+  auto recent = previous_;
+  recent.Merge(current_);
+  return recent.Percentile(percentile_);
+}
+
+void PercentileHedgedReadPolicy::OnFirstByte(
+    std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lk(mu_);
+  current_.Record(latency);
+  if (current_.count() < window_size_) return;
+  previous_ = std::move(current_);
+  current_ = LatencyHistogram();
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
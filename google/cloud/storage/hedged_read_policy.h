@@ -0,0 +1,132 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_HEDGED_READ_POLICY_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_HEDGED_READ_POLICY_H
+
+#include "google/cloud/storage/client_metrics.h"
+#include "google/cloud/storage/version.h"
+#include "absl/types/optional.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * Define the interface for the hedged read policy.
+ *
+ * A hedged download sends a second, identical, request if the first request
+ * does not return any data after a (short) delay. The download continues with
+ * whichever request returns data first, and the other request is cancelled.
+ * This reduces the tail latency of downloads for small objects, where the time
+ * to receive the first byte dominates the total latency, at the cost of sending
+ * more requests to the service.
+ *
+ * Hedging is disabled by default. To enable it, pass an instance of this policy
+ * to the `Client` constructor, together with any other policies, for example:
+ *
+ * @code
+ * namespace gcs = google::cloud::storage;
+ * auto client = gcs::Client(
+ *     options,
+ *     gcs::PercentileHedgedReadPolicy(95, std::chrono::milliseconds(50)));
+ * @endcode
+ *
+ * Implementations of this interface must be thread-safe, the `Client` shares
+ * the policy across all its downloads.
+ */
+class HedgedReadPolicy {
+ public:
+  virtual ~HedgedReadPolicy() = default;
+
+  /// Create a new copy of this object.
+  virtual std::unique_ptr<HedgedReadPolicy> clone() const = 0;
+
+  /**
+   * How long to wait for the first response before sending a second request.
+   *
+   * Returning `absl::nullopt` disables hedging for the next download.
+   */
+  virtual absl::optional<std::chrono::microseconds> HedgeDelay() const = 0;
+
+  /// Called with the time to receive the first response of each download.
+  virtual void OnFirstByte(std::chrono::microseconds latency) = 0;
+};
+
+/// Send the second request after a fixed delay.
+class FixedDelayHedgedReadPolicy : public HedgedReadPolicy {
+ public:
+  template <typename Rep, typename Period>
+  explicit FixedDelayHedgedReadPolicy(std::chrono::duration<Rep, Period> delay)
+      : delay_(std::chrono::duration_cast<std::chrono::microseconds>(delay)) {}
+
+  std::unique_ptr<HedgedReadPolicy> clone() const override;
+  absl::optional<std::chrono::microseconds> HedgeDelay() const override {
+    return delay_;
+  }
+  void OnFirstByte(std::chrono::microseconds) override {}
+
+ private:
+  std::chrono::microseconds delay_;
+};
+
+/**
+ * Send the second request once a download is slower than most downloads.
+ *
+ * This policy tracks the time to receive the first response of recent
+ * downloads, and sends the second request once a download takes longer than
+ * the given percentile of them. For example, with `percentile == 95` about 5%
+ * of the downloads send a second request.
+ *
+ * Until `window_size` downloads complete this policy uses the
+ * `initial_delay`. The policy keeps the statistics for the last (approximately)
+ * `2 * window_size` downloads, so it adapts to changes in the service latency.
+ */
+class PercentileHedgedReadPolicy : public HedgedReadPolicy {
+ public:
+  template <typename Rep, typename Period>
+  PercentileHedgedReadPolicy(double percentile,
+                             std::chrono::duration<Rep, Period> initial_delay,
+                             std::uint64_t window_size = 1000)
+      : percentile_(percentile),
+        initial_delay_(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                initial_delay)),
+        window_size_(window_size == 0 ? 1 : window_size) {}
+
+  PercentileHedgedReadPolicy(PercentileHedgedReadPolicy const& rhs);
+
+  std::unique_ptr<HedgedReadPolicy> clone() const override;
+  absl::optional<std::chrono::microseconds> HedgeDelay() const override;
+  void OnFirstByte(std::chrono::microseconds latency) override;
+
+ private:
+  double percentile_;
+  std::chrono::microseconds initial_delay_;
+  std::uint64_t window_size_;
+  mutable std::mutex mu_;
+  LatencyHistogram current_;
+  LatencyHistogram previous_;
+};
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_HEDGED_READ_POLICY_H
@@ -0,0 +1,61 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/hedged_read_policy.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using ::testing::Optional;
+
+TEST(HedgedReadPolicyTest, FixedDelay) {
+  FixedDelayHedgedReadPolicy tested(milliseconds(20));
+  EXPECT_THAT(tested.HedgeDelay(), Optional(microseconds(20000)));
+  tested.OnFirstByte(milliseconds(100));
+  EXPECT_THAT(tested.clone()->HedgeDelay(), Optional(microseconds(20000)));
+}
+
+TEST(HedgedReadPolicyTest, Percentile) {
+  PercentileHedgedReadPolicy tested(90, milliseconds(50), 100);
+  EXPECT_THAT(tested.HedgeDelay(), Optional(microseconds(50000)));
+  for (int i = 0; i != 99; ++i) tested.OnFirstByte(microseconds(1000));
+  EXPECT_THAT(tested.HedgeDelay(), Optional(microseconds(50000)));
+  tested.OnFirstByte(microseconds(1000));
+  EXPECT_THAT(tested.HedgeDelay(), Optional(microseconds(1000)));
+
+  // The clone starts with the same statistics.
+  auto clone = tested.clone();
+  EXPECT_THAT(clone->HedgeDelay(), Optional(microseconds(1000)));
+}
+
+TEST(HedgedReadPolicyTest, PercentileAdapts) {
+  PercentileHedgedReadPolicy tested(50, milliseconds(50), 10);
+  for (int i = 0; i != 10; ++i) tested.OnFirstByte(microseconds(1000));
+  EXPECT_THAT(tested.HedgeDelay(), Optional(microseconds(1000)));
+  // Older samples are discarded after two windows.
+  for (int i = 0; i != 20; ++i) tested.OnFirstByte(microseconds(8000));
+  EXPECT_THAT(tested.HedgeDelay(), Optional(microseconds(8000)));
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,79 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/adaptive_chunk_size.h"
+#include "google/cloud/storage/internal/object_requests.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+auto constexpr kQuantum = UploadChunkRequest::kChunkSizeQuantum;
+// Grow the chunk size only while the goodput improves by at least this ratio.
+double constexpr kGrowthThreshold = 1.1;
+}  // namespace
+
+AdaptiveChunkSize::AdaptiveChunkSize(std::size_t initial_chunk_size,
+                                     std::size_t maximum_chunk_size)
+    : maximum_chunk_size_(UploadChunkRequest::RoundUpToQuantum(
+          (std::max)(maximum_chunk_size, kQuantum))),
+      chunk_size_((std::min)(UploadChunkRequest::RoundUpToQuantum(
+                                 (std::max)(initial_chunk_size, kQuantum)),
+                             maximum_chunk_size_)) {}
+
+void AdaptiveChunkSize::OnChunkUploaded(std::size_t bytes,
+                                        std::chrono::microseconds elapsed,
+                                        std::uint64_t retries) {
+  if (retries != 0) {
+    growing_ = false;
+    last_goodput_ = 0;
+    Shrink();
+    return;
+  }
+  if (bytes == 0 || elapsed.count() <= 0) return;
+
+  auto const goodput = static_cast<double>(bytes) /
+                       std::chrono::duration<double>(elapsed).count();
+  if (growing_) {
+    if (last_goodput_ == 0 || goodput >= last_goodput_ * kGrowthThreshold) {
+      Grow();
+    } else {
+      growing_ = false;
+    }
+  } else if (goodput < best_goodput_ / 2) {
+    // Measure against the new conditions, so a single degradation does not
+    // shrink the chunk size all the way to the minimum.
+    best_goodput_ = 0;
+    Shrink();
+  }
+  last_goodput_ = goodput;
+  best_goodput_ = (std::max)(best_goodput_, goodput);
+}
+
+void AdaptiveChunkSize::Grow() {
+  chunk_size_ = (std::min)(2 * chunk_size_, maximum_chunk_size_);
+}
+
+void AdaptiveChunkSize::Shrink() {
+  chunk_size_ = (std::max)(chunk_size_ / 2 / kQuantum * kQuantum, kQuantum);
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
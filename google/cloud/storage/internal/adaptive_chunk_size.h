@@ -0,0 +1,76 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_ADAPTIVE_CHUNK_SIZE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_ADAPTIVE_CHUNK_SIZE_H
+
+#include "google/cloud/storage/version.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Computes the chunk size for resumable uploads based on the observed goodput.
+ *
+ * The chunk size starts at the initial value and doubles after each chunk
+ * while the goodput (bytes committed per second) improves by at least 10%.
+ * Once the improvements stop the chunk size remains stable. Chunks that
+ * required retries halve the chunk size and stop any further growth, as do
+ * chunks with a goodput below half of the best observed value.
+ *
+ * The chunk size is always a multiple of the 256KiB quantum required by GCS,
+ * and it is always in the `[256KiB, maximum]` range.
+ */
+class AdaptiveChunkSize {
+ public:
+  AdaptiveChunkSize(std::size_t initial_chunk_size,
+                    std::size_t maximum_chunk_size);
+
+  /// The size for the next chunk.
+  std::size_t chunk_size() const { return chunk_size_; }
+
+  /**
+   * Update the chunk size after an upload.
+   *
+   * @param bytes the number of bytes uploaded.
+   * @param elapsed the time to upload the bytes, including any retries.
+   * @param retries the number of retries required to upload the bytes.
+   */
+  void OnChunkUploaded(std::size_t bytes, std::chrono::microseconds elapsed,
+                       std::uint64_t retries);
+
+ private:
+  void Grow();
+  void Shrink();
+
+  std::size_t maximum_chunk_size_;
+  std::size_t chunk_size_;
+  bool growing_ = true;
+  double last_goodput_ = 0;
+  double best_goodput_ = 0;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_ADAPTIVE_CHUNK_SIZE_H
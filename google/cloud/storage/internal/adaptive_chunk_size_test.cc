@@ -0,0 +1,107 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/adaptive_chunk_size.h"
+#include "google/cloud/storage/internal/object_requests.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using std::chrono::milliseconds;
+
+auto constexpr kQuantum = UploadChunkRequest::kChunkSizeQuantum;
+
+TEST(AdaptiveChunkSizeTest, Clamped) {
+  EXPECT_EQ(kQuantum, AdaptiveChunkSize(0, 0).chunk_size());
+  EXPECT_EQ(2 * kQuantum, AdaptiveChunkSize(kQuantum + 1, 8 * kQuantum)
+                              .chunk_size());
+  EXPECT_EQ(4 * kQuantum,
+            AdaptiveChunkSize(16 * kQuantum, 4 * kQuantum).chunk_size());
+  EXPECT_EQ(4 * kQuantum,
+            AdaptiveChunkSize(16 * kQuantum, 3 * kQuantum + 1).chunk_size());
+}
+
+TEST(AdaptiveChunkSizeTest, GrowsWhileGoodputImproves) {
+  AdaptiveChunkSize tested(kQuantum, 8 * kQuantum);
+  // The latency dominates, so larger chunks improve the goodput.
+  tested.OnChunkUploaded(kQuantum, milliseconds(100), 0);
+  EXPECT_EQ(2 * kQuantum, tested.chunk_size());
+  tested.OnChunkUploaded(2 * kQuantum, milliseconds(110), 0);
+  EXPECT_EQ(4 * kQuantum, tested.chunk_size());
+  tested.OnChunkUploaded(4 * kQuantum, milliseconds(120), 0);
+  EXPECT_EQ(8 * kQuantum, tested.chunk_size());
+  // Never grows past the maximum.
+  tested.OnChunkUploaded(8 * kQuantum, milliseconds(130), 0);
+  EXPECT_EQ(8 * kQuantum, tested.chunk_size());
+}
+
+TEST(AdaptiveChunkSizeTest, StopsGrowingWhenGoodputIsFlat) {
+  AdaptiveChunkSize tested(kQuantum, 64 * kQuantum);
+  tested.OnChunkUploaded(kQuantum, milliseconds(100), 0);
+  EXPECT_EQ(2 * kQuantum, tested.chunk_size());
+  // The bandwidth is saturated, a larger chunk takes proportionally longer.
+  tested.OnChunkUploaded(2 * kQuantum, milliseconds(200), 0);
+  EXPECT_EQ(2 * kQuantum, tested.chunk_size());
+  // Once growth stops it does not resume, even if the goodput improves.
+  tested.OnChunkUploaded(2 * kQuantum, milliseconds(100), 0);
+  EXPECT_EQ(2 * kQuantum, tested.chunk_size());
+}
+
+TEST(AdaptiveChunkSizeTest, ShrinksOnRetries) {
+  AdaptiveChunkSize tested(8 * kQuantum, 64 * kQuantum);
+  tested.OnChunkUploaded(8 * kQuantum, milliseconds(100), 1);
+  EXPECT_EQ(4 * kQuantum, tested.chunk_size());
+  // Growth does not resume after a retry.
+  tested.OnChunkUploaded(4 * kQuantum, milliseconds(10), 0);
+  EXPECT_EQ(4 * kQuantum, tested.chunk_size());
+  tested.OnChunkUploaded(4 * kQuantum, milliseconds(100), 2);
+  EXPECT_EQ(2 * kQuantum, tested.chunk_size());
+  tested.OnChunkUploaded(2 * kQuantum, milliseconds(100), 1);
+  EXPECT_EQ(kQuantum, tested.chunk_size());
+  // Never shrinks below the quantum.
+  tested.OnChunkUploaded(kQuantum, milliseconds(100), 1);
+  EXPECT_EQ(kQuantum, tested.chunk_size());
+}
+
+TEST(AdaptiveChunkSizeTest, ShrinksOnLowGoodput) {
+  AdaptiveChunkSize tested(kQuantum, 64 * kQuantum);
+  tested.OnChunkUploaded(kQuantum, milliseconds(100), 0);
+  tested.OnChunkUploaded(2 * kQuantum, milliseconds(200), 0);
+  EXPECT_EQ(2 * kQuantum, tested.chunk_size());
+  // The goodput drops to less than half of the best value.
+  tested.OnChunkUploaded(2 * kQuantum, milliseconds(500), 0);
+  EXPECT_EQ(kQuantum, tested.chunk_size());
+  // The new conditions become the baseline.
+  tested.OnChunkUploaded(kQuantum, milliseconds(250), 0);
+  EXPECT_EQ(kQuantum, tested.chunk_size());
+}
+
+TEST(AdaptiveChunkSizeTest, IgnoresEmptyMeasurements) {
+  AdaptiveChunkSize tested(kQuantum, 64 * kQuantum);
+  tested.OnChunkUploaded(0, milliseconds(100), 0);
+  tested.OnChunkUploaded(kQuantum, milliseconds(0), 0);
+  EXPECT_EQ(kQuantum, tested.chunk_size());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,285 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/async_connection.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+/**
+ * The work queue shared by the background threads.
+ *
+ * The threads keep a reference to the queue, so it outlives the
+ * `AsyncConnection` if the connection is released from one of the threads,
+ * for example, in a `.then()` continuation.
+ */
+class WorkQueue {
+ public:
+  void Push(std::function<void()> work) {
+    std::unique_lock<std::mutex> lk(mu_);
+    queue_.push_back(std::move(work));
+    lk.unlock();
+    cv_.notify_one();
+  }
+
+  void Shutdown() {
+    std::unique_lock<std::mutex> lk(mu_);
+    shutdown_ = true;
+    lk.unlock();
+    cv_.notify_all();
+  }
+
+  /// Run work until the queue is shutdown and drained.
+  void Run() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+      cv_.wait(lk, [this] { return shutdown_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+      auto work = std::move(queue_.front());
+      queue_.pop_front();
+      lk.unlock();
+      work();
+      lk.lock();
+    }
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> queue_;
+  bool shutdown_ = false;
+};
+
+class BackgroundThreadsAsyncConnection : public AsyncConnection {
+ public:
+  BackgroundThreadsAsyncConnection(std::shared_ptr<RawClient> client,
+                                   std::size_t background_threads)
+      : client_(std::move(client)), queue_(std::make_shared<WorkQueue>()) {
+    if (background_threads == 0) background_threads = 1;
+    threads_.reserve(background_threads);
+    for (std::size_t i = 0; i != background_threads; ++i) {
+      auto queue = queue_;
+      threads_.emplace_back([queue] { queue->Run(); });
+    }
+  }
+
+  ~BackgroundThreadsAsyncConnection() override {
+    queue_->Shutdown();
+    for (auto& t : threads_) {
+      // The last reference may be released by one of the background threads,
+      // it cannot join itself.
+      if (t.get_id() == std::this_thread::get_id()) {
+        t.detach();
+        continue;
+      }
+      t.join();
+    }
+  }
+
+  future<StatusOr<ObjectMetadata>> AsyncGetObjectMetadata(
+      GetObjectMetadataRequest const& request) override {
+    return Schedule<StatusOr<ObjectMetadata>>(
+        [request](RawClient& client) {
+          return client.GetObjectMetadata(request);
+        });
+  }
+
+  future<StatusOr<ObjectMetadata>> AsyncInsertObjectMedia(
+      InsertObjectMediaRequest const& request) override {
+    return Schedule<StatusOr<ObjectMetadata>>(
+        [request](RawClient& client) {
+          return client.InsertObjectMedia(request);
+        });
+  }
+
+  future<StatusOr<EmptyResponse>> AsyncDeleteObject(
+      DeleteObjectRequest const& request) override {
+    return Schedule<StatusOr<EmptyResponse>>(
+        [request](RawClient& client) { return client.DeleteObject(request); });
+  }
+
+ private:
+  template <typename T, typename Functor>
+  future<T> Schedule(Functor&& functor) {
+    // `std::function<>` requires copyable functors, and `promise<T>` is not.
+    auto p = std::make_shared<promise<T>>();
+    auto f = p->get_future();
+    auto client = client_;
+    queue_->Push([p, client, functor] { p->set_value(functor(*client)); });
+    return f;
+  }
+
+  std::shared_ptr<RawClient> client_;
+  std::shared_ptr<WorkQueue> queue_;
+  std::vector<std::thread> threads_;
+};
+
+/**
+ * Retry an asynchronous operation until it succeeds or the policies stop it.
+ *
+ * The loop holds a reference to itself while an attempt or a backoff timer is
+ * pending, it is released once the returned future is satisfied.
+ */
+template <typename T>
+class AsyncRetryLoop : public std::enable_shared_from_this<AsyncRetryLoop<T>> {
+ public:
+  AsyncRetryLoop(std::shared_ptr<CurlMultiReactor> reactor,
+                 std::unique_ptr<RetryPolicy> retry_policy,
+                 std::unique_ptr<BackoffPolicy> backoff_policy,
+                 bool idempotent, char const* location,
+                 std::function<future<T>()> attempt)
+      : reactor_(std::move(reactor)),
+        retry_policy_(std::move(retry_policy)),
+        backoff_policy_(std::move(backoff_policy)),
+        idempotent_(idempotent),
+        location_(location),
+        attempt_(std::move(attempt)) {}
+
+  future<T> Start() {
+    auto f = promise_.get_future();
+    StartAttempt();
+    return f;
+  }
+
+ private:
+  void StartAttempt() {
+    auto self = this->shared_from_this();
+    attempt_().then([self](future<T> f) { self->OnAttempt(f.get()); });
+  }
+
+  void OnAttempt(T result) {
+    if (result.ok()) {
+      promise_.set_value(std::move(result));
+      return;
+    }
+    auto last_status = std::move(result).status();
+    if (!idempotent_) {
+      return SetError("Error in non-idempotent operation ", last_status);
+    }
+    if (!retry_policy_->OnFailure(last_status)) {
+      if (StatusTraits::IsPermanentFailure(last_status)) {
+        return SetError("Permanent error in ", last_status);
+      }
+      return SetError("Retry policy exhausted in ", last_status);
+    }
+    auto self = this->shared_from_this();
+    reactor_->MakeRelativeTimer(backoff_policy_->OnCompletion())
+        .then([self, last_status](future<CurlMultiReactor::TimerResult> f) {
+          if (!f.get()) {
+            return self->SetError("Retry loop cancelled in ", last_status);
+          }
+          self->StartAttempt();
+        });
+  }
+
+  void SetError(char const* prefix, Status const& last_status) {
+    std::ostringstream os;
+    os << prefix << location_ << ": " << last_status;
+    promise_.set_value(Status(last_status.code(), std::move(os).str()));
+  }
+
+  std::shared_ptr<CurlMultiReactor> reactor_;
+  std::unique_ptr<RetryPolicy> retry_policy_;
+  std::unique_ptr<BackoffPolicy> backoff_policy_;
+  bool idempotent_;
+  char const* location_;
+  std::function<future<T>()> attempt_;
+  promise<T> promise_;
+};
+
+class CurlAsyncConnection : public AsyncConnection {
+ public:
+  CurlAsyncConnection(std::shared_ptr<CurlClient> client,
+                      std::shared_ptr<RetryPolicy const> retry_policy,
+                      std::shared_ptr<BackoffPolicy const> backoff_policy,
+                      std::shared_ptr<IdempotencyPolicy const> idempotency)
+      : client_(std::move(client)),
+        retry_policy_(std::move(retry_policy)),
+        backoff_policy_(std::move(backoff_policy)),
+        idempotency_policy_(std::move(idempotency)) {}
+
+  future<StatusOr<ObjectMetadata>> AsyncGetObjectMetadata(
+      GetObjectMetadataRequest const& request) override {
+    auto client = client_;
+    return Retry<StatusOr<ObjectMetadata>>(
+        idempotency_policy_->IsIdempotent(request), __func__,
+        [client, request] { return client->AsyncGetObjectMetadata(request); });
+  }
+
+  future<StatusOr<ObjectMetadata>> AsyncInsertObjectMedia(
+      InsertObjectMediaRequest const& request) override {
+    auto client = client_;
+    return Retry<StatusOr<ObjectMetadata>>(
+        idempotency_policy_->IsIdempotent(request), __func__,
+        [client, request] { return client->AsyncInsertObjectMedia(request); });
+  }
+
+  future<StatusOr<EmptyResponse>> AsyncDeleteObject(
+      DeleteObjectRequest const& request) override {
+    auto client = client_;
+    return Retry<StatusOr<EmptyResponse>>(
+        idempotency_policy_->IsIdempotent(request), __func__,
+        [client, request] { return client->AsyncDeleteObject(request); });
+  }
+
+ private:
+  template <typename T>
+  future<T> Retry(bool idempotent, char const* location,
+                  std::function<future<T>()> attempt) {
+    auto loop = std::make_shared<AsyncRetryLoop<T>>(
+        client_->reactor(), retry_policy_->clone(), backoff_policy_->clone(),
+        idempotent, location, std::move(attempt));
+    return loop->Start();
+  }
+
+  std::shared_ptr<CurlClient> client_;
+  std::shared_ptr<RetryPolicy const> retry_policy_;
+  std::shared_ptr<BackoffPolicy const> backoff_policy_;
+  std::shared_ptr<IdempotencyPolicy const> idempotency_policy_;
+};
+
+}  // namespace
+
+std::shared_ptr<AsyncConnection> MakeBackgroundThreadsAsyncConnection(
+    std::shared_ptr<RawClient> client, std::size_t background_threads) {
+  return std::make_shared<BackgroundThreadsAsyncConnection>(
+      std::move(client), background_threads);
+}
+
+std::shared_ptr<AsyncConnection> MakeCurlAsyncConnection(
+    std::shared_ptr<CurlClient> client,
+    std::shared_ptr<RetryPolicy const> retry_policy,
+    std::shared_ptr<BackoffPolicy const> backoff_policy,
+    std::shared_ptr<IdempotencyPolicy const> idempotency_policy) {
+  return std::make_shared<CurlAsyncConnection>(
+      std::move(client), std::move(retry_policy), std::move(backoff_policy),
+      std::move(idempotency_policy));
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,88 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_ASYNC_CONNECTION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_ASYNC_CONNECTION_H
+
+#include "google/cloud/storage/idempotency_policy.h"
+#include "google/cloud/storage/internal/curl_client.h"
+#include "google/cloud/storage/internal/empty_response.h"
+#include "google/cloud/storage/internal/object_requests.h"
+#include "google/cloud/storage/internal/raw_client.h"
+#include "google/cloud/storage/object_metadata.h"
+#include "google/cloud/storage/retry_policy.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status_or.h"
+#include <cstddef>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Defines the interface used by `storage_experimental::AsyncClient`.
+ *
+ * Each function starts the operation and returns immediately, the returned
+ * future is satisfied when the operation completes.
+ */
+class AsyncConnection {
+ public:
+  virtual ~AsyncConnection() = default;
+
+  virtual future<StatusOr<ObjectMetadata>> AsyncGetObjectMetadata(
+      GetObjectMetadataRequest const& request) = 0;
+  virtual future<StatusOr<ObjectMetadata>> AsyncInsertObjectMedia(
+      InsertObjectMediaRequest const& request) = 0;
+  virtual future<StatusOr<EmptyResponse>> AsyncDeleteObject(
+      DeleteObjectRequest const& request) = 0;
+};
+
+/**
+ * Create an `AsyncConnection` running @p client operations in background
+ * threads.
+ *
+ * The operations use the retry, backoff, and idempotency policies configured
+ * in @p client. At most @p background_threads operations run at the same time,
+ * any other operations are queued until a thread becomes available. Pending
+ * operations are completed before the connection is destroyed.
+ */
+std::shared_ptr<AsyncConnection> MakeBackgroundThreadsAsyncConnection(
+    std::shared_ptr<RawClient> client, std::size_t background_threads);
+
+/**
+ * Create an `AsyncConnection` running @p client operations in its
+ * `CurlMultiReactor`.
+ *
+ * All the operations share a single background thread, independently of how
+ * many operations are in flight. Failed operations are retried using the
+ * given policies, the backoff between attempts uses the reactor timers and
+ * does not block any threads.
+ */
+std::shared_ptr<AsyncConnection> MakeCurlAsyncConnection(
+    std::shared_ptr<CurlClient> client,
+    std::shared_ptr<RetryPolicy const> retry_policy,
+    std::shared_ptr<BackoffPolicy const> backoff_policy,
+    std::shared_ptr<IdempotencyPolicy const> idempotency_policy);
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_ASYNC_CONNECTION_H
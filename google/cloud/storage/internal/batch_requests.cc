@@ -0,0 +1,438 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/batch_requests.h"
+#include "google/cloud/storage/internal/curl_handle.h"
+#include "google/cloud/storage/internal/object_access_control_parser.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "absl/strings/numbers.h"
+#include "absl/types/optional.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+char const kCrLf[] = "\r\n";
+
+std::string Escape(CurlHandle& handle, std::string const& value) {
+  return std::string(handle.MakeEscapedString(value).get());
+}
+
+/**
+ * Collects the method, path, headers and payload for one operation.
+ *
+ * This implements the subset of the `CurlRequestBuilder` interface used by
+ * `AddOptionsToHttpRequest()`. The authorization header is only set in the
+ * outer HTTP request.
+ */
+class BatchPartBuilder {
+ public:
+  BatchPartBuilder(CurlHandle& handle, std::string method, std::string path)
+      : handle_(handle), method_(std::move(method)), path_(std::move(path)) {}
+
+  template <typename P>
+  BatchPartBuilder& AddOption(WellKnownParameter<P, std::string> const& p) {
+    if (p.has_value()) AddQueryParameter(p.parameter_name(), p.value());
+    return *this;
+  }
+
+  template <typename P>
+  BatchPartBuilder& AddOption(WellKnownParameter<P, std::int64_t> const& p) {
+    if (p.has_value()) {
+      AddQueryParameter(p.parameter_name(), std::to_string(p.value()));
+    }
+    return *this;
+  }
+
+  template <typename P>
+  BatchPartBuilder& AddOption(WellKnownParameter<P, bool> const& p) {
+    if (p.has_value()) {
+      AddQueryParameter(p.parameter_name(), p.value() ? "true" : "false");
+    }
+    return *this;
+  }
+
+  template <typename P>
+  BatchPartBuilder& AddOption(WellKnownHeader<P, std::string> const& p) {
+    if (p.has_value()) {
+      AddHeader(std::string(p.header_name()) + ": " + p.value());
+    }
+    return *this;
+  }
+
+  template <typename P, typename V>
+  BatchPartBuilder& AddOption(WellKnownHeader<P, V> const& p) {
+    if (p.has_value()) {
+      AddHeader(std::string(p.header_name()) + ": " +
+                std::to_string(p.value()));
+    }
+    return *this;
+  }
+
+  BatchPartBuilder& AddOption(CustomHeader const& p) {
+    if (p.has_value()) AddHeader(p.custom_header_name() + ": " + p.value());
+    return *this;
+  }
+
+  BatchPartBuilder& AddOption(EncryptionKey const& p) {
+    if (p.has_value()) {
+      auto const prefix = std::string(EncryptionKey::prefix());
+      AddHeader(prefix + "algorithm: " + p.value().algorithm);
+      AddHeader(prefix + "key: " + p.value().key);
+      AddHeader(prefix + "key-sha256: " + p.value().sha256);
+    }
+    return *this;
+  }
+
+  /// Ignore complex options, the batch request does not support them.
+  template <typename Option, typename T>
+  BatchPartBuilder& AddOption(ComplexOption<Option, T> const&) {
+    return *this;
+  }
+
+  BatchPartBuilder& AddHeader(std::string header) {
+    headers_.push_back(std::move(header));
+    return *this;
+  }
+
+  BatchPartBuilder& AddQueryParameter(std::string const& key,
+                                      std::string const& value) {
+    path_ += separator_;
+    path_ += Escape(handle_, key);
+    path_ += "=";
+    path_ += Escape(handle_, value);
+    separator_ = "&";
+    return *this;
+  }
+
+  void Format(std::ostream& os, std::string const& payload) const {
+    os << method_ << " " << path_ << " HTTP/1.1" << kCrLf;
+    if (!payload.empty()) {
+      os << "Content-Type: application/json; charset=UTF-8" << kCrLf
+         << "Content-Length: " << payload.size() << kCrLf;
+    }
+    for (auto const& h : headers_) os << h << kCrLf;
+    os << kCrLf << payload;
+  }
+
+ private:
+  CurlHandle& handle_;
+  std::string method_;
+  std::string path_;
+  char const* separator_ = "?";
+  std::vector<std::string> headers_;
+};
+
+/// Formats each type of operation.
+struct FormatOperation {
+  void operator()(DeleteObjectRequest const& r) const {
+    BatchPartBuilder builder(handle, "DELETE", ObjectPath(r));
+    r.AddOptionsToHttpRequest(builder);
+    builder.Format(os, std::string{});
+  }
+
+  void operator()(PatchObjectRequest const& r) const {
+    BatchPartBuilder builder(handle, "PATCH", ObjectPath(r));
+    r.AddOptionsToHttpRequest(builder);
+    builder.Format(os, r.payload());
+  }
+
+  void operator()(UpdateObjectAclRequest const& r) const {
+    auto path = ObjectPath(r) + "/acl/" + Escape(handle, r.entity());
+    BatchPartBuilder builder(handle, "PUT", std::move(path));
+    r.AddOptionsToHttpRequest(builder);
+    nlohmann::json object;
+    object["entity"] = r.entity();
+    object["role"] = r.role();
+    builder.Format(os, object.dump());
+  }
+
+  template <typename Request>
+  std::string ObjectPath(Request const& r) const {
+    return path_prefix + "/b/" + Escape(handle, r.bucket_name()) + "/o/" +
+           Escape(handle, r.object_name());
+  }
+
+  CurlHandle& handle;
+  std::ostream& os;
+  std::string const& path_prefix;
+};
+
+template <typename Parser>
+auto ParseResult(HttpResponse const& response)
+    -> decltype(Parser::FromString(response.payload)) {
+  if (response.status_code >= HttpStatusCode::kMinNotSuccess) {
+    return AsStatus(response);
+  }
+  return Parser::FromString(response.payload);
+}
+
+/// Parses the result of each type of operation.
+struct ParseOperationResult {
+  BatchOperationResult operator()(DeleteObjectRequest const&) const {
+    if (response.status_code >= HttpStatusCode::kMinNotSuccess) {
+      return StatusOr<EmptyResponse>(AsStatus(response));
+    }
+    return StatusOr<EmptyResponse>(EmptyResponse{});
+  }
+
+  BatchOperationResult operator()(PatchObjectRequest const&) const {
+    return ParseResult<ObjectMetadataParser>(response);
+  }
+
+  BatchOperationResult operator()(UpdateObjectAclRequest const&) const {
+    return ParseResult<ObjectAccessControlParser>(response);
+  }
+
+  HttpResponse const& response;
+};
+
+struct OperationStatus {
+  template <typename T>
+  Status operator()(StatusOr<T> const& r) const {
+    return r.status();
+  }
+};
+
+struct PrintOperation {
+  template <typename Request>
+  void operator()(Request const& r) const {
+    os << r;
+  }
+  std::ostream& os;
+};
+
+Status BatchFormatError(char const* where, std::string const& details) {
+  return Status(StatusCode::kInternal,
+                std::string(where) + "(): invalid batch response, " + details);
+}
+
+/// Splits @p text at the first empty line.
+std::pair<std::string, std::string> SplitHeaders(std::string const& text) {
+  auto pos = text.find("\r\n\r\n");
+  if (pos != std::string::npos) {
+    return {text.substr(0, pos), text.substr(pos + 4)};
+  }
+  pos = text.find("\n\n");
+  if (pos != std::string::npos) {
+    return {text.substr(0, pos), text.substr(pos + 2)};
+  }
+  return {text, std::string{}};
+}
+
+std::vector<std::string> SplitLines(std::string const& text) {
+  std::vector<std::string> lines;
+  std::istringstream is(text);
+  std::string line;
+  while (std::getline(is, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (!line.empty()) lines.push_back(std::move(line));
+  }
+  return lines;
+}
+
+std::string ToLower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char x) {
+    return static_cast<char>(std::tolower(x));
+  });
+  return s;
+}
+
+/**
+ * Extracts the operation index from a `Content-ID: <response-N>` header.
+ *
+ * Returns an empty optional if the header is missing or has no numeric
+ * suffix, in which case the caller falls back to the position of the part.
+ */
+StatusOr<absl::optional<std::size_t>> ContentIdIndex(
+    std::string const& headers) {
+  for (auto const& line : SplitLines(headers)) {
+    auto const colon = line.find(':');
+    if (colon == std::string::npos) continue;
+    if (ToLower(line.substr(0, colon)) != "content-id") continue;
+    auto const end = line.find_last_of('>');
+    if (end == std::string::npos) return absl::optional<std::size_t>{};
+    auto begin = end;
+    while (begin != 0 &&
+           std::isdigit(static_cast<unsigned char>(line[begin - 1]))) {
+      --begin;
+    }
+    if (begin == end) return absl::optional<std::size_t>{};
+    std::size_t id = 0;
+    if (!absl::SimpleAtoi(line.substr(begin, end - begin), &id) || id == 0) {
+      return BatchFormatError(__func__, "bad Content-ID <" + line + ">");
+    }
+    return absl::optional<std::size_t>(id - 1);
+  }
+  return absl::optional<std::size_t>{};
+}
+
+/// Parses an embedded HTTP response, including the status line.
+StatusOr<HttpResponse> ParseEmbeddedResponse(std::string const& text) {
+  auto split = SplitHeaders(text);
+  auto lines = SplitLines(split.first);
+  if (lines.empty()) return BatchFormatError(__func__, "missing status line");
+  std::istringstream status_line(lines.front());
+  std::string version;
+  long status_code = 0;  // NOLINT(google-runtime-int)
+  status_line >> version >> status_code;
+  if (!status_line || version.rfind("HTTP/", 0) != 0) {
+    return BatchFormatError(__func__,
+                            "bad status line <" + lines.front() + ">");
+  }
+  HttpResponse response{status_code, std::move(split.second), {}};
+  for (auto i = std::next(lines.begin()); i != lines.end(); ++i) {
+    auto const colon = i->find(':');
+    if (colon == std::string::npos) continue;
+    auto value = i->substr(colon + 1);
+    value.erase(0, value.find_first_not_of(' '));
+    response.headers.emplace(ToLower(i->substr(0, colon)), std::move(value));
+  }
+  // The part separator is preceded by a CRLF, which is not part of the body.
+  auto& payload = response.payload;
+  while (!payload.empty() &&
+         (payload.back() == '\n' || payload.back() == '\r')) {
+    payload.pop_back();
+  }
+  return response;
+}
+
+StatusOr<std::string> ResponseBoundary(HttpResponse const& response) {
+  auto const h = response.headers.find("content-type");
+  if (h == response.headers.end()) {
+    return BatchFormatError(__func__, "missing content-type");
+  }
+  auto const& value = h->second;
+  auto pos = value.find("boundary=");
+  if (pos == std::string::npos) {
+    return BatchFormatError(__func__, "missing boundary in <" + value + ">");
+  }
+  auto boundary = value.substr(pos + std::strlen("boundary="));
+  boundary = boundary.substr(0, boundary.find(';'));
+  if (boundary.size() >= 2 && boundary.front() == '"' &&
+      boundary.back() == '"') {
+    boundary = boundary.substr(1, boundary.size() - 2);
+  }
+  if (boundary.empty()) return BatchFormatError(__func__, "empty boundary");
+  return boundary;
+}
+
+}  // namespace
+
+std::size_t constexpr BatchRequest::kMaxOperations;
+
+Status BatchOperationStatus(BatchOperationResult const& result) {
+  return absl::visit(OperationStatus{}, result);
+}
+
+std::ostream& operator<<(std::ostream& os, BatchRequest const& r) {
+  os << "BatchRequest={operations=[";
+  char const* sep = "";
+  for (auto const& op : r.operations()) {
+    os << sep;
+    absl::visit(PrintOperation{os}, op);
+    sep = ", ";
+  }
+  return os << "]}";
+}
+
+std::ostream& operator<<(std::ostream& os, BatchResponse const& r) {
+  os << "BatchResponse={results=[";
+  char const* sep = "";
+  for (auto const& result : r.results) {
+    os << sep << BatchOperationStatus(result);
+    sep = ", ";
+  }
+  return os << "]}";
+}
+
+std::string FormatBatchRequestPayload(BatchRequest const& request,
+                                      std::string const& boundary,
+                                      std::string const& path_prefix) {
+  CurlHandle handle;
+  std::ostringstream os;
+  std::size_t id = 0;
+  for (auto const& op : request.operations()) {
+    os << "--" << boundary << kCrLf << "Content-Type: application/http"
+       << kCrLf << "Content-ID: <" << ++id << ">" << kCrLf << kCrLf;
+    absl::visit(FormatOperation{handle, os, path_prefix}, op);
+    os << kCrLf;
+  }
+  os << "--" << boundary << "--" << kCrLf;
+  return std::move(os).str();
+}
+
+StatusOr<BatchResponse> ParseBatchResponse(BatchRequest const& request,
+                                           HttpResponse const& response) {
+  if (response.status_code >= HttpStatusCode::kMinNotSuccess) {
+    return AsStatus(response);
+  }
+  auto boundary = ResponseBoundary(response);
+  if (!boundary) return std::move(boundary).status();
+  auto const delimiter = "--" + *boundary;
+
+  auto const& payload = response.payload;
+  std::vector<absl::optional<BatchOperationResult>> results(request.size());
+  std::size_t position = 0;
+  auto pos = payload.find(delimiter);
+  while (pos != std::string::npos) {
+    auto begin = pos + delimiter.size();
+    if (payload.compare(begin, 2, "--") == 0) break;  // the final delimiter
+    begin = payload.find('\n', begin);
+    if (begin == std::string::npos) break;
+    ++begin;
+    pos = payload.find(delimiter, begin);
+    if (pos == std::string::npos) {
+      return BatchFormatError(__func__, "missing final delimiter");
+    }
+    auto part = SplitHeaders(payload.substr(begin, pos - begin));
+    auto content_id = ContentIdIndex(part.first);
+    if (!content_id) return std::move(content_id).status();
+    auto index = content_id->value_or(position);
+    ++position;
+    if (index >= results.size()) {
+      return BatchFormatError(__func__, "unexpected result for operation #" +
+                                            std::to_string(index + 1));
+    }
+    auto embedded = ParseEmbeddedResponse(part.second);
+    if (!embedded) return std::move(embedded).status();
+    results[index] = absl::visit(ParseOperationResult{*embedded},
+                                 request.operations()[index]);
+  }
+
+  BatchResponse result;
+  result.results.reserve(results.size());
+  for (std::size_t i = 0; i != results.size(); ++i) {
+    if (!results[i].has_value()) {
+      return BatchFormatError(__func__, "missing result for operation #" +
+                                            std::to_string(i + 1));
+    }
+    result.results.push_back(*std::move(results[i]));
+  }
+  return result;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,116 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_BATCH_REQUESTS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_BATCH_REQUESTS_H
+
+#include "google/cloud/storage/internal/empty_response.h"
+#include "google/cloud/storage/internal/http_response.h"
+#include "google/cloud/storage/internal/object_acl_requests.h"
+#include "google/cloud/storage/internal/object_requests.h"
+#include "google/cloud/storage/object_access_control.h"
+#include "google/cloud/storage/object_metadata.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/variant.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/// The operations supported in a batch request.
+using BatchOperation = absl::variant<DeleteObjectRequest, PatchObjectRequest,
+                                     UpdateObjectAclRequest>;
+
+/// The result of each operation in a batch request.
+using BatchOperationResult =
+    absl::variant<StatusOr<EmptyResponse>, StatusOr<ObjectMetadata>,
+                  StatusOr<ObjectAccessControl>>;
+
+/// Returns the status of @p result, regardless of the operation type.
+Status BatchOperationStatus(BatchOperationResult const& result);
+
+/**
+ * Represents a request to the batch JSON API.
+ *
+ * A batch request packs several metadata operations into a single HTTP
+ * request, see https://cloud.google.com/storage/docs/batch for details. The
+ * service limits each batch request to 100 operations.
+ */
+class BatchRequest {
+ public:
+  static std::size_t constexpr kMaxOperations = 100;
+
+  BatchRequest() = default;
+  explicit BatchRequest(std::vector<BatchOperation> operations)
+      : operations_(std::move(operations)) {}
+
+  std::vector<BatchOperation> const& operations() const { return operations_; }
+  std::size_t size() const { return operations_.size(); }
+  bool empty() const { return operations_.empty(); }
+  bool full() const { return operations_.size() >= kMaxOperations; }
+
+  void Add(BatchOperation operation) {
+    operations_.push_back(std::move(operation));
+  }
+
+ private:
+  std::vector<BatchOperation> operations_;
+};
+
+std::ostream& operator<<(std::ostream& os, BatchRequest const& r);
+
+/// The results of a batch request, in the same order as the operations.
+struct BatchResponse {
+  std::vector<BatchOperationResult> results;
+};
+
+std::ostream& operator<<(std::ostream& os, BatchResponse const& r);
+
+/**
+ * Formats the payload for a batch request.
+ *
+ * @param request the operations to format.
+ * @param boundary the separator for each part, it must not appear in the
+ *     payload of any operation.
+ * @param path_prefix the path for the JSON API, e.g. `/storage/v1`.
+ */
+std::string FormatBatchRequestPayload(BatchRequest const& request,
+                                      std::string const& boundary,
+                                      std::string const& path_prefix);
+
+/**
+ * Parses the response of a batch request.
+ *
+ * Each part of the response is parsed into the result type of the
+ * corresponding operation in @p request. Returns an error if the response
+ * does not have the expected format, or if it is missing any results.
+ */
+StatusOr<BatchResponse> ParseBatchResponse(BatchRequest const& request,
+                                           HttpResponse const& response);
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_BATCH_REQUESTS_H
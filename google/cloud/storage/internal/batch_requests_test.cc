@@ -0,0 +1,214 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/batch_requests.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::HasSubstr;
+using ::testing::StartsWith;
+
+BatchRequest MakeTestBatch() {
+  BatchRequest batch;
+  batch.Add(DeleteObjectRequest("test-bucket", "dir/obj1")
+                .set_multiple_options(IfGenerationMatch(7),
+                                      UserProject("test-project")));
+  batch.Add(PatchObjectRequest(
+      "test-bucket", "obj2",
+      ObjectMetadataPatchBuilder().SetContentType("text/plain")));
+  batch.Add(UpdateObjectAclRequest("test-bucket", "obj3", "allUsers", "READER")
+                .set_multiple_options(Generation(42)));
+  return batch;
+}
+
+std::string MakePart(std::string const& id, std::string const& status_line,
+                     std::string const& body) {
+  return "--batch_boundary\r\n"
+         "Content-Type: application/http\r\n"
+         "Content-ID: <response-" +
+         id +
+         ">\r\n"
+         "\r\n" +
+         status_line +
+         "\r\n"
+         "Content-Type: application/json; charset=UTF-8\r\n"
+         "\r\n" +
+         body + "\r\n";
+}
+
+HttpResponse MakeBatchResponse(std::string const& payload) {
+  return HttpResponse{
+      200,
+      payload,
+      {{"content-type", "multipart/mixed; boundary=batch_boundary"}}};
+}
+
+TEST(BatchRequestsTest, Full) {
+  BatchRequest batch;
+  for (std::size_t i = 0; i != BatchRequest::kMaxOperations; ++i) {
+    EXPECT_FALSE(batch.full());
+    batch.Add(DeleteObjectRequest("b", "o" + std::to_string(i)));
+  }
+  EXPECT_TRUE(batch.full());
+  EXPECT_EQ(BatchRequest::kMaxOperations, batch.size());
+}
+
+TEST(BatchRequestsTest, FormatPayload) {
+  auto const payload = FormatBatchRequestPayload(
+      MakeTestBatch(), "test-boundary", "/storage/v1");
+  EXPECT_THAT(payload,
+              StartsWith("--test-boundary\r\n"
+                         "Content-Type: application/http\r\n"
+                         "Content-ID: <1>\r\n\r\n"
+                         "DELETE /storage/v1/b/test-bucket/o/dir%2Fobj1?"));
+  EXPECT_THAT(payload, HasSubstr("ifGenerationMatch=7"));
+  EXPECT_THAT(payload, HasSubstr("userProject=test-project"));
+  EXPECT_THAT(payload, HasSubstr("Content-ID: <2>\r\n\r\n"
+                                 "PATCH /storage/v1/b/test-bucket/o/obj2 "
+                                 "HTTP/1.1\r\n"));
+  EXPECT_THAT(payload, HasSubstr(R"js("contentType":"text/plain")js"));
+  EXPECT_THAT(payload, HasSubstr("Content-ID: <3>\r\n\r\n"
+                                 "PUT /storage/v1/b/test-bucket/o/obj3/acl/"
+                                 "allUsers?generation=42 HTTP/1.1\r\n"));
+  EXPECT_THAT(payload, HasSubstr(R"js("role":"READER")js"));
+  EXPECT_THAT(payload, ::testing::EndsWith("\r\n--test-boundary--\r\n"));
+}
+
+TEST(BatchRequestsTest, FormatPayloadEscapesBucketName) {
+  BatchRequest batch;
+  batch.Add(DeleteObjectRequest("test bucket", "obj1"));
+  auto const payload =
+      FormatBatchRequestPayload(batch, "test-boundary", "/storage/v1");
+  EXPECT_THAT(payload,
+              HasSubstr("DELETE /storage/v1/b/test%20bucket/o/obj1 "));
+}
+
+TEST(BatchRequestsTest, ParseResponse) {
+  auto batch = MakeTestBatch();
+  // The results may be returned in any order, use the Content-ID to find the
+  // corresponding operation.
+  auto const payload =
+      MakePart("3", "HTTP/1.1 200 OK",
+               R"js({"entity": "allUsers", "role": "READER"})js") +
+      MakePart("1", "HTTP/1.1 404 Not Found",
+               R"js({"error": {"message": "not found"}})js") +
+      MakePart("2", "HTTP/1.1 200 OK",
+               R"js({"bucket": "test-bucket", "name": "obj2",
+                     "contentType": "text/plain"})js") +
+      "--batch_boundary--\r\n";
+
+  auto response = ParseBatchResponse(batch, MakeBatchResponse(payload));
+  ASSERT_STATUS_OK(response);
+  ASSERT_EQ(3, response->results.size());
+
+  auto const& r0 = absl::get<StatusOr<EmptyResponse>>(response->results[0]);
+  EXPECT_THAT(r0, StatusIs(StatusCode::kNotFound));
+
+  auto const& r1 = absl::get<StatusOr<ObjectMetadata>>(response->results[1]);
+  ASSERT_STATUS_OK(r1);
+  EXPECT_EQ("obj2", r1->name());
+  EXPECT_EQ("text/plain", r1->content_type());
+
+  auto const& r2 =
+      absl::get<StatusOr<ObjectAccessControl>>(response->results[2]);
+  ASSERT_STATUS_OK(r2);
+  EXPECT_EQ("allUsers", r2->entity());
+  EXPECT_EQ("READER", r2->role());
+
+  EXPECT_THAT(BatchOperationStatus(response->results[0]),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_STATUS_OK(BatchOperationStatus(response->results[1]));
+}
+
+TEST(BatchRequestsTest, ParseResponseWithoutContentId) {
+  BatchRequest batch;
+  batch.Add(DeleteObjectRequest("test-bucket", "obj1"));
+  batch.Add(DeleteObjectRequest("test-bucket", "obj2"));
+  auto const payload = std::string{} +
+                       "--batch_boundary\r\n"
+                       "Content-Type: application/http\r\n\r\n"
+                       "HTTP/1.1 204 No Content\r\n\r\n\r\n"
+                       "--batch_boundary\r\n"
+                       "Content-Type: application/http\r\n\r\n"
+                       "HTTP/1.1 412 Precondition Failed\r\n\r\n\r\n"
+                       "--batch_boundary--\r\n";
+  auto response = ParseBatchResponse(batch, MakeBatchResponse(payload));
+  ASSERT_STATUS_OK(response);
+  ASSERT_EQ(2, response->results.size());
+  EXPECT_STATUS_OK(BatchOperationStatus(response->results[0]));
+  EXPECT_THAT(BatchOperationStatus(response->results[1]),
+              StatusIs(StatusCode::kFailedPrecondition));
+}
+
+TEST(BatchRequestsTest, ParseResponseErrors) {
+  auto batch = MakeTestBatch();
+
+  // The batch request failed as a whole.
+  auto r = ParseBatchResponse(batch, HttpResponse{503, "try-again", {}});
+  EXPECT_THAT(r, StatusIs(StatusCode::kUnavailable));
+
+  // Missing the boundary.
+  r = ParseBatchResponse(batch, HttpResponse{200, "", {}});
+  EXPECT_THAT(r, StatusIs(StatusCode::kInternal, HasSubstr("content-type")));
+
+  // Missing some of the results.
+  r = ParseBatchResponse(
+      batch, MakeBatchResponse(MakePart("1", "HTTP/1.1 204 No Content", "") +
+                               "--batch_boundary--\r\n"));
+  EXPECT_THAT(r, StatusIs(StatusCode::kInternal,
+                          HasSubstr("missing result for operation #2")));
+
+  // A result for an unknown operation.
+  r = ParseBatchResponse(
+      batch, MakeBatchResponse(MakePart("7", "HTTP/1.1 204 No Content", "") +
+                               "--batch_boundary--\r\n"));
+  EXPECT_THAT(r, StatusIs(StatusCode::kInternal, HasSubstr("operation #7")));
+
+  // A Content-ID that does not fit in an integer.
+  r = ParseBatchResponse(
+      batch, MakeBatchResponse(MakePart("123456789012345678901234567890",
+                                        "HTTP/1.1 204 No Content", "") +
+                               "--batch_boundary--\r\n"));
+  EXPECT_THAT(r, StatusIs(StatusCode::kInternal, HasSubstr("Content-ID")));
+
+  // A malformed status line.
+  r = ParseBatchResponse(batch, MakeBatchResponse(MakePart("1", "BAD", "") +
+                                                  "--batch_boundary--\r\n"));
+  EXPECT_THAT(r, StatusIs(StatusCode::kInternal, HasSubstr("status line")));
+}
+
+TEST(BatchRequestsTest, Printing) {
+  std::ostringstream os;
+  os << MakeTestBatch();
+  EXPECT_THAT(os.str(), HasSubstr("DeleteObjectRequest={"));
+  EXPECT_THAT(os.str(), HasSubstr("PatchObjectRequest={"));
+  EXPECT_THAT(os.str(), HasSubstr("UpdateObjectAclRequest={"));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,90 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_BOUNDED_QUEUE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_BOUNDED_QUEUE_H
+
+#include "google/cloud/storage/version.h"
+#include "absl/types/optional.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A blocking queue with a maximum size, used to connect pipeline stages.
+ *
+ * `Push()` blocks while the queue is full, and `Pop()` blocks while it is
+ * empty. After `Shutdown()` the producers stop (`Push()` returns false), and
+ * the consumers drain the remaining elements before `Pop()` returns an empty
+ * optional.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(std::size_t max_size)
+      : max_size_(max_size == 0 ? 1 : max_size) {}
+
+  void Shutdown() {
+    std::unique_lock<std::mutex> lk(mu_);
+    is_shutdown_ = true;
+    lk.unlock();
+    cv_read_.notify_all();
+    cv_write_.notify_all();
+  }
+
+  absl::optional<T> Pop() {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_read_.wait(lk, [this] { return is_shutdown_ || !buffer_.empty(); });
+    if (buffer_.empty()) return {};
+    auto next = std::move(buffer_.front());
+    buffer_.pop_front();
+    lk.unlock();
+    cv_write_.notify_one();
+    return next;
+  }
+
+  bool Push(T data) {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_write_.wait(
+        lk, [this] { return is_shutdown_ || buffer_.size() < max_size_; });
+    if (is_shutdown_) return false;
+    buffer_.push_back(std::move(data));
+    lk.unlock();
+    cv_read_.notify_one();
+    return true;
+  }
+
+ private:
+  std::size_t const max_size_;
+  std::mutex mu_;
+  std::condition_variable cv_read_;
+  std::condition_variable cv_write_;
+  std::deque<T> buffer_;
+  bool is_shutdown_ = false;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_BOUNDED_QUEUE_H
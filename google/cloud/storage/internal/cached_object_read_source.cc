@@ -0,0 +1,225 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/cached_object_read_source.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+#include <cstring>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+bool IsCacheableRead(ReadObjectRangeRequest const& request) {
+  // Do not store the plaintext of encrypted objects.
+  if (request.HasOption<EncryptionKey>()) return false;
+  // With the REST API this is an error, let the service report it.
+  if (request.HasOption<ReadLast>() &&
+      request.GetOption<ReadLast>().value() <= 0) {
+    return false;
+  }
+  return true;
+}
+
+StatusOr<std::unique_ptr<ObjectReadSource>> ReadObjectThroughCache(
+    std::shared_ptr<RawClient> client, std::shared_ptr<ObjectReadCache> cache,
+    ReadObjectRangeRequest const& request, std::size_t block_size) {
+  // The metadata request evaluates any pre-conditions, and pins the
+  // generation downloaded by the (possibly many) requests for missing blocks.
+  GetObjectMetadataRequest metadata_request(request.bucket_name(),
+                                            request.object_name());
+  metadata_request.set_multiple_options(
+      request.GetOption<Generation>(), request.GetOption<IfGenerationMatch>(),
+      request.GetOption<IfGenerationNotMatch>(),
+      request.GetOption<IfMetagenerationMatch>(),
+      request.GetOption<IfMetagenerationNotMatch>(),
+      request.GetOption<UserProject>());
+  auto metadata = client->GetObjectMetadata(metadata_request);
+  if (!metadata) return std::move(metadata).status();
+
+  auto const size = static_cast<std::int64_t>(metadata->size());
+  std::int64_t begin = 0;
+  std::int64_t end = size;
+  if (request.HasOption<ReadRange>()) {
+    auto const range = request.GetOption<ReadRange>().value();
+    begin = range.begin;
+    end = (std::min)(end, range.end);
+  }
+  if (request.HasOption<ReadLast>()) {
+    auto const last = request.GetOption<ReadLast>().value();
+    begin = (std::max<std::int64_t>)(0, size - last);
+  }
+  if (request.HasOption<ReadFromOffset>()) {
+    begin = (std::max)(begin, request.GetOption<ReadFromOffset>().value());
+  }
+  if (begin > size) {
+    return Status(StatusCode::kOutOfRange,
+                  "ReadObjectThroughCache(): the requested range starts after "
+                  "the end of the object");
+  }
+  end = (std::max)(begin, end);
+
+  std::multimap<std::string, std::string> headers{
+      {"x-goog-generation", std::to_string(metadata->generation())},
+      {"x-goog-metageneration", std::to_string(metadata->metageneration())},
+  };
+  // The downloads of full objects validate the data, including the data from
+  // the cache, against the checksums in the metadata.
+  if (begin == 0 && end == size) {
+    if (!metadata->crc32c().empty()) {
+      headers.emplace("x-goog-hash", "crc32c=" + metadata->crc32c());
+    }
+    if (!metadata->md5_hash().empty()) {
+      headers.emplace("x-goog-hash", "md5=" + metadata->md5_hash());
+    }
+  }
+
+  auto block_request = request;
+  block_request.set_multiple_options(
+      Generation(metadata->generation()), IfGenerationMatch(),
+      IfGenerationNotMatch(), IfMetagenerationMatch(),
+      IfMetagenerationNotMatch(), ReadRange(), ReadFromOffset(), ReadLast(),
+      ParallelReadStreams());
+  return std::unique_ptr<ObjectReadSource>(
+      absl::make_unique<CachedObjectReadSource>(
+          std::move(client), std::move(cache), std::move(block_request), begin,
+          end, block_size, std::move(headers)));
+}
+
+CachedObjectReadSource::CachedObjectReadSource(
+    std::shared_ptr<RawClient> client, std::shared_ptr<ObjectReadCache> cache,
+    ReadObjectRangeRequest request, std::int64_t begin, std::int64_t end,
+    std::size_t block_size, std::multimap<std::string, std::string> headers)
+    : client_(std::move(client)),
+      cache_(std::move(cache)),
+      request_(std::move(request)),
+      offset_(begin),
+      end_(end),
+      block_size_(static_cast<std::int64_t>(block_size)),
+      key_prefix_(request_.bucket_name() + '/' + request_.object_name() + '#' +
+                  std::to_string(request_.GetOption<Generation>().value()) +
+                  '@' + std::to_string(block_size) + ':'),
+      headers_(std::move(headers)) {}
+
+StatusOr<HttpResponse> CachedObjectReadSource::Close() {
+  closed_ = true;
+  if (upstream_) {
+    (void)upstream_->Close();
+    upstream_.reset();
+  }
+  return HttpResponse{HttpStatusCode::kOk, {}, {}};
+}
+
+StatusOr<ReadSourceResult> CachedObjectReadSource::Read(char* buf,
+                                                        std::size_t n) {
+  if (closed_) {
+    return Status(StatusCode::kFailedPrecondition, "Stream is not open");
+  }
+  std::size_t count = 0;
+  if (offset_ < end_) {
+    auto const index = offset_ / block_size_;
+    auto status = LoadBlock(index);
+    if (!status.ok()) return status;
+    auto const block_offset = offset_ - index * block_size_;
+    auto const available = (std::min<std::int64_t>)(
+        end_ - offset_,
+        static_cast<std::int64_t>(block_.size()) - block_offset);
+    if (available <= 0) {
+      return Status(StatusCode::kDataLoss,
+                    "CachedObjectReadSource::Read(): the object is shorter "
+                    "than its metadata size");
+    }
+    count = (std::min)(n, static_cast<std::size_t>(available));
+    std::memcpy(buf, block_.data() + block_offset, count);
+    offset_ += static_cast<std::int64_t>(count);
+  }
+  auto const code =
+      offset_ < end_ ? HttpStatusCode::kContinue : HttpStatusCode::kOk;
+  // Only the first response needs the headers.
+  std::multimap<std::string, std::string> headers;
+  headers.swap(headers_);
+  return ReadSourceResult{count, HttpResponse{code, {}, std::move(headers)}};
+}
+
+std::string CachedObjectReadSource::BlockKey(std::int64_t index) const {
+  return key_prefix_ + std::to_string(index);
+}
+
+Status CachedObjectReadSource::LoadBlock(std::int64_t index) {
+  if (block_index_ == index) return Status();
+  // Restarting a download is more expensive than receiving data that is
+  // already cached, so once a download starts it is used for all the
+  // subsequent blocks.
+  if (upstream_ && upstream_index_ == index) return DownloadBlock(index);
+  auto cached = cache_->Get(BlockKey(index));
+  if (cached) {
+    block_ = *std::move(cached);
+    block_index_ = index;
+    return Status();
+  }
+  return DownloadBlock(index);
+}
+
+Status CachedObjectReadSource::DownloadBlock(std::int64_t index) {
+  if (!upstream_ || upstream_index_ != index) {
+    if (upstream_) (void)upstream_->Close();
+    // Download all the blocks until the end of the range, rounded up to a full
+    // block so the last block can be cached too.
+    auto const range_begin = index * block_size_;
+    auto const last_block = (end_ - 1) / block_size_;
+    auto const range_end = (last_block + 1) * block_size_;
+    auto request = request_;
+    request.set_option(ReadRange(range_begin, range_end));
+    auto source = client_->ReadObject(request);
+    if (!source) return std::move(source).status();
+    upstream_ = *std::move(source);
+    upstream_index_ = index;
+  }
+
+  std::string block(static_cast<std::size_t>(block_size_), '\0');
+  std::size_t received = 0;
+  while (received < block.size()) {
+    auto r = upstream_->Read(&block[received], block.size() - received);
+    if (!r) {
+      upstream_.reset();
+      return std::move(r).status();
+    }
+    if (r->response.status_code >= HttpStatusCode::kMinNotSuccess) {
+      upstream_.reset();
+      return AsStatus(r->response);
+    }
+    received += r->bytes_received;
+    if (r->response.status_code != HttpStatusCode::kContinue) break;
+  }
+  // A short block is the last block of the object.
+  if (received < block.size() || !upstream_->IsOpen()) {
+    (void)upstream_->Close();
+    upstream_.reset();
+  }
+  ++upstream_index_;
+  block.resize(received);
+
+  cache_->Put(BlockKey(index), block);
+  block_ = std::move(block);
+  block_index_ = index;
+  return Status();
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
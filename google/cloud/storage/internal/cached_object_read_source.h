@@ -0,0 +1,103 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CACHED_OBJECT_READ_SOURCE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CACHED_OBJECT_READ_SOURCE_H
+
+#include "google/cloud/storage/internal/object_read_source.h"
+#include "google/cloud/storage/internal/raw_client.h"
+#include "google/cloud/storage/object_read_cache.h"
+#include "google/cloud/storage/version.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/// The size of the blocks stored in an `ObjectReadCache`.
+std::size_t constexpr kObjectReadCacheBlockSize = 2 * 1024 * 1024;
+
+/// Returns true if @p request can be served through an `ObjectReadCache`.
+bool IsCacheableRead(ReadObjectRangeRequest const& request);
+
+/**
+ * Downloads an object through an `ObjectReadCache`.
+ *
+ * This function first fetches the object metadata, which finds the generation
+ * and size of the object, and evaluates any pre-conditions in @p request. The
+ * returned source serves the download from the blocks in @p cache, and
+ * downloads (and caches) any missing blocks using @p client.
+ *
+ * The caller should first verify that `IsCacheableRead(request)` is true.
+ */
+StatusOr<std::unique_ptr<ObjectReadSource>> ReadObjectThroughCache(
+    std::shared_ptr<RawClient> client, std::shared_ptr<ObjectReadCache> cache,
+    ReadObjectRangeRequest const& request,
+    std::size_t block_size = kObjectReadCacheBlockSize);
+
+/**
+ * Serves a download from the blocks of an `ObjectReadCache`.
+ *
+ * The source reads the range `[begin, end)` of a specific object generation.
+ * Blocks missing from the cache are downloaded with a single request that
+ * starts at the first missing block, and this request is reused for any
+ * subsequent missing blocks.
+ */
+class CachedObjectReadSource : public ObjectReadSource {
+ public:
+  CachedObjectReadSource(std::shared_ptr<RawClient> client,
+                         std::shared_ptr<ObjectReadCache> cache,
+                         ReadObjectRangeRequest request, std::int64_t begin,
+                         std::int64_t end, std::size_t block_size,
+                         std::multimap<std::string, std::string> headers);
+
+  bool IsOpen() const override { return !closed_ && offset_ < end_; }
+  StatusOr<HttpResponse> Close() override;
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override;
+
+ private:
+  std::string BlockKey(std::int64_t index) const;
+  Status LoadBlock(std::int64_t index);
+  Status DownloadBlock(std::int64_t index);
+
+  std::shared_ptr<RawClient> client_;
+  std::shared_ptr<ObjectReadCache> cache_;
+  // The request to download missing blocks, without any range options.
+  ReadObjectRangeRequest request_;
+  std::int64_t offset_;
+  std::int64_t const end_;
+  std::int64_t const block_size_;
+  std::string const key_prefix_;
+  std::multimap<std::string, std::string> headers_;
+  bool closed_ = false;
+
+  std::string block_;
+  std::int64_t block_index_ = -1;
+
+  std::unique_ptr<ObjectReadSource> upstream_;
+  std::int64_t upstream_index_ = -1;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CACHED_OBJECT_READ_SOURCE_H
@@ -0,0 +1,220 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/cached_object_read_source.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <cstring>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::MockObjectReadSource;
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::Contains;
+using ::testing::Pair;
+using ::testing::Return;
+
+auto constexpr kBlockSize = 16;
+
+std::string MakeContents(std::size_t size) {
+  std::string contents;
+  for (std::size_t i = 0; i != size; ++i) {
+    contents.push_back(static_cast<char>('a' + i % 26));
+  }
+  return contents;
+}
+
+ObjectMetadata CreateMetadata(std::size_t size) {
+  return ObjectMetadataParser::FromString(R"""({
+      "bucket": "test-bucket",
+      "name": "test-object",
+      "generation": "42",
+      "metageneration": "7",
+      "size": ")""" + std::to_string(size) + R"""("
+})""")
+      .value();
+}
+
+/// Simulate downloads of the range requested in each `ReadObject()` call.
+void ExpectDownloads(testing::MockClient& mock, std::string const& contents,
+                     int count) {
+  EXPECT_CALL(mock, ReadObject(_))
+      .Times(count)
+      .WillRepeatedly([contents](ReadObjectRangeRequest const& request) {
+        EXPECT_EQ(42, request.GetOption<Generation>().value_or(0));
+        auto const range = request.GetOption<ReadRange>().value();
+        auto offset = std::make_shared<std::size_t>(
+            static_cast<std::size_t>(range.begin));
+        auto const end = (std::min)(contents.size(),
+                                    static_cast<std::size_t>(range.end));
+        auto source = absl::make_unique<MockObjectReadSource>();
+        EXPECT_CALL(*source, IsOpen).WillRepeatedly([offset, end] {
+          return *offset < end;
+        });
+        EXPECT_CALL(*source, Read)
+            .WillRepeatedly([contents, offset, end](char* buf, std::size_t n) {
+              // Return small pieces to test partial reads.
+              auto const count = (std::min)({n, std::size_t(5), end - *offset});
+              std::memcpy(buf, contents.data() + *offset, count);
+              *offset += count;
+              auto const code = *offset == end ? HttpStatusCode::kOk
+                                               : HttpStatusCode::kContinue;
+              return make_status_or(
+                  ReadSourceResult{count, HttpResponse{code, {}, {}}});
+            });
+        EXPECT_CALL(*source, Close)
+            .WillRepeatedly(Return(HttpResponse{HttpStatusCode::kOk, {}, {}}));
+        return make_status_or(
+            std::unique_ptr<ObjectReadSource>(std::move(source)));
+      });
+}
+
+std::string ReadAll(ObjectReadSource& source) {
+  std::string actual;
+  char buffer[7];
+  while (source.IsOpen()) {
+    auto r = source.Read(buffer, sizeof(buffer));
+    EXPECT_STATUS_OK(r);
+    if (!r) break;
+    actual.append(buffer, r->bytes_received);
+  }
+  return actual;
+}
+
+TEST(CachedObjectReadSourceTest, FullObject) {
+  auto const contents = MakeContents(5 * kBlockSize + 3);
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .Times(2)
+      .WillRepeatedly(Return(CreateMetadata(contents.size())));
+  // Only the first download reaches the service.
+  ExpectDownloads(*mock, contents, 1);
+  auto cache = MakeInMemoryObjectReadCache(1024 * 1024);
+
+  for (int i = 0; i != 2; ++i) {
+    auto source = ReadObjectThroughCache(
+        mock, cache, ReadObjectRangeRequest("test-bucket", "test-object"),
+        kBlockSize);
+    ASSERT_STATUS_OK(source);
+    EXPECT_EQ(contents, ReadAll(**source));
+    EXPECT_STATUS_OK((*source)->Close());
+  }
+}
+
+TEST(CachedObjectReadSourceTest, Ranges) {
+  auto const contents = MakeContents(5 * kBlockSize + 3);
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillRepeatedly(Return(CreateMetadata(contents.size())));
+  // Block 1 is downloaded in the first read, the second read downloads blocks
+  // 2 and 3, reusing the cached block 1. The last read uses only cached data.
+  ExpectDownloads(*mock, contents, 2);
+  auto cache = MakeInMemoryObjectReadCache(1024 * 1024);
+
+  auto read = [&](ReadObjectRangeRequest const& request) {
+    auto source = ReadObjectThroughCache(mock, cache, request, kBlockSize);
+    EXPECT_STATUS_OK(source);
+    if (!source) return std::string{};
+    return ReadAll(**source);
+  };
+  auto request = [](std::int64_t begin, std::int64_t end) {
+    return ReadObjectRangeRequest("test-bucket", "test-object")
+        .set_option(ReadRange(begin, end));
+  };
+  EXPECT_EQ(contents.substr(20, 10), read(request(20, 30)));
+  EXPECT_EQ(contents.substr(25, 30), read(request(25, 55)));
+  EXPECT_EQ(contents.substr(40, 20),
+            read(request(20, 60).set_option(ReadFromOffset(40))));
+}
+
+TEST(CachedObjectReadSourceTest, ReadLast) {
+  auto const contents = MakeContents(3 * kBlockSize + 3);
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(CreateMetadata(contents.size())));
+  ExpectDownloads(*mock, contents, 1);
+  auto cache = MakeInMemoryObjectReadCache(1024 * 1024);
+
+  auto source = ReadObjectThroughCache(
+      mock, cache,
+      ReadObjectRangeRequest("test-bucket", "test-object")
+          .set_option(ReadLast(20)),
+      kBlockSize);
+  ASSERT_STATUS_OK(source);
+  EXPECT_EQ(contents.substr(contents.size() - 20), ReadAll(**source));
+}
+
+TEST(CachedObjectReadSourceTest, HeadersFromMetadata) {
+  auto const contents = MakeContents(kBlockSize);
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(CreateMetadata(contents.size())));
+  ExpectDownloads(*mock, contents, 1);
+  auto cache = MakeInMemoryObjectReadCache(1024 * 1024);
+
+  auto source = ReadObjectThroughCache(
+      mock, cache, ReadObjectRangeRequest("test-bucket", "test-object"),
+      kBlockSize);
+  ASSERT_STATUS_OK(source);
+  char buffer[4];
+  auto r = (*source)->Read(buffer, sizeof(buffer));
+  ASSERT_STATUS_OK(r);
+  EXPECT_THAT(r->response.headers, Contains(Pair("x-goog-generation", "42")));
+  EXPECT_THAT(r->response.headers,
+              Contains(Pair("x-goog-metageneration", "7")));
+}
+
+TEST(CachedObjectReadSourceTest, MetadataError) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(PermanentError())));
+  EXPECT_CALL(*mock, ReadObject(_)).Times(0);
+  auto cache = MakeInMemoryObjectReadCache(1024 * 1024);
+
+  auto source = ReadObjectThroughCache(
+      mock, cache, ReadObjectRangeRequest("test-bucket", "test-object"),
+      kBlockSize);
+  EXPECT_THAT(source, StatusIs(PermanentError().code()));
+}
+
+TEST(CachedObjectReadSourceTest, IsCacheableRead) {
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  EXPECT_TRUE(IsCacheableRead(request));
+  EXPECT_TRUE(
+      IsCacheableRead(ReadObjectRangeRequest(request).set_option(ReadLast(5))));
+  EXPECT_FALSE(
+      IsCacheableRead(ReadObjectRangeRequest(request).set_option(ReadLast(0))));
+  EXPECT_FALSE(IsCacheableRead(ReadObjectRangeRequest(request).set_option(
+      EncryptionKey::FromBinaryKey("01234567890123456789012345678901"))));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
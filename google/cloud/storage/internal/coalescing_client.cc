@@ -0,0 +1,573 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/coalescing_client.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A download shared by several `ObjectReadSource` readers.
+ *
+ * The data is read from the upstream source on demand, by whichever reader
+ * needs it first, and buffered until all the readers have consumed it. To
+ * bound the memory usage, the buffer is only trimmed once it exceeds
+ * `max_buffer_bytes`, and from then on no new readers can join.
+ */
+class CoalescedDownload {
+ public:
+  CoalescedDownload(std::unique_ptr<ObjectReadSource> source,
+                    std::size_t max_buffer_bytes)
+      : source_(std::move(source)),
+        max_buffer_bytes_(max_buffer_bytes),
+        start_(std::chrono::steady_clock::now()) {}
+
+  std::chrono::steady_clock::time_point start() const { return start_; }
+
+  /// Returns a new reader id, or an empty optional if readers cannot join.
+  absl::optional<std::size_t> AddReader() {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (trimming_) return absl::nullopt;
+    auto const id = next_id_++;
+    readers_.emplace(id, Reader{0, 0});
+    return id;
+  }
+
+  void RemoveReader(std::size_t id) {
+    std::lock_guard<std::mutex> lk(mu_);
+    readers_.erase(id);
+    if (!readers_.empty()) return;
+    // Nobody can join once the last reader is gone, release all the
+    // resources.
+    trimming_ = true;
+    if (!done_) (void)source_->Close();
+    done_ = true;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+  }
+
+  StatusOr<ReadSourceResult> Read(std::size_t id, char* buf, std::size_t n) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& reader = readers_.at(id);
+    while (reader.offset == end() && !done_) Fill(n);
+    if (reader.offset == end() && !status_.ok()) return status_;
+
+    auto const count = (std::min)(n, end() - reader.offset);
+    std::copy_n(buffer_.data() + (reader.offset - base_), count, buf);
+    reader.offset += count;
+    ReadSourceResult result{count, HttpResponse{HttpStatusCode::kContinue,
+                                                std::string{},
+                                                {}}};
+    result.response.headers.insert(
+        std::next(headers_.begin(),
+                  static_cast<std::ptrdiff_t>(reader.headers)),
+        headers_.end());
+    reader.headers = headers_.size();
+    if (done_ && reader.offset == end()) {
+      result.response.status_code = final_status_code_;
+      result.response.payload = final_payload_;
+    }
+    Trim();
+    return result;
+  }
+
+ private:
+  struct Reader {
+    std::size_t offset;
+    std::size_t headers;
+  };
+
+  std::size_t end() const { return base_ + buffer_.size(); }
+
+  void Fill(std::size_t n) {
+    auto const size = buffer_.size();
+    buffer_.resize(size + n);
+    auto r = source_->Read(&buffer_[size], n);
+    if (!r) {
+      buffer_.resize(size);
+      status_ = std::move(r).status();
+      done_ = true;
+      return;
+    }
+    buffer_.resize(size + r->bytes_received);
+    headers_.insert(headers_.end(), r->response.headers.begin(),
+                    r->response.headers.end());
+    if (r->response.status_code != HttpStatusCode::kContinue) {
+      final_status_code_ = r->response.status_code;
+      final_payload_ = std::move(r->response.payload);
+      done_ = true;
+    }
+    if (buffer_.size() > max_buffer_bytes_) trimming_ = true;
+  }
+
+  void Trim() {
+    if (!trimming_) return;
+    auto offset = (std::numeric_limits<std::size_t>::max)();
+    for (auto const& kv : readers_) {
+      offset = (std::min)(offset, kv.second.offset);
+    }
+    // Erasing from the front of the buffer copies the remaining data, only
+    // do so when at least half of it can be released.
+    auto const consumed = offset - base_;
+    if (consumed == 0 || consumed < buffer_.size() / 2) return;
+    buffer_.erase(0, consumed);
+    base_ = offset;
+  }
+
+  std::mutex mu_;
+  std::unique_ptr<ObjectReadSource> source_;
+  std::size_t const max_buffer_bytes_;
+  std::chrono::steady_clock::time_point const start_;
+  std::unordered_map<std::size_t, Reader> readers_;
+  std::size_t next_id_ = 0;
+  bool trimming_ = false;
+  bool done_ = false;
+  Status status_;
+  // NOLINTNEXTLINE(google-runtime-int)
+  long final_status_code_ = HttpStatusCode::kContinue;
+  std::string final_payload_;
+  std::vector<std::pair<std::string, std::string>> headers_;
+  // The offset, within the download, of the first byte in `buffer_`.
+  std::size_t base_ = 0;
+  std::string buffer_;
+};
+
+namespace {
+
+/// The minimum number of entries before expired downloads are removed.
+std::size_t constexpr kMinSweepThreshold = 64;
+
+template <typename Request>
+std::string CoalescingKey(Request const& request) {
+  std::ostringstream os;
+  os << request;
+  return os.str();
+}
+
+class CoalescedReadSource : public ObjectReadSource {
+ public:
+  CoalescedReadSource(std::shared_ptr<CoalescedDownload> download,
+                      std::size_t id)
+      : download_(std::move(download)), id_(id) {}
+  ~CoalescedReadSource() override {
+    if (!closed_) download_->RemoveReader(id_);
+  }
+
+  bool IsOpen() const override { return !closed_ && !finished_; }
+
+  StatusOr<HttpResponse> Close() override {
+    if (!closed_) download_->RemoveReader(id_);
+    closed_ = true;
+    return HttpResponse{HttpStatusCode::kOk, {}, {}};
+  }
+
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override {
+    if (closed_) {
+      return Status(StatusCode::kFailedPrecondition, "Stream is not open");
+    }
+    auto result = download_->Read(id_, buf, n);
+    finished_ = !result ||
+                result->response.status_code != HttpStatusCode::kContinue;
+    return result;
+  }
+
+ private:
+  std::shared_ptr<CoalescedDownload> download_;
+  std::size_t id_;
+  bool closed_ = false;
+  bool finished_ = false;
+};
+
+/// Returns a reader for @p download, or nullptr if readers cannot join it.
+std::unique_ptr<ObjectReadSource> JoinDownload(
+    std::shared_ptr<CoalescedDownload> download) {
+  auto id = download->AddReader();
+  if (!id) return nullptr;
+  return absl::make_unique<CoalescedReadSource>(std::move(download), *id);
+}
+
+}  // namespace
+
+std::size_t constexpr CoalescingClient::kMaxBufferBytes;
+std::chrono::milliseconds constexpr CoalescingClient::kJoinWindow;
+
+CoalescingClient::CoalescingClient(std::shared_ptr<RawClient> client,
+                                   std::size_t max_buffer_bytes,
+                                   std::chrono::milliseconds join_window)
+    : client_(std::move(client)),
+      max_buffer_bytes_(max_buffer_bytes),
+      join_window_(join_window),
+      sweep_threshold_(kMinSweepThreshold) {}
+
+CoalescingClient::~CoalescingClient() = default;
+
+ClientOptions const& CoalescingClient::client_options() const {
+  return client_->client_options();
+}
+
+StatusOr<BucketMetadata> CoalescingClient::GetBucketMetadata(
+    GetBucketMetadataRequest const& request) {
+  return bucket_metadata_.Run(CoalescingKey(request), join_window_, [&] {
+    return client_->GetBucketMetadata(request);
+  });
+}
+
+StatusOr<ObjectMetadata> CoalescingClient::GetObjectMetadata(
+    GetObjectMetadataRequest const& request) {
+  // The metadata of a generation can change, so these requests use the join
+  // window even if they are pinned to a generation.
+  return object_metadata_.Run(CoalescingKey(request), join_window_, [&] {
+    return client_->GetObjectMetadata(request);
+  });
+}
+
+StatusOr<std::unique_ptr<ObjectReadSource>> CoalescingClient::ReadObject(
+    ReadObjectRangeRequest const& request) {
+  auto const key = CoalescingKey(request);
+  // The contents of a generation never change, any download for it is as
+  // good as a new one.
+  auto const max_age = request.HasOption<Generation>()
+                           ? (std::chrono::steady_clock::duration::max)()
+                           : std::chrono::steady_clock::duration(join_window_);
+  auto existing = FindDownload(key, max_age);
+  if (existing) {
+    auto reader = JoinDownload(std::move(existing));
+    if (reader) return reader;
+  }
+
+  auto download = open_download_.Run(
+      key, max_age, [&]() -> StatusOr<std::shared_ptr<CoalescedDownload>> {
+        auto source = client_->ReadObject(request);
+        if (!source) return std::move(source).status();
+        auto d = std::make_shared<CoalescedDownload>(*std::move(source),
+                                                     max_buffer_bytes_);
+        std::lock_guard<std::mutex> lk(mu_);
+        downloads_[key] = d;
+        if (downloads_.size() >= sweep_threshold_) {
+          for (auto i = downloads_.begin(); i != downloads_.end();) {
+            i = i->second.expired() ? downloads_.erase(i) : std::next(i);
+          }
+          sweep_threshold_ =
+              (std::max)(kMinSweepThreshold, 2 * downloads_.size());
+        }
+        return d;
+      });
+  if (!download) return std::move(download).status();
+  auto reader = JoinDownload(*std::move(download));
+  if (reader) return reader;
+  // Other callers consumed enough of the download to start releasing its
+  // data before this caller could join it.
+  return client_->ReadObject(request);
+}
+
+std::shared_ptr<CoalescedDownload> CoalescingClient::FindDownload(
+    std::string const& key, std::chrono::steady_clock::duration max_age) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto i = downloads_.find(key);
+  if (i == downloads_.end()) return nullptr;
+  auto d = i->second.lock();
+  if (!d) {
+    downloads_.erase(i);
+    return nullptr;
+  }
+  if (std::chrono::steady_clock::now() - d->start() >= max_age) return nullptr;
+  return d;
+}
+
+StatusOr<ListBucketsResponse> CoalescingClient::ListBuckets(
+    ListBucketsRequest const& request) {
+  return client_->ListBuckets(request);
+}
+
+StatusOr<BucketMetadata> CoalescingClient::CreateBucket(
+    CreateBucketRequest const& request) {
+  return client_->CreateBucket(request);
+}
+
+StatusOr<EmptyResponse> CoalescingClient::DeleteBucket(
+    DeleteBucketRequest const& request) {
+  return client_->DeleteBucket(request);
+}
+
+StatusOr<BucketMetadata> CoalescingClient::UpdateBucket(
+    UpdateBucketRequest const& request) {
+  return client_->UpdateBucket(request);
+}
+
+StatusOr<BucketMetadata> CoalescingClient::PatchBucket(
+    PatchBucketRequest const& request) {
+  return client_->PatchBucket(request);
+}
+
+StatusOr<IamPolicy> CoalescingClient::GetBucketIamPolicy(
+    GetBucketIamPolicyRequest const& request) {
+  return client_->GetBucketIamPolicy(request);
+}
+
+StatusOr<NativeIamPolicy> CoalescingClient::GetNativeBucketIamPolicy(
+    GetBucketIamPolicyRequest const& request) {
+  return client_->GetNativeBucketIamPolicy(request);
+}
+
+StatusOr<IamPolicy> CoalescingClient::SetBucketIamPolicy(
+    SetBucketIamPolicyRequest const& request) {
+  return client_->SetBucketIamPolicy(request);
+}
+
+StatusOr<NativeIamPolicy> CoalescingClient::SetNativeBucketIamPolicy(
+    SetNativeBucketIamPolicyRequest const& request) {
+  return client_->SetNativeBucketIamPolicy(request);
+}
+
+StatusOr<TestBucketIamPermissionsResponse>
+CoalescingClient::TestBucketIamPermissions(
+    TestBucketIamPermissionsRequest const& request) {
+  return client_->TestBucketIamPermissions(request);
+}
+
+StatusOr<BucketMetadata> CoalescingClient::LockBucketRetentionPolicy(
+    LockBucketRetentionPolicyRequest const& request) {
+  return client_->LockBucketRetentionPolicy(request);
+}
+
+StatusOr<ObjectMetadata> CoalescingClient::InsertObjectMedia(
+    InsertObjectMediaRequest const& request) {
+  return client_->InsertObjectMedia(request);
+}
+
+StatusOr<ObjectMetadata> CoalescingClient::CopyObject(
+    CopyObjectRequest const& request) {
+  return client_->CopyObject(request);
+}
+
+StatusOr<ListObjectsResponse> CoalescingClient::ListObjects(
+    ListObjectsRequest const& request) {
+  return client_->ListObjects(request);
+}
+
+StatusOr<ListObjectsCompactResponse> CoalescingClient::ListObjectsCompact(
+    ListObjectsRequest const& request) {
+  return client_->ListObjectsCompact(request);
+}
+
+StatusOr<EmptyResponse> CoalescingClient::DeleteObject(
+    DeleteObjectRequest const& request) {
+  return client_->DeleteObject(request);
+}
+
+StatusOr<ObjectMetadata> CoalescingClient::UpdateObject(
+    UpdateObjectRequest const& request) {
+  return client_->UpdateObject(request);
+}
+
+StatusOr<ObjectMetadata> CoalescingClient::PatchObject(
+    PatchObjectRequest const& request) {
+  return client_->PatchObject(request);
+}
+
+StatusOr<ObjectMetadata> CoalescingClient::ComposeObject(
+    ComposeObjectRequest const& request) {
+  return client_->ComposeObject(request);
+}
+
+StatusOr<RewriteObjectResponse> CoalescingClient::RewriteObject(
+    RewriteObjectRequest const& request) {
+  return client_->RewriteObject(request);
+}
+
+StatusOr<std::unique_ptr<ResumableUploadSession>>
+CoalescingClient::CreateResumableSession(
+    ResumableUploadRequest const& request) {
+  return client_->CreateResumableSession(request);
+}
+
+StatusOr<std::unique_ptr<ResumableUploadSession>>
+CoalescingClient::RestoreResumableSession(std::string const& request) {
+  return client_->RestoreResumableSession(request);
+}
+
+StatusOr<EmptyResponse> CoalescingClient::DeleteResumableUpload(
+    DeleteResumableUploadRequest const& request) {
+  return client_->DeleteResumableUpload(request);
+}
+
+StatusOr<ListBucketAclResponse> CoalescingClient::ListBucketAcl(
+    ListBucketAclRequest const& request) {
+  return client_->ListBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> CoalescingClient::CreateBucketAcl(
+    CreateBucketAclRequest const& request) {
+  return client_->CreateBucketAcl(request);
+}
+
+StatusOr<EmptyResponse> CoalescingClient::DeleteBucketAcl(
+    DeleteBucketAclRequest const& request) {
+  return client_->DeleteBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> CoalescingClient::GetBucketAcl(
+    GetBucketAclRequest const& request) {
+  return client_->GetBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> CoalescingClient::UpdateBucketAcl(
+    UpdateBucketAclRequest const& request) {
+  return client_->UpdateBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> CoalescingClient::PatchBucketAcl(
+    PatchBucketAclRequest const& request) {
+  return client_->PatchBucketAcl(request);
+}
+
+StatusOr<ListObjectAclResponse> CoalescingClient::ListObjectAcl(
+    ListObjectAclRequest const& request) {
+  return client_->ListObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CoalescingClient::CreateObjectAcl(
+    CreateObjectAclRequest const& request) {
+  return client_->CreateObjectAcl(request);
+}
+
+StatusOr<EmptyResponse> CoalescingClient::DeleteObjectAcl(
+    DeleteObjectAclRequest const& request) {
+  return client_->DeleteObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CoalescingClient::GetObjectAcl(
+    GetObjectAclRequest const& request) {
+  return client_->GetObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CoalescingClient::UpdateObjectAcl(
+    UpdateObjectAclRequest const& request) {
+  return client_->UpdateObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CoalescingClient::PatchObjectAcl(
+    PatchObjectAclRequest const& request) {
+  return client_->PatchObjectAcl(request);
+}
+
+StatusOr<ListDefaultObjectAclResponse> CoalescingClient::ListDefaultObjectAcl(
+    ListDefaultObjectAclRequest const& request) {
+  return client_->ListDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CoalescingClient::CreateDefaultObjectAcl(
+    CreateDefaultObjectAclRequest const& request) {
+  return client_->CreateDefaultObjectAcl(request);
+}
+
+StatusOr<EmptyResponse> CoalescingClient::DeleteDefaultObjectAcl(
+    DeleteDefaultObjectAclRequest const& request) {
+  return client_->DeleteDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CoalescingClient::GetDefaultObjectAcl(
+    GetDefaultObjectAclRequest const& request) {
+  return client_->GetDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CoalescingClient::UpdateDefaultObjectAcl(
+    UpdateDefaultObjectAclRequest const& request) {
+  return client_->UpdateDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CoalescingClient::PatchDefaultObjectAcl(
+    PatchDefaultObjectAclRequest const& request) {
+  return client_->PatchDefaultObjectAcl(request);
+}
+
+StatusOr<ServiceAccount> CoalescingClient::GetServiceAccount(
+    GetProjectServiceAccountRequest const& request) {
+  return client_->GetServiceAccount(request);
+}
+
+StatusOr<ListHmacKeysResponse> CoalescingClient::ListHmacKeys(
+    ListHmacKeysRequest const& request) {
+  return client_->ListHmacKeys(request);
+}
+
+StatusOr<CreateHmacKeyResponse> CoalescingClient::CreateHmacKey(
+    CreateHmacKeyRequest const& request) {
+  return client_->CreateHmacKey(request);
+}
+
+StatusOr<EmptyResponse> CoalescingClient::DeleteHmacKey(
+    DeleteHmacKeyRequest const& request) {
+  return client_->DeleteHmacKey(request);
+}
+
+StatusOr<HmacKeyMetadata> CoalescingClient::GetHmacKey(
+    GetHmacKeyRequest const& request) {
+  return client_->GetHmacKey(request);
+}
+
+StatusOr<HmacKeyMetadata> CoalescingClient::UpdateHmacKey(
+    UpdateHmacKeyRequest const& request) {
+  return client_->UpdateHmacKey(request);
+}
+
+StatusOr<SignBlobResponse> CoalescingClient::SignBlob(
+    SignBlobRequest const& request) {
+  return client_->SignBlob(request);
+}
+
+StatusOr<ListNotificationsResponse> CoalescingClient::ListNotifications(
+    ListNotificationsRequest const& request) {
+  return client_->ListNotifications(request);
+}
+
+StatusOr<NotificationMetadata> CoalescingClient::CreateNotification(
+    CreateNotificationRequest const& request) {
+  return client_->CreateNotification(request);
+}
+
+StatusOr<NotificationMetadata> CoalescingClient::GetNotification(
+    GetNotificationRequest const& request) {
+  return client_->GetNotification(request);
+}
+
+StatusOr<EmptyResponse> CoalescingClient::DeleteNotification(
+    DeleteNotificationRequest const& request) {
+  return client_->DeleteNotification(request);
+}
+
+StatusOr<BatchResponse> CoalescingClient::ExecuteBatch(
+    BatchRequest const& request) {
+  return client_->ExecuteBatch(request);
+}
+
+Status CoalescingClient::WarmUpConnectionPool() {
+  return client_->WarmUpConnectionPool();
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
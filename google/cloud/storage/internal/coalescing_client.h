@@ -0,0 +1,318 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_COALESCING_CLIENT_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_COALESCING_CLIENT_H
+
+#include "google/cloud/storage/internal/raw_client.h"
+#include "google/cloud/storage/version.h"
+#include "absl/types/optional.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Runs at most one call for each key at a time.
+ *
+ * If `Run()` is called while a recent call with the same key is in progress,
+ * it waits for that call to complete and returns (a copy of) its result,
+ * instead of running @p f. Calls that started more than `max_age` ago are not
+ * joined, as their result may predate changes the caller has already observed.
+ *
+ * If the call being waited on exits with an exception the waiters do not
+ * receive its result, instead they try again, and one of them runs @p f.
+ */
+template <typename T>
+class SingleFlight {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  template <typename Functor>
+  T Run(std::string const& key, Clock::duration max_age, Functor&& f) {
+    for (;;) {
+      std::shared_ptr<Call> call;
+      bool leader;
+      std::tie(call, leader) = Join(key, max_age);
+      if (leader) {
+        Leader guard(*this, key, std::move(call));
+        T value = f();
+        guard.Publish(value);
+        return value;
+      }
+      std::unique_lock<std::mutex> call_lk(call->mu);
+      call->cv.wait(call_lk, [&call] { return call->done; });
+      if (call->value.has_value()) return *call->value;
+    }
+  }
+
+ private:
+  struct Call {
+    explicit Call(Clock::time_point s) : start(s) {}
+
+    Clock::time_point const start;
+    std::mutex mu;
+    std::condition_variable cv;
+    bool done = false;
+    absl::optional<T> value;
+  };
+
+  /**
+   * Completes a call, even if the functor throws.
+   *
+   * Removes the call from the in-progress calls, so new callers start a new
+   * call, and wakes up any waiters.
+   */
+  class Leader {
+   public:
+    Leader(SingleFlight& flight, std::string key, std::shared_ptr<Call> call)
+        : flight_(flight), key_(std::move(key)), call_(std::move(call)) {}
+    ~Leader() {
+      {
+        std::lock_guard<std::mutex> lk(flight_.mu_);
+        auto i = flight_.calls_.find(key_);
+        if (i != flight_.calls_.end() && i->second == call_) {
+          flight_.calls_.erase(i);
+        }
+      }
+      std::lock_guard<std::mutex> lk(call_->mu);
+      call_->done = true;
+      call_->cv.notify_all();
+    }
+    Leader(Leader const&) = delete;
+    Leader& operator=(Leader const&) = delete;
+
+    void Publish(T const& value) {
+      std::lock_guard<std::mutex> lk(call_->mu);
+      call_->value = value;
+    }
+
+   private:
+    SingleFlight& flight_;
+    std::string key_;
+    std::shared_ptr<Call> call_;
+  };
+
+  /// Returns the call to wait on, and true if the caller must run it.
+  std::pair<std::shared_ptr<Call>, bool> Join(std::string const& key,
+                                              Clock::duration max_age) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto const now = Clock::now();
+    auto i = calls_.find(key);
+    if (i != calls_.end() && now - i->second->start < max_age) {
+      return {i->second, false};
+    }
+    // Any older call keeps running, but new callers no longer join it.
+    auto call = std::make_shared<Call>(now);
+    calls_[key] = call;
+    return {std::move(call), true};
+  }
+
+  std::mutex mu_;
+  std::unordered_map<std::string, std::shared_ptr<Call>> calls_;
+};
+
+class CoalescedDownload;
+
+/**
+ * A decorator for `RawClient` that coalesces identical concurrent requests.
+ *
+ * When many threads request the same object at the same time, for example
+ * right after a popular object is created, sending one request per thread
+ * only adds load on the service and latency for the application. This
+ * decorator sends a single request for each group of identical in-flight
+ * `GetObjectMetadata()`, `GetBucketMetadata()` and `ReadObject()` calls, and
+ * returns its result to all the callers. Two requests are identical if they
+ * have the same bucket, object, and options, including any generation,
+ * pre-conditions and read ranges.
+ *
+ * Joining a request that started before the caller's own call may return
+ * stale data: for example, a `ReadObject()` issued right after an object is
+ * overwritten could receive the previous contents. To preserve
+ * read-after-write consistency as much as possible, requests only join
+ * requests that started less than `join_window` ago. Downloads pinned to a
+ * specific generation are immutable, so they are joined regardless of their
+ * age.
+ *
+ * Coalesced downloads are buffered in memory, and each caller receives its own
+ * `ObjectReadSource` reading from the shared buffer. New callers can join a
+ * download until more than `max_buffer_bytes` are buffered (or the join window
+ * expires), after that the data consumed by all the callers is released, and
+ * identical requests start a new download.
+ *
+ * All other requests are forwarded to the decorated client.
+ */
+class CoalescingClient : public RawClient {
+ public:
+  explicit CoalescingClient(
+      std::shared_ptr<RawClient> client,
+      std::size_t max_buffer_bytes = kMaxBufferBytes,
+      std::chrono::milliseconds join_window = kJoinWindow);
+  ~CoalescingClient() override;
+
+  ClientOptions const& client_options() const override;
+
+  StatusOr<ListBucketsResponse> ListBuckets(
+      ListBucketsRequest const& request) override;
+  StatusOr<BucketMetadata> CreateBucket(
+      CreateBucketRequest const& request) override;
+  StatusOr<BucketMetadata> GetBucketMetadata(
+      GetBucketMetadataRequest const& request) override;
+  StatusOr<EmptyResponse> DeleteBucket(DeleteBucketRequest const&) override;
+  StatusOr<BucketMetadata> UpdateBucket(
+      UpdateBucketRequest const& request) override;
+  StatusOr<BucketMetadata> PatchBucket(
+      PatchBucketRequest const& request) override;
+  StatusOr<IamPolicy> GetBucketIamPolicy(
+      GetBucketIamPolicyRequest const& request) override;
+  StatusOr<NativeIamPolicy> GetNativeBucketIamPolicy(
+      GetBucketIamPolicyRequest const& request) override;
+  StatusOr<IamPolicy> SetBucketIamPolicy(
+      SetBucketIamPolicyRequest const& request) override;
+  StatusOr<NativeIamPolicy> SetNativeBucketIamPolicy(
+      SetNativeBucketIamPolicyRequest const& request) override;
+  StatusOr<TestBucketIamPermissionsResponse> TestBucketIamPermissions(
+      TestBucketIamPermissionsRequest const& request) override;
+  StatusOr<BucketMetadata> LockBucketRetentionPolicy(
+      LockBucketRetentionPolicyRequest const& request) override;
+
+  StatusOr<ObjectMetadata> InsertObjectMedia(
+      InsertObjectMediaRequest const& request) override;
+  StatusOr<ObjectMetadata> CopyObject(
+      CopyObjectRequest const& request) override;
+  StatusOr<ObjectMetadata> GetObjectMetadata(
+      GetObjectMetadataRequest const& request) override;
+  StatusOr<std::unique_ptr<ObjectReadSource>> ReadObject(
+      ReadObjectRangeRequest const&) override;
+  StatusOr<ListObjectsResponse> ListObjects(ListObjectsRequest const&) override;
+  StatusOr<ListObjectsCompactResponse> ListObjectsCompact(
+      ListObjectsRequest const&) override;
+  StatusOr<EmptyResponse> DeleteObject(DeleteObjectRequest const&) override;
+  StatusOr<ObjectMetadata> UpdateObject(
+      UpdateObjectRequest const& request) override;
+  StatusOr<ObjectMetadata> PatchObject(
+      PatchObjectRequest const& request) override;
+  StatusOr<ObjectMetadata> ComposeObject(
+      ComposeObjectRequest const& request) override;
+  StatusOr<RewriteObjectResponse> RewriteObject(
+      RewriteObjectRequest const&) override;
+  StatusOr<std::unique_ptr<ResumableUploadSession>> CreateResumableSession(
+      ResumableUploadRequest const& request) override;
+  StatusOr<std::unique_ptr<ResumableUploadSession>> RestoreResumableSession(
+      std::string const& request) override;
+  StatusOr<EmptyResponse> DeleteResumableUpload(
+      DeleteResumableUploadRequest const& request) override;
+
+  StatusOr<ListBucketAclResponse> ListBucketAcl(
+      ListBucketAclRequest const& request) override;
+  StatusOr<BucketAccessControl> CreateBucketAcl(
+      CreateBucketAclRequest const&) override;
+  StatusOr<EmptyResponse> DeleteBucketAcl(
+      DeleteBucketAclRequest const&) override;
+  StatusOr<BucketAccessControl> GetBucketAcl(
+      GetBucketAclRequest const&) override;
+  StatusOr<BucketAccessControl> UpdateBucketAcl(
+      UpdateBucketAclRequest const&) override;
+  StatusOr<BucketAccessControl> PatchBucketAcl(
+      PatchBucketAclRequest const&) override;
+
+  StatusOr<ListObjectAclResponse> ListObjectAcl(
+      ListObjectAclRequest const& request) override;
+  StatusOr<ObjectAccessControl> CreateObjectAcl(
+      CreateObjectAclRequest const&) override;
+  StatusOr<EmptyResponse> DeleteObjectAcl(
+      DeleteObjectAclRequest const&) override;
+  StatusOr<ObjectAccessControl> GetObjectAcl(
+      GetObjectAclRequest const&) override;
+  StatusOr<ObjectAccessControl> UpdateObjectAcl(
+      UpdateObjectAclRequest const&) override;
+  StatusOr<ObjectAccessControl> PatchObjectAcl(
+      PatchObjectAclRequest const&) override;
+
+  StatusOr<ListDefaultObjectAclResponse> ListDefaultObjectAcl(
+      ListDefaultObjectAclRequest const& request) override;
+  StatusOr<ObjectAccessControl> CreateDefaultObjectAcl(
+      CreateDefaultObjectAclRequest const&) override;
+  StatusOr<EmptyResponse> DeleteDefaultObjectAcl(
+      DeleteDefaultObjectAclRequest const&) override;
+  StatusOr<ObjectAccessControl> GetDefaultObjectAcl(
+      GetDefaultObjectAclRequest const&) override;
+  StatusOr<ObjectAccessControl> UpdateDefaultObjectAcl(
+      UpdateDefaultObjectAclRequest const&) override;
+  StatusOr<ObjectAccessControl> PatchDefaultObjectAcl(
+      PatchDefaultObjectAclRequest const&) override;
+
+  StatusOr<ServiceAccount> GetServiceAccount(
+      GetProjectServiceAccountRequest const&) override;
+  StatusOr<ListHmacKeysResponse> ListHmacKeys(
+      ListHmacKeysRequest const&) override;
+  StatusOr<CreateHmacKeyResponse> CreateHmacKey(
+      CreateHmacKeyRequest const&) override;
+  StatusOr<EmptyResponse> DeleteHmacKey(DeleteHmacKeyRequest const&) override;
+  StatusOr<HmacKeyMetadata> GetHmacKey(GetHmacKeyRequest const&) override;
+  StatusOr<HmacKeyMetadata> UpdateHmacKey(UpdateHmacKeyRequest const&) override;
+  StatusOr<SignBlobResponse> SignBlob(SignBlobRequest const&) override;
+
+  StatusOr<ListNotificationsResponse> ListNotifications(
+      ListNotificationsRequest const&) override;
+  StatusOr<NotificationMetadata> CreateNotification(
+      CreateNotificationRequest const&) override;
+  StatusOr<NotificationMetadata> GetNotification(
+      GetNotificationRequest const&) override;
+  StatusOr<EmptyResponse> DeleteNotification(
+      DeleteNotificationRequest const&) override;
+
+  StatusOr<BatchResponse> ExecuteBatch(BatchRequest const&) override;
+  Status WarmUpConnectionPool() override;
+
+  std::shared_ptr<RawClient> client() const { return client_; }
+
+  static std::size_t constexpr kMaxBufferBytes = 8 * 1024 * 1024;
+  static std::chrono::milliseconds constexpr kJoinWindow =
+      std::chrono::milliseconds(100);
+
+ private:
+  std::shared_ptr<CoalescedDownload> FindDownload(
+      std::string const& key, std::chrono::steady_clock::duration max_age);
+
+  std::shared_ptr<RawClient> client_;
+  std::size_t const max_buffer_bytes_;
+  std::chrono::milliseconds const join_window_;
+  SingleFlight<StatusOr<ObjectMetadata>> object_metadata_;
+  SingleFlight<StatusOr<BucketMetadata>> bucket_metadata_;
+  SingleFlight<StatusOr<std::shared_ptr<CoalescedDownload>>> open_download_;
+
+  std::mutex mu_;
+  std::unordered_map<std::string, std::weak_ptr<CoalescedDownload>> downloads_;
+  std::size_t sweep_threshold_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_COALESCING_CLIENT_H
@@ -0,0 +1,349 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/coalescing_client.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::MockObjectReadSource;
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::storage::testing::canonical_errors::TransientError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::Return;
+
+ObjectMetadata CreateObject(int generation) {
+  return ObjectMetadataParser::FromString(R"""({
+      "bucket": "test-bucket",
+      "name": "test-object",
+      "generation": ")""" + std::to_string(generation) + R"""(",
+      "size": "10"
+})""")
+      .value();
+}
+
+/// Create a source returning @p chunks, and then the status in @p last.
+std::unique_ptr<ObjectReadSource> MakeSource(std::vector<std::string> chunks,
+                                             StatusOr<long> last) {  // NOLINT
+  auto source = absl::make_unique<MockObjectReadSource>();
+  auto index = std::make_shared<std::size_t>(0);
+  EXPECT_CALL(*source, Read(_, _))
+      .WillRepeatedly([chunks, last, index](
+                          char* buf,
+                          std::size_t n) -> StatusOr<ReadSourceResult> {
+        auto const i = (*index)++;
+        if (i < chunks.size()) {
+          auto const& c = chunks[i];
+          auto const count = (std::min)(n, c.size());
+          std::copy(c.begin(), c.begin() + count, buf);
+          ReadSourceResult result{
+              count, HttpResponse{HttpStatusCode::kContinue, {}, {}}};
+          if (i == 0) result.response.headers.emplace("x-goog-generation", "1");
+          return result;
+        }
+        if (!last) return last.status();
+        return ReadSourceResult{
+            0, HttpResponse{*last, {}, {{"x-goog-hash", "crc32c=test"}}}};
+      });
+  EXPECT_CALL(*source, Close).WillRepeatedly([] {
+    return make_status_or(HttpResponse{HttpStatusCode::kOk, {}, {}});
+  });
+  return std::unique_ptr<ObjectReadSource>(std::move(source));
+}
+
+struct ReadAllResult {
+  std::string contents;
+  std::multimap<std::string, std::string> headers;
+  long status_code;  // NOLINT(google-runtime-int)
+};
+
+StatusOr<ReadAllResult> ReadAll(ObjectReadSource& source) {
+  ReadAllResult result{{}, {}, HttpStatusCode::kContinue};
+  while (result.status_code == HttpStatusCode::kContinue) {
+    char buffer[4];
+    auto r = source.Read(buffer, sizeof(buffer));
+    if (!r) return std::move(r).status();
+    result.contents.append(buffer, r->bytes_received);
+    result.headers.insert(r->response.headers.begin(),
+                          r->response.headers.end());
+    result.status_code = r->response.status_code;
+  }
+  EXPECT_FALSE(source.IsOpen());
+  return result;
+}
+
+TEST(SingleFlightTest, DoesNotJoinOldCalls) {
+  SingleFlight<int> flight;
+  std::promise<void> started;
+  std::promise<void> release;
+  auto first = std::async(std::launch::async, [&] {
+    return flight.Run("key", std::chrono::hours(1), [&] {
+      started.set_value();
+      release.get_future().wait();
+      return 1;
+    });
+  });
+  started.get_future().wait();
+  // The first call is still running, but it is too old to join.
+  EXPECT_EQ(2, flight.Run("key", std::chrono::seconds(0), [] { return 2; }));
+  release.set_value();
+  EXPECT_EQ(1, first.get());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST(SingleFlightTest, WaitersRetryAfterException) {
+  SingleFlight<int> flight;
+  std::promise<void> started;
+  std::promise<void> release;
+  auto first = std::async(std::launch::async, [&] {
+    return flight.Run("key", std::chrono::hours(1), [&]() -> int {
+      started.set_value();
+      release.get_future().wait();
+      throw std::runtime_error("uh-oh");
+    });
+  });
+  started.get_future().wait();
+  auto second = std::async(std::launch::async, [&] {
+    return flight.Run("key", std::chrono::hours(1), [] { return 2; });
+  });
+  // Give the second call a chance to wait on the first one.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  release.set_value();
+  EXPECT_THROW(first.get(), std::runtime_error);
+  EXPECT_EQ(2, second.get());
+  EXPECT_EQ(3, flight.Run("key", std::chrono::hours(1), [] { return 3; }));
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+TEST(CoalescingClientTest, GetObjectMetadataCoalesced) {
+  auto mock = std::make_shared<testing::MockClient>();
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce([released](GetObjectMetadataRequest const&) {
+        released.wait();
+        return make_status_or(CreateObject(1));
+      });
+  CoalescingClient client(mock);
+
+  auto constexpr kThreadCount = 8;
+  std::vector<std::future<StatusOr<ObjectMetadata>>> results;
+  for (int i = 0; i != kThreadCount; ++i) {
+    results.push_back(std::async(std::launch::async, [&client] {
+      return client.GetObjectMetadata(
+          GetObjectMetadataRequest("test-bucket", "test-object"));
+    }));
+  }
+  // Give all the threads a chance to join the first request.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  release.set_value();
+  for (auto& f : results) {
+    auto r = f.get();
+    ASSERT_STATUS_OK(r);
+    EXPECT_EQ(1, r->generation());
+  }
+}
+
+TEST(CoalescingClientTest, GetObjectMetadataNotCached) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(TransientError())))
+      .WillOnce(Return(CreateObject(1)))
+      .WillOnce(Return(CreateObject(2)));
+  CoalescingClient client(mock);
+
+  GetObjectMetadataRequest request("test-bucket", "test-object");
+  EXPECT_THAT(client.GetObjectMetadata(request),
+              StatusIs(TransientError().code()));
+  auto r = client.GetObjectMetadata(request);
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(1, r->generation());
+  r = client.GetObjectMetadata(
+      GetObjectMetadataRequest(request).set_option(Generation(2)));
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(2, r->generation());
+}
+
+TEST(CoalescingClientTest, ReadObjectShared) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, ReadObject(_)).WillOnce([](ReadObjectRangeRequest const&) {
+    return make_status_or(
+        MakeSource({"0123", "4567", "89"}, HttpStatusCode::kOk));
+  });
+  CoalescingClient client(mock);
+
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  auto r1 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r1);
+  auto r2 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r2);
+
+  for (auto* source : {r1->get(), r2->get()}) {
+    auto result = ReadAll(*source);
+    ASSERT_STATUS_OK(result);
+    EXPECT_EQ("0123456789", result->contents);
+    EXPECT_EQ(HttpStatusCode::kOk, result->status_code);
+    EXPECT_EQ(1, result->headers.count("x-goog-generation"));
+    EXPECT_EQ(1, result->headers.count("x-goog-hash"));
+  }
+}
+
+TEST(CoalescingClientTest, ReadObjectJoinWindow) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, ReadObject(_))
+      .Times(3)
+      .WillRepeatedly([](ReadObjectRangeRequest const&) {
+        return make_status_or(
+            MakeSource({"0123", "4567", "89"}, HttpStatusCode::kOk));
+      });
+  CoalescingClient client(mock, CoalescingClient::kMaxBufferBytes,
+                          std::chrono::milliseconds(0));
+
+  // Requests that are not pinned to a generation could observe stale data if
+  // they joined an older download.
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  auto r1 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r1);
+  auto r2 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r2);
+
+  // The contents of a generation never change, so these are shared.
+  request.set_option(Generation(1));
+  auto r3 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r3);
+  auto r4 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r4);
+
+  for (auto* source : {r1->get(), r2->get(), r3->get(), r4->get()}) {
+    auto result = ReadAll(*source);
+    ASSERT_STATUS_OK(result);
+    EXPECT_EQ("0123456789", result->contents);
+  }
+}
+
+TEST(CoalescingClientTest, ReadObjectStopsJoiningWhenTrimming) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, ReadObject(_))
+      .Times(2)
+      .WillRepeatedly([](ReadObjectRangeRequest const&) {
+        return make_status_or(
+            MakeSource({"0123", "4567", "89"}, HttpStatusCode::kOk));
+      });
+  CoalescingClient client(mock, 4);
+
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  auto r1 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r1);
+  auto r2 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r2);
+  auto result = ReadAll(**r1);
+  ASSERT_STATUS_OK(result);
+  EXPECT_EQ("0123456789", result->contents);
+
+  // The buffer exceeded its limit, so this starts a new download.
+  auto r3 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r3);
+  for (auto* source : {r2->get(), r3->get()}) {
+    result = ReadAll(*source);
+    ASSERT_STATUS_OK(result);
+    EXPECT_EQ("0123456789", result->contents);
+  }
+}
+
+TEST(CoalescingClientTest, ReadObjectDifferentRanges) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, ReadObject(_))
+      .Times(2)
+      .WillRepeatedly([](ReadObjectRangeRequest const&) {
+        return make_status_or(MakeSource({"0123"}, HttpStatusCode::kOk));
+      });
+  CoalescingClient client(mock);
+
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  auto r1 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r1);
+  auto r2 = client.ReadObject(
+      ReadObjectRangeRequest(request).set_option(ReadRange(0, 4)));
+  ASSERT_STATUS_OK(r2);
+}
+
+TEST(CoalescingClientTest, ReadObjectErrors) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, ReadObject(_))
+      .WillOnce(Return(
+          StatusOr<std::unique_ptr<ObjectReadSource>>(PermanentError())))
+      .WillOnce([](ReadObjectRangeRequest const&) {
+        return make_status_or(
+            MakeSource({"0123", "45"}, StatusOr<long>(TransientError())));
+      });
+  CoalescingClient client(mock);
+
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  EXPECT_THAT(client.ReadObject(request), StatusIs(PermanentError().code()));
+
+  auto r1 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r1);
+  auto r2 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r2);
+  for (auto* source : {r1->get(), r2->get()}) {
+    EXPECT_THAT(ReadAll(*source), StatusIs(TransientError().code()));
+  }
+}
+
+TEST(CoalescingClientTest, ReadObjectCloseReleasesDownload) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, ReadObject(_))
+      .Times(2)
+      .WillRepeatedly([](ReadObjectRangeRequest const&) {
+        return make_status_or(
+            MakeSource({"0123", "4567", "89"}, HttpStatusCode::kOk));
+      });
+  CoalescingClient client(mock);
+
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  auto r1 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r1);
+  ASSERT_STATUS_OK((*r1)->Close());
+  EXPECT_FALSE((*r1)->IsOpen());
+
+  auto r2 = client.ReadObject(request);
+  ASSERT_STATUS_OK(r2);
+  auto result = ReadAll(**r2);
+  ASSERT_STATUS_OK(result);
+  EXPECT_EQ("0123456789", result->contents);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
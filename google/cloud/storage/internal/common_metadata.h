@@ -61,6 +61,7 @@ inline bool operator>=(Owner const& lhs, Owner const& rhs) {
 
 namespace internal {
 class GrpcClient;
+class ListObjectsSaxHandler;
 template <typename Derived>
 struct CommonMetadataParser;
 
@@ -104,6 +105,7 @@ class CommonMetadata {
 
  private:
   friend class GrpcClient;
+  friend class ListObjectsSaxHandler;
   template <typename ParserDerived>
   friend struct CommonMetadataParser;
 
@@ -0,0 +1,87 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/crc32c_combine.h"
+#include <array>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+// The CRC32C (Castagnoli) polynomial, in reversed bit order.
+auto constexpr kCrc32cPolynomial = 0x82F63B78U;
+
+using Gf2Matrix = std::array<std::uint32_t, 32>;
+
+std::uint32_t Gf2MatrixTimes(Gf2Matrix const& mat, std::uint32_t vec) {
+  std::uint32_t sum = 0;
+  for (std::size_t i = 0; vec != 0; vec >>= 1, ++i) {
+    if ((vec & 1U) != 0) sum ^= mat[i];
+  }
+  return sum;
+}
+
+Gf2Matrix Gf2MatrixSquare(Gf2Matrix const& mat) {
+  Gf2Matrix square;
+  for (std::size_t i = 0; i != mat.size(); ++i) {
+    square[i] = Gf2MatrixTimes(mat, mat[i]);
+  }
+  return square;
+}
+
+}  // namespace
+
+// This is the same algorithm used by zlib's `crc32_combine()`: appending
+// `len2` zero bytes to the first block is a linear operation in GF(2), which
+// can be computed in O(log(len2)) steps by repeatedly squaring the operator
+// that appends a single zero bit.
+std::uint32_t Crc32cCombine(std::uint32_t crc1, std::uint32_t crc2,
+                            std::uint64_t len2) {
+  if (len2 == 0) return crc1;
+
+  // The operator for a single zero bit.
+  Gf2Matrix odd;
+  odd[0] = kCrc32cPolynomial;
+  std::uint32_t row = 1;
+  for (std::size_t i = 1; i != odd.size(); ++i) {
+    odd[i] = row;
+    row <<= 1;
+  }
+  // The operator for two zero bits, and then for four zero bits.
+  auto even = Gf2MatrixSquare(odd);
+  odd = Gf2MatrixSquare(even);
+
+  // Apply `len2` zero bytes to `crc1`, the first squaring below computes the
+  // operator for one zero byte.
+  do {
+    even = Gf2MatrixSquare(odd);
+    if ((len2 & 1U) != 0) crc1 = Gf2MatrixTimes(even, crc1);
+    len2 >>= 1;
+    if (len2 == 0) break;
+
+    odd = Gf2MatrixSquare(even);
+    if ((len2 & 1U) != 0) crc1 = Gf2MatrixTimes(odd, crc1);
+    len2 >>= 1;
+  } while (len2 != 0);
+
+  return crc1 ^ crc2;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,64 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/crc32c_combine.h"
+#include <crc32c/crc32c.h>
+#include <gmock/gmock.h>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+std::uint32_t Crc(std::string const& data) {
+  return crc32c::Crc32c(data.data(), data.size());
+}
+
+TEST(Crc32cCombine, EmptySecondBlock) {
+  auto const crc1 = Crc("The quick brown fox");
+  EXPECT_EQ(crc1, Crc32cCombine(crc1, Crc(""), 0));
+}
+
+TEST(Crc32cCombine, EmptyFirstBlock) {
+  auto const crc2 = Crc("jumps over the lazy dog");
+  EXPECT_EQ(crc2, Crc32cCombine(Crc(""), crc2, 23));
+}
+
+TEST(Crc32cCombine, Simple) {
+  std::string const a = "The quick brown fox ";
+  std::string const b = "jumps over the lazy dog";
+  EXPECT_EQ(Crc(a + b), Crc32cCombine(Crc(a), Crc(b), b.size()));
+}
+
+TEST(Crc32cCombine, ManySplits) {
+  std::string data;
+  for (int i = 0; i != 4096; ++i) data.push_back(static_cast<char>(i * 7));
+  auto const expected = Crc(data);
+  for (std::size_t split : {1, 3, 255, 256, 1000, 4095}) {
+    auto const a = data.substr(0, split);
+    auto const b = data.substr(split);
+    EXPECT_EQ(expected, Crc32cCombine(Crc(a), Crc(b), b.size()))
+        << "split=" << split;
+  }
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
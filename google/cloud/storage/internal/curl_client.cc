@@ -29,7 +29,9 @@
 #include "google/cloud/internal/getenv.h"
 #include "google/cloud/terminate_handler.h"
 #include "absl/memory/memory.h"
+#include <cstring>
 #include <sstream>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -86,6 +88,69 @@ StatusOr<EmptyResponse> ReturnEmptyResponse(StatusOr<HttpResponse> response) {
   return EmptyResponse{};
 }
 
+/// The payload for a multipart upload, without the object contents.
+struct MultipartPayload {
+  /// The object metadata part, and the headers for the contents part.
+  std::string header;
+  /// The final separator, sent after the object contents.
+  std::string trailer;
+
+  std::size_t size(absl::string_view contents) const {
+    return header.size() + contents.size() + trailer.size();
+  }
+};
+
+/// Format the payload for a multipart upload using @p boundary.
+MultipartPayload FormatMultipartPayload(
+    InsertObjectMediaRequest const& request, std::string const& boundary) {
+  std::ostringstream writer;
+
+  nlohmann::json metadata = nlohmann::json::object();
+  if (request.HasOption<WithObjectMetadata>()) {
+    metadata = ObjectMetadataJsonForInsert(
+        request.GetOption<WithObjectMetadata>().value());
+  }
+  if (request.HasOption<MD5HashValue>()) {
+    metadata["md5Hash"] = request.GetOption<MD5HashValue>().value();
+  } else if (!request.GetOption<DisableMD5Hash>().value()) {
+    metadata["md5Hash"] = ComputeMD5Hash(request.contents());
+  }
+
+  if (request.HasOption<Crc32cChecksumValue>()) {
+    metadata["crc32c"] = request.GetOption<Crc32cChecksumValue>().value();
+  } else if (!request.GetOption<DisableCrc32cChecksum>().value_or(false)) {
+    metadata["crc32c"] = ComputeCrc32cChecksum(request.contents());
+  }
+
+  std::string crlf = "\r\n";
+  std::string marker = "--" + boundary;
+
+  // Format the first part, including the separators and the headers.
+  writer << marker << crlf << "content-type: application/json; charset=UTF-8"
+         << crlf << crlf << metadata.dump() << crlf << marker << crlf;
+
+  // Format the second part, which includes all the contents and a final
+  // separator.
+  if (request.HasOption<ContentType>()) {
+    writer << "content-type: " << request.GetOption<ContentType>().value()
+           << crlf;
+  } else if (metadata.count("contentType") != 0) {
+    writer << "content-type: "
+           << metadata.value("contentType", "application/octet-stream") << crlf;
+  } else {
+    writer << "content-type: application/octet-stream" << crlf;
+  }
+  writer << crlf;
+  return MultipartPayload{std::move(writer).str(),
+                          crlf + marker + "--" + crlf};
+}
+
+/// Send @p contents without copies, see `CurlRequest::MakeUploadRequest()`.
+ConstBufferSequence AsBufferSequence(absl::string_view contents) {
+  if (contents.empty()) return {};
+  return {ConstBuffer(contents.data(), contents.size())};
+}
+
 template <typename ReturnType>
 StatusOr<ReturnType> ParseFromHttpResponse(StatusOr<HttpResponse> response) {
   if (!response.ok()) {
@@ -97,6 +162,18 @@ StatusOr<ReturnType> ParseFromHttpResponse(StatusOr<HttpResponse> response) {
   return ReturnType::FromHttpResponse(response->payload);
 }
 
+// Returns the value for @p prefix in a `x-goog-hash` header, which contain
+// comma-separated values such as `crc32c=<value>,md5=<value>`.
+std::string ExtractHashValue(std::string const& header, char const* prefix) {
+  auto const prefix_length = std::strlen(prefix);
+  auto pos = header.find(prefix);
+  if (pos == std::string::npos) return {};
+  pos += prefix_length;
+  auto end = header.find(',', pos);
+  if (end == std::string::npos) return header.substr(pos);
+  return header.substr(pos, end - pos);
+}
+
 bool XmlEnabled() {
   auto const config =
       google::cloud::internal::GetEnv("GOOGLE_CLOUD_CPP_STORAGE_REST_CONFIG")
@@ -113,12 +190,32 @@ Status CurlClient::SetupBuilderCommon(CurlRequestBuilder& builder,
     return std::move(auth_header).status();
   }
   builder.SetMethod(method)
-      .ApplyClientOptions(options_)
       .AddHeader(auth_header.value())
-      .AddHeader(x_goog_api_client_header_);
+      .ApplyTemplate(request_template_);
   return Status();
 }
 
+/// Returns the bucket name for requests that have one.
+template <typename Request>
+auto RateLimiterBucket(Request const& request, int)
+    -> decltype(request.bucket_name(), std::string()) {
+  return request.bucket_name();
+}
+
+/// Requests without a bucket name share a single (unnamed) limit.
+template <typename Request>
+std::string RateLimiterBucket(Request const&, long) {  // NOLINT
+  return std::string{};
+}
+
+/// Extracts the bucket name from a (JSON API) resumable upload session URL.
+std::string BucketFromUploadSessionUrl(std::string const& url) {
+  auto const pos = url.find("/b/");
+  if (pos == std::string::npos) return std::string{};
+  auto const start = pos + 3;
+  return url.substr(start, url.find_first_of("/?", start) - start);
+}
+
 template <typename Request>
 void SetupBuilderUserIp(CurlRequestBuilder& builder, Request const& request) {
   if (request.template HasOption<UserIp>()) {
@@ -139,7 +236,8 @@ Status CurlClient::SetupBuilder(CurlRequestBuilder& builder,
   if (!status.ok()) {
     return status;
   }
-  builder.AddHeader("Host: " + storage_host_);
+  builder.AddHeader(storage_host_header_);
+  builder.SetRateLimiterBucket(RateLimiterBucket(request, 0));
   request.AddOptionsToHttpRequest(builder);
   SetupBuilderUserIp(builder, request);
   return Status();
@@ -251,6 +349,11 @@ CurlClient::CurlClient(ClientOptions options)
       xml_host_(ExtractUrlHostpart(xml_endpoint_)),
       iam_endpoint_(IamEndpoint(options_)),
       xml_enabled_(XmlEnabled()),
+      xml_lean_(xml_enabled_ && options_.enable_lean_xml()),
+      request_template_(
+          MakeCurlRequestTemplate(options_, {x_goog_api_client_header_})),
+      storage_host_header_("Host: " + storage_host_),
+      xml_host_header_("Host: " + xml_host_),
       generator_(google::cloud::internal::MakeDefaultPRNG()),
       storage_factory_(CreateHandleFactory(options_)),
       upload_factory_(CreateHandleFactory(options_)),
@@ -266,6 +369,16 @@ StatusOr<ResumableUploadResponse> CurlClient::UploadChunk(
   if (!status.ok()) {
     return status;
   }
+  auto const& rate_limiter = options_.rate_limiter();
+  auto const bucket =
+      rate_limiter ? BucketFromUploadSessionUrl(request.upload_session_url())
+                   : std::string{};
+  if (rate_limiter) {
+    // Chunks are retried by `RetryResumableUploadSession`, they do not go
+    // through the retry loop that reserves capacity for each request.
+    std::this_thread::sleep_for(rate_limiter->ReserveRequest(bucket));
+    builder.SetRateLimiterBucket(bucket);
+  }
   builder.AddHeader(request.RangeHeader());
   builder.AddHeader("Content-Type: application/octet-stream");
   builder.AddHeader("Content-Length: " +
@@ -282,6 +395,11 @@ StatusOr<ResumableUploadResponse> CurlClient::UploadChunk(
       response->status_code == HttpStatusCode::kResumeIncomplete) {
     return ResumableUploadResponse::FromHttpResponse(*std::move(response));
   }
+  if (rate_limiter &&
+      (response->status_code == HttpStatusCode::kTooManyRequests ||
+       response->status_code == HttpStatusCode::kServiceUnavailable)) {
+    rate_limiter->OnThrottled(bucket);
+  }
   return AsStatus(*response);
 }
 
@@ -509,11 +627,16 @@ StatusOr<ObjectMetadata> CurlClient::InsertObjectMedia(
   }
 
   // Unless the request uses a feature that disables it, prefer to use XML.
+  // Outside "lean" mode the application must also opt-out of receiving the
+  // full object metadata, which only the JSON API returns.
+  auto const skip_metadata =
+      request.HasOption<Fields>()
+          ? request.GetOption<Fields>().value().empty()
+          : xml_lean_;
   if (xml_enabled_ && !request.HasOption<IfMetagenerationNotMatch>() &&
       !request.HasOption<IfGenerationNotMatch>() &&
       !request.HasOption<QuotaUser>() && !request.HasOption<UserIp>() &&
-      !request.HasOption<Projection>() && request.HasOption<Fields>() &&
-      request.GetOption<Fields>().value().empty()) {
+      !request.HasOption<Projection>() && skip_metadata) {
     return InsertObjectMediaXml(request);
   }
 
@@ -554,15 +677,9 @@ StatusOr<ObjectMetadata> CurlClient::CopyObject(
 
 StatusOr<ObjectMetadata> CurlClient::GetObjectMetadata(
     GetObjectMetadataRequest const& request) {
-  CurlRequestBuilder builder(storage_endpoint_ + "/b/" + request.bucket_name() +
-                                 "/o/" + UrlEscapeString(request.object_name()),
-                             storage_factory_);
-  auto status = SetupBuilder(builder, request, "GET");
-  if (!status.ok()) {
-    return status;
-  }
-  return CheckedFromString<ObjectMetadataParser>(
-      builder.BuildRequest().MakeRequest(std::string{}));
+  auto r = PrepareGetObjectMetadata(request);
+  if (!r) return std::move(r).status();
+  return CheckedFromString<ObjectMetadataParser>(r->MakeRequest(std::string{}));
 }
 
 StatusOr<std::unique_ptr<ObjectReadSource>> CurlClient::ReadObject(
@@ -587,6 +704,9 @@ StatusOr<std::unique_ptr<ObjectReadSource>> CurlClient::ReadObject(
   if (request.RequiresNoCache()) {
     builder.AddHeader("Cache-Control: no-transform");
   }
+  if (request.GetOption<DecompressGzip>().value_or(false)) {
+    builder.AddHeader("Accept-Encoding: gzip");
+  }
 
   return std::unique_ptr<ObjectReadSource>(
       new CurlDownloadRequest(builder.BuildDownloadRequest(std::string{})));
@@ -607,17 +727,26 @@ StatusOr<ListObjectsResponse> CurlClient::ListObjects(
       builder.BuildRequest().MakeRequest(std::string{}));
 }
 
-StatusOr<EmptyResponse> CurlClient::DeleteObject(
-    DeleteObjectRequest const& request) {
+StatusOr<ListObjectsCompactResponse> CurlClient::ListObjectsCompact(
+    ListObjectsRequest const& request) {
   // Assume the bucket name is validated by the caller.
-  CurlRequestBuilder builder(storage_endpoint_ + "/b/" + request.bucket_name() +
-                                 "/o/" + UrlEscapeString(request.object_name()),
-                             storage_factory_);
-  auto status = SetupBuilder(builder, request, "DELETE");
+  CurlRequestBuilder builder(
+      storage_endpoint_ + "/b/" + request.bucket_name() + "/o",
+      storage_factory_);
+  auto status = SetupBuilder(builder, request, "GET");
   if (!status.ok()) {
     return status;
   }
-  return ReturnEmptyResponse(builder.BuildRequest().MakeRequest(std::string{}));
+  builder.AddQueryParameter("pageToken", request.page_token());
+  return ParseFromHttpResponse<ListObjectsCompactResponse>(
+      builder.BuildRequest().MakeRequest(std::string{}));
+}
+
+StatusOr<EmptyResponse> CurlClient::DeleteObject(
+    DeleteObjectRequest const& request) {
+  auto r = PrepareDeleteObject(request);
+  if (!r) return std::move(r).status();
+  return ReturnEmptyResponse(r->MakeRequest(std::string{}));
 }
 
 StatusOr<ObjectMetadata> CurlClient::UpdateObject(
@@ -1175,6 +1304,34 @@ StatusOr<EmptyResponse> CurlClient::DeleteNotification(
   return ReturnEmptyResponse(builder.BuildRequest().MakeRequest(std::string{}));
 }
 
+StatusOr<BatchResponse> CurlClient::ExecuteBatch(BatchRequest const& request) {
+  if (request.empty()) return BatchResponse{};
+  if (request.size() > BatchRequest::kMaxOperations) {
+    std::ostringstream os;
+    os << __func__ << "(): too many operations in batch request ("
+       << request.size() << "), the maximum is "
+       << BatchRequest::kMaxOperations;
+    return Status(StatusCode::kInvalidArgument, std::move(os).str());
+  }
+  // The separator must not appear in any of the operation payloads.
+  auto const path_prefix = "/storage/" + options_.version();
+  auto boundary =
+      PickBoundary(FormatBatchRequestPayload(request, "", path_prefix));
+  auto payload = FormatBatchRequestPayload(request, boundary, path_prefix);
+
+  CurlRequestBuilder builder(
+      xml_endpoint_ + "/batch/storage/" + options_.version(), storage_factory_);
+  auto status = SetupBuilderCommon(builder, "POST");
+  if (!status.ok()) {
+    return status;
+  }
+  builder.AddHeader("Content-Type: multipart/mixed; boundary=" + boundary);
+  builder.AddHeader("Content-Length: " + std::to_string(payload.size()));
+  auto response = builder.BuildRequest().MakeRequest(payload);
+  if (!response.ok()) return std::move(response).status();
+  return ParseBatchResponse(request, *response);
+}
+
 StatusOr<ObjectMetadata> CurlClient::InsertObjectMediaXml(
     InsertObjectMediaRequest const& request) {
   CurlRequestBuilder builder(xml_endpoint_ + "/" + request.bucket_name() + "/" +
@@ -1184,7 +1341,8 @@ StatusOr<ObjectMetadata> CurlClient::InsertObjectMediaXml(
   if (!status.ok()) {
     return status;
   }
-  builder.AddHeader("Host: " + xml_host_);
+  builder.AddHeader(xml_host_header_);
+  builder.SetRateLimiterBucket(request.bucket_name());
 
   //
   // Apply the options from InsertObjectMediaRequest that are set, translating
@@ -1247,17 +1405,31 @@ StatusOr<ObjectMetadata> CurlClient::InsertObjectMediaXml(
 
   builder.AddHeader("Content-Length: " +
                     std::to_string(request.contents().size()));
-  auto response = builder.BuildRequest().MakeRequest(request.contents());
+  auto response = builder.BuildRequest().MakeUploadRequest(
+      AsBufferSequence(request.contents()));
   if (!response.ok()) {
     return std::move(response).status();
   }
   if (response->status_code >= HttpStatusCode::kMinNotSuccess) {
     return AsStatus(*response);
   }
-  return internal::ObjectMetadataParser::FromJson(nlohmann::json{
+  // The XML API does not return the object metadata, but the generation and
+  // checksums are available in the response headers.
+  nlohmann::json metadata{
       {"name", request.object_name()},
       {"bucket", request.bucket_name()},
-  });
+  };
+  auto const& headers = response->headers;
+  auto g = headers.find("x-goog-generation");
+  if (g != headers.end()) metadata["generation"] = g->second;
+  auto const hashes = headers.equal_range("x-goog-hash");
+  for (auto h = hashes.first; h != hashes.second; ++h) {
+    auto crc32c = ExtractHashValue(h->second, "crc32c=");
+    if (!crc32c.empty()) metadata["crc32c"] = std::move(crc32c);
+    auto md5 = ExtractHashValue(h->second, "md5=");
+    if (!md5.empty()) metadata["md5Hash"] = std::move(md5);
+  }
+  return internal::ObjectMetadataParser::FromJson(metadata);
 }
 
 StatusOr<std::unique_ptr<ObjectReadSource>> CurlClient::ReadObjectXml(
@@ -1269,7 +1441,8 @@ StatusOr<std::unique_ptr<ObjectReadSource>> CurlClient::ReadObjectXml(
   if (!status.ok()) {
     return status;
   }
-  builder.AddHeader("Host: " + xml_host_);
+  builder.AddHeader(xml_host_header_);
+  builder.SetRateLimiterBucket(request.bucket_name());
 
   //
   // Apply the options from ReadObjectMediaRequest that are set, translating
@@ -1307,6 +1480,13 @@ StatusOr<std::unique_ptr<ObjectReadSource>> CurlClient::ReadObjectXml(
   if (request.RequiresNoCache()) {
     builder.AddHeader("Cache-Control: no-transform");
   }
+  auto const decompress = request.GetOption<DecompressGzip>().value_or(false);
+  if (decompress) builder.AddHeader("Accept-Encoding: gzip");
+  if (xml_lean_) {
+    std::vector<std::string> names{"x-goog-hash", "x-goog-generation"};
+    if (decompress) names.emplace_back("content-encoding");
+    builder.SetReceivedHeadersFilter(std::move(names));
+  }
 
   return std::unique_ptr<ObjectReadSource>(
       new CurlDownloadRequest(builder.BuildDownloadRequest(std::string{})));
@@ -1314,73 +1494,23 @@ StatusOr<std::unique_ptr<ObjectReadSource>> CurlClient::ReadObjectXml(
 
 StatusOr<ObjectMetadata> CurlClient::InsertObjectMediaMultipart(
     InsertObjectMediaRequest const& request) {
-  // To perform a multipart upload we need to separate the parts as described
-  // in:
-  //   https://cloud.google.com/storage/docs/uploading-objects#rest-upload-objects
-  // This function is structured as follows:
-  // 1. Create a request object, as we often do.
-  CurlRequestBuilder builder(
-      upload_endpoint_ + "/b/" + request.bucket_name() + "/o", upload_factory_);
-  auto status = SetupBuilder(builder, request, "POST");
-  if (!status.ok()) {
-    return status;
-  }
-
-  // 2. Pick a separator that does not conflict with the request contents.
-  auto boundary = PickBoundary(request.contents());
-  builder.AddHeader("content-type: multipart/related; boundary=" + boundary);
-  builder.AddQueryParameter("uploadType", "multipart");
-  builder.AddQueryParameter("name", request.object_name());
-
-  // 3. Perform a streaming upload because computing the size upfront is more
-  //    complicated than it is worth.
-  std::ostringstream writer;
-
-  nlohmann::json metadata = nlohmann::json::object();
-  if (request.HasOption<WithObjectMetadata>()) {
-    metadata = ObjectMetadataJsonForInsert(
-        request.GetOption<WithObjectMetadata>().value());
-  }
-  if (request.HasOption<MD5HashValue>()) {
-    metadata["md5Hash"] = request.GetOption<MD5HashValue>().value();
-  } else if (!request.GetOption<DisableMD5Hash>().value()) {
-    metadata["md5Hash"] = ComputeMD5Hash(request.contents());
-  }
-
-  if (request.HasOption<Crc32cChecksumValue>()) {
-    metadata["crc32c"] = request.GetOption<Crc32cChecksumValue>().value();
-  } else if (!request.GetOption<DisableCrc32cChecksum>().value_or(false)) {
-    metadata["crc32c"] = ComputeCrc32cChecksum(request.contents());
-  }
-
-  std::string crlf = "\r\n";
-  std::string marker = "--" + boundary;
-
-  // 4. Format the first part, including the separators and the headers.
-  writer << marker << crlf << "content-type: application/json; charset=UTF-8"
-         << crlf << crlf << metadata.dump() << crlf << marker << crlf;
-
-  // 5. Format the second part, which includes all the contents and a final
-  //    separator.
-  if (request.HasOption<ContentType>()) {
-    writer << "content-type: " << request.GetOption<ContentType>().value()
-           << crlf;
-  } else if (metadata.count("contentType") != 0) {
-    writer << "content-type: "
-           << metadata.value("contentType", "application/octet-stream") << crlf;
-  } else {
-    writer << "content-type: application/octet-stream" << crlf;
-  }
-  writer << crlf << request.contents() << crlf << marker << "--" << crlf;
-
-  // 6. Return the results as usual.
-  auto contents = std::move(writer).str();
-  builder.AddHeader("Content-Length: " + std::to_string(contents.size()));
+  auto const contents = request.contents();
+  auto boundary = PickBoundary(contents);
+  auto payload = FormatMultipartPayload(request, boundary);
+  auto r = PrepareInsertObjectMediaMultipart(request, boundary,
+                                             payload.size(contents));
+  if (!r) return std::move(r).status();
+  // Send the contents from the request, instead of copying them into a single
+  // buffer with the other parts.
+  ConstBufferSequence buffers{
+      ConstBuffer(payload.header.data(), payload.header.size())};
+  if (!contents.empty()) buffers.emplace_back(contents.data(), contents.size());
+  buffers.emplace_back(payload.trailer.data(), payload.trailer.size());
   return CheckedFromString<ObjectMetadataParser>(
-      builder.BuildRequest().MakeRequest(contents));
+      r->MakeUploadRequest(std::move(buffers)));
 }
 
-std::string CurlClient::PickBoundary(std::string const& text_to_avoid) {
+std::string CurlClient::PickBoundary(absl::string_view text_to_avoid) {
   // We need to find a string that is *not* found in `text_to_avoid`, we pick
   // a string at random, and see if it is in `text_to_avoid`, if it is, we grow
   // the string with random characters and start from where we last found a
@@ -1401,6 +1531,128 @@ std::string CurlClient::PickBoundary(std::string const& text_to_avoid) {
 
 StatusOr<ObjectMetadata> CurlClient::InsertObjectMediaSimple(
     InsertObjectMediaRequest const& request) {
+  auto r = PrepareInsertObjectMediaSimple(request);
+  if (!r) return std::move(r).status();
+  return CheckedFromString<ObjectMetadataParser>(
+      r->MakeUploadRequest(AsBufferSequence(request.contents())));
+}
+
+future<StatusOr<ObjectMetadata>> CurlClient::AsyncGetObjectMetadata(
+    GetObjectMetadataRequest const& request) {
+  auto r = PrepareGetObjectMetadata(request);
+  if (!r) {
+    return make_ready_future(StatusOr<ObjectMetadata>(std::move(r).status()));
+  }
+  return (*std::move(r))
+      .MakeRequestAsync(*reactor(), std::string{})
+      .then([](future<StatusOr<HttpResponse>> f) {
+        return CheckedFromString<ObjectMetadataParser>(f.get());
+      });
+}
+
+future<StatusOr<ObjectMetadata>> CurlClient::AsyncInsertObjectMedia(
+    InsertObjectMediaRequest const& request) {
+  // Uploads using the XML API are not supported, they are only used when the
+  // application requests no metadata in the response.
+  StatusOr<CurlRequest> r;
+  std::string payload;
+  if (request.HasOption<WithObjectMetadata>() ||
+      !request.GetOption<DisableMD5Hash>().value() ||
+      !request.GetOption<DisableCrc32cChecksum>().value_or(false)) {
+    auto boundary = PickBoundary(request.contents());
+    auto parts = FormatMultipartPayload(request, boundary);
+    payload = std::move(parts.header);
+    payload.append(request.contents().data(), request.contents().size());
+    payload += parts.trailer;
+    r = PrepareInsertObjectMediaMultipart(request, boundary, payload.size());
+  } else {
+    payload = std::string(request.contents());
+    r = PrepareInsertObjectMediaSimple(request);
+  }
+  if (!r) {
+    return make_ready_future(StatusOr<ObjectMetadata>(std::move(r).status()));
+  }
+  return (*std::move(r))
+      .MakeRequestAsync(*reactor(), std::move(payload))
+      .then([](future<StatusOr<HttpResponse>> f) {
+        return CheckedFromString<ObjectMetadataParser>(f.get());
+      });
+}
+
+future<StatusOr<EmptyResponse>> CurlClient::AsyncDeleteObject(
+    DeleteObjectRequest const& request) {
+  auto r = PrepareDeleteObject(request);
+  if (!r) {
+    return make_ready_future(StatusOr<EmptyResponse>(std::move(r).status()));
+  }
+  return (*std::move(r))
+      .MakeRequestAsync(*reactor(), std::string{})
+      .then([](future<StatusOr<HttpResponse>> f) {
+        return ReturnEmptyResponse(f.get());
+      });
+}
+
+std::shared_ptr<CurlMultiReactor> CurlClient::reactor() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!reactor_) {
+    reactor_ = std::make_shared<CurlMultiReactor>(
+        static_cast<long>(  // NOLINT(google-runtime-int)
+            options_.connection_pool_size()));
+  }
+  return reactor_;
+}
+
+StatusOr<CurlRequest> CurlClient::PrepareGetObjectMetadata(
+    GetObjectMetadataRequest const& request) {
+  CurlRequestBuilder builder(storage_endpoint_ + "/b/" + request.bucket_name() +
+                                 "/o/" + UrlEscapeString(request.object_name()),
+                             storage_factory_);
+  auto status = SetupBuilder(builder, request, "GET");
+  if (!status.ok()) {
+    return status;
+  }
+  return builder.BuildRequest();
+}
+
+StatusOr<CurlRequest> CurlClient::PrepareDeleteObject(
+    DeleteObjectRequest const& request) {
+  // Assume the bucket name is validated by the caller.
+  CurlRequestBuilder builder(storage_endpoint_ + "/b/" + request.bucket_name() +
+                                 "/o/" + UrlEscapeString(request.object_name()),
+                             storage_factory_);
+  auto status = SetupBuilder(builder, request, "DELETE");
+  if (!status.ok()) {
+    return status;
+  }
+  return builder.BuildRequest();
+}
+
+StatusOr<CurlRequest> CurlClient::PrepareInsertObjectMediaMultipart(
+    InsertObjectMediaRequest const& request, std::string const& boundary,
+    std::size_t payload_size) {
+  // To perform a multipart upload we need to separate the parts as described
+  // in:
+  //   https://cloud.google.com/storage/docs/uploading-objects#rest-upload-objects
+  // The payload is formatted by `FormatMultipartPayload()`, using a
+  // @p boundary that does not conflict with the request contents.
+  CurlRequestBuilder builder(
+      upload_endpoint_ + "/b/" + request.bucket_name() + "/o", upload_factory_);
+  auto status = SetupBuilder(builder, request, "POST");
+  if (!status.ok()) {
+    return status;
+  }
+  builder.AddHeader("content-type: multipart/related; boundary=" + boundary);
+  builder.AddQueryParameter("uploadType", "multipart");
+  builder.AddQueryParameter("name", request.object_name());
+  builder.AddHeader("Content-Length: " + std::to_string(payload_size));
+  // The payload may be sent from several buffers, disable chunked transfer
+  // encoding as the content length is known.
+  builder.AddHeader("Transfer-Encoding:");
+  return builder.BuildRequest();
+}
+
+StatusOr<CurlRequest> CurlClient::PrepareInsertObjectMediaSimple(
+    InsertObjectMediaRequest const& request) {
   CurlRequestBuilder builder(
       upload_endpoint_ + "/b/" + request.bucket_name() + "/o", upload_factory_);
   auto status = SetupBuilder(builder, request, "POST");
@@ -1416,8 +1668,13 @@ StatusOr<ObjectMetadata> CurlClient::InsertObjectMediaSimple(
   builder.AddQueryParameter("name", request.object_name());
   builder.AddHeader("Content-Length: " +
                     std::to_string(request.contents().size()));
-  return CheckedFromString<ObjectMetadataParser>(
-      builder.BuildRequest().MakeRequest(request.contents()));
+  return builder.BuildRequest();
+}
+
+Status CurlClient::WarmUpConnectionPool() {
+  auto status = storage_factory_->WarmUp(storage_endpoint_);
+  auto upload = upload_factory_->WarmUp(upload_endpoint_);
+  return status.ok() ? upload : status;
 }
 
 }  // namespace internal
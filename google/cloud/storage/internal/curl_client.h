@@ -16,11 +16,15 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CURL_CLIENT_H
 
 #include "google/cloud/storage/internal/curl_handle_factory.h"
+#include "google/cloud/storage/internal/curl_multi_reactor.h"
+#include "google/cloud/storage/internal/curl_request_builder.h"
 #include "google/cloud/storage/internal/raw_client.h"
 #include "google/cloud/storage/internal/resumable_upload_session.h"
 #include "google/cloud/storage/oauth2/credentials.h"
 #include "google/cloud/storage/version.h"
+#include "google/cloud/future.h"
 #include "google/cloud/internal/random.h"
+#include <memory>
 #include <mutex>
 
 namespace google {
@@ -28,6 +32,7 @@ namespace cloud {
 namespace storage {
 inline namespace STORAGE_CLIENT_NS {
 namespace internal {
+class CurlRequest;
 class CurlRequestBuilder;
 
 /**
@@ -101,6 +106,8 @@ class CurlClient : public RawClient,
       ReadObjectRangeRequest const&) override;
   StatusOr<ListObjectsResponse> ListObjects(
       ListObjectsRequest const& request) override;
+  StatusOr<ListObjectsCompactResponse> ListObjectsCompact(
+      ListObjectsRequest const& request) override;
   StatusOr<EmptyResponse> DeleteObject(
       DeleteObjectRequest const& request) override;
   StatusOr<ObjectMetadata> UpdateObject(
@@ -179,6 +186,28 @@ class CurlClient : public RawClient,
   StatusOr<EmptyResponse> DeleteNotification(
       DeleteNotificationRequest const&) override;
 
+  StatusOr<BatchResponse> ExecuteBatch(BatchRequest const&) override;
+  Status WarmUpConnectionPool() override;
+
+  //@{
+  /**
+   * @name Asynchronous operations.
+   *
+   * These operations run on the `CurlMultiReactor` returned by `reactor()`,
+   * many of them can be in flight without blocking any threads. They make a
+   * single attempt, the retry loop is implemented by the caller.
+   */
+  future<StatusOr<ObjectMetadata>> AsyncGetObjectMetadata(
+      GetObjectMetadataRequest const& request);
+  future<StatusOr<ObjectMetadata>> AsyncInsertObjectMedia(
+      InsertObjectMediaRequest const& request);
+  future<StatusOr<EmptyResponse>> AsyncDeleteObject(
+      DeleteObjectRequest const& request);
+
+  /// The reactor shared by all the asynchronous operations in this client.
+  std::shared_ptr<CurlMultiReactor> reactor();
+  //@}
+
  protected:
   // The constructor is private because the class must always be created
   // as a shared_ptr<>.
@@ -193,6 +222,18 @@ class CurlClient : public RawClient,
   Status SetupBuilder(CurlRequestBuilder& builder, Request const& request,
                       char const* method);
 
+  //@{
+  /// @name Create the requests shared by the synchronous and asynchronous APIs.
+  StatusOr<CurlRequest> PrepareGetObjectMetadata(
+      GetObjectMetadataRequest const& request);
+  StatusOr<CurlRequest> PrepareDeleteObject(DeleteObjectRequest const& request);
+  StatusOr<CurlRequest> PrepareInsertObjectMediaMultipart(
+      InsertObjectMediaRequest const& request, std::string const& boundary,
+      std::size_t payload_size);
+  StatusOr<CurlRequest> PrepareInsertObjectMediaSimple(
+      InsertObjectMediaRequest const& request);
+  //@}
+
   StatusOr<ObjectMetadata> InsertObjectMediaXml(
       InsertObjectMediaRequest const& request);
   StatusOr<std::unique_ptr<ObjectReadSource>> ReadObjectXml(
@@ -201,7 +242,7 @@ class CurlClient : public RawClient,
   /// Insert an object using uploadType=multipart.
   StatusOr<ObjectMetadata> InsertObjectMediaMultipart(
       InsertObjectMediaRequest const& request);
-  std::string PickBoundary(std::string const& text_to_avoid);
+  std::string PickBoundary(absl::string_view text_to_avoid);
 
   /// Insert an object using uploadType=media.
   StatusOr<ObjectMetadata> InsertObjectMediaSimple(
@@ -220,6 +261,15 @@ class CurlClient : public RawClient,
   std::string const xml_host_;
   std::string const iam_endpoint_;
   bool const xml_enabled_;
+  // Prefer the XML API for all eligible uploads and downloads, and keep only
+  // the response headers the library uses, see
+  // `ClientOptions::enable_lean_xml()`.
+  bool const xml_lean_;
+  // The request configuration computed once from `options_`, and the
+  // pre-formatted `Host:` headers, avoid that work on each request.
+  CurlRequestTemplate const request_template_;
+  std::string const storage_host_header_;
+  std::string const xml_host_header_;
 
   std::mutex mu_;
   google::cloud::internal::DefaultPRNG generator_;  // GUARDED_BY(mu_);
@@ -228,6 +278,8 @@ class CurlClient : public RawClient,
   std::shared_ptr<CurlHandleFactory> upload_factory_;
   std::shared_ptr<CurlHandleFactory> xml_upload_factory_;
   std::shared_ptr<CurlHandleFactory> xml_download_factory_;
+
+  std::shared_ptr<CurlMultiReactor> reactor_;  // GUARDED_BY(mu_)
 };
 
 }  // namespace internal
@@ -225,6 +225,16 @@ TEST_P(CurlClientTest, InsertObjectMediaXml) {
   CheckStatus(actual);
 }
 
+TEST_P(CurlClientTest, InsertObjectMediaLeanXml) {
+  auto options = client_->client_options();
+  auto client = CurlClient::Create(options.set_enable_lean_xml(true));
+  auto actual = client
+                    ->InsertObjectMedia(
+                        InsertObjectMediaRequest("bkt", "obj", "contents"))
+                    .status();
+  CheckStatus(actual);
+}
+
 TEST_P(CurlClientTest, GetObjectMetadata) {
   auto actual =
       client_->GetObjectMetadata(GetObjectMetadataRequest("bkt", "obj"))
@@ -264,6 +274,42 @@ TEST_P(CurlClientTest, DeleteObject) {
   CheckStatus(actual);
 }
 
+TEST_P(CurlClientTest, AsyncGetObjectMetadata) {
+  auto actual =
+      client_->AsyncGetObjectMetadata(GetObjectMetadataRequest("bkt", "obj"))
+          .get()
+          .status();
+  CheckStatus(actual);
+}
+
+TEST_P(CurlClientTest, AsyncInsertObjectMediaSimple) {
+  auto actual = client_
+                    ->AsyncInsertObjectMedia(
+                        InsertObjectMediaRequest("bkt", "obj", "contents")
+                            .set_multiple_options(DisableMD5Hash(true),
+                                                  DisableCrc32cChecksum(true)))
+                    .get()
+                    .status();
+  CheckStatus(actual);
+}
+
+TEST_P(CurlClientTest, AsyncInsertObjectMediaMultipart) {
+  auto actual = client_
+                    ->AsyncInsertObjectMedia(
+                        InsertObjectMediaRequest("bkt", "obj", "contents"))
+                    .get()
+                    .status();
+  CheckStatus(actual);
+}
+
+TEST_P(CurlClientTest, AsyncDeleteObject) {
+  auto actual =
+      client_->AsyncDeleteObject(DeleteObjectRequest("bkt", "obj"))
+          .get()
+          .status();
+  CheckStatus(actual);
+}
+
 TEST_P(CurlClientTest, UpdateObject) {
   auto actual =
       client_->UpdateObject(UpdateObjectRequest("bkt", "obj", ObjectMetadata()))
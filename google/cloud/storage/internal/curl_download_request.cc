@@ -15,10 +15,12 @@
 #include "google/cloud/storage/internal/curl_download_request.h"
 #include "google/cloud/storage/internal/binary_data_as_debug_string.h"
 #include "google/cloud/storage/internal/curl_wrappers.h"
+#include "google/cloud/storage/internal/stage_timer.h"
 #include "google/cloud/internal/throw_delegate.h"
 #include "google/cloud/log.h"
 #include <curl/multi.h>
 #include <algorithm>
+#include <cctype>
 #include <cstring>
 #include <thread>
 
@@ -57,8 +59,7 @@ extern "C" std::size_t CurlDownloadRequestHeader(char* contents,
 CurlDownloadRequest::CurlDownloadRequest()
     : headers_(nullptr, &curl_slist_free_all),
       download_stall_timeout_(0),
-      multi_(nullptr, &curl_multi_cleanup),
-      spill_(CURL_MAX_WRITE_SIZE) {}
+      multi_(nullptr, &curl_multi_cleanup) {}
 
 template <typename Predicate>
 Status CurlDownloadRequest::Wait(Predicate predicate) {
@@ -172,6 +173,12 @@ StatusOr<ReadSourceResult> CurlDownloadRequest::Read(char* buf, std::size_t n) {
   }
   TRACE_STATE();
   auto bytes_read = buffer_offset_;
+  if (rate_limiter_ && bytes_read != 0) {
+    // The transfer is paused (or complete) at this point, waiting here slows
+    // down the download without holding any data in libcurl buffers.
+    std::this_thread::sleep_for(
+        rate_limiter_->ReserveBytes(rate_limiter_bucket_, bytes_read));
+  }
   buffer_ = nullptr;
   buffer_offset_ = 0;
   buffer_size_ = 0;
@@ -243,6 +250,7 @@ void CurlDownloadRequest::SetOptions() {
 }
 
 void CurlDownloadRequest::DrainSpillBuffer() {
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kCopy);
   std::size_t free = buffer_size_ - buffer_offset_;
   auto copy_count = (std::min)(free, spill_offset_);
   std::copy(spill_.data(), spill_.data() + copy_count,
@@ -281,6 +289,7 @@ std::size_t CurlDownloadRequest::WriteCallback(void* ptr, std::size_t size,
   }
   TRACE_STATE() << ", n=" << size * nmemb << ", free=" << free;
 
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kCopy);
   // Copy the full contents of `ptr` into the application buffer.
   if (size * nmemb < free) {
     std::memcpy(buffer_ + buffer_offset_, ptr, size * nmemb);
@@ -301,7 +310,25 @@ std::size_t CurlDownloadRequest::WriteCallback(void* ptr, std::size_t size,
 std::size_t CurlDownloadRequest::HeaderCallback(char* contents,
                                                 std::size_t size,
                                                 std::size_t nitems) {
-  return CurlAppendHeaderData(received_headers_, contents, size * nitems);
+  auto const n = size * nitems;
+  if (!received_headers_filter_.empty()) {
+    // Compare the names in place, most headers are discarded and there is no
+    // need to allocate strings for them.
+    auto const* separator = std::find(contents, contents + n, ':');
+    auto const length = static_cast<std::size_t>(separator - contents);
+    auto const wanted = std::any_of(
+        received_headers_filter_.begin(), received_headers_filter_.end(),
+        [&](std::string const& name) {
+          return name.size() == length &&
+                 std::equal(name.begin(), name.end(), contents,
+                            [](char a, char b) {
+                              return a == std::tolower(
+                                              static_cast<unsigned char>(b));
+                            });
+        });
+    if (!wanted) return n;
+  }
+  return CurlAppendHeaderData(received_headers_, contents, n);
 }
 
 StatusOr<int> CurlDownloadRequest::PerformWork() {
@@ -315,9 +342,12 @@ StatusOr<int> CurlDownloadRequest::PerformWork() {
   // work, but is it pretty harmless to keep here.
   int running_handles = 0;
   CURLMcode result;
-  do {
-    result = curl_multi_perform(multi_.get(), &running_handles);
-  } while (result == CURLM_CALL_MULTI_PERFORM);
+  {
+    GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kTransport);
+    do {
+      result = curl_multi_perform(multi_.get(), &running_handles);
+    } while (result == CURLM_CALL_MULTI_PERFORM);
+  }
 
   // Throw an exception if the result is unexpected, otherwise return.
   auto status = AsStatus(result, __func__);
@@ -18,7 +18,10 @@
 #include "google/cloud/storage/internal/curl_request.h"
 #include "google/cloud/storage/internal/http_response.h"
 #include "google/cloud/storage/internal/object_read_source.h"
+#include "google/cloud/storage/internal/pooled_buffer.h"
 #include "google/cloud/storage/version.h"
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -110,6 +113,11 @@ class CurlDownloadRequest : public ObjectReadSource {
   std::string payload_;
   std::string user_agent_;
   CurlReceivedHeaders received_headers_;
+  // If not empty, only these (lowercase) headers are kept in
+  // `received_headers_`.
+  std::vector<std::string> received_headers_filter_;
+  std::shared_ptr<RateLimiter> rate_limiter_;
+  std::string rate_limiter_bucket_;
   bool logging_enabled_ = false;
   CurlHandle::SocketOptions socket_options_;
   std::chrono::seconds download_stall_timeout_;
@@ -149,8 +157,9 @@ class CurlDownloadRequest : public ObjectReadSource {
   // WriteCallback. However, the callback *must* save all the bytes, returning
   // less bytes read aborts the download (we do that on a Close(), but in
   // general we do not). The application may have requested less bytes in the
-  // call to `Read()`, so we need a place to store the additional bytes.
-  std::vector<char> spill_;
+  // call to `Read()`, so we need a place to store the additional bytes. The
+  // buffer is allocated by `CurlRequestBuilder`, from the client's pool.
+  PooledBuffer spill_;
   std::size_t spill_offset_ = 0;
 };
 
@@ -16,6 +16,7 @@
 #include "google/cloud/storage/internal/binary_data_as_debug_string.h"
 #include "google/cloud/internal/strerror.h"
 #include "google/cloud/log.h"
+#include "absl/memory/memory.h"
 #ifdef _WIN32
 #include <winsock.h>
 #else
@@ -65,6 +66,13 @@ extern "C" int CurlHandleDebugCallback(CURL*, curl_infotype type, char* data,
   return 0;
 }
 
+extern "C" int CurlHandleProgressCallback(void* userdata, curl_off_t,
+                                          curl_off_t, curl_off_t, curl_off_t) {
+  auto const* token = reinterpret_cast<CancellationToken const*>(userdata);
+  // Any non-zero value aborts the transfer.
+  return token->cancelled() ? 1 : 0;
+}
+
 extern "C" int CurlSetSocketOptions(void* userdata, curl_socket_t curlfd,
                                     curlsocktype purpose) {
   auto errno_msg = [] { return google::cloud::internal::strerror(errno); };
@@ -146,6 +154,13 @@ void CurlHandle::EnableLogging(bool enabled) {
   }
 }
 
+void CurlHandle::SetCancellationToken(CancellationToken token) {
+  cancellation_token_ = absl::make_unique<CancellationToken>(std::move(token));
+  SetOption(CURLOPT_XFERINFOFUNCTION, &CurlHandleProgressCallback);
+  SetOption(CURLOPT_XFERINFODATA, cancellation_token_.get());
+  SetOption(CURLOPT_NOPROGRESS, 0L);
+}
+
 void CurlHandle::FlushDebug(char const* where) {
   if (!debug_buffer_.empty()) {
     GCP_LOG(DEBUG) << where << ' ' << debug_buffer_;
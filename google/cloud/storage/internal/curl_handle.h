@@ -18,8 +18,10 @@
 #include "google/cloud/storage/client_options.h"
 #include "google/cloud/storage/internal/curl_wrappers.h"
 #include "google/cloud/storage/version.h"
+#include "google/cloud/cancellation.h"
 #include "google/cloud/status_or.h"
 #include <curl/curl.h>
+#include <memory>
 
 namespace google {
 namespace cloud {
@@ -94,6 +96,15 @@ class CurlHandle {
 
   void EnableLogging(bool enabled);
 
+  /**
+   * Aborts the transfer, with `CURLE_ABORTED_BY_CALLBACK`, once @p token is
+   * cancelled.
+   *
+   * libcurl checks the token through its progress callback, which runs at
+   * least once per second, and more often while data is transferred.
+   */
+  void SetCancellationToken(CancellationToken token);
+
   /// Flushes any debug data using GCP_LOG().
   void FlushDebug(char const* where);
 
@@ -104,6 +115,7 @@ class CurlHandle {
   explicit CurlHandle(CurlPtr ptr) : handle_(std::move(ptr)) {}
 
   friend class CurlDownloadRequest;
+  friend class CurlMultiReactor;
   friend class CurlRequestBuilder;
   friend class CurlHandleFactory;
 
@@ -124,6 +136,8 @@ class CurlHandle {
   CurlPtr handle_;
   std::string debug_buffer_;
   SocketOptions socket_options_;
+  // Held by pointer, libcurl keeps its address across moves of this object.
+  std::unique_ptr<CancellationToken> cancellation_token_;
 };
 
 }  // namespace internal
@@ -13,12 +13,24 @@
 // limitations under the License.
 
 #include "google/cloud/storage/internal/curl_handle_factory.h"
+#include <algorithm>
+#include <sstream>
 
 namespace google {
 namespace cloud {
 namespace storage {
 inline namespace STORAGE_CLIENT_NS {
 namespace internal {
+namespace {
+Status AsStatus(CURLMcode result, char const* where) {
+  if (result == CURLM_OK) return Status();
+  std::ostringstream os;
+  os << where << "(): unexpected error code in curl_multi_*, [" << result
+     << "]=" << curl_multi_strerror(result);
+  return Status(StatusCode::kUnknown, std::move(os).str());
+}
+}  // namespace
+
 std::once_flag default_curl_handle_factory_initialized;
 std::shared_ptr<CurlHandleFactory> default_curl_handle_factory;
 
@@ -74,12 +86,23 @@ void DefaultCurlHandleFactory::CleanupMultiHandle(CurlMulti&& m) { m.reset(); }
 
 PooledCurlHandleFactory::PooledCurlHandleFactory(std::size_t maximum_size,
                                                  ChannelOptions options)
-    : maximum_size_(maximum_size), options_(std::move(options)) {
+    : maximum_size_(maximum_size),
+      share_(curl_share_init(), &curl_share_cleanup),
+      options_(std::move(options)) {
   handles_.reserve(maximum_size);
   multi_handles_.reserve(maximum_size);
+  (void)curl_share_setopt(share_.get(), CURLSHOPT_LOCKFUNC,
+                          &PooledCurlHandleFactory::LockShare);
+  (void)curl_share_setopt(share_.get(), CURLSHOPT_UNLOCKFUNC,
+                          &PooledCurlHandleFactory::UnlockShare);
+  (void)curl_share_setopt(share_.get(), CURLSHOPT_USERDATA, this);
+  (void)curl_share_setopt(share_.get(), CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  (void)curl_share_setopt(share_.get(), CURLSHOPT_SHARE,
+                          CURL_LOCK_DATA_SSL_SESSION);
 }
 
 PooledCurlHandleFactory::~PooledCurlHandleFactory() {
+  // The handles must be released before `share_`.
   for (auto* h : handles_) {
     curl_easy_cleanup(h);
   }
@@ -97,11 +120,11 @@ CurlPtr PooledCurlHandleFactory::CreateHandle() {
     handles_.pop_back();
     CurlPtr curl(handle, &curl_easy_cleanup);
     SetCurlOptions(curl.get(), options_);
+    (void)curl_easy_setopt(curl.get(), CURLOPT_SHARE, share_.get());
     return curl;
   }
-  CurlPtr curl(curl_easy_init(), &curl_easy_cleanup);
-  SetCurlOptions(curl.get(), options_);
-  return curl;
+  lk.unlock();
+  return CreateNewHandle();
 }
 
 void PooledCurlHandleFactory::CleanupHandle(CurlHandle&& h) {
@@ -143,6 +166,81 @@ void PooledCurlHandleFactory::CleanupMultiHandle(CurlMulti&& m) {
   (void)m.release();
 }
 
+Status PooledCurlHandleFactory::WarmUp(std::string const& url) {
+  std::size_t count = 0;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (handles_.size() < maximum_size_) count = maximum_size_ - handles_.size();
+  }
+  if (count == 0) return Status();
+
+  Status status;
+  auto multi = CreateMultiHandle();
+  std::vector<CurlPtr> handles;
+  handles.reserve(count);
+  for (std::size_t i = 0; i != count && status.ok(); ++i) {
+    auto curl = CreateNewHandle();
+    (void)curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+    (void)curl_easy_setopt(curl.get(), CURLOPT_NOBODY, 1L);
+    (void)curl_easy_setopt(curl.get(), CURLOPT_NOSIGNAL, 1L);
+    status = AsStatus(curl_multi_add_handle(multi.get(), curl.get()), __func__);
+    if (status.ok()) handles.push_back(std::move(curl));
+  }
+
+  int running = static_cast<int>(handles.size());
+  while (running != 0 && status.ok()) {
+    status = AsStatus(curl_multi_perform(multi.get(), &running), __func__);
+    if (running == 0 || !status.ok()) break;
+    status = AsStatus(curl_multi_wait(multi.get(), nullptr, 0, 1000, nullptr),
+                      __func__);
+  }
+
+  std::vector<CURL*> connected;
+  int remaining;
+  while (auto* msg = curl_multi_info_read(multi.get(), &remaining)) {
+    if (msg->msg != CURLMSG_DONE) continue;
+    if (msg->data.result == CURLE_OK) {
+      connected.push_back(msg->easy_handle);
+    } else if (status.ok()) {
+      status = CurlHandle::AsStatus(msg->data.result, __func__);
+    }
+  }
+
+  for (auto& h : handles) (void)curl_multi_remove_handle(multi.get(), h.get());
+  CleanupMultiHandle(std::move(multi));
+
+  // The connected handles keep their connection open while in the pool.
+  std::lock_guard<std::mutex> lk(mu_);
+  for (auto& h : handles) {
+    if (handles_.size() >= maximum_size_) break;
+    if (std::find(connected.begin(), connected.end(), h.get()) ==
+        connected.end()) {
+      continue;
+    }
+    handles_.push_back(h.release());
+  }
+  return status;
+}
+
+CurlPtr PooledCurlHandleFactory::CreateNewHandle() {
+  CurlPtr curl(curl_easy_init(), &curl_easy_cleanup);
+  SetCurlOptions(curl.get(), options_);
+  (void)curl_easy_setopt(curl.get(), CURLOPT_SHARE, share_.get());
+  return curl;
+}
+
+void PooledCurlHandleFactory::LockShare(CURL*, curl_lock_data data,
+                                        curl_lock_access, void* userptr) {
+  auto* self = static_cast<PooledCurlHandleFactory*>(userptr);
+  self->share_mu_[data].lock();
+}
+
+void PooledCurlHandleFactory::UnlockShare(CURL*, curl_lock_data data,
+                                          void* userptr) {
+  auto* self = static_cast<PooledCurlHandleFactory*>(userptr);
+  self->share_mu_[data].unlock();
+}
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
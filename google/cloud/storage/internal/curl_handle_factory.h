@@ -18,7 +18,9 @@
 #include "google/cloud/storage/internal/curl_handle.h"
 #include "google/cloud/storage/internal/curl_wrappers.h"
 #include "google/cloud/storage/version.h"
+#include "google/cloud/status.h"
 #include <mutex>
+#include <string>
 #include <vector>
 
 namespace google {
@@ -41,6 +43,14 @@ class CurlHandleFactory {
 
   virtual std::string LastClientIpAddress() const = 0;
 
+  /**
+   * Establish connections to @p url, so future requests can reuse them.
+   *
+   * Factories that do not keep handles between requests have nothing to warm
+   * up, the default implementation does nothing.
+   */
+  virtual Status WarmUp(std::string const& /*url*/) { return Status(); }
+
  protected:
   // Only virtual for testing purposes.
   virtual void SetCurlStringOption(CURL* handle, CURLoption option_tag,
@@ -91,6 +101,11 @@ class DefaultCurlHandleFactory : public CurlHandleFactory {
  *
  * This implementation keeps up to N handles in memory, they are only released
  * when the factory is destructed.
+ *
+ * All the handles created by this factory share their DNS cache and TLS
+ * session cache, so new connections (for example, after the server closes an
+ * idle connection) can skip the name resolution and resume the TLS session
+ * instead of performing a full handshake.
  */
 class PooledCurlHandleFactory : public CurlHandleFactory {
  public:
@@ -110,8 +125,26 @@ class PooledCurlHandleFactory : public CurlHandleFactory {
     return last_client_ip_address_;
   }
 
+  /**
+   * Fill the pool with handles connected to @p url.
+   *
+   * Makes a `HEAD` request to @p url with enough new handles to fill the pool,
+   * the requests run in parallel. The handles with a successful request are
+   * added to the pool, where they keep their connection open. Returns the
+   * first error, if any, the handles with errors are discarded.
+   */
+  Status WarmUp(std::string const& url) override;
+
  private:
+  CurlPtr CreateNewHandle();
+
+  static void LockShare(CURL*, curl_lock_data data, curl_lock_access,
+                        void* userptr);
+  static void UnlockShare(CURL*, curl_lock_data data, void* userptr);
+
   std::size_t maximum_size_;
+  std::mutex share_mu_[CURL_LOCK_DATA_LAST];
+  CurlShare share_;
   mutable std::mutex mu_;
   std::vector<CURL*> handles_;
   std::vector<CURLM*> multi_handles_;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/storage/internal/curl_handle_factory.h"
+#include "google/cloud/testing_util/assert_ok.h"
 #include <gmock/gmock.h>
 #include <map>
 
@@ -110,6 +111,29 @@ TEST(CurlHandleFactoryTest, PooledFactoryChannelOptionsCallsSetOptions) {
   EXPECT_THAT(object_under_test.set_options_, testing::ElementsAre(expected));
 }
 
+TEST(CurlHandleFactoryTest, DefaultFactoryWarmUpDoesNothing) {
+  DefaultCurlHandleFactory object_under_test;
+  // There are no handles to keep, so the URL is never used.
+  EXPECT_STATUS_OK(object_under_test.WarmUp("http://localhost:1"));
+}
+
+TEST(CurlHandleFactoryTest, PooledFactoryWarmUpFullPool) {
+  PooledCurlHandleFactory object_under_test(0);
+  // The pool is already full, so the URL is never used.
+  EXPECT_STATUS_OK(object_under_test.WarmUp("http://localhost:1"));
+}
+
+TEST(CurlHandleFactoryTest, PooledFactoryWarmUpError) {
+  PooledCurlHandleFactory object_under_test(2);
+  // Use an invalid port to force a libcurl failure.
+  auto status = object_under_test.WarmUp("http://localhost:1");
+  EXPECT_FALSE(status.ok());
+
+  // The factory remains usable after a failure.
+  auto handle = object_under_test.CreateHandle();
+  EXPECT_TRUE(handle != nullptr);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
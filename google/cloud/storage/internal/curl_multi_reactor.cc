@@ -0,0 +1,274 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/curl_multi_reactor.h"
+#include "google/cloud/storage/internal/curl_wrappers.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+Status AsStatus(CURLMcode result, char const* where) {
+  if (result == CURLM_OK) return Status();
+  std::ostringstream os;
+  os << where << "(): unexpected error code in curl_multi_*, [" << result
+     << "]=" << curl_multi_strerror(result);
+  return Status(StatusCode::kUnknown, std::move(os).str());
+}
+
+Status CancelledStatus() {
+  return Status(StatusCode::kCancelled, "CurlMultiReactor is shutting down");
+}
+
+// Wait at most this long before checking for new work. With libcurl >= 7.68.0
+// new work interrupts the wait, older versions poll for new work.
+#if CURL_AT_LEAST_VERSION(7, 68, 0)
+auto constexpr kMaxPollTimeout = std::chrono::milliseconds(1000);
+#else
+auto constexpr kMaxPollTimeout = std::chrono::milliseconds(10);
+#endif  // CURL_AT_LEAST_VERSION(7, 68, 0)
+
+}  // namespace
+
+class CurlMultiReactor::Impl {
+ public:
+  explicit Impl(long max_host_connections)  // NOLINT(google-runtime-int)
+      : multi_(curl_multi_init(), &curl_multi_cleanup) {
+    // Multiplex transfers to the same host over a single HTTP/2 connection.
+    (void)curl_multi_setopt(multi_.get(), CURLMOPT_PIPELINING,
+                            CURLPIPE_MULTIPLEX);
+    if (max_host_connections > 0) {
+      (void)curl_multi_setopt(multi_.get(), CURLMOPT_MAX_HOST_CONNECTIONS,
+                              max_host_connections);
+    }
+  }
+
+  future<Status> Perform(CURL* handle) {
+    promise<Status> p;
+    auto f = p.get_future();
+    std::unique_lock<std::mutex> lk(mu_);
+    if (shutdown_) {
+      lk.unlock();
+      p.set_value(CancelledStatus());
+      return f;
+    }
+    pending_.emplace_back(handle, std::move(p));
+    lk.unlock();
+    Wakeup();
+    return f;
+  }
+
+  future<TimerResult> MakeRelativeTimer(std::chrono::nanoseconds duration) {
+    promise<TimerResult> p;
+    auto f = p.get_future();
+    auto const deadline =
+        std::chrono::system_clock::now() +
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            duration);
+    std::unique_lock<std::mutex> lk(mu_);
+    if (shutdown_) {
+      lk.unlock();
+      p.set_value(CancelledStatus());
+      return f;
+    }
+    timers_.emplace(deadline, std::move(p));
+    lk.unlock();
+    Wakeup();
+    return f;
+  }
+
+  void Shutdown() {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      shutdown_ = true;
+    }
+    Wakeup();
+  }
+
+  void Run() {
+    for (;;) {
+      AddPendingHandles();
+      int running_handles = 0;
+      CURLMcode result;
+      do {
+        result = curl_multi_perform(multi_.get(), &running_handles);
+      } while (result == CURLM_CALL_MULTI_PERFORM);
+      CompleteTransfers(AsStatus(result, __func__));
+      ExpireTimers(std::chrono::system_clock::now());
+      if (IsShutdown()) break;
+      Wait();
+    }
+    // Cancel any remaining work, new work is rejected once `shutdown_` is set.
+    std::unique_lock<std::mutex> lk(mu_);
+    auto pending = std::move(pending_);
+    auto timers = std::move(timers_);
+    lk.unlock();
+    for (auto& r : running_) {
+      (void)curl_multi_remove_handle(multi_.get(), r.first);
+      r.second.set_value(CancelledStatus());
+    }
+    running_.clear();
+    for (auto& p : pending) p.second.set_value(CancelledStatus());
+    for (auto& t : timers) t.second.set_value(CancelledStatus());
+  }
+
+ private:
+  void Wakeup() {
+#if CURL_AT_LEAST_VERSION(7, 68, 0)
+    (void)curl_multi_wakeup(multi_.get());
+#endif  // CURL_AT_LEAST_VERSION(7, 68, 0)
+  }
+
+  bool IsShutdown() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return shutdown_;
+  }
+
+  void AddPendingHandles() {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto pending = std::move(pending_);
+    pending_.clear();
+    lk.unlock();
+    for (auto& p : pending) {
+      auto s = AsStatus(curl_multi_add_handle(multi_.get(), p.first), __func__);
+      if (!s.ok()) {
+        p.second.set_value(std::move(s));
+        continue;
+      }
+      running_.emplace(p.first, std::move(p.second));
+    }
+  }
+
+  void CompleteTransfers(Status const& status) {
+    // If `curl_multi_perform()` fails there is no way to know which transfers
+    // are affected, fail all of them.
+    if (!status.ok()) {
+      auto running = std::move(running_);
+      running_.clear();
+      for (auto& r : running) {
+        (void)curl_multi_remove_handle(multi_.get(), r.first);
+        r.second.set_value(status);
+      }
+      return;
+    }
+    int remaining;
+    while (auto* msg = curl_multi_info_read(multi_.get(), &remaining)) {
+      if (msg->msg != CURLMSG_DONE) continue;
+      auto* handle = msg->easy_handle;
+      auto result = CurlHandle::AsStatus(msg->data.result, "Perform");
+      (void)curl_multi_remove_handle(multi_.get(), handle);
+      auto i = running_.find(handle);
+      if (i == running_.end()) continue;
+      auto p = std::move(i->second);
+      running_.erase(i);
+      // This may run callbacks, which could add more work.
+      p.set_value(std::move(result));
+    }
+  }
+
+  void ExpireTimers(std::chrono::system_clock::time_point now) {
+    std::unique_lock<std::mutex> lk(mu_);
+    std::vector<promise<TimerResult>> expired;
+    auto end = timers_.upper_bound(now);
+    for (auto i = timers_.begin(); i != end; ++i) {
+      expired.push_back(std::move(i->second));
+    }
+    timers_.erase(timers_.begin(), end);
+    lk.unlock();
+    for (auto& p : expired) p.set_value(now);
+  }
+
+  void Wait() {
+    auto timeout = std::chrono::milliseconds(kMaxPollTimeout);
+    long curl_timeout = -1;  // NOLINT(google-runtime-int)
+    if (curl_multi_timeout(multi_.get(), &curl_timeout) == CURLM_OK &&
+        curl_timeout >= 0) {
+      timeout = (std::min)(timeout, std::chrono::milliseconds(curl_timeout));
+    }
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if (!pending_.empty()) return;
+      if (!timers_.empty()) {
+        auto const next = std::chrono::duration_cast<std::chrono::milliseconds>(
+            timers_.begin()->first - std::chrono::system_clock::now());
+        timeout = (std::max)(std::chrono::milliseconds(0),
+                             (std::min)(timeout, next));
+      }
+    }
+    auto const timeout_ms = static_cast<int>(timeout.count());
+#if CURL_AT_LEAST_VERSION(7, 68, 0)
+    (void)curl_multi_poll(multi_.get(), nullptr, 0, timeout_ms, nullptr);
+#else
+    int numfds = 0;
+    (void)curl_multi_wait(multi_.get(), nullptr, 0, timeout_ms, &numfds);
+    // curl_multi_wait() returns immediately if there are no transfers.
+    if (numfds == 0 && running_.empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    }
+#endif  // CURL_AT_LEAST_VERSION(7, 68, 0)
+  }
+
+  CurlMulti multi_;
+  std::mutex mu_;
+  bool shutdown_ = false;                                   // GUARDED_BY(mu_)
+  std::vector<std::pair<CURL*, promise<Status>>> pending_;  // GUARDED_BY(mu_)
+  std::multimap<std::chrono::system_clock::time_point, promise<TimerResult>>
+      timers_;  // GUARDED_BY(mu_)
+  // Only used by the background thread.
+  std::unordered_map<CURL*, promise<Status>> running_;
+};
+
+CurlMultiReactor::CurlMultiReactor(
+    long max_host_connections)  // NOLINT(google-runtime-int)
+    : impl_(std::make_shared<Impl>(max_host_connections)) {
+  auto impl = impl_;
+  thread_ = std::thread([impl] { impl->Run(); });
+}
+
+CurlMultiReactor::~CurlMultiReactor() {
+  Shutdown();
+  // The last reference may be released by a callback running in the
+  // background thread, it cannot join itself.
+  if (thread_.get_id() == std::this_thread::get_id()) {
+    thread_.detach();
+    return;
+  }
+  if (thread_.joinable()) thread_.join();
+}
+
+future<Status> CurlMultiReactor::Perform(CurlHandle& handle) {
+  return impl_->Perform(handle.handle_.get());
+}
+
+future<CurlMultiReactor::TimerResult> CurlMultiReactor::MakeRelativeTimer(
+    std::chrono::nanoseconds duration) {
+  return impl_->MakeRelativeTimer(duration);
+}
+
+void CurlMultiReactor::Shutdown() { impl_->Shutdown(); }
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,94 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CURL_MULTI_REACTOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CURL_MULTI_REACTOR_H
+
+#include "google/cloud/storage/internal/curl_handle.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Runs many libcurl transfers using a single `CURLM*` handle and thread.
+ *
+ * Each `CurlHandle` driven with `curl_easy_perform()` needs a thread for as
+ * long as the transfer is running. This class adds the handles to a shared
+ * multi handle, and runs all the transfers from a single background thread.
+ * The transfers share the connection cache of the multi handle, and (with
+ * HTTP/2) they are multiplexed over the same connection when possible.
+ *
+ * The class also provides timers, so asynchronous operations can implement
+ * backoff loops without blocking a thread.
+ *
+ * Callbacks attached to the returned futures run in the background thread,
+ * they should not block.
+ */
+class CurlMultiReactor {
+ public:
+  using TimerResult = StatusOr<std::chrono::system_clock::time_point>;
+
+  /**
+   * Start the background thread.
+   *
+   * @param max_host_connections the maximum number of connections to any
+   *     single host, zero means no limit.
+   */
+  explicit CurlMultiReactor(long max_host_connections = 0);  // NOLINT
+  ~CurlMultiReactor();
+
+  CurlMultiReactor(CurlMultiReactor const&) = delete;
+  CurlMultiReactor& operator=(CurlMultiReactor const&) = delete;
+
+  /**
+   * Start a transfer using @p handle.
+   *
+   * The handle must be fully configured, and it must remain valid until the
+   * returned future is satisfied. The future is satisfied with the result of
+   * the transfer, or with a `kCancelled` error if the reactor is shutdown
+   * before the transfer completes.
+   */
+  future<Status> Perform(CurlHandle& handle);
+
+  /// Create a timer that expires after @p duration.
+  future<TimerResult> MakeRelativeTimer(std::chrono::nanoseconds duration);
+
+  /// Stop the background thread, cancelling any pending work.
+  void Shutdown();
+
+ private:
+  class Impl;
+  // The background thread holds a reference to `impl_`, this allows the last
+  // reference to a `CurlMultiReactor` to be released from within a callback.
+  std::shared_ptr<Impl> impl_;
+  std::thread thread_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CURL_MULTI_REACTOR_H
@@ -0,0 +1,132 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/curl_multi_reactor.h"
+#include "google/cloud/storage/testing/temp_file.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::TempFile;
+using ::google::cloud::testing_util::StatusIs;
+
+extern "C" std::size_t CurlMultiReactorTestWrite(char* ptr, std::size_t size,
+                                                 std::size_t nmemb,
+                                                 void* userdata) {
+  auto* buffer = reinterpret_cast<std::string*>(userdata);
+  buffer->append(ptr, size * nmemb);
+  return size * nmemb;
+}
+
+TEST(CurlMultiReactorTest, TimerExpires) {
+  CurlMultiReactor reactor;
+  auto const start = std::chrono::system_clock::now();
+  auto t = reactor.MakeRelativeTimer(std::chrono::milliseconds(10)).get();
+  ASSERT_STATUS_OK(t);
+  EXPECT_GE(*t, start + std::chrono::milliseconds(10));
+}
+
+TEST(CurlMultiReactorTest, TimersExpireInOrder) {
+  CurlMultiReactor reactor;
+  std::mutex mu;
+  std::vector<int> order;
+  auto make = [&](int id, std::chrono::milliseconds d) {
+    return reactor.MakeRelativeTimer(d).then(
+        [&mu, &order, id](future<CurlMultiReactor::TimerResult> f) {
+          std::lock_guard<std::mutex> lk(mu);
+          if (f.get()) order.push_back(id);
+        });
+  };
+  auto f2 = make(2, std::chrono::milliseconds(40));
+  auto f1 = make(1, std::chrono::milliseconds(20));
+  auto f0 = make(0, std::chrono::milliseconds(0));
+  f2.get();
+  f1.get();
+  f0.get();
+  EXPECT_THAT(order, ::testing::ElementsAre(0, 1, 2));
+}
+
+TEST(CurlMultiReactorTest, ShutdownCancelsTimers) {
+  CurlMultiReactor reactor;
+  auto f = reactor.MakeRelativeTimer(std::chrono::hours(1));
+  reactor.Shutdown();
+  EXPECT_THAT(f.get(), StatusIs(StatusCode::kCancelled));
+
+  // New work is rejected once the reactor is shutdown.
+  auto t = reactor.MakeRelativeTimer(std::chrono::milliseconds(0)).get();
+  EXPECT_THAT(t, StatusIs(StatusCode::kCancelled));
+}
+
+TEST(CurlMultiReactorTest, DestructorCancelsTimers) {
+  future<CurlMultiReactor::TimerResult> f;
+  {
+    CurlMultiReactor reactor;
+    f = reactor.MakeRelativeTimer(std::chrono::hours(1));
+  }
+  EXPECT_THAT(f.get(), StatusIs(StatusCode::kCancelled));
+}
+
+TEST(CurlMultiReactorTest, PerformManyTransfers) {
+  std::string const contents = "The quick brown fox jumps over the lazy dog";
+  TempFile file(contents);
+
+  CurlMultiReactor reactor;
+  auto constexpr kTransfers = 8;
+  std::vector<CurlHandle> handles(kTransfers);
+  std::vector<std::string> buffers(kTransfers);
+  std::vector<future<Status>> pending;
+  for (int i = 0; i != kTransfers; ++i) {
+    auto& h = handles[i];
+    h.SetOption(CURLOPT_URL, ("file://" + file.name()).c_str());
+    h.SetOption(CURLOPT_WRITEFUNCTION, &CurlMultiReactorTestWrite);
+    h.SetOption(CURLOPT_WRITEDATA, &buffers[i]);
+    pending.push_back(reactor.Perform(h));
+  }
+  for (auto& f : pending) EXPECT_STATUS_OK(f.get());
+  for (auto const& b : buffers) EXPECT_EQ(contents, b);
+}
+
+TEST(CurlMultiReactorTest, PerformError) {
+  CurlMultiReactor reactor;
+  CurlHandle h;
+  h.SetOption(CURLOPT_URL, "file:///this/file/does/not/exist");
+  EXPECT_FALSE(reactor.Perform(h).get().ok());
+}
+
+TEST(CurlMultiReactorTest, ReleaseFromCallback) {
+  auto reactor = std::make_shared<CurlMultiReactor>();
+  auto f = reactor->MakeRelativeTimer(std::chrono::milliseconds(0))
+               .then([reactor](future<CurlMultiReactor::TimerResult> f) {
+                 return f.get().status();
+               });
+  reactor.reset();
+  EXPECT_STATUS_OK(f.get());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
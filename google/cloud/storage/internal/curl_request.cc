@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "google/cloud/storage/internal/curl_request.h"
+#include "google/cloud/storage/internal/stage_timer.h"
 #include <iostream>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -70,6 +72,7 @@ StatusOr<HttpResponse> CurlRequest::MakeRequest(std::string const& payload) {
     handle_.SetOption(CURLOPT_POSTFIELDSIZE, payload.length());
     handle_.SetOption(CURLOPT_POSTFIELDS, payload.c_str());
   }
+  WaitForRateLimiter(payload.size());
   return MakeRequestImpl();
 }
 
@@ -77,6 +80,7 @@ StatusOr<HttpResponse> CurlRequest::MakeUploadRequest(
     ConstBufferSequence payload) {
   handle_.SetOption(CURLOPT_UPLOAD, 0L);
   if (payload.empty()) return MakeRequestImpl();
+  WaitForRateLimiter(TotalBytes(payload));
   if (payload.size() == 1) {
     handle_.SetOption(CURLOPT_POSTFIELDSIZE, payload[0].size());
     handle_.SetOption(CURLOPT_POSTFIELDS, payload[0].data());
@@ -90,7 +94,31 @@ StatusOr<HttpResponse> CurlRequest::MakeUploadRequest(
   return MakeRequestImpl();
 }
 
-StatusOr<HttpResponse> CurlRequest::MakeRequestImpl() {
+future<StatusOr<HttpResponse>> CurlRequest::MakeRequestAsync(
+    CurlMultiReactor& reactor, std::string payload) && {
+  // The request, and the payload, must remain valid until the transfer
+  // completes, they are owned by the continuation.
+  struct State {
+    CurlRequest request;
+    std::string payload;
+  };
+  auto state = std::make_shared<State>(State{std::move(*this), {}});
+  state->payload = std::move(payload);
+  auto& r = state->request;
+  r.handle_.SetOption(CURLOPT_UPLOAD, 0L);
+  if (!state->payload.empty()) {
+    r.handle_.SetOption(CURLOPT_POSTFIELDSIZE, state->payload.length());
+    r.handle_.SetOption(CURLOPT_POSTFIELDS, state->payload.c_str());
+  }
+  r.SetupHandle();
+  return reactor.Perform(r.handle_).then([state](future<Status> f) {
+    auto status = f.get();
+    if (!status.ok()) return StatusOr<HttpResponse>(std::move(status));
+    return state->request.MakeResponse();
+  });
+}
+
+void CurlRequest::SetupHandle() {
   // We get better performance using a slightly larger buffer (128KiB) than the
   // default buffer size set by libcurl (16KiB)
   auto constexpr kDefaultBufferSize = 128 * 1024L;
@@ -108,10 +136,9 @@ StatusOr<HttpResponse> CurlRequest::MakeRequestImpl() {
   handle_.SetOption(CURLOPT_WRITEDATA, this);
   handle_.SetOption(CURLOPT_HEADERFUNCTION, &CurlRequestOnHeaderData);
   handle_.SetOption(CURLOPT_HEADERDATA, this);
-  auto status = handle_.EasyPerform();
-  if (!status.ok()) {
-    return status;
-  }
+}
+
+StatusOr<HttpResponse> CurlRequest::MakeResponse() {
   if (logging_enabled_) {
     handle_.FlushDebug(__func__);
   }
@@ -123,6 +150,18 @@ StatusOr<HttpResponse> CurlRequest::MakeRequestImpl() {
                       std::move(received_headers_)};
 }
 
+StatusOr<HttpResponse> CurlRequest::MakeRequestImpl() {
+  SetupHandle();
+  auto status = [this] {
+    GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kTransport);
+    return handle_.EasyPerform();
+  }();
+  if (!status.ok()) {
+    return status;
+  }
+  return MakeResponse();
+}
+
 std::size_t CurlRequest::OnWriteData(char* contents, std::size_t size,
                                      std::size_t nmemb) {
   response_payload_.append(contents, size * nmemb);
@@ -134,6 +173,12 @@ std::size_t CurlRequest::OnHeaderData(char* contents, std::size_t size,
   return CurlAppendHeaderData(received_headers_, contents, size * nitems);
 }
 
+void CurlRequest::WaitForRateLimiter(std::size_t bytes) {
+  if (!rate_limiter_ || bytes == 0) return;
+  std::this_thread::sleep_for(
+      rate_limiter_->ReserveBytes(rate_limiter_bucket_, bytes));
+}
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
@@ -18,8 +18,12 @@
 #include "google/cloud/storage/internal/const_buffer.h"
 #include "google/cloud/storage/internal/curl_handle.h"
 #include "google/cloud/storage/internal/curl_handle_factory.h"
+#include "google/cloud/storage/internal/curl_multi_reactor.h"
 #include "google/cloud/storage/internal/http_response.h"
+#include "google/cloud/storage/rate_limiter.h"
 #include "google/cloud/storage/version.h"
+#include "google/cloud/future.h"
+#include <string>
 #include <vector>
 
 namespace google {
@@ -54,8 +58,21 @@ class CurlRequest {
   /// @copydoc MakeRequest(std::string const&)
   StatusOr<HttpResponse> MakeUploadRequest(ConstBufferSequence payload);
 
+  /**
+   * Makes the prepared request using @p reactor.
+   *
+   * The request is consumed, the returned future is satisfied (in the
+   * @p reactor background thread) when the request completes.
+   */
+  future<StatusOr<HttpResponse>> MakeRequestAsync(CurlMultiReactor& reactor,
+                                                  std::string payload) &&;
+
  private:
   StatusOr<HttpResponse> MakeRequestImpl();
+  void SetupHandle();
+  /// Wait until the rate limiter (if any) has capacity to send @p bytes.
+  void WaitForRateLimiter(std::size_t bytes);
+  StatusOr<HttpResponse> MakeResponse();
 
   friend class CurlRequestBuilder;
   friend size_t CurlRequestOnWriteData(char* ptr, size_t size, size_t nmemb,
@@ -74,6 +91,8 @@ class CurlRequest {
   CurlReceivedHeaders received_headers_;
   bool logging_enabled_ = false;
   CurlHandle::SocketOptions socket_options_;
+  std::shared_ptr<RateLimiter> rate_limiter_;
+  std::string rate_limiter_bucket_;
   CurlHandle handle_;
   std::shared_ptr<CurlHandleFactory> factory_;
 };
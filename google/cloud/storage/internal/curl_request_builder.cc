@@ -15,6 +15,7 @@
 #include "google/cloud/storage/internal/curl_request_builder.h"
 #include "google/cloud/storage/version.h"
 #include "google/cloud/internal/build_info.h"
+#include <algorithm>
 
 namespace google {
 namespace cloud {
@@ -26,6 +27,33 @@ namespace internal {
 #define GOOGLE_CLOUD_CPP_STORAGE_INITIAL_BUFFER_SIZE (128 * 1024)
 #endif  // GOOGLE_CLOUD_CPP_STORAGE_INITIAL_BUFFER_SIZE
 
+namespace {
+std::string const& DefaultUserAgentSuffix() {
+  // Pre-compute and cache the user agent string:
+  static std::string const kUserAgentSuffix = [] {
+    std::string agent = "gcloud-cpp/" + storage::version_string() + " ";
+    agent += curl_version();
+    agent += " " + google::cloud::internal::compiler();
+    return agent;
+  }();
+  return kUserAgentSuffix;
+}
+}  // namespace
+
+CurlRequestTemplate MakeCurlRequestTemplate(ClientOptions const& options,
+                                            std::vector<std::string> headers) {
+  CurlRequestTemplate t;
+  t.user_agent = options.user_agent_prefix() + DefaultUserAgentSuffix();
+  t.logging_enabled = options.enable_http_tracing();
+  t.socket_options.recv_buffer_size_ = options.maximum_socket_recv_size();
+  t.socket_options.send_buffer_size_ = options.maximum_socket_send_size();
+  t.download_stall_timeout = options.download_stall_timeout();
+  t.buffer_pool = options.buffer_pool();
+  t.rate_limiter = options.rate_limiter();
+  t.headers = std::move(headers);
+  return t;
+}
+
 CurlRequestBuilder::CurlRequestBuilder(
     std::string base_url, std::shared_ptr<CurlHandleFactory> factory)
     : factory_(std::move(factory)),
@@ -34,18 +62,28 @@ CurlRequestBuilder::CurlRequestBuilder(
       url_(std::move(base_url)),
       query_parameter_separator_("?"),
       logging_enabled_(false),
-      download_stall_timeout_(0) {}
+      download_stall_timeout_(0),
+      buffer_pool_(DefaultBufferPool()),
+      cancellation_token_(
+          google::cloud::internal::CurrentCancellationToken()) {}
 
 CurlRequest CurlRequestBuilder::BuildRequest() {
   ValidateBuilderState(__func__);
   CurlRequest request;
   request.url_ = std::move(url_);
   request.headers_ = std::move(headers_);
-  request.user_agent_ = user_agent_prefix_ + UserAgentSuffix();
+  request.user_agent_ = user_agent_.empty()
+                            ? user_agent_prefix_ + UserAgentSuffix()
+                            : std::move(user_agent_);
   request.handle_ = std::move(handle_);
   request.factory_ = std::move(factory_);
   request.logging_enabled_ = logging_enabled_;
   request.socket_options_ = socket_options_;
+  request.rate_limiter_ = std::move(rate_limiter_);
+  request.rate_limiter_bucket_ = std::move(rate_limiter_bucket_);
+  if (cancellation_token_) {
+    request.handle_.SetCancellationToken(*std::move(cancellation_token_));
+  }
   return request;
 }
 
@@ -55,7 +93,9 @@ CurlDownloadRequest CurlRequestBuilder::BuildDownloadRequest(
   CurlDownloadRequest request;
   request.url_ = std::move(url_);
   request.headers_ = std::move(headers_);
-  request.user_agent_ = user_agent_prefix_ + UserAgentSuffix();
+  request.user_agent_ = user_agent_.empty()
+                            ? user_agent_prefix_ + UserAgentSuffix()
+                            : std::move(user_agent_);
   request.payload_ = std::move(payload);
   request.handle_ = std::move(handle_);
   request.multi_ = factory_->CreateMultiHandle();
@@ -63,7 +103,14 @@ CurlDownloadRequest CurlRequestBuilder::BuildDownloadRequest(
   request.logging_enabled_ = logging_enabled_;
   request.socket_options_ = socket_options_;
   request.download_stall_timeout_ = download_stall_timeout_;
+  request.received_headers_filter_ = std::move(received_headers_filter_);
+  request.rate_limiter_ = std::move(rate_limiter_);
+  request.rate_limiter_bucket_ = std::move(rate_limiter_bucket_);
+  request.spill_ = PooledBuffer(buffer_pool_, CURL_MAX_WRITE_SIZE);
   request.SetOptions();
+  if (cancellation_token_) {
+    request.handle_.SetCancellationToken(*std::move(cancellation_token_));
+  }
   return request;
 }
 
@@ -75,6 +122,34 @@ CurlRequestBuilder& CurlRequestBuilder::ApplyClientOptions(
   socket_options_.send_buffer_size_ = options.maximum_socket_send_size();
   user_agent_prefix_ = options.user_agent_prefix() + user_agent_prefix_;
   download_stall_timeout_ = options.download_stall_timeout();
+  buffer_pool_ = options.buffer_pool();
+  rate_limiter_ = options.rate_limiter();
+  return *this;
+}
+
+CurlRequestBuilder& CurlRequestBuilder::ApplyTemplate(
+    CurlRequestTemplate const& t) {
+  ValidateBuilderState(__func__);
+  logging_enabled_ = t.logging_enabled;
+  socket_options_ = t.socket_options;
+  user_agent_ = t.user_agent;
+  download_stall_timeout_ = t.download_stall_timeout;
+  buffer_pool_ = t.buffer_pool;
+  rate_limiter_ = t.rate_limiter;
+  for (auto const& h : t.headers) AddHeader(h);
+  return *this;
+}
+
+CurlRequestBuilder& CurlRequestBuilder::AddOption(
+    OperationDeadline const& p) {
+  ValidateBuilderState(__func__);
+  if (!p.has_value()) return *this;
+  // A timeout of 0 disables the timeout in libcurl, if the deadline has passed
+  // use the smallest timeout instead.
+  auto const timeout = (std::max)(TimeRemaining(p).count(),
+                                  std::chrono::milliseconds::rep(1));
+  // NOLINTNEXTLINE(google-runtime-int)
+  handle_.SetOption(CURLOPT_TIMEOUT_MS, static_cast<long>(timeout));
   return *this;
 }
 
@@ -109,16 +184,23 @@ CurlRequestBuilder& CurlRequestBuilder::SetCurlShare(CURLSH* share) {
   return *this;
 }
 
-std::string CurlRequestBuilder::UserAgentSuffix() const {
+CurlRequestBuilder& CurlRequestBuilder::SetReceivedHeadersFilter(
+    std::vector<std::string> names) {
   ValidateBuilderState(__func__);
-  // Pre-compute and cache the user agent string:
-  static std::string const kUserAgentSuffix = [] {
-    std::string agent = "gcloud-cpp/" + storage::version_string() + " ";
-    agent += curl_version();
-    agent += " " + google::cloud::internal::compiler();
-    return agent;
-  }();
-  return kUserAgentSuffix;
+  received_headers_filter_ = std::move(names);
+  return *this;
+}
+
+CurlRequestBuilder& CurlRequestBuilder::SetRateLimiterBucket(
+    std::string bucket) {
+  ValidateBuilderState(__func__);
+  rate_limiter_bucket_ = std::move(bucket);
+  return *this;
+}
+
+std::string const& CurlRequestBuilder::UserAgentSuffix() const {
+  ValidateBuilderState(__func__);
+  return DefaultUserAgentSuffix();
 }
 
 void CurlRequestBuilder::ValidateBuilderState(char const* where) const {
@@ -19,14 +19,41 @@
 #include "google/cloud/storage/internal/curl_download_request.h"
 #include "google/cloud/storage/internal/curl_handle_factory.h"
 #include "google/cloud/storage/internal/curl_request.h"
+#include "google/cloud/storage/operation_deadline.h"
 #include "google/cloud/storage/version.h"
 #include "google/cloud/storage/well_known_headers.h"
+#include "google/cloud/cancellation.h"
+#include "absl/types/optional.h"
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
 namespace storage {
 inline namespace STORAGE_CLIENT_NS {
 namespace internal {
+/**
+ * The configuration shared by all the requests created by a client.
+ *
+ * Most of the request setup depends only on the `ClientOptions`. Computing it
+ * once per client, instead of once per request, saves several allocations and
+ * string concatenations on each request.
+ */
+struct CurlRequestTemplate {
+  std::string user_agent;
+  bool logging_enabled;
+  CurlHandle::SocketOptions socket_options;
+  std::chrono::seconds download_stall_timeout;
+  std::shared_ptr<BufferPool> buffer_pool;
+  std::shared_ptr<RateLimiter> rate_limiter;
+  /// The headers included in all the requests, e.g. `x-goog-api-client`.
+  std::vector<std::string> headers;
+};
+
+/// Creates the request template for @p options.
+CurlRequestTemplate MakeCurlRequestTemplate(ClientOptions const& options,
+                                            std::vector<std::string> headers);
+
 /**
  * Implements the Builder pattern for CurlRequest, and CurlUploadRequest.
  */
@@ -140,6 +167,9 @@ class CurlRequestBuilder {
     return *this;
   }
 
+  /// Limit the request to the time left before the operation deadline.
+  CurlRequestBuilder& AddOption(OperationDeadline const& p);
+
   /**
    * Ignore complex options, these are managed explicitly in the requests that
    * use them.
@@ -163,11 +193,36 @@ class CurlRequestBuilder {
   /// Copy interesting configuration parameters from the client options.
   CurlRequestBuilder& ApplyClientOptions(ClientOptions const& options);
 
+  /**
+   * Copy the configuration parameters and headers from a request template.
+   *
+   * This is equivalent to `ApplyClientOptions()` and `AddHeader()` for each
+   * header in the template, but avoids recomputing the configuration on each
+   * request.
+   */
+  CurlRequestBuilder& ApplyTemplate(CurlRequestTemplate const& t);
+
   /// Sets the CURLSH* handle to share resources.
   CurlRequestBuilder& SetCurlShare(CURLSH* share);
 
+  /**
+   * Only keep these response headers in download requests.
+   *
+   * The names must be in lowercase. An empty list (the default) keeps all the
+   * headers.
+   */
+  CurlRequestBuilder& SetReceivedHeadersFilter(std::vector<std::string> names);
+
+  /**
+   * Charge the bytes transferred by this request to @p bucket.
+   *
+   * The rate limiter is configured via `ApplyClientOptions()`, this only
+   * selects the limit used when the rate limiter is configured per-bucket.
+   */
+  CurlRequestBuilder& SetRateLimiterBucket(std::string bucket);
+
   /// Gets the user-agent suffix.
-  std::string UserAgentSuffix() const;
+  std::string const& UserAgentSuffix() const;
 
   /// URL-escapes a string.
   CurlString MakeEscapedString(std::string const& s) {
@@ -191,9 +246,16 @@ class CurlRequestBuilder {
   char const* query_parameter_separator_;
 
   std::string user_agent_prefix_;
+  // The full user agent, set by `ApplyTemplate()`.
+  std::string user_agent_;
   bool logging_enabled_;
   CurlHandle::SocketOptions socket_options_;
   std::chrono::seconds download_stall_timeout_;
+  std::shared_ptr<BufferPool> buffer_pool_;
+  std::vector<std::string> received_headers_filter_;
+  std::shared_ptr<RateLimiter> rate_limiter_;
+  std::string rate_limiter_bucket_;
+  absl::optional<CancellationToken> cancellation_token_;
 };
 
 }  // namespace internal
@@ -0,0 +1,366 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/direct_file_io.h"
+#include "google/cloud/storage/buffer_pool.h"
+#include "google/cloud/storage/internal/pooled_buffer.h"
+#include "google/cloud/internal/strerror.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include "absl/memory/memory.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+#ifndef _WIN32
+namespace {
+
+std::size_t RoundUpToAlignment(std::size_t size) {
+  auto const blocks = (std::max<std::size_t>)(
+      1, (size + kDirectIOAlignment - 1) / kDirectIOAlignment);
+  return blocks * kDirectIOAlignment;
+}
+
+/// All the direct I/O buffers are allocated from this pool.
+std::shared_ptr<BufferPool> DirectIOBufferPool() {
+  static auto* const kPool =
+      new std::shared_ptr<BufferPool>(MakeRecyclingBufferPool(
+          RecyclingBufferPoolOptions{}.set_alignment(kDirectIOAlignment)));
+  return *kPool;
+}
+
+Status IOError(char const* where, std::string const& file_name, int errnum) {
+  auto code = StatusCode::kUnknown;
+  if (errnum == ENOENT) code = StatusCode::kNotFound;
+  if (errnum == EACCES || errnum == EPERM) {
+    code = StatusCode::kPermissionDenied;
+  }
+  return Status(code, std::string(where) + "(" + file_name +
+                          "): " + google::cloud::internal::strerror(errnum));
+}
+
+/// Open a file using direct I/O if possible, returns -1 and sets errno on
+/// failure.
+int OpenFile(std::string const& file_name, int flags) {
+#ifdef O_DIRECT
+  auto const direct_fd =
+      ::open(file_name.c_str(), flags | O_DIRECT | O_CLOEXEC, 0666);
+  // Some filesystems (e.g. tmpfs) reject `O_DIRECT`, fallback to buffered
+  // I/O in that case.
+  if (direct_fd >= 0 || errno != EINVAL) return direct_fd;
+#endif  // O_DIRECT
+  auto fd = ::open(file_name.c_str(), flags | O_CLOEXEC, 0666);
+#ifdef F_NOCACHE
+  // macOS does not support `O_DIRECT`, but can disable caching per file.
+  if (fd >= 0) (void)::fcntl(fd, F_NOCACHE, 1);
+#endif  // F_NOCACHE
+  return fd;
+}
+
+StatusOr<std::size_t> ReadBlock(int fd, std::string const& file_name,
+                                char* data, std::size_t size,
+                                std::int64_t offset) {
+  std::size_t n = 0;
+  while (n < size) {
+    auto r = ::pread(fd, data + n, size - n, static_cast<off_t>(offset + n));
+    if (r < 0 && errno == EINTR) continue;
+    if (r < 0) return IOError("pread", file_name, errno);
+    if (r == 0) break;
+    n += static_cast<std::size_t>(r);
+    // With direct I/O the offsets must be aligned, a partial read of an
+    // unaligned size only happens at the end of the file.
+    if (n % kDirectIOAlignment != 0) break;
+  }
+  return n;
+}
+
+Status WriteBlock(int fd, std::string const& file_name, char const* data,
+                  std::size_t size, std::int64_t offset) {
+  std::size_t n = 0;
+  while (n < size) {
+    auto r = ::pwrite(fd, data + n, size - n, static_cast<off_t>(offset + n));
+    if (r < 0 && errno == EINTR) continue;
+    if (r < 0) return IOError("pwrite", file_name, errno);
+    n += static_cast<std::size_t>(r);
+  }
+  return Status();
+}
+
+/**
+ * Read a file in aligned blocks, reading the next block in the background.
+ *
+ * The block at `current_offset_` is in `current_` and is exposed as the get
+ * area. The next block, at `next_offset_`, is read into `next_` by `pending_`.
+ */
+class DirectFileReadStreambuf : public std::basic_streambuf<char> {
+ public:
+  DirectFileReadStreambuf(std::string file_name, int fd,
+                          std::size_t block_size, std::int64_t file_size)
+      : file_name_(std::move(file_name)),
+        fd_(fd),
+        block_size_(block_size),
+        file_size_(file_size),
+        current_(DirectIOBufferPool(), block_size_),
+        next_(DirectIOBufferPool(), block_size_) {}
+
+  ~DirectFileReadStreambuf() override {
+    if (pending_.valid()) pending_.wait();
+    ::close(fd_);
+  }
+
+  DirectFileReadStreambuf(DirectFileReadStreambuf const&) = delete;
+  DirectFileReadStreambuf& operator=(DirectFileReadStreambuf const&) = delete;
+
+ protected:
+  int_type underflow() override {
+    while (gptr() == egptr()) {
+      if (eof_) return traits_type::eof();
+      if (!pending_.valid()) StartRead();
+      auto r = pending_.get();
+      if (!r) return ReportError(std::move(r).status());
+      current_.swap(next_);
+      current_offset_ = next_offset_;
+      next_offset_ += static_cast<std::int64_t>(*r);
+      eof_ = *r < block_size_;
+      if (!eof_) StartRead();
+      auto const skip = (std::min)(skip_, *r);
+      skip_ -= skip;
+      setg(current_.data(), current_.data() + skip, current_.data() + *r);
+    }
+    return traits_type::to_int_type(*gptr());
+  }
+
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override {
+    if ((which & std::ios_base::in) == 0) return pos_type(off_type(-1));
+    switch (dir) {
+      case std::ios_base::beg:
+        return Seek(off);
+      case std::ios_base::cur:
+        return Seek(Position() + off);
+      case std::ios_base::end:
+        return Seek(file_size_ + off);
+      default:
+        return pos_type(off_type(-1));
+    }
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+
+ private:
+  std::int64_t Position() const {
+    if (eback() == nullptr) return next_offset_ + skip_;
+    return current_offset_ + (gptr() - eback());
+  }
+
+  pos_type Seek(std::int64_t pos) {
+    if (pos < 0) return pos_type(off_type(-1));
+    // Seeking within the current block keeps the data read ahead.
+    if (eback() != nullptr && pos >= current_offset_ &&
+        pos <= current_offset_ + (egptr() - eback())) {
+      setg(eback(), eback() + (pos - current_offset_), egptr());
+      return pos_type(off_type(pos));
+    }
+    if (pending_.valid()) (void)pending_.get();
+    auto const alignment = static_cast<std::int64_t>(kDirectIOAlignment);
+    next_offset_ = pos - pos % alignment;
+    skip_ = static_cast<std::size_t>(pos - next_offset_);
+    eof_ = false;
+    setg(nullptr, nullptr, nullptr);
+    return pos_type(off_type(pos));
+  }
+
+  void StartRead() {
+    auto* data = next_.data();
+    auto const offset = next_offset_;
+    pending_ = std::async(std::launch::async, [this, data, offset] {
+      return ReadBlock(fd_, file_name_, data, block_size_, offset);
+    });
+  }
+
+  int_type ReportError(Status status) {
+    // See the comments in `ObjectReadStreambuf::ReportError()`. Exceptions
+    // raised here set the `badbit` in the `std::istream`.
+    status_ = std::move(status);
+    eof_ = true;
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    google::cloud::internal::ThrowStatus(status_);
+#else
+    return traits_type::eof();
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  }
+
+  std::string const file_name_;
+  int const fd_;
+  std::size_t const block_size_;
+  std::int64_t const file_size_;
+  PooledBuffer current_;
+  PooledBuffer next_;
+  std::int64_t current_offset_ = 0;
+  std::int64_t next_offset_ = 0;
+  // The number of bytes in the next block before the current position.
+  std::size_t skip_ = 0;
+  bool eof_ = false;
+  Status status_;
+  std::future<StatusOr<std::size_t>> pending_;
+};
+
+/**
+ * Write a file in aligned blocks, writing the previous block in the background.
+ *
+ * The put area covers `current_`, which starts at `offset_` in the file. Full
+ * blocks are swapped with `next_`, and written by `pending_`.
+ */
+class DirectFileWriteStreambuf : public std::basic_streambuf<char> {
+ public:
+  DirectFileWriteStreambuf(std::string file_name, int fd,
+                           std::size_t block_size)
+      : file_name_(std::move(file_name)),
+        fd_(fd),
+        block_size_(block_size),
+        current_(DirectIOBufferPool(), block_size_),
+        next_(DirectIOBufferPool(), block_size_) {
+    setp(current_.data(), current_.data() + block_size_);
+  }
+
+  ~DirectFileWriteStreambuf() override {
+    (void)sync();
+    ::close(fd_);
+  }
+
+  DirectFileWriteStreambuf(DirectFileWriteStreambuf const&) = delete;
+  DirectFileWriteStreambuf& operator=(DirectFileWriteStreambuf const&) =
+      delete;
+
+ protected:
+  int_type overflow(int_type ch) override {
+    // For ch == EOF this function must do nothing and return any value != EOF.
+    if (traits_type::eq_int_type(ch, traits_type::eof())) return 0;
+    if (!FlushBlock()) return traits_type::eof();
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+    return ch;
+  }
+
+  int sync() override {
+    if (!WaitPending()) return -1;
+    auto const size = static_cast<std::size_t>(pptr() - pbase());
+    if (size == 0) return 0;
+    // Direct I/O requires aligned sizes, write a padded block and then
+    // truncate the file. The data remains in the put area, future writes
+    // complete the block, and rewrite it at the same offset.
+    auto const padded = RoundUpToAlignment(size);
+    std::fill(pptr(), pbase() + padded, '\0');
+    status_ = WriteBlock(fd_, file_name_, pbase(), padded, offset_);
+    if (!status_.ok()) return -1;
+    if (::ftruncate(fd_, static_cast<off_t>(offset_ + size)) != 0) {
+      status_ = IOError("ftruncate", file_name_, errno);
+      return -1;
+    }
+    return 0;
+  }
+
+ private:
+  bool FlushBlock() {
+    if (!WaitPending()) return false;
+    auto const* data = current_.data();
+    auto const offset = offset_;
+    pending_ = std::async(std::launch::async, [this, data, offset] {
+      return WriteBlock(fd_, file_name_, data, block_size_, offset);
+    });
+    offset_ += static_cast<std::int64_t>(block_size_);
+    current_.swap(next_);
+    setp(current_.data(), current_.data() + block_size_);
+    return true;
+  }
+
+  bool WaitPending() {
+    if (pending_.valid()) {
+      auto status = pending_.get();
+      if (status_.ok()) status_ = std::move(status);
+    }
+    return status_.ok();
+  }
+
+  std::string const file_name_;
+  int const fd_;
+  std::size_t const block_size_;
+  PooledBuffer current_;
+  PooledBuffer next_;
+  std::int64_t offset_ = 0;
+  Status status_;
+  std::future<Status> pending_;
+};
+
+}  // namespace
+
+StatusOr<std::unique_ptr<std::streambuf>> OpenDirectFileForRead(
+    std::string const& file_name, std::size_t block_size) {
+  auto fd = OpenFile(file_name, O_RDONLY);
+  if (fd < 0) return IOError("open", file_name, errno);
+  struct stat st;  // NOLINT(cppcoreguidelines-pro-type-member-init)
+  if (::fstat(fd, &st) != 0) {
+    auto status = IOError("fstat", file_name, errno);
+    ::close(fd);
+    return status;
+  }
+  return std::unique_ptr<std::streambuf>(
+      absl::make_unique<DirectFileReadStreambuf>(
+          file_name, fd, RoundUpToAlignment(block_size),
+          static_cast<std::int64_t>(st.st_size)));
+}
+
+StatusOr<std::unique_ptr<std::streambuf>> OpenDirectFileForWrite(
+    std::string const& file_name, std::size_t block_size) {
+  auto fd = OpenFile(file_name, O_WRONLY | O_CREAT | O_TRUNC);
+  if (fd < 0) return IOError("open", file_name, errno);
+  return std::unique_ptr<std::streambuf>(
+      absl::make_unique<DirectFileWriteStreambuf>(
+          file_name, fd, RoundUpToAlignment(block_size)));
+}
+
+#else
+
+StatusOr<std::unique_ptr<std::streambuf>> OpenDirectFileForRead(
+    std::string const&, std::size_t) {
+  return Status(StatusCode::kUnimplemented,
+                "direct file I/O is not supported on this platform");
+}
+
+StatusOr<std::unique_ptr<std::streambuf>> OpenDirectFileForWrite(
+    std::string const&, std::size_t) {
+  return Status(StatusCode::kUnimplemented,
+                "direct file I/O is not supported on this platform");
+}
+
+#endif  // _WIN32
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
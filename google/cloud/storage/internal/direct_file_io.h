@@ -0,0 +1,70 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_DIRECT_FILE_IO_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_DIRECT_FILE_IO_H
+
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status_or.h"
+#include <cstddef>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/// The alignment for the buffers, offsets and sizes used in direct I/O.
+std::size_t constexpr kDirectIOAlignment = 4096;
+
+/**
+ * Open @p file_name for reading, bypassing the page cache if possible.
+ *
+ * The returned streambuf reads the file in blocks of @p block_size bytes
+ * (rounded up to `kDirectIOAlignment`), and reads the next block in a
+ * background thread while the application consumes the current block. The
+ * streambuf supports seeking, which discards any data read ahead.
+ *
+ * The file is opened with `O_DIRECT` if the platform and the filesystem
+ * support it, otherwise it uses buffered I/O with the same read-ahead.
+ * Returns `StatusCode::kUnimplemented` on platforms without POSIX file I/O.
+ */
+StatusOr<std::unique_ptr<std::streambuf>> OpenDirectFileForRead(
+    std::string const& file_name, std::size_t block_size);
+
+/**
+ * Create (or truncate) @p file_name for writing, bypassing the page cache if
+ * possible.
+ *
+ * The returned streambuf writes full blocks of @p block_size bytes (rounded up
+ * to `kDirectIOAlignment`) in a background thread, while the application fills
+ * the next block. `pubsync()` writes any partial block and sets the file size,
+ * the application must call it (e.g. via `std::ostream::flush()`) to detect
+ * errors before destroying the streambuf.
+ *
+ * Returns `StatusCode::kUnimplemented` on platforms without POSIX file I/O.
+ */
+StatusOr<std::unique_ptr<std::streambuf>> OpenDirectFileForWrite(
+    std::string const& file_name, std::size_t block_size);
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_DIRECT_FILE_IO_H
@@ -0,0 +1,144 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/direct_file_io.h"
+#include "google/cloud/storage/testing/random_names.h"
+#include "google/cloud/storage/testing/temp_file.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::MakeRandomData;
+using ::google::cloud::storage::testing::TempFile;
+using ::google::cloud::testing_util::StatusIs;
+
+auto constexpr kBlockSize = 2 * kDirectIOAlignment;
+
+std::string ReadAll(std::string const& file_name) {
+  std::ifstream is(file_name, std::ios::binary);
+  return std::string{std::istreambuf_iterator<char>(is), {}};
+}
+
+#ifndef _WIN32
+TEST(DirectFileIOTest, Read) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const contents = MakeRandomData(generator, 3 * kBlockSize + 100);
+  TempFile file(contents);
+
+  auto buf = OpenDirectFileForRead(file.name(), kBlockSize);
+  ASSERT_STATUS_OK(buf);
+  std::istream is(buf->get());
+  std::string actual{std::istreambuf_iterator<char>(is), {}};
+  EXPECT_EQ(contents, actual);
+}
+
+TEST(DirectFileIOTest, ReadEmpty) {
+  TempFile file("");
+  auto buf = OpenDirectFileForRead(file.name(), kBlockSize);
+  ASSERT_STATUS_OK(buf);
+  std::istream is(buf->get());
+  std::string actual{std::istreambuf_iterator<char>(is), {}};
+  EXPECT_TRUE(actual.empty());
+}
+
+TEST(DirectFileIOTest, Seek) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const contents = MakeRandomData(generator, 3 * kBlockSize + 100);
+  TempFile file(contents);
+
+  auto buf = OpenDirectFileForRead(file.name(), kBlockSize);
+  ASSERT_STATUS_OK(buf);
+  std::istream is(buf->get());
+  std::string data(200, '\0');
+  for (std::streamoff offset :
+       {0, 123, 4096, 4097, 3 * 4096 + 5, 100, 2 * 8192 + 7}) {
+    is.seekg(offset, std::ios::beg);
+    EXPECT_EQ(offset, is.tellg());
+    is.read(&data[0], data.size());
+    ASSERT_TRUE(is.good()) << "offset=" << offset;
+    EXPECT_EQ(contents.substr(static_cast<std::size_t>(offset), data.size()),
+              data)
+        << "offset=" << offset;
+    EXPECT_EQ(offset + data.size(), is.tellg());
+  }
+
+  is.seekg(-50, std::ios::end);
+  is.read(&data[0], data.size());
+  EXPECT_EQ(50, is.gcount());
+  EXPECT_EQ(contents.substr(contents.size() - 50), data.substr(0, 50));
+  EXPECT_TRUE(is.eof());
+}
+
+TEST(DirectFileIOTest, ReadMissing) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const name =
+      ::testing::TempDir() + testing::MakeRandomFileName(generator);
+  auto buf = OpenDirectFileForRead(name, kBlockSize);
+  EXPECT_THAT(buf, StatusIs(StatusCode::kNotFound));
+}
+
+TEST(DirectFileIOTest, Write) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const contents = MakeRandomData(generator, 3 * kBlockSize + 100);
+  TempFile file("some existing data");
+
+  auto buf = OpenDirectFileForWrite(file.name(), kBlockSize);
+  ASSERT_STATUS_OK(buf);
+  std::ostream os(buf->get());
+  // Write in pieces of different sizes, to test full and partial blocks.
+  std::size_t offset = 0;
+  for (std::size_t size : {10, 4096, 8192, 1, 9000}) {
+    os.write(contents.data() + offset, static_cast<std::streamsize>(size));
+    offset += size;
+  }
+  os.write(contents.data() + offset,
+           static_cast<std::streamsize>(contents.size() - offset));
+  os.flush();
+  ASSERT_TRUE(os.good());
+  EXPECT_EQ(contents, ReadAll(file.name()));
+}
+
+TEST(DirectFileIOTest, WriteAfterFlush) {
+  TempFile file("");
+  auto buf = OpenDirectFileForWrite(file.name(), kBlockSize);
+  ASSERT_STATUS_OK(buf);
+  std::ostream os(buf->get());
+  os << "hello";
+  os.flush();
+  ASSERT_TRUE(os.good());
+  EXPECT_EQ("hello", ReadAll(file.name()));
+  os << " world";
+  os.flush();
+  ASSERT_TRUE(os.good());
+  EXPECT_EQ("hello world", ReadAll(file.name()));
+}
+#endif  // _WIN32
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,124 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_EXPIRING_LRU_CACHE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_EXPIRING_LRU_CACHE_H
+
+#include "google/cloud/storage/version.h"
+#include "absl/types/optional.h"
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A thread-safe LRU cache where the entries expire after a fixed time.
+ *
+ * The cache holds at most `max_entries` values, once full, inserting a new
+ * value evicts the least recently used entry. Entries older than `ttl` are
+ * never returned, and are removed when found.
+ *
+ * @tparam Value the type of the cached values, must be copyable.
+ * @tparam Clock the clock used to expire entries, it is a template parameter
+ *     so tests can use a fake clock.
+ */
+template <typename Value, typename Clock = std::chrono::steady_clock>
+class ExpiringLruCache {
+ public:
+  using duration = typename Clock::duration;
+  using time_point = typename Clock::time_point;
+
+  ExpiringLruCache(std::size_t max_entries, duration ttl)
+      : max_entries_(max_entries), ttl_(ttl) {}
+
+  /// Returns the value for @p key, if present and not expired.
+  absl::optional<Value> Get(std::string const& key) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto i = index_.find(key);
+    if (i == index_.end()) return {};
+    auto e = i->second;
+    if (e->expiration <= Clock::now()) {
+      index_.erase(i);
+      entries_.erase(e);
+      return {};
+    }
+    entries_.splice(entries_.begin(), entries_, e);
+    return e->value;
+  }
+
+  /// Inserts or replaces the value for @p key.
+  void Put(std::string const& key, Value value) {
+    if (max_entries_ == 0) return;
+    std::lock_guard<std::mutex> lk(mu_);
+    auto const expiration = Clock::now() + ttl_;
+    auto i = index_.find(key);
+    if (i != index_.end()) {
+      i->second->value = std::move(value);
+      i->second->expiration = expiration;
+      entries_.splice(entries_.begin(), entries_, i->second);
+      return;
+    }
+    while (entries_.size() >= max_entries_) {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+    entries_.push_front(Entry{key, std::move(value), expiration});
+    index_.emplace(key, entries_.begin());
+  }
+
+  /// Removes the value for @p key, if present.
+  void Erase(std::string const& key) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto i = index_.find(key);
+    if (i == index_.end()) return;
+    entries_.erase(i->second);
+    index_.erase(i);
+  }
+
+  /// The number of entries, including any expired entries not yet removed.
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    Value value;
+    time_point expiration;
+  };
+
+  std::size_t const max_entries_;
+  duration const ttl_;
+  mutable std::mutex mu_;
+  // The most recently used entries are at the front of the list.
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, typename std::list<Entry>::iterator> index_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_EXPIRING_LRU_CACHE_H
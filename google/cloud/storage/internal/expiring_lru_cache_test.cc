@@ -0,0 +1,86 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/expiring_lru_cache.h"
+#include "google/cloud/storage/testing/mock_fake_clock.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::FakeClock;
+using ::testing::Eq;
+using ::testing::Optional;
+
+using TestCache = ExpiringLruCache<int, FakeClock>;
+
+TEST(ExpiringLruCacheTest, Basic) {
+  FakeClock::reset_clock(1000);
+  TestCache cache(4, std::chrono::seconds(10));
+  EXPECT_FALSE(cache.Get("a").has_value());
+  cache.Put("a", 1);
+  cache.Put("b", 2);
+  EXPECT_THAT(cache.Get("a"), Optional(Eq(1)));
+  EXPECT_THAT(cache.Get("b"), Optional(Eq(2)));
+  cache.Put("a", 3);
+  EXPECT_THAT(cache.Get("a"), Optional(Eq(3)));
+  EXPECT_EQ(2, cache.size());
+  cache.Erase("a");
+  EXPECT_FALSE(cache.Get("a").has_value());
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST(ExpiringLruCacheTest, EvictsLeastRecentlyUsed) {
+  FakeClock::reset_clock(1000);
+  TestCache cache(2, std::chrono::seconds(10));
+  cache.Put("a", 1);
+  cache.Put("b", 2);
+  // Using "a" makes "b" the least recently used entry.
+  EXPECT_THAT(cache.Get("a"), Optional(Eq(1)));
+  cache.Put("c", 3);
+  EXPECT_EQ(2, cache.size());
+  EXPECT_THAT(cache.Get("a"), Optional(Eq(1)));
+  EXPECT_FALSE(cache.Get("b").has_value());
+  EXPECT_THAT(cache.Get("c"), Optional(Eq(3)));
+}
+
+TEST(ExpiringLruCacheTest, Expires) {
+  FakeClock::reset_clock(1000);
+  TestCache cache(2, std::chrono::seconds(10));
+  cache.Put("a", 1);
+  FakeClock::reset_clock(1005);
+  cache.Put("b", 2);
+  FakeClock::reset_clock(1010);
+  EXPECT_FALSE(cache.Get("a").has_value());
+  EXPECT_THAT(cache.Get("b"), Optional(Eq(2)));
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST(ExpiringLruCacheTest, Disabled) {
+  TestCache cache(0, std::chrono::seconds(10));
+  cache.Put("a", 1);
+  EXPECT_FALSE(cache.Get("a").has_value());
+  EXPECT_EQ(0, cache.size());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,144 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GRPC_CHANNEL_POOL_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GRPC_CHANNEL_POOL_H
+
+#include "google/cloud/storage/version.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A pool of gRPC stubs, each using a different channel, for streaming RPCs.
+ *
+ * Each HTTP/2 connection supports a limited number of concurrent streams,
+ * additional streams wait until a stream in the same connection completes.
+ * This class tracks the number of active streams in each channel, and
+ * `Acquire()` returns the stub for the least loaded channel. If all the
+ * channels have at least @p max_streams_per_channel active streams, and the
+ * pool has fewer than @p max_size channels, a new channel is created.
+ *
+ * The pool never shrinks: gRPC closes idle connections on its own, and
+ * reconnects on demand.
+ *
+ * @tparam Stub the type of the gRPC stub, a template parameter to simplify
+ *     testing.
+ */
+template <typename Stub>
+class GrpcChannelPool {
+ public:
+  /// Creates the stub for a new channel, with the given index in the pool.
+  using StubFactory = std::function<std::shared_ptr<Stub>(int)>;
+
+  /// Creates a pool with the (non-empty) initial set of @p stubs.
+  GrpcChannelPool(std::vector<std::shared_ptr<Stub>> stubs,
+                  StubFactory factory, std::size_t max_size,
+                  std::size_t max_streams_per_channel)
+      : state_(std::make_shared<State>()) {
+    state_->factory = std::move(factory);
+    state_->max_size = (std::max)(max_size, stubs.size());
+    state_->max_streams_per_channel =
+        (std::max)(max_streams_per_channel, std::size_t{1});
+    for (auto& s : stubs) state_->channels.push_back({std::move(s), 0});
+  }
+
+  /**
+   * Returns the stub for the least loaded channel.
+   *
+   * The returned pointer counts as an active stream on the channel until it,
+   * and any copies of it, are released. Applications should keep it for as
+   * long as the stream created with it is active.
+   */
+  std::shared_ptr<Stub> Acquire() {
+    std::lock_guard<std::mutex> lk(state_->mu);
+    auto& channels = state_->channels;
+    auto best = std::min_element(channels.begin(), channels.end(),
+                                 [](Channel const& a, Channel const& b) {
+                                   return a.active_streams < b.active_streams;
+                                 });
+    auto index = static_cast<std::size_t>(best - channels.begin());
+    if (best->active_streams >= state_->max_streams_per_channel &&
+        channels.size() < state_->max_size) {
+      index = channels.size();
+      channels.push_back({state_->factory(static_cast<int>(index)), 0});
+    }
+    auto& channel = channels[index];
+    ++channel.active_streams;
+    auto lease = std::make_shared<Lease>(state_, index, channel.stub);
+    return std::shared_ptr<Stub>(lease, lease->stub.get());
+  }
+
+  /// The number of channels in the pool.
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lk(state_->mu);
+    return state_->channels.size();
+  }
+
+  /// The number of active streams in each channel.
+  std::vector<std::size_t> active_streams() const {
+    std::lock_guard<std::mutex> lk(state_->mu);
+    std::vector<std::size_t> result;
+    result.reserve(state_->channels.size());
+    for (auto const& c : state_->channels) result.push_back(c.active_streams);
+    return result;
+  }
+
+ private:
+  struct Channel {
+    std::shared_ptr<Stub> stub;
+    std::size_t active_streams;
+  };
+
+  // The leases may outlive the pool, so the state is shared with them.
+  struct State {
+    std::mutex mu;
+    std::vector<Channel> channels;
+    StubFactory factory;
+    std::size_t max_size;
+    std::size_t max_streams_per_channel;
+  };
+
+  struct Lease {
+    Lease(std::shared_ptr<State> s, std::size_t i, std::shared_ptr<Stub> st)
+        : state(std::move(s)), index(i), stub(std::move(st)) {}
+    ~Lease() {
+      std::lock_guard<std::mutex> lk(state->mu);
+      --state->channels[index].active_streams;
+    }
+
+    std::shared_ptr<State> state;
+    std::size_t index;
+    std::shared_ptr<Stub> stub;
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GRPC_CHANNEL_POOL_H
@@ -0,0 +1,114 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/grpc_channel_pool.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+
+struct FakeStub {
+  int index;
+};
+
+using TestPool = GrpcChannelPool<FakeStub>;
+
+std::vector<std::shared_ptr<FakeStub>> MakeStubs(int count) {
+  std::vector<std::shared_ptr<FakeStub>> stubs;
+  for (int i = 0; i != count; ++i) {
+    stubs.push_back(std::make_shared<FakeStub>(FakeStub{i}));
+  }
+  return stubs;
+}
+
+TestPool::StubFactory MakeFactory(std::vector<int>& created) {
+  return [&created](int index) {
+    created.push_back(index);
+    return std::make_shared<FakeStub>(FakeStub{index});
+  };
+}
+
+TEST(GrpcChannelPoolTest, LeastLoaded) {
+  std::vector<int> created;
+  TestPool pool(MakeStubs(3), MakeFactory(created), 3, 10);
+
+  auto s0 = pool.Acquire();
+  auto s1 = pool.Acquire();
+  auto s2 = pool.Acquire();
+  EXPECT_EQ(0, s0->index);
+  EXPECT_EQ(1, s1->index);
+  EXPECT_EQ(2, s2->index);
+  EXPECT_THAT(pool.active_streams(), ElementsAre(1, 1, 1));
+
+  s1.reset();
+  EXPECT_THAT(pool.active_streams(), ElementsAre(1, 0, 1));
+  auto s3 = pool.Acquire();
+  EXPECT_EQ(1, s3->index);
+
+  // Copies of the stub share the same lease.
+  auto copy = s3;
+  s3.reset();
+  EXPECT_THAT(pool.active_streams(), ElementsAre(1, 1, 1));
+  copy.reset();
+  EXPECT_THAT(pool.active_streams(), ElementsAre(1, 0, 1));
+  EXPECT_TRUE(created.empty());
+}
+
+TEST(GrpcChannelPoolTest, GrowsWhenSaturated) {
+  std::vector<int> created;
+  TestPool pool(MakeStubs(1), MakeFactory(created), 3, 2);
+
+  std::vector<std::shared_ptr<FakeStub>> streams;
+  for (int i = 0; i != 6; ++i) streams.push_back(pool.Acquire());
+  EXPECT_EQ(3U, pool.size());
+  EXPECT_THAT(created, ElementsAre(1, 2));
+  EXPECT_THAT(pool.active_streams(), ElementsAre(2, 2, 2));
+
+  // Once the pool reaches its maximum size the streams share the channels.
+  streams.push_back(pool.Acquire());
+  EXPECT_EQ(3U, pool.size());
+  EXPECT_THAT(pool.active_streams(), ElementsAre(3, 2, 2));
+
+  // The pool does not shrink, new streams use the idle channels.
+  streams.clear();
+  EXPECT_THAT(pool.active_streams(), ElementsAre(0, 0, 0));
+  auto s = pool.Acquire();
+  EXPECT_EQ(3U, pool.size());
+  EXPECT_THAT(created, ElementsAre(1, 2));
+}
+
+TEST(GrpcChannelPoolTest, LeaseOutlivesPool) {
+  std::vector<int> created;
+  std::shared_ptr<FakeStub> stub;
+  {
+    TestPool pool(MakeStubs(1), MakeFactory(created), 1, 1);
+    stub = pool.Acquire();
+  }
+  ASSERT_TRUE(stub);
+  EXPECT_EQ(0, stub->index);
+  stub.reset();
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -16,6 +16,7 @@
 #include "google/cloud/storage/internal/grpc_object_read_source.h"
 #include "google/cloud/storage/internal/grpc_resumable_upload_session.h"
 #include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/storage/internal/parallel_object_read_source.h"
 #include "google/cloud/storage/internal/resumable_upload_session.h"
 #include "google/cloud/storage/internal/sha256_hash.h"
 #include "google/cloud/storage/oauth2/anonymous_credentials.h"
@@ -48,20 +49,42 @@ bool DirectPathEnabled() {
                         [](absl::string_view v) { return v == "storage"; });
 }
 
-std::string GrpcEndpoint() {
+DirectPathMode GetDirectPathMode(ClientOptions const& options) {
+  // A custom endpoint, typically the emulator, cannot use DirectPath.
+  auto env = google::cloud::internal::GetEnv("CLOUD_STORAGE_GRPC_ENDPOINT");
+  if (env.has_value()) return DirectPathMode::kDisabled;
+  auto const& channel_options = options.channel_options();
+  if (!channel_options.enable_direct_path() && !DirectPathEnabled()) {
+    return DirectPathMode::kDisabled;
+  }
+  return channel_options.direct_path_xds() ? DirectPathMode::kXds
+                                           : DirectPathMode::kGrpclb;
+}
+
+std::string GrpcEndpoint(DirectPathMode mode) {
   auto env = google::cloud::internal::GetEnv("CLOUD_STORAGE_GRPC_ENDPOINT");
   if (env.has_value()) {
     return env.value();
   }
+  // The `google-c2p` resolver uses xDS to find the DirectPath backends when
+  // running on Google Cloud, and DNS (i.e. CloudPath) elsewhere.
+  if (mode == DirectPathMode::kXds) {
+    return "google-c2p:///storage.googleapis.com";
+  }
   return "storage.googleapis.com";
 }
 
 std::shared_ptr<grpc::ChannelCredentials> GrpcCredentials(
-    ClientOptions const& options) {
+    ClientOptions const& options, DirectPathMode mode) {
   auto env = google::cloud::internal::GetEnv("CLOUD_STORAGE_GRPC_ENDPOINT");
   if (env.has_value()) {
     return grpc::InsecureChannelCredentials();
   }
+  // The Google default credentials use ALTS with the DirectPath backends, and
+  // TLS with the CloudPath endpoints.
+  if (mode != DirectPathMode::kDisabled) {
+    return grpc::GoogleDefaultCredentials();
+  }
   if (dynamic_cast<oauth2::AnonymousCredentials*>(
           options.credentials().get()) != nullptr) {
     return grpc::InsecureChannelCredentials();
@@ -76,9 +99,21 @@ std::shared_ptr<grpc::ChannelInterface> CreateGrpcChannel(
 
 std::shared_ptr<grpc::ChannelInterface> CreateGrpcChannel(
     ClientOptions const& options, int channel_id) {
+  return CreateGrpcChannel(options, channel_id, 0);
+}
+
+std::shared_ptr<grpc::ChannelInterface> CreateGrpcChannel(
+    ClientOptions const& options, int channel_id, int pool_index) {
   grpc::ChannelArguments args;
   args.SetInt("grpc.channel_id", channel_id);
-  if (DirectPathEnabled()) {
+  // gRPC shares the connections of channels with identical arguments, a
+  // distinct argument forces each channel in the pool to use its own
+  // connection.
+  if (pool_index != 0) {
+    args.SetInt("grpc.storage_channel_pool_index", pool_index);
+  }
+  auto const mode = GetDirectPathMode(options);
+  if (mode == DirectPathMode::kGrpclb) {
     args.SetServiceConfigJSON(R"json({
       "loadBalancingConfig": [{
         "grpclb": {
@@ -88,30 +123,127 @@ std::shared_ptr<grpc::ChannelInterface> CreateGrpcChannel(
         }
       }]
     })json");
-  }
-  return grpc::CreateCustomChannel(GrpcEndpoint(), GrpcCredentials(options),
+    // The grpclb balancers are discovered using DNS SRV records. If they are
+    // not reachable, use the CloudPath backends returned by DNS.
+    args.SetInt(GRPC_ARG_DNS_ENABLE_SRV_QUERIES, 1);
+    args.SetInt(GRPC_ARG_GRPCLB_FALLBACK_TIMEOUT_MS,
+                static_cast<int>(options.channel_options()
+                                     .direct_path_fallback_timeout()
+                                     .count()));
+  }
+  return grpc::CreateCustomChannel(GrpcEndpoint(mode),
+                                   GrpcCredentials(options, mode),
                                    std::move(args));
 }
 
+namespace {
+
+using StubPtr = std::shared_ptr<google::storage::v1::Storage::Stub>;
+
+/// Keeps a stub from the channel pool while a download is active.
+template <typename Response>
+class LeasedReader : public grpc::ClientReaderInterface<Response> {
+ public:
+  LeasedReader(StubPtr lease,
+               std::unique_ptr<grpc::ClientReaderInterface<Response>> impl)
+      : lease_(std::move(lease)), impl_(std::move(impl)) {}
+
+  bool NextMessageSize(std::uint32_t* sz) override {
+    return impl_->NextMessageSize(sz);
+  }
+  bool Read(Response* msg) override { return impl_->Read(msg); }
+  void WaitForInitialMetadata() override { impl_->WaitForInitialMetadata(); }
+  grpc::Status Finish() override { return impl_->Finish(); }
+
+ private:
+  StubPtr lease_;
+  std::unique_ptr<grpc::ClientReaderInterface<Response>> impl_;
+};
+
+/// Keeps a stub from the channel pool while an upload is active.
+template <typename Request>
+class LeasedWriter : public grpc::ClientWriterInterface<Request> {
+ public:
+  LeasedWriter(StubPtr lease,
+               std::unique_ptr<grpc::ClientWriterInterface<Request>> impl)
+      : lease_(std::move(lease)), impl_(std::move(impl)) {}
+
+  bool Write(Request const& msg, grpc::WriteOptions options) override {
+    return impl_->Write(msg, std::move(options));
+  }
+  bool WritesDone() override { return impl_->WritesDone(); }
+  grpc::Status Finish() override { return impl_->Finish(); }
+
+ private:
+  StubPtr lease_;
+  std::unique_ptr<grpc::ClientWriterInterface<Request>> impl_;
+};
+
+using ObjectMediaReader =
+    grpc::ClientReaderInterface<google::storage::v1::GetObjectMediaResponse>;
+
+std::unique_ptr<ObjectMediaReader> MakeLeasedReader(
+    StubPtr lease, std::unique_ptr<ObjectMediaReader> impl) {
+  return std::unique_ptr<ObjectMediaReader>(
+      new LeasedReader<google::storage::v1::GetObjectMediaResponse>(
+          std::move(lease), std::move(impl)));
+}
+
+/// Limit the RPC to the time left before the operation deadline, if any.
+template <typename Request>
+void ApplyOperationDeadline(grpc::ClientContext& context,
+                            Request const& request) {
+  if (!request.template HasOption<OperationDeadline>()) return;
+  context.set_deadline(request.template GetOption<OperationDeadline>().value());
+}
+
+}  // namespace
+
 GrpcClient::GrpcClient(ClientOptions options)
     : options_(std::move(options)),
-      stub_(google::storage::v1::Storage::NewStub(CreateGrpcChannel(options))) {
-}
+      stub_(
+          google::storage::v1::Storage::NewStub(CreateGrpcChannel(options_))),
+      stub_pool_(CreateStubPool(options_, stub_, 0)) {}
 
 GrpcClient::GrpcClient(ClientOptions options, int channel_id)
     : options_(std::move(options)),
       stub_(google::storage::v1::Storage::NewStub(
-          CreateGrpcChannel(options, channel_id))) {}
+          CreateGrpcChannel(options_, channel_id))),
+      stub_pool_(CreateStubPool(options_, stub_, channel_id)) {}
+
+GrpcClient::StubPool GrpcClient::CreateStubPool(ClientOptions const& options,
+                                                StubPtr stub, int channel_id) {
+  auto const& channel_options = options.channel_options();
+  auto const pool_size = channel_options.channel_pool_size();
+  std::vector<StubPtr> stubs;
+  stubs.reserve(pool_size);
+  stubs.push_back(std::move(stub));
+  for (std::size_t i = 1; i < pool_size; ++i) {
+    stubs.push_back(google::storage::v1::Storage::NewStub(
+        CreateGrpcChannel(options, channel_id, static_cast<int>(i))));
+  }
+  auto factory = [options, channel_id](int pool_index) -> StubPtr {
+    return google::storage::v1::Storage::NewStub(
+        CreateGrpcChannel(options, channel_id, pool_index));
+  };
+  return StubPool(std::move(stubs), std::move(factory),
+                  channel_options.max_channel_pool_size(),
+                  channel_options.max_streams_per_channel());
+}
 
 std::unique_ptr<GrpcClient::UploadWriter> GrpcClient::CreateUploadWriter(
     grpc::ClientContext& context, google::storage::v1::Object& result) {
-  auto concrete_writer = stub_->InsertObject(&context, &result);
-  return std::unique_ptr<GrpcClient::UploadWriter>(concrete_writer.release());
+  auto stub = stub_pool_.Acquire();
+  auto concrete_writer = stub->InsertObject(&context, &result);
+  return std::unique_ptr<GrpcClient::UploadWriter>(
+      new LeasedWriter<google::storage::v1::InsertObjectRequest>(
+          std::move(stub), std::move(concrete_writer)));
 }
 
 StatusOr<ResumableUploadResponse> GrpcClient::QueryResumableUpload(
     QueryResumableUploadRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto const proto_request = ToProto(request);
   google::storage::v1::QueryWriteStatusResponse response;
   auto status = stub_->QueryWriteStatus(&context, proto_request, &response);
@@ -132,6 +264,7 @@ ClientOptions const& GrpcClient::client_options() const { return options_; }
 StatusOr<ListBucketsResponse> GrpcClient::ListBuckets(
     ListBucketsRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::ListBucketsResponse response;
   auto status = stub_->ListBuckets(&context, proto_request, &response);
@@ -149,6 +282,7 @@ StatusOr<ListBucketsResponse> GrpcClient::ListBuckets(
 StatusOr<BucketMetadata> GrpcClient::CreateBucket(
     CreateBucketRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::Bucket response;
   auto status = stub_->InsertBucket(&context, proto_request, &response);
@@ -160,6 +294,7 @@ StatusOr<BucketMetadata> GrpcClient::CreateBucket(
 StatusOr<BucketMetadata> GrpcClient::GetBucketMetadata(
     GetBucketMetadataRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   google::storage::v1::Bucket response;
   auto proto_request = ToProto(request);
   auto status = stub_->GetBucket(&context, proto_request, &response);
@@ -171,6 +306,7 @@ StatusOr<BucketMetadata> GrpcClient::GetBucketMetadata(
 StatusOr<EmptyResponse> GrpcClient::DeleteBucket(
     DeleteBucketRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::protobuf::Empty response;
   auto status = stub_->DeleteBucket(&context, proto_request, &response);
@@ -182,6 +318,7 @@ StatusOr<EmptyResponse> GrpcClient::DeleteBucket(
 StatusOr<BucketMetadata> GrpcClient::UpdateBucket(
     UpdateBucketRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   google::storage::v1::Bucket response;
   auto proto_request = ToProto(request);
   auto status = stub_->UpdateBucket(&context, proto_request, &response);
@@ -227,12 +364,14 @@ StatusOr<BucketMetadata> GrpcClient::LockBucketRetentionPolicy(
 StatusOr<ObjectMetadata> GrpcClient::InsertObjectMedia(
     InsertObjectMediaRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   google::storage::v1::Object response;
-  auto stream = stub_->InsertObject(&context, &response);
+  auto stub = stub_pool_.Acquire();
+  auto stream = stub->InsertObject(&context, &response);
   auto proto_request = ToProto(request);
   std::size_t const maximum_buffer_size =
       google::storage::v1::ServiceConstants::MAX_WRITE_CHUNK_BYTES;
-  auto const& contents = request.contents();
+  auto const contents = request.contents();
 
   // This loop must run at least once because we need to send at least one
   // Write() call for empty objects.
@@ -241,7 +380,7 @@ StatusOr<ObjectMetadata> GrpcClient::InsertObjectMedia(
     proto_request.set_write_offset(offset);
     auto& data = *proto_request.mutable_checksummed_data();
     auto const n = (std::min)(contents.size() - offset, maximum_buffer_size);
-    data.set_content(contents.substr(offset, n));
+    data.set_content(contents.data() + offset, n);
     data.mutable_crc32c()->set_value(crc32c::Crc32c(data.content()));
 
     grpc::WriteOptions options;
@@ -285,15 +424,68 @@ StatusOr<std::unique_ptr<ObjectReadSource>> GrpcClient::ReadObject(
         StatusCode::kOutOfRange,
         "ReadLast(0) is invalid in REST and produces incorrect output in gRPC");
   }
+  if (request.HasOption<ParallelReadStreams>() &&
+      request.HasOption<ReadRange>() &&
+      request.GetOption<ParallelReadStreams>().value() > 1) {
+    return ParallelReadObject(request,
+                              request.GetOption<ParallelReadStreams>().value());
+  }
   auto const proto_request = ToProto(request);
-  auto create_stream = [&proto_request, this](grpc::ClientContext& context) {
-    return stub_->GetObjectMedia(&context, proto_request);
+  auto stub = stub_pool_.Acquire();
+  auto create_stream = [&proto_request, &stub,
+                        &request](grpc::ClientContext& context) {
+    ApplyOperationDeadline(context, request);
+    return MakeLeasedReader(stub,
+                            stub->GetObjectMedia(&context, proto_request));
   };
 
   return std::unique_ptr<ObjectReadSource>(
       new GrpcObjectReadSource(create_stream));
 }
 
+StatusOr<std::unique_ptr<ObjectReadSource>> GrpcClient::ParallelReadObject(
+    ReadObjectRangeRequest const& request, std::size_t streams) {
+  // Each stream should download enough data to amortize the cost of starting
+  // a new stream.
+  auto constexpr kMinShardSize = 8 * 1024 * 1024L;
+  auto range = request.GetOption<ReadRange>().value();
+  if (request.HasOption<ReadFromOffset>()) {
+    range.begin =
+        (std::max)(range.begin, request.GetOption<ReadFromOffset>().value());
+  }
+  if (range.begin >= range.end) {
+    // Nothing to split, let the service report any errors.
+    auto shard = request;
+    shard.set_multiple_options(ParallelReadStreams());
+    return ReadObject(shard);
+  }
+
+  auto const shards =
+      ComputeReadRangeShards(range.begin, range.end, streams, kMinShardSize);
+  std::vector<std::unique_ptr<ObjectReadSource>> sources;
+  sources.reserve(shards.size());
+  for (std::size_t i = 0; i != shards.size(); ++i) {
+    auto shard = request;
+    shard.set_multiple_options(ReadRange(shards[i].begin, shards[i].end),
+                               ReadFromOffset(), ParallelReadStreams());
+    auto const proto_request = ToProto(shard);
+    // The pool returns the least loaded channel, which spreads the shards
+    // across different channels.
+    auto stub = stub_pool_.Acquire();
+    auto create_stream = [&proto_request, &stub,
+                          &request](grpc::ClientContext& context) {
+      ApplyOperationDeadline(context, request);
+      return MakeLeasedReader(stub,
+                              stub->GetObjectMedia(&context, proto_request));
+    };
+    sources.push_back(std::unique_ptr<ObjectReadSource>(
+        new GrpcObjectReadSource(create_stream)));
+  }
+  if (sources.size() == 1) return std::move(sources.front());
+  return std::unique_ptr<ObjectReadSource>(
+      new ParallelObjectReadSource(std::move(sources)));
+}
+
 StatusOr<ListObjectsResponse> GrpcClient::ListObjects(
     ListObjectsRequest const&) {
   return Status(StatusCode::kUnimplemented, __func__);
@@ -302,6 +494,7 @@ StatusOr<ListObjectsResponse> GrpcClient::ListObjects(
 StatusOr<EmptyResponse> GrpcClient::DeleteObject(
     DeleteObjectRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::protobuf::Empty response;
   auto status = stub_->DeleteObject(&context, proto_request, &response);
@@ -338,6 +531,7 @@ GrpcClient::CreateResumableSession(ResumableUploadRequest const& request) {
   }
 
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::StartResumableWriteResponse response;
   auto status = stub_->StartResumableWrite(&context, proto_request, &response);
@@ -373,6 +567,7 @@ StatusOr<EmptyResponse> GrpcClient::DeleteResumableUpload(
 StatusOr<ListBucketAclResponse> GrpcClient::ListBucketAcl(
     ListBucketAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::ListBucketAccessControlsResponse response;
   auto status =
@@ -390,6 +585,7 @@ StatusOr<ListBucketAclResponse> GrpcClient::ListBucketAcl(
 StatusOr<BucketAccessControl> GrpcClient::GetBucketAcl(
     GetBucketAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::BucketAccessControl response;
   auto status =
@@ -402,6 +598,7 @@ StatusOr<BucketAccessControl> GrpcClient::GetBucketAcl(
 StatusOr<BucketAccessControl> GrpcClient::CreateBucketAcl(
     CreateBucketAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::BucketAccessControl response;
   auto status =
@@ -413,6 +610,7 @@ StatusOr<BucketAccessControl> GrpcClient::CreateBucketAcl(
 StatusOr<EmptyResponse> GrpcClient::DeleteBucketAcl(
     DeleteBucketAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::protobuf::Empty response;
   auto status =
@@ -430,6 +628,7 @@ StatusOr<ListObjectAclResponse> GrpcClient::ListObjectAcl(
 StatusOr<BucketAccessControl> GrpcClient::UpdateBucketAcl(
     UpdateBucketAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::BucketAccessControl response;
   auto status =
@@ -472,6 +671,7 @@ StatusOr<ObjectAccessControl> GrpcClient::PatchObjectAcl(
 StatusOr<ListDefaultObjectAclResponse> GrpcClient::ListDefaultObjectAcl(
     ListDefaultObjectAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::ListObjectAccessControlsResponse response;
   auto status = stub_->ListDefaultObjectAccessControls(&context, proto_request,
@@ -489,6 +689,7 @@ StatusOr<ListDefaultObjectAclResponse> GrpcClient::ListDefaultObjectAcl(
 StatusOr<ObjectAccessControl> GrpcClient::CreateDefaultObjectAcl(
     CreateDefaultObjectAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::ObjectAccessControl response;
   auto status = stub_->InsertDefaultObjectAccessControl(&context, proto_request,
@@ -500,6 +701,7 @@ StatusOr<ObjectAccessControl> GrpcClient::CreateDefaultObjectAcl(
 StatusOr<EmptyResponse> GrpcClient::DeleteDefaultObjectAcl(
     DeleteDefaultObjectAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::protobuf::Empty response;
   auto status = stub_->DeleteDefaultObjectAccessControl(&context, proto_request,
@@ -512,6 +714,7 @@ StatusOr<EmptyResponse> GrpcClient::DeleteDefaultObjectAcl(
 StatusOr<ObjectAccessControl> GrpcClient::GetDefaultObjectAcl(
     GetDefaultObjectAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::ObjectAccessControl response;
   auto status =
@@ -524,6 +727,7 @@ StatusOr<ObjectAccessControl> GrpcClient::GetDefaultObjectAcl(
 StatusOr<ObjectAccessControl> GrpcClient::UpdateDefaultObjectAcl(
     UpdateDefaultObjectAclRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::ObjectAccessControl response;
   auto status = stub_->UpdateDefaultObjectAccessControl(&context, proto_request,
@@ -609,6 +813,7 @@ NotificationMetadata GrpcClient::FromProto(
 StatusOr<ListNotificationsResponse> GrpcClient::ListNotifications(
     ListNotificationsRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::ListNotificationsResponse response;
   auto status = stub_->ListNotifications(&context, proto_request, &response);
@@ -625,6 +830,7 @@ StatusOr<ListNotificationsResponse> GrpcClient::ListNotifications(
 StatusOr<NotificationMetadata> GrpcClient::CreateNotification(
     CreateNotificationRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::Notification response;
   auto status = stub_->InsertNotification(&context, proto_request, &response);
@@ -636,6 +842,7 @@ StatusOr<NotificationMetadata> GrpcClient::CreateNotification(
 StatusOr<NotificationMetadata> GrpcClient::GetNotification(
     GetNotificationRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::storage::v1::Notification response;
   auto status = stub_->GetNotification(&context, proto_request, &response);
@@ -647,6 +854,7 @@ StatusOr<NotificationMetadata> GrpcClient::GetNotification(
 StatusOr<EmptyResponse> GrpcClient::DeleteNotification(
     DeleteNotificationRequest const& request) {
   grpc::ClientContext context;
+  ApplyOperationDeadline(context, request);
   auto proto_request = ToProto(request);
   google::protobuf::Empty response;
   auto status = stub_->DeleteNotification(&context, proto_request, &response);
@@ -1697,9 +1905,11 @@ google::storage::v1::InsertObjectRequest GrpcClient::ToProto(
 
   auto& checksums = *r.mutable_object_checksums();
   // TODO(#4156) - use the crc32c value in the request options.
-  checksums.mutable_crc32c()->set_value(crc32c::Crc32c(request.contents()));
+  auto const contents = request.contents();
+  checksums.mutable_crc32c()->set_value(
+      crc32c::Crc32c(contents.data(), contents.size()));
   // TODO(#4157) - use the MD5 hash value in the request options.
-  checksums.set_md5_hash(MD5ToProto(ComputeMD5Hash(request.contents())));
+  checksums.set_md5_hash(MD5ToProto(ComputeMD5Hash(contents)));
 
   return r;
 }
@@ -15,6 +15,7 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GRPC_CLIENT_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GRPC_CLIENT_H
 
+#include "google/cloud/storage/internal/grpc_channel_pool.h"
 #include "google/cloud/storage/internal/raw_client.h"
 #include "google/cloud/storage/version.h"
 #include <google/storage/v1/storage.grpc.pb.h>
@@ -29,9 +30,21 @@ namespace internal {
 /// GOOGLE_CLOUD_DIRECT_PATH.
 bool DirectPathEnabled();
 
+/// How the gRPC channels discover the GCS backends.
+enum class DirectPathMode { kDisabled, kGrpclb, kXds };
+
+/// Determine the DirectPath configuration from @p options and the environment.
+DirectPathMode GetDirectPathMode(ClientOptions const& options);
+
+/// The gRPC endpoint for the given DirectPath configuration.
+std::string GrpcEndpoint(DirectPathMode mode);
+
 std::shared_ptr<grpc::ChannelInterface> CreateGrpcChannel(ClientOptions const&);
 std::shared_ptr<grpc::ChannelInterface> CreateGrpcChannel(ClientOptions const&,
                                                           int channel_id);
+std::shared_ptr<grpc::ChannelInterface> CreateGrpcChannel(ClientOptions const&,
+                                                          int channel_id,
+                                                          int pool_index);
 
 class GrpcClient : public RawClient,
                    public std::enable_shared_from_this<GrpcClient> {
@@ -306,8 +319,20 @@ class GrpcClient : public RawClient,
   static std::string MD5ToProto(std::string const&);
 
  private:
+  using StubPool = GrpcChannelPool<google::storage::v1::Storage::Stub>;
+  static StubPool CreateStubPool(
+      ClientOptions const& options,
+      std::shared_ptr<google::storage::v1::Storage::Stub> stub,
+      int channel_id);
+  StatusOr<std::unique_ptr<ObjectReadSource>> ParallelReadObject(
+      ReadObjectRangeRequest const& request, std::size_t streams);
+
   ClientOptions options_;
   std::shared_ptr<google::storage::v1::Storage::Stub> stub_;
+  // The stubs used for streaming RPCs. The first channel in the pool is the
+  // channel used by `stub_`, the other channels are created on demand, see
+  // `channel_pool_size()` and `max_channel_pool_size()`.
+  StubPool stub_pool_;
 };
 
 }  // namespace internal
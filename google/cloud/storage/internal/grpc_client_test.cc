@@ -16,6 +16,7 @@
 #include "google/cloud/storage/internal/notification_metadata_parser.h"
 #include "google/cloud/storage/internal/object_access_control_parser.h"
 #include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/oauth2/google_credentials.h"
 #include "google/cloud/testing_util/assert_ok.h"
 #include "google/cloud/testing_util/is_proto_equal.h"
 #include "google/cloud/testing_util/scoped_environment.h"
@@ -48,6 +49,39 @@ TEST(GrpcClientDirectPath, NotEnabled) {
   EXPECT_FALSE(DirectPathEnabled());
 }
 
+TEST(GrpcClientDirectPath, Mode) {
+  ScopedEnvironment endpoint("CLOUD_STORAGE_GRPC_ENDPOINT", {});
+  ScopedEnvironment env("GOOGLE_CLOUD_ENABLE_DIRECT_PATH", {});
+  ClientOptions options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(DirectPathMode::kDisabled, GetDirectPathMode(options));
+  EXPECT_EQ("storage.googleapis.com", GrpcEndpoint(DirectPathMode::kDisabled));
+
+  options.channel_options().set_enable_direct_path(true);
+  EXPECT_EQ(DirectPathMode::kGrpclb, GetDirectPathMode(options));
+  EXPECT_EQ("storage.googleapis.com", GrpcEndpoint(DirectPathMode::kGrpclb));
+
+  options.channel_options().set_direct_path_xds(true);
+  EXPECT_EQ(DirectPathMode::kXds, GetDirectPathMode(options));
+  EXPECT_EQ("google-c2p:///storage.googleapis.com",
+            GrpcEndpoint(DirectPathMode::kXds));
+}
+
+TEST(GrpcClientDirectPath, ModeFromEnvironment) {
+  ScopedEnvironment endpoint("CLOUD_STORAGE_GRPC_ENDPOINT", {});
+  ScopedEnvironment env("GOOGLE_CLOUD_ENABLE_DIRECT_PATH", "storage");
+  ClientOptions options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(DirectPathMode::kGrpclb, GetDirectPathMode(options));
+}
+
+TEST(GrpcClientDirectPath, DisabledByCustomEndpoint) {
+  ScopedEnvironment endpoint("CLOUD_STORAGE_GRPC_ENDPOINT", "localhost:8000");
+  ScopedEnvironment env("GOOGLE_CLOUD_ENABLE_DIRECT_PATH", "storage");
+  ClientOptions options(oauth2::CreateAnonymousCredentials());
+  options.channel_options().set_enable_direct_path(true);
+  EXPECT_EQ(DirectPathMode::kDisabled, GetDirectPathMode(options));
+  EXPECT_EQ("localhost:8000", GrpcEndpoint(DirectPathMode::kXds));
+}
+
 TEST(GrpcClientFromProto, ObjectSimple) {
   storage_proto::Object input;
   EXPECT_TRUE(google::protobuf::TextFormat::ParseFromString(R"""(
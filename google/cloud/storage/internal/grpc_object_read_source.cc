@@ -57,30 +57,40 @@ StatusOr<ReadSourceResult> GrpcObjectReadSource::Read(char* buf,
                                                       std::size_t n) {
   std::multimap<std::string, std::string> headers;
   std::size_t offset = 0;
-  auto update_buf = [&offset, buf, n](std::string source) {
-    if (source.empty()) {
-      return source;
-    }
-    auto const nbytes = std::min(n - offset, source.size());
-    std::copy(source.data(), source.data() + nbytes, buf + offset);
+  while (offset < n) {
+    if (spill_offset_ == spill_.size() && !NextResponse(headers)) break;
+    auto const nbytes = (std::min)(n - offset, spill_.size() - spill_offset_);
+    std::copy(spill_.data() + spill_offset_,
+              spill_.data() + spill_offset_ + nbytes, buf + offset);
     offset += nbytes;
-    source.erase(0, nbytes);
-    return source;
-  };
+    spill_offset_ += nbytes;
+  }
+  return MakeResult(offset, std::move(headers));
+}
 
-  spill_ = update_buf(std::move(spill_));
+StatusOr<ReadSourceBlock> GrpcObjectReadSource::ReadBlock(char*,
+                                                          std::size_t n) {
+  std::multimap<std::string, std::string> headers;
+  if (spill_offset_ == spill_.size()) NextResponse(headers);
+  auto const nbytes = (std::min)(n, spill_.size() - spill_offset_);
+  // The data stays in `spill_` until the next call, which is all the caller
+  // can expect.
+  auto* data = &spill_[0] + spill_offset_;
+  spill_offset_ += nbytes;
+  auto result = MakeResult(nbytes, std::move(headers));
+  if (!result) return std::move(result).status();
+  return ReadSourceBlock{data, nbytes, std::move(result->response)};
+}
 
-  while (offset < n && stream_) {
-    google::storage::v1::GetObjectMediaResponse response;
+bool GrpcObjectReadSource::NextResponse(
+    std::multimap<std::string, std::string>& headers) {
+  while (stream_) {
+    // `Clear()` keeps the allocated fields, a failed `Read()` would otherwise
+    // leave the previous response in place.
+    auto& response = response_;
+    response.Clear();
     bool success = stream_->Read(&response);
 
-    // The google.storage.v1.Storage documentation says this field can be empty.
-    if (response.has_checksummed_data()) {
-      spill_ =
-          update_buf(std::string(  // Sometimes protobuf bytes are not strings
-              std::move(
-                  *response.mutable_checksummed_data()->mutable_content())));
-    }
     if (response.has_object_checksums()) {
       auto const& checksums = response.object_checksums();
       if (checksums.has_crc32c()) {
@@ -96,11 +106,26 @@ StatusOr<ReadSourceResult> GrpcObjectReadSource::Read(char* buf,
       status_ = google::cloud::MakeStatusFromRpcError(stream_->Finish());
       stream_ = nullptr;
     }
+    // The google.storage.v1.Storage documentation says this field can be empty.
+    if (!response.has_checksummed_data() ||
+        response.checksummed_data().content().empty()) {
+      continue;
+    }
+    // Take ownership of the data, without copying it. The previous buffer goes
+    // back into the response, so the next read can reuse its memory.
+    spill_.swap(*response.mutable_checksummed_data()->mutable_content());
+    spill_offset_ = 0;
+    return true;
   }
+  return false;
+}
 
-  if (offset != 0) {
+StatusOr<ReadSourceResult> GrpcObjectReadSource::MakeResult(
+    std::size_t bytes_received,
+    std::multimap<std::string, std::string> headers) {
+  if (bytes_received != 0) {
     return ReadSourceResult{
-        offset,
+        bytes_received,
         HttpResponse{HttpStatusCode::kContinue, {}, std::move(headers)}};
   }
   if (status_.ok()) {
@@ -19,6 +19,8 @@
 #include "google/cloud/storage/version.h"
 #include <google/storage/v1/storage.grpc.pb.h>
 #include <functional>
+#include <map>
+#include <string>
 
 namespace google {
 namespace cloud {
@@ -38,6 +40,10 @@ using StreamMaker = std::function<std::unique_ptr<grpc::ClientReaderInterface<
  * needed. The IOStream classes (storage::ReadObjectStream,
  * storage::internal::ReadObjectStreambuf), read chunks from gRPC through this
  * class.
+ *
+ * The data for each response is received in a protobuf message, this class
+ * keeps the message contents until they are consumed, and `ReadBlock()`
+ * returns them without any additional copies.
  */
 class GrpcObjectReadSource : public ObjectReadSource {
  public:
@@ -55,7 +61,16 @@ class GrpcObjectReadSource : public ObjectReadSource {
   /// codes.
   StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override;
 
+  /// Return the next block of data, pointing into the last gRPC response.
+  StatusOr<ReadSourceBlock> ReadBlock(char* buf, std::size_t n) override;
+
  private:
+  /// Receive the next response with data, returns false at the end of stream.
+  bool NextResponse(std::multimap<std::string, std::string>& headers);
+  StatusOr<ReadSourceResult> MakeResult(
+      std::size_t bytes_received,
+      std::multimap<std::string, std::string> headers);
+
   // To create a reader for a streaming RPC one needs a client context with
   // longer lifetime than the stream. This is the client context used for the
   // request.
@@ -64,9 +79,15 @@ class GrpcObjectReadSource : public ObjectReadSource {
       grpc::ClientReaderInterface<google::storage::v1::GetObjectMediaResponse>>
       stream_;
 
+  // Each response is read into this message, gRPC reuses its allocated fields
+  // instead of building a new message tree for every response.
+  google::storage::v1::GetObjectMediaResponse response_;
+
   // In some cases the gRPC response may contain more data than the buffer
-  // provided by the application. This buffer stores any excess results.
+  // provided by the application. This buffer stores the data in the last
+  // response, `spill_offset_` is the start of the data not yet returned.
   std::string spill_;
+  std::size_t spill_offset_ = 0;
 
   // The status of the request.
   google::cloud::Status status_;
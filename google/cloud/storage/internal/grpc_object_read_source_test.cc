@@ -363,6 +363,58 @@ TEST(GrpcObjectReadSource, HandleExtraRead) {
   EXPECT_EQ(200, status->status_code);
 }
 
+TEST(GrpcObjectReadSource, ReadBlockWithoutCopy) {
+  auto mock = absl::make_unique<MockMediaReader>();
+  EXPECT_CALL(*mock, Read(_))
+      .WillOnce([](storage_proto::GetObjectMediaResponse* response) {
+        response->mutable_checksummed_data()->set_content("0123456789");
+        return true;
+      })
+      .WillOnce(Return(true))
+      .WillOnce([](storage_proto::GetObjectMediaResponse* response) {
+        response->mutable_checksummed_data()->set_content("abcdef");
+        return true;
+      })
+      .WillOnce(Return(false));
+  EXPECT_CALL(*mock, Finish()).WillOnce(Return(grpc::Status::OK));
+  GrpcObjectReadSource tested([&mock](grpc::ClientContext&) {
+    return std::unique_ptr<
+        grpc::ClientReaderInterface<storage_proto::GetObjectMediaResponse>>(
+        mock.release());
+  });
+  std::vector<char> buffer(1024);
+  auto const* begin = buffer.data();
+  auto const* end = begin + buffer.size();
+  auto not_in_buffer = [&](char const* p) { return p < begin || p >= end; };
+
+  // Each block comes from a single response, and it is not copied into the
+  // buffer provided by the caller.
+  auto block = tested.ReadBlock(buffer.data(), 4);
+  ASSERT_STATUS_OK(block);
+  EXPECT_EQ("0123", std::string(block->data, block->bytes_received));
+  EXPECT_TRUE(not_in_buffer(block->data));
+  EXPECT_EQ(100, block->response.status_code);
+
+  block = tested.ReadBlock(buffer.data(), buffer.size());
+  ASSERT_STATUS_OK(block);
+  EXPECT_EQ("456789", std::string(block->data, block->bytes_received));
+  EXPECT_TRUE(not_in_buffer(block->data));
+
+  // Mixing Read() and ReadBlock() is supported.
+  auto response = tested.Read(buffer.data(), 2);
+  ASSERT_STATUS_OK(response);
+  EXPECT_EQ("ab", std::string(buffer.data(), response->bytes_received));
+
+  block = tested.ReadBlock(buffer.data(), buffer.size());
+  ASSERT_STATUS_OK(block);
+  EXPECT_EQ("cdef", std::string(block->data, block->bytes_received));
+
+  block = tested.ReadBlock(buffer.data(), buffer.size());
+  ASSERT_STATUS_OK(block);
+  EXPECT_EQ(0, block->bytes_received);
+  EXPECT_EQ(200, block->response.status_code);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
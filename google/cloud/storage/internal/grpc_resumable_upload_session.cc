@@ -16,6 +16,7 @@
 #include "google/cloud/grpc_error_delegate.h"
 #include "absl/memory/memory.h"
 #include <crc32c/crc32c.h>
+#include <algorithm>
 
 namespace google {
 namespace cloud {
@@ -32,12 +33,23 @@ static_assert(google::storage::v1::ServiceConstants::MAX_WRITE_CHUNK_BYTES >
               "Expected maximum insert request size to be greater than twice "
               "the chunk quantum");
 
+namespace {
+std::uint64_t NextExpectedByte(ResumableUploadResponse const& response) {
+  if (response.last_committed_byte == 0) return 0;
+  return response.last_committed_byte + 1;
+}
+}  // namespace
+
+std::size_t constexpr GrpcResumableUploadSession::kDefaultCheckpointInterval;
+
 GrpcResumableUploadSession::GrpcResumableUploadSession(
     std::shared_ptr<GrpcClient> client,
-    ResumableUploadSessionGrpcParams session_id_params)
+    ResumableUploadSessionGrpcParams session_id_params,
+    std::size_t checkpoint_interval)
     : client_(std::move(client)),
       session_id_params_(std::move(session_id_params)),
-      session_url_(EncodeGrpcResumableUploadSessionUrl(session_id_params_)) {}
+      session_url_(EncodeGrpcResumableUploadSessionUrl(session_id_params_)),
+      checkpoint_interval_(checkpoint_interval) {}
 
 StatusOr<ResumableUploadResponse> GrpcResumableUploadSession::UploadChunk(
     ConstBufferSequence const& payload) {
@@ -55,6 +67,8 @@ StatusOr<ResumableUploadResponse> GrpcResumableUploadSession::UploadFinalChunk(
   if (!status.ok()) return google::cloud::MakeStatusFromRpcError(status);
 
   done_ = true;
+  pending_.clear();
+  persisted_ = next_expected_;
   return ResumableUploadResponse{{},
                                  next_expected_ - 1,
                                  GrpcClient::FromProto(upload_object_),
@@ -63,17 +77,29 @@ StatusOr<ResumableUploadResponse> GrpcResumableUploadSession::UploadFinalChunk(
 }
 
 StatusOr<ResumableUploadResponse> GrpcResumableUploadSession::ResetSession() {
+  if (upload_writer_) {
+    // Any data in flight is either persisted or replayed on a new stream.
+    upload_context_->TryCancel();
+    (void)upload_writer_->Finish();
+    upload_writer_ = nullptr;
+    upload_context_ = nullptr;
+  }
   QueryResumableUploadRequest request(session_id_params_.upload_id);
   auto result = client_->QueryResumableUpload(request);
   last_response_ = std::move(result);
   if (!last_response_) return last_response_;
 
   done_ = (last_response_->upload_state == ResumableUploadResponse::kDone);
-  if (last_response_->last_committed_byte == 0) {
-    next_expected_ = 0;
-  } else {
-    next_expected_ = last_response_->last_committed_byte + 1;
+  auto const persisted = NextExpectedByte(*last_response_);
+  if (!done_ && persisted >= persisted_ && persisted <= next_expected_) {
+    // Resume from the last persisted offset, the retained data is replayed
+    // when the next stream is created.
+    DiscardPersisted(persisted);
+    return last_response_;
   }
+  pending_.clear();
+  persisted_ = persisted;
+  next_expected_ = persisted;
   return last_response_;
 }
 
@@ -94,7 +120,7 @@ GrpcResumableUploadSession::last_response() const {
 
 StatusOr<ResumableUploadResponse> GrpcResumableUploadSession::UploadGeneric(
     ConstBufferSequence buffers, bool final_chunk) {
-  CreateUploadWriter();
+  if (!CreateUploadWriter()) return HandleWriteError();
 
   std::size_t const maximum_chunk_size =
       google::storage::v1::ServiceConstants::MAX_WRITE_CHUNK_BYTES;
@@ -104,36 +130,14 @@ StatusOr<ResumableUploadResponse> GrpcResumableUploadSession::UploadGeneric(
     if (chunk.size() < maximum_chunk_size && has_more) return true;
     if (chunk.empty() && !final_chunk) return true;
 
-    google::storage::v1::InsertObjectRequest request;
-    request.set_upload_id(session_id_params_.upload_id);
-    request.set_write_offset(next_expected_);
-    request.set_finish_write(false);
-
-    auto& data = *request.mutable_checksummed_data();
-    auto const n = chunk.size();
-    data.set_content(std::move(chunk));
+    auto content = std::move(chunk);
     chunk.clear();
     chunk.reserve(maximum_chunk_size);
-    data.mutable_crc32c()->set_value(crc32c::Crc32c(data.content()));
-
-    auto options = grpc::WriteOptions();
-    if (final_chunk && !has_more) {
-      // At this point we can set the full object checksums, there are two bugs
-      // for this:
-      // TODO(#4156) - compute the crc32c value inline
-      // TODO(#4157) - compute the MD5 hash value inline
-      request.set_finish_write(true);
-      options.set_last_message();
-    }
-
-    if (!upload_writer_->Write(request, options)) return false;
-    // After the first message, clear the object specification and checksums,
-    // there is no need to resend it.
-    request.clear_insert_object_spec();
-    request.clear_object_checksums();
-
-    next_expected_ += n;
-    return true;
+    // Do not wait for the service after each message, the stream provides
+    // flow control, and the data is retained until it is known to be
+    // persisted.
+    return WriteMessage(std::move(content), next_expected_,
+                        final_chunk && !has_more);
   };
 
   do {
@@ -155,16 +159,87 @@ StatusOr<ResumableUploadResponse> GrpcResumableUploadSession::UploadGeneric(
       {}, next_expected_ - 1, {}, ResumableUploadResponse::kInProgress, {}};
 }
 
-void GrpcResumableUploadSession::CreateUploadWriter() {
-  if (upload_writer_) {
-    return;
-  }
+bool GrpcResumableUploadSession::CreateUploadWriter() {
+  if (upload_writer_) return true;
   // TODO(#4216) - set the timeout
   upload_context_ = absl::make_unique<grpc::ClientContext>();
-  google::storage::v1::InsertObjectRequest request;
-  request.set_upload_id(session_id_params_.upload_id);
   upload_writer_ =
       client_->CreateUploadWriter(*upload_context_, upload_object_);
+
+  // Replay any data lost with the previous stream, starting from the last
+  // persisted offset.
+  auto offset = persisted_;
+  for (auto const& p : pending_) {
+    google::storage::v1::InsertObjectRequest request;
+    request.set_upload_id(session_id_params_.upload_id);
+    request.set_write_offset(offset);
+    auto& data = *request.mutable_checksummed_data();
+    data.set_content(p);
+    data.mutable_crc32c()->set_value(crc32c::Crc32c(p));
+    if (!upload_writer_->Write(request, grpc::WriteOptions())) return false;
+    offset += p.size();
+  }
+  return true;
+}
+
+bool GrpcResumableUploadSession::WriteMessage(std::string content,
+                                              std::uint64_t offset,
+                                              bool final_message) {
+  google::storage::v1::InsertObjectRequest request;
+  request.set_upload_id(session_id_params_.upload_id);
+  request.set_write_offset(offset);
+  request.set_finish_write(false);
+
+  auto& data = *request.mutable_checksummed_data();
+  auto const n = content.size();
+  data.set_content(std::move(content));
+  data.mutable_crc32c()->set_value(crc32c::Crc32c(data.content()));
+
+  auto options = grpc::WriteOptions();
+  if (final_message) {
+    // At this point we can set the full object checksums, there are two bugs
+    // for this:
+    // TODO(#4156) - compute the crc32c value inline
+    // TODO(#4157) - compute the MD5 hash value inline
+    request.set_finish_write(true);
+    options.set_last_message();
+  }
+
+  if (!upload_writer_->Write(request, options)) return false;
+
+  next_expected_ += n;
+  if (n != 0) pending_.push_back(std::move(*data.mutable_content()));
+  bytes_since_checkpoint_ += n;
+  if (!final_message && bytes_since_checkpoint_ >= checkpoint_interval_) {
+    Checkpoint();
+  }
+  return true;
+}
+
+void GrpcResumableUploadSession::Checkpoint() {
+  bytes_since_checkpoint_ = 0;
+  auto response = client_->QueryResumableUpload(
+      QueryResumableUploadRequest(session_id_params_.upload_id));
+  // On errors keep the data, the next checkpoint or ResetSession() will
+  // release it.
+  if (!response) return;
+  DiscardPersisted(
+      (std::min)(NextExpectedByte(*response), next_expected_));
+}
+
+void GrpcResumableUploadSession::DiscardPersisted(std::uint64_t persisted) {
+  while (!pending_.empty() && persisted_ < persisted) {
+    auto& front = pending_.front();
+    auto const n = persisted - persisted_;
+    if (n < front.size()) {
+      front.erase(0, static_cast<std::size_t>(n));
+      persisted_ = persisted;
+      break;
+    }
+    persisted_ += front.size();
+    pending_.pop_front();
+  }
+  persisted_ = (std::max)(persisted_, persisted);
 }
 
 StatusOr<ResumableUploadResponse>
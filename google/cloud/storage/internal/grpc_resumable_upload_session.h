@@ -19,18 +19,33 @@
 #include "google/cloud/storage/internal/grpc_resumable_upload_session_url.h"
 #include "google/cloud/storage/internal/resumable_upload_session.h"
 #include "google/cloud/storage/version.h"
+#include <deque>
+#include <string>
 
 namespace google {
 namespace cloud {
 namespace storage {
 inline namespace STORAGE_CLIENT_NS {
 namespace internal {
-/// Implements the ResumableUploadSession interface for a gRPC client.
+/**
+ * Implements the ResumableUploadSession interface for a gRPC client.
+ *
+ * The session keeps a single streaming RPC open for the whole upload, and
+ * pipelines the data without waiting for the service after each chunk. The
+ * data written to the stream, but not yet known to be persisted, is retained
+ * so it can be replayed on a new stream if the current one fails. The session
+ * queries the persisted size after every @p checkpoint_interval bytes, to
+ * release the retained data, and on `ResetSession()`, to resume from the last
+ * persisted offset.
+ */
 class GrpcResumableUploadSession : public ResumableUploadSession {
  public:
+  static std::size_t constexpr kDefaultCheckpointInterval = 32 * 1024 * 1024L;
+
   explicit GrpcResumableUploadSession(
       std::shared_ptr<GrpcClient> client,
-      ResumableUploadSessionGrpcParams session_id_params);
+      ResumableUploadSessionGrpcParams session_id_params,
+      std::size_t checkpoint_interval = kDefaultCheckpointInterval);
 
   StatusOr<ResumableUploadResponse> UploadChunk(
       ConstBufferSequence const& payload) override;
@@ -57,7 +72,18 @@ class GrpcResumableUploadSession : public ResumableUploadSession {
   StatusOr<ResumableUploadResponse> UploadGeneric(ConstBufferSequence buffers,
                                                   bool final_chunk);
 
-  void CreateUploadWriter();
+  /// Creates a new stream if needed, replaying any unpersisted data.
+  bool CreateUploadWriter();
+
+  /// Writes a single message with @p content at @p offset.
+  bool WriteMessage(std::string content, std::uint64_t offset,
+                    bool final_message);
+
+  /// Queries the persisted size and releases the data up to that point.
+  void Checkpoint();
+
+  /// Releases the retained data before @p persisted.
+  void DiscardPersisted(std::uint64_t persisted);
 
   StatusOr<ResumableUploadResponse> HandleWriteError();
 
@@ -70,6 +96,13 @@ class GrpcResumableUploadSession : public ResumableUploadSession {
   google::storage::v1::Object upload_object_;
   std::unique_ptr<UploadWriter> upload_writer_;
 
+  std::size_t checkpoint_interval_;
+  std::size_t bytes_since_checkpoint_ = 0;
+  // The data in [persisted_, next_expected_), written to some stream but not
+  // yet known to be persisted by the service.
+  std::uint64_t persisted_ = 0;
+  std::deque<std::string> pending_;
+
   std::uint64_t next_expected_ = 0;
   bool done_ = false;
   StatusOr<ResumableUploadResponse> last_response_;
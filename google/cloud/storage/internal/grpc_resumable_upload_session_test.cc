@@ -293,6 +293,121 @@ TEST(GrpcResumableUploadSessionTest, ResumeFromEmpty) {
   EXPECT_TRUE(session.done());
 }
 
+TEST(GrpcResumableUploadSessionTest, ReplayUnpersistedData) {
+  auto mock = MockGrpcClient::Create();
+  GrpcResumableUploadSession session(
+      mock, {"test-bucket", "test-object", "test-upload-id"});
+
+  std::string const p0 = "0123456789";
+  std::string const p1 = "abcdefghij";
+  std::string const p2 = "ABCDEFGHIJ";
+  auto const size = p0.size();
+
+  using google::storage::v1::InsertObjectRequest;
+  EXPECT_CALL(*mock, CreateUploadWriter(_, _))
+      .WillOnce([&](grpc::ClientContext&, google::storage::v1::Object&) {
+        auto writer = absl::make_unique<MockGrpcUploadWriter>();
+        EXPECT_CALL(*writer, Write(_, _))
+            .WillOnce(Return(true))
+            .WillOnce(Return(true))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*writer, Finish())
+            .WillOnce(Return(
+                grpc::Status(grpc::StatusCode::UNAVAILABLE, "try again")));
+        return std::unique_ptr<GrpcClient::UploadWriter>(writer.release());
+      })
+      .WillOnce([&](grpc::ClientContext&, google::storage::v1::Object&) {
+        auto writer = absl::make_unique<MockGrpcUploadWriter>();
+        // The new stream starts with the data that was not persisted.
+        EXPECT_CALL(*writer, Write(_, _))
+            .WillOnce([&](InsertObjectRequest const& r,
+                          grpc::WriteOptions const&) {
+              EXPECT_EQ(p1, r.checksummed_data().content());
+              EXPECT_EQ(size, r.write_offset());
+              EXPECT_FALSE(r.finish_write());
+              return true;
+            })
+            .WillOnce([&](InsertObjectRequest const& r,
+                          grpc::WriteOptions const&) {
+              EXPECT_EQ(p2, r.checksummed_data().content());
+              EXPECT_EQ(2 * size, r.write_offset());
+              EXPECT_TRUE(r.finish_write());
+              return true;
+            });
+        EXPECT_CALL(*writer, Finish()).WillOnce(Return(grpc::Status::OK));
+        return std::unique_ptr<GrpcClient::UploadWriter>(writer.release());
+      });
+  EXPECT_CALL(*mock, QueryResumableUpload(_))
+      .WillOnce(Return(make_status_or(ResumableUploadResponse{
+          {}, size - 1, {}, ResumableUploadResponse::kInProgress, {}})));
+
+  ASSERT_STATUS_OK(session.UploadChunk({{p0}}));
+  ASSERT_STATUS_OK(session.UploadChunk({{p1}}));
+  EXPECT_EQ(2 * size, session.next_expected_byte());
+  EXPECT_THAT(session.UploadFinalChunk({{p2}}, 3 * size),
+              StatusIs(StatusCode::kUnavailable));
+
+  // Only the first chunk was persisted, but the session retained the second
+  // one, so the upload resumes without going backwards.
+  ASSERT_STATUS_OK(session.ResetSession());
+  EXPECT_EQ(2 * size, session.next_expected_byte());
+
+  auto upload = session.UploadFinalChunk({{p2}}, 3 * size);
+  ASSERT_STATUS_OK(upload);
+  EXPECT_EQ(3 * size - 1, upload->last_committed_byte);
+  EXPECT_TRUE(session.done());
+}
+
+TEST(GrpcResumableUploadSessionTest, CheckpointReleasesPersistedData) {
+  auto mock = MockGrpcClient::Create();
+  std::string const payload = "test payload";
+  auto const size = payload.size();
+  GrpcResumableUploadSession session(
+      mock, {"test-bucket", "test-object", "test-upload-id"}, 2 * size);
+
+  using google::storage::v1::InsertObjectRequest;
+  EXPECT_CALL(*mock, CreateUploadWriter(_, _))
+      .WillOnce([&](grpc::ClientContext&, google::storage::v1::Object&) {
+        auto writer = absl::make_unique<MockGrpcUploadWriter>();
+        EXPECT_CALL(*writer, Write(_, _))
+            .WillOnce(Return(true))
+            .WillOnce(Return(true))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*writer, Finish())
+            .WillOnce(Return(
+                grpc::Status(grpc::StatusCode::UNAVAILABLE, "try again")));
+        return std::unique_ptr<GrpcClient::UploadWriter>(writer.release());
+      })
+      .WillOnce([&](grpc::ClientContext&, google::storage::v1::Object&) {
+        auto writer = absl::make_unique<MockGrpcUploadWriter>();
+        // The checkpoint released the persisted data, nothing is replayed.
+        EXPECT_CALL(*writer, Write(_, _))
+            .WillOnce([&](InsertObjectRequest const& r,
+                          grpc::WriteOptions const&) {
+              EXPECT_EQ(payload, r.checksummed_data().content());
+              EXPECT_EQ(2 * size, r.write_offset());
+              return true;
+            });
+        return std::unique_ptr<GrpcClient::UploadWriter>(writer.release());
+      });
+  ResumableUploadResponse const persisted{
+      {}, 2 * size - 1, {}, ResumableUploadResponse::kInProgress, {}};
+  EXPECT_CALL(*mock, QueryResumableUpload(_))
+      .Times(2)
+      .WillRepeatedly(Return(make_status_or(persisted)));
+
+  // The second chunk reaches the checkpoint interval.
+  ASSERT_STATUS_OK(session.UploadChunk({{payload}}));
+  ASSERT_STATUS_OK(session.UploadChunk({{payload}}));
+  EXPECT_THAT(session.UploadChunk({{payload}}),
+              StatusIs(StatusCode::kUnavailable));
+
+  ASSERT_STATUS_OK(session.ResetSession());
+  EXPECT_EQ(2 * size, session.next_expected_byte());
+  ASSERT_STATUS_OK(session.UploadChunk({{payload}}));
+  EXPECT_EQ(3 * size, session.next_expected_byte());
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
@@ -0,0 +1,198 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/gzip_object_read_source.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+GzipObjectReadSource::GzipObjectReadSource(
+    std::unique_ptr<ObjectReadSource> child,
+    std::unique_ptr<HashValidator> hash_validator, std::size_t buffer_size,
+    std::shared_ptr<BufferPool> buffer_pool)
+    : child_(std::move(child)),
+      hash_validator_(std::move(hash_validator)),
+      buffer_size_(buffer_size),
+      buffer_pool_(std::move(buffer_pool)),
+      stream_() {}
+
+GzipObjectReadSource::~GzipObjectReadSource() {
+  if (stream_initialized_) inflateEnd(&stream_);
+}
+
+bool GzipObjectReadSource::IsOpen() const {
+  if (mode_ != Mode::kInflate) return child_->IsOpen();
+  return child_->IsOpen() || stream_.avail_in != 0 || output_pending_;
+}
+
+StatusOr<HttpResponse> GzipObjectReadSource::Close() {
+  return child_->Close();
+}
+
+StatusOr<ReadSourceResult> GzipObjectReadSource::Read(char* buf,
+                                                      std::size_t n) {
+  if (mode_ == Mode::kPassThrough) return ReadPassThrough(buf, n);
+  if (mode_ == Mode::kInflate) {
+    return Inflate(buf, n, HttpResponse{HttpStatusCode::kContinue, {}, {}});
+  }
+
+  // The headers in the first response determine if the data is compressed.
+  auto r = child_->Read(buf, n);
+  if (!r) return r;
+  ProcessHeaders(r->response);
+  if (r->response.status_code >= HttpStatusCode::kMinNotSuccess) return r;
+  if (mode_ != Mode::kInflate) {
+    if (r->response.headers.empty() && r->bytes_received == 0) return r;
+    mode_ = Mode::kPassThrough;
+    hash_validator_->Update(buf, r->bytes_received);
+    if (!child_->IsOpen()) {
+      auto status = FinishHashValidation();
+      if (!status.ok()) return status;
+    }
+    return r;
+  }
+
+  if (inflateInit2(&stream_, 16 + MAX_WBITS) != Z_OK) {
+    return Status(StatusCode::kInternal,
+                  "cannot initialize zlib stream for decompression");
+  }
+  stream_initialized_ = true;
+  // The data received so far is compressed, move it to the input buffer and
+  // decompress it into `buf`.
+  input_ = PooledBuffer(buffer_pool_, (std::max)(buffer_size_, n));
+  std::memcpy(input_.data(), buf, r->bytes_received);
+  hash_validator_->Update(input_.data(), r->bytes_received);
+  stream_.next_in = reinterpret_cast<Bytef*>(input_.data());
+  stream_.avail_in = static_cast<uInt>(r->bytes_received);
+  if (r->response.status_code != HttpStatusCode::kContinue) {
+    final_status_code_ = r->response.status_code;
+  }
+  return Inflate(buf, n, std::move(r->response));
+}
+
+void GzipObjectReadSource::ProcessHeaders(HttpResponse const& response) {
+  for (auto const& kv : response.headers) {
+    hash_validator_->ProcessHeader(kv.first, kv.second);
+    if (mode_ == Mode::kUnknown && kv.first == "content-encoding" &&
+        kv.second.find("gzip") != std::string::npos) {
+      mode_ = Mode::kInflate;
+    }
+  }
+}
+
+Status GzipObjectReadSource::FinishHashValidation() {
+  if (validated_) return {};
+  validated_ = true;
+  auto result = std::move(*hash_validator_).Finish();
+  if (!result.is_mismatch) return {};
+  std::string msg = __func__;
+  msg += "(): mismatched hashes in download";
+  msg += ", computed=";
+  msg += result.computed;
+  msg += ", received=";
+  msg += result.received;
+  return Status(StatusCode::kDataLoss, std::move(msg));
+}
+
+StatusOr<ReadSourceResult> GzipObjectReadSource::ReadPassThrough(
+    char* buf, std::size_t n) {
+  auto r = child_->Read(buf, n);
+  if (!r) return r;
+  ProcessHeaders(r->response);
+  if (r->response.status_code >= HttpStatusCode::kMinNotSuccess) return r;
+  hash_validator_->Update(buf, r->bytes_received);
+  if (!child_->IsOpen()) {
+    auto status = FinishHashValidation();
+    if (!status.ok()) return status;
+  }
+  return r;
+}
+
+StatusOr<ReadSourceResult> GzipObjectReadSource::Inflate(
+    char* buf, std::size_t n, HttpResponse response) {
+  auto const capacity = static_cast<uInt>(
+      (std::min)(n, static_cast<std::size_t>(
+                        (std::numeric_limits<uInt>::max)())));
+  stream_.next_out = reinterpret_cast<Bytef*>(buf);
+  stream_.avail_out = capacity;
+  while (stream_.avail_out != 0) {
+    if (stream_.avail_in == 0 && !output_pending_) {
+      // Return any decompressed data before blocking for more input.
+      if (stream_.avail_out != capacity || !child_->IsOpen()) break;
+      auto r = child_->Read(input_.data(), input_.size());
+      if (!r) return std::move(r).status();
+      ProcessHeaders(r->response);
+      response.headers.insert(r->response.headers.begin(),
+                              r->response.headers.end());
+      if (r->response.status_code >= HttpStatusCode::kMinNotSuccess) {
+        r->bytes_received = 0;
+        r->response.headers = std::move(response.headers);
+        return r;
+      }
+      if (r->response.status_code != HttpStatusCode::kContinue) {
+        final_status_code_ = r->response.status_code;
+      }
+      hash_validator_->Update(input_.data(), r->bytes_received);
+      stream_.next_in = reinterpret_cast<Bytef*>(input_.data());
+      stream_.avail_in = static_cast<uInt>(r->bytes_received);
+      continue;
+    }
+    if (at_member_end_) {
+      // More data after the end of a gzip member, it must be another member.
+      inflateReset(&stream_);
+      at_member_end_ = false;
+    }
+    auto const rc = inflate(&stream_, Z_NO_FLUSH);
+    output_pending_ = rc == Z_OK && stream_.avail_out == 0;
+    if (rc == Z_STREAM_END) {
+      at_member_end_ = true;
+      continue;
+    }
+    // Z_BUF_ERROR indicates that no progress was possible, more input is
+    // needed.
+    if (rc == Z_OK || rc == Z_BUF_ERROR) continue;
+    std::string msg = __func__;
+    msg += "(): error decompressing download";
+    if (stream_.msg != nullptr) {
+      msg += ": ";
+      msg += stream_.msg;
+    }
+    return Status(StatusCode::kDataLoss, std::move(msg));
+  }
+
+  auto const received = static_cast<std::size_t>(capacity - stream_.avail_out);
+  response.status_code = HttpStatusCode::kContinue;
+  if (!IsOpen()) {
+    if (!at_member_end_) {
+      return Status(StatusCode::kDataLoss,
+                    std::string(__func__) + "(): truncated gzip data");
+    }
+    auto status = FinishHashValidation();
+    if (!status.ok()) return status;
+    response.status_code = final_status_code_;
+  }
+  return ReadSourceResult{received, std::move(response)};
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,99 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GZIP_OBJECT_READ_SOURCE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GZIP_OBJECT_READ_SOURCE_H
+
+#include "google/cloud/storage/internal/hash_validator.h"
+#include "google/cloud/storage/internal/object_read_source.h"
+#include "google/cloud/storage/internal/pooled_buffer.h"
+#include "google/cloud/storage/version.h"
+#include <zlib.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Decompresses a download of a gzip-encoded object.
+ *
+ * The data is only decompressed if the response includes a
+ * `Content-Encoding: gzip` header, otherwise it is returned unmodified. That
+ * happens if the service applied decompressive transcoding, or if the object
+ * is not compressed.
+ *
+ * The checksums in the response headers are for the data as stored in the
+ * service, so this class validates them (using @p hash_validator) before
+ * decompressing the data. The `ObjectReadStreambuf` using this source should
+ * not validate the checksums again. A mismatch is reported as a `kDataLoss`
+ * error once the download completes.
+ */
+class GzipObjectReadSource : public ObjectReadSource {
+ public:
+  GzipObjectReadSource(
+      std::unique_ptr<ObjectReadSource> child,
+      std::unique_ptr<HashValidator> hash_validator, std::size_t buffer_size,
+      std::shared_ptr<BufferPool> buffer_pool = DefaultBufferPool());
+  ~GzipObjectReadSource() override;
+
+  GzipObjectReadSource(GzipObjectReadSource const&) = delete;
+  GzipObjectReadSource& operator=(GzipObjectReadSource const&) = delete;
+
+  bool IsOpen() const override;
+  StatusOr<HttpResponse> Close() override;
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override;
+
+ private:
+  enum class Mode { kUnknown, kPassThrough, kInflate };
+
+  /// Update the hash validator and the mode using the response headers.
+  void ProcessHeaders(HttpResponse const& response);
+
+  /// Validate the checksums once the download completes.
+  Status FinishHashValidation();
+
+  StatusOr<ReadSourceResult> ReadPassThrough(char* buf, std::size_t n);
+  StatusOr<ReadSourceResult> Inflate(char* buf, std::size_t n,
+                                     HttpResponse response);
+
+  std::unique_ptr<ObjectReadSource> child_;
+  std::unique_ptr<HashValidator> hash_validator_;
+  std::size_t buffer_size_;
+  std::shared_ptr<BufferPool> buffer_pool_;
+  Mode mode_ = Mode::kUnknown;
+  bool validated_ = false;
+
+  // The compressed data received from `child_`, only used in `kInflate` mode.
+  PooledBuffer input_;
+  z_stream stream_;
+  bool stream_initialized_ = false;
+  // True before the first gzip member and after each member is complete. The
+  // data may contain more than one member.
+  bool at_member_end_ = true;
+  // True if `inflate()` may have more output without any additional input.
+  bool output_pending_ = false;
+  // NOLINTNEXTLINE(google-runtime-int)
+  long final_status_code_ = HttpStatusCode::kContinue;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GZIP_OBJECT_READ_SOURCE_H
@@ -0,0 +1,198 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/gzip_object_read_source.h"
+#include "google/cloud/storage/hashing_options.h"
+#include "google/cloud/storage/internal/hash_validator_impl.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+
+/// Returns the contents in small pieces, with @p headers in the first piece.
+class FakeReadSource : public ObjectReadSource {
+ public:
+  FakeReadSource(std::string const& contents, std::size_t piece_size,
+                 std::multimap<std::string, std::string> headers)
+      : headers_(std::move(headers)) {
+    for (std::size_t offset = 0; offset < contents.size();
+         offset += piece_size) {
+      pieces_.push_back(contents.substr(offset, piece_size));
+    }
+  }
+
+  bool IsOpen() const override { return !pieces_.empty() || !headers_sent_; }
+  StatusOr<HttpResponse> Close() override {
+    return HttpResponse{HttpStatusCode::kOk, {}, {}};
+  }
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override {
+    HttpResponse response{HttpStatusCode::kContinue, {}, {}};
+    if (!headers_sent_) response.headers = headers_;
+    headers_sent_ = true;
+    std::size_t size = 0;
+    if (!pieces_.empty()) {
+      auto& p = pieces_.front();
+      size = (std::min)(n, p.size());
+      std::memcpy(buf, p.data(), size);
+      p.erase(0, size);
+      if (p.empty()) pieces_.pop_front();
+    }
+    if (pieces_.empty()) response.status_code = HttpStatusCode::kOk;
+    return ReadSourceResult{size, std::move(response)};
+  }
+
+ private:
+  std::deque<std::string> pieces_;
+  std::multimap<std::string, std::string> headers_;
+  bool headers_sent_ = false;
+};
+
+std::string Compress(std::string const& data) {
+  z_stream stream{};
+  EXPECT_EQ(Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                               16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY));
+  std::string compressed(deflateBound(&stream, data.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  EXPECT_EQ(Z_STREAM_END, deflate(&stream, Z_FINISH));
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return compressed;
+}
+
+std::string MakeContents() {
+  std::string contents;
+  for (int i = 0; i != 2000; ++i) {
+    contents += "line " + std::to_string(i) + ": the quick brown fox\n";
+  }
+  return contents;
+}
+
+StatusOr<std::string> ReadAll(ObjectReadSource& source, std::size_t n) {
+  std::string result;
+  std::vector<char> buffer(n);
+  while (source.IsOpen()) {
+    auto r = source.Read(buffer.data(), buffer.size());
+    if (!r) return std::move(r).status();
+    result.append(buffer.data(), r->bytes_received);
+  }
+  return result;
+}
+
+TEST(GzipObjectReadSourceTest, Decompress) {
+  auto const contents = MakeContents();
+  auto const compressed = Compress(contents);
+  ASSERT_LT(compressed.size(), contents.size());
+
+  for (std::size_t piece : {std::size_t{7}, std::size_t{1024}}) {
+    for (std::size_t n : {std::size_t{16}, std::size_t{64 * 1024}}) {
+      SCOPED_TRACE("piece=" + std::to_string(piece) +
+                   ", n=" + std::to_string(n));
+      GzipObjectReadSource tested(
+          absl::make_unique<FakeReadSource>(
+              compressed, piece,
+              std::multimap<std::string, std::string>{
+                  {"content-encoding", "gzip"},
+                  {"x-goog-hash",
+                   "crc32c=" + ComputeCrc32cChecksum(compressed)}}),
+          absl::make_unique<Crc32cHashValidator>(), 1024);
+      auto actual = ReadAll(tested, n);
+      ASSERT_STATUS_OK(actual);
+      EXPECT_EQ(contents, *actual);
+    }
+  }
+}
+
+TEST(GzipObjectReadSourceTest, MultipleMembers) {
+  auto const contents = MakeContents();
+  GzipObjectReadSource tested(
+      absl::make_unique<FakeReadSource>(
+          Compress(contents) + Compress(contents), 512,
+          std::multimap<std::string, std::string>{
+              {"content-encoding", "gzip"}}),
+      absl::make_unique<NullHashValidator>(), 1024);
+  auto actual = ReadAll(tested, 4096);
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(contents + contents, *actual);
+}
+
+/// @test Verify objects transcoded by the service are not modified.
+TEST(GzipObjectReadSourceTest, PassThrough) {
+  auto const contents = MakeContents();
+  GzipObjectReadSource tested(
+      absl::make_unique<FakeReadSource>(
+          contents, 1000,
+          std::multimap<std::string, std::string>{
+              {"x-goog-hash", "crc32c=" + ComputeCrc32cChecksum(contents)}}),
+      absl::make_unique<Crc32cHashValidator>(), 1024);
+  auto actual = ReadAll(tested, 4096);
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(contents, *actual);
+}
+
+TEST(GzipObjectReadSourceTest, HashMismatch) {
+  auto const compressed = Compress(MakeContents());
+  GzipObjectReadSource tested(
+      absl::make_unique<FakeReadSource>(
+          compressed, 1000,
+          std::multimap<std::string, std::string>{
+              {"content-encoding", "gzip"},
+              {"x-goog-hash", "crc32c=" + ComputeCrc32cChecksum("bad")}}),
+      absl::make_unique<Crc32cHashValidator>(), 1024);
+  EXPECT_THAT(ReadAll(tested, 4096), StatusIs(StatusCode::kDataLoss));
+}
+
+TEST(GzipObjectReadSourceTest, Truncated) {
+  auto compressed = Compress(MakeContents());
+  compressed.resize(compressed.size() / 2);
+  GzipObjectReadSource tested(
+      absl::make_unique<FakeReadSource>(
+          compressed, 1000,
+          std::multimap<std::string, std::string>{
+              {"content-encoding", "gzip"}}),
+      absl::make_unique<NullHashValidator>(), 1024);
+  EXPECT_THAT(ReadAll(tested, 4096), StatusIs(StatusCode::kDataLoss));
+}
+
+TEST(GzipObjectReadSourceTest, CorruptData) {
+  GzipObjectReadSource tested(
+      absl::make_unique<FakeReadSource>(
+          std::string(1000, 'x'), 100,
+          std::multimap<std::string, std::string>{
+              {"content-encoding", "gzip"}}),
+      absl::make_unique<NullHashValidator>(), 1024);
+  EXPECT_THAT(ReadAll(tested, 4096), StatusIs(StatusCode::kDataLoss));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,159 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/gzip_object_write_streambuf.h"
+#include <algorithm>
+#include <limits>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+GzipObjectWriteStreambuf::GzipObjectWriteStreambuf(
+    std::unique_ptr<ObjectWriteStreambuf> child, int compression_level,
+    std::size_t buffer_size, std::shared_ptr<BufferPool> buffer_pool)
+    : child_(std::move(child)),
+      input_(buffer_pool, buffer_size),
+      output_(std::move(buffer_pool), buffer_size),
+      stream_() {
+  // Adding 16 to the window bits produces a gzip header and trailer.
+  auto const rc =
+      deflateInit2(&stream_, compression_level, Z_DEFLATED, 16 + MAX_WBITS,
+                   /*memLevel=*/8, Z_DEFAULT_STRATEGY);
+  if (rc != Z_OK) {
+    status_ = Status(StatusCode::kInvalidArgument,
+                     "cannot initialize zlib stream with compression level " +
+                         std::to_string(compression_level));
+    return;
+  }
+  stream_initialized_ = true;
+  setp(input_.data(), input_.data() + input_.size());
+}
+
+GzipObjectWriteStreambuf::~GzipObjectWriteStreambuf() {
+  if (stream_initialized_) deflateEnd(&stream_);
+}
+
+StatusOr<ResumableUploadResponse> GzipObjectWriteStreambuf::Close() {
+  if (!closed_ && status_.ok()) {
+    DeflatePutArea(Z_FINISH);
+    WriteOutput();
+  }
+  closed_ = true;
+  if (!status_.ok()) return status_;
+  return child_->Close();
+}
+
+bool GzipObjectWriteStreambuf::IsOpen() const {
+  return !closed_ && status_.ok() && child_->IsOpen();
+}
+
+bool GzipObjectWriteStreambuf::ValidateHash(ObjectMetadata const& meta) {
+  return child_->ValidateHash(meta);
+}
+
+Status GzipObjectWriteStreambuf::last_status() const {
+  if (!status_.ok()) return status_;
+  return child_->last_status();
+}
+
+int GzipObjectWriteStreambuf::sync() {
+  if (!IsOpen()) return traits_type::eof();
+  DeflatePutArea(Z_NO_FLUSH);
+  WriteOutput();
+  if (!status_.ok()) return traits_type::eof();
+  return child_->pubsync();
+}
+
+std::streamsize GzipObjectWriteStreambuf::xsputn(char const* s,
+                                                 std::streamsize count) {
+  if (!IsOpen()) return traits_type::eof();
+  auto const n = static_cast<std::size_t>(count);
+  if (n < static_cast<std::size_t>(epptr() - pptr())) {
+    std::copy(s, s + n, pptr());
+    pbump(static_cast<int>(count));
+    return count;
+  }
+  // Compress the data directly from the application buffer, there is no need
+  // to copy it into the put area.
+  DeflatePutArea(Z_NO_FLUSH);
+  Deflate(s, n, Z_NO_FLUSH);
+  return status_.ok() ? count : traits_type::eof();
+}
+
+GzipObjectWriteStreambuf::int_type GzipObjectWriteStreambuf::overflow(
+    int_type ch) {
+  // For ch == EOF this function must do nothing and return any value != EOF.
+  if (traits_type::eq_int_type(ch, traits_type::eof())) return 0;
+  if (!IsOpen()) return traits_type::eof();
+  if (pptr() == epptr()) DeflatePutArea(Z_NO_FLUSH);
+  if (!status_.ok()) return traits_type::eof();
+  *pptr() = traits_type::to_char_type(ch);
+  pbump(1);
+  return ch;
+}
+
+void GzipObjectWriteStreambuf::Deflate(char const* data, std::size_t n,
+                                       int flush) {
+  auto constexpr kMaxInput = (std::numeric_limits<uInt>::max)();
+  // zlib uses `unsigned int` for sizes, larger inputs are compressed in
+  // pieces.
+  while (status_.ok()) {
+    auto const input_size = (std::min)(n, static_cast<std::size_t>(kMaxInput));
+    auto const piece_flush = input_size == n ? flush : Z_NO_FLUSH;
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream_.avail_in = static_cast<uInt>(input_size);
+    int rc;
+    do {
+      if (output_size_ == output_.size()) WriteOutput();
+      if (!status_.ok()) return;
+      stream_.next_out = reinterpret_cast<Bytef*>(output_.data() + output_size_);
+      stream_.avail_out = static_cast<uInt>(output_.size() - output_size_);
+      rc = deflate(&stream_, piece_flush);
+      output_size_ = output_.size() - stream_.avail_out;
+      if (rc == Z_STREAM_ERROR) {
+        status_ = Status(StatusCode::kInternal, "error compressing data");
+        return;
+      }
+    } while (stream_.avail_in != 0 ||
+             (piece_flush == Z_FINISH && rc != Z_STREAM_END));
+    data += input_size;
+    n -= input_size;
+    if (n == 0) return;
+  }
+}
+
+void GzipObjectWriteStreambuf::DeflatePutArea(int flush) {
+  Deflate(pbase(), static_cast<std::size_t>(pptr() - pbase()), flush);
+  setp(input_.data(), input_.data() + input_.size());
+}
+
+void GzipObjectWriteStreambuf::WriteOutput() {
+  if (output_size_ == 0 || !status_.ok()) return;
+  auto const expected = static_cast<std::streamsize>(output_size_);
+  output_size_ = 0;
+  if (child_->sputn(output_.data(), expected) == expected) return;
+  status_ = child_->last_status();
+  if (status_.ok()) {
+    status_ = Status(StatusCode::kUnknown, "error writing compressed data");
+  }
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
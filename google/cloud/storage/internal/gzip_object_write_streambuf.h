@@ -0,0 +1,96 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GZIP_OBJECT_WRITE_STREAMBUF_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GZIP_OBJECT_WRITE_STREAMBUF_H
+
+#include "google/cloud/storage/internal/object_streambuf.h"
+#include "google/cloud/storage/internal/pooled_buffer.h"
+#include "google/cloud/storage/version.h"
+#include <zlib.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Compresses the data written to an `ObjectWriteStream` using gzip.
+ *
+ * The application writes into a buffer of @p buffer_size bytes, when this
+ * buffer is full its contents are compressed into a second buffer of the same
+ * size, and the compressed data is written to @p child, which uploads it. The
+ * hashes are computed by @p child, over the compressed data.
+ */
+class GzipObjectWriteStreambuf : public ObjectWriteStreambuf {
+ public:
+  GzipObjectWriteStreambuf(
+      std::unique_ptr<ObjectWriteStreambuf> child, int compression_level,
+      std::size_t buffer_size,
+      std::shared_ptr<BufferPool> buffer_pool = DefaultBufferPool());
+
+  ~GzipObjectWriteStreambuf() override;
+
+  StatusOr<ResumableUploadResponse> Close() override;
+  bool IsOpen() const override;
+  bool ValidateHash(ObjectMetadata const& meta) override;
+
+  std::string const& received_hash() const override {
+    return child_->received_hash();
+  }
+  std::string const& computed_hash() const override {
+    return child_->computed_hash();
+  }
+  std::string const& resumable_session_id() const override {
+    return child_->resumable_session_id();
+  }
+  std::uint64_t next_expected_byte() const override {
+    return child_->next_expected_byte();
+  }
+  Status last_status() const override;
+
+ protected:
+  int sync() override;
+  std::streamsize xsputn(char const* s, std::streamsize count) override;
+  int_type overflow(int_type ch) override;
+
+ private:
+  /// Compress @p n bytes starting at @p data, using @p flush for `deflate()`.
+  void Deflate(char const* data, std::size_t n, int flush);
+
+  /// Compress the data in the put area and reset it.
+  void DeflatePutArea(int flush);
+
+  /// Write the compressed data to `child_`.
+  void WriteOutput();
+
+  std::unique_ptr<ObjectWriteStreambuf> child_;
+  PooledBuffer input_;
+  PooledBuffer output_;
+  std::size_t output_size_ = 0;
+  z_stream stream_;
+  bool stream_initialized_ = false;
+  bool closed_ = false;
+  Status status_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_GZIP_OBJECT_WRITE_STREAMBUF_H
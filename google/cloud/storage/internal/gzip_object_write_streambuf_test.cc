@@ -0,0 +1,195 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/gzip_object_write_streambuf.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <zlib.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+auto constexpr kQuantum = UploadChunkRequest::kChunkSizeQuantum;
+
+std::string Decompress(std::string const& data) {
+  z_stream stream{};
+  EXPECT_EQ(Z_OK, inflateInit2(&stream, 16 + MAX_WBITS));
+  std::string result;
+  std::vector<char> buffer(4096);
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  int rc;
+  do {
+    stream.next_out = reinterpret_cast<Bytef*>(buffer.data());
+    stream.avail_out = static_cast<uInt>(buffer.size());
+    rc = inflate(&stream, Z_NO_FLUSH);
+    EXPECT_TRUE(rc == Z_OK || rc == Z_STREAM_END) << "rc=" << rc;
+    result.append(buffer.data(), buffer.size() - stream.avail_out);
+  } while (rc == Z_OK);
+  inflateEnd(&stream);
+  return result;
+}
+
+std::string MakeContents() {
+  std::string contents;
+  for (int i = 0; i != 20000; ++i) {
+    contents += "line " + std::to_string(i) + ": the quick brown fox\n";
+  }
+  return contents;
+}
+
+ResumableUploadResponse InProgress(std::uint64_t next_byte) {
+  return ResumableUploadResponse{"",
+                                 next_byte == 0 ? 0 : next_byte - 1,
+                                 {},
+                                 ResumableUploadResponse::kInProgress,
+                                 {}};
+}
+
+TEST(GzipObjectWriteStreambufTest, Compress) {
+  std::string const id = "test-session-id";
+  std::string uploaded;
+  auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+  EXPECT_CALL(*mock, done).WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock, session_id).WillRepeatedly(ReturnRef(id));
+  EXPECT_CALL(*mock, next_expected_byte).WillRepeatedly([&uploaded] {
+    return uploaded.size();
+  });
+  EXPECT_CALL(*mock, UploadChunk)
+      .WillRepeatedly([&](ConstBufferSequence const& p) {
+        for (auto const& b : p) uploaded.append(b.data(), b.size());
+        return make_status_or(InProgress(uploaded.size()));
+      });
+  EXPECT_CALL(*mock, UploadFinalChunk)
+      .WillOnce([&](ConstBufferSequence const& p, std::uint64_t size) {
+        for (auto const& b : p) uploaded.append(b.data(), b.size());
+        EXPECT_EQ(uploaded.size(), size);
+        return make_status_or(InProgress(size));
+      });
+
+  auto child = absl::make_unique<ObjectWriteStreambuf>(
+      std::move(mock), kQuantum, absl::make_unique<NullHashValidator>());
+  GzipObjectWriteStreambuf tested(std::move(child), Z_DEFAULT_COMPRESSION,
+                                  kQuantum);
+  EXPECT_TRUE(tested.IsOpen());
+  EXPECT_EQ(id, tested.resumable_session_id());
+
+  // Mix large and small writes, and single characters.
+  auto const contents = MakeContents();
+  auto const piece = contents.size() / 7;
+  std::size_t offset = 0;
+  for (; offset + piece < contents.size(); offset += piece) {
+    EXPECT_EQ(static_cast<std::streamsize>(piece),
+              tested.sputn(contents.data() + offset, piece));
+    EXPECT_EQ(100, tested.sputn(contents.data() + offset + piece, 100));
+    offset += 100;
+  }
+  for (; offset != contents.size(); ++offset) {
+    EXPECT_EQ(contents[offset], tested.sputc(contents[offset]));
+  }
+  EXPECT_EQ(0, tested.pubsync());
+  auto response = tested.Close();
+  ASSERT_STATUS_OK(response);
+  EXPECT_FALSE(tested.IsOpen());
+
+  EXPECT_LT(uploaded.size(), contents.size() / 5);
+  EXPECT_EQ(contents, Decompress(uploaded));
+}
+
+TEST(GzipObjectWriteStreambufTest, EmptyStream) {
+  std::string const id = "test-session-id";
+  std::string uploaded;
+  auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+  EXPECT_CALL(*mock, done).WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock, session_id).WillRepeatedly(ReturnRef(id));
+  EXPECT_CALL(*mock, next_expected_byte).WillRepeatedly(Return(0));
+  EXPECT_CALL(*mock, UploadChunk).Times(0);
+  EXPECT_CALL(*mock, UploadFinalChunk)
+      .WillOnce([&](ConstBufferSequence const& p, std::uint64_t size) {
+        for (auto const& b : p) uploaded.append(b.data(), b.size());
+        return make_status_or(InProgress(size));
+      });
+
+  GzipObjectWriteStreambuf tested(
+      absl::make_unique<ObjectWriteStreambuf>(
+          std::move(mock), kQuantum, absl::make_unique<NullHashValidator>()),
+      Z_DEFAULT_COMPRESSION, kQuantum);
+  ASSERT_STATUS_OK(tested.Close());
+  // Even an empty stream has a gzip header and trailer.
+  EXPECT_FALSE(uploaded.empty());
+  EXPECT_EQ("", Decompress(uploaded));
+}
+
+TEST(GzipObjectWriteStreambufTest, UploadError) {
+  std::string const id = "test-session-id";
+  auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+  EXPECT_CALL(*mock, done).WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock, session_id).WillRepeatedly(ReturnRef(id));
+  EXPECT_CALL(*mock, next_expected_byte).WillRepeatedly(Return(0));
+  EXPECT_CALL(*mock, UploadChunk).WillOnce([](ConstBufferSequence const&) {
+    return StatusOr<ResumableUploadResponse>(
+        Status(StatusCode::kPermissionDenied, "uh-oh"));
+  });
+  EXPECT_CALL(*mock, UploadFinalChunk).Times(0);
+
+  GzipObjectWriteStreambuf tested(
+      absl::make_unique<ObjectWriteStreambuf>(
+          std::move(mock), kQuantum, absl::make_unique<NullHashValidator>()),
+      Z_BEST_SPEED, kQuantum);
+  // Random data does not compress, so this eventually fills the child buffer.
+  std::string data(4 * kQuantum, '\0');
+  std::uint32_t state = 12345;
+  for (auto& c : data) {
+    state = state * 1103515245U + 12345U;
+    c = static_cast<char>(state >> 24);
+  }
+  EXPECT_EQ(-1, tested.sputn(data.data(), data.size()));
+  EXPECT_FALSE(tested.IsOpen());
+  EXPECT_THAT(tested.last_status(), StatusIs(StatusCode::kPermissionDenied));
+  EXPECT_THAT(tested.Close(), StatusIs(StatusCode::kPermissionDenied));
+}
+
+TEST(GzipObjectWriteStreambufTest, InvalidLevel) {
+  std::string const id = "test-session-id";
+  auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+  EXPECT_CALL(*mock, done).WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock, UploadChunk).Times(0);
+  EXPECT_CALL(*mock, UploadFinalChunk).Times(0);
+
+  GzipObjectWriteStreambuf tested(
+      absl::make_unique<ObjectWriteStreambuf>(
+          std::move(mock), kQuantum, absl::make_unique<NullHashValidator>()),
+      42, kQuantum);
+  EXPECT_FALSE(tested.IsOpen());
+  EXPECT_EQ(-1, tested.sputc('a'));
+  EXPECT_THAT(tested.Close(), StatusIs(StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -68,6 +68,15 @@ std::unique_ptr<HashValidator> CreateHashValidator(bool disable_md5,
       absl::make_unique<MD5HashValidator>());
 }
 
+std::unique_ptr<HashValidator> CreateHashValidator(bool disable_md5,
+                                                   bool disable_crc32c,
+                                                   bool use_background) {
+  auto validator = CreateHashValidator(disable_md5, disable_crc32c);
+  // There is nothing to compute when both hashes are disabled.
+  if (!use_background || (disable_md5 && disable_crc32c)) return validator;
+  return absl::make_unique<BackgroundHashValidator>(std::move(validator));
+}
+
 std::unique_ptr<HashValidator> CreateHashValidator(
     ReadObjectRangeRequest const& request) {
   if (request.RequiresRangeHeader()) {
@@ -77,7 +86,9 @@ std::unique_ptr<HashValidator> CreateHashValidator(
   auto disable_md5 = request.GetOption<DisableMD5Hash>().value();
   auto disable_crc32c = request.HasOption<DisableCrc32cChecksum>() &&
                         request.GetOption<DisableCrc32cChecksum>().value();
-  return CreateHashValidator(disable_md5, disable_crc32c);
+  auto use_background =
+      request.GetOption<UseBackgroundHashing>().value_or(false);
+  return CreateHashValidator(disable_md5, disable_crc32c, use_background);
 }
 
 std::unique_ptr<HashValidator> CreateHashValidator(
@@ -86,7 +97,9 @@ std::unique_ptr<HashValidator> CreateHashValidator(
   auto disable_md5 = request.GetOption<DisableMD5Hash>().value();
   auto disable_crc32c = request.HasOption<DisableCrc32cChecksum>() &&
                         request.GetOption<DisableCrc32cChecksum>().value();
-  return CreateHashValidator(disable_md5, disable_crc32c);
+  auto use_background =
+      request.GetOption<UseBackgroundHashing>().value_or(false);
+  return CreateHashValidator(disable_md5, disable_crc32c, use_background);
 }
 
 }  // namespace internal
@@ -120,6 +120,9 @@ class ResumableUploadRequest;
  *
  * Specifying the option with `false` or no argument (default constructor) has
  * the same effect as not passing the option at all.
+ *
+ * If the request has the `UseBackgroundHashing(true)` option the hashes are
+ * computed on a background thread, see `BackgroundHashValidator`.
  */
 /// Create a hash validator configured by @p request.
 std::unique_ptr<HashValidator> CreateHashValidator(
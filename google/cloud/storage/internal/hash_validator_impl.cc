@@ -14,6 +14,7 @@
 
 #include "google/cloud/storage/internal/hash_validator_impl.h"
 #include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/storage/internal/stage_timer.h"
 #include "google/cloud/storage/object_metadata.h"
 #include "google/cloud/internal/big_endian.h"
 #include <crc32c/crc32c.h>
@@ -26,6 +27,7 @@ namespace internal {
 MD5HashValidator::MD5HashValidator() : context_{} { MD5_Init(&context_); }
 
 void MD5HashValidator::Update(char const* buf, std::size_t n) {
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kHashing);
   MD5_Update(&context_, buf, n);
 }
 
@@ -67,6 +69,7 @@ HashValidator::Result MD5HashValidator::Finish() && {
 }
 
 void Crc32cHashValidator::Update(char const* buf, std::size_t n) {
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kHashing);
   current_ =
       crc32c::Extend(current_, reinterpret_cast<std::uint8_t const*>(buf), n);
 }
@@ -107,6 +110,91 @@ HashValidator::Result Crc32cHashValidator::Finish() && {
   return Result{std::move(received_hash_), std::move(computed), is_mismatch};
 }
 
+std::size_t constexpr BackgroundHashValidator::kDefaultMaxPendingBytes;
+std::size_t constexpr BackgroundHashValidator::kMaxFreeBuffers;
+
+BackgroundHashValidator::BackgroundHashValidator(
+    std::unique_ptr<HashValidator> child, std::size_t max_pending_bytes)
+    : child_(std::move(child)),
+      max_pending_bytes_(max_pending_bytes),
+      worker_([this] { Run(); }) {}
+
+BackgroundHashValidator::~BackgroundHashValidator() { Shutdown(); }
+
+void BackgroundHashValidator::Update(char const* buf, std::size_t n) {
+  std::string data;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!free_buffers_.empty()) {
+      data = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+    }
+  }
+  // Copy outside the lock, `assign()` reuses the capacity of the buffer.
+  data.assign(buf, n);
+  Push(Pending{std::move(data), {}});
+}
+
+void BackgroundHashValidator::ProcessMetadata(ObjectMetadata const& meta) {
+  Push(Pending{{}, [meta](HashValidator& v) { v.ProcessMetadata(meta); }});
+}
+
+void BackgroundHashValidator::ProcessHeader(std::string const& key,
+                                            std::string const& value) {
+  Push(Pending{
+      {}, [key, value](HashValidator& v) { v.ProcessHeader(key, value); }});
+}
+
+HashValidator::Result BackgroundHashValidator::Finish() && {
+  Shutdown();
+  return std::move(*child_).Finish();
+}
+
+void BackgroundHashValidator::Push(Pending pending) {
+  auto const bytes = pending.data.size();
+  std::unique_lock<std::mutex> lk(mu_);
+  // Always accept at least one block, even if it is larger than the limit.
+  cv_.wait(lk, [&] {
+    return pending_.empty() || pending_bytes_ + bytes <= max_pending_bytes_;
+  });
+  pending_.push_back(std::move(pending));
+  pending_bytes_ += bytes;
+  cv_.notify_all();
+}
+
+void BackgroundHashValidator::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) worker_.join();
+}
+
+void BackgroundHashValidator::Run() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    cv_.wait(lk, [this] { return shutdown_ || !pending_.empty(); });
+    // Drain any pending work before shutting down, `Finish()` needs the
+    // results of all the calls to `Update()`.
+    if (pending_.empty()) return;
+    auto pending = std::move(pending_.front());
+    pending_.pop_front();
+    lk.unlock();
+    if (pending.work) {
+      pending.work(*child_);
+    } else {
+      child_->Update(pending.data.data(), pending.data.size());
+    }
+    lk.lock();
+    pending_bytes_ -= pending.data.size();
+    if (!pending.work && free_buffers_.size() < kMaxFreeBuffers) {
+      free_buffers_.push_back(std::move(pending.data));
+    }
+    cv_.notify_all();
+  }
+}
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
@@ -18,6 +18,14 @@
 #include "google/cloud/storage/internal/hash_validator.h"
 #include "google/cloud/storage/version.h"
 #include <openssl/md5.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -67,6 +75,59 @@ class Crc32cHashValidator : public HashValidator {
   std::string received_hash_;
 };
 
+/**
+ * A validator that runs another validator on a background thread.
+ *
+ * `Update()` copies the data and queues it for the background thread, so the
+ * hash computations overlap with the network I/O in the calling thread. The
+ * amount of queued data is bounded by @p max_pending_bytes, `Update()` blocks
+ * until the background thread catches up if the limit is reached.
+ *
+ * The copies reuse the buffers of previously hashed blocks, so a download or
+ * upload in steady state does not allocate memory for each block.
+ */
+class BackgroundHashValidator : public HashValidator {
+ public:
+  explicit BackgroundHashValidator(std::unique_ptr<HashValidator> child,
+                                   std::size_t max_pending_bytes =
+                                       kDefaultMaxPendingBytes);
+  ~BackgroundHashValidator() override;
+
+  BackgroundHashValidator(BackgroundHashValidator const&) = delete;
+  BackgroundHashValidator& operator=(BackgroundHashValidator const&) = delete;
+
+  std::string Name() const override { return child_->Name(); }
+  void Update(char const* buf, std::size_t n) override;
+  void ProcessMetadata(ObjectMetadata const& meta) override;
+  void ProcessHeader(std::string const& key, std::string const& value) override;
+  Result Finish() && override;
+
+  static std::size_t constexpr kDefaultMaxPendingBytes = 32 * 1024 * 1024;
+  /// The maximum number of hashed blocks kept for reuse by `Update()`.
+  static std::size_t constexpr kMaxFreeBuffers = 8;
+
+ private:
+  using Work = std::function<void(HashValidator&)>;
+  /// Queued work, a block of data to hash if `work` is empty.
+  struct Pending {
+    std::string data;
+    Work work;
+  };
+  void Push(Pending pending);
+  void Shutdown();
+  void Run();
+
+  std::unique_ptr<HashValidator> child_;
+  std::size_t const max_pending_bytes_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Pending> pending_;
+  std::vector<std::string> free_buffers_;
+  std::size_t pending_bytes_ = 0;
+  bool shutdown_ = false;
+  std::thread worker_;
+};
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
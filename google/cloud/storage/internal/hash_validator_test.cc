@@ -216,6 +216,74 @@ TEST(CompositeHashValidator, Missing) {
   EXPECT_FALSE(result.is_mismatch);
 }
 
+TEST(BackgroundHashValidator, Simple) {
+  BackgroundHashValidator validator(absl::make_unique<CompositeValidator>(
+      absl::make_unique<Crc32cHashValidator>(),
+      absl::make_unique<MD5HashValidator>()));
+  EXPECT_EQ("composite", validator.Name());
+  UpdateValidator(validator, "The quick");
+  UpdateValidator(validator, " brown");
+  UpdateValidator(validator, " fox jumps over the lazy dog");
+  validator.ProcessHeader("x-goog-hash", "crc32c=" + kQuickFoxCrc32cChecksum);
+  validator.ProcessHeader("x-goog-hash", "md5=" + kQuickFoxMD5Hash);
+  auto result = std::move(validator).Finish();
+  EXPECT_EQ("crc32c=" + kQuickFoxCrc32cChecksum + ",md5=" + kQuickFoxMD5Hash,
+            result.computed);
+  EXPECT_EQ(result.computed, result.received);
+  EXPECT_FALSE(result.is_mismatch);
+}
+
+TEST(BackgroundHashValidator, SmallQueue) {
+  // Use a queue smaller than each block to exercise the flow control.
+  BackgroundHashValidator validator(absl::make_unique<Crc32cHashValidator>(),
+                                    4);
+  std::string const data = "The quick brown fox jumps over the lazy dog";
+  for (auto c : data) UpdateValidator(validator, std::string(1, c));
+  auto object_metadata = internal::ObjectMetadataParser::FromJson(
+                             nlohmann::json{
+                                 {"crc32c", kQuickFoxCrc32cChecksum},
+                             })
+                             .value();
+  validator.ProcessMetadata(object_metadata);
+  auto result = std::move(validator).Finish();
+  EXPECT_EQ(kQuickFoxCrc32cChecksum, result.computed);
+  EXPECT_EQ(kQuickFoxCrc32cChecksum, result.received);
+  EXPECT_FALSE(result.is_mismatch);
+}
+
+TEST(BackgroundHashValidator, ReusedBuffers) {
+  // Alternate long and short blocks, the short blocks reuse the buffers of
+  // the long ones, and vice versa.
+  BackgroundHashValidator validator(absl::make_unique<CompositeValidator>(
+      absl::make_unique<Crc32cHashValidator>(),
+      absl::make_unique<MD5HashValidator>()));
+  UpdateValidator(validator, "The quick brown fox");
+  UpdateValidator(validator, " ");
+  UpdateValidator(validator, "jumps over the lazy");
+  UpdateValidator(validator, "");
+  UpdateValidator(validator, " dog");
+  validator.ProcessHeader("x-goog-hash", "crc32c=" + kQuickFoxCrc32cChecksum);
+  validator.ProcessHeader("x-goog-hash", "md5=" + kQuickFoxMD5Hash);
+  auto result = std::move(validator).Finish();
+  EXPECT_EQ("crc32c=" + kQuickFoxCrc32cChecksum + ",md5=" + kQuickFoxMD5Hash,
+            result.computed);
+  EXPECT_FALSE(result.is_mismatch);
+}
+
+TEST(BackgroundHashValidator, Mismatch) {
+  BackgroundHashValidator validator(absl::make_unique<Crc32cHashValidator>());
+  UpdateValidator(validator, "The quick brown fox jumps over the lazy dog");
+  validator.ProcessHeader("x-goog-hash", "crc32c=<invalid-crc32c-for-test>");
+  auto result = std::move(validator).Finish();
+  EXPECT_EQ(kQuickFoxCrc32cChecksum, result.computed);
+  EXPECT_TRUE(result.is_mismatch);
+}
+
+TEST(BackgroundHashValidator, DestroyWithoutFinish) {
+  BackgroundHashValidator validator(absl::make_unique<MD5HashValidator>());
+  UpdateValidator(validator, "The quick brown fox jumps over the lazy dog");
+}
+
 TEST(CreateHashValidator, ReadNull) {
   auto validator =
       CreateHashValidator(ReadObjectRangeRequest("test-bucket", "test-object")
@@ -381,6 +449,44 @@ TEST(CreateHashValidator, WriteDisableMD5DefaultConstructor) {
   auto result = std::move(*validator).Finish();
   EXPECT_EQ(kQuickFoxCrc32cChecksum, result.computed);
 }
+
+TEST(CreateHashValidator, ReadBackground) {
+  auto validator = CreateHashValidator(
+      ReadObjectRangeRequest("test-bucket", "test-object")
+          .set_multiple_options(DisableMD5Hash(false),
+                                UseBackgroundHashing(true)));
+  EXPECT_NE(nullptr, dynamic_cast<BackgroundHashValidator*>(validator.get()));
+  UpdateValidator(*validator, "The quick brown fox jumps over the lazy dog");
+  auto result = std::move(*validator).Finish();
+  EXPECT_EQ("crc32c=" + kQuickFoxCrc32cChecksum + ",md5=" + kQuickFoxMD5Hash,
+            result.computed);
+}
+
+TEST(CreateHashValidator, ReadBackgroundNull) {
+  auto validator = CreateHashValidator(
+      ReadObjectRangeRequest("test-bucket", "test-object")
+          .set_multiple_options(DisableCrc32cChecksum(true),
+                                UseBackgroundHashing(true)));
+  EXPECT_EQ("null", validator->Name());
+  EXPECT_EQ(nullptr, dynamic_cast<BackgroundHashValidator*>(validator.get()));
+}
+
+TEST(CreateHashValidator, WriteBackground) {
+  auto validator = CreateHashValidator(
+      ResumableUploadRequest("test-bucket", "test-object")
+          .set_multiple_options(UseBackgroundHashing(true)));
+  EXPECT_NE(nullptr, dynamic_cast<BackgroundHashValidator*>(validator.get()));
+  UpdateValidator(*validator, "The quick brown fox jumps over the lazy dog");
+  auto result = std::move(*validator).Finish();
+  EXPECT_EQ(kQuickFoxCrc32cChecksum, result.computed);
+}
+
+TEST(CreateHashValidator, WriteBackgroundFalse) {
+  auto validator = CreateHashValidator(
+      ResumableUploadRequest("test-bucket", "test-object")
+          .set_multiple_options(UseBackgroundHashing(false)));
+  EXPECT_EQ(nullptr, dynamic_cast<BackgroundHashValidator*>(validator.get()));
+}
 }  // namespace
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
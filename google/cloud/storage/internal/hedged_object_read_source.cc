@@ -0,0 +1,178 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/hedged_object_read_source.h"
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+namespace {
+
+/// The result of the first `Read()` on one of the sources.
+struct HedgedAttempt {
+  bool done = false;
+  std::unique_ptr<ObjectReadSource> source;
+  StatusOr<ReadSourceResult> result;
+};
+
+/// The state shared between a hedged `Read()` and its background threads.
+struct HedgedReadState {
+  explicit HedgedReadState(std::size_t n)
+      : buffer_size(n), buffer(new char[2 * n]) {}
+
+  std::mutex mu;
+  std::condition_variable cv;
+  bool finished = false;
+  HedgedAttempt attempts[2];
+  // A single allocation holds the data for both attempts, each one reads
+  // into its own half. It is not initialized, so the memory for the hedged
+  // request is only touched if it is needed.
+  std::size_t const buffer_size;
+  std::unique_ptr<char[]> const buffer;
+};
+
+void RunAttempt(std::shared_ptr<HedgedReadState> const& state,
+                std::size_t index, std::unique_ptr<ObjectReadSource> source,
+                HedgedObjectReadSource::SourceFactory factory) {
+  auto result = StatusOr<ReadSourceResult>(
+      Status(StatusCode::kUnknown, "HedgedObjectReadSource: no source"));
+  if (!source) {
+    auto s = factory();
+    if (s) source = *std::move(s);
+    if (!s) result = std::move(s).status();
+  }
+  // The factory may hold resources, e.g., the client, release them before the
+  // (potentially slow) download.
+  factory = nullptr;
+  if (source) {
+    result = source->Read(state->buffer.get() + index * state->buffer_size,
+                          state->buffer_size);
+  }
+
+  std::unique_lock<std::mutex> lk(state->mu);
+  if (state->finished) {
+    // The other attempt won, cancel this download.
+    lk.unlock();
+    if (source) (void)source->Close();
+    return;
+  }
+  auto& attempt = state->attempts[index];
+  attempt.done = true;
+  attempt.source = std::move(source);
+  attempt.result = std::move(result);
+  lk.unlock();
+  state->cv.notify_all();
+}
+
+}  // namespace
+
+HedgedObjectReadSource::HedgedObjectReadSource(
+    std::unique_ptr<ObjectReadSource> primary, SourceFactory hedge_factory,
+    std::shared_ptr<HedgedReadPolicy> policy)
+    : primary_(std::move(primary)),
+      hedge_factory_(std::move(hedge_factory)),
+      policy_(std::move(policy)) {}
+
+HedgedObjectReadSource::~HedgedObjectReadSource() {
+  for (auto& t : attempts_) t.join();
+}
+
+bool HedgedObjectReadSource::IsOpen() const {
+  if (winner_) return winner_->IsOpen();
+  return primary_ && primary_->IsOpen();
+}
+
+StatusOr<HttpResponse> HedgedObjectReadSource::Close() {
+  if (winner_) return winner_->Close();
+  if (primary_) return primary_->Close();
+  return Status(StatusCode::kFailedPrecondition, "Stream is not open");
+}
+
+StatusOr<ReadSourceResult> HedgedObjectReadSource::Read(char* buf,
+                                                        std::size_t n) {
+  if (winner_) return winner_->Read(buf, n);
+  if (!primary_) {
+    return Status(StatusCode::kFailedPrecondition, "Stream is not open");
+  }
+  return HedgedRead(buf, n);
+}
+
+StatusOr<ReadSourceResult> HedgedObjectReadSource::HedgedRead(char* buf,
+                                                              std::size_t n) {
+  auto const delay = policy_->HedgeDelay();
+  if (!delay) {
+    winner_ = std::move(primary_);
+    return winner_->Read(buf, n);
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  auto state = std::make_shared<HedgedReadState>(n);
+  attempts_.emplace_back(RunAttempt, state, 0, std::move(primary_),
+                         SourceFactory{});
+
+  std::size_t launched = 1;
+  auto winner = [&]() -> int {
+    for (std::size_t i = 0; i != launched; ++i) {
+      auto const& a = state->attempts[i];
+      if (a.done && a.result.ok()) return static_cast<int>(i);
+    }
+    return -1;
+  };
+  auto ready = [&] {
+    if (winner() >= 0) return true;
+    for (std::size_t i = 0; i != launched; ++i) {
+      if (!state->attempts[i].done) return false;
+    }
+    return true;
+  };
+
+  std::unique_lock<std::mutex> lk(state->mu);
+  // Do not hedge after a fast failure, the retry loop handles those.
+  if (!state->cv.wait_for(lk, *delay, ready)) {
+    launched = 2;
+    lk.unlock();
+    attempts_.emplace_back(RunAttempt, state, 1,
+                           std::unique_ptr<ObjectReadSource>{}, hedge_factory_);
+    lk.lock();
+  }
+  state->cv.wait(lk, ready);
+  state->finished = true;
+  auto const w = winner();
+  // If all the attempts failed report the error from the primary request.
+  auto const index = static_cast<std::size_t>(w < 0 ? 0 : w);
+  auto selected = std::move(state->attempts[index]);
+  auto loser = std::move(state->attempts[w == 1 ? 0 : 1].source);
+  lk.unlock();
+  if (loser) (void)loser->Close();
+
+  winner_ = std::move(selected.source);
+  if (!selected.result) return std::move(selected.result).status();
+  policy_->OnFirstByte(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start));
+  std::memcpy(buf, state->buffer.get() + index * n,
+              selected.result->bytes_received);
+  return selected.result;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
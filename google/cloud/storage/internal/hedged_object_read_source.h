@@ -0,0 +1,77 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HEDGED_OBJECT_READ_SOURCE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HEDGED_OBJECT_READ_SOURCE_H
+
+#include "google/cloud/storage/hedged_read_policy.h"
+#include "google/cloud/storage/internal/object_read_source.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status_or.h"
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * An `ObjectReadSource` that hedges the first `Read()` of a download.
+ *
+ * The first `Read()` runs in a background thread. If it does not complete
+ * before the delay configured in the `HedgedReadPolicy`, this class creates a
+ * second source (using @p hedge_factory) and issues the same `Read()` on it.
+ * The first `Read()` to succeed wins, and the download continues using its
+ * source. The other source is closed as soon as its `Read()` returns, the
+ * synchronous `ObjectReadSource` interface offers no way to interrupt it
+ * earlier. A slow request does not delay the reads, but the destructor waits
+ * for the background threads, so they never outlive the client.
+ */
+class HedgedObjectReadSource : public ObjectReadSource {
+ public:
+  using SourceFactory =
+      std::function<StatusOr<std::unique_ptr<ObjectReadSource>>()>;
+
+  HedgedObjectReadSource(std::unique_ptr<ObjectReadSource> primary,
+                         SourceFactory hedge_factory,
+                         std::shared_ptr<HedgedReadPolicy> policy);
+  ~HedgedObjectReadSource() override;
+
+  bool IsOpen() const override;
+  StatusOr<HttpResponse> Close() override;
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override;
+
+ private:
+  StatusOr<ReadSourceResult> HedgedRead(char* buf, std::size_t n);
+
+  std::unique_ptr<ObjectReadSource> primary_;
+  SourceFactory hedge_factory_;
+  std::shared_ptr<HedgedReadPolicy> policy_;
+  // The source used after the first `Read()`.
+  std::unique_ptr<ObjectReadSource> winner_;
+  // The threads running the first `Read()`, joined on destruction.
+  std::vector<std::thread> attempts_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HEDGED_OBJECT_READ_SOURCE_H
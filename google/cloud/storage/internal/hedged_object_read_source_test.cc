@@ -0,0 +1,194 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/hedged_object_read_source.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <cstring>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::MockObjectReadSource;
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::storage::testing::canonical_errors::TransientError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::Return;
+
+/// A policy that never uses the adaptive logic.
+class DisabledHedgedReadPolicy : public HedgedReadPolicy {
+ public:
+  std::unique_ptr<HedgedReadPolicy> clone() const override {
+    return absl::make_unique<DisabledHedgedReadPolicy>();
+  }
+  absl::optional<std::chrono::microseconds> HedgeDelay() const override {
+    return absl::nullopt;
+  }
+  void OnFirstByte(std::chrono::microseconds) override {}
+};
+
+StatusOr<ReadSourceResult> Data(char* buf, std::string const& contents) {
+  std::memcpy(buf, contents.data(), contents.size());
+  return ReadSourceResult{contents.size(),
+                          HttpResponse{HttpStatusCode::kOk, {}, {}}};
+}
+
+std::shared_ptr<HedgedReadPolicy> ShortDelay() {
+  return std::make_shared<FixedDelayHedgedReadPolicy>(
+      std::chrono::milliseconds(10));
+}
+
+TEST(HedgedObjectReadSourceTest, FastPrimary) {
+  auto primary = absl::make_unique<MockObjectReadSource>();
+  EXPECT_CALL(*primary, Read)
+      .WillOnce([](char* buf, std::size_t) { return Data(buf, "primary"); })
+      .WillOnce([](char* buf, std::size_t) { return Data(buf, "more"); });
+  EXPECT_CALL(*primary, IsOpen).WillRepeatedly(Return(true));
+  HedgedObjectReadSource tested(
+      std::move(primary),
+      [] {
+        ADD_FAILURE() << "unexpected hedged request";
+        return StatusOr<std::unique_ptr<ObjectReadSource>>(TransientError());
+      },
+      std::make_shared<FixedDelayHedgedReadPolicy>(std::chrono::seconds(60)));
+
+  char buffer[16];
+  auto r = tested.Read(buffer, sizeof(buffer));
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ("primary", std::string(buffer, r->bytes_received));
+  EXPECT_TRUE(tested.IsOpen());
+  r = tested.Read(buffer, sizeof(buffer));
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ("more", std::string(buffer, r->bytes_received));
+}
+
+TEST(HedgedObjectReadSourceTest, HedgeWins) {
+  std::promise<void> release_primary;
+  auto primary_released = release_primary.get_future().share();
+  std::promise<void> primary_closed;
+
+  auto primary = absl::make_unique<MockObjectReadSource>();
+  EXPECT_CALL(*primary, Read).WillOnce([primary_released](char* buf,
+                                                          std::size_t) {
+    primary_released.wait();
+    return Data(buf, "primary");
+  });
+  // The slow request is closed as soon as its `Read()` returns.
+  EXPECT_CALL(*primary, Close).WillOnce([&primary_closed] {
+    primary_closed.set_value();
+    return make_status_or(HttpResponse{HttpStatusCode::kOk, {}, {}});
+  });
+
+  {
+    HedgedObjectReadSource tested(
+        std::move(primary),
+        [] {
+          auto hedge = absl::make_unique<MockObjectReadSource>();
+          EXPECT_CALL(*hedge, Read).WillOnce([](char* buf, std::size_t) {
+            return Data(buf, "hedge");
+          });
+          EXPECT_CALL(*hedge, Close)
+              .WillOnce(Return(HttpResponse{HttpStatusCode::kOk, {}, {}}));
+          return make_status_or(
+              std::unique_ptr<ObjectReadSource>(std::move(hedge)));
+        },
+        ShortDelay());
+
+    char buffer[16];
+    auto r = tested.Read(buffer, sizeof(buffer));
+    release_primary.set_value();
+    ASSERT_STATUS_OK(r);
+    EXPECT_EQ("hedge", std::string(buffer, r->bytes_received));
+    EXPECT_STATUS_OK(tested.Close());
+  }
+
+  // The destructor waits for the slow request.
+  auto closed = primary_closed.get_future();
+  EXPECT_EQ(std::future_status::ready,
+            closed.wait_for(std::chrono::seconds(0)));
+}
+
+TEST(HedgedObjectReadSourceTest, PrimaryFailsFast) {
+  auto primary = absl::make_unique<MockObjectReadSource>();
+  EXPECT_CALL(*primary, Read)
+      .WillOnce(Return(StatusOr<ReadSourceResult>(TransientError())));
+  HedgedObjectReadSource tested(
+      std::move(primary),
+      [] {
+        ADD_FAILURE() << "unexpected hedged request";
+        return StatusOr<std::unique_ptr<ObjectReadSource>>(TransientError());
+      },
+      std::make_shared<FixedDelayHedgedReadPolicy>(std::chrono::seconds(60)));
+
+  char buffer[16];
+  EXPECT_THAT(tested.Read(buffer, sizeof(buffer)),
+              StatusIs(TransientError().code()));
+}
+
+TEST(HedgedObjectReadSourceTest, AllFail) {
+  std::promise<void> hedge_done;
+  auto hedge_finished = hedge_done.get_future().share();
+  auto primary = absl::make_unique<MockObjectReadSource>();
+  EXPECT_CALL(*primary, Read).WillOnce([hedge_finished](char*, std::size_t) {
+    hedge_finished.wait();
+    return StatusOr<ReadSourceResult>(TransientError());
+  });
+  HedgedObjectReadSource tested(
+      std::move(primary),
+      [&hedge_done] {
+        hedge_done.set_value();
+        return StatusOr<std::unique_ptr<ObjectReadSource>>(PermanentError());
+      },
+      ShortDelay());
+
+  // The error from the primary request is returned.
+  char buffer[16];
+  EXPECT_THAT(tested.Read(buffer, sizeof(buffer)),
+              StatusIs(TransientError().code()));
+}
+
+TEST(HedgedObjectReadSourceTest, Disabled) {
+  auto primary = absl::make_unique<MockObjectReadSource>();
+  EXPECT_CALL(*primary, Read).WillOnce([](char* buf, std::size_t) {
+    return Data(buf, "primary");
+  });
+  HedgedObjectReadSource tested(
+      std::move(primary),
+      [] {
+        ADD_FAILURE() << "unexpected hedged request";
+        return StatusOr<std::unique_ptr<ObjectReadSource>>(TransientError());
+      },
+      std::make_shared<DisabledHedgedReadPolicy>());
+
+  char buffer[16];
+  auto r = tested.Read(buffer, sizeof(buffer));
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ("primary", std::string(buffer, r->bytes_received));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
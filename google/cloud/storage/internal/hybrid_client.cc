@@ -20,14 +20,44 @@ namespace cloud {
 namespace storage {
 inline namespace STORAGE_CLIENT_NS {
 namespace internal {
+namespace {
+using Operation = TransportSelector::Operation;
+using Transport = TransportSelector::Transport;
+
+/// The number of bytes in a download, if known before it starts.
+absl::optional<std::uint64_t> ExpectedReadSize(
+    ReadObjectRangeRequest const& request) {
+  if (request.HasOption<ReadLast>()) {
+    return static_cast<std::uint64_t>(request.GetOption<ReadLast>().value());
+  }
+  if (request.HasOption<ReadRange>()) {
+    auto const range = request.GetOption<ReadRange>().value();
+    if (range.end > range.begin) {
+      return static_cast<std::uint64_t>(range.end - range.begin);
+    }
+  }
+  return absl::nullopt;
+}
+
+std::chrono::microseconds ElapsedSince(
+    std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+}  // namespace
 
 HybridClient::HybridClient(ClientOptions options)
-    : grpc_(std::make_shared<GrpcClient>(options)),
-      curl_(CurlClient::Create(std::move(options))) {}
+    : HybridClient(std::move(options), 0) {}
 
 HybridClient::HybridClient(ClientOptions options, int channel_id)
+    : HybridClient(std::move(options), channel_id,
+                   std::make_shared<TransportSelector>()) {}
+
+HybridClient::HybridClient(ClientOptions options, int channel_id,
+                           std::shared_ptr<TransportSelector> selector)
     : grpc_(std::make_shared<GrpcClient>(options, channel_id)),
-      curl_(CurlClient::Create(std::move(options))) {}
+      curl_(CurlClient::Create(std::move(options))),
+      selector_(std::move(selector)) {}
 
 ClientOptions const& HybridClient::client_options() const {
   return curl_->client_options();
@@ -96,7 +126,15 @@ StatusOr<BucketMetadata> HybridClient::LockBucketRetentionPolicy(
 
 StatusOr<ObjectMetadata> HybridClient::InsertObjectMedia(
     InsertObjectMediaRequest const& request) {
-  return grpc_->InsertObjectMedia(request);
+  auto const size = static_cast<std::uint64_t>(request.contents().size());
+  auto const transport = selector_->Pick(Operation::kInsertObjectMedia, size);
+  auto const start = std::chrono::steady_clock::now();
+  auto response = transport == Transport::kGrpc
+                      ? grpc_->InsertObjectMedia(request)
+                      : curl_->InsertObjectMedia(request);
+  selector_->Record(Operation::kInsertObjectMedia, size, transport,
+                    response ? size : 0, ElapsedSince(start));
+  return response;
 }
 
 StatusOr<ObjectMetadata> HybridClient::CopyObject(
@@ -111,7 +149,25 @@ StatusOr<ObjectMetadata> HybridClient::GetObjectMetadata(
 
 StatusOr<std::unique_ptr<ObjectReadSource>> HybridClient::ReadObject(
     ReadObjectRangeRequest const& request) {
-  return grpc_->ReadObject(request);
+  auto const size = ExpectedReadSize(request);
+  auto const transport = selector_->Pick(Operation::kReadObject, size);
+  auto const start = std::chrono::steady_clock::now();
+  auto source = transport == Transport::kGrpc ? grpc_->ReadObject(request)
+                                              : curl_->ReadObject(request);
+  if (!selector_->adaptive()) return source;
+  if (!source) {
+    selector_->Record(Operation::kReadObject, size, transport, 0,
+                      ElapsedSince(start));
+    return source;
+  }
+  auto selector = selector_;
+  return MakeMeasuredReadSource(
+      *std::move(source),
+      [selector, size, transport](std::uint64_t bytes,
+                                  std::chrono::microseconds elapsed) {
+        selector->Record(Operation::kReadObject, size, transport, bytes,
+                         elapsed);
+      });
 }
 
 StatusOr<ListObjectsResponse> HybridClient::ListObjects(
@@ -119,6 +175,11 @@ StatusOr<ListObjectsResponse> HybridClient::ListObjects(
   return curl_->ListObjects(request);
 }
 
+StatusOr<ListObjectsCompactResponse> HybridClient::ListObjectsCompact(
+    ListObjectsRequest const& request) {
+  return curl_->ListObjectsCompact(request);
+}
+
 StatusOr<EmptyResponse> HybridClient::DeleteObject(
     DeleteObjectRequest const& request) {
   return curl_->DeleteObject(request);
@@ -146,6 +207,12 @@ StatusOr<RewriteObjectResponse> HybridClient::RewriteObject(
 
 StatusOr<std::unique_ptr<ResumableUploadSession>>
 HybridClient::CreateResumableSession(ResumableUploadRequest const& request) {
+  // Resumable sessions are restored using the transport that created them, see
+  // `RestoreResumableSession()`.
+  if (selector_->Pick(Operation::kResumableUpload, absl::nullopt) ==
+      Transport::kJson) {
+    return curl_->CreateResumableSession(request);
+  }
   return grpc_->CreateResumableSession(request);
 }
 
@@ -310,6 +377,15 @@ StatusOr<EmptyResponse> HybridClient::DeleteNotification(
   return curl_->DeleteNotification(request);
 }
 
+StatusOr<BatchResponse> HybridClient::ExecuteBatch(
+    BatchRequest const& request) {
+  return curl_->ExecuteBatch(request);
+}
+
+Status HybridClient::WarmUpConnectionPool() {
+  return curl_->WarmUpConnectionPool();
+}
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
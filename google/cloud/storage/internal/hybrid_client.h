@@ -18,6 +18,7 @@
 #include "google/cloud/storage/internal/curl_client.h"
 #include "google/cloud/storage/internal/grpc_client.h"
 #include "google/cloud/storage/internal/raw_client.h"
+#include "google/cloud/storage/internal/transport_selector.h"
 #include "google/cloud/storage/version.h"
 
 namespace google {
@@ -26,10 +27,18 @@ namespace storage {
 inline namespace STORAGE_CLIENT_NS {
 namespace internal {
 
+/**
+ * Routes each operation to `GrpcClient` or `CurlClient`.
+ *
+ * Most operations use `CurlClient`. Media uploads and downloads use the
+ * transport chosen by the `TransportSelector`, gRPC by default.
+ */
 class HybridClient : public RawClient {
  public:
   explicit HybridClient(ClientOptions options);
   explicit HybridClient(ClientOptions options, int channel_id);
+  HybridClient(ClientOptions options, int channel_id,
+               std::shared_ptr<TransportSelector> selector);
   ~HybridClient() override = default;
 
   ClientOptions const& client_options() const override;
@@ -69,6 +78,8 @@ class HybridClient : public RawClient {
       ReadObjectRangeRequest const&) override;
 
   StatusOr<ListObjectsResponse> ListObjects(ListObjectsRequest const&) override;
+  StatusOr<ListObjectsCompactResponse> ListObjectsCompact(
+      ListObjectsRequest const&) override;
   StatusOr<EmptyResponse> DeleteObject(DeleteObjectRequest const&) override;
   StatusOr<ObjectMetadata> UpdateObject(
       UpdateObjectRequest const& request) override;
@@ -144,9 +155,13 @@ class HybridClient : public RawClient {
   StatusOr<EmptyResponse> DeleteNotification(
       DeleteNotificationRequest const&) override;
 
+  StatusOr<BatchResponse> ExecuteBatch(BatchRequest const&) override;
+  Status WarmUpConnectionPool() override;
+
  private:
   std::shared_ptr<GrpcClient> grpc_;
   std::shared_ptr<CurlClient> curl_;
+  std::shared_ptr<TransportSelector> selector_;
 };
 
 }  // namespace internal
@@ -175,6 +175,12 @@ StatusOr<ListObjectsResponse> LoggingClient::ListObjects(
   return MakeCall(*client_, &RawClient::ListObjects, request, __func__);
 }
 
+StatusOr<ListObjectsCompactResponse> LoggingClient::ListObjectsCompact(
+    ListObjectsRequest const& request) {
+  return MakeCall(*client_, &RawClient::ListObjectsCompact, request,
+                  __func__);
+}
+
 StatusOr<EmptyResponse> LoggingClient::DeleteObject(
     DeleteObjectRequest const& request) {
   return MakeCall(*client_, &RawClient::DeleteObject, request, __func__);
@@ -375,6 +381,18 @@ StatusOr<EmptyResponse> LoggingClient::DeleteNotification(
   return MakeCall(*client_, &RawClient::DeleteNotification, request, __func__);
 }
 
+StatusOr<BatchResponse> LoggingClient::ExecuteBatch(
+    BatchRequest const& request) {
+  return MakeCall(*client_, &RawClient::ExecuteBatch, request, __func__);
+}
+
+Status LoggingClient::WarmUpConnectionPool() {
+  GCP_LOG(INFO) << __func__ << "() << {}";
+  auto status = client_->WarmUpConnectionPool();
+  GCP_LOG(INFO) << __func__ << "() >> status={" << status << "}";
+  return status;
+}
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
@@ -0,0 +1,105 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/mapped_file.h"
+#include "google/cloud/internal/strerror.h"
+#include <cerrno>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+#ifndef _WIN32
+namespace {
+Status IOError(char const* where, std::string const& file_name, int errnum) {
+  auto code = StatusCode::kUnknown;
+  if (errnum == ENOENT) code = StatusCode::kNotFound;
+  if (errnum == EACCES || errnum == EPERM) {
+    code = StatusCode::kPermissionDenied;
+  }
+  return Status(code, std::string(where) + "(" + file_name +
+                          "): " + google::cloud::internal::strerror(errnum));
+}
+}  // namespace
+
+MappedFileRegion::~MappedFileRegion() {
+  if (mapping_ != nullptr) (void)::munmap(mapping_, mapping_size_);
+}
+
+StatusOr<std::shared_ptr<MappedFileRegion const>> MapFileRegion(
+    std::string const& file_name, std::uint64_t offset, std::size_t size) {
+  auto fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return IOError("open", file_name, errno);
+  struct stat st;  // NOLINT(cppcoreguidelines-pro-type-member-init)
+  if (::fstat(fd, &st) != 0) {
+    auto status = IOError("fstat", file_name, errno);
+    ::close(fd);
+    return status;
+  }
+  auto const file_size = static_cast<std::uint64_t>(st.st_size);
+  if (offset > file_size || size > file_size - offset) {
+    ::close(fd);
+    return Status(StatusCode::kOutOfRange,
+                  "MapFileRegion(" + file_name +
+                      "): the region is past the end of the file");
+  }
+  // `mmap()` rejects empty mappings, there is nothing to map anyway.
+  if (size == 0) {
+    ::close(fd);
+    return std::shared_ptr<MappedFileRegion const>(
+        std::make_shared<MappedFileRegion>(nullptr, 0, nullptr, 0));
+  }
+  // The mapping must start at a multiple of the page size.
+  auto const page_size = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+  auto const start = offset - offset % page_size;
+  auto const delta = static_cast<std::size_t>(offset - start);
+  auto const mapping_size = size + delta;
+  auto* mapping = ::mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd,
+                         static_cast<off_t>(start));
+  auto const errnum = errno;
+  // The mapping remains valid after the file descriptor is closed.
+  ::close(fd);
+  if (mapping == MAP_FAILED) return IOError("mmap", file_name, errnum);
+  // The data is read once, from start to finish.
+  (void)::madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+  return std::shared_ptr<MappedFileRegion const>(
+      std::make_shared<MappedFileRegion>(
+          mapping, mapping_size, static_cast<char const*>(mapping) + delta,
+          size));
+}
+
+#else
+
+MappedFileRegion::~MappedFileRegion() = default;
+
+StatusOr<std::shared_ptr<MappedFileRegion const>> MapFileRegion(
+    std::string const&, std::uint64_t, std::size_t) {
+  return Status(StatusCode::kUnimplemented,
+                "memory-mapped files are not supported on this platform");
+}
+
+#endif  // _WIN32
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
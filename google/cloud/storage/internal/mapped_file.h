@@ -0,0 +1,77 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_MAPPED_FILE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_MAPPED_FILE_H
+
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status_or.h"
+#include "absl/strings/string_view.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A read-only, memory-mapped region of a file.
+ *
+ * Uploading from a mapped region avoids reading the file into a (possibly
+ * very large) temporary buffer, libcurl reads the data directly from the page
+ * cache. The file must not be truncated while it is mapped, on most platforms
+ * accessing the missing pages terminates the program.
+ */
+class MappedFileRegion {
+ public:
+  MappedFileRegion(void* mapping, std::size_t mapping_size, char const* data,
+                   std::size_t size)
+      : mapping_(mapping),
+        mapping_size_(mapping_size),
+        data_(data),
+        size_(size) {}
+  ~MappedFileRegion();
+
+  MappedFileRegion(MappedFileRegion const&) = delete;
+  MappedFileRegion& operator=(MappedFileRegion const&) = delete;
+
+  absl::string_view contents() const { return {data_, size_}; }
+
+ private:
+  void* mapping_;
+  std::size_t mapping_size_;
+  char const* data_;
+  std::size_t size_;
+};
+
+/**
+ * Map @p size bytes of @p file_name, starting at @p offset.
+ *
+ * Returns `StatusCode::kUnimplemented` on platforms without `mmap()`, the
+ * caller should fallback to reading the file.
+ */
+StatusOr<std::shared_ptr<MappedFileRegion const>> MapFileRegion(
+    std::string const& file_name, std::uint64_t offset, std::size_t size);
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_MAPPED_FILE_H
@@ -0,0 +1,89 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/mapped_file.h"
+#include "google/cloud/storage/testing/random_names.h"
+#include "google/cloud/storage/testing/temp_file.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::MakeRandomData;
+using ::google::cloud::storage::testing::TempFile;
+using ::google::cloud::testing_util::StatusIs;
+
+#ifndef _WIN32
+TEST(MappedFileTest, Full) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const contents = MakeRandomData(generator, 3 * 4096 + 100);
+  TempFile file(contents);
+
+  auto region = MapFileRegion(file.name(), 0, contents.size());
+  ASSERT_STATUS_OK(region);
+  EXPECT_EQ(contents, std::string((*region)->contents()));
+}
+
+TEST(MappedFileTest, UnalignedOffset) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const contents = MakeRandomData(generator, 3 * 4096 + 100);
+  TempFile file(contents);
+
+  auto region = MapFileRegion(file.name(), 4096 + 7, 1000);
+  ASSERT_STATUS_OK(region);
+  EXPECT_EQ(contents.substr(4096 + 7, 1000),
+            std::string((*region)->contents()));
+}
+
+TEST(MappedFileTest, Empty) {
+  TempFile file("");
+  auto region = MapFileRegion(file.name(), 0, 0);
+  ASSERT_STATUS_OK(region);
+  EXPECT_TRUE((*region)->contents().empty());
+}
+
+TEST(MappedFileTest, OutOfRange) {
+  TempFile file("0123456789");
+  EXPECT_THAT(MapFileRegion(file.name(), 5, 10),
+              StatusIs(StatusCode::kOutOfRange));
+  EXPECT_THAT(MapFileRegion(file.name(), 11, 0),
+              StatusIs(StatusCode::kOutOfRange));
+}
+
+TEST(MappedFileTest, NotFound) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  EXPECT_THAT(MapFileRegion(testing::MakeRandomFileName(generator), 0, 0),
+              StatusIs(StatusCode::kNotFound));
+}
+#else
+TEST(MappedFileTest, Unimplemented) {
+  EXPECT_THAT(MapFileRegion("unused", 0, 0),
+              StatusIs(StatusCode::kUnimplemented));
+}
+#endif  // _WIN32
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
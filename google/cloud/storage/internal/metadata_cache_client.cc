@@ -0,0 +1,543 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/metadata_cache_client.h"
+#include "google/cloud/storage/internal/batch_requests.h"
+#include "absl/memory/memory.h"
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+namespace {
+
+std::string ObjectKey(std::string const& bucket_name,
+                      std::string const& object_name) {
+  return MetadataCacheObjectKey(bucket_name, object_name);
+}
+
+/// Returns true if the response to @p request contains the full metadata.
+template <typename Request>
+bool ReturnsFullMetadata(Request const& request) {
+  return !request.template HasOption<Fields>() &&
+         !request.template HasOption<Projection>();
+}
+
+/// Returns true if the response to @p request may be served from the cache.
+template <typename Request>
+bool IsCacheable(Request const& request) {
+  return ReturnsFullMetadata(request) &&
+         !request.template HasOption<IfMetagenerationMatch>() &&
+         !request.template HasOption<IfMetagenerationNotMatch>() &&
+         !request.template HasOption<IfMatchEtag>() &&
+         !request.template HasOption<IfNoneMatchEtag>() &&
+         !request.template HasOption<CustomHeader>();
+}
+
+bool IsCacheable(GetObjectMetadataRequest const& request) {
+  return IsCacheable<GetObjectMetadataRequest>(request) &&
+         !request.HasOption<Generation>() &&
+         !request.HasOption<IfGenerationMatch>() &&
+         !request.HasOption<IfGenerationNotMatch>();
+}
+
+/**
+ * Invalidates cached entries that do not match the object being downloaded.
+ *
+ * Downloads do not return the full object metadata, but they do return the
+ * generation and metageneration of the object. If these do not match the
+ * cached metadata, or the download fails because the object does not exist,
+ * the cached entry is stale.
+ */
+class CacheValidatingReadSource : public ObjectReadSource {
+ public:
+  CacheValidatingReadSource(
+      std::unique_ptr<ObjectReadSource> child,
+      std::shared_ptr<ExpiringLruCache<ObjectMetadata>> cache, std::string key)
+      : child_(std::move(child)),
+        cache_(std::move(cache)),
+        key_(std::move(key)) {}
+
+  bool IsOpen() const override { return child_->IsOpen(); }
+  StatusOr<HttpResponse> Close() override { return child_->Close(); }
+
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override {
+    auto result = child_->Read(buf, n);
+    if (!validated_ && result) Validate(result->response);
+    return result;
+  }
+
+  StatusOr<ReadSourceBlock> ReadBlock(char* buf, std::size_t n) override {
+    auto result = child_->ReadBlock(buf, n);
+    if (!validated_ && result) Validate(result->response);
+    return result;
+  }
+
+ private:
+  void Validate(HttpResponse const& response) {
+    if (response.status_code == HttpStatusCode::kNotFound) {
+      cache_->Erase(key_);
+      validated_ = true;
+      return;
+    }
+    auto const& headers = response.headers;
+    auto g = headers.find("x-goog-generation");
+    auto m = headers.find("x-goog-metageneration");
+    if (g == headers.end() && m == headers.end()) return;
+    validated_ = true;
+    auto cached = cache_->Get(key_);
+    if (!cached) return;
+    if ((g != headers.end() &&
+         std::to_string(cached->generation()) != g->second) ||
+        (m != headers.end() &&
+         std::to_string(cached->metageneration()) != m->second)) {
+      cache_->Erase(key_);
+    }
+  }
+
+  std::unique_ptr<ObjectReadSource> child_;
+  std::shared_ptr<ExpiringLruCache<ObjectMetadata>> cache_;
+  std::string key_;
+  bool validated_ = false;
+};
+
+/// Invalidates the objects modified by each operation in a batch request.
+struct InvalidateBatchOperation {
+  ExpiringLruCache<ObjectMetadata>& cache;
+
+  template <typename Request>
+  void operator()(Request const& r) const {
+    cache.Erase(ObjectKey(r.bucket_name(), r.object_name()));
+  }
+};
+
+}  // namespace
+
+MetadataCacheClient::MetadataCacheClient(
+    std::shared_ptr<RawClient> client, std::size_t max_entries,
+    std::chrono::milliseconds ttl,
+    std::shared_ptr<MetadataCacheInvalidator> invalidator)
+    : client_(std::move(client)),
+      objects_(std::make_shared<ObjectCache>(max_entries, ttl)),
+      buckets_(max_entries, ttl) {
+  if (invalidator) invalidator->Register(objects_);
+}
+
+ClientOptions const& MetadataCacheClient::client_options() const {
+  return client_->client_options();
+}
+
+StatusOr<ListBucketsResponse> MetadataCacheClient::ListBuckets(
+    ListBucketsRequest const& request) {
+  return client_->ListBuckets(request);
+}
+
+StatusOr<BucketMetadata> MetadataCacheClient::CreateBucket(
+    CreateBucketRequest const& request) {
+  auto result = client_->CreateBucket(request);
+  if (result && ReturnsFullMetadata(request)) {
+    buckets_.Put(result->name(), *result);
+  }
+  return result;
+}
+
+StatusOr<BucketMetadata> MetadataCacheClient::GetBucketMetadata(
+    GetBucketMetadataRequest const& request) {
+  if (!IsCacheable(request)) return client_->GetBucketMetadata(request);
+  auto cached = buckets_.Get(request.bucket_name());
+  if (cached) return *std::move(cached);
+  auto result = client_->GetBucketMetadata(request);
+  if (result) buckets_.Put(request.bucket_name(), *result);
+  return result;
+}
+
+StatusOr<EmptyResponse> MetadataCacheClient::DeleteBucket(
+    DeleteBucketRequest const& request) {
+  auto result = client_->DeleteBucket(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<BucketMetadata> MetadataCacheClient::UpdateBucket(
+    UpdateBucketRequest const& request) {
+  auto result = client_->UpdateBucket(request);
+  InvalidateBucket(request.metadata().name());
+  if (result && ReturnsFullMetadata(request)) {
+    buckets_.Put(result->name(), *result);
+  }
+  return result;
+}
+
+StatusOr<BucketMetadata> MetadataCacheClient::PatchBucket(
+    PatchBucketRequest const& request) {
+  auto result = client_->PatchBucket(request);
+  InvalidateBucket(request.bucket());
+  if (result && ReturnsFullMetadata(request)) {
+    buckets_.Put(result->name(), *result);
+  }
+  return result;
+}
+
+StatusOr<IamPolicy> MetadataCacheClient::GetBucketIamPolicy(
+    GetBucketIamPolicyRequest const& request) {
+  return client_->GetBucketIamPolicy(request);
+}
+
+StatusOr<NativeIamPolicy> MetadataCacheClient::GetNativeBucketIamPolicy(
+    GetBucketIamPolicyRequest const& request) {
+  return client_->GetNativeBucketIamPolicy(request);
+}
+
+StatusOr<IamPolicy> MetadataCacheClient::SetBucketIamPolicy(
+    SetBucketIamPolicyRequest const& request) {
+  auto result = client_->SetBucketIamPolicy(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<NativeIamPolicy> MetadataCacheClient::SetNativeBucketIamPolicy(
+    SetNativeBucketIamPolicyRequest const& request) {
+  auto result = client_->SetNativeBucketIamPolicy(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<TestBucketIamPermissionsResponse>
+MetadataCacheClient::TestBucketIamPermissions(
+    TestBucketIamPermissionsRequest const& request) {
+  return client_->TestBucketIamPermissions(request);
+}
+
+StatusOr<BucketMetadata> MetadataCacheClient::LockBucketRetentionPolicy(
+    LockBucketRetentionPolicyRequest const& request) {
+  auto result = client_->LockBucketRetentionPolicy(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<ObjectMetadata> MetadataCacheClient::InsertObjectMedia(
+    InsertObjectMediaRequest const& request) {
+  auto result = client_->InsertObjectMedia(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  if (result && ReturnsFullMetadata(request)) {
+    objects_->Put(ObjectKey(result->bucket(), result->name()), *result);
+  }
+  return result;
+}
+
+StatusOr<ObjectMetadata> MetadataCacheClient::CopyObject(
+    CopyObjectRequest const& request) {
+  auto result = client_->CopyObject(request);
+  InvalidateObject(request.destination_bucket(), request.destination_object());
+  if (result && ReturnsFullMetadata(request)) {
+    objects_->Put(ObjectKey(result->bucket(), result->name()), *result);
+  }
+  return result;
+}
+
+StatusOr<ObjectMetadata> MetadataCacheClient::GetObjectMetadata(
+    GetObjectMetadataRequest const& request) {
+  if (!IsCacheable(request)) return client_->GetObjectMetadata(request);
+  auto const key = ObjectKey(request.bucket_name(), request.object_name());
+  auto cached = objects_->Get(key);
+  if (cached) return *std::move(cached);
+  auto result = client_->GetObjectMetadata(request);
+  if (result) objects_->Put(key, *result);
+  return result;
+}
+
+StatusOr<std::unique_ptr<ObjectReadSource>> MetadataCacheClient::ReadObject(
+    ReadObjectRangeRequest const& request) {
+  auto result = client_->ReadObject(request);
+  if (!result || request.HasOption<Generation>()) return result;
+  return std::unique_ptr<ObjectReadSource>(
+      absl::make_unique<CacheValidatingReadSource>(
+          *std::move(result), objects_,
+          ObjectKey(request.bucket_name(), request.object_name())));
+}
+
+StatusOr<ListObjectsResponse> MetadataCacheClient::ListObjects(
+    ListObjectsRequest const& request) {
+  return client_->ListObjects(request);
+}
+
+StatusOr<ListObjectsCompactResponse> MetadataCacheClient::ListObjectsCompact(
+    ListObjectsRequest const& request) {
+  return client_->ListObjectsCompact(request);
+}
+
+StatusOr<EmptyResponse> MetadataCacheClient::DeleteObject(
+    DeleteObjectRequest const& request) {
+  auto result = client_->DeleteObject(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  return result;
+}
+
+StatusOr<ObjectMetadata> MetadataCacheClient::UpdateObject(
+    UpdateObjectRequest const& request) {
+  auto result = client_->UpdateObject(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  if (result && ReturnsFullMetadata(request)) {
+    objects_->Put(ObjectKey(result->bucket(), result->name()), *result);
+  }
+  return result;
+}
+
+StatusOr<ObjectMetadata> MetadataCacheClient::PatchObject(
+    PatchObjectRequest const& request) {
+  auto result = client_->PatchObject(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  if (result && ReturnsFullMetadata(request)) {
+    objects_->Put(ObjectKey(result->bucket(), result->name()), *result);
+  }
+  return result;
+}
+
+StatusOr<ObjectMetadata> MetadataCacheClient::ComposeObject(
+    ComposeObjectRequest const& request) {
+  auto result = client_->ComposeObject(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  if (result && ReturnsFullMetadata(request)) {
+    objects_->Put(ObjectKey(result->bucket(), result->name()), *result);
+  }
+  return result;
+}
+
+StatusOr<RewriteObjectResponse> MetadataCacheClient::RewriteObject(
+    RewriteObjectRequest const& request) {
+  auto result = client_->RewriteObject(request);
+  InvalidateObject(request.destination_bucket(), request.destination_object());
+  if (result && result->done && ReturnsFullMetadata(request)) {
+    objects_->Put(ObjectKey(result->resource.bucket(), result->resource.name()),
+                  result->resource);
+  }
+  return result;
+}
+
+StatusOr<std::unique_ptr<ResumableUploadSession>>
+MetadataCacheClient::CreateResumableSession(
+    ResumableUploadRequest const& request) {
+  InvalidateObject(request.bucket_name(), request.object_name());
+  return client_->CreateResumableSession(request);
+}
+
+StatusOr<std::unique_ptr<ResumableUploadSession>>
+MetadataCacheClient::RestoreResumableSession(std::string const& request) {
+  return client_->RestoreResumableSession(request);
+}
+
+StatusOr<EmptyResponse> MetadataCacheClient::DeleteResumableUpload(
+    DeleteResumableUploadRequest const& request) {
+  return client_->DeleteResumableUpload(request);
+}
+
+StatusOr<ListBucketAclResponse> MetadataCacheClient::ListBucketAcl(
+    ListBucketAclRequest const& request) {
+  return client_->ListBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> MetadataCacheClient::CreateBucketAcl(
+    CreateBucketAclRequest const& request) {
+  auto result = client_->CreateBucketAcl(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<EmptyResponse> MetadataCacheClient::DeleteBucketAcl(
+    DeleteBucketAclRequest const& request) {
+  auto result = client_->DeleteBucketAcl(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<BucketAccessControl> MetadataCacheClient::GetBucketAcl(
+    GetBucketAclRequest const& request) {
+  return client_->GetBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> MetadataCacheClient::UpdateBucketAcl(
+    UpdateBucketAclRequest const& request) {
+  auto result = client_->UpdateBucketAcl(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<BucketAccessControl> MetadataCacheClient::PatchBucketAcl(
+    PatchBucketAclRequest const& request) {
+  auto result = client_->PatchBucketAcl(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<ListObjectAclResponse> MetadataCacheClient::ListObjectAcl(
+    ListObjectAclRequest const& request) {
+  return client_->ListObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> MetadataCacheClient::CreateObjectAcl(
+    CreateObjectAclRequest const& request) {
+  auto result = client_->CreateObjectAcl(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  return result;
+}
+
+StatusOr<EmptyResponse> MetadataCacheClient::DeleteObjectAcl(
+    DeleteObjectAclRequest const& request) {
+  auto result = client_->DeleteObjectAcl(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  return result;
+}
+
+StatusOr<ObjectAccessControl> MetadataCacheClient::GetObjectAcl(
+    GetObjectAclRequest const& request) {
+  return client_->GetObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> MetadataCacheClient::UpdateObjectAcl(
+    UpdateObjectAclRequest const& request) {
+  auto result = client_->UpdateObjectAcl(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  return result;
+}
+
+StatusOr<ObjectAccessControl> MetadataCacheClient::PatchObjectAcl(
+    PatchObjectAclRequest const& request) {
+  auto result = client_->PatchObjectAcl(request);
+  InvalidateObject(request.bucket_name(), request.object_name());
+  return result;
+}
+
+StatusOr<ListDefaultObjectAclResponse>
+MetadataCacheClient::ListDefaultObjectAcl(
+    ListDefaultObjectAclRequest const& request) {
+  return client_->ListDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> MetadataCacheClient::CreateDefaultObjectAcl(
+    CreateDefaultObjectAclRequest const& request) {
+  auto result = client_->CreateDefaultObjectAcl(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<EmptyResponse> MetadataCacheClient::DeleteDefaultObjectAcl(
+    DeleteDefaultObjectAclRequest const& request) {
+  auto result = client_->DeleteDefaultObjectAcl(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<ObjectAccessControl> MetadataCacheClient::GetDefaultObjectAcl(
+    GetDefaultObjectAclRequest const& request) {
+  return client_->GetDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> MetadataCacheClient::UpdateDefaultObjectAcl(
+    UpdateDefaultObjectAclRequest const& request) {
+  auto result = client_->UpdateDefaultObjectAcl(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<ObjectAccessControl> MetadataCacheClient::PatchDefaultObjectAcl(
+    PatchDefaultObjectAclRequest const& request) {
+  auto result = client_->PatchDefaultObjectAcl(request);
+  InvalidateBucket(request.bucket_name());
+  return result;
+}
+
+StatusOr<ServiceAccount> MetadataCacheClient::GetServiceAccount(
+    GetProjectServiceAccountRequest const& request) {
+  return client_->GetServiceAccount(request);
+}
+
+StatusOr<ListHmacKeysResponse> MetadataCacheClient::ListHmacKeys(
+    ListHmacKeysRequest const& request) {
+  return client_->ListHmacKeys(request);
+}
+
+StatusOr<CreateHmacKeyResponse> MetadataCacheClient::CreateHmacKey(
+    CreateHmacKeyRequest const& request) {
+  return client_->CreateHmacKey(request);
+}
+
+StatusOr<EmptyResponse> MetadataCacheClient::DeleteHmacKey(
+    DeleteHmacKeyRequest const& request) {
+  return client_->DeleteHmacKey(request);
+}
+
+StatusOr<HmacKeyMetadata> MetadataCacheClient::GetHmacKey(
+    GetHmacKeyRequest const& request) {
+  return client_->GetHmacKey(request);
+}
+
+StatusOr<HmacKeyMetadata> MetadataCacheClient::UpdateHmacKey(
+    UpdateHmacKeyRequest const& request) {
+  return client_->UpdateHmacKey(request);
+}
+
+StatusOr<SignBlobResponse> MetadataCacheClient::SignBlob(
+    SignBlobRequest const& request) {
+  return client_->SignBlob(request);
+}
+
+StatusOr<ListNotificationsResponse> MetadataCacheClient::ListNotifications(
+    ListNotificationsRequest const& request) {
+  return client_->ListNotifications(request);
+}
+
+StatusOr<NotificationMetadata> MetadataCacheClient::CreateNotification(
+    CreateNotificationRequest const& request) {
+  return client_->CreateNotification(request);
+}
+
+StatusOr<NotificationMetadata> MetadataCacheClient::GetNotification(
+    GetNotificationRequest const& request) {
+  return client_->GetNotification(request);
+}
+
+StatusOr<EmptyResponse> MetadataCacheClient::DeleteNotification(
+    DeleteNotificationRequest const& request) {
+  return client_->DeleteNotification(request);
+}
+
+StatusOr<BatchResponse> MetadataCacheClient::ExecuteBatch(
+    BatchRequest const& request) {
+  auto result = client_->ExecuteBatch(request);
+  for (auto const& op : request.operations()) {
+    absl::visit(InvalidateBatchOperation{*objects_}, op);
+  }
+  return result;
+}
+
+Status MetadataCacheClient::WarmUpConnectionPool() {
+  return client_->WarmUpConnectionPool();
+}
+
+void MetadataCacheClient::InvalidateObject(std::string const& bucket_name,
+                                           std::string const& object_name) {
+  objects_->Erase(ObjectKey(bucket_name, object_name));
+}
+
+void MetadataCacheClient::InvalidateBucket(std::string const& bucket_name) {
+  buckets_.Erase(bucket_name);
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,207 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/metadata_cache_client.h"
+#include "google/cloud/storage/internal/bucket_metadata_parser.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::MockObjectReadSource;
+using ::google::cloud::storage::testing::canonical_errors::TransientError;
+using ::testing::_;
+using ::testing::Return;
+
+ObjectMetadata CreateObject(int generation) {
+  return ObjectMetadataParser::FromString(R"""({
+      "bucket": "test-bucket",
+      "name": "test-object",
+      "generation": ")""" + std::to_string(generation) + R"""(",
+      "metageneration": "1",
+      "size": "1024"
+})""")
+      .value();
+}
+
+BucketMetadata CreateBucket() {
+  return BucketMetadataParser::FromString(R"""({
+      "name": "test-bucket",
+      "metageneration": "3"
+})""")
+      .value();
+}
+
+std::unique_ptr<MetadataCacheClient> CreateTestClient(
+    std::shared_ptr<RawClient> mock) {
+  return absl::make_unique<MetadataCacheClient>(std::move(mock), 16,
+                                                std::chrono::minutes(5));
+}
+
+TEST(MetadataCacheClientTest, GetObjectMetadataCached) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(TransientError())))
+      .WillOnce(Return(CreateObject(1)));
+  auto client = CreateTestClient(mock);
+
+  GetObjectMetadataRequest request("test-bucket", "test-object");
+  // Errors are not cached.
+  EXPECT_FALSE(client->GetObjectMetadata(request).ok());
+  for (int i = 0; i != 3; ++i) {
+    auto r = client->GetObjectMetadata(request);
+    ASSERT_STATUS_OK(r);
+    EXPECT_EQ(1, r->generation());
+  }
+}
+
+TEST(MetadataCacheClientTest, GetObjectMetadataNotCacheable) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .Times(4)
+      .WillRepeatedly(Return(CreateObject(1)));
+  auto client = CreateTestClient(mock);
+
+  GetObjectMetadataRequest request("test-bucket", "test-object");
+  ASSERT_STATUS_OK(client->GetObjectMetadata(
+      GetObjectMetadataRequest(request).set_option(Generation(1))));
+  ASSERT_STATUS_OK(client->GetObjectMetadata(
+      GetObjectMetadataRequest(request).set_option(IfGenerationMatch(1))));
+  ASSERT_STATUS_OK(client->GetObjectMetadata(
+      GetObjectMetadataRequest(request).set_option(Projection::Full())));
+  ASSERT_STATUS_OK(client->GetObjectMetadata(
+      GetObjectMetadataRequest(request).set_option(Fields("name"))));
+}
+
+TEST(MetadataCacheClientTest, InsertPopulatesCache) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, InsertObjectMedia(_)).WillOnce(Return(CreateObject(2)));
+  EXPECT_CALL(*mock, GetObjectMetadata(_)).Times(0);
+  auto client = CreateTestClient(mock);
+
+  ASSERT_STATUS_OK(client->InsertObjectMedia(
+      InsertObjectMediaRequest("test-bucket", "test-object", "contents")));
+  auto r = client->GetObjectMetadata(
+      GetObjectMetadataRequest("test-bucket", "test-object"));
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(2, r->generation());
+}
+
+TEST(MetadataCacheClientTest, DeleteInvalidatesCache) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(CreateObject(1)))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(
+          Status(StatusCode::kNotFound, "not found"))));
+  EXPECT_CALL(*mock, DeleteObject(_))
+      .WillOnce(Return(make_status_or(EmptyResponse{})));
+  auto client = CreateTestClient(mock);
+
+  GetObjectMetadataRequest request("test-bucket", "test-object");
+  ASSERT_STATUS_OK(client->GetObjectMetadata(request));
+  ASSERT_STATUS_OK(
+      client->DeleteObject(DeleteObjectRequest("test-bucket", "test-object")));
+  EXPECT_EQ(StatusCode::kNotFound,
+            client->GetObjectMetadata(request).status().code());
+}
+
+TEST(MetadataCacheClientTest, ReadObjectInvalidatesStaleEntry) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(CreateObject(1)))
+      .WillOnce(Return(CreateObject(2)));
+  EXPECT_CALL(*mock, ReadObject(_)).WillOnce([](ReadObjectRangeRequest const&) {
+    auto source = absl::make_unique<MockObjectReadSource>();
+    EXPECT_CALL(*source, Read(_, _))
+        .WillOnce(Return(make_status_or(ReadSourceResult{
+            0, HttpResponse{HttpStatusCode::kOk,
+                            {},
+                            {{"x-goog-generation", "2"},
+                             {"x-goog-metageneration", "1"}}}})));
+    return make_status_or(std::unique_ptr<ObjectReadSource>(std::move(source)));
+  });
+  auto client = CreateTestClient(mock);
+
+  GetObjectMetadataRequest request("test-bucket", "test-object");
+  ASSERT_STATUS_OK(client->GetObjectMetadata(request));
+  auto source =
+      client->ReadObject(ReadObjectRangeRequest("test-bucket", "test-object"));
+  ASSERT_STATUS_OK(source);
+  char buffer[16];
+  ASSERT_STATUS_OK((*source)->Read(buffer, sizeof(buffer)));
+
+  auto r = client->GetObjectMetadata(request);
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(2, r->generation());
+}
+
+TEST(MetadataCacheClientTest, GetBucketMetadataCached) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetBucketMetadata(_))
+      .Times(2)
+      .WillRepeatedly(Return(CreateBucket()));
+  EXPECT_CALL(*mock, PatchBucket(_))
+      .WillOnce(Return(StatusOr<BucketMetadata>(TransientError())));
+  auto client = CreateTestClient(mock);
+
+  GetBucketMetadataRequest request("test-bucket");
+  ASSERT_STATUS_OK(client->GetBucketMetadata(request));
+  ASSERT_STATUS_OK(client->GetBucketMetadata(request));
+  // Even failed updates invalidate the cache, the update may have succeeded.
+  EXPECT_FALSE(client
+                   ->PatchBucket(PatchBucketRequest(
+                       "test-bucket", BucketMetadataPatchBuilder{}))
+                   .ok());
+  auto r = client->GetBucketMetadata(request);
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(3, r->metageneration());
+}
+
+TEST(MetadataCacheClientTest, InvalidatorEvictsEntries) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(CreateObject(1)))
+      .WillOnce(Return(CreateObject(2)));
+  auto invalidator = std::make_shared<MetadataCacheInvalidator>();
+  auto client = absl::make_unique<MetadataCacheClient>(
+      mock, 16, std::chrono::minutes(5), invalidator);
+
+  GetObjectMetadataRequest request("test-bucket", "test-object");
+  auto r = client->GetObjectMetadata(request);
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(1, r->generation());
+  EXPECT_TRUE(invalidator->OnNotification({{"eventType", "OBJECT_FINALIZE"},
+                                           {"bucketId", "test-bucket"},
+                                           {"objectId", "test-object"},
+                                           {"objectGeneration", "2"}}));
+  r = client->GetObjectMetadata(request);
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(2, r->generation());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,552 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/metrics_client.h"
+#include "google/cloud/storage/internal/const_buffer.h"
+#include "google/cloud/storage/internal/raw_client_wrapper_utils.h"
+#include "absl/memory/memory.h"
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+namespace {
+
+using ::google::cloud::storage::internal::raw_client_wrapper_utils::Signature;
+
+std::chrono::microseconds ElapsedSince(
+    std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+/**
+ * Records the metrics for a `RawClient` operation.
+ *
+ * @tparam MemberFunction the signature of the member function.
+ * @param client the storage::RawClient object to make the call through.
+ * @param metrics where the metrics are recorded.
+ * @param mode what metrics are recorded.
+ * @param function the pointer to the member function to call.
+ * @param request an initialized request parameter for the call.
+ * @param context the name of the operation.
+ * @param bytes_sent the size of the payload sent by this operation.
+ * @return the result from making the call;
+ */
+template <typename MemberFunction>
+typename Signature<MemberFunction>::ReturnType MakeCall(
+    RawClient& client, ClientMetrics& metrics, MetricsClient::Mode mode,
+    MemberFunction function,
+    typename Signature<MemberFunction>::RequestType const& request,
+    char const* context, std::uint64_t bytes_sent = 0) {
+  if (mode == MetricsClient::Mode::kAttempts) {
+    metrics.RecordAttempt(context);
+    return (client.*function)(request);
+  }
+  auto const start = std::chrono::steady_clock::now();
+  auto response = (client.*function)(request);
+  metrics.RecordOperation(context, ElapsedSince(start), response.ok(),
+                          bytes_sent);
+  return response;
+}
+
+/// Records the bytes received, and the time to receive the first byte.
+class MetricsObjectReadSource : public ObjectReadSource {
+ public:
+  MetricsObjectReadSource(std::unique_ptr<ObjectReadSource> source,
+                          std::shared_ptr<ClientMetrics> metrics,
+                          char const* operation,
+                          std::chrono::steady_clock::time_point start)
+      : source_(std::move(source)),
+        metrics_(std::move(metrics)),
+        operation_(operation),
+        start_(start) {}
+
+  ~MetricsObjectReadSource() override { Flush(); }
+
+  bool IsOpen() const override { return source_->IsOpen(); }
+
+  StatusOr<HttpResponse> Close() override {
+    auto response = source_->Close();
+    Flush();
+    return response;
+  }
+
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override {
+    auto result = source_->Read(buf, n);
+    if (result) Update(result->bytes_received);
+    return result;
+  }
+
+  StatusOr<ReadSourceBlock> ReadBlock(char* buf, std::size_t n) override {
+    auto result = source_->ReadBlock(buf, n);
+    if (result) Update(result->bytes_received);
+    return result;
+  }
+
+ private:
+  void Update(std::size_t bytes_received) {
+    if (bytes_received == 0) return;
+    if (bytes_received_ == 0) time_to_first_byte_ = ElapsedSince(start_);
+    bytes_received_ += bytes_received;
+  }
+
+  // Recording the metrics on each `Read()` is wasteful, the totals are
+  // recorded once the download is closed or destroyed.
+  void Flush() {
+    if (bytes_received_ == 0) return;
+    metrics_->RecordDownload(operation_, time_to_first_byte_, bytes_received_);
+    bytes_received_ = 0;
+  }
+
+  std::unique_ptr<ObjectReadSource> source_;
+  std::shared_ptr<ClientMetrics> metrics_;
+  char const* operation_;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::microseconds time_to_first_byte_{0};
+  std::uint64_t bytes_received_ = 0;
+};
+
+/// Records the latency and bytes sent by each chunk of a resumable upload.
+class MetricsResumableUploadSession : public ResumableUploadSession {
+ public:
+  MetricsResumableUploadSession(std::unique_ptr<ResumableUploadSession> session,
+                                std::shared_ptr<ClientMetrics> metrics,
+                                MetricsClient::Mode mode)
+      : session_(std::move(session)),
+        metrics_(std::move(metrics)),
+        mode_(mode) {}
+
+  StatusOr<ResumableUploadResponse> UploadChunk(
+      ConstBufferSequence const& buffers) override {
+    return Record(__func__, TotalBytes(buffers),
+                  [&] { return session_->UploadChunk(buffers); });
+  }
+
+  StatusOr<ResumableUploadResponse> UploadFinalChunk(
+      ConstBufferSequence const& buffers, std::uint64_t upload_size) override {
+    return Record(__func__, TotalBytes(buffers), [&] {
+      return session_->UploadFinalChunk(buffers, upload_size);
+    });
+  }
+
+  StatusOr<ResumableUploadResponse> ResetSession() override {
+    return session_->ResetSession();
+  }
+  std::uint64_t next_expected_byte() const override {
+    return session_->next_expected_byte();
+  }
+  std::string const& session_id() const override {
+    return session_->session_id();
+  }
+  StatusOr<ResumableUploadResponse> const& last_response() const override {
+    return session_->last_response();
+  }
+  bool done() const override { return session_->done(); }
+
+ private:
+  template <typename Functor>
+  StatusOr<ResumableUploadResponse> Record(char const* operation,
+                                           std::uint64_t bytes_sent,
+                                           Functor&& functor) {
+    if (mode_ == MetricsClient::Mode::kAttempts) {
+      metrics_->RecordAttempt(operation);
+      return functor();
+    }
+    auto const start = std::chrono::steady_clock::now();
+    auto response = functor();
+    metrics_->RecordOperation(operation, ElapsedSince(start), response.ok(),
+                              bytes_sent);
+    return response;
+  }
+
+  std::unique_ptr<ResumableUploadSession> session_;
+  std::shared_ptr<ClientMetrics> metrics_;
+  MetricsClient::Mode mode_;
+};
+
+}  // namespace
+
+MetricsClient::MetricsClient(std::shared_ptr<RawClient> client,
+                             std::shared_ptr<ClientMetrics> metrics, Mode mode)
+    : client_(std::move(client)), metrics_(std::move(metrics)), mode_(mode) {}
+
+ClientOptions const& MetricsClient::client_options() const {
+  return client_->client_options();
+}
+
+StatusOr<ListBucketsResponse> MetricsClient::ListBuckets(
+    ListBucketsRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ListBuckets,
+                  request, __func__);
+}
+
+StatusOr<BucketMetadata> MetricsClient::CreateBucket(
+    CreateBucketRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::CreateBucket,
+                  request, __func__);
+}
+
+StatusOr<BucketMetadata> MetricsClient::GetBucketMetadata(
+    GetBucketMetadataRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetBucketMetadata,
+                  request, __func__);
+}
+
+StatusOr<EmptyResponse> MetricsClient::DeleteBucket(
+    DeleteBucketRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::DeleteBucket,
+                  request, __func__);
+}
+
+StatusOr<BucketMetadata> MetricsClient::UpdateBucket(
+    UpdateBucketRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::UpdateBucket,
+                  request, __func__);
+}
+
+StatusOr<BucketMetadata> MetricsClient::PatchBucket(
+    PatchBucketRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::PatchBucket,
+                  request, __func__);
+}
+
+StatusOr<IamPolicy> MetricsClient::GetBucketIamPolicy(
+    GetBucketIamPolicyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetBucketIamPolicy,
+                  request, __func__);
+}
+
+StatusOr<NativeIamPolicy> MetricsClient::GetNativeBucketIamPolicy(
+    GetBucketIamPolicyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_,
+                  &RawClient::GetNativeBucketIamPolicy, request, __func__);
+}
+
+StatusOr<IamPolicy> MetricsClient::SetBucketIamPolicy(
+    SetBucketIamPolicyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::SetBucketIamPolicy,
+                  request, __func__);
+}
+
+StatusOr<NativeIamPolicy> MetricsClient::SetNativeBucketIamPolicy(
+    SetNativeBucketIamPolicyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_,
+                  &RawClient::SetNativeBucketIamPolicy, request, __func__);
+}
+
+StatusOr<TestBucketIamPermissionsResponse>
+MetricsClient::TestBucketIamPermissions(
+    TestBucketIamPermissionsRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_,
+                  &RawClient::TestBucketIamPermissions, request, __func__);
+}
+
+StatusOr<BucketMetadata> MetricsClient::LockBucketRetentionPolicy(
+    LockBucketRetentionPolicyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_,
+                  &RawClient::LockBucketRetentionPolicy, request, __func__);
+}
+
+StatusOr<ObjectMetadata> MetricsClient::InsertObjectMedia(
+    InsertObjectMediaRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::InsertObjectMedia,
+                  request, __func__, request.contents().size());
+}
+
+StatusOr<ObjectMetadata> MetricsClient::CopyObject(
+    CopyObjectRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::CopyObject,
+                  request, __func__);
+}
+
+StatusOr<ObjectMetadata> MetricsClient::GetObjectMetadata(
+    GetObjectMetadataRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetObjectMetadata,
+                  request, __func__);
+}
+
+StatusOr<std::unique_ptr<ObjectReadSource>> MetricsClient::ReadObject(
+    ReadObjectRangeRequest const& request) {
+  auto const start = std::chrono::steady_clock::now();
+  auto source = MakeCall(*client_, *metrics_, mode_, &RawClient::ReadObject,
+                         request, __func__);
+  if (!source || mode_ != Mode::kOperations) return source;
+  return std::unique_ptr<ObjectReadSource>(
+      absl::make_unique<MetricsObjectReadSource>(*std::move(source), metrics_,
+                                                 __func__, start));
+}
+
+StatusOr<ListObjectsResponse> MetricsClient::ListObjects(
+    ListObjectsRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ListObjects,
+                  request, __func__);
+}
+
+StatusOr<ListObjectsCompactResponse> MetricsClient::ListObjectsCompact(
+    ListObjectsRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ListObjectsCompact,
+                  request, __func__);
+}
+
+StatusOr<EmptyResponse> MetricsClient::DeleteObject(
+    DeleteObjectRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::DeleteObject,
+                  request, __func__);
+}
+
+StatusOr<ObjectMetadata> MetricsClient::UpdateObject(
+    UpdateObjectRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::UpdateObject,
+                  request, __func__);
+}
+
+StatusOr<ObjectMetadata> MetricsClient::PatchObject(
+    PatchObjectRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::PatchObject,
+                  request, __func__);
+}
+
+StatusOr<ObjectMetadata> MetricsClient::ComposeObject(
+    ComposeObjectRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ComposeObject,
+                  request, __func__);
+}
+
+StatusOr<RewriteObjectResponse> MetricsClient::RewriteObject(
+    RewriteObjectRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::RewriteObject,
+                  request, __func__);
+}
+
+StatusOr<std::unique_ptr<ResumableUploadSession>>
+MetricsClient::CreateResumableSession(ResumableUploadRequest const& request) {
+  auto session = MakeCall(*client_, *metrics_, mode_,
+                          &RawClient::CreateResumableSession, request,
+                          __func__);
+  if (!session) return session;
+  return std::unique_ptr<ResumableUploadSession>(
+      absl::make_unique<MetricsResumableUploadSession>(*std::move(session),
+                                                       metrics_, mode_));
+}
+
+StatusOr<std::unique_ptr<ResumableUploadSession>>
+MetricsClient::RestoreResumableSession(std::string const& request) {
+  auto session = MakeCall(*client_, *metrics_, mode_,
+                          &RawClient::RestoreResumableSession, request,
+                          __func__);
+  if (!session) return session;
+  return std::unique_ptr<ResumableUploadSession>(
+      absl::make_unique<MetricsResumableUploadSession>(*std::move(session),
+                                                       metrics_, mode_));
+}
+
+StatusOr<EmptyResponse> MetricsClient::DeleteResumableUpload(
+    DeleteResumableUploadRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::DeleteResumableUpload,
+                  request, __func__);
+}
+
+StatusOr<ListBucketAclResponse> MetricsClient::ListBucketAcl(
+    ListBucketAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ListBucketAcl,
+                  request, __func__);
+}
+
+StatusOr<BucketAccessControl> MetricsClient::CreateBucketAcl(
+    CreateBucketAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::CreateBucketAcl,
+                  request, __func__);
+}
+
+StatusOr<EmptyResponse> MetricsClient::DeleteBucketAcl(
+    DeleteBucketAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::DeleteBucketAcl,
+                  request, __func__);
+}
+
+StatusOr<BucketAccessControl> MetricsClient::GetBucketAcl(
+    GetBucketAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetBucketAcl,
+                  request, __func__);
+}
+
+StatusOr<BucketAccessControl> MetricsClient::UpdateBucketAcl(
+    UpdateBucketAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::UpdateBucketAcl,
+                  request, __func__);
+}
+
+StatusOr<BucketAccessControl> MetricsClient::PatchBucketAcl(
+    PatchBucketAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::PatchBucketAcl,
+                  request, __func__);
+}
+
+StatusOr<ListObjectAclResponse> MetricsClient::ListObjectAcl(
+    ListObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ListObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<ObjectAccessControl> MetricsClient::CreateObjectAcl(
+    CreateObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::CreateObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<EmptyResponse> MetricsClient::DeleteObjectAcl(
+    DeleteObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::DeleteObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<ObjectAccessControl> MetricsClient::GetObjectAcl(
+    GetObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<ObjectAccessControl> MetricsClient::UpdateObjectAcl(
+    UpdateObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::UpdateObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<ObjectAccessControl> MetricsClient::PatchObjectAcl(
+    PatchObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::PatchObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<ListDefaultObjectAclResponse> MetricsClient::ListDefaultObjectAcl(
+    ListDefaultObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ListDefaultObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<ObjectAccessControl> MetricsClient::CreateDefaultObjectAcl(
+    CreateDefaultObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_,
+                  &RawClient::CreateDefaultObjectAcl, request, __func__);
+}
+
+StatusOr<EmptyResponse> MetricsClient::DeleteDefaultObjectAcl(
+    DeleteDefaultObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_,
+                  &RawClient::DeleteDefaultObjectAcl, request, __func__);
+}
+
+StatusOr<ObjectAccessControl> MetricsClient::GetDefaultObjectAcl(
+    GetDefaultObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetDefaultObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<ObjectAccessControl> MetricsClient::UpdateDefaultObjectAcl(
+    UpdateDefaultObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_,
+                  &RawClient::UpdateDefaultObjectAcl, request, __func__);
+}
+
+StatusOr<ObjectAccessControl> MetricsClient::PatchDefaultObjectAcl(
+    PatchDefaultObjectAclRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::PatchDefaultObjectAcl,
+                  request, __func__);
+}
+
+StatusOr<ServiceAccount> MetricsClient::GetServiceAccount(
+    GetProjectServiceAccountRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetServiceAccount,
+                  request, __func__);
+}
+
+StatusOr<ListHmacKeysResponse> MetricsClient::ListHmacKeys(
+    ListHmacKeysRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ListHmacKeys,
+                  request, __func__);
+}
+
+StatusOr<CreateHmacKeyResponse> MetricsClient::CreateHmacKey(
+    CreateHmacKeyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::CreateHmacKey,
+                  request, __func__);
+}
+
+StatusOr<EmptyResponse> MetricsClient::DeleteHmacKey(
+    DeleteHmacKeyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::DeleteHmacKey,
+                  request, __func__);
+}
+
+StatusOr<HmacKeyMetadata> MetricsClient::GetHmacKey(
+    GetHmacKeyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetHmacKey,
+                  request, __func__);
+}
+
+StatusOr<HmacKeyMetadata> MetricsClient::UpdateHmacKey(
+    UpdateHmacKeyRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::UpdateHmacKey,
+                  request, __func__);
+}
+
+StatusOr<SignBlobResponse> MetricsClient::SignBlob(
+    SignBlobRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::SignBlob,
+                  request, __func__);
+}
+
+StatusOr<ListNotificationsResponse> MetricsClient::ListNotifications(
+    ListNotificationsRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ListNotifications,
+                  request, __func__);
+}
+
+StatusOr<NotificationMetadata> MetricsClient::CreateNotification(
+    CreateNotificationRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::CreateNotification,
+                  request, __func__);
+}
+
+StatusOr<NotificationMetadata> MetricsClient::GetNotification(
+    GetNotificationRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::GetNotification,
+                  request, __func__);
+}
+
+StatusOr<EmptyResponse> MetricsClient::DeleteNotification(
+    DeleteNotificationRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::DeleteNotification,
+                  request, __func__);
+}
+
+StatusOr<BatchResponse> MetricsClient::ExecuteBatch(
+    BatchRequest const& request) {
+  return MakeCall(*client_, *metrics_, mode_, &RawClient::ExecuteBatch,
+                  request, __func__);
+}
+
+Status MetricsClient::WarmUpConnectionPool() {
+  return client_->WarmUpConnectionPool();
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
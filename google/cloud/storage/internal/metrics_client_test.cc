@@ -0,0 +1,171 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/metrics_client.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::MockObjectReadSource;
+using ::google::cloud::storage::testing::MockResumableUploadSession;
+using ::google::cloud::storage::testing::canonical_errors::TransientError;
+using ::testing::_;
+using ::testing::Return;
+
+ObjectMetadata CreateObject() {
+  return ObjectMetadataParser::FromString(R"""({
+      "bucket": "test-bucket",
+      "name": "test-object",
+      "generation": "42"
+})""")
+      .value();
+}
+
+TEST(MetricsClientTest, RecordsOperations) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(CreateObject()))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(TransientError())));
+  auto metrics = std::make_shared<ClientMetrics>();
+  MetricsClient client(mock, metrics, MetricsClient::Mode::kOperations);
+
+  GetObjectMetadataRequest request("test-bucket", "test-object");
+  EXPECT_STATUS_OK(client.GetObjectMetadata(request));
+  EXPECT_FALSE(client.GetObjectMetadata(request).ok());
+
+  auto snapshot = metrics->Snapshot();
+  ASSERT_EQ(1, snapshot.count("GetObjectMetadata"));
+  auto const& m = snapshot["GetObjectMetadata"];
+  EXPECT_EQ(2, m.count);
+  EXPECT_EQ(1, m.errors);
+  EXPECT_EQ(0, m.attempts);
+  EXPECT_EQ(2, m.latency.count());
+}
+
+TEST(MetricsClientTest, RecordsAttempts) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(TransientError())))
+      .WillOnce(Return(CreateObject()));
+  auto metrics = std::make_shared<ClientMetrics>();
+  auto attempts = std::make_shared<MetricsClient>(
+      mock, metrics, MetricsClient::Mode::kAttempts);
+  MetricsClient client(attempts, metrics, MetricsClient::Mode::kOperations);
+
+  // Simulate a retry loop between the two decorators.
+  GetObjectMetadataRequest request("test-bucket", "test-object");
+  EXPECT_FALSE(attempts->GetObjectMetadata(request).ok());
+  EXPECT_STATUS_OK(client.GetObjectMetadata(request));
+
+  auto snapshot = metrics->Snapshot();
+  auto const& m = snapshot["GetObjectMetadata"];
+  EXPECT_EQ(1, m.count);
+  EXPECT_EQ(0, m.errors);
+  EXPECT_EQ(2, m.attempts);
+  EXPECT_EQ(1, m.retries());
+}
+
+TEST(MetricsClientTest, InsertObjectMediaBytes) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, InsertObjectMedia(_)).WillOnce(Return(CreateObject()));
+  auto metrics = std::make_shared<ClientMetrics>();
+  MetricsClient client(mock, metrics, MetricsClient::Mode::kOperations);
+
+  EXPECT_STATUS_OK(client.InsertObjectMedia(InsertObjectMediaRequest(
+      "test-bucket", "test-object", std::string(1000, 'x'))));
+  auto snapshot = metrics->Snapshot();
+  EXPECT_EQ(1000, snapshot["InsertObjectMedia"].bytes_sent);
+}
+
+TEST(MetricsClientTest, ReadObject) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, ReadObject(_)).WillOnce([](ReadObjectRangeRequest const&) {
+    auto source = absl::make_unique<MockObjectReadSource>();
+    EXPECT_CALL(*source, Read)
+        .WillOnce(Return(ReadSourceResult{
+            100, HttpResponse{HttpStatusCode::kContinue, {}, {}}}))
+        .WillOnce(Return(
+            ReadSourceResult{50, HttpResponse{HttpStatusCode::kOk, {}, {}}}));
+    EXPECT_CALL(*source, Close)
+        .WillOnce(Return(HttpResponse{HttpStatusCode::kOk, {}, {}}));
+    return make_status_or(std::unique_ptr<ObjectReadSource>(std::move(source)));
+  });
+  auto metrics = std::make_shared<ClientMetrics>();
+  MetricsClient client(mock, metrics, MetricsClient::Mode::kOperations);
+
+  auto source =
+      client.ReadObject(ReadObjectRangeRequest("test-bucket", "test-object"));
+  ASSERT_STATUS_OK(source);
+  char buffer[128];
+  EXPECT_STATUS_OK((*source)->Read(buffer, sizeof(buffer)));
+  EXPECT_STATUS_OK((*source)->Read(buffer, sizeof(buffer)));
+  // The download metrics are recorded once the download is closed.
+  EXPECT_EQ(0, metrics->Snapshot()["ReadObject"].bytes_received);
+  EXPECT_STATUS_OK((*source)->Close());
+  source->reset();
+
+  auto snapshot = metrics->Snapshot();
+  auto const& m = snapshot["ReadObject"];
+  EXPECT_EQ(1, m.count);
+  EXPECT_EQ(150, m.bytes_received);
+  EXPECT_EQ(1, m.time_to_first_byte.count());
+}
+
+TEST(MetricsClientTest, ResumableUpload) {
+  auto mock = std::make_shared<testing::MockClient>();
+  EXPECT_CALL(*mock, CreateResumableSession(_))
+      .WillOnce([](ResumableUploadRequest const&) {
+        auto session = absl::make_unique<MockResumableUploadSession>();
+        EXPECT_CALL(*session, UploadChunk)
+            .WillOnce(Return(ResumableUploadResponse{}));
+        EXPECT_CALL(*session, UploadFinalChunk)
+            .WillOnce(Return(ResumableUploadResponse{}));
+        return make_status_or(
+            std::unique_ptr<ResumableUploadSession>(std::move(session)));
+      });
+  auto metrics = std::make_shared<ClientMetrics>();
+  MetricsClient client(mock, metrics, MetricsClient::Mode::kOperations);
+
+  auto session = client.CreateResumableSession(
+      ResumableUploadRequest("test-bucket", "test-object"));
+  ASSERT_STATUS_OK(session);
+  std::string const chunk(256 * 1024, 'x');
+  EXPECT_STATUS_OK((*session)->UploadChunk({{chunk.data(), chunk.size()}}));
+  EXPECT_STATUS_OK(
+      (*session)->UploadFinalChunk({{chunk.data(), 100}}, chunk.size() + 100));
+
+  auto snapshot = metrics->Snapshot();
+  EXPECT_EQ(1, snapshot["CreateResumableSession"].count);
+  EXPECT_EQ(1, snapshot["UploadChunk"].count);
+  EXPECT_EQ(chunk.size(), snapshot["UploadChunk"].bytes_sent);
+  EXPECT_EQ(1, snapshot["UploadFinalChunk"].count);
+  EXPECT_EQ(100, snapshot["UploadFinalChunk"].bytes_sent);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -15,6 +15,7 @@
 #include "google/cloud/storage/internal/object_metadata_parser.h"
 #include "google/cloud/storage/internal/common_metadata_parser.h"
 #include "google/cloud/storage/internal/object_access_control_parser.h"
+#include "google/cloud/storage/internal/object_metadata_sax_parser.h"
 #include "google/cloud/internal/format_time_point.h"
 #include <nlohmann/json.hpp>
 
@@ -102,8 +103,7 @@ StatusOr<ObjectMetadata> ObjectMetadataParser::FromJson(
 
 StatusOr<ObjectMetadata> ObjectMetadataParser::FromString(
     std::string const& payload) {
-  auto json = nlohmann::json::parse(payload, nullptr, false);
-  return FromJson(json);
+  return ParseObjectMetadata(payload);
 }
 
 nlohmann::json ObjectMetadataJsonForCompose(ObjectMetadata const& meta) {
@@ -0,0 +1,723 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/object_metadata_sax_parser.h"
+#include "google/cloud/storage/internal/object_access_control_parser.h"
+#include "google/cloud/storage/internal/stage_timer.h"
+#include "google/cloud/internal/parse_rfc3339.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include <nlohmann/json.hpp>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+namespace {
+
+using value_t = nlohmann::json::value_t;
+
+/// A scalar value reported by the SAX parser.
+struct JsonScalar {
+  value_t type = value_t::null;
+  bool boolean = false;
+  std::int64_t integer = 0;
+  std::uint64_t unsigned_integer = 0;
+  double number = 0;
+  std::string* string = nullptr;
+
+  bool is_string() const { return type == value_t::string; }
+
+  /// Move the value of a string field, other types return an empty string.
+  std::string TakeString() const {
+    if (!is_string()) return {};
+    return std::move(*string);
+  }
+
+  // The conversions match the `Parse*Field()` functions in metadata_parser.h.
+  std::int64_t AsInt64(char const* field_name) const {
+    switch (type) {
+      case value_t::number_integer:
+        return integer;
+      case value_t::number_unsigned:
+        return static_cast<std::int64_t>(unsigned_integer);
+      case value_t::number_float:
+        return static_cast<std::int64_t>(number);
+      case value_t::string:
+        return std::stoll(*string);
+      default:
+        break;
+    }
+    google::cloud::internal::ThrowInvalidArgument(
+        std::string("Error parsing field <") + field_name +
+        "> as an std::int64_t");
+  }
+
+  std::uint64_t AsUInt64(char const* field_name) const {
+    switch (type) {
+      case value_t::number_integer:
+        return static_cast<std::uint64_t>(integer);
+      case value_t::number_unsigned:
+        return unsigned_integer;
+      case value_t::number_float:
+        return static_cast<std::uint64_t>(number);
+      case value_t::string:
+        return std::stoull(*string);
+      default:
+        break;
+    }
+    google::cloud::internal::ThrowInvalidArgument(
+        std::string("Error parsing field <") + field_name +
+        "> as an std::uint64_t");
+  }
+
+  bool AsBool(char const* field_name) const {
+    if (type == value_t::boolean) return boolean;
+    if (is_string() && *string == "true") return true;
+    if (is_string() && *string == "false") return false;
+    google::cloud::internal::ThrowInvalidArgument(
+        std::string("Error parsing field <") + field_name + "> as a boolean");
+  }
+
+  std::chrono::system_clock::time_point AsTimestamp() const {
+    return google::cloud::internal::ParseRfc3339(is_string() ? *string : "");
+  }
+
+  nlohmann::json ToJson() const {
+    switch (type) {
+      case value_t::boolean:
+        return boolean;
+      case value_t::number_integer:
+        return integer;
+      case value_t::number_unsigned:
+        return unsigned_integer;
+      case value_t::number_float:
+        return number;
+      case value_t::string:
+        return std::move(*string);
+      default:
+        break;
+    }
+    return nullptr;
+  }
+};
+
+}  // namespace
+
+/**
+ * Populates a `ListObjectsResponse` from the events of a SAX parser.
+ *
+ * The handler keeps a stack with the (interesting) JSON objects and arrays
+ * containing the current value. Values that do not map to any field are
+ * skipped by counting their nesting depth, without allocating any memory.
+ */
+class ListObjectsSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+ public:
+  /**
+   * Creates a handler for a `ListObjects` response.
+   *
+   * If @p single_object is true the payload is the metadata for a single
+   * object, which is stored as the only element of `response.items`.
+   */
+  explicit ListObjectsSaxHandler(ListObjectsResponse& response,
+                                 bool single_object = false)
+      : response_(response), single_object_(single_object) {}
+
+  Status const& status() const { return status_; }
+
+  bool null() override { return Scalar(JsonScalar{}); }
+  bool boolean(bool v) override {
+    JsonScalar s;
+    s.type = value_t::boolean;
+    s.boolean = v;
+    return Scalar(s);
+  }
+  bool number_integer(number_integer_t v) override {
+    JsonScalar s;
+    s.type = value_t::number_integer;
+    s.integer = v;
+    return Scalar(s);
+  }
+  bool number_unsigned(number_unsigned_t v) override {
+    JsonScalar s;
+    s.type = value_t::number_unsigned;
+    s.unsigned_integer = v;
+    return Scalar(s);
+  }
+  bool number_float(number_float_t v, string_t const&) override {
+    JsonScalar s;
+    s.type = value_t::number_float;
+    s.number = v;
+    return Scalar(s);
+  }
+  bool string(string_t& v) override {
+    JsonScalar s;
+    s.type = value_t::string;
+    s.string = &v;
+    return Scalar(s);
+  }
+  // The JSON parser never generates binary values.
+  bool binary(binary_t&) override { return Scalar(JsonScalar{}); }
+
+  bool start_object(std::size_t) override;
+  bool key(string_t& v) override;
+  bool end_object() override;
+  bool start_array(std::size_t) override;
+  bool end_array() override;
+
+  bool parse_error(std::size_t, std::string const&,
+                   nlohmann::detail::exception const& ex) override {
+    return Error(StatusCode::kInvalidArgument, ex.what());
+  }
+
+ private:
+  enum class State {
+    kResponse,
+    kItems,
+    kItem,
+    kOwner,
+    kCustomerEncryption,
+    kMetadata,
+    kAcl,
+    kPrefixes,
+  };
+
+  ObjectMetadata& item() { return response_.items.back(); }
+
+  bool Error(StatusCode code, std::string message) {
+    status_ = Status(code, std::move(message));
+    return false;
+  }
+  bool NotAnObject() {
+    return Error(StatusCode::kInvalidArgument, "ParseListObjectsResponse");
+  }
+  bool PrefixNotAString() {
+    return Error(StatusCode::kInternal,
+                 "List Objects Response's 'prefix' is not a string.");
+  }
+
+  bool Scalar(JsonScalar const& value);
+  void SetItemField(JsonScalar const& value);
+  nlohmann::json& Capture(nlohmann::json value);
+
+  ListObjectsResponse& response_;
+  bool single_object_;
+  Status status_;
+  std::vector<State> stack_;
+  int skip_depth_ = 0;
+  std::string key_;
+  // The `acl` entries are captured as a small DOM.
+  nlohmann::json capture_;
+  std::vector<nlohmann::json*> capture_stack_;
+  std::string capture_key_;
+};
+
+bool ListObjectsSaxHandler::start_object(std::size_t) {
+  if (skip_depth_ > 0) {
+    ++skip_depth_;
+    return true;
+  }
+  if (!capture_stack_.empty()) {
+    capture_stack_.push_back(&Capture(nlohmann::json::object()));
+    return true;
+  }
+  if (stack_.empty()) {
+    if (!single_object_) {
+      stack_.push_back(State::kResponse);
+      return true;
+    }
+    response_.items.emplace_back();
+    stack_.push_back(State::kItem);
+    return true;
+  }
+  switch (stack_.back()) {
+    case State::kItems:
+      response_.items.emplace_back();
+      stack_.push_back(State::kItem);
+      return true;
+    case State::kItem:
+      if (key_ == "owner") {
+        item().owner_ = Owner{};
+        stack_.push_back(State::kOwner);
+        return true;
+      }
+      if (key_ == "customerEncryption") {
+        item().customer_encryption_ = CustomerEncryption{};
+        stack_.push_back(State::kCustomerEncryption);
+        return true;
+      }
+      if (key_ == "metadata") {
+        stack_.push_back(State::kMetadata);
+        return true;
+      }
+      break;
+    case State::kAcl:
+      capture_ = nlohmann::json::object();
+      capture_stack_.push_back(&capture_);
+      return true;
+    case State::kPrefixes:
+      return PrefixNotAString();
+    default:
+      break;
+  }
+  skip_depth_ = 1;
+  return true;
+}
+
+bool ListObjectsSaxHandler::key(string_t& v) {
+  if (skip_depth_ > 0) return true;
+  // Reuse the buffer, most keys are short but a few are not.
+  if (!capture_stack_.empty()) {
+    capture_key_.assign(v);
+  } else {
+    key_.assign(v);
+  }
+  return true;
+}
+
+bool ListObjectsSaxHandler::end_object() {
+  if (skip_depth_ > 0) {
+    --skip_depth_;
+    return true;
+  }
+  if (!capture_stack_.empty()) {
+    capture_stack_.pop_back();
+    if (!capture_stack_.empty()) return true;
+    auto parsed = ObjectAccessControlParser::FromJson(capture_);
+    if (!parsed) {
+      status_ = std::move(parsed).status();
+      return false;
+    }
+    item().acl_.push_back(*std::move(parsed));
+    return true;
+  }
+  if (!stack_.empty()) stack_.pop_back();
+  return true;
+}
+
+bool ListObjectsSaxHandler::start_array(std::size_t) {
+  if (skip_depth_ > 0) {
+    ++skip_depth_;
+    return true;
+  }
+  if (!capture_stack_.empty()) {
+    capture_stack_.push_back(&Capture(nlohmann::json::array()));
+    return true;
+  }
+  if (stack_.empty()) return NotAnObject();
+  switch (stack_.back()) {
+    case State::kResponse:
+      if (key_ == "items") {
+        stack_.push_back(State::kItems);
+        return true;
+      }
+      if (key_ == "prefixes") {
+        stack_.push_back(State::kPrefixes);
+        return true;
+      }
+      break;
+    case State::kItem:
+      if (key_ == "acl") {
+        stack_.push_back(State::kAcl);
+        return true;
+      }
+      break;
+    case State::kItems:
+    case State::kAcl:
+      return NotAnObject();
+    case State::kPrefixes:
+      return PrefixNotAString();
+    default:
+      break;
+  }
+  skip_depth_ = 1;
+  return true;
+}
+
+bool ListObjectsSaxHandler::end_array() {
+  if (skip_depth_ > 0) {
+    --skip_depth_;
+    return true;
+  }
+  if (!capture_stack_.empty()) {
+    capture_stack_.pop_back();
+    return true;
+  }
+  if (!stack_.empty()) stack_.pop_back();
+  return true;
+}
+
+bool ListObjectsSaxHandler::Scalar(JsonScalar const& value) {
+  if (skip_depth_ > 0) return true;
+  if (!capture_stack_.empty()) {
+    Capture(value.ToJson());
+    return true;
+  }
+  if (stack_.empty()) return NotAnObject();
+  switch (stack_.back()) {
+    case State::kResponse:
+      if (key_ == "nextPageToken") {
+        response_.next_page_token = value.TakeString();
+      }
+      return true;
+    case State::kItems:
+    case State::kAcl:
+      return NotAnObject();
+    case State::kItem:
+      SetItemField(value);
+      return true;
+    case State::kOwner:
+      if (key_ == "entity") item().owner_->entity = value.TakeString();
+      if (key_ == "entityId") item().owner_->entity_id = value.TakeString();
+      return true;
+    case State::kCustomerEncryption:
+      if (key_ == "encryptionAlgorithm") {
+        item().customer_encryption_->encryption_algorithm = value.TakeString();
+      }
+      if (key_ == "keySha256") {
+        item().customer_encryption_->key_sha256 = value.TakeString();
+      }
+      return true;
+    case State::kMetadata:
+      item().metadata_.emplace(key_, value.TakeString());
+      return true;
+    case State::kPrefixes:
+      if (!value.is_string()) return PrefixNotAString();
+      response_.prefixes.push_back(value.TakeString());
+      return true;
+  }
+  return true;
+}
+
+void ListObjectsSaxHandler::SetItemField(JsonScalar const& value) {
+  auto& m = item();
+  // Keep the fields in alphabetical order.
+  if (key_ == "bucket") {
+    m.bucket_ = value.TakeString();
+  } else if (key_ == "cacheControl") {
+    m.cache_control_ = value.TakeString();
+  } else if (key_ == "componentCount") {
+    m.component_count_ =
+        static_cast<std::int32_t>(value.AsInt64("componentCount"));
+  } else if (key_ == "contentDisposition") {
+    m.content_disposition_ = value.TakeString();
+  } else if (key_ == "contentEncoding") {
+    m.content_encoding_ = value.TakeString();
+  } else if (key_ == "contentLanguage") {
+    m.content_language_ = value.TakeString();
+  } else if (key_ == "contentType") {
+    m.content_type_ = value.TakeString();
+  } else if (key_ == "crc32c") {
+    m.crc32c_ = value.TakeString();
+  } else if (key_ == "customTime") {
+    m.custom_time_ = value.AsTimestamp();
+  } else if (key_ == "etag") {
+    m.etag_ = value.TakeString();
+  } else if (key_ == "eventBasedHold") {
+    m.event_based_hold_ = value.AsBool("eventBasedHold");
+  } else if (key_ == "generation") {
+    m.generation_ = value.AsInt64("generation");
+  } else if (key_ == "id") {
+    m.id_ = value.TakeString();
+  } else if (key_ == "kind") {
+    m.kind_ = value.TakeString();
+  } else if (key_ == "kmsKeyName") {
+    m.kms_key_name_ = value.TakeString();
+  } else if (key_ == "md5Hash") {
+    m.md5_hash_ = value.TakeString();
+  } else if (key_ == "mediaLink") {
+    m.media_link_ = value.TakeString();
+  } else if (key_ == "metageneration") {
+    m.metageneration_ = value.AsInt64("metageneration");
+  } else if (key_ == "name") {
+    m.name_ = value.TakeString();
+  } else if (key_ == "retentionExpirationTime") {
+    m.retention_expiration_time_ = value.AsTimestamp();
+  } else if (key_ == "selfLink") {
+    m.self_link_ = value.TakeString();
+  } else if (key_ == "size") {
+    m.size_ = value.AsUInt64("size");
+  } else if (key_ == "storageClass") {
+    m.storage_class_ = value.TakeString();
+  } else if (key_ == "temporaryHold") {
+    m.temporary_hold_ = value.AsBool("temporaryHold");
+  } else if (key_ == "timeCreated") {
+    m.time_created_ = value.AsTimestamp();
+  } else if (key_ == "timeDeleted") {
+    m.time_deleted_ = value.AsTimestamp();
+  } else if (key_ == "timeStorageClassUpdated") {
+    m.time_storage_class_updated_ = value.AsTimestamp();
+  } else if (key_ == "updated") {
+    m.updated_ = value.AsTimestamp();
+  }
+}
+
+nlohmann::json& ListObjectsSaxHandler::Capture(nlohmann::json value) {
+  auto& parent = *capture_stack_.back();
+  if (parent.is_array()) {
+    parent.push_back(std::move(value));
+    return parent.back();
+  }
+  return parent[capture_key_] = std::move(value);
+}
+
+/**
+ * Populates a `CompactObjectList` from the events of a SAX parser.
+ *
+ * Only the top-level fields of each item are of interest, all the nested
+ * objects and arrays in the items are skipped.
+ */
+class CompactListObjectsSaxHandler
+    : public nlohmann::json_sax<nlohmann::json> {
+ public:
+  explicit CompactListObjectsSaxHandler(ListObjectsCompactResponse& response)
+      : response_(response) {}
+
+  Status const& status() const { return status_; }
+
+  bool null() override { return Scalar(JsonScalar{}); }
+  bool boolean(bool v) override {
+    JsonScalar s;
+    s.type = value_t::boolean;
+    s.boolean = v;
+    return Scalar(s);
+  }
+  bool number_integer(number_integer_t v) override {
+    JsonScalar s;
+    s.type = value_t::number_integer;
+    s.integer = v;
+    return Scalar(s);
+  }
+  bool number_unsigned(number_unsigned_t v) override {
+    JsonScalar s;
+    s.type = value_t::number_unsigned;
+    s.unsigned_integer = v;
+    return Scalar(s);
+  }
+  bool number_float(number_float_t v, string_t const&) override {
+    JsonScalar s;
+    s.type = value_t::number_float;
+    s.number = v;
+    return Scalar(s);
+  }
+  bool string(string_t& v) override {
+    JsonScalar s;
+    s.type = value_t::string;
+    s.string = &v;
+    return Scalar(s);
+  }
+  bool binary(binary_t&) override { return Scalar(JsonScalar{}); }
+
+  bool start_object(std::size_t) override;
+  bool key(string_t& v) override {
+    if (skip_depth_ == 0) key_.assign(v);
+    return true;
+  }
+  bool end_object() override;
+  bool start_array(std::size_t) override;
+  bool end_array() override;
+
+  bool parse_error(std::size_t, std::string const&,
+                   nlohmann::detail::exception const& ex) override {
+    return Error(StatusCode::kInvalidArgument, ex.what());
+  }
+
+ private:
+  enum class State {
+    kResponse,
+    kItems,
+    kItem,
+    kPrefixes,
+  };
+
+  bool Error(StatusCode code, std::string message) {
+    status_ = Status(code, std::move(message));
+    return false;
+  }
+  bool NotAnObject() {
+    return Error(StatusCode::kInvalidArgument,
+                 "ParseListObjectsCompactResponse");
+  }
+  bool PrefixNotAString() {
+    return Error(StatusCode::kInternal,
+                 "List Objects Response's 'prefix' is not a string.");
+  }
+
+  bool Scalar(JsonScalar const& value);
+
+  ListObjectsCompactResponse& response_;
+  Status status_;
+  std::vector<State> stack_;
+  int skip_depth_ = 0;
+  std::string key_;
+  // The item being parsed, `item_.name` refers to `name_`.
+  CompactObjectMetadata item_;
+  std::string name_;
+};
+
+bool CompactListObjectsSaxHandler::start_object(std::size_t) {
+  if (skip_depth_ > 0) {
+    ++skip_depth_;
+    return true;
+  }
+  if (stack_.empty()) {
+    stack_.push_back(State::kResponse);
+    return true;
+  }
+  switch (stack_.back()) {
+    case State::kItems:
+      item_ = CompactObjectMetadata{};
+      name_.clear();
+      stack_.push_back(State::kItem);
+      return true;
+    case State::kPrefixes:
+      return PrefixNotAString();
+    default:
+      break;
+  }
+  skip_depth_ = 1;
+  return true;
+}
+
+bool CompactListObjectsSaxHandler::end_object() {
+  if (skip_depth_ > 0) {
+    --skip_depth_;
+    return true;
+  }
+  if (stack_.empty()) return true;
+  if (stack_.back() == State::kItem) {
+    item_.name = name_;
+    response_.items.Append(item_);
+  }
+  stack_.pop_back();
+  return true;
+}
+
+bool CompactListObjectsSaxHandler::start_array(std::size_t) {
+  if (skip_depth_ > 0) {
+    ++skip_depth_;
+    return true;
+  }
+  if (stack_.empty()) return NotAnObject();
+  switch (stack_.back()) {
+    case State::kResponse:
+      if (key_ == "items") {
+        stack_.push_back(State::kItems);
+        return true;
+      }
+      if (key_ == "prefixes") {
+        stack_.push_back(State::kPrefixes);
+        return true;
+      }
+      break;
+    case State::kItems:
+      return NotAnObject();
+    case State::kPrefixes:
+      return PrefixNotAString();
+    default:
+      break;
+  }
+  skip_depth_ = 1;
+  return true;
+}
+
+bool CompactListObjectsSaxHandler::end_array() {
+  if (skip_depth_ > 0) {
+    --skip_depth_;
+    return true;
+  }
+  if (!stack_.empty()) stack_.pop_back();
+  return true;
+}
+
+bool CompactListObjectsSaxHandler::Scalar(JsonScalar const& value) {
+  if (skip_depth_ > 0) return true;
+  if (stack_.empty()) return NotAnObject();
+  switch (stack_.back()) {
+    case State::kResponse:
+      if (key_ == "nextPageToken") {
+        response_.next_page_token = value.TakeString();
+      }
+      return true;
+    case State::kItems:
+      return NotAnObject();
+    case State::kItem:
+      break;
+    case State::kPrefixes:
+      if (!value.is_string()) return PrefixNotAString();
+      response_.items.AddPrefix(value.TakeString());
+      return true;
+  }
+  // Reuse the buffer for the name, it is copied into the list.
+  if (key_ == "name") {
+    if (value.is_string()) name_.assign(*value.string);
+  } else if (key_ == "size") {
+    item_.size = value.AsUInt64("size");
+  } else if (key_ == "generation") {
+    item_.generation = value.AsInt64("generation");
+  } else if (key_ == "crc32c") {
+    if (value.is_string()) item_.crc32c = DecodeCrc32c(*value.string);
+  } else if (key_ == "timeCreated") {
+    item_.time_created = value.AsTimestamp();
+  } else if (key_ == "updated") {
+    item_.updated = value.AsTimestamp();
+  }
+  return true;
+}
+
+StatusOr<ListObjectsResponse> ParseListObjectsResponse(
+    std::string const& payload) {
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kJsonParsing);
+  ListObjectsResponse response;
+  ListObjectsSaxHandler handler(response);
+  if (!nlohmann::json::sax_parse(payload, &handler)) {
+    if (!handler.status().ok()) return handler.status();
+    return Status(StatusCode::kInvalidArgument, __func__);
+  }
+  return response;
+}
+
+StatusOr<ListObjectsCompactResponse> ParseListObjectsCompactResponse(
+    std::string const& payload) {
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kJsonParsing);
+  ListObjectsCompactResponse response;
+  CompactListObjectsSaxHandler handler(response);
+  if (!nlohmann::json::sax_parse(payload, &handler)) {
+    if (!handler.status().ok()) return handler.status();
+    return Status(StatusCode::kInvalidArgument, __func__);
+  }
+  return response;
+}
+
+StatusOr<ObjectMetadata> ParseObjectMetadata(std::string const& payload) {
+  GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kJsonParsing);
+  ListObjectsResponse response;
+  ListObjectsSaxHandler handler(response, /*single_object=*/true);
+  if (!nlohmann::json::sax_parse(payload, &handler)) {
+    if (!handler.status().ok()) return handler.status();
+    return Status(StatusCode::kInvalidArgument, __func__);
+  }
+  if (response.items.empty()) {
+    return Status(StatusCode::kInvalidArgument, __func__);
+  }
+  return std::move(response.items.front());
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
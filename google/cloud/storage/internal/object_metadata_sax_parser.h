@@ -0,0 +1,65 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_OBJECT_METADATA_SAX_PARSER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_OBJECT_METADATA_SAX_PARSER_H
+
+#include "google/cloud/storage/internal/object_requests.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status_or.h"
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Parses a `ListObjects` response without creating a `nlohmann::json` DOM.
+ *
+ * The parser populates each `ObjectMetadata` directly from the events
+ * generated by a streaming (SAX) JSON parser. Only the (rare) `acl` entries
+ * use a small DOM, so they can reuse `ObjectAccessControlParser`. The result
+ * is the same as parsing the payload with `nlohmann::json::parse()` followed by
+ * `ObjectMetadataParser::FromJson()` for each item, but it performs far fewer
+ * allocations.
+ */
+StatusOr<ListObjectsResponse> ParseListObjectsResponse(
+    std::string const& payload);
+
+/**
+ * Parses a `ListObjects` response into a `CompactObjectList`.
+ *
+ * Only the fields kept by `CompactObjectList` are parsed, all other fields are
+ * skipped without allocating memory.
+ */
+StatusOr<ListObjectsCompactResponse> ParseListObjectsCompactResponse(
+    std::string const& payload);
+
+/**
+ * Parses the metadata for a single object without creating a DOM.
+ *
+ * Fields not present in the payload, for example, because the request used
+ * the `Fields` parameter, retain their default values.
+ */
+StatusOr<ObjectMetadata> ParseObjectMetadata(std::string const& payload);
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_OBJECT_METADATA_SAX_PARSER_H
@@ -0,0 +1,249 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/object_metadata_sax_parser.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <nlohmann/json.hpp>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+
+std::string FullObject() {
+  return R"""({
+      "acl": [{
+        "kind": "storage#objectAccessControl",
+        "id": "acl-id-0",
+        "entity": "user-qux",
+        "projectTeam": {"projectNumber": "123456789", "team": "owners"}
+      }, {
+        "kind": "storage#objectAccessControl",
+        "id": "acl-id-1",
+        "entity": "user-quux"
+      }],
+      "bucket": "foo-bar",
+      "cacheControl": "no-cache",
+      "componentCount": 7,
+      "contentDisposition": "a-disposition",
+      "contentEncoding": "an-encoding",
+      "contentLanguage": "a-language",
+      "contentType": "application/octet-stream",
+      "crc32c": "deadbeef",
+      "customTime": "2020-08-10T12:34:56Z",
+      "customerEncryption": {
+        "encryptionAlgorithm": "some-algo",
+        "keySha256": "abc123"
+      },
+      "etag": "XYZ=",
+      "eventBasedHold": true,
+      "generation": "12345",
+      "id": "foo-bar/baz/12345",
+      "kind": "storage#object",
+      "kmsKeyName": "/foo/bar/baz/key",
+      "md5Hash": "deaderBeef=",
+      "mediaLink": "https://storage.googleapis.com/download/storage/v1/b/foo",
+      "metadata": {
+        "foo": "bar",
+        "baz": "qux"
+      },
+      "metageneration": "4",
+      "name": "baz",
+      "owner": {
+        "entity": "user-qux",
+        "entityId": "user-qux-id-123"
+      },
+      "retentionExpirationTime": "2019-01-19T19:31:24Z",
+      "selfLink": "https://storage.googleapis.com/storage/v1/b/foo-bar/baz",
+      "size": 102400,
+      "storageClass": "STANDARD",
+      "temporaryHold": "false",
+      "timeCreated": "2018-05-19T19:31:14Z",
+      "timeDeleted": "2018-05-19T19:32:24Z",
+      "timeStorageClassUpdated": "2018-05-19T19:31:34Z",
+      "updated": "2018-05-19T19:31:24Z",
+      "unknownObject": {"nested": [1, 2, {"a": null}]},
+      "unknownArray": [[1], {"b": 2.5}]
+})""";
+}
+
+std::string MinimalObject() {
+  return R"""({"bucket": "foo-bar", "name": "qux", "generation": 7})""";
+}
+
+TEST(ObjectMetadataSaxParserTest, MatchesDomParser) {
+  auto const text = R"""({
+      "kind": "storage#objects",
+      "nextPageToken": "some-token-42",
+      "items": [)""" + FullObject() +
+                    "," + MinimalObject() + R"""(],
+      "prefixes": ["foo/", "qux/"],
+      "unknown": {"items": ["not-an-item"]}})""";
+
+  auto o1 = ObjectMetadataParser::FromJson(nlohmann::json::parse(FullObject()));
+  ASSERT_STATUS_OK(o1);
+  auto o2 =
+      ObjectMetadataParser::FromJson(nlohmann::json::parse(MinimalObject()));
+  ASSERT_STATUS_OK(o2);
+
+  auto actual = ParseListObjectsResponse(text);
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ("some-token-42", actual->next_page_token);
+  EXPECT_THAT(actual->items, ElementsAre(*o1, *o2));
+  EXPECT_THAT(actual->prefixes, ElementsAre("foo/", "qux/"));
+  auto const& acl = actual->items.front().acl();
+  ASSERT_THAT(acl, SizeIs(2));
+  EXPECT_EQ("owners", acl.front().project_team().team);
+  EXPECT_TRUE(actual->items.front().has_custom_time());
+  EXPECT_FALSE(actual->items.back().has_custom_time());
+  EXPECT_FALSE(actual->items.back().has_owner());
+}
+
+TEST(ObjectMetadataSaxParserTest, SingleObject) {
+  auto expected =
+      ObjectMetadataParser::FromJson(nlohmann::json::parse(FullObject()));
+  ASSERT_STATUS_OK(expected);
+  auto actual = ParseObjectMetadata(FullObject());
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(*expected, *actual);
+}
+
+TEST(ObjectMetadataSaxParserTest, SingleObjectPartialResponse) {
+  auto actual = ParseObjectMetadata(
+      R"""({"name": "baz", "size": "1024", "generation": "7"})""");
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ("baz", actual->name());
+  EXPECT_EQ(1024, actual->size());
+  EXPECT_EQ(7, actual->generation());
+  EXPECT_THAT(actual->bucket(), IsEmpty());
+  EXPECT_THAT(actual->acl(), IsEmpty());
+  EXPECT_THAT(actual->metadata(), IsEmpty());
+}
+
+TEST(ObjectMetadataSaxParserTest, SingleObjectInvalid) {
+  EXPECT_THAT(ParseObjectMetadata("{123"),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseObjectMetadata("[]"),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseObjectMetadata("\"foo\""),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ObjectMetadataSaxParserTest, Empty) {
+  auto actual = ParseListObjectsResponse("{}");
+  ASSERT_STATUS_OK(actual);
+  EXPECT_THAT(actual->next_page_token, IsEmpty());
+  EXPECT_THAT(actual->items, IsEmpty());
+  EXPECT_THAT(actual->prefixes, IsEmpty());
+}
+
+TEST(ObjectMetadataSaxParserTest, InvalidJson) {
+  EXPECT_THAT(ParseListObjectsResponse("{123"),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseListObjectsResponse(""),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ObjectMetadataSaxParserTest, NotAnObject) {
+  EXPECT_THAT(ParseListObjectsResponse("[]"),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseListObjectsResponse("\"foo\""),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ObjectMetadataSaxParserTest, InvalidItem) {
+  EXPECT_THAT(ParseListObjectsResponse(R"""({"items": ["invalid-item"]})"""),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseListObjectsResponse(R"""({"items": [[]]})"""),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ObjectMetadataSaxParserTest, InvalidAcl) {
+  EXPECT_THAT(
+      ParseListObjectsResponse(R"""({"items": [{"acl": ["invalid"]}]})"""),
+      StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ObjectMetadataSaxParserTest, InvalidPrefix) {
+  EXPECT_THAT(ParseListObjectsResponse(R"""({"prefixes": [1]})"""),
+              StatusIs(StatusCode::kInternal));
+  EXPECT_THAT(ParseListObjectsResponse(R"""({"prefixes": [{}]})"""),
+              StatusIs(StatusCode::kInternal));
+}
+
+TEST(ObjectMetadataSaxParserTest, CompactMatchesDomParser) {
+  auto const text = R"""({
+      "kind": "storage#objects",
+      "nextPageToken": "some-token-42",
+      "items": [)""" + FullObject() +
+                    "," + MinimalObject() + R"""(],
+      "prefixes": ["foo/", "qux/"],
+      "unknown": {"items": ["not-an-item"]}})""";
+
+  auto o1 = ObjectMetadataParser::FromJson(nlohmann::json::parse(FullObject()));
+  ASSERT_STATUS_OK(o1);
+  auto o2 =
+      ObjectMetadataParser::FromJson(nlohmann::json::parse(MinimalObject()));
+  ASSERT_STATUS_OK(o2);
+
+  auto actual = ParseListObjectsCompactResponse(text);
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ("some-token-42", actual->next_page_token);
+  EXPECT_THAT(actual->items.prefixes(), ElementsAre("foo/", "qux/"));
+  ASSERT_EQ(2U, actual->items.size());
+  std::vector<ObjectMetadata> expected{*o1, *o2};
+  for (std::size_t i = 0; i != expected.size(); ++i) {
+    auto const m = actual->items[i];
+    EXPECT_EQ(expected[i].name(), std::string(m.name));
+    EXPECT_EQ(expected[i].size(), m.size);
+    EXPECT_EQ(expected[i].generation(), m.generation);
+    EXPECT_EQ(expected[i].time_created(), m.time_created);
+    EXPECT_EQ(expected[i].updated(), m.updated);
+  }
+}
+
+TEST(ObjectMetadataSaxParserTest, CompactCrc32c) {
+  auto actual = ParseListObjectsCompactResponse(R"""({"items": [
+      {"name": "a", "crc32c": "ImIEBA=="}, {"name": "b"}]})""");
+  ASSERT_STATUS_OK(actual);
+  ASSERT_EQ(2U, actual->items.size());
+  EXPECT_EQ(0x22620404U, actual->items[0].crc32c.value_or(0));
+  EXPECT_FALSE(actual->items[1].crc32c.has_value());
+}
+
+TEST(ObjectMetadataSaxParserTest, CompactInvalid) {
+  EXPECT_THAT(ParseListObjectsCompactResponse("{123"),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseListObjectsCompactResponse(R"""({"items": [1]})"""),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseListObjectsCompactResponse(R"""({"prefixes": [1]})"""),
+              StatusIs(StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -49,6 +49,19 @@ struct ReadSourceResult {
   HttpResponse response;
 };
 
+/**
+ * The result of reading a block of data from the source.
+ *
+ * This is similar to `ReadSourceResult`, but the data is in `data`, which may
+ * point to the buffer provided by the caller or to a buffer owned by the
+ * source.
+ */
+struct ReadSourceBlock {
+  char* data;
+  std::size_t bytes_received;
+  HttpResponse response;
+};
+
 /**
  * A data source for ObjectReadStreambuf.
  *
@@ -69,6 +82,24 @@ class ObjectReadSource {
   /// Read more data from the download, returning any HTTP headers and error
   /// codes.
   virtual StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) = 0;
+
+  /**
+   * Read up to @p n bytes, without copying them if possible.
+   *
+   * Sources that receive the data in their own buffers (such as gRPC, where
+   * the data arrives as part of a protobuf message) can return a pointer into
+   * these buffers, avoiding a copy into @p buf. The returned data remains
+   * valid until the next call to any member function in this object, or until
+   * the object is destroyed.
+   *
+   * The default implementation reads into @p buf.
+   */
+  virtual StatusOr<ReadSourceBlock> ReadBlock(char* buf, std::size_t n) {
+    auto result = Read(buf, n);
+    if (!result) return std::move(result).status();
+    return ReadSourceBlock{buf, result->bytes_received,
+                           std::move(result->response)};
+  }
 };
 
 /**
@@ -18,6 +18,7 @@
 #include "google/cloud/storage/internal/metadata_parser.h"
 #include "google/cloud/storage/internal/object_acl_requests.h"
 #include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/internal/object_metadata_sax_parser.h"
 #include "google/cloud/storage/object_metadata.h"
 #include <cinttypes>
 #include <sstream>
@@ -39,32 +40,7 @@ std::ostream& operator<<(std::ostream& os, ListObjectsRequest const& r) {
 
 StatusOr<ListObjectsResponse> ListObjectsResponse::FromHttpResponse(
     std::string const& payload) {
-  auto json = nlohmann::json::parse(payload, nullptr, false);
-  if (!json.is_object()) {
-    return Status(StatusCode::kInvalidArgument, __func__);
-  }
-
-  ListObjectsResponse result;
-  result.next_page_token = json.value("nextPageToken", "");
-
-  for (auto const& kv : json["items"].items()) {
-    auto parsed = internal::ObjectMetadataParser::FromJson(kv.value());
-    if (!parsed.ok()) {
-      return std::move(parsed).status();
-    }
-    result.items.emplace_back(std::move(*parsed));
-  }
-
-  for (auto const& prefix_iterator : json["prefixes"].items()) {
-    auto const& prefix = prefix_iterator.value();
-    if (!prefix.is_string()) {
-      return Status(StatusCode::kInternal,
-                    "List Objects Response's 'prefix' is not a string.");
-    }
-    result.prefixes.emplace_back(prefix.get<std::string>());
-  }
-
-  return result;
+  return ParseListObjectsResponse(payload);
 }
 
 std::ostream& operator<<(std::ostream& os, ListObjectsResponse const& r) {
@@ -78,6 +54,24 @@ std::ostream& operator<<(std::ostream& os, ListObjectsResponse const& r) {
   return os << "}}";
 }
 
+StatusOr<ListObjectsCompactResponse>
+ListObjectsCompactResponse::FromHttpResponse(std::string const& payload) {
+  return ParseListObjectsCompactResponse(payload);
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         ListObjectsCompactResponse const& r) {
+  // Compact listings are used for very large results, only the first few
+  // objects are worth logging.
+  std::size_t constexpr kMaxItems = 8;
+  os << "ListObjectsCompactResponse={next_page_token=" << r.next_page_token
+     << ", items.size=" << r.items.size() << ", items={";
+  for (std::size_t i = 0; i != r.items.size() && i != kMaxItems; ++i) {
+    os << r.items[i] << "\n  ";
+  }
+  return os << "}, prefixes.size=" << r.items.prefixes().size() << "}";
+}
+
 std::ostream& operator<<(std::ostream& os, GetObjectMetadataRequest const& r) {
   os << "GetObjectMetadataRequest={bucket_name=" << r.bucket_name()
      << ", object_name=" << r.object_name();
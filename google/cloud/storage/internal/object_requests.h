@@ -15,15 +15,20 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_OBJECT_REQUESTS_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_OBJECT_REQUESTS_H
 
+#include "google/cloud/storage/compact_object_list.h"
 #include "google/cloud/storage/download_options.h"
+#include "google/cloud/storage/file_io_options.h"
 #include "google/cloud/storage/hashing_options.h"
 #include "google/cloud/storage/internal/const_buffer.h"
 #include "google/cloud/storage/internal/generic_object_request.h"
 #include "google/cloud/storage/internal/http_response.h"
+#include "google/cloud/storage/internal/mapped_file.h"
+#include "google/cloud/storage/list_objects_options.h"
 #include "google/cloud/storage/object_metadata.h"
 #include "google/cloud/storage/upload_options.h"
 #include "google/cloud/storage/version.h"
 #include "google/cloud/storage/well_known_parameters.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include <numeric>
 #include <vector>
@@ -39,7 +44,8 @@ namespace internal {
 class ListObjectsRequest
     : public GenericRequest<ListObjectsRequest, MaxResults, Prefix, Delimiter,
                             IncludeTrailingDelimiter, StartOffset, EndOffset,
-                            Projection, UserProject, Versions> {
+                            Projection, PrefetchNextPage, UserProject,
+                            Versions> {
  public:
   ListObjectsRequest() = default;
   explicit ListObjectsRequest(std::string bucket_name)
@@ -70,6 +76,19 @@ struct ListObjectsResponse {
 
 std::ostream& operator<<(std::ostream& os, ListObjectsResponse const& r);
 
+/// The response for `RawClient::ListObjectsCompact()`.
+struct ListObjectsCompactResponse {
+  static StatusOr<ListObjectsCompactResponse> FromHttpResponse(
+      std::string const& payload);
+
+  std::string next_page_token;
+  /// The objects and prefixes in this page.
+  CompactObjectList items;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         ListObjectsCompactResponse const& r);
+
 /**
  * Represents a request to the `Objects: get` API.
  */
@@ -94,12 +113,13 @@ std::ostream& operator<<(std::ostream& os, GetObjectMetadataRequest const& r);
  */
 class InsertObjectMediaRequest
     : public GenericObjectRequest<
-          InsertObjectMediaRequest, ContentEncoding, ContentType,
-          Crc32cChecksumValue, DisableCrc32cChecksum, DisableMD5Hash,
-          EncryptionKey, IfGenerationMatch, IfGenerationNotMatch,
-          IfMetagenerationMatch, IfMetagenerationNotMatch, KmsKeyName,
-          MD5HashValue, PredefinedAcl, Projection, UserProject,
-          UploadFromOffset, UploadLimit, WithObjectMetadata> {
+          InsertObjectMediaRequest, AdaptiveUploadChunkSize, ContentEncoding,
+          ContentType, Crc32cChecksumValue, DisableCrc32cChecksum,
+          DisableMD5Hash, EncryptionKey, IfGenerationMatch,
+          IfGenerationNotMatch, IfMetagenerationMatch, IfMetagenerationNotMatch,
+          KmsKeyName, MD5HashValue, PredefinedAcl, Projection,
+          UseDirectFileIO, UserProject, UploadFromOffset, UploadLimit,
+          WithObjectMetadata> {
  public:
   InsertObjectMediaRequest() = default;
 
@@ -109,14 +129,27 @@ class InsertObjectMediaRequest
       : GenericObjectRequest(std::move(bucket_name), std::move(object_name)),
         contents_(std::move(contents)) {}
 
-  std::string const& contents() const { return contents_; }
+  /// The object contents, either a string or a memory-mapped file region.
+  absl::string_view contents() const {
+    if (mapped_contents_) return mapped_contents_->contents();
+    return contents_;
+  }
   InsertObjectMediaRequest& set_contents(std::string&& v) {
     contents_ = std::move(v);
+    mapped_contents_.reset();
+    return *this;
+  }
+  /// Upload the contents directly from a memory-mapped file region.
+  InsertObjectMediaRequest& set_contents(
+      std::shared_ptr<MappedFileRegion const> v) {
+    contents_.clear();
+    mapped_contents_ = std::move(v);
     return *this;
   }
 
  private:
   std::string contents_;
+  std::shared_ptr<MappedFileRegion const> mapped_contents_;
 };
 
 std::ostream& operator<<(std::ostream& os, InsertObjectMediaRequest const& r);
@@ -161,10 +194,11 @@ std::ostream& operator<<(std::ostream& os, CopyObjectRequest const& r);
  */
 class ReadObjectRangeRequest
     : public GenericObjectRequest<
-          ReadObjectRangeRequest, DisableCrc32cChecksum, DisableMD5Hash,
-          EncryptionKey, Generation, IfGenerationMatch, IfGenerationNotMatch,
-          IfMetagenerationMatch, IfMetagenerationNotMatch, ReadFromOffset,
-          ReadRange, ReadLast, UserProject> {
+          ReadObjectRangeRequest, DecompressGzip, DisableCrc32cChecksum,
+          DisableMD5Hash, EncryptionKey, Generation, IfGenerationMatch,
+          IfGenerationNotMatch, IfMetagenerationMatch, IfMetagenerationNotMatch,
+          ParallelReadStreams, ReadFromOffset, ReadRange, ReadLast,
+          UseBackgroundHashing, UseDirectFileIO, UserProject> {
  public:
   using GenericObjectRequest::GenericObjectRequest;
 
@@ -339,13 +373,14 @@ std::ostream& operator<<(std::ostream& os, RewriteObjectResponse const& r);
  */
 class ResumableUploadRequest
     : public GenericObjectRequest<
-          ResumableUploadRequest, ContentEncoding, ContentType,
-          Crc32cChecksumValue, DisableCrc32cChecksum, DisableMD5Hash,
-          EncryptionKey, IfGenerationMatch, IfGenerationNotMatch,
-          IfMetagenerationMatch, IfMetagenerationNotMatch, KmsKeyName,
-          MD5HashValue, PredefinedAcl, Projection, UseResumableUploadSession,
-          UserProject, UploadFromOffset, UploadLimit, WithObjectMetadata,
-          UploadContentLength> {
+          ResumableUploadRequest, AdaptiveUploadChunkSize, ContentEncoding,
+          ContentType, Crc32cChecksumValue, DisableCrc32cChecksum,
+          DisableMD5Hash, EncryptionKey, GzipCompression, IfGenerationMatch,
+          IfGenerationNotMatch, IfMetagenerationMatch, IfMetagenerationNotMatch,
+          KmsKeyName, MD5HashValue, PipelinedUploadBuffers, PredefinedAcl,
+          Projection, UseBackgroundHashing, UseDirectFileIO,
+          UseResumableUploadSession, UserProject, UploadFromOffset,
+          UploadLimit, WithObjectMetadata, UploadContentLength> {
  public:
   ResumableUploadRequest() = default;
 
@@ -14,9 +14,11 @@
 
 #include "google/cloud/storage/internal/object_streambuf.h"
 #include "google/cloud/storage/internal/object_requests.h"
+#include "google/cloud/storage/internal/stage_timer.h"
 #include "google/cloud/storage/object_stream.h"
 #include "google/cloud/log.h"
 #include "absl/memory/memory.h"
+#include <chrono>
 #include <cstring>
 
 namespace google {
@@ -26,15 +28,18 @@ inline namespace STORAGE_CLIENT_NS {
 namespace internal {
 ObjectReadStreambuf::ObjectReadStreambuf(
     ReadObjectRangeRequest const& request,
-    std::unique_ptr<ObjectReadSource> source, std::streamoff pos_in_stream)
+    std::unique_ptr<ObjectReadSource> source, std::streamoff pos_in_stream,
+    std::shared_ptr<BufferPool> buffer_pool)
     : source_(std::move(source)),
       source_pos_(pos_in_stream),
+      buffer_pool_(std::move(buffer_pool)),
       hash_validator_(CreateHashValidator(request)) {}
 
 ObjectReadStreambuf::ObjectReadStreambuf(ReadObjectRangeRequest const&,
                                          Status status)
     : source_(new ObjectReadErrorSource(status)),
       source_pos_(-1),
+      buffer_pool_(DefaultBufferPool()),
       hash_validator_(absl::make_unique<NullHashValidator>()),
       status_(std::move(status)) {}
 
@@ -57,16 +62,21 @@ StatusOr<ObjectReadStreambuf::int_type> ObjectReadStreambuf::Peek() {
   }
 
   auto constexpr kInitialPeekRead = 128 * 1024;
-  current_ios_buffer_.resize(kInitialPeekRead);
+  // The buffer is allocated once, and reused for each `Peek()` call.
+  if (current_ios_buffer_.empty()) {
+    current_ios_buffer_ = PooledBuffer(buffer_pool_, kInitialPeekRead);
+  }
   std::size_t n = current_ios_buffer_.size();
-  StatusOr<ReadSourceResult> read_result =
-      source_->Read(current_ios_buffer_.data(), n);
+  // Some sources (notably gRPC) return the data in their own buffers, in that
+  // case the get area points to these buffers and the data is not copied.
+  StatusOr<ReadSourceBlock> read_result =
+      source_->ReadBlock(current_ios_buffer_.data(), n);
   if (!read_result.ok()) {
     return std::move(read_result).status();
   }
   source_pos_ += read_result->bytes_received;
   // assert(n <= current_ios_buffer_.size())
-  current_ios_buffer_.resize(read_result->bytes_received);
+  auto const received = read_result->bytes_received;
 
   for (auto const& kv : read_result->response.headers) {
     hash_validator_->ProcessHeader(kv.first, kv.second);
@@ -76,10 +86,10 @@ StatusOr<ObjectReadStreambuf::int_type> ObjectReadStreambuf::Peek() {
     return AsStatus(read_result->response);
   }
 
-  if (!current_ios_buffer_.empty()) {
-    char* data = current_ios_buffer_.data();
-    hash_validator_->Update(data, current_ios_buffer_.size());
-    setg(data, data, data + current_ios_buffer_.size());
+  if (received != 0) {
+    char* data = read_result->data;
+    hash_validator_->Update(data, received);
+    setg(data, data, data + received);
     return traits_type::to_int_type(*data);
   }
 
@@ -178,6 +188,7 @@ std::streamsize ObjectReadStreambuf::xsgetn(char* s, std::streamsize count) {
   // read more in that case:
   auto from_internal = (std::min)(count, in_avail());
   if (from_internal > 0) {
+    GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kCopy);
     std::memcpy(s, gptr(), static_cast<std::size_t>(from_internal));
   }
   gbump(static_cast<int>(from_internal));
@@ -217,6 +228,39 @@ std::streamsize ObjectReadStreambuf::xsgetn(char* s, std::streamsize count) {
   return run_validator_if_closed(Status());
 }
 
+absl::Span<char const> ObjectReadStreambuf::ReadSome() {
+  if (!status_.ok()) return {};
+  if (gptr() == egptr()) {
+    // Refill the get area directly from the data source, this is the only copy
+    // of the data, the application consumes it in place.
+    auto next_char = Peek();
+    if (!next_char) {
+      status_ = std::move(next_char).status();
+      return {};
+    }
+    if (*next_char == traits_type::eof()) {
+      hash_validator_result_ = std::move(*hash_validator_).Finish();
+      if (hash_validator_result_.is_mismatch) {
+        std::string msg;
+        msg += __func__;
+        msg += "(): mismatched hashes in download";
+        msg += ", computed=";
+        msg += hash_validator_result_.computed;
+        msg += ", received=";
+        msg += hash_validator_result_.received;
+        status_ = Status(StatusCode::kDataLoss, std::move(msg));
+      }
+      return {};
+    }
+  }
+  char const* data = gptr();
+  auto const size = static_cast<std::size_t>(egptr() - gptr());
+  // Mark the full region as consumed, `seekoff()` computes the current
+  // position using `source_pos_` and the size of the get area.
+  setg(eback(), egptr(), egptr());
+  return absl::Span<char const>(data, size);
+}
+
 ObjectReadStreambuf::int_type ObjectReadStreambuf::ReportError(Status status) {
   // The only way to report errors from a std::basic_streambuf<> (which this
   // class derives from) is to throw exceptions:
@@ -238,21 +282,27 @@ ObjectReadStreambuf::int_type ObjectReadStreambuf::ReportError(Status status) {
 }
 
 void ObjectReadStreambuf::SetEmptyRegion() {
-  current_ios_buffer_.clear();
-  current_ios_buffer_.push_back('\0');
-  char* data = &current_ios_buffer_[0];
+  current_ios_buffer_.reset();
+  char* data = &empty_region_;
   setg(data, data + 1, data + 1);
 }
 
 ObjectWriteStreambuf::ObjectWriteStreambuf(
     std::unique_ptr<ResumableUploadSession> upload_session,
-    std::size_t max_buffer_size, std::unique_ptr<HashValidator> hash_validator)
+    std::size_t max_buffer_size, std::unique_ptr<HashValidator> hash_validator,
+    absl::optional<std::size_t> adaptive_max_buffer_size,
+    std::shared_ptr<BufferPool> buffer_pool)
     : upload_session_(std::move(upload_session)),
+      buffer_pool_(std::move(buffer_pool)),
       max_buffer_size_(UploadChunkRequest::RoundUpToQuantum(max_buffer_size)),
       hash_validator_(std::move(hash_validator)),
       last_response_(ResumableUploadResponse{
           {}, 0, {}, ResumableUploadResponse::kInProgress, {}}) {
-  current_ios_buffer_.resize(max_buffer_size_);
+  if (adaptive_max_buffer_size.has_value()) {
+    adaptive_chunk_size_.emplace(max_buffer_size_, *adaptive_max_buffer_size);
+    max_buffer_size_ = adaptive_chunk_size_->chunk_size();
+  }
+  current_ios_buffer_ = PooledBuffer(buffer_pool_, max_buffer_size_);
   auto* pbeg = current_ios_buffer_.data();
   auto* pend = pbeg + current_ios_buffer_.size();
   setp(pbeg, pend);
@@ -318,6 +368,7 @@ std::streamsize ObjectWriteStreambuf::xsputn(char const* s,
     }
     if (!last_response_) return traits_type::eof();
   } else {
+    GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kCopy);
     std::copy(s, s + count, pptr());
     pbump(static_cast<int>(count));
   }
@@ -347,10 +398,9 @@ void ObjectWriteStreambuf::FlushFinal() {
   last_response_ = upload_session_->UploadFinalChunk(
       {ConstBuffer(pbase(), actual_size)}, upload_size);
 
-  // Reset the iostream put area with valid pointers, but empty.
-  current_ios_buffer_.resize(1);
-  auto* pbeg = current_ios_buffer_.data();
-  setp(pbeg, pbeg);
+  // Reset the iostream put area, and return the buffer to the pool.
+  setp(nullptr, nullptr);
+  current_ios_buffer_.reset();
 
   // Close the stream
   upload_session_.reset();
@@ -390,18 +440,35 @@ void ObjectWriteStreambuf::FlushRoundChunk(ConstBufferSequence buffers) {
   // buffer.
   auto first_buffered_byte = upload_session_->next_expected_byte();
   auto expected_next_byte = upload_session_->next_expected_byte() + actual_size;
+  auto const retry_count = upload_session_->retry_count();
+  auto const start = std::chrono::steady_clock::now();
   last_response_ = upload_session_->UploadChunk(payload);
 
   if (last_response_) {
+    if (adaptive_chunk_size_) {
+      adaptive_chunk_size_->OnChunkUploaded(
+          actual_size,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - start),
+          upload_session_->retry_count() - retry_count);
+      max_buffer_size_ = adaptive_chunk_size_->chunk_size();
+    }
     // Reset the internal buffer and copy any trailing bytes from `buffers` to
-    // it.
+    // it. The trailing bytes may be stored in the current buffer, if the
+    // buffer size changed they are copied to a new buffer.
+    PooledBuffer resized;
     auto* pbeg = current_ios_buffer_.data();
-    setp(pbeg, pbeg + current_ios_buffer_.size());
+    if (max_buffer_size_ != current_ios_buffer_.size()) {
+      resized = PooledBuffer(buffer_pool_, max_buffer_size_);
+      pbeg = resized.data();
+    }
+    setp(pbeg, pbeg + max_buffer_size_);
     PopFrontBytes(buffers, rounded_size);
     for (auto const& b : buffers) {
       std::copy(b.begin(), b.end(), pptr());
       pbump(static_cast<int>(b.size()));
     }
+    if (!resized.empty()) current_ios_buffer_ = std::move(resized);
 
     // We cannot use the last committed byte in `last_response_` because when
     // using X-Upload-Content-Length GCS returns 0 when the upload completed
@@ -15,12 +15,17 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_OBJECT_STREAMBUF_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_OBJECT_STREAMBUF_H
 
+#include "google/cloud/storage/buffer_pool.h"
+#include "google/cloud/storage/internal/adaptive_chunk_size.h"
 #include "google/cloud/storage/internal/hash_validator.h"
 #include "google/cloud/storage/internal/http_response.h"
 #include "google/cloud/storage/internal/object_read_source.h"
+#include "google/cloud/storage/internal/pooled_buffer.h"
 #include "google/cloud/storage/internal/resumable_upload_session.h"
 #include "google/cloud/storage/version.h"
 #include "google/cloud/status_or.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include <iostream>
 #include <map>
 #include <memory>
@@ -41,9 +46,10 @@ namespace internal {
  */
 class ObjectReadStreambuf : public std::basic_streambuf<char> {
  public:
-  ObjectReadStreambuf(ReadObjectRangeRequest const& request,
-                      std::unique_ptr<ObjectReadSource> source,
-                      std::streamoff pos_in_stream);
+  ObjectReadStreambuf(
+      ReadObjectRangeRequest const& request,
+      std::unique_ptr<ObjectReadSource> source, std::streamoff pos_in_stream,
+      std::shared_ptr<BufferPool> buffer_pool = DefaultBufferPool());
 
   /// Create a streambuf in a permanent error status.
   ObjectReadStreambuf(ReadObjectRangeRequest const& request, Status status);
@@ -61,6 +67,17 @@ class ObjectReadStreambuf : public std::basic_streambuf<char> {
 
   bool IsOpen() const;
   void Close();
+
+  /**
+   * Return the next block of downloaded data without copying it.
+   *
+   * The returned view points into the internal buffer, it remains valid until
+   * the next call to any read function on this object. An empty view indicates
+   * that the download has finished, or that there was an error, applications
+   * should check `status()` to distinguish the two cases.
+   */
+  absl::Span<char const> ReadSome();
+
   Status const& status() const { return status_; }
   std::string const& received_hash() const {
     return hash_validator_result_.received;
@@ -82,7 +99,12 @@ class ObjectReadStreambuf : public std::basic_streambuf<char> {
 
   std::unique_ptr<ObjectReadSource> source_;
   std::streamoff source_pos_;
-  std::vector<char> current_ios_buffer_;
+  std::shared_ptr<BufferPool> buffer_pool_;
+  // The get area points to this buffer, or to a buffer owned by `source_`,
+  // see `ObjectReadSource::ReadBlock()`.
+  PooledBuffer current_ios_buffer_;
+  // The get area points here once the download has finished.
+  char empty_region_ = '\0';
   std::unique_ptr<HashValidator> hash_validator_;
   HashValidator::Result hash_validator_result_;
   Status status_;
@@ -100,9 +122,20 @@ class ObjectWriteStreambuf : public std::basic_streambuf<char> {
  public:
   ObjectWriteStreambuf() = default;
 
-  ObjectWriteStreambuf(std::unique_ptr<ResumableUploadSession> upload_session,
-                       std::size_t max_buffer_size,
-                       std::unique_ptr<HashValidator> hash_validator);
+  /**
+   * Create a streambuf for a resumable upload.
+   *
+   * If @p adaptive_max_buffer_size is set, the buffer size starts at
+   * @p max_buffer_size and then adapts to the observed throughput, up to
+   * @p adaptive_max_buffer_size bytes, see `AdaptiveChunkSize` for details.
+   * The buffers are allocated from @p buffer_pool.
+   */
+  ObjectWriteStreambuf(
+      std::unique_ptr<ResumableUploadSession> upload_session,
+      std::size_t max_buffer_size,
+      std::unique_ptr<HashValidator> hash_validator,
+      absl::optional<std::size_t> adaptive_max_buffer_size = absl::nullopt,
+      std::shared_ptr<BufferPool> buffer_pool = DefaultBufferPool());
 
   ~ObjectWriteStreambuf() override = default;
 
@@ -154,8 +187,10 @@ class ObjectWriteStreambuf : public std::basic_streambuf<char> {
 
   std::unique_ptr<ResumableUploadSession> upload_session_;
 
-  std::vector<char> current_ios_buffer_;
+  std::shared_ptr<BufferPool> buffer_pool_;
+  PooledBuffer current_ios_buffer_;
   std::size_t max_buffer_size_;
+  absl::optional<AdaptiveChunkSize> adaptive_chunk_size_;
 
   std::unique_ptr<HashValidator> hash_validator_;
   HashValidator::Result hash_validator_result_;
@@ -645,6 +645,58 @@ TEST(ObjectWriteStreambufTest, PubsyncTooSmall) {
   EXPECT_EQ(0, streambuf.pubsync());
 }
 
+/// @test Verify the buffer size adapts, preserving the trailing bytes.
+TEST(ObjectWriteStreambufTest, AdaptiveBufferSize) {
+  auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+
+  auto const quantum = UploadChunkRequest::kChunkSizeQuantum;
+  std::string payload(3 * quantum, ' ');
+  for (std::size_t i = 0; i != payload.size(); ++i) {
+    payload[i] = static_cast<char>('a' + i % 26);
+  }
+
+  std::size_t mock_next_byte = 0;
+  EXPECT_CALL(*mock, next_expected_byte()).WillRepeatedly([&]() {
+    return mock_next_byte;
+  });
+  EXPECT_CALL(*mock, done()).WillRepeatedly(Return(false));
+
+  std::string uploaded;
+  std::vector<std::size_t> chunk_sizes;
+  EXPECT_CALL(*mock, UploadChunk(_))
+      .WillRepeatedly([&](ConstBufferSequence const& p) {
+        auto const size = TotalBytes(p);
+        for (auto const& b : p) uploaded.append(b.data(), b.size());
+        chunk_sizes.push_back(size);
+        mock_next_byte += size;
+        return make_status_or(ResumableUploadResponse{
+            "", mock_next_byte - 1, {}, ResumableUploadResponse::kInProgress,
+            {}});
+      });
+  EXPECT_CALL(*mock, UploadFinalChunk(_, _))
+      .WillOnce([&](ConstBufferSequence const& p, std::uint64_t s) {
+        for (auto const& b : p) uploaded.append(b.data(), b.size());
+        EXPECT_EQ(payload.size(), s);
+        return make_status_or(ResumableUploadResponse{
+            "{}", s - 1, {}, ResumableUploadResponse::kDone, {}});
+      });
+
+  ObjectWriteStreambuf streambuf(std::move(mock), quantum,
+                                 absl::make_unique<NullHashValidator>(),
+                                 4 * quantum);
+
+  // The first chunk always doubles the buffer size, the bytes that do not fit
+  // in the first chunk must be preserved in the new buffer.
+  auto const piece = 3 * quantum / 8;
+  for (std::size_t offset = 0; offset < payload.size(); offset += piece) {
+    EXPECT_EQ(piece, streambuf.sputn(payload.data() + offset, piece));
+  }
+  auto response = streambuf.Close();
+  EXPECT_STATUS_OK(response);
+  EXPECT_THAT(chunk_sizes, ElementsAre(quantum, 2 * quantum));
+  EXPECT_EQ(payload, uploaded);
+}
+
 TEST(ObjectReadStreambufTest, FailedTellg) {
   ObjectReadStreambuf buf(ReadObjectRangeRequest{},
                           Status(StatusCode::kInvalidArgument, "some error"));
@@ -712,6 +764,110 @@ TEST(ObjectReadStreambufTest, WrongSeek) {
   EXPECT_TRUE(stream.fail());
 }
 
+TEST(ObjectReadStreambufTest, ReadSome) {
+  std::string const payload = "The quick brown fox jumps over the lazy dog";
+  auto read_source = absl::make_unique<testing::MockObjectReadSource>();
+  bool open = true;
+  EXPECT_CALL(*read_source, IsOpen()).WillRepeatedly([&] { return open; });
+  EXPECT_CALL(*read_source, Read(_, _))
+      .WillOnce([&](char* buf, std::size_t n) {
+        EXPECT_LE(payload.size(), n);
+        std::copy(payload.begin(), payload.end(), buf);
+        return ReadSourceResult{payload.size(), HttpResponse{100, "", {}}};
+      })
+      .WillOnce([&](char*, std::size_t) {
+        open = false;
+        return ReadSourceResult{0, HttpResponse{200, "", {}}};
+      });
+  ObjectReadStreambuf buf(ReadObjectRangeRequest{}, std::move(read_source), 0);
+  std::istream stream(&buf);
+
+  // Mixing ReadSome() with the std::istream functions is supported.
+  EXPECT_EQ('T', stream.get());
+  auto data = buf.ReadSome();
+  EXPECT_EQ(payload.substr(1), std::string(data.data(), data.size()));
+  EXPECT_EQ(payload.size(), stream.tellg());
+
+  data = buf.ReadSome();
+  EXPECT_TRUE(data.empty());
+  EXPECT_STATUS_OK(buf.status());
+}
+
+/// A source that returns the data from its own buffer, like gRPC does.
+class OwnedBufferReadSource : public testing::MockObjectReadSource {
+ public:
+  explicit OwnedBufferReadSource(std::string data) : data_(std::move(data)) {}
+
+  StatusOr<ReadSourceBlock> ReadBlock(char*, std::size_t n) override {
+    auto const nbytes = (std::min)(n, data_.size() - offset_);
+    auto* data = &data_[0] + offset_;
+    offset_ += nbytes;
+    if (nbytes == 0) return ReadSourceBlock{data, 0, HttpResponse{200, "", {}}};
+    return ReadSourceBlock{data, nbytes, HttpResponse{100, "", {}}};
+  }
+
+  char const* data() const { return data_.data(); }
+
+ private:
+  std::string data_;
+  std::size_t offset_ = 0;
+};
+
+TEST(ObjectReadStreambufTest, ReadSomeWithoutCopy) {
+  std::string const payload = "The quick brown fox jumps over the lazy dog";
+  auto read_source = absl::make_unique<OwnedBufferReadSource>(payload);
+  auto const* source_data = read_source->data();
+  EXPECT_CALL(*read_source, IsOpen()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*read_source, Read).Times(0);
+  ObjectReadStreambuf buf(ReadObjectRangeRequest{}, std::move(read_source), 0);
+
+  auto data = buf.ReadSome();
+  EXPECT_EQ(payload, std::string(data.data(), data.size()));
+  // The data is returned directly from the buffer owned by the source.
+  EXPECT_EQ(source_data, data.data());
+  EXPECT_EQ(payload.size(), buf.pubseekoff(0, std::ios_base::cur,
+                                           std::ios_base::in));
+
+  data = buf.ReadSome();
+  EXPECT_TRUE(data.empty());
+  EXPECT_STATUS_OK(buf.status());
+}
+
+TEST(ObjectReadStreambufTest, ReadSomeHashMismatch) {
+  auto read_source = absl::make_unique<testing::MockObjectReadSource>();
+  bool open = true;
+  EXPECT_CALL(*read_source, IsOpen()).WillRepeatedly([&] { return open; });
+  EXPECT_CALL(*read_source, Read(_, _))
+      .WillOnce([&](char* buf, std::size_t) {
+        buf[0] = 'x';
+        return ReadSourceResult{
+            1, HttpResponse{100, "", {{"x-goog-hash", "crc32c=AAAAAA=="}}}};
+      })
+      .WillOnce([&](char*, std::size_t) {
+        open = false;
+        return ReadSourceResult{0, HttpResponse{200, "", {}}};
+      });
+  ObjectReadStreambuf buf(ReadObjectRangeRequest{}, std::move(read_source), 0);
+
+  auto data = buf.ReadSome();
+  EXPECT_EQ("x", std::string(data.data(), data.size()));
+  data = buf.ReadSome();
+  EXPECT_TRUE(data.empty());
+  EXPECT_THAT(buf.status(), StatusIs(StatusCode::kDataLoss));
+}
+
+TEST(ObjectReadStreambufTest, ReadSomeError) {
+  auto read_source = absl::make_unique<testing::MockObjectReadSource>();
+  EXPECT_CALL(*read_source, IsOpen()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*read_source, Read(_, _))
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+  ObjectReadStreambuf buf(ReadObjectRangeRequest{}, std::move(read_source), 0);
+
+  auto data = buf.ReadSome();
+  EXPECT_TRUE(data.empty());
+  EXPECT_THAT(buf.status(), StatusIs(StatusCode::kUnavailable));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/internal/base64.h"
 #include "google/cloud/internal/throw_delegate.h"
 #include <openssl/bio.h>
 #include <openssl/buffer.h>
@@ -80,52 +81,13 @@ std::unique_ptr<BIO, decltype(&BIO_free_all)> PushBase64Transcoding(
   return bio_chain;
 }
 #endif  // OPENSSL_IS_BORINGSSL
-
-std::string Base64Encode(std::uint8_t const* bytes, std::size_t bytes_size) {
-#ifdef OPENSSL_IS_BORINGSSL
-  std::size_t encoded_size;
-  EVP_EncodedLength(&encoded_size, bytes_size);
-  std::vector<std::uint8_t> result(encoded_size);
-  std::size_t out_size = EVP_EncodeBlock(result.data(), bytes, bytes_size);
-  result.resize(out_size);
-  return {result.begin(), result.end()};
-#else
-  auto mem_io = std::unique_ptr<BIO, decltype(&BIO_free)>(BIO_new(BIO_s_mem()),
-                                                          &BIO_free);
-  auto bio_chain = PushBase64Transcoding(std::move(mem_io));
-
-  // These BIO_*() operations are guaranteed not to block, consult the NOTES in:
-  //   https://www.openssl.org/docs/man1.1.1/man3/BIO_s_mem.html
-  // for details.
-  int retval = BIO_write(bio_chain.get(), bytes, static_cast<int>(bytes_size));
-  if (retval <= 0) {
-    std::ostringstream err_builder;
-    err_builder << "Permanent error in " << __func__ << ": "
-                << "BIO_write returned non-retryable value of " << retval;
-    google::cloud::internal::ThrowRuntimeError(err_builder.str());
-  }
-
-  // Tell the b64 encoder that we're done writing data, thus prompting it to
-  // add trailing '=' characters for padding if needed.
-  retval = BIO_flush(bio_chain.get());
-  if (retval <= 0) {
-    std::ostringstream err_builder;
-    err_builder << "Permanent error in " << __func__ << ": "
-                << "BIO_flush returned non-retryable value of " << retval;
-    google::cloud::internal::ThrowRuntimeError(err_builder.str());
-  }
-
-  // This buffer belongs to the BIO chain and is freed upon its destruction.
-  BUF_MEM* buf_mem;
-  BIO_get_mem_ptr(bio_chain.get(), &buf_mem);
-  // Return a string copy of the buffer's bytes, as the buffer will be freed
-  // upon this method's exit.
-  return std::string(buf_mem->data, buf_mem->length);
-#endif  // OPENSSL_IS_BORINGSSL
-}
 }  // namespace
 
 std::vector<std::uint8_t> Base64Decode(std::string const& str) {
+  // Well-formed inputs, by far the common case, use the (faster) common codec.
+  // Only fall back to OpenSSL, which is more lenient, if that fails.
+  auto decoded = google::cloud::internal::Base64Decode(str);
+  if (decoded) return {decoded->begin(), decoded->end()};
 #ifdef OPENSSL_IS_BORINGSSL
   std::size_t decoded_size;
   EVP_DecodedLength(&decoded_size, str.size());
@@ -165,25 +127,33 @@ std::vector<std::uint8_t> Base64Decode(std::string const& str) {
 }
 
 std::string Base64Encode(std::string const& str) {
-  return Base64Encode(reinterpret_cast<unsigned char const*>(str.data()),
-                      str.size());
+  return google::cloud::internal::Base64Encode(str);
 }
 
 std::string Base64Encode(std::vector<std::uint8_t> const& bytes) {
-  return Base64Encode(bytes.data(), bytes.size());
+  std::string encoded;
+  google::cloud::internal::Base64Encode(
+      reinterpret_cast<char const*>(bytes.data()), bytes.size(), encoded);
+  return encoded;
 }
 
 StatusOr<std::vector<std::uint8_t>> SignStringWithPem(
     std::string const& str, std::string const& pem_contents,
     storage::oauth2::JwtSigningAlgorithms alg) {
-  using ::google::cloud::storage::oauth2::JwtSigningAlgorithms;
+  auto signer = PemSigner::Create(pem_contents, alg);
+  if (!signer) return std::move(signer).status();
+  return signer->Sign(str);
+}
 
-  auto digest_ctx = GetDigestCtx();
-  if (!digest_ctx) {
-    return Status(StatusCode::kInvalidArgument,
-                  "Invalid ServiceAccountCredentials: "
-                  "could not create context for OpenSSL digest. ");
-  }
+struct PemSigner::Key {
+  EVP_MD const* digest_type;
+  std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> private_key;
+};
+
+StatusOr<PemSigner> PemSigner::Create(
+    std::string const& pem_contents,
+    storage::oauth2::JwtSigningAlgorithms alg) {
+  using ::google::cloud::storage::oauth2::JwtSigningAlgorithms;
 
   EVP_MD const* digest_type = nullptr;
   switch (alg) {
@@ -223,13 +193,26 @@ StatusOr<std::vector<std::uint8_t>> SignStringWithPem(
                   "could not parse PEM to get private key ");
   }
 
+  return PemSigner(std::make_shared<Key const>(
+      Key{digest_type, std::move(private_key)}));
+}
+
+StatusOr<std::vector<std::uint8_t>> PemSigner::Sign(
+    std::string const& str) const {
+  auto digest_ctx = GetDigestCtx();
+  if (!digest_ctx) {
+    return Status(StatusCode::kInvalidArgument,
+                  "Invalid ServiceAccountCredentials: "
+                  "could not create context for OpenSSL digest. ");
+  }
+
   int const digest_sign_success_code = 1;
   if (digest_sign_success_code !=
       EVP_DigestSignInit(digest_ctx.get(),
                          nullptr,  // `EVP_PKEY_CTX **pctx`
-                         digest_type,
+                         key_->digest_type,
                          nullptr,  // `ENGINE *e`
-                         private_key.get())) {
+                         key_->private_key.get())) {
     return Status(StatusCode::kInvalidArgument,
                   "Invalid ServiceAccountCredentials: "
                   "could not initialize PEM digest. ");
@@ -19,6 +19,8 @@
 #include "google/cloud/storage/version.h"
 #include "google/cloud/status_or.h"
 #include <algorithm>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace google {
@@ -53,6 +55,30 @@ StatusOr<std::vector<std::uint8_t>> SignStringWithPem(
     std::string const& str, std::string const& pem_contents,
     storage::oauth2::JwtSigningAlgorithms alg);
 
+/**
+ * Signs strings with the private key from a PEM container.
+ *
+ * Parsing the PEM container is a significant fraction of the cost of
+ * `SignStringWithPem()`. Applications that sign many strings with the same key
+ * should create a `PemSigner` once and reuse it. Copies of a `PemSigner` share
+ * the parsed key, and `Sign()` can be called concurrently from multiple
+ * threads.
+ */
+class PemSigner {
+ public:
+  static StatusOr<PemSigner> Create(std::string const& pem_contents,
+                                    storage::oauth2::JwtSigningAlgorithms alg);
+
+  /// Returns the signature as an *unencoded* byte array.
+  StatusOr<std::vector<std::uint8_t>> Sign(std::string const& str) const;
+
+ private:
+  struct Key;
+  explicit PemSigner(std::shared_ptr<Key const> key) : key_(std::move(key)) {}
+
+  std::shared_ptr<Key const> key_;
+};
+
 /**
  * Returns a Base64-encoded version of @p bytes. Using the URL- and
  * filesystem-safe alphabet, making these adjustments:
@@ -0,0 +1,180 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/parallel_object_read_source.h"
+#include <algorithm>
+#include <cstring>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+std::size_t constexpr ParallelObjectReadSource::kDefaultChunkSize;
+std::size_t constexpr ParallelObjectReadSource::kDefaultMaxBufferedChunks;
+
+std::vector<ReadRangeShard> ComputeReadRangeShards(
+    std::int64_t begin, std::int64_t end, std::size_t max_shards,
+    std::int64_t min_shard_size) {
+  auto const size = end - begin;
+  if (size <= 0 || max_shards <= 1) return {ReadRangeShard{begin, end}};
+  auto const count = (std::max<std::int64_t>)(
+      1, (std::min)(static_cast<std::int64_t>(max_shards),
+                    size / (std::max<std::int64_t>)(1, min_shard_size)));
+  auto const shard_size = (size + count - 1) / count;
+  std::vector<ReadRangeShard> shards;
+  shards.reserve(static_cast<std::size_t>(count));
+  for (auto b = begin; b < end; b += shard_size) {
+    shards.push_back(ReadRangeShard{b, (std::min)(end, b + shard_size)});
+  }
+  return shards;
+}
+
+ParallelObjectReadSource::ParallelObjectReadSource(
+    std::vector<std::unique_ptr<ObjectReadSource>> sources,
+    std::size_t chunk_size, std::size_t max_buffered_chunks)
+    : chunk_size_(chunk_size),
+      max_buffered_chunks_((std::max<std::size_t>)(1, max_buffered_chunks)),
+      streams_(sources.size()) {
+  for (std::size_t i = 0; i != sources.size(); ++i) {
+    streams_[i].source = std::move(sources[i]);
+  }
+  workers_.reserve(streams_.size());
+  for (auto& s : streams_) {
+    workers_.emplace_back([this, &s] { Worker(s); });
+  }
+}
+
+ParallelObjectReadSource::~ParallelObjectReadSource() {
+  Cancel();
+  for (auto& t : workers_) t.join();
+}
+
+bool ParallelObjectReadSource::IsOpen() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return !closed_;
+}
+
+StatusOr<HttpResponse> ParallelObjectReadSource::Close() {
+  Cancel();
+  for (auto& t : workers_) t.join();
+  workers_.clear();
+  // The background threads are stopped, it is safe to close the sources.
+  for (auto& s : streams_) {
+    if (s.source->IsOpen()) (void)s.source->Close();
+  }
+  if (!status_.ok()) return status_;
+  return HttpResponse{HttpStatusCode::kOk, {}, {}};
+}
+
+StatusOr<ReadSourceResult> ParallelObjectReadSource::Read(char* buf,
+                                                          std::size_t n) {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    if (closed_ || current_ == streams_.size()) {
+      closed_ = true;
+      if (!status_.ok()) return status_;
+      return ReadSourceResult{0, HttpResponse{HttpStatusCode::kOk, {}, {}}};
+    }
+    auto& s = streams_[current_];
+    cv_.wait(lk, [&s] { return !s.chunks.empty() || s.done; });
+    if (!s.chunks.empty()) break;
+    if (!s.status.ok()) {
+      closed_ = true;
+      status_ = s.status;
+      return status_;
+    }
+    if (s.error.has_value()) {
+      closed_ = true;
+      return ReadSourceResult{0, *std::move(s.error)};
+    }
+    ++current_;
+  }
+
+  // Copy as much data as possible from the current stream, without blocking.
+  auto& s = streams_[current_];
+  std::multimap<std::string, std::string> headers;
+  std::size_t offset = 0;
+  while (offset < n && !s.chunks.empty()) {
+    auto& chunk = s.chunks.front();
+    auto const count = (std::min)(n - offset, chunk.data.size() - chunk.offset);
+    if (count != 0) {
+      std::memcpy(buf + offset, chunk.data.data() + chunk.offset, count);
+    }
+    offset += count;
+    chunk.offset += count;
+    headers.insert(chunk.headers.begin(), chunk.headers.end());
+    chunk.headers.clear();
+    if (chunk.offset == chunk.data.size()) s.chunks.pop_front();
+  }
+  lk.unlock();
+  cv_.notify_all();
+  return ReadSourceResult{
+      offset, HttpResponse{HttpStatusCode::kContinue, {}, std::move(headers)}};
+}
+
+void ParallelObjectReadSource::Worker(Stream& stream) {
+  // Only this thread uses `stream.source` until the thread is joined.
+  auto& source = *stream.source;
+  auto finish = [this, &stream](Status status,
+                                absl::optional<HttpResponse> error) {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      stream.done = true;
+      stream.status = std::move(status);
+      stream.error = std::move(error);
+    }
+    cv_.notify_all();
+  };
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lk(mu_);
+      cv_.wait(lk, [this, &stream] {
+        return closed_ || stream.chunks.size() < max_buffered_chunks_;
+      });
+      if (closed_) break;
+    }
+    if (!source.IsOpen()) break;
+    Chunk chunk{std::vector<char>(chunk_size_), 0, {}};
+    auto result = source.Read(chunk.data.data(), chunk.data.size());
+    if (!result) return finish(std::move(result).status(), {});
+    if (result->response.status_code >= HttpStatusCode::kMinNotSuccess) {
+      return finish(Status(), std::move(result->response));
+    }
+    chunk.data.resize(result->bytes_received);
+    chunk.headers = std::move(result->response.headers);
+    if (chunk.data.empty() && chunk.headers.empty()) continue;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      stream.chunks.push_back(std::move(chunk));
+    }
+    cv_.notify_all();
+  }
+  finish(Status(), {});
+}
+
+void ParallelObjectReadSource::Cancel() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    closed_ = true;
+  }
+  cv_.notify_all();
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
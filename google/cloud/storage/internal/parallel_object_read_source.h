@@ -0,0 +1,130 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_PARALLEL_OBJECT_READ_SOURCE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_PARALLEL_OBJECT_READ_SOURCE_H
+
+#include "google/cloud/storage/internal/object_read_source.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status.h"
+#include "absl/types/optional.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A range of an object, used to split a download into parallel streams.
+ *
+ * The range is right-open: `[begin, end)`.
+ */
+struct ReadRangeShard {
+  std::int64_t begin;
+  std::int64_t end;
+};
+
+/**
+ * Split `[begin, end)` into at most @p max_shards consecutive ranges.
+ *
+ * Each range (except possibly the last) contains at least @p min_shard_size
+ * bytes, so small downloads use fewer shards.
+ */
+std::vector<ReadRangeShard> ComputeReadRangeShards(std::int64_t begin,
+                                                   std::int64_t end,
+                                                   std::size_t max_shards,
+                                                   std::int64_t min_shard_size);
+
+/**
+ * Combine several downloads of consecutive ranges into a single download.
+ *
+ * Each source reads a consecutive range of the object. This class reads all
+ * the sources concurrently, using one background thread per source, and
+ * returns the data in order: first the data from the first source, then the
+ * data from the second source, and so on. The background threads stop when
+ * they have `max_buffered_chunks` chunks (of `chunk_size` bytes) that have not
+ * been consumed, which bounds the memory usage.
+ *
+ * Errors are reported in order too: an error in the second source is returned
+ * once all the data from the first source is consumed.
+ */
+class ParallelObjectReadSource : public ObjectReadSource {
+ public:
+  static std::size_t constexpr kDefaultChunkSize = 1024 * 1024;
+  static std::size_t constexpr kDefaultMaxBufferedChunks = 4;
+
+  explicit ParallelObjectReadSource(
+      std::vector<std::unique_ptr<ObjectReadSource>> sources,
+      std::size_t chunk_size = kDefaultChunkSize,
+      std::size_t max_buffered_chunks = kDefaultMaxBufferedChunks);
+
+  ~ParallelObjectReadSource() override;
+
+  ParallelObjectReadSource(ParallelObjectReadSource const&) = delete;
+  ParallelObjectReadSource& operator=(ParallelObjectReadSource const&) = delete;
+
+  bool IsOpen() const override;
+  StatusOr<HttpResponse> Close() override;
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override;
+
+ private:
+  struct Chunk {
+    std::vector<char> data;
+    std::size_t offset;
+    std::multimap<std::string, std::string> headers;
+  };
+
+  struct Stream {
+    std::unique_ptr<ObjectReadSource> source;
+    std::deque<Chunk> chunks;
+    bool done = false;
+    Status status;
+    absl::optional<HttpResponse> error;
+  };
+
+  void Worker(Stream& stream);
+  void Cancel();
+
+  std::size_t const chunk_size_;
+  std::size_t const max_buffered_chunks_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<Stream> streams_;
+  std::size_t current_ = 0;
+  bool closed_ = false;
+  Status status_;
+
+  // Declared last, so the threads are started after all the other members are
+  // initialized.
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_PARALLEL_OBJECT_READ_SOURCE_H
@@ -0,0 +1,171 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/parallel_object_read_source.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <cstring>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::MockObjectReadSource;
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Return;
+
+MATCHER_P2(IsShard, begin, end, "") {
+  return arg.begin == begin && arg.end == end;
+}
+
+TEST(ComputeReadRangeShardsTest, Basic) {
+  EXPECT_THAT(ComputeReadRangeShards(0, 100, 4, 10),
+              ElementsAre(IsShard(0, 25), IsShard(25, 50), IsShard(50, 75),
+                          IsShard(75, 100)));
+  EXPECT_THAT(ComputeReadRangeShards(10, 20, 3, 1),
+              ElementsAre(IsShard(10, 14), IsShard(14, 18), IsShard(18, 20)));
+}
+
+TEST(ComputeReadRangeShardsTest, Small) {
+  EXPECT_THAT(ComputeReadRangeShards(0, 100, 4, 40),
+              ElementsAre(IsShard(0, 50), IsShard(50, 100)));
+  EXPECT_THAT(ComputeReadRangeShards(0, 100, 4, 200),
+              ElementsAre(IsShard(0, 100)));
+  EXPECT_THAT(ComputeReadRangeShards(0, 100, 1, 10),
+              ElementsAre(IsShard(0, 100)));
+  EXPECT_THAT(ComputeReadRangeShards(0, 0, 4, 10), ElementsAre(IsShard(0, 0)));
+}
+
+/// Create a mock source that returns @p contents in pieces of @p piece bytes.
+std::unique_ptr<ObjectReadSource> MakeSource(std::string contents,
+                                             std::size_t piece) {
+  auto source = absl::make_unique<MockObjectReadSource>();
+  auto offset = std::make_shared<std::size_t>(0);
+  auto data = std::make_shared<std::string>(std::move(contents));
+  EXPECT_CALL(*source, IsOpen).WillRepeatedly([offset, data] {
+    return *offset < data->size();
+  });
+  EXPECT_CALL(*source, Read)
+      .WillRepeatedly([offset, data, piece](char* buf, std::size_t n) {
+        auto const count = (std::min)({n, piece, data->size() - *offset});
+        std::memcpy(buf, data->data() + *offset, count);
+        *offset += count;
+        auto const code = *offset == data->size() ? HttpStatusCode::kOk
+                                                  : HttpStatusCode::kContinue;
+        return make_status_or(
+            ReadSourceResult{count, HttpResponse{code, {}, {}}});
+      });
+  EXPECT_CALL(*source, Close)
+      .WillRepeatedly(Return(HttpResponse{HttpStatusCode::kOk, {}, {}}));
+  return std::unique_ptr<ObjectReadSource>(std::move(source));
+}
+
+std::string ReadAll(ObjectReadSource& source, std::size_t n) {
+  std::string actual;
+  std::vector<char> buffer(n);
+  while (source.IsOpen()) {
+    auto r = source.Read(buffer.data(), buffer.size());
+    EXPECT_STATUS_OK(r);
+    if (!r) break;
+    actual.append(buffer.data(), r->bytes_received);
+  }
+  return actual;
+}
+
+TEST(ParallelObjectReadSourceTest, InOrder) {
+  std::vector<std::string> pieces{std::string(1000, 'a'),
+                                  std::string(1500, 'b'),
+                                  std::string(10, 'c'), std::string()};
+  std::vector<std::unique_ptr<ObjectReadSource>> sources;
+  std::string expected;
+  for (auto const& p : pieces) {
+    sources.push_back(MakeSource(p, 128));
+    expected += p;
+  }
+  ParallelObjectReadSource tested(std::move(sources), 100, 2);
+  EXPECT_EQ(expected, ReadAll(tested, 333));
+  EXPECT_FALSE(tested.IsOpen());
+  EXPECT_STATUS_OK(tested.Close());
+}
+
+TEST(ParallelObjectReadSourceTest, ErrorIsReportedInOrder) {
+  std::vector<std::unique_ptr<ObjectReadSource>> sources;
+  sources.push_back(MakeSource(std::string(1000, 'a'), 128));
+  auto error = absl::make_unique<MockObjectReadSource>();
+  EXPECT_CALL(*error, IsOpen).WillRepeatedly(Return(true));
+  EXPECT_CALL(*error, Read(_, _))
+      .WillRepeatedly(Return(StatusOr<ReadSourceResult>(PermanentError())));
+  sources.push_back(std::move(error));
+
+  ParallelObjectReadSource tested(std::move(sources), 100, 2);
+  std::vector<char> buffer(1000);
+  std::size_t received = 0;
+  StatusOr<ReadSourceResult> r;
+  for (r = tested.Read(buffer.data(), buffer.size()); r;
+       r = tested.Read(buffer.data(), buffer.size())) {
+    received += r->bytes_received;
+  }
+  EXPECT_EQ(1000, received);
+  EXPECT_THAT(r, StatusIs(PermanentError().code()));
+  EXPECT_FALSE(tested.IsOpen());
+}
+
+TEST(ParallelObjectReadSourceTest, HttpError) {
+  std::vector<std::unique_ptr<ObjectReadSource>> sources;
+  auto error = absl::make_unique<MockObjectReadSource>();
+  EXPECT_CALL(*error, IsOpen).WillRepeatedly(Return(true));
+  EXPECT_CALL(*error, Read(_, _))
+      .WillOnce(Return(make_status_or(ReadSourceResult{
+          0, HttpResponse{HttpStatusCode::kNotFound, "not found", {}}})));
+  sources.push_back(std::move(error));
+
+  ParallelObjectReadSource tested(std::move(sources));
+  std::vector<char> buffer(1000);
+  auto r = tested.Read(buffer.data(), buffer.size());
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(0, r->bytes_received);
+  EXPECT_EQ(HttpStatusCode::kNotFound, r->response.status_code);
+}
+
+TEST(ParallelObjectReadSourceTest, CloseEarly) {
+  std::vector<std::unique_ptr<ObjectReadSource>> sources;
+  sources.push_back(MakeSource(std::string(100000, 'a'), 128));
+  sources.push_back(MakeSource(std::string(100000, 'b'), 128));
+
+  ParallelObjectReadSource tested(std::move(sources), 100, 2);
+  std::vector<char> buffer(10);
+  auto r = tested.Read(buffer.data(), buffer.size());
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(std::string(10, 'a'), std::string(buffer.data(), 10));
+  EXPECT_STATUS_OK(tested.Close());
+  EXPECT_FALSE(tested.IsOpen());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
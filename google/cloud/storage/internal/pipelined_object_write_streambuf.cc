@@ -0,0 +1,233 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/pipelined_object_write_streambuf.h"
+#include "google/cloud/storage/internal/object_requests.h"
+#include <algorithm>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+PipelinedObjectWriteStreambuf::PipelinedObjectWriteStreambuf(
+    std::unique_ptr<ResumableUploadSession> upload_session,
+    std::size_t max_buffer_size, std::unique_ptr<HashValidator> hash_validator,
+    std::size_t max_in_flight, std::shared_ptr<BufferPool> buffer_pool)
+    : upload_session_(std::move(upload_session)),
+      session_id_(upload_session_->session_id()),
+      buffer_pool_(std::move(buffer_pool)),
+      max_buffer_size_(UploadChunkRequest::RoundUpToQuantum(max_buffer_size)),
+      max_in_flight_((std::max)(max_in_flight, std::size_t{1})),
+      hash_validator_(std::move(hash_validator)),
+      next_expected_byte_(upload_session_->next_expected_byte()),
+      last_response_(ResumableUploadResponse{
+          {}, 0, {}, ResumableUploadResponse::kInProgress, {}}) {
+  // Sessions start in a closed state for uploads that have already been
+  // finalized, there is nothing to upload in that case.
+  if (upload_session_->done()) {
+    last_response_ = upload_session_->last_response();
+    closed_ = true;
+    return;
+  }
+  current_ios_buffer_ = PooledBuffer(buffer_pool_, max_buffer_size_);
+  auto* pbeg = current_ios_buffer_.data();
+  setp(pbeg, pbeg + current_ios_buffer_.size());
+  uploader_ = std::thread([this] { Run(); });
+}
+
+PipelinedObjectWriteStreambuf::~PipelinedObjectWriteStreambuf() {
+  if (!uploader_.joinable()) return;
+  // The stream was not closed, e.g., because the upload was suspended. Finish
+  // any pending uploads, but do not finalize the object.
+  if (!closed_) QueueCurrentBuffer(ChunkType::kStop);
+  uploader_.join();
+}
+
+StatusOr<ResumableUploadResponse> PipelinedObjectWriteStreambuf::Close() {
+  if (!closed_) {
+    closed_ = true;
+    QueueCurrentBuffer(ChunkType::kFinal);
+    uploader_.join();
+  }
+  std::lock_guard<std::mutex> lk(mu_);
+  return last_response_;
+}
+
+bool PipelinedObjectWriteStreambuf::IsOpen() const { return !closed_; }
+
+bool PipelinedObjectWriteStreambuf::ValidateHash(ObjectMetadata const& meta) {
+  hash_validator_->ProcessMetadata(meta);
+  hash_validator_result_ = std::move(*hash_validator_).Finish();
+  return !hash_validator_result_.is_mismatch;
+}
+
+std::uint64_t PipelinedObjectWriteStreambuf::next_expected_byte() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return next_expected_byte_;
+}
+
+Status PipelinedObjectWriteStreambuf::last_status() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return last_response_.status();
+}
+
+int PipelinedObjectWriteStreambuf::sync() {
+  if (closed_) return last_status().ok() ? 0 : traits_type::eof();
+  if (put_area_size() >= UploadChunkRequest::kChunkSizeQuantum) {
+    QueueCurrentBuffer(ChunkType::kData);
+  }
+  std::unique_lock<std::mutex> lk(mu_);
+  WaitForUploads(lk);
+  return last_response_ ? 0 : traits_type::eof();
+}
+
+std::streamsize PipelinedObjectWriteStreambuf::xsputn(char const* s,
+                                                      std::streamsize count) {
+  if (closed_ || !last_status().ok()) return traits_type::eof();
+
+  std::streamsize offset = 0;
+  while (offset < count) {
+    auto const n = (std::min)(count - offset,
+                              static_cast<std::streamsize>(epptr() - pptr()));
+    std::copy(s + offset, s + offset + n, pptr());
+    pbump(static_cast<int>(n));
+    offset += n;
+    // Hand the buffer to the uploader as soon as it is full, there is no
+    // reason to wait for more data.
+    if (pptr() == epptr()) {
+      QueueCurrentBuffer(ChunkType::kData);
+      if (!last_status().ok()) return traits_type::eof();
+    }
+  }
+  return count;
+}
+
+PipelinedObjectWriteStreambuf::int_type
+PipelinedObjectWriteStreambuf::overflow(int_type ch) {
+  // For ch == EOF this function must do nothing and return any value != EOF.
+  if (traits_type::eq_int_type(ch, traits_type::eof())) return 0;
+  if (closed_) return traits_type::eof();
+
+  if (pptr() == epptr()) QueueCurrentBuffer(ChunkType::kData);
+  if (!last_status().ok()) return traits_type::eof();
+  *pptr() = traits_type::to_char_type(ch);
+  pbump(1);
+  return ch;
+}
+
+void PipelinedObjectWriteStreambuf::QueueCurrentBuffer(ChunkType type) {
+  auto const actual_size = put_area_size();
+  auto const size =
+      type != ChunkType::kData
+          ? actual_size
+          : actual_size / UploadChunkRequest::kChunkSizeQuantum *
+                UploadChunkRequest::kChunkSizeQuantum;
+  Chunk chunk{type, std::move(current_ios_buffer_), size};
+  auto const* trailer = chunk.buffer.data() + size;
+  auto const trailer_size = actual_size - size;
+  setp(nullptr, nullptr);
+  if (type == ChunkType::kData) {
+    // Start the next buffer before the chunk is queued, as the uploader may
+    // release it at any time after that.
+    current_ios_buffer_ = PooledBuffer(buffer_pool_, max_buffer_size_);
+    auto* pbeg = current_ios_buffer_.data();
+    setp(pbeg, pbeg + current_ios_buffer_.size());
+    std::copy(trailer, trailer + trailer_size, pptr());
+    pbump(static_cast<int>(trailer_size));
+  }
+
+  std::unique_lock<std::mutex> lk(mu_);
+  // The uploader must always receive the last chunk so it can exit, only the
+  // `kData` chunks are subject to flow control.
+  if (type == ChunkType::kData) {
+    cv_.wait(lk, [this] { return queue_.size() < max_in_flight_; });
+  }
+  queue_.push_back(std::move(chunk));
+  cv_.notify_all();
+}
+
+void PipelinedObjectWriteStreambuf::WaitForUploads(
+    std::unique_lock<std::mutex>& lk) {
+  cv_.wait(lk, [this] { return queue_.empty(); });
+}
+
+void PipelinedObjectWriteStreambuf::Run() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    cv_.wait(lk, [this] { return !queue_.empty(); });
+    // The chunk remains in the queue while it is uploaded, so it counts
+    // towards the in-flight limit. References to the elements of a deque
+    // remain valid when new elements are added at the end.
+    auto const& chunk = queue_.front();
+    auto const type = chunk.type;
+    if (type != ChunkType::kStop && last_response_) {
+      lk.unlock();
+      auto response = Upload(chunk);
+      lk.lock();
+      last_response_ = std::move(response);
+      next_expected_byte_ = upload_session_->next_expected_byte();
+    }
+    queue_.pop_front();
+    cv_.notify_all();
+    if (type != ChunkType::kData) break;
+  }
+  // Release the upload session, from now on the stream is closed.
+  lk.unlock();
+  upload_session_.reset();
+}
+
+StatusOr<ResumableUploadResponse> PipelinedObjectWriteStreambuf::Upload(
+    Chunk const& chunk) {
+  hash_validator_->Update(chunk.buffer.data(), chunk.size);
+  ConstBufferSequence payload{ConstBuffer(chunk.buffer.data(), chunk.size)};
+
+  auto const first_buffered_byte = upload_session_->next_expected_byte();
+  auto const expected_next_byte = first_buffered_byte + chunk.size;
+  if (chunk.type == ChunkType::kFinal) {
+    return upload_session_->UploadFinalChunk(payload, expected_next_byte);
+  }
+
+  auto response = upload_session_->UploadChunk(payload);
+  if (!response) return response;
+
+  // GCS upload returns an updated range header that sets the next expected
+  // byte. Check to make sure it remains consistent with the bytes uploaded so
+  // far, any data before the current chunk has been released.
+  auto actual_next_byte = upload_session_->next_expected_byte();
+  if (actual_next_byte < expected_next_byte &&
+      actual_next_byte < first_buffered_byte) {
+    std::ostringstream error_message;
+    error_message << "Could not continue upload stream. GCS requested byte "
+                  << actual_next_byte << " which has already been uploaded.";
+    return Status(StatusCode::kAborted, error_message.str());
+  }
+  if (actual_next_byte > expected_next_byte) {
+    std::ostringstream error_message;
+    error_message << "Could not continue upload stream. "
+                  << "GCS requested unexpected byte. (expected: "
+                  << expected_next_byte << ", actual: " << actual_next_byte
+                  << ")";
+    return Status(StatusCode::kAborted, error_message.str());
+  }
+  return response;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,127 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_PIPELINED_OBJECT_WRITE_STREAMBUF_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_PIPELINED_OBJECT_WRITE_STREAMBUF_H
+
+#include "google/cloud/storage/internal/object_streambuf.h"
+#include "google/cloud/storage/internal/pooled_buffer.h"
+#include "google/cloud/storage/version.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A streambuf that uploads full buffers in a background thread.
+ *
+ * `ObjectWriteStreambuf` uploads each chunk in the thread writing to the
+ * stream, so the application cannot produce more data until the upload
+ * completes. This class hands each full buffer to a background thread, and
+ * the application continues writing into a new buffer. At most
+ * @p max_in_flight buffers are queued (or being uploaded), once this limit is
+ * reached writing to the stream blocks until an upload completes.
+ *
+ * The hashes are computed in the background thread, in the same order as the
+ * data is uploaded. Upload errors are reported by the next write to the
+ * stream, or by `Close()`.
+ */
+class PipelinedObjectWriteStreambuf : public ObjectWriteStreambuf {
+ public:
+  PipelinedObjectWriteStreambuf(
+      std::unique_ptr<ResumableUploadSession> upload_session,
+      std::size_t max_buffer_size,
+      std::unique_ptr<HashValidator> hash_validator, std::size_t max_in_flight,
+      std::shared_ptr<BufferPool> buffer_pool = DefaultBufferPool());
+
+  ~PipelinedObjectWriteStreambuf() override;
+
+  StatusOr<ResumableUploadResponse> Close() override;
+  bool IsOpen() const override;
+  bool ValidateHash(ObjectMetadata const& meta) override;
+
+  std::string const& received_hash() const override {
+    return hash_validator_result_.received;
+  }
+  std::string const& computed_hash() const override {
+    return hash_validator_result_.computed;
+  }
+  std::string const& resumable_session_id() const override {
+    return session_id_;
+  }
+  std::uint64_t next_expected_byte() const override;
+  Status last_status() const override;
+
+ protected:
+  int sync() override;
+  std::streamsize xsputn(char const* s, std::streamsize count) override;
+  int_type overflow(int_type ch) override;
+
+ private:
+  enum class ChunkType { kData, kFinal, kStop };
+  struct Chunk {
+    ChunkType type;
+    PooledBuffer buffer;
+    std::size_t size;
+  };
+
+  /**
+   * Queue the data in the put area, blocking if too many chunks are queued.
+   *
+   * For `kData` chunks only a multiple of the upload quantum is queued, any
+   * trailing bytes are copied to the new put area.
+   */
+  void QueueCurrentBuffer(ChunkType type);
+
+  /// Wait until all the queued buffers are uploaded.
+  void WaitForUploads(std::unique_lock<std::mutex>& lk);
+
+  void Run();
+  StatusOr<ResumableUploadResponse> Upload(Chunk const& chunk);
+
+  std::size_t put_area_size() const { return pptr() - pbase(); }
+
+  std::unique_ptr<ResumableUploadSession> upload_session_;
+  std::string session_id_;
+  std::shared_ptr<BufferPool> buffer_pool_;
+  std::size_t max_buffer_size_;
+  std::size_t max_in_flight_;
+  PooledBuffer current_ios_buffer_;
+  bool closed_ = false;
+
+  // Only used by the background thread until it exits.
+  std::unique_ptr<HashValidator> hash_validator_;
+  HashValidator::Result hash_validator_result_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Chunk> queue_;
+  std::uint64_t next_expected_byte_;
+  StatusOr<ResumableUploadResponse> last_response_;
+  std::thread uploader_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_PIPELINED_OBJECT_WRITE_STREAMBUF_H
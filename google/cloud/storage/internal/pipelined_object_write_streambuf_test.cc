@@ -0,0 +1,248 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/pipelined_object_write_streambuf.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <atomic>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+auto constexpr kQuantum = UploadChunkRequest::kChunkSizeQuantum;
+
+ResumableUploadResponse InProgress(std::uint64_t next_byte) {
+  return ResumableUploadResponse{"",
+                                 next_byte == 0 ? 0 : next_byte - 1,
+                                 {},
+                                 ResumableUploadResponse::kInProgress,
+                                 {}};
+}
+
+/// Create a mock session that tracks the number of bytes uploaded.
+std::unique_ptr<testing::MockResumableUploadSession> MockSession(
+    std::string const& session_id, std::atomic<std::uint64_t>& next_byte) {
+  auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+  EXPECT_CALL(*mock, done).WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock, session_id).WillRepeatedly(ReturnRef(session_id));
+  EXPECT_CALL(*mock, next_expected_byte).WillRepeatedly([&next_byte] {
+    return next_byte.load();
+  });
+  return mock;
+}
+
+TEST(PipelinedObjectWriteStreambufTest, EmptyStream) {
+  std::string const id = "test-session-id";
+  std::atomic<std::uint64_t> next_byte{0};
+  auto mock = MockSession(id, next_byte);
+  EXPECT_CALL(*mock, UploadChunk).Times(0);
+  EXPECT_CALL(*mock, UploadFinalChunk(_, 0))
+      .WillOnce([](ConstBufferSequence const& p, std::uint64_t) {
+        EXPECT_EQ(0U, TotalBytes(p));
+        return make_status_or(InProgress(0));
+      });
+
+  PipelinedObjectWriteStreambuf tested(
+      std::move(mock), kQuantum, absl::make_unique<NullHashValidator>(), 2);
+  EXPECT_EQ(id, tested.resumable_session_id());
+  EXPECT_TRUE(tested.IsOpen());
+  auto response = tested.Close();
+  EXPECT_STATUS_OK(response);
+  EXPECT_FALSE(tested.IsOpen());
+}
+
+TEST(PipelinedObjectWriteStreambufTest, MultipleChunks) {
+  std::string const id = "test-session-id";
+  std::atomic<std::uint64_t> next_byte{0};
+  auto mock = MockSession(id, next_byte);
+
+  std::string uploaded;
+  EXPECT_CALL(*mock, UploadChunk)
+      .Times(3)
+      .WillRepeatedly([&](ConstBufferSequence const& p) {
+        EXPECT_EQ(kQuantum, TotalBytes(p));
+        for (auto const& b : p) uploaded.append(b.data(), b.size());
+        next_byte += TotalBytes(p);
+        return make_status_or(InProgress(next_byte));
+      });
+  EXPECT_CALL(*mock, UploadFinalChunk)
+      .WillOnce([&](ConstBufferSequence const& p, std::uint64_t size) {
+        for (auto const& b : p) uploaded.append(b.data(), b.size());
+        EXPECT_EQ(uploaded.size(), size);
+        return make_status_or(InProgress(size));
+      });
+
+  PipelinedObjectWriteStreambuf tested(
+      std::move(mock), kQuantum, absl::make_unique<NullHashValidator>(), 2);
+  std::string const payload(3 * kQuantum + 10, 'A');
+  std::string const trailer = "0123456789";
+  // Write in pieces that do not align with the buffer size.
+  auto const piece = kQuantum / 3;
+  for (std::size_t offset = 0; offset < payload.size(); offset += piece) {
+    auto const n = (std::min)(piece, payload.size() - offset);
+    EXPECT_EQ(static_cast<std::streamsize>(n),
+              tested.sputn(payload.data() + offset, n));
+  }
+  for (auto c : trailer) EXPECT_EQ(c, tested.sputc(c));
+  auto response = tested.Close();
+  EXPECT_STATUS_OK(response);
+  EXPECT_EQ(payload + trailer, uploaded);
+  EXPECT_EQ(3 * kQuantum, tested.next_expected_byte());
+}
+
+/// @test Verify the application can write while a chunk is being uploaded.
+TEST(PipelinedObjectWriteStreambufTest, WriteDuringUpload) {
+  std::string const id = "test-session-id";
+  std::atomic<std::uint64_t> next_byte{0};
+  auto mock = MockSession(id, next_byte);
+
+  std::promise<void> upload_started;
+  std::promise<void> unblock;
+  EXPECT_CALL(*mock, UploadChunk)
+      .WillOnce([&](ConstBufferSequence const& p) {
+        upload_started.set_value();
+        unblock.get_future().wait();
+        next_byte += TotalBytes(p);
+        return make_status_or(InProgress(next_byte));
+      })
+      .WillOnce([&](ConstBufferSequence const& p) {
+        next_byte += TotalBytes(p);
+        return make_status_or(InProgress(next_byte));
+      });
+  EXPECT_CALL(*mock, UploadFinalChunk(_, 2 * kQuantum))
+      .WillOnce([](ConstBufferSequence const&, std::uint64_t size) {
+        return make_status_or(InProgress(size));
+      });
+
+  PipelinedObjectWriteStreambuf tested(
+      std::move(mock), kQuantum, absl::make_unique<NullHashValidator>(), 2);
+  std::string const payload(kQuantum, 'A');
+  EXPECT_EQ(static_cast<std::streamsize>(kQuantum),
+            tested.sputn(payload.data(), payload.size()));
+  upload_started.get_future().wait();
+  // The first upload is blocked, but there is room for another buffer.
+  EXPECT_EQ(static_cast<std::streamsize>(kQuantum),
+            tested.sputn(payload.data(), payload.size()));
+  unblock.set_value();
+  EXPECT_EQ(0, tested.pubsync());
+  EXPECT_EQ(2 * kQuantum, tested.next_expected_byte());
+  EXPECT_STATUS_OK(tested.Close());
+}
+
+TEST(PipelinedObjectWriteStreambufTest, UploadError) {
+  std::string const id = "test-session-id";
+  std::atomic<std::uint64_t> next_byte{0};
+  auto mock = MockSession(id, next_byte);
+
+  EXPECT_CALL(*mock, UploadChunk)
+      .WillOnce([&](ConstBufferSequence const& p) {
+        next_byte += TotalBytes(p);
+        return make_status_or(InProgress(next_byte));
+      })
+      .WillOnce([](ConstBufferSequence const&) {
+        return StatusOr<ResumableUploadResponse>(
+            Status(StatusCode::kPermissionDenied, "uh-oh"));
+      });
+  EXPECT_CALL(*mock, UploadFinalChunk).Times(0);
+
+  PipelinedObjectWriteStreambuf tested(
+      std::move(mock), kQuantum, absl::make_unique<NullHashValidator>(), 2);
+  std::string const payload(kQuantum, 'A');
+  tested.sputn(payload.data(), payload.size());
+  tested.sputn(payload.data(), payload.size());
+  EXPECT_EQ(-1, tested.pubsync());
+  EXPECT_THAT(tested.last_status(), StatusIs(StatusCode::kPermissionDenied));
+  EXPECT_EQ(-1, tested.sputn(payload.data(), payload.size()));
+  EXPECT_THAT(tested.Close(), StatusIs(StatusCode::kPermissionDenied));
+  EXPECT_EQ(kQuantum, tested.next_expected_byte());
+  EXPECT_EQ(id, tested.resumable_session_id());
+}
+
+TEST(PipelinedObjectWriteStreambufTest, UnexpectedNextByte) {
+  std::string const id = "test-session-id";
+  std::atomic<std::uint64_t> next_byte{0};
+  auto mock = MockSession(id, next_byte);
+
+  EXPECT_CALL(*mock, UploadChunk).WillOnce([&](ConstBufferSequence const& p) {
+    next_byte += 2 * TotalBytes(p);
+    return make_status_or(InProgress(next_byte));
+  });
+
+  PipelinedObjectWriteStreambuf tested(
+      std::move(mock), kQuantum, absl::make_unique<NullHashValidator>(), 2);
+  std::string const payload(kQuantum, 'A');
+  tested.sputn(payload.data(), payload.size());
+  EXPECT_EQ(-1, tested.pubsync());
+  EXPECT_THAT(tested.last_status(), StatusIs(StatusCode::kAborted));
+}
+
+/// @test Verify that destroying an open stream does not finalize the upload.
+TEST(PipelinedObjectWriteStreambufTest, DestroyWithoutClose) {
+  std::string const id = "test-session-id";
+  std::atomic<std::uint64_t> next_byte{0};
+  auto mock = MockSession(id, next_byte);
+
+  EXPECT_CALL(*mock, UploadChunk).WillOnce([&](ConstBufferSequence const& p) {
+    next_byte += TotalBytes(p);
+    return make_status_or(InProgress(next_byte));
+  });
+  EXPECT_CALL(*mock, UploadFinalChunk).Times(0);
+
+  auto tested = absl::make_unique<PipelinedObjectWriteStreambuf>(
+      std::move(mock), kQuantum, absl::make_unique<NullHashValidator>(), 2);
+  std::string const payload(kQuantum + 10, 'A');
+  tested->sputn(payload.data(), payload.size());
+  tested.reset();
+  EXPECT_EQ(kQuantum, next_byte.load());
+}
+
+TEST(PipelinedObjectWriteStreambufTest, AlreadyDone) {
+  std::string const id = "test-session-id";
+  auto mock = absl::make_unique<testing::MockResumableUploadSession>();
+  StatusOr<ResumableUploadResponse> const last_response(ResumableUploadResponse{
+      "url-for-test", 0, {}, ResumableUploadResponse::kDone, {}});
+  EXPECT_CALL(*mock, done).WillRepeatedly(Return(true));
+  EXPECT_CALL(*mock, session_id).WillRepeatedly(ReturnRef(id));
+  EXPECT_CALL(*mock, next_expected_byte).WillRepeatedly(Return(0));
+  EXPECT_CALL(*mock, last_response).WillOnce(ReturnRef(last_response));
+  EXPECT_CALL(*mock, UploadChunk).Times(0);
+  EXPECT_CALL(*mock, UploadFinalChunk).Times(0);
+
+  PipelinedObjectWriteStreambuf tested(
+      std::move(mock), kQuantum, absl::make_unique<NullHashValidator>(), 2);
+  EXPECT_FALSE(tested.IsOpen());
+  auto response = tested.Close();
+  ASSERT_STATUS_OK(response);
+  EXPECT_EQ("url-for-test", response->upload_session_url);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,91 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_POOLED_BUFFER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_POOLED_BUFFER_H
+
+#include "google/cloud/storage/buffer_pool.h"
+#include "google/cloud/storage/version.h"
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A fixed-size buffer allocated from a `BufferPool`.
+ *
+ * The buffer is returned to the pool when this object is destroyed or reset.
+ * Unlike `std::vector<char>` the contents are not initialized.
+ */
+class PooledBuffer {
+ public:
+  PooledBuffer() = default;
+  PooledBuffer(std::shared_ptr<BufferPool> pool, std::size_t size)
+      : pool_(std::move(pool)),
+        data_(size == 0 ? nullptr : pool_->Allocate(size)),
+        size_(data_ == nullptr ? 0 : size) {}
+
+  ~PooledBuffer() { reset(); }
+
+  PooledBuffer(PooledBuffer&& rhs) noexcept
+      : pool_(std::move(rhs.pool_)),
+        data_(rhs.data_),
+        size_(rhs.size_) {
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+  }
+  PooledBuffer& operator=(PooledBuffer&& rhs) noexcept {
+    PooledBuffer tmp(std::move(rhs));
+    swap(tmp);
+    return *this;
+  }
+
+  PooledBuffer(PooledBuffer const&) = delete;
+  PooledBuffer& operator=(PooledBuffer const&) = delete;
+
+  char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /// Return the buffer to the pool.
+  void reset() {
+    if (data_ != nullptr) pool_->Deallocate(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  void swap(PooledBuffer& rhs) noexcept {
+    std::swap(pool_, rhs.pool_);
+    std::swap(data_, rhs.data_);
+    std::swap(size_, rhs.size_);
+  }
+
+ private:
+  std::shared_ptr<BufferPool> pool_;
+  char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_POOLED_BUFFER_H
@@ -17,6 +17,7 @@
 
 #include "google/cloud/storage/bucket_metadata.h"
 #include "google/cloud/storage/client_options.h"
+#include "google/cloud/storage/internal/batch_requests.h"
 #include "google/cloud/storage/internal/bucket_acl_requests.h"
 #include "google/cloud/storage/internal/bucket_requests.h"
 #include "google/cloud/storage/internal/default_object_acl_requests.h"
@@ -177,6 +178,44 @@ class RawClient {
   virtual StatusOr<EmptyResponse> DeleteNotification(
       DeleteNotificationRequest const&) = 0;
   //@}
+
+  /**
+   * Runs several metadata operations using a single batch request.
+   *
+   * Not all the transports support batch requests, the default implementation
+   * returns a `kUnimplemented` error, and the caller should fallback to
+   * individual requests.
+   */
+  virtual StatusOr<BatchResponse> ExecuteBatch(BatchRequest const&) {
+    return Status(StatusCode::kUnimplemented,
+                  "batch requests are not supported by this client");
+  }
+
+  /**
+   * Establishes the connections used by future requests.
+   *
+   * Only the transports that keep a pool of connections have any work to do,
+   * the default implementation does nothing.
+   */
+  virtual Status WarmUpConnectionPool() { return Status(); }
+
+  /**
+   * Lists objects into the compact representation of `CompactObjectList`.
+   *
+   * The transports receiving JSON payloads parse them directly into the compact
+   * representation. The default implementation converts the results of
+   * `ListObjects()`, one page at a time.
+   */
+  virtual StatusOr<ListObjectsCompactResponse> ListObjectsCompact(
+      ListObjectsRequest const& request) {
+    auto response = ListObjects(request);
+    if (!response) return std::move(response).status();
+    ListObjectsCompactResponse result;
+    result.next_page_token = std::move(response->next_page_token);
+    for (auto const& item : response->items) result.items.Append(item);
+    for (auto& p : response->prefixes) result.items.AddPrefix(std::move(p));
+    return result;
+  }
 };
 
 }  // namespace internal
@@ -83,6 +83,13 @@ class ResumableUploadSession {
 
   /// Returns the last upload response encountered during the upload.
   virtual StatusOr<ResumableUploadResponse> const& last_response() const = 0;
+
+  /**
+   * Returns the number of retried attempts to upload chunks in this session.
+   *
+   * Only sessions that retry failed requests need to override this function.
+   */
+  virtual std::uint64_t retry_count() const { return 0; }
 };
 
 struct ResumableUploadResponse {
@@ -13,13 +13,15 @@
 // limitations under the License.
 
 #include "google/cloud/storage/internal/retry_client.h"
+#include "google/cloud/storage/internal/hedged_object_read_source.h"
 #include "google/cloud/storage/internal/raw_client_wrapper_utils.h"
 #include "google/cloud/storage/internal/retry_object_read_source.h"
 #include "google/cloud/storage/internal/retry_resumable_upload_session.h"
+#include "google/cloud/cancellation.h"
 #include "google/cloud/internal/retry_policy.h"
 #include "absl/memory/memory.h"
+#include <algorithm>
 #include <sstream>
-#include <thread>
 
 // Define the defaults using a pre-processor macro, this allows the application
 // developers to change the defaults for their application by compiling with
@@ -50,6 +52,39 @@ namespace {
 using ::google::cloud::internal::Idempotency;
 using ::google::cloud::storage::internal::raw_client_wrapper_utils::Signature;
 
+/// Returns the bucket name for requests that have one.
+template <typename Request>
+auto BucketName(Request const& request, int)
+    -> decltype(request.bucket_name(), std::string()) {
+  return request.bucket_name();
+}
+
+/// Requests without a bucket name share a single (unnamed) limit.
+template <typename Request>
+std::string BucketName(Request const&, long) {  // NOLINT(google-runtime-int)
+  return std::string{};
+}
+
+/// Returns the operation deadline for requests that support it.
+template <typename Request>
+auto RequestDeadline(Request const& request, int)
+    -> decltype(request.template GetOption<OperationDeadline>()) {
+  return request.template GetOption<OperationDeadline>();
+}
+
+/// Some requests (e.g. restoring an upload session) do not have options.
+template <typename Request>
+OperationDeadline RequestDeadline(Request const&,
+                                  long) {  // NOLINT(google-runtime-int)
+  return OperationDeadline{};
+}
+
+/// HTTP 429 and 503 errors (and their gRPC equivalents) map to these codes.
+bool IsOverloaded(Status const& status) {
+  return status.code() == StatusCode::kUnavailable ||
+         status.code() == StatusCode::kResourceExhausted;
+}
+
 /**
  * Calls a client operation with retries borrowing the RPC policies.
  *
@@ -59,6 +94,8 @@ using ::google::cloud::storage::internal::raw_client_wrapper_utils::Signature;
  *     for how long we can retry
  * @param backoff_policy the policy controlling how long to wait before
  *     retrying.
+ * @param rate_limiter if not null, wait for capacity in this rate limiter
+ *     before each attempt, and notify it about overload errors.
  * @param function the pointer to the member function to call.
  * @param request an initialized request parameter for the call.
  * @param error_message include this message in any exception or error log.
@@ -68,7 +105,8 @@ using ::google::cloud::storage::internal::raw_client_wrapper_utils::Signature;
 template <typename MemberFunction>
 typename Signature<MemberFunction>::ReturnType MakeCall(
     RetryPolicy& retry_policy, BackoffPolicy& backoff_policy,
-    Idempotency idempotency, RawClient& client, MemberFunction function,
+    Idempotency idempotency, RateLimiter* rate_limiter, RawClient& client,
+    MemberFunction function,
     typename Signature<MemberFunction>::RequestType const& request,
     char const* error_message) {
   Status last_status(StatusCode::kDeadlineExceeded,
@@ -77,12 +115,46 @@ typename Signature<MemberFunction>::ReturnType MakeCall(
     return Status(last_status.code(), msg);
   };
 
+  auto const bucket = rate_limiter ? BucketName(request, 0) : std::string{};
+  // The transport limits each attempt to the time left before the deadline,
+  // the loop stops once there is not enough time for another attempt.
+  auto const deadline = RequestDeadline(request, 0);
+  bool attempted = false;
+  auto deadline_error = [&] {
+    std::ostringstream os;
+    os << "Operation deadline exceeded in " << error_message;
+    if (attempted) os << ", last error: " << last_status;
+    return Status(StatusCode::kDeadlineExceeded, std::move(os).str());
+  };
+  // The transport cancels the transfer in progress, the loop stops retrying.
+  auto const token = google::cloud::internal::CurrentCancellationToken();
+  auto cancelled = [&] {
+    return google::cloud::internal::IsCancelled(token);
+  };
+  auto cancelled_error = [&] {
+    std::ostringstream os;
+    os << "Operation cancelled in " << error_message;
+    if (attempted) os << ", last error: " << last_status;
+    return Status(StatusCode::kCancelled, std::move(os).str());
+  };
   while (!retry_policy.IsExhausted()) {
+    if (rate_limiter) {
+      google::cloud::internal::SleepUnlessCancelled(
+          token, rate_limiter->ReserveRequest(bucket));
+    }
+    if (cancelled()) return cancelled_error();
+    if (!AttemptFitsDeadline(deadline)) return deadline_error();
+    attempted = true;
     auto result = (client.*function)(request);
     if (result.ok()) {
+      retry_policy.OnSuccess();
       return result;
     }
     last_status = std::move(result).status();
+    if (rate_limiter && IsOverloaded(last_status)) {
+      rate_limiter->OnThrottled(bucket);
+    }
+    if (cancelled()) return cancelled_error();
     if (idempotency == Idempotency::kNonIdempotent) {
       std::ostringstream os;
       os << "Error in non-idempotent operation " << error_message << ": "
@@ -102,12 +174,23 @@ typename Signature<MemberFunction>::ReturnType MakeCall(
       break;
     }
     auto delay = backoff_policy.OnCompletion();
-    std::this_thread::sleep_for(delay);
+    if (!AttemptFitsDeadline(deadline, delay)) return deadline_error();
+    google::cloud::internal::SleepUnlessCancelled(token, delay);
   }
   std::ostringstream os;
   os << "Retry policy exhausted in " << error_message << ": " << last_status;
   return error(std::move(os).str());
 }
+
+/// Applies an `IdempotencyPolicy` to each operation in a batch.
+struct IsIdempotentVisitor {
+  template <typename Request>
+  bool operator()(Request const& r) const {
+    return policy.IsIdempotent(r);
+  }
+  IdempotencyPolicy const& policy;
+};
+
 }  // namespace
 
 RetryClient::RetryClient(std::shared_ptr<RawClient> client, DefaultPolicies)
@@ -134,8 +217,9 @@ StatusOr<ListBucketsResponse> RetryClient::ListBuckets(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::ListBuckets, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ListBuckets,
+                  request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::CreateBucket(
@@ -145,8 +229,9 @@ StatusOr<BucketMetadata> RetryClient::CreateBucket(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::CreateBucket, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::CreateBucket,
+                  request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::GetBucketMetadata(
@@ -156,8 +241,9 @@ StatusOr<BucketMetadata> RetryClient::GetBucketMetadata(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::GetBucketMetadata, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::GetBucketMetadata,
+                  request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteBucket(
@@ -167,8 +253,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteBucket(
   auto idempotency = idempotency_policy_->IsIdempotent(request)
                          ? Idempotency::kIdempotent
                          : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::DeleteBucket, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::DeleteBucket,
+                  request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::UpdateBucket(
@@ -178,8 +265,9 @@ StatusOr<BucketMetadata> RetryClient::UpdateBucket(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::UpdateBucket, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::UpdateBucket,
+                  request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::PatchBucket(
@@ -189,8 +277,9 @@ StatusOr<BucketMetadata> RetryClient::PatchBucket(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::PatchBucket, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::PatchBucket,
+                  request, __func__);
 }
 
 StatusOr<IamPolicy> RetryClient::GetBucketIamPolicy(
@@ -200,8 +289,9 @@ StatusOr<IamPolicy> RetryClient::GetBucketIamPolicy(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::GetBucketIamPolicy, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::GetBucketIamPolicy,
+                  request, __func__);
 }
 
 StatusOr<NativeIamPolicy> RetryClient::GetNativeBucketIamPolicy(
@@ -211,7 +301,8 @@ StatusOr<NativeIamPolicy> RetryClient::GetNativeBucketIamPolicy(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::GetNativeBucketIamPolicy, request, __func__);
 }
 
@@ -222,8 +313,9 @@ StatusOr<IamPolicy> RetryClient::SetBucketIamPolicy(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::SetBucketIamPolicy, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::SetBucketIamPolicy,
+                  request, __func__);
 }
 
 StatusOr<NativeIamPolicy> RetryClient::SetNativeBucketIamPolicy(
@@ -233,7 +325,8 @@ StatusOr<NativeIamPolicy> RetryClient::SetNativeBucketIamPolicy(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::SetNativeBucketIamPolicy, request, __func__);
 }
 
@@ -245,7 +338,8 @@ RetryClient::TestBucketIamPermissions(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::TestBucketIamPermissions, request, __func__);
 }
 
@@ -256,7 +350,8 @@ StatusOr<BucketMetadata> RetryClient::LockBucketRetentionPolicy(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::LockBucketRetentionPolicy, request, __func__);
 }
 
@@ -267,8 +362,9 @@ StatusOr<ObjectMetadata> RetryClient::InsertObjectMedia(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::InsertObjectMedia, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::InsertObjectMedia,
+                  request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::CopyObject(
@@ -278,8 +374,9 @@ StatusOr<ObjectMetadata> RetryClient::CopyObject(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::CopyObject, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::CopyObject,
+                  request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::GetObjectMetadata(
@@ -289,8 +386,9 @@ StatusOr<ObjectMetadata> RetryClient::GetObjectMetadata(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::GetObjectMetadata, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::GetObjectMetadata,
+                  request, __func__);
 }
 
 StatusOr<std::unique_ptr<ObjectReadSource>> RetryClient::ReadObjectNotWrapped(
@@ -299,8 +397,9 @@ StatusOr<std::unique_ptr<ObjectReadSource>> RetryClient::ReadObjectNotWrapped(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(retry_policy, backoff_policy, idempotency, *client_,
-                  &RawClient::ReadObject, request, __func__);
+  return MakeCall(retry_policy, backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ReadObject,
+                  request, __func__);
 }
 
 StatusOr<std::unique_ptr<ObjectReadSource>> RetryClient::ReadObject(
@@ -311,6 +410,16 @@ StatusOr<std::unique_ptr<ObjectReadSource>> RetryClient::ReadObject(
   if (!child) {
     return child;
   }
+  // Only the initial download is hedged, resuming an interrupted download
+  // goes through `ReadObjectNotWrapped()`.
+  if (hedged_read_policy_ && idempotency_policy_->IsIdempotent(request)) {
+    auto client = client_;
+    child = std::unique_ptr<ObjectReadSource>(
+        absl::make_unique<HedgedObjectReadSource>(
+            *std::move(child),
+            [client, request] { return client->ReadObject(request); },
+            hedged_read_policy_));
+  }
   auto self = shared_from_this();
   return std::unique_ptr<ObjectReadSource>(new RetryObjectReadSource(
       self, request, *std::move(child), std::move(retry_policy),
@@ -324,8 +433,21 @@ StatusOr<ListObjectsResponse> RetryClient::ListObjects(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::ListObjects, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ListObjects,
+                  request, __func__);
+}
+
+StatusOr<ListObjectsCompactResponse> RetryClient::ListObjectsCompact(
+    ListObjectsRequest const& request) {
+  auto retry_policy = retry_policy_prototype_->clone();
+  auto backoff_policy = backoff_policy_prototype_->clone();
+  auto const idempotency = idempotency_policy_->IsIdempotent(request)
+                               ? Idempotency::kIdempotent
+                               : Idempotency::kNonIdempotent;
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
+                  &RawClient::ListObjectsCompact, request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteObject(
@@ -335,8 +457,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteObject(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::DeleteObject, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::DeleteObject,
+                  request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::UpdateObject(
@@ -346,8 +469,9 @@ StatusOr<ObjectMetadata> RetryClient::UpdateObject(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::UpdateObject, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::UpdateObject,
+                  request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::PatchObject(
@@ -357,8 +481,9 @@ StatusOr<ObjectMetadata> RetryClient::PatchObject(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::PatchObject, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::PatchObject,
+                  request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::ComposeObject(
@@ -368,8 +493,9 @@ StatusOr<ObjectMetadata> RetryClient::ComposeObject(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::ComposeObject, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ComposeObject,
+                  request, __func__);
 }
 
 StatusOr<RewriteObjectResponse> RetryClient::RewriteObject(
@@ -379,8 +505,9 @@ StatusOr<RewriteObjectResponse> RetryClient::RewriteObject(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::RewriteObject, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::RewriteObject,
+                  request, __func__);
 }
 
 StatusOr<std::unique_ptr<ResumableUploadSession>>
@@ -390,7 +517,8 @@ RetryClient::CreateResumableSession(ResumableUploadRequest const& request) {
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  auto result = MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  auto result = MakeCall(*retry_policy, *backoff_policy, idempotency,
+                         rate_limiter_.get(), *client_,
                          &RawClient::CreateResumableSession, request, __func__);
   if (!result.ok()) {
     return result;
@@ -407,8 +535,8 @@ RetryClient::RestoreResumableSession(std::string const& request) {
   auto retry_policy = retry_policy_prototype_->clone();
   auto backoff_policy = backoff_policy_prototype_->clone();
   return MakeCall(*retry_policy, *backoff_policy, Idempotency::kIdempotent,
-                  *client_, &RawClient::RestoreResumableSession, request,
-                  __func__);
+                  rate_limiter_.get(), *client_,
+                  &RawClient::RestoreResumableSession, request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteResumableUpload(
@@ -416,8 +544,8 @@ StatusOr<EmptyResponse> RetryClient::DeleteResumableUpload(
   auto retry_policy = retry_policy_prototype_->clone();
   auto backoff_policy = backoff_policy_prototype_->clone();
   return MakeCall(*retry_policy, *backoff_policy, Idempotency::kIdempotent,
-                  *client_, &RawClient::DeleteResumableUpload, request,
-                  __func__);
+                  rate_limiter_.get(), *client_,
+                  &RawClient::DeleteResumableUpload, request, __func__);
 }
 
 StatusOr<ListBucketAclResponse> RetryClient::ListBucketAcl(
@@ -427,8 +555,9 @@ StatusOr<ListBucketAclResponse> RetryClient::ListBucketAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::ListBucketAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ListBucketAcl,
+                  request, __func__);
 }
 
 StatusOr<BucketAccessControl> RetryClient::GetBucketAcl(
@@ -438,8 +567,9 @@ StatusOr<BucketAccessControl> RetryClient::GetBucketAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::GetBucketAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::GetBucketAcl,
+                  request, __func__);
 }
 
 StatusOr<BucketAccessControl> RetryClient::CreateBucketAcl(
@@ -449,8 +579,9 @@ StatusOr<BucketAccessControl> RetryClient::CreateBucketAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::CreateBucketAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::CreateBucketAcl,
+                  request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteBucketAcl(
@@ -460,8 +591,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteBucketAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::DeleteBucketAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::DeleteBucketAcl,
+                  request, __func__);
 }
 
 StatusOr<ListObjectAclResponse> RetryClient::ListObjectAcl(
@@ -471,8 +603,9 @@ StatusOr<ListObjectAclResponse> RetryClient::ListObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::ListObjectAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ListObjectAcl,
+                  request, __func__);
 }
 
 StatusOr<BucketAccessControl> RetryClient::UpdateBucketAcl(
@@ -482,8 +615,9 @@ StatusOr<BucketAccessControl> RetryClient::UpdateBucketAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::UpdateBucketAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::UpdateBucketAcl,
+                  request, __func__);
 }
 
 StatusOr<BucketAccessControl> RetryClient::PatchBucketAcl(
@@ -493,8 +627,9 @@ StatusOr<BucketAccessControl> RetryClient::PatchBucketAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::PatchBucketAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::PatchBucketAcl,
+                  request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::CreateObjectAcl(
@@ -504,8 +639,9 @@ StatusOr<ObjectAccessControl> RetryClient::CreateObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::CreateObjectAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::CreateObjectAcl,
+                  request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteObjectAcl(
@@ -515,8 +651,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::DeleteObjectAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::DeleteObjectAcl,
+                  request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::GetObjectAcl(
@@ -526,8 +663,9 @@ StatusOr<ObjectAccessControl> RetryClient::GetObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::GetObjectAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::GetObjectAcl,
+                  request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::UpdateObjectAcl(
@@ -537,8 +675,9 @@ StatusOr<ObjectAccessControl> RetryClient::UpdateObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::UpdateObjectAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::UpdateObjectAcl,
+                  request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::PatchObjectAcl(
@@ -548,8 +687,9 @@ StatusOr<ObjectAccessControl> RetryClient::PatchObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::PatchObjectAcl, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::PatchObjectAcl,
+                  request, __func__);
 }
 
 StatusOr<ListDefaultObjectAclResponse> RetryClient::ListDefaultObjectAcl(
@@ -559,7 +699,8 @@ StatusOr<ListDefaultObjectAclResponse> RetryClient::ListDefaultObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::ListDefaultObjectAcl, request, __func__);
 }
 
@@ -570,7 +711,8 @@ StatusOr<ObjectAccessControl> RetryClient::CreateDefaultObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::CreateDefaultObjectAcl, request, __func__);
 }
 
@@ -581,7 +723,8 @@ StatusOr<EmptyResponse> RetryClient::DeleteDefaultObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::DeleteDefaultObjectAcl, request, __func__);
 }
 
@@ -592,7 +735,8 @@ StatusOr<ObjectAccessControl> RetryClient::GetDefaultObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::GetDefaultObjectAcl, request, __func__);
 }
 
@@ -603,7 +747,8 @@ StatusOr<ObjectAccessControl> RetryClient::UpdateDefaultObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::UpdateDefaultObjectAcl, request, __func__);
 }
 
@@ -614,7 +759,8 @@ StatusOr<ObjectAccessControl> RetryClient::PatchDefaultObjectAcl(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_,
                   &RawClient::PatchDefaultObjectAcl, request, __func__);
 }
 
@@ -625,8 +771,9 @@ StatusOr<ServiceAccount> RetryClient::GetServiceAccount(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::GetServiceAccount, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::GetServiceAccount,
+                  request, __func__);
 }
 
 StatusOr<ListHmacKeysResponse> RetryClient::ListHmacKeys(
@@ -636,8 +783,9 @@ StatusOr<ListHmacKeysResponse> RetryClient::ListHmacKeys(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::ListHmacKeys, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ListHmacKeys,
+                  request, __func__);
 }
 
 StatusOr<CreateHmacKeyResponse> RetryClient::CreateHmacKey(
@@ -647,8 +795,9 @@ StatusOr<CreateHmacKeyResponse> RetryClient::CreateHmacKey(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::CreateHmacKey, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::CreateHmacKey,
+                  request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteHmacKey(
@@ -658,8 +807,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteHmacKey(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::DeleteHmacKey, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::DeleteHmacKey,
+                  request, __func__);
 }
 
 StatusOr<HmacKeyMetadata> RetryClient::GetHmacKey(
@@ -669,8 +819,9 @@ StatusOr<HmacKeyMetadata> RetryClient::GetHmacKey(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::GetHmacKey, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::GetHmacKey,
+                  request, __func__);
 }
 
 StatusOr<HmacKeyMetadata> RetryClient::UpdateHmacKey(
@@ -680,8 +831,9 @@ StatusOr<HmacKeyMetadata> RetryClient::UpdateHmacKey(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::UpdateHmacKey, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::UpdateHmacKey,
+                  request, __func__);
 }
 
 StatusOr<SignBlobResponse> RetryClient::SignBlob(
@@ -691,8 +843,9 @@ StatusOr<SignBlobResponse> RetryClient::SignBlob(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::SignBlob, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::SignBlob, request,
+                  __func__);
 }
 
 StatusOr<ListNotificationsResponse> RetryClient::ListNotifications(
@@ -702,8 +855,9 @@ StatusOr<ListNotificationsResponse> RetryClient::ListNotifications(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::ListNotifications, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ListNotifications,
+                  request, __func__);
 }
 
 StatusOr<NotificationMetadata> RetryClient::CreateNotification(
@@ -713,8 +867,9 @@ StatusOr<NotificationMetadata> RetryClient::CreateNotification(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::CreateNotification, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::CreateNotification,
+                  request, __func__);
 }
 
 StatusOr<NotificationMetadata> RetryClient::GetNotification(
@@ -724,8 +879,9 @@ StatusOr<NotificationMetadata> RetryClient::GetNotification(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::GetNotification, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::GetNotification,
+                  request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteNotification(
@@ -735,8 +891,35 @@ StatusOr<EmptyResponse> RetryClient::DeleteNotification(
   auto const idempotency = idempotency_policy_->IsIdempotent(request)
                                ? Idempotency::kIdempotent
                                : Idempotency::kNonIdempotent;
-  return MakeCall(*retry_policy, *backoff_policy, idempotency, *client_,
-                  &RawClient::DeleteNotification, request, __func__);
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::DeleteNotification,
+                  request, __func__);
+}
+
+StatusOr<BatchResponse> RetryClient::ExecuteBatch(
+    BatchRequest const& request) {
+  auto retry_policy = retry_policy_prototype_->clone();
+  auto backoff_policy = backoff_policy_prototype_->clone();
+  // Retrying the batch request repeats all its operations, that is only safe
+  // if all of them are idempotent. Failures in individual operations are
+  // reported in the response and not retried.
+  auto const all_idempotent =
+      std::all_of(request.operations().begin(), request.operations().end(),
+                  [this](BatchOperation const& op) {
+                    return absl::visit(
+                        IsIdempotentVisitor{*idempotency_policy_}, op);
+                  });
+  auto const idempotency =
+      all_idempotent ? Idempotency::kIdempotent : Idempotency::kNonIdempotent;
+  return MakeCall(*retry_policy, *backoff_policy, idempotency,
+                  rate_limiter_.get(), *client_, &RawClient::ExecuteBatch,
+                  request, __func__);
+}
+
+Status RetryClient::WarmUpConnectionPool() {
+  // Warming up the pool is an optimization, failures are not retried. Any
+  // connections that failed are created on demand by future requests.
+  return client_->WarmUpConnectionPool();
 }
 
 }  // namespace internal
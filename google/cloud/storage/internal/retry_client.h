@@ -15,9 +15,11 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_RETRY_CLIENT_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_RETRY_CLIENT_H
 
+#include "google/cloud/storage/hedged_read_policy.h"
 #include "google/cloud/storage/idempotency_policy.h"
 #include "google/cloud/storage/internal/raw_client.h"
 #include "google/cloud/storage/internal/resumable_upload_session.h"
+#include "google/cloud/storage/rate_limiter.h"
 #include "google/cloud/storage/retry_policy.h"
 #include "google/cloud/storage/version.h"
 
@@ -87,6 +89,8 @@ class RetryClient : public RawClient,
       ReadObjectRangeRequest const&) override;
 
   StatusOr<ListObjectsResponse> ListObjects(ListObjectsRequest const&) override;
+  StatusOr<ListObjectsCompactResponse> ListObjectsCompact(
+      ListObjectsRequest const&) override;
   StatusOr<EmptyResponse> DeleteObject(DeleteObjectRequest const&) override;
   StatusOr<ObjectMetadata> UpdateObject(
       UpdateObjectRequest const& request) override;
@@ -162,7 +166,23 @@ class RetryClient : public RawClient,
   StatusOr<EmptyResponse> DeleteNotification(
       DeleteNotificationRequest const&) override;
 
+  StatusOr<BatchResponse> ExecuteBatch(BatchRequest const&) override;
+  Status WarmUpConnectionPool() override;
+
   std::shared_ptr<RawClient> client() const { return client_; }
+  std::shared_ptr<RetryPolicy const> retry_policy_prototype() const {
+    return retry_policy_prototype_;
+  }
+  std::shared_ptr<BackoffPolicy const> backoff_policy_prototype() const {
+    return backoff_policy_prototype_;
+  }
+  std::shared_ptr<IdempotencyPolicy const> idempotency_policy() const {
+    return idempotency_policy_;
+  }
+  std::shared_ptr<HedgedReadPolicy> hedged_read_policy() const {
+    return hedged_read_policy_;
+  }
+  std::shared_ptr<RateLimiter> rate_limiter() const { return rate_limiter_; }
 
  private:
   void Apply(RetryPolicy const& policy) {
@@ -177,6 +197,15 @@ class RetryClient : public RawClient,
     idempotency_policy_ = policy.clone();
   }
 
+  void Apply(HedgedReadPolicy const& policy) {
+    hedged_read_policy_ = policy.clone();
+  }
+
+  // The rate limiter is shared, possibly across many clients, and not cloned.
+  void Apply(std::shared_ptr<RateLimiter> limiter) {
+    rate_limiter_ = std::move(limiter);
+  }
+
   void ApplyPolicies() {}
 
   template <typename P, typename... Policies>
@@ -189,6 +218,8 @@ class RetryClient : public RawClient,
   std::shared_ptr<RetryPolicy const> retry_policy_prototype_;
   std::shared_ptr<BackoffPolicy const> backoff_policy_prototype_;
   std::shared_ptr<IdempotencyPolicy const> idempotency_policy_;
+  std::shared_ptr<HedgedReadPolicy> hedged_read_policy_;
+  std::shared_ptr<RateLimiter> rate_limiter_;
 };
 
 }  // namespace internal
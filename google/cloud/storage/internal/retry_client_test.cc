@@ -15,9 +15,15 @@
 #include "google/cloud/storage/internal/retry_client.h"
 #include "google/cloud/storage/testing/canonical_errors.h"
 #include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/cancellation.h"
+#include "google/cloud/testing_util/assert_ok.h"
 #include "google/cloud/testing_util/chrono_literals.h"
 #include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
 #include <gmock/gmock.h>
+#include <cstring>
+#include <functional>
+#include <future>
 
 namespace google {
 namespace cloud {
@@ -27,10 +33,12 @@ namespace internal {
 namespace {
 
 using ::google::cloud::testing_util::chrono_literals::operator"" _us;
+using ::google::cloud::storage::testing::MockObjectReadSource;
 using ::google::cloud::storage::testing::canonical_errors::PermanentError;
 using ::google::cloud::storage::testing::canonical_errors::TransientError;
 using ::google::cloud::testing_util::StatusIs;
 using ::testing::_;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Return;
 
@@ -92,6 +100,47 @@ TEST_F(RetryClientTest, TooManyTransientsHandling) {
   EXPECT_THAT(result, StatusIs(TransientError().code()));
 }
 
+/// @test Verify that an expired operation deadline stops the retry loop.
+TEST_F(RetryClientTest, OperationDeadlineExpired) {
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock_),
+                     LimitedErrorCountRetryPolicy(3),
+                     ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  EXPECT_CALL(*mock_, GetObjectMetadata(_)).Times(0);
+
+  auto result = client.GetObjectMetadata(
+      GetObjectMetadataRequest("test-bucket", "test-object")
+          .set_multiple_options(
+              OperationDeadline(std::chrono::system_clock::now())));
+  EXPECT_THAT(result, StatusIs(StatusCode::kDeadlineExceeded,
+                               HasSubstr("Operation deadline exceeded")));
+}
+
+/// @test Verify that the retry loop stops when a backoff exceeds the deadline.
+TEST_F(RetryClientTest, OperationDeadlineStopsRetries) {
+  RetryClient client(
+      std::shared_ptr<internal::RawClient>(mock_),
+      LimitedErrorCountRetryPolicy(100),
+      ExponentialBackoffPolicy(std::chrono::milliseconds(100),
+                               std::chrono::milliseconds(100), 2));
+
+  // The first attempt fits in the deadline, but there is no time to retry
+  // after the backoff.
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce([](GetObjectMetadataRequest const& r) {
+        EXPECT_TRUE(r.HasOption<OperationDeadline>());
+        return StatusOr<ObjectMetadata>(TransientError());
+      });
+
+  auto result = client.GetObjectMetadata(
+      GetObjectMetadataRequest("test-bucket", "test-object")
+          .set_multiple_options(
+              OperationDeadline(std::chrono::system_clock::now() +
+                                std::chrono::milliseconds(50))));
+  EXPECT_THAT(result, StatusIs(StatusCode::kDeadlineExceeded,
+                               HasSubstr(TransientError().message())));
+}
+
 /// @test Verify that the retry loop works with exhausted retry policy.
 TEST_F(RetryClientTest, ExpiredRetryPolicy) {
   RetryClient client(std::shared_ptr<internal::RawClient>(mock_),
@@ -107,6 +156,142 @@ TEST_F(RetryClientTest, ExpiredRetryPolicy) {
                HasSubstr("Retry policy exhausted before first attempt")));
 }
 
+class FakeRateLimiter : public RateLimiter {
+ public:
+  std::chrono::microseconds ReserveRequest(std::string const& bucket) override {
+    requests.push_back(bucket);
+    return std::chrono::microseconds(0);
+  }
+  std::chrono::microseconds ReserveBytes(std::string const&,
+                                         std::uint64_t) override {
+    return std::chrono::microseconds(0);
+  }
+  void OnThrottled(std::string const& bucket) override {
+    throttled.push_back(bucket);
+  }
+
+  std::vector<std::string> requests;
+  std::vector<std::string> throttled;
+};
+
+/// @test Verify that each attempt reserves capacity in the rate limiter.
+TEST_F(RetryClientTest, RateLimiter) {
+  auto limiter = std::make_shared<FakeRateLimiter>();
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock_),
+                     LimitedErrorCountRetryPolicy(3),
+                     // Make the tests faster.
+                     ExponentialBackoffPolicy(1_us, 2_us, 2),
+                     std::shared_ptr<RateLimiter>(limiter));
+
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(TransientError())))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(PermanentError())));
+  EXPECT_CALL(*mock_, GetServiceAccount(_))
+      .WillOnce(Return(make_status_or(ServiceAccount{})));
+
+  auto metadata = client.GetObjectMetadata(
+      GetObjectMetadataRequest("test-bucket", "test-object"));
+  EXPECT_THAT(metadata, StatusIs(PermanentError().code()));
+  auto account =
+      client.GetServiceAccount(GetProjectServiceAccountRequest("test-project"));
+  EXPECT_STATUS_OK(account);
+
+  EXPECT_THAT(limiter->requests,
+              ElementsAre("test-bucket", "test-bucket", std::string{}));
+  EXPECT_THAT(limiter->throttled, ElementsAre("test-bucket"));
+}
+
+/// @test Verify that downloads are hedged with a HedgedReadPolicy.
+TEST_F(RetryClientTest, HedgedReadObject) {
+  auto client = std::make_shared<RetryClient>(
+      std::shared_ptr<internal::RawClient>(mock_),
+      LimitedErrorCountRetryPolicy(3), ExponentialBackoffPolicy(1_us, 2_us, 2),
+      FixedDelayHedgedReadPolicy(std::chrono::milliseconds(10)));
+  ASSERT_NE(nullptr, client->hedged_read_policy());
+
+  auto make_source = [](std::string contents,
+                        std::shared_future<void> const& ready,
+                        std::function<void()> const& on_close) {
+    auto source = absl::make_unique<MockObjectReadSource>();
+    // The losing source is deleted by a background thread, which may outlive
+    // the test. Its expectations are verified via `on_close`.
+    ::testing::Mock::AllowLeak(source.get());
+    EXPECT_CALL(*source, Read)
+        .WillOnce([contents, ready](char* buf, std::size_t) {
+          ready.wait();
+          std::memcpy(buf, contents.data(), contents.size());
+          return make_status_or(ReadSourceResult{
+              contents.size(), HttpResponse{HttpStatusCode::kOk, {}, {}}});
+        });
+    EXPECT_CALL(*source, Close).WillRepeatedly([on_close] {
+      on_close();
+      return make_status_or(HttpResponse{HttpStatusCode::kOk, {}, {}});
+    });
+    return make_status_or(std::unique_ptr<ObjectReadSource>(std::move(source)));
+  };
+  std::promise<void> release_slow;
+  auto slow = release_slow.get_future().share();
+  std::promise<void> slow_closed;
+  std::promise<void> ready;
+  ready.set_value();
+  auto fast = ready.get_future().share();
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .WillOnce([&](ReadObjectRangeRequest const&) {
+        return make_source("slow", slow, [&] { slow_closed.set_value(); });
+      })
+      .WillOnce([&](ReadObjectRangeRequest const&) {
+        return make_source("fast", fast, [] {});
+      });
+
+  auto source =
+      client->ReadObject(ReadObjectRangeRequest("test-bucket", "test-object"));
+  ASSERT_TRUE(source.ok());
+  char buffer[16];
+  auto r = (*source)->Read(buffer, sizeof(buffer));
+  ASSERT_TRUE(r.ok());
+  EXPECT_EQ("fast", std::string(buffer, r->bytes_received));
+  // The slow download is closed as soon as its `Read()` returns.
+  release_slow.set_value();
+  slow_closed.get_future().wait();
+}
+
+/// @test Verify that a cancelled token stops the retry loop.
+TEST_F(RetryClientTest, CancelledBeforeStart) {
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock_),
+                     LimitedErrorCountRetryPolicy(3),
+                     ExponentialBackoffPolicy(1_us, 2_us, 2));
+  EXPECT_CALL(*mock_, GetObjectMetadata(_)).Times(0);
+
+  CancellationToken token;
+  token.Cancel();
+  CancellationScope scope(token);
+  StatusOr<ObjectMetadata> result = client.GetObjectMetadata(
+      GetObjectMetadataRequest("test-bucket", "test-object"));
+  EXPECT_THAT(result, StatusIs(StatusCode::kCancelled,
+                               HasSubstr("GetObjectMetadata")));
+}
+
+/// @test Verify that cancelling the token skips the backoff and retries.
+TEST_F(RetryClientTest, CancelDuringAttempt) {
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock_),
+                     LimitedErrorCountRetryPolicy(3),
+                     // The test would time out if the loop waited for these.
+                     ExponentialBackoffPolicy(std::chrono::hours(1),
+                                              std::chrono::hours(2), 2));
+  CancellationToken token;
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce([&token](GetObjectMetadataRequest const&) {
+        token.Cancel();
+        return StatusOr<ObjectMetadata>(TransientError());
+      });
+
+  CancellationScope scope(token);
+  StatusOr<ObjectMetadata> result = client.GetObjectMetadata(
+      GetObjectMetadataRequest("test-bucket", "test-object"));
+  EXPECT_THAT(result, StatusIs(StatusCode::kCancelled,
+                               HasSubstr(TransientError().message())));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
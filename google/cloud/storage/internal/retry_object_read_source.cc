@@ -14,7 +14,8 @@
 
 #include "google/cloud/storage/internal/retry_object_read_source.h"
 #include "google/cloud/log.h"
-#include <thread>
+#include <algorithm>
+#include <chrono>
 
 namespace google {
 namespace cloud {
@@ -42,16 +43,18 @@ RetryObjectReadSource::RetryObjectReadSource(
       backoff_policy_prototype_(std::move(backoff_policy)),
       offset_direction_(request_.HasOption<ReadLast>() ? kFromEnd
                                                        : kFromBeginning),
-      current_offset_(InitialOffset(offset_direction_, request_)) {}
+      current_offset_(InitialOffset(offset_direction_, request_)),
+      cancellation_token_(
+          google::cloud::internal::CurrentCancellationToken()) {}
 
-StatusOr<ReadSourceResult> RetryObjectReadSource::Read(char* buf,
-                                                       std::size_t n) {
+template <typename Result, typename Functor>
+StatusOr<Result> RetryObjectReadSource::ReadWithRetry(Functor read) {
   GCP_LOG(INFO) << __func__ << "() current_offset=" << current_offset_;
   if (!child_) {
     return Status(StatusCode::kFailedPrecondition, "Stream is not open");
   }
   // Refactor code to handle a successful read so we can return early.
-  auto handle_result = [this](StatusOr<ReadSourceResult> const& r) {
+  auto handle_result = [this](StatusOr<Result> const& r) {
     if (!r) {
       return false;
     }
@@ -67,7 +70,7 @@ StatusOr<ReadSourceResult> RetryObjectReadSource::Read(char* buf,
     return true;
   };
   // Read some data, if successful return immediately, saving some allocations.
-  auto result = child_->Read(buf, n);
+  auto result = read(*child_);
   if (handle_result(result)) {
     return result;
   }
@@ -82,15 +85,35 @@ StatusOr<ReadSourceResult> RetryObjectReadSource::Read(char* buf,
   // Start a new retry loop to get the data.
   auto backoff_policy = backoff_policy_prototype_->clone();
   auto retry_policy = retry_policy_prototype_->clone();
+  // The deadline covers the complete download, do not sleep past it.
+  auto const deadline = request_.GetOption<OperationDeadline>();
+  auto backoff = [&] {
+    auto delay = backoff_policy->OnCompletion();
+    if (!deadline.has_value()) return delay;
+    return (std::max)(std::chrono::milliseconds(0),
+                      (std::min)(delay, TimeRemaining(deadline)));
+  };
   int counter = 0;
   for (; !result && retry_policy->OnFailure(result.status());
-       std::this_thread::sleep_for(backoff_policy->OnCompletion()),
-       result = child_->Read(buf, n)) {
+       google::cloud::internal::SleepUnlessCancelled(cancellation_token_,
+                                                     backoff()),
+       result = read(*child_)) {
     // A Read() request failed, most likely that means the connection failed or
     // stalled. The current child might no longer be usable, so we will try to
     // create a new one and replace it. Should that fail, the retry policy would
     // already be exhausted, so we should fail this operation too.
     child_.reset();
+    if (google::cloud::internal::IsCancelled(cancellation_token_)) {
+      std::stringstream os;
+      os << "Read() cancelled, last error: " << result.status();
+      return Status(StatusCode::kCancelled, os.str());
+    }
+    if (!AttemptFitsDeadline(deadline)) {
+      std::stringstream os;
+      os << "Operation deadline exceeded in Read(), last error: "
+         << result.status();
+      return Status(StatusCode::kDeadlineExceeded, os.str());
+    }
 
     if (has_emulator_instructions) {
       request_.set_multiple_options(
@@ -106,6 +129,10 @@ StatusOr<ReadSourceResult> RetryObjectReadSource::Read(char* buf,
     if (generation_) {
       request_.set_option(Generation(*generation_));
     }
+    // The new download must be cancellable with the token of the original
+    // call, even if this thread no longer has it.
+    absl::optional<CancellationScope> scope;
+    if (cancellation_token_) scope.emplace(*cancellation_token_);
     auto new_child =
         client_->ReadObjectNotWrapped(request_, *retry_policy, *backoff_policy);
     if (!new_child) {
@@ -129,6 +156,18 @@ StatusOr<ReadSourceResult> RetryObjectReadSource::Read(char* buf,
   return Status(status.code(), os.str());
 }
 
+StatusOr<ReadSourceResult> RetryObjectReadSource::Read(char* buf,
+                                                       std::size_t n) {
+  return ReadWithRetry<ReadSourceResult>(
+      [buf, n](ObjectReadSource& child) { return child.Read(buf, n); });
+}
+
+StatusOr<ReadSourceBlock> RetryObjectReadSource::ReadBlock(char* buf,
+                                                           std::size_t n) {
+  return ReadWithRetry<ReadSourceBlock>(
+      [buf, n](ObjectReadSource& child) { return child.ReadBlock(buf, n); });
+}
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
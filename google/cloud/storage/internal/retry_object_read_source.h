@@ -18,6 +18,7 @@
 #include "google/cloud/storage/internal/object_read_source.h"
 #include "google/cloud/storage/internal/retry_client.h"
 #include "google/cloud/storage/version.h"
+#include "google/cloud/cancellation.h"
 #include "absl/types/optional.h"
 
 namespace google {
@@ -47,8 +48,13 @@ class RetryObjectReadSource : public ObjectReadSource {
   bool IsOpen() const override { return child_ && child_->IsOpen(); }
   StatusOr<HttpResponse> Close() override { return child_->Close(); }
   StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override;
+  StatusOr<ReadSourceBlock> ReadBlock(char* buf, std::size_t n) override;
 
  private:
+  /// Run @p read, creating a new child and retrying it on transient failures.
+  template <typename Result, typename Functor>
+  StatusOr<Result> ReadWithRetry(Functor read);
+
   std::shared_ptr<RetryClient> client_;
   ReadObjectRangeRequest request_;
   std::unique_ptr<ObjectReadSource> child_;
@@ -57,6 +63,7 @@ class RetryObjectReadSource : public ObjectReadSource {
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
   OffsetDirection offset_direction_;
   std::int64_t current_offset_;
+  absl::optional<CancellationToken> cancellation_token_;
 };
 
 }  // namespace internal
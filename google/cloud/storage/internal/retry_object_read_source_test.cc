@@ -298,6 +298,43 @@ TEST(RetryObjectReadSourceTest, TransientFailureWithReadLastOption) {
   auto res = (*source)->Read(nullptr, 1024);
   ASSERT_TRUE(res);
 }
+
+/// @test ReadBlock() resumes the download after transient failures.
+TEST(RetryObjectReadSourceTest, ReadBlockTransientFailure) {
+  auto raw_client = std::make_shared<testing::MockClient>();
+  auto client = std::make_shared<RetryClient>(
+      std::shared_ptr<internal::RawClient>(raw_client),
+      LimitedErrorCountRetryPolicy(3), StrictIdempotencyPolicy(),
+      ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  EXPECT_CALL(*raw_client, ReadObject(_))
+      .WillOnce([](ReadObjectRangeRequest const& req) {
+        EXPECT_FALSE(req.HasOption<ReadFromOffset>());
+        auto source = absl::make_unique<MockObjectReadSource>();
+        EXPECT_CALL(*source, Read)
+            .WillOnce(Return(ReadSourceResult{static_cast<std::size_t>(1024),
+                                              HttpResponse{100, "", {}}}))
+            .WillOnce(Return(TransientError()));
+        return std::unique_ptr<ObjectReadSource>(std::move(source));
+      })
+      .WillOnce([](ReadObjectRangeRequest const& req) {
+        EXPECT_EQ(1024, req.GetOption<ReadFromOffset>().value_or(0));
+        auto source = absl::make_unique<MockObjectReadSource>();
+        EXPECT_CALL(*source, Read).WillOnce(Return(ReadSourceResult{}));
+        return std::unique_ptr<ObjectReadSource>(std::move(source));
+      });
+
+  std::vector<char> buffer(1024);
+  auto source = client->ReadObject(ReadObjectRangeRequest{});
+  ASSERT_STATUS_OK(source);
+  auto block = (*source)->ReadBlock(buffer.data(), buffer.size());
+  ASSERT_STATUS_OK(block);
+  EXPECT_EQ(buffer.data(), block->data);
+  EXPECT_EQ(1024, block->bytes_received);
+  block = (*source)->ReadBlock(buffer.data(), buffer.size());
+  ASSERT_STATUS_OK(block);
+  EXPECT_EQ(0, block->bytes_received);
+}
 }  // namespace
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
@@ -113,12 +113,14 @@ RetryResumableUploadSession::UploadGenericChunk(
       last_status = Status(StatusCode::kUnavailable, os.str());
       // Don't reset the session on a short write nor wait according to the
       // backoff policy - we did get a response from the server after all.
+      ++retry_count_;
       continue;
     }
     last_status = std::move(result).status();
     if (!retry_policy->OnFailure(last_status)) {
       return ReturnError(std::move(last_status), *retry_policy, __func__);
     }
+    ++retry_count_;
     auto delay = backoff_policy->OnCompletion();
     std::this_thread::sleep_for(delay);
 
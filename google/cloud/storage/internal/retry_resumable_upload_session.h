@@ -51,6 +51,7 @@ class RetryResumableUploadSession : public ResumableUploadSession {
   std::string const& session_id() const override;
   bool done() const override;
   StatusOr<ResumableUploadResponse> const& last_response() const override;
+  std::uint64_t retry_count() const override { return retry_count_; }
 
  private:
   // Retry either UploadChunk or either UploadFinalChunk. Note that we need a
@@ -67,6 +68,7 @@ class RetryResumableUploadSession : public ResumableUploadSession {
   std::unique_ptr<ResumableUploadSession> session_;
   std::unique_ptr<RetryPolicy const> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
+  std::uint64_t retry_count_ = 0;
 };
 
 }  // namespace internal
@@ -191,14 +191,17 @@ TEST_F(RetryResumableUploadSessionTest, HandleTransient) {
   response = session.UploadChunk({{payload}});
   EXPECT_STATUS_OK(response);
   EXPECT_EQ(quantum - 1, response->last_committed_byte);
+  EXPECT_EQ(1, session.retry_count());
 
   response = session.UploadChunk({{payload}});
   EXPECT_STATUS_OK(response);
   EXPECT_EQ(2 * quantum - 1, response->last_committed_byte);
+  EXPECT_EQ(2, session.retry_count());
 
   response = session.UploadChunk({{payload}});
   EXPECT_STATUS_OK(response);
   EXPECT_EQ(3 * quantum - 1, response->last_committed_byte);
+  EXPECT_EQ(2, session.retry_count());
 }
 
 /// @test Verify that a permanent error on UploadChunk results in a failure.
@@ -330,6 +330,16 @@ class V4SignUrlRequest {
 
 std::ostream& operator<<(std::ostream& os, V4SignUrlRequest const& r);
 
+/// Sets the options on a `V4SignUrlRequest`, used with `internal::apply()`.
+struct V4SignUrlRequestSetOptions {
+  template <typename... Options>
+  void operator()(Options&&... options) const {
+    request.set_multiple_options(std::forward<Options>(options)...);
+  }
+
+  V4SignUrlRequest& request;
+};
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
@@ -0,0 +1,106 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/stage_timer.h"
+#ifndef _WIN32
+#include <time.h>
+#endif  // _WIN32
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+StageCpuTimes& ThreadTimes() {
+  static thread_local StageCpuTimes times{};
+  return times;
+}
+
+}  // namespace
+
+char const* ToString(Stage stage) {
+  switch (stage) {
+    case Stage::kTransport:
+      return "Transport";
+    case Stage::kHashing:
+      return "Hashing";
+    case Stage::kCopy:
+      return "Copy";
+    case Stage::kJsonParsing:
+      return "JsonParsing";
+  }
+  return "Unknown";
+}
+
+StageCpuTimes ThreadStageCpuTimes() { return ThreadTimes(); }
+
+StageCpuTimes ElapsedStageCpuTimes(StageCpuTimes const& start) {
+  auto result = ThreadTimes();
+  for (std::size_t i = 0; i != result.size(); ++i) result[i] -= start[i];
+  return result;
+}
+
+#ifdef GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS
+namespace {
+
+ScopedStageTimer*& CurrentTimer() {
+  static thread_local ScopedStageTimer* current = nullptr;
+  return current;
+}
+
+std::chrono::nanoseconds ThreadCpuTime() {
+#ifndef _WIN32
+  struct timespec ts;
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+#else
+  // There is no cheap per-thread CPU clock on Windows, the wall time is a
+  // reasonable approximation for CPU-bound stages.
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch());
+#endif  // _WIN32
+}
+
+}  // namespace
+
+bool StageTimersEnabled() { return true; }
+
+ScopedStageTimer::ScopedStageTimer(Stage stage)
+    : stage_(stage), parent_(CurrentTimer()), start_(ThreadCpuTime()) {
+  if (parent_ != nullptr) parent_->Charge(start_);
+  CurrentTimer() = this;
+}
+
+ScopedStageTimer::~ScopedStageTimer() {
+  auto const now = ThreadCpuTime();
+  Charge(now);
+  CurrentTimer() = parent_;
+  if (parent_ != nullptr) parent_->start_ = now;
+}
+
+void ScopedStageTimer::Charge(std::chrono::nanoseconds now) {
+  ThreadTimes()[static_cast<std::size_t>(stage_)] += now - start_;
+  start_ = now;
+}
+#else
+bool StageTimersEnabled() { return false; }
+#endif  // GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,106 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_STAGE_TIMER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_STAGE_TIMER_H
+
+#include "google/cloud/storage/version.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/// The stages of the upload and download paths measured by the stage timers.
+enum class Stage {
+  /// Time in libcurl, including the TLS encryption and decryption.
+  kTransport,
+  /// Computing the MD5 hashes and CRC32C checksums.
+  kHashing,
+  /// Copying data between the application, the streambufs, and libcurl.
+  kCopy,
+  /// Parsing JSON responses.
+  kJsonParsing,
+};
+
+std::size_t constexpr kStageCount = 4;
+
+/// The CPU time consumed in each stage, indexed by `Stage`.
+using StageCpuTimes = std::array<std::chrono::nanoseconds, kStageCount>;
+
+char const* ToString(Stage stage);
+
+/// Returns true if the library was compiled with the stage timers.
+bool StageTimersEnabled();
+
+/**
+ * Returns the CPU time that the calling thread consumed in each stage.
+ *
+ * The values only increase, the CPU time for an operation is the difference
+ * between the values before and after the operation. All the values are zero
+ * unless `StageTimersEnabled()`.
+ */
+StageCpuTimes ThreadStageCpuTimes();
+
+/// Returns the CPU time in each stage since @p start, for the calling thread.
+StageCpuTimes ElapsedStageCpuTimes(StageCpuTimes const& start);
+
+#ifdef GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS
+/**
+ * Charges the thread CPU time consumed in its scope to a stage.
+ *
+ * Timers can be nested, for example, libcurl invokes the callbacks that copy
+ * the data while the transport timer is active. Each timer only counts the
+ * time not charged to any nested timer, so the stages do not overlap.
+ *
+ * Use `GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER()`, which compiles to nothing
+ * unless `GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS` is defined. The macro
+ * declares a variable, so it can be used at most once per scope.
+ */
+class ScopedStageTimer {
+ public:
+  explicit ScopedStageTimer(Stage stage);
+  ~ScopedStageTimer();
+
+  ScopedStageTimer(ScopedStageTimer const&) = delete;
+  ScopedStageTimer& operator=(ScopedStageTimer const&) = delete;
+
+ private:
+  void Charge(std::chrono::nanoseconds now);
+
+  Stage stage_;
+  ScopedStageTimer* parent_;
+  std::chrono::nanoseconds start_;
+};
+
+#define GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(stage)    \
+  ::google::cloud::storage::internal::ScopedStageTimer \
+      google_cloud_cpp_storage_stage_timer(stage)
+#else
+// The timers are compiled out by default, they add two system calls (or vDSO
+// calls) per scope.
+#define GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(stage) static_cast<void>(0)
+#endif  // GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_STAGE_TIMER_H
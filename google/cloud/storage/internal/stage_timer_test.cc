@@ -0,0 +1,76 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/stage_timer.h"
+#include "google/cloud/storage/hashing_options.h"
+#include <gmock/gmock.h>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+std::size_t Index(Stage stage) { return static_cast<std::size_t>(stage); }
+
+TEST(StageTimer, ToString) {
+  EXPECT_STREQ("Transport", ToString(Stage::kTransport));
+  EXPECT_STREQ("Hashing", ToString(Stage::kHashing));
+  EXPECT_STREQ("Copy", ToString(Stage::kCopy));
+  EXPECT_STREQ("JsonParsing", ToString(Stage::kJsonParsing));
+}
+
+TEST(StageTimer, ChargesHashing) {
+  auto const before = ThreadStageCpuTimes();
+  std::string const data(16 * 1024 * 1024, 'a');
+  for (int i = 0; i != 4; ++i) (void)ComputeCrc32cChecksum(data);
+  auto const diff = ElapsedStageCpuTimes(before);
+  if (!StageTimersEnabled()) {
+    for (auto const& d : diff) EXPECT_EQ(std::chrono::nanoseconds(0), d);
+    return;
+  }
+  EXPECT_LT(std::chrono::nanoseconds(0), diff[Index(Stage::kHashing)]);
+  EXPECT_EQ(std::chrono::nanoseconds(0), diff[Index(Stage::kTransport)]);
+}
+
+#ifdef GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS
+TEST(StageTimer, NestedTimersDoNotOverlap) {
+  auto burn = [] {
+    std::string const data(16 * 1024 * 1024, 'a');
+    return ComputeMD5Hash(data);
+  };
+  auto const before = ThreadStageCpuTimes();
+  {
+    GOOGLE_CLOUD_CPP_STORAGE_STAGE_TIMER(Stage::kTransport);
+    {
+      ScopedStageTimer copy(Stage::kCopy);
+      (void)burn();
+    }
+  }
+  auto const diff = ElapsedStageCpuTimes(before);
+  // All the work happens in the nested hashing timer (inside ComputeMD5Hash),
+  // the outer timers only see the time to allocate and fill the data.
+  EXPECT_LT(diff[Index(Stage::kCopy)], diff[Index(Stage::kHashing)]);
+  EXPECT_LT(diff[Index(Stage::kTransport)], diff[Index(Stage::kHashing)]);
+}
+#endif  // GOOGLE_CLOUD_CPP_STORAGE_ENABLE_STAGE_TIMERS
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
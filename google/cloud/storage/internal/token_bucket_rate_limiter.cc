@@ -0,0 +1,116 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/token_bucket_rate_limiter.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+// The rates are never reduced below this fraction of the configured values.
+auto constexpr kMinimumFactor = 1.0 / 64;
+// After a rejection the rates grow by this fraction of the configured values
+// each second.
+auto constexpr kRecoveryPerSecond = 0.1;
+}  // namespace
+
+TokenBucketRateLimiter::TokenBucketRateLimiter(
+    TokenBucketRateLimiterOptions options)
+    : TokenBucketRateLimiter(std::move(options), [] { return Clock::now(); }) {}
+
+TokenBucketRateLimiter::TokenBucketRateLimiter(
+    TokenBucketRateLimiterOptions options,
+    std::function<Clock::time_point()> clock)
+    : options_(std::move(options)), clock_(std::move(clock)) {}
+
+std::chrono::microseconds TokenBucketRateLimiter::ReserveRequest(
+    std::string const& bucket) {
+  if (options_.requests_per_second() <= 0) return std::chrono::microseconds(0);
+  auto const now = clock_();
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& state = Refresh(bucket, now);
+  return Reserve(state.requests_tat, 1.0,
+                 options_.requests_per_second() * state.factor, now);
+}
+
+std::chrono::microseconds TokenBucketRateLimiter::ReserveBytes(
+    std::string const& bucket, std::uint64_t bytes) {
+  if (options_.bytes_per_second() <= 0 || bytes == 0) {
+    return std::chrono::microseconds(0);
+  }
+  auto const now = clock_();
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& state = Refresh(bucket, now);
+  return Reserve(state.bytes_tat, static_cast<double>(bytes),
+                 options_.bytes_per_second() * state.factor, now);
+}
+
+void TokenBucketRateLimiter::OnThrottled(std::string const& bucket) {
+  auto const now = clock_();
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& state = Refresh(bucket, now);
+  // Many requests in flight are rejected at about the same time, only the
+  // first rejection in each period reduces the rate.
+  if (now - state.last_throttled < options_.burst()) return;
+  state.last_throttled = now;
+  state.factor = (std::max)(kMinimumFactor, state.factor / 2);
+}
+
+double TokenBucketRateLimiter::rate_factor(std::string const& bucket) {
+  auto const now = clock_();
+  std::lock_guard<std::mutex> lk(mu_);
+  return Refresh(bucket, now).factor;
+}
+
+TokenBucketRateLimiter::State& TokenBucketRateLimiter::Refresh(
+    std::string const& bucket, Clock::time_point now) {
+  auto const key = options_.per_bucket() ? bucket : std::string{};
+  auto l = states_.find(key);
+  if (l == states_.end()) {
+    State state;
+    state.requests_tat = now;
+    state.bytes_tat = now;
+    state.last_update = now;
+    state.last_throttled = now - options_.burst();
+    l = states_.emplace(key, state).first;
+  }
+  auto& state = l->second;
+  if (state.factor < 1.0 && now > state.last_update) {
+    auto const elapsed =
+        std::chrono::duration<double>(now - state.last_update).count();
+    state.factor = (std::min)(1.0, state.factor + kRecoveryPerSecond * elapsed);
+  }
+  state.last_update = (std::max)(state.last_update, now);
+  return state;
+}
+
+std::chrono::microseconds TokenBucketRateLimiter::Reserve(
+    Clock::time_point& tat, double amount, double rate,
+    Clock::time_point now) const {
+  tat = (std::max)(tat, now) +
+        std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(amount / rate));
+  auto const wait = tat - options_.burst() - now;
+  if (wait <= Clock::duration::zero()) return std::chrono::microseconds(0);
+  return std::chrono::duration_cast<std::chrono::microseconds>(wait);
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
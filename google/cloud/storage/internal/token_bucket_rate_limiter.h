@@ -0,0 +1,83 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_TOKEN_BUCKET_RATE_LIMITER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_TOKEN_BUCKET_RATE_LIMITER_H
+
+#include "google/cloud/storage/rate_limiter.h"
+#include "google/cloud/storage/version.h"
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Implements `MakeTokenBucketRateLimiter()`.
+ *
+ * Each limit is tracked as a "theoretical arrival time": the time at which the
+ * capacity reserved so far would be consumed at the current rate. A
+ * reservation never fails, it pushes this time forward, and the caller waits
+ * until it is at most `burst()` in the future. This is equivalent to a token
+ * bucket, but needs no background refill.
+ */
+class TokenBucketRateLimiter : public RateLimiter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit TokenBucketRateLimiter(TokenBucketRateLimiterOptions options);
+  TokenBucketRateLimiter(TokenBucketRateLimiterOptions options,
+                         std::function<Clock::time_point()> clock);
+
+  std::chrono::microseconds ReserveRequest(std::string const& bucket) override;
+  std::chrono::microseconds ReserveBytes(std::string const& bucket,
+                                         std::uint64_t bytes) override;
+  void OnThrottled(std::string const& bucket) override;
+
+  /// The fraction of the configured rates currently in effect for @p bucket.
+  double rate_factor(std::string const& bucket);
+
+ private:
+  struct State {
+    Clock::time_point requests_tat;
+    Clock::time_point bytes_tat;
+    double factor = 1.0;
+    Clock::time_point last_update;
+    Clock::time_point last_throttled;
+  };
+
+  /// Returns the state for @p bucket, after applying any rate recovery.
+  State& Refresh(std::string const& bucket, Clock::time_point now);
+  std::chrono::microseconds Reserve(Clock::time_point& tat, double amount,
+                                    double rate, Clock::time_point now) const;
+
+  TokenBucketRateLimiterOptions options_;
+  std::function<Clock::time_point()> clock_;
+  std::mutex mu_;
+  std::unordered_map<std::string, State> states_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_TOKEN_BUCKET_RATE_LIMITER_H
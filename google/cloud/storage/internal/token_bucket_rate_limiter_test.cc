@@ -0,0 +1,160 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/token_bucket_rate_limiter.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::std::chrono::microseconds;
+using ::std::chrono::milliseconds;
+using ::std::chrono::seconds;
+using Clock = TokenBucketRateLimiter::Clock;
+
+class TokenBucketRateLimiterTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<TokenBucketRateLimiter> MakeTested(
+      TokenBucketRateLimiterOptions options) {
+    return absl::make_unique<TokenBucketRateLimiter>(std::move(options),
+                                                     [this] { return now_; });
+  }
+
+  Clock::time_point now_ = Clock::time_point{} + seconds(1000);
+};
+
+TEST_F(TokenBucketRateLimiterTest, Unlimited) {
+  auto tested = MakeTested(TokenBucketRateLimiterOptions{});
+  for (int i = 0; i != 1000; ++i) {
+    EXPECT_EQ(microseconds(0), tested->ReserveRequest("b"));
+    EXPECT_EQ(microseconds(0), tested->ReserveBytes("b", 1024 * 1024));
+  }
+}
+
+TEST_F(TokenBucketRateLimiterTest, Requests) {
+  auto tested = MakeTested(TokenBucketRateLimiterOptions{}
+                               .set_requests_per_second(10)
+                               .set_burst(seconds(1)));
+  // The first burst is free.
+  for (int i = 0; i != 10; ++i) {
+    EXPECT_EQ(microseconds(0), tested->ReserveRequest("b"));
+  }
+  // Then each request must wait for 100ms more than the previous one.
+  EXPECT_EQ(milliseconds(100), tested->ReserveRequest("b"));
+  EXPECT_EQ(milliseconds(200), tested->ReserveRequest("b"));
+  // As time passes the wait goes down.
+  now_ += milliseconds(500);
+  for (int i = 0; i != 3; ++i) {
+    EXPECT_EQ(microseconds(0), tested->ReserveRequest("b"));
+  }
+  EXPECT_EQ(milliseconds(100), tested->ReserveRequest("b"));
+  // After a long idle period the burst is available again, but no more.
+  now_ += seconds(60);
+  for (int i = 0; i != 10; ++i) {
+    EXPECT_EQ(microseconds(0), tested->ReserveRequest("b"));
+  }
+  EXPECT_EQ(milliseconds(100), tested->ReserveRequest("b"));
+}
+
+TEST_F(TokenBucketRateLimiterTest, Bytes) {
+  auto tested = MakeTested(TokenBucketRateLimiterOptions{}
+                               .set_bytes_per_second(1000)
+                               .set_burst(seconds(1)));
+  EXPECT_EQ(microseconds(0), tested->ReserveBytes("b", 1000));
+  EXPECT_EQ(seconds(2), tested->ReserveBytes("b", 2000));
+  EXPECT_EQ(seconds(2) + milliseconds(500), tested->ReserveBytes("b", 500));
+  // The requests are not limited.
+  EXPECT_EQ(microseconds(0), tested->ReserveRequest("b"));
+}
+
+TEST_F(TokenBucketRateLimiterTest, Global) {
+  auto tested = MakeTested(TokenBucketRateLimiterOptions{}
+                               .set_requests_per_second(1)
+                               .set_burst(seconds(1)));
+  EXPECT_EQ(microseconds(0), tested->ReserveRequest("b1"));
+  EXPECT_EQ(seconds(1), tested->ReserveRequest("b2"));
+  EXPECT_EQ(seconds(2), tested->ReserveRequest(""));
+}
+
+TEST_F(TokenBucketRateLimiterTest, PerBucket) {
+  auto tested = MakeTested(TokenBucketRateLimiterOptions{}
+                               .set_requests_per_second(1)
+                               .set_per_bucket(true)
+                               .set_burst(seconds(1)));
+  EXPECT_EQ(microseconds(0), tested->ReserveRequest("b1"));
+  EXPECT_EQ(microseconds(0), tested->ReserveRequest("b2"));
+  EXPECT_EQ(microseconds(0), tested->ReserveRequest(""));
+  EXPECT_EQ(seconds(1), tested->ReserveRequest("b1"));
+  EXPECT_EQ(seconds(1), tested->ReserveRequest("b2"));
+
+  tested->OnThrottled("b1");
+  EXPECT_EQ(0.5, tested->rate_factor("b1"));
+  EXPECT_EQ(1.0, tested->rate_factor("b2"));
+}
+
+TEST_F(TokenBucketRateLimiterTest, AdaptiveBackoff) {
+  auto tested = MakeTested(TokenBucketRateLimiterOptions{}
+                               .set_requests_per_second(10)
+                               .set_burst(seconds(1)));
+  EXPECT_EQ(1.0, tested->rate_factor("b"));
+  tested->OnThrottled("b");
+  EXPECT_EQ(0.5, tested->rate_factor("b"));
+  // Many rejections at about the same time reduce the rate only once.
+  tested->OnThrottled("b");
+  tested->OnThrottled("b");
+  EXPECT_EQ(0.5, tested->rate_factor("b"));
+
+  // At half the rate each request costs 200ms.
+  for (int i = 0; i != 5; ++i) {
+    EXPECT_EQ(microseconds(0), tested->ReserveRequest("b"));
+  }
+  EXPECT_EQ(milliseconds(200), tested->ReserveRequest("b"));
+
+  // The rate recovers linearly.
+  now_ += seconds(2);
+  EXPECT_NEAR(0.7, tested->rate_factor("b"), 1E-6);
+  now_ += seconds(10);
+  EXPECT_EQ(1.0, tested->rate_factor("b"));
+
+  // With a rejection every second the rate settles where the reduction and
+  // the recovery balance each other.
+  for (int i = 0; i != 100; ++i) {
+    tested->OnThrottled("b");
+    now_ += seconds(1);
+  }
+  EXPECT_NEAR(0.2, tested->rate_factor("b"), 1E-6);
+}
+
+TEST_F(TokenBucketRateLimiterTest, MinimumRate) {
+  auto tested = MakeTested(TokenBucketRateLimiterOptions{}
+                               .set_requests_per_second(64)
+                               .set_burst(microseconds(1)));
+  for (int i = 0; i != 100; ++i) {
+    tested->OnThrottled("b");
+    now_ += microseconds(1);
+  }
+  EXPECT_NEAR(1.0 / 64, tested->rate_factor("b"), 1E-3);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
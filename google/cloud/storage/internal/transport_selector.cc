@@ -0,0 +1,208 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/transport_selector.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_split.h"
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+// Each transport gets a few requests before the selector compares them.
+auto constexpr kMinSamples = 3;
+// Send one in this many requests to the slower transport, to detect changes.
+auto constexpr kExplorationPeriod = 20;
+// The weight of the older samples in the estimates.
+auto constexpr kDecay = 0.8;
+
+class MeasuredReadSource : public ObjectReadSource {
+ public:
+  MeasuredReadSource(
+      std::unique_ptr<ObjectReadSource> source,
+      std::function<void(std::uint64_t, std::chrono::microseconds)> report)
+      : source_(std::move(source)),
+        report_(std::move(report)),
+        start_(std::chrono::steady_clock::now()) {}
+  ~MeasuredReadSource() override { Report(); }
+
+  bool IsOpen() const override { return source_->IsOpen(); }
+
+  StatusOr<HttpResponse> Close() override {
+    auto response = source_->Close();
+    Report();
+    return response;
+  }
+
+  StatusOr<ReadSourceResult> Read(char* buf, std::size_t n) override {
+    return Update(source_->Read(buf, n));
+  }
+
+  StatusOr<ReadSourceBlock> ReadBlock(char* buf, std::size_t n) override {
+    return Update(source_->ReadBlock(buf, n));
+  }
+
+ private:
+  template <typename Result>
+  StatusOr<Result> Update(StatusOr<Result> result) {
+    if (!result) {
+      Report();
+      return result;
+    }
+    bytes_ += result->bytes_received;
+    if (result->response.status_code != HttpStatusCode::kContinue) Report();
+    return result;
+  }
+
+  void Report() {
+    if (!report_) return;
+    report_(bytes_, std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start_));
+    report_ = nullptr;
+  }
+
+  std::unique_ptr<ObjectReadSource> source_;
+  std::function<void(std::uint64_t, std::chrono::microseconds)> report_;
+  std::chrono::steady_clock::time_point start_;
+  std::uint64_t bytes_ = 0;
+};
+
+}  // namespace
+
+TransportSelector::TransportSelector(bool adaptive,
+                                     std::map<Operation, Transport> pinned)
+    : adaptive_(adaptive), pinned_(std::move(pinned)) {}
+
+std::shared_ptr<TransportSelector> TransportSelector::FromConfig(
+    std::string const& config) {
+  std::map<std::string, Operation> const operations{
+      {"insert", Operation::kInsertObjectMedia},
+      {"read", Operation::kReadObject},
+      {"resumable", Operation::kResumableUpload},
+  };
+  std::map<std::string, Transport> const transports{
+      {"grpc", Transport::kGrpc},
+      {"json", Transport::kJson},
+  };
+  bool adaptive = false;
+  std::map<Operation, Transport> pinned;
+  for (auto const& element : absl::StrSplit(config, ',')) {
+    if (element == "adaptive") {
+      adaptive = true;
+      continue;
+    }
+    std::pair<std::string, std::string> kv =
+        absl::StrSplit(element, absl::MaxSplits('=', 1));
+    auto o = operations.find(kv.first);
+    auto t = transports.find(kv.second);
+    if (o == operations.end() || t == transports.end()) continue;
+    pinned[o->second] = t->second;
+  }
+  return std::make_shared<TransportSelector>(adaptive, std::move(pinned));
+}
+
+TransportSelector::Transport TransportSelector::Pick(
+    Operation operation, absl::optional<std::uint64_t> size) {
+  auto p = pinned_.find(operation);
+  if (p != pinned_.end()) return p->second;
+  // Resumable uploads span many requests, they are not measured.
+  if (!adaptive_ || operation == Operation::kResumableUpload) {
+    return DefaultTransport(operation);
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& stats = stats_[Index(operation, size)];
+  auto const request = stats.requests++;
+  auto const& grpc = stats.transports[static_cast<int>(Transport::kGrpc)];
+  auto const& json = stats.transports[static_cast<int>(Transport::kJson)];
+  if (grpc.samples < kMinSamples || json.samples < kMinSamples) {
+    if (grpc.samples < json.samples) return Transport::kGrpc;
+    if (json.samples < grpc.samples) return Transport::kJson;
+    return request % 2 == 0 ? Transport::kGrpc : Transport::kJson;
+  }
+  auto const best = grpc.bytes * json.seconds >= json.bytes * grpc.seconds
+                        ? Transport::kGrpc
+                        : Transport::kJson;
+  if (request % kExplorationPeriod != kExplorationPeriod - 1) return best;
+  return best == Transport::kGrpc ? Transport::kJson : Transport::kGrpc;
+}
+
+void TransportSelector::Record(Operation operation,
+                               absl::optional<std::uint64_t> size,
+                               Transport transport, std::uint64_t bytes,
+                               std::chrono::microseconds elapsed) {
+  if (!adaptive_) return;
+  using seconds = std::chrono::duration<double>;
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& stats = stats_[Index(operation, size)]
+                    .transports[static_cast<int>(transport)];
+  // Count each request as one extra byte, so empty objects are compared by
+  // their latency.
+  stats.bytes = stats.bytes * kDecay + static_cast<double>(bytes + 1);
+  stats.seconds = stats.seconds * kDecay +
+                  std::chrono::duration_cast<seconds>(elapsed).count();
+  ++stats.samples;
+}
+
+double TransportSelector::Throughput(Operation operation,
+                                     absl::optional<std::uint64_t> size,
+                                     Transport transport) const {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto const& stats = stats_[Index(operation, size)]
+                          .transports[static_cast<int>(transport)];
+  if (stats.samples == 0 || stats.seconds <= 0) return 0;
+  return stats.bytes / stats.seconds;
+}
+
+TransportSelector::Transport TransportSelector::DefaultTransport(
+    Operation operation) {
+  switch (operation) {
+    case Operation::kInsertObjectMedia:
+    case Operation::kReadObject:
+    case Operation::kResumableUpload:
+      return Transport::kGrpc;
+  }
+  return Transport::kGrpc;
+}
+
+std::size_t TransportSelector::Index(Operation operation,
+                                     absl::optional<std::uint64_t> size) {
+  // The first bucket is for requests of unknown size, the others grow by a
+  // factor of 16 starting at 64KiB.
+  std::size_t bucket = 0;
+  if (size.has_value()) {
+    bucket = 1;
+    for (std::uint64_t limit = 64 * 1024;
+         bucket + 1 < kSizeBuckets && *size >= limit; limit *= 16) {
+      ++bucket;
+    }
+  }
+  return static_cast<std::size_t>(operation) * kSizeBuckets + bucket;
+}
+
+std::unique_ptr<ObjectReadSource> MakeMeasuredReadSource(
+    std::unique_ptr<ObjectReadSource> source,
+    std::function<void(std::uint64_t, std::chrono::microseconds)> report) {
+  return absl::make_unique<MeasuredReadSource>(std::move(source),
+                                               std::move(report));
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,132 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_TRANSPORT_SELECTOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_TRANSPORT_SELECTOR_H
+
+#include "google/cloud/storage/internal/object_read_source.h"
+#include "google/cloud/storage/version.h"
+#include "absl/types/optional.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * Selects the transport (gRPC or JSON) for each operation in `HybridClient`.
+ *
+ * By default the operations use the transports statically assigned by
+ * `HybridClient`. Each operation can be pinned to a transport. In adaptive
+ * mode the selector measures the throughput of each transport, per operation
+ * and object size bucket, and routes new requests to the transport that
+ * currently performs better. A small fraction of the requests is sent to the
+ * other transport, to detect changes in performance.
+ *
+ * This class is thread-safe.
+ */
+class TransportSelector {
+ public:
+  enum class Transport { kGrpc, kJson };
+  enum class Operation { kInsertObjectMedia, kReadObject, kResumableUpload };
+
+  /// Create a selector using the `HybridClient` defaults.
+  TransportSelector() : TransportSelector(false, {}) {}
+  TransportSelector(bool adaptive, std::map<Operation, Transport> pinned);
+
+  /**
+   * Create a selector from a configuration string.
+   *
+   * The configuration is a comma-separated list. `adaptive` enables the
+   * adaptive mode, and `<operation>=<transport>` pins an operation, where the
+   * operation is one of `insert`, `read`, or `resumable`, and the transport
+   * is `grpc` or `json`. Other elements are ignored.
+   */
+  static std::shared_ptr<TransportSelector> FromConfig(
+      std::string const& config);
+
+  bool adaptive() const { return adaptive_; }
+
+  /**
+   * Pick the transport for a new @p operation request.
+   *
+   * @param size the number of bytes transferred by the request, if known.
+   */
+  Transport Pick(Operation operation, absl::optional<std::uint64_t> size);
+
+  /**
+   * Record the outcome of a request.
+   *
+   * Failed requests should be recorded with the bytes actually transferred,
+   * typically 0, so a failing transport is not preferred.
+   */
+  void Record(Operation operation, absl::optional<std::uint64_t> size,
+              Transport transport, std::uint64_t bytes,
+              std::chrono::microseconds elapsed);
+
+  /// The estimated throughput in bytes/second, 0 if there are no samples.
+  double Throughput(Operation operation, absl::optional<std::uint64_t> size,
+                    Transport transport) const;
+
+ private:
+  static Transport DefaultTransport(Operation operation);
+  static std::size_t Index(Operation operation,
+                           absl::optional<std::uint64_t> size);
+
+  struct TransportStats {
+    double bytes = 0;
+    double seconds = 0;
+    int samples = 0;
+  };
+  struct BucketStats {
+    std::array<TransportStats, 2> transports;
+    std::uint64_t requests = 0;
+  };
+
+  static std::size_t constexpr kSizeBuckets = 6;
+  static std::size_t constexpr kOperations = 3;
+
+  bool const adaptive_;
+  std::map<Operation, Transport> const pinned_;
+  mutable std::mutex mu_;
+  // GUARDED_BY(mu_)
+  std::array<BucketStats, kSizeBuckets * kOperations> stats_;
+};
+
+/**
+ * Wrap @p source to report the bytes received, and the time to receive them.
+ *
+ * The @p report callback is called once, when the download completes, fails,
+ * or is closed.
+ */
+std::unique_ptr<ObjectReadSource> MakeMeasuredReadSource(
+    std::unique_ptr<ObjectReadSource> source,
+    std::function<void(std::uint64_t, std::chrono::microseconds)> report);
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_TRANSPORT_SELECTOR_H
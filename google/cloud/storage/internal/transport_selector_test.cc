@@ -0,0 +1,207 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/transport_selector.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::canonical_errors::TransientError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::Return;
+using Operation = TransportSelector::Operation;
+using Transport = TransportSelector::Transport;
+
+auto constexpr kSmall = 1024;
+auto constexpr kLarge = 64 * 1024 * 1024;
+
+// Record @p count samples with the given throughput, in bytes per millisecond.
+void RecordSamples(TransportSelector& selector, Operation operation,
+                   std::uint64_t size, Transport transport, int count,
+                   std::uint64_t bytes_per_ms) {
+  for (int i = 0; i != count; ++i) {
+    selector.Record(operation, size, transport, size,
+                    std::chrono::milliseconds(size / bytes_per_ms + 1));
+  }
+}
+
+TEST(TransportSelectorTest, Default) {
+  TransportSelector selector;
+  EXPECT_FALSE(selector.adaptive());
+  for (auto o : {Operation::kInsertObjectMedia, Operation::kReadObject,
+                 Operation::kResumableUpload}) {
+    EXPECT_EQ(Transport::kGrpc, selector.Pick(o, kSmall));
+    EXPECT_EQ(Transport::kGrpc, selector.Pick(o, absl::nullopt));
+  }
+  RecordSamples(selector, Operation::kReadObject, kSmall, Transport::kJson, 10,
+                1000);
+  EXPECT_EQ(0, selector.Throughput(Operation::kReadObject, kSmall,
+                                   Transport::kJson));
+  EXPECT_EQ(Transport::kGrpc, selector.Pick(Operation::kReadObject, kSmall));
+}
+
+TEST(TransportSelectorTest, FromConfig) {
+  auto selector = TransportSelector::FromConfig(
+      "metadata,adaptive,read=json,insert=grpc,unknown=json,resumable=xml");
+  EXPECT_TRUE(selector->adaptive());
+  for (int i = 0; i != 10; ++i) {
+    EXPECT_EQ(Transport::kJson, selector->Pick(Operation::kReadObject, kSmall));
+    EXPECT_EQ(Transport::kGrpc,
+              selector->Pick(Operation::kInsertObjectMedia, kSmall));
+    EXPECT_EQ(Transport::kGrpc,
+              selector->Pick(Operation::kResumableUpload, absl::nullopt));
+  }
+
+  selector = TransportSelector::FromConfig("resumable=json");
+  EXPECT_FALSE(selector->adaptive());
+  EXPECT_EQ(Transport::kJson,
+            selector->Pick(Operation::kResumableUpload, absl::nullopt));
+  EXPECT_EQ(Transport::kGrpc, selector->Pick(Operation::kReadObject, kSmall));
+
+  selector = TransportSelector::FromConfig("");
+  EXPECT_FALSE(selector->adaptive());
+}
+
+TEST(TransportSelectorTest, AdaptiveSamplesBothTransports) {
+  TransportSelector selector(true, {});
+  int grpc = 0;
+  int json = 0;
+  for (int i = 0; i != 6; ++i) {
+    auto const t = selector.Pick(Operation::kInsertObjectMedia, kSmall);
+    (t == Transport::kGrpc ? grpc : json)++;
+    RecordSamples(selector, Operation::kInsertObjectMedia, kSmall, t, 1, 1000);
+  }
+  EXPECT_EQ(3, grpc);
+  EXPECT_EQ(3, json);
+}
+
+TEST(TransportSelectorTest, AdaptivePrefersFaster) {
+  TransportSelector selector(true, {});
+  RecordSamples(selector, Operation::kReadObject, kLarge, Transport::kGrpc, 5,
+                10000);
+  RecordSamples(selector, Operation::kReadObject, kLarge, Transport::kJson, 5,
+                1000);
+  EXPECT_GT(
+      selector.Throughput(Operation::kReadObject, kLarge, Transport::kGrpc),
+      selector.Throughput(Operation::kReadObject, kLarge, Transport::kJson));
+
+  int grpc = 0;
+  int json = 0;
+  for (int i = 0; i != 100; ++i) {
+    auto const t = selector.Pick(Operation::kReadObject, kLarge);
+    (t == Transport::kGrpc ? grpc : json)++;
+  }
+  // Most requests use the faster transport, a few explore the other one.
+  EXPECT_EQ(95, grpc);
+  EXPECT_EQ(5, json);
+}
+
+TEST(TransportSelectorTest, AdaptiveBySize) {
+  TransportSelector selector(true, {});
+  RecordSamples(selector, Operation::kInsertObjectMedia, kSmall,
+                Transport::kGrpc, 5, 1);
+  RecordSamples(selector, Operation::kInsertObjectMedia, kSmall,
+                Transport::kJson, 5, 100);
+  RecordSamples(selector, Operation::kInsertObjectMedia, kLarge,
+                Transport::kGrpc, 5, 10000);
+  RecordSamples(selector, Operation::kInsertObjectMedia, kLarge,
+                Transport::kJson, 5, 1000);
+
+  EXPECT_EQ(Transport::kJson,
+            selector.Pick(Operation::kInsertObjectMedia, kSmall));
+  EXPECT_EQ(Transport::kGrpc,
+            selector.Pick(Operation::kInsertObjectMedia, kLarge));
+  // Other operations, and downloads of unknown size, have separate estimates.
+  EXPECT_EQ(
+      0, selector.Throughput(Operation::kReadObject, kLarge, Transport::kGrpc));
+  EXPECT_EQ(0, selector.Throughput(Operation::kInsertObjectMedia,
+                                   absl::nullopt, Transport::kGrpc));
+}
+
+TEST(TransportSelectorTest, AdaptiveAvoidsFailures) {
+  TransportSelector selector(true, {});
+  for (int i = 0; i != 5; ++i) {
+    selector.Record(Operation::kReadObject, kSmall, Transport::kGrpc, 0,
+                    std::chrono::milliseconds(10));
+  }
+  RecordSamples(selector, Operation::kReadObject, kSmall, Transport::kJson, 5,
+                100);
+  EXPECT_EQ(Transport::kJson, selector.Pick(Operation::kReadObject, kSmall));
+}
+
+TEST(TransportSelectorTest, MeasuredReadSource) {
+  auto mock = absl::make_unique<testing::MockObjectReadSource>();
+  EXPECT_CALL(*mock, Read)
+      .WillOnce(Return(ReadSourceResult{1024, HttpResponse{100, {}, {}}}))
+      .WillOnce(Return(ReadSourceResult{512, HttpResponse{200, {}, {}}}));
+  EXPECT_CALL(*mock, Close).WillOnce(Return(HttpResponse{200, {}, {}}));
+
+  int calls = 0;
+  std::uint64_t bytes = 0;
+  auto source = MakeMeasuredReadSource(
+      std::move(mock),
+      [&](std::uint64_t b, std::chrono::microseconds) {
+        ++calls;
+        bytes = b;
+      });
+  std::vector<char> buffer(2048);
+  ASSERT_STATUS_OK(source->Read(buffer.data(), buffer.size()));
+  EXPECT_EQ(0, calls);
+  ASSERT_STATUS_OK(source->Read(buffer.data(), buffer.size()));
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(1536, bytes);
+  ASSERT_STATUS_OK(source->Close());
+  source.reset();
+  EXPECT_EQ(1, calls);
+}
+
+TEST(TransportSelectorTest, MeasuredReadSourceError) {
+  auto mock = absl::make_unique<testing::MockObjectReadSource>();
+  EXPECT_CALL(*mock, Read)
+      .WillOnce(Return(ReadSourceResult{1024, HttpResponse{100, {}, {}}}))
+      .WillOnce(Return(StatusOr<ReadSourceResult>(TransientError())));
+
+  int calls = 0;
+  std::uint64_t bytes = 0;
+  auto source = MakeMeasuredReadSource(
+      std::move(mock),
+      [&](std::uint64_t b, std::chrono::microseconds) {
+        ++calls;
+        bytes = b;
+      });
+  std::vector<char> buffer(2048);
+  ASSERT_STATUS_OK(source->Read(buffer.data(), buffer.size()));
+  EXPECT_THAT(source->Read(buffer.data(), buffer.size()),
+              StatusIs(TransientError().code()));
+  source.reset();
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(1024, bytes);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -20,6 +20,7 @@
 #include "google/cloud/internal/tuple.h"
 #include "google/cloud/internal/utility.h"
 #include "absl/meta/type_traits.h"
+#include "absl/types/optional.h"
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -167,6 +168,31 @@ struct NotAmong {
                 std::is_same<typename std::decay<T>::type, Types>...>::value>;
 };
 
+/**
+ * Return an empty option if Tuple contains an element of type T, otherwise
+ *     return the value of the first element of type T
+ */
+template <typename T, typename Tuple, typename Enable = void>
+struct ExtractFirstOccurenceOfTypeImpl {
+  absl::optional<T> operator()(Tuple const&) { return absl::optional<T>(); }
+};
+
+template <typename T, typename... Options>
+struct ExtractFirstOccurenceOfTypeImpl<
+    T, std::tuple<Options...>,
+    typename std::enable_if<
+        Among<typename std::decay<Options>::type...>::template TPred<
+            typename std::decay<T>::type>::value>::type> {
+  absl::optional<T> operator()(std::tuple<Options...> const& tuple) {
+    return std::get<0>(StaticTupleFilter<Among<T>::template TPred>(tuple));
+  }
+};
+
+template <typename T, typename Tuple>
+absl::optional<T> ExtractFirstOccurenceOfType(Tuple const& tuple) {
+  return ExtractFirstOccurenceOfTypeImpl<T, Tuple>()(tuple);
+}
+
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
@@ -0,0 +1,52 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_LIST_OBJECTS_OPTIONS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_LIST_OBJECTS_OPTIONS_H
+
+#include "google/cloud/storage/internal/complex_option.h"
+#include "google/cloud/storage/version.h"
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+
+/**
+ * Fetch the next page of results in the background.
+ *
+ * By default `Client::ListObjects()` (and `Client::ListObjectsAndPrefixes()`)
+ * request the next page of results only when the application has consumed all
+ * the results in the current page. With this option the library requests the
+ * next page in a background thread as soon as it receives the current page, so
+ * the application processes each page while the next one is in flight.
+ *
+ * At most one page is prefetched, so the memory usage is at most twice the
+ * memory usage without this option.
+ */
+struct PrefetchNextPage
+    : public internal::ComplexOption<PrefetchNextPage, bool> {
+  using ComplexOption<PrefetchNextPage, bool>::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  PrefetchNextPage() = default;
+  static char const* name() { return "prefetch-next-page"; }
+};
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_LIST_OBJECTS_OPTIONS_H
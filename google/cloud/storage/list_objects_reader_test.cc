@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/storage/list_objects_reader.h"
+#include "google/cloud/storage/client.h"
 #include "google/cloud/storage/internal/object_metadata_parser.h"
 #include "google/cloud/storage/testing/canonical_errors.h"
 #include "google/cloud/storage/testing/mock_client.h"
@@ -33,6 +34,7 @@ using ::google::cloud::storage::testing::canonical_errors::PermanentError;
 using ::testing::_;
 using ::testing::ContainerEq;
 using ::testing::Return;
+using ::testing::ReturnRef;
 
 ObjectMetadata CreateElement(int index) {
   std::string id = "object-" + std::to_string(index);
@@ -159,6 +161,43 @@ TEST(ListObjectsReaderTest, PermanentFailure) {
   EXPECT_THAT(actual, ContainerEq(expected));
 }
 
+TEST(ListObjectsReaderTest, PrefetchNextPage) {
+  std::vector<ObjectMetadata> expected;
+  int const page_count = 3;
+  for (int i = 0; i != 2 * page_count; ++i) {
+    expected.emplace_back(CreateElement(i));
+  }
+
+  auto mock = std::make_shared<MockClient>();
+  auto const options = ClientOptions(oauth2::CreateAnonymousCredentials());
+  EXPECT_CALL(*mock, client_options()).WillRepeatedly(ReturnRef(options));
+  EXPECT_CALL(*mock, ListObjects(_))
+      .Times(page_count)
+      .WillRepeatedly([&](ListObjectsRequest const& r) {
+        EXPECT_TRUE(r.GetOption<PrefetchNextPage>().value_or(false));
+        auto const i = r.page_token().empty()
+                           ? 0
+                           : std::stoi(r.page_token().substr(5)) + 1;
+        ListObjectsResponse response;
+        if (i != page_count - 1) {
+          response.next_page_token = "page-" + std::to_string(i);
+        }
+        response.items.emplace_back(CreateElement(2 * i));
+        response.items.emplace_back(CreateElement(2 * i + 1));
+        return make_status_or(response);
+      });
+  Client client(std::shared_ptr<internal::RawClient>(mock),
+                Client::NoDecorations{});
+
+  std::vector<ObjectMetadata> actual;
+  for (auto&& object :
+       client.ListObjects("test-bucket", PrefetchNextPage(true))) {
+    ASSERT_STATUS_OK(object);
+    actual.emplace_back(std::move(object).value());
+  }
+  EXPECT_THAT(actual, ContainerEq(expected));
+}
+
 }  // namespace
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
@@ -0,0 +1,101 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/metadata_cache_invalidator.h"
+#include "absl/strings/numbers.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+std::string Attribute(std::map<std::string, std::string> const& attributes,
+                      std::string const& name) {
+  auto i = attributes.find(name);
+  if (i == attributes.end()) return {};
+  return i->second;
+}
+
+}  // namespace
+
+bool MetadataCacheInvalidator::OnNotification(
+    std::map<std::string, std::string> const& attributes) {
+  auto const event_type = Attribute(attributes, "eventType");
+  if (event_type != "OBJECT_FINALIZE" && event_type != "OBJECT_DELETE" &&
+      event_type != "OBJECT_METADATA_UPDATE") {
+    return false;
+  }
+  auto const bucket_name = Attribute(attributes, "bucketId");
+  auto const object_name = Attribute(attributes, "objectId");
+  if (bucket_name.empty() || object_name.empty()) return false;
+
+  absl::optional<std::int64_t> generation;
+  std::int64_t g;
+  if (absl::SimpleAtoi(Attribute(attributes, "objectGeneration"), &g)) {
+    generation = g;
+  }
+  // A new version replaces the cached metadata regardless of its generation.
+  if (event_type == "OBJECT_FINALIZE") generation = absl::nullopt;
+  InvalidateObject(bucket_name, object_name, generation);
+  return true;
+}
+
+void MetadataCacheInvalidator::InvalidateObject(
+    std::string const& bucket_name, std::string const& object_name,
+    absl::optional<std::int64_t> generation) {
+  auto const key = internal::MetadataCacheObjectKey(bucket_name, object_name);
+  std::uint64_t evicted = 0;
+  for (auto const& cache : Caches()) {
+    auto cached = cache->Get(key);
+    if (!cached) continue;
+    if (generation.has_value() && cached->generation() > *generation) continue;
+    cache->Erase(key);
+    ++evicted;
+  }
+  std::lock_guard<std::mutex> lk(mu_);
+  eviction_count_ += evicted;
+}
+
+std::uint64_t MetadataCacheInvalidator::eviction_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return eviction_count_;
+}
+
+void MetadataCacheInvalidator::Register(std::weak_ptr<ObjectCache> cache) {
+  std::lock_guard<std::mutex> lk(mu_);
+  caches_.push_back(std::move(cache));
+}
+
+std::vector<std::shared_ptr<MetadataCacheInvalidator::ObjectCache>>
+MetadataCacheInvalidator::Caches() {
+  std::vector<std::shared_ptr<ObjectCache>> result;
+  std::lock_guard<std::mutex> lk(mu_);
+  // Remove the caches of any clients that no longer exist.
+  caches_.erase(std::remove_if(caches_.begin(), caches_.end(),
+                               [&result](std::weak_ptr<ObjectCache> const& w) {
+                                 auto c = w.lock();
+                                 if (!c) return true;
+                                 result.push_back(std::move(c));
+                                 return false;
+                               }),
+                caches_.end());
+  return result;
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
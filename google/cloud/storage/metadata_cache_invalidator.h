@@ -0,0 +1,129 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_METADATA_CACHE_INVALIDATOR_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_METADATA_CACHE_INVALIDATOR_H
+
+#include "google/cloud/storage/internal/expiring_lru_cache.h"
+#include "google/cloud/storage/object_metadata.h"
+#include "google/cloud/storage/version.h"
+#include "absl/types/optional.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * Evicts entries from the metadata cache when objects change.
+ *
+ * The metadata cache (see `ClientOptions::set_metadata_cache_max_entries()`)
+ * only observes changes made through the same client, changes made by other
+ * clients are visible once the cached entry expires. Applications can
+ * configure [Pub/Sub notifications][notifications] for their buckets, and
+ * forward the notifications to this class, to evict stale entries as soon as
+ * the objects change. With this feed in place the cache TTL can be much
+ * longer.
+ *
+ * Configure the invalidator with
+ * `ClientOptions::set_metadata_cache_invalidator()`, and share it with all the
+ * clients that should observe the notifications.
+ * The class is thread-safe.
+ *
+ * The invalidator does not depend on the Pub/Sub library, applications
+ * forward the message attributes from their subscriber.
+ *
+ * @par Example
+ * @code
+ * auto invalidator = std::make_shared<gcs::MetadataCacheInvalidator>();
+ * auto client = gcs::Client(
+ *     gcs::ClientOptions(credentials)
+ *         .set_metadata_cache_max_entries(100000)
+ *         .set_metadata_cache_ttl(std::chrono::hours(1))
+ *         .set_metadata_cache_invalidator(invalidator));
+ * auto session = subscriber.Subscribe(
+ *     [invalidator](pubsub::Message const& m, pubsub::AckHandler h) {
+ *       invalidator->OnNotification(m.attributes());
+ *       std::move(h).ack();
+ *     });
+ * @endcode
+ *
+ * Notifications may be delayed, or delivered out of order, so there is a short
+ * window where the cache can return stale data. Applications that cannot
+ * tolerate this should not use the metadata cache.
+ *
+ * [notifications]: https://cloud.google.com/storage/docs/pubsub-notifications
+ */
+class MetadataCacheInvalidator {
+ public:
+  MetadataCacheInvalidator() = default;
+
+  /**
+   * Evicts the object described by a Pub/Sub notification, if needed.
+   *
+   * @param attributes the attributes of the Pub/Sub message.
+   * @return true if the notification is for an `OBJECT_FINALIZE`,
+   *     `OBJECT_DELETE` or `OBJECT_METADATA_UPDATE` event, other
+   *     notifications are ignored.
+   */
+  bool OnNotification(std::map<std::string, std::string> const& attributes);
+
+  /**
+   * Evicts the cached metadata for an object.
+   *
+   * If @p generation is set, the entry is evicted only if the cached metadata
+   * is for the same or an older generation. Notifications about non-current
+   * versions of an object do not evict the metadata for the live version.
+   */
+  void InvalidateObject(std::string const& bucket_name,
+                        std::string const& object_name,
+                        absl::optional<std::int64_t> generation = {});
+
+  /// The number of entries evicted by this invalidator.
+  std::uint64_t eviction_count() const;
+
+  //@{
+  /// @name Used by the client library to register each metadata cache.
+  using ObjectCache = internal::ExpiringLruCache<ObjectMetadata>;
+  void Register(std::weak_ptr<ObjectCache> cache);
+  //@}
+
+ private:
+  std::vector<std::shared_ptr<ObjectCache>> Caches();
+
+  mutable std::mutex mu_;
+  std::vector<std::weak_ptr<ObjectCache>> caches_;
+  std::uint64_t eviction_count_ = 0;
+};
+
+namespace internal {
+/// The key for an object in the metadata cache.
+inline std::string MetadataCacheObjectKey(std::string const& bucket_name,
+                                          std::string const& object_name) {
+  // Bucket names cannot contain `/`, so this key is unambiguous.
+  return bucket_name + '/' + object_name;
+}
+}  // namespace internal
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_METADATA_CACHE_INVALIDATOR_H
@@ -0,0 +1,121 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/metadata_cache_invalidator.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+using ObjectCache = MetadataCacheInvalidator::ObjectCache;
+
+ObjectMetadata CreateObject(std::string const& name, int generation) {
+  return internal::ObjectMetadataParser::FromString(R"""({
+      "bucket": "test-bucket",
+      "name": ")""" + name + R"""(",
+      "generation": ")""" + std::to_string(generation) + R"""(",
+      "metageneration": "1"
+})""")
+      .value();
+}
+
+std::shared_ptr<ObjectCache> CreateCache() {
+  auto cache = std::make_shared<ObjectCache>(16, std::chrono::hours(1));
+  cache->Put("test-bucket/foo", CreateObject("foo", 2));
+  cache->Put("test-bucket/bar", CreateObject("bar", 2));
+  return cache;
+}
+
+std::map<std::string, std::string> Notification(std::string event_type,
+                                                std::string object_name,
+                                                std::string generation) {
+  return {{"eventType", std::move(event_type)},
+          {"bucketId", "test-bucket"},
+          {"objectId", std::move(object_name)},
+          {"objectGeneration", std::move(generation)},
+          {"payloadFormat", "JSON_API_V1"}};
+}
+
+TEST(MetadataCacheInvalidatorTest, EvictsOnChanges) {
+  MetadataCacheInvalidator tested;
+  auto c1 = CreateCache();
+  auto c2 = CreateCache();
+  tested.Register(c1);
+  tested.Register(c2);
+
+  for (auto const* event :
+       {"OBJECT_FINALIZE", "OBJECT_DELETE", "OBJECT_METADATA_UPDATE"}) {
+    SCOPED_TRACE(event);
+    c1->Put("test-bucket/foo", CreateObject("foo", 2));
+    c2->Put("test-bucket/foo", CreateObject("foo", 2));
+    EXPECT_TRUE(tested.OnNotification(Notification(event, "foo", "2")));
+    EXPECT_FALSE(c1->Get("test-bucket/foo").has_value());
+    EXPECT_FALSE(c2->Get("test-bucket/foo").has_value());
+    EXPECT_TRUE(c1->Get("test-bucket/bar").has_value());
+    EXPECT_TRUE(c2->Get("test-bucket/bar").has_value());
+  }
+  EXPECT_EQ(6, tested.eviction_count());
+}
+
+TEST(MetadataCacheInvalidatorTest, IgnoresOtherNotifications) {
+  MetadataCacheInvalidator tested;
+  auto cache = CreateCache();
+  tested.Register(cache);
+
+  EXPECT_FALSE(
+      tested.OnNotification(Notification("OBJECT_ARCHIVE", "foo", "2")));
+  EXPECT_FALSE(tested.OnNotification({{"eventType", "OBJECT_DELETE"}}));
+  EXPECT_FALSE(tested.OnNotification({}));
+  EXPECT_TRUE(cache->Get("test-bucket/foo").has_value());
+  EXPECT_EQ(0, tested.eviction_count());
+}
+
+TEST(MetadataCacheInvalidatorTest, OlderGenerations) {
+  MetadataCacheInvalidator tested;
+  auto cache = CreateCache();
+  tested.Register(cache);
+
+  // Changes to non-current versions do not affect the cached live version.
+  EXPECT_TRUE(
+      tested.OnNotification(Notification("OBJECT_DELETE", "foo", "1")));
+  EXPECT_TRUE(tested.OnNotification(
+      Notification("OBJECT_METADATA_UPDATE", "foo", "1")));
+  EXPECT_TRUE(cache->Get("test-bucket/foo").has_value());
+
+  // But a new version always replaces the cached entry.
+  EXPECT_TRUE(
+      tested.OnNotification(Notification("OBJECT_FINALIZE", "foo", "1")));
+  EXPECT_FALSE(cache->Get("test-bucket/foo").has_value());
+}
+
+TEST(MetadataCacheInvalidatorTest, ExpiredCaches) {
+  MetadataCacheInvalidator tested;
+  auto cache = CreateCache();
+  tested.Register(cache);
+  tested.Register(CreateCache());
+
+  tested.InvalidateObject("test-bucket", "foo");
+  EXPECT_FALSE(cache->Get("test-bucket/foo").has_value());
+  EXPECT_EQ(1, tested.eviction_count());
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
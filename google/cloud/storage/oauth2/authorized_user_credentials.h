@@ -23,7 +23,6 @@
 #include "google/cloud/storage/version.h"
 #include "google/cloud/status.h"
 #include <iostream>
-#include <mutex>
 
 namespace google {
 namespace cloud {
@@ -95,7 +94,6 @@ class AuthorizedUserCredentials : public Credentials {
   }
 
   StatusOr<std::string> AuthorizationHeader() override {
-    std::unique_lock<std::mutex> lock(mu_);
     return refreshing_creds_.AuthorizationHeader(clock_.now(),
                                                  [this] { return Refresh(); });
   }
@@ -115,7 +113,6 @@ class AuthorizedUserCredentials : public Credentials {
   ClockType clock_;
   typename HttpRequestBuilderType::RequestType request_;
   std::string payload_;
-  mutable std::mutex mu_;
   RefreshingCredentialsWrapper refreshing_creds_;
 };
 
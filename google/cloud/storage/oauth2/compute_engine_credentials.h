@@ -84,7 +84,6 @@ class ComputeEngineCredentials : public Credentials {
       : clock_(), service_account_email_(std::move(service_account_email)) {}
 
   StatusOr<std::string> AuthorizationHeader() override {
-    std::unique_lock<std::mutex> lock(mu_);
     return refreshing_creds_.AuthorizationHeader(clock_.now(),
                                                  [this] { return Refresh(); });
   }
@@ -174,6 +173,9 @@ class ComputeEngineCredentials : public Credentials {
   }
 
   StatusOr<RefreshingCredentialsWrapper::TemporaryToken> Refresh() const {
+    // The refresh may run in a background thread, concurrently with calls to
+    // `AccountEmail()` or `scopes()`.
+    std::unique_lock<std::mutex> lock(mu_);
     auto status = RetrieveServiceAccountInfo();
     if (!status.ok()) {
       return status;
@@ -195,9 +197,9 @@ class ComputeEngineCredentials : public Credentials {
 
   ClockType clock_;
   mutable std::mutex mu_;
-  RefreshingCredentialsWrapper refreshing_creds_;
   mutable std::set<std::string> scopes_;
   mutable std::string service_account_email_;
+  RefreshingCredentialsWrapper refreshing_creds_;
 };
 
 }  // namespace oauth2
@@ -51,12 +51,37 @@ constexpr std::chrono::seconds GoogleOAuthAccessTokenExpirationSlack() {
   return std::chrono::seconds(500);
 }
 
+/**
+ * Returns the slack to consider when refreshing access tokens in the
+ * background.
+ *
+ * Access tokens are refreshed in the background once they are within this
+ * time of their expiration. This must be larger than
+ * `GoogleOAuthAccessTokenExpirationSlack()`, so the refresh (usually)
+ * completes before any caller needs to block.
+ */
+constexpr std::chrono::seconds GoogleOAuthAccessTokenBackgroundRefreshSlack() {
+  return std::chrono::seconds(1000);
+}
+
+/// The minimum time between failed background refresh attempts.
+constexpr std::chrono::seconds
+GoogleOAuthAccessTokenBackgroundRefreshRetryPeriod() {
+  return std::chrono::seconds(10);
+}
+
 /// The endpoint to fetch an OAuth 2.0 access token from.
 inline char const* GoogleOAuthRefreshEndpoint() {
   static constexpr char kEndpoint[] = "https://oauth2.googleapis.com/token";
   return kEndpoint;
 }
 
+/// The audience of self-signed JWTs used to access Cloud Storage.
+inline char const* GoogleStorageSelfSignedJwtAudience() {
+  static constexpr char kAudience[] = "https://storage.googleapis.com/";
+  return kAudience;
+}
+
 /// String representing the "cloud-platform" OAuth 2.0 scope.
 inline char const* GoogleOAuthScopeCloudPlatform() {
   static constexpr char kScope[] =
@@ -17,6 +17,7 @@
 #include "google/cloud/storage/oauth2/authorized_user_credentials.h"
 #include "google/cloud/storage/oauth2/compute_engine_credentials.h"
 #include "google/cloud/storage/oauth2/google_application_default_credentials_file.h"
+#include "google/cloud/storage/oauth2/lazy_credentials.h"
 #include "google/cloud/storage/oauth2/service_account_credentials.h"
 #include "google/cloud/internal/filesystem.h"
 #include "google/cloud/internal/throw_delegate.h"
@@ -176,6 +177,12 @@ StatusOr<std::shared_ptr<Credentials>> GoogleDefaultCredentials(
                  std::string(kAdcLink)));
 }
 
+std::shared_ptr<Credentials> CreateLazyGoogleDefaultCredentials(
+    ChannelOptions const& options) {
+  return std::make_shared<LazyCredentials>(
+      [options] { return GoogleDefaultCredentials(options); });
+}
+
 std::shared_ptr<Credentials> CreateAnonymousCredentials() {
   return std::make_shared<AnonymousCredentials>();
 }
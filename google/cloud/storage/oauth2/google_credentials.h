@@ -44,6 +44,20 @@ namespace oauth2 {
 StatusOr<std::shared_ptr<Credentials>> GoogleDefaultCredentials(
     ChannelOptions const& options = {});
 
+/**
+ * Produces a Credentials type based on the runtime environment, in the
+ * background.
+ *
+ * This returns immediately, and runs the same discovery as
+ * `GoogleDefaultCredentials()` in a separate thread. The first request using
+ * the credentials waits for the discovery to complete, and fails if it fails.
+ * Use this function to avoid blocking the application startup while the
+ * credentials are discovered, for example, to create several clients in
+ * parallel.
+ */
+std::shared_ptr<Credentials> CreateLazyGoogleDefaultCredentials(
+    ChannelOptions const& options = {});
+
 //@{
 /**
  * @name Functions to manually create specific credential types.
@@ -0,0 +1,57 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/oauth2/lazy_credentials.h"
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace oauth2 {
+
+LazyCredentials::LazyCredentials(Factory factory)
+    : impl_(std::async(std::launch::async, std::move(factory)).share()) {}
+
+StatusOr<std::string> LazyCredentials::AuthorizationHeader() {
+  auto const& impl = Get();
+  if (!impl) return impl.status();
+  return (*impl)->AuthorizationHeader();
+}
+
+StatusOr<std::vector<std::uint8_t>> LazyCredentials::SignBlob(
+    SigningAccount const& service_account,
+    std::string const& string_to_sign) const {
+  auto const& impl = Get();
+  if (!impl) return impl.status();
+  return (*impl)->SignBlob(service_account, string_to_sign);
+}
+
+std::string LazyCredentials::AccountEmail() const {
+  auto const& impl = Get();
+  if (!impl) return std::string{};
+  return (*impl)->AccountEmail();
+}
+
+std::string LazyCredentials::KeyId() const {
+  auto const& impl = Get();
+  if (!impl) return std::string{};
+  return (*impl)->KeyId();
+}
+
+}  // namespace oauth2
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,73 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OAUTH2_LAZY_CREDENTIALS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OAUTH2_LAZY_CREDENTIALS_H
+
+#include "google/cloud/storage/oauth2/credentials.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status_or.h"
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace oauth2 {
+
+/**
+ * Creates the underlying credentials in the background.
+ *
+ * Discovering the Application Default %Credentials may read files and probe
+ * the metadata server, which can take several seconds outside Google Cloud.
+ * This wrapper starts that work in a separate thread when it is constructed,
+ * so creating a client does not block. The first call that needs the
+ * credentials waits for the discovery to complete, and any error in the
+ * discovery is returned by that call (and all the following calls).
+ *
+ * The destructor waits for the discovery to complete if it is still running.
+ */
+class LazyCredentials : public Credentials {
+ public:
+  using Factory = std::function<StatusOr<std::shared_ptr<Credentials>>()>;
+
+  explicit LazyCredentials(Factory factory);
+
+  StatusOr<std::string> AuthorizationHeader() override;
+  StatusOr<std::vector<std::uint8_t>> SignBlob(
+      SigningAccount const& service_account,
+      std::string const& string_to_sign) const override;
+  std::string AccountEmail() const override;
+  std::string KeyId() const override;
+
+ private:
+  StatusOr<std::shared_ptr<Credentials>> const& Get() const {
+    return impl_.get();
+  }
+
+  std::shared_future<StatusOr<std::shared_ptr<Credentials>>> impl_;
+};
+
+}  // namespace oauth2
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OAUTH2_LAZY_CREDENTIALS_H
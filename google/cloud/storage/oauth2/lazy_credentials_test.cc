@@ -0,0 +1,90 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/oauth2/lazy_credentials.h"
+#include "google/cloud/storage/oauth2/anonymous_credentials.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace oauth2 {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+
+class FakeCredentials : public Credentials {
+ public:
+  StatusOr<std::string> AuthorizationHeader() override {
+    return std::string("Authorization: Bearer test-token");
+  }
+  std::string AccountEmail() const override { return "test@example.com"; }
+  std::string KeyId() const override { return "test-key-id"; }
+};
+
+/// @test Verify the constructor does not wait for the factory.
+TEST(LazyCredentialsTest, ConstructorDoesNotBlock) {
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  LazyCredentials tested([released] {
+    released.wait();
+    return StatusOr<std::shared_ptr<Credentials>>(
+        std::make_shared<FakeCredentials>());
+  });
+  // If the constructor waited for the factory this would never run.
+  release.set_value();
+  auto header = tested.AuthorizationHeader();
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("Authorization: Bearer test-token", *header);
+  EXPECT_EQ("test@example.com", tested.AccountEmail());
+  EXPECT_EQ("test-key-id", tested.KeyId());
+}
+
+/// @test Verify errors in the factory are returned by each call.
+TEST(LazyCredentialsTest, FactoryError) {
+  LazyCredentials tested([] {
+    return StatusOr<std::shared_ptr<Credentials>>(
+        Status(StatusCode::kUnknown, "no credentials"));
+  });
+  EXPECT_THAT(tested.AuthorizationHeader(), StatusIs(StatusCode::kUnknown));
+  EXPECT_THAT(tested.AuthorizationHeader(), StatusIs(StatusCode::kUnknown));
+  EXPECT_THAT(tested.SignBlob(SigningAccount("test@example.com"), "blob"),
+              StatusIs(StatusCode::kUnknown));
+  EXPECT_EQ("", tested.AccountEmail());
+  EXPECT_EQ("", tested.KeyId());
+}
+
+/// @test Verify the factory runs only once.
+TEST(LazyCredentialsTest, FactoryRunsOnce) {
+  int calls = 0;
+  LazyCredentials tested([&calls] {
+    ++calls;
+    return StatusOr<std::shared_ptr<Credentials>>(
+        std::make_shared<AnonymousCredentials>());
+  });
+  ASSERT_STATUS_OK(tested.AuthorizationHeader());
+  ASSERT_STATUS_OK(tested.AuthorizationHeader());
+  EXPECT_EQ(1, calls);
+}
+
+}  // namespace
+}  // namespace oauth2
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -21,15 +21,42 @@ namespace storage {
 inline namespace STORAGE_CLIENT_NS {
 namespace oauth2 {
 
+RefreshingCredentialsWrapper::~RefreshingCredentialsWrapper() {
+  if (background_.joinable()) background_.join();
+}
+
 bool RefreshingCredentialsWrapper::IsExpired(
     std::chrono::system_clock::time_point now) const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return IsExpiredImpl(now);
+}
+
+bool RefreshingCredentialsWrapper::IsValid(
+    std::chrono::system_clock::time_point now) const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return IsValidImpl(now);
+}
+
+bool RefreshingCredentialsWrapper::IsExpiredImpl(
+    std::chrono::system_clock::time_point now) const {
   return now > (temporary_token_.expiration_time -
                 GoogleOAuthAccessTokenExpirationSlack());
 }
 
-bool RefreshingCredentialsWrapper::IsValid(
+bool RefreshingCredentialsWrapper::IsValidImpl(
+    std::chrono::system_clock::time_point now) const {
+  return !temporary_token_.token.empty() && !IsExpiredImpl(now);
+}
+
+bool RefreshingCredentialsWrapper::NeedsBackgroundRefresh(
     std::chrono::system_clock::time_point now) const {
-  return !temporary_token_.token.empty() && !IsExpired(now);
+  if (refreshing_) return false;
+  if (now <= temporary_token_.expiration_time -
+                 GoogleOAuthAccessTokenBackgroundRefreshSlack()) {
+    return false;
+  }
+  return now >= last_background_refresh_ +
+                    GoogleOAuthAccessTokenBackgroundRefreshRetryPeriod();
 }
 
 }  // namespace oauth2
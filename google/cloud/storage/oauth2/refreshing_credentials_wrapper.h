@@ -19,7 +19,10 @@
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 
 namespace google {
@@ -30,6 +33,18 @@ namespace oauth2 {
 
 /**
  * Wrapper for refreshable parts of a Credentials object.
+ *
+ * The wrapper refreshes the access token in a background thread when it is
+ * close to (but not past) its expiration time, and continues to return the
+ * current token while the refresh is in progress. Only when the token is
+ * expired, or if the background refresh has not succeeded by then, do callers
+ * block waiting for a new token.
+ *
+ * This class is thread-safe. At most one refresh is in progress at any time,
+ * so the refresh functions do not need to guard against concurrent calls.
+ * Objects that contain a `RefreshingCredentialsWrapper` should declare it as
+ * their last data member: its destructor waits for any background refresh,
+ * which may use the other members of the containing object.
  */
 class RefreshingCredentialsWrapper {
  public:
@@ -38,15 +53,34 @@ class RefreshingCredentialsWrapper {
     std::chrono::system_clock::time_point expiration_time;
   };
 
+  RefreshingCredentialsWrapper() = default;
+  ~RefreshingCredentialsWrapper();
+
+  RefreshingCredentialsWrapper(RefreshingCredentialsWrapper const&) = delete;
+  RefreshingCredentialsWrapper& operator=(RefreshingCredentialsWrapper const&) =
+      delete;
+
   template <typename RefreshFunctor>
   StatusOr<std::string> AuthorizationHeader(
       std::chrono::system_clock::time_point now,
       RefreshFunctor refresh_fn) const {
-    if (IsValid(now)) {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (IsValidImpl(now)) {
+      if (NeedsBackgroundRefresh(now)) StartBackgroundRefresh(now, refresh_fn);
       return temporary_token_.token;
     }
 
+    // If a refresh is already in progress wait for it, and use its result if
+    // it is valid.
+    cv_.wait(lk, [this] { return !refreshing_; });
+    if (IsValidImpl(now)) return temporary_token_.token;
+
+    refreshing_ = true;
+    lk.unlock();
     StatusOr<TemporaryToken> new_token = refresh_fn();
+    lk.lock();
+    refreshing_ = false;
+    cv_.notify_all();
     if (new_token) {
       temporary_token_ = *std::move(new_token);
       return temporary_token_.token;
@@ -76,7 +110,35 @@ class RefreshingCredentialsWrapper {
   bool IsValid(std::chrono::system_clock::time_point now) const;
 
  private:
+  bool IsExpiredImpl(std::chrono::system_clock::time_point now) const;
+  bool IsValidImpl(std::chrono::system_clock::time_point now) const;
+  bool NeedsBackgroundRefresh(std::chrono::system_clock::time_point now) const;
+
+  template <typename RefreshFunctor>
+  void StartBackgroundRefresh(std::chrono::system_clock::time_point now,
+                              RefreshFunctor refresh_fn) const {
+    refreshing_ = true;
+    last_background_refresh_ = now;
+    // The previous thread (if any) has finished its work, as `refreshing_` was
+    // false, joining it does not block.
+    if (background_.joinable()) background_.join();
+    background_ = std::thread([this, refresh_fn]() mutable {
+      StatusOr<TemporaryToken> new_token = refresh_fn();
+      std::lock_guard<std::mutex> lk(mu_);
+      refreshing_ = false;
+      // On failure keep the current token, the next call after the retry
+      // period starts a new background refresh.
+      if (new_token) temporary_token_ = *std::move(new_token);
+      cv_.notify_all();
+    });
+  }
+
+  mutable std::mutex mu_;
+  mutable std::condition_variable cv_;
   mutable TemporaryToken temporary_token_;
+  mutable bool refreshing_ = false;
+  mutable std::chrono::system_clock::time_point last_background_refresh_;
+  mutable std::thread background_;
 };
 
 }  // namespace oauth2
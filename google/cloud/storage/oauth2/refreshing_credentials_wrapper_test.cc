@@ -0,0 +1,165 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/oauth2/refreshing_credentials_wrapper.h"
+#include "google/cloud/storage/oauth2/credential_constants.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace oauth2 {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using TemporaryToken = RefreshingCredentialsWrapper::TemporaryToken;
+
+auto constexpr kLifetime = std::chrono::seconds(3600);
+
+TEST(RefreshingCredentialsWrapperTest, RefreshWhenEmpty) {
+  auto const now = std::chrono::system_clock::now();
+  RefreshingCredentialsWrapper tested;
+  int calls = 0;
+  auto refresh = [&]() -> StatusOr<TemporaryToken> {
+    ++calls;
+    return TemporaryToken{"token-" + std::to_string(calls), now + kLifetime};
+  };
+  EXPECT_FALSE(tested.IsValid(now));
+  auto header = tested.AuthorizationHeader(now, refresh);
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("token-1", *header);
+  EXPECT_TRUE(tested.IsValid(now));
+
+  // A valid token is reused.
+  header = tested.AuthorizationHeader(now + std::chrono::seconds(60), refresh);
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("token-1", *header);
+  EXPECT_EQ(1, calls);
+}
+
+TEST(RefreshingCredentialsWrapperTest, RefreshError) {
+  auto const now = std::chrono::system_clock::now();
+  RefreshingCredentialsWrapper tested;
+  auto header = tested.AuthorizationHeader(now, [] {
+    return StatusOr<TemporaryToken>(Status(StatusCode::kUnavailable, "try"));
+  });
+  EXPECT_THAT(header, StatusIs(StatusCode::kUnavailable));
+  EXPECT_FALSE(tested.IsValid(now));
+}
+
+TEST(RefreshingCredentialsWrapperTest, RefreshWhenExpired) {
+  auto const now = std::chrono::system_clock::now();
+  RefreshingCredentialsWrapper tested;
+  auto header = tested.AuthorizationHeader(now, [&] {
+    return StatusOr<TemporaryToken>(TemporaryToken{"token-1", now + kLifetime});
+  });
+  ASSERT_STATUS_OK(header);
+
+  auto const later = now + kLifetime;
+  EXPECT_TRUE(tested.IsExpired(later));
+  header = tested.AuthorizationHeader(later, [&] {
+    return StatusOr<TemporaryToken>(
+        TemporaryToken{"token-2", later + kLifetime});
+  });
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("token-2", *header);
+}
+
+TEST(RefreshingCredentialsWrapperTest, BackgroundRefresh) {
+  auto const now = std::chrono::system_clock::now();
+  RefreshingCredentialsWrapper tested;
+  auto header = tested.AuthorizationHeader(now, [&] {
+    return StatusOr<TemporaryToken>(TemporaryToken{"token-1", now + kLifetime});
+  });
+  ASSERT_STATUS_OK(header);
+
+  // Close to the expiration time the wrapper starts a background refresh and
+  // returns the current token without waiting for it.
+  auto const later = now + kLifetime -
+                     GoogleOAuthAccessTokenBackgroundRefreshSlack() +
+                     std::chrono::seconds(1);
+  ASSERT_FALSE(tested.IsExpired(later));
+  std::promise<void> unblock;
+  std::promise<void> done;
+  header = tested.AuthorizationHeader(later, [&] {
+    unblock.get_future().wait();
+    done.set_value();
+    return StatusOr<TemporaryToken>(
+        TemporaryToken{"token-2", later + kLifetime});
+  });
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("token-1", *header);
+
+  // While the refresh is running other callers use the current token.
+  header = tested.AuthorizationHeader(later, [] {
+    ADD_FAILURE() << "unexpected refresh";
+    return StatusOr<TemporaryToken>(Status(StatusCode::kInternal, "bad"));
+  });
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("token-1", *header);
+
+  unblock.set_value();
+  done.get_future().wait();
+
+  // Once the token expires callers wait for the background refresh, which
+  // may still be updating the token, and never start a new one.
+  auto const expired = now + kLifetime;
+  header = tested.AuthorizationHeader(expired, [] {
+    ADD_FAILURE() << "unexpected refresh";
+    return StatusOr<TemporaryToken>(Status(StatusCode::kInternal, "bad"));
+  });
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("token-2", *header);
+}
+
+TEST(RefreshingCredentialsWrapperTest, BackgroundRefreshFailure) {
+  auto const now = std::chrono::system_clock::now();
+  RefreshingCredentialsWrapper tested;
+  auto header = tested.AuthorizationHeader(now, [&] {
+    return StatusOr<TemporaryToken>(TemporaryToken{"token-1", now + kLifetime});
+  });
+  ASSERT_STATUS_OK(header);
+
+  auto const later = now + kLifetime -
+                     GoogleOAuthAccessTokenBackgroundRefreshSlack() +
+                     std::chrono::seconds(1);
+  std::promise<void> done;
+  header = tested.AuthorizationHeader(later, [&] {
+    done.set_value();
+    return StatusOr<TemporaryToken>(Status(StatusCode::kUnavailable, "try"));
+  });
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("token-1", *header);
+  done.get_future().wait();
+
+  // The failure does not affect the current token, and a new refresh is not
+  // attempted until the retry period expires.
+  header = tested.AuthorizationHeader(later, [] {
+    ADD_FAILURE() << "unexpected refresh";
+    return StatusOr<TemporaryToken>(Status(StatusCode::kInternal, "bad"));
+  });
+  ASSERT_STATUS_OK(header);
+  EXPECT_EQ("token-1", *header);
+}
+
+}  // namespace
+}  // namespace oauth2
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
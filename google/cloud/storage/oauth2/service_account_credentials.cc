@@ -15,6 +15,7 @@
 #include "google/cloud/storage/oauth2/service_account_credentials.h"
 #include "google/cloud/storage/internal/openssl_util.h"
 #include "google/cloud/internal/absl_str_join_quiet.h"
+#include "google/cloud/internal/getenv.h"
 #include <nlohmann/json.hpp>
 #include <openssl/err.h>
 #include <openssl/pem.h>
@@ -49,6 +50,11 @@ StatusOr<std::string> MakeJWTAssertionNoThrow(std::string const& header,
 }  // namespace internal
 
 namespace oauth2 {
+namespace {
+// P12 keyfiles do not include the private key id.
+auto constexpr kP12PrivateKeyId = "--unknown--";
+}  // namespace
+
 StatusOr<ServiceAccountCredentialsInfo> ParseServiceAccountCredentials(
     std::string const& content, std::string const& source,
     std::string const& default_token_uri) {
@@ -94,7 +100,8 @@ StatusOr<ServiceAccountCredentialsInfo> ParseServiceAccountCredentials(
       // the default value.
       credentials.value(token_uri_key, default_token_uri),
       /*scopes*/ {},
-      /*subject*/ {}};
+      /*subject*/ {},
+      /*enable_self_signed_jwt*/ false};
 }
 
 #include "google/cloud/internal/disable_msvc_crt_secure_warnings.inc"
@@ -198,11 +205,12 @@ StatusOr<ServiceAccountCredentialsInfo> ParseServiceAccountP12File(
   std::string private_key(buf_mem->data, buf_mem->length);
 
   return ServiceAccountCredentialsInfo{std::move(service_account_id),
-                                       "--unknown--",
+                                       kP12PrivateKeyId,
                                        std::move(private_key),
                                        default_token_uri,
                                        /*scopes*/ {},
-                                       /*subject*/ {}};
+                                       /*subject*/ {},
+                                       /*enable_self_signed_jwt*/ false};
 }
 #include "google/cloud/internal/diagnostics_pop.inc"
 
@@ -246,6 +254,51 @@ std::pair<std::string, std::string> AssertionComponentsFromInfo(
   return std::make_pair(assertion_header.dump(), assertion_payload.dump());
 }
 
+bool ServiceAccountUseOAuth(ServiceAccountCredentialsInfo const& info) {
+  if (info.private_key_id == kP12PrivateKeyId || info.subject) return true;
+  if (info.enable_self_signed_jwt) return false;
+  return !google::cloud::internal::GetEnv(GoogleSelfSignedJwtEnvVar())
+              .has_value();
+}
+
+std::pair<std::string, std::string> SelfSignedJWTComponentsFromInfo(
+    ServiceAccountCredentialsInfo const& info,
+    std::chrono::system_clock::time_point now) {
+  nlohmann::json header = {{"alg", "RS256"}, {"typ", "JWT"}};
+  if (!info.private_key_id.empty()) header["kid"] = info.private_key_id;
+
+  auto const now_from_epoch =
+      static_cast<std::intmax_t>(std::chrono::system_clock::to_time_t(now));
+  auto const expiration_from_epoch =
+      static_cast<std::intmax_t>(std::chrono::system_clock::to_time_t(
+          now + GoogleOAuthAccessTokenLifetime()));
+  nlohmann::json payload = {{"iss", info.client_email},
+                            {"sub", info.client_email},
+                            {"iat", now_from_epoch},
+                            {"exp", expiration_from_epoch}};
+  // Self-signed JWTs use either an audience or scopes, but not both.
+  if (info.scopes) {
+    payload["scope"] = absl::StrJoin(*info.scopes, " ");
+  } else {
+    payload["aud"] = GoogleStorageSelfSignedJwtAudience();
+  }
+  return std::make_pair(header.dump(), payload.dump());
+}
+
+StatusOr<std::string> MakeSelfSignedJWT(
+    ServiceAccountCredentialsInfo const& info,
+    internal::PemSigner const& signer,
+    std::chrono::system_clock::time_point now) {
+  auto components = SelfSignedJWTComponentsFromInfo(info, now);
+  auto jwt = internal::UrlsafeBase64Encode(components.first) + '.' +
+             internal::UrlsafeBase64Encode(components.second);
+  auto signature = signer.Sign(jwt);
+  if (!signature) return std::move(signature).status();
+  jwt += '.';
+  jwt += internal::UrlsafeBase64Encode(*signature);
+  return jwt;
+}
+
 std::string MakeJWTAssertion(std::string const& header,
                              std::string const& payload,
                              std::string const& pem_contents) {
@@ -28,7 +28,6 @@
 #include <condition_variable>
 #include <ctime>
 #include <iostream>
-#include <mutex>
 #include <set>
 
 namespace google {
@@ -52,8 +51,28 @@ struct ServiceAccountCredentialsInfo {
   absl::optional<std::set<std::string>> scopes;
   // See https://developers.google.com/identity/protocols/OAuth2ServiceAccount.
   absl::optional<std::string> subject;
+  // Use self-signed JWTs instead of exchanging them for access tokens. See
+  // `ServiceAccountUseOAuth()` for the cases where this is not possible.
+  bool enable_self_signed_jwt;
 };
 
+/// The environment variable to use self-signed JWTs with all service accounts.
+inline char const* GoogleSelfSignedJwtEnvVar() {
+  static constexpr char kEnvVarName[] =
+      "GOOGLE_CLOUD_CPP_ENABLE_SELF_SIGNED_JWT";
+  return kEnvVarName;
+}
+
+/**
+ * Returns true if @p info must exchange JWT assertions for OAuth access tokens.
+ *
+ * Self-signed JWTs are only used if they are enabled, via
+ * `ServiceAccountCredentialsInfo::enable_self_signed_jwt` or the
+ * `GoogleSelfSignedJwtEnvVar()` environment variable. Even then, P12 keyfiles
+ * and credentials with a `subject` (domain-wide delegation) require OAuth.
+ */
+bool ServiceAccountUseOAuth(ServiceAccountCredentialsInfo const& info);
+
 /// Parses the contents of a JSON keyfile into a ServiceAccountCredentialsInfo.
 StatusOr<ServiceAccountCredentialsInfo> ParseServiceAccountCredentials(
     std::string const& content, std::string const& source,
@@ -92,6 +111,26 @@ std::pair<std::string, std::string> AssertionComponentsFromInfo(
     ServiceAccountCredentialsInfo const& info,
     std::chrono::system_clock::time_point now);
 
+/**
+ * Splits a ServiceAccountCredentialsInfo into header and payload components
+ * for a self-signed JWT, valid from @p now.
+ *
+ * The JWT is used directly as a bearer token. Its audience is the Cloud
+ * Storage service, unless the credentials have explicit scopes, in which case
+ * it contains the scopes instead.
+ *
+ * @see https://google.aip.dev/auth/4111
+ */
+std::pair<std::string, std::string> SelfSignedJWTComponentsFromInfo(
+    ServiceAccountCredentialsInfo const& info,
+    std::chrono::system_clock::time_point now);
+
+/// Creates a self-signed JWT for @p info, signed using @p signer.
+StatusOr<std::string> MakeSelfSignedJWT(
+    ServiceAccountCredentialsInfo const& info,
+    internal::PemSigner const& signer,
+    std::chrono::system_clock::time_point now);
+
 /**
  * Given a key and a JSON header and payload, creates a JWT assertion string.
  *
@@ -116,6 +155,11 @@ std::string CreateServiceAccountRefreshPayload(
  * usually be created via the convenience methods declared in
  * google_credentials.h.
  *
+ * When self-signed JWTs are enabled (see `ServiceAccountUseOAuth()`) the
+ * credentials sign their own JWTs and use them as bearer tokens. This avoids
+ * the round trip to the Google Authorization Service at startup, and every
+ * time the token expires.
+ *
  * An HTTP Authorization header, with an access token as its value,
  * can be obtained by calling the AuthorizationHeader() method; if the current
  * access token is invalid or nearing expiration, this will class will first
@@ -143,7 +187,11 @@ class ServiceAccountCredentials : public Credentials {
       : ServiceAccountCredentials(std::move(info), {}) {}
   ServiceAccountCredentials(ServiceAccountCredentialsInfo info,
                             ChannelOptions const& options)
-      : info_(std::move(info)), clock_() {
+      : info_(std::move(info)),
+        use_oauth_(ServiceAccountUseOAuth(info_)),
+        signer_(internal::PemSigner::Create(info_.private_key,
+                                            JwtSigningAlgorithms::RS256)),
+        clock_() {
     HttpRequestBuilderType request_builder(
         info_.token_uri,
         storage::internal::GetDefaultCurlHandleFactory(options));
@@ -161,7 +209,6 @@ class ServiceAccountCredentials : public Credentials {
   }
 
   StatusOr<std::string> AuthorizationHeader() override {
-    std::unique_lock<std::mutex> lock(mu_);
     return refreshing_creds_.AuthorizationHeader(clock_.now(),
                                                  [this] { return Refresh(); });
   }
@@ -186,8 +233,8 @@ class ServiceAccountCredentials : public Credentials {
                     "The current_credentials cannot sign blobs for " +
                         signing_account.value());
     }
-    return internal::SignStringWithPem(blob, info_.private_key,
-                                       JwtSigningAlgorithms::RS256);
+    if (!signer_) return signer_.status();
+    return signer_->Sign(blob);
   }
 
   std::string AccountEmail() const override { return info_.client_email; }
@@ -195,6 +242,7 @@ class ServiceAccountCredentials : public Credentials {
 
  private:
   StatusOr<RefreshingCredentialsWrapper::TemporaryToken> Refresh() {
+    if (!use_oauth_) return RefreshSelfSignedJWT();
     auto payload =
         CreateServiceAccountRefreshPayload(info_, grant_type_, clock_.now());
 
@@ -209,12 +257,26 @@ class ServiceAccountCredentials : public Credentials {
     return ParseServiceAccountRefreshResponse(*response, clock_.now());
   }
 
+  StatusOr<RefreshingCredentialsWrapper::TemporaryToken>
+  RefreshSelfSignedJWT() {
+    if (!signer_) return signer_.status();
+    auto const now = clock_.now();
+    auto jwt = MakeSelfSignedJWT(info_, *signer_, now);
+    if (!jwt) return std::move(jwt).status();
+    return RefreshingCredentialsWrapper::TemporaryToken{
+        "Authorization: Bearer " + *std::move(jwt),
+        now + GoogleOAuthAccessTokenLifetime()};
+  }
+
   typename HttpRequestBuilderType::RequestType request_;
   std::string grant_type_;
   ServiceAccountCredentialsInfo info_;
-  mutable std::mutex mu_;
-  RefreshingCredentialsWrapper refreshing_creds_;
+  bool use_oauth_;
+  // Parsing the private key is expensive, parse it once and reuse it to sign
+  // any blobs.
+  StatusOr<internal::PemSigner> signer_;
   ClockType clock_;
+  RefreshingCredentialsWrapper refreshing_creds_;
 };
 
 }  // namespace oauth2
@@ -22,6 +22,7 @@
 #include "google/cloud/internal/random.h"
 #include "google/cloud/internal/setenv.h"
 #include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/scoped_environment.h"
 #include "google/cloud/testing_util/status_matchers.h"
 #include "absl/strings/str_split.h"
 #include <gmock/gmock.h>
@@ -45,6 +46,7 @@ using ::google::cloud::storage::testing::kP12ServiceAccountId;
 using ::google::cloud::storage::testing::MockHttpRequest;
 using ::google::cloud::storage::testing::MockHttpRequestBuilder;
 using ::google::cloud::storage::testing::WriteBase64AsBinary;
+using ::google::cloud::testing_util::ScopedEnvironment;
 using ::google::cloud::testing_util::StatusIs;
 using ::testing::_;
 using ::testing::An;
@@ -695,6 +697,104 @@ TEST_F(ServiceAccountCredentialsTest, AssertionComponentsFromInfo) {
   EXPECT_EQ(info->token_uri, payload.value("aud", ""));
 }
 
+/// @test Verify when the credentials can use self-signed JWTs.
+TEST_F(ServiceAccountCredentialsTest, ServiceAccountUseOAuth) {
+  ScopedEnvironment env(GoogleSelfSignedJwtEnvVar(), absl::nullopt);
+  auto info = ParseServiceAccountCredentials(kJsonKeyfileContents, "test");
+  ASSERT_STATUS_OK(info);
+  EXPECT_TRUE(ServiceAccountUseOAuth(*info));
+
+  info->enable_self_signed_jwt = true;
+  EXPECT_FALSE(ServiceAccountUseOAuth(*info));
+
+  auto with_subject = *info;
+  with_subject.subject = std::string(kSubjectForGrant);
+  EXPECT_TRUE(ServiceAccountUseOAuth(with_subject));
+
+  auto p12 = *info;
+  p12.private_key_id = "--unknown--";
+  EXPECT_TRUE(ServiceAccountUseOAuth(p12));
+
+  info->enable_self_signed_jwt = false;
+  ScopedEnvironment enable(GoogleSelfSignedJwtEnvVar(), "1");
+  EXPECT_FALSE(ServiceAccountUseOAuth(*info));
+}
+
+/// @test Verify the components of a self-signed JWT.
+TEST_F(ServiceAccountCredentialsTest, SelfSignedJWTComponentsFromInfo) {
+  auto info = ParseServiceAccountCredentials(kJsonKeyfileContents, "test");
+  ASSERT_STATUS_OK(info);
+  auto const clock_value = 10000;
+  FakeClock::now_value_ = clock_value;
+  auto components = SelfSignedJWTComponentsFromInfo(*info, FakeClock::now());
+
+  auto header = nlohmann::json::parse(components.first);
+  EXPECT_EQ("RS256", header.value("alg", ""));
+  EXPECT_EQ("JWT", header.value("typ", ""));
+  EXPECT_EQ(info->private_key_id, header.value("kid", ""));
+
+  auto payload = nlohmann::json::parse(components.second);
+  EXPECT_EQ(clock_value, payload.value("iat", 0));
+  EXPECT_EQ(clock_value + 3600, payload.value("exp", 0));
+  EXPECT_EQ(info->client_email, payload.value("iss", ""));
+  EXPECT_EQ(info->client_email, payload.value("sub", ""));
+  EXPECT_EQ(GoogleStorageSelfSignedJwtAudience(), payload.value("aud", ""));
+  EXPECT_EQ(0, payload.count("scope"));
+
+  info->scopes = std::set<std::string>{"scope1", "scope2"};
+  components = SelfSignedJWTComponentsFromInfo(*info, FakeClock::now());
+  payload = nlohmann::json::parse(components.second);
+  EXPECT_EQ("scope1 scope2", payload.value("scope", ""));
+  EXPECT_EQ(0, payload.count("aud"));
+}
+
+/// @test Verify self-signed JWTs are used without contacting the token
+/// endpoint.
+TEST_F(ServiceAccountCredentialsTest, SelfSignedJWT) {
+  auto mock_builder = MockHttpRequestBuilder::mock_;
+  EXPECT_CALL(*mock_builder, AddHeader(_));
+  EXPECT_CALL(*mock_builder, Constructor(GoogleOAuthRefreshEndpoint()));
+  EXPECT_CALL(*mock_builder, MakeEscapedString(An<std::string const&>()))
+      .WillRepeatedly([](std::string const&) -> std::unique_ptr<char[]> {
+        auto t = std::unique_ptr<char[]>(new char[sizeof(kGrantParamEscaped)]);
+        std::copy(kGrantParamEscaped,
+                  kGrantParamEscaped + sizeof(kGrantParamEscaped), t.get());
+        return t;
+      });
+  auto mock_request = std::make_shared<MockHttpRequest::Impl>();
+  EXPECT_CALL(*mock_request, MakeRequest(_)).Times(0);
+  EXPECT_CALL(*mock_builder, BuildRequest()).WillOnce([mock_request] {
+    MockHttpRequest result;
+    result.mock = mock_request;
+    return result;
+  });
+
+  auto info = ParseServiceAccountCredentials(kJsonKeyfileContents, "test");
+  ASSERT_STATUS_OK(info);
+  info->enable_self_signed_jwt = true;
+  auto const clock_value = 10000;
+  FakeClock::now_value_ = clock_value;
+  ServiceAccountCredentials<MockHttpRequestBuilder, FakeClock> credentials(
+      *info);
+
+  auto header = credentials.AuthorizationHeader();
+  ASSERT_STATUS_OK(header);
+  std::string const prefix = "Authorization: Bearer ";
+  ASSERT_THAT(*header, StartsWith(prefix));
+  std::vector<std::string> const tokens =
+      absl::StrSplit(header->substr(prefix.size()), '.');
+  ASSERT_EQ(3, tokens.size());
+  auto payload_bytes = internal::UrlsafeBase64Decode(tokens[1]);
+  auto payload = nlohmann::json::parse(
+      std::string{payload_bytes.begin(), payload_bytes.end()});
+  EXPECT_EQ(clock_value, payload.value("iat", 0));
+  EXPECT_EQ(info->client_email, payload.value("iss", ""));
+
+  // The token is cached until it is about to expire.
+  FakeClock::now_value_ = clock_value + 60;
+  EXPECT_EQ(*header, credentials.AuthorizationHeader().value());
+}
+
 /// @test Verify we can construct a JWT assertion given the info parsed from a
 /// keyfile.
 TEST_F(ServiceAccountCredentialsTest, MakeJWTAssertion) {
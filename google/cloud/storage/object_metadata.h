@@ -31,6 +31,7 @@ inline namespace STORAGE_CLIENT_NS {
 namespace internal {
 struct ObjectMetadataParser;
 class GrpcClient;
+class ListObjectsSaxHandler;
 }  // namespace internal
 
 /// A simple representation for the customerEncryption field.
@@ -251,6 +252,7 @@ class ObjectMetadata : private internal::CommonMetadata<ObjectMetadata> {
  private:
   friend struct internal::ObjectMetadataParser;
   friend class internal::GrpcClient;
+  friend class internal::ListObjectsSaxHandler;
 
   friend std::ostream& operator<<(std::ostream& os, ObjectMetadata const& rhs);
   // Keep the fields in alphabetical order.
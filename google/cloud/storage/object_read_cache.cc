@@ -0,0 +1,215 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/object_read_cache.h"
+#include "google/cloud/storage/internal/sha256_hash.h"
+#include "google/cloud/internal/strerror.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+#endif  // _WIN32
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+class InMemoryObjectReadCache : public ObjectReadCache {
+ public:
+  explicit InMemoryObjectReadCache(std::size_t max_bytes)
+      : max_bytes_(max_bytes) {}
+
+  absl::optional<std::string> Get(std::string const& key) override {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto i = index_.find(key);
+    if (i == index_.end()) return {};
+    entries_.splice(entries_.begin(), entries_, i->second);
+    return i->second->second;
+  }
+
+  void Put(std::string const& key, std::string const& value) override {
+    if (value.size() > max_bytes_) return;
+    std::lock_guard<std::mutex> lk(mu_);
+    auto i = index_.find(key);
+    if (i != index_.end()) {
+      // The blocks are immutable, there is no need to replace the value.
+      entries_.splice(entries_.begin(), entries_, i->second);
+      return;
+    }
+    while (!entries_.empty() && total_bytes_ + value.size() > max_bytes_) {
+      total_bytes_ -= entries_.back().second.size();
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    entries_.emplace_front(key, value);
+    index_.emplace(key, entries_.begin());
+    total_bytes_ += value.size();
+  }
+
+ private:
+  using Entry = std::pair<std::string, std::string>;
+
+  std::size_t const max_bytes_;
+  std::mutex mu_;
+  // The most recently used blocks are at the front of the list.
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  std::size_t total_bytes_ = 0;
+};
+
+#ifndef _WIN32
+class FileObjectReadCache : public ObjectReadCache {
+ public:
+  FileObjectReadCache(std::string directory, std::size_t max_bytes)
+      : directory_(std::move(directory)), max_bytes_(max_bytes) {}
+
+  absl::optional<std::string> Get(std::string const& key) override {
+    auto const path = Path(key);
+    std::ifstream is(path, std::ios::binary);
+    if (!is.is_open()) return {};
+    std::string value{std::istreambuf_iterator<char>(is), {}};
+    if (is.bad()) return {};
+    // Update the modification time, the eviction uses it to find the least
+    // recently used files. This is best effort, errors are ignored.
+    (void)::utime(path.c_str(), nullptr);
+    return value;
+  }
+
+  void Put(std::string const& key, std::string const& value) override {
+    auto const path = Path(key);
+    std::string tmp;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      tmp = path + kTempSuffix + std::to_string(::getpid()) + "." +
+            std::to_string(++temp_counter_);
+    }
+    std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+    os.write(value.data(), static_cast<std::streamsize>(value.size()));
+    os.close();
+    if (!os.good() || std::rename(tmp.c_str(), path.c_str()) != 0) {
+      (void)std::remove(tmp.c_str());
+      return;
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    bytes_since_eviction_ += value.size();
+    // Scanning the directory is expensive, only do it after writing a
+    // significant fraction of the maximum size.
+    if (bytes_since_eviction_ < max_bytes_ / 8) return;
+    bytes_since_eviction_ = 0;
+    Evict();
+  }
+
+ private:
+  static char constexpr kTempSuffix[] = ".tmp.";
+
+  std::string Path(std::string const& key) const {
+    return directory_ + "/" + internal::HexEncode(internal::Sha256Hash(key));
+  }
+
+  void Evict() {
+    struct File {
+      std::string path;
+      std::time_t mtime;
+      std::size_t size;
+    };
+    std::vector<File> files;
+    std::size_t total = 0;
+    auto* dir = ::opendir(directory_.c_str());
+    if (dir == nullptr) return;
+    for (auto* entry = ::readdir(dir); entry != nullptr;
+         entry = ::readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name.find(kTempSuffix) != std::string::npos) continue;
+      auto path = directory_ + "/" + name;
+      struct stat st;
+      if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+      auto const size = static_cast<std::size_t>(st.st_size);
+      files.push_back(File{std::move(path), st.st_mtime, size});
+      total += size;
+    }
+    ::closedir(dir);
+    if (total <= max_bytes_) return;
+    std::sort(files.begin(), files.end(), [](File const& a, File const& b) {
+      return a.mtime < b.mtime;
+    });
+    for (auto const& f : files) {
+      if (total <= max_bytes_) break;
+      if (std::remove(f.path.c_str()) == 0) total -= f.size;
+    }
+  }
+
+  std::string const directory_;
+  std::size_t const max_bytes_;
+  std::mutex mu_;
+  std::uint64_t temp_counter_ = 0;
+  std::size_t bytes_since_eviction_ = 0;
+};
+
+char constexpr FileObjectReadCache::kTempSuffix[];
+#endif  // _WIN32
+
+}  // namespace
+
+std::shared_ptr<ObjectReadCache> MakeInMemoryObjectReadCache(
+    std::size_t max_bytes) {
+  return std::make_shared<InMemoryObjectReadCache>(max_bytes);
+}
+
+#ifndef _WIN32
+StatusOr<std::shared_ptr<ObjectReadCache>> MakeFileObjectReadCache(
+    std::string directory, std::size_t max_bytes) {
+  if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+    auto const errnum = errno;
+    return Status(StatusCode::kUnavailable,
+                  "MakeFileObjectReadCache(" + directory +
+                      "): cannot create directory: " +
+                      google::cloud::internal::strerror(errnum));
+  }
+  struct stat st;
+  if (::stat(directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+    return Status(StatusCode::kInvalidArgument,
+                  "MakeFileObjectReadCache(" + directory +
+                      "): not a directory");
+  }
+  return std::shared_ptr<ObjectReadCache>(
+      std::make_shared<FileObjectReadCache>(std::move(directory), max_bytes));
+}
+#else
+StatusOr<std::shared_ptr<ObjectReadCache>> MakeFileObjectReadCache(
+    std::string, std::size_t) {
+  return Status(StatusCode::kUnimplemented,
+                "MakeFileObjectReadCache() is not supported on Windows");
+}
+#endif  // _WIN32
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,84 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OBJECT_READ_CACHE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OBJECT_READ_CACHE_H
+
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/optional.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * A local cache for the contents of objects.
+ *
+ * Applications that repeatedly download the same objects can configure a
+ * cache, via `ClientOptions::set_object_read_cache()`, and the client serves
+ * `ReadObject()` and `DownloadToFile()` requests from the cache when possible.
+ *
+ * The client splits each object into fixed-size blocks, and stores each block
+ * under a different key. The keys include the object generation, so cached
+ * blocks never become stale: a new version of the object uses different keys.
+ * Downloads of a range, including `ReadRange`, `ReadFromOffset`, and
+ * `ReadLast`, only fetch the blocks missing from the cache.
+ *
+ * Implementations must be thread-safe.
+ */
+class ObjectReadCache {
+ public:
+  virtual ~ObjectReadCache() = default;
+
+  /// Returns the block stored with @p key, if any.
+  virtual absl::optional<std::string> Get(std::string const& key) = 0;
+
+  /// Stores a block, implementations may discard it, for example, if full.
+  virtual void Put(std::string const& key, std::string const& value) = 0;
+};
+
+/**
+ * Creates a cache that keeps the blocks in memory.
+ *
+ * Once the cache contains more than @p max_bytes bytes, the least recently
+ * used blocks are discarded.
+ */
+std::shared_ptr<ObjectReadCache> MakeInMemoryObjectReadCache(
+    std::size_t max_bytes);
+
+/**
+ * Creates a cache that keeps each block as a file in @p directory.
+ *
+ * Several processes on the same host can share the cache by using the same
+ * directory. Each block is written to a temporary file and then renamed, so
+ * readers never observe partially written blocks. Each process limits the
+ * size of the directory to (approximately) @p max_bytes, by removing the
+ * least recently used files.
+ *
+ * Returns an error if the directory does not exist and cannot be created. On
+ * Windows this function returns a `kUnimplemented` error.
+ */
+StatusOr<std::shared_ptr<ObjectReadCache>> MakeFileObjectReadCache(
+    std::string directory, std::size_t max_bytes);
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OBJECT_READ_CACHE_H
@@ -0,0 +1,96 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/object_read_cache.h"
+#include "google/cloud/storage/testing/random_names.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::Eq;
+using ::testing::Optional;
+
+TEST(ObjectReadCacheTest, InMemory) {
+  auto cache = MakeInMemoryObjectReadCache(10);
+  EXPECT_FALSE(cache->Get("a").has_value());
+  cache->Put("a", "1234");
+  cache->Put("b", "5678");
+  EXPECT_THAT(cache->Get("a"), Optional(Eq("1234")));
+  // "b" is the least recently used block, so it is evicted.
+  cache->Put("c", "9012");
+  EXPECT_THAT(cache->Get("a"), Optional(Eq("1234")));
+  EXPECT_FALSE(cache->Get("b").has_value());
+  EXPECT_THAT(cache->Get("c"), Optional(Eq("9012")));
+  // Blocks larger than the cache are discarded.
+  cache->Put("d", "01234567890");
+  EXPECT_FALSE(cache->Get("d").has_value());
+  EXPECT_THAT(cache->Get("a"), Optional(Eq("1234")));
+}
+
+#ifndef _WIN32
+TEST(ObjectReadCacheTest, File) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const directory =
+      ::testing::TempDir() + testing::MakeRandomFileName(generator);
+  auto cache = MakeFileObjectReadCache(directory, 1024 * 1024);
+  ASSERT_STATUS_OK(cache);
+  EXPECT_FALSE((*cache)->Get("a").has_value());
+  (*cache)->Put("a", "1234");
+  (*cache)->Put("b", std::string(1000, 'b'));
+  EXPECT_THAT((*cache)->Get("a"), Optional(Eq("1234")));
+  EXPECT_THAT((*cache)->Get("b"), Optional(Eq(std::string(1000, 'b'))));
+
+  // A second cache in the same directory sees the same blocks.
+  auto other = MakeFileObjectReadCache(directory, 1024 * 1024);
+  ASSERT_STATUS_OK(other);
+  EXPECT_THAT((*other)->Get("a"), Optional(Eq("1234")));
+}
+
+TEST(ObjectReadCacheTest, FileEvicts) {
+  auto generator = google::cloud::internal::DefaultPRNG(std::random_device{}());
+  auto const directory =
+      ::testing::TempDir() + testing::MakeRandomFileName(generator);
+  auto cache = MakeFileObjectReadCache(directory, 2000);
+  ASSERT_STATUS_OK(cache);
+  for (int i = 0; i != 10; ++i) {
+    (*cache)->Put("block-" + std::to_string(i), std::string(500, 'x'));
+  }
+  int found = 0;
+  for (int i = 0; i != 10; ++i) {
+    if ((*cache)->Get("block-" + std::to_string(i)).has_value()) ++found;
+  }
+  // The modification times have coarse resolution, so we cannot predict
+  // which blocks are evicted, only how many.
+  EXPECT_LE(found, 4);
+}
+
+TEST(ObjectReadCacheTest, FileBadDirectory) {
+  auto cache = MakeFileObjectReadCache("/dev/null/not-a-directory", 1024);
+  EXPECT_THAT(cache, StatusIs(StatusCode::kUnavailable));
+}
+#endif  // _WIN32
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
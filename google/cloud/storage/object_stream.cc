@@ -55,6 +55,19 @@ void ObjectReadStream::Close() {
   }
 }
 
+absl::Span<char const> ObjectReadStream::ReadSome() {
+  if (!buf_) {
+    setstate(std::ios_base::badbit | std::ios_base::eofbit);
+    return {};
+  }
+  auto data = buf_->ReadSome();
+  if (data.empty()) {
+    setstate(std::ios_base::eofbit);
+    if (!status().ok()) setstate(std::ios_base::badbit);
+  }
+  return data;
+}
+
 ObjectWriteStream::ObjectWriteStream(
     std::unique_ptr<internal::ObjectWriteStreambuf> buf)
     : std::basic_ostream<char>(nullptr), buf_(std::move(buf)) {
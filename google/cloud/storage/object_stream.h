@@ -18,6 +18,7 @@
 #include "google/cloud/storage/internal/object_streambuf.h"
 #include "google/cloud/storage/object_metadata.h"
 #include "google/cloud/storage/version.h"
+#include "absl/types/span.h"
 #include <ios>
 #include <iostream>
 #include <string>
@@ -103,6 +104,23 @@ class ObjectReadStream : public std::basic_istream<char> {
    */
   void Close();
 
+  /**
+   * Read the next block of data without copying it into an application buffer.
+   *
+   * The returned view points into the buffers owned by this stream, it is only
+   * valid until the next call to `ReadSome()`, any other read function (such as
+   * `read()` or `get()`), or until the stream is closed or destroyed.
+   *
+   * This is useful for applications that process the data in place, e.g. a
+   * parser, as they can avoid copying the data into their own buffers. Mixing
+   * calls to `ReadSome()` and the `std::istream` read functions is supported.
+   *
+   * An empty view indicates that the download has completed or failed, in
+   * either case the stream's `eof()` bit is set. Errors, including checksum
+   * mismatches, are reported via `status()` and the stream's `bad()` bit.
+   */
+  absl::Span<char const> ReadSome();
+
   //@{
   /**
    * Report any download errors.
@@ -80,6 +80,15 @@ TEST(ObjectStream, ReadMoveAssignment) {
   EXPECT_NE(nullptr, copy.rdbuf());
 }
 
+TEST(ObjectStream, ReadSomeError) {
+  ObjectReadStream reader = CreateReader();
+  auto data = reader.ReadSome();
+  EXPECT_TRUE(data.empty());
+  EXPECT_TRUE(reader.bad());
+  EXPECT_TRUE(reader.eof());
+  EXPECT_THAT(reader.status(), StatusIs(StatusCode::kNotFound));
+}
+
 TEST(ObjectStream, WriteMoveConstructor) {
   ObjectWriteStream writer = CreateWriter();
   EXPECT_THAT(writer.metadata(), StatusIs(StatusCode::kNotFound));
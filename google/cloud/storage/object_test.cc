@@ -20,7 +20,9 @@
 #include "google/cloud/storage/testing/mock_client.h"
 #include "google/cloud/storage/testing/retry_tests.h"
 #include "google/cloud/testing_util/assert_ok.h"
+#include "absl/memory/memory.h"
 #include <gmock/gmock.h>
+#include <iterator>
 
 namespace google {
 namespace cloud {
@@ -175,6 +177,48 @@ TEST_F(ObjectTest, GetObjectMetadataPermanentFailure) {
       "GetObjectMetadata");
 }
 
+TEST_F(ObjectTest, ListObjectsCompact) {
+  auto page = [](std::string const& name, std::string token) {
+    internal::ListObjectsCompactResponse response;
+    CompactObjectMetadata object;
+    object.name = name;
+    object.size = 42;
+    response.items.Append(object);
+    response.next_page_token = std::move(token);
+    return response;
+  };
+  EXPECT_CALL(*mock_, ListObjectsCompact(_))
+      .WillOnce(Return(StatusOr<internal::ListObjectsCompactResponse>(
+          TransientError())))
+      .WillOnce([&](internal::ListObjectsRequest const& r) {
+        EXPECT_EQ("test-bucket-name", r.bucket_name());
+        EXPECT_TRUE(r.page_token().empty());
+        EXPECT_THAT(r.GetOption<Fields>().value(), HasSubstr("items(name,"));
+        EXPECT_EQ("dir/", r.GetOption<Prefix>().value());
+        return make_status_or(page("dir/a", "page-1"));
+      })
+      .WillOnce([&](internal::ListObjectsRequest const& r) {
+        EXPECT_EQ("page-1", r.page_token());
+        return make_status_or(page("dir/b", ""));
+      });
+
+  auto list = client_->ListObjectsCompact("test-bucket-name", Prefix("dir/"));
+  ASSERT_STATUS_OK(list);
+  ASSERT_EQ(2U, list->size());
+  EXPECT_EQ("dir/a", std::string((*list)[0].name));
+  EXPECT_EQ("dir/b", std::string((*list)[1].name));
+  EXPECT_EQ(42U, (*list)[1].size);
+}
+
+TEST_F(ObjectTest, ListObjectsCompactPermanentFailure) {
+  testing::PermanentFailureStatusTest<internal::ListObjectsCompactResponse>(
+      *client_, EXPECT_CALL(*mock_, ListObjectsCompact(_)),
+      [](Client& client) {
+        return client.ListObjectsCompact("test-bucket-name").status();
+      },
+      "ListObjectsCompact");
+}
+
 TEST_F(ObjectTest, DeleteObject) {
   EXPECT_CALL(*mock_, DeleteObject(_))
       .WillOnce(Return(StatusOr<internal::EmptyResponse>(TransientError())))
@@ -421,6 +465,51 @@ TEST_F(ObjectTest, ReadObjectPermanentFailure) {
   EXPECT_THAT(status.message(), HasSubstr("ReadObject"));
 }
 
+TEST_F(ObjectTest, ReadObjectThroughCache) {
+  client_options_.set_object_read_cache(MakeInMemoryObjectReadCache(1024));
+  std::string const contents = "The quick brown fox jumps over the lazy dog";
+
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .Times(2)
+      .WillRepeatedly(Return(internal::ObjectMetadataParser::FromJson(
+                                 nlohmann::json{
+                                     {"bucket", "test-bucket-name"},
+                                     {"name", "test-object-name"},
+                                     {"generation", "1"},
+                                     {"size", std::to_string(contents.size())},
+                                 })
+                                 .value()));
+  // Only the first download reaches the service.
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .WillOnce([&contents](internal::ReadObjectRangeRequest const& r) {
+        EXPECT_EQ(1, r.GetOption<Generation>().value_or(0));
+        auto source = absl::make_unique<testing::MockObjectReadSource>();
+        EXPECT_CALL(*source, IsOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*source, Read)
+            .WillOnce([&contents](char* buf, std::size_t n) {
+              EXPECT_LE(contents.size(), n);
+              contents.copy(buf, contents.size());
+              return make_status_or(internal::ReadSourceResult{
+                  contents.size(),
+                  internal::HttpResponse{internal::HttpStatusCode::kOk,
+                                         {},
+                                         {}}});
+            });
+        EXPECT_CALL(*source, Close)
+            .WillRepeatedly(Return(internal::HttpResponse{
+                internal::HttpStatusCode::kOk, {}, {}}));
+        return make_status_or(
+            std::unique_ptr<internal::ObjectReadSource>(std::move(source)));
+      });
+
+  for (int i = 0; i != 2; ++i) {
+    auto stream = client_->ReadObject("test-bucket-name", "test-object-name");
+    std::string actual{std::istreambuf_iterator<char>(stream), {}};
+    EXPECT_STATUS_OK(stream.status());
+    EXPECT_EQ(contents, actual);
+  }
+}
+
 ObjectMetadata CreateObject(int index) {
   std::string id = "object-" + std::to_string(index);
   std::string name = id;
@@ -570,6 +659,70 @@ TEST_F(ObjectTest, DeleteByPrefixDeleteFailure) {
   EXPECT_EQ(StatusCode::kPermissionDenied, status.code());
 }
 
+TEST_F(ObjectTest, DeleteByPrefixBatch) {
+  // Pretend ListObjects returns 150 objects, which requires two batches.
+  auto constexpr kObjectCount = 150;
+  auto mock = std::make_shared<testing::MockClientWithBatch>();
+  auto const mock_options = ClientOptions(oauth2::CreateAnonymousCredentials());
+  EXPECT_CALL(*mock, client_options()).WillRepeatedly(ReturnRef(mock_options));
+  EXPECT_CALL(*mock, ListObjects(_))
+      .WillOnce([&](internal::ListObjectsRequest const&) {
+        internal::ListObjectsResponse response;
+        for (int i = 0; i != kObjectCount; ++i) {
+          response.items.emplace_back(CreateObject(i));
+        }
+        return make_status_or(response);
+      });
+  std::vector<std::string> deleted;
+  auto batch = [&deleted](internal::BatchRequest const& r) {
+    internal::BatchResponse response;
+    for (auto const& op : r.operations()) {
+      auto const& d = absl::get<internal::DeleteObjectRequest>(op);
+      EXPECT_EQ("test-bucket", d.bucket_name());
+      EXPECT_TRUE(d.HasOption<IfGenerationMatch>());
+      deleted.push_back(d.object_name());
+      response.results.emplace_back(
+          make_status_or(internal::EmptyResponse{}));
+    }
+    return make_status_or(std::move(response));
+  };
+  EXPECT_CALL(*mock, ExecuteBatch(_)).WillOnce(batch).WillOnce(batch);
+  EXPECT_CALL(*mock, DeleteObject(_)).Times(0);
+  Client client(mock);
+
+  auto status = DeleteByPrefix(client, "test-bucket", "object-");
+  EXPECT_STATUS_OK(status);
+  ASSERT_EQ(static_cast<std::size_t>(kObjectCount), deleted.size());
+  EXPECT_EQ("object-0", deleted.front());
+  EXPECT_EQ("object-149", deleted.back());
+}
+
+TEST_F(ObjectTest, DeleteByPrefixBatchFailure) {
+  auto mock = std::make_shared<testing::MockClientWithBatch>();
+  auto const mock_options = ClientOptions(oauth2::CreateAnonymousCredentials());
+  EXPECT_CALL(*mock, client_options()).WillRepeatedly(ReturnRef(mock_options));
+  EXPECT_CALL(*mock, ListObjects(_))
+      .WillOnce([](internal::ListObjectsRequest const&) {
+        internal::ListObjectsResponse response;
+        response.items.emplace_back(CreateObject(1));
+        response.items.emplace_back(CreateObject(2));
+        return make_status_or(response);
+      });
+  EXPECT_CALL(*mock, ExecuteBatch(_))
+      .WillOnce([](internal::BatchRequest const&) {
+        internal::BatchResponse response;
+        response.results.emplace_back(
+            make_status_or(internal::EmptyResponse{}));
+        response.results.emplace_back(StatusOr<internal::EmptyResponse>(
+            Status(StatusCode::kPermissionDenied, "uh-oh")));
+        return make_status_or(std::move(response));
+      });
+  Client client(mock);
+
+  auto status = DeleteByPrefix(client, "test-bucket", "object-");
+  EXPECT_EQ(StatusCode::kPermissionDenied, status.code());
+}
+
 TEST_F(ObjectTest, ComposeManyNone) {
   auto mock = std::make_shared<testing::MockClient>();
   auto const mock_options = ClientOptions(oauth2::CreateAnonymousCredentials());
@@ -699,50 +852,34 @@ TEST_F(ObjectTest, ComposeManyThreeLayers) {
   auto const mock_options = ClientOptions(oauth2::CreateAnonymousCredentials());
   EXPECT_CALL(*mock, client_options()).WillRepeatedly(ReturnRef(mock_options));
 
-  // Test 63 sources.
+  // Test 63 sources. The compositions into temporary objects run
+  // concurrently, so their order is not predictable.
 
   EXPECT_CALL(*mock, ComposeObject(_))
-      .WillOnce([](internal::ComposeObjectRequest const& req)
-                    -> StatusOr<ObjectMetadata> {
-        EXPECT_EQ("test-bucket", req.bucket_name());
-        EXPECT_EQ("prefix.compose-tmp-0", req.object_name());
-        auto parsed = nlohmann::json::parse(req.JsonPayload());
-        auto source_objects = parsed["sourceObjects"];
-
-        EXPECT_EQ(32, source_objects.size());
-
-        for (int i = 0; i != 32; ++i) {
-          EXPECT_EQ(std::to_string(i), source_objects[i]["name"]);
-        }
-
-        return MockObject(req.bucket_name(), req.object_name(), 42);
-      })
-      .WillOnce([](internal::ComposeObjectRequest const& req)
-                    -> StatusOr<ObjectMetadata> {
+      .Times(3)
+      .WillRepeatedly([](internal::ComposeObjectRequest const& req)
+                          -> StatusOr<ObjectMetadata> {
         EXPECT_EQ("test-bucket", req.bucket_name());
-        EXPECT_EQ("prefix.compose-tmp-1", req.object_name());
         auto parsed = nlohmann::json::parse(req.JsonPayload());
         auto source_objects = parsed["sourceObjects"];
 
-        EXPECT_EQ(31, source_objects.size());
-
-        for (int i = 0; i != 31; ++i) {
-          EXPECT_EQ(std::to_string(i + 32), source_objects[i]["name"]);
+        if (req.object_name() == "prefix.compose-tmp-0") {
+          EXPECT_EQ(32, source_objects.size());
+          for (int i = 0; i != 32; ++i) {
+            EXPECT_EQ(std::to_string(i), source_objects[i]["name"]);
+          }
+        } else if (req.object_name() == "prefix.compose-tmp-1") {
+          EXPECT_EQ(31, source_objects.size());
+          for (int i = 0; i != 31; ++i) {
+            EXPECT_EQ(std::to_string(i + 32), source_objects[i]["name"]);
+          }
+        } else {
+          EXPECT_EQ("dest", req.object_name());
+          EXPECT_EQ(2, source_objects.size());
+          EXPECT_EQ("prefix.compose-tmp-0", source_objects[0]["name"]);
+          EXPECT_EQ("prefix.compose-tmp-1", source_objects[1]["name"]);
         }
 
-        return MockObject(req.bucket_name(), req.object_name(), 42);
-      })
-      .WillOnce([](internal::ComposeObjectRequest const& req)
-                    -> StatusOr<ObjectMetadata> {
-        EXPECT_EQ("test-bucket", req.bucket_name());
-        EXPECT_EQ("dest", req.object_name());
-        auto parsed = nlohmann::json::parse(req.JsonPayload());
-        auto source_objects = parsed["sourceObjects"];
-
-        EXPECT_EQ(2, source_objects.size());
-        EXPECT_EQ("prefix.compose-tmp-0", source_objects[0]["name"]);
-        EXPECT_EQ("prefix.compose-tmp-1", source_objects[1]["name"]);
-
         return MockObject(req.bucket_name(), req.object_name(), 42);
       });
   EXPECT_CALL(*mock, InsertObjectMedia(_))
@@ -0,0 +1,46 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/operation_deadline.h"
+#include <iostream>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+
+std::ostream& operator<<(std::ostream& os, OperationDeadline const& rhs) {
+  os << rhs.option_name() << "=";
+  if (!rhs.has_value()) return os << "<not set>";
+  return os << internal::TimeRemaining(rhs).count() << "ms from now";
+}
+
+namespace internal {
+
+std::chrono::milliseconds TimeRemaining(OperationDeadline const& deadline) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline.value() - std::chrono::system_clock::now());
+}
+
+bool AttemptFitsDeadline(OperationDeadline const& deadline,
+                         std::chrono::milliseconds delay) {
+  if (!deadline.has_value()) return true;
+  return TimeRemaining(deadline) >= delay + kMinimumAttemptTime;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
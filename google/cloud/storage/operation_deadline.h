@@ -0,0 +1,90 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OPERATION_DEADLINE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OPERATION_DEADLINE_H
+
+#include "google/cloud/storage/internal/complex_option.h"
+#include "google/cloud/storage/version.h"
+#include <chrono>
+#include <iosfwd>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * Bound the total time spent in an operation, including all its retries.
+ *
+ * The retry and backoff policies bound the number of attempts, or the time
+ * spent retrying, but each attempt can take as long as the transport allows.
+ * Applications with latency requirements can set an end-to-end deadline for
+ * the operation with this option. Each attempt is limited to the time left
+ * before the deadline (as a gRPC deadline, or a libcurl timeout), and the
+ * client stops retrying once there is not enough time left for another
+ * attempt, returning a `kDeadlineExceeded` error.
+ *
+ * For downloads the deadline applies to the complete download, including any
+ * attempts to resume an interrupted download.
+ *
+ * @par Example
+ * @code
+ * auto metadata = client.GetObjectMetadata(
+ *     "my-bucket", "my-object",
+ *     gcs::OperationDeadline(std::chrono::system_clock::now() +
+ *                            std::chrono::milliseconds(200)));
+ * @endcode
+ */
+struct OperationDeadline
+    : public internal::ComplexOption<OperationDeadline,
+                                     std::chrono::system_clock::time_point> {
+  using ComplexOption::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  OperationDeadline() = default;
+  static char const* name() { return "operation-deadline"; }
+};
+
+std::ostream& operator<<(std::ostream& os, OperationDeadline const& rhs);
+
+namespace internal {
+
+/**
+ * The minimum time needed for an attempt.
+ *
+ * Starting an attempt with less time left before the deadline is almost
+ * certain to fail, and just wastes resources.
+ */
+auto constexpr kMinimumAttemptTime = std::chrono::milliseconds(10);
+
+/// The time left before @p deadline, negative if the deadline has passed.
+std::chrono::milliseconds TimeRemaining(OperationDeadline const& deadline);
+
+/**
+ * Returns true if an attempt can start after waiting for @p delay.
+ *
+ * This is always true if @p deadline is not set, otherwise there must be at
+ * least `kMinimumAttemptTime` left before the deadline once the delay expires.
+ */
+bool AttemptFitsDeadline(
+    OperationDeadline const& deadline,
+    std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_OPERATION_DEADLINE_H
@@ -0,0 +1,72 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/operation_deadline.h"
+#include <gmock/gmock.h>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::HasSubstr;
+using std::chrono::milliseconds;
+
+TEST(OperationDeadlineTest, NotSet) {
+  OperationDeadline deadline;
+  EXPECT_TRUE(AttemptFitsDeadline(deadline));
+  EXPECT_TRUE(AttemptFitsDeadline(deadline, std::chrono::hours(24)));
+
+  std::ostringstream os;
+  os << deadline;
+  EXPECT_EQ("operation-deadline=<not set>", os.str());
+}
+
+TEST(OperationDeadlineTest, Future) {
+  OperationDeadline deadline(std::chrono::system_clock::now() +
+                             std::chrono::minutes(1));
+  EXPECT_LE(TimeRemaining(deadline), std::chrono::minutes(1));
+  EXPECT_GT(TimeRemaining(deadline), std::chrono::seconds(30));
+  EXPECT_TRUE(AttemptFitsDeadline(deadline));
+  EXPECT_TRUE(AttemptFitsDeadline(deadline, std::chrono::seconds(30)));
+  // The delay and the minimum attempt time must fit.
+  EXPECT_FALSE(AttemptFitsDeadline(deadline, std::chrono::minutes(1)));
+
+  std::ostringstream os;
+  os << deadline;
+  EXPECT_THAT(os.str(), HasSubstr("operation-deadline="));
+  EXPECT_THAT(os.str(), HasSubstr("ms from now"));
+}
+
+TEST(OperationDeadlineTest, Past) {
+  OperationDeadline deadline(std::chrono::system_clock::now() -
+                             std::chrono::seconds(1));
+  EXPECT_LT(TimeRemaining(deadline), milliseconds(0));
+  EXPECT_FALSE(AttemptFitsDeadline(deadline));
+
+  // Less than the minimum attempt time is also too late.
+  OperationDeadline almost(std::chrono::system_clock::now() +
+                           kMinimumAttemptTime / 2);
+  EXPECT_FALSE(AttemptFitsDeadline(almost));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,562 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/parallel_download.h"
+#include "google/cloud/storage/internal/crc32c_combine.h"
+#include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/internal/big_endian.h"
+#include "google/cloud/internal/filesystem.h"
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif  // _WIN32
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using Slice = ParallelDownloadPersistentState::Slice;
+
+/// Called after each chunk of a slice is written to the destination file.
+using SliceProgressCallback = std::function<Status(Slice const&)>;
+
+struct SliceResult {
+  Status status;
+  std::uint32_t crc32c = 0;
+};
+
+SliceResult DownloadSlice(Client client,
+                          ReadObjectRangeRequest const& request,
+                          std::int64_t generation, Slice slice,
+                          std::string const& file_name,
+                          std::size_t buffer_size,
+                          SliceProgressCallback const& on_progress) {
+  SliceResult result;
+  result.crc32c = slice.crc32c;
+  auto const offset = slice.begin + slice.completed;
+  if (offset == slice.end) return result;
+  // Each slice uses its own file handle, so the writes from different threads
+  // do not interfere with each other.
+  std::fstream os(file_name, std::ios::binary | std::ios::in | std::ios::out);
+  if (!os.is_open()) {
+    result.status = Status(StatusCode::kInvalidArgument,
+                           "cannot open download destination file");
+    return result;
+  }
+  os.seekp(offset);
+
+  // Checksums cannot be validated on a partial download, we compute the
+  // checksum for each slice and validate the combined result.
+  auto stream = client.ReadObject(
+      request.bucket_name(), request.object_name(), Generation(generation),
+      ReadRange(offset, slice.end), DisableCrc32cChecksum(true),
+      DisableMD5Hash(true), request.GetOption<EncryptionKey>(),
+      request.GetOption<UserProject>());
+  if (!stream.status().ok()) {
+    result.status = stream.status();
+    return result;
+  }
+
+  std::vector<char> buffer(buffer_size);
+  std::int64_t received = 0;
+  do {
+    stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    auto const n = static_cast<std::size_t>(stream.gcount());
+    result.crc32c = crc32c::Extend(
+        result.crc32c, reinterpret_cast<std::uint8_t const*>(buffer.data()),
+        n);
+    os.write(buffer.data(), static_cast<std::streamsize>(n));
+    received += static_cast<std::int64_t>(n);
+    if (!on_progress || n == 0) continue;
+    // The data must be in the file before the checkpoint says it is.
+    os.flush();
+    if (!os.good()) break;
+    slice.completed += static_cast<std::int64_t>(n);
+    slice.crc32c = result.crc32c;
+    auto status = on_progress(slice);
+    if (!status.ok()) {
+      result.status = std::move(status);
+      return result;
+    }
+  } while (os.good() && stream.good());
+  os.close();
+
+  if (!stream.status().ok()) {
+    result.status = stream.status();
+    return result;
+  }
+  if (!os.good()) {
+    result.status = Status(StatusCode::kUnknown,
+                           "cannot write to download destination file");
+    return result;
+  }
+  if (received != slice.end - offset) {
+    result.status = Status(
+        StatusCode::kDataLoss,
+        "short read in slice [" + std::to_string(slice.begin) + "," +
+            std::to_string(slice.end) + "), got " + std::to_string(received) +
+            " bytes");
+  }
+  return result;
+}
+
+/// Flushes the data written to @p f to stable storage, and closes it.
+bool SyncAndClose(std::FILE* f) {
+  auto ok = std::fflush(f) == 0;
+#ifdef _WIN32
+  ok = ok && _commit(_fileno(f)) == 0;
+#else
+  ok = ok && fsync(fileno(f)) == 0;
+#endif  // _WIN32
+  return std::fclose(f) == 0 && ok;
+}
+
+/// The minimum time between two checkpoint saves triggered by progress.
+auto constexpr kCheckpointSaveInterval = std::chrono::seconds(1);
+
+/**
+ * Saves the state of a resumable download, as the slices make progress.
+ *
+ * Each save flushes the destination file and the checkpoint to stable
+ * storage, which is too expensive to do after every chunk. `Update()` saves
+ * the progress at most once per `kCheckpointSaveInterval`, and `Flush()`
+ * saves any progress not saved yet.
+ */
+class DownloadCheckpoint {
+ public:
+  DownloadCheckpoint(std::string file_name, std::string destination,
+                     ParallelDownloadPersistentState state)
+      : file_name_(std::move(file_name)),
+        destination_(std::move(destination)),
+        state_(std::move(state)) {}
+
+  Status Save() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return SaveLocked();
+  }
+
+  Status Update(std::size_t index, Slice const& slice) {
+    std::lock_guard<std::mutex> lk(mu_);
+    state_.slices[index] = slice;
+    dirty_ = true;
+    auto const elapsed = std::chrono::steady_clock::now() - last_save_;
+    if (elapsed < kCheckpointSaveInterval) return Status();
+    return SaveLocked();
+  }
+
+  Status Flush() {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!dirty_) return Status();
+    return SaveLocked();
+  }
+
+ private:
+  Status SaveLocked() {
+    // The checkpoint must not claim data that a crash could still lose.
+    auto* destination = std::fopen(destination_.c_str(), "r+b");
+    if (destination == nullptr || !SyncAndClose(destination)) {
+      return Status(StatusCode::kUnknown,
+                    "cannot flush download destination file " + destination_);
+    }
+    // Write to a temporary file and rename it, so an interrupted write never
+    // leaves a truncated checkpoint behind.
+    auto const tmp = file_name_ + ".tmp";
+    auto const contents = state_.ToString();
+    auto* os = std::fopen(tmp.c_str(), "wb");
+    if (os == nullptr) {
+      return Status(StatusCode::kUnknown,
+                    "cannot open download checkpoint file " + tmp);
+    }
+    auto const written = std::fwrite(contents.data(), 1, contents.size(), os);
+    if (!SyncAndClose(os) || written != contents.size()) {
+      return Status(StatusCode::kUnknown,
+                    "cannot write download checkpoint file " + tmp);
+    }
+    if (!Rename(tmp)) {
+      return Status(StatusCode::kUnknown,
+                    "cannot rename download checkpoint file " + tmp);
+    }
+    last_save_ = std::chrono::steady_clock::now();
+    dirty_ = false;
+    return Status();
+  }
+
+  bool Rename(std::string const& tmp) {
+    if (std::rename(tmp.c_str(), file_name_.c_str()) == 0) return true;
+    // Some platforms (notably Windows) do not replace existing files.
+    (void)std::remove(file_name_.c_str());
+    return std::rename(tmp.c_str(), file_name_.c_str()) == 0;
+  }
+
+  std::mutex mu_;
+  std::string const file_name_;
+  std::string const destination_;
+  ParallelDownloadPersistentState state_;
+  bool dirty_ = false;
+  std::chrono::steady_clock::time_point last_save_;
+};
+
+Status ReportError(ReadObjectRangeRequest const& request,
+                   std::string const& file_name, char const* what,
+                   Status const& status) {
+  std::ostringstream msg;
+  msg << "ParallelDownloadFile(" << request << ", " << file_name
+      << "): " << what << " - status.message=" << status.message();
+  return Status(status.code(), std::move(msg).str());
+}
+
+Status ValidateRequest(ReadObjectRangeRequest const& request,
+                       std::string const& file_name) {
+  if (request.HasOption<ReadRange>() || request.HasOption<ReadFromOffset>() ||
+      request.HasOption<ReadLast>()) {
+    return ReportError(
+        request, file_name, "invalid options",
+        Status(StatusCode::kInvalidArgument,
+               "ReadRange, ReadFromOffset, and ReadLast are not supported"));
+  }
+  return Status();
+}
+
+StatusOr<ObjectMetadata> GetSourceMetadata(
+    Client& client, ReadObjectRangeRequest const& request,
+    std::string const& file_name, Generation generation) {
+  auto metadata = client.GetObjectMetadata(
+      request.bucket_name(), request.object_name(), std::move(generation),
+      request.GetOption<IfGenerationMatch>(),
+      request.GetOption<IfGenerationNotMatch>(),
+      request.GetOption<IfMetagenerationMatch>(),
+      request.GetOption<IfMetagenerationNotMatch>(),
+      request.GetOption<UserProject>());
+  if (!metadata) {
+    return ReportError(request, file_name,
+                       "cannot get download source object metadata",
+                       metadata.status());
+  }
+  return metadata;
+}
+
+// Create (or truncate) the destination file, and set its final size, so the
+// slices can be written in any order.
+Status CreateDestination(ReadObjectRangeRequest const& request,
+                         std::string const& file_name,
+                         std::int64_t object_size) {
+  std::ofstream os(file_name, std::ios::binary | std::ios::trunc);
+  if (!os.is_open()) {
+    return ReportError(
+        request, file_name, "cannot open download destination file",
+        Status(StatusCode::kInvalidArgument, "ofstream::open()"));
+  }
+  if (object_size != 0) {
+    os.seekp(object_size - 1);
+    os.put('\0');
+  }
+  os.close();
+  if (!os.good()) {
+    return ReportError(request, file_name,
+                       "cannot allocate download destination file",
+                       Status(StatusCode::kUnknown, "ofstream::close()"));
+  }
+  return Status();
+}
+
+std::vector<Slice> InitialSlices(
+    std::int64_t object_size, absl::optional<MaxStreams> const& max_streams,
+    absl::optional<MinStreamSize> const& min_size) {
+  std::vector<Slice> slices;
+  for (auto const& s :
+       ComputeParallelDownloadSlices(object_size, max_streams, min_size)) {
+    slices.push_back(Slice{s.begin, s.end, 0, 0});
+  }
+  return slices;
+}
+
+/// Download all the slices and return the CRC32C checksum of the object.
+StatusOr<std::uint32_t> DownloadSlices(Client& client,
+                                       ReadObjectRangeRequest const& request,
+                                       std::int64_t generation,
+                                       std::string const& file_name,
+                                       std::vector<Slice> const& slices,
+                                       DownloadCheckpoint* checkpoint) {
+  auto const buffer_size =
+      client.raw_client()->client_options().download_buffer_size();
+  std::vector<SliceResult> results(slices.size());
+  std::vector<std::thread> threads;
+  threads.reserve(slices.size());
+  for (std::size_t i = 0; i != slices.size(); ++i) {
+    SliceProgressCallback on_progress;
+    if (checkpoint != nullptr) {
+      on_progress = [checkpoint, i](Slice const& s) {
+        return checkpoint->Update(i, s);
+      };
+    }
+    threads.emplace_back([&, i, on_progress] {
+      results[i] = DownloadSlice(client, request, generation, slices[i],
+                                 file_name, buffer_size, on_progress);
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  std::uint32_t crc = 0;
+  for (std::size_t i = 0; i != slices.size(); ++i) {
+    auto const& r = results[i];
+    if (!r.status.ok()) {
+      return ReportError(request, file_name, "error downloading slice",
+                         r.status);
+    }
+    crc = Crc32cCombine(crc, r.crc32c,
+                        static_cast<std::uint64_t>(slices[i].end -
+                                                   slices[i].begin));
+  }
+  return crc;
+}
+
+Status VerifyChecksum(ReadObjectRangeRequest const& request,
+                      std::string const& file_name,
+                      ObjectMetadata const& metadata, std::uint32_t crc) {
+  if (request.GetOption<DisableCrc32cChecksum>().value_or(false) ||
+      metadata.crc32c().empty()) {
+    return Status();
+  }
+  auto computed =
+      Base64Encode(google::cloud::internal::EncodeBigEndian(crc));
+  if (computed != metadata.crc32c()) {
+    return ReportError(
+        request, file_name, "mismatched checksums in download",
+        Status(StatusCode::kDataLoss,
+               "computed=" + computed + " received=" + metadata.crc32c()));
+  }
+  return Status();
+}
+
+/// Load a checkpoint, returns `absl::nullopt` if it cannot be used.
+absl::optional<ParallelDownloadPersistentState> LoadCheckpoint(
+    ReadObjectRangeRequest const& request, std::string const& file_name,
+    std::string const& checkpoint_name) {
+  std::ifstream is(checkpoint_name, std::ios::binary);
+  if (!is.is_open()) return absl::nullopt;
+  std::string contents{std::istreambuf_iterator<char>{is}, {}};
+  auto state = ParallelDownloadPersistentState::FromString(contents);
+  if (!state) return absl::nullopt;
+  if (state->bucket_name != request.bucket_name() ||
+      state->object_name != request.object_name()) {
+    return absl::nullopt;
+  }
+  auto const generation = request.GetOption<Generation>();
+  if (generation.has_value() && generation.value() != state->generation) {
+    return absl::nullopt;
+  }
+  std::error_code ec;
+  auto const size = google::cloud::internal::file_size(file_name, ec);
+  if (ec || size != static_cast<std::uintmax_t>(state->object_size)) {
+    return absl::nullopt;
+  }
+  // The slices must cover the object, and their progress must be valid.
+  std::int64_t offset = 0;
+  for (auto const& s : state->slices) {
+    if (s.begin != offset || s.end < s.begin || s.completed < 0 ||
+        s.completed > s.end - s.begin) {
+      return absl::nullopt;
+    }
+    offset = s.end;
+  }
+  if (offset != state->object_size) return absl::nullopt;
+  return *std::move(state);
+}
+
+}  // namespace
+
+std::string ParallelDownloadPersistentState::ToString() const {
+  auto json_slices = nlohmann::json::array();
+  for (auto const& s : slices) {
+    json_slices.emplace_back(nlohmann::json{{"begin", s.begin},
+                                            {"end", s.end},
+                                            {"completed", s.completed},
+                                            {"crc32c", s.crc32c}});
+  }
+  return nlohmann::json{{"bucket", bucket_name},
+                        {"object", object_name},
+                        {"generation", generation},
+                        {"size", object_size},
+                        {"slices", json_slices}}
+      .dump();
+}
+
+StatusOr<ParallelDownloadPersistentState>
+ParallelDownloadPersistentState::FromString(std::string const& json_rep) {
+  auto json = nlohmann::json::parse(json_rep, nullptr, false);
+  if (json.is_discarded() || !json.is_object()) {
+    return Status(StatusCode::kInternal,
+                  "Parallel download state is not a valid JSON object.");
+  }
+  auto invalid = [](char const* field) {
+    return Status(StatusCode::kInternal,
+                  std::string("Parallel download state has a missing or "
+                              "invalid '") +
+                      field + "'.");
+  };
+  ParallelDownloadPersistentState res;
+  if (json.count("bucket") != 1 || !json["bucket"].is_string()) {
+    return invalid("bucket");
+  }
+  res.bucket_name = json["bucket"].get<std::string>();
+  if (json.count("object") != 1 || !json["object"].is_string()) {
+    return invalid("object");
+  }
+  res.object_name = json["object"].get<std::string>();
+  if (json.count("generation") != 1 ||
+      !json["generation"].is_number_integer()) {
+    return invalid("generation");
+  }
+  res.generation = json["generation"].get<std::int64_t>();
+  if (json.count("size") != 1 || !json["size"].is_number_integer()) {
+    return invalid("size");
+  }
+  res.object_size = json["size"].get<std::int64_t>();
+  if (json.count("slices") != 1 || !json["slices"].is_array()) {
+    return invalid("slices");
+  }
+  for (auto const& s : json["slices"]) {
+    if (!s.is_object()) return invalid("slices");
+    for (char const* field : {"begin", "end", "completed", "crc32c"}) {
+      if (s.count(field) != 1 || !s[field].is_number_integer()) {
+        return invalid(field);
+      }
+    }
+    res.slices.push_back(Slice{s["begin"].get<std::int64_t>(),
+                               s["end"].get<std::int64_t>(),
+                               s["completed"].get<std::int64_t>(),
+                               s["crc32c"].get<std::uint32_t>()});
+  }
+  return res;
+}
+
+std::string ParallelDownloadCheckpointFileName(std::string const& file_name) {
+  return file_name + ".download-checkpoint";
+}
+
+std::vector<ParallelDownloadSlice> ComputeParallelDownloadSlices(
+    std::int64_t object_size, absl::optional<MaxStreams> const& max_streams,
+    absl::optional<MinStreamSize> const& min_stream_size) {
+  std::vector<std::uintmax_t> split_points;
+  auto const size = static_cast<std::uintmax_t>(object_size);
+  if (max_streams && min_stream_size) {
+    split_points = ComputeParallelFileUploadSplitPoints(
+        size, std::make_tuple(*max_streams, *min_stream_size));
+  } else if (max_streams) {
+    split_points = ComputeParallelFileUploadSplitPoints(
+        size, std::make_tuple(*max_streams));
+  } else if (min_stream_size) {
+    split_points = ComputeParallelFileUploadSplitPoints(
+        size, std::make_tuple(*min_stream_size));
+  } else {
+    split_points = ComputeParallelFileUploadSplitPoints(size, std::tuple<>{});
+  }
+  split_points.push_back(size);
+
+  std::vector<ParallelDownloadSlice> slices;
+  std::int64_t offset = 0;
+  for (auto end : split_points) {
+    slices.push_back({offset, static_cast<std::int64_t>(end)});
+    offset = static_cast<std::int64_t>(end);
+  }
+  return slices;
+}
+
+Status ParallelDownloadFileImpl(
+    Client client, ReadObjectRangeRequest const& request,
+    std::string const& file_name, absl::optional<MaxStreams> max_streams,
+    absl::optional<MinStreamSize> min_stream_size) {
+  auto status = ValidateRequest(request, file_name);
+  if (!status.ok()) return status;
+
+  // Pin the generation, so all the slices read the same data.
+  auto metadata = GetSourceMetadata(client, request, file_name,
+                                    request.GetOption<Generation>());
+  if (!metadata) return std::move(metadata).status();
+  auto const object_size = static_cast<std::int64_t>(metadata->size());
+
+  status = CreateDestination(request, file_name, object_size);
+  if (!status.ok()) return status;
+
+  auto crc = DownloadSlices(
+      client, request, metadata->generation(), file_name,
+      InitialSlices(object_size, max_streams, min_stream_size), nullptr);
+  if (!crc) return std::move(crc).status();
+  return VerifyChecksum(request, file_name, *metadata, *crc);
+}
+
+Status ResumableParallelDownloadFileImpl(
+    Client client, ReadObjectRangeRequest const& request,
+    std::string const& file_name, absl::optional<MaxStreams> max_streams,
+    absl::optional<MinStreamSize> min_stream_size) {
+  auto status = ValidateRequest(request, file_name);
+  if (!status.ok()) return status;
+
+  auto const checkpoint_name = ParallelDownloadCheckpointFileName(file_name);
+  auto state = LoadCheckpoint(request, file_name, checkpoint_name);
+  // When resuming, the generation recorded in the checkpoint is used, even if
+  // the object has been overwritten, because the data already downloaded
+  // belongs to that generation.
+  auto metadata = GetSourceMetadata(
+      client, request, file_name,
+      state ? Generation(state->generation) : request.GetOption<Generation>());
+  if (!metadata) return std::move(metadata).status();
+
+  if (!state) {
+    auto const object_size = static_cast<std::int64_t>(metadata->size());
+    status = CreateDestination(request, file_name, object_size);
+    if (!status.ok()) return status;
+    state = ParallelDownloadPersistentState{
+        request.bucket_name(), request.object_name(), metadata->generation(),
+        object_size, InitialSlices(object_size, max_streams, min_stream_size)};
+  }
+
+  DownloadCheckpoint checkpoint(checkpoint_name, file_name, *state);
+  status = checkpoint.Save();
+  if (!status.ok()) {
+    return ReportError(request, file_name, "cannot save checkpoint", status);
+  }
+  auto crc = DownloadSlices(client, request, metadata->generation(),
+                            file_name, state->slices, &checkpoint);
+  if (!crc) {
+    // Save the progress made since the last checkpoint, so resuming the
+    // download does not need to fetch that data again.
+    (void)checkpoint.Flush();
+    return std::move(crc).status();
+  }
+  // The download is complete, resuming it again would not change the result,
+  // even if the checksums do not match.
+  (void)std::remove(checkpoint_name.c_str());
+  return VerifyChecksum(request, file_name, *metadata, *crc);
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
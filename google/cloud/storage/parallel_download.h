@@ -0,0 +1,240 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_PARALLEL_DOWNLOAD_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_PARALLEL_DOWNLOAD_H
+
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/internal/tuple_filter.h"
+#include "google/cloud/storage/parallel_upload.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/internal/tuple.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/optional.h"
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/// A slice of a parallel download, the range is right-open: `[begin, end)`.
+struct ParallelDownloadSlice {
+  std::int64_t begin;
+  std::int64_t end;
+};
+
+/**
+ * Split an object of size @p object_size into slices for a parallel download.
+ *
+ * The slices are computed using the same algorithm (and defaults) as
+ * `ParallelUploadFile()`.
+ */
+std::vector<ParallelDownloadSlice> ComputeParallelDownloadSlices(
+    std::int64_t object_size, absl::optional<MaxStreams> const& max_streams,
+    absl::optional<MinStreamSize> const& min_stream_size);
+
+/**
+ * The progress of a resumable parallel download.
+ *
+ * This is saved (as JSON) in a checkpoint file next to the destination file.
+ * Each slice records how many bytes have been written to the destination file,
+ * and the CRC32C checksum of those bytes, so the download can continue from
+ * that point.
+ */
+struct ParallelDownloadPersistentState {
+  struct Slice {
+    std::int64_t begin;
+    std::int64_t end;
+    /// The number of bytes, starting at `begin`, already written to the file.
+    std::int64_t completed;
+    /// The CRC32C checksum of the bytes in `[begin, begin + completed)`.
+    std::uint32_t crc32c;
+  };
+
+  std::string ToString() const;
+  static StatusOr<ParallelDownloadPersistentState> FromString(
+      std::string const& json_rep);
+
+  std::string bucket_name;
+  std::string object_name;
+  std::int64_t generation;
+  std::int64_t object_size;
+  std::vector<Slice> slices;
+};
+
+/// The name of the checkpoint file used by `ResumableParallelDownloadFile()`.
+std::string ParallelDownloadCheckpointFileName(std::string const& file_name);
+
+/// Implement `ParallelDownloadFile()` once the options are applied.
+Status ParallelDownloadFileImpl(
+    Client client, ReadObjectRangeRequest const& request,
+    std::string const& file_name, absl::optional<MaxStreams> max_streams,
+    absl::optional<MinStreamSize> min_stream_size);
+
+/// Implement `ResumableParallelDownloadFile()` once the options are applied.
+Status ResumableParallelDownloadFileImpl(
+    Client client, ReadObjectRangeRequest const& request,
+    std::string const& file_name, absl::optional<MaxStreams> max_streams,
+    absl::optional<MinStreamSize> min_stream_size);
+
+/**
+ * Helper functor to set the options in a `ReadObjectRangeRequest` via `apply`.
+ */
+struct ReadObjectRangeRequestSetOptions {
+  template <typename... Options>
+  void operator()(Options&&... options) const {
+    request.set_multiple_options(std::forward<Options>(options)...);
+  }
+
+  ReadObjectRangeRequest& request;
+};
+
+}  // namespace internal
+
+/**
+ * Download a Cloud Storage object to a file using multiple parallel streams.
+ *
+ * The object is split into byte ranges ("slices"), each slice is downloaded
+ * using a separate `ReadObject()` stream, on a separate thread, and written
+ * directly into its position in the destination file. Because the streams do
+ * not share any state they can saturate multiple connections from the
+ * client's connection pool, which is significantly faster than
+ * `Client::DownloadToFile()` for large objects.
+ *
+ * All the slices read the same object generation, even if the object is
+ * overwritten while the download is in progress. Once all the slices are
+ * downloaded their CRC32C checksums are combined and compared against the
+ * checksum in the object metadata.
+ *
+ * You can affect how many slices will be created by using the `MaxStreams` and
+ * `MinStreamSize` options.
+ *
+ * @param client the client on which to perform the operation.
+ * @param bucket_name the name of the bucket that contains the object.
+ * @param object_name the name of the object to be downloaded.
+ * @param file_name the name of the destination file that will have the object
+ *   media. The file is truncated if it exists.
+ * @param options a list of optional query parameters and/or request headers.
+ *   Valid types for this operation include `DisableCrc32cChecksum`,
+ *   `EncryptionKey`, `Generation`, `IfGenerationMatch`,
+ *   `IfGenerationNotMatch`, `IfMetagenerationMatch`,
+ *   `IfMetagenerationNotMatch`, `MaxStreams`, `MinStreamSize`, and
+ *   `UserProject`.
+ *
+ * @return the status of the download, a `kDataLoss` error indicates that the
+ *   checksum of the downloaded data does not match the object checksum.
+ *
+ * @par Idempotency
+ * This is a read-only operation and is always idempotent.
+ *
+ * @par Example
+ * @snippet storage_object_file_transfer_samples.cc parallel download file
+ */
+template <typename... Options>
+Status ParallelDownloadFile(Client client, std::string const& bucket_name,
+                            std::string const& object_name,
+                            std::string const& file_name,
+                            Options&&... options) {
+  auto const max_streams =
+      internal::ExtractFirstOccurenceOfType<MaxStreams>(std::tie(options...));
+  auto const min_stream_size =
+      internal::ExtractFirstOccurenceOfType<MinStreamSize>(
+          std::tie(options...));
+  internal::ReadObjectRangeRequest request(bucket_name, object_name);
+  google::cloud::internal::apply(
+      internal::ReadObjectRangeRequestSetOptions{request},
+      internal::StaticTupleFilter<
+          internal::NotAmong<MaxStreams, MinStreamSize>::TPred>(
+          std::tie(options...)));
+  return internal::ParallelDownloadFileImpl(std::move(client), request,
+                                            file_name, max_streams,
+                                            min_stream_size);
+}
+
+/**
+ * Download a Cloud Storage object to a file, resuming any previous download.
+ *
+ * This function works like `ParallelDownloadFile()`, but it periodically saves
+ * the progress of each slice to a checkpoint file. The checkpoint file is
+ * located next to the destination file, and it is named
+ * `file_name + ".download-checkpoint"`. If the application (or the download)
+ * is interrupted, calling this function again with the same arguments
+ * continues the download from the last checkpoint, instead of downloading the
+ * object from the beginning. The checkpoint file is removed once the download
+ * completes successfully.
+ *
+ * The checkpoint records the object generation. When resuming, the download
+ * always reads that generation, even if the object has been overwritten since
+ * the download started. If that generation is no longer available the
+ * function returns an error, you need to remove the checkpoint file to
+ * download the new generation. The checkpoint is ignored (and the download
+ * starts from the beginning) if it refers to a different object, if the
+ * destination file does not have the expected size, or if the checkpoint
+ * cannot be parsed.
+ *
+ * @param client the client on which to perform the operation.
+ * @param bucket_name the name of the bucket that contains the object.
+ * @param object_name the name of the object to be downloaded.
+ * @param file_name the name of the destination file that will have the object
+ *   media.
+ * @param options a list of optional query parameters and/or request headers.
+ *   Valid types for this operation include `DisableCrc32cChecksum`,
+ *   `EncryptionKey`, `Generation`, `IfGenerationMatch`,
+ *   `IfGenerationNotMatch`, `IfMetagenerationMatch`,
+ *   `IfMetagenerationNotMatch`, `MaxStreams`, `MinStreamSize`, and
+ *   `UserProject`.
+ *
+ * @return the status of the download, a `kDataLoss` error indicates that the
+ *   checksum of the downloaded data does not match the object checksum.
+ *
+ * @par Idempotency
+ * This is a read-only operation and is always idempotent.
+ *
+ * @par Example
+ * @snippet storage_object_file_transfer_samples.cc resumable parallel download
+ */
+template <typename... Options>
+Status ResumableParallelDownloadFile(Client client,
+                                     std::string const& bucket_name,
+                                     std::string const& object_name,
+                                     std::string const& file_name,
+                                     Options&&... options) {
+  auto const max_streams =
+      internal::ExtractFirstOccurenceOfType<MaxStreams>(std::tie(options...));
+  auto const min_stream_size =
+      internal::ExtractFirstOccurenceOfType<MinStreamSize>(
+          std::tie(options...));
+  internal::ReadObjectRangeRequest request(bucket_name, object_name);
+  google::cloud::internal::apply(
+      internal::ReadObjectRangeRequestSetOptions{request},
+      internal::StaticTupleFilter<
+          internal::NotAmong<MaxStreams, MinStreamSize>::TPred>(
+          std::tie(options...)));
+  return internal::ResumableParallelDownloadFileImpl(
+      std::move(client), request, file_name, max_streams, min_stream_size);
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_PARALLEL_DOWNLOAD_H
@@ -0,0 +1,412 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/parallel_download.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/oauth2/google_credentials.h"
+#include "google/cloud/storage/retry_policy.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/storage/testing/random_names.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <crc32c/crc32c.h>
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <set>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+std::string const kBucketName = "test-bucket";
+std::string const kObjectName = "test-object";
+std::int64_t const kGeneration = 1234;
+
+ObjectMetadata MockObject(std::string const& contents,
+                          std::string const& crc32c) {
+  auto metadata = internal::ObjectMetadataParser::FromJson(nlohmann::json{
+      {"bucket", kBucketName},
+      {"name", kObjectName},
+      {"generation", kGeneration},
+      {"size", contents.size()},
+      {"crc32c", crc32c},
+  });
+  EXPECT_STATUS_OK(metadata);
+  return *metadata;
+}
+
+/// Return a `ObjectReadSource` that returns @p contents.
+std::unique_ptr<ObjectReadSource> MockSource(std::string contents) {
+  auto source = absl::make_unique<testing::MockObjectReadSource>();
+  auto offset = std::make_shared<std::size_t>(0);
+  EXPECT_CALL(*source, Read(_, _))
+      .WillRepeatedly([contents, offset](char* buf, std::size_t n) {
+        n = (std::min)(n, contents.size() - *offset);
+        std::memcpy(buf, contents.data() + *offset, n);
+        *offset += n;
+        auto const code = *offset == contents.size() ? 200 : 100;
+        return make_status_or(ReadSourceResult{n, HttpResponse{code, "", {}}});
+      });
+  EXPECT_CALL(*source, IsOpen()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*source, Close())
+      .WillRepeatedly(Return(HttpResponse{200, "", {}}));
+  return std::unique_ptr<ObjectReadSource>(std::move(source));
+}
+
+class ParallelDownloadTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<testing::MockClient>();
+    EXPECT_CALL(*mock_, client_options())
+        .WillRepeatedly(ReturnRef(client_options_));
+    client_.reset(new Client{
+        std::shared_ptr<internal::RawClient>(mock_),
+        LimitedErrorCountRetryPolicy(2),
+        ExponentialBackoffPolicy(std::chrono::milliseconds(1),
+                                 std::chrono::milliseconds(1), 2.0)});
+    file_name_ = testing::MakeRandomFileName(generator_);
+  }
+  void TearDown() override {
+    (void)std::remove(file_name_.c_str());
+    (void)std::remove(CheckpointFile().c_str());
+    client_.reset();
+    mock_.reset();
+  }
+
+  void ExpectReads(std::string const& contents) {
+    EXPECT_CALL(*mock_, ReadObject(_))
+        .WillRepeatedly([contents](ReadObjectRangeRequest const& r) {
+          EXPECT_EQ(kBucketName, r.bucket_name());
+          EXPECT_EQ(kObjectName, r.object_name());
+          EXPECT_EQ(kGeneration, r.GetOption<Generation>().value_or(0));
+          EXPECT_TRUE(r.HasOption<ReadRange>());
+          auto const range = r.GetOption<ReadRange>().value();
+          return make_status_or(MockSource(contents.substr(
+              static_cast<std::size_t>(range.begin),
+              static_cast<std::size_t>(range.end - range.begin))));
+        });
+  }
+
+  std::string ReadFile() { return ReadFile(file_name_); }
+
+  static std::string ReadFile(std::string const& name) {
+    std::ifstream is(name, std::ios::binary);
+    return std::string{std::istreambuf_iterator<char>{is}, {}};
+  }
+
+  static void WriteFile(std::string const& name, std::string const& contents) {
+    std::ofstream os(name, std::ios::binary | std::ios::trunc);
+    os.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  }
+
+  std::string CheckpointFile() const {
+    return ParallelDownloadCheckpointFileName(file_name_);
+  }
+
+  google::cloud::internal::DefaultPRNG generator_ =
+      google::cloud::internal::MakeDefaultPRNG();
+  std::shared_ptr<testing::MockClient> mock_;
+  std::unique_ptr<Client> client_;
+  ClientOptions client_options_ =
+      ClientOptions(oauth2::CreateAnonymousCredentials());
+  std::string file_name_;
+};
+
+TEST(ParallelDownloadSlices, Empty) {
+  auto const slices = ComputeParallelDownloadSlices(0, {}, {});
+  ASSERT_EQ(1, slices.size());
+  EXPECT_EQ(0, slices[0].begin);
+  EXPECT_EQ(0, slices[0].end);
+}
+
+TEST(ParallelDownloadSlices, Basic) {
+  auto const slices = ComputeParallelDownloadSlices(
+      1000, MaxStreams(4), MinStreamSize(100));
+  ASSERT_EQ(4, slices.size());
+  std::int64_t offset = 0;
+  for (auto const& s : slices) {
+    EXPECT_EQ(offset, s.begin);
+    EXPECT_LT(s.begin, s.end);
+    offset = s.end;
+  }
+  EXPECT_EQ(1000, offset);
+}
+
+TEST(ParallelDownloadSlices, MinStreamSize) {
+  auto const slices =
+      ComputeParallelDownloadSlices(1000, absl::nullopt, MinStreamSize(400));
+  ASSERT_EQ(3, slices.size());
+  EXPECT_EQ(1000, slices.back().end);
+}
+
+TEST_F(ParallelDownloadTest, Success) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(
+          MockObject(contents, ComputeCrc32cChecksum(contents)))));
+  ExpectReads(contents);
+
+  auto status =
+      ParallelDownloadFile(*client_, kBucketName, kObjectName, file_name_,
+                           MaxStreams(4), MinStreamSize(100));
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(contents, ReadFile());
+}
+
+TEST_F(ParallelDownloadTest, EmptyObject) {
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(MockObject("", "AAAAAA=="))));
+  EXPECT_CALL(*mock_, ReadObject(_)).Times(0);
+
+  auto status =
+      ParallelDownloadFile(*client_, kBucketName, kObjectName, file_name_);
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ("", ReadFile());
+}
+
+TEST_F(ParallelDownloadTest, ChecksumMismatch) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(
+          MockObject(contents, ComputeCrc32cChecksum("not the contents")))));
+  ExpectReads(contents);
+
+  auto status =
+      ParallelDownloadFile(*client_, kBucketName, kObjectName, file_name_,
+                           MaxStreams(4), MinStreamSize(100));
+  EXPECT_THAT(status, StatusIs(StatusCode::kDataLoss,
+                               HasSubstr("mismatched checksums")));
+
+  // The checksum validation can be disabled.
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(
+          MockObject(contents, ComputeCrc32cChecksum("not the contents")))));
+  status = ParallelDownloadFile(*client_, kBucketName, kObjectName,
+                                file_name_, MaxStreams(4), MinStreamSize(100),
+                                DisableCrc32cChecksum(true));
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(contents, ReadFile());
+}
+
+TEST_F(ParallelDownloadTest, MetadataFailure) {
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(PermanentError())));
+  auto status =
+      ParallelDownloadFile(*client_, kBucketName, kObjectName, file_name_);
+  EXPECT_THAT(status, StatusIs(PermanentError().code(),
+                               HasSubstr("cannot get download source")));
+}
+
+TEST_F(ParallelDownloadTest, ReadFailure) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(
+          MockObject(contents, ComputeCrc32cChecksum(contents)))));
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .WillRepeatedly([](ReadObjectRangeRequest const&) {
+        return StatusOr<std::unique_ptr<ObjectReadSource>>(PermanentError());
+      });
+  auto status =
+      ParallelDownloadFile(*client_, kBucketName, kObjectName, file_name_,
+                           MaxStreams(4), MinStreamSize(100));
+  EXPECT_THAT(status, StatusIs(PermanentError().code(),
+                               HasSubstr("error downloading slice")));
+}
+
+TEST_F(ParallelDownloadTest, RangesNotSupported) {
+  auto status = ParallelDownloadFile(*client_, kBucketName, kObjectName,
+                                     file_name_, ReadFromOffset(10));
+  EXPECT_THAT(status, StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ParallelDownloadPersistentState, RoundTrip) {
+  ParallelDownloadPersistentState state{
+      kBucketName, kObjectName, kGeneration, 1000,
+      {{0, 500, 500, 0x12345678U}, {500, 1000, 20, 0xFFFFFFFFU}}};
+  auto actual = ParallelDownloadPersistentState::FromString(state.ToString());
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(kBucketName, actual->bucket_name);
+  EXPECT_EQ(kObjectName, actual->object_name);
+  EXPECT_EQ(kGeneration, actual->generation);
+  EXPECT_EQ(1000, actual->object_size);
+  ASSERT_EQ(2, actual->slices.size());
+  EXPECT_EQ(500, actual->slices[1].begin);
+  EXPECT_EQ(1000, actual->slices[1].end);
+  EXPECT_EQ(20, actual->slices[1].completed);
+  EXPECT_EQ(0xFFFFFFFFU, actual->slices[1].crc32c);
+}
+
+TEST(ParallelDownloadPersistentState, Invalid) {
+  for (std::string const json : {
+           R"js(not-json)js",
+           R"js([])js",
+           R"js({"object": "o", "generation": 1, "size": 0, "slices": []})js",
+           R"js({"bucket": "b", "object": "o", "generation": "1",
+                 "size": 0, "slices": []})js",
+           R"js({"bucket": "b", "object": "o", "generation": 1,
+                 "size": 0, "slices": [{"begin": 0, "end": 0}]})js",
+       }) {
+    EXPECT_THAT(ParallelDownloadPersistentState::FromString(json),
+                StatusIs(StatusCode::kInternal))
+        << "json=" << json;
+  }
+}
+
+TEST_F(ParallelDownloadTest, ResumableSuccess) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(
+          MockObject(contents, ComputeCrc32cChecksum(contents)))));
+  ExpectReads(contents);
+
+  auto status = ResumableParallelDownloadFile(
+      *client_, kBucketName, kObjectName, file_name_, MaxStreams(4),
+      MinStreamSize(100));
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(contents, ReadFile());
+  // The checkpoint is removed after a successful download.
+  EXPECT_FALSE(std::ifstream(CheckpointFile()).is_open());
+}
+
+TEST_F(ParallelDownloadTest, ResumableAfterFailure) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  auto const metadata = MockObject(contents, ComputeCrc32cChecksum(contents));
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillRepeatedly(Return(make_status_or(metadata)));
+
+  // Fail the third slice, the other slices complete.
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .WillRepeatedly([contents](ReadObjectRangeRequest const& r) {
+        auto const range = r.GetOption<ReadRange>().value();
+        if (range.begin == 500) {
+          return StatusOr<std::unique_ptr<ObjectReadSource>>(PermanentError());
+        }
+        return make_status_or(MockSource(contents.substr(
+            static_cast<std::size_t>(range.begin),
+            static_cast<std::size_t>(range.end - range.begin))));
+      });
+  auto status = ResumableParallelDownloadFile(
+      *client_, kBucketName, kObjectName, file_name_, MaxStreams(4),
+      MinStreamSize(100));
+  EXPECT_THAT(status, StatusIs(PermanentError().code()));
+
+  auto state =
+      ParallelDownloadPersistentState::FromString(ReadFile(CheckpointFile()));
+  ASSERT_STATUS_OK(state);
+  EXPECT_EQ(kGeneration, state->generation);
+  ASSERT_EQ(4, state->slices.size());
+  EXPECT_EQ(250, state->slices[0].completed);
+  EXPECT_EQ(250, state->slices[1].completed);
+  EXPECT_EQ(0, state->slices[2].completed);
+  EXPECT_EQ(250, state->slices[3].completed);
+
+  // Resuming only downloads the missing slice, using the pinned generation.
+  std::mutex mu;
+  std::set<std::int64_t> offsets;
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce([&](GetObjectMetadataRequest const& r) {
+        EXPECT_EQ(kGeneration, r.GetOption<Generation>().value_or(0));
+        return make_status_or(metadata);
+      });
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .WillRepeatedly([&](ReadObjectRangeRequest const& r) {
+        auto const range = r.GetOption<ReadRange>().value();
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          offsets.insert(range.begin);
+        }
+        return make_status_or(MockSource(contents.substr(
+            static_cast<std::size_t>(range.begin),
+            static_cast<std::size_t>(range.end - range.begin))));
+      });
+  status = ResumableParallelDownloadFile(*client_, kBucketName, kObjectName,
+                                         file_name_, MaxStreams(4),
+                                         MinStreamSize(100));
+  ASSERT_STATUS_OK(status);
+  EXPECT_THAT(offsets, ElementsAre(500));
+  EXPECT_EQ(contents, ReadFile());
+  EXPECT_FALSE(std::ifstream(CheckpointFile()).is_open());
+}
+
+TEST_F(ParallelDownloadTest, ResumablePartialSlice) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(
+          MockObject(contents, ComputeCrc32cChecksum(contents)))));
+
+  // Simulate a download interrupted after the first 100 bytes.
+  WriteFile(file_name_, contents.substr(0, 100) + std::string(900, '\0'));
+  ParallelDownloadPersistentState state{
+      kBucketName,
+      kObjectName,
+      kGeneration,
+      1000,
+      {{0, 1000, 100, crc32c::Crc32c(contents.data(), 100)}}};
+  WriteFile(CheckpointFile(), state.ToString());
+
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .WillOnce([contents](ReadObjectRangeRequest const& r) {
+        auto const range = r.GetOption<ReadRange>().value();
+        EXPECT_EQ(100, range.begin);
+        EXPECT_EQ(1000, range.end);
+        return make_status_or(MockSource(contents.substr(100)));
+      });
+  auto status = ResumableParallelDownloadFile(*client_, kBucketName,
+                                              kObjectName, file_name_);
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(contents, ReadFile());
+}
+
+TEST_F(ParallelDownloadTest, ResumableIgnoresMismatchedCheckpoint) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(
+          MockObject(contents, ComputeCrc32cChecksum(contents)))));
+  ExpectReads(contents);
+
+  WriteFile(file_name_, std::string(1000, '\0'));
+  ParallelDownloadPersistentState state{
+      kBucketName, "some-other-object", kGeneration, 1000, {{0, 1000, 0, 0}}};
+  WriteFile(CheckpointFile(), state.ToString());
+
+  auto status = ResumableParallelDownloadFile(*client_, kBucketName,
+                                              kObjectName, file_name_);
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(contents, ReadFile());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,206 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/parallel_list_objects.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+std::size_t constexpr kDefaultMaxStreams = 64;
+// The number of pages, per stream, buffered for the application.
+std::size_t constexpr kBufferedPagesPerStream = 2;
+
+/**
+ * Lists several shards in background threads, and merges the results.
+ *
+ * Each background thread picks the next shard to list, and pushes the pages
+ * of results into a queue shared by all the threads. The application consumes
+ * the results from the queue. The threads block while the queue is full.
+ */
+class ParallelObjectLister {
+ public:
+  ParallelObjectLister(std::shared_ptr<RawClient> client,
+                       ListObjectsRequest request,
+                       std::vector<ListObjectsShard> shards,
+                       std::size_t stream_count)
+      : client_(std::move(client)),
+        request_(std::move(request)),
+        shards_(std::move(shards)),
+        max_buffered_pages_(stream_count * kBufferedPagesPerStream),
+        running_(stream_count) {
+    current_ = page_.begin();
+    workers_.reserve(stream_count);
+    for (std::size_t i = 0; i != stream_count; ++i) {
+      workers_.emplace_back([this] { Worker(); });
+    }
+  }
+
+  ~ParallelObjectLister() {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      cancelled_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+  }
+
+  using ResultType =
+      google::cloud::internal::StreamReader<ObjectMetadata>::result_type;
+
+  ResultType GetNext() {
+    while (current_ == page_.end()) {
+      std::unique_lock<std::mutex> lk(mu_);
+      cv_.wait(lk, [this] { return !pages_.empty() || running_ == 0; });
+      if (pages_.empty()) return Status{};
+      auto page = std::move(pages_.front());
+      pages_.pop_front();
+      if (!page) cancelled_ = true;
+      lk.unlock();
+      cv_.notify_all();
+      if (!page) return std::move(page).status();
+      page_ = *std::move(page);
+      current_ = page_.begin();
+    }
+    return std::move(*current_++);
+  }
+
+ private:
+  void Worker() {
+    for (auto shard = NextShard(); shard.has_value(); shard = NextShard()) {
+      if (!ListShard(*shard)) break;
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    if (--running_ == 0) cv_.notify_all();
+  }
+
+  absl::optional<ListObjectsShard> NextShard() {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (cancelled_ || next_shard_ == shards_.size()) return {};
+    return shards_[next_shard_++];
+  }
+
+  /// List all the objects in @p shard, returns false if the listing stopped.
+  bool ListShard(ListObjectsShard const& shard) {
+    auto request = request_;
+    if (!shard.start_offset.empty()) {
+      request.set_option(StartOffset(shard.start_offset));
+    }
+    if (!shard.end_offset.empty()) {
+      request.set_option(EndOffset(shard.end_offset));
+    }
+    for (;;) {
+      auto response = client_->ListObjects(request);
+      if (!response) {
+        Push(std::move(response).status());
+        return false;
+      }
+      request.set_page_token(std::move(response->next_page_token));
+      if (!Push(std::move(response->items))) return false;
+      if (request.page_token().empty()) return true;
+    }
+  }
+
+  /// Push a page into the queue, returns false if the listing was cancelled.
+  bool Push(StatusOr<std::vector<ObjectMetadata>> page) {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [this] {
+      return cancelled_ || pages_.size() < max_buffered_pages_;
+    });
+    if (cancelled_) return false;
+    pages_.push_back(std::move(page));
+    lk.unlock();
+    cv_.notify_all();
+    return true;
+  }
+
+  std::shared_ptr<RawClient> client_;
+  ListObjectsRequest const request_;
+  std::vector<ListObjectsShard> const shards_;
+  std::size_t const max_buffered_pages_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<StatusOr<std::vector<ObjectMetadata>>> pages_;
+  std::size_t next_shard_ = 0;
+  std::size_t running_;
+  bool cancelled_ = false;
+
+  // Only used by the application thread, in `GetNext()`.
+  std::vector<ObjectMetadata> page_;
+  std::vector<ObjectMetadata>::iterator current_;
+
+  // Declared last, so the threads are started after all the other members are
+  // initialized.
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace
+
+std::vector<ListObjectsShard> ComputeListObjectsShards(
+    ListObjectsRequest const& request, std::vector<std::string> split_points) {
+  auto const start = request.GetOption<StartOffset>().value_or("");
+  auto const end = request.GetOption<EndOffset>().value_or("");
+  auto const prefix = request.GetOption<Prefix>().value_or("");
+  auto const outside = [&](std::string const& p) {
+    if (p.empty() || p <= start) return true;
+    if (!end.empty() && p >= end) return true;
+    return p.compare(0, prefix.size(), prefix) != 0;
+  };
+  split_points.erase(
+      std::remove_if(split_points.begin(), split_points.end(), outside),
+      split_points.end());
+  std::sort(split_points.begin(), split_points.end());
+  split_points.erase(std::unique(split_points.begin(), split_points.end()),
+                     split_points.end());
+
+  std::vector<ListObjectsShard> shards;
+  shards.reserve(split_points.size() + 1);
+  auto begin = start;
+  for (auto& p : split_points) {
+    shards.push_back(ListObjectsShard{std::move(begin), p});
+    begin = std::move(p);
+  }
+  shards.push_back(ListObjectsShard{std::move(begin), end});
+  return shards;
+}
+
+ListObjectsReader ParallelListObjectsImpl(
+    Client client, ListObjectsRequest request,
+    std::vector<std::string> split_points,
+    absl::optional<MaxStreams> max_streams) {
+  auto shards = ComputeListObjectsShards(request, std::move(split_points));
+  auto const stream_count = (std::max<std::size_t>)(
+      1, (std::min)(shards.size(), max_streams.value_or(kDefaultMaxStreams)
+                                       .value()));
+  auto lister = std::make_shared<ParallelObjectLister>(
+      client.raw_client(), std::move(request), std::move(shards),
+      stream_count);
+  return google::cloud::internal::MakeStreamRange<ObjectMetadata>(
+      [lister] { return lister->GetNext(); });
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
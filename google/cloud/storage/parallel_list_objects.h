@@ -0,0 +1,157 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_PARALLEL_LIST_OBJECTS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_PARALLEL_LIST_OBJECTS_H
+
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/internal/tuple_filter.h"
+#include "google/cloud/storage/list_objects_reader.h"
+#include "google/cloud/storage/parallel_upload.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/internal/tuple.h"
+#include "absl/types/optional.h"
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+
+/**
+ * A shard of a parallel listing, the range is right-open: `[start, end)`.
+ *
+ * An empty `start_offset` (or `end_offset`) means the range is unbounded on
+ * that side.
+ */
+struct ListObjectsShard {
+  std::string start_offset;
+  std::string end_offset;
+};
+
+/**
+ * Split the key space of @p request into shards for a parallel listing.
+ *
+ * The split points are sorted and deduplicated. Split points that are outside
+ * the range defined by the `StartOffset`, `EndOffset` and `Prefix` options in
+ * @p request are ignored.
+ */
+std::vector<ListObjectsShard> ComputeListObjectsShards(
+    ListObjectsRequest const& request, std::vector<std::string> split_points);
+
+/// Implement `ParallelListObjects()` once the options are applied.
+ListObjectsReader ParallelListObjectsImpl(
+    Client client, ListObjectsRequest request,
+    std::vector<std::string> split_points,
+    absl::optional<MaxStreams> max_streams);
+
+/**
+ * Helper functor to set the options in a `ListObjectsRequest` via `apply`.
+ */
+struct ListObjectsRequestSetOptions {
+  template <typename... Options>
+  void operator()(Options&&... options) const {
+    request.set_multiple_options(std::forward<Options>(options)...);
+  }
+
+  ListObjectsRequest& request;
+};
+
+}  // namespace internal
+
+/**
+ * List the objects in a bucket using multiple parallel streams.
+ *
+ * `Client::ListObjects()` fetches the pages of results one at a time, each
+ * request depends on the page token returned by the previous request. For
+ * buckets with hundreds of millions of objects this can take a long time.
+ * This function splits the key space into shards, using @p split_points as the
+ * boundaries between shards, and lists the shards in parallel, using the
+ * `StartOffset` and `EndOffset` options.
+ *
+ * The shards cover the full key space, with `N` split points there are `N + 1`
+ * shards: `[(start), split_points[0])`, `[split_points[0], split_points[1])`,
+ * ... `[split_points[N-1], (end))`. The results are the same as the results
+ * from `Client::ListObjects()`, only their order is different: results from
+ * different shards are interleaved as they arrive, while results within a
+ * shard are returned in lexicographical order.
+ *
+ * The split points should divide the bucket into shards of similar sizes.
+ * For buckets using a hierarchical naming scheme the top-level prefixes,
+ * as returned by `Client::ListObjectsAndPrefixes()` with a `Delimiter("/")`
+ * option, are a good choice.
+ *
+ * The number of parallel streams is controlled by the `MaxStreams` option,
+ * it defaults to 64. The background threads stop listing when the results not
+ * yet consumed by the application fill two pages per stream, and when the
+ * returned range is destroyed. If listing any shard fails the range returns
+ * that error, and stops listing the remaining shards.
+ *
+ * @param client the client on which to perform the operation.
+ * @param bucket_name the name of the bucket to list.
+ * @param split_points the boundaries between shards, in any order.
+ * @param options a list of optional query parameters and/or request headers.
+ *     Valid types for this operation include `MaxResults`, `MaxStreams`,
+ *     `Prefix`, `Projection`, `StartOffset`, `EndOffset`, `UserProject`, and
+ *     `Versions`.
+ *
+ * @par Idempotency
+ * This is a read-only operation and is always idempotent.
+ *
+ * @par Example
+ * @code
+ * namespace gcs = google::cloud::storage;
+ * std::vector<std::string> split_points;
+ * for (auto& p : client.ListObjectsAndPrefixes(bucket_name,
+ *                                              gcs::Delimiter("/"))) {
+ *   if (!p) throw std::runtime_error(p.status().message());
+ *   if (absl::holds_alternative<std::string>(*p)) {
+ *     split_points.push_back(absl::get<std::string>(*std::move(p)));
+ *   }
+ * }
+ * for (auto& o : gcs::ParallelListObjects(client, bucket_name, split_points,
+ *                                         gcs::MaxStreams(32))) {
+ *   if (!o) throw std::runtime_error(o.status().message());
+ *   std::cout << o->name() << "\n";
+ * }
+ * @endcode
+ */
+template <typename... Options>
+ListObjectsReader ParallelListObjects(Client client,
+                                      std::string const& bucket_name,
+                                      std::vector<std::string> split_points,
+                                      Options&&... options) {
+  auto const max_streams =
+      internal::ExtractFirstOccurenceOfType<MaxStreams>(std::tie(options...));
+  internal::ListObjectsRequest request(bucket_name);
+  google::cloud::internal::apply(
+      internal::ListObjectsRequestSetOptions{request},
+      internal::StaticTupleFilter<internal::NotAmong<MaxStreams>::TPred>(
+          std::tie(options...)));
+  return internal::ParallelListObjectsImpl(std::move(client),
+                                           std::move(request),
+                                           std::move(split_points),
+                                           max_streams);
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_PARALLEL_LIST_OBJECTS_H
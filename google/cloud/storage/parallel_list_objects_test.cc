@@ -0,0 +1,194 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/parallel_list_objects.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::ReturnRef;
+
+std::string const kBucketName = "test-bucket";
+
+ObjectMetadata MockObject(std::string const& name) {
+  auto metadata = internal::ObjectMetadataParser::FromJson(nlohmann::json{
+      {"bucket", kBucketName},
+      {"name", name},
+  });
+  EXPECT_STATUS_OK(metadata);
+  return *metadata;
+}
+
+MATCHER_P2(IsShard, start, end, "") {
+  return arg.start_offset == start && arg.end_offset == end;
+}
+
+TEST(ComputeListObjectsShardsTest, Basic) {
+  ListObjectsRequest request(kBucketName);
+  EXPECT_THAT(ComputeListObjectsShards(request, {}),
+              ElementsAre(IsShard("", "")));
+  EXPECT_THAT(ComputeListObjectsShards(request, {"m", "d", "", "m", "t"}),
+              ElementsAre(IsShard("", "d"), IsShard("d", "m"),
+                          IsShard("m", "t"), IsShard("t", "")));
+}
+
+TEST(ComputeListObjectsShardsTest, WithOffsets) {
+  ListObjectsRequest request(kBucketName);
+  request.set_multiple_options(StartOffset("c"), EndOffset("p"));
+  EXPECT_THAT(ComputeListObjectsShards(request, {"a", "c", "d", "m", "p", "z"}),
+              ElementsAre(IsShard("c", "d"), IsShard("d", "m"),
+                          IsShard("m", "p")));
+}
+
+TEST(ComputeListObjectsShardsTest, WithPrefix) {
+  ListObjectsRequest request(kBucketName);
+  request.set_multiple_options(Prefix("dir/"));
+  EXPECT_THAT(ComputeListObjectsShards(request, {"a", "dir/m", "z"}),
+              ElementsAre(IsShard("", "dir/m"), IsShard("dir/m", "")));
+}
+
+class ParallelListObjectsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (char c = 'a'; c <= 'z'; ++c) {
+      for (int i = 0; i != 5; ++i) {
+        objects_.push_back(std::string(1, c) + std::to_string(i));
+      }
+    }
+    mock_ = std::make_shared<testing::MockClient>();
+    EXPECT_CALL(*mock_, client_options())
+        .WillRepeatedly(ReturnRef(client_options_));
+  }
+
+  /// Simulate the service, returning two objects in each page.
+  StatusOr<ListObjectsResponse> List(ListObjectsRequest const& r) {
+    EXPECT_EQ(kBucketName, r.bucket_name());
+    auto const start = r.GetOption<StartOffset>().value_or("");
+    auto const end = r.GetOption<EndOffset>().value_or("");
+    auto begin = std::lower_bound(objects_.begin(), objects_.end(),
+                                  std::max(start, r.page_token()));
+    ListObjectsResponse response;
+    for (auto i = begin; i != objects_.end(); ++i) {
+      if (!end.empty() && *i >= end) break;
+      if (response.items.size() == 2) {
+        response.next_page_token = *i;
+        break;
+      }
+      response.items.push_back(MockObject(*i));
+    }
+    return response;
+  }
+
+  Client MakeClient() {
+    return Client(std::shared_ptr<internal::RawClient>(mock_),
+                  Client::NoDecorations{});
+  }
+
+  std::vector<std::string> objects_;
+  std::shared_ptr<testing::MockClient> mock_;
+  ClientOptions client_options_ =
+      ClientOptions(oauth2::CreateAnonymousCredentials());
+};
+
+TEST_F(ParallelListObjectsTest, Basic) {
+  EXPECT_CALL(*mock_, ListObjects(_))
+      .WillRepeatedly(
+          [this](ListObjectsRequest const& r) { return List(r); });
+
+  std::vector<std::string> actual;
+  for (auto& o : ParallelListObjects(MakeClient(), kBucketName,
+                                     {"t", "e", "k"}, MaxStreams(3))) {
+    ASSERT_STATUS_OK(o);
+    actual.push_back(o->name());
+  }
+  std::sort(actual.begin(), actual.end());
+  EXPECT_THAT(actual, ElementsAreArray(objects_));
+}
+
+TEST_F(ParallelListObjectsTest, SingleStreamIsOrdered) {
+  EXPECT_CALL(*mock_, ListObjects(_))
+      .WillRepeatedly(
+          [this](ListObjectsRequest const& r) { return List(r); });
+
+  std::vector<std::string> actual;
+  for (auto& o : ParallelListObjects(MakeClient(), kBucketName,
+                                     {"t", "e", "k"}, MaxStreams(1),
+                                     StartOffset("c"), EndOffset("w"))) {
+    ASSERT_STATUS_OK(o);
+    actual.push_back(o->name());
+  }
+  std::vector<std::string> expected;
+  std::copy_if(objects_.begin(), objects_.end(), std::back_inserter(expected),
+               [](std::string const& n) { return n >= "c" && n < "w"; });
+  EXPECT_THAT(actual, ElementsAreArray(expected));
+}
+
+TEST_F(ParallelListObjectsTest, Error) {
+  EXPECT_CALL(*mock_, ListObjects(_))
+      .WillRepeatedly([this](ListObjectsRequest const& r) {
+        if (r.GetOption<StartOffset>().value_or("") == "k") {
+          return StatusOr<ListObjectsResponse>(PermanentError());
+        }
+        return List(r);
+      });
+
+  Status status;
+  for (auto& o : ParallelListObjects(MakeClient(), kBucketName,
+                                     {"t", "e", "k"}, MaxStreams(4))) {
+    if (!o) {
+      status = std::move(o).status();
+      break;
+    }
+  }
+  EXPECT_THAT(status, StatusIs(PermanentError().code()));
+}
+
+TEST_F(ParallelListObjectsTest, Abandoned) {
+  EXPECT_CALL(*mock_, ListObjects(_))
+      .WillRepeatedly(
+          [this](ListObjectsRequest const& r) { return List(r); });
+
+  // Destroying the range stops (and waits for) the background threads.
+  auto range = ParallelListObjects(MakeClient(), kBucketName, {"t", "e", "k"},
+                                   MaxStreams(2));
+  auto i = range.begin();
+  ASSERT_NE(i, range.end());
+  EXPECT_STATUS_OK(*i);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
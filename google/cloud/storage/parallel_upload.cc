@@ -13,7 +13,11 @@
 // limitations under the License.
 
 #include "google/cloud/storage/parallel_upload.h"
+#include "google/cloud/storage/internal/crc32c_combine.h"
+#include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/internal/big_endian.h"
 #include "absl/memory/memory.h"
+#include <crc32c/crc32c.h>
 #include <nlohmann/json.hpp>
 #include <sstream>
 
@@ -53,9 +57,10 @@ class ParallelObjectWriteStreambuf : public ObjectWriteStreambuf {
 ParallelUploadStateImpl::ParallelUploadStateImpl(
     bool cleanup_on_failures, std::string destination_object_name,
     std::int64_t expected_generation, std::shared_ptr<ScopedDeleter> deleter,
-    Composer composer)
+    Composer composer, GroupComposer group_composer)
     : deleter_(std::move(deleter)),
       composer_(std::move(composer)),
+      group_composer_(std::move(group_composer)),
       destination_object_name_(std::move(destination_object_name)),
       expected_generation_(expected_generation),
       finished_{},
@@ -82,7 +87,8 @@ StatusOr<ObjectWriteStream> ParallelUploadStateImpl::CreateStream(
   auto idx = streams_.size();
   ++num_unfinished_streams_;
   streams_.emplace_back(
-      StreamInfo{request.object_name(), (*session)->session_id(), {}, false});
+      StreamInfo{request.object_name(), (*session)->session_id(), {}, false,
+                 {}, 0});
   assert(idx < streams_.size());
   lk.unlock();
   return ObjectWriteStream(absl::make_unique<ParallelObjectWriteStreambuf>(
@@ -223,6 +229,15 @@ void ParallelUploadStateImpl::Fail(Status status) {
   }
 }
 
+void ParallelUploadStateImpl::SetStreamCrc32c(std::size_t stream_idx,
+                                              std::uint32_t crc32c,
+                                              std::uintmax_t size) {
+  std::unique_lock<std::mutex> lk(mu_);
+  assert(stream_idx < streams_.size());
+  streams_[stream_idx].crc32c = crc32c;
+  streams_[stream_idx].size = size;
+}
+
 ParallelUploadPersistentState ParallelUploadStateImpl::ToPersistentState()
     const {
   std::unique_lock<std::mutex> lk(mu_);
@@ -245,15 +260,25 @@ void ParallelUploadStateImpl::AllStreamsFinished(
     std::unique_lock<std::mutex>& lk) {
   if (!res_) {
     std::vector<ComposeSourceObject> to_compose;
-    std::transform(
-        streams_.begin(), streams_.end(), std::back_inserter(to_compose),
-        [](StreamInfo const& stream) { return *stream.composition_arg; });
+    auto const group_size = kParallelUploadComposeGroupSize;
+    for (std::size_t i = 0; i < streams_.size();) {
+      auto const group = i / group_size;
+      if (i % group_size == 0 && group < groups_.size() && groups_[group]) {
+        to_compose.push_back(*groups_[group]);
+        i += group_size;
+        continue;
+      }
+      to_compose.push_back(*streams_[i].composition_arg);
+      ++i;
+    }
     // only execute ComposeMany if all the streams succeeded.
     lk.unlock();
     auto res = composer_(to_compose);
     lk.lock();
     if (res) {
       deleter_->Enable(true);
+      auto status = VerifyCrc32c(*res);
+      if (!status.ok()) res = std::move(status);
     }
     res_ = std::move(res);
   }
@@ -266,6 +291,23 @@ void ParallelUploadStateImpl::AllStreamsFinished(
   }
 }
 
+Status ParallelUploadStateImpl::VerifyCrc32c(
+    ObjectMetadata const& metadata) const {
+  if (metadata.crc32c().empty()) return Status();
+  std::uint32_t crc = 0;
+  for (auto const& stream : streams_) {
+    // Streams written directly by the application do not report a checksum.
+    if (!stream.crc32c) return Status();
+    crc = Crc32cCombine(crc, *stream.crc32c, stream.size);
+  }
+  auto computed = Base64Encode(google::cloud::internal::EncodeBigEndian(crc));
+  if (computed == metadata.crc32c()) return Status();
+  return Status(StatusCode::kDataLoss,
+                "mismatched CRC32C checksum in parallel upload to " +
+                    destination_object_name_ + ", computed=" + computed +
+                    " received=" + metadata.crc32c());
+}
+
 void ParallelUploadStateImpl::StreamFinished(
     std::size_t stream_idx, StatusOr<ResumableUploadResponse> const& response) {
   std::unique_lock<std::mutex> lk(mu_);
@@ -287,6 +329,7 @@ void ParallelUploadStateImpl::StreamFinished(
     deleter_->Add(metadata);
     streams_[stream_idx].composition_arg =
         ComposeSourceObject{metadata.name(), metadata.generation(), {}};
+    MaybeComposeGroup(lk, stream_idx);
   }
   if (num_unfinished_streams_ > 0) {
     return;
@@ -294,6 +337,35 @@ void ParallelUploadStateImpl::StreamFinished(
   AllStreamsFinished(lk);
 }
 
+void ParallelUploadStateImpl::MaybeComposeGroup(
+    std::unique_lock<std::mutex>& lk, std::size_t stream_idx) {
+  auto const group_size = kParallelUploadComposeGroupSize;
+  // With a single group the final composition is just as fast.
+  if (!group_composer_ || res_ || streams_.size() <= group_size) return;
+  auto const group = stream_idx / group_size;
+  auto const begin = group * group_size;
+  auto const end = begin + group_size;
+  if (end > streams_.size()) return;
+  std::vector<ComposeSourceObject> sources;
+  for (auto i = begin; i != end; ++i) {
+    // Only the last stream to finish in a group composes it.
+    if (!streams_[i].composition_arg) return;
+    sources.push_back(*streams_[i].composition_arg);
+  }
+  // Prevent the final composition until this group is composed.
+  ++num_unfinished_streams_;
+  lk.unlock();
+  auto object = group_composer_(group, sources);
+  lk.lock();
+  --num_unfinished_streams_;
+  // On failure the final composition uses the individual shards.
+  if (!object) return;
+  deleter_->Add(*object);
+  if (groups_.size() <= group) groups_.resize(group + 1);
+  groups_[group] =
+      ComposeSourceObject{object->name(), object->generation(), {}};
+}
+
 void ParallelUploadStateImpl::StreamDestroyed(std::size_t stream_idx) {
   std::unique_lock<std::mutex> lk(mu_);
   if (!streams_[stream_idx].finished) {
@@ -384,6 +456,7 @@ Status ParallelUploadFileShard::Upload() {
                                            " out of " +
                                            std::to_string(left_to_upload_));
   }
+  auto const shard_size = left_to_upload_;
   left_to_upload_ -= already_uploaded;
   offset_in_file_ += already_uploaded;
   std::ifstream istream(file_name_, std::ios::binary);
@@ -394,6 +467,30 @@ Status ParallelUploadFileShard::Upload() {
   static_assert(sizeof(std::ifstream::off_type) >= sizeof(std::uintmax_t),
                 "files cannot handle uintmax_t for offsets uploads");
 
+  std::uint32_t crc32c = 0;
+  auto update_crc32c = [&](std::ifstream::off_type n) {
+    if (!compute_crc32c_) return;
+    crc32c = crc32c::Extend(crc32c,
+                            reinterpret_cast<std::uint8_t const*>(buf.data()),
+                            static_cast<std::size_t>(n));
+  };
+  if (compute_crc32c_ && already_uploaded > 0) {
+    // The checksum covers the complete shard. The data uploaded before this
+    // upload was resumed is read (but not uploaded) again.
+    istream.seekg(static_cast<std::ifstream::off_type>(offset_in_file_ -
+                                                       already_uploaded));
+    for (auto left = already_uploaded; left > 0;) {
+      auto const to_read = static_cast<std::ifstream::off_type>(
+          std::min<std::uintmax_t>(left, upload_buffer_size_));
+      istream.read(buf.data(), to_read);
+      if (!istream.good()) {
+        return fail(StatusCode::kInternal, "cannot read from file source");
+      }
+      update_crc32c(to_read);
+      left -= to_read;
+    }
+  }
+
   // TODO(#...) - this cast should not be necessary.
   istream.seekg(static_cast<std::ifstream::off_type>(offset_in_file_));
   if (!istream.good()) {
@@ -406,6 +503,7 @@ Status ParallelUploadFileShard::Upload() {
     if (!istream.good()) {
       return fail(StatusCode::kInternal, "cannot read from file source");
     }
+    update_crc32c(to_copy);
     ostream_.write(buf.data(), to_copy);
     if (!ostream_.good()) {
       return Status(StatusCode::kInternal,
@@ -414,6 +512,7 @@ Status ParallelUploadFileShard::Upload() {
     }
     left_to_upload_ -= to_copy;
   }
+  if (compute_crc32c_) state_->SetStreamCrc32c(stream_idx_, crc32c, shard_size);
   ostream_.Close();
   if (ostream_.metadata()) {
     return Status();
@@ -421,6 +520,105 @@ Status ParallelUploadFileShard::Upload() {
   return ostream_.metadata().status();
 }
 
+StatusOr<ObjectMetadata> ParallelUploadStreamImpl(
+    ParallelUploadDataSource const& source, std::size_t num_streams,
+    std::size_t part_size, ParallelUploadStreamOperations const& operations) {
+  auto const group_size = kParallelUploadComposeGroupSize;
+  std::mutex mu;
+  bool end_of_data = false;
+  Status status;
+  std::vector<absl::optional<ComposeSourceObject>> parts;
+  std::vector<absl::optional<ComposeSourceObject>> groups;
+  std::vector<bool> group_started;
+
+  // Compose the group containing @p part into a temporary object, if all its
+  // parts are uploaded and more data follows it.
+  auto maybe_compose_group = [&](std::unique_lock<std::mutex>& lk,
+                                 std::size_t part) {
+    auto const group = part / group_size;
+    auto const begin = group * group_size;
+    auto const end = begin + group_size;
+    if (!status.ok() || parts.size() <= end) return;
+    std::vector<ComposeSourceObject> sources;
+    for (auto i = begin; i != end; ++i) {
+      if (!parts[i]) return;
+      sources.push_back(*parts[i]);
+    }
+    if (group_started.size() <= group) group_started.resize(group + 1);
+    if (group_started[group]) return;
+    group_started[group] = true;
+    lk.unlock();
+    auto object = operations.compose_group(group, sources);
+    lk.lock();
+    // On failure the final composition uses the individual parts.
+    if (!object) return;
+    operations.deleter->Add(*object);
+    if (groups.size() <= group) groups.resize(group + 1);
+    groups[group] =
+        ComposeSourceObject{object->name(), object->generation(), {}};
+  };
+
+  auto worker = [&] {
+    std::unique_lock<std::mutex> lk(mu);
+    while (!end_of_data && status.ok()) {
+      // The data is read while holding the lock, this keeps the parts in
+      // order, while the other workers upload their parts.
+      std::string contents(part_size, '\0');
+      std::size_t size = 0;
+      while (size < part_size) {
+        auto n = source(&contents[size], part_size - size);
+        if (!n) {
+          status = std::move(n).status();
+          return;
+        }
+        if (*n == 0) {
+          end_of_data = true;
+          break;
+        }
+        size += *n;
+      }
+      // The first part is uploaded, even if empty, to create the object.
+      if (size == 0 && !parts.empty()) return;
+      contents.resize(size);
+      auto const part = parts.size();
+      parts.emplace_back();
+
+      lk.unlock();
+      auto object = operations.upload_part(part, std::move(contents));
+      lk.lock();
+      if (!object) {
+        if (status.ok()) status = std::move(object).status();
+        return;
+      }
+      operations.deleter->Add(*object);
+      parts[part] =
+          ComposeSourceObject{object->name(), object->generation(), {}};
+      maybe_compose_group(lk, part);
+      // The previous group may have finished before this part started.
+      if (part % group_size == 0 && part != 0) {
+        maybe_compose_group(lk, part - 1);
+      }
+    }
+  };
+  RunConcurrently(num_streams, num_streams, [&worker](std::size_t) {
+    worker();
+  });
+  if (!status.ok()) return status;
+
+  std::vector<ComposeSourceObject> to_compose;
+  for (std::size_t i = 0; i < parts.size();) {
+    auto const group = i / group_size;
+    if (i % group_size == 0 && group < groups.size() && groups[group]) {
+      to_compose.push_back(*groups[group]);
+      i += group_size;
+      continue;
+    }
+    to_compose.push_back(*parts[i]);
+    ++i;
+  }
+  return operations.compose(to_compose);
+}
+
 StatusOr<std::pair<std::string, std::int64_t>> ParseResumableSessionId(
     std::string const& session_id) {
   auto starts_with = [](std::string const& s, std::string const& prefix) {
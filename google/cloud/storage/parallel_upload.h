@@ -29,6 +29,7 @@
 #include <cstddef>
 #include <fstream>
 #include <functional>
+#include <istream>
 #include <mutex>
 #include <tuple>
 #include <utility>
@@ -73,31 +74,6 @@ namespace internal {
 class ParallelUploadFileShard;
 struct CreateParallelUploadShards;
 
-/**
- * Return an empty option if Tuple contains an element of type T, otherwise
- *     return the value of the first element of type T
- */
-template <typename T, typename Tuple, typename Enable = void>
-struct ExtractFirstOccurenceOfTypeImpl {
-  absl::optional<T> operator()(Tuple const&) { return absl::optional<T>(); }
-};
-
-template <typename T, typename... Options>
-struct ExtractFirstOccurenceOfTypeImpl<
-    T, std::tuple<Options...>,
-    typename std::enable_if<
-        Among<typename std::decay<Options>::type...>::template TPred<
-            typename std::decay<T>::type>::value>::type> {
-  absl::optional<T> operator()(std::tuple<Options...> const& tuple) {
-    return std::get<0>(StaticTupleFilter<Among<T>::template TPred>(tuple));
-  }
-};
-
-template <typename T, typename Tuple>
-absl::optional<T> ExtractFirstOccurenceOfType(Tuple const& tuple) {
-  return ExtractFirstOccurenceOfTypeImpl<T, Tuple>()(tuple);
-}
-
 /**
  * An option for `PrepareParallelUpload` to associate opaque data with upload.
  *
@@ -125,6 +101,19 @@ class ParallelObjectWriteStreambuf;
 using Composer = std::function<StatusOr<ObjectMetadata>(
     std::vector<ComposeSourceObject> const&)>;
 
+// Type-erased function object to compose a group of finished shards into the
+// temporary object for group number `group`.
+using GroupComposer = std::function<StatusOr<ObjectMetadata>(
+    std::size_t group, std::vector<ComposeSourceObject> const&)>;
+
+/**
+ * The number of consecutive shards composed into a temporary object while the
+ * upload is still in progress.
+ *
+ * This matches the maximum number of source objects in a compose request.
+ */
+std::size_t constexpr kParallelUploadComposeGroupSize = 32;
+
 struct ParallelUploadPersistentState {
   struct Stream {
     std::string object_name;
@@ -155,7 +144,8 @@ class ParallelUploadStateImpl
                           std::string destination_object_name,
                           std::int64_t expected_generation,
                           std::shared_ptr<ScopedDeleter> deleter,
-                          Composer composer);
+                          Composer composer,
+                          GroupComposer group_composer = {});
   ~ParallelUploadStateImpl();
 
   StatusOr<ObjectWriteStream> CreateStream(
@@ -173,6 +163,15 @@ class ParallelUploadStateImpl
 
   void Fail(Status status);
 
+  /**
+   * Record the CRC32C checksum of the data uploaded via a stream.
+   *
+   * If all the streams report their checksum, the checksum of the composed
+   * object is verified against the combination of the stream checksums.
+   */
+  void SetStreamCrc32c(std::size_t stream_idx, std::uint32_t crc32c,
+                       std::uintmax_t size);
+
   ParallelUploadPersistentState ToPersistentState() const;
 
   std::string custom_data() const {
@@ -213,8 +212,16 @@ class ParallelUploadStateImpl
     std::string resumable_session_id;
     absl::optional<ComposeSourceObject> composition_arg;
     bool finished;
+    absl::optional<std::uint32_t> crc32c;
+    std::uintmax_t size;
   };
 
+  void MaybeComposeGroup(std::unique_lock<std::mutex>& lk,
+                         std::size_t stream_idx);
+
+  // Verify the checksum of the composed object, must be called with `mu_` held.
+  Status VerifyCrc32c(ObjectMetadata const& metadata) const;
+
   mutable std::mutex mu_;
   // Promises made via `WaitForCompletion()`
   mutable std::vector<promise<StatusOr<ObjectMetadata>>> res_promises_;
@@ -224,6 +231,11 @@ class ParallelUploadStateImpl
   // bound.
   std::function<StatusOr<ObjectMetadata>(std::vector<ComposeSourceObject>)>
       composer_;
+  // Composes groups of shards while other shards are still being uploaded, so
+  // only a small final composition remains after the last shard finishes.
+  GroupComposer group_composer_;
+  // The temporary objects for each group, set once the group is composed.
+  std::vector<absl::optional<ComposeSourceObject>> groups_;
   std::string destination_object_name_;
   std::int64_t expected_generation_;
   // Set when all streams are closed and composed but before cleanup.
@@ -252,6 +264,29 @@ struct ComposeManyApplyHelper {
   std::string destination_object_name;
 };
 
+/**
+ * Create a `GroupComposer` for the temporary objects of a parallel upload.
+ *
+ * The parallel uploads compose each group of shards into an object named
+ * `<prefix>.compose_group_<group>`.
+ */
+template <typename... Options>
+GroupComposer CreateParallelUploadGroupComposer(
+    Client client, std::string bucket_name, std::string prefix,
+    std::tuple<Options...> const& options) {
+  auto compose_options = StaticTupleFilter<
+      Among<DestinationPredefinedAcl, EncryptionKey, KmsKeyName, QuotaUser,
+            UserIp, UserProject, WithObjectMetadata>::TPred>(options);
+  return [client, bucket_name, prefix, compose_options](
+             std::size_t group,
+             std::vector<ComposeSourceObject> const& sources) mutable {
+    return google::cloud::internal::apply(
+        ComposeApplyHelper{client, bucket_name, sources,
+                           prefix + ".compose_group_" + std::to_string(group)},
+        compose_options);
+  };
+}
+
 class SetOptionsApplyHelper {
  public:
   // NOLINTNEXTLINE(google-explicit-constructor)
@@ -352,24 +387,28 @@ class ParallelUploadFileShard {
  private:
   friend struct CreateParallelUploadShards;
   ParallelUploadFileShard(std::shared_ptr<ParallelUploadStateImpl> state,
-                          ObjectWriteStream ostream, std::string file_name,
-                          std::uintmax_t offset_in_file,
+                          std::size_t stream_idx, ObjectWriteStream ostream,
+                          std::string file_name, std::uintmax_t offset_in_file,
                           std::uintmax_t bytes_to_upload,
-                          std::size_t upload_buffer_size)
+                          std::size_t upload_buffer_size, bool compute_crc32c)
       : state_(std::move(state)),
+        stream_idx_(stream_idx),
         ostream_(std::move(ostream)),
         file_name_(std::move(file_name)),
         offset_in_file_(offset_in_file),
         left_to_upload_(bytes_to_upload),
         upload_buffer_size_(upload_buffer_size),
+        compute_crc32c_(compute_crc32c),
         resumable_session_id_(state_->resumable_session_id()) {}
 
   std::shared_ptr<ParallelUploadStateImpl> state_;
+  std::size_t stream_idx_;
   ObjectWriteStream ostream_;
   std::string file_name_;
   std::uintmax_t offset_in_file_;
   std::uintmax_t left_to_upload_;
   std::size_t upload_buffer_size_;
+  bool compute_crc32c_;
   std::string resumable_session_id_;
 };
 
@@ -384,6 +423,11 @@ class ParallelUploadFileShard {
  * them (via `ComposeMany`) into the destination object and set the value in
  * `future`s returned by `WaitForCompletion`.
  *
+ * To reduce the work left after the last stream is closed, each group of 32
+ * consecutive streams is composed into a temporary object as soon as all the
+ * streams in the group are `Close`d. The `Close()` call on the last stream of
+ * each group blocks until this composition completes.
+ *
  * Parallel upload will create temporary files. Upon completion of the whole
  * operation, this class will attempt to remove them in its destructor, but if
  * they fail, they fail silently. In order to proactively cleanup these files,
@@ -469,6 +513,11 @@ class NonResumableParallelUploadState {
  * them (via `ComposeMany`) into the destination object and set the value in
  * `future`s returned by `WaitForCompletion`.
  *
+ * To reduce the work left after the last stream is closed, each group of 32
+ * consecutive streams is composed into a temporary object as soon as all the
+ * streams in the group are `Close`d. The `Close()` call on the last stream of
+ * each group blocks until this composition completes.
+ *
  * Parallel upload will create temporary files. Upon successful completion of
  * the whole operation, this class will attempt to remove them in its
  * destructor, but if they fail, they fail silently. In order to proactively
@@ -695,7 +744,8 @@ NonResumableParallelUploadState::Create(Client client,
   deleter->Add(*lock);
 
   auto internal_state = std::make_shared<ParallelUploadStateImpl>(
-      true, object_name, 0, std::move(deleter), std::move(composer));
+      true, object_name, 0, std::move(deleter), std::move(composer),
+      CreateParallelUploadGroupComposer(client, bucket_name, prefix, options));
   std::vector<ObjectWriteStream> streams;
 
   auto upload_options = StaticTupleFilter<
@@ -798,7 +848,8 @@ StatusOr<ResumableParallelUploadState> ResumableParallelUploadState::CreateNew(
   auto composer = CreateComposer(client, bucket_name, object_name,
                                  expected_generation, prefix, options);
   auto internal_state = std::make_shared<ParallelUploadStateImpl>(
-      false, object_name, expected_generation, deleter, std::move(composer));
+      false, object_name, expected_generation, deleter, std::move(composer),
+      CreateParallelUploadGroupComposer(client, bucket_name, prefix, options));
   internal_state->set_custom_data(std::move(extra_state));
 
   std::vector<ObjectWriteStream> streams;
@@ -902,7 +953,8 @@ StatusOr<ResumableParallelUploadState> ResumableParallelUploadState::Resume(
                      persistent_state->expected_generation, prefix, options);
   auto internal_state = std::make_shared<ParallelUploadStateImpl>(
       false, object_name, persistent_state->expected_generation, deleter,
-      std::move(composer));
+      std::move(composer),
+      CreateParallelUploadGroupComposer(client, bucket_name, prefix, options));
   internal_state->set_custom_data(std::move(persistent_state->custom_data));
   internal_state->set_resumable_session_id(resumable_session_id);
   // If a resumed stream is already finalized, callbacks from streams will be
@@ -1062,6 +1114,10 @@ struct CreateParallelUploadShards {
     auto upload_options =
         StaticTupleFilter<NotAmong<MaxStreams, MinStreamSize>::TPred>(
             std::tie(options...));
+    auto disable_crc32c = ExtractFirstOccurenceOfType<DisableCrc32cChecksum>(
+        std::tie(options...));
+    bool const compute_crc32c =
+        !disable_crc32c || !disable_crc32c->value_or(false);
 
     std::vector<uintmax_t> file_split_points;
     std::size_t num_shards = 0;
@@ -1106,9 +1162,11 @@ struct CreateParallelUploadShards {
     std::size_t shard_idx = 0;
     for (auto shard_end : file_split_points) {
       res.emplace_back(ParallelUploadFileShard(
-          state->impl_, std::move(state->shards()[shard_idx++]), file_name,
-          offset, shard_end - offset, upload_buffer_size));
+          state->impl_, shard_idx, std::move(state->shards()[shard_idx]),
+          file_name, offset, shard_end - offset, upload_buffer_size,
+          compute_crc32c));
       offset = shard_end;
+      ++shard_idx;
     }
 #if defined(__clang__) && \
     (__clang_major__ < 4 || (__clang_major__ == 3 && __clang_minor__ <= 8))
@@ -1121,6 +1179,35 @@ struct CreateParallelUploadShards {
   }
 };
 
+/**
+ * A source of data for `ParallelUploadStream()`.
+ *
+ * Each call should copy up to `size` bytes into `buffer`, and return the number
+ * of bytes copied. Return 0 at the end of the data, or an error to abort the
+ * upload.
+ */
+using ParallelUploadDataSource =
+    std::function<StatusOr<std::size_t>(char* buffer, std::size_t size)>;
+
+/// The type-erased operations used by `ParallelUploadStreamImpl()`.
+struct ParallelUploadStreamOperations {
+  // Upload the data for part number `part` into a temporary object.
+  std::function<StatusOr<ObjectMetadata>(std::size_t part,
+                                         std::string contents)>
+      upload_part;
+  GroupComposer compose_group;
+  Composer compose;
+  std::shared_ptr<ScopedDeleter> deleter;
+};
+
+/**
+ * Upload the data from @p source as parts of @p part_size bytes, using
+ * @p num_streams concurrent uploads, and compose them in order.
+ */
+StatusOr<ObjectMetadata> ParallelUploadStreamImpl(
+    ParallelUploadDataSource const& source, std::size_t num_streams,
+    std::size_t part_size, ParallelUploadStreamOperations const& operations);
+
 /// @copydoc CreateParallelUploadShards::Create()
 template <typename... Options>
 StatusOr<std::vector<ParallelUploadFileShard>> CreateUploadShards(
@@ -1140,6 +1227,12 @@ StatusOr<std::vector<ParallelUploadFileShard>> CreateUploadShards(
  * You can affect how many shards will be created by using the `MaxStreams` and
  * `MinStreamSize` options.
  *
+ * Each shard computes the CRC32C checksum of its data while uploading it. The
+ * checksums are combined, in shard order, and compared against the checksum of
+ * the composed object, so the upload is verified end-to-end without reading
+ * the file a second time. A mismatch is reported as a `kDataLoss` error, use
+ * `DisableCrc32cChecksum(true)` to skip this validation.
+ *
  * @param client the client on which to perform the operation.
  * @param file_name the path to the file to be uploaded
  * @param bucket_name the name of the bucket that will contain the object.
@@ -1196,6 +1289,137 @@ StatusOr<ObjectMetadata> ParallelUploadFile(
   return res;
 }
 
+/**
+ * Perform a parallel upload of data generated by @p source.
+ *
+ * Use this function when the size of the data is not known in advance, for
+ * example, when the data is generated on the fly. The data is read in order,
+ * in parts of `MinStreamSize` bytes (16 MiB by default). Up to `MaxStreams`
+ * parts (8 by default) are uploaded concurrently as temporary objects, which
+ * are then composed into the destination object. Note that each concurrent
+ * upload holds a full part in memory.
+ *
+ * @param client the client on which to perform the operation.
+ * @param source the function to generate the data, see
+ *     `internal::ParallelUploadDataSource` for details.
+ * @param bucket_name the name of the bucket that will contain the object.
+ * @param object_name the uploaded object name.
+ * @param prefix the prefix with which temporary objects will be created.
+ * @param ignore_cleanup_failures treat failures to cleanup the temporary
+ *     objects as not fatal.
+ * @param options a list of optional query parameters and/or request headers.
+ *     Valid types for this operation include `ContentEncoding`, `ContentType`,
+ *     `DestinationPredefinedAcl`, `DisableCrc32cChecksum`, `DisableMD5Hash`,
+ *     `EncryptionKey`, `IfGenerationMatch`, `IfMetagenerationMatch`,
+ *     `KmsKeyName`, `MaxStreams, `MinStreamSize`, `PredefinedAcl`,
+ *     `QuotaUser`, `UserIp`, `UserProject`, `WithObjectMetadata`.
+ *
+ * @return the metadata of the object created by the upload.
+ *
+ * @par Idempotency
+ * This operation is not idempotent. While each request performed by this
+ * function is retried based on the client policies, the operation itself stops
+ * on the first request that fails.
+ */
+template <typename... Options>
+StatusOr<ObjectMetadata> ParallelUploadStream(
+    Client client, internal::ParallelUploadDataSource const& source,
+    std::string const& bucket_name, std::string const& object_name,
+    std::string const& prefix, bool ignore_cleanup_failures,
+    Options&&... options) {
+  using internal::Among;
+  using internal::StaticTupleFilter;
+  auto all_options = std::make_tuple(options...);
+
+  auto const num_streams = (std::max<std::size_t>)(
+      1, internal::ExtractFirstOccurenceOfType<MaxStreams>(all_options)
+             .value_or(MaxStreams(8))
+             .value());
+  auto const part_size = static_cast<std::size_t>((std::max<std::uintmax_t>)(
+      1, internal::ExtractFirstOccurenceOfType<MinStreamSize>(all_options)
+             .value_or(MinStreamSize(16 * 1024 * 1024))
+             .value()));
+
+  auto delete_options =
+      StaticTupleFilter<Among<QuotaUser, UserProject, UserIp>::TPred>(
+          all_options);
+  auto deleter = std::make_shared<internal::ScopedDeleter>(
+      [&client, &bucket_name, &delete_options](std::string const& name,
+                                               std::int64_t generation) {
+        return google::cloud::internal::apply(
+            internal::DeleteApplyHelper{client, bucket_name, name},
+            std::tuple_cat(std::make_tuple(IfGenerationMatch(generation)),
+                           delete_options));
+      });
+  auto lock = internal::LockPrefix(client, bucket_name, prefix, options...);
+  if (!lock) {
+    return Status(lock.status().code(),
+                  "Failed to lock prefix for ParallelUploadStream: " +
+                      lock.status().message());
+  }
+  deleter->Add(*lock);
+
+  auto upload_options = StaticTupleFilter<
+      Among<ContentEncoding, ContentType, DisableCrc32cChecksum, DisableMD5Hash,
+            EncryptionKey, KmsKeyName, PredefinedAcl, UserProject,
+            WithObjectMetadata>::TPred>(all_options);
+  auto compose_options = StaticTupleFilter<
+      Among<DestinationPredefinedAcl, EncryptionKey, IfGenerationMatch,
+            IfMetagenerationMatch, KmsKeyName, QuotaUser, UserIp, UserProject,
+            WithObjectMetadata>::TPred>(all_options);
+
+  internal::ParallelUploadStreamOperations operations;
+  operations.upload_part = [&](std::size_t part, std::string contents) {
+    auto const name = prefix + ".upload_part_" + std::to_string(part);
+    return google::cloud::internal::apply(
+        internal::InsertObjectApplyHelper{client, bucket_name, name,
+                                          std::move(contents)},
+        upload_options);
+  };
+  operations.compose_group = internal::CreateParallelUploadGroupComposer(
+      client, bucket_name, prefix, all_options);
+  operations.compose = [&](std::vector<ComposeSourceObject> const& sources) {
+    return google::cloud::internal::apply(
+        internal::ComposeManyApplyHelper{client, bucket_name, sources,
+                                         prefix + ".compose_many",
+                                         object_name},
+        compose_options);
+  };
+  operations.deleter = deleter;
+
+  auto res = internal::ParallelUploadStreamImpl(source, num_streams, part_size,
+                                                operations);
+  auto cleanup_res = deleter->ExecuteDelete();
+  if (!res) return res;
+  if (!cleanup_res.ok() && !ignore_cleanup_failures) return cleanup_res;
+  return res;
+}
+
+/**
+ * Perform a parallel upload of the data read from @p source.
+ *
+ * This overload reads @p source until its end, see the previous overload for
+ * the details.
+ */
+template <typename... Options>
+StatusOr<ObjectMetadata> ParallelUploadStream(
+    Client client, std::istream& source, std::string const& bucket_name,
+    std::string const& object_name, std::string const& prefix,
+    bool ignore_cleanup_failures, Options&&... options) {
+  auto read = [&source](char* buffer,
+                        std::size_t size) -> StatusOr<std::size_t> {
+    source.read(buffer, static_cast<std::streamsize>(size));
+    if (source.bad()) {
+      return Status(StatusCode::kInternal,
+                    "ParallelUploadStream(): cannot read from source stream");
+    }
+    return static_cast<std::size_t>(source.gcount());
+  };
+  return ParallelUploadStream(std::move(client), read, bucket_name,
+                              object_name, prefix, ignore_cleanup_failures,
+                              std::forward<Options>(options)...);
+}
+
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
 }  // namespace cloud
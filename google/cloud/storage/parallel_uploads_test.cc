@@ -14,6 +14,7 @@
 
 #include "google/cloud/storage/internal/bucket_metadata_parser.h"
 #include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/internal/openssl_util.h"
 #include "google/cloud/storage/oauth2/google_credentials.h"
 #include "google/cloud/storage/parallel_upload.h"
 #include "google/cloud/storage/retry_policy.h"
@@ -22,11 +23,15 @@
 #include "google/cloud/storage/testing/random_names.h"
 #include "google/cloud/storage/testing/retry_tests.h"
 #include "google/cloud/storage/testing/temp_file.h"
+#include "google/cloud/internal/big_endian.h"
 #include "google/cloud/testing_util/assert_ok.h"
 #include "google/cloud/testing_util/chrono_literals.h"
 #include "google/cloud/testing_util/status_matchers.h"
+#include <crc32c/crc32c.h>
 #include <gmock/gmock.h>
 #include <cstdio>
+#include <cstring>
+#include <sstream>
 #include <stack>
 #ifdef __linux__
 #include <sys/stat.h>
@@ -67,12 +72,18 @@ std::string ObjectId(std::string const& bucket, std::string const& object,
   return bucket + "/" + object + "/" + std::to_string(generation);
 }
 
-ObjectMetadata MockObject(std::string const& object_name, int generation) {
+std::string Crc32c(std::string const& contents) {
+  return Base64Encode(
+      google::cloud::internal::EncodeBigEndian(crc32c::Crc32c(contents)));
+}
+
+ObjectMetadata MockObject(std::string const& object_name, int generation,
+                          std::string const& crc32c = "d1e2f3") {
   auto metadata = internal::ObjectMetadataParser::FromJson(nlohmann::json{
       {"contentDisposition", "a-disposition"},
       {"contentLanguage", "a-language"},
       {"contentType", "application/octet-stream"},
-      {"crc32c", "d1e2f3"},
+      {"crc32c", crc32c},
       {"etag", "XYZ="},
       {"kind", "storage#object"},
       {"md5Hash", "xa1b2c3=="},
@@ -433,6 +444,71 @@ TEST_F(ParallelUploadTest, Success) {
   EXPECT_STATUS_OK(state->EagerCleanup());
 }
 
+TEST_F(ParallelUploadTest, ComposesGroupsBeforeLastShard) {
+  auto const group_size = static_cast<int>(kParallelUploadComposeGroupSize);
+  int const num_shards = group_size + 1;
+  auto shard_name = [](int i) {
+    return kPrefix + ".upload_shard_" + std::to_string(i);
+  };
+  auto const group_name = kPrefix + ".compose_group_0";
+  int const group_generation = 999;
+  // The expectations need to be reversed.
+  for (int i = num_shards - 1; i >= 0; --i) {
+    ExpectCreateSession(shard_name(i), 1000 + i);
+  }
+
+  std::vector<std::pair<std::string, int>> group_sources;
+  std::map<std::pair<std::string, std::int64_t>, Status> expected_deletions{
+      {{kPrefix, kUploadMarkerGeneration}, Status()},
+      {{kPrefix + ".compose_many", kComposeMarkerGeneration}, Status()},
+      {{group_name, group_generation}, Status()},
+  };
+  for (int i = 0; i != num_shards; ++i) {
+    if (i < group_size) group_sources.emplace_back(shard_name(i), 1000 + i);
+    expected_deletions.emplace(std::make_pair(shard_name(i), 1000 + i),
+                               Status());
+  }
+
+  EXPECT_CALL(*raw_client_mock_, InsertObjectMedia(_))
+      .WillOnce(expect_new_object(kPrefix, kUploadMarkerGeneration))
+      .WillOnce(expect_new_object(kPrefix + ".compose_many",
+                                  kComposeMarkerGeneration));
+  bool group_composed = false;
+  auto group_check = create_composition_check(
+      group_sources, group_name, MockObject(group_name, group_generation));
+  EXPECT_CALL(*raw_client_mock_, ComposeObject(_))
+      .WillOnce([&](internal::ComposeObjectRequest const& r) {
+        group_composed = true;
+        return group_check(r);
+      })
+      .WillOnce(create_composition_check(
+          {{group_name, group_generation},
+           {shard_name(group_size), 1000 + group_size}},
+          kDestObjectName, MockObject(kDestObjectName, kDestGeneration)));
+
+  ExpectedDeletions deletions(std::move(expected_deletions));
+  EXPECT_CALL(*raw_client_mock_, DeleteObject(_))
+      .Times(num_shards + 3)
+      .WillRepeatedly([&deletions](internal::DeleteObjectRequest const& r) {
+        return deletions(r);
+      });
+
+  auto state = PrepareParallelUpload(*client_, kBucketName, kDestObjectName,
+                                     num_shards, kPrefix);
+  ASSERT_STATUS_OK(state);
+  auto res_future = state->WaitForCompletion();
+  for (int i = 0; i != group_size; ++i) state->shards()[i].Close();
+  // The first group is composed before the last shard finishes.
+  EXPECT_TRUE(group_composed);
+  EXPECT_TRUE(Unsatisfied(res_future));
+
+  state->shards().clear();
+  auto res = res_future.get();
+  ASSERT_STATUS_OK(res);
+  EXPECT_EQ(kDestObjectName, res->name());
+  EXPECT_STATUS_OK(state->EagerCleanup());
+}
+
 TEST_F(ParallelUploadTest, OneStreamFailsUponCration) {
   int const num_shards = 3;
   // The expectations need to be reversed.
@@ -583,7 +659,8 @@ TEST_F(ParallelUploadTest, FileSuccessWithMaxStreamsNotReached) {
           {{kPrefix + ".upload_shard_0", 111},
            {kPrefix + ".upload_shard_1", 222},
            {kPrefix + ".upload_shard_2", 333}},
-          kDestObjectName, MockObject(kDestObjectName, kDestGeneration)));
+          kDestObjectName,
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abc"))));
 
   ExpectedDeletions deletions({{{kPrefix + ".upload_shard_0", 111}, Status()},
                                {{kPrefix + ".upload_shard_1", 222}, Status()},
@@ -637,7 +714,8 @@ TEST_F(ParallelUploadTest, FileSuccessWithMaxStreamsReached) {
       .WillOnce(create_composition_check(
           {{kPrefix + ".upload_shard_0", 111},
            {kPrefix + ".upload_shard_1", 222}},
-          kDestObjectName, MockObject(kDestObjectName, kDestGeneration)));
+          kDestObjectName,
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abc"))));
 
   ExpectedDeletions deletions({{{kPrefix + ".upload_shard_0", 111}, Status()},
                                {{kPrefix + ".upload_shard_1", 222}, Status()}});
@@ -685,7 +763,7 @@ TEST_F(ParallelUploadTest, FileSuccessWithEmptyFile) {
   EXPECT_CALL(*raw_client_mock_, ComposeObject(_))
       .WillOnce(create_composition_check(
           {{kPrefix + ".upload_shard_0", 111}}, kDestObjectName,
-          MockObject(kDestObjectName, kDestGeneration)));
+          MockObject(kDestObjectName, kDestGeneration, Crc32c(""))));
 
   ExpectedDeletions deletions({{{kPrefix + ".upload_shard_0", 111}, Status()}});
   EXPECT_CALL(*raw_client_mock_, DeleteObject(_))
@@ -903,7 +981,8 @@ TEST_F(ParallelUploadTest, FileSuccessBasic) {
           {{kPrefix + ".upload_shard_0", 111},
            {kPrefix + ".upload_shard_1", 222},
            {kPrefix + ".upload_shard_2", 333}},
-          kDestObjectName, MockObject(kDestObjectName, kDestGeneration)));
+          kDestObjectName,
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abc"))));
 
   ExpectedDeletions deletions({{{kPrefix + ".upload_shard_0", 111}, Status()},
                                {{kPrefix + ".upload_shard_1", 222}, Status()},
@@ -930,6 +1009,93 @@ TEST_F(ParallelUploadTest, FileSuccessBasic) {
   EXPECT_EQ(kBucketName, res->bucket());
 }
 
+TEST_F(ParallelUploadTest, FileCrc32cMismatch) {
+  // The expectations need to be reversed.
+  ExpectCreateSession(kPrefix + ".upload_shard_2", 333, "c");
+  ExpectCreateSession(kPrefix + ".upload_shard_1", 222, "b");
+  ExpectCreateSession(kPrefix + ".upload_shard_0", 111, "a");
+
+  testing::TempFile temp_file("abc");
+
+  EXPECT_CALL(*raw_client_mock_, InsertObjectMedia(_))
+      .WillOnce(expect_new_object(kPrefix, kUploadMarkerGeneration))
+      .WillOnce(expect_new_object(kPrefix + ".compose_many",
+                                  kComposeMarkerGeneration));
+  EXPECT_CALL(*raw_client_mock_, ComposeObject(_))
+      .WillOnce(create_composition_check(
+          {{kPrefix + ".upload_shard_0", 111},
+           {kPrefix + ".upload_shard_1", 222},
+           {kPrefix + ".upload_shard_2", 333}},
+          kDestObjectName,
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abd"))));
+
+  ExpectedDeletions deletions({{{kPrefix + ".upload_shard_0", 111}, Status()},
+                               {{kPrefix + ".upload_shard_1", 222}, Status()},
+                               {{kPrefix + ".upload_shard_2", 333}, Status()}});
+  EXPECT_CALL(*raw_client_mock_, DeleteObject(_))
+      .WillOnce(
+          expect_deletion(kPrefix + ".compose_many", kComposeMarkerGeneration))
+      .WillOnce([&deletions](internal::DeleteObjectRequest const& r) {
+        return deletions(r);
+      })
+      .WillOnce([&deletions](internal::DeleteObjectRequest const& r) {
+        return deletions(r);
+      })
+      .WillOnce([&deletions](internal::DeleteObjectRequest const& r) {
+        return deletions(r);
+      })
+      .WillOnce(expect_deletion(kPrefix, kUploadMarkerGeneration));
+
+  auto res =
+      ParallelUploadFile(*client_, temp_file.name(), kBucketName,
+                         kDestObjectName, kPrefix, false, MinStreamSize(1));
+  EXPECT_THAT(res, StatusIs(StatusCode::kDataLoss,
+                            HasSubstr("computed=" + Crc32c("abc"))));
+}
+
+TEST_F(ParallelUploadTest, FileCrc32cDisabled) {
+  // The expectations need to be reversed.
+  ExpectCreateSession(kPrefix + ".upload_shard_2", 333, "c");
+  ExpectCreateSession(kPrefix + ".upload_shard_1", 222, "b");
+  ExpectCreateSession(kPrefix + ".upload_shard_0", 111, "a");
+
+  testing::TempFile temp_file("abc");
+
+  EXPECT_CALL(*raw_client_mock_, InsertObjectMedia(_))
+      .WillOnce(expect_new_object(kPrefix, kUploadMarkerGeneration))
+      .WillOnce(expect_new_object(kPrefix + ".compose_many",
+                                  kComposeMarkerGeneration));
+  EXPECT_CALL(*raw_client_mock_, ComposeObject(_))
+      .WillOnce(create_composition_check(
+          {{kPrefix + ".upload_shard_0", 111},
+           {kPrefix + ".upload_shard_1", 222},
+           {kPrefix + ".upload_shard_2", 333}},
+          kDestObjectName,
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abd"))));
+
+  ExpectedDeletions deletions({{{kPrefix + ".upload_shard_0", 111}, Status()},
+                               {{kPrefix + ".upload_shard_1", 222}, Status()},
+                               {{kPrefix + ".upload_shard_2", 333}, Status()}});
+  EXPECT_CALL(*raw_client_mock_, DeleteObject(_))
+      .WillOnce(
+          expect_deletion(kPrefix + ".compose_many", kComposeMarkerGeneration))
+      .WillOnce([&deletions](internal::DeleteObjectRequest const& r) {
+        return deletions(r);
+      })
+      .WillOnce([&deletions](internal::DeleteObjectRequest const& r) {
+        return deletions(r);
+      })
+      .WillOnce([&deletions](internal::DeleteObjectRequest const& r) {
+        return deletions(r);
+      })
+      .WillOnce(expect_deletion(kPrefix, kUploadMarkerGeneration));
+
+  auto res = ParallelUploadFile(*client_, temp_file.name(), kBucketName,
+                                kDestObjectName, kPrefix, false,
+                                MinStreamSize(1), DisableCrc32cChecksum(true));
+  EXPECT_STATUS_OK(res);
+}
+
 TEST_F(ParallelUploadTest, UploadNonExistentFile) {
   auto res =
       ParallelUploadFile(*client_, "nonexistent", kBucketName, kDestObjectName,
@@ -948,7 +1114,7 @@ TEST_F(ParallelUploadTest, CleanupFailureIsIgnored) {
   EXPECT_CALL(*raw_client_mock_, ComposeObject(_))
       .WillOnce(create_composition_check(
           {{kPrefix + ".upload_shard_0", 111}}, kDestObjectName,
-          MockObject(kDestObjectName, kDestGeneration)));
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abc"))));
 
   ExpectedDeletions deletions(
       {{{kPrefix + ".upload_shard_0", 111}, PermanentError()}});
@@ -977,7 +1143,7 @@ TEST_F(ParallelUploadTest, CleanupFailureIsNotIgnored) {
   EXPECT_CALL(*raw_client_mock_, ComposeObject(_))
       .WillOnce(create_composition_check(
           {{kPrefix + ".upload_shard_0", 111}}, kDestObjectName,
-          MockObject(kDestObjectName, kDestGeneration)));
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abc"))));
 
   ExpectedDeletions deletions(
       {{{kPrefix + ".upload_shard_0", 111}, PermanentError()}});
@@ -995,6 +1161,83 @@ TEST_F(ParallelUploadTest, CleanupFailureIsNotIgnored) {
   ASSERT_FALSE(object_metadata);
 }
 
+TEST_F(ParallelUploadTest, StreamSuccess) {
+  auto part_name = [](int i) {
+    return kPrefix + ".upload_part_" + std::to_string(i);
+  };
+  std::vector<std::string> const expected_parts{"0123", "4567", "89"};
+  EXPECT_CALL(*raw_client_mock_, InsertObjectMedia(_))
+      .Times(5)
+      .WillRepeatedly([&](internal::InsertObjectMediaRequest const& request) {
+        EXPECT_EQ(kBucketName, request.bucket_name());
+        auto const& name = request.object_name();
+        if (name == kPrefix) {
+          return make_status_or(MockObject(name, kUploadMarkerGeneration));
+        }
+        if (name == kPrefix + ".compose_many") {
+          return make_status_or(MockObject(name, kComposeMarkerGeneration));
+        }
+        for (int i = 0; i != 3; ++i) {
+          if (name != part_name(i)) continue;
+          EXPECT_EQ(expected_parts[i], request.contents());
+          return make_status_or(MockObject(name, 100 + i));
+        }
+        ADD_FAILURE() << "unexpected object " << name;
+        return StatusOr<ObjectMetadata>(PermanentError());
+      });
+  EXPECT_CALL(*raw_client_mock_, ComposeObject(_))
+      .WillOnce(create_composition_check(
+          {{part_name(0), 100}, {part_name(1), 101}, {part_name(2), 102}},
+          kDestObjectName, MockObject(kDestObjectName, kDestGeneration)));
+
+  ExpectedDeletions deletions(
+      {{{kPrefix, kUploadMarkerGeneration}, Status()},
+       {{kPrefix + ".compose_many", kComposeMarkerGeneration}, Status()},
+       {{part_name(0), 100}, Status()},
+       {{part_name(1), 101}, Status()},
+       {{part_name(2), 102}, Status()}});
+  EXPECT_CALL(*raw_client_mock_, DeleteObject(_))
+      .Times(5)
+      .WillRepeatedly([&deletions](internal::DeleteObjectRequest const& r) {
+        return deletions(r);
+      });
+
+  std::istringstream source("0123456789");
+  auto res = ParallelUploadStream(*client_, source, kBucketName,
+                                  kDestObjectName, kPrefix, false,
+                                  MaxStreams(2), MinStreamSize(4));
+  ASSERT_STATUS_OK(res);
+  EXPECT_EQ(kDestObjectName, res->name());
+}
+
+TEST_F(ParallelUploadTest, StreamSourceFails) {
+  auto const part_name = kPrefix + ".upload_part_0";
+  EXPECT_CALL(*raw_client_mock_, InsertObjectMedia(_))
+      .WillOnce(expect_new_object(kPrefix, kUploadMarkerGeneration))
+      .WillOnce([&](internal::InsertObjectMediaRequest const& request) {
+        EXPECT_EQ(part_name, request.object_name());
+        EXPECT_EQ("0123", request.contents());
+        return make_status_or(MockObject(part_name, 100));
+      });
+  EXPECT_CALL(*raw_client_mock_, ComposeObject(_)).Times(0);
+  EXPECT_CALL(*raw_client_mock_, DeleteObject(_))
+      .WillOnce(expect_deletion(part_name, 100))
+      .WillOnce(expect_deletion(kPrefix, kUploadMarkerGeneration));
+
+  int calls = 0;
+  auto source = [&calls](char* buffer,
+                         std::size_t size) -> StatusOr<std::size_t> {
+    if (calls++ != 0) return PermanentError();
+    EXPECT_EQ(4, size);
+    std::memcpy(buffer, "0123", 4);
+    return 4;
+  };
+  auto res =
+      ParallelUploadStream(*client_, source, kBucketName, kDestObjectName,
+                           kPrefix, false, MaxStreams(1), MinStreamSize(4));
+  EXPECT_THAT(res, StatusIs(PermanentError().code()));
+}
+
 TEST(ParallelUploadPersistentState, NotJson) {
   auto res = ParallelUploadPersistentState::FromString("blah");
   EXPECT_THAT(res,
@@ -1649,7 +1892,8 @@ TEST_F(ParallelUploadTest, ResumableUploadFileShards) {
           {{kPrefix + ".upload_shard_0", 111},
            {kPrefix + ".upload_shard_1", 222},
            {kPrefix + ".upload_shard_2", 333}},
-          kDestObjectName, MockObject(kDestObjectName, kDestGeneration)));
+          kDestObjectName,
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abc"))));
 
   ExpectedDeletions deletions({{{kPrefix + ".upload_shard_0", 111}, Status()},
                                {{kPrefix + ".upload_shard_1", 222}, Status()},
@@ -1761,7 +2005,8 @@ TEST_F(ParallelUploadTest, SuspendUploadFileResume) {
           {{kPrefix + ".upload_shard_0", 111},
            {kPrefix + ".upload_shard_1", 222},
            {kPrefix + ".upload_shard_2", 333}},
-          kDestObjectName, MockObject(kDestObjectName, kDestGeneration)));
+          kDestObjectName,
+          MockObject(kDestObjectName, kDestGeneration, Crc32c("abcdefghi"))));
   EXPECT_CALL(*raw_client_mock_, ReadObject(_))
       .WillOnce(create_state_read_expectation(
           kPersistentStateName, kPersistentStateGeneration, state_json));
@@ -0,0 +1,153 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_RATE_LIMITER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_RATE_LIMITER_H
+
+#include "google/cloud/storage/version.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * Limits the rate of requests and bytes sent to (or received from) GCS.
+ *
+ * Applications running many workers on the same host can share a single rate
+ * limiter across all their `Client` objects, via
+ * `ClientOptions::set_rate_limiter()`, to keep their aggregate traffic below
+ * the capacity of the host network.
+ *
+ * The client consults the rate limiter before each attempt of each request,
+ * and before sending or after receiving each block of data in uploads and
+ * downloads. The rate limiter returns how long the client must wait, this
+ * makes the rate limiter easy to test and to compose. It is also notified when
+ * the service rejects a request because it is overloaded (HTTP 429 or 503), so
+ * it can reduce the rate until the service recovers.
+ *
+ * Implementations must be thread-safe, the rate limiter is used by many
+ * requests concurrently.
+ */
+class RateLimiter {
+ public:
+  virtual ~RateLimiter() = default;
+
+  /**
+   * Reserve capacity for one request to @p bucket.
+   *
+   * @return how long the caller must wait before sending the request.
+   */
+  virtual std::chrono::microseconds ReserveRequest(
+      std::string const& bucket) = 0;
+
+  /**
+   * Reserve capacity to transfer @p bytes to (or from) @p bucket.
+   *
+   * @return how long the caller must wait before (or after) the transfer.
+   */
+  virtual std::chrono::microseconds ReserveBytes(std::string const& bucket,
+                                                 std::uint64_t bytes) = 0;
+
+  /// Called when the service rejects a request to @p bucket as overloaded.
+  virtual void OnThrottled(std::string const& bucket) = 0;
+};
+
+/// Configure the rate limiters created by `MakeTokenBucketRateLimiter()`.
+class TokenBucketRateLimiterOptions {
+ public:
+  TokenBucketRateLimiterOptions() = default;
+
+  /// The maximum number of requests per second. The default (0) is unlimited.
+  double requests_per_second() const { return requests_per_second_; }
+  TokenBucketRateLimiterOptions& set_requests_per_second(double v) {
+    requests_per_second_ = v;
+    return *this;
+  }
+
+  /// The maximum number of bytes per second. The default (0) is unlimited.
+  double bytes_per_second() const { return bytes_per_second_; }
+  TokenBucketRateLimiterOptions& set_bytes_per_second(double v) {
+    bytes_per_second_ = v;
+    return *this;
+  }
+
+  /**
+   * Apply the limits to each bucket separately.
+   *
+   * By default the limits apply to the aggregate traffic to all buckets.
+   * Requests that are not associated with a single bucket, such as
+   * `CopyObject()` or `ListHmacKeys()`, share a separate limit.
+   */
+  bool per_bucket() const { return per_bucket_; }
+  TokenBucketRateLimiterOptions& set_per_bucket(bool v) {
+    per_bucket_ = v;
+    return *this;
+  }
+
+  /**
+   * How much unused capacity can be accumulated.
+   *
+   * After a period of inactivity the limiter allows a burst of requests (or
+   * bytes) worth this much time at the configured rates. The default is one
+   * second.
+   */
+  std::chrono::microseconds burst() const { return burst_; }
+  TokenBucketRateLimiterOptions& set_burst(std::chrono::microseconds v) {
+    burst_ = v;
+    return *this;
+  }
+
+ private:
+  double requests_per_second_ = 0;
+  double bytes_per_second_ = 0;
+  bool per_bucket_ = false;
+  std::chrono::microseconds burst_ = std::chrono::seconds(1);
+};
+
+/**
+ * Creates a rate limiter based on the token bucket algorithm.
+ *
+ * The rate limiter adapts to the capacity of the service. Each time the
+ * service rejects a request as overloaded the limiter halves the rates (at
+ * most once per `burst()` period), and then increases them linearly, reaching
+ * the configured rates again after about 10 seconds without rejections. This
+ * keeps the aggregate throughput close to what the service can sustain,
+ * instead of oscillating between overload and retry storms.
+ *
+ * @par Example
+ * @code
+ * namespace gcs = google::cloud::storage;
+ * auto limiter = gcs::MakeTokenBucketRateLimiter(
+ *     gcs::TokenBucketRateLimiterOptions{}
+ *         .set_requests_per_second(1000)
+ *         .set_bytes_per_second(500 * 1024 * 1024.0));
+ * auto options = gcs::ClientOptions::CreateDefaultClientOptions();
+ * if (!options) throw std::runtime_error(options.status().message());
+ * // Share `limiter` with all the clients in this process.
+ * gcs::Client client(options->set_rate_limiter(limiter));
+ * @endcode
+ */
+std::shared_ptr<RateLimiter> MakeTokenBucketRateLimiter(
+    TokenBucketRateLimiterOptions options);
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_RATE_LIMITER_H
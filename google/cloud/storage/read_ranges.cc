@@ -0,0 +1,188 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/read_ranges.h"
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+// Fetching 64KiB more data costs less than the latency of another request.
+auto constexpr kDefaultMaxRangeGap = 64 * 1024;
+auto constexpr kDefaultMaxStreams = 16;
+
+Status ReportError(ReadObjectRangeRequest const& request, char const* what,
+                   Status const& status) {
+  std::ostringstream msg;
+  msg << "ReadRanges(" << request << "): " << what
+      << " - status.message=" << status.message();
+  return Status(status.code(), std::move(msg).str());
+}
+
+Status ValidateRequest(ReadObjectRangeRequest const& request,
+                       std::vector<ReadRangeData> const& ranges) {
+  if (request.HasOption<ReadRange>() || request.HasOption<ReadFromOffset>() ||
+      request.HasOption<ReadLast>()) {
+    return ReportError(
+        request, "invalid options",
+        Status(StatusCode::kInvalidArgument,
+               "ReadRange, ReadFromOffset, and ReadLast are not supported"));
+  }
+  for (auto const& r : ranges) {
+    if (r.begin >= 0 && r.begin <= r.end) continue;
+    return ReportError(request, "invalid range",
+                       Status(StatusCode::kInvalidArgument,
+                              "[" + std::to_string(r.begin) + "," +
+                                  std::to_string(r.end) + ")"));
+  }
+  return Status();
+}
+
+StatusOr<std::string> ReadCoalescedRange(Client& client,
+                                         ReadObjectRangeRequest const& request,
+                                         Generation const& generation,
+                                         CoalescedReadRange const& group) {
+  // Checksums cannot be validated on a partial read.
+  auto stream = client.ReadObject(
+      request.bucket_name(), request.object_name(), generation,
+      ReadRange(group.begin, group.end), DisableCrc32cChecksum(true),
+      DisableMD5Hash(true), request.GetOption<EncryptionKey>(),
+      request.GetOption<IfGenerationMatch>(),
+      request.GetOption<IfGenerationNotMatch>(),
+      request.GetOption<IfMetagenerationMatch>(),
+      request.GetOption<IfMetagenerationNotMatch>(),
+      request.GetOption<UserProject>());
+  if (!stream.status().ok()) return stream.status();
+
+  auto const size = group.end - group.begin;
+  std::string buffer(static_cast<std::size_t>(size), '\0');
+  stream.read(&buffer[0], static_cast<std::streamsize>(size));
+  auto const received = static_cast<std::int64_t>(stream.gcount());
+  if (!stream.status().ok()) return stream.status();
+  if (received != size) {
+    return Status(StatusCode::kOutOfRange,
+                  "short read in range [" + std::to_string(group.begin) + "," +
+                      std::to_string(group.end) + "), got " +
+                      std::to_string(received) + " bytes");
+  }
+  return buffer;
+}
+
+}  // namespace
+
+std::vector<CoalescedReadRange> CoalesceReadRanges(
+    std::vector<ReadRangeData> const& ranges, std::int64_t max_gap) {
+  max_gap = (std::max<std::int64_t>)(0, max_gap);
+  std::vector<std::size_t> order;
+  order.reserve(ranges.size());
+  for (std::size_t i = 0; i != ranges.size(); ++i) {
+    if (ranges[i].begin < ranges[i].end) order.push_back(i);
+  }
+  std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    return std::tie(ranges[a].begin, ranges[a].end) <
+           std::tie(ranges[b].begin, ranges[b].end);
+  });
+
+  std::vector<CoalescedReadRange> groups;
+  for (auto i : order) {
+    auto const& r = ranges[i];
+    if (!groups.empty() && r.begin - groups.back().end <= max_gap) {
+      auto& g = groups.back();
+      g.end = (std::max)(g.end, r.end);
+      g.ranges.push_back(i);
+      continue;
+    }
+    groups.push_back(CoalescedReadRange{r.begin, r.end, {i}});
+  }
+  return groups;
+}
+
+StatusOr<std::vector<std::string>> ReadRangesImpl(
+    Client client, ReadObjectRangeRequest const& request,
+    std::vector<ReadRangeData> const& ranges,
+    absl::optional<MaxRangeGap> const& max_gap,
+    absl::optional<MaxStreams> const& max_streams) {
+  auto status = ValidateRequest(request, ranges);
+  if (!status.ok()) return status;
+
+  auto const groups = CoalesceReadRanges(
+      ranges, max_gap.value_or(MaxRangeGap(kDefaultMaxRangeGap)).value());
+  std::vector<std::string> result(ranges.size());
+  if (groups.empty()) return result;
+
+  // Pin the generation, so all the requests read the same data. With a single
+  // request there is nothing to pin.
+  auto generation = request.GetOption<Generation>();
+  if (!generation.has_value() && groups.size() > 1) {
+    auto metadata = client.GetObjectMetadata(
+        request.bucket_name(), request.object_name(),
+        request.GetOption<IfGenerationMatch>(),
+        request.GetOption<IfGenerationNotMatch>(),
+        request.GetOption<IfMetagenerationMatch>(),
+        request.GetOption<IfMetagenerationNotMatch>(),
+        request.GetOption<UserProject>());
+    if (!metadata) {
+      return ReportError(request, "cannot get object metadata",
+                         metadata.status());
+    }
+    generation = Generation(metadata->generation());
+  }
+
+  std::vector<StatusOr<std::string>> data(groups.size());
+  std::atomic<std::size_t> next{0};
+  auto worker = [&] {
+    for (auto i = next++; i < groups.size(); i = next++) {
+      data[i] = ReadCoalescedRange(client, request, generation, groups[i]);
+    }
+  };
+  auto const thread_count = (std::min)(
+      groups.size(),
+      (std::max<std::size_t>)(
+          1, max_streams.value_or(MaxStreams(kDefaultMaxStreams)).value()));
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (std::size_t i = 1; i < thread_count; ++i) threads.emplace_back(worker);
+  worker();
+  for (auto& t : threads) t.join();
+
+  for (std::size_t i = 0; i != groups.size(); ++i) {
+    auto& d = data[i];
+    if (!d) return ReportError(request, "error reading range", d.status());
+    auto const& g = groups[i];
+    if (g.ranges.size() == 1) {
+      result[g.ranges.front()] = *std::move(d);
+      continue;
+    }
+    for (auto index : g.ranges) {
+      auto const& r = ranges[index];
+      result[index] = d->substr(static_cast<std::size_t>(r.begin - g.begin),
+                                static_cast<std::size_t>(r.end - r.begin));
+    }
+  }
+  return result;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
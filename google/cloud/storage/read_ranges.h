@@ -0,0 +1,142 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_READ_RANGES_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_READ_RANGES_H
+
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/download_options.h"
+#include "google/cloud/storage/internal/tuple_filter.h"
+#include "google/cloud/storage/parallel_download.h"
+#include "google/cloud/storage/parallel_upload.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/internal/tuple.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/optional.h"
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * A parameter type indicating the maximum gap between coalesced ranges in
+ * `ReadRanges()`.
+ *
+ * Two ranges separated by at most this many bytes are fetched using a single
+ * request, and the bytes in the gap are discarded. Reading a few extra bytes
+ * is usually cheaper than the latency of an additional request. Use `0` to
+ * coalesce only adjacent or overlapping ranges.
+ */
+class MaxRangeGap {
+ public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  MaxRangeGap(std::int64_t value) : value_(value) {}
+  std::int64_t value() const { return value_; }
+
+ private:
+  std::int64_t value_;
+};
+
+namespace internal {
+
+/// A group of ranges fetched with a single request, `[begin, end)`.
+struct CoalescedReadRange {
+  std::int64_t begin;
+  std::int64_t end;
+  /// The indices (in the original list) of the ranges in this group.
+  std::vector<std::size_t> ranges;
+};
+
+/**
+ * Group @p ranges into as few requests as possible.
+ *
+ * Ranges that overlap, or are separated by at most @p max_gap bytes, are
+ * coalesced into the same group. Empty ranges are not included in any group.
+ * The groups are sorted by offset.
+ */
+std::vector<CoalescedReadRange> CoalesceReadRanges(
+    std::vector<ReadRangeData> const& ranges, std::int64_t max_gap);
+
+/// Implement `ReadRanges()` once the options are applied.
+StatusOr<std::vector<std::string>> ReadRangesImpl(
+    Client client, ReadObjectRangeRequest const& request,
+    std::vector<ReadRangeData> const& ranges,
+    absl::optional<MaxRangeGap> const& max_gap,
+    absl::optional<MaxStreams> const& max_streams);
+
+}  // namespace internal
+
+/**
+ * Read multiple byte ranges of a Cloud Storage object.
+ *
+ * Applications reading columnar formats (such as Parquet or ORC) typically
+ * need many small ranges from each file. Reading each range with a separate
+ * `Client::ReadObject()` call incurs the latency of one request per range.
+ * This function sorts the ranges, coalesces nearby ranges (see `MaxRangeGap`)
+ * into a single request, and fetches the coalesced ranges concurrently (see
+ * `MaxStreams`), each on a separate thread.
+ *
+ * All the ranges read the same object generation. Unless the application
+ * provides a `Generation` option, this function gets the object metadata first
+ * to pin the generation, the additional request is skipped when all the ranges
+ * coalesce into one request.
+ *
+ * @param client the client on which to perform the operation.
+ * @param bucket_name the name of the bucket that contains the object.
+ * @param object_name the name of the object to be read.
+ * @param ranges the byte ranges to read, each range is right-open, i.e.,
+ *   `[begin, end)`. The ranges may be in any order and may overlap.
+ * @param options a list of optional query parameters and/or request headers.
+ *   Valid types for this operation include `EncryptionKey`, `Generation`,
+ *   `IfGenerationMatch`, `IfGenerationNotMatch`, `IfMetagenerationMatch`,
+ *   `IfMetagenerationNotMatch`, `MaxRangeGap`, `MaxStreams`, and
+ *   `UserProject`.
+ *
+ * @return the contents of each range, in the same order as @p ranges, or the
+ *   first error. Ranges that extend past the end of the object return a
+ *   `kOutOfRange` error.
+ *
+ * @par Idempotency
+ * This is a read-only operation and is always idempotent.
+ */
+template <typename... Options>
+StatusOr<std::vector<std::string>> ReadRanges(
+    Client client, std::string const& bucket_name,
+    std::string const& object_name, std::vector<ReadRangeData> const& ranges,
+    Options&&... options) {
+  auto const max_gap =
+      internal::ExtractFirstOccurenceOfType<MaxRangeGap>(std::tie(options...));
+  auto const max_streams =
+      internal::ExtractFirstOccurenceOfType<MaxStreams>(std::tie(options...));
+  internal::ReadObjectRangeRequest request(bucket_name, object_name);
+  google::cloud::internal::apply(
+      internal::ReadObjectRangeRequestSetOptions{request},
+      internal::StaticTupleFilter<
+          internal::NotAmong<MaxRangeGap, MaxStreams>::TPred>(
+          std::tie(options...)));
+  return internal::ReadRangesImpl(std::move(client), request, ranges,
+                                  max_gap, max_streams);
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_READ_RANGES_H
@@ -0,0 +1,256 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/read_ranges.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/oauth2/google_credentials.h"
+#include "google/cloud/storage/retry_policy.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/storage/testing/random_names.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include "absl/memory/memory.h"
+#include <gmock/gmock.h>
+#include <atomic>
+#include <cstring>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+std::string const kBucketName = "test-bucket";
+std::string const kObjectName = "test-object";
+std::int64_t const kGeneration = 1234;
+
+ObjectMetadata MockObject(std::size_t size) {
+  auto metadata = internal::ObjectMetadataParser::FromJson(nlohmann::json{
+      {"bucket", kBucketName},
+      {"name", kObjectName},
+      {"generation", kGeneration},
+      {"size", size},
+  });
+  EXPECT_STATUS_OK(metadata);
+  return *metadata;
+}
+
+/// Return a `ObjectReadSource` that returns @p contents.
+std::unique_ptr<ObjectReadSource> MockSource(std::string contents) {
+  auto source = absl::make_unique<testing::MockObjectReadSource>();
+  auto offset = std::make_shared<std::size_t>(0);
+  EXPECT_CALL(*source, Read(_, _))
+      .WillRepeatedly([contents, offset](char* buf, std::size_t n) {
+        n = (std::min)(n, contents.size() - *offset);
+        std::memcpy(buf, contents.data() + *offset, n);
+        *offset += n;
+        auto const code = *offset == contents.size() ? 200 : 100;
+        return make_status_or(ReadSourceResult{n, HttpResponse{code, "", {}}});
+      });
+  EXPECT_CALL(*source, IsOpen()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*source, Close())
+      .WillRepeatedly(Return(HttpResponse{200, "", {}}));
+  return std::unique_ptr<ObjectReadSource>(std::move(source));
+}
+
+class ReadRangesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<testing::MockClient>();
+    EXPECT_CALL(*mock_, client_options())
+        .WillRepeatedly(ReturnRef(client_options_));
+    client_.reset(new Client{
+        std::shared_ptr<internal::RawClient>(mock_),
+        LimitedErrorCountRetryPolicy(2),
+        ExponentialBackoffPolicy(std::chrono::milliseconds(1),
+                                 std::chrono::milliseconds(1), 2.0)});
+  }
+
+  /// Serve reads of @p contents, and count the requests.
+  void ExpectReads(std::string const& contents,
+                   std::int64_t expected_generation) {
+    EXPECT_CALL(*mock_, ReadObject(_))
+        .WillRepeatedly([this, contents, expected_generation](
+                            ReadObjectRangeRequest const& r) {
+          ++read_count_;
+          EXPECT_EQ(kBucketName, r.bucket_name());
+          EXPECT_EQ(kObjectName, r.object_name());
+          EXPECT_EQ(expected_generation, r.GetOption<Generation>().value_or(0));
+          EXPECT_TRUE(r.HasOption<ReadRange>());
+          auto const range = r.GetOption<ReadRange>().value();
+          auto const begin = static_cast<std::size_t>(range.begin);
+          auto const end = (std::min)(static_cast<std::size_t>(range.end),
+                                      contents.size());
+          return make_status_or(
+              MockSource(contents.substr(begin, end - begin)));
+        });
+  }
+
+  google::cloud::internal::DefaultPRNG generator_ =
+      google::cloud::internal::MakeDefaultPRNG();
+  std::shared_ptr<testing::MockClient> mock_;
+  std::unique_ptr<Client> client_;
+  ClientOptions client_options_ =
+      ClientOptions(oauth2::CreateAnonymousCredentials());
+  std::atomic<int> read_count_{0};
+};
+
+TEST(CoalesceReadRanges, Empty) {
+  EXPECT_TRUE(CoalesceReadRanges({}, 0).empty());
+  EXPECT_TRUE(CoalesceReadRanges({{10, 10}, {20, 20}}, 100).empty());
+}
+
+TEST(CoalesceReadRanges, Basic) {
+  auto const groups = CoalesceReadRanges(
+      {{500, 600}, {0, 100}, {150, 200}, {90, 120}, {1000, 1100}}, 50);
+  ASSERT_EQ(3, groups.size());
+  EXPECT_EQ(0, groups[0].begin);
+  EXPECT_EQ(200, groups[0].end);
+  EXPECT_THAT(groups[0].ranges, ElementsAre(1, 3, 2));
+  EXPECT_EQ(500, groups[1].begin);
+  EXPECT_EQ(600, groups[1].end);
+  EXPECT_THAT(groups[1].ranges, ElementsAre(0));
+  EXPECT_EQ(1000, groups[2].begin);
+  EXPECT_EQ(1100, groups[2].end);
+  EXPECT_THAT(groups[2].ranges, ElementsAre(4));
+}
+
+TEST(CoalesceReadRanges, NoGap) {
+  auto const groups =
+      CoalesceReadRanges({{0, 100}, {100, 200}, {201, 300}}, 0);
+  ASSERT_EQ(2, groups.size());
+  EXPECT_EQ(0, groups[0].begin);
+  EXPECT_EQ(200, groups[0].end);
+  EXPECT_EQ(201, groups[1].begin);
+  EXPECT_EQ(300, groups[1].end);
+}
+
+TEST(CoalesceReadRanges, Contained) {
+  auto const groups = CoalesceReadRanges({{0, 1000}, {100, 200}}, 0);
+  ASSERT_EQ(1, groups.size());
+  EXPECT_EQ(0, groups[0].begin);
+  EXPECT_EQ(1000, groups[0].end);
+}
+
+TEST_F(ReadRangesTest, Success) {
+  auto const contents = testing::MakeRandomData(generator_, 10000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(make_status_or(MockObject(contents.size()))));
+  ExpectReads(contents, kGeneration);
+
+  std::vector<ReadRangeData> const ranges{
+      {9000, 9500}, {0, 100}, {150, 300}, {5000, 5000}, {4000, 4100}};
+  auto actual = ReadRanges(*client_, kBucketName, kObjectName, ranges,
+                           MaxRangeGap(100), MaxStreams(2));
+  ASSERT_STATUS_OK(actual);
+  ASSERT_EQ(ranges.size(), actual->size());
+  for (std::size_t i = 0; i != ranges.size(); ++i) {
+    auto const& r = ranges[i];
+    EXPECT_EQ(contents.substr(static_cast<std::size_t>(r.begin),
+                              static_cast<std::size_t>(r.end - r.begin)),
+              (*actual)[i]);
+  }
+  EXPECT_EQ(3, read_count_.load());
+}
+
+TEST_F(ReadRangesTest, SingleRequestSkipsMetadata) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_)).Times(0);
+  ExpectReads(contents, 0);
+
+  auto actual = ReadRanges(*client_, kBucketName, kObjectName,
+                           {{0, 100}, {200, 300}}, MaxRangeGap(1000));
+  ASSERT_STATUS_OK(actual);
+  EXPECT_THAT(*actual, ElementsAre(contents.substr(0, 100),
+                                   contents.substr(200, 100)));
+  EXPECT_EQ(1, read_count_.load());
+}
+
+TEST_F(ReadRangesTest, ExplicitGeneration) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  EXPECT_CALL(*mock_, GetObjectMetadata(_)).Times(0);
+  ExpectReads(contents, 42);
+
+  auto actual = ReadRanges(*client_, kBucketName, kObjectName,
+                           {{0, 100}, {800, 900}}, MaxRangeGap(0),
+                           Generation(42));
+  ASSERT_STATUS_OK(actual);
+  EXPECT_THAT(*actual, ElementsAre(contents.substr(0, 100),
+                                   contents.substr(800, 100)));
+  EXPECT_EQ(2, read_count_.load());
+}
+
+TEST_F(ReadRangesTest, ShortRead) {
+  auto const contents = testing::MakeRandomData(generator_, 1000);
+  ExpectReads(contents, 0);
+
+  auto actual =
+      ReadRanges(*client_, kBucketName, kObjectName, {{900, 1100}});
+  EXPECT_THAT(actual, StatusIs(StatusCode::kOutOfRange,
+                               HasSubstr("short read")));
+}
+
+TEST_F(ReadRangesTest, ReadError) {
+  EXPECT_CALL(*mock_, ReadObject(_)).WillOnce(Return(PermanentError()));
+
+  auto actual = ReadRanges(*client_, kBucketName, kObjectName, {{0, 100}});
+  EXPECT_THAT(actual, StatusIs(PermanentError().code(),
+                               HasSubstr("error reading range")));
+}
+
+TEST_F(ReadRangesTest, MetadataError) {
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(PermanentError())));
+  EXPECT_CALL(*mock_, ReadObject(_)).Times(0);
+
+  auto actual = ReadRanges(*client_, kBucketName, kObjectName,
+                           {{0, 100}, {900, 1000}}, MaxRangeGap(0));
+  EXPECT_THAT(actual, StatusIs(PermanentError().code(),
+                               HasSubstr("cannot get object metadata")));
+}
+
+TEST_F(ReadRangesTest, InvalidRange) {
+  EXPECT_CALL(*mock_, ReadObject(_)).Times(0);
+
+  auto actual = ReadRanges(*client_, kBucketName, kObjectName, {{100, 0}});
+  EXPECT_THAT(actual, StatusIs(StatusCode::kInvalidArgument,
+                               HasSubstr("invalid range")));
+}
+
+TEST_F(ReadRangesTest, InvalidOptions) {
+  EXPECT_CALL(*mock_, ReadObject(_)).Times(0);
+
+  auto actual = ReadRanges(*client_, kBucketName, kObjectName, {{0, 100}},
+                           ReadFromOffset(10));
+  EXPECT_THAT(actual, StatusIs(StatusCode::kInvalidArgument,
+                               HasSubstr("not supported")));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
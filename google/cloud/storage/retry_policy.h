@@ -17,6 +17,7 @@
 
 #include "google/cloud/storage/version.h"
 #include "google/cloud/internal/backoff_policy.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/internal/retry_policy.h"
 #include "google/cloud/status.h"
 
@@ -49,6 +50,13 @@ using LimitedErrorCountRetryPolicy =
     google::cloud::internal::LimitedErrorCountRetryPolicy<
         internal::StatusTraits>;
 
+/// A retry budget (and optional circuit breaker) shared across many calls.
+using RetryBudget = google::cloud::internal::RetryBudget;
+
+/// Wrap another retry policy and also consult a shared `RetryBudget`.
+using BudgetedRetryPolicy =
+    google::cloud::internal::BudgetedRetryPolicy<internal::StatusTraits>;
+
 /// The backoff policy base class.
 using BackoffPolicy = google::cloud::internal::BackoffPolicy;
 
@@ -18,6 +18,7 @@
 #include "google/cloud/storage/internal/complex_option.h"
 #include "google/cloud/storage/version.h"
 #include <chrono>
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -248,6 +249,27 @@ struct Scheme : public internal::ComplexOption<Scheme, std::string> {
   static char const* option_name() { return "scheme"; }
 };
 
+/// One URL created by `Client::CreateV4SignedUrls()`.
+struct SignedUrlItem {
+  std::string verb;
+  std::string bucket_name;
+  std::string object_name;
+};
+
+/**
+ * The maximum number of threads used by `Client::CreateV4SignedUrls()`.
+ *
+ * The default (or 0) uses one thread per core.
+ */
+struct MaxSigningThreads
+    : public internal::ComplexOption<MaxSigningThreads, std::size_t> {
+  using ComplexOption<MaxSigningThreads, std::size_t>::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  MaxSigningThreads() = default;
+  static char const* option_name() { return "max-signing-threads"; }
+};
+
 /**
  * Add a extension header to a POST policy.
  */
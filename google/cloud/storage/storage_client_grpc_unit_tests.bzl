@@ -17,6 +17,7 @@
 """Automatically generated unit tests list - DO NOT EDIT."""
 
 storage_client_grpc_unit_tests = [
+    "internal/grpc_channel_pool_test.cc",
     "internal/grpc_client_bucket_metadata_test.cc",
     "internal/grpc_client_bucket_request_test.cc",
     "internal/grpc_client_failures_test.cc",
@@ -25,4 +26,5 @@ storage_client_grpc_unit_tests = [
     "internal/grpc_object_read_source_test.cc",
     "internal/grpc_resumable_upload_session_test.cc",
     "internal/grpc_resumable_upload_session_url_test.cc",
+    "internal/transport_selector_test.cc",
 ]
@@ -17,11 +17,16 @@
 """Automatically generated unit tests list - DO NOT EDIT."""
 
 storage_client_unit_tests = [
+    "async_client_test.cc",
+    "batch_builder_test.cc",
     "bucket_access_control_test.cc",
     "bucket_metadata_test.cc",
+    "buffer_pool_test.cc",
     "bucket_test.cc",
+    "bulk_rewrite_test.cc",
     "client_bucket_acl_test.cc",
     "client_default_object_acl_test.cc",
+    "client_metrics_test.cc",
     "client_notifications_test.cc",
     "client_object_acl_test.cc",
     "client_object_copy_test.cc",
@@ -31,20 +36,28 @@ storage_client_unit_tests = [
     "client_sign_url_test.cc",
     "client_test.cc",
     "client_write_object_test.cc",
+    "compact_object_list_test.cc",
     "hashing_options_test.cc",
+    "hedged_read_policy_test.cc",
     "hmac_key_metadata_test.cc",
     "idempotency_policy_test.cc",
     "internal/access_control_common_parser_test.cc",
     "internal/access_control_common_test.cc",
+    "internal/adaptive_chunk_size_test.cc",
+    "internal/batch_requests_test.cc",
     "internal/binary_data_as_debug_string_test.cc",
     "internal/bucket_acl_requests_test.cc",
     "internal/bucket_requests_test.cc",
+    "internal/cached_object_read_source_test.cc",
+    "internal/coalescing_client_test.cc",
     "internal/complex_option_test.cc",
     "internal/compute_engine_util_test.cc",
     "internal/const_buffer_test.cc",
+    "internal/crc32c_combine_test.cc",
     "internal/curl_client_test.cc",
     "internal/curl_handle_factory_test.cc",
     "internal/curl_handle_test.cc",
+    "internal/curl_multi_reactor_test.cc",
     "internal/curl_resumable_upload_session_test.cc",
     "internal/curl_wrappers_disable_sigpipe_handler_test.cc",
     "internal/curl_wrappers_enable_sigpipe_handler_test.cc",
@@ -53,21 +66,32 @@ storage_client_unit_tests = [
     "internal/curl_wrappers_locking_enabled_test.cc",
     "internal/curl_wrappers_test.cc",
     "internal/default_object_acl_requests_test.cc",
+    "internal/direct_file_io_test.cc",
+    "internal/expiring_lru_cache_test.cc",
     "internal/generate_message_boundary_test.cc",
     "internal/generic_request_test.cc",
+    "internal/gzip_object_read_source_test.cc",
+    "internal/gzip_object_write_streambuf_test.cc",
     "internal/hash_validator_test.cc",
+    "internal/hedged_object_read_source_test.cc",
     "internal/hmac_key_requests_test.cc",
     "internal/http_response_test.cc",
     "internal/logging_client_test.cc",
     "internal/logging_resumable_upload_session_test.cc",
+    "internal/mapped_file_test.cc",
+    "internal/metadata_cache_client_test.cc",
     "internal/metadata_parser_test.cc",
+    "internal/metrics_client_test.cc",
     "internal/notification_requests_test.cc",
     "internal/object_acl_requests_test.cc",
+    "internal/object_metadata_sax_parser_test.cc",
     "internal/object_requests_test.cc",
     "internal/object_streambuf_test.cc",
     "internal/openssl_util_test.cc",
+    "internal/parallel_object_read_source_test.cc",
     "internal/parameter_pack_validation_test.cc",
     "internal/patch_builder_test.cc",
+    "internal/pipelined_object_write_streambuf_test.cc",
     "internal/policy_document_request_test.cc",
     "internal/resumable_upload_session_test.cc",
     "internal/retry_client_test.cc",
@@ -77,31 +101,44 @@ storage_client_unit_tests = [
     "internal/sha256_hash_test.cc",
     "internal/sign_blob_requests_test.cc",
     "internal/signed_url_requests_test.cc",
+    "internal/stage_timer_test.cc",
+    "internal/token_bucket_rate_limiter_test.cc",
     "internal/tuple_filter_test.cc",
     "lifecycle_rule_test.cc",
     "list_buckets_reader_test.cc",
     "list_hmac_keys_reader_test.cc",
     "list_objects_and_prefixes_reader_test.cc",
     "list_objects_reader_test.cc",
+    "metadata_cache_invalidator_test.cc",
     "notification_metadata_test.cc",
     "oauth2/anonymous_credentials_test.cc",
     "oauth2/authorized_user_credentials_test.cc",
     "oauth2/compute_engine_credentials_test.cc",
     "oauth2/google_application_default_credentials_file_test.cc",
     "oauth2/google_credentials_test.cc",
+    "oauth2/lazy_credentials_test.cc",
+    "oauth2/refreshing_credentials_wrapper_test.cc",
     "oauth2/service_account_credentials_test.cc",
     "object_access_control_test.cc",
     "object_metadata_test.cc",
+    "object_read_cache_test.cc",
     "object_stream_test.cc",
     "object_test.cc",
+    "operation_deadline_test.cc",
+    "parallel_download_test.cc",
+    "parallel_list_objects_test.cc",
     "parallel_uploads_test.cc",
     "policy_document_test.cc",
+    "read_ranges_test.cc",
     "retry_policy_test.cc",
     "service_account_test.cc",
     "signed_url_options_test.cc",
     "storage_class_test.cc",
     "storage_iam_policy_test.cc",
     "storage_version_test.cc",
+    "streaming_copy_test.cc",
+    "sync_directory_test.cc",
+    "transfer_manager_test.cc",
     "testing/remove_stale_buckets_test.cc",
     "well_known_headers_test.cc",
     "well_known_parameters_test.cc",
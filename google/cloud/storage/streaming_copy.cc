@@ -0,0 +1,137 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/streaming_copy.h"
+#include "google/cloud/storage/internal/bounded_queue.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+// Large enough to amortize the per-block overhead, small enough to keep the
+// memory usage of the queues modest.
+auto constexpr kDefaultBlockSize = 2 * 1024 * 1024L;
+auto constexpr kDefaultQueueDepth = 8;
+
+}  // namespace
+
+Status StreamingCopyImpl(StreamingCopyReader const& read,
+                         StreamingCopyTransform::Function const& transform,
+                         StreamingCopyWriter const& write,
+                         std::size_t block_size, std::size_t queue_depth) {
+  std::mutex mu;
+  Status first_error;
+  BoundedQueue<std::string> downloaded(queue_depth);
+  BoundedQueue<std::string> transformed(queue_depth);
+  // On errors stop all the stages, the producers blocked in `Push()` return
+  // immediately.
+  auto fail = [&](Status status) {
+    {
+      std::lock_guard<std::mutex> lk(mu);
+      if (first_error.ok()) first_error = std::move(status);
+    }
+    downloaded.Shutdown();
+    transformed.Shutdown();
+  };
+
+  std::thread reader([&] {
+    for (;;) {
+      auto block = read(block_size);
+      if (!block) return fail(std::move(block).status());
+      if (block->empty()) break;
+      if (!downloaded.Push(*std::move(block))) return;
+    }
+    downloaded.Shutdown();
+  });
+
+  auto* output = &downloaded;
+  std::thread transformer;
+  if (transform) {
+    output = &transformed;
+    transformer = std::thread([&] {
+      for (auto b = downloaded.Pop(); b.has_value(); b = downloaded.Pop()) {
+        auto block = transform(*std::move(b));
+        if (!block) return fail(std::move(block).status());
+        if (block->empty()) continue;
+        if (!transformed.Push(*std::move(block))) return;
+      }
+      transformed.Shutdown();
+    });
+  }
+
+  for (auto b = output->Pop(); b.has_value(); b = output->Pop()) {
+    auto status = write(*b);
+    if (!status.ok()) {
+      fail(std::move(status));
+      break;
+    }
+  }
+
+  reader.join();
+  if (transformer.joinable()) transformer.join();
+  std::lock_guard<std::mutex> lk(mu);
+  return first_error;
+}
+
+StatusOr<ObjectMetadata> StreamingCopyObjectImpl(
+    ObjectReadStream source, ObjectWriteStream destination,
+    absl::optional<StreamingCopyBlockSize> const& block_size,
+    absl::optional<StreamingCopyQueueDepth> const& queue_depth,
+    absl::optional<StreamingCopyTransform> const& transform) {
+  auto read = [&source](std::size_t n) -> StatusOr<std::string> {
+    std::string block(n, '\0');
+    source.read(&block[0], static_cast<std::streamsize>(n));
+    block.resize(static_cast<std::size_t>(source.gcount()));
+    if (block.empty() && !source.status().ok()) return source.status();
+    return block;
+  };
+  auto write = [&destination](std::string const& block) {
+    destination.write(block.data(), static_cast<std::streamsize>(block.size()));
+    if (destination) return Status();
+    auto status = destination.last_status();
+    if (!status.ok()) return status;
+    return Status(StatusCode::kUnknown,
+                  "StreamingCopyObject: error writing to the upload stream");
+  };
+
+  auto status = StreamingCopyImpl(
+      read,
+      transform.has_value() ? transform->value()
+                            : StreamingCopyTransform::Function{},
+      write,
+      (std::max<std::size_t>)(
+          1, block_size.value_or(StreamingCopyBlockSize(kDefaultBlockSize))
+                 .value()),
+      queue_depth.value_or(StreamingCopyQueueDepth(kDefaultQueueDepth))
+          .value());
+  if (!status.ok()) {
+    // Do not finalize the upload, that would create a truncated object.
+    std::move(destination).Suspend();
+    return status;
+  }
+  destination.Close();
+  return std::move(destination).metadata();
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,172 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_STREAMING_COPY_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_STREAMING_COPY_H
+
+#include "google/cloud/storage/internal/tuple_filter.h"
+#include "google/cloud/storage/object_metadata.h"
+#include "google/cloud/storage/object_stream.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/optional.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * The size of the blocks read ahead by `StreamingCopyObject()`.
+ *
+ * The default is 2 MiB.
+ */
+class StreamingCopyBlockSize {
+ public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  StreamingCopyBlockSize(std::size_t value) : value_(value) {}
+  std::size_t value() const { return value_; }
+
+ private:
+  std::size_t value_;
+};
+
+/**
+ * The maximum number of blocks buffered between the stages of
+ * `StreamingCopyObject()`.
+ *
+ * Each stage (download, transform, upload) can run ahead of the next stage by
+ * this many blocks. The default is 8.
+ */
+class StreamingCopyQueueDepth {
+ public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  StreamingCopyQueueDepth(std::size_t value) : value_(value) {}
+  std::size_t value() const { return value_; }
+
+ private:
+  std::size_t value_;
+};
+
+/**
+ * Transform the data copied by `StreamingCopyObject()`.
+ *
+ * The function is called for each block, in order, on a dedicated thread. It
+ * may return a block of a different size (including an empty block). Any
+ * error stops the copy.
+ */
+class StreamingCopyTransform {
+ public:
+  using Function = std::function<StatusOr<std::string>(std::string)>;
+
+  explicit StreamingCopyTransform(Function value) : value_(std::move(value)) {}
+  Function const& value() const { return value_; }
+
+ private:
+  Function value_;
+};
+
+namespace internal {
+
+/// Reads the next block, an empty block indicates the end of the data.
+using StreamingCopyReader = std::function<StatusOr<std::string>(std::size_t)>;
+
+/// Writes a block to the destination.
+using StreamingCopyWriter = std::function<Status(std::string const&)>;
+
+/**
+ * Run the streaming copy pipeline.
+ *
+ * The @p read function runs on a separate thread, reading up to @p queue_depth
+ * blocks ahead. If @p transform is set it runs on its own thread. The @p write
+ * function runs on the calling thread.
+ *
+ * @return the first error in any of the stages, or OK if all the data was
+ *   read, transformed, and written.
+ */
+Status StreamingCopyImpl(StreamingCopyReader const& read,
+                         StreamingCopyTransform::Function const& transform,
+                         StreamingCopyWriter const& write,
+                         std::size_t block_size, std::size_t queue_depth);
+
+/// Implement `StreamingCopyObject()` once the options are applied.
+StatusOr<ObjectMetadata> StreamingCopyObjectImpl(
+    ObjectReadStream source, ObjectWriteStream destination,
+    absl::optional<StreamingCopyBlockSize> const& block_size,
+    absl::optional<StreamingCopyQueueDepth> const& queue_depth,
+    absl::optional<StreamingCopyTransform> const& transform);
+
+}  // namespace internal
+
+/**
+ * Copy an object by streaming its data from a download to an upload.
+ *
+ * `Client::RewriteObject()` copies objects without transferring the data
+ * through the client, and should be preferred when possible. When the source
+ * and destination require different credentials, or the data must be
+ * transformed, the data needs to go through the client. Simply reading from
+ * an `ObjectReadStream` and writing into an `ObjectWriteStream` alternates
+ * between the download and the upload, leaving one of them idle at all times.
+ *
+ * This function reads the data ahead on a separate thread, into a bounded
+ * queue, and uploads it concurrently, so both directions stay busy. An
+ * optional `StreamingCopyTransform` runs in a third stage between them.
+ *
+ * The application creates both streams, using any client and options, for
+ * example:
+ *
+ * @code
+ * auto metadata = gcs::StreamingCopyObject(
+ *     source_client.ReadObject("source-bucket", "source-object"),
+ *     destination_client.WriteObject("destination-bucket", "object"),
+ *     gcs::StreamingCopyQueueDepth(16));
+ * @endcode
+ *
+ * If any stage fails the upload is suspended, and not finalized, so a failed
+ * copy never creates a truncated object.
+ *
+ * @param source the download stream, the data is read until the end of the
+ *   stream.
+ * @param destination the upload stream, it is finalized if the copy succeeds.
+ * @param options a list of optional parameters. Valid types for this operation
+ *   include `StreamingCopyBlockSize`, `StreamingCopyQueueDepth`, and
+ *   `StreamingCopyTransform`.
+ *
+ * @return the metadata of the new object, or the first error.
+ */
+template <typename... Options>
+StatusOr<ObjectMetadata> StreamingCopyObject(ObjectReadStream source,
+                                             ObjectWriteStream destination,
+                                             Options&&... options) {
+  return internal::StreamingCopyObjectImpl(
+      std::move(source), std::move(destination),
+      internal::ExtractFirstOccurenceOfType<StreamingCopyBlockSize>(
+          std::tie(options...)),
+      internal::ExtractFirstOccurenceOfType<StreamingCopyQueueDepth>(
+          std::tie(options...)),
+      internal::ExtractFirstOccurenceOfType<StreamingCopyTransform>(
+          std::tie(options...)));
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_STREAMING_COPY_H
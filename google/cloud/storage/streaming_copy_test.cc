@@ -0,0 +1,165 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/streaming_copy.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+
+/// Returns @p contents in blocks of at most the requested size.
+StreamingCopyReader MakeReader(std::string const& contents,
+                               std::shared_ptr<std::size_t> offset) {
+  return [contents, offset](std::size_t n) -> StatusOr<std::string> {
+    auto const count = (std::min)(n, contents.size() - *offset);
+    auto block = contents.substr(*offset, count);
+    *offset += count;
+    return block;
+  };
+}
+
+TEST(StreamingCopyTest, CopiesInOrder) {
+  std::string const contents = "The quick brown fox jumps over the lazy dog";
+  std::string copied;
+  auto status = StreamingCopyImpl(
+      MakeReader(contents, std::make_shared<std::size_t>(0)), {},
+      [&](std::string const& b) {
+        EXPECT_LE(b.size(), 4);
+        copied += b;
+        return Status();
+      },
+      4, 2);
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(contents, copied);
+}
+
+TEST(StreamingCopyTest, Transform) {
+  std::string const contents = "The quick brown fox jumps over the lazy dog";
+  std::string copied;
+  auto status = StreamingCopyImpl(
+      MakeReader(contents, std::make_shared<std::size_t>(0)),
+      [](std::string b) -> StatusOr<std::string> {
+        std::transform(b.begin(), b.end(), b.begin(), [](char c) {
+          return static_cast<char>(std::toupper(c));
+        });
+        // Dropping a block is allowed, the writer should not see it.
+        if (b == "THE ") return std::string{};
+        return b;
+      },
+      [&](std::string const& b) {
+        EXPECT_FALSE(b.empty());
+        copied += b;
+        return Status();
+      },
+      4, 2);
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ("QUICK BROWN FOX JUMPS OVER THE LAZY DOG", copied);
+}
+
+TEST(StreamingCopyTest, ReadsAhead) {
+  std::string const contents(64, 'a');
+  std::mutex mu;
+  std::condition_variable cv;
+  std::size_t read_count = 0;
+  auto offset = std::make_shared<std::size_t>(0);
+  auto base = MakeReader(contents, offset);
+  auto reader = [&](std::size_t n) {
+    auto block = base(n);
+    std::lock_guard<std::mutex> lk(mu);
+    ++read_count;
+    cv.notify_all();
+    return block;
+  };
+
+  bool first = true;
+  auto status = StreamingCopyImpl(
+      reader, {},
+      [&](std::string const&) {
+        if (!first) return Status();
+        first = false;
+        // The reader keeps going while the first block is being written, up
+        // to the queue depth.
+        std::unique_lock<std::mutex> lk(mu);
+        cv.wait(lk, [&] { return read_count >= 4; });
+        return Status();
+      },
+      4, 3);
+  ASSERT_STATUS_OK(status);
+  EXPECT_EQ(contents.size(), *offset);
+}
+
+TEST(StreamingCopyTest, ReadError) {
+  std::atomic<int> reads{0};
+  std::string copied;
+  auto status = StreamingCopyImpl(
+      [&](std::size_t) -> StatusOr<std::string> {
+        if (++reads > 2) return PermanentError();
+        return std::string("abcd");
+      },
+      {},
+      [&](std::string const& b) {
+        copied += b;
+        return Status();
+      },
+      4, 2);
+  EXPECT_THAT(status, StatusIs(PermanentError().code()));
+  EXPECT_EQ(3, reads.load());
+}
+
+TEST(StreamingCopyTest, WriteErrorStopsReader) {
+  std::atomic<int> reads{0};
+  auto status = StreamingCopyImpl(
+      [&](std::size_t) -> StatusOr<std::string> {
+        ++reads;
+        return std::string("abcd");
+      },
+      {}, [](std::string const&) { return PermanentError(); }, 4, 2);
+  EXPECT_THAT(status, StatusIs(PermanentError().code()));
+  // The reader never ends on its own, it must stop once the queue is closed.
+  EXPECT_LE(reads.load(), 4);
+}
+
+TEST(StreamingCopyTest, TransformError) {
+  auto status = StreamingCopyImpl(
+      MakeReader(std::string(64, 'a'), std::make_shared<std::size_t>(0)),
+      [](std::string) -> StatusOr<std::string> { return PermanentError(); },
+      [](std::string const&) {
+        ADD_FAILURE() << "unexpected write";
+        return Status();
+      },
+      4, 2);
+  EXPECT_THAT(status, StatusIs(PermanentError().code()));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
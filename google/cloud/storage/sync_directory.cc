@@ -0,0 +1,156 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/sync_directory.h"
+#include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/internal/big_endian.h"
+#include <crc32c/crc32c.h>
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+
+Status SyncSummary::status() const {
+  auto status = uploads.status();
+  if (!status.ok()) return status;
+  return delete_status;
+}
+
+namespace internal {
+namespace {
+
+// Large enough to amortize the cost of each read, small enough to keep many
+// files in flight without consuming too much memory.
+auto constexpr kChecksumBufferSize = 1024 * 1024;
+
+struct RemoteObject {
+  std::uint64_t size;
+  std::string crc32c;
+  std::int64_t generation;
+};
+
+}  // namespace
+
+char const* SyncListObjectsFields() {
+  return "items(name,size,crc32c,generation),nextPageToken";
+}
+
+StatusOr<std::string> ComputeFileCrc32cChecksum(std::string const& file_name) {
+  std::ifstream is(file_name, std::ios::binary);
+  if (!is.is_open()) {
+    return Status(StatusCode::kNotFound,
+                  "ComputeFileCrc32cChecksum(" + file_name +
+                      "): cannot open file");
+  }
+  std::vector<char> buffer(kChecksumBufferSize);
+  std::uint32_t crc = 0;
+  while (is) {
+    is.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    crc = crc32c::Extend(crc,
+                         reinterpret_cast<std::uint8_t const*>(buffer.data()),
+                         static_cast<std::size_t>(is.gcount()));
+  }
+  if (is.bad()) {
+    return Status(StatusCode::kDataLoss, "ComputeFileCrc32cChecksum(" +
+                                             file_name + "): read error");
+  }
+  return Base64Encode(google::cloud::internal::EncodeBigEndian(crc));
+}
+
+StatusOr<SyncPlan> ComputeSyncPlan(
+    Client client, ListObjectsRequest request,
+    std::vector<FileTransfer> const& local,
+    absl::optional<MaxConcurrentTransfers> const& max_concurrent_transfers) {
+  std::unordered_map<std::string, RemoteObject> remote;
+  for (;;) {
+    auto response = client.raw_client()->ListObjects(request);
+    if (!response) return std::move(response).status();
+    for (auto& o : response->items) {
+      remote.emplace(o.name(),
+                     RemoteObject{o.size(), o.crc32c(), o.generation()});
+    }
+    if (response->next_page_token.empty()) break;
+    request.set_page_token(std::move(response->next_page_token));
+  }
+
+  // Only files with the same size as their object need a checksum, all the
+  // other files are new or changed.
+  std::vector<char> changed(local.size(), true);
+  std::vector<std::size_t> candidates;
+  for (std::size_t i = 0; i != local.size(); ++i) {
+    auto const& f = local[i];
+    auto r = remote.find(f.object_name);
+    if (r == remote.end() || r->second.crc32c.empty()) continue;
+    std::error_code ec;
+    auto const size = google::cloud::internal::file_size(f.file_name, ec);
+    if (ec || size != r->second.size) continue;
+    candidates.push_back(i);
+  }
+  RunConcurrently(candidates.size(), max_concurrent_transfers,
+                  [&](std::size_t c) {
+                    auto const i = candidates[c];
+                    auto crc32c = ComputeFileCrc32cChecksum(local[i].file_name);
+                    // Upload the file on errors, the upload reports them.
+                    changed[i] =
+                        !crc32c ||
+                        *crc32c != remote.at(local[i].object_name).crc32c;
+                  });
+
+  SyncPlan plan;
+  std::unordered_set<std::string> names;
+  for (std::size_t i = 0; i != local.size(); ++i) {
+    names.insert(local[i].object_name);
+    if (changed[i]) {
+      plan.uploads.push_back(local[i]);
+    } else {
+      plan.unchanged.push_back(local[i].object_name);
+    }
+  }
+  for (auto const& kv : remote) {
+    if (names.count(kv.first) != 0) continue;
+    plan.extraneous.push_back(
+        SyncExtraneousObject{kv.first, kv.second.generation});
+  }
+  std::sort(plan.extraneous.begin(), plan.extraneous.end(),
+            [](SyncExtraneousObject const& a, SyncExtraneousObject const& b) {
+              return a.name < b.name;
+            });
+  return plan;
+}
+
+Status DeleteSyncExtraneousObjects(
+    Client client, std::string const& bucket_name,
+    std::vector<SyncExtraneousObject> const& objects,
+    absl::optional<UserProject> const& user_project) {
+  BatchDeleter deleter(client.raw_client());
+  for (auto const& o : objects) {
+    DeleteObjectRequest request(bucket_name, o.name);
+    request.set_multiple_options(IfGenerationMatch(o.generation),
+                                 user_project.value_or(UserProject()));
+    auto status = deleter.Add(std::move(request));
+    if (!status.ok()) return status;
+  }
+  return deleter.Flush();
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,198 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_SYNC_DIRECTORY_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_SYNC_DIRECTORY_H
+
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/internal/tuple_filter.h"
+#include "google/cloud/storage/transfer_manager.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/internal/tuple.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/optional.h"
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * A parameter type indicating if `SyncDirectory()` deletes the objects that
+ * do not have a matching local file.
+ */
+class DeleteExtraneousObjects {
+ public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  DeleteExtraneousObjects(bool value) : value_(value) {}
+  bool value() const { return value_; }
+
+ private:
+  bool value_;
+};
+
+/// The results of `SyncDirectory()`.
+struct SyncSummary {
+  /// The results of uploading the new and changed files.
+  TransferSummary uploads;
+  /// The objects that already matched their local files.
+  std::vector<std::string> unchanged;
+  /// The extraneous objects, deleted only with `DeleteExtraneousObjects(true)`.
+  std::vector<std::string> extraneous;
+  /// The result of deleting the extraneous objects.
+  Status delete_status;
+
+  /// The first error in the uploads or deletes, or OK if all succeeded.
+  Status status() const;
+};
+
+namespace internal {
+
+/// An object in the destination prefix without a matching local file.
+struct SyncExtraneousObject {
+  std::string name;
+  std::int64_t generation;
+};
+
+/// The work needed to synchronize a directory with a prefix.
+struct SyncPlan {
+  std::vector<FileTransfer> uploads;
+  std::vector<std::string> unchanged;
+  std::vector<SyncExtraneousObject> extraneous;
+};
+
+/// The fields needed to compare the objects against the local files.
+char const* SyncListObjectsFields();
+
+/// Compute the CRC32C checksum of a file, in the format used by `crc32c()`.
+StatusOr<std::string> ComputeFileCrc32cChecksum(std::string const& file_name);
+
+/**
+ * Compare the @p local files against the objects listed by @p request.
+ *
+ * Files whose object does not exist, or has a different size or CRC32C
+ * checksum, need to be uploaded. The checksums are only computed for files
+ * whose size matches the object size, using at most
+ * @p max_concurrent_transfers threads.
+ */
+StatusOr<SyncPlan> ComputeSyncPlan(
+    Client client, ListObjectsRequest request,
+    std::vector<FileTransfer> const& local,
+    absl::optional<MaxConcurrentTransfers> const& max_concurrent_transfers);
+
+/// Delete the @p objects using batch requests, if the client supports them.
+Status DeleteSyncExtraneousObjects(
+    Client client, std::string const& bucket_name,
+    std::vector<SyncExtraneousObject> const& objects,
+    absl::optional<UserProject> const& user_project);
+
+/// Helper functor to call `UploadFiles()` via `apply`.
+struct UploadFilesFunctor {
+  template <typename... Options>
+  TransferSummary operator()(Options&&... options) const {
+    return UploadFiles(client, bucket_name, files,
+                       std::forward<Options>(options)...);
+  }
+
+  Client& client;
+  std::string const& bucket_name;
+  std::vector<FileTransfer> const& files;
+};
+
+}  // namespace internal
+
+/**
+ * Synchronize a Cloud Storage prefix with the files in a local directory.
+ *
+ * Mirroring a directory with `UploadDirectory()` transfers every file, even if
+ * the objects are unchanged. This function lists the objects in the
+ * destination prefix (requesting only the fields needed for the comparison),
+ * and only uploads the files that do not have a matching object, or whose
+ * size or CRC32C checksum is different. The checksums of the local files are
+ * computed in parallel, and only for files whose size matches the object size.
+ *
+ * The object names are computed as in `UploadDirectory()`. The uploads use
+ * `UploadFiles()`, and support the same options. With
+ * `DeleteExtraneousObjects(true)` the objects in the prefix that do not have a
+ * matching local file are deleted, using batch requests if the client supports
+ * them. Each deletion is conditioned on the object generation, so objects
+ * overwritten during the synchronization are not deleted.
+ *
+ * @param client the client on which to perform the operations.
+ * @param directory the directory containing the files to upload.
+ * @param bucket_name the name of the bucket that will contain the objects.
+ * @param prefix the prefix for all the object names, typically empty or ending
+ *   in `/`.
+ * @param options a list of optional query parameters and/or request headers.
+ *   Valid types for this operation include `DeleteExtraneousObjects`, and the
+ *   valid types for `UploadFiles()`.
+ *
+ * @return an error if the directory or the prefix cannot be listed, otherwise
+ *   the status of each upload and deletion.
+ *
+ * @par Idempotency
+ * This operation is not idempotent, see `UploadFiles()`.
+ */
+template <typename... Options>
+StatusOr<SyncSummary> SyncDirectory(Client client,
+                                    std::string const& directory,
+                                    std::string const& bucket_name,
+                                    std::string const& prefix,
+                                    Options&&... options) {
+  auto const delete_extraneous =
+      internal::ExtractFirstOccurenceOfType<DeleteExtraneousObjects>(
+          std::tie(options...));
+  auto const max_concurrent_transfers =
+      internal::ExtractFirstOccurenceOfType<MaxConcurrentTransfers>(
+          std::tie(options...));
+  auto const user_project =
+      internal::ExtractFirstOccurenceOfType<UserProject>(std::tie(options...));
+
+  auto local = internal::ListDirectoryTransfers(directory, prefix);
+  if (!local) return std::move(local).status();
+
+  internal::ListObjectsRequest request(bucket_name);
+  request.set_multiple_options(Prefix(prefix),
+                               Fields(internal::SyncListObjectsFields()),
+                               user_project.value_or(UserProject()));
+  auto plan = internal::ComputeSyncPlan(client, std::move(request), *local,
+                                        max_concurrent_transfers);
+  if (!plan) return std::move(plan).status();
+
+  SyncSummary summary;
+  summary.uploads = google::cloud::internal::apply(
+      internal::UploadFilesFunctor{client, bucket_name, plan->uploads},
+      internal::StaticTupleFilter<
+          internal::NotAmong<DeleteExtraneousObjects>::TPred>(
+          std::tie(options...)));
+  summary.unchanged = std::move(plan->unchanged);
+  for (auto const& o : plan->extraneous) summary.extraneous.push_back(o.name);
+  if (delete_extraneous.value_or(false).value()) {
+    summary.delete_status = internal::DeleteSyncExtraneousObjects(
+        std::move(client), bucket_name, plan->extraneous, user_project);
+  }
+  return summary;
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_SYNC_DIRECTORY_H
@@ -0,0 +1,207 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/sync_directory.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/oauth2/google_credentials.h"
+#include "google/cloud/storage/retry_policy.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/storage/testing/random_names.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <set>
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Return;
+using ::testing::ReturnRef;
+using ::testing::UnorderedElementsAre;
+
+std::string const kBucketName = "test-bucket";
+
+void WriteFile(std::string const& name, std::string const& contents) {
+  std::ofstream os(name, std::ios::binary | std::ios::trunc);
+  os.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+ObjectMetadata MockObject(std::string const& name, std::string const& contents,
+                          std::int64_t generation) {
+  auto metadata = internal::ObjectMetadataParser::FromJson(nlohmann::json{
+      {"bucket", kBucketName},
+      {"name", name},
+      {"generation", generation},
+      {"size", contents.size()},
+      {"crc32c", ComputeCrc32cChecksum(contents)},
+  });
+  EXPECT_STATUS_OK(metadata);
+  return *metadata;
+}
+
+TEST(SyncDirectory, ComputeFileCrc32cChecksum) {
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  auto const file_name = testing::MakeRandomFileName(generator);
+  auto const contents = testing::MakeRandomData(generator, 3 * 1024 * 1024);
+  WriteFile(file_name, contents);
+  auto actual = ComputeFileCrc32cChecksum(file_name);
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(ComputeCrc32cChecksum(contents), *actual);
+  (void)std::remove(file_name.c_str());
+
+  EXPECT_THAT(ComputeFileCrc32cChecksum(file_name),
+              StatusIs(StatusCode::kNotFound));
+}
+
+#ifndef _WIN32
+class SyncDirectoryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<testing::MockClient>();
+    EXPECT_CALL(*mock_, client_options())
+        .WillRepeatedly(ReturnRef(client_options_));
+    client_.reset(new Client{std::shared_ptr<internal::RawClient>(mock_),
+                             LimitedErrorCountRetryPolicy(2)});
+    directory_ = testing::MakeRandomFileName(generator_);
+    ASSERT_EQ(0, ::mkdir(directory_.c_str(), 0755));
+    WriteFile(directory_ + "/same.txt", "same contents");
+    WriteFile(directory_ + "/changed.txt", "new contents");
+    WriteFile(directory_ + "/resized.txt", "new contents, larger");
+    WriteFile(directory_ + "/new.txt", "new file");
+  }
+  void TearDown() override {
+    for (auto const* name :
+         {"same.txt", "changed.txt", "resized.txt", "new.txt"}) {
+      (void)std::remove((directory_ + "/" + name).c_str());
+    }
+    (void)::rmdir(directory_.c_str());
+  }
+
+  void ExpectList() {
+    EXPECT_CALL(*mock_, ListObjects(_))
+        .WillOnce([](ListObjectsRequest const& r) {
+          EXPECT_EQ(kBucketName, r.bucket_name());
+          EXPECT_EQ("p/", r.GetOption<Prefix>().value_or(""));
+          EXPECT_EQ(SyncListObjectsFields(),
+                    r.GetOption<Fields>().value_or(""));
+          ListObjectsResponse response;
+          response.next_page_token = "page-2";
+          response.items.push_back(
+              MockObject("p/same.txt", "same contents", 1));
+          response.items.push_back(
+              MockObject("p/changed.txt", "old contents", 2));
+          return make_status_or(response);
+        })
+        .WillOnce([](ListObjectsRequest const& r) {
+          EXPECT_EQ("page-2", r.page_token());
+          ListObjectsResponse response;
+          response.items.push_back(MockObject("p/resized.txt", "old", 3));
+          response.items.push_back(MockObject("p/extra.txt", "extra", 4));
+          return make_status_or(response);
+        });
+  }
+
+  void ExpectUploads() {
+    EXPECT_CALL(*mock_, InsertObjectMedia(_))
+        .WillRepeatedly([this](InsertObjectMediaRequest const& r) {
+          {
+            std::lock_guard<std::mutex> lk(mu_);
+            uploaded_.insert(r.object_name());
+          }
+          return internal::ObjectMetadataParser::FromJson(nlohmann::json{
+              {"bucket", r.bucket_name()},
+              {"name", r.object_name()},
+              {"size", r.contents().size()},
+          });
+        });
+  }
+
+  google::cloud::internal::DefaultPRNG generator_ =
+      google::cloud::internal::MakeDefaultPRNG();
+  std::shared_ptr<testing::MockClient> mock_;
+  std::unique_ptr<Client> client_;
+  ClientOptions client_options_ =
+      ClientOptions(oauth2::CreateAnonymousCredentials());
+  std::string directory_;
+  std::mutex mu_;
+  std::set<std::string> uploaded_;
+};
+
+TEST_F(SyncDirectoryTest, UploadsChangedFiles) {
+  ExpectList();
+  ExpectUploads();
+  EXPECT_CALL(*mock_, DeleteObject(_)).Times(0);
+
+  auto summary = SyncDirectory(*client_, directory_, kBucketName, "p/",
+                               MaxConcurrentTransfers(2));
+  ASSERT_STATUS_OK(summary);
+  EXPECT_STATUS_OK(summary->status());
+  EXPECT_THAT(uploaded_,
+              UnorderedElementsAre("p/changed.txt", "p/new.txt",
+                                   "p/resized.txt"));
+  EXPECT_THAT(summary->unchanged, ElementsAre("p/same.txt"));
+  EXPECT_THAT(summary->extraneous, ElementsAre("p/extra.txt"));
+}
+
+TEST_F(SyncDirectoryTest, DeleteExtraneous) {
+  ExpectList();
+  ExpectUploads();
+  EXPECT_CALL(*mock_, DeleteObject(_))
+      .WillOnce([](DeleteObjectRequest const& r) {
+        EXPECT_EQ(kBucketName, r.bucket_name());
+        EXPECT_EQ("p/extra.txt", r.object_name());
+        EXPECT_EQ(4, r.GetOption<IfGenerationMatch>().value_or(0));
+        return make_status_or(EmptyResponse{});
+      });
+
+  auto summary = SyncDirectory(*client_, directory_, kBucketName, "p/",
+                               DeleteExtraneousObjects(true));
+  ASSERT_STATUS_OK(summary);
+  EXPECT_STATUS_OK(summary->status());
+  EXPECT_THAT(summary->extraneous, ElementsAre("p/extra.txt"));
+}
+
+TEST_F(SyncDirectoryTest, ListError) {
+  EXPECT_CALL(*mock_, ListObjects(_))
+      .WillOnce(Return(StatusOr<ListObjectsResponse>(PermanentError())));
+  EXPECT_CALL(*mock_, InsertObjectMedia(_)).Times(0);
+
+  auto summary = SyncDirectory(*client_, directory_, kBucketName, "p/");
+  EXPECT_THAT(summary, StatusIs(PermanentError().code()));
+}
+#endif  // _WIN32
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
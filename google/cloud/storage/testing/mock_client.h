@@ -70,6 +70,9 @@ class MockClient : public google::cloud::storage::internal::RawClient {
                    internal::ReadObjectRangeRequest const&));
   MOCK_METHOD1(ListObjects, StatusOr<internal::ListObjectsResponse>(
                                 internal::ListObjectsRequest const&));
+  MOCK_METHOD1(ListObjectsCompact,
+               StatusOr<internal::ListObjectsCompactResponse>(
+                   internal::ListObjectsRequest const&));
   MOCK_METHOD1(DeleteObject, StatusOr<internal::EmptyResponse>(
                                  internal::DeleteObjectRequest const&));
   MOCK_METHOD1(UpdateObject, StatusOr<storage::ObjectMetadata>(
@@ -162,12 +165,25 @@ class MockClient : public google::cloud::storage::internal::RawClient {
   MOCK_METHOD1(DeleteNotification,
                StatusOr<internal::EmptyResponse>(
                    internal::DeleteNotificationRequest const&));
+  MOCK_METHOD0(WarmUpConnectionPool, Status());
   MOCK_METHOD1(
       AuthorizationHeader,
       StatusOr<std::string>(
           std::shared_ptr<google::cloud::storage::oauth2::Credentials> const&));
 };
 
+/**
+ * A `MockClient` that also mocks batch requests.
+ *
+ * Most tests do not use batch requests, and the default implementation in
+ * `RawClient` (which returns `kUnimplemented`) is a better default for them.
+ */
+class MockClientWithBatch : public MockClient {
+ public:
+  MOCK_METHOD1(ExecuteBatch, StatusOr<internal::BatchResponse>(
+                                 internal::BatchRequest const&));
+};
+
 class MockResumableUploadSession
     : public google::cloud::storage::internal::ResumableUploadSession {
  public:
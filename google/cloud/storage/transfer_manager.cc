@@ -0,0 +1,172 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/transfer_manager.h"
+#include "google/cloud/internal/strerror.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <thread>
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif  // _WIN32
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+
+double TransferSummary::bytes_per_second() const {
+  using seconds = std::chrono::duration<double>;
+  auto const s = std::chrono::duration_cast<seconds>(elapsed).count();
+  if (s <= 0) return 0;
+  return static_cast<double>(total_bytes) / s;
+}
+
+Status TransferSummary::status() const {
+  for (auto const& r : results) {
+    if (!r.status.ok()) return r.status;
+  }
+  return Status();
+}
+
+namespace internal {
+namespace {
+
+// Most transfers are small enough to be dominated by latency, more threads than
+// cores are needed to keep the connections busy.
+auto constexpr kDefaultMaxConcurrentTransfers = 16;
+
+#ifndef _WIN32
+Status ListDirectory(std::string const& directory,
+                     std::string const& relative_path,
+                     std::vector<std::string>& files) {
+  auto const path =
+      relative_path.empty() ? directory : directory + "/" + relative_path;
+  auto* dir = ::opendir(path.c_str());
+  if (dir == nullptr) {
+    auto const errnum = errno;
+    return Status(StatusCode::kNotFound,
+                  "ListDirectoryTransfers(" + path +
+                      "): cannot open directory: " +
+                      google::cloud::internal::strerror(errnum));
+  }
+  std::vector<std::string> subdirectories;
+  for (auto* entry = ::readdir(dir); entry != nullptr;
+       entry = ::readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name == "." || name == "..") continue;
+    auto relative = relative_path.empty() ? name : relative_path + "/" + name;
+    struct stat st;
+    if (::stat((path + "/" + name).c_str(), &st) != 0) continue;
+    if (S_ISDIR(st.st_mode)) {
+      subdirectories.push_back(std::move(relative));
+    } else if (S_ISREG(st.st_mode)) {
+      files.push_back(std::move(relative));
+    }
+  }
+  ::closedir(dir);
+  for (auto const& d : subdirectories) {
+    auto status = ListDirectory(directory, d, files);
+    if (!status.ok()) return status;
+  }
+  return Status();
+}
+#endif  // _WIN32
+
+}  // namespace
+
+void RunConcurrently(
+    std::size_t count,
+    absl::optional<MaxConcurrentTransfers> const& max_concurrent_transfers,
+    std::function<void(std::size_t)> const& work) {
+  std::atomic<std::size_t> next{0};
+  auto worker = [&] {
+    for (auto i = next++; i < count; i = next++) work(i);
+  };
+  auto const thread_count = (std::min)(
+      count, (std::max<std::size_t>)(
+                 1, max_concurrent_transfers
+                        .value_or(MaxConcurrentTransfers(
+                            kDefaultMaxConcurrentTransfers))
+                        .value()));
+  std::vector<std::thread> threads;
+  if (thread_count > 1) threads.reserve(thread_count - 1);
+  for (std::size_t i = 1; i < thread_count; ++i) threads.emplace_back(worker);
+  worker();
+  for (auto& t : threads) t.join();
+}
+
+TransferSummary RunFileTransfers(
+    std::vector<FileTransfer> const& transfers,
+    FileTransferFunction const& transfer,
+    absl::optional<MaxConcurrentTransfers> const& max_concurrent_transfers) {
+  auto const start = std::chrono::steady_clock::now();
+  TransferSummary summary;
+  summary.results.reserve(transfers.size());
+  for (auto const& t : transfers) {
+    summary.results.push_back(
+        FileTransferResult{t.file_name, t.object_name, Status(), 0});
+  }
+
+  RunConcurrently(transfers.size(), max_concurrent_transfers,
+                  [&](std::size_t i) {
+                    auto bytes = transfer(transfers[i]);
+                    auto& r = summary.results[i];
+                    if (!bytes) {
+                      r.status = std::move(bytes).status();
+                      return;
+                    }
+                    r.bytes = *bytes;
+                  });
+
+  for (auto const& r : summary.results) summary.total_bytes += r.bytes;
+  summary.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  return summary;
+}
+
+#ifndef _WIN32
+StatusOr<std::vector<FileTransfer>> ListDirectoryTransfers(
+    std::string const& directory, std::string const& prefix) {
+  std::vector<std::string> files;
+  auto status = ListDirectory(directory, std::string{}, files);
+  if (!status.ok()) return status;
+  std::sort(files.begin(), files.end());
+  std::vector<FileTransfer> transfers;
+  transfers.reserve(files.size());
+  for (auto const& f : files) {
+    transfers.push_back(FileTransfer{directory + "/" + f, prefix + f});
+  }
+  return transfers;
+}
+#else
+StatusOr<std::vector<FileTransfer>> ListDirectoryTransfers(
+    std::string const&, std::string const&) {
+  return Status(StatusCode::kUnimplemented,
+                "UploadDirectory() is not supported on Windows");
+}
+#endif  // _WIN32
+
+std::string TransferTemporaryPrefix(std::string const& object_name) {
+  return object_name + ".transfer";
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,328 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_TRANSFER_MANAGER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_TRANSFER_MANAGER_H
+
+#include "google/cloud/storage/client.h"
+#include "google/cloud/storage/internal/tuple_filter.h"
+#include "google/cloud/storage/parallel_download.h"
+#include "google/cloud/storage/parallel_upload.h"
+#include "google/cloud/storage/version.h"
+#include "google/cloud/internal/filesystem.h"
+#include "google/cloud/internal/tuple.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include "absl/types/optional.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * A parameter type indicating the maximum number of files transferred at the
+ * same time by `UploadFiles()`, `UploadDirectory()`, and `DownloadFiles()`.
+ */
+class MaxConcurrentTransfers {
+ public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  MaxConcurrentTransfers(std::size_t value) : value_(value) {}
+  std::size_t value() const { return value_; }
+
+ private:
+  std::size_t value_;
+};
+
+/// A single file to transfer, and the object it is transferred to (or from).
+struct FileTransfer {
+  std::string file_name;
+  std::string object_name;
+};
+
+/// The result of a single file transfer.
+struct FileTransferResult {
+  std::string file_name;
+  std::string object_name;
+  Status status;
+  /// The number of bytes transferred, `0` if the transfer failed.
+  std::int64_t bytes;
+};
+
+/// The results of `UploadFiles()`, `UploadDirectory()`, and `DownloadFiles()`.
+struct TransferSummary {
+  /// The result of each transfer, in the same order as the requested files.
+  std::vector<FileTransferResult> results;
+  /// The total number of bytes transferred by the successful transfers.
+  std::int64_t total_bytes = 0;
+  /// The wall time to complete all the transfers.
+  std::chrono::microseconds elapsed{0};
+
+  /// The aggregate throughput in bytes per second.
+  double bytes_per_second() const;
+
+  /// The status of the first failed transfer, or OK if all succeeded.
+  Status status() const;
+};
+
+namespace internal {
+
+/// Transfer a single file, returning the number of bytes transferred.
+using FileTransferFunction =
+    std::function<StatusOr<std::int64_t>(FileTransfer const&)>;
+
+/**
+ * Call @p work with each index in `[0, count)`, using at most
+ * @p max_concurrent_transfers threads, including the calling thread.
+ */
+void RunConcurrently(
+    std::size_t count,
+    absl::optional<MaxConcurrentTransfers> const& max_concurrent_transfers,
+    std::function<void(std::size_t)> const& work);
+
+/**
+ * Run @p transfers using a pool of at most @p max_concurrent_transfers worker
+ * threads.
+ */
+TransferSummary RunFileTransfers(
+    std::vector<FileTransfer> const& transfers,
+    FileTransferFunction const& transfer,
+    absl::optional<MaxConcurrentTransfers> const& max_concurrent_transfers);
+
+/**
+ * List the regular files under @p directory, recursively.
+ *
+ * The object names are the file paths relative to @p directory, using `/` as
+ * the separator, and prefixed with @p prefix.
+ */
+StatusOr<std::vector<FileTransfer>> ListDirectoryTransfers(
+    std::string const& directory, std::string const& prefix);
+
+/// The prefix for the temporary objects of a parallel upload to @p object.
+std::string TransferTemporaryPrefix(std::string const& object_name);
+
+/// Helper functor to call `Client::UploadFile()` via `apply`.
+struct UploadFileFunctor {
+  template <typename... Options>
+  StatusOr<ObjectMetadata> operator()(Options const&... options) const {
+    return client.UploadFile(transfer.file_name, bucket_name,
+                             transfer.object_name, options...);
+  }
+
+  Client& client;
+  std::string const& bucket_name;
+  FileTransfer const& transfer;
+};
+
+/// Helper functor to call `ParallelUploadFile()` via `apply`.
+struct ParallelUploadFileFunctor {
+  template <typename... Options>
+  StatusOr<ObjectMetadata> operator()(Options const&... options) const;
+
+  Client& client;
+  std::string const& bucket_name;
+  FileTransfer const& transfer;
+};
+
+/// Helper functor to call `ParallelDownloadFile()` via `apply`.
+struct ParallelDownloadFileFunctor {
+  template <typename... Options>
+  Status operator()(Options const&... options) const {
+    return ParallelDownloadFile(client, bucket_name, transfer.object_name,
+                                transfer.file_name, options...);
+  }
+
+  Client& client;
+  std::string const& bucket_name;
+  FileTransfer const& transfer;
+};
+
+template <typename... Options>
+StatusOr<ObjectMetadata> ParallelUploadFileFunctor::operator()(
+    Options const&... options) const {
+  return ParallelUploadFile(client, transfer.file_name, bucket_name,
+                            transfer.object_name,
+                            TransferTemporaryPrefix(transfer.object_name),
+                            /*ignore_cleanup_failures=*/false, options...);
+}
+
+}  // namespace internal
+
+/**
+ * Upload multiple files to Cloud Storage concurrently.
+ *
+ * Uploading many files with `Client::UploadFile()` one at a time is dominated
+ * by the latency of each request. This function runs the uploads on a pool of
+ * worker threads (see `MaxConcurrentTransfers`), all sharing @p client, and
+ * therefore its connection pool.
+ *
+ * Each file is uploaded with the strategy that best fits its size. Files that
+ * `ParallelUploadFile()` would split into more than one shard (see
+ * `MaxStreams` and `MinStreamSize`) are uploaded with `ParallelUploadFile()`,
+ * other files are uploaded with `Client::UploadFile()`, which selects a simple
+ * or resumable upload based on
+ * `ClientOptions::maximum_simple_upload_size()`.
+ *
+ * @param client the client on which to perform the operations.
+ * @param bucket_name the name of the bucket that will contain the objects.
+ * @param files the files to upload, and the names of the objects created for
+ *   each one.
+ * @param options a list of optional query parameters and/or request headers.
+ *   Valid types for this operation include `DestinationPredefinedAcl`,
+ *   `EncryptionKey`, `IfGenerationMatch`, `IfMetagenerationMatch`,
+ *   `KmsKeyName`, `MaxConcurrentTransfers`, `MaxStreams`, `MinStreamSize`,
+ *   `QuotaUser`, `UserIp`, `UserProject`, and `WithObjectMetadata`.
+ *
+ * @return the status of each upload and the aggregate throughput. A failed
+ *   upload does not stop the other uploads.
+ *
+ * @par Idempotency
+ * This operation is not idempotent. Each upload is retried based on the client
+ * policies, as described in `Client::UploadFile()` and `ParallelUploadFile()`.
+ */
+template <typename... Options>
+TransferSummary UploadFiles(Client client, std::string const& bucket_name,
+                            std::vector<FileTransfer> const& files,
+                            Options&&... options) {
+  auto const max_concurrent_transfers =
+      internal::ExtractFirstOccurenceOfType<MaxConcurrentTransfers>(
+          std::tie(options...));
+  auto const parallel_options = internal::StaticTupleFilter<
+      internal::NotAmong<MaxConcurrentTransfers>::TPred>(
+      std::make_tuple(options...));
+  auto const upload_options = internal::StaticTupleFilter<
+      internal::NotAmong<MaxConcurrentTransfers, MaxStreams,
+                         MinStreamSize>::TPred>(std::make_tuple(options...));
+
+  auto upload = [&](FileTransfer const& t) -> StatusOr<std::int64_t> {
+    std::error_code ec;
+    auto const file_size = google::cloud::internal::file_size(t.file_name, ec);
+    if (ec) {
+      return Status(StatusCode::kNotFound, "UploadFiles(" + t.file_name +
+                                               "): cannot get file size: " +
+                                               ec.message());
+    }
+    auto const use_parallel = !internal::ComputeParallelFileUploadSplitPoints(
+                                   file_size, parallel_options)
+                                   .empty();
+    auto metadata =
+        use_parallel
+            ? google::cloud::internal::apply(
+                  internal::ParallelUploadFileFunctor{client, bucket_name, t},
+                  parallel_options)
+            : google::cloud::internal::apply(
+                  internal::UploadFileFunctor{client, bucket_name, t},
+                  upload_options);
+    if (!metadata) return std::move(metadata).status();
+    return static_cast<std::int64_t>(metadata->size());
+  };
+  return internal::RunFileTransfers(files, upload, max_concurrent_transfers);
+}
+
+/**
+ * Upload all the files in a directory tree to Cloud Storage concurrently.
+ *
+ * This function walks @p directory recursively and uploads each regular file
+ * using `UploadFiles()`. The name of each object is @p prefix followed by the
+ * path of the file relative to @p directory, using `/` as the separator.
+ *
+ * @param client the client on which to perform the operations.
+ * @param directory the directory containing the files to upload.
+ * @param bucket_name the name of the bucket that will contain the objects.
+ * @param prefix the prefix for all the object names, typically empty or ending
+ *   in `/`.
+ * @param options a list of optional query parameters and/or request headers,
+ *   the valid types are the same as in `UploadFiles()`.
+ *
+ * @return an error if the directory cannot be listed, otherwise the status of
+ *   each upload and the aggregate throughput.
+ *
+ * @par Idempotency
+ * This operation is not idempotent, see `UploadFiles()`.
+ */
+template <typename... Options>
+StatusOr<TransferSummary> UploadDirectory(Client client,
+                                          std::string const& directory,
+                                          std::string const& bucket_name,
+                                          std::string const& prefix,
+                                          Options&&... options) {
+  auto files = internal::ListDirectoryTransfers(directory, prefix);
+  if (!files) return std::move(files).status();
+  return UploadFiles(std::move(client), bucket_name, *files,
+                     std::forward<Options>(options)...);
+}
+
+/**
+ * Download multiple Cloud Storage objects to files concurrently.
+ *
+ * The downloads run on a pool of worker threads (see
+ * `MaxConcurrentTransfers`), all sharing @p client, and therefore its
+ * connection pool. Each object is downloaded with `ParallelDownloadFile()`,
+ * which reads small objects with a single stream, and splits large objects
+ * into slices (see `MaxStreams` and `MinStreamSize`).
+ *
+ * @param client the client on which to perform the operations.
+ * @param bucket_name the name of the bucket that contains the objects.
+ * @param files the objects to download, and the name of the destination file
+ *   for each one. The destination files are truncated if they exist.
+ * @param options a list of optional query parameters and/or request headers.
+ *   Valid types for this operation include `DisableCrc32cChecksum`,
+ *   `EncryptionKey`, `IfGenerationMatch`, `IfGenerationNotMatch`,
+ *   `IfMetagenerationMatch`, `IfMetagenerationNotMatch`,
+ *   `MaxConcurrentTransfers`, `MaxStreams`, `MinStreamSize`, and
+ *   `UserProject`.
+ *
+ * @return the status of each download and the aggregate throughput. A failed
+ *   download does not stop the other downloads.
+ *
+ * @par Idempotency
+ * This is a read-only operation and is always idempotent.
+ */
+template <typename... Options>
+TransferSummary DownloadFiles(Client client, std::string const& bucket_name,
+                              std::vector<FileTransfer> const& files,
+                              Options&&... options) {
+  auto const max_concurrent_transfers =
+      internal::ExtractFirstOccurenceOfType<MaxConcurrentTransfers>(
+          std::tie(options...));
+  auto const download_options = internal::StaticTupleFilter<
+      internal::NotAmong<MaxConcurrentTransfers>::TPred>(
+      std::make_tuple(options...));
+
+  auto download = [&](FileTransfer const& t) -> StatusOr<std::int64_t> {
+    auto status = google::cloud::internal::apply(
+        internal::ParallelDownloadFileFunctor{client, bucket_name, t},
+        download_options);
+    if (!status.ok()) return status;
+    std::error_code ec;
+    auto const size = google::cloud::internal::file_size(t.file_name, ec);
+    if (ec) return std::int64_t{0};
+    return static_cast<std::int64_t>(size);
+  };
+  return internal::RunFileTransfers(files, download, max_concurrent_transfers);
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_TRANSFER_MANAGER_H
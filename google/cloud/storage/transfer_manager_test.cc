@@ -0,0 +1,184 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/transfer_manager.h"
+#include "google/cloud/storage/internal/object_metadata_parser.h"
+#include "google/cloud/storage/oauth2/google_credentials.h"
+#include "google/cloud/storage/retry_policy.h"
+#include "google/cloud/storage/testing/canonical_errors.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include "google/cloud/storage/testing/random_names.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::storage::testing::canonical_errors::PermanentError;
+using ::google::cloud::testing_util::StatusIs;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::ReturnRef;
+using ::testing::UnorderedElementsAre;
+
+std::string const kBucketName = "test-bucket";
+
+void WriteFile(std::string const& name, std::string const& contents) {
+  std::ofstream os(name, std::ios::binary | std::ios::trunc);
+  os.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+TEST(TransferManager, RunFileTransfers) {
+  std::vector<FileTransfer> const transfers{
+      {"f0", "o0"}, {"f1", "o1"}, {"f2", "o2"}, {"f3", "o3"}};
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  auto transfer = [&](FileTransfer const& t) -> StatusOr<std::int64_t> {
+    auto const r = ++running;
+    for (auto m = max_running.load(); m < r;) {
+      if (max_running.compare_exchange_weak(m, r)) break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    --running;
+    if (t.file_name == "f2") return PermanentError();
+    return static_cast<std::int64_t>(100 * t.file_name.size());
+  };
+
+  auto summary =
+      RunFileTransfers(transfers, transfer, MaxConcurrentTransfers(2));
+  ASSERT_EQ(4, summary.results.size());
+  for (std::size_t i = 0; i != transfers.size(); ++i) {
+    EXPECT_EQ(transfers[i].file_name, summary.results[i].file_name);
+    EXPECT_EQ(transfers[i].object_name, summary.results[i].object_name);
+  }
+  EXPECT_STATUS_OK(summary.results[0].status);
+  EXPECT_EQ(200, summary.results[0].bytes);
+  EXPECT_THAT(summary.results[2].status, StatusIs(PermanentError().code()));
+  EXPECT_EQ(0, summary.results[2].bytes);
+  EXPECT_EQ(600, summary.total_bytes);
+  EXPECT_THAT(summary.status(), StatusIs(PermanentError().code()));
+  EXPECT_LE(max_running.load(), 2);
+  EXPECT_LT(0, summary.elapsed.count());
+  EXPECT_LT(0, summary.bytes_per_second());
+}
+
+TEST(TransferManager, RunFileTransfersEmpty) {
+  auto summary = RunFileTransfers(
+      {}, [](FileTransfer const&) { return StatusOr<std::int64_t>(0); },
+      absl::nullopt);
+  EXPECT_TRUE(summary.results.empty());
+  EXPECT_STATUS_OK(summary.status());
+  EXPECT_EQ(0, summary.total_bytes);
+}
+
+#ifndef _WIN32
+TEST(TransferManager, ListDirectoryTransfers) {
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  auto const dir = testing::MakeRandomFileName(generator);
+  ASSERT_EQ(0, ::mkdir(dir.c_str(), 0755));
+  ASSERT_EQ(0, ::mkdir((dir + "/sub").c_str(), 0755));
+  WriteFile(dir + "/a.txt", "a");
+  WriteFile(dir + "/sub/b.txt", "b");
+
+  auto transfers = ListDirectoryTransfers(dir, "prefix/");
+  ASSERT_STATUS_OK(transfers);
+  std::vector<std::string> object_names;
+  for (auto const& t : *transfers) {
+    object_names.push_back(t.object_name);
+    EXPECT_EQ(dir + "/" + t.object_name.substr(7), t.file_name);
+  }
+  EXPECT_THAT(object_names, ElementsAre("prefix/a.txt", "prefix/sub/b.txt"));
+
+  (void)std::remove((dir + "/sub/b.txt").c_str());
+  (void)std::remove((dir + "/a.txt").c_str());
+  (void)::rmdir((dir + "/sub").c_str());
+  (void)::rmdir(dir.c_str());
+
+  EXPECT_THAT(ListDirectoryTransfers(dir, ""),
+              StatusIs(StatusCode::kNotFound));
+}
+#endif  // _WIN32
+
+TEST(TransferManager, UploadFiles) {
+  auto mock = std::make_shared<testing::MockClient>();
+  auto const client_options =
+      ClientOptions(oauth2::CreateAnonymousCredentials());
+  EXPECT_CALL(*mock, client_options())
+      .WillRepeatedly(ReturnRef(client_options));
+  Client client{std::shared_ptr<internal::RawClient>(mock),
+                LimitedErrorCountRetryPolicy(2)};
+
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  std::vector<FileTransfer> files;
+  for (auto const* object_name : {"o1", "o2", "o3"}) {
+    auto file_name = testing::MakeRandomFileName(generator);
+    WriteFile(file_name, std::string(object_name) + "-contents");
+    files.push_back(FileTransfer{std::move(file_name), object_name});
+  }
+  files.push_back(FileTransfer{testing::MakeRandomFileName(generator), "o4"});
+
+  std::mutex mu;
+  std::set<std::string> uploaded;
+  EXPECT_CALL(*mock, InsertObjectMedia(_))
+      .WillRepeatedly([&](InsertObjectMediaRequest const& r) {
+        EXPECT_EQ(kBucketName, r.bucket_name());
+        EXPECT_EQ("test-project", r.GetOption<UserProject>().value_or(""));
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          uploaded.insert(r.object_name());
+        }
+        return internal::ObjectMetadataParser::FromJson(nlohmann::json{
+            {"bucket", r.bucket_name()},
+            {"name", r.object_name()},
+            {"size", r.contents().size()},
+        });
+      });
+
+  auto summary = UploadFiles(client, kBucketName, files,
+                             MaxConcurrentTransfers(2),
+                             UserProject("test-project"));
+  ASSERT_EQ(4, summary.results.size());
+  for (std::size_t i = 0; i != 3; ++i) {
+    EXPECT_STATUS_OK(summary.results[i].status);
+    EXPECT_EQ(11, summary.results[i].bytes);
+  }
+  EXPECT_THAT(summary.results[3].status, StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(33, summary.total_bytes);
+  EXPECT_THAT(uploaded, UnorderedElementsAre("o1", "o2", "o3"));
+
+  for (auto const& f : files) (void)std::remove(f.file_name.c_str());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -18,6 +18,7 @@
 #include "google/cloud/storage/internal/complex_option.h"
 #include "google/cloud/storage/version.h"
 #include "google/cloud/storage/well_known_headers.h"
+#include <cstddef>
 #include <string>
 
 namespace google {
@@ -93,6 +94,73 @@ struct UploadLimit
   static char const* name() { return "upload-limit"; }
 };
 
+/**
+ * Adapt the chunk size of resumable uploads to the observed throughput.
+ *
+ * By default resumable uploads send chunks of
+ * `ClientOptions::upload_buffer_size()` bytes. With this option the chunk size
+ * starts at that value, grows while the measured throughput improves, and
+ * shrinks after chunks that required retries. The value of the option is the
+ * maximum chunk size, which bounds the memory used by the upload buffers.
+ * Larger chunks are useful on links with a high bandwidth-delay product, while
+ * smaller chunks reduce the amount of data resent on lossy links.
+ */
+struct AdaptiveUploadChunkSize
+    : public internal::ComplexOption<AdaptiveUploadChunkSize, std::size_t> {
+  using ComplexOption::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  AdaptiveUploadChunkSize() = default;
+  static char const* name() { return "adaptive-upload-chunk-size"; }
+};
+
+/**
+ * Upload the data written to an `ObjectWriteStream` in a background thread.
+ *
+ * By default `ObjectWriteStream` uploads each chunk in the thread writing to
+ * the stream, and the application cannot write more data until the upload
+ * completes. With this option full buffers are handed to a background thread,
+ * and the application continues writing into a new buffer. The value of the
+ * option is the maximum number of buffers queued or being uploaded, once this
+ * limit is reached writing to the stream blocks until an upload completes. The
+ * stream uses at most one more buffer than this value, each of
+ * `ClientOptions::upload_buffer_size()` bytes.
+ *
+ * This option is ignored if its value is zero, and is not compatible with
+ * `AdaptiveUploadChunkSize`, which is ignored when both are set.
+ */
+struct PipelinedUploadBuffers
+    : public internal::ComplexOption<PipelinedUploadBuffers, std::size_t> {
+  using ComplexOption::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  PipelinedUploadBuffers() = default;
+  static char const* name() { return "pipelined-upload-buffers"; }
+};
+
+/**
+ * Compress the data written to an `ObjectWriteStream` using gzip.
+ *
+ * The data is compressed as the application writes it, using a bounded buffer,
+ * and the object is stored with `Content-Encoding: gzip`. The value of the
+ * option is the zlib compression level, from `1` (fastest) to `9` (best
+ * compression), or `-1` to use the zlib default. The checksums are computed
+ * over the compressed data, therefore this option is not compatible with
+ * `Crc32cChecksumValue` or `MD5HashValue`. Uploads using this option cannot be
+ * resumed with `UseResumableUploadSession`, as the state of the compressor is
+ * lost.
+ *
+ * @see `DecompressGzip` to download the object without decompressive
+ *     transcoding.
+ */
+struct GzipCompression : public internal::ComplexOption<GzipCompression, int> {
+  using ComplexOption::ComplexOption;
+  // GCC <= 7.0 does not use the inherited default constructor, redeclare it
+  // explicitly
+  GzipCompression() = default;
+  static char const* name() { return "gzip-compression"; }
+};
+
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
 }  // namespace cloud
@@ -129,6 +129,26 @@ struct DestinationKmsKeyName
 struct Fields : public internal::WellKnownParameter<Fields, std::string> {
   using WellKnownParameter<Fields, std::string>::WellKnownParameter;
   static char const* well_known_parameter_name() { return "fields"; }
+
+  /**
+   * Restricts the object fields returned by `Client::ListObjects()`.
+   *
+   * A partial response for `ListObjects()` must include the `nextPageToken`
+   * field, otherwise the iterator stops after the first page. This function
+   * returns a field mask with @p object_fields for each object, plus the
+   * fields required to iterate over all the pages, for example:
+   *
+   * @code
+   * auto reader = client.ListObjects(
+   *     "my-bucket", gcs::Fields::ListObjectsItems("name,size,crc32c"));
+   * @endcode
+   *
+   * The client library only populates the `ObjectMetadata` fields included in
+   * the response, all other fields retain their default values.
+   */
+  static Fields ListObjectsItems(std::string const& object_fields) {
+    return Fields("nextPageToken,prefixes,items(" + object_fields + ")");
+  }
 };
 
 /**
@@ -33,6 +33,11 @@ TEST(PredefinedAclHeaderNameTest, Simple) {
   EXPECT_EQ("SomeCustom", PredefinedAcl("SomeCustom").HeaderName());
 }
 
+TEST(FieldsTest, ListObjectsItems) {
+  EXPECT_EQ("nextPageToken,prefixes,items(name,size)",
+            Fields::ListObjectsItems("name,size").value());
+}
+
 TEST(WellKnownParameter, ValueOrEmptyCase) {
   KmsKeyName param;
   ASSERT_FALSE(param.has_value());
@@ -22,6 +22,7 @@
 #include <functional>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -54,9 +55,26 @@ namespace internal {
 template <typename T>
 using StreamReader = std::function<absl::variant<Status, T>()>;
 
+/**
+ * A function that returns the `T`s of a stream in batches, ending with a
+ * `Status`.
+ *
+ * This is an optional companion to `StreamReader<T>`, reading from the same
+ * underlying stream. Each call returns the elements not yet returned by either
+ * function: the rest of the current page if the `StreamReader<T>` returned
+ * some of its elements, or the next page otherwise. The batch may be empty
+ * only in the first case. The end-of-stream is indicated by returning a
+ * `Status`, as with `StreamReader<T>`.
+ */
+template <typename T>
+using StreamBatchReader =
+    std::function<absl::variant<Status, std::vector<T>>()>;
+
 // Defined below.
 template <typename T>
 StreamRange<T> MakeStreamRange(StreamReader<T>);
+template <typename T>
+StreamRange<T> MakeStreamRange(StreamReader<T>, StreamBatchReader<T>);
 
 }  // namespace internal
 
@@ -82,6 +100,20 @@ StreamRange<T> MakeStreamRange(StreamReader<T>);
  * }
  * @endcode
  *
+ * Callers processing large streams can also consume the range in batches,
+ * using `NextBatch()`. Paginated ranges return a whole page in each batch,
+ * avoiding the per-element overhead of the iterators.
+ *
+ * @par Example: Processing a range in batches
+ *
+ * @code
+ * StreamRange<int> sr = MakeRangeFromOneTo(10);
+ * for (auto batch = sr.NextBatch(); batch && !batch->empty();
+ *      batch = sr.NextBatch()) {
+ *   for (int x : *batch) std::cout << x << "\n";
+ * }
+ * @endcode
+ *
  * [input-iter-link]: https://en.cppreference.com/w/cpp/named_req/InputIterator
  */
 template <typename T>
@@ -91,7 +123,9 @@ class StreamRange {
   template <typename U>
   static constexpr bool IsMoveNoexcept() {
     return noexcept(StatusOr<U>(std::declval<U>()))&& noexcept(
-        internal::StreamReader<U>(std::declval<internal::StreamReader<U>>()));
+        internal::StreamReader<U>(std::declval<internal::StreamReader<U>>()))&&
+        noexcept(internal::StreamBatchReader<U>(
+            std::declval<internal::StreamBatchReader<U>>()));
   }
 
  public:
@@ -170,10 +204,78 @@ class StreamRange {
   StreamRange& operator=(StreamRange&&) noexcept(IsMoveNoexcept<T>()) = default;
   //@}
 
-  iterator begin() { return iterator(this); }
+  iterator begin() {
+    if (!primed_) {
+      primed_ = true;
+      Next();
+    }
+    return iterator(this);
+  }
   iterator end() { return iterator(); }
 
+  /**
+   * Returns the next batch of elements from the stream.
+   *
+   * The batch contains the elements not yet consumed, typically a page for
+   * paginated ranges, so the application can process them without the
+   * per-element overhead of the iterators. Ranges that cannot read in batches
+   * return one element at a time.
+   *
+   * Iterators obtained before calling this function are invalidated, call
+   * `begin()` again to continue iterating one element at a time.
+   *
+   * @return the next elements, an empty vector at the end of the stream, or
+   *     the error that ended the stream.
+   */
+  StatusOr<std::vector<T>> NextBatch() {
+    std::vector<T> batch;
+    if (!primed_) {
+      // The stream reader was not called since the last batch, so batches
+      // are only empty at the end of the stream.
+      return ReadBatch();
+    }
+    if (is_end_) return batch;
+    if (!current_) {
+      is_end_ = true;
+      return std::move(current_).status();
+    }
+    batch.push_back(*std::move(current_));
+    if (!batch_reader_) {
+      Next();
+      return batch;
+    }
+    auto rest = ReadBatch();
+    if (!rest) {
+      // Return the buffered element now, and the error on the next call.
+      is_end_ = false;
+      current_ = std::move(rest).status();
+      return batch;
+    }
+    batch.reserve(batch.size() + rest->size());
+    std::move(rest->begin(), rest->end(), std::back_inserter(batch));
+    return batch;
+  }
+
  private:
+  // Reads a batch, leaving `current_` unset until the next `begin()` or
+  // `NextBatch()`.
+  StatusOr<std::vector<T>> ReadBatch() {
+    struct UnpackVariant {
+      StreamRange& sr;
+      StatusOr<std::vector<T>> operator()(Status&& status) {
+        sr.primed_ = true;
+        sr.is_end_ = true;
+        if (!status.ok()) return std::move(status);
+        return std::vector<T>{};
+      }
+      StatusOr<std::vector<T>> operator()(std::vector<T>&& batch) {
+        sr.primed_ = false;
+        return std::move(batch);
+      }
+    };
+    return absl::visit(UnpackVariant{*this}, batch_reader_());
+  }
+
   void Next() {
     // Jump to the end if we previously got an error.
     if (!is_end_ && !current_) {
@@ -197,6 +299,9 @@ class StreamRange {
 
   template <typename U>
   friend StreamRange<U> internal::MakeStreamRange(internal::StreamReader<U>);
+  template <typename U>
+  friend StreamRange<U> internal::MakeStreamRange(
+      internal::StreamReader<U>, internal::StreamBatchReader<U>);
 
   /**
    * Constructs a `StreamRange<T>` that will use the given @p reader.
@@ -229,9 +334,25 @@ class StreamRange {
     Next();
   }
 
+  /**
+   * Constructs a `StreamRange<T>` that also supports `NextBatch()`.
+   *
+   * Both @p reader and @p batch_reader must read from the same stream, see
+   * `internal::StreamBatchReader` for details.
+   */
+  StreamRange(internal::StreamReader<T> reader,
+              internal::StreamBatchReader<T> batch_reader)
+      : reader_(std::move(reader)), batch_reader_(std::move(batch_reader)) {
+    Next();
+  }
+
   internal::StreamReader<T> reader_;
+  internal::StreamBatchReader<T> batch_reader_;
   StatusOr<T> current_;
   bool is_end_ = true;
+  // False after `NextBatch()` consumed all the elements read so far, the next
+  // element has not been read into `current_`.
+  bool primed_ = true;
 };
 
 namespace internal {
@@ -252,6 +373,17 @@ StreamRange<T> MakeStreamRange(StreamReader<T> reader) {
   return StreamRange<T>{std::move(reader)};
 }
 
+/**
+ * Factory to construct a `StreamRange<T>` supporting `NextBatch()`.
+ *
+ * As above, callers should explicitly specify the `T` parameter.
+ */
+template <typename T>
+StreamRange<T> MakeStreamRange(StreamReader<T> reader,
+                               StreamBatchReader<T> batch_reader) {
+  return StreamRange<T>{std::move(reader), std::move(batch_reader)};
+}
+
 }  // namespace internal
 
 }  // namespace GOOGLE_CLOUD_CPP_NS
@@ -13,10 +13,12 @@
 // limitations under the License.
 
 #include "google/cloud/stream_range.h"
+#include "google/cloud/testing_util/assert_ok.h"
 #include "google/cloud/testing_util/status_matchers.h"
 #include "absl/memory/memory.h"
 #include <gmock/gmock.h>
 #include <deque>
+#include <memory>
 #include <vector>
 
 namespace google {
@@ -170,6 +172,134 @@ TEST(StreamRange, StreamError) {
   EXPECT_EQ(it, sr.end());
 }
 
+// Returns a range over @p pages, read both one element at a time and in
+// batches, which ends with @p last.
+StreamRange<int> MakeBatchRange(std::deque<std::deque<int>> pages,
+                                Status last = Status{}) {
+  struct State {
+    std::deque<std::deque<int>> pages;
+    Status last;
+    bool partial;
+  };
+  auto state = std::make_shared<State>(
+      State{std::move(pages), std::move(last), false});
+  auto reader = [state]() -> internal::StreamReader<int>::result_type {
+    while (!state->pages.empty() && state->pages.front().empty()) {
+      state->pages.pop_front();
+    }
+    if (state->pages.empty()) return state->last;
+    state->partial = true;
+    auto v = state->pages.front().front();
+    state->pages.front().pop_front();
+    return v;
+  };
+  auto batch_reader =
+      [state]() -> internal::StreamBatchReader<int>::result_type {
+    auto const partial = state->partial;
+    state->partial = false;
+    if (partial && !state->pages.empty() && state->pages.front().empty()) {
+      return std::vector<int>{};
+    }
+    while (!state->pages.empty() && state->pages.front().empty()) {
+      state->pages.pop_front();
+    }
+    if (state->pages.empty()) return state->last;
+    std::vector<int> batch(state->pages.front().begin(),
+                           state->pages.front().end());
+    state->pages.pop_front();
+    return batch;
+  };
+  return internal::MakeStreamRange<int>(std::move(reader),
+                                        std::move(batch_reader));
+}
+
+TEST(StreamRange, NextBatchDefaultConstructed) {
+  StreamRange<int> sr;
+  auto batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_TRUE(batch->empty());
+}
+
+TEST(StreamRange, NextBatchWithoutBatchReader) {
+  auto counter = 0;
+  StreamRange<int> sr = internal::MakeStreamRange<int>(
+      [&counter]() -> internal::StreamReader<int>::result_type {
+        if (counter++ < 2) return counter;
+        return Status{};
+      });
+  auto batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(1));
+  batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(2));
+  batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_TRUE(batch->empty());
+}
+
+TEST(StreamRange, NextBatchReturnsPages) {
+  auto sr = MakeBatchRange({{1, 2, 3}, {4, 5}, {6}});
+  // The first element is read on construction, it is returned with the rest
+  // of its page.
+  auto batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(1, 2, 3));
+  batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(4, 5));
+  batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(6));
+  batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_TRUE(batch->empty());
+  EXPECT_EQ(sr.begin(), sr.end());
+}
+
+TEST(StreamRange, NextBatchMixedWithIterators) {
+  auto sr = MakeBatchRange({{1, 2, 3}, {4, 5}, {6}});
+  auto it = sr.begin();
+  EXPECT_EQ(1, **it);
+  ++it;
+  EXPECT_EQ(2, **it);
+  auto batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(2, 3));
+  it = sr.begin();
+  EXPECT_EQ(4, **it);
+  // The batches stay aligned with the pages.
+  batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(4, 5));
+  std::vector<int> rest;
+  for (auto& v : sr) rest.push_back(*v);
+  EXPECT_THAT(rest, ElementsAre(6));
+}
+
+TEST(StreamRange, NextBatchError) {
+  auto sr = MakeBatchRange({{1, 2}, {3}},
+                           Status(StatusCode::kUnknown, "oops"));
+  auto batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(1, 2));
+  batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(3));
+  EXPECT_THAT(sr.NextBatch(), StatusIs(StatusCode::kUnknown, "oops"));
+  batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_TRUE(batch->empty());
+}
+
+TEST(StreamRange, NextBatchErrorAfterBufferedElement) {
+  auto sr = MakeBatchRange({{1}}, Status(StatusCode::kUnknown, "oops"));
+  auto batch = sr.NextBatch();
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(*batch, ElementsAre(1));
+  EXPECT_THAT(sr.NextBatch(), StatusIs(StatusCode::kUnknown, "oops"));
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -0,0 +1,84 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/testing_util/benchmark_harness.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+namespace gcb = ::google::cloud::testing_util;
+
+google::cloud::StatusOr<std::vector<gcb::BenchmarkSummary>> Load(
+    std::string const& filename) {
+  std::ifstream is(filename);
+  if (!is) {
+    return google::cloud::Status(google::cloud::StatusCode::kNotFound,
+                                 "cannot open " + filename);
+  }
+  return gcb::ParseBenchmarkCsv(is);
+}
+
+}  // namespace
+
+/**
+ * Compare two benchmark runs, saved with `--output-format=csv`.
+ *
+ * Prints the change of the mean latency for each operation, and exits with
+ * a non-zero status if any operation regressed.
+ */
+int main(int argc, char* argv[]) try {
+  gcb::BenchmarkCompareOptions options;
+  std::vector<gcb::OptionDescriptor> desc{
+      {"--min-change", "ignore changes smaller than this fraction",
+       [&options](std::string const& v) { options.min_change = std::stod(v); }},
+      {"--critical-value", "the critical value for the t statistic",
+       [&options](std::string const& v) {
+         options.critical_value = std::stod(v);
+       }},
+  };
+  auto args = gcb::OptionsParse(desc, {argv, argv + argc});
+  if (args.size() != 3) {
+    std::cerr << gcb::BuildUsage(desc, argv[0])
+              << "    <baseline.csv> <candidate.csv>\n";
+    return 1;
+  }
+  auto baseline = Load(args[1]);
+  auto candidate = Load(args[2]);
+  for (auto const* r : {&baseline, &candidate}) {
+    if (r->ok()) continue;
+    std::cerr << r->status() << "\n";
+    return 1;
+  }
+
+  auto results = gcb::CompareBenchmarks(*baseline, *candidate, options);
+  bool regression = false;
+  std::cout << std::fixed << std::setprecision(2);
+  for (auto const& r : results) {
+    std::cout << r.operation << ": " << r.baseline_mean_us << "us -> "
+              << r.candidate_mean_us << "us (" << std::showpos
+              << 100 * r.change << "%" << std::noshowpos
+              << ", t=" << r.t_statistic << ")"
+              << (r.regression    ? " REGRESSION"
+                  : r.significant ? " significant"
+                                  : "")
+              << "\n";
+    regression = regression || r.regression;
+  }
+  return regression ? 2 : 0;
+} catch (std::exception const& ex) {
+  std::cerr << "Standard exception raised: " << ex.what() << "\n";
+  return 1;
+}
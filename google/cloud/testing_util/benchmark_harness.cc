@@ -0,0 +1,311 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/testing_util/benchmark_harness.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include "absl/strings/str_split.h"
+#include <cmath>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace testing_util {
+namespace {
+
+auto constexpr kCsvHeader =
+    "Operation,Count,MeanUs,StddevUs,MinUs,P50Us,P90Us,P99Us,P999Us,MaxUs,"
+    "OpsPerSecond,BytesPerSecond";
+
+std::string JsonEscape(std::string const& value) {
+  std::ostringstream os;
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << static_cast<int>(c) << std::dec;
+        } else {
+          os << c;
+        }
+    }
+  }
+  return std::move(os).str();
+}
+
+void WriteText(std::ostream& os, BenchmarkFlags const& flags,
+               std::vector<BenchmarkSummary> const& results) {
+  for (auto const& l : flags.labels) {
+    os << "# " << l.first << ": " << l.second << "\n";
+  }
+  for (auto const& r : results) {
+    os << r.operation << ": count=" << r.count << ", mean=" << r.mean_us
+       << "us, stddev=" << r.stddev_us << "us, min=" << r.min_us
+       << "us, p50=" << r.p50_us << "us, p90=" << r.p90_us
+       << "us, p99=" << r.p99_us << "us, p99.9=" << r.p999_us
+       << "us, max=" << r.max_us << "us, ops/s=" << r.ops_per_second
+       << ", bytes/s=" << r.bytes_per_second << "\n";
+  }
+}
+
+void WriteJson(std::ostream& os, BenchmarkFlags const& flags,
+               std::vector<BenchmarkSummary> const& results) {
+  os << "{\"labels\":{";
+  char const* sep = "";
+  for (auto const& l : flags.labels) {
+    os << sep << '"' << JsonEscape(l.first) << "\":\"" << JsonEscape(l.second)
+       << '"';
+    sep = ",";
+  }
+  os << "},\"results\":[";
+  sep = "";
+  for (auto const& r : results) {
+    os << sep << "{\"operation\":\"" << JsonEscape(r.operation) << '"'
+       << ",\"count\":" << r.count << ",\"mean_us\":" << r.mean_us
+       << ",\"stddev_us\":" << r.stddev_us << ",\"min_us\":" << r.min_us
+       << ",\"p50_us\":" << r.p50_us << ",\"p90_us\":" << r.p90_us
+       << ",\"p99_us\":" << r.p99_us << ",\"p999_us\":" << r.p999_us
+       << ",\"max_us\":" << r.max_us
+       << ",\"ops_per_second\":" << r.ops_per_second
+       << ",\"bytes_per_second\":" << r.bytes_per_second << "}";
+    sep = ",";
+  }
+  os << "]}\n";
+}
+
+Status WriteCsv(std::ostream& os, BenchmarkFlags const& flags,
+                std::vector<BenchmarkSummary> const& results) {
+  for (auto const& r : results) {
+    if (r.operation.find_first_of(",\n") != std::string::npos) {
+      return Status(StatusCode::kInvalidArgument,
+                    "operation names in CSV output cannot contain commas or "
+                    "newlines: " +
+                        r.operation);
+    }
+  }
+  for (auto const& l : flags.labels) {
+    os << "# " << l.first << "=" << l.second << "\n";
+  }
+  os << kCsvHeader << "\n";
+  for (auto const& r : results) {
+    os << r.operation << ',' << r.count << ',' << r.mean_us << ','
+       << r.stddev_us << ',' << r.min_us << ',' << r.p50_us << ','
+       << r.p90_us << ',' << r.p99_us << ',' << r.p999_us << ',' << r.max_us
+       << ',' << r.ops_per_second << ',' << r.bytes_per_second << "\n";
+  }
+  return Status{};
+}
+
+}  // namespace
+
+void AddBenchmarkOptions(std::vector<OptionDescriptor>& desc,
+                         BenchmarkFlags& flags) {
+  auto* f = &flags;
+  desc.push_back({"--warmup", "discard the samples from this initial period",
+                  [f](std::string const& v) { f->warmup = ParseDuration(v); }});
+  desc.push_back({"--duration", "run the benchmark for this long",
+                  [f](std::string const& v) {
+                    f->duration = ParseDuration(v);
+                  }});
+  desc.push_back({"--output-format", "text, json, or csv",
+                  [f](std::string const& v) { f->output_format = v; }});
+  desc.push_back({"--output-file", "write the results to this file",
+                  [f](std::string const& v) { f->output_file = v; }});
+  desc.push_back({"--label", "describe the run, e.g. --label=version=1.2.3",
+                  [f](std::string const& v) {
+                    auto const pos = v.find('=');
+                    if (pos == std::string::npos) {
+                      internal::ThrowInvalidArgument("invalid label: " + v);
+                    }
+                    f->labels.emplace_back(v.substr(0, pos),
+                                           v.substr(pos + 1));
+                  }});
+}
+
+Status ValidateBenchmarkFlags(BenchmarkFlags const& flags) {
+  if (flags.output_format != "text" && flags.output_format != "json" &&
+      flags.output_format != "csv") {
+    return Status(StatusCode::kInvalidArgument,
+                  "invalid --output-format: " + flags.output_format);
+  }
+  if (flags.warmup.count() < 0) {
+    return Status(StatusCode::kInvalidArgument, "negative --warmup");
+  }
+  if (flags.duration.count() <= 0) {
+    return Status(StatusCode::kInvalidArgument, "--duration must be positive");
+  }
+  return Status{};
+}
+
+BenchmarkRecorder::BenchmarkRecorder(std::chrono::microseconds warmup,
+                                     ClockFunction clock)
+    : clock_(std::move(clock)), measurement_start_(clock_() + warmup) {}
+
+bool BenchmarkRecorder::warming_up() const {
+  return clock_() < measurement_start_;
+}
+
+void BenchmarkRecorder::Record(std::string const& operation,
+                               std::chrono::microseconds latency,
+                               std::int64_t bytes) {
+  if (warming_up()) return;
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& op = operations_[operation];
+  op.latency.Record(latency.count());
+  op.bytes += bytes;
+}
+
+std::vector<BenchmarkSummary> BenchmarkRecorder::Summarize() const {
+  auto const elapsed = std::chrono::duration<double>(
+      clock_() - measurement_start_);
+  std::lock_guard<std::mutex> lk(mu_);
+  std::vector<BenchmarkSummary> results;
+  results.reserve(operations_.size());
+  for (auto const& kv : operations_) {
+    auto const& h = kv.second.latency;
+    BenchmarkSummary s;
+    s.operation = kv.first;
+    s.count = h.count();
+    s.mean_us = h.mean();
+    s.stddev_us = h.stddev();
+    s.min_us = h.min();
+    s.p50_us = h.ValueAtPercentile(50);
+    s.p90_us = h.ValueAtPercentile(90);
+    s.p99_us = h.ValueAtPercentile(99);
+    s.p999_us = h.ValueAtPercentile(99.9);
+    s.max_us = h.max();
+    if (elapsed.count() > 0) {
+      s.ops_per_second = static_cast<double>(h.count()) / elapsed.count();
+      s.bytes_per_second =
+          static_cast<double>(kv.second.bytes) / elapsed.count();
+    }
+    results.push_back(std::move(s));
+  }
+  return results;
+}
+
+Status WriteBenchmarkResults(std::ostream& os, BenchmarkFlags const& flags,
+                             std::vector<BenchmarkSummary> const& results) {
+  auto status = ValidateBenchmarkFlags(flags);
+  if (!status.ok()) return status;
+  if (flags.output_format == "text") {
+    WriteText(os, flags, results);
+    return Status{};
+  }
+  // Keep enough digits in the machine-readable formats to compare runs.
+  auto const precision = os.precision(15);
+  if (flags.output_format == "json") {
+    WriteJson(os, flags, results);
+  } else {
+    status = WriteCsv(os, flags, results);
+  }
+  os.precision(precision);
+  return status;
+}
+
+StatusOr<std::vector<BenchmarkSummary>> ParseBenchmarkCsv(std::istream& is) {
+  std::vector<BenchmarkSummary> results;
+  bool header = false;
+  std::string line;
+  while (std::getline(is, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    if (!header) {
+      if (line != kCsvHeader) {
+        return Status(StatusCode::kInvalidArgument,
+                      "unexpected CSV header: " + line);
+      }
+      header = true;
+      continue;
+    }
+    std::vector<std::string> fields = absl::StrSplit(line, ',');
+    if (fields.size() != 12) {
+      return Status(StatusCode::kInvalidArgument,
+                    "unexpected number of fields in: " + line);
+    }
+    BenchmarkSummary s;
+    try {
+      s.operation = fields[0];
+      s.count = std::stoll(fields[1]);
+      s.mean_us = std::stod(fields[2]);
+      s.stddev_us = std::stod(fields[3]);
+      s.min_us = std::stoll(fields[4]);
+      s.p50_us = std::stoll(fields[5]);
+      s.p90_us = std::stoll(fields[6]);
+      s.p99_us = std::stoll(fields[7]);
+      s.p999_us = std::stoll(fields[8]);
+      s.max_us = std::stoll(fields[9]);
+      s.ops_per_second = std::stod(fields[10]);
+      s.bytes_per_second = std::stod(fields[11]);
+    } catch (std::exception const&) {
+      return Status(StatusCode::kInvalidArgument, "invalid number in: " + line);
+    }
+    results.push_back(std::move(s));
+  }
+  if (!header) {
+    return Status(StatusCode::kInvalidArgument, "missing CSV header");
+  }
+  return results;
+}
+
+std::vector<BenchmarkComparison> CompareBenchmarks(
+    std::vector<BenchmarkSummary> const& baseline,
+    std::vector<BenchmarkSummary> const& candidate,
+    BenchmarkCompareOptions const& options) {
+  std::map<std::string, BenchmarkSummary const*> index;
+  for (auto const& b : baseline) index[b.operation] = &b;
+
+  std::vector<BenchmarkComparison> results;
+  for (auto const& c : candidate) {
+    auto i = index.find(c.operation);
+    if (i == index.end()) continue;
+    auto const& b = *i->second;
+    if (b.count == 0 || c.count == 0) continue;
+    BenchmarkComparison r;
+    r.operation = c.operation;
+    r.baseline_mean_us = b.mean_us;
+    r.candidate_mean_us = c.mean_us;
+    if (b.mean_us > 0) r.change = (c.mean_us - b.mean_us) / b.mean_us;
+    auto const se = std::sqrt(
+        b.stddev_us * b.stddev_us / static_cast<double>(b.count) +
+        c.stddev_us * c.stddev_us / static_cast<double>(c.count));
+    auto const diff = c.mean_us - b.mean_us;
+    if (se > 0) {
+      r.t_statistic = diff / se;
+      r.significant = std::abs(r.t_statistic) > options.critical_value;
+    } else {
+      // Constant latencies, any difference is significant.
+      r.significant = diff != 0;
+    }
+    r.regression = r.significant && r.change > options.min_change;
+    results.push_back(std::move(r));
+  }
+  return results;
+}
+
+}  // namespace testing_util
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,175 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_BENCHMARK_HARNESS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_BENCHMARK_HARNESS_H
+
+#include "google/cloud/testing_util/command_line_parsing.h"
+#include "google/cloud/testing_util/hdr_histogram.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include "google/cloud/version.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace testing_util {
+
+/**
+ * The command-line flags shared by all the benchmarks.
+ *
+ * Each benchmark adds these flags to its own with `AddBenchmarkOptions()`, so
+ * all the benchmarks use the same names for the same concepts.
+ */
+struct BenchmarkFlags {
+  /// Discard the samples recorded during this initial period.
+  std::chrono::seconds warmup = std::chrono::seconds(0);
+  /// How long to run the benchmark, after the warm-up period.
+  std::chrono::seconds duration = std::chrono::seconds(60);
+  /// One of `text`, `json`, or `csv`.
+  std::string output_format = "text";
+  /// Where to write the results, `stdout` if empty.
+  std::string output_file;
+  /// Describe the run, e.g., `--label=version=1.23.0`.
+  std::vector<std::pair<std::string, std::string>> labels;
+};
+
+/**
+ * Append the options for @p flags to @p desc.
+ *
+ * The options are `--warmup`, `--duration`, `--output-format`,
+ * `--output-file`, and `--label` (which can be repeated).
+ */
+void AddBenchmarkOptions(std::vector<OptionDescriptor>& desc,
+                         BenchmarkFlags& flags);
+
+/// Validate the values in @p flags.
+Status ValidateBenchmarkFlags(BenchmarkFlags const& flags);
+
+/// The statistics for one operation in a benchmark run.
+struct BenchmarkSummary {
+  std::string operation;
+  std::int64_t count = 0;
+  double mean_us = 0;
+  double stddev_us = 0;
+  std::int64_t min_us = 0;
+  std::int64_t p50_us = 0;
+  std::int64_t p90_us = 0;
+  std::int64_t p99_us = 0;
+  std::int64_t p999_us = 0;
+  std::int64_t max_us = 0;
+  double ops_per_second = 0;
+  double bytes_per_second = 0;
+};
+
+/**
+ * Collects the latency of each operation in a benchmark.
+ *
+ * Samples recorded during the warm-up period are discarded. The throughput
+ * is computed over the time since the end of the warm-up period.
+ *
+ * @par Thread-safety
+ * Instances of this class are safe to use from multiple threads.
+ */
+class BenchmarkRecorder {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using ClockFunction = std::function<Clock::time_point()>;
+
+  explicit BenchmarkRecorder(std::chrono::microseconds warmup,
+                             ClockFunction clock = Clock::now);
+
+  /// Returns true until the warm-up period ends.
+  bool warming_up() const;
+
+  /// Record an operation, @p bytes is used to compute the throughput.
+  void Record(std::string const& operation, std::chrono::microseconds latency,
+              std::int64_t bytes = 0);
+
+  /// Summarize the samples recorded so far, sorted by operation.
+  std::vector<BenchmarkSummary> Summarize() const;
+
+ private:
+  struct Operation {
+    HdrHistogram latency;
+    std::int64_t bytes = 0;
+  };
+
+  ClockFunction const clock_;
+  Clock::time_point const measurement_start_;
+  mutable std::mutex mu_;
+  std::map<std::string, Operation> operations_;  // GUARDED_BY(mu_)
+};
+
+/// Write @p results in the format selected by @p flags.
+Status WriteBenchmarkResults(std::ostream& os, BenchmarkFlags const& flags,
+                             std::vector<BenchmarkSummary> const& results);
+
+/**
+ * Parse the results written by `WriteBenchmarkResults()` in `csv` format.
+ *
+ * Lines starting with `#` (the labels) are ignored.
+ */
+StatusOr<std::vector<BenchmarkSummary>> ParseBenchmarkCsv(std::istream& is);
+
+/// Configure `CompareBenchmarks()`.
+struct BenchmarkCompareOptions {
+  /// Ignore latency changes smaller than this fraction of the baseline.
+  double min_change = 0.05;
+  /// The critical value of the test statistic, 2.576 is a 99% confidence.
+  double critical_value = 2.576;
+};
+
+/// The comparison of the mean latency of one operation in two runs.
+struct BenchmarkComparison {
+  std::string operation;
+  double baseline_mean_us = 0;
+  double candidate_mean_us = 0;
+  /// The relative change of the mean latency, positive if slower.
+  double change = 0;
+  /// The Welch's t statistic for the difference of the means.
+  double t_statistic = 0;
+  /// The change is statistically significant.
+  bool significant = false;
+  /// The candidate is significantly slower, by more than `min_change`.
+  bool regression = false;
+};
+
+/**
+ * Compare the operations present in both @p baseline and @p candidate.
+ *
+ * The difference of the mean latencies is tested with Welch's t-test. The
+ * benchmarks record thousands of samples, so the t distribution is
+ * approximated by the normal distribution.
+ */
+std::vector<BenchmarkComparison> CompareBenchmarks(
+    std::vector<BenchmarkSummary> const& baseline,
+    std::vector<BenchmarkSummary> const& candidate,
+    BenchmarkCompareOptions const& options = {});
+
+}  // namespace testing_util
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_BENCHMARK_HARNESS_H
@@ -0,0 +1,176 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/testing_util/benchmark_harness.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/status_matchers.h"
+#include <gmock/gmock.h>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace testing_util {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Pair;
+
+using Clock = BenchmarkRecorder::Clock;
+
+BenchmarkSummary MakeSummary(std::string operation, double mean,
+                             double stddev, std::int64_t count = 1000) {
+  BenchmarkSummary s;
+  s.operation = std::move(operation);
+  s.count = count;
+  s.mean_us = mean;
+  s.stddev_us = stddev;
+  return s;
+}
+
+TEST(BenchmarkHarnessTest, ParseFlags) {
+  BenchmarkFlags flags;
+  std::vector<OptionDescriptor> desc;
+  AddBenchmarkOptions(desc, flags);
+  auto unparsed = OptionsParse(
+      desc, {"self", "--warmup=10s", "--duration=2m", "--output-format=csv",
+             "--output-file=out.csv", "--label=version=1.2.3",
+             "--label=region=us-east1", "--other=x"});
+  EXPECT_THAT(unparsed, ElementsAre("self", "--other=x"));
+  EXPECT_EQ(std::chrono::seconds(10), flags.warmup);
+  EXPECT_EQ(std::chrono::seconds(120), flags.duration);
+  EXPECT_EQ("csv", flags.output_format);
+  EXPECT_EQ("out.csv", flags.output_file);
+  EXPECT_THAT(flags.labels, ElementsAre(Pair("version", "1.2.3"),
+                                        Pair("region", "us-east1")));
+  EXPECT_STATUS_OK(ValidateBenchmarkFlags(flags));
+
+  flags.output_format = "xml";
+  EXPECT_THAT(ValidateBenchmarkFlags(flags),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(BenchmarkHarnessTest, RecorderDiscardsWarmup) {
+  auto now = Clock::time_point{};
+  BenchmarkRecorder recorder(std::chrono::seconds(1), [&now] { return now; });
+  EXPECT_TRUE(recorder.warming_up());
+  recorder.Record("read", std::chrono::microseconds(1000000), 100);
+
+  now += std::chrono::seconds(1);
+  EXPECT_FALSE(recorder.warming_up());
+  recorder.Record("read", std::chrono::microseconds(100), 1000);
+  recorder.Record("read", std::chrono::microseconds(300), 1000);
+  recorder.Record("write", std::chrono::microseconds(50));
+  now += std::chrono::seconds(2);
+
+  auto results = recorder.Summarize();
+  ASSERT_EQ(2, results.size());
+  EXPECT_EQ("read", results[0].operation);
+  EXPECT_EQ(2, results[0].count);
+  EXPECT_DOUBLE_EQ(200, results[0].mean_us);
+  EXPECT_EQ(100, results[0].min_us);
+  EXPECT_EQ(300, results[0].max_us);
+  EXPECT_DOUBLE_EQ(1, results[0].ops_per_second);
+  EXPECT_DOUBLE_EQ(1000, results[0].bytes_per_second);
+  EXPECT_EQ("write", results[1].operation);
+  EXPECT_EQ(1, results[1].count);
+}
+
+TEST(BenchmarkHarnessTest, CsvRoundTrip) {
+  BenchmarkFlags flags;
+  flags.output_format = "csv";
+  flags.labels = {{"version", "1.2.3"}};
+  auto s = MakeSummary("read", 123.456789, 12.5);
+  s.p50_us = 120;
+  s.p999_us = 400;
+  s.ops_per_second = 8100.25;
+  std::ostringstream os;
+  ASSERT_STATUS_OK(WriteBenchmarkResults(os, flags, {s}));
+  EXPECT_THAT(os.str(), HasSubstr("# version=1.2.3\n"));
+
+  std::istringstream is(os.str());
+  auto parsed = ParseBenchmarkCsv(is);
+  ASSERT_STATUS_OK(parsed);
+  ASSERT_EQ(1, parsed->size());
+  auto const& p = parsed->front();
+  EXPECT_EQ("read", p.operation);
+  EXPECT_EQ(1000, p.count);
+  EXPECT_DOUBLE_EQ(123.456789, p.mean_us);
+  EXPECT_EQ(120, p.p50_us);
+  EXPECT_EQ(400, p.p999_us);
+  EXPECT_DOUBLE_EQ(8100.25, p.ops_per_second);
+}
+
+TEST(BenchmarkHarnessTest, CsvErrors) {
+  std::istringstream missing("read,1,2,3\n");
+  EXPECT_THAT(ParseBenchmarkCsv(missing),
+              StatusIs(StatusCode::kInvalidArgument));
+
+  BenchmarkFlags flags;
+  flags.output_format = "csv";
+  std::ostringstream os;
+  EXPECT_THAT(
+      WriteBenchmarkResults(os, flags, {MakeSummary("read,write", 1, 1)}),
+      StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(BenchmarkHarnessTest, Json) {
+  BenchmarkFlags flags;
+  flags.output_format = "json";
+  flags.labels = {{"name", "with \"quotes\""}};
+  std::ostringstream os;
+  ASSERT_STATUS_OK(
+      WriteBenchmarkResults(os, flags, {MakeSummary("read", 100, 10)}));
+  EXPECT_THAT(os.str(), HasSubstr(R"("labels":{"name":"with \"quotes\""})"));
+  EXPECT_THAT(os.str(), HasSubstr(R"({"operation":"read","count":1000,)"));
+}
+
+TEST(BenchmarkHarnessTest, Compare) {
+  auto baseline = std::vector<BenchmarkSummary>{
+      MakeSummary("noise", 100, 50), MakeSummary("slower", 100, 10),
+      MakeSummary("faster", 100, 10), MakeSummary("small", 100, 1),
+      MakeSummary("removed", 100, 10)};
+  auto candidate = std::vector<BenchmarkSummary>{
+      MakeSummary("noise", 102, 50), MakeSummary("slower", 120, 10),
+      MakeSummary("faster", 80, 10), MakeSummary("small", 101, 1),
+      MakeSummary("added", 100, 10)};
+
+  auto results = CompareBenchmarks(baseline, candidate);
+  ASSERT_EQ(4, results.size());
+
+  EXPECT_EQ("noise", results[0].operation);
+  EXPECT_FALSE(results[0].significant);
+  EXPECT_FALSE(results[0].regression);
+
+  EXPECT_EQ("slower", results[1].operation);
+  EXPECT_NEAR(0.2, results[1].change, 1e-9);
+  EXPECT_TRUE(results[1].significant);
+  EXPECT_TRUE(results[1].regression);
+
+  EXPECT_EQ("faster", results[2].operation);
+  EXPECT_TRUE(results[2].significant);
+  EXPECT_FALSE(results[2].regression);
+
+  // Significant, but smaller than the minimum change.
+  EXPECT_EQ("small", results[3].operation);
+  EXPECT_TRUE(results[3].significant);
+  EXPECT_FALSE(results[3].regression);
+}
+
+}  // namespace
+}  // namespace testing_util
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,86 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/testing_util/capture_instrumentation.h"
+#include "absl/memory/memory.h"
+#include <sstream>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace testing_util {
+namespace {
+class CaptureSpan : public InstrumentationSpan {
+ public:
+  CaptureSpan(std::shared_ptr<CaptureInstrumentation> owner, std::string name)
+      : owner_(std::move(owner)), name_(std::move(name)) {}
+
+  void AddEvent(char const* name) override {
+    owner_->Capture("event:" + name_ + ":" + name);
+  }
+  void End(Status const& status) override {
+    std::ostringstream os;
+    os << "end:" << name_ << ":" << status.code();
+    owner_->Capture(std::move(os).str());
+  }
+
+ private:
+  std::shared_ptr<CaptureInstrumentation> owner_;
+  std::string name_;
+};
+}  // namespace
+
+std::vector<std::string> CaptureInstrumentation::ClearEvents() {
+  std::vector<std::string> result;
+  std::lock_guard<std::mutex> lk(mu_);
+  result.swap(events_);
+  return result;
+}
+
+std::unique_ptr<InstrumentationSpan> CaptureInstrumentation::StartSpan(
+    char const* name) {
+  Capture(std::string("start:") + name);
+  return absl::make_unique<CaptureSpan>(shared_from_this(), name);
+}
+
+void CaptureInstrumentation::RecordDuration(char const* metric,
+                                            std::chrono::nanoseconds) {
+  Capture(std::string("duration:") + metric);
+}
+
+void CaptureInstrumentation::RecordValue(char const* metric,
+                                         std::int64_t value) {
+  Capture(std::string("value:") + metric + "=" + std::to_string(value));
+}
+
+void CaptureInstrumentation::RecordRpc(RpcMetrics const& metrics) {
+  std::ostringstream os;
+  os << "rpc:" << metrics.rpc << ":" << metrics.code;
+  if (metrics.messages_sent != 0 || metrics.messages_received != 0) {
+    os << ":sent=" << metrics.messages_sent << "/" << metrics.bytes_sent
+       << ":received=" << metrics.messages_received << "/"
+       << metrics.bytes_received;
+  }
+  Capture(std::move(os).str());
+}
+
+void CaptureInstrumentation::Capture(std::string event) {
+  std::lock_guard<std::mutex> lk(mu_);
+  events_.push_back(std::move(event));
+}
+
+}  // namespace testing_util
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,61 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_CAPTURE_INSTRUMENTATION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_CAPTURE_INSTRUMENTATION_H
+
+#include "google/cloud/instrumentation.h"
+#include "google/cloud/version.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace testing_util {
+/**
+ * An `Instrumentation` that stores a description of each call.
+ *
+ * The events are formatted as:
+ * - `start:<span>`, `event:<span>:<event>` and `end:<span>:<status code>`
+ * - `duration:<metric>` and `value:<metric>=<value>`
+ * - `rpc:<rpc>:<status code>`, followed by
+ *   `:sent=<messages>/<bytes>:received=<messages>/<bytes>` for streaming RPCs
+ */
+class CaptureInstrumentation
+    : public Instrumentation,
+      public std::enable_shared_from_this<CaptureInstrumentation> {
+ public:
+  std::vector<std::string> ClearEvents();
+
+  std::unique_ptr<InstrumentationSpan> StartSpan(char const* name) override;
+  void RecordDuration(char const* metric,
+                      std::chrono::nanoseconds value) override;
+  void RecordValue(char const* metric, std::int64_t value) override;
+  void RecordRpc(RpcMetrics const& metrics) override;
+
+  void Capture(std::string event);
+
+ private:
+  std::mutex mu_;
+  std::vector<std::string> events_;
+};
+
+}  // namespace testing_util
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_CAPTURE_INSTRUMENTATION_H
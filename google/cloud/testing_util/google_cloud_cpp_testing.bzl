@@ -19,6 +19,8 @@
 google_cloud_cpp_testing_hdrs = [
     "assert_ok.h",
     "async_sequencer.h",
+    "benchmark_harness.h",
+    "capture_instrumentation.h",
     "capture_log_lines_backend.h",
     "check_predicate_becomes_false.h",
     "chrono_literals.h",
@@ -28,6 +30,7 @@ google_cloud_cpp_testing_hdrs = [
     "example_driver.h",
     "expect_exception.h",
     "expect_future_error.h",
+    "hdr_histogram.h",
     "scoped_environment.h",
     "scoped_thread.h",
     "status_matchers.h",
@@ -37,10 +40,13 @@ google_cloud_cpp_testing_hdrs = [
 
 google_cloud_cpp_testing_srcs = [
     "assert_ok.cc",
+    "benchmark_harness.cc",
+    "capture_instrumentation.cc",
     "capture_log_lines_backend.cc",
     "command_line_parsing.cc",
     "crash_handler.cc",
     "example_driver.cc",
+    "hdr_histogram.cc",
     "scoped_environment.cc",
     "testing_types.cc",
     "timer.cc",
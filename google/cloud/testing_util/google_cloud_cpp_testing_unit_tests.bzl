@@ -18,10 +18,12 @@
 
 google_cloud_cpp_testing_unit_tests = [
     "assert_ok_test.cc",
+    "benchmark_harness_test.cc",
     "command_line_parsing_test.cc",
     "contains_once_test.cc",
     "crash_handler_test.cc",
     "example_driver_test.cc",
+    "hdr_histogram_test.cc",
     "scoped_environment_test.cc",
     "status_matchers_test.cc",
 ]
@@ -0,0 +1,130 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/testing_util/hdr_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace testing_util {
+namespace {
+
+int MostSignificantBit(std::int64_t value) {
+  int msb = 0;
+  while (value >>= 1) ++msb;
+  return msb;
+}
+
+}  // namespace
+
+// Values below `sub_bucket_count_` have their own bucket. Above that, each
+// power of two is split into `sub_bucket_count_ / 2` buckets of equal width,
+// so the width of a bucket is at most 1 / 10^significant_digits of its values.
+HdrHistogram::HdrHistogram(int significant_digits) {
+  significant_digits = (std::min)((std::max)(significant_digits, 1), 5);
+  std::int64_t precision = 1;
+  for (int i = 0; i != significant_digits; ++i) precision *= 10;
+  sub_bucket_bits_ = 1;
+  while ((std::int64_t{1} << (sub_bucket_bits_ - 1)) < precision) {
+    ++sub_bucket_bits_;
+  }
+  sub_bucket_count_ = std::int64_t{1} << sub_bucket_bits_;
+}
+
+void HdrHistogram::Record(std::int64_t value) {
+  value = (std::max)(value, std::int64_t{0});
+  auto const index = IndexOf(value);
+  if (index >= counts_.size()) counts_.resize(index + 1);
+  ++counts_[index];
+  min_ = count_ == 0 ? value : (std::min)(min_, value);
+  max_ = (std::max)(max_, value);
+  ++count_;
+  auto const v = static_cast<double>(value);
+  sum_ += v;
+  sum_squares_ += v * v;
+}
+
+void HdrHistogram::Merge(HdrHistogram const& rhs) {
+  if (rhs.count_ == 0) return;
+  if (rhs.sub_bucket_bits_ == sub_bucket_bits_) {
+    if (rhs.counts_.size() > counts_.size()) counts_.resize(rhs.counts_.size());
+    for (std::size_t i = 0; i != rhs.counts_.size(); ++i) {
+      counts_[i] += rhs.counts_[i];
+    }
+  } else {
+    // Different precisions, re-bucket using the value of each bucket.
+    for (std::size_t i = 0; i != rhs.counts_.size(); ++i) {
+      if (rhs.counts_[i] == 0) continue;
+      auto const index = IndexOf(rhs.HighestEquivalent(i));
+      if (index >= counts_.size()) counts_.resize(index + 1);
+      counts_[index] += rhs.counts_[i];
+    }
+  }
+  min_ = count_ == 0 ? rhs.min_ : (std::min)(min_, rhs.min_);
+  max_ = (std::max)(max_, rhs.max_);
+  count_ += rhs.count_;
+  sum_ += rhs.sum_;
+  sum_squares_ += rhs.sum_squares_;
+}
+
+double HdrHistogram::mean() const {
+  if (count_ == 0) return 0;
+  return sum_ / static_cast<double>(count_);
+}
+
+double HdrHistogram::stddev() const {
+  if (count_ < 2) return 0;
+  auto const n = static_cast<double>(count_);
+  auto const variance = (sum_squares_ - sum_ * sum_ / n) / (n - 1);
+  return variance <= 0 ? 0 : std::sqrt(variance);
+}
+
+std::int64_t HdrHistogram::ValueAtPercentile(double p) const {
+  if (count_ == 0) return 0;
+  p = (std::min)((std::max)(p, 0.0), 100.0);
+  auto target = static_cast<std::int64_t>(
+      std::ceil(p / 100.0 * static_cast<double>(count_)));
+  target = (std::max)(target, std::int64_t{1});
+  std::int64_t seen = 0;
+  for (std::size_t i = 0; i != counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= target) return (std::min)(HighestEquivalent(i), max_);
+  }
+  return max_;
+}
+
+std::size_t HdrHistogram::IndexOf(std::int64_t value) const {
+  if (value < sub_bucket_count_) return static_cast<std::size_t>(value);
+  auto const half = sub_bucket_count_ / 2;
+  auto const shift = MostSignificantBit(value) - (sub_bucket_bits_ - 1);
+  auto const sub = value >> shift;
+  return static_cast<std::size_t>(sub_bucket_count_ + (shift - 1) * half +
+                                  (sub - half));
+}
+
+std::int64_t HdrHistogram::HighestEquivalent(std::size_t index) const {
+  auto const i = static_cast<std::int64_t>(index);
+  if (i < sub_bucket_count_) return i;
+  auto const half = sub_bucket_count_ / 2;
+  auto const shift = (i - sub_bucket_count_) / half + 1;
+  auto const sub = (i - sub_bucket_count_) % half + half;
+  return ((sub + 1) << shift) - 1;
+}
+
+}  // namespace testing_util
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
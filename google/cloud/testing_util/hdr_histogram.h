@@ -0,0 +1,82 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_HDR_HISTOGRAM_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_HDR_HISTOGRAM_H
+
+#include "google/cloud/version.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace testing_util {
+
+/**
+ * A high dynamic range histogram for benchmark latencies.
+ *
+ * Values are counted in buckets whose width grows with the value, so the
+ * relative error of the reported percentiles is bounded by the number of
+ * significant digits, e.g., 0.1% with 3 digits, for any value. The memory
+ * usage grows with the logarithm of the largest value recorded.
+ *
+ * The mean and standard deviation are computed from the exact values.
+ */
+class HdrHistogram {
+ public:
+  /// Create a histogram, @p significant_digits is clamped to [1, 5].
+  explicit HdrHistogram(int significant_digits = 3);
+
+  /// Record @p value, negative values are recorded as 0.
+  void Record(std::int64_t value);
+
+  /// Add all the values recorded in @p rhs.
+  void Merge(HdrHistogram const& rhs);
+
+  std::int64_t count() const { return count_; }
+  std::int64_t min() const { return count_ == 0 ? 0 : min_; }
+  std::int64_t max() const { return max_; }
+  double mean() const;
+  double stddev() const;
+
+  /**
+   * The value at percentile @p p, in the range [0, 100].
+   *
+   * Returns the largest value in the same bucket as the value at the
+   * percentile, but not more than `max()`.
+   */
+  std::int64_t ValueAtPercentile(double p) const;
+
+ private:
+  std::size_t IndexOf(std::int64_t value) const;
+  std::int64_t HighestEquivalent(std::size_t index) const;
+
+  int sub_bucket_bits_;
+  std::int64_t sub_bucket_count_;
+  std::vector<std::int64_t> counts_;
+  std::int64_t count_ = 0;
+  std::int64_t min_ = 0;
+  std::int64_t max_ = 0;
+  double sum_ = 0;
+  double sum_squares_ = 0;
+};
+
+}  // namespace testing_util
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TESTING_UTIL_HDR_HISTOGRAM_H
@@ -0,0 +1,105 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/testing_util/hdr_histogram.h"
+#include <gmock/gmock.h>
+#include <cmath>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace testing_util {
+namespace {
+
+TEST(HdrHistogramTest, Empty) {
+  HdrHistogram h;
+  EXPECT_EQ(0, h.count());
+  EXPECT_EQ(0, h.min());
+  EXPECT_EQ(0, h.max());
+  EXPECT_EQ(0, h.ValueAtPercentile(50));
+  EXPECT_DOUBLE_EQ(0, h.mean());
+  EXPECT_DOUBLE_EQ(0, h.stddev());
+}
+
+TEST(HdrHistogramTest, SmallValuesAreExact) {
+  HdrHistogram h;
+  for (int i = 1; i <= 100; ++i) h.Record(i);
+  EXPECT_EQ(100, h.count());
+  EXPECT_EQ(1, h.min());
+  EXPECT_EQ(100, h.max());
+  EXPECT_EQ(50, h.ValueAtPercentile(50));
+  EXPECT_EQ(90, h.ValueAtPercentile(90));
+  EXPECT_EQ(100, h.ValueAtPercentile(100));
+  EXPECT_EQ(1, h.ValueAtPercentile(0));
+  EXPECT_DOUBLE_EQ(50.5, h.mean());
+  EXPECT_NEAR(29.011, h.stddev(), 0.001);
+}
+
+TEST(HdrHistogramTest, LargeValuesWithinPrecision) {
+  for (int digits : {1, 2, 3, 4}) {
+    SCOPED_TRACE("digits=" + std::to_string(digits));
+    auto const tolerance = std::pow(10.0, -digits);
+    for (std::int64_t v : {std::int64_t{12345}, std::int64_t{987654321},
+                           std::int64_t{1} << 40}) {
+      HdrHistogram single(digits);
+      single.Record(v);
+      auto const actual = static_cast<double>(single.ValueAtPercentile(50));
+      EXPECT_LE(actual, static_cast<double>(v));
+      EXPECT_GE(actual, static_cast<double>(v) * (1 - tolerance));
+    }
+  }
+}
+
+TEST(HdrHistogramTest, Percentiles) {
+  HdrHistogram h;
+  for (int i = 0; i != 9900; ++i) h.Record(1000);
+  for (int i = 0; i != 100; ++i) h.Record(1000000);
+  EXPECT_EQ(1000, h.ValueAtPercentile(50));
+  EXPECT_EQ(1000, h.ValueAtPercentile(99));
+  EXPECT_NEAR(1000000, static_cast<double>(h.ValueAtPercentile(99.9)), 1000);
+  EXPECT_EQ(1000000, h.max());
+}
+
+TEST(HdrHistogramTest, NegativeValues) {
+  HdrHistogram h;
+  h.Record(-5);
+  EXPECT_EQ(1, h.count());
+  EXPECT_EQ(0, h.max());
+}
+
+TEST(HdrHistogramTest, Merge) {
+  HdrHistogram a;
+  HdrHistogram b;
+  HdrHistogram c(1);
+  for (int i = 1; i <= 50; ++i) a.Record(i);
+  for (int i = 51; i <= 100; ++i) b.Record(i);
+  c.Record(5000);
+  a.Merge(b);
+  EXPECT_EQ(100, a.count());
+  EXPECT_EQ(1, a.min());
+  EXPECT_EQ(100, a.max());
+  EXPECT_EQ(50, a.ValueAtPercentile(50));
+  EXPECT_DOUBLE_EQ(50.5, a.mean());
+
+  a.Merge(c);
+  EXPECT_EQ(101, a.count());
+  EXPECT_EQ(5000, a.max());
+  EXPECT_EQ(5000, a.ValueAtPercentile(100));
+}
+
+}  // namespace
+}  // namespace testing_util
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -19,6 +19,7 @@
 #include "google/cloud/version.h"
 #include "absl/types/optional.h"
 #include <grpcpp/client_context.h>
+#include <map>
 #include <string>
 
 namespace google {
@@ -26,6 +27,15 @@ namespace cloud {
 inline namespace GOOGLE_CLOUD_CPP_NS {
 namespace testing_util {
 
+/**
+ * Returns the metadata that @p context would send with a request.
+ *
+ * @warning the `context` will be destroyed and shouldn't be used after passing
+ *     it to this function.
+ */
+std::multimap<std::string, std::string> GetMetadata(
+    grpc::ClientContext& context);
+
 /**
  * Verify that the metadata in the context is appropriate for a gRPC method.
  *
@@ -56,6 +56,18 @@ TracingOptions& TracingOptions::SetOptions(std::string const& str) {
       if (auto v = ParseBoolean(val)) use_short_repeated_primitives_ = *v;
     } else if (opt == "truncate_string_field_longer_than") {
       if (auto v = ParseInteger(val)) truncate_string_field_longer_than_ = *v;
+    } else if (opt == "sample_one_in") {
+      if (auto v = ParseInteger(val)) {
+        sample_one_in_ = (std::max)(*v, std::int64_t{1});
+      }
+    } else if (opt == "latency_threshold_ms") {
+      if (auto v = ParseInteger(val)) {
+        latency_threshold_ = std::chrono::milliseconds(*v);
+      }
+    } else if (opt == "errors_only") {
+      if (auto v = ParseBoolean(val)) errors_only_ = *v;
+    } else if (opt == "max_message_length") {
+      if (auto v = ParseInteger(val)) max_message_length_ = *v;
     }
     if (comma == end) break;
     pos = comma + 1;
@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TRACING_OPTIONS_H
 
 #include "google/cloud/version.h"
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -29,6 +30,16 @@ inline namespace GOOGLE_CLOUD_CPP_NS {
  *   single_line_mode=on
  *   use_short_repeated_primitives=on
  *   truncate_string_field_longer_than=128
+ *   sample_one_in=1
+ *   latency_threshold_ms=0
+ *   errors_only=off
+ *   max_message_length=0
+ *
+ * The sampling options make it practical to leave tracing enabled in
+ * production: with `sample_one_in=100,latency_threshold_ms=500` only one RPC
+ * in 100 is considered, and it is logged only if it took 500ms or longer. When
+ * an RPC is filtered by latency or errors its request is formatted (and
+ * logged) only after the RPC completes, and only if it is logged at all.
  */
 class TracingOptions {
  public:
@@ -49,10 +60,28 @@ class TracingOptions {
     return truncate_string_field_longer_than_;
   }
 
+  /// Trace one RPC in this many, the others are not logged at all.
+  std::int64_t sample_one_in() const { return sample_one_in_; }
+
+  /// If non-zero, only log RPCs that take at least this long.
+  std::chrono::milliseconds latency_threshold() const {
+    return latency_threshold_;
+  }
+
+  /// Only log RPCs that fail.
+  bool errors_only() const { return errors_only_; }
+
+  /// If non-zero, truncate each formatted message longer than this.
+  std::int64_t max_message_length() const { return max_message_length_; }
+
  private:
   bool single_line_mode_ = true;
   bool use_short_repeated_primitives_ = true;
   std::int64_t truncate_string_field_longer_than_ = 128;
+  std::int64_t sample_one_in_ = 1;
+  std::chrono::milliseconds latency_threshold_{0};
+  bool errors_only_ = false;
+  std::int64_t max_message_length_ = 0;
 };
 
 }  // namespace GOOGLE_CLOUD_CPP_NS
@@ -44,6 +44,29 @@ TEST(TracingOptionsTest, Override) {
   EXPECT_EQ(256, tracing_options.truncate_string_field_longer_than());
 }
 
+TEST(TracingOptionsTest, Sampling) {
+  TracingOptions tracing_options;
+  EXPECT_EQ(1, tracing_options.sample_one_in());
+  EXPECT_EQ(std::chrono::milliseconds(0), tracing_options.latency_threshold());
+  EXPECT_FALSE(tracing_options.errors_only());
+  EXPECT_EQ(0, tracing_options.max_message_length());
+
+  tracing_options.SetOptions(
+      "sample_one_in=100"
+      ",latency_threshold_ms=500"
+      ",errors_only=on"
+      ",max_message_length=1024");
+  EXPECT_EQ(100, tracing_options.sample_one_in());
+  EXPECT_EQ(std::chrono::milliseconds(500),
+            tracing_options.latency_threshold());
+  EXPECT_TRUE(tracing_options.errors_only());
+  EXPECT_EQ(1024, tracing_options.max_message_length());
+
+  // Sampling less than one in one is meaningless.
+  tracing_options.SetOptions("sample_one_in=0");
+  EXPECT_EQ(1, tracing_options.sample_one_in());
+}
+
 }  // namespace
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud